@@ -12,3 +12,6 @@ ninja
 ccache -s
 
 ctest -VV -C Release
+
+# Keep the benchmark results of every build so regressions can be tracked between revisions
+bin/yuzu_bench --reporter xml --out benchmarks.xml
@@ -17,4 +17,6 @@ mkdir "$DIR_NAME"
 cp build/bin/yuzu-cmd "$DIR_NAME"
 cp build/bin/yuzu "$DIR_NAME"
 
+cp build/benchmarks.xml "artifacts/${REV_NAME}-benchmarks.xml"
+
 . .ci/scripts/common/post-upload.sh
@@ -9,8 +9,13 @@
 #include <cmath>
 #include <vector>
 #include "audio_core/algorithm/filter.h"
+#include "audio_core/algorithm/mix.h"
 #include "common/common_types.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include <xmmintrin.h>
+#endif
+
 namespace AudioCore {
 
 Filter Filter::LowPass(double cutoff, double Q) {
@@ -32,21 +37,26 @@ Filter Filter::LowPass(double cutoff, double Q) {
 Filter::Filter() : Filter(1.0, 0.0, 0.0, 1.0, 0.0, 0.0) {}
 
 Filter::Filter(double a0, double a1, double a2, double b0, double b1, double b2)
-    : a1(a1 / a0), a2(a2 / a0), b0(b0 / a0), b1(b1 / a0), b2(b2 / a0) {}
+    : a1(static_cast<float>(a1 / a0)), a2(static_cast<float>(a2 / a0)),
+      b0(static_cast<float>(b0 / a0)), b1(static_cast<float>(b1 / a0)),
+      b2(static_cast<float>(b2 / a0)) {}
 
 void Filter::Process(std::vector<s16>& signal) {
-    const std::size_t num_frames = signal.size() / 2;
-    for (std::size_t i = 0; i < num_frames; i++) {
-        std::rotate(in.begin(), in.end() - 1, in.end());
-        std::rotate(out.begin(), out.end() - 1, out.end());
+    std::vector<float> buffer(signal.size());
+    MixSamples(buffer.data(), signal.data(), signal.size(), 1.0f);
+    Process(buffer.data(), signal.size() / channel_count);
+    ResolveMixBus(signal.data(), buffer.data(), signal.size());
+}
 
+void Filter::Process(float* signal, std::size_t num_frames) {
+    for (std::size_t i = 0; i < num_frames; i++) {
         for (std::size_t ch = 0; ch < channel_count; ch++) {
-            in[0][ch] = signal[i * channel_count + ch];
-
-            out[0][ch] = b0 * in[0][ch] + b1 * in[1][ch] + b2 * in[2][ch] - a1 * out[1][ch] -
-                         a2 * out[2][ch];
-
-            signal[i * 2 + ch] = static_cast<s16>(std::clamp(out[0][ch], -32768.0, 32767.0));
+            float& sample = signal[i * channel_count + ch];
+            const float x = sample;
+            const float y = b0 * x + z1[ch];
+            z1[ch] = b1 * x - a1 * y + z2[ch];
+            z2[ch] = b2 * x - a2 * y;
+            sample = y;
         }
     }
 }
@@ -71,9 +81,93 @@ CascadingFilter::CascadingFilter() = default;
 CascadingFilter::CascadingFilter(std::vector<Filter> filters) : filters(std::move(filters)) {}
 
 void CascadingFilter::Process(std::vector<s16>& signal) {
-    for (auto& filter : filters) {
-        filter.Process(signal);
+    scratch.assign(signal.size(), 0.0f);
+    MixSamples(scratch.data(), signal.data(), signal.size(), 1.0f);
+    Process(scratch.data(), signal.size() / Filter::channel_count);
+    ResolveMixBus(signal.data(), scratch.data(), signal.size());
+}
+
+void CascadingFilter::Process(float* signal, std::size_t num_frames) {
+    std::size_t stage = 0;
+    for (; stage + 2 <= filters.size(); stage += 2) {
+        ProcessPair(filters[stage], filters[stage + 1], signal, num_frames);
+    }
+    if (stage < filters.size()) {
+        filters[stage].Process(signal, num_frames);
+    }
+}
+
+#ifdef ARCHITECTURE_x86_64
+
+void CascadingFilter::ProcessPair(Filter& first, Filter& second, float* signal,
+                                  std::size_t num_frames) {
+    if (num_frames == 0) {
+        return;
+    }
+
+    // The low lanes run the first stage on a frame while the high lanes run the second stage on
+    // the frame before it, so both channels of both stages share every instruction. The first and
+    // the last frame only run one of the stages, their other lanes keep their state.
+    const auto coefficients = [&](float Filter::*coefficient) {
+        return _mm_setr_ps(first.*coefficient, first.*coefficient, second.*coefficient,
+                           second.*coefficient);
+    };
+    const __m128 b0 = coefficients(&Filter::b0);
+    const __m128 b1 = coefficients(&Filter::b1);
+    const __m128 b2 = coefficients(&Filter::b2);
+    const __m128 a1 = coefficients(&Filter::a1);
+    const __m128 a2 = coefficients(&Filter::a2);
+    __m128 z1 = _mm_setr_ps(first.z1[0], first.z1[1], second.z1[0], second.z1[1]);
+    __m128 z2 = _mm_setr_ps(first.z2[0], first.z2[1], second.z2[0], second.z2[1]);
+
+    const auto step = [&](__m128 x) {
+        const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+        z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+        z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+        return y;
+    };
+    const auto load_frame = [signal](std::size_t frame) {
+        return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(signal + frame * 2));
+    };
+    const auto store_frame = [signal](std::size_t frame, __m128 y) {
+        _mm_storeh_pi(reinterpret_cast<__m64*>(signal + frame * 2), y);
+    };
+
+    const __m128 old_z1 = z1;
+    const __m128 old_z2 = z2;
+    __m128 y = step(load_frame(0));
+    z1 = _mm_shuffle_ps(z1, old_z1, _MM_SHUFFLE(3, 2, 1, 0));
+    z2 = _mm_shuffle_ps(z2, old_z2, _MM_SHUFFLE(3, 2, 1, 0));
+
+    for (std::size_t frame = 1; frame < num_frames; ++frame) {
+        y = step(_mm_movelh_ps(load_frame(frame), y));
+        store_frame(frame - 1, y);
     }
+
+    const __m128 first_z1 = z1;
+    const __m128 first_z2 = z2;
+    y = step(_mm_movelh_ps(_mm_setzero_ps(), y));
+    z1 = _mm_shuffle_ps(first_z1, z1, _MM_SHUFFLE(3, 2, 1, 0));
+    z2 = _mm_shuffle_ps(first_z2, z2, _MM_SHUFFLE(3, 2, 1, 0));
+    store_frame(num_frames - 1, y);
+
+    alignas(16) std::array<float, 4> state;
+    _mm_store_ps(state.data(), z1);
+    first.z1 = {state[0], state[1]};
+    second.z1 = {state[2], state[3]};
+    _mm_store_ps(state.data(), z2);
+    first.z2 = {state[0], state[1]};
+    second.z2 = {state[2], state[3]};
 }
 
+#else
+
+void CascadingFilter::ProcessPair(Filter& first, Filter& second, float* signal,
+                                  std::size_t num_frames) {
+    first.Process(signal, num_frames);
+    second.Process(signal, num_frames);
+}
+
+#endif
+
 } // namespace AudioCore
@@ -15,6 +15,8 @@ namespace AudioCore {
 ///          b0 + b1 z^-1 + b2 z^-2
 ///  H(z) = ------------------------
 ///          a0 + a1 z^-1 + b2 z^-2
+///
+/// Runs in single precision, in transposed direct form II.
 class Filter {
 public:
     /// Creates a low-pass filter.
@@ -27,17 +29,24 @@ public:
 
     Filter(double a0, double a1, double a2, double b0, double b1, double b2);
 
+    /// Filters interleaved stereo PCM16 in place.
     void Process(std::vector<s16>& signal);
 
+    /// Filters interleaved stereo samples in place.
+    /// @param signal The samples, num_frames * 2 long.
+    /// @param num_frames Number of stereo frames in signal.
+    void Process(float* signal, std::size_t num_frames);
+
 private:
+    friend class CascadingFilter;
+
     static constexpr std::size_t channel_count = 2;
 
     /// Coefficients are in normalized form (a0 = 1.0).
-    double a1, a2, b0, b1, b2;
-    /// Input History
-    std::array<std::array<double, channel_count>, 3> in;
-    /// Output History
-    std::array<std::array<double, channel_count>, 3> out;
+    float a1, a2, b0, b1, b2;
+    /// State of each channel
+    std::array<float, channel_count> z1{};
+    std::array<float, channel_count> z2{};
 };
 
 /// Cascade filters to build up higher-order filters from lower-order ones.
@@ -53,10 +62,18 @@ public:
 
     explicit CascadingFilter(std::vector<Filter> filters);
 
+    /// Filters interleaved stereo PCM16 in place.
     void Process(std::vector<s16>& signal);
 
+    /// Filters interleaved stereo samples in place, see Filter::Process.
+    void Process(float* signal, std::size_t num_frames);
+
 private:
+    /// Runs two consecutive biquads of the cascade in a single pass over the signal.
+    static void ProcessPair(Filter& first, Filter& second, float* signal, std::size_t num_frames);
+
     std::vector<Filter> filters;
+    std::vector<float> scratch;
 };
 
 } // namespace AudioCore
@@ -5,68 +5,160 @@
 #define _USE_MATH_DEFINES
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <map>
+#include <mutex>
 #include <vector>
 #include "audio_core/algorithm/interpolate.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include "audio_core/algorithm/interpolate_avx2.h"
+#endif
+
 namespace AudioCore {
+namespace {
+
+constexpr std::size_t TAPS = InterpolationState::taps;
+constexpr std::size_t PHASES = InterpolationState::phases;
+
+/// Shape of the Kaiser window, about 80 dB of stopband attenuation
+constexpr double KAISER_BETA = 8.0;
+
+/// Zeroth order modified Bessel function of the first kind
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+/// Tabulates a Kaiser windowed sinc low-pass at every phase. The cutoff sits below the Nyquist
+/// frequency of whichever of the input and output rates is lower, so downsampling doesn't alias.
+std::vector<float> MakeCoefficients(double ratio) {
+    const double cutoff = 0.45 * std::min(1.0, 1.0 / ratio);
+    const double half_length = static_cast<double>(TAPS) / 2.0;
+
+    std::vector<float> coefficients((PHASES + 1) * TAPS);
+    std::array<double, TAPS> values;
+    for (std::size_t phase = 0; phase <= PHASES; ++phase) {
+        const double fraction = static_cast<double>(phase) / static_cast<double>(PHASES);
+        float* const row = coefficients.data() + phase * TAPS;
+
+        double sum = 0.0;
+        for (std::size_t tap = 0; tap < TAPS; ++tap) {
+            const double x = static_cast<double>(tap) - (half_length - 1.0) - fraction;
+            const double sinc_x = 2.0 * cutoff * x;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * sinc_x) / (M_PI * sinc_x);
+            const double edge = x / half_length;
+            const double window =
+                std::abs(edge) >= 1.0
+                    ? 0.0
+                    : BesselI0(KAISER_BETA * std::sqrt(1.0 - edge * edge)) / BesselI0(KAISER_BETA);
+            values[tap] = sinc * window;
+            sum += values[tap];
+        }
+        // Normalize every phase to unity gain, so a constant signal stays constant
+        for (std::size_t tap = 0; tap < TAPS; ++tap) {
+            row[tap] = static_cast<float>(values[tap] / sum);
+        }
+    }
+    return coefficients;
+}
+
+/// Returns the coefficients for a ratio, voices playing at the same rate share a table.
+std::shared_ptr<const std::vector<float>> GetCoefficients(double ratio) {
+    static std::mutex mutex;
+    static std::map<double, std::shared_ptr<const std::vector<float>>> tables;
 
-/// The Lanczos kernel
-static double Lanczos(std::size_t a, double x) {
-    if (x == 0.0)
-        return 1.0;
-    const double px = M_PI * x;
-    return a * std::sin(px) * std::sin(px / a) / (px * px);
+    std::lock_guard lock{mutex};
+    auto& table = tables[ratio];
+    if (!table) {
+        table = std::make_shared<const std::vector<float>>(MakeCoefficients(ratio));
+    }
+    return table;
+}
+
+s16 ClampToS16(float value) {
+    return static_cast<s16>(std::clamp(value, -32768.0f, 32767.0f));
+}
+
+std::size_t ResampleGeneric(const float* coefficients, const float* left, const float* right,
+                            std::size_t num_frames, double& position, double ratio, s16* output) {
+    std::size_t count = 0;
+    double pos = position;
+    for (auto index = static_cast<std::size_t>(pos); index + TAPS / 2 < num_frames;
+         index = static_cast<std::size_t>(pos)) {
+        const double phase = (pos - static_cast<double>(index)) * static_cast<double>(PHASES);
+        const auto row = static_cast<std::size_t>(phase);
+        const auto blend = static_cast<float>(phase - static_cast<double>(row));
+        const float* const low = coefficients + row * TAPS;
+        const float* const high = low + TAPS;
+        const float* const l = left + index - (TAPS / 2 - 1);
+        const float* const r = right + index - (TAPS / 2 - 1);
+
+        float sum_l = 0.0f;
+        float sum_r = 0.0f;
+        for (std::size_t tap = 0; tap < TAPS; ++tap) {
+            const float coefficient = low[tap] + blend * (high[tap] - low[tap]);
+            sum_l += coefficient * l[tap];
+            sum_r += coefficient * r[tap];
+        }
+        output[count * 2 + 0] = ClampToS16(sum_l);
+        output[count * 2 + 1] = ClampToS16(sum_r);
+
+        ++count;
+        pos += ratio;
+    }
+    position = pos;
+    return count;
 }
 
-std::vector<s16> Interpolate(InterpolationState& state, std::vector<s16> input, double ratio) {
-    if (input.size() < 2)
-        return {};
+} // Anonymous namespace
 
+std::size_t Interpolate(InterpolationState& state, const s16* input, std::size_t num_frames,
+                        s16* output, double ratio) {
     if (ratio <= 0) {
         LOG_CRITICAL(Audio, "Nonsensical interpolation ratio {}", ratio);
         ratio = 1.0;
     }
 
     if (ratio != state.current_ratio) {
-        const double cutoff_frequency = std::min(0.5 / ratio, 0.5 * ratio);
-        state.nyquist = CascadingFilter::LowPass(std::clamp(cutoff_frequency, 0.0, 0.4), 3);
+        state.coefficients = GetCoefficients(ratio);
         state.current_ratio = ratio;
     }
-    state.nyquist.Process(input);
-
-    constexpr std::size_t taps = InterpolationState::lanczos_taps;
-    const std::size_t num_frames = input.size() / 2;
-
-    std::vector<s16> output;
-    output.reserve(static_cast<std::size_t>(input.size() / ratio + 4));
 
-    double& pos = state.position;
-    auto& h = state.history;
+    // Append the input to the history, deinterleaved so the filter can load consecutive frames
+    constexpr std::size_t history_size = TAPS - 1;
+    const std::size_t length = history_size + num_frames;
+    state.left.resize(length);
+    state.right.resize(length);
     for (std::size_t i = 0; i < num_frames; ++i) {
-        std::rotate(h.begin(), h.end() - 1, h.end());
-        h[0][0] = input[i * 2 + 0];
-        h[0][1] = input[i * 2 + 1];
-
-        while (pos <= 1.0) {
-            double l = 0.0;
-            double r = 0.0;
-            for (std::size_t j = 0; j < h.size(); j++) {
-                const double lanczos_calc = Lanczos(taps, pos + j - taps + 1);
-                l += lanczos_calc * h[j][0];
-                r += lanczos_calc * h[j][1];
-            }
-            output.emplace_back(static_cast<s16>(std::clamp(l, -32768.0, 32767.0)));
-            output.emplace_back(static_cast<s16>(std::clamp(r, -32768.0, 32767.0)));
-
-            pos += ratio;
-        }
-        pos -= 1.0;
+        state.left[history_size + i] = static_cast<float>(input[i * 2 + 0]);
+        state.right[history_size + i] = static_cast<float>(input[i * 2 + 1]);
     }
 
-    return output;
+#ifdef ARCHITECTURE_x86_64
+    static const auto resample = AVX2::IsSupported() ? AVX2::Resample : ResampleGeneric;
+#else
+    constexpr auto resample = ResampleGeneric;
+#endif
+    const std::size_t count = resample(state.coefficients->data(), state.left.data(),
+                                       state.right.data(), length, state.position, ratio, output);
+
+    // Keep the tail as the history of the next call
+    std::copy(state.left.end() - history_size, state.left.end(), state.left.begin());
+    std::copy(state.right.end() - history_size, state.right.end(), state.right.begin());
+    state.left.resize(history_size);
+    state.right.resize(history_size);
+    state.position -= static_cast<double>(num_frames);
+
+    return count;
 }
 
 } // namespace AudioCore
@@ -4,40 +4,49 @@
 
 #pragma once
 
-#include <array>
+#include <cstddef>
+#include <memory>
 #include <vector>
-#include "audio_core/algorithm/filter.h"
 #include "common/common_types.h"
 
 namespace AudioCore {
 
 struct InterpolationState {
-    static constexpr std::size_t lanczos_taps = 4;
-    static constexpr std::size_t history_size = lanczos_taps * 2 - 1;
+    /// Length of the windowed sinc, in input frames
+    static constexpr std::size_t taps = 16;
+    /// Number of fractional positions the sinc is tabulated at, positions in between are blended
+    static constexpr std::size_t phases = 256;
 
     double current_ratio = 0.0;
-    CascadingFilter nyquist;
-    std::array<std::array<s16, 2>, history_size> history = {};
-    double position = 0;
+    /// Filter coefficients of every phase, shared by every state resampling at the same ratio
+    std::shared_ptr<const std::vector<float>> coefficients;
+    /// Position of the next output frame, in frames from the start of the history
+    double position = static_cast<double>(taps / 2 - 1);
+    /// Deinterleaved input, starting with the last taps - 1 frames of the previous call
+    std::vector<float> left = std::vector<float>(taps - 1);
+    std::vector<float> right = std::vector<float>(taps - 1);
 };
 
-/// Interpolates input signal to produce output signal.
-/// @param input The signal to interpolate.
+/// Returns how many frames Interpolate can write at most for an input of num_frames frames.
+constexpr std::size_t GetMaxInterpolatedFrames(std::size_t num_frames, double ratio) {
+    return static_cast<std::size_t>(static_cast<double>(num_frames) / ratio) + 2;
+}
+
+/// Resamples a stereo signal with a windowed sinc polyphase filter.
+/// @param input The interleaved signal to resample.
+/// @param num_frames Number of stereo frames in input.
+/// @param output Buffer for the interleaved output signal, it has to fit at least
+///               GetMaxInterpolatedFrames frames.
 /// @param ratio Interpolation ratio.
 ///              ratio > 1.0 results in fewer output samples.
 ///              ratio < 1.0 results in more output samples.
-/// @returns Output signal.
-std::vector<s16> Interpolate(InterpolationState& state, std::vector<s16> input, double ratio);
-
-/// Interpolates input signal to produce output signal.
-/// @param input The signal to interpolate.
-/// @param input_rate The sample rate of input.
-/// @param output_rate The desired sample rate of the output.
-/// @returns Output signal.
-inline std::vector<s16> Interpolate(InterpolationState& state, std::vector<s16> input,
-                                    u32 input_rate, u32 output_rate) {
-    const double ratio = static_cast<double>(input_rate) / static_cast<double>(output_rate);
-    return Interpolate(state, std::move(input), ratio);
+/// @returns Number of frames written to output.
+std::size_t Interpolate(InterpolationState& state, const s16* input, std::size_t num_frames,
+                        s16* output, double ratio);
+
+/// Converts a pair of sample rates to an interpolation ratio.
+constexpr double GetInterpolationRatio(u32 input_rate, u32 output_rate) {
+    return static_cast<double>(input_rate) / static_cast<double>(output_rate);
 }
 
 } // namespace AudioCore
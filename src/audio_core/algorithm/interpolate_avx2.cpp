@@ -0,0 +1,70 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <immintrin.h>
+#include "audio_core/algorithm/interpolate.h"
+#include "audio_core/algorithm/interpolate_avx2.h"
+#include "common/x64/cpu_detect.h"
+
+namespace AudioCore::AVX2 {
+namespace {
+
+constexpr std::size_t TAPS = InterpolationState::taps;
+constexpr std::size_t PHASES = InterpolationState::phases;
+static_assert(TAPS == 16, "The filter is evaluated as two vectors of eight taps");
+
+/// Adds up the lanes of a vector.
+float HorizontalSum(__m256 value) {
+    const __m128 half = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    const __m128 pair = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    return _mm_cvtss_f32(_mm_add_ss(pair, _mm_movehdup_ps(pair)));
+}
+
+s16 ClampToS16(float value) {
+    return static_cast<s16>(std::clamp(value, -32768.0f, 32767.0f));
+}
+
+} // Anonymous namespace
+
+bool IsSupported() {
+    const auto& caps = Common::GetCPUCaps();
+    return caps.avx2 && caps.fma;
+}
+
+std::size_t Resample(const float* coefficients, const float* left, const float* right,
+                     std::size_t num_frames, double& position, double ratio, s16* output) {
+    std::size_t count = 0;
+    double pos = position;
+    for (auto index = static_cast<std::size_t>(pos); index + TAPS / 2 < num_frames;
+         index = static_cast<std::size_t>(pos)) {
+        const double phase = (pos - static_cast<double>(index)) * static_cast<double>(PHASES);
+        const auto row = static_cast<std::size_t>(phase);
+        const __m256 blend = _mm256_set1_ps(static_cast<float>(phase - static_cast<double>(row)));
+        const float* const low = coefficients + row * TAPS;
+        const float* const high = low + TAPS;
+        const float* const l = left + index - (TAPS / 2 - 1);
+        const float* const r = right + index - (TAPS / 2 - 1);
+
+        // Blend the two closest phases, then run both channels through the same taps
+        const __m256 low0 = _mm256_loadu_ps(low);
+        const __m256 low1 = _mm256_loadu_ps(low + 8);
+        const __m256 c0 = _mm256_fmadd_ps(blend, _mm256_sub_ps(_mm256_loadu_ps(high), low0), low0);
+        const __m256 c1 =
+            _mm256_fmadd_ps(blend, _mm256_sub_ps(_mm256_loadu_ps(high + 8), low1), low1);
+        const __m256 sum_l = _mm256_fmadd_ps(c1, _mm256_loadu_ps(l + 8),
+                                             _mm256_mul_ps(c0, _mm256_loadu_ps(l)));
+        const __m256 sum_r = _mm256_fmadd_ps(c1, _mm256_loadu_ps(r + 8),
+                                             _mm256_mul_ps(c0, _mm256_loadu_ps(r)));
+        output[count * 2 + 0] = ClampToS16(HorizontalSum(sum_l));
+        output[count * 2 + 1] = ClampToS16(HorizontalSum(sum_r));
+
+        ++count;
+        pos += ratio;
+    }
+    position = pos;
+    return count;
+}
+
+} // namespace AudioCore::AVX2
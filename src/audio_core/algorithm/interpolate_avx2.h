@@ -0,0 +1,25 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+
+/// Inner loop of Interpolate implemented with AVX2 and FMA. Only available on x86-64 hosts.
+namespace AudioCore::AVX2 {
+
+/// Returns true when the host CPU supports the instructions used by this module.
+bool IsSupported();
+
+/**
+ * Filters deinterleaved stereo input into interleaved output until the input runs out.
+ * @param coefficients Filter coefficients, phases + 1 rows of 16 taps.
+ * @param position     Position of the first output frame, advanced past the last one.
+ * @returns Number of frames written to output.
+ */
+std::size_t Resample(const float* coefficients, const float* left, const float* right,
+                     std::size_t num_frames, double& position, double ratio, s16* output);
+
+} // namespace AudioCore::AVX2
@@ -0,0 +1,53 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "audio_core/algorithm/mix.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
+namespace AudioCore {
+
+void MixSamples(float* mix_bus, const s16* samples, std::size_t count, float volume) {
+    std::size_t index = 0;
+#ifdef ARCHITECTURE_x86_64
+    // SSE2 is part of x86-64, so this needs no dispatch
+    const __m128 gain = _mm_set1_ps(volume);
+    for (; index + 8 <= count; index += 8) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + index));
+        // Sign extend by unpacking each sample into the top half of a 32-bit lane
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(input, input), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(input, input), 16);
+        float* const bus = mix_bus + index;
+        _mm_storeu_ps(bus, _mm_add_ps(_mm_loadu_ps(bus), _mm_mul_ps(_mm_cvtepi32_ps(low), gain)));
+        _mm_storeu_ps(bus + 4, _mm_add_ps(_mm_loadu_ps(bus + 4),
+                                          _mm_mul_ps(_mm_cvtepi32_ps(high), gain)));
+    }
+#endif
+    for (; index < count; ++index) {
+        mix_bus[index] += static_cast<float>(samples[index]) * volume;
+    }
+}
+
+void ResolveMixBus(s16* output, const float* mix_bus, std::size_t count) {
+    std::size_t index = 0;
+#ifdef ARCHITECTURE_x86_64
+    // Clamp in float first, out of range conversions to int32 don't saturate
+    const __m128 min = _mm_set1_ps(-32768.0f);
+    const __m128 max = _mm_set1_ps(32767.0f);
+    for (; index + 8 <= count; index += 8) {
+        const __m128 low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(mix_bus + index), min), max);
+        const __m128 high = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(mix_bus + index + 4), min), max);
+        const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(low), _mm_cvttps_epi32(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index), packed);
+    }
+#endif
+    for (; index < count; ++index) {
+        output[index] = static_cast<s16>(std::clamp(mix_bus[index], -32768.0f, 32767.0f));
+    }
+}
+
+} // namespace AudioCore
@@ -0,0 +1,25 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/// Adds samples scaled by volume to a float mix bus.
+/// @param mix_bus The bus to mix into, at least count samples long.
+/// @param samples The samples to mix.
+/// @param count Number of samples, counting every channel.
+/// @param volume Linear gain applied to the samples.
+void MixSamples(float* mix_bus, const s16* samples, std::size_t count, float volume);
+
+/// Converts a float mix bus to PCM16, clamping samples that are out of range.
+/// @param output The buffer to write, at least count samples long.
+/// @param mix_bus The mixed samples.
+/// @param count Number of samples, counting every channel.
+void ResolveMixBus(s16* output, const float* mix_bus, std::size_t count);
+
+} // namespace AudioCore
@@ -2,12 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <iterator>
 #include "audio_core/algorithm/interpolate.h"
+#include "audio_core/algorithm/mix.h"
 #include "audio_core/audio_out.h"
 #include "audio_core/audio_renderer.h"
 #include "audio_core/codec.h"
+#include "audio_core/perf_counters.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/hle/kernel/writable_event.h"
 #include "core/memory.h"
@@ -16,6 +20,19 @@ namespace AudioCore {
 
 constexpr u32 STREAM_SAMPLE_RATE{48000};
 constexpr u32 STREAM_NUM_CHANNELS{2};
+constexpr std::size_t MIX_BUFFER_SIZE{512};
+
+MICROPROFILE_DEFINE(Audio_Voice, "Audio", "Voice", MP_RGB(64, 160, 224));
+MICROPROFILE_DEFINE(Audio_Decode, "Audio", "Decode", MP_RGB(64, 192, 192));
+MICROPROFILE_DEFINE(Audio_Resample, "Audio", "Resample", MP_RGB(64, 192, 128));
+MICROPROFILE_DEFINE(Audio_Mix, "Audio", "Mix", MP_RGB(128, 192, 64));
+MICROPROFILE_DEFINE(Audio_Effects, "Audio", "Effects", MP_RGB(192, 160, 64));
+
+/// Every renderer mixes on the same thread, like they all share the ADSP on hardware.
+static Common::ThreadWorker& GetDSPWorker() {
+    static Common::ThreadWorker worker{1, "yuzu:AudioDSP"};
+    return worker;
+}
 
 class AudioRenderer::VoiceState {
 public:
@@ -36,18 +53,39 @@ public:
     }
 
     void SetWaveIndex(std::size_t index);
-    std::vector<s16> DequeueSamples(std::size_t sample_count, Memory::Memory& memory);
+
+    /// Returns up to sample_count frames of the current wave buffer, without copying them. The
+    /// samples stay valid until the next call. The number of samples returned, counting both
+    /// channels, is written to num_samples.
+    const s16* DequeueSamples(std::size_t sample_count, Memory::Memory& memory,
+                              std::size_t& num_samples);
     void UpdateState();
     void RefreshBuffer(Memory::Memory& memory);
 
 private:
+    /// Returns the smallest piece of the wave buffer that can be decoded, in bytes.
+    std::size_t GetDecodeUnit() const;
+    bool IsWaveBufferDrained() const;
+
+    /// Decodes the next piece of the wave buffer into samples, about enough for sample_count
+    /// output frames.
+    void DecodeNextChunk(std::size_t sample_count, Memory::Memory& memory);
+
+    /// Resamples a freshly decoded piece to the stream rate.
+    void ResampleChunk();
+
     bool is_in_use{};
     bool is_refresh_pending{};
     std::size_t wave_index{};
-    std::size_t offset{};
+    std::size_t wave_offset{}; ///< Bytes of the current wave buffer decoded so far
+    std::size_t offset{};      ///< Samples already dequeued from samples
+    Codec::ADPCM_Coeff adpcm_coeffs{};
     Codec::ADPCMState adpcm_state{};
     InterpolationState interp_state{};
-    std::vector<s16> samples;
+    std::vector<u8> wave_data; ///< Raw ADPCM frames read from guest memory
+    std::vector<s16> decoded;  ///< PCM16 in the channel layout of the voice
+    std::vector<s16> samples;  ///< Stereo samples at the stream rate, ready to mix
+    std::vector<s16> resampled;
     VoiceOutStatus out_status{};
     VoiceInfo info{};
 };
@@ -76,8 +114,9 @@ AudioRenderer::AudioRenderer(Core::Timing::CoreTiming& core_timing, Memory::Memo
                              AudioRendererParameter params,
                              std::shared_ptr<Kernel::WritableEvent> buffer_event,
                              std::size_t instance_number)
-    : worker_params{params}, buffer_event{buffer_event}, voices(params.voice_count),
-      effects(params.effect_count), memory{memory_} {
+    : worker_params{params}, buffer_event{buffer_event}, effects(params.effect_count),
+      memory{memory_}, voices(params.voice_count), mix_bus(MIX_BUFFER_SIZE * STREAM_NUM_CHANNELS),
+      voice_out_status(params.voice_count) {
 
     audio_out = std::make_unique<AudioCore::AudioOut>();
     stream = audio_out->OpenStream(core_timing, STREAM_SAMPLE_RATE, STREAM_NUM_CHANNELS,
@@ -85,12 +124,16 @@ AudioRenderer::AudioRenderer(Core::Timing::CoreTiming& core_timing, Memory::Memo
                                    [=]() { buffer_event->Signal(); });
     audio_out->StartStream(stream);
 
-    QueueMixedBuffer(0);
-    QueueMixedBuffer(1);
-    QueueMixedBuffer(2);
+    // No voice is playing yet, so the first buffers are silent
+    for (Buffer::Tag tag = 0; tag < 3; ++tag) {
+        audio_out->QueueBuffer(stream, tag,
+                               std::vector<s16>(MIX_BUFFER_SIZE * STREAM_NUM_CHANNELS));
+    }
 }
 
-AudioRenderer::~AudioRenderer() = default;
+AudioRenderer::~AudioRenderer() {
+    mix_tasks.Wait();
+}
 
 u32 AudioRenderer::GetSampleRate() const {
     return worker_params.sample_rate;
@@ -125,13 +168,13 @@ std::vector<u8> AudioRenderer::UpdateAudioRenderer(const std::vector<u8>& input_
                 input_params.data() + sizeof(UpdateDataHeader) + config.behavior_size,
                 memory_pool_count * sizeof(MemoryPoolInfo));
 
-    // Copy VoiceInfo structs
-    std::size_t voice_offset{sizeof(UpdateDataHeader) + config.behavior_size +
-                             config.memory_pools_size + config.voice_resource_size};
-    for (auto& voice : voices) {
-        std::memcpy(&voice.GetInfo(), input_params.data() + voice_offset, sizeof(VoiceInfo));
-        voice_offset += sizeof(VoiceInfo);
-    }
+    // Copy VoiceInfo structs, they are applied to the voices by the DSP thread
+    MixCommand command;
+    command.voice_infos.resize(worker_params.voice_count);
+    std::memcpy(command.voice_infos.data(),
+                input_params.data() + sizeof(UpdateDataHeader) + config.behavior_size +
+                    config.memory_pools_size + config.voice_resource_size,
+                command.voice_infos.size() * sizeof(VoiceInfo));
 
     std::size_t effect_offset{sizeof(UpdateDataHeader) + config.behavior_size +
                               config.memory_pools_size + config.voice_resource_size +
@@ -151,23 +194,22 @@ std::vector<u8> AudioRenderer::UpdateAudioRenderer(const std::vector<u8>& input_
         }
     }
 
-    // Update voices
-    for (auto& voice : voices) {
-        voice.UpdateState();
-        if (!voice.GetInfo().is_in_use) {
-            continue;
+    PerfCounters::GetInstance().AddUpdate();
+    {
+        MICROPROFILE_SCOPE(Audio_Effects);
+        const PerfCounters::ScopedTimer timer{PerfCounters::Stage::Effects};
+        for (auto& effect : effects) {
+            effect.UpdateState(memory);
         }
-        if (voice.GetInfo().is_new) {
-            voice.SetWaveIndex(voice.GetInfo().wave_buffer_head);
-        }
-    }
-
-    for (auto& effect : effects) {
-        effect.UpdateState(memory);
     }
 
-    // Release previous buffers and queue next ones for playback
-    ReleaseAndQueueBuffers();
+    // Queue the buffers mixed since the last update, then release the buffers that finished
+    // playing and hand them to the DSP thread together with the new voice parameters. The
+    // response reports the voice status of the last mix the DSP thread completed.
+    QueueMixedBuffers();
+    command.tags = audio_out->GetTagsAndReleaseBuffers(stream, 2);
+    GetDSPWorker().QueueWork(mix_tasks,
+                             [this, command = std::move(command)] { ProcessMixCommand(command); });
 
     // Copy output header
     UpdateDataHeader response_data{worker_params};
@@ -184,11 +226,11 @@ std::vector<u8> AudioRenderer::UpdateAudioRenderer(const std::vector<u8>& input_
                 response_data.memory_pools_size);
 
     // Copy output voice status
-    std::size_t voice_out_status_offset{sizeof(UpdateDataHeader) + response_data.memory_pools_size};
-    for (const auto& voice : voices) {
-        std::memcpy(output_params.data() + voice_out_status_offset, &voice.GetOutStatus(),
-                    sizeof(VoiceOutStatus));
-        voice_out_status_offset += sizeof(VoiceOutStatus);
+    {
+        std::lock_guard lock{mix_mutex};
+        std::memcpy(output_params.data() + sizeof(UpdateDataHeader) +
+                        response_data.memory_pools_size,
+                    voice_out_status.data(), voice_out_status.size() * sizeof(VoiceOutStatus));
     }
 
     std::size_t effect_out_status_offset{
@@ -207,16 +249,25 @@ void AudioRenderer::VoiceState::SetWaveIndex(std::size_t index) {
     is_refresh_pending = true;
 }
 
-std::vector<s16> AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_count,
-                                                           Memory::Memory& memory) {
+const s16* AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_count,
+                                                     Memory::Memory& memory,
+                                                     std::size_t& num_samples) {
+    num_samples = 0;
     if (!IsPlaying()) {
-        return {};
+        return nullptr;
     }
 
     if (is_refresh_pending) {
         RefreshBuffer(memory);
     }
 
+    // Wave buffers are decoded just in time, a piece at a time. The resampler can hold back all
+    // of a small piece, so keep going until something comes out or the buffer is drained.
+    while (offset == samples.size() && !IsWaveBufferDrained()) {
+        DecodeNextChunk(sample_count, memory);
+        ResampleChunk();
+    }
+
     const std::size_t max_size{samples.size() - offset};
     const std::size_t dequeue_offset{offset};
     std::size_t size{sample_count * STREAM_NUM_CHANNELS};
@@ -228,8 +279,9 @@ std::vector<s16> AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_co
     offset += size;
 
     const auto& wave_buffer{info.wave_buffer[wave_index]};
-    if (offset == samples.size()) {
-        offset = 0;
+    if (offset == samples.size() && IsWaveBufferDrained()) {
+        // Looping buffers and resumed streams decode the buffer again from the start
+        wave_offset = 0;
 
         if (!wave_buffer.is_looping && wave_buffer.buffer_sz) {
             SetWaveIndex(wave_index + 1);
@@ -244,7 +296,8 @@ std::vector<s16> AudioRenderer::VoiceState::DequeueSamples(std::size_t sample_co
         }
     }
 
-    return {samples.begin() + dequeue_offset, samples.begin() + dequeue_offset + size};
+    num_samples = size;
+    return samples.data() + dequeue_offset;
 }
 
 void AudioRenderer::VoiceState::UpdateState() {
@@ -259,22 +312,14 @@ void AudioRenderer::VoiceState::UpdateState() {
 }
 
 void AudioRenderer::VoiceState::RefreshBuffer(Memory::Memory& memory) {
-    const auto wave_buffer_address = info.wave_buffer[wave_index].buffer_addr;
-    const auto wave_buffer_size = info.wave_buffer[wave_index].buffer_sz;
-    std::vector<s16> new_samples(wave_buffer_size / sizeof(s16));
-    memory.ReadBlock(wave_buffer_address, new_samples.data(), wave_buffer_size);
-
     switch (static_cast<Codec::PcmFormat>(info.sample_format)) {
     case Codec::PcmFormat::Int16: {
         // PCM16 is played as-is
         break;
     }
     case Codec::PcmFormat::Adpcm: {
-        // Decode ADPCM to PCM16
-        Codec::ADPCM_Coeff coeffs;
-        memory.ReadBlock(info.additional_params_addr, coeffs.data(), sizeof(Codec::ADPCM_Coeff));
-        new_samples = Codec::DecodeADPCM(reinterpret_cast<u8*>(new_samples.data()),
-                                         new_samples.size() * sizeof(s16), coeffs, adpcm_state);
+        memory.ReadBlock(info.additional_params_addr, adpcm_coeffs.data(),
+                         sizeof(Codec::ADPCM_Coeff));
         break;
     }
     default:
@@ -282,32 +327,93 @@ void AudioRenderer::VoiceState::RefreshBuffer(Memory::Memory& memory) {
         break;
     }
 
-    switch (info.channel_count) {
-    case 1:
+    if (info.channel_count != 1 && info.channel_count != 2) {
+        UNIMPLEMENTED_MSG("Unimplemented channel_count={}", info.channel_count);
+    }
+
+    wave_offset = 0;
+    offset = 0;
+    samples.clear();
+    is_refresh_pending = false;
+}
+
+std::size_t AudioRenderer::VoiceState::GetDecodeUnit() const {
+    if (static_cast<Codec::PcmFormat>(info.sample_format) == Codec::PcmFormat::Adpcm) {
+        return Codec::ADPCM_FRAME_SIZE;
+    }
+    return (info.channel_count == 1 ? 1 : 2) * sizeof(s16);
+}
+
+bool AudioRenderer::VoiceState::IsWaveBufferDrained() const {
+    const std::size_t buffer_size = info.wave_buffer[wave_index].buffer_sz;
+    return buffer_size <= wave_offset || buffer_size - wave_offset < GetDecodeUnit();
+}
+
+void AudioRenderer::VoiceState::DecodeNextChunk(std::size_t sample_count,
+                                                Memory::Memory& memory) {
+    MICROPROFILE_SCOPE(Audio_Decode);
+    const PerfCounters::ScopedTimer timer{PerfCounters::Stage::Decode};
+
+    const auto& wave_buffer{info.wave_buffer[wave_index]};
+    const std::size_t num_channels = info.channel_count == 1 ? 1 : 2;
+    const double ratio = GetInterpolationRatio(info.sample_rate, STREAM_SAMPLE_RATE);
+
+    // Decode what the request needs at the voice rate plus what the resampler holds back,
+    // rounded to whole units and capped to what is left of the buffer
+    const std::size_t unit = GetDecodeUnit();
+    const std::size_t input_samples =
+        (static_cast<std::size_t>(static_cast<double>(sample_count) * ratio) +
+         InterpolationState::taps) *
+        num_channels;
+    const std::size_t remaining = (wave_buffer.buffer_sz - wave_offset) / unit * unit;
+    const VAddr address = wave_buffer.buffer_addr + wave_offset;
+
+    if (static_cast<Codec::PcmFormat>(info.sample_format) == Codec::PcmFormat::Adpcm) {
+        const std::size_t num_frames =
+            (input_samples + Codec::ADPCM_SAMPLES_PER_FRAME - 1) / Codec::ADPCM_SAMPLES_PER_FRAME;
+        const std::size_t size = std::min(num_frames * Codec::ADPCM_FRAME_SIZE, remaining);
+        wave_data.resize(size);
+        memory.ReadBlock(address, wave_data.data(), size);
+        decoded.resize(size / Codec::ADPCM_FRAME_SIZE * Codec::ADPCM_SAMPLES_PER_FRAME);
+        Codec::DecodeADPCMFrames(wave_data.data(), size / Codec::ADPCM_FRAME_SIZE, adpcm_coeffs,
+                                 adpcm_state, decoded.data());
+        wave_offset += size;
+    } else {
+        const std::size_t size = std::min(input_samples * sizeof(s16), remaining);
+        decoded.resize(size / sizeof(s16));
+        memory.ReadBlock(address, decoded.data(), size);
+        wave_offset += size;
+    }
+
+    if (num_channels == 1) {
         // 1 channel is upsampled to 2 channel
-        samples.resize(new_samples.size() * 2);
-        for (std::size_t index = 0; index < new_samples.size(); ++index) {
-            samples[index * 2] = new_samples[index];
-            samples[index * 2 + 1] = new_samples[index];
+        samples.resize(decoded.size() * 2);
+        for (std::size_t index = 0; index < decoded.size(); ++index) {
+            samples[index * 2] = decoded[index];
+            samples[index * 2 + 1] = decoded[index];
         }
-        break;
-    case 2: {
+    } else {
         // 2 channel is played as is
-        samples = std::move(new_samples);
-        break;
-    }
-    default:
-        UNIMPLEMENTED_MSG("Unimplemented channel_count={}", info.channel_count);
-        break;
+        samples.swap(decoded);
     }
+    offset = 0;
+}
 
+void AudioRenderer::VoiceState::ResampleChunk() {
     // Only interpolate when necessary, expensive.
     if (GetInfo().sample_rate != STREAM_SAMPLE_RATE) {
-        samples = Interpolate(interp_state, std::move(samples), GetInfo().sample_rate,
-                              STREAM_SAMPLE_RATE);
+        MICROPROFILE_SCOPE(Audio_Resample);
+        const PerfCounters::ScopedTimer timer{PerfCounters::Stage::Resample};
+
+        const double ratio = GetInterpolationRatio(GetInfo().sample_rate, STREAM_SAMPLE_RATE);
+        const std::size_t num_frames = samples.size() / STREAM_NUM_CHANNELS;
+        resampled.resize(GetMaxInterpolatedFrames(num_frames, ratio) * STREAM_NUM_CHANNELS);
+        const std::size_t num_resampled =
+            Interpolate(interp_state, samples.data(), num_frames, resampled.data(), ratio);
+        resampled.resize(num_resampled * STREAM_NUM_CHANNELS);
+        // Swap instead of moving, so the scratch buffer keeps an allocation for the next chunk
+        samples.swap(resampled);
     }
-
-    is_refresh_pending = false;
 }
 
 void AudioRenderer::EffectState::UpdateState(Memory::Memory& memory) {
@@ -327,44 +433,79 @@ void AudioRenderer::EffectState::UpdateState(Memory::Memory& memory) {
     }
 }
 
-static constexpr s16 ClampToS16(s32 value) {
-    return static_cast<s16>(std::clamp(value, -32768, 32767));
+void AudioRenderer::ProcessMixCommand(const MixCommand& command) {
+    for (std::size_t index = 0; index < voices.size(); ++index) {
+        auto& voice = voices[index];
+        voice.GetInfo() = command.voice_infos[index];
+        voice.UpdateState();
+        if (voice.GetInfo().is_in_use && voice.GetInfo().is_new) {
+            voice.SetWaveIndex(voice.GetInfo().wave_buffer_head);
+        }
+    }
+
+    std::vector<std::pair<Buffer::Tag, std::vector<s16>>> buffers;
+    for (const Buffer::Tag tag : command.tags) {
+        buffers.emplace_back(tag, MixBuffer());
+    }
+
+    std::lock_guard lock{mix_mutex};
+    for (std::size_t index = 0; index < voices.size(); ++index) {
+        voice_out_status[index] = voices[index].GetOutStatus();
+    }
+    std::move(buffers.begin(), buffers.end(), std::back_inserter(mixed_buffers));
 }
 
-void AudioRenderer::QueueMixedBuffer(Buffer::Tag tag) {
-    constexpr std::size_t BUFFER_SIZE{512};
-    std::vector<s16> buffer(BUFFER_SIZE * stream->GetNumChannels());
+std::vector<s16> AudioRenderer::MixBuffer() {
+    std::fill(mix_bus.begin(), mix_bus.end(), 0.0f);
 
+    u32 active_voices = 0;
+    u64 mixed_samples = 0;
     for (auto& voice : voices) {
         if (!voice.IsPlaying()) {
             continue;
         }
+        MICROPROFILE_SCOPE(Audio_Voice);
+        ++active_voices;
 
         std::size_t offset{};
-        s64 samples_remaining{BUFFER_SIZE};
+        std::size_t samples_remaining{MIX_BUFFER_SIZE};
         while (samples_remaining > 0) {
-            const std::vector<s16> samples{voice.DequeueSamples(samples_remaining, memory)};
+            std::size_t num_samples{};
+            const s16* const samples{voice.DequeueSamples(samples_remaining, memory, num_samples)};
 
-            if (samples.empty()) {
+            if (num_samples == 0) {
                 break;
             }
 
-            samples_remaining -= samples.size() / stream->GetNumChannels();
+            samples_remaining -= num_samples / STREAM_NUM_CHANNELS;
+            mixed_samples += num_samples;
 
-            for (const auto& sample : samples) {
-                const s32 buffer_sample{buffer[offset]};
-                buffer[offset++] =
-                    ClampToS16(buffer_sample + static_cast<s32>(sample * voice.GetInfo().volume));
-            }
+            MICROPROFILE_SCOPE(Audio_Mix);
+            const PerfCounters::ScopedTimer timer{PerfCounters::Stage::Mix};
+            MixSamples(mix_bus.data() + offset, samples, num_samples, voice.GetInfo().volume);
+            offset += num_samples;
         }
     }
-    audio_out->QueueBuffer(stream, tag, std::move(buffer));
+
+    // Clamping once after every voice is mixed keeps loud voices from clipping the quiet ones
+    std::vector<s16> buffer(mix_bus.size());
+    {
+        MICROPROFILE_SCOPE(Audio_Mix);
+        const PerfCounters::ScopedTimer timer{PerfCounters::Stage::Mix};
+        ResolveMixBus(buffer.data(), mix_bus.data(), buffer.size());
+    }
+    PerfCounters::GetInstance().AddMixedBuffer(active_voices, mixed_samples);
+    return buffer;
 }
 
-void AudioRenderer::ReleaseAndQueueBuffers() {
-    const auto released_buffers{audio_out->GetTagsAndReleaseBuffers(stream, 2)};
-    for (const auto& tag : released_buffers) {
-        QueueMixedBuffer(tag);
+void AudioRenderer::QueueMixedBuffers() {
+    std::vector<std::pair<Buffer::Tag, std::vector<s16>>> buffers;
+    {
+        std::lock_guard lock{mix_mutex};
+        buffers.swap(mixed_buffers);
+    }
+    for (auto& [tag, samples] : buffers) {
+        audio_out->QueueBuffer(stream, tag, std::move(samples));
     }
 }
 
@@ -6,12 +6,15 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "audio_core/stream.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/hle/kernel/object.h"
 
 namespace Core::Timing {
@@ -227,8 +230,6 @@ public:
     ~AudioRenderer();
 
     std::vector<u8> UpdateAudioRenderer(const std::vector<u8>& input_params);
-    void QueueMixedBuffer(Buffer::Tag tag);
-    void ReleaseAndQueueBuffers();
     u32 GetSampleRate() const;
     u32 GetSampleCount() const;
     u32 GetMixBufferCount() const;
@@ -238,13 +239,38 @@ private:
     class EffectState;
     class VoiceState;
 
+    /// Work handed from the IPC thread to the DSP thread by every update
+    struct MixCommand {
+        std::vector<VoiceInfo> voice_infos; ///< Voice parameters written by the game
+        std::vector<Buffer::Tag> tags;      ///< Released buffers to mix again
+    };
+
+    /// Applies a command to the voices and mixes its buffers, on the DSP thread.
+    void ProcessMixCommand(const MixCommand& command);
+
+    /// Mixes the next buffer of every playing voice, on the DSP thread.
+    std::vector<s16> MixBuffer();
+
+    /// Queues the buffers the DSP thread has finished mixing for playback.
+    void QueueMixedBuffers();
+
     AudioRendererParameter worker_params;
     std::shared_ptr<Kernel::WritableEvent> buffer_event;
-    std::vector<VoiceState> voices;
     std::vector<EffectState> effects;
     std::unique_ptr<AudioOut> audio_out;
     StreamPtr stream;
     Memory::Memory& memory;
+
+    // Owned by the DSP thread
+    std::vector<VoiceState> voices;
+    std::vector<float> mix_bus; ///< Voices are mixed here before being converted to PCM16
+
+    // Results of the DSP thread, picked up by the next update
+    std::mutex mix_mutex;
+    std::vector<VoiceOutStatus> voice_out_status;
+    std::vector<std::pair<Buffer::Tag, std::vector<s16>>> mixed_buffers;
+
+    Common::TaskGroup mix_tasks;
 };
 
 } // namespace AudioCore
@@ -31,6 +31,11 @@ struct ADPCMState {
 
 using ADPCM_Coeff = std::array<s16, 16>;
 
+/// Size in bytes of an ADPCM frame
+constexpr std::size_t ADPCM_FRAME_SIZE = 8;
+/// Number of samples every ADPCM frame decodes to
+constexpr std::size_t ADPCM_SAMPLES_PER_FRAME = 14;
+
 /**
  * @param data Pointer to buffer that contains ADPCM data to decode
  * @param size Size of buffer in bytes
@@ -41,4 +46,16 @@ using ADPCM_Coeff = std::array<s16, 16>;
 std::vector<s16> DecodeADPCM(const u8* const data, std::size_t size, const ADPCM_Coeff& coeff,
                              ADPCMState& state);
 
+/**
+ * Decodes whole ADPCM frames into an existing buffer, so a wave buffer can be decoded a few
+ * frames at a time
+ * @param data Pointer to the ADPCM frames to decode
+ * @param num_frames Number of frames to decode
+ * @param coeff ADPCM coefficients
+ * @param state ADPCM state, this is updated with new state
+ * @param output Buffer that receives ADPCM_SAMPLES_PER_FRAME samples for every frame
+ */
+void DecodeADPCMFrames(const u8* data, std::size_t num_frames, const ADPCM_Coeff& coeff,
+                       ADPCMState& state, s16* output);
+
 }; // namespace AudioCore::Codec
@@ -6,6 +6,7 @@
 #include <atomic>
 #include <cstring>
 #include "audio_core/cubeb_sink.h"
+#include "audio_core/perf_counters.h"
 #include "audio_core/stream.h"
 #include "audio_core/time_stretch.h"
 #include "common/logging/log.h"
@@ -18,6 +19,16 @@
 
 namespace AudioCore {
 
+namespace {
+
+/// Time the sink queue may grow to when the target latency is raised after underruns
+constexpr u32 MAX_TARGET_LATENCY_MS = 250;
+
+/// Time without underruns after which the target latency is lowered again
+constexpr u32 LATENCY_DECAY_MS = 5000;
+
+} // Anonymous namespace
+
 class CubebSinkStream final : public SinkStream {
 public:
     CubebSinkStream(cubeb* ctx, u32 sample_rate, u32 num_channels_, cubeb_devid output_device,
@@ -36,8 +47,17 @@ public:
             LOG_CRITICAL(Audio_Sink, "Error getting minimum latency");
         }
 
+        // Start with a queue of two callbacks worth of frames, raised on underruns
+        const u32 latency_frames = std::max(512u, minimum_latency);
+        min_target_frames = latency_frames * 2;
+        max_target_frames = std::max<std::size_t>(
+            min_target_frames, std::min<std::size_t>(sample_rate * MAX_TARGET_LATENCY_MS / 1000,
+                                                     queue.Capacity() / 2 / num_channels));
+        target_frames = min_target_frames;
+        decay_frames = sample_rate * LATENCY_DECAY_MS / 1000;
+
         if (cubeb_stream_init(ctx, &stream_backend, name.c_str(), nullptr, nullptr, output_device,
-                              &params, std::max(512u, minimum_latency),
+                              &params, latency_frames,
                               &CubebSinkStream::DataCallback, &CubebSinkStream::StateCallback,
                               this) != CUBEB_OK) {
             LOG_CRITICAL(Audio_Sink, "Error initializing cubeb stream");
@@ -63,20 +83,33 @@ public:
     }
 
     void EnqueueSamples(u32 source_num_channels, const std::vector<s16>& samples) override {
+        const std::vector<s16>* input = &samples;
         if (source_num_channels > num_channels) {
             // Downsample 6 channels to 2
-            std::vector<s16> buf;
-            buf.reserve(samples.size() * num_channels / source_num_channels);
+            downmixed.clear();
             for (std::size_t i = 0; i < samples.size(); i += source_num_channels) {
                 for (std::size_t ch = 0; ch < num_channels; ch++) {
-                    buf.push_back(samples[i + ch]);
+                    downmixed.push_back(samples[i + ch]);
                 }
             }
-            queue.Push(buf);
+            input = &downmixed;
+        }
+
+        if (!Settings::values.enable_audio_stretching) {
+            queue.Push(*input);
             return;
         }
 
-        queue.Push(samples);
+        // Stretching runs here rather than in the data callback, which only copies out of the
+        // queue, so a loaded host can't make the callback miss its deadline
+        const std::size_t num_frames = input->size() / num_channels;
+        UpdateTargetLatency(num_frames);
+        const double fill_level = static_cast<double>(queue.Size() / num_channels) /
+                                  static_cast<double>(target_frames);
+        stretched.clear();
+        time_stretch.Process(input->data(), num_frames, fill_level, stretched);
+        queue.Push(stretched);
+        has_stretched_samples = true;
     }
 
     std::size_t SamplesInQueue(u32 channel_count) const override {
@@ -87,7 +120,15 @@ public:
     }
 
     void Flush() override {
-        should_flush = true;
+        // Underruns while nothing is being played don't count against the target latency
+        is_idle = true;
+        if (!has_stretched_samples) {
+            return;
+        }
+        stretched.clear();
+        time_stretch.Flush(stretched);
+        queue.Push(stretched);
+        has_stretched_samples = false;
     }
 
     u32 GetNumChannels() const {
@@ -95,6 +136,32 @@ public:
     }
 
 private:
+    /// Raises the target latency after underruns, and lowers it back slowly while playback is
+    /// smooth. Called from the producer with the number of frames about to be queued.
+    void UpdateTargetLatency(std::size_t num_frames) {
+        const u32 current_underruns = underruns.load(std::memory_order_relaxed);
+        if (is_idle) {
+            is_idle = false;
+            seen_underruns = current_underruns;
+            return;
+        }
+
+        if (current_underruns != seen_underruns) {
+            seen_underruns = current_underruns;
+            stable_frames = 0;
+            target_frames = std::min(target_frames * 3 / 2, max_target_frames);
+            LOG_DEBUG(Audio_Sink, "Underrun, target latency raised to {} frames", target_frames);
+            return;
+        }
+
+        stable_frames += num_frames;
+        if (stable_frames >= decay_frames && target_frames > min_target_frames) {
+            stable_frames = 0;
+            target_frames = std::max(target_frames * 7 / 8, min_target_frames);
+            LOG_DEBUG(Audio_Sink, "Target latency lowered to {} frames", target_frames);
+        }
+    }
+
     std::vector<std::string> device_list;
 
     cubeb* ctx{};
@@ -103,9 +170,22 @@ private:
 
     Common::RingBuffer<s16, 0x10000> queue;
     std::array<s16, 2> last_frame{};
-    std::atomic<bool> should_flush{};
+    std::atomic<u32> underruns{}; ///< Callbacks that ran out of queued samples
+    bool is_callback_playing{};   ///< Whether the last callback was filled, only used by it
     TimeStretcher time_stretch;
 
+    // Only touched by the producer
+    std::vector<s16> downmixed;
+    std::vector<s16> stretched;
+    bool has_stretched_samples{};
+    bool is_idle{true};
+    u32 seen_underruns{};
+    std::size_t min_target_frames{};
+    std::size_t max_target_frames{};
+    std::size_t target_frames{};
+    std::size_t decay_frames{};
+    std::size_t stable_frames{};
+
     static long DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
                              void* output_buffer, long num_frames);
     static void StateCallback(cubeb_stream* stream, void* user_data, cubeb_state state);
@@ -177,23 +257,15 @@ long CubebSinkStream::DataCallback(cubeb_stream* stream, void* user_data, const
 
     const std::size_t num_channels = impl->GetNumChannels();
     const std::size_t samples_to_write = num_channels * num_frames;
-    std::size_t samples_written;
-
-    if (Settings::values.enable_audio_stretching) {
-        const std::vector<s16> in{impl->queue.Pop()};
-        const std::size_t num_in{in.size() / num_channels};
-        s16* const out{reinterpret_cast<s16*>(buffer)};
-        const std::size_t out_frames =
-            impl->time_stretch.Process(in.data(), num_in, out, num_frames);
-        samples_written = out_frames * num_channels;
-
-        if (impl->should_flush) {
-            impl->time_stretch.Flush();
-            impl->should_flush = false;
+    const std::size_t samples_written = impl->queue.Pop(buffer, samples_to_write);
+    if (samples_written < samples_to_write) {
+        impl->underruns.fetch_add(1, std::memory_order_relaxed);
+        // Only the first short callback of a dropout is reported, idle streams are always short
+        if (impl->is_callback_playing) {
+            PerfCounters::GetInstance().AddUnderrun();
         }
-    } else {
-        samples_written = impl->queue.Pop(buffer, samples_to_write);
     }
+    impl->is_callback_playing = samples_written == samples_to_write;
 
     if (samples_written >= num_channels) {
         std::memcpy(&impl->last_frame[0], buffer + (samples_written - num_channels) * sizeof(s16),
@@ -0,0 +1,47 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "audio_core/perf_counters.h"
+
+namespace AudioCore {
+
+PerfCounters& PerfCounters::GetInstance() {
+    static PerfCounters instance;
+    return instance;
+}
+
+void PerfCounters::AddTime(Stage stage, std::chrono::nanoseconds time) {
+    stage_ns[static_cast<std::size_t>(stage)].fetch_add(static_cast<u64>(time.count()),
+                                                        std::memory_order_relaxed);
+}
+
+void PerfCounters::AddMixedBuffer(u32 num_voices, u64 num_samples) {
+    active_voices.store(num_voices, std::memory_order_relaxed);
+    mixed_samples.fetch_add(num_samples, std::memory_order_relaxed);
+}
+
+void PerfCounters::AddUpdate() {
+    updates.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::AddUnderrun() {
+    underruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+PerfCounters::Results PerfCounters::GetAndReset(double interval) {
+    Results results{};
+    const u64 num_updates = updates.exchange(0, std::memory_order_relaxed);
+    for (std::size_t stage = 0; stage < stage_ns.size(); ++stage) {
+        const u64 ns = stage_ns[stage].exchange(0, std::memory_order_relaxed);
+        results.stage_times[stage] =
+            num_updates == 0 ? 0.0 : static_cast<double>(ns) / 1e9 / num_updates;
+    }
+    results.active_voices = active_voices.load(std::memory_order_relaxed);
+    results.samples_per_second =
+        static_cast<double>(mixed_samples.exchange(0, std::memory_order_relaxed)) / interval;
+    results.underruns = underruns.exchange(0, std::memory_order_relaxed);
+    return results;
+}
+
+} // namespace AudioCore
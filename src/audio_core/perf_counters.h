@@ -0,0 +1,78 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/**
+ * Process wide counters of the work done by the audio renderers and sinks. Core::PerfStats reads
+ * and resets them along with the rest of the performance statistics. Every function can be called
+ * from any thread, including the real-time callbacks of the sinks.
+ */
+class PerfCounters {
+public:
+    enum class Stage : std::size_t {
+        Decode,
+        Resample,
+        Mix,
+        Effects,
+        Count,
+    };
+
+    struct Results {
+        u32 active_voices;         ///< Voices that played in the last mixed buffer
+        double samples_per_second; ///< Voice samples mixed per second of walltime
+        /// Average walltime spent on each stage per renderer update, in seconds
+        std::array<double, static_cast<std::size_t>(Stage::Count)> stage_times;
+        u64 underruns; ///< Times a sink ran out of samples to play
+    };
+
+    /// Measures the lifetime of the timer as time spent on a stage.
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Stage stage_) : stage{stage_}, start{Clock::now()} {}
+        ~ScopedTimer() {
+            GetInstance().AddTime(stage, Clock::now() - start);
+        }
+
+    private:
+        Stage stage;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static PerfCounters& GetInstance();
+
+    void AddTime(Stage stage, std::chrono::nanoseconds time);
+
+    /// Records a mixed buffer.
+    /// @param active_voices Number of voices mixed into the buffer.
+    /// @param num_samples Number of voice samples mixed, counting every channel of every voice.
+    void AddMixedBuffer(u32 active_voices, u64 num_samples);
+
+    /// Records a renderer update, the unit of the stage times.
+    void AddUpdate();
+
+    void AddUnderrun();
+
+    /// Returns the counters accumulated over interval seconds of walltime and resets them.
+    Results GetAndReset(double interval);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::array<std::atomic<u64>, static_cast<std::size_t>(Stage::Count)> stage_ns{};
+    std::atomic<u32> active_voices{};
+    std::atomic<u64> mixed_samples{};
+    std::atomic<u64> updates{};
+    std::atomic<u64> underruns{};
+};
+
+} // namespace AudioCore
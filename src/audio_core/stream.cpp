@@ -19,6 +19,10 @@ namespace AudioCore {
 
 constexpr std::size_t MaxAudioBufferCount{32};
 
+/// Minimum time between two releases. Buffers that finish playing in between are released and
+/// signalled together, so titles queueing many tiny buffers don't flood CoreTiming and the guest.
+constexpr std::chrono::microseconds ReleaseBatchInterval{2000};
+
 u32 Stream::GetNumChannels() const {
     switch (format) {
     case Format::Mono16:
@@ -38,7 +42,7 @@ Stream::Stream(Core::Timing::CoreTiming& core_timing, u32 sample_rate, Format fo
       sink_stream{sink_stream}, core_timing{core_timing}, name{std::move(name_)} {
 
     release_event = Core::Timing::CreateEvent(
-        name, [this](u64 userdata, s64 cycles_late) { ReleaseActiveBuffer(); });
+        name, [this](u64 userdata, s64 cycles_late) { ReleaseActiveBuffers(); });
 }
 
 void Stream::Play() {
@@ -87,31 +91,65 @@ void Stream::PlayNextBuffer() {
         return;
     }
 
-    if (active_buffer) {
-        // Do not queue a new buffer if we are already playing a buffer
+    if (is_release_scheduled) {
+        // Queued buffers are picked up when the pending release runs
         return;
     }
 
-    if (queued_buffers.empty()) {
-        // No queued buffers - we are effectively paused
-        sink_stream.Flush();
-        return;
+    const u64 now = core_timing.GetTicks();
+    if (active_buffers.empty()) {
+        // Starting from idle, the first buffer plays from now on
+        play_cursor_ticks = now;
     }
 
-    active_buffer = queued_buffers.front();
-    queued_buffers.pop();
+    const auto play_buffer = [this] {
+        BufferPtr buffer = std::move(queued_buffers.front());
+        queued_buffers.pop();
 
-    VolumeAdjustSamples(active_buffer->GetSamples(), game_volume);
+        VolumeAdjustSamples(buffer->GetSamples(), game_volume);
+        sink_stream.EnqueueSamples(GetNumChannels(), buffer->GetSamples());
 
-    sink_stream.EnqueueSamples(GetNumChannels(), active_buffer->GetSamples());
+        play_cursor_ticks += GetBufferReleaseCycles(*buffer);
+        active_buffers.push({std::move(buffer), play_cursor_ticks});
+    };
 
-    core_timing.ScheduleEvent(GetBufferReleaseCycles(*active_buffer), release_event, {});
+    if (active_buffers.empty()) {
+        if (queued_buffers.empty()) {
+            // No queued buffers - we are effectively paused
+            sink_stream.Flush();
+            return;
+        }
+        play_buffer();
+    }
+
+    // Buffers that start before the next release go to the sink now, so playback stays gapless
+    // while the release is held back
+    const u64 batch_ticks = Core::Timing::usToCycles(ReleaseBatchInterval);
+    const u64 release_ticks =
+        std::max({active_buffers.front().release_ticks, last_release_ticks + batch_ticks, now});
+    while (!queued_buffers.empty() && play_cursor_ticks < release_ticks) {
+        play_buffer();
+    }
+
+    core_timing.ScheduleEvent(static_cast<s64>(release_ticks - now), release_event, {});
+    is_release_scheduled = true;
 }
 
-void Stream::ReleaseActiveBuffer() {
-    ASSERT(active_buffer);
-    released_buffers.push(std::move(active_buffer));
-    release_callback();
+void Stream::ReleaseActiveBuffers() {
+    is_release_scheduled = false;
+
+    const u64 now = core_timing.GetTicks();
+    last_release_ticks = now;
+    bool has_released = false;
+    while (!active_buffers.empty() && active_buffers.front().release_ticks <= now) {
+        released_buffers.push(std::move(active_buffers.front().buffer));
+        active_buffers.pop();
+        has_released = true;
+    }
+
+    if (has_released) {
+        release_callback();
+    }
     PlayNextBuffer();
 }
 
@@ -89,13 +89,20 @@ public:
     State GetState() const;
 
 private:
-    /// Plays the next queued buffer in the audio stream, starting playback if necessary
+    /// A buffer handed to the sink, with the time its last sample is played
+    struct ActiveBuffer {
+        BufferPtr buffer;
+        u64 release_ticks;
+    };
+
+    /// Hands queued buffers to the sink up to the next release, starting playback if necessary,
+    /// and schedules that release
     void PlayNextBuffer();
 
-    /// Releases the actively playing buffer, signalling that it has been completed
-    void ReleaseActiveBuffer();
+    /// Releases every active buffer that has been played, signalling them together
+    void ReleaseActiveBuffers();
 
-    /// Gets the number of core cycles when the specified buffer will be released
+    /// Gets the number of core cycles the specified buffer takes to play
     s64 GetBufferReleaseCycles(const Buffer& buffer) const;
 
     u32 sample_rate;                  ///< Sample rate of the stream
@@ -104,13 +111,16 @@ private:
     ReleaseCallback release_callback; ///< Buffer release callback for the stream
     State state{State::Stopped};      ///< Playback state of the stream
     std::shared_ptr<Core::Timing::EventType>
-        release_event;                      ///< Core timing release event for the stream
-    BufferPtr active_buffer;                ///< Actively playing buffer in the stream
-    std::queue<BufferPtr> queued_buffers;   ///< Buffers queued to be played in the stream
-    std::queue<BufferPtr> released_buffers; ///< Buffers recently released from the stream
-    SinkStream& sink_stream;                ///< Output sink for the stream
-    Core::Timing::CoreTiming& core_timing;  ///< Core timing instance.
-    std::string name;                       ///< Name of the stream, must be unique
+        release_event;                       ///< Core timing release event for the stream
+    bool is_release_scheduled{};             ///< Whether release_event is pending
+    u64 last_release_ticks{};                ///< Time release_event last ran
+    u64 play_cursor_ticks{};                 ///< Time the last active buffer finishes playing
+    std::queue<ActiveBuffer> active_buffers; ///< Buffers handed to the sink, in play order
+    std::queue<BufferPtr> queued_buffers;    ///< Buffers queued to be played in the stream
+    std::queue<BufferPtr> released_buffers;  ///< Buffers recently released from the stream
+    SinkStream& sink_stream;                 ///< Output sink for the stream
+    Core::Timing::CoreTiming& core_timing;   ///< Core timing instance.
+    std::string name;                        ///< Name of the stream, must be unique
 };
 
 using StreamPtr = std::shared_ptr<Stream>;
@@ -10,7 +10,8 @@
 
 namespace AudioCore {
 
-TimeStretcher::TimeStretcher(u32 sample_rate, u32 channel_count) : m_sample_rate{sample_rate} {
+TimeStretcher::TimeStretcher(u32 sample_rate, u32 channel_count)
+    : m_sample_rate{sample_rate}, m_channel_count{channel_count} {
     m_sound_touch.setChannels(channel_count);
     m_sound_touch.setSampleRate(sample_rate);
     m_sound_touch.setPitch(1.0);
@@ -19,37 +20,33 @@ TimeStretcher::TimeStretcher(u32 sample_rate, u32 channel_count) : m_sample_rate
 
 void TimeStretcher::Clear() {
     m_sound_touch.clear();
+    m_stretch_ratio = 1.0;
+    m_integral = 0.0;
 }
 
-void TimeStretcher::Flush() {
+void TimeStretcher::Flush(std::vector<s16>& out) {
     m_sound_touch.flush();
+    ReceiveSamples(out);
 }
 
-std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
-                                   std::size_t num_out) {
-    const double time_delta = static_cast<double>(num_out) / m_sample_rate; // seconds
+void TimeStretcher::Process(const s16* in, std::size_t num_in, double fill_level,
+                            std::vector<s16>& out) {
+    const double time_delta = static_cast<double>(num_in) / m_sample_rate; // seconds
 
-    // We were given actual_samples number of samples, and num_samples were requested from us.
-    double current_ratio = static_cast<double>(num_in) / static_cast<double>(num_out);
-
-    const double max_latency = 0.25; // seconds
-    const double max_backlog = m_sample_rate * max_latency;
-    const double backlog_fullness = m_sound_touch.numSamples() / max_backlog;
-    if (backlog_fullness > 4.0) {
-        // Too many samples in backlog: Don't push anymore on
-        num_in = 0;
-    }
-
-    // We ideally want the backlog to be about 50% full.
-    // This gives some headroom both ways to prevent underflow and overflow.
-    // We tweak current_ratio to encourage this.
-    constexpr double tweak_time_scale = 0.05; // seconds
-    const double tweak_correction = (backlog_fullness - 0.5) * (time_delta / tweak_time_scale);
-    current_ratio *= std::pow(1.0 + 2.0 * tweak_correction, tweak_correction < 0 ? 3.0 : 1.0);
+    // A proportional-integral controller on the fill level of the sink queue. A queue that is too
+    // full speeds the tempo up, one that is running dry slows it down. The integral settles on
+    // the ratio between the speed of the game and real time, so the queue stays on target even
+    // when the game produces samples too slowly for a long time.
+    constexpr double proportional_gain = 0.5;
+    constexpr double integral_time_scale = 1.0; // seconds
+    const double error = std::clamp(fill_level, 0.0, 4.0) - 1.0;
+    m_integral += proportional_gain * error * time_delta / integral_time_scale;
+    m_integral = std::clamp(m_integral, -0.95, 3.0);
+    const double current_ratio = 1.0 + proportional_gain * error + m_integral;
 
     // This low-pass filter smoothes out variance in the calculated stretch ratio.
     // The time-scale determines how responsive this filter is.
-    constexpr double lpf_time_scale = 0.712; // seconds
+    constexpr double lpf_time_scale = 0.25; // seconds
     const double lpf_gain = 1.0 - std::exp(-time_delta / lpf_time_scale);
     m_stretch_ratio += lpf_gain * (current_ratio - m_stretch_ratio);
 
@@ -58,11 +55,19 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
     m_stretch_ratio = std::max(m_stretch_ratio, 0.05);
     m_sound_touch.setTempo(m_stretch_ratio);
 
-    LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} backlog:{:0.6f}", num_in, num_out, m_stretch_ratio,
-              backlog_fullness);
+    LOG_TRACE(Audio, "{:5} ratio:{:0.6f} fill:{:0.6f}", num_in, m_stretch_ratio, fill_level);
 
     m_sound_touch.putSamples(in, static_cast<u32>(num_in));
-    return m_sound_touch.receiveSamples(out, static_cast<u32>(num_out));
+    ReceiveSamples(out);
+}
+
+void TimeStretcher::ReceiveSamples(std::vector<s16>& out) {
+    const std::size_t num_available = m_sound_touch.numSamples();
+    const std::size_t offset = out.size();
+    out.resize(offset + num_available * m_channel_count);
+    const std::size_t num_received = m_sound_touch.receiveSamples(
+        out.data() + offset, static_cast<u32>(num_available));
+    out.resize(offset + num_received * m_channel_count);
 }
 
 } // namespace AudioCore
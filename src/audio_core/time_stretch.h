@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 #include <SoundTouch.h>
 #include "common/common_types.h"
 
@@ -14,21 +15,27 @@ class TimeStretcher {
 public:
     TimeStretcher(u32 sample_rate, u32 channel_count);
 
-    /// @param in       Input sample buffer
-    /// @param num_in   Number of input frames in `in`
-    /// @param out      Output sample buffer
-    /// @param num_out  Desired number of output frames in `out`
-    /// @returns Actual number of frames written to `out`
-    std::size_t Process(const s16* in, std::size_t num_in, s16* out, std::size_t num_out);
+    /// Stretches samples on their way into a sink queue, changing the tempo to steer the queue
+    /// towards its target fill level.
+    /// @param in          Input sample buffer
+    /// @param num_in      Number of input frames in `in`
+    /// @param fill_level  Frames queued in the sink divided by the target, 1.0 is on target
+    /// @param out         Output sample buffer, the stretched frames are appended to it
+    void Process(const s16* in, std::size_t num_in, double fill_level, std::vector<s16>& out);
 
     void Clear();
 
-    void Flush();
+    /// Pushes out the samples held back by the stretcher, appending them to `out`
+    void Flush(std::vector<s16>& out);
 
 private:
+    void ReceiveSamples(std::vector<s16>& out);
+
     u32 m_sample_rate;
+    u32 m_channel_count;
     soundtouch::SoundTouch m_sound_touch;
     double m_stretch_ratio = 1.0;
+    double m_integral = 0.0;
 };
 
 } // namespace AudioCore
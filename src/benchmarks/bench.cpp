@@ -0,0 +1,9 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// Catch provides the main function and the benchmark runner. Run with
+// "--reporter xml --out results.xml" to keep the results of a run.
@@ -0,0 +1,58 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/catch.hpp>
+#include "common/bit_field.h"
+#include "common/common_types.h"
+
+namespace {
+
+union Instruction {
+    u64 raw;
+    BitField<0, 8, u64> gpr0;
+    BitField<8, 8, u64> gpr8;
+    BitField<20, 19, s64> immediate;
+    BitField<39, 8, u64> gpr39;
+    BitField<48, 16, u64> opcode;
+};
+
+/// Shader instructions appear in bursts, so decode a whole block at once
+std::array<Instruction, 1024> MakeInstructions() {
+    std::array<Instruction, 1024> instructions;
+    u64 state = 0x9E3779B97F4A7C15;
+    for (Instruction& instruction : instructions) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        instruction.raw = state;
+    }
+    return instructions;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("BitField", "[common]") {
+    auto instructions = MakeInstructions();
+
+    BENCHMARK("Extract") {
+        u64 sum = 0;
+        for (const Instruction& instruction : instructions) {
+            sum += instruction.gpr0 + instruction.gpr8 + instruction.gpr39 + instruction.opcode +
+                   static_cast<u64>(instruction.immediate.Value());
+        }
+        return sum;
+    };
+
+    BENCHMARK("Assign") {
+        u64 value = 0;
+        for (Instruction& instruction : instructions) {
+            instruction.gpr0.Assign(value);
+            instruction.immediate.Assign(-static_cast<s64>(value));
+            instruction.opcode.Assign(value >> 8);
+            ++value;
+        }
+        return instructions[0].raw;
+    };
+}
@@ -0,0 +1,58 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/lz4_compression.h"
+#include "common/zstd_compression.h"
+
+namespace {
+
+constexpr std::size_t INPUT_SIZE = 1 << 20;
+
+/// Code-like data: runs of repeated words mixed with noise, roughly as compressible as the
+/// executables and shader binaries that are compressed in practice
+std::vector<u8> MakeInput() {
+    std::vector<u8> input(INPUT_SIZE);
+    u32 state = 0x12345678;
+    for (std::size_t i = 0; i < input.size(); i += 4) {
+        state = state * 1664525 + 1013904223;
+        const u32 word = (state >> 24) < 160 ? static_cast<u32>(i / 64) : state;
+        for (std::size_t byte = 0; byte < 4; ++byte) {
+            input[i + byte] = static_cast<u8>(word >> (byte * 8));
+        }
+    }
+    return input;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Compression", "[common]") {
+    const std::vector<u8> input = MakeInput();
+
+    // NSO segments are LZ4 compressed and decompressed into their final location on load
+    const std::vector<u8> lz4 = Common::Compression::CompressDataLZ4(input.data(), input.size());
+    BENCHMARK("LZ4 compress") {
+        return Common::Compression::CompressDataLZ4(input.data(), input.size());
+    };
+    BENCHMARK_ADVANCED("LZ4 decompress")(Catch::Benchmark::Chronometer meter) {
+        std::vector<u8> output(input.size());
+        meter.measure([&] {
+            return Common::Compression::DecompressDataLZ4(lz4.data(), lz4.size(), output.data(),
+                                                          output.size());
+        });
+    };
+
+    // The shader cache stores its precompiled binaries with zstd at the default level
+    const std::vector<u8> zstd =
+        Common::Compression::CompressDataZSTDDefault(input.data(), input.size());
+    BENCHMARK("zstd compress (default level)") {
+        return Common::Compression::CompressDataZSTDDefault(input.data(), input.size());
+    };
+    BENCHMARK("zstd decompress") {
+        return Common::Compression::DecompressDataZSTD(zstd);
+    };
+}
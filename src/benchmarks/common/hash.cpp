@@ -0,0 +1,42 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "common/hash.h"
+
+namespace {
+
+std::vector<char> MakeInput(std::size_t size) {
+    std::vector<char> input(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        input[i] = static_cast<char>(i * 31 + (i >> 8));
+    }
+    return input;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Hash", "[common]") {
+    // From the size of a cache key to the size of a large shader program or texture
+    for (const std::size_t size : {16, 256, 1024, 4096, 16384, 65536}) {
+        const std::vector<char> input = MakeInput(size);
+
+        BENCHMARK("CityHash64 " + std::to_string(size) + " bytes") {
+            return Common::CityHash64(input.data(), input.size());
+        };
+
+        BENCHMARK("CityHash128 " + std::to_string(size) + " bytes") {
+            return Common::CityHash128(input.data(), input.size());
+        };
+
+        BENCHMARK("HashValue " + std::to_string(size) + " bytes") {
+            return Common::HashValue(input.data(), input.size());
+        };
+    }
+}
@@ -0,0 +1,86 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/multi_level_queue.h"
+
+namespace {
+
+/// Same shape as the scheduler queues: 64 priorities and a few dozen threads
+constexpr std::size_t NUM_ELEMENTS = 48;
+
+struct QueueElement {
+    u32 priority;
+    Common::MultiLevelQueueNode<QueueElement> node;
+};
+
+struct QueueElementAccessor {
+    Common::MultiLevelQueueNode<QueueElement>& operator()(QueueElement& element) const {
+        return element.node;
+    }
+};
+
+using IntrusiveQueue = Common::IntrusiveMultiLevelQueue<QueueElement, 64, QueueElementAccessor>;
+
+std::array<QueueElement, NUM_ELEMENTS> MakeElements() {
+    std::array<QueueElement, NUM_ELEMENTS> elements{};
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        elements[i].priority = static_cast<u32>((i * 37) % 64);
+    }
+    return elements;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MultiLevelQueue", "[common]") {
+    auto elements = MakeElements();
+
+    BENCHMARK_ADVANCED("MultiLevelQueue add/front/remove")(Catch::Benchmark::Chronometer meter) {
+        Common::MultiLevelQueue<QueueElement*, 64> mlq;
+        meter.measure([&] {
+            for (QueueElement& element : elements) {
+                mlq.add(&element, element.priority);
+            }
+            while (!mlq.empty()) {
+                QueueElement* const element = mlq.front();
+                mlq.remove(element, element->priority);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("MultiLevelQueue yield")(Catch::Benchmark::Chronometer meter) {
+        Common::MultiLevelQueue<QueueElement*, 64> mlq;
+        for (QueueElement& element : elements) {
+            mlq.add(&element, 0);
+        }
+        meter.measure([&] { mlq.yield(0); });
+    };
+
+    BENCHMARK_ADVANCED("IntrusiveMultiLevelQueue add/front/remove")
+    (Catch::Benchmark::Chronometer meter) {
+        IntrusiveQueue mlq{QueueElementAccessor{}};
+        meter.measure([&] {
+            for (QueueElement& element : elements) {
+                mlq.add(&element, element.priority);
+            }
+            while (!mlq.empty()) {
+                mlq.remove(mlq.front());
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("IntrusiveMultiLevelQueue yield")(Catch::Benchmark::Chronometer meter) {
+        IntrusiveQueue mlq{QueueElementAccessor{}};
+        for (QueueElement& element : elements) {
+            mlq.add(&element, 0);
+        }
+        meter.measure([&] { mlq.yield(0); });
+        while (!mlq.empty()) {
+            mlq.remove(mlq.front());
+        }
+    };
+}
@@ -0,0 +1,53 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/ring_buffer.h"
+
+namespace {
+
+/// Audio sinks push stereo s16 frames in chunks of a few milliseconds
+constexpr std::size_t CHUNK_FRAMES = 240;
+
+using AudioRing = Common::RingBuffer<s16, 0x10000, 2>;
+
+} // Anonymous namespace
+
+TEST_CASE("RingBuffer", "[common]") {
+    std::array<s16, CHUNK_FRAMES * 2> chunk{};
+    std::array<s16, CHUNK_FRAMES * 2> output{};
+
+    BENCHMARK_ADVANCED("Push/Pop one thread")(Catch::Benchmark::Chronometer meter) {
+        AudioRing buffer;
+        meter.measure([&] {
+            buffer.Push(chunk.data(), CHUNK_FRAMES);
+            return buffer.Pop(output.data(), CHUNK_FRAMES);
+        });
+    };
+
+    BENCHMARK_ADVANCED("Push with a consumer thread")(Catch::Benchmark::Chronometer meter) {
+        AudioRing buffer;
+        std::atomic_bool stop{false};
+        std::thread consumer([&] {
+            std::array<s16, CHUNK_FRAMES * 2> consumed;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (buffer.Pop(consumed.data(), CHUNK_FRAMES) == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        meter.measure([&] {
+            while (buffer.Push(chunk.data(), CHUNK_FRAMES) == 0) {
+                std::this_thread::yield();
+            }
+        });
+        stop = true;
+        consumer.join();
+    };
+}
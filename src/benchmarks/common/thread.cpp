@@ -0,0 +1,163 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/thread.h"
+
+namespace {
+
+/// Previous Common::Event, built on a mutex and a condition variable
+class CondvarEvent {
+public:
+    void Set() {
+        std::lock_guard lk{mutex};
+        if (!is_set) {
+            is_set = true;
+            condvar.notify_one();
+        }
+    }
+
+    void Wait() {
+        std::unique_lock lk{mutex};
+        condvar.wait(lk, [&] { return is_set; });
+        is_set = false;
+    }
+
+private:
+    bool is_set = false;
+    std::condition_variable condvar;
+    std::mutex mutex;
+};
+
+/// Previous Common::Barrier, built on a mutex and a condition variable
+class CondvarBarrier {
+public:
+    explicit CondvarBarrier(std::size_t count) : count{count} {}
+
+    void Sync() {
+        std::unique_lock lk{mutex};
+        const std::size_t current_generation = generation;
+        if (++waiting == count) {
+            generation++;
+            waiting = 0;
+            condvar.notify_all();
+        } else {
+            condvar.wait(lk,
+                         [this, current_generation] { return current_generation != generation; });
+        }
+    }
+
+private:
+    std::condition_variable condvar;
+    std::mutex mutex;
+    std::size_t count;
+    std::size_t waiting = 0;
+    std::size_t generation = 0;
+};
+
+/// Bounces a signal off a second thread, like the GPU thread and scheduler worker handoffs
+template <typename Event>
+class PingPong {
+public:
+    PingPong() : partner{[this] { Run(); }} {}
+
+    ~PingPong() {
+        stop = true;
+        ping.Set();
+        partner.join();
+    }
+
+    void RoundTrip() {
+        ping.Set();
+        pong.Wait();
+    }
+
+private:
+    void Run() {
+        while (true) {
+            ping.Wait();
+            if (stop) {
+                return;
+            }
+            pong.Set();
+        }
+    }
+
+    Event ping;
+    Event pong;
+    std::atomic<bool> stop{false};
+    std::thread partner;
+};
+
+/// Keeps the other parties of a barrier syncing until destroyed, like the CPU core rounds
+template <typename Barrier>
+class BarrierRounds {
+public:
+    explicit BarrierRounds(std::size_t num_threads) : barrier{num_threads} {
+        for (std::size_t i = 1; i < num_threads; ++i) {
+            threads.emplace_back([this] {
+                // The stop round is published before the final sync, seeing it early is harmless
+                for (u64 round = 1;; ++round) {
+                    barrier.Sync();
+                    if (round == stop_round) {
+                        return;
+                    }
+                }
+            });
+        }
+    }
+
+    ~BarrierRounds() {
+        stop_round = ++rounds;
+        barrier.Sync();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void Sync() {
+        ++rounds;
+        barrier.Sync();
+    }
+
+private:
+    Barrier barrier;
+    u64 rounds = 0;
+    std::atomic<u64> stop_round{std::numeric_limits<u64>::max()};
+    std::vector<std::thread> threads;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Thread", "[common]") {
+    BENCHMARK_ADVANCED("Event round trip, condition variable")
+    (Catch::Benchmark::Chronometer meter) {
+        PingPong<CondvarEvent> ping_pong;
+        meter.measure([&] { ping_pong.RoundTrip(); });
+    };
+
+    BENCHMARK_ADVANCED("Event round trip, futex")(Catch::Benchmark::Chronometer meter) {
+        PingPong<Common::Event> ping_pong;
+        meter.measure([&] { ping_pong.RoundTrip(); });
+    };
+
+    BENCHMARK_ADVANCED("Barrier four threads, condition variable")
+    (Catch::Benchmark::Chronometer meter) {
+        BarrierRounds<CondvarBarrier> rounds{4};
+        meter.measure([&] { rounds.Sync(); });
+    };
+
+    BENCHMARK_ADVANCED("Barrier four threads, futex")(Catch::Benchmark::Chronometer meter) {
+        BarrierRounds<Common::Barrier> rounds{4};
+        meter.measure([&] { rounds.Sync(); });
+    };
+}
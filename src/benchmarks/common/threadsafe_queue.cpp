@@ -0,0 +1,74 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/threadsafe_queue.h"
+
+namespace {
+
+/// Commands of the GPU thread are about this large
+struct Command {
+    u64 fence;
+    u64 payload[4];
+};
+
+constexpr std::size_t NUM_COMMANDS = 4096;
+
+} // Anonymous namespace
+
+TEST_CASE("ThreadsafeQueue", "[common]") {
+    BENCHMARK_ADVANCED("SPSCQueue Push/Pop one thread")(Catch::Benchmark::Chronometer meter) {
+        Common::SPSCQueue<Command> queue;
+        meter.measure([&] {
+            queue.Push(Command{});
+            Command command;
+            return queue.Pop(command);
+        });
+    };
+
+    BENCHMARK("SPSCQueue producer and consumer threads") {
+        Common::SPSCQueue<Command> queue;
+        std::thread consumer([&] {
+            for (std::size_t i = 0; i < NUM_COMMANDS; ++i) {
+                queue.PopWait();
+            }
+        });
+        for (std::size_t i = 0; i < NUM_COMMANDS; ++i) {
+            queue.Push(Command{i, {}});
+        }
+        consumer.join();
+    };
+
+    BENCHMARK_ADVANCED("MPSCQueue Push/Pop one thread")(Catch::Benchmark::Chronometer meter) {
+        Common::MPSCQueue<Command> queue;
+        meter.measure([&] {
+            queue.Push(Command{});
+            Command command;
+            return queue.Pop(command);
+        });
+    };
+
+    BENCHMARK("MPSCQueue four producers") {
+        constexpr std::size_t num_producers = 4;
+        Common::MPSCQueue<Command> queue;
+        std::vector<std::thread> producers;
+        for (std::size_t producer = 0; producer < num_producers; ++producer) {
+            producers.emplace_back([&queue] {
+                for (std::size_t i = 0; i < NUM_COMMANDS / num_producers; ++i) {
+                    queue.Push(Command{i, {}});
+                }
+            });
+        }
+        for (std::size_t i = 0; i < NUM_COMMANDS; ++i) {
+            queue.PopWait();
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+    };
+}
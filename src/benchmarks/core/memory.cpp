@@ -0,0 +1,93 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/page_table.h"
+#include "core/core.h"
+#include "core/memory.h"
+
+namespace {
+
+constexpr VAddr BASE_ADDRESS = 0x80000000;
+constexpr std::size_t REGION_SIZE = 16 * Memory::PAGE_SIZE;
+constexpr std::size_t ADDRESS_SPACE_WIDTH = 39;
+
+/// Maps plain host memory into a page table of its own, without a process or CPU cores
+class SyntheticMemory {
+public:
+    SyntheticMemory() : memory{Core::System::GetInstance().Memory()} {
+        page_table.Resize(ADDRESS_SPACE_WIDTH);
+        memory.MapMemoryRegion(page_table, BASE_ADDRESS, REGION_SIZE, backing.data());
+        memory.SetCurrentPageTable(page_table);
+    }
+
+    ~SyntheticMemory() {
+        memory.UnmapRegion(page_table, BASE_ADDRESS, REGION_SIZE);
+    }
+
+    Memory::Memory& memory;
+
+private:
+    Common::PageTable page_table{Memory::PAGE_BITS};
+    std::vector<u8> backing = std::vector<u8>(REGION_SIZE);
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Memory", "[core]") {
+    SyntheticMemory synthetic;
+    Memory::Memory& memory = synthetic.memory;
+
+    // Accesses walk a page, so the page table lookup isn't always served by the same entry
+    BENCHMARK("Read8") {
+        u32 sum = 0;
+        for (VAddr addr = BASE_ADDRESS; addr < BASE_ADDRESS + REGION_SIZE; addr += 257) {
+            sum += memory.Read8(addr);
+        }
+        return sum;
+    };
+
+    BENCHMARK("Read32") {
+        u32 sum = 0;
+        for (VAddr addr = BASE_ADDRESS; addr < BASE_ADDRESS + REGION_SIZE; addr += 260) {
+            sum += memory.Read32(addr);
+        }
+        return sum;
+    };
+
+    BENCHMARK("Read64") {
+        u64 sum = 0;
+        for (VAddr addr = BASE_ADDRESS; addr < BASE_ADDRESS + REGION_SIZE; addr += 264) {
+            sum += memory.Read64(addr);
+        }
+        return sum;
+    };
+
+    BENCHMARK("Write32") {
+        u32 value = 0;
+        for (VAddr addr = BASE_ADDRESS; addr < BASE_ADDRESS + REGION_SIZE; addr += 260) {
+            memory.Write32(addr, value++);
+        }
+    };
+
+    BENCHMARK("Write64") {
+        u64 value = 0;
+        for (VAddr addr = BASE_ADDRESS; addr < BASE_ADDRESS + REGION_SIZE; addr += 264) {
+            memory.Write64(addr, value++);
+        }
+    };
+
+    std::array<u8, 0x1000> block{};
+    BENCHMARK("ReadBlock across pages") {
+        memory.ReadBlock(BASE_ADDRESS + 0x800, block.data(), block.size());
+    };
+
+    BENCHMARK("WriteBlock across pages") {
+        memory.WriteBlock(BASE_ADDRESS + 0x800, block.data(), block.size());
+    };
+}
@@ -0,0 +1,99 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/scheduler.h"
+#include "core/hle/kernel/slab_heap.h"
+#include "core/hle/kernel/thread.h"
+
+namespace {
+
+constexpr std::size_t NUM_CORES = Kernel::GlobalScheduler::NUM_CPU_CORES;
+constexpr std::size_t NUM_THREADS = 4096;
+constexpr u32 PREEMPTION_PRIORITY = 59;
+
+/**
+ * Thousands of threads linked into per core queues the way GlobalScheduler links them, without a
+ * process or CPU cores. Every thread is suggested to all the cores it isn't scheduled on.
+ */
+class SchedulerQueues {
+public:
+    SchedulerQueues() : kernel{Core::System::GetInstance()} {
+        for (std::size_t core = 0; core < NUM_CORES; ++core) {
+            scheduled.emplace_back(Kernel::ThreadQueueNodeAccessor{core});
+            suggested.emplace_back(Kernel::ThreadQueueNodeAccessor{NUM_CORES + core});
+        }
+        threads.reserve(NUM_THREADS);
+        for (std::size_t i = 0; i < NUM_THREADS; ++i) {
+            auto& thread = threads.emplace_back(std::allocate_shared<Kernel::Thread>(
+                Kernel::SlabAllocator<Kernel::Thread>{kernel.GetObjectHeap()}, kernel));
+            const std::size_t core = i % NUM_CORES;
+            const u32 priority = i % 8 == 0 ? PREEMPTION_PRIORITY : static_cast<u32>(i * 37 % 64);
+            thread->SetProcessorID(static_cast<s32>(core));
+            scheduled[core].add(thread.get(), priority);
+            for (std::size_t other = 0; other < NUM_CORES; ++other) {
+                if (other != core) {
+                    suggested[other].add(thread.get(), priority);
+                }
+            }
+        }
+    }
+
+    ~SchedulerQueues() {
+        for (auto& queue : scheduled) {
+            while (!queue.empty()) {
+                queue.remove(queue.front());
+            }
+        }
+        for (auto& queue : suggested) {
+            while (!queue.empty()) {
+                queue.remove(queue.front());
+            }
+        }
+    }
+
+    Kernel::KernelCore kernel;
+    std::vector<Kernel::ThreadQueue> scheduled;
+    std::vector<Kernel::ThreadQueue> suggested;
+
+private:
+    std::vector<std::shared_ptr<Kernel::Thread>> threads;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Scheduler", "[core]") {
+    SchedulerQueues queues;
+
+    // The walk over the suggested queues done by SelectThread and PreemptThreads when no thread
+    // matches, it touches the scheduling fields of every thread
+    BENCHMARK("Scan suggested queues") {
+        u64 result = 0;
+        for (std::size_t core = 0; core < NUM_CORES; ++core) {
+            for (const Kernel::Thread* thread : queues.suggested[core]) {
+                if (thread->GetProcessorID() >= 0 && !thread->IsRunning()) {
+                    result += thread->GetPriority() + thread->GetLastRunningTicks();
+                }
+            }
+        }
+        return result;
+    };
+
+    BENCHMARK("Preemption round") {
+        for (std::size_t core = 0; core < NUM_CORES; ++core) {
+            auto& queue = queues.scheduled[core];
+            queue.front(PREEMPTION_PRIORITY)->IncrementYieldCount();
+            queue.yield(PREEMPTION_PRIORITY);
+            queue.front(PREEMPTION_PRIORITY)->IncrementYieldCount();
+        }
+        return queues.scheduled[0].front(PREEMPTION_PRIORITY);
+    };
+}
@@ -0,0 +1,98 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <memory>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/file_sys/program_metadata.h"
+#include "core/hle/kernel/physical_memory.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/memory.h"
+
+namespace {
+
+constexpr std::size_t NUM_REGIONS = 256;
+constexpr u64 REGION_SIZE = 4 * Memory::PAGE_SIZE;
+
+/// Leaves an unmapped page after every region, so neighbouring regions are never merged
+constexpr u64 REGION_STRIDE = REGION_SIZE + Memory::PAGE_SIZE;
+
+/**
+ * Address space of a process without the process, with many small regions mapped into it the way
+ * JIT heavy titles map their code and data.
+ */
+class FragmentedAddressSpace {
+public:
+    FragmentedAddressSpace() : vm_manager{Core::System::GetInstance()} {
+        vm_manager.Reset(FileSys::ProgramAddressSpaceType::Is32Bit);
+        base = vm_manager.GetMapRegionBaseAddress();
+        for (std::size_t region = 0; region < NUM_REGIONS; ++region) {
+            Map(region);
+        }
+    }
+
+    VAddr GetRegionAddress(std::size_t region) const {
+        return base + region * REGION_STRIDE;
+    }
+
+    void Map(std::size_t region) {
+        vm_manager.MapMemoryBlock(GetRegionAddress(region), block, 0, REGION_SIZE,
+                                  Kernel::MemoryState::Heap, Kernel::VMAPermission::ReadWrite);
+    }
+
+    void Unmap(std::size_t region) {
+        vm_manager.UnmapRange(GetRegionAddress(region), REGION_SIZE);
+    }
+
+    Kernel::VMManager vm_manager;
+
+private:
+    std::shared_ptr<Kernel::PhysicalMemory> block =
+        std::make_shared<Kernel::PhysicalMemory>(REGION_SIZE);
+    VAddr base = 0;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("VMManager", "[core]") {
+    FragmentedAddressSpace address_space;
+    Kernel::VMManager& vm_manager = address_space.vm_manager;
+
+    BENCHMARK("QueryMemory") {
+        u64 sum = 0;
+        for (std::size_t region = 0; region < NUM_REGIONS; ++region) {
+            const VAddr addr = address_space.GetRegionAddress(region) + Memory::PAGE_SIZE;
+            sum += vm_manager.QueryMemory(addr).size;
+        }
+        return sum;
+    };
+
+    // Splits every region in three and merges it back
+    BENCHMARK("SetMemoryAttribute") {
+        constexpr auto uncached = Kernel::MemoryAttribute::Uncached;
+        for (std::size_t region = 0; region < NUM_REGIONS; ++region) {
+            const VAddr addr = address_space.GetRegionAddress(region) + Memory::PAGE_SIZE;
+            vm_manager.SetMemoryAttribute(addr, Memory::PAGE_SIZE, uncached, uncached);
+            vm_manager.SetMemoryAttribute(addr, Memory::PAGE_SIZE, uncached,
+                                          Kernel::MemoryAttribute::None);
+        }
+    };
+
+    // Unmapped regions merge with their free neighbours, and get carved out again when remapped
+    BENCHMARK("Map, query and unmap") {
+        u64 sum = 0;
+        for (std::size_t region = 0; region < NUM_REGIONS; region += 2) {
+            address_space.Unmap(region);
+        }
+        for (std::size_t region = 0; region < NUM_REGIONS; ++region) {
+            sum += vm_manager.QueryMemory(address_space.GetRegionAddress(region)).size;
+        }
+        for (std::size_t region = 0; region < NUM_REGIONS; region += 2) {
+            address_space.Map(region);
+        }
+        return sum;
+    };
+}
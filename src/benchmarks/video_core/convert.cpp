@@ -0,0 +1,54 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/textures/convert.h"
+
+namespace {
+
+using VideoCore::Surface::PixelFormat;
+
+constexpr u32 WIDTH = 1920;
+constexpr u32 HEIGHT = 1080;
+
+} // Anonymous namespace
+
+TEST_CASE("Texture conversion", "[video_core]") {
+    std::vector<u8> texels(std::size_t{WIDTH} * HEIGHT * 4);
+    for (std::size_t i = 0; i < texels.size(); ++i) {
+        texels[i] = static_cast<u8>(i * 7);
+    }
+
+    // Converting there and back has to give the original texels
+    std::vector<u8> converted = texels;
+    Tegra::Texture::ConvertFromGuestToHost(converted.data(), converted.data(), PixelFormat::S8Z24,
+                                           WIDTH, HEIGHT, 1, true, true);
+    REQUIRE(converted[0] == texels[3]);
+    REQUIRE(converted[1] == texels[0]);
+    Tegra::Texture::ConvertFromHostToGuest(converted.data(), PixelFormat::S8Z24, WIDTH, HEIGHT, 1,
+                                           true, true);
+    REQUIRE(converted == texels);
+
+    BENCHMARK("S8Z24 to Z24S8 in place, 1080p") {
+        Tegra::Texture::ConvertFromGuestToHost(converted.data(), converted.data(),
+                                               PixelFormat::S8Z24, WIDTH, HEIGHT, 1, true, true);
+        return converted[0];
+    };
+
+    BENCHMARK("S8Z24 to Z24S8 from guest memory, 1080p") {
+        Tegra::Texture::ConvertFromGuestToHost(texels.data(), converted.data(), PixelFormat::S8Z24,
+                                               WIDTH, HEIGHT, 1, true, true);
+        return converted[0];
+    };
+
+    BENCHMARK("Z24S8 to S8Z24 in place, 1080p") {
+        Tegra::Texture::ConvertFromHostToGuest(converted.data(), PixelFormat::S8Z24, WIDTH, HEIGHT,
+                                               1, true, true);
+        return converted[0];
+    };
+}
@@ -0,0 +1,80 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/engines/shader_bytecode.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/shader/const_buffer_locker.h"
+#include "video_core/shader/memory_util.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace {
+
+using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::CompilerSettings;
+using VideoCommon::Shader::ConstBufferLocker;
+using VideoCommon::Shader::KERNEL_MAIN_OFFSET;
+using VideoCommon::Shader::ProgramCode;
+using VideoCommon::Shader::ShaderIR;
+
+constexpr u64 MOV_C = 0x4C98ULL << 48;
+constexpr u64 LDG_32 = (0xEED0ULL << 48) | (4ULL << 48);
+constexpr u64 EXIT = (0xE300ULL << 48) | 0xF;
+
+/// Unconditional predicate, PT
+constexpr u64 PRED_ALWAYS = 7ULL << 16;
+
+/// Number of registers holding the global memory addresses
+constexpr u64 NUM_ADDRESS_REGISTERS = 32;
+
+/**
+ * Builds a compute kernel loading the addresses of its global memory regions from a const buffer
+ * and then accessing them many times, every access tracks its address back to the const buffer.
+ */
+ProgramCode MakeGlobalMemoryProgram(std::size_t num_accesses) {
+    ProgramCode code;
+    const auto push = [&code](u64 instruction) {
+        // Every fourth instruction is a scheduling word
+        if (code.size() % 4 == 0) {
+            code.push_back(0);
+        }
+        code.push_back(instruction | PRED_ALWAYS);
+    };
+    for (u64 reg = 0; reg < NUM_ADDRESS_REGISTERS; ++reg) {
+        const u64 cbuf_offset = reg * 2;
+        push(MOV_C | (1ULL << 34) | (cbuf_offset << 20) | (reg + 1));
+    }
+    for (std::size_t access = 0; access < num_accesses; ++access) {
+        const u64 address = access % NUM_ADDRESS_REGISTERS + 1;
+        push(LDG_32 | (address << 8) | (NUM_ADDRESS_REGISTERS + 1));
+    }
+    push(EXIT);
+    return code;
+}
+
+std::size_t Decode(const ProgramCode& code) {
+    ConstBufferLocker locker(ShaderType::Compute);
+    const ShaderIR ir(code, KERNEL_MAIN_OFFSET, CompilerSettings{}, locker);
+    return ir.GetGlobalMemory().size();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ShaderIR", "[video_core]") {
+    // Decode time should grow linearly with the number of tracked accesses
+    const ProgramCode small_program = MakeGlobalMemoryProgram(256);
+    const ProgramCode large_program = MakeGlobalMemoryProgram(4096);
+    REQUIRE(Decode(small_program) == NUM_ADDRESS_REGISTERS);
+    REQUIRE(Decode(large_program) == NUM_ADDRESS_REGISTERS);
+
+    BENCHMARK("Decode 256 global memory accesses") {
+        return Decode(small_program);
+    };
+
+    BENCHMARK("Decode 4096 global memory accesses") {
+        return Decode(large_program);
+    };
+}
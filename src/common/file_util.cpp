@@ -11,6 +11,7 @@
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/scope_exit.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -42,8 +43,10 @@
 #include <cstdlib>
 #include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 #if defined(__APPLE__)
@@ -976,4 +979,89 @@ bool IOFile::Resize(u64 size) {
         ;
 }
 
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef _WIN32
+    const HANDLE file =
+        CreateFileW(Common::UTF8ToUTF16W(filename).c_str(), GENERIC_READ,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    SCOPE_EXIT({ CloseHandle(file); });
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        return;
+    }
+    mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        return;
+    }
+    data = static_cast<u8*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+        return;
+    }
+    size = static_cast<u64>(file_size.QuadPart);
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+    SCOPE_EXIT({ close(fd); });
+
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || file_info.st_size <= 0) {
+        return;
+    }
+    void* const pointer =
+        mmap(nullptr, static_cast<std::size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pointer == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}: {}", filename, GetLastErrorMsg());
+        return;
+    }
+    data = static_cast<u8*>(pointer);
+    size = static_cast<u64>(file_info.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (data == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping_handle);
+#else
+    munmap(data, static_cast<std::size_t>(size));
+#endif
+}
+
+void MappedFile::Advise(u64 offset, u64 length, AccessPattern pattern) const {
+#ifndef _WIN32
+    if (offset >= size) {
+        return;
+    }
+    // madvise wants a page aligned start
+    const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 start = offset & ~(page_size - 1);
+    const u64 end = std::min(offset + length, size);
+    int advice = MADV_NORMAL;
+    switch (pattern) {
+    case AccessPattern::Normal:
+        advice = MADV_NORMAL;
+        break;
+    case AccessPattern::Sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case AccessPattern::Random:
+        advice = MADV_RANDOM;
+        break;
+    }
+    madvise(data + start, static_cast<std::size_t>(end - start), advice);
+#endif
+}
+
 } // namespace FileUtil
@@ -281,6 +281,42 @@ private:
     std::FILE* m_file = nullptr;
 };
 
+// Read-only mapping of a whole file into memory, reads become plain memory accesses
+class MappedFile : public NonCopyable {
+public:
+    enum class AccessPattern {
+        Normal,     ///< Default readahead
+        Sequential, ///< Read ahead aggressively, pages can be dropped soon after use
+        Random,     ///< Don't read ahead
+    };
+
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    /// Returns false when the file couldn't be mapped, like when it is empty.
+    bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    const u8* GetData() const {
+        return data;
+    }
+
+    u64 GetSize() const {
+        return size;
+    }
+
+    /// Tells the OS how a range of the mapping is about to be accessed. Only a hint.
+    void Advise(u64 offset, u64 length, AccessPattern pattern) const;
+
+private:
+    u8* data = nullptr;
+    u64 size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+};
+
 } // namespace FileUtil
 
 // To deal with Windows being dumb at unicode:
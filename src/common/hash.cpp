@@ -0,0 +1,276 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include "common/hash.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#include "common/x64/cpu_detect.h"
+#include "common/x64/hash_avx2.h"
+#endif
+
+// The structure follows XXH3: inputs up to a few hundred bytes are mixed 16 bytes at a time with
+// 128-bit multiplications, longer inputs are accumulated into eight 64-bit lanes with 32x32-bit
+// multiplications, which map directly to SIMD instructions.
+
+namespace Common {
+
+namespace {
+
+constexpr u64 PRIME32_1 = 0x9E3779B1;
+constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87;
+constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+
+constexpr std::size_t NUM_LANES = 8;
+constexpr std::size_t STRIPE_SIZE = NUM_LANES * sizeof(u64);
+constexpr std::size_t STRIPES_PER_BLOCK = 16;
+constexpr std::size_t BLOCK_SIZE = STRIPE_SIZE * STRIPES_PER_BLOCK;
+constexpr std::size_t MAX_MID_SIZE = 256;
+
+/// Keys mixed into the input, each stripe of a block uses them shifted by one
+constexpr std::size_t NUM_KEYS = STRIPES_PER_BLOCK + 2 * NUM_LANES;
+
+constexpr std::array<u64, NUM_KEYS> MakeKeys() {
+    // SplitMix64, any well distributed constants work
+    std::array<u64, NUM_KEYS> keys{};
+    u64 state = PRIME64_2;
+    for (u64& key : keys) {
+        state += 0x9E3779B97F4A7C15;
+        u64 z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        key = z ^ (z >> 31);
+    }
+    return keys;
+}
+
+constexpr std::array<u64, NUM_KEYS> KEYS = MakeKeys();
+
+u64 Read64(const u8* data) {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+u32 Read32(const u8* data) {
+    u32 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// Multiplies two 64-bit values and folds the 128-bit product into 64 bits
+u64 Mul128Fold64(u64 lhs, u64 rhs) {
+#if defined(_MSC_VER) && defined(ARCHITECTURE_x86_64)
+    u64 high;
+    const u64 low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#elif defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#else
+    const u64 lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+    const u64 hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+    const u64 lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+    const u64 hi_hi = (lhs >> 32) * (rhs >> 32);
+    const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    const u64 high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    const u64 low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return low ^ high;
+#endif
+}
+
+u64 Avalanche(u64 hash) {
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9;
+    return hash ^ (hash >> 32);
+}
+
+u64 Mix16(const u8* data, u64 key_low, u64 key_high, u64 seed) {
+    return Mul128Fold64(Read64(data) ^ (key_low + seed), Read64(data + 8) ^ (key_high - seed));
+}
+
+u64 HashSmall(const u8* data, std::size_t size, u64 seed) {
+    if (size > 8) {
+        const u64 low = Read64(data) ^ (KEYS[0] + seed);
+        const u64 high = Read64(data + size - 8) ^ (KEYS[1] - seed);
+        return Avalanche(size + ((low << 32) | (low >> 32)) + high + Mul128Fold64(low, high));
+    }
+    if (size >= 4) {
+        const u64 combined = Read32(data + size - 4) | (static_cast<u64>(Read32(data)) << 32);
+        u64 hash = combined ^ (KEYS[2] + seed);
+        hash ^= ((hash << 49) | (hash >> 15)) ^ ((hash << 24) | (hash >> 40));
+        hash *= 0x9FB21C651E98DF25;
+        hash ^= (hash >> 35) + size;
+        hash *= 0x9FB21C651E98DF25;
+        return hash ^ (hash >> 28);
+    }
+    if (size > 0) {
+        const u32 combined = (static_cast<u32>(data[0]) << 16) |
+                             (static_cast<u32>(data[size >> 1]) << 24) | data[size - 1] |
+                             (static_cast<u32>(size) << 8);
+        return Avalanche((combined ^ (KEYS[3] + seed)) * PRIME64_1);
+    }
+    return Avalanche(seed ^ KEYS[4]);
+}
+
+u64 HashMid(const u8* data, std::size_t size, u64 seed) {
+    u64 hash = size * PRIME64_1;
+    const std::size_t num_chunks = size / 16;
+    for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        const std::size_t key = (chunk * 2) % (NUM_KEYS - 1);
+        hash += Mix16(data + chunk * 16, KEYS[key], KEYS[key + 1], seed);
+    }
+    // The last 16 bytes cover the remainder, overlapping the last chunk
+    hash += Mix16(data + size - 16, KEYS[NUM_KEYS - 2], KEYS[NUM_KEYS - 1], seed);
+    return Avalanche(hash);
+}
+
+#ifdef ARCHITECTURE_x86_64
+// SSE2 is part of x86-64, so this needs no dispatch. The lanes stay in registers for the whole
+// input. Whole blocks go through AVX2 instead when the host supports it.
+constexpr std::size_t NUM_VECTORS = NUM_LANES / 2;
+
+struct Accumulators {
+    __m128i vectors[NUM_VECTORS];
+};
+
+Accumulators LoadAccumulators(const std::array<u64, NUM_LANES>& values) {
+    Accumulators acc;
+    for (std::size_t i = 0; i < NUM_VECTORS; ++i) {
+        acc.vectors[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data() + i * 2));
+    }
+    return acc;
+}
+
+std::array<u64, NUM_LANES> StoreAccumulators(const Accumulators& acc) {
+    std::array<u64, NUM_LANES> values;
+    for (std::size_t i = 0; i < NUM_VECTORS; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values.data() + i * 2), acc.vectors[i]);
+    }
+    return values;
+}
+
+void AccumulateStripe(Accumulators& acc, const u8* data, const u64* keys) {
+    for (std::size_t i = 0; i < NUM_VECTORS; ++i) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + i);
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i * 2));
+        const __m128i mixed = _mm_xor_si128(input, key);
+        // Multiplies the low and high halves of each 64-bit lane together
+        const __m128i product =
+            _mm_mul_epu32(mixed, _mm_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1)));
+        // Adding the input of the neighbour lane keeps the input when the product is zero
+        const __m128i swapped = _mm_shuffle_epi32(input, _MM_SHUFFLE(1, 0, 3, 2));
+        acc.vectors[i] = _mm_add_epi64(acc.vectors[i], _mm_add_epi64(product, swapped));
+    }
+}
+
+void ScrambleAccumulators(Accumulators& acc) {
+    const u64* const keys = KEYS.data() + STRIPES_PER_BLOCK;
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+    for (std::size_t i = 0; i < NUM_VECTORS; ++i) {
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i * 2));
+        __m128i value = _mm_xor_si128(acc.vectors[i], _mm_srli_epi64(acc.vectors[i], 47));
+        value = _mm_xor_si128(value, key);
+        // 64x32-bit multiplication from two 32x32-bit ones
+        const __m128i low = _mm_mul_epu32(value, prime);
+        const __m128i high = _mm_mul_epu32(_mm_srli_epi64(value, 32), prime);
+        acc.vectors[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+    }
+}
+#else
+using Accumulators = std::array<u64, NUM_LANES>;
+
+Accumulators LoadAccumulators(const std::array<u64, NUM_LANES>& values) {
+    return values;
+}
+
+std::array<u64, NUM_LANES> StoreAccumulators(const Accumulators& acc) {
+    return acc;
+}
+
+void AccumulateStripe(Accumulators& acc, const u8* data, const u64* keys) {
+    for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        const u64 input = Read64(data + lane * sizeof(u64));
+        const u64 mixed = input ^ keys[lane];
+        acc[lane ^ 1] += input;
+        acc[lane] += (mixed & 0xFFFFFFFF) * (mixed >> 32);
+    }
+}
+
+void ScrambleAccumulators(Accumulators& acc) {
+    const u64* const keys = KEYS.data() + STRIPES_PER_BLOCK;
+    for (std::size_t lane = 0; lane < NUM_LANES; ++lane) {
+        u64 value = acc[lane];
+        value ^= value >> 47;
+        value ^= keys[lane];
+        acc[lane] = value * PRIME32_1;
+    }
+}
+#endif
+
+void AccumulateBlocks(std::array<u64, NUM_LANES>& lanes, const u8* data, std::size_t num_blocks) {
+    Accumulators acc = LoadAccumulators(lanes);
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        const u8* const block_data = data + block * BLOCK_SIZE;
+        for (std::size_t stripe = 0; stripe < STRIPES_PER_BLOCK; ++stripe) {
+            AccumulateStripe(acc, block_data + stripe * STRIPE_SIZE, KEYS.data() + stripe);
+        }
+        ScrambleAccumulators(acc);
+    }
+    lanes = StoreAccumulators(acc);
+}
+
+u64 HashLarge(const u8* data, std::size_t size, u64 seed) {
+    std::array<u64, NUM_LANES> lanes{PRIME32_1, PRIME64_1, PRIME64_2, seed,
+                                     ~seed,     PRIME64_2, PRIME64_1, PRIME32_1};
+
+    const std::size_t num_blocks = (size - 1) / BLOCK_SIZE;
+#ifdef ARCHITECTURE_x86_64
+    static const bool has_avx2 = GetCPUCaps().avx2;
+    if (has_avx2) {
+        X64::AccumulateBlocksAVX2(lanes, data, num_blocks, KEYS.data());
+    } else {
+        AccumulateBlocks(lanes, data, num_blocks);
+    }
+#else
+    AccumulateBlocks(lanes, data, num_blocks);
+#endif
+
+    // Last partial block, its last stripe is taken from the end of the input
+    Accumulators acc = LoadAccumulators(lanes);
+    const u8* const tail = data + num_blocks * BLOCK_SIZE;
+    const std::size_t num_stripes = (size - num_blocks * BLOCK_SIZE - 1) / STRIPE_SIZE;
+    for (std::size_t stripe = 0; stripe < num_stripes; ++stripe) {
+        AccumulateStripe(acc, tail + stripe * STRIPE_SIZE, KEYS.data() + stripe);
+    }
+    AccumulateStripe(acc, data + size - STRIPE_SIZE, KEYS.data() + NUM_KEYS - NUM_LANES);
+    lanes = StoreAccumulators(acc);
+
+    u64 hash = size * PRIME64_1;
+    for (std::size_t lane = 0; lane < NUM_LANES; lane += 2) {
+        hash += Mul128Fold64(lanes[lane] ^ KEYS[lane + 1], lanes[lane + 1] ^ KEYS[lane + 2]);
+    }
+    return Avalanche(hash);
+}
+
+} // Anonymous namespace
+
+u64 HashValue(const void* data, std::size_t size, u64 seed) {
+    const u8* const bytes = static_cast<const u8*>(data);
+    if (size <= 16) {
+        return HashSmall(bytes, size, seed);
+    }
+    if (size <= MAX_MID_SIZE) {
+        return HashMid(bytes, size, seed);
+    }
+    return HashLarge(bytes, size, seed);
+}
+
+} // namespace Common
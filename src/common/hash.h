@@ -13,6 +13,17 @@
 
 namespace Common {
 
+/**
+ * Computes a fast 64-bit hash over the specified block of data, several times faster than
+ * CityHash64 on large inputs. Values are only stable within a build, so anything stored on disk
+ * must keep using CityHash.
+ * @param data Block of data to compute hash over
+ * @param len Length of data (in bytes) to compute hash over
+ * @param seed Seed mixed into the hash
+ * @returns 64-bit hash value that was computed over the data block
+ */
+u64 HashValue(const void* data, std::size_t len, u64 seed = 0);
+
 /**
  * Computes a 64-bit hash over the specified block of data
  * @param data Block of data to compute hash over
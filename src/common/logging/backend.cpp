@@ -5,8 +5,8 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <climits>
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -22,10 +22,56 @@
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
-#include "common/threadsafe_queue.h"
 
 namespace Log {
 
+namespace {
+
+/**
+ * Single producer, single consumer ring of log entries. Every thread that logs gets its own ring,
+ * so pushing an entry neither takes a lock nor allocates a queue node, and only the backend thread
+ * pops from it.
+ */
+class EntryRing {
+public:
+    static constexpr std::size_t CAPACITY = 256;
+
+    EntryRing() : slots(CAPACITY) {}
+
+    /// Moves the entry into the ring, leaving it untouched when the ring is full.
+    bool TryPush(Entry& entry) {
+        const std::size_t write = write_index.load(std::memory_order_relaxed);
+        if (write - read_index.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        slots[write % CAPACITY] = std::move(entry);
+        write_index.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(Entry& entry) {
+        const std::size_t read = read_index.load(std::memory_order_relaxed);
+        if (read == write_index.load(std::memory_order_acquire)) {
+            return false;
+        }
+        entry = std::move(slots[read % CAPACITY]);
+        read_index.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool IsEmpty() const {
+        return read_index.load(std::memory_order_acquire) ==
+               write_index.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<Entry> slots;
+    alignas(64) std::atomic<std::size_t> write_index{0};
+    alignas(64) std::atomic<std::size_t> read_index{0};
+};
+
+} // Anonymous namespace
+
 /**
  * Static state as a singleton.
  */
@@ -41,8 +87,15 @@ public:
 
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+        Entry entry =
+            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message));
+        EntryRing& ring = GetThreadRing();
+        while (!ring.TryPush(entry)) {
+            // The backend thread is behind, wake it up and give it a chance to catch up
+            WakeBackend(true);
+            std::this_thread::yield();
+        }
+        WakeBackend(false);
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -76,40 +129,124 @@ public:
     }
 
 private:
+    /// Most entries taken from a single ring before the batch is written out
+    static constexpr std::size_t MAX_BATCH_PER_RING = EntryRing::CAPACITY;
+
     Impl() {
         backend_thread = std::thread([&] {
-            Entry entry;
-            auto write_logs = [&](Entry& e) {
-                std::lock_guard lock{writing_mutex};
-                for (const auto& backend : backends) {
-                    backend->Write(e);
-                }
-            };
+            std::vector<Entry> batch;
             while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
+                WaitForEntries();
+                const bool stopping = stop_requested.load(std::memory_order_acquire);
+                if (stopping) {
                     break;
                 }
-                write_logs(entry);
+                PopBatch(batch, MAX_BATCH_PER_RING);
+                WriteBatch(batch);
             }
 
             // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a case
             // where a system is repeatedly spamming logs even on close.
-            const int MAX_LOGS_TO_WRITE = filter.IsDebug() ? INT_MAX : 100;
-            int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
-                write_logs(entry);
+            const std::size_t MAX_LOGS_TO_WRITE = filter.IsDebug() ? SIZE_MAX : 100;
+            std::size_t logs_written = 0;
+            while (logs_written < MAX_LOGS_TO_WRITE) {
+                PopBatch(batch, MAX_LOGS_TO_WRITE - logs_written);
+                if (batch.empty()) {
+                    break;
+                }
+                logs_written += batch.size();
+                WriteBatch(batch);
             }
         });
     }
 
     ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
+        stop_requested.store(true, std::memory_order_release);
+        WakeBackend(true);
         backend_thread.join();
     }
 
+    /// Returns the ring of the calling thread, registering it on its first log
+    EntryRing& GetThreadRing() {
+        thread_local std::shared_ptr<EntryRing> thread_ring;
+        if (!thread_ring) {
+            thread_ring = std::make_shared<EntryRing>();
+            std::lock_guard lock{rings_mutex};
+            rings.push_back(thread_ring);
+        }
+        return *thread_ring;
+    }
+
+    /// Notifies the backend thread, unless it's busy and will see the new entries by itself
+    void WakeBackend(bool force) {
+        // Pairs with the fence in WaitForEntries, so either this thread sees the backend waiting
+        // or the backend sees the entry that was just pushed
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!force && !backend_waiting.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::lock_guard lock{wake_mutex};
+        backend_waiting.store(false, std::memory_order_relaxed);
+        wake_cv.notify_one();
+    }
+
+    void WaitForEntries() {
+        std::unique_lock lock{wake_mutex};
+        backend_waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (HasPendingEntries() || stop_requested.load(std::memory_order_acquire)) {
+            backend_waiting.store(false, std::memory_order_relaxed);
+            return;
+        }
+        wake_cv.wait_for(lock, std::chrono::milliseconds(100), [this] {
+            return !backend_waiting.load(std::memory_order_relaxed);
+        });
+        backend_waiting.store(false, std::memory_order_relaxed);
+    }
+
+    bool HasPendingEntries() {
+        std::lock_guard lock{rings_mutex};
+        return std::any_of(rings.begin(), rings.end(),
+                           [](const auto& ring) { return !ring->IsEmpty(); });
+    }
+
+    /**
+     * Takes up to max_per_ring entries from every thread ring and sorts them by time, as the
+     * rings of different threads fill up independently of one another.
+     */
+    void PopBatch(std::vector<Entry>& batch, std::size_t max_per_ring) {
+        batch.clear();
+        std::lock_guard lock{rings_mutex};
+        Entry entry;
+        for (const auto& ring : rings) {
+            for (std::size_t i = 0; i < max_per_ring && ring->TryPop(entry); ++i) {
+                batch.push_back(std::move(entry));
+            }
+        }
+        // Forget the rings of threads that have exited once they have been drained
+        rings.erase(std::remove_if(rings.begin(), rings.end(),
+                                   [](const auto& ring) {
+                                       return ring.use_count() == 1 && ring->IsEmpty();
+                                   }),
+                    rings.end());
+        std::stable_sort(batch.begin(), batch.end(), [](const Entry& lhs, const Entry& rhs) {
+            return lhs.timestamp < rhs.timestamp;
+        });
+    }
+
+    void WriteBatch(const std::vector<Entry>& batch) {
+        if (batch.empty()) {
+            return;
+        }
+        std::lock_guard lock{writing_mutex};
+        for (const auto& backend : backends) {
+            for (const Entry& entry : batch) {
+                backend->Write(entry);
+            }
+            backend->Flush();
+        }
+    }
+
     Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
                       const char* function, std::string message) const {
         using std::chrono::duration_cast;
@@ -131,7 +268,15 @@ private:
     std::mutex writing_mutex;
     std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
-    Common::MPSCQueue<Log::Entry> message_queue;
+
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<EntryRing>> rings;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic_bool backend_waiting{false};
+    std::atomic_bool stop_requested{false};
+
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
 };
@@ -149,6 +294,10 @@ void ColorConsoleBackend::Write(const Entry& entry) {
 FileBackend::FileBackend(const std::string& filename)
     : file(filename, "w", _SH_DENYWR), bytes_written(0) {}
 
+FileBackend::~FileBackend() {
+    Flush();
+}
+
 void FileBackend::Write(const Entry& entry) {
     // prevent logs from going over the maximum size (in case its spamming and the user doesn't
     // know)
@@ -156,10 +305,26 @@ void FileBackend::Write(const Entry& entry) {
     if (!file.IsOpen() || bytes_written > MAX_BYTES_WRITTEN) {
         return;
     }
-    bytes_written += file.WriteString(FormatLogMessage(entry).append(1, '\n'));
-    if (entry.log_level >= Level::Error) {
+    const std::size_t previous_size = pending.size();
+    pending += FormatLogMessage(entry);
+    pending += '\n';
+    bytes_written += pending.size() - previous_size;
+
+    // Errors are written right away, in case they are followed by a crash
+    if (entry.log_level >= Level::Error || pending.size() >= MAX_PENDING_BYTES) {
+        Flush();
+    }
+}
+
+void FileBackend::Flush() {
+    if (pending.empty()) {
+        return;
+    }
+    if (file.IsOpen()) {
+        file.WriteString(pending);
         file.Flush();
     }
+    pending.clear();
 }
 
 void DebuggerBackend::Write(const Entry& entry) {
@@ -301,6 +466,10 @@ void SetGlobalFilter(const Filter& filter) {
     Impl::Instance().SetGlobalFilter(filter);
 }
 
+bool IsLogged(Class log_class, Level log_level) {
+    return Impl::Instance().GetGlobalFilter().CheckMessage(log_class, log_level);
+}
+
 void AddBackend(std::unique_ptr<Backend> backend) {
     Impl::Instance().AddBackend(std::move(backend));
 }
@@ -25,9 +25,8 @@ struct Entry {
     Level log_level;
     const char* filename;
     unsigned int line_num;
-    std::string function;
+    const char* function;
     std::string message;
-    bool final_entry = false;
 
     Entry() = default;
     Entry(Entry&& o) = default;
@@ -48,6 +47,8 @@ public:
     }
     virtual const char* GetName() const = 0;
     virtual void Write(const Entry& entry) = 0;
+    /// Called after every batch of entries, for backends that buffer their writes
+    virtual void Flush() {}
 
 private:
     Filter filter;
@@ -88,6 +89,7 @@ public:
 class FileBackend : public Backend {
 public:
     explicit FileBackend(const std::string& filename);
+    ~FileBackend() override;
 
     static const char* Name() {
         return "file";
@@ -98,10 +100,15 @@ public:
     }
 
     void Write(const Entry& entry) override;
+    void Flush() override;
 
 private:
+    /// Bytes buffered before they are written out without waiting for the end of the batch
+    static constexpr std::size_t MAX_PENDING_BYTES = 0x10000;
+
     FileUtil::IOFile file;
     std::size_t bytes_written;
+    std::string pending; ///< Formatted entries not yet written to the file
 };
 
 /**
@@ -141,4 +148,10 @@ const char* GetLevelName(Level log_level);
  * never get the message
  */
 void SetGlobalFilter(const Filter& filter);
+
+/**
+ * Returns whether messages of the given class and level pass the global filter, so that callers
+ * can skip building expensive messages that would be dropped anyway.
+ */
+bool IsLogged(Class log_class, Level log_level);
 } // namespace Log
\ No newline at end of file
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <memory>
 #include <lz4hc.h>
 
 #include "common/assert.h"
@@ -10,6 +11,21 @@
 
 namespace Common::Compression {
 
+namespace {
+
+/// Compression states are large (the HC one in particular), so each thread reuses its own
+void* ThreadState() {
+    thread_local const auto state = std::make_unique<LZ4_stream_t>();
+    return state.get();
+}
+
+void* ThreadStateHC() {
+    thread_local const auto state = std::make_unique<LZ4_streamHC_t>();
+    return state.get();
+}
+
+} // Anonymous namespace
+
 std::vector<u8> CompressDataLZ4(const u8* source, std::size_t source_size) {
     ASSERT_MSG(source_size <= LZ4_MAX_INPUT_SIZE, "Source size exceeds LZ4 maximum input size");
 
@@ -17,9 +33,9 @@ std::vector<u8> CompressDataLZ4(const u8* source, std::size_t source_size) {
     const int max_compressed_size = LZ4_compressBound(source_size_int);
     std::vector<u8> compressed(max_compressed_size);
 
-    const int compressed_size = LZ4_compress_default(reinterpret_cast<const char*>(source),
-                                                     reinterpret_cast<char*>(compressed.data()),
-                                                     source_size_int, max_compressed_size);
+    const int compressed_size = LZ4_compress_fast_extState(
+        ThreadState(), reinterpret_cast<const char*>(source),
+        reinterpret_cast<char*>(compressed.data()), source_size_int, max_compressed_size, 1);
 
     if (compressed_size <= 0) {
         // Compression failed
@@ -41,9 +57,10 @@ std::vector<u8> CompressDataLZ4HC(const u8* source, std::size_t source_size,
     const int max_compressed_size = LZ4_compressBound(source_size_int);
     std::vector<u8> compressed(max_compressed_size);
 
-    const int compressed_size = LZ4_compress_HC(
-        reinterpret_cast<const char*>(source), reinterpret_cast<char*>(compressed.data()),
-        source_size_int, max_compressed_size, compression_level);
+    const int compressed_size = LZ4_compress_HC_extStateHC(
+        ThreadStateHC(), reinterpret_cast<const char*>(source),
+        reinterpret_cast<char*>(compressed.data()), source_size_int, max_compressed_size,
+        compression_level);
 
     if (compressed_size <= 0) {
         // Compression failed
@@ -61,16 +78,25 @@ std::vector<u8> CompressDataLZ4HCMax(const u8* source, std::size_t source_size)
 
 std::vector<u8> DecompressDataLZ4(const std::vector<u8>& compressed,
                                   std::size_t uncompressed_size) {
+    return DecompressDataLZ4(compressed.data(), compressed.size(), uncompressed_size);
+}
+
+std::vector<u8> DecompressDataLZ4(const u8* source, std::size_t source_size,
+                                  std::size_t uncompressed_size) {
     std::vector<u8> uncompressed(uncompressed_size);
-    const int size_check = LZ4_decompress_safe(reinterpret_cast<const char*>(compressed.data()),
-                                               reinterpret_cast<char*>(uncompressed.data()),
-                                               static_cast<int>(compressed.size()),
-                                               static_cast<int>(uncompressed.size()));
-    if (static_cast<int>(uncompressed_size) != size_check) {
+    if (!DecompressDataLZ4(source, source_size, uncompressed.data(), uncompressed_size)) {
         // Decompression failed
         return {};
     }
     return uncompressed;
 }
 
+bool DecompressDataLZ4(const u8* source, std::size_t source_size, u8* destination,
+                       std::size_t uncompressed_size) {
+    const int size_check = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(source), reinterpret_cast<char*>(destination),
+        static_cast<int>(source_size), static_cast<int>(uncompressed_size));
+    return static_cast<int>(uncompressed_size) == size_check;
+}
+
 } // namespace Common::Compression
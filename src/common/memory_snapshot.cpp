@@ -0,0 +1,361 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/memory_snapshot.h"
+
+namespace Common {
+
+struct MemorySnapshot::TrackedRange {
+    u8* pointer;
+    std::size_t size;
+    u8* begin;  ///< First byte of the page holding pointer
+    u8* end;    ///< End of the page holding the last byte of the range
+    u8* shadow; ///< Old contents of the touched pages, only backed by the host once written
+
+    /// Epoch at which each page was first written after the snapshot, 0 when it wasn't
+    std::vector<u64> touch_epochs;
+    bool is_released;
+};
+
+namespace {
+
+// The fault handler takes this lock, which is fine as it is never held by code that writes
+// tracked memory, so a thread can't fault while already owning it.
+std::mutex registry_mutex;
+std::vector<MemorySnapshot*> live_snapshots;
+u64 current_epoch = 0;
+
+#ifndef _WIN32
+struct sigaction previous_segv_action;
+struct sigaction previous_bus_action;
+#endif
+
+u8* AlignDownToPage(const u8* pointer) {
+    const auto address = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<u8*>(address - address % MemorySnapshot::PageSize());
+}
+
+u8* AlignUpToPage(const u8* pointer) {
+    return AlignDownToPage(pointer + MemorySnapshot::PageSize() - 1);
+}
+
+bool Protect(u8* pointer, std::size_t size, bool writable) {
+#ifdef _WIN32
+    DWORD old_protection;
+    return VirtualProtect(pointer, size, writable ? PAGE_READWRITE : PAGE_READONLY,
+                          &old_protection) != 0;
+#else
+    return mprotect(pointer, size, writable ? PROT_READ | PROT_WRITE : PROT_READ) == 0;
+#endif
+}
+
+/// Reserves address space for the shadow copy of a range without committing host memory
+u8* AllocateShadow(std::size_t size) {
+#ifdef _WIN32
+    return static_cast<u8*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS));
+#else
+    void* const pointer =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return pointer == MAP_FAILED ? nullptr : static_cast<u8*>(pointer);
+#endif
+}
+
+bool CommitShadowPage(u8* page) {
+#ifdef _WIN32
+    return VirtualAlloc(page, MemorySnapshot::PageSize(), MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    // Anonymous mappings are backed on their first write
+    return true;
+#endif
+}
+
+void FreeShadow(u8* pointer, std::size_t size) {
+#ifdef _WIN32
+    VirtualFree(pointer, 0, MEM_RELEASE);
+#else
+    munmap(pointer, size);
+#endif
+}
+
+#ifndef _WIN32
+void ForwardSignal(int signal_number, siginfo_t* info, void* raw_context) {
+    const struct sigaction& previous =
+        signal_number == SIGSEGV ? previous_segv_action : previous_bus_action;
+    if ((previous.sa_flags & SA_SIGINFO) != 0) {
+        previous.sa_sigaction(signal_number, info, raw_context);
+        return;
+    }
+    if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN) {
+        // Returning retries the faulting instruction, which now takes the default action
+        signal(signal_number, SIG_DFL);
+        return;
+    }
+    previous.sa_handler(signal_number);
+}
+#endif
+
+} // Anonymous namespace
+
+MemorySnapshot::MemorySnapshot(std::vector<Range> ranges_) {
+    InstallFaultHandler();
+
+    const std::size_t page_size = PageSize();
+    ranges.reserve(ranges_.size());
+    for (const Range& range : ranges_) {
+        TrackedRange& tracked = ranges.emplace_back();
+        tracked.pointer = range.pointer;
+        tracked.size = range.size;
+        tracked.begin = AlignDownToPage(range.pointer);
+        tracked.end = AlignUpToPage(range.pointer + range.size);
+        tracked.shadow = nullptr;
+        tracked.is_released = false;
+
+        const std::size_t tracked_size = tracked.end - tracked.begin;
+        if (tracked_size == 0) {
+            continue;
+        }
+        tracked.touch_epochs.resize(tracked_size / page_size);
+        tracked.shadow = AllocateShadow(tracked_size);
+        if (tracked.shadow == nullptr) {
+            LOG_ERROR(Common_Memory, "Failed to reserve 0x{:X} bytes for a snapshot", tracked_size);
+            tracked.is_released = true;
+        }
+    }
+
+    std::lock_guard lock{registry_mutex};
+    epoch = ++current_epoch;
+    live_snapshots.push_back(this);
+    for (TrackedRange& range : ranges) {
+        if (range.is_released || range.begin == range.end) {
+            continue;
+        }
+        if (!Protect(range.begin, range.end - range.begin, false)) {
+            LOG_ERROR(Common_Memory, "Failed to write-protect 0x{:X} bytes at {}",
+                      range.end - range.begin, static_cast<void*>(range.begin));
+            range.is_released = true;
+            UpdateProtection(range.begin, range.end);
+        }
+    }
+}
+
+MemorySnapshot::~MemorySnapshot() {
+    {
+        std::lock_guard lock{registry_mutex};
+        live_snapshots.erase(std::find(live_snapshots.begin(), live_snapshots.end(), this));
+        for (const TrackedRange& range : ranges) {
+            if (!range.is_released) {
+                UpdateProtection(range.begin, range.end);
+            }
+        }
+    }
+    for (const TrackedRange& range : ranges) {
+        if (range.shadow != nullptr) {
+            FreeShadow(range.shadow, range.end - range.begin);
+        }
+    }
+}
+
+std::size_t MemorySnapshot::PageSize() {
+    static const std::size_t page_size = [] {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<std::size_t>(info.dwPageSize);
+#else
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }();
+    return page_size;
+}
+
+void MemorySnapshot::ReleaseMemory(const void* pointer, std::size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const u8* const begin = static_cast<const u8*>(pointer);
+    const u8* const end = begin + size;
+
+    std::lock_guard lock{registry_mutex};
+    for (MemorySnapshot* snapshot : live_snapshots) {
+        for (TrackedRange& range : snapshot->ranges) {
+            if (range.is_released || range.begin >= end || begin >= range.end) {
+                continue;
+            }
+            range.is_released = true;
+            UpdateProtection(range.begin, range.end);
+        }
+    }
+}
+
+std::size_t MemorySnapshot::NumPages(std::size_t range) const {
+    return ranges[range].touch_epochs.size();
+}
+
+bool MemorySnapshot::IsReleased(std::size_t range) const {
+    std::lock_guard lock{registry_mutex};
+    return ranges[range].is_released;
+}
+
+std::vector<std::size_t> MemorySnapshot::GetTouchedPages(std::size_t range,
+                                                         const MemorySnapshot* until) const {
+    const u64 until_epoch = until != nullptr ? until->epoch : std::numeric_limits<u64>::max();
+
+    std::lock_guard lock{registry_mutex};
+    const TrackedRange& tracked = ranges[range];
+    std::vector<std::size_t> pages;
+    for (std::size_t index = 0; index < tracked.touch_epochs.size(); ++index) {
+        const u64 touch_epoch = tracked.touch_epochs[index];
+        if (tracked.is_released || (touch_epoch != 0 && touch_epoch < until_epoch)) {
+            pages.push_back(index);
+        }
+    }
+    return pages;
+}
+
+bool MemorySnapshot::Read(std::size_t range, std::size_t offset, void* dest,
+                          std::size_t size) const {
+    const std::size_t page_size = PageSize();
+
+    std::lock_guard lock{registry_mutex};
+    const TrackedRange& tracked = ranges[range];
+    if (tracked.is_released) {
+        return false;
+    }
+    ASSERT(offset + size <= tracked.size);
+
+    auto* dest_bytes = static_cast<u8*>(dest);
+    std::size_t position = tracked.pointer + offset - tracked.begin;
+    while (size > 0) {
+        const std::size_t page_offset = position % page_size;
+        const std::size_t copy_size = std::min(size, page_size - page_offset);
+        const bool is_touched = tracked.touch_epochs[position / page_size] != 0;
+        const u8* const src = (is_touched ? tracked.shadow : tracked.begin) + position;
+        std::memcpy(dest_bytes, src, copy_size);
+
+        dest_bytes += copy_size;
+        position += copy_size;
+        size -= copy_size;
+    }
+    return true;
+}
+
+bool MemorySnapshot::HandleWrite(u8* address) {
+    const std::size_t page_size = PageSize();
+    u8* const page = AlignDownToPage(address);
+
+    std::lock_guard lock{registry_mutex};
+    bool is_tracked = false;
+    for (MemorySnapshot* snapshot : live_snapshots) {
+        for (TrackedRange& range : snapshot->ranges) {
+            if (range.is_released || page < range.begin || page >= range.end) {
+                continue;
+            }
+            is_tracked = true;
+
+            const std::size_t index = (page - range.begin) / page_size;
+            if (range.touch_epochs[index] != 0) {
+                continue;
+            }
+            u8* const shadow_page = range.shadow + index * page_size;
+            if (!CommitShadowPage(shadow_page)) {
+                // The old contents can't be kept, so the range can't be trusted anymore
+                range.is_released = true;
+                continue;
+            }
+            std::memcpy(shadow_page, page, page_size);
+            range.touch_epochs[index] = current_epoch;
+        }
+    }
+    if (!is_tracked) {
+        return false;
+    }
+    return Protect(page, page_size, true);
+}
+
+bool MemorySnapshot::IsProtected(const u8* page) {
+    for (const MemorySnapshot* snapshot : live_snapshots) {
+        for (const TrackedRange& range : snapshot->ranges) {
+            if (range.is_released || page < range.begin || page >= range.end) {
+                continue;
+            }
+            if (range.touch_epochs[(page - range.begin) / PageSize()] == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void MemorySnapshot::UpdateProtection(u8* begin, u8* end) {
+    const std::size_t page_size = PageSize();
+    while (begin != end) {
+        const bool is_protected = IsProtected(begin);
+        u8* run_end = begin + page_size;
+        while (run_end != end && IsProtected(run_end) == is_protected) {
+            run_end += page_size;
+        }
+        Protect(begin, run_end - begin, !is_protected);
+        begin = run_end;
+    }
+}
+
+void MemorySnapshot::InstallFaultHandler() {
+#ifdef _WIN32
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        AddVectoredExceptionHandler(1, [](PEXCEPTION_POINTERS info) -> LONG {
+            const EXCEPTION_RECORD& record = *info->ExceptionRecord;
+            const bool is_write = record.ExceptionCode == EXCEPTION_ACCESS_VIOLATION &&
+                                  record.NumberParameters >= 2 &&
+                                  record.ExceptionInformation[0] == 1;
+            if (is_write &&
+                HandleWrite(reinterpret_cast<u8*>(record.ExceptionInformation[1]))) {
+                return EXCEPTION_CONTINUE_EXECUTION;
+            }
+            return EXCEPTION_CONTINUE_SEARCH;
+        });
+    });
+#else
+    void (*const handler)(int, siginfo_t*, void*) = [](int signal_number, siginfo_t* info,
+                                                       void* raw_context) {
+        if (!HandleWrite(static_cast<u8*>(info->si_addr))) {
+            ForwardSignal(signal_number, info, raw_context);
+        }
+    };
+
+    // Handlers installed after ours, like those of crash reporters, would not forward the faults,
+    // so ours is put back in front of them whenever a snapshot is taken. Some hosts report writes
+    // to protected pages as SIGBUS instead of SIGSEGV.
+    for (const int signal_number : {SIGSEGV, SIGBUS}) {
+        struct sigaction current {};
+        sigaction(signal_number, nullptr, &current);
+        if ((current.sa_flags & SA_SIGINFO) != 0 && current.sa_sigaction == handler) {
+            continue;
+        }
+        struct sigaction action {};
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        action.sa_sigaction = handler;
+        sigaction(signal_number, &action,
+                  signal_number == SIGSEGV ? &previous_segv_action : &previous_bus_action);
+    }
+#endif
+}
+
+} // namespace Common
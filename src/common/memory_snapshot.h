@@ -0,0 +1,90 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Copy-on-write snapshot of ranges of host memory.
+ *
+ * Taking a snapshot write-protects its ranges. The first write to each page afterwards faults
+ * into a handler that saves the old contents of the page, records when it was touched and makes
+ * it writable again, so a snapshot only costs as much as the memory written while it is alive.
+ * Any number of snapshots can be alive at the same time.
+ *
+ * Ranges are rounded out to host pages. Writes made by the host kernel (e.g. read(2) into a
+ * tracked buffer) fail instead of faulting in user space, so such memory must not be tracked.
+ */
+class MemorySnapshot {
+public:
+    struct Range {
+        u8* pointer;
+        std::size_t size;
+    };
+
+    /// Write-protects the given ranges, which must not overlap each other.
+    explicit MemorySnapshot(std::vector<Range> ranges);
+
+    /// Makes the pages that no other snapshot still tracks writable again.
+    ~MemorySnapshot();
+
+    MemorySnapshot(const MemorySnapshot&) = delete;
+    MemorySnapshot& operator=(const MemorySnapshot&) = delete;
+
+    /// Granularity of the tracking, which is the host page size.
+    static std::size_t PageSize();
+
+    /**
+     * Stops every snapshot from tracking memory that is about to be returned to the host. Ranges
+     * overlapping it are reported as released instead of tracking memory they no longer own.
+     */
+    static void ReleaseMemory(const void* pointer, std::size_t size);
+
+    /// Number of pages tracked in a range, starting at the page holding its first byte.
+    std::size_t NumPages(std::size_t range) const;
+
+    /// Returns true when the memory of a range was released while the snapshot was alive.
+    bool IsReleased(std::size_t range) const;
+
+    /**
+     * Returns the indices of the pages of a range written after this snapshot was taken and
+     * before the snapshot until was, or until now when until is null. Every page of a released
+     * range is reported.
+     */
+    std::vector<std::size_t> GetTouchedPages(std::size_t range,
+                                             const MemorySnapshot* until = nullptr) const;
+
+    /**
+     * Copies memory of a range as it was when the snapshot was taken.
+     * @param range  Index of the range
+     * @param offset Offset from the start of the range, not from its first page
+     * @returns false when the memory of the range was released
+     */
+    bool Read(std::size_t range, std::size_t offset, void* dest, std::size_t size) const;
+
+private:
+    struct TrackedRange;
+
+    /// Called by the fault handler. Returns true when the write was in a tracked page.
+    static bool HandleWrite(u8* address);
+
+    /// Returns true when a live snapshot still needs writes to the page to fault.
+    static bool IsProtected(const u8* page);
+
+    /// Sets the protection of the pages in [begin, end) to what the live snapshots need.
+    static void UpdateProtection(u8* begin, u8* end);
+
+    static void InstallFaultHandler();
+
+    std::vector<TrackedRange> ranges;
+    u64 epoch;
+};
+
+} // namespace Common
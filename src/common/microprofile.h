@@ -24,6 +24,41 @@ typedef void* HANDLE;
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
 
+#if MICROPROFILE_ENABLED
+#include "common/trace.h"
+
+namespace Common::Trace {
+
+/// MicroProfile scope that is also recorded into the traces, see common/trace.h
+class Scope {
+public:
+    explicit Scope(MicroProfileToken token_) : token{token_}, tick{MicroProfileEnter(token_)} {
+        is_traced = IsRecording() && Begin(token);
+    }
+
+    ~Scope() {
+        if (is_traced) {
+            End(token);
+        }
+        MicroProfileLeave(token, tick);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    MicroProfileToken token;
+    u64 tick;
+    bool is_traced;
+};
+
+} // namespace Common::Trace
+
+#undef MICROPROFILE_SCOPE
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    Common::Trace::Scope MICROPROFILE_TOKEN_PASTE(foo, __LINE__)(g_mp_##var)
+#endif
+
 // On OS X, some Mach header included by MicroProfile defines these as macros, conflicting with
 // identifiers we use.
 #ifdef PAGE_SIZE
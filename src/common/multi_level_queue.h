@@ -7,6 +7,8 @@
 #include <array>
 #include <iterator>
 #include <list>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "common/bit_util.h"
@@ -341,4 +343,297 @@ private:
     u64 used_priorities = 0;
 };
 
+/// Link node embedded into the elements of an IntrusiveMultiLevelQueue.
+template <typename T>
+struct MultiLevelQueueNode {
+    T* prev = nullptr;
+    T* next = nullptr;
+    u32 priority = 0;
+    bool is_linked = false;
+};
+
+/**
+ * Allocation-free counterpart of MultiLevelQueue for pointers to elements that embed their own
+ * MultiLevelQueueNode. NodeAccessor is a (possibly stateful) callable returning the node an element
+ * uses for this particular queue, so one element can be linked into several queues at once.
+ * - O(1) add, remove, adjust and lookup (both front and back)
+ * - discrete priorities and a max of 64 priorities (limited domain)
+ * - an element is linked into a given queue at most once
+ */
+template <typename T, std::size_t Depth, typename NodeAccessor>
+class IntrusiveMultiLevelQueue {
+    static_assert(Depth <= 64, "Priorities are tracked with a 64-bit bitmap");
+
+    using Node = MultiLevelQueueNode<T>;
+
+public:
+    using value_type = T*;
+
+    template <bool is_constant>
+    class iterator_impl {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T*;
+        using pointer = T* const*;
+        using reference = T* const&;
+        using difference_type = std::ptrdiff_t;
+
+        iterator_impl() = default;
+
+        friend bool operator==(const iterator_impl& lhs, const iterator_impl& rhs) {
+            return lhs.current == rhs.current;
+        }
+
+        friend bool operator!=(const iterator_impl& lhs, const iterator_impl& rhs) {
+            return !operator==(lhs, rhs);
+        }
+
+        reference operator*() const {
+            return current;
+        }
+
+        iterator_impl& operator++() {
+            const Node& node = mlq->GetNode(current);
+            current = node.next;
+            if (current == nullptr) {
+                const u64 prios = mlq->used_priorities & ~((2ULL << node.priority) - 1);
+                if (prios != 0) {
+                    current = mlq->heads[CountTrailingZeroes64(prios)];
+                }
+            }
+            return *this;
+        }
+
+        iterator_impl operator++(int) {
+            const iterator_impl v{*this};
+            ++(*this);
+            return v;
+        }
+
+    private:
+        friend class IntrusiveMultiLevelQueue;
+        using container_ptr = std::conditional_t<is_constant, const IntrusiveMultiLevelQueue*,
+                                                 IntrusiveMultiLevelQueue*>;
+
+        explicit iterator_impl(container_ptr mlq, T* current) : mlq{mlq}, current{current} {}
+
+        container_ptr mlq = nullptr;
+        T* current = nullptr;
+    };
+
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+
+    explicit IntrusiveMultiLevelQueue(NodeAccessor accessor = {}) : accessor{std::move(accessor)} {}
+
+    // Elements point back into the queue through their nodes, so copies would alias them.
+    IntrusiveMultiLevelQueue(const IntrusiveMultiLevelQueue&) = delete;
+    IntrusiveMultiLevelQueue& operator=(const IntrusiveMultiLevelQueue&) = delete;
+
+    IntrusiveMultiLevelQueue(IntrusiveMultiLevelQueue&&) = default;
+    IntrusiveMultiLevelQueue& operator=(IntrusiveMultiLevelQueue&&) = default;
+
+    /// Adds an element to the queue. Adding an element that is already linked moves it instead.
+    void add(T* element, u32 priority, bool send_back = true) {
+        Node& node = GetNode(element);
+        if (node.is_linked) {
+            Unlink(node);
+        }
+        node.priority = priority;
+        node.is_linked = true;
+        if (send_back) {
+            LinkBack(element, node);
+        } else {
+            LinkFront(element, node);
+        }
+    }
+
+    /// Removes an element from the queue, does nothing if the element isn't linked into it.
+    /// The priority is only kept for compatibility with MultiLevelQueue, the node knows its own.
+    void remove(T* element, [[maybe_unused]] u32 priority = 0) {
+        Node& node = GetNode(element);
+        if (!node.is_linked) {
+            return;
+        }
+        Unlink(node);
+        node.is_linked = false;
+    }
+
+    void adjust(T* element, u32 old_priority, u32 new_priority, bool adjust_front = false) {
+        remove(element, old_priority);
+        add(element, new_priority, !adjust_front);
+    }
+
+    bool contains(const T* element) const {
+        return GetNode(element).is_linked;
+    }
+
+    /// Moves the first n elements of the given priority level to its back.
+    void yield(u32 priority, std::size_t n = 1) {
+        if (n >= sizes[priority]) {
+            return;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            T* const element = heads[priority];
+            Node& node = GetNode(element);
+            Unlink(node);
+            LinkBack(element, node);
+        }
+    }
+
+    std::size_t depth() const {
+        return Depth;
+    }
+
+    std::size_t size(u32 priority) const {
+        return sizes[priority];
+    }
+
+    std::size_t size() const {
+        u64 priorities = used_priorities;
+        std::size_t size = 0;
+        while (priorities != 0) {
+            const u64 current_priority = CountTrailingZeroes64(priorities);
+            size += sizes[current_priority];
+            priorities &= ~(1ULL << current_priority);
+        }
+        return size;
+    }
+
+    bool empty() const {
+        return used_priorities == 0;
+    }
+
+    bool empty(u32 priority) const {
+        return (used_priorities & (1ULL << priority)) == 0;
+    }
+
+    u32 highest_priority_set(u32 max_priority = 0) const {
+        const u64 priorities =
+            max_priority == 0 ? used_priorities : (used_priorities & ~((1ULL << max_priority) - 1));
+        return priorities == 0 ? Depth : static_cast<u32>(CountTrailingZeroes64(priorities));
+    }
+
+    u32 lowest_priority_set(u32 min_priority = Depth - 1) const {
+        const u64 priorities = min_priority >= Depth - 1
+                                   ? used_priorities
+                                   : (used_priorities & ((1ULL << (min_priority + 1)) - 1));
+        return priorities == 0 ? Depth : 63 - CountLeadingZeroes64(priorities);
+    }
+
+    const_iterator cbegin(u32 max_prio = 0) const {
+        const u32 priority = highest_priority_set(max_prio);
+        return const_iterator{this, priority == Depth ? nullptr : heads[priority]};
+    }
+    const_iterator begin(u32 max_prio = 0) const {
+        return cbegin(max_prio);
+    }
+    iterator begin(u32 max_prio = 0) {
+        const u32 priority = highest_priority_set(max_prio);
+        return iterator{this, priority == Depth ? nullptr : heads[priority]};
+    }
+
+    const_iterator cend() const {
+        return const_iterator{this, nullptr};
+    }
+    const_iterator end() const {
+        return cend();
+    }
+    iterator end() {
+        return iterator{this, nullptr};
+    }
+
+    /// Returns the first element with a priority of at least max_priority, or nullptr if none.
+    T* front(u32 max_priority = 0) const {
+        const u32 priority = highest_priority_set(max_priority);
+        return priority == Depth ? nullptr : heads[priority];
+    }
+
+    /// Returns the last element with a priority of at most min_priority, or nullptr if none.
+    T* back(u32 min_priority = Depth - 1) const {
+        const u32 priority = lowest_priority_set(min_priority);
+        return priority == Depth ? nullptr : tails[priority];
+    }
+
+    void clear() {
+        u64 priorities = used_priorities;
+        while (priorities != 0) {
+            const u32 priority = static_cast<u32>(CountTrailingZeroes64(priorities));
+            T* element = heads[priority];
+            while (element != nullptr) {
+                Node& node = GetNode(element);
+                element = node.next;
+                node = Node{};
+            }
+            heads[priority] = nullptr;
+            tails[priority] = nullptr;
+            sizes[priority] = 0;
+            priorities &= ~(1ULL << priority);
+        }
+        used_priorities = 0;
+    }
+
+private:
+    Node& GetNode(T* element) {
+        return accessor(*element);
+    }
+
+    const Node& GetNode(const T* element) const {
+        return accessor(*const_cast<T*>(element));
+    }
+
+    void LinkBack(T* element, Node& node) {
+        const u32 priority = node.priority;
+        node.prev = tails[priority];
+        node.next = nullptr;
+        if (tails[priority] != nullptr) {
+            GetNode(tails[priority]).next = element;
+        } else {
+            heads[priority] = element;
+        }
+        tails[priority] = element;
+        ++sizes[priority];
+        used_priorities |= 1ULL << priority;
+    }
+
+    void LinkFront(T* element, Node& node) {
+        const u32 priority = node.priority;
+        node.prev = nullptr;
+        node.next = heads[priority];
+        if (heads[priority] != nullptr) {
+            GetNode(heads[priority]).prev = element;
+        } else {
+            tails[priority] = element;
+        }
+        heads[priority] = element;
+        ++sizes[priority];
+        used_priorities |= 1ULL << priority;
+    }
+
+    void Unlink(Node& node) {
+        const u32 priority = node.priority;
+        if (node.prev != nullptr) {
+            GetNode(node.prev).next = node.next;
+        } else {
+            heads[priority] = node.next;
+        }
+        if (node.next != nullptr) {
+            GetNode(node.next).prev = node.prev;
+        } else {
+            tails[priority] = node.prev;
+        }
+        node.prev = nullptr;
+        node.next = nullptr;
+        if (--sizes[priority] == 0) {
+            used_priorities &= ~(1ULL << priority);
+        }
+    }
+
+    std::array<T*, Depth> heads{};
+    std::array<T*, Depth> tails{};
+    std::array<std::size_t, Depth> sizes{};
+    u64 used_priorities = 0;
+    NodeAccessor accessor;
+};
+
 } // namespace Common
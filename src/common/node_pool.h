@@ -0,0 +1,132 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "common/alignment.h"
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Pool of fixed size nodes carved out of larger slabs, for node based containers that insert and
+ * erase often. Freed nodes are kept for reuse instead of going back to the heap, and nodes
+ * allocated together sit next to each other in memory, so walking the container stays cache
+ * friendly.
+ *
+ * The node size is set by the first allocation. The pool is not thread safe, it is meant to be
+ * owned along with the container using it.
+ */
+class NodePool {
+public:
+    explicit NodePool(std::size_t nodes_per_slab_ = 64) : nodes_per_slab{nodes_per_slab_} {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /// Returns true if nodes of the given size can be allocated from the pool
+    bool Fits(std::size_t size) const {
+        return node_size == 0 || size <= node_size;
+    }
+
+    void* Allocate(std::size_t size) {
+        if (node_size == 0) {
+            node_size = AlignUp(std::max(size, sizeof(FreeNode)), alignof(std::max_align_t));
+        }
+        if (free_list != nullptr) {
+            FreeNode* const node = free_list;
+            free_list = node->next;
+            return node;
+        }
+        if (slab_cursor == slab_end) {
+            const std::size_t slab_size = node_size * nodes_per_slab;
+            slabs.push_back(std::make_unique<u8[]>(slab_size));
+            slab_cursor = slabs.back().get();
+            slab_end = slab_cursor + slab_size;
+        }
+        void* const node = slab_cursor;
+        slab_cursor += node_size;
+        return node;
+    }
+
+    void Free(void* pointer) {
+        FreeNode* const node = static_cast<FreeNode*>(pointer);
+        node->next = free_list;
+        free_list = node;
+    }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    const std::size_t nodes_per_slab;
+    std::size_t node_size = 0;
+    std::vector<std::unique_ptr<u8[]>> slabs;
+    u8* slab_cursor = nullptr;
+    u8* slab_end = nullptr;
+    FreeNode* free_list = nullptr;
+};
+
+/**
+ * Allocator serving single node allocations from a NodePool, and anything else from the heap.
+ * Default constructed allocators have no pool, and copies of a container don't share the pool of
+ * the original, so they can outlive it.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Overaligned types are not supported");
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    PoolAllocator() noexcept = default;
+    explicit PoolAllocator(NodePool* pool_) noexcept : pool{pool_} {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool{other.pool} {}
+
+    T* allocate(std::size_t n) {
+        if (n == 1 && pool != nullptr && pool->Fits(sizeof(T))) {
+            return static_cast<T*>(pool->Allocate(sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if (n == 1 && pool != nullptr && pool->Fits(sizeof(T))) {
+            pool->Free(pointer);
+            return;
+        }
+        ::operator delete(pointer);
+    }
+
+    PoolAllocator select_on_container_copy_construction() const noexcept {
+        return {};
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return pool == other.pool;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept {
+        return pool != other.pool;
+    }
+
+    NodePool* pool = nullptr;
+};
+
+} // namespace Common
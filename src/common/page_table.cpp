@@ -14,18 +14,16 @@ void PageTable::Resize(std::size_t address_space_width_in_bits) {
     const std::size_t num_page_table_entries = 1ULL
                                                << (address_space_width_in_bits - page_size_in_bits);
 
-    pointers.resize(num_page_table_entries);
-    attributes.resize(num_page_table_entries);
-    backing_addr.resize(num_page_table_entries);
-
-    // The default is a 39-bit address space, which causes an initial 1GB allocation size. If the
-    // vector size is subsequently decreased (via resize), the vector might not automatically
-    // actually reallocate/resize its underlying allocation, which wastes up to ~800 MB for
-    // 36-bit titles. Call shrink_to_fit to reduce capacity to what's actually in use.
-
-    pointers.shrink_to_fit();
-    attributes.shrink_to_fit();
-    backing_addr.shrink_to_fit();
+    // The tables are reserved in virtual memory and only committed where pages get mapped, so
+    // the default 39-bit address space doesn't cost its 1GB of pointers up front.
+    pointers.Resize(num_page_table_entries);
+    attributes.Resize(num_page_table_entries);
+}
+
+void PageTable::Clear() {
+    pointers.Clear();
+    attributes.Clear();
+    special_regions.clear();
 }
 
 } // namespace Common
@@ -4,16 +4,16 @@
 
 #pragma once
 
-#include <vector>
 #include <boost/icl/interval_map.hpp>
 #include "common/common_types.h"
 #include "common/memory_hook.h"
+#include "common/virtual_buffer.h"
 
 namespace Common {
 
 enum class PageType : u8 {
-    /// Page is unmapped and should cause an access error.
-    Unmapped,
+    /// Page is unmapped and should cause an access error. Zeroed tables are unmapped.
+    Unmapped = 0,
     /// Page is mapped to regular memory. This is the only type you can get pointers to.
     Memory,
     /// Page is mapped to regular memory, but also needs to check for rasterizer cache flushing and
@@ -52,17 +52,21 @@ struct PageTable {
 
     /**
      * Resizes the page table to be able to accomodate enough pages within
-     * a given address space.
+     * a given address space. Every page is left unmapped.
      *
      * @param address_space_width_in_bits The address size width in bits.
      */
     void Resize(std::size_t address_space_width_in_bits);
 
+    /// Unmaps every page, releasing the host memory taken by the tables.
+    void Clear();
+
     /**
-     * Vector of memory pointers backing each page. An entry can only be non-null if the
-     * corresponding entry in the `attributes` vector is of type `Memory`.
+     * Memory pointers backing each page. An entry can only be non-null if the corresponding entry
+     * in `attributes` is of type `Memory`. It is kept flat so the JIT reaches it with a single
+     * indirection, the memory of unused ranges is never committed.
      */
-    std::vector<u8*> pointers;
+    VirtualBuffer<u8*> pointers;
 
     /**
      * Contains MMIO handlers that back memory regions whose entries in the `attribute` vector is
@@ -71,12 +75,10 @@ struct PageTable {
     boost::icl::interval_map<u64, std::set<SpecialRegion>> special_regions;
 
     /**
-     * Vector of fine grained page attributes. If it is set to any value other than `Memory`, then
-     * the corresponding entry in `pointers` MUST be set to null.
+     * Fine grained page attributes. If it is set to any value other than `Memory`, then the
+     * corresponding entry in `pointers` MUST be set to null.
      */
-    std::vector<PageType> attributes;
-
-    std::vector<u64> backing_addr;
+    VirtualBuffer<PageType> attributes;
 
     const std::size_t page_size_in_bits{};
 };
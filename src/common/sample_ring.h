@@ -0,0 +1,100 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Single producer, multiple consumer ring of timestamped samples from an input source. The
+ * producer pushes samples as they arrive, in batches when several arrive at once, and consumers
+ * read the value at any time they like, interpolated between the samples around it. Neither side
+ * ever blocks: a consumer that was lapped by the producer while reading simply reads again.
+ *
+ * @tparam T        Sample value, providing static T Interpolate(const T& a, const T& b, float t)
+ * @tparam capacity Number of samples kept, only the newer half of them is looked up
+ */
+template <typename T, std::size_t capacity = 64>
+class SampleRing {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::atomic<u64>::is_always_lock_free);
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample {
+        Clock::time_point time;
+        T value;
+    };
+
+    /// Pushes samples, oldest first and not older than the ones already pushed
+    void Push(const Sample* new_samples, std::size_t count) {
+        u64 index = write_index.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < count; ++i) {
+            samples[index % capacity] = new_samples[i];
+            write_index.store(++index, std::memory_order_release);
+        }
+    }
+
+    void Push(Clock::time_point time, const T& value) {
+        const Sample sample{time, value};
+        Push(&sample, 1);
+    }
+
+    /// Returns the newest value, if any was pushed
+    std::optional<T> GetLatest() const {
+        return GetAt(Clock::time_point::max());
+    }
+
+    /**
+     * Returns the value at the given time, interpolated between the samples around it. Times
+     * past the newest sample give the newest value, times before the oldest looked up sample give
+     * that sample's value.
+     */
+    std::optional<T> GetAt(Clock::time_point time) const {
+        while (true) {
+            const u64 end = write_index.load(std::memory_order_acquire);
+            if (end == 0) {
+                return std::nullopt;
+            }
+            const u64 begin = end - std::min<u64>(end, capacity / 2);
+
+            Sample newer = samples[(end - 1) % capacity];
+            T value = newer.value;
+            for (u64 index = end - 1; index-- > begin && time < newer.time;) {
+                const Sample older = samples[index % capacity];
+                if (older.time <= time) {
+                    const auto span = std::chrono::duration<float>(newer.time - older.time);
+                    const auto elapsed = std::chrono::duration<float>(time - older.time);
+                    value = T::Interpolate(older.value, newer.value, elapsed / span);
+                    break;
+                }
+                newer = older;
+                value = older.value;
+            }
+
+            // The producer only ever writes the slot after the last published one, the copies are
+            // only torn when it came around to the oldest slot read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (write_index.load(std::memory_order_relaxed) - begin < capacity) {
+                return value;
+            }
+        }
+    }
+
+private:
+    std::array<Sample, capacity> samples{};
+    std::atomic<u64> write_index{0};
+};
+
+} // namespace Common
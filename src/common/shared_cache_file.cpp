@@ -0,0 +1,211 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "common/alignment.h"
+#include "common/common_funcs.h"
+#include "common/logging/log.h"
+#include "common/shared_cache_file.h"
+#include "common/string_util.h"
+
+namespace Common {
+
+namespace {
+
+constexpr u32 MAGIC = Common::MakeMagic('Y', 'S', 'C', 'F');
+
+/// Bumped whenever the layout of the file changes
+constexpr u32 VERSION = 1;
+
+/// The header and the block states take whole pages, so the data is page aligned
+constexpr std::size_t PAGE_SIZE = 0x1000;
+
+/// How long to wait for another process to finish creating the file
+constexpr auto INITIALIZATION_TIMEOUT = std::chrono::seconds{1};
+
+enum InitState : u32 {
+    Uninitialized = 0,
+    Initializing = 1,
+    Initialized = 2,
+};
+
+enum BlockStateValue : u32 {
+    Empty = 0,
+    Storing = 1,
+    Stored = 2,
+};
+
+struct Header {
+    std::atomic<u32> init_state;
+    u32 magic;
+    u32 version;
+    u32 reserved;
+    u64 size;
+    u64 block_size;
+};
+static_assert(sizeof(Header) <= PAGE_SIZE, "Header is larger than a page");
+
+} // Anonymous namespace
+
+SharedCacheFile::SharedCacheFile(u8* mapping_, std::size_t mapping_size_, std::size_t size_,
+                                 std::size_t block_size_)
+    : mapping{mapping_}, mapping_size{mapping_size_}, size{size_}, block_size{block_size_} {
+    const std::size_t num_blocks = (size + block_size - 1) / block_size;
+    block_states = reinterpret_cast<BlockState*>(mapping + PAGE_SIZE);
+    data = mapping + PAGE_SIZE + AlignUp(num_blocks * sizeof(BlockState), PAGE_SIZE);
+}
+
+SharedCacheFile::~SharedCacheFile() {
+    Unmap(mapping, mapping_size);
+}
+
+std::unique_ptr<SharedCacheFile> SharedCacheFile::Open(const std::string& path, std::size_t size,
+                                                       std::size_t block_size) {
+    if (size == 0 || block_size == 0) {
+        return nullptr;
+    }
+
+    const std::size_t num_blocks = (size + block_size - 1) / block_size;
+    const std::size_t mapping_size =
+        PAGE_SIZE + AlignUp(num_blocks * sizeof(BlockState), PAGE_SIZE) + size;
+    u8* const mapping = Map(path, mapping_size);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+
+    // Whoever maps the fresh, zero filled, file first writes the header
+    auto* const header = reinterpret_cast<Header*>(mapping);
+    u32 init_state = Uninitialized;
+    if (header->init_state.compare_exchange_strong(init_state, Initializing,
+                                                   std::memory_order_acq_rel)) {
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->size = size;
+        header->block_size = block_size;
+        header->init_state.store(Initialized, std::memory_order_release);
+    } else {
+        const auto deadline = std::chrono::steady_clock::now() + INITIALIZATION_TIMEOUT;
+        while (header->init_state.load(std::memory_order_acquire) != Initialized) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                LOG_WARNING(Common_Filesystem, "Shared cache file {} was never initialized",
+                            path);
+                Unmap(mapping, mapping_size);
+                return nullptr;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    if (header->magic != MAGIC || header->version != VERSION || header->size != size ||
+        header->block_size != block_size) {
+        LOG_WARNING(Common_Filesystem, "Shared cache file {} holds data of another layout", path);
+        Unmap(mapping, mapping_size);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedCacheFile>(
+        new SharedCacheFile(mapping, mapping_size, size, block_size));
+}
+
+std::size_t SharedCacheFile::GetBlockSize(std::size_t block) const {
+    return std::min(block_size, size - block * block_size);
+}
+
+const u8* SharedCacheFile::GetBlock(std::size_t block) const {
+    if (block_states[block].load(std::memory_order_acquire) != Stored) {
+        return nullptr;
+    }
+    return data + block * block_size;
+}
+
+void SharedCacheFile::StoreBlock(std::size_t block, const u8* block_data) {
+    u32 state = Empty;
+    if (!block_states[block].compare_exchange_strong(state, Storing, std::memory_order_acquire)) {
+        return;
+    }
+    std::memcpy(data + block * block_size, block_data, GetBlockSize(block));
+    block_states[block].store(Stored, std::memory_order_release);
+}
+
+u8* SharedCacheFile::Map(const std::string& path, std::size_t mapping_size) {
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(UTF8ToUTF16W(path).c_str(), GENERIC_READ | GENERIC_WRITE,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERROR(Common_Filesystem, "Failed to open shared cache file {}", path);
+        return nullptr;
+    }
+
+    // Without this, growing the file would allocate disk space for every block
+    DWORD bytes_returned;
+    DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes_returned, nullptr);
+
+    const u64 size = static_cast<u64>(mapping_size);
+    const HANDLE file_mapping =
+        CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                           static_cast<DWORD>(size), nullptr);
+    CloseHandle(file);
+    if (file_mapping == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to create mapping of shared cache file {}", path);
+        return nullptr;
+    }
+
+    void* const pointer = MapViewOfFile(file_mapping, FILE_MAP_ALL_ACCESS, 0, 0, mapping_size);
+    CloseHandle(file_mapping);
+    if (pointer == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to map shared cache file {}", path);
+        return nullptr;
+    }
+    return static_cast<u8*>(pointer);
+#else
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        LOG_ERROR(Common_Filesystem, "Failed to open shared cache file {}", path);
+        return nullptr;
+    }
+
+    // Growing the file with ftruncate keeps it sparse, only stored blocks take disk space
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+        (static_cast<std::size_t>(file_stat.st_size) < mapping_size &&
+         ftruncate(fd, static_cast<off_t>(mapping_size)) != 0)) {
+        LOG_ERROR(Common_Filesystem, "Failed to resize shared cache file {}", path);
+        close(fd);
+        return nullptr;
+    }
+
+    void* const pointer = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pointer == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "Failed to map shared cache file {}", path);
+        return nullptr;
+    }
+    return static_cast<u8*>(pointer);
+#endif
+}
+
+void SharedCacheFile::Unmap(u8* mapping, std::size_t mapping_size) {
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, mapping_size);
+#endif
+}
+
+} // namespace Common
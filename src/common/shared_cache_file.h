@@ -0,0 +1,82 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * File of fixed size blocks mapped into the memory of every process that opens it, so data that
+ * is expensive to produce, like decrypted or decompressed content, is produced once and then read
+ * in place by every instance of the emulator, without each one holding its own copy.
+ *
+ * Blocks are stored at most once, by whoever produces them first, and are immutable afterwards.
+ * The file is sparse, so only stored blocks take disk space, and it outlives the processes, so
+ * later runs start with the blocks earlier runs produced.
+ */
+class SharedCacheFile {
+public:
+    ~SharedCacheFile();
+
+    SharedCacheFile(const SharedCacheFile&) = delete;
+    SharedCacheFile& operator=(const SharedCacheFile&) = delete;
+
+    /**
+     * Opens the cache file at path, creating it when it doesn't exist.
+     * @param size       Size in bytes of the cached data
+     * @param block_size Size in bytes of a block, only the last block can be shorter
+     * @returns null when the file can't be mapped or was created for data of another layout
+     */
+    static std::unique_ptr<SharedCacheFile> Open(const std::string& path, std::size_t size,
+                                                 std::size_t block_size);
+
+    std::size_t GetSize() const {
+        return size;
+    }
+
+    std::size_t GetBlockSize() const {
+        return block_size;
+    }
+
+    /// Returns the size of a block, which is shorter than the others for the last one
+    std::size_t GetBlockSize(std::size_t block) const;
+
+    /// Returns the contents of a block if any process stored it, null otherwise
+    const u8* GetBlock(std::size_t block) const;
+
+    /**
+     * Stores the contents of a block, GetBlockSize(block) bytes long. Does nothing when another
+     * process is storing or already stored the block. A block whose process died while storing
+     * it is never stored, it is simply produced again by every reader.
+     */
+    void StoreBlock(std::size_t block, const u8* data);
+
+private:
+    using BlockState = std::atomic<u32>;
+    static_assert(BlockState::is_always_lock_free, "Block states must be usable across processes");
+
+    SharedCacheFile(u8* mapping, std::size_t mapping_size, std::size_t size,
+                    std::size_t block_size);
+
+    /// Maps the file at path, sized to mapping_size bytes
+    static u8* Map(const std::string& path, std::size_t mapping_size);
+
+    static void Unmap(u8* mapping, std::size_t mapping_size);
+
+    u8* const mapping;
+    const std::size_t mapping_size;
+    const std::size_t size;
+    const std::size_t block_size;
+    BlockState* block_states;
+    u8* data;
+};
+
+} // namespace Common
@@ -2,10 +2,26 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include "common/thread.h"
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#endif
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif defined(_WIN32)
+// WaitOnAddress is only declared when targeting Windows 8 or later, which every supported host is
+#if _WIN32_WINNT < 0x0602
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0602
+#endif
 #include <windows.h>
 #else
 #if defined(__Bitrig__) || defined(__DragonFly__) || defined(__FreeBSD__) || defined(__OpenBSD__)
@@ -25,6 +41,205 @@
 
 namespace Common {
 
+namespace {
+
+constexpr u32 MIN_SPINS = 16;
+constexpr u32 MAX_SPINS = 4096;
+
+void CpuRelax() {
+#ifdef ARCHITECTURE_x86_64
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * Spins until the predicate holds or the spin limit is exhausted. The limit grows when spinning
+ * pays off and shrinks when the thread ends up parking anyway.
+ */
+template <typename Predicate>
+bool AdaptiveSpin(std::atomic<u32>& spin_limit, Predicate&& predicate) {
+    // With a single core the signalling thread cannot run while we spin
+    static const bool can_spin = std::thread::hardware_concurrency() > 1;
+    if (!can_spin) {
+        return predicate();
+    }
+    const u32 limit = spin_limit.load(std::memory_order_relaxed);
+    for (u32 spin = 0; spin < limit; ++spin) {
+        if (predicate()) {
+            spin_limit.store(std::min(limit * 2, MAX_SPINS), std::memory_order_relaxed);
+            return true;
+        }
+        CpuRelax();
+    }
+    spin_limit.store(std::max(limit / 2, MIN_SPINS), std::memory_order_relaxed);
+    return false;
+}
+
+#if !defined(__linux__) && !defined(_WIN32)
+/// Emulates futexes with condition variables, the words are hashed to a fixed set of slots
+struct ParkingSlot {
+    std::mutex mutex;
+    std::condition_variable condvar;
+};
+
+ParkingSlot& GetParkingSlot(const std::atomic<u32>& word) {
+    static std::array<ParkingSlot, 64> slots;
+    const auto address = reinterpret_cast<std::uintptr_t>(&word);
+    return slots[(address / sizeof(u32)) % slots.size()];
+}
+#endif
+
+} // Anonymous namespace
+
+static_assert(sizeof(std::atomic<u32>) == sizeof(u32), "Futex words must be plain integers");
+
+#ifdef __linux__
+
+void FutexWait(std::atomic<u32>& word, u32 expected) {
+    syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr,
+            nullptr, 0);
+}
+
+void FutexWaitFor(std::atomic<u32>& word, u32 expected, std::chrono::nanoseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+    timespec relative_time{};
+    relative_time.tv_sec = static_cast<time_t>(timeout.count() / 1'000'000'000);
+    relative_time.tv_nsec = static_cast<long>(timeout.count() % 1'000'000'000);
+    syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAIT_PRIVATE, expected,
+            &relative_time, nullptr, 0);
+}
+
+void FutexWakeOne(std::atomic<u32>& word) {
+    syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<u32>& word) {
+    syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr,
+            nullptr, 0);
+}
+
+#elif defined(_WIN32)
+
+void FutexWait(std::atomic<u32>& word, u32 expected) {
+    WaitOnAddress(&word, &expected, sizeof(u32), INFINITE);
+}
+
+void FutexWaitFor(std::atomic<u32>& word, u32 expected, std::chrono::nanoseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+    // Round up, a zero millisecond wait would turn timed waits into busy loops
+    const auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+    WaitOnAddress(&word, &expected, sizeof(u32), static_cast<DWORD>(milliseconds));
+}
+
+void FutexWakeOne(std::atomic<u32>& word) {
+    WakeByAddressSingle(&word);
+}
+
+void FutexWakeAll(std::atomic<u32>& word) {
+    WakeByAddressAll(&word);
+}
+
+#else
+
+void FutexWait(std::atomic<u32>& word, u32 expected) {
+    ParkingSlot& slot = GetParkingSlot(word);
+    std::unique_lock lock{slot.mutex};
+    if (word.load() == expected) {
+        slot.condvar.wait(lock);
+    }
+}
+
+void FutexWaitFor(std::atomic<u32>& word, u32 expected, std::chrono::nanoseconds timeout) {
+    ParkingSlot& slot = GetParkingSlot(word);
+    std::unique_lock lock{slot.mutex};
+    if (word.load() == expected) {
+        slot.condvar.wait_for(lock, timeout);
+    }
+}
+
+void FutexWakeOne(std::atomic<u32>& word) {
+    // Slots are shared between words, everyone has to wake up to check their own
+    FutexWakeAll(word);
+}
+
+void FutexWakeAll(std::atomic<u32>& word) {
+    ParkingSlot& slot = GetParkingSlot(word);
+    { std::lock_guard lock{slot.mutex}; }
+    slot.condvar.notify_all();
+}
+
+#endif
+
+void Event::Set() {
+    is_set.store(1);
+    if (num_waiters.load() != 0) {
+        FutexWakeOne(is_set);
+    }
+}
+
+void Event::Wait() {
+    if (Spin()) {
+        return;
+    }
+    num_waiters.fetch_add(1);
+    while (!TryConsume()) {
+        FutexWait(is_set, 0);
+    }
+    num_waiters.fetch_sub(1);
+}
+
+bool Event::Spin() {
+    return AdaptiveSpin(spin_limit, [this] { return TryConsume(); });
+}
+
+bool Event::WaitUntilSteady(std::chrono::steady_clock::time_point deadline) {
+    if (Spin()) {
+        return true;
+    }
+    num_waiters.fetch_add(1);
+    bool signaled = true;
+    while (!TryConsume()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            signaled = false;
+            break;
+        }
+        FutexWaitFor(is_set, 0, deadline - now);
+    }
+    num_waiters.fetch_sub(1);
+    return signaled;
+}
+
+void Barrier::Sync() {
+    const u32 current_generation = generation.load();
+    if (waiting.fetch_add(1) + 1 == count) {
+        waiting.store(0);
+        generation.fetch_add(1);
+        if (num_parked.load() != 0) {
+            FutexWakeAll(generation);
+        }
+        return;
+    }
+
+    const auto is_released = [this, current_generation] {
+        return generation.load() != current_generation;
+    };
+    if (AdaptiveSpin(spin_limit, is_released)) {
+        return;
+    }
+    num_parked.fetch_add(1);
+    while (!is_released()) {
+        FutexWait(generation, current_generation);
+    }
+    num_parked.fetch_sub(1);
+}
+
 #ifdef _MSC_VER
 
 // Sets the debugger-visible name of the current thread.
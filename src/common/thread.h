@@ -4,86 +4,85 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <mutex>
 #include <thread>
+#include "common/common_types.h"
 
 namespace Common {
 
+/// Blocks the calling thread while the word holds the expected value. It may wake up spuriously.
+void FutexWait(std::atomic<u32>& word, u32 expected);
+
+/// Like FutexWait, but gives up once the timeout expires.
+void FutexWaitFor(std::atomic<u32>& word, u32 expected, std::chrono::nanoseconds timeout);
+
+/// Wakes up one thread blocked on the word.
+void FutexWakeOne(std::atomic<u32>& word);
+
+/// Wakes up every thread blocked on the word.
+void FutexWakeAll(std::atomic<u32>& word);
+
+/**
+ * Auto resetting event, each Set releases one Wait. Waiters spin for a short, adaptive amount of
+ * time before parking on a futex, so handoffs between busy threads don't go through the kernel.
+ */
 class Event {
 public:
-    void Set() {
-        std::lock_guard lk{mutex};
-        if (!is_set) {
-            is_set = true;
-            condvar.notify_one();
-        }
-    }
+    void Set();
 
-    void Wait() {
-        std::unique_lock lk{mutex};
-        condvar.wait(lk, [&] { return is_set; });
-        is_set = false;
-    }
+    void Wait();
 
-    template <class Duration>
-    bool WaitFor(const std::chrono::duration<Duration>& time) {
-        std::unique_lock lk{mutex};
-        if (!condvar.wait_for(lk, time, [this] { return is_set; }))
-            return false;
-        is_set = false;
-        return true;
+    template <class Rep, class Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& time) {
+        return WaitUntilSteady(std::chrono::steady_clock::now() +
+                               std::chrono::duration_cast<std::chrono::nanoseconds>(time));
     }
 
     template <class Clock, class Duration>
     bool WaitUntil(const std::chrono::time_point<Clock, Duration>& time) {
-        std::unique_lock lk{mutex};
-        if (!condvar.wait_until(lk, time, [this] { return is_set; }))
-            return false;
-        is_set = false;
-        return true;
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time - Clock::now());
+        return WaitUntilSteady(std::chrono::steady_clock::now() + remaining);
     }
 
     void Reset() {
-        std::unique_lock lk{mutex};
-        // no other action required, since wait loops on the predicate and any lingering signal will
-        // get cleared on the first iteration
-        is_set = false;
+        // Lingering signals are cleared, waiters keep waiting for a new one
+        is_set.store(0);
     }
 
 private:
-    bool is_set = false;
-    std::condition_variable condvar;
-    std::mutex mutex;
+    /// Consumes the signal if it's set.
+    bool TryConsume() {
+        return is_set.load(std::memory_order_relaxed) != 0 && is_set.exchange(0) != 0;
+    }
+
+    /// Spins for a while trying to consume the signal, adapting the time to past outcomes.
+    bool Spin();
+
+    bool WaitUntilSteady(std::chrono::steady_clock::time_point deadline);
+
+    std::atomic<u32> is_set{0};
+    std::atomic<u32> num_waiters{0};  ///< Threads parked, or about to park, on the event
+    std::atomic<u32> spin_limit{256}; ///< Iterations spun before parking, adapted on each wait
 };
 
 class Barrier {
 public:
-    explicit Barrier(std::size_t count_) : count(count_) {}
+    explicit Barrier(std::size_t count_) : count(static_cast<u32>(count_)) {}
 
     /// Blocks until all "count" threads have called Sync()
-    void Sync() {
-        std::unique_lock lk{mutex};
-        const std::size_t current_generation = generation;
-
-        if (++waiting == count) {
-            generation++;
-            waiting = 0;
-            condvar.notify_all();
-        } else {
-            condvar.wait(lk,
-                         [this, current_generation] { return current_generation != generation; });
-        }
-    }
+    void Sync();
 
 private:
-    std::condition_variable condvar;
-    std::mutex mutex;
-    std::size_t count;
-    std::size_t waiting = 0;
-    std::size_t generation = 0; // Incremented once each time the barrier is used
+    u32 count;
+    std::atomic<u32> waiting{0};
+    std::atomic<u32> generation{0}; // Incremented once each time the barrier is used
+    std::atomic<u32> num_parked{0};  ///< Threads parked, or about to park, on the barrier
+    std::atomic<u32> spin_limit{256}; ///< Iterations spun before parking, adapted on each sync
 };
 
 void SetCurrentThreadName(const char* name);
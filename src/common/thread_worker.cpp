@@ -0,0 +1,114 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "common/thread.h"
+#include "common/thread_worker.h"
+
+namespace Common {
+
+TaskGroup::TaskGroup() = default;
+
+TaskGroup::~TaskGroup() = default;
+
+void TaskGroup::Wait() {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [this] { return pending == 0; });
+}
+
+bool TaskGroup::IsDone() const {
+    std::lock_guard lock{mutex};
+    return pending == 0;
+}
+
+void TaskGroup::Add() {
+    std::lock_guard lock{mutex};
+    ++pending;
+}
+
+void TaskGroup::Finish() {
+    // Notify while holding the lock, the group may be destroyed as soon as Wait returns
+    std::lock_guard lock{mutex};
+    if (--pending == 0) {
+        cv.notify_all();
+    }
+}
+
+ThreadWorker::ThreadWorker(std::size_t num_workers, const std::string& name) {
+    threads.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        threads.emplace_back([this, thread_name = fmt::format("{}:{}", name, i)] {
+            SetCurrentThreadName(thread_name.c_str());
+            WorkerLoop();
+        });
+    }
+}
+
+ThreadWorker::~ThreadWorker() {
+    {
+        std::lock_guard lock{queue_mutex};
+        stop = true;
+    }
+    condition.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadWorker::QueueWork(std::function<void()> work, WorkPriority priority) {
+    {
+        std::lock_guard lock{queue_mutex};
+        requests[static_cast<std::size_t>(priority)].push(std::move(work));
+    }
+    condition.notify_one();
+}
+
+void ThreadWorker::QueueWork(TaskGroup& group, std::function<void()> work,
+                             WorkPriority priority) {
+    group.Add();
+    QueueWork(
+        [&group, work = std::move(work)] {
+            work();
+            group.Finish();
+        },
+        priority);
+}
+
+void ThreadWorker::WorkerLoop() {
+    const auto has_requests = [this] {
+        return std::any_of(requests.begin(), requests.end(),
+                           [](const auto& queue) { return !queue.empty(); });
+    };
+    while (true) {
+        std::function<void()> work;
+        {
+            std::unique_lock lock{queue_mutex};
+            condition.wait(lock, [&] { return stop || has_requests(); });
+            const auto it = std::find_if(requests.begin(), requests.end(),
+                                         [](const auto& queue) { return !queue.empty(); });
+            if (it == requests.end()) {
+                // Stopping with nothing left to do
+                return;
+            }
+            work = std::move(it->front());
+            it->pop();
+        }
+        work();
+    }
+}
+
+std::size_t GetDefaultNumWorkers() {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+}
+
+ThreadWorker& GetSharedWorker() {
+    static ThreadWorker worker{GetDefaultNumWorkers(), "yuzu:Worker"};
+    return worker;
+}
+
+} // namespace Common
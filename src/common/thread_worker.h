@@ -0,0 +1,94 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/// Order in which queued work is picked up. Work of the same priority runs in submission order.
+enum class WorkPriority {
+    High,   ///< Work something is waiting on right now
+    Normal, ///< Work needed soon
+    Low,    ///< Speculative work, only run when nothing else is queued
+};
+
+/**
+ * Wait handle for a set of tasks queued on a ThreadWorker. A group can be reused once it has been
+ * waited on, and must outlive the tasks queued with it.
+ */
+class TaskGroup final {
+public:
+    TaskGroup();
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Blocks until every task queued with this group has finished.
+    void Wait();
+
+    /// Returns true when every task queued with this group has finished.
+    bool IsDone() const;
+
+private:
+    friend class ThreadWorker;
+
+    void Add();
+    void Finish();
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t pending = 0;
+};
+
+/// Fixed set of threads executing queued work by priority.
+class ThreadWorker final {
+public:
+    explicit ThreadWorker(std::size_t num_workers, const std::string& name);
+    ~ThreadWorker();
+
+    ThreadWorker(const ThreadWorker&) = delete;
+    ThreadWorker& operator=(const ThreadWorker&) = delete;
+
+    /// Queues work to be executed by one of the worker threads.
+    void QueueWork(std::function<void()> work, WorkPriority priority = WorkPriority::Normal);
+
+    /// Queues work to be executed by one of the worker threads, tracked by the given group.
+    void QueueWork(TaskGroup& group, std::function<void()> work,
+                   WorkPriority priority = WorkPriority::Normal);
+
+    /// Returns the number of worker threads.
+    std::size_t NumWorkers() const {
+        return threads.size();
+    }
+
+private:
+    static constexpr std::size_t NumPriorities = 3;
+
+    void WorkerLoop();
+
+    std::vector<std::thread> threads;
+    std::array<std::queue<std::function<void()>>, NumPriorities> requests;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop = false;
+};
+
+/// Returns the number of workers that keeps every host core busy alongside the calling thread.
+std::size_t GetDefaultNumWorkers();
+
+/// Returns the worker pool shared by background jobs across the emulator.
+ThreadWorker& GetSharedWorker();
+
+} // namespace Common
@@ -0,0 +1,292 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/trace.h"
+
+namespace Common::Trace {
+
+namespace Detail {
+std::atomic_bool is_recording{false};
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Events per thread, a power of two
+constexpr std::size_t RING_SIZE = 1 << 16;
+constexpr auto WRITE_INTERVAL = std::chrono::milliseconds(100);
+
+struct Event {
+    Clock::time_point time;
+    u64 token;
+    bool is_begin;
+};
+
+/// Ring written by its thread and read by the writer thread
+struct ThreadBuffer {
+    explicit ThreadBuffer(u32 id) : id{id} {}
+
+    void SetName(std::string new_name) {
+        std::lock_guard lock{name_mutex};
+        name = std::move(new_name);
+        is_name_written = false;
+    }
+
+    const u32 id;
+    std::array<Event, RING_SIZE> events;
+    std::atomic<std::size_t> head{0}; ///< Written by the thread
+    std::atomic<std::size_t> tail{0}; ///< Written by the writer thread
+    std::atomic<u64> dropped{0};
+
+    std::mutex name_mutex;
+    std::string name;
+    bool is_name_written = false;
+};
+
+std::string Escape(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+const char* TimerName(u64 token) {
+#if MICROPROFILE_ENABLED
+    return MicroProfileGet()->TimerInfo[MicroProfileGetTimerIndex(token)].pName;
+#else
+    return "scope";
+#endif
+}
+
+const char* GroupName(u64 token) {
+#if MICROPROFILE_ENABLED
+    const MicroProfile* profile = MicroProfileGet();
+    return profile->GroupInfo[profile->TimerInfo[MicroProfileGetTimerIndex(token)].nGroupIndex]
+        .pName;
+#else
+    return "yuzu";
+#endif
+}
+
+class Recorder {
+public:
+    static Recorder& Instance() {
+        static Recorder recorder;
+        return recorder;
+    }
+
+    /// Returns the ring of the calling thread, allocated the first time it records
+    ThreadBuffer& CurrentBuffer() {
+        if (!current_buffer) {
+            std::lock_guard lock{buffers_mutex};
+            current_buffer = buffers.emplace_back(
+                std::make_shared<ThreadBuffer>(static_cast<u32>(buffers.size() + 1)));
+            current_buffer->SetName(current_thread_name.empty()
+                                        ? fmt::format("Thread {}", current_buffer->id)
+                                        : current_thread_name);
+        }
+        return *current_buffer;
+    }
+
+    void SetCurrentThreadName(std::string name) {
+        current_thread_name = name;
+        if (current_buffer) {
+            current_buffer->SetName(std::move(name));
+        }
+    }
+
+    bool Start(const std::string& path) {
+        std::lock_guard control_lock{control_mutex};
+        if (writer.joinable()) {
+            return false;
+        }
+        file = FileUtil::IOFile(path, "w");
+        if (!file.IsOpen()) {
+            return false;
+        }
+        file.WriteString("{\"traceEvents\":[\n");
+        is_first_event = true;
+        start_time = Clock::now();
+        {
+            std::lock_guard lock{buffers_mutex};
+            for (const auto& buffer : buffers) {
+                // Nobody records while stopped, leftovers of earlier sessions are dropped
+                buffer->tail.store(buffer->head.load(std::memory_order_acquire),
+                                   std::memory_order_release);
+                buffer->dropped.store(0, std::memory_order_relaxed);
+                std::lock_guard name_lock{buffer->name_mutex};
+                buffer->is_name_written = false;
+            }
+        }
+        stop_writer = false;
+        Detail::is_recording.store(true, std::memory_order_relaxed);
+        writer = std::thread([this] { WriterLoop(); });
+        LOG_INFO(Common, "Recording a trace into {}", path);
+        return true;
+    }
+
+    void Stop() {
+        std::lock_guard control_lock{control_mutex};
+        if (!writer.joinable()) {
+            return;
+        }
+        Detail::is_recording.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard lock{writer_mutex};
+            stop_writer = true;
+        }
+        writer_cv.notify_one();
+        writer.join();
+
+        u64 dropped = 0;
+        Drain(&dropped);
+        file.WriteString("\n]}\n");
+        file.Close();
+        if (dropped != 0) {
+            LOG_WARNING(Common, "{} trace events were dropped, the rings were full", dropped);
+        }
+    }
+
+private:
+    void WriterLoop() {
+        std::unique_lock lock{writer_mutex};
+        while (!writer_cv.wait_for(lock, WRITE_INTERVAL, [this] { return stop_writer; })) {
+            lock.unlock();
+            Drain(nullptr);
+            lock.lock();
+        }
+    }
+
+    void Drain(u64* dropped) {
+        std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+        {
+            std::lock_guard lock{buffers_mutex};
+            snapshot = buffers;
+        }
+        for (const auto& buffer : snapshot) {
+            DrainBuffer(*buffer);
+            if (dropped) {
+                *dropped += buffer->dropped.load(std::memory_order_relaxed);
+            }
+        }
+        if (!chunk.empty()) {
+            file.WriteString(chunk);
+            chunk.clear();
+        }
+    }
+
+    void DrainBuffer(ThreadBuffer& buffer) {
+        {
+            std::lock_guard lock{buffer.name_mutex};
+            if (!buffer.is_name_written) {
+                Append(fmt::format(
+                    "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                    "\"args\":{{\"name\":\"{}\"}}}}",
+                    buffer.id, Escape(buffer.name)));
+                buffer.is_name_written = true;
+            }
+        }
+        const std::size_t head = buffer.head.load(std::memory_order_acquire);
+        std::size_t tail = buffer.tail.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            const Event& event = buffer.events[tail % RING_SIZE];
+            const double timestamp =
+                std::chrono::duration<double, std::micro>(event.time - start_time).count();
+            if (event.is_begin) {
+                Append(fmt::format(
+                    "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"B\",\"ts\":{:.3f},\"pid\":1,"
+                    "\"tid\":{}}}",
+                    Escape(TimerName(event.token)), Escape(GroupName(event.token)), timestamp,
+                    buffer.id));
+            } else {
+                Append(fmt::format("{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                   timestamp, buffer.id));
+            }
+        }
+        buffer.tail.store(tail, std::memory_order_release);
+    }
+
+    void Append(const std::string& event) {
+        if (!is_first_event) {
+            chunk += ",\n";
+        }
+        is_first_event = false;
+        chunk += event;
+    }
+
+    std::mutex buffers_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    static thread_local std::shared_ptr<ThreadBuffer> current_buffer;
+    static thread_local std::string current_thread_name;
+
+    std::mutex control_mutex;
+    std::thread writer;
+    std::mutex writer_mutex;
+    std::condition_variable writer_cv;
+    bool stop_writer = false;
+
+    // Only touched by the writer thread, or while it isn't running
+    FileUtil::IOFile file;
+    Clock::time_point start_time;
+    std::string chunk;
+    bool is_first_event = true;
+};
+
+thread_local std::shared_ptr<ThreadBuffer> Recorder::current_buffer;
+thread_local std::string Recorder::current_thread_name;
+
+bool Push(u64 token, bool is_begin) {
+    ThreadBuffer& buffer = Recorder::Instance().CurrentBuffer();
+    const std::size_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) == RING_SIZE) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    buffer.events[head % RING_SIZE] = {Clock::now(), token, is_begin};
+    buffer.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+} // Anonymous namespace
+
+bool StartRecording(const std::string& path) {
+    return Recorder::Instance().Start(path);
+}
+
+void StopRecording() {
+    Recorder::Instance().Stop();
+}
+
+void SetCurrentThreadName(std::string name) {
+    Recorder::Instance().SetCurrentThreadName(std::move(name));
+}
+
+bool Begin(u64 token) {
+    return Push(token, true);
+}
+
+void End(u64 token) {
+    Push(token, false);
+}
+
+} // namespace Common::Trace
@@ -0,0 +1,45 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * Records the MicroProfile scopes of every thread into a Chrome trace JSON file, which can be
+ * opened by chrome://tracing and the Perfetto UI. Unlike the MicroProfile UI it keeps everything
+ * for the whole session and doesn't need a frontend, so long sessions can be analyzed offline.
+ *
+ * Each thread writes its events into its own lock-free ring, and a writer thread streams them to
+ * the file. Events that don't fit into a full ring are dropped, together with the end of their
+ * scope.
+ */
+namespace Common::Trace {
+
+namespace Detail {
+extern std::atomic_bool is_recording;
+}
+
+/// Starts recording into the file at path. Returns false if it can't be created.
+bool StartRecording(const std::string& path);
+
+/// Stops recording and finishes the file.
+void StopRecording();
+
+inline bool IsRecording() {
+    return Detail::is_recording.load(std::memory_order_relaxed);
+}
+
+/// Names the calling thread in the traces.
+void SetCurrentThreadName(std::string name);
+
+/// Records the beginning of a scope. Returns false if the event had to be dropped.
+bool Begin(u64 token);
+
+/// Records the end of a scope whose beginning was recorded.
+void End(u64 token);
+
+} // namespace Common::Trace
@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "common/assert.h"
+#include "common/virtual_buffer.h"
+
+namespace Common {
+
+void* AllocateMemoryPages(std::size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+#ifdef _WIN32
+    void* const base = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+    }
+#endif
+    ASSERT_MSG(base != nullptr, "Failed to allocate 0x{:X} bytes of virtual memory", size);
+    return base;
+}
+
+void FreeMemoryPages(void* base, std::size_t size) {
+    if (base == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    const bool freed = VirtualFree(base, 0, MEM_RELEASE) != 0;
+#else
+    const bool freed = munmap(base, size) == 0;
+#endif
+    ASSERT(freed);
+}
+
+void DecommitMemoryPages(void* base, std::size_t size) {
+#ifdef _WIN32
+    // Decommitted pages can't be accessed on Windows, commit them again so they read as zeroes
+    // without taking physical memory until they are written
+    VirtualFree(base, size, MEM_DECOMMIT);
+    const bool committed = VirtualAlloc(base, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    const bool committed = madvise(base, size, MADV_DONTNEED) == 0;
+#endif
+    ASSERT(committed);
+}
+
+} // namespace Common
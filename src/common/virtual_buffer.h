@@ -0,0 +1,146 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/// Allocates zeroed memory straight from the OS, host pages are only committed when written.
+void* AllocateMemoryPages(std::size_t size);
+
+/// Frees memory allocated with AllocateMemoryPages.
+void FreeMemoryPages(void* base, std::size_t size);
+
+/**
+ * Returns the host pages of a region allocated with AllocateMemoryPages to the OS. The region
+ * stays accessible and reads back as zeroes. Both ends must be aligned to VirtualPageAlignment.
+ */
+void DecommitMemoryPages(void* base, std::size_t size);
+
+/// Alignment used to decommit regions, a multiple of the page size of every supported host.
+constexpr std::size_t VirtualPageAlignment = 0x10000;
+
+/**
+ * Fixed size array of trivial entries allocated from the OS. Untouched parts of the buffer don't
+ * take host memory, making it suitable for large and sparsely used tables that still have to be
+ * accessed with a single indirection. Every entry starts as zero.
+ */
+template <typename T>
+class VirtualBuffer final {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "T must be trivial, entries are zeroed by the OS");
+
+public:
+    constexpr VirtualBuffer() = default;
+
+    explicit VirtualBuffer(std::size_t count) : alloc_size{count * sizeof(T)} {
+        base_ptr = static_cast<T*>(AllocateMemoryPages(alloc_size));
+    }
+
+    ~VirtualBuffer() {
+        FreeMemoryPages(base_ptr, alloc_size);
+    }
+
+    VirtualBuffer(const VirtualBuffer&) = delete;
+    VirtualBuffer& operator=(const VirtualBuffer&) = delete;
+
+    VirtualBuffer(VirtualBuffer&& other) noexcept
+        : alloc_size{std::exchange(other.alloc_size, 0)}, base_ptr{std::exchange(other.base_ptr,
+                                                                                 nullptr)} {}
+
+    VirtualBuffer& operator=(VirtualBuffer&& other) noexcept {
+        FreeMemoryPages(base_ptr, alloc_size);
+        alloc_size = std::exchange(other.alloc_size, 0);
+        base_ptr = std::exchange(other.base_ptr, nullptr);
+        return *this;
+    }
+
+    /// Reallocates the buffer to hold count entries. Previous contents are discarded.
+    void Resize(std::size_t count) {
+        FreeMemoryPages(base_ptr, alloc_size);
+        alloc_size = count * sizeof(T);
+        base_ptr = static_cast<T*>(AllocateMemoryPages(alloc_size));
+    }
+
+    /// Zeroes a range of entries, releasing the host pages fully contained in it.
+    void Zero(std::size_t first, std::size_t count) {
+        u8* const begin = reinterpret_cast<u8*>(base_ptr + first);
+        u8* const end = reinterpret_cast<u8*>(base_ptr + first + count);
+        u8* const aligned_begin = AlignPointerUp(begin);
+        u8* const aligned_end = AlignPointerDown(end);
+        if (aligned_begin >= aligned_end) {
+            std::memset(begin, 0, end - begin);
+            return;
+        }
+        std::memset(begin, 0, aligned_begin - begin);
+        DecommitMemoryPages(aligned_begin, aligned_end - aligned_begin);
+        std::memset(aligned_end, 0, end - aligned_end);
+    }
+
+    /// Zeroes every entry, releasing the host memory of the whole buffer.
+    void Clear() {
+        Zero(0, size());
+    }
+
+    T& operator[](std::size_t index) {
+        return base_ptr[index];
+    }
+
+    const T& operator[](std::size_t index) const {
+        return base_ptr[index];
+    }
+
+    T* data() {
+        return base_ptr;
+    }
+
+    const T* data() const {
+        return base_ptr;
+    }
+
+    T* begin() {
+        return base_ptr;
+    }
+
+    const T* begin() const {
+        return base_ptr;
+    }
+
+    T* end() {
+        return base_ptr + size();
+    }
+
+    const T* end() const {
+        return base_ptr + size();
+    }
+
+    std::size_t size() const {
+        return alloc_size / sizeof(T);
+    }
+
+private:
+    static u8* AlignPointerUp(u8* pointer) {
+        const auto value = reinterpret_cast<std::uintptr_t>(pointer);
+        return reinterpret_cast<u8*>((value + VirtualPageAlignment - 1) &
+                                     ~(VirtualPageAlignment - 1));
+    }
+
+    static u8* AlignPointerDown(u8* pointer) {
+        const auto value = reinterpret_cast<std::uintptr_t>(pointer);
+        return reinterpret_cast<u8*>(value & ~(VirtualPageAlignment - 1));
+    }
+
+    std::size_t alloc_size{};
+    T* base_ptr{};
+};
+
+} // namespace Common
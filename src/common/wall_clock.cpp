@@ -0,0 +1,50 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/wall_clock.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include "common/x64/cpu_detect.h"
+#include "common/x64/native_clock.h"
+#endif
+
+namespace Common {
+
+namespace {
+
+class StandardWallClock final : public WallClock {
+public:
+    explicit StandardWallClock(u64 emulated_cpu_frequency)
+        : WallClock{emulated_cpu_frequency, false}, start_time{Clock::now()} {}
+
+    std::chrono::nanoseconds GetTimeNS() override {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_time);
+    }
+
+    u64 GetCPUCycles() override {
+        const u64 ns = static_cast<u64>(GetTimeNS().count());
+        // Split the conversion to avoid overflowing after a few seconds of uptime.
+        constexpr u64 ns_per_second = 1000000000;
+        return (ns / ns_per_second) * emulated_cpu_frequency +
+               (ns % ns_per_second) * emulated_cpu_frequency / ns_per_second;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start_time;
+};
+
+} // Anonymous namespace
+
+std::unique_ptr<WallClock> CreateBestMatchingClock(u64 emulated_cpu_frequency) {
+#ifdef ARCHITECTURE_x86_64
+    if (GetCPUCaps().invariant_tsc) {
+        return std::make_unique<X64::NativeClock>(emulated_cpu_frequency);
+    }
+#endif
+    return std::make_unique<StandardWallClock>(emulated_cpu_frequency);
+}
+
+} // namespace Common
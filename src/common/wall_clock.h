@@ -0,0 +1,43 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/// Monotonic host clock that counts emulated CPU cycles since its creation.
+class WallClock {
+public:
+    virtual ~WallClock() = default;
+
+    /// Returns the time elapsed since the clock was created.
+    virtual std::chrono::nanoseconds GetTimeNS() = 0;
+
+    /// Returns the amount of emulated CPU cycles elapsed since the clock was created.
+    virtual u64 GetCPUCycles() = 0;
+
+    /// Returns whether the clock is backed by a native hardware counter.
+    bool IsNative() const {
+        return is_native;
+    }
+
+protected:
+    WallClock(u64 emulated_cpu_frequency, bool is_native)
+        : emulated_cpu_frequency{emulated_cpu_frequency}, is_native{is_native} {}
+
+    u64 emulated_cpu_frequency;
+
+private:
+    bool is_native;
+};
+
+/// Creates the most precise clock available on the host, falling back to std::chrono.
+std::unique_ptr<WallClock> CreateBestMatchingClock(u64 emulated_cpu_frequency);
+
+} // namespace Common
@@ -110,6 +110,8 @@ static CPUCaps Detect() {
                 caps.bmi1 = true;
             if ((cpu_id[1] >> 8) & 1)
                 caps.bmi2 = true;
+            if ((cpu_id[1] >> 29) & 1)
+                caps.sha = true;
         }
     }
 
@@ -130,6 +132,13 @@ static CPUCaps Detect() {
             caps.fma4 = true;
     }
 
+    if (max_ex_fn >= 0x80000007) {
+        // Check whether the TSC runs at a constant rate regardless of power states
+        __cpuid(cpu_id, 0x80000007);
+        if ((cpu_id[3] >> 8) & 1)
+            caps.invariant_tsc = true;
+    }
+
     return caps;
 }
 
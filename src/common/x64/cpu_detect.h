@@ -24,6 +24,8 @@ struct CPUCaps {
     bool fma;
     bool fma4;
     bool aes;
+    bool sha;
+    bool invariant_tsc;
 };
 
 /**
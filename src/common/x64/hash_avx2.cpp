@@ -0,0 +1,60 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <immintrin.h>
+#include "common/x64/hash_avx2.h"
+
+namespace Common::X64 {
+
+namespace {
+
+constexpr u32 PRIME32_1 = 0x9E3779B1;
+constexpr std::size_t STRIPE_SIZE = 64;
+constexpr std::size_t STRIPES_PER_BLOCK = 16;
+
+} // Anonymous namespace
+
+void AccumulateBlocksAVX2(std::array<u64, 8>& lanes, const u8* data, std::size_t num_blocks,
+                          const u64* keys) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.data()));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.data() + 4));
+
+    const auto accumulate = [](__m256i acc, __m256i input, __m256i key) {
+        const __m256i mixed = _mm256_xor_si256(input, key);
+        const __m256i product =
+            _mm256_mul_epu32(mixed, _mm256_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1)));
+        const __m256i swapped = _mm256_shuffle_epi32(input, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+    };
+    const __m256i prime = _mm256_set1_epi32(static_cast<int>(PRIME32_1));
+    const auto scramble = [prime](__m256i acc, __m256i key) {
+        __m256i value = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+        value = _mm256_xor_si256(value, key);
+        const __m256i product_low = _mm256_mul_epu32(value, prime);
+        const __m256i product_high = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+        return _mm256_add_epi64(product_low, _mm256_slli_epi64(product_high, 32));
+    };
+
+    const __m256i scramble_low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + STRIPES_PER_BLOCK));
+    const __m256i scramble_high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + STRIPES_PER_BLOCK + 4));
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        const u8* const block_data = data + block * STRIPE_SIZE * STRIPES_PER_BLOCK;
+        for (std::size_t stripe = 0; stripe < STRIPES_PER_BLOCK; ++stripe) {
+            const auto* const input =
+                reinterpret_cast<const __m256i*>(block_data + stripe * STRIPE_SIZE);
+            const auto* const key = reinterpret_cast<const __m256i*>(keys + stripe);
+            low = accumulate(low, _mm256_loadu_si256(input), _mm256_loadu_si256(key));
+            high = accumulate(high, _mm256_loadu_si256(input + 1), _mm256_loadu_si256(key + 1));
+        }
+        low = scramble(low, scramble_low);
+        high = scramble(high, scramble_high);
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.data()), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.data() + 4), high);
+}
+
+} // namespace Common::X64
@@ -0,0 +1,24 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace Common::X64 {
+
+/**
+ * Accumulates the whole 1 KiB blocks of a long HashValue input with AVX2, giving the same result
+ * as the generic loop in hash.cpp. Only call it after checking the host supports AVX2.
+ * @param lanes      The eight 64-bit accumulators of the hash.
+ * @param num_blocks Number of blocks to accumulate from data.
+ * @param keys       The 32 keys of the hash. The stripes of a block use them shifted by one, the
+ *                   scramble at the end of each block uses the last 16.
+ */
+void AccumulateBlocksAVX2(std::array<u64, 8>& lanes, const u8* data, std::size_t num_blocks,
+                          const u64* keys);
+
+} // namespace Common::X64
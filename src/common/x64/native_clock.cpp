@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <thread>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "common/x64/native_clock.h"
+
+namespace Common::X64 {
+
+namespace {
+
+u64 EstimateRDTSCFrequency() {
+    // Measure the TSC against the steady clock for a short period. This is only done once per
+    // emulation session, so the few milliseconds spent here are negligible.
+    const auto measure_start = std::chrono::steady_clock::now();
+    const u64 tsc_start = __rdtsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    const auto measure_end = std::chrono::steady_clock::now();
+    const u64 tsc_end = __rdtsc();
+
+    const u64 elapsed_ns = static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(measure_end - measure_start).count());
+    const u64 tsc_diff = tsc_end - tsc_start;
+    return tsc_diff * 1000000000 / elapsed_ns;
+}
+
+} // Anonymous namespace
+
+NativeClock::NativeClock(u64 emulated_cpu_frequency)
+    : WallClock{emulated_cpu_frequency, true}, rdtsc_frequency{EstimateRDTSCFrequency()} {
+    start_rdtsc = __rdtsc();
+}
+
+u64 NativeClock::ScaleElapsed(u64 frequency) const {
+    const u64 elapsed = __rdtsc() - start_rdtsc;
+    // Split the conversion to avoid overflowing, both frequencies are well below 2^32.
+    return (elapsed / rdtsc_frequency) * frequency +
+           (elapsed % rdtsc_frequency) * frequency / rdtsc_frequency;
+}
+
+std::chrono::nanoseconds NativeClock::GetTimeNS() {
+    return std::chrono::nanoseconds{ScaleElapsed(1000000000)};
+}
+
+u64 NativeClock::GetCPUCycles() {
+    return ScaleElapsed(emulated_cpu_frequency);
+}
+
+} // namespace Common::X64
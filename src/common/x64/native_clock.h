@@ -0,0 +1,33 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+#include "common/wall_clock.h"
+
+namespace Common::X64 {
+
+/// Wall clock backed by the invariant TSC, calibrated against std::chrono on creation.
+class NativeClock final : public WallClock {
+public:
+    explicit NativeClock(u64 emulated_cpu_frequency);
+
+    std::chrono::nanoseconds GetTimeNS() override;
+
+    u64 GetCPUCycles() override;
+
+    u64 GetRDTSCFrequency() const {
+        return rdtsc_frequency;
+    }
+
+private:
+    /// Returns the TSC ticks elapsed since the clock was created scaled to the given frequency.
+    u64 ScaleElapsed(u64 frequency) const;
+
+    u64 start_rdtsc;
+    u64 rdtsc_frequency;
+};
+
+} // namespace Common::X64
@@ -3,6 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <memory>
+#include <utility>
+#include <zdict.h>
 #include <zstd.h>
 
 #include "common/assert.h"
@@ -10,6 +13,170 @@
 
 namespace Common::Compression {
 
+namespace {
+
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* context) const {
+        ZSTD_freeCCtx(context);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* context) const {
+        ZSTD_freeDCtx(context);
+    }
+};
+
+struct CDictDeleter {
+    void operator()(ZSTD_CDict* dictionary) const {
+        ZSTD_freeCDict(dictionary);
+    }
+};
+
+struct DDictDeleter {
+    void operator()(ZSTD_DDict* dictionary) const {
+        ZSTD_freeDDict(dictionary);
+    }
+};
+
+using UniqueCCtx = std::unique_ptr<ZSTD_CCtx, CCtxDeleter>;
+using UniqueDCtx = std::unique_ptr<ZSTD_DCtx, DCtxDeleter>;
+
+/// Contexts are expensive to create and keep large tables, so each thread reuses its own
+ZSTD_CCtx* ThreadCompressionContext() {
+    thread_local UniqueCCtx context{ZSTD_createCCtx()};
+    return context.get();
+}
+
+ZSTD_DCtx* ThreadDecompressionContext() {
+    thread_local UniqueDCtx context{ZSTD_createDCtx()};
+    return context.get();
+}
+
+} // Anonymous namespace
+
+struct ZSTDDictionary::Impl {
+    std::unique_ptr<ZSTD_CDict, CDictDeleter> compression;
+    std::unique_ptr<ZSTD_DDict, DDictDeleter> decompression;
+};
+
+ZSTDDictionary::ZSTDDictionary(std::vector<u8> data_)
+    : ZSTDDictionary(std::move(data_), ZSTD_CLEVEL_DEFAULT) {}
+
+ZSTDDictionary::ZSTDDictionary(std::vector<u8> data_, s32 compression_level)
+    : data{std::move(data_)}, impl{std::make_unique<Impl>()} {
+    compression_level = std::clamp(compression_level, 1, ZSTD_maxCLevel());
+    impl->compression.reset(ZSTD_createCDict(data.data(), data.size(), compression_level));
+    impl->decompression.reset(ZSTD_createDDict(data.data(), data.size()));
+}
+
+ZSTDDictionary::~ZSTDDictionary() = default;
+
+bool ZSTDDictionary::IsValid() const {
+    return impl->compression && impl->decompression;
+}
+
+struct ZSTDCompressionStream::Impl {
+    UniqueCCtx context{ZSTD_createCCtx()};
+    std::vector<u8> compressed;
+    bool is_broken = false;
+
+    bool Compress(const u8* source, std::size_t source_size, ZSTD_EndDirective directive) {
+        ZSTD_inBuffer input{source, source_size, 0};
+        while (true) {
+            // Grow the output in steps of the size the library flushes at once
+            const std::size_t offset = compressed.size();
+            compressed.resize(offset + ZSTD_CStreamOutSize());
+            ZSTD_outBuffer output{compressed.data(), compressed.size(), offset};
+            const std::size_t remaining =
+                ZSTD_compressStream2(context.get(), &output, &input, directive);
+            compressed.resize(output.pos);
+            if (ZSTD_isError(remaining)) {
+                is_broken = true;
+                return false;
+            }
+            const bool is_done = directive == ZSTD_e_end ? remaining == 0 : input.pos == input.size;
+            if (is_done) {
+                return true;
+            }
+        }
+    }
+};
+
+ZSTDCompressionStream::ZSTDCompressionStream(s32 compression_level)
+    : impl{std::make_unique<Impl>()} {
+    compression_level = std::clamp(compression_level, 1, ZSTD_maxCLevel());
+    ZSTD_CCtx_setParameter(impl->context.get(), ZSTD_c_compressionLevel, compression_level);
+}
+
+ZSTDCompressionStream::~ZSTDCompressionStream() = default;
+
+bool ZSTDCompressionStream::Write(const u8* source, std::size_t source_size) {
+    return !impl->is_broken && impl->Compress(source, source_size, ZSTD_e_continue);
+}
+
+std::optional<std::vector<u8>> ZSTDCompressionStream::Finish() {
+    const bool is_ok = !impl->is_broken && impl->Compress(nullptr, 0, ZSTD_e_end);
+    std::vector<u8> compressed = std::move(impl->compressed);
+    impl->compressed = {};
+    impl->is_broken = false;
+    ZSTD_CCtx_reset(impl->context.get(), ZSTD_reset_session_only);
+    if (!is_ok) {
+        return {};
+    }
+    return compressed;
+}
+
+struct ZSTDDecompressionStream::Impl {
+    UniqueDCtx context{ZSTD_createDCtx()};
+    std::vector<u8> decompressed;
+    bool is_finished = false;
+    bool is_broken = false;
+};
+
+ZSTDDecompressionStream::ZSTDDecompressionStream() : impl{std::make_unique<Impl>()} {}
+
+ZSTDDecompressionStream::~ZSTDDecompressionStream() = default;
+
+bool ZSTDDecompressionStream::Write(const u8* source, std::size_t source_size) {
+    if (impl->is_broken) {
+        return false;
+    }
+    ZSTD_inBuffer input{source, source_size, 0};
+    while (true) {
+        const std::size_t offset = impl->decompressed.size();
+        const std::size_t input_offset = input.pos;
+        impl->decompressed.resize(offset + ZSTD_DStreamOutSize());
+        ZSTD_outBuffer output{impl->decompressed.data(), impl->decompressed.size(), offset};
+        const std::size_t result = ZSTD_decompressStream(impl->context.get(), &output, &input);
+        impl->decompressed.resize(output.pos);
+        if (ZSTD_isError(result)) {
+            impl->is_broken = true;
+            return false;
+        }
+        // Once a frame is done, calls without input only wait for the next one
+        if (result == 0) {
+            impl->is_finished = true;
+        } else if (input.pos != input_offset) {
+            impl->is_finished = false;
+        }
+        // A full output buffer may still hold data back, keep going until it has room left
+        if (input.pos == input.size && output.pos < output.size) {
+            return true;
+        }
+    }
+}
+
+bool ZSTDDecompressionStream::IsFinished() const {
+    return impl->is_finished;
+}
+
+std::vector<u8> ZSTDDecompressionStream::TakeOutput() {
+    std::vector<u8> decompressed = std::move(impl->decompressed);
+    impl->decompressed = {};
+    return decompressed;
+}
+
 std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size, s32 compression_level) {
     compression_level = std::clamp(compression_level, 1, ZSTD_maxCLevel());
 
@@ -17,7 +184,8 @@ std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size, s32
     std::vector<u8> compressed(max_compressed_size);
 
     const std::size_t compressed_size =
-        ZSTD_compress(compressed.data(), compressed.size(), source, source_size, compression_level);
+        ZSTD_compressCCtx(ThreadCompressionContext(), compressed.data(), compressed.size(), source,
+                          source_size, compression_level);
 
     if (ZSTD_isError(compressed_size)) {
         // Compression failed
@@ -33,19 +201,77 @@ std::vector<u8> CompressDataZSTDDefault(const u8* source, std::size_t source_siz
     return CompressDataZSTD(source, source_size, ZSTD_CLEVEL_DEFAULT);
 }
 
-std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
-    const std::size_t decompressed_size =
-        ZSTD_getDecompressedSize(compressed.data(), compressed.size());
-    std::vector<u8> decompressed(decompressed_size);
+std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size,
+                                 const ZSTDDictionary& dictionary) {
+    ASSERT(dictionary.IsValid());
+
+    const std::size_t max_compressed_size = ZSTD_compressBound(source_size);
+    std::vector<u8> compressed(max_compressed_size);
 
-    const std::size_t uncompressed_result_size = ZSTD_decompress(
-        decompressed.data(), decompressed.size(), compressed.data(), compressed.size());
+    const std::size_t compressed_size = ZSTD_compress_usingCDict(
+        ThreadCompressionContext(), compressed.data(), compressed.size(), source, source_size,
+        dictionary.impl->compression.get());
 
-    if (decompressed_size != uncompressed_result_size || ZSTD_isError(uncompressed_result_size)) {
+    if (ZSTD_isError(compressed_size)) {
+        // Compression failed
+        return {};
+    }
+
+    compressed.resize(compressed_size);
+
+    return compressed;
+}
+
+std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
+    const unsigned long long decompressed_size =
+        ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+    if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
+        return {};
+    }
+    std::vector<u8> decompressed(static_cast<std::size_t>(decompressed_size));
+    if (!DecompressDataZSTD(compressed.data(), compressed.size(), decompressed.data(),
+                            decompressed.size())) {
         // Decompression failed
         return {};
     }
     return decompressed;
 }
 
+bool DecompressDataZSTD(const u8* source, std::size_t source_size, u8* destination,
+                        std::size_t uncompressed_size, const ZSTDDictionary* dictionary) {
+    std::size_t result;
+    if (dictionary) {
+        ASSERT(dictionary->IsValid());
+        result = ZSTD_decompress_usingDDict(ThreadDecompressionContext(), destination,
+                                            uncompressed_size, source, source_size,
+                                            dictionary->impl->decompression.get());
+    } else {
+        result = ZSTD_decompressDCtx(ThreadDecompressionContext(), destination, uncompressed_size,
+                                     source, source_size);
+    }
+    return !ZSTD_isError(result) && result == uncompressed_size;
+}
+
+std::vector<u8> TrainDictionaryZSTD(const std::vector<std::vector<u8>>& samples,
+                                    std::size_t max_size) {
+    std::vector<u8> buffer;
+    std::vector<std::size_t> sample_sizes;
+    sample_sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer.insert(buffer.end(), sample.begin(), sample.end());
+        sample_sizes.push_back(sample.size());
+    }
+
+    std::vector<u8> dictionary(max_size);
+    const std::size_t dictionary_size =
+        ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(),
+                              sample_sizes.data(), static_cast<unsigned>(sample_sizes.size()));
+    if (ZDICT_isError(dictionary_size)) {
+        return {};
+    }
+    dictionary.resize(dictionary_size);
+    return dictionary;
+}
+
 } // namespace Common::Compression
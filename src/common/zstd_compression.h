@@ -4,12 +4,125 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include "common/common_types.h"
 
 namespace Common::Compression {
 
+/**
+ * Zstandard dictionary shared by the compression and decompression of many small, similar
+ * buffers. Each buffer is still compressed into its own independent frame, but they don't need to
+ * repeat what they have in common with the dictionary. The dictionary is digested once, so it can
+ * be used for any number of buffers from any thread.
+ */
+class ZSTDDictionary {
+public:
+    /**
+     * Creates a dictionary from its contents, as returned by TrainDictionaryZSTD. Buffers are
+     * compressed with it at the default compression level.
+     *
+     * @param data the contents of the dictionary.
+     */
+    explicit ZSTDDictionary(std::vector<u8> data);
+
+    /**
+     * Creates a dictionary from its contents, as returned by TrainDictionaryZSTD.
+     *
+     * @param data the contents of the dictionary.
+     * @param compression_level the compression level of the buffers compressed with it.
+     */
+    explicit ZSTDDictionary(std::vector<u8> data, s32 compression_level);
+    ~ZSTDDictionary();
+
+    ZSTDDictionary(const ZSTDDictionary&) = delete;
+    ZSTDDictionary& operator=(const ZSTDDictionary&) = delete;
+
+    /// Returns the contents of the dictionary, to be stored together with the compressed buffers.
+    const std::vector<u8>& GetData() const {
+        return data;
+    }
+
+    /// Returns true if the dictionary could be digested and can be used.
+    bool IsValid() const;
+
+private:
+    friend std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size,
+                                            const ZSTDDictionary& dictionary);
+    friend bool DecompressDataZSTD(const u8* source, std::size_t source_size, u8* destination,
+                                   std::size_t uncompressed_size,
+                                   const ZSTDDictionary* dictionary);
+
+    struct Impl;
+
+    std::vector<u8> data;
+    std::unique_ptr<Impl> impl;
+};
+
+/**
+ * Compresses a stream of data with Zstandard into a single frame, for data that isn't available
+ * all at once.
+ */
+class ZSTDCompressionStream {
+public:
+    /// @param compression_level the used compression level. Should be between 1 and 22.
+    explicit ZSTDCompressionStream(s32 compression_level);
+    ~ZSTDCompressionStream();
+
+    ZSTDCompressionStream(const ZSTDCompressionStream&) = delete;
+    ZSTDCompressionStream& operator=(const ZSTDCompressionStream&) = delete;
+
+    /**
+     * Compresses the next part of the stream.
+     *
+     * @return false on failure, the stream can't be used anymore.
+     */
+    bool Write(const u8* source, std::size_t source_size);
+
+    /**
+     * Ends the frame and returns the compressed stream. The stream can be used again afterwards.
+     *
+     * @return the compressed data, or empty on failure.
+     */
+    std::optional<std::vector<u8>> Finish();
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> impl;
+};
+
+/// Decompresses a Zstandard frame as its compressed data becomes available.
+class ZSTDDecompressionStream {
+public:
+    ZSTDDecompressionStream();
+    ~ZSTDDecompressionStream();
+
+    ZSTDDecompressionStream(const ZSTDDecompressionStream&) = delete;
+    ZSTDDecompressionStream& operator=(const ZSTDDecompressionStream&) = delete;
+
+    /**
+     * Decompresses the next part of the compressed data, appending its output to the decompressed
+     * data.
+     *
+     * @return false on corrupted data, the stream can't be used anymore.
+     */
+    bool Write(const u8* source, std::size_t source_size);
+
+    /// Returns true when a whole frame has been decompressed.
+    bool IsFinished() const;
+
+    /// Returns the data decompressed so far and clears it.
+    std::vector<u8> TakeOutput();
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> impl;
+};
+
 /**
  * Compresses a source memory region with Zstandard and returns the compressed data in a vector.
  *
@@ -32,6 +145,19 @@ std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size, s32
  */
 std::vector<u8> CompressDataZSTDDefault(const u8* source, std::size_t source_size);
 
+/**
+ * Compresses a source memory region with Zstandard using a dictionary and returns the compressed
+ * data in a vector. The compression level is the one of the dictionary.
+ *
+ * @param source the uncompressed source memory region.
+ * @param source_size the size in bytes of the uncompressed source memory region.
+ * @param dictionary the dictionary to compress with, it's needed again to decompress the data.
+ *
+ * @return the compressed data.
+ */
+std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size,
+                                 const ZSTDDictionary& dictionary);
+
 /**
  * Decompresses a source memory region with Zstandard and returns the uncompressed data in a vector.
  *
@@ -41,4 +167,32 @@ std::vector<u8> CompressDataZSTDDefault(const u8* source, std::size_t source_siz
  */
 std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed);
 
+/**
+ * Decompresses a source memory region with Zstandard into an existing buffer.
+ *
+ * @param source the compressed source memory region.
+ * @param source_size the size in bytes of the compressed source memory region.
+ * @param destination the buffer the data is decompressed to.
+ * @param uncompressed_size the size in bytes of the uncompressed data.
+ * @param dictionary the dictionary the data was compressed with, if any. Data compressed without
+ *                   a dictionary can be decompressed with one.
+ *
+ * @return true when exactly uncompressed_size bytes were decompressed.
+ */
+bool DecompressDataZSTD(const u8* source, std::size_t source_size, u8* destination,
+                        std::size_t uncompressed_size,
+                        const ZSTDDictionary* dictionary = nullptr);
+
+/**
+ * Trains a Zstandard dictionary from samples of the data it will compress. Dictionaries help the
+ * most with many small buffers that share a lot of content.
+ *
+ * @param samples the uncompressed samples, usually a hundred or more.
+ * @param max_size the maximum size in bytes of the dictionary.
+ *
+ * @return the contents of the dictionary, or empty when it couldn't be trained.
+ */
+std::vector<u8> TrainDictionaryZSTD(const std::vector<std::vector<u8>>& samples,
+                                    std::size_t max_size);
+
 } // namespace Common::Compression
\ No newline at end of file
@@ -49,6 +49,9 @@ public:
     /// Clear all instruction cache
     virtual void ClearInstructionCache() = 0;
 
+    /// Clears the instruction cache for the given range of guest memory only
+    virtual void InvalidateCacheRange(VAddr addr, std::size_t size) = 0;
+
     /// Notifies CPU emulation that the current page table has changed.
     ///
     /// @param new_page_table                 The new page table.
@@ -148,6 +151,15 @@ public:
     /// Prepare core for thread reschedule (if needed to correctly handle state)
     virtual void PrepareReschedule() = 0;
 
+    /**
+     * Returns a value that changes whenever the state of the core is set from outside of the
+     * guest code, so the scheduler can tell whether the core still holds the context it saved
+     * last, and skip loading it back.
+     */
+    u64 GetStateGeneration() const {
+        return state_generation;
+    }
+
     struct BacktraceEntry {
         std::string module;
         u64 address;
@@ -167,8 +179,16 @@ public:
     void LogBacktrace() const;
 
 protected:
+    /// To be called by the implementations whenever their state is set from outside the guest.
+    void InvalidateState() {
+        ++state_generation;
+    }
+
     /// System context that this ARM interface is running under.
     System& system;
+
+private:
+    u64 state_generation = 0;
 };
 
 } // namespace Core
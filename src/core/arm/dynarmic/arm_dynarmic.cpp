@@ -9,6 +9,7 @@
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
+#include "core/arm/dynarmic/arm_dynarmic_fallback.h"
 #include "core/core.h"
 #include "core/core_manager.h"
 #include "core/core_timing.h"
@@ -19,14 +20,20 @@
 #include "core/hle/kernel/svc.h"
 #include "core/hle/kernel/vm_manager.h"
 #include "core/memory.h"
+#include "core/settings.h"
 
 namespace Core {
 
 using Vector = Dynarmic::A64::Vector;
 
+/// Number of system tick reads within a single slice, without an SVC in between, after which the
+/// guest is considered to be busy-waiting on the timer.
+constexpr std::size_t IDLE_POLL_THRESHOLD = 100;
+
 class ARM_Dynarmic_Callbacks : public Dynarmic::A64::UserCallbacks {
 public:
-    explicit ARM_Dynarmic_Callbacks(ARM_Dynarmic& parent) : parent(parent) {}
+    explicit ARM_Dynarmic_Callbacks(ARM_Dynarmic& parent)
+        : parent(parent), idle_skip{Settings::values.use_idle_skip} {}
 
     u8 MemoryRead8(u64 vaddr) override {
         return parent.system.Memory().Read8(vaddr);
@@ -64,16 +71,33 @@ public:
     }
 
     void InterpreterFallback(u64 pc, std::size_t num_instructions) override {
-        LOG_INFO(Core_ARM, "Unicorn fallback @ 0x{:X} for {} instructions (instr = {:08X})", pc,
-                 num_instructions, MemoryReadCode(pc));
+        num_interpreted_instructions += num_instructions;
+
+        // Run what can be executed directly on the JIT state, only handing the remainder over to
+        // Unicorn, which requires copying the whole context in and out.
+        std::size_t num_native = 0;
+        while (num_native < num_instructions) {
+            const u64 instruction_pc = pc + num_native * 4;
+            const u32 instruction = MemoryReadCode(instruction_pc);
+            const bool is_native = InterpretFallbackInstruction(*parent.jit, instruction);
+            fallback_statistics.Record(instruction_pc, instruction, is_native);
+            if (!is_native) {
+                break;
+            }
+            ++num_native;
+        }
+
+        parent.jit->SetPC(pc + num_native * 4);
+        if (num_native == num_instructions) {
+            return;
+        }
 
         ARM_Interface::ThreadContext ctx;
         parent.SaveContext(ctx);
         parent.inner_unicorn.LoadContext(ctx);
-        parent.inner_unicorn.ExecuteInstructions(num_instructions);
+        parent.inner_unicorn.ExecuteInstructions(num_instructions - num_native);
         parent.inner_unicorn.SaveContext(ctx);
         parent.LoadContext(ctx);
-        num_interpreted_instructions += num_instructions;
     }
 
     void ExceptionRaised(u64 pc, Dynarmic::A64::Exception exception) override {
@@ -102,31 +126,83 @@ public:
     }
 
     void CallSVC(u32 swi) override {
-        Kernel::CallSVC(parent.system, swi);
+        num_idle_polls = 0;
+
+        // Capture the argument registers straight from the JIT instead of going through the
+        // virtual ARM_Interface accessors, and only write back what the SVC returned.
+        Kernel::SvcRegisters registers;
+        for (std::size_t i = 0; i < Kernel::SvcRegisters::NumRegisters; i++) {
+            registers.values[i] = parent.jit->GetRegister(i);
+        }
+
+        Kernel::CallSVC(parent.system, swi, registers);
+
+        for (std::size_t i = 0; i < Kernel::SvcRegisters::NumRegisters; i++) {
+            if ((registers.written_mask & (1U << i)) != 0) {
+                parent.jit->SetRegister(i, registers.values[i]);
+            }
+        }
     }
 
     void AddTicks(u64 ticks) override {
+        auto& core_timing = parent.system.CoreTiming();
+
         // Divide the number of ticks by the amount of CPU cores. TODO(Subv): This yields only a
         // rough approximation of the amount of executed ticks in the system, it may be thrown off
         // if not all cores are doing a similar amount of work. Instead of doing this, we should
         // device a way so that timing is consistent across all cores without increasing the ticks 4
         // times.
-        u64 amortized_ticks = (ticks - num_interpreted_instructions) / Core::NUM_CPU_CORES;
+        // In multicore mode the cores run in parallel and only core 0 drives the global timer, so
+        // there's nothing to amortize.
+        u64 amortized_ticks = ticks - num_interpreted_instructions;
+        if (!core_timing.IsMultiCore()) {
+            amortized_ticks /= Core::NUM_CPU_CORES;
+        }
         // Always execute at least one tick.
         amortized_ticks = std::max<u64>(amortized_ticks, 1);
 
-        parent.system.CoreTiming().AddTicks(amortized_ticks);
+        core_timing.AddTicks(amortized_ticks);
         num_interpreted_instructions = 0;
     }
     u64 GetTicksRemaining() override {
         return std::max(parent.system.CoreTiming().GetDowncount(), s64{0});
     }
     u64 GetCNTPCT() override {
-        return Timing::CpuCyclesToClockCycles(parent.system.CoreTiming().GetTicks());
+        auto& core_timing = parent.system.CoreTiming();
+        const u64 ticks = core_timing.GetTicks();
+        if (idle_skip) {
+            DetectIdlePolling(core_timing, ticks);
+        }
+        return Timing::CpuCyclesToClockCycles(ticks);
+    }
+
+    /**
+     * Guest time only moves forward between JIT runs, so a core that keeps reading the same tick
+     * value without making any SVC is spinning until some deadline. Treat it like an idle core:
+     * skip ahead to the next timed event and leave the JIT so that the event gets serviced.
+     */
+    void DetectIdlePolling(Timing::CoreTiming& core_timing, u64 ticks) {
+        if (ticks != last_polled_ticks) {
+            last_polled_ticks = ticks;
+            num_idle_polls = 0;
+            return;
+        }
+
+        if (++num_idle_polls < IDLE_POLL_THRESHOLD) {
+            return;
+        }
+
+        num_idle_polls = 0;
+        core_timing.Idle();
+        parent.jit->HaltExecution();
     }
 
     ARM_Dynarmic& parent;
+    const bool idle_skip;
+    u64 last_polled_ticks = 0;
+    std::size_t num_idle_polls = 0;
     std::size_t num_interpreted_instructions = 0;
+    FallbackStatistics fallback_statistics;
     u64 tpidrro_el0 = 0;
     u64 tpidr_el0 = 0;
 };
@@ -180,9 +256,12 @@ ARM_Dynarmic::ARM_Dynarmic(System& system, ExclusiveMonitor& exclusive_monitor,
       core_index{core_index}, exclusive_monitor{
                                   dynamic_cast<DynarmicExclusiveMonitor&>(exclusive_monitor)} {}
 
-ARM_Dynarmic::~ARM_Dynarmic() = default;
+ARM_Dynarmic::~ARM_Dynarmic() {
+    cb->fallback_statistics.Log();
+}
 
 void ARM_Dynarmic::SetPC(u64 pc) {
+    InvalidateState();
     jit->SetPC(pc);
 }
 
@@ -195,6 +274,7 @@ u64 ARM_Dynarmic::GetReg(int index) const {
 }
 
 void ARM_Dynarmic::SetReg(int index, u64 value) {
+    InvalidateState();
     jit->SetRegister(index, value);
 }
 
@@ -203,6 +283,7 @@ u128 ARM_Dynarmic::GetVectorReg(int index) const {
 }
 
 void ARM_Dynarmic::SetVectorReg(int index, u128 value) {
+    InvalidateState();
     jit->SetVector(index, value);
 }
 
@@ -211,6 +292,7 @@ u32 ARM_Dynarmic::GetPSTATE() const {
 }
 
 void ARM_Dynarmic::SetPSTATE(u32 pstate) {
+    InvalidateState();
     jit->SetPstate(pstate);
 }
 
@@ -242,6 +324,7 @@ void ARM_Dynarmic::SaveContext(ThreadContext& ctx) {
 }
 
 void ARM_Dynarmic::LoadContext(const ThreadContext& ctx) {
+    InvalidateState();
     jit->SetRegisters(ctx.cpu_registers);
     jit->SetSP(ctx.sp);
     jit->SetPC(ctx.pc);
@@ -260,12 +343,18 @@ void ARM_Dynarmic::ClearInstructionCache() {
     jit->ClearCache();
 }
 
+void ARM_Dynarmic::InvalidateCacheRange(VAddr addr, std::size_t size) {
+    jit->InvalidateCacheRange(addr, size);
+}
+
 void ARM_Dynarmic::ClearExclusiveState() {
     jit->ClearExclusiveState();
 }
 
 void ARM_Dynarmic::PageTableChanged(Common::PageTable& page_table,
                                     std::size_t new_address_space_size_in_bits) {
+    // The new JIT starts with a blank state
+    InvalidateState();
     jit = MakeJit(page_table, new_address_space_size_in_bits);
 }
 
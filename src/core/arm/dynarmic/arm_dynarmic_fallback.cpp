@@ -0,0 +1,206 @@
+// Copyright 2020 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <dynarmic/A64/a64.h>
+#include "common/bit_util.h"
+#include "common/logging/log.h"
+#include "core/arm/dynarmic/arm_dynarmic_fallback.h"
+
+namespace Core {
+
+namespace {
+
+constexpr u32 FPCR_RMODE_SHIFT = 22;
+constexpr u32 FPCR_RMODE_MASK = 3;
+constexpr u32 FPCR_FZ = 1U << 24;
+
+constexpr u32 FPSR_IOC = 1U << 0;
+constexpr u32 FPSR_IXC = 1U << 4;
+constexpr u32 FPSR_IDC = 1U << 7;
+
+/// Number of fallback locations logged by FallbackStatistics::Log.
+constexpr std::size_t NUM_LOGGED_FALLBACKS = 16;
+
+/// Converts a floating point value to fixed point, rounding towards zero and saturating.
+template <typename Int, typename Float>
+Int FloatToFixed(Float value, u32 fbits, bool flush_to_zero, u32& fpsr) {
+    if (std::isnan(value)) {
+        fpsr |= FPSR_IOC;
+        return 0;
+    }
+    if (flush_to_zero && std::fpclassify(value) == FP_SUBNORMAL) {
+        fpsr |= FPSR_IDC;
+        return 0;
+    }
+
+    // Scaling by a power of two is exact, only the truncation can lose precision
+    const Float scaled = std::ldexp(value, static_cast<int>(fbits));
+    const Float truncated = std::trunc(scaled);
+
+    // Both bounds are powers of two (or zero), so they are exact as floating point values
+    constexpr Float min = static_cast<Float>(std::numeric_limits<Int>::min());
+    constexpr Float max_plus_one =
+        static_cast<Float>(std::numeric_limits<Int>::max() / 2 + 1) * Float{2};
+    if (truncated < min) {
+        fpsr |= FPSR_IOC;
+        return std::numeric_limits<Int>::min();
+    }
+    if (truncated >= max_plus_one) {
+        fpsr |= FPSR_IOC;
+        return std::numeric_limits<Int>::max();
+    }
+    if (truncated != scaled) {
+        fpsr |= FPSR_IXC;
+    }
+    return static_cast<Int>(truncated);
+}
+
+/// Converts a fixed point value to floating point, rounding to nearest.
+template <typename Float, typename Int>
+Float FixedToFloat(Int value, u32 fbits, u32& fpsr) {
+    const u64 magnitude = value < 0 ? u64{0} - static_cast<u64>(value) : static_cast<u64>(value);
+    if (magnitude != 0) {
+        const u32 significant_bits = 64 - Common::CountLeadingZeroes64(magnitude) -
+                                     Common::CountTrailingZeroes64(magnitude);
+        if (significant_bits > static_cast<u32>(std::numeric_limits<Float>::digits)) {
+            fpsr |= FPSR_IXC;
+        }
+    }
+    // The host conversion rounds to nearest, scaling afterwards is exact
+    return std::ldexp(static_cast<Float>(value), -static_cast<int>(fbits));
+}
+
+template <typename UInt>
+UInt ConvertElement(UInt element, bool to_float, bool is_unsigned, u32 fbits, bool flush_to_zero,
+                    u32& fpsr) {
+    using SInt = std::make_signed_t<UInt>;
+    using Float = std::conditional_t<sizeof(UInt) == sizeof(u64), double, float>;
+    static_assert(sizeof(Float) == sizeof(UInt));
+
+    if (to_float) {
+        const Float value = is_unsigned
+                                ? FixedToFloat<Float>(element, fbits, fpsr)
+                                : FixedToFloat<Float>(static_cast<SInt>(element), fbits, fpsr);
+        UInt result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    Float value;
+    std::memcpy(&value, &element, sizeof(value));
+    if (is_unsigned) {
+        return FloatToFixed<UInt>(value, fbits, flush_to_zero, fpsr);
+    }
+    return static_cast<UInt>(FloatToFixed<SInt>(value, fbits, flush_to_zero, fpsr));
+}
+
+/**
+ * SCVTF, UCVTF, FCVTZS and FCVTZU (scalar and vector, fixed-point), in single and double
+ * precision. Half precision is left to Unicorn.
+ */
+bool InterpretFixedPointConversion(Dynarmic::A64::Jit& jit, u32 instruction) {
+    const bool is_scalar = (instruction & 0xDF800400) == 0x5F000400;
+    const bool is_vector = (instruction & 0x9F800400) == 0x0F000400;
+    if (!is_scalar && !is_vector) {
+        return false;
+    }
+
+    const u32 opcode = (instruction >> 11) & 0x1F;
+    const bool to_float = opcode == 0b11100;
+    if (!to_float && opcode != 0b11111) {
+        return false;
+    }
+
+    const bool q = ((instruction >> 30) & 1) != 0;
+    const bool is_unsigned = ((instruction >> 29) & 1) != 0;
+    const u32 immh = (instruction >> 19) & 0xF;
+    const u32 immhb = (instruction >> 16) & 0x7F;
+    const std::size_t rn = (instruction >> 5) & 0x1F;
+    const std::size_t rd = instruction & 0x1F;
+
+    u32 esize;
+    if ((immh & 0b1000) != 0) {
+        esize = 64;
+    } else if ((immh & 0b0100) != 0) {
+        esize = 32;
+    } else {
+        return false;
+    }
+    if (is_vector && esize == 64 && !q) {
+        // Reserved encoding
+        return false;
+    }
+    const u32 fbits = esize * 2 - immhb;
+
+    const u32 fpcr = jit.GetFpcr();
+    if (to_float && ((fpcr >> FPCR_RMODE_SHIFT) & FPCR_RMODE_MASK) != 0) {
+        // Only round to nearest is handled, which is what guests set
+        return false;
+    }
+    const bool flush_to_zero = (fpcr & FPCR_FZ) != 0;
+
+    const Dynarmic::A64::Vector operand = jit.GetVector(rn);
+    const std::size_t datasize = is_scalar ? esize : (q ? 128 : 64);
+    Dynarmic::A64::Vector result{};
+    u32 fpsr = 0;
+    for (std::size_t element = 0; element < datasize / esize; ++element) {
+        if (esize == 64) {
+            result[element] =
+                ConvertElement(operand[element], to_float, is_unsigned, fbits, flush_to_zero, fpsr);
+            continue;
+        }
+        const std::size_t shift = (element % 2) * 32;
+        const auto value = static_cast<u32>(operand[element / 2] >> shift);
+        const u32 converted =
+            ConvertElement(value, to_float, is_unsigned, fbits, flush_to_zero, fpsr);
+        result[element / 2] |= static_cast<u64>(converted) << shift;
+    }
+
+    jit.SetVector(rd, result);
+    jit.SetFpsr(jit.GetFpsr() | fpsr);
+    return true;
+}
+
+} // Anonymous namespace
+
+bool InterpretFallbackInstruction(Dynarmic::A64::Jit& jit, u32 instruction) {
+    return InterpretFixedPointConversion(jit, instruction);
+}
+
+void FallbackStatistics::Record(u64 pc, u32 instruction, bool is_native) {
+    const auto [it, is_new] = entries.try_emplace(pc, Entry{instruction, is_native, 0});
+    Entry& entry = it->second;
+    if (is_new || entry.instruction != instruction) {
+        // Code at the same address may have been replaced
+        LOG_INFO(Core_ARM, "{} fallback @ 0x{:X} (instr = {:08X})",
+                 is_native ? "Native" : "Unicorn", pc, instruction);
+        entry = Entry{instruction, is_native, 0};
+    }
+    ++entry.hits;
+}
+
+void FallbackStatistics::Log() const {
+    if (entries.empty()) {
+        return;
+    }
+    std::vector<std::pair<u64, Entry>> sorted(entries.begin(), entries.end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.second.hits > rhs.second.hits; });
+    sorted.resize(std::min(sorted.size(), NUM_LOGGED_FALLBACKS));
+
+    LOG_INFO(Core_ARM, "Most frequent interpreter fallbacks out of {} locations:", entries.size());
+    for (const auto& [pc, entry] : sorted) {
+        LOG_INFO(Core_ARM, "  0x{:X} (instr = {:08X}, {}): {} hits", pc, entry.instruction,
+                 entry.is_native ? "native" : "unicorn", entry.hits);
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,45 @@
+// Copyright 2020 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <unordered_map>
+#include "common/common_types.h"
+
+namespace Dynarmic::A64 {
+class Jit;
+}
+
+namespace Core {
+
+/**
+ * Executes an instruction the JIT doesn't implement directly on the JIT state, avoiding the round
+ * trip of the whole context through Unicorn. The PC is not touched.
+ *
+ * @returns True when the instruction was executed, false when it isn't handled here; the state
+ *          is left untouched in that case.
+ */
+bool InterpretFallbackInstruction(Dynarmic::A64::Jit& jit, u32 instruction);
+
+/// Counts the instructions reaching the JIT interpreter fallback, to know which ones are worth
+/// implementing in the JIT.
+class FallbackStatistics {
+public:
+    /// Records a fallback of the instruction at pc, logging it the first time it's seen.
+    void Record(u64 pc, u32 instruction, bool is_native);
+
+    /// Logs the locations that fell back the most.
+    void Log() const;
+
+private:
+    struct Entry {
+        u32 instruction;
+        bool is_native;
+        u64 hits;
+    };
+
+    std::unordered_map<u64, Entry> entries;
+};
+
+} // namespace Core
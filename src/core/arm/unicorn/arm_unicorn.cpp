@@ -82,6 +82,7 @@ ARM_Unicorn::~ARM_Unicorn() {
 }
 
 void ARM_Unicorn::SetPC(u64 pc) {
+    InvalidateState();
     CHECKED(uc_reg_write(uc, UC_ARM64_REG_PC, &pc));
 }
 
@@ -104,6 +105,7 @@ u64 ARM_Unicorn::GetReg(int regn) const {
 }
 
 void ARM_Unicorn::SetReg(int regn, u64 val) {
+    InvalidateState();
     auto treg = UC_ARM64_REG_SP;
     if (regn <= 28) {
         treg = (uc_arm64_reg)(UC_ARM64_REG_X0 + regn);
@@ -130,6 +132,7 @@ u32 ARM_Unicorn::GetPSTATE() const {
 }
 
 void ARM_Unicorn::SetPSTATE(u32 pstate) {
+    InvalidateState();
     u64 nzcv = pstate;
     CHECKED(uc_reg_write(uc, UC_ARM64_REG_NZCV, &nzcv));
 }
@@ -216,6 +219,7 @@ void ARM_Unicorn::SaveContext(ThreadContext& ctx) {
 }
 
 void ARM_Unicorn::LoadContext(const ThreadContext& ctx) {
+    InvalidateState();
     int uregs[32];
     void* tregs[32];
 
@@ -250,6 +254,8 @@ void ARM_Unicorn::ClearExclusiveState() {}
 
 void ARM_Unicorn::ClearInstructionCache() {}
 
+void ARM_Unicorn::InvalidateCacheRange(VAddr addr, std::size_t size) {}
+
 void ARM_Unicorn::RecordBreak(GDBStub::BreakpointAddress bkpt) {
     last_bkpt = bkpt;
     last_bkpt_hit = true;
@@ -3,12 +3,15 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <chrono>
 #include <memory>
+#include <tuple>
 #include <utility>
 
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread_worker.h"
 #include "core/arm/exclusive_monitor.h"
 #include "core/core.h"
 #include "core/core_manager.h"
@@ -22,6 +25,7 @@
 #include "core/file_sys/romfs_factory.h"
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/sdmc_factory.h"
+#include "core/file_sys/vfs_cached.h"
 #include "core/file_sys/vfs_concat.h"
 #include "core/file_sys/vfs_real.h"
 #include "core/gdbstub/gdbstub.h"
@@ -44,6 +48,7 @@
 #include "core/memory/cheat_engine.h"
 #include "core/perf_stats.h"
 #include "core/reporter.h"
+#include "core/save_state.h"
 #include "core/settings.h"
 #include "core/telemetry_session.h"
 #include "core/tools/freezer.h"
@@ -77,6 +82,7 @@ FileSys::StorageId GetStorageIdForFrontendSlot(
 } // Anonymous namespace
 
 /*static*/ System System::s_instance;
+/*static*/ thread_local System* System::current_instance = &System::s_instance;
 
 FileSys::VirtualFile GetGameFileFromPath(const FileSys::VirtualFilesystem& vfs,
                                          const std::string& path) {
@@ -140,6 +146,7 @@ struct System::Impl {
     ResultStatus Init(System& system, Frontend::EmuWindow& emu_window) {
         LOG_DEBUG(HW_Memory, "initialized OK");
 
+        core_timing.SetHostTiming(Settings::values.use_host_timing);
         core_timing.Initialize();
         kernel.Initialize();
         cpu_manager.Initialize();
@@ -164,15 +171,34 @@ struct System::Impl {
         telemetry_session = std::make_unique<Core::TelemetrySession>();
         service_manager = std::make_shared<Service::SM::ServiceManager>();
 
-        Service::Init(service_manager, system);
-        GDBStub::Init();
-
-        renderer = VideoCore::CreateRenderer(emu_window, system);
-        if (!renderer->Init()) {
+        // The services don't depend on the renderer, build them on the shared worker while the
+        // renderer initializes. The renderer stays on this thread, it owns the graphics context.
+        Common::TaskGroup services_task;
+        Common::GetSharedWorker().QueueWork(
+            services_task,
+            [this, &system] {
+                BootStageTimer timer{"services"};
+                Service::Init(service_manager, system);
+                GDBStub::Init();
+            },
+            Common::WorkPriority::High);
+
+        // A soft reset keeps the renderer of the previous session, only its rasterizer is new
+        bool renderer_initialized = true;
+        if (renderer == nullptr) {
+            BootStageTimer timer{"renderer"};
+            renderer = VideoCore::CreateRenderer(emu_window, system);
+            renderer_initialized = renderer->Init();
+        }
+        services_task.Wait();
+        if (!renderer_initialized) {
             return ResultStatus::ErrorVideoCore;
         }
         interrupt_manager = std::make_unique<Core::Hardware::InterruptManager>(system);
-        gpu_core = VideoCore::CreateGPU(system);
+        {
+            BootStageTimer timer{"gpu"};
+            gpu_core = VideoCore::CreateGPU(system);
+        }
 
         is_powered_on = true;
         exit_lock = false;
@@ -184,7 +210,12 @@ struct System::Impl {
 
     ResultStatus Load(System& system, Frontend::EmuWindow& emu_window,
                       const std::string& filepath) {
-        app_loader = Loader::GetLoader(GetGameFileFromPath(virtual_filesystem, filepath));
+        BootStageTimer boot_timer{"boot (total)"};
+        loaded_filepath = filepath;
+        {
+            BootStageTimer timer{"loader"};
+            app_loader = Loader::GetLoader(GetGameFileFromPath(virtual_filesystem, filepath));
+        }
         if (!app_loader) {
             LOG_CRITICAL(Core, "Failed to obtain loader for {}!", filepath);
             return ResultStatus::ErrorGetLoader;
@@ -201,7 +232,10 @@ struct System::Impl {
         telemetry_session->AddInitialInfo(*app_loader);
         auto main_process =
             Kernel::Process::Create(system, "main", Kernel::Process::ProcessType::Userland);
-        const auto [load_result, load_parameters] = app_loader->Load(*main_process);
+        const auto [load_result, load_parameters] = [&] {
+            BootStageTimer timer{"application"};
+            return app_loader->Load(*main_process);
+        }();
         if (load_result != Loader::ResultStatus::Success) {
             LOG_CRITICAL(Core, "Failed to load ROM (Error {})!", static_cast<int>(load_result));
             Shutdown();
@@ -248,7 +282,23 @@ struct System::Impl {
         return status;
     }
 
-    void Shutdown() {
+    ResultStatus SoftReset(System& system) {
+        if (!is_powered_on || renderer == nullptr) {
+            return ResultStatus::ErrorNotInitialized;
+        }
+        BootStageTimer timer{"soft reset"};
+        const std::string filepath = loaded_filepath;
+        auto& emu_window = renderer->GetRenderWindow();
+        Shutdown(true);
+        const ResultStatus result = Load(system, emu_window, filepath);
+        if (result != ResultStatus::Success) {
+            // Don't leave a renderer bound to the window behind a failed boot
+            renderer.reset();
+        }
+        return result;
+    }
+
+    void Shutdown(bool keep_renderer = false) {
         // Log last frame performance stats if game was loded
         if (perf_stats) {
             const auto perf_results = GetAndResetPerfStats();
@@ -261,6 +311,14 @@ struct System::Impl {
                                         perf_results.frametime * 1000.0);
             telemetry_session->AddField(Telemetry::FieldType::Performance, "Mean_Frametime_MS",
                                         perf_stats->GetMeanFrametime());
+            if (gpu_core) {
+                telemetry_session->AddField(Telemetry::FieldType::Performance,
+                                            "Shutdown_GpuQueuePeakDepth",
+                                            static_cast<u64>(gpu_core->GetPeakCommandQueueDepth()));
+            }
+            telemetry_session->AddField(
+                Telemetry::FieldType::Performance, "Shutdown_NcaCacheHitRate",
+                FileSys::SectorCache::GetInstance().GetStats().HitRate() * 100.0);
         }
 
         lm_manager.Flush();
@@ -273,7 +331,9 @@ struct System::Impl {
         }
 
         // Shutdown emulation session
-        renderer.reset();
+        if (!keep_renderer) {
+            renderer.reset();
+        }
         GDBStub::Shutdown();
         Service::Shutdown();
         service_manager.reset();
@@ -281,6 +341,10 @@ struct System::Impl {
         telemetry_session.reset();
         perf_stats.reset();
         gpu_core.reset();
+        if (keep_renderer && renderer) {
+            // The caches of the rasterizer point into the memory of the process about to be freed
+            renderer->ResetRasterizer();
+        }
 
         // Close all CPU/threading state
         cpu_manager.Shutdown();
@@ -337,7 +401,19 @@ struct System::Impl {
     }
 
     PerfStatsResults GetAndResetPerfStats() {
-        return perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs());
+        auto results = perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs());
+        if (gpu_core) {
+            std::tie(results.syncpt_wait_time, results.syncpt_waits) =
+                gpu_core->GetAndResetSyncptWaitStats();
+            std::tie(results.gpu_accelerated_blits, results.gpu_unhandled_blits) =
+                gpu_core->GetAndResetBlitStats();
+            std::tie(results.gpu_resolved_overlaps, results.gpu_flushed_overlaps) =
+                gpu_core->GetAndResetSurfaceOverlapStats();
+            results.gpu_skipped_upload_bytes = gpu_core->GetAndResetSkippedUploadStats();
+            std::tie(results.gpu_uploaded_buffer_bytes, results.gpu_reused_const_buffer_bytes) =
+                gpu_core->GetAndResetBufferUploadStats();
+        }
+        return results;
     }
 
     Timing::CoreTiming core_timing;
@@ -349,6 +425,8 @@ struct System::Impl {
     Service::FileSystem::FileSystemController fs_controller;
     /// AppLoader used to load the current executing application
     std::unique_ptr<Loader::AppLoader> app_loader;
+    /// Path the current application was loaded from, booted again by a soft reset
+    std::string loaded_filepath;
     std::unique_ptr<VideoCore::RendererBase> renderer;
     std::unique_ptr<Tegra::GPU> gpu_core;
     std::unique_ptr<Hardware::InterruptManager> interrupt_manager;
@@ -408,6 +486,10 @@ void System::InvalidateCpuInstructionCaches() {
     impl->kernel.InvalidateAllInstructionCaches();
 }
 
+void System::InvalidateCpuInstructionCacheRange(VAddr addr, std::size_t size) {
+    impl->kernel.InvalidateInstructionCacheRange(addr, size);
+}
+
 System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::string& filepath) {
     return impl->Load(*this, emu_window, filepath);
 }
@@ -699,6 +781,38 @@ void System::Shutdown() {
     impl->Shutdown();
 }
 
+System::ResultStatus System::SoftReset() {
+    return impl->SoftReset(*this);
+}
+
+std::shared_ptr<const SaveState> System::CreateSaveState() {
+    if (!IsPoweredOn()) {
+        return nullptr;
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    auto state = std::make_shared<const SaveState>(*this);
+    LOG_INFO(Core, "Saved state in {} ms",
+             std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - begin)
+                 .count());
+    return state;
+}
+
+bool System::LoadSaveState(const SaveState& state) {
+    if (!IsPoweredOn()) {
+        return false;
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    if (!state.Restore(*this)) {
+        return false;
+    }
+    LOG_INFO(Core, "Loaded state in {} ms",
+             std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - begin)
+                 .count());
+    return true;
+}
+
 Service::SM::ServiceManager& System::ServiceManager() {
     return *impl->service_manager;
 }
@@ -98,6 +98,7 @@ class ExclusiveMonitor;
 class FrameLimiter;
 class PerfStats;
 class Reporter;
+class SaveState;
 class TelemetrySession;
 
 struct PerfStatsResults;
@@ -115,14 +116,26 @@ public:
     System(System&&) = delete;
     System& operator=(System&&) = delete;
 
+    /// Creates an isolated system, it has to be bound with SetCurrentInstance before being used.
+    System();
     ~System();
 
     /**
-     * Gets the instance of the System singleton class.
-     * @returns Reference to the instance of the System singleton class.
+     * Gets the instance of the System bound to the calling thread. Threads start bound to the
+     * process wide instance.
+     * @returns Reference to the instance of the System bound to the calling thread.
      */
     static System& GetInstance() {
-        return s_instance;
+        return *current_instance;
+    }
+
+    /**
+     * Binds an instance to the calling thread, GetInstance returns it on this thread from then on.
+     * Allows running isolated systems in the same process, each one driven by its own threads.
+     * @param system Instance to bind, it must outlive its usage from the calling thread.
+     */
+    static void SetCurrentInstance(System& system) {
+        current_instance = &system;
     }
 
     /// Enumeration representing the return values of the System Initialize and Load process.
@@ -162,9 +175,39 @@ public:
      */
     void InvalidateCpuInstructionCaches();
 
+    /**
+     * Invalidate translated CPU code for a range of guest memory only. This should be preferred
+     * over InvalidateCpuInstructionCaches whenever the modified range is known.
+     * @param addr Start of the modified range.
+     * @param size Size of the modified range in bytes.
+     */
+    void InvalidateCpuInstructionCacheRange(VAddr addr, std::size_t size);
+
     /// Shutdown the emulated system.
     void Shutdown();
 
+    /**
+     * Restarts the running application without tearing down the host side of the emulator. The
+     * kernel, services, GPU and rasterizer are recreated from scratch, while the renderer with its
+     * window and graphics context, the filesystem, the content providers and the keys are kept.
+     * @returns ResultStatus code, indicating if the application booted again.
+     */
+    ResultStatus SoftReset();
+
+    /**
+     * Takes a snapshot of the running application, see SaveState. Has to be called from the
+     * emulation thread between two calls to RunLoop, or while the emulation is paused.
+     * @returns The snapshot, or nullptr when no application is running.
+     */
+    std::shared_ptr<const SaveState> CreateSaveState();
+
+    /**
+     * Returns the running application to a snapshot taken by CreateSaveState during this session,
+     * with the same threading requirements.
+     * @returns Whether the snapshot could be restored.
+     */
+    bool LoadSaveState(const SaveState& state);
+
     /**
      * Load an executable application.
      * @param emu_window Reference to the host-system window used for video output and keyboard
@@ -361,8 +404,6 @@ public:
     const CurrentBuildProcessID& GetCurrentProcessBuildID() const;
 
 private:
-    System();
-
     /// Returns the currently running CPU core
     CoreManager& CurrentCoreManager();
 
@@ -381,6 +422,7 @@ private:
     std::unique_ptr<Impl> impl;
 
     static System s_instance;
+    static thread_local System* current_instance;
 };
 
 } // namespace Core
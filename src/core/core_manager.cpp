@@ -14,19 +14,19 @@
 #include "core/core.h"
 #include "core/core_manager.h"
 #include "core/core_timing.h"
+#include "core/frame_timeline.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/physical_core.h"
 #include "core/hle/kernel/scheduler.h"
 #include "core/hle/kernel/thread.h"
-#include "core/hle/lock.h"
 #include "core/settings.h"
 
 namespace Core {
 
 CoreManager::CoreManager(System& system, std::size_t core_index)
-    : global_scheduler{system.GlobalScheduler()}, physical_core{system.Kernel().PhysicalCore(
-                                                      core_index)},
-      core_timing{system.CoreTiming()}, core_index{core_index} {}
+    : global_scheduler{system.GlobalScheduler()},
+      physical_core{system.Kernel().PhysicalCore(core_index)}, core_timing{system.CoreTiming()},
+      hle_lock{system.Kernel().HLELock()}, core_index{core_index} {}
 
 CoreManager::~CoreManager() = default;
 
@@ -37,15 +37,25 @@ void CoreManager::RunLoop(bool tight_loop) {
     // instead advance to the next event and try to yield to the next thread
     if (Kernel::GetCurrentThread() == nullptr) {
         LOG_TRACE(Core, "Core-{} idling", core_index);
+        FrameTimeline::ScopedTimer timer{FrameTimeline::Stage::Idle};
         core_timing.Idle();
     } else {
+        FrameTimeline::ScopedTimer timer{FrameTimeline::Stage::Jit};
         if (tight_loop) {
             physical_core.Run();
         } else {
             physical_core.Step();
         }
     }
-    core_timing.Advance();
+
+    {
+        // In multicore mode, event callbacks may touch HLE state while other cores are running.
+        std::unique_lock lock{hle_lock, std::defer_lock};
+        if (core_timing.IsMultiCore()) {
+            lock.lock();
+        }
+        core_timing.Advance();
+    }
 
     Reschedule();
 }
@@ -60,7 +70,7 @@ void CoreManager::PrepareReschedule() {
 
 void CoreManager::Reschedule() {
     // Lock the global kernel mutex when we manipulate the HLE state
-    std::lock_guard lock(HLE::g_hle_lock);
+    std::lock_guard lock(hle_lock);
 
     global_scheduler.SelectThread(core_index);
 
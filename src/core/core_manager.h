@@ -7,6 +7,7 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include "common/common_types.h"
 
 namespace Kernel {
@@ -55,6 +56,7 @@ private:
     Kernel::GlobalScheduler& global_scheduler;
     Kernel::PhysicalCore& physical_core;
     Timing::CoreTiming& core_timing;
+    std::recursive_mutex& hle_lock;
 
     std::atomic<bool> reschedule_pending = false;
     std::size_t core_index;
@@ -5,17 +5,23 @@
 #include "core/core_timing.h"
 
 #include <algorithm>
-#include <mutex>
+#include <deque>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "common/assert.h"
 #include "common/thread.h"
+#include "common/wall_clock.h"
 #include "core/core_timing_util.h"
 
 namespace Core::Timing {
 
 constexpr int MAX_SLICE_LENGTH = 10000;
+// With host timing the slices don't determine the guest time, so they only bound how late events
+// can be dispatched.
+constexpr int MAX_HOST_TIMING_SLICE_LENGTH = 100000;
 
 std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callback) {
     return std::make_shared<EventType>(std::move(callback), std::move(name));
@@ -38,16 +44,228 @@ struct CoreTiming::Event {
     }
 };
 
-CoreTiming::CoreTiming() = default;
+struct CoreTiming::StagedOperation {
+    enum class Type {
+        Schedule,
+        Unschedule,
+        Remove,
+    };
+
+    Type type;
+    Event event;
+};
+
+thread_local u64 CoreTiming::current_context = 0;
+
+/**
+ * Pairing heap of pending events. Every node is additionally linked into a per-type chain, so
+ * cancelling the events of a given type only visits the events of that type instead of the whole
+ * queue.
+ *
+ * Insertion is O(1), removal of the top or of an arbitrary node is O(log n) amortized. Nodes are
+ * recycled through a free list, so steady-state scheduling doesn't allocate.
+ */
+class CoreTiming::EventQueue {
+public:
+    bool Empty() const {
+        return root == nullptr;
+    }
+
+    const Event& Top() const {
+        return root->event;
+    }
+
+    void Push(Event event) {
+        Node* const node = AllocateNode();
+        node->event = std::move(event);
+
+        // The raw pointer is only used as a lookup key, it's never dereferenced.
+        node->type_key = node->event.type.lock().get();
+        Node*& head = type_heads[node->type_key];
+        node->type_next = head;
+        if (head != nullptr) {
+            head->type_prev = node;
+        }
+        head = node;
+
+        root = Meld(root, node);
+    }
+
+    Event Pop() {
+        Node* const node = root;
+        Event event = std::move(node->event);
+        Erase(node);
+        return event;
+    }
+
+    template <typename Predicate>
+    void RemoveIf(const EventType* type, Predicate&& predicate) {
+        const auto itr = type_heads.find(type);
+        if (itr == type_heads.end()) {
+            return;
+        }
+        Node* node = itr->second;
+        while (node != nullptr) {
+            Node* const next = node->type_next;
+            if (predicate(node->event)) {
+                Erase(node);
+            }
+            node = next;
+        }
+    }
+
+    /// Calls func with every pending event, in no particular order.
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const auto& [type, head] : type_heads) {
+            for (const Node* node = head; node != nullptr; node = node->type_next) {
+                func(node->event);
+            }
+        }
+    }
+
+    void Clear() {
+        nodes.clear();
+        free_nodes.clear();
+        type_heads.clear();
+        root = nullptr;
+    }
+
+private:
+    struct Node {
+        Event event;
+        const EventType* type_key;
+
+        // Heap links. For the first child of a node, prev points to the parent.
+        Node* child;
+        Node* next;
+        Node* prev;
+
+        // Links of the chain of pending events that share the same type.
+        Node* type_next;
+        Node* type_prev;
+    };
+
+    Node* AllocateNode() {
+        Node* node;
+        if (free_nodes.empty()) {
+            node = &nodes.emplace_back();
+        } else {
+            node = free_nodes.back();
+            free_nodes.pop_back();
+        }
+        node->child = nullptr;
+        node->next = nullptr;
+        node->prev = nullptr;
+        node->type_next = nullptr;
+        node->type_prev = nullptr;
+        return node;
+    }
+
+    void Erase(Node* node) {
+        if (node == root) {
+            root = MergePairs(node->child);
+        } else {
+            if (node->prev->child == node) {
+                node->prev->child = node->next;
+            } else {
+                node->prev->next = node->next;
+            }
+            if (node->next != nullptr) {
+                node->next->prev = node->prev;
+            }
+            root = Meld(root, MergePairs(node->child));
+        }
+
+        if (node->type_prev != nullptr) {
+            node->type_prev->type_next = node->type_next;
+        } else {
+            type_heads[node->type_key] = node->type_next;
+        }
+        if (node->type_next != nullptr) {
+            node->type_next->type_prev = node->type_prev;
+        }
+
+        node->event.type.reset();
+        free_nodes.push_back(node);
+    }
+
+    /// Links two heaps together, returning the new root.
+    static Node* Meld(Node* a, Node* b) {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        if (b->event < a->event) {
+            std::swap(a, b);
+        }
+        b->prev = a;
+        b->next = a->child;
+        if (a->child != nullptr) {
+            a->child->prev = b;
+        }
+        a->child = b;
+        a->next = nullptr;
+        a->prev = nullptr;
+        return a;
+    }
+
+    /// Standard two-pass merge of a sibling list into a single heap.
+    Node* MergePairs(Node* first) {
+        if (first == nullptr) {
+            return nullptr;
+        }
+        merge_scratch.clear();
+        while (first != nullptr) {
+            Node* const a = first;
+            Node* const b = a->next;
+            if (b == nullptr) {
+                a->next = nullptr;
+                a->prev = nullptr;
+                merge_scratch.push_back(a);
+                break;
+            }
+            first = b->next;
+            a->next = nullptr;
+            a->prev = nullptr;
+            b->next = nullptr;
+            b->prev = nullptr;
+            merge_scratch.push_back(Meld(a, b));
+        }
+        Node* result = merge_scratch.back();
+        for (auto itr = merge_scratch.rbegin() + 1; itr != merge_scratch.rend(); ++itr) {
+            result = Meld(*itr, result);
+        }
+        return result;
+    }
+
+    Node* root = nullptr;
+    std::deque<Node> nodes;
+    std::vector<Node*> free_nodes;
+    std::vector<Node*> merge_scratch;
+    std::unordered_map<const EventType*, Node*> type_heads;
+};
+
+CoreTiming::CoreTiming() : event_queue{std::make_unique<EventQueue>()} {}
 CoreTiming::~CoreTiming() = default;
 
 void CoreTiming::Initialize() {
-    downcounts.fill(MAX_SLICE_LENGTH);
-    time_slice.fill(MAX_SLICE_LENGTH);
-    slice_length = MAX_SLICE_LENGTH;
+    max_slice_length = is_host_timing ? MAX_HOST_TIMING_SLICE_LENGTH : MAX_SLICE_LENGTH;
+    if (is_host_timing) {
+        clock = Common::CreateBestMatchingClock(BASE_CLOCK_RATE);
+    } else {
+        clock.reset();
+    }
+
+    downcounts.fill(max_slice_length);
+    time_slice.fill(max_slice_length);
+    slice_length = max_slice_length;
     global_timer = 0;
     idled_cycles = 0;
     current_context = 0;
+    timing_thread = std::thread::id{};
 
     // The time between CoreTiming being initialized and the first call to Advance() is considered
     // the slice boundary between slice -1 and slice 0. Dispatcher loops must call Advance() before
@@ -67,7 +285,11 @@ void CoreTiming::Shutdown() {
 
 void CoreTiming::ScheduleEvent(s64 cycles_into_future, const std::shared_ptr<EventType>& event_type,
                                u64 userdata) {
-    std::lock_guard guard{inner_mutex};
+    if (!IsTimingThread()) {
+        ScheduleEventThreadsafe(cycles_into_future, event_type, userdata);
+        return;
+    }
+
     const s64 timeout = GetTicks() + cycles_into_future;
 
     // If this event needs to be scheduled before the next advance(), force one early
@@ -75,26 +297,32 @@ void CoreTiming::ScheduleEvent(s64 cycles_into_future, const std::shared_ptr<Eve
         ForceExceptionCheck(cycles_into_future);
     }
 
-    event_queue.emplace_back(Event{timeout, event_fifo_id++, userdata, event_type});
+    event_queue->Push(Event{timeout, event_fifo_id++, userdata, event_type});
+}
 
-    std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+void CoreTiming::ScheduleEventThreadsafe(s64 cycles_into_future,
+                                         const std::shared_ptr<EventType>& event_type,
+                                         u64 userdata) {
+    ts_queue.Push(StagedOperation{StagedOperation::Type::Schedule,
+                                  Event{cycles_into_future, 0, userdata, event_type}});
 }
 
 void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type, u64 userdata) {
-    std::lock_guard guard{inner_mutex};
-
-    const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type.lock().get() == event_type.get() && e.userdata == userdata;
-    });
-
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    if (!IsTimingThread()) {
+        ts_queue.Push(StagedOperation{StagedOperation::Type::Unschedule,
+                                      Event{0, 0, userdata, event_type}});
+        return;
     }
+
+    event_queue->RemoveIf(event_type.get(),
+                          [userdata](const Event& e) { return e.userdata == userdata; });
 }
 
 u64 CoreTiming::GetTicks() const {
+    if (clock) {
+        return clock->GetCPUCycles();
+    }
+
     u64 ticks = static_cast<u64>(global_timer);
     if (!is_global_timer_sane) {
         ticks += accumulated_ticks;
@@ -107,26 +335,53 @@ u64 CoreTiming::GetIdleTicks() const {
 }
 
 void CoreTiming::AddTicks(u64 ticks) {
-    accumulated_ticks += ticks;
+    if (IsTimingContext()) {
+        accumulated_ticks += ticks;
+    }
     downcounts[current_context] -= static_cast<s64>(ticks);
 }
 
 void CoreTiming::ClearPendingEvents() {
-    event_queue.clear();
+    event_queue->Clear();
+    ts_queue.Clear();
 }
 
-void CoreTiming::RemoveEvent(const std::shared_ptr<EventType>& event_type) {
-    std::lock_guard guard{inner_mutex};
+void CoreTiming::MoveEvents() {
+    StagedOperation op;
+    while (ts_queue.Pop(op)) {
+        Event& evt = op.event;
+        switch (op.type) {
+        case StagedOperation::Type::Schedule:
+            evt.time += global_timer;
+            evt.fifo_order = event_fifo_id++;
+            event_queue->Push(std::move(evt));
+            break;
+        case StagedOperation::Type::Unschedule: {
+            const auto event_type = evt.type.lock();
+            event_queue->RemoveIf(event_type.get(), [userdata = evt.userdata](const Event& e) {
+                return e.userdata == userdata;
+            });
+            break;
+        }
+        case StagedOperation::Type::Remove:
+            event_queue->RemoveIf(evt.type.lock().get(), [](const Event&) { return true; });
+            break;
+        }
+    }
+}
 
-    const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type.lock().get() == event_type.get();
-    });
+bool CoreTiming::IsTimingThread() const {
+    const std::thread::id owner = timing_thread.load(std::memory_order_relaxed);
+    return owner == std::thread::id{} || owner == std::this_thread::get_id();
+}
 
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+void CoreTiming::RemoveEvent(const std::shared_ptr<EventType>& event_type) {
+    if (!IsTimingThread()) {
+        ts_queue.Push(StagedOperation{StagedOperation::Type::Remove, Event{0, 0, 0, event_type}});
+        return;
     }
+
+    event_queue->RemoveIf(event_type.get(), [](const Event&) { return true; });
 }
 
 void CoreTiming::ForceExceptionCheck(s64 cycles) {
@@ -155,52 +410,64 @@ std::optional<u64> CoreTiming::NextAvailableCore(const s64 needed_ticks) const {
 }
 
 void CoreTiming::Advance() {
-    std::unique_lock<std::mutex> guard(inner_mutex);
+    if (!IsTimingContext()) {
+        // Secondary cores in multicore mode only consume their own slice, the global timer and
+        // the event queue are driven by context 0.
+        time_slice[current_context] = std::max<s64>(0, downcounts[current_context]);
+        downcounts[current_context] = time_slice[current_context];
+        return;
+    }
+
+    timing_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
 
     const u64 cycles_executed = accumulated_ticks;
     time_slice[current_context] = std::max<s64>(0, time_slice[current_context] - accumulated_ticks);
-    global_timer += cycles_executed;
+    if (clock) {
+        global_timer = static_cast<s64>(clock->GetCPUCycles());
+    } else {
+        global_timer += cycles_executed;
+    }
 
     is_global_timer_sane = true;
 
-    while (!event_queue.empty() && event_queue.front().time <= global_timer) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
-        inner_mutex.unlock();
+    MoveEvents();
+
+    while (!event_queue->Empty() && event_queue->Top().time <= global_timer) {
+        Event evt = event_queue->Pop();
 
         if (auto event_type{evt.type.lock()}) {
             event_type->callback(evt.userdata, global_timer - evt.time);
         }
-
-        inner_mutex.lock();
     }
 
     is_global_timer_sane = false;
 
+    accumulated_ticks = 0;
+
+    downcounts[current_context] = time_slice[current_context];
+
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
+    if (!event_queue->Empty()) {
         const s64 needed_ticks =
-            std::min<s64>(event_queue.front().time - global_timer, MAX_SLICE_LENGTH);
-        const auto next_core = NextAvailableCore(needed_ticks);
-        if (next_core) {
+            std::min<s64>(event_queue->Top().time - global_timer, max_slice_length);
+        if (is_multicore) {
+            // The other contexts are running on their own threads, so the timing core has to stop
+            // for the event itself.
+            downcounts[current_context] = std::min(downcounts[current_context], needed_ticks);
+        } else if (const auto next_core = NextAvailableCore(needed_ticks)) {
             downcounts[*next_core] = needed_ticks;
         }
     }
-
-    accumulated_ticks = 0;
-
-    downcounts[current_context] = time_slice[current_context];
 }
 
 void CoreTiming::ResetRun() {
-    downcounts.fill(MAX_SLICE_LENGTH);
-    time_slice.fill(MAX_SLICE_LENGTH);
+    downcounts.fill(max_slice_length);
+    time_slice.fill(max_slice_length);
     current_context = 0;
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
+    if (!event_queue->Empty()) {
         const s64 needed_ticks =
-            std::min<s64>(event_queue.front().time - global_timer, MAX_SLICE_LENGTH);
+            std::min<s64>(event_queue->Top().time - global_timer, max_slice_length);
         downcounts[current_context] = needed_ticks;
     }
 
@@ -209,11 +476,50 @@ void CoreTiming::ResetRun() {
 }
 
 void CoreTiming::Idle() {
-    accumulated_ticks += downcounts[current_context];
-    idled_cycles += downcounts[current_context];
+    if (IsTimingContext() && !clock) {
+        accumulated_ticks += downcounts[current_context];
+        idled_cycles += downcounts[current_context];
+    }
     downcounts[current_context] = 0;
 }
 
+CoreTiming::Snapshot CoreTiming::TakeSnapshot() {
+    MoveEvents();
+
+    Snapshot snapshot;
+    event_queue->ForEach([&snapshot](const Event& event) {
+        snapshot.events.push_back({event.time, event.fifo_order, event.userdata, event.type});
+    });
+    snapshot.ticks = GetTicks();
+    snapshot.global_timer = global_timer;
+    snapshot.idled_cycles = idled_cycles;
+    snapshot.slice_length = slice_length;
+    snapshot.accumulated_ticks = accumulated_ticks;
+    snapshot.downcounts = downcounts;
+    snapshot.time_slice = time_slice;
+    snapshot.event_fifo_id = event_fifo_id;
+    snapshot.is_global_timer_sane = is_global_timer_sane;
+    return snapshot;
+}
+
+void CoreTiming::RestoreSnapshot(const Snapshot& snapshot) {
+    const s64 time_offset = clock ? static_cast<s64>(GetTicks() - snapshot.ticks) : 0;
+
+    ClearPendingEvents();
+    for (const auto& event : snapshot.events) {
+        event_queue->Push(
+            Event{event.time + time_offset, event.fifo_order, event.userdata, event.type});
+    }
+    global_timer = snapshot.global_timer + time_offset;
+    idled_cycles = snapshot.idled_cycles;
+    slice_length = snapshot.slice_length;
+    accumulated_ticks = snapshot.accumulated_ticks;
+    downcounts = snapshot.downcounts;
+    time_slice = snapshot.time_slice;
+    event_fifo_id = snapshot.event_fifo_id;
+    is_global_timer_sane = snapshot.is_global_timer_sane;
+}
+
 std::chrono::microseconds CoreTiming::GetGlobalTimeUs() const {
     return std::chrono::microseconds{GetTicks() * 1000000 / BASE_CLOCK_RATE};
 }
@@ -4,17 +4,23 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "common/common_types.h"
 #include "common/threadsafe_queue.h"
 
+namespace Common {
+class WallClock;
+}
+
 namespace Core::Timing {
 
 /// A callback that may be scheduled for a particular core timing event.
@@ -45,6 +51,8 @@ struct EventType {
  */
 class CoreTiming {
 public:
+    static constexpr u64 num_cpu_cores = 4;
+
     CoreTiming();
     ~CoreTiming();
 
@@ -61,16 +69,48 @@ public:
     /// Tears down all timing related functionality.
     void Shutdown();
 
+    /// Enables multicore mode. In this mode, every emulated core runs on its own host thread and
+    /// only context 0 drives the global timer, the other contexts just consume their slices.
+    void SetMultiCore(bool is_multicore_) {
+        is_multicore = is_multicore_;
+    }
+
+    bool IsMultiCore() const {
+        return is_multicore;
+    }
+
+    /// Makes the guest time follow a calibrated host clock instead of the executed cycles. The JIT
+    /// then only has to leave its blocks to dispatch events, so slices can be much longer.
+    /// This must be set before Initialize().
+    void SetHostTiming(bool is_host_timing_) {
+        is_host_timing = is_host_timing_;
+    }
+
+    bool IsHostTiming() const {
+        return is_host_timing;
+    }
+
     /// After the first Advance, the slice lengths and the downcount will be reduced whenever an
     /// event is scheduled earlier than the current values.
     ///
     /// Scheduling from a callback will not update the downcount until the Advance() completes.
+    ///
+    /// When called from a thread other than the one that drives Advance(), this behaves like
+    /// ScheduleEventThreadsafe.
     void ScheduleEvent(s64 cycles_into_future, const std::shared_ptr<EventType>& event_type,
                        u64 userdata = 0);
 
+    /// Schedules an event from a thread other than the emu thread (e.g. the GPU thread).
+    /// The event is staged in a lock-free queue and only enters the event queue on the next
+    /// Advance(), so cycles_into_future is relative to that point in time.
+    void ScheduleEventThreadsafe(s64 cycles_into_future,
+                                 const std::shared_ptr<EventType>& event_type, u64 userdata = 0);
+
+    /// When called from a thread other than the one that drives Advance(), the removal is deferred
+    /// to the next Advance(). This also applies to RemoveEvent.
     void UnscheduleEvent(const std::shared_ptr<EventType>& event_type, u64 userdata);
 
-    /// We only permit one event of each type in the queue at a time.
+    /// Removes every pending event of the given type, regardless of userdata.
     void RemoveEvent(const std::shared_ptr<EventType>& event_type);
 
     void ForceExceptionCheck(s64 cycles);
@@ -99,6 +139,8 @@ public:
 
     s64 GetDowncount() const;
 
+    /// Sets the context of the calling host thread. Contexts are tracked per host thread, so in
+    /// multicore mode each core thread only has to do this once.
     void SwitchContext(u64 new_context) {
         current_context = new_context;
     }
@@ -109,13 +151,53 @@ public:
 
     std::optional<u64> NextAvailableCore(const s64 needed_ticks) const;
 
+    /// Pending events and the state of the timer, see Core::SaveState.
+    struct Snapshot {
+        struct PendingEvent {
+            s64 time;
+            u64 fifo_order;
+            u64 userdata;
+            std::weak_ptr<EventType> type;
+        };
+
+        std::vector<PendingEvent> events;
+        u64 ticks;
+        s64 global_timer;
+        s64 idled_cycles;
+        s64 slice_length;
+        u64 accumulated_ticks;
+        std::array<s64, num_cpu_cores> downcounts;
+        std::array<s64, num_cpu_cores> time_slice;
+        u64 event_fifo_id;
+        bool is_global_timer_sane;
+    };
+
+    /// Has to be called from the thread that drives Advance(), like Advance() itself.
+    Snapshot TakeSnapshot();
+
+    /// Replaces the pending events with the ones of the snapshot, dropping the events staged by
+    /// other threads. With host timing the guest time can't go back, so the events are moved
+    /// forward by the time that passed since the snapshot instead.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
 private:
     struct Event;
+    struct StagedOperation;
+    class EventQueue;
 
     /// Clear all pending events. This should ONLY be done on exit.
     void ClearPendingEvents();
 
-    static constexpr u64 num_cpu_cores = 4;
+    /// Applies the operations staged by other threads to the event queue.
+    void MoveEvents();
+
+    /// Returns whether the calling thread is allowed to touch the event queue directly.
+    bool IsTimingThread() const;
+
+    /// Returns whether the current context advances the global timer.
+    bool IsTimingContext() const {
+        return !is_multicore || current_context == 0;
+    }
 
     s64 global_timer = 0;
     s64 idled_cycles = 0;
@@ -124,23 +206,32 @@ private:
     std::array<s64, num_cpu_cores> downcounts{};
     // Slice of time assigned to each core per run.
     std::array<s64, num_cpu_cores> time_slice{};
-    u64 current_context = 0;
+    static thread_local u64 current_context;
+
+    bool is_multicore = false;
+
+    bool is_host_timing = false;
+    std::unique_ptr<Common::WallClock> clock;
+    s64 max_slice_length = 0;
+
+    // Host thread that last called Advance(). Until the first Advance() any thread is accepted.
+    std::atomic<std::thread::id> timing_thread{};
 
     // Are we in a function that has been called from Advance()
     // If events are scheduled from a function that gets called from Advance(),
     // don't change slice_length and downcount.
     bool is_global_timer_sane = false;
 
-    // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-    // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-    // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-    // accomodated by the standard adaptor class.
-    std::vector<Event> event_queue;
+    // The queue is a pairing heap that also indexes its pending events by type, so that
+    // scheduling is O(1) and unscheduling doesn't need to scan or re-heapify the whole queue.
+    std::unique_ptr<EventQueue> event_queue;
     u64 event_fifo_id = 0;
 
-    std::shared_ptr<EventType> ev_lost;
+    // Operations requested from other threads, the event queue itself is only ever touched by the
+    // timing thread. The time of each staged event is relative to the Advance() that drains it.
+    Common::MPSCQueue<StagedOperation> ts_queue;
 
-    std::mutex inner_mutex;
+    std::shared_ptr<EventType> ev_lost;
 };
 
 /// Creates a core timing event with the given name and callback.
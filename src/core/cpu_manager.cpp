@@ -2,25 +2,61 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <fmt/format.h>
+
+#include "common/thread.h"
+#include "common/trace.h"
 #include "core/arm/exclusive_monitor.h"
 #include "core/core.h"
 #include "core/core_manager.h"
 #include "core/core_timing.h"
 #include "core/cpu_manager.h"
 #include "core/gdbstub/gdbstub.h"
+#include "core/settings.h"
 
 namespace Core {
 
+namespace {
+/// Index of the core emulated by the calling host thread, only used in multicore mode.
+thread_local std::size_t thread_core_index = 0;
+} // Anonymous namespace
+
 CpuManager::CpuManager(System& system) : system{system} {}
 CpuManager::~CpuManager() = default;
 
 void CpuManager::Initialize() {
+    is_multicore = Settings::values.use_multi_core;
+    system.CoreTiming().SetMultiCore(is_multicore);
+
     for (std::size_t index = 0; index < core_managers.size(); ++index) {
         core_managers[index] = std::make_unique<CoreManager>(system, index);
     }
+
+    if (!is_multicore) {
+        return;
+    }
+
+    // Core 0 keeps running on the thread that calls RunLoop, every other core gets its own.
+    round_start_barrier = std::make_unique<Common::Barrier>(NUM_CPU_CORES);
+    round_end_barrier = std::make_unique<Common::Barrier>(NUM_CPU_CORES);
+    cores_running = true;
+    for (std::size_t index = 0; index < secondary_threads.size(); ++index) {
+        secondary_threads[index] = std::thread(&CpuManager::RunSecondaryCore, this, index + 1);
+    }
 }
 
 void CpuManager::Shutdown() {
+    if (cores_running.exchange(false)) {
+        // The secondary cores are parked on the start barrier whenever RunLoop isn't executing,
+        // release them so they can observe the shutdown.
+        round_start_barrier->Sync();
+        for (auto& thread : secondary_threads) {
+            thread.join();
+        }
+    }
+    round_start_barrier.reset();
+    round_end_barrier.reset();
+
     for (auto& cpu_core : core_managers) {
         cpu_core.reset();
     }
@@ -35,15 +71,27 @@ const CoreManager& CpuManager::GetCoreManager(std::size_t index) const {
 }
 
 CoreManager& CpuManager::GetCurrentCoreManager() {
+    if (is_multicore) {
+        return *core_managers[thread_core_index];
+    }
+
     // Otherwise, use single-threaded mode active_core variable
     return *core_managers[active_core];
 }
 
 const CoreManager& CpuManager::GetCurrentCoreManager() const {
+    if (is_multicore) {
+        return *core_managers[thread_core_index];
+    }
+
     // Otherwise, use single-threaded mode active_core variable
     return *core_managers[active_core];
 }
 
+std::size_t CpuManager::GetActiveCoreIndex() const {
+    return is_multicore ? thread_core_index : active_core;
+}
+
 void CpuManager::RunLoop(bool tight_loop) {
     if (GDBStub::IsServerEnabled()) {
         GDBStub::HandlePacket();
@@ -59,6 +107,18 @@ void CpuManager::RunLoop(bool tight_loop) {
         }
     }
 
+    if (is_multicore) {
+        MultiCoreRunLoop(tight_loop);
+    } else {
+        SingleCoreRunLoop(tight_loop);
+    }
+
+    if (GDBStub::IsServerEnabled()) {
+        GDBStub::SetCpuStepFlag(false);
+    }
+}
+
+void CpuManager::SingleCoreRunLoop(bool tight_loop) {
     auto& core_timing = system.CoreTiming();
     core_timing.ResetRun();
     bool keep_running{};
@@ -72,9 +132,40 @@ void CpuManager::RunLoop(bool tight_loop) {
             keep_running |= core_timing.CanCurrentContextRun();
         }
     } while (keep_running);
+}
 
-    if (GDBStub::IsServerEnabled()) {
-        GDBStub::SetCpuStepFlag(false);
+void CpuManager::MultiCoreRunLoop(bool tight_loop) {
+    // Every core gets a fresh slice while the secondary cores are parked, then all of them run it
+    // concurrently. Idle cores pick up work from the other cores' suggested queues when they
+    // reschedule.
+    system.CoreTiming().ResetRun();
+    round_start_barrier->Sync();
+    RunCoreSlice(0, tight_loop);
+    round_end_barrier->Sync();
+}
+
+void CpuManager::RunCoreSlice(std::size_t core, bool tight_loop) {
+    auto& core_timing = system.CoreTiming();
+    core_timing.SwitchContext(core);
+    while (core_timing.CanCurrentContextRun()) {
+        core_managers[core]->RunLoop(tight_loop);
+    }
+}
+
+void CpuManager::RunSecondaryCore(std::size_t core) {
+    const std::string name = fmt::format("yuzu:CPUCore_{}", core);
+    Common::SetCurrentThreadName(name.c_str());
+    Common::Trace::SetCurrentThreadName(name);
+    System::SetCurrentInstance(system);
+    thread_core_index = core;
+
+    while (true) {
+        round_start_barrier->Sync();
+        if (!cores_running) {
+            return;
+        }
+        RunCoreSlice(core, true);
+        round_end_barrier->Sync();
     }
 }
 
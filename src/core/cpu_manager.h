@@ -5,7 +5,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
+
+namespace Common {
+class Barrier;
+}
 
 namespace Core {
 
@@ -32,8 +38,12 @@ public:
     CoreManager& GetCurrentCoreManager();
     const CoreManager& GetCurrentCoreManager() const;
 
-    std::size_t GetActiveCoreIndex() const {
-        return active_core;
+    /// Returns the index of the core being emulated. In multicore mode, this is the core that
+    /// belongs to the calling host thread.
+    std::size_t GetActiveCoreIndex() const;
+
+    bool IsMultiCore() const {
+        return is_multicore;
     }
 
     void RunLoop(bool tight_loop);
@@ -41,9 +51,25 @@ public:
 private:
     static constexpr std::size_t NUM_CPU_CORES = 4;
 
+    void SingleCoreRunLoop(bool tight_loop);
+    void MultiCoreRunLoop(bool tight_loop);
+
+    /// Runs the given core until its timing slice is exhausted.
+    void RunCoreSlice(std::size_t core, bool tight_loop);
+
+    /// Entry point of the host threads that emulate the secondary cores in multicore mode.
+    void RunSecondaryCore(std::size_t core);
+
     std::array<std::unique_ptr<CoreManager>, NUM_CPU_CORES> core_managers;
     std::size_t active_core{}; ///< Active core, only used in single thread mode
 
+    bool is_multicore = false;
+    std::atomic<bool> cores_running{false};
+    /// Synchronizes the start and the end of every round of slices across all cores.
+    std::unique_ptr<Common::Barrier> round_start_barrier;
+    std::unique_ptr<Common::Barrier> round_end_barrier;
+    std::array<std::thread, NUM_CPU_CORES - 1> secondary_threads;
+
     System& system;
 };
 
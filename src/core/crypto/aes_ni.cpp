@@ -0,0 +1,271 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#include "common/assert.h"
+#include "common/swap.h"
+#include "common/x64/cpu_detect.h"
+#include "core/crypto/aes_ni.h"
+
+namespace Core::Crypto::AESNI {
+namespace {
+
+/// Number of blocks kept in flight. The round instructions have a latency of several cycles but
+/// can be issued every cycle, so independent blocks are interleaved to keep the unit busy.
+constexpr std::size_t PARALLEL_BLOCKS = 8;
+
+constexpr std::size_t BLOCK_SIZE = sizeof(Block);
+
+__m128i Load(const u8* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+void Store(u8* data, __m128i value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value);
+}
+
+__m128i ShiftXor(__m128i value) {
+    value = _mm_xor_si128(value, _mm_slli_si128(value, 4));
+    value = _mm_xor_si128(value, _mm_slli_si128(value, 4));
+    return _mm_xor_si128(value, _mm_slli_si128(value, 4));
+}
+
+template <int rcon>
+__m128i ExpandKey128Step(__m128i key) {
+    const __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, rcon), 0xFF);
+    return _mm_xor_si128(ShiftXor(key), assist);
+}
+
+template <int rcon>
+void ExpandKey256Step(__m128i& even, __m128i& odd) {
+    even = _mm_xor_si128(ShiftXor(even),
+                         _mm_shuffle_epi32(_mm_aeskeygenassist_si128(odd, rcon), 0xFF));
+    odd = _mm_xor_si128(ShiftXor(odd),
+                        _mm_shuffle_epi32(_mm_aeskeygenassist_si128(even, 0), 0xAA));
+}
+
+void ExpandKey128(const u8* key, __m128i* round_keys) {
+    round_keys[0] = Load(key);
+    round_keys[1] = ExpandKey128Step<0x01>(round_keys[0]);
+    round_keys[2] = ExpandKey128Step<0x02>(round_keys[1]);
+    round_keys[3] = ExpandKey128Step<0x04>(round_keys[2]);
+    round_keys[4] = ExpandKey128Step<0x08>(round_keys[3]);
+    round_keys[5] = ExpandKey128Step<0x10>(round_keys[4]);
+    round_keys[6] = ExpandKey128Step<0x20>(round_keys[5]);
+    round_keys[7] = ExpandKey128Step<0x40>(round_keys[6]);
+    round_keys[8] = ExpandKey128Step<0x80>(round_keys[7]);
+    round_keys[9] = ExpandKey128Step<0x1B>(round_keys[8]);
+    round_keys[10] = ExpandKey128Step<0x36>(round_keys[9]);
+}
+
+void ExpandKey256(const u8* key, __m128i* round_keys) {
+    __m128i even = Load(key);
+    __m128i odd = Load(key + BLOCK_SIZE);
+    round_keys[0] = even;
+    round_keys[1] = odd;
+    ExpandKey256Step<0x01>(even, odd);
+    round_keys[2] = even;
+    round_keys[3] = odd;
+    ExpandKey256Step<0x02>(even, odd);
+    round_keys[4] = even;
+    round_keys[5] = odd;
+    ExpandKey256Step<0x04>(even, odd);
+    round_keys[6] = even;
+    round_keys[7] = odd;
+    ExpandKey256Step<0x08>(even, odd);
+    round_keys[8] = even;
+    round_keys[9] = odd;
+    ExpandKey256Step<0x10>(even, odd);
+    round_keys[10] = even;
+    round_keys[11] = odd;
+    ExpandKey256Step<0x20>(even, odd);
+    round_keys[12] = even;
+    round_keys[13] = odd;
+    // The last round only needs the even half
+    round_keys[14] = _mm_xor_si128(
+        ShiftXor(even), _mm_shuffle_epi32(_mm_aeskeygenassist_si128(odd, 0x40), 0xFF));
+}
+
+/// Round keys loaded into registers for the duration of a transcode.
+struct RoundKeys {
+    explicit RoundKeys(const std::array<Block, 15>& keys, std::size_t rounds_) : rounds{rounds_} {
+        for (std::size_t i = 0; i <= rounds; ++i) {
+            values[i] = Load(keys[i].data());
+        }
+    }
+
+    __m128i values[15];
+    std::size_t rounds;
+};
+
+template <std::size_t N>
+void EncryptBlocks(const RoundKeys& keys, __m128i (&blocks)[N]) {
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_xor_si128(blocks[i], keys.values[0]);
+    }
+    for (std::size_t round = 1; round < keys.rounds; ++round) {
+        const __m128i key = keys.values[round];
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] = _mm_aesenc_si128(blocks[i], key);
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_aesenclast_si128(blocks[i], keys.values[keys.rounds]);
+    }
+}
+
+template <std::size_t N>
+void DecryptBlocks(const RoundKeys& keys, __m128i (&blocks)[N]) {
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_xor_si128(blocks[i], keys.values[0]);
+    }
+    for (std::size_t round = 1; round < keys.rounds; ++round) {
+        const __m128i key = keys.values[round];
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] = _mm_aesdec_si128(blocks[i], key);
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_aesdeclast_si128(blocks[i], keys.values[keys.rounds]);
+    }
+}
+
+/// Multiplies an XTS tweak by the primitive element of GF(2^128), as a little endian number.
+__m128i MultiplyTweak(__m128i tweak) {
+    // Carries out of bit 63 move into bit 64, carries out of bit 127 reduce into the low byte
+    const __m128i reduction = _mm_set_epi32(0, 1, 0, 0x87);
+    const __m128i carries = _mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), 0x13);
+    return _mm_xor_si128(_mm_add_epi64(tweak, tweak), _mm_and_si128(carries, reduction));
+}
+
+} // Anonymous namespace
+
+bool IsSupported() {
+    const auto& caps = Common::GetCPUCaps();
+    return caps.aes && caps.ssse3;
+}
+
+KeySchedule ExpandKey(const u8* key, std::size_t key_size) {
+    ASSERT(key_size == 0x10 || key_size == 0x20);
+
+    __m128i round_keys[15];
+    KeySchedule schedule{};
+    if (key_size == 0x10) {
+        ExpandKey128(key, round_keys);
+        schedule.rounds = 10;
+    } else {
+        ExpandKey256(key, round_keys);
+        schedule.rounds = 14;
+    }
+
+    // The equivalent inverse cipher runs the round keys backwards, through InvMixColumns
+    const std::size_t rounds = schedule.rounds;
+    for (std::size_t i = 0; i <= rounds; ++i) {
+        Store(schedule.encryption[i].data(), round_keys[i]);
+        const bool is_edge = i == 0 || i == rounds;
+        const __m128i inverse = is_edge ? round_keys[i] : _mm_aesimc_si128(round_keys[i]);
+        Store(schedule.decryption[rounds - i].data(), inverse);
+    }
+    return schedule;
+}
+
+void CTRTranscode(const KeySchedule& key, Block& counter, const u8* src, std::size_t size,
+                  u8* dest) {
+    const RoundKeys keys{key.encryption, key.rounds};
+    const __m128i byte_swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    // Keep the counter as a native 128-bit integer, swapping it to big endian for every block
+    u64 high;
+    u64 low;
+    std::memcpy(&high, counter.data(), sizeof(high));
+    std::memcpy(&low, counter.data() + sizeof(high), sizeof(low));
+    high = Common::swap64(high);
+    low = Common::swap64(low);
+
+    const auto next_counter = [&] {
+        const __m128i value = _mm_shuffle_epi8(
+            _mm_set_epi64x(static_cast<s64>(high), static_cast<s64>(low)), byte_swap);
+        high += ++low == 0 ? 1 : 0;
+        return value;
+    };
+
+    std::size_t offset = 0;
+    for (; offset + PARALLEL_BLOCKS * BLOCK_SIZE <= size; offset += PARALLEL_BLOCKS * BLOCK_SIZE) {
+        __m128i blocks[PARALLEL_BLOCKS];
+        for (auto& block : blocks) {
+            block = next_counter();
+        }
+        EncryptBlocks(keys, blocks);
+        for (std::size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+            const u8* const in = src + offset + i * BLOCK_SIZE;
+            Store(dest + offset + i * BLOCK_SIZE, _mm_xor_si128(blocks[i], Load(in)));
+        }
+    }
+    for (; offset < size; offset += BLOCK_SIZE) {
+        __m128i block[1] = {next_counter()};
+        EncryptBlocks(keys, block);
+        if (size - offset >= BLOCK_SIZE) {
+            Store(dest + offset, _mm_xor_si128(block[0], Load(src + offset)));
+            continue;
+        }
+        // A partial block at the end uses as much of the key stream as it needs
+        Block stream;
+        Store(stream.data(), block[0]);
+        for (std::size_t i = 0; i < size - offset; ++i) {
+            dest[offset + i] = src[offset + i] ^ stream[i];
+        }
+    }
+
+    high = Common::swap64(high);
+    low = Common::swap64(low);
+    std::memcpy(counter.data(), &high, sizeof(high));
+    std::memcpy(counter.data() + sizeof(high), &low, sizeof(low));
+}
+
+void XTSTranscode(const KeySchedule& data_key, const KeySchedule& tweak_key,
+                  const Block& data_unit, const u8* src, std::size_t size, u8* dest, bool encrypt) {
+    ASSERT_MSG(size % BLOCK_SIZE == 0, "XTS data unit size must be a multiple of the block size.");
+
+    const RoundKeys keys{encrypt ? data_key.encryption : data_key.decryption, data_key.rounds};
+    __m128i tweak;
+    {
+        const RoundKeys tweak_keys{tweak_key.encryption, tweak_key.rounds};
+        __m128i block[1] = {Load(data_unit.data())};
+        EncryptBlocks(tweak_keys, block);
+        tweak = block[0];
+    }
+
+    const auto transcode = [&](auto& blocks) {
+        if (encrypt) {
+            EncryptBlocks(keys, blocks);
+        } else {
+            DecryptBlocks(keys, blocks);
+        }
+    };
+
+    std::size_t offset = 0;
+    for (; offset + PARALLEL_BLOCKS * BLOCK_SIZE <= size; offset += PARALLEL_BLOCKS * BLOCK_SIZE) {
+        __m128i tweaks[PARALLEL_BLOCKS];
+        __m128i blocks[PARALLEL_BLOCKS];
+        for (std::size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+            tweaks[i] = tweak;
+            blocks[i] = _mm_xor_si128(Load(src + offset + i * BLOCK_SIZE), tweak);
+            tweak = MultiplyTweak(tweak);
+        }
+        transcode(blocks);
+        for (std::size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+            Store(dest + offset + i * BLOCK_SIZE, _mm_xor_si128(blocks[i], tweaks[i]));
+        }
+    }
+    for (; offset < size; offset += BLOCK_SIZE) {
+        __m128i block[1] = {_mm_xor_si128(Load(src + offset), tweak)};
+        transcode(block);
+        Store(dest + offset, _mm_xor_si128(block[0], tweak));
+        tweak = MultiplyTweak(tweak);
+    }
+}
+
+} // namespace Core::Crypto::AESNI
@@ -2,16 +2,22 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <cstring>
 #include <mbedtls/cipher.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include "core/crypto/aes_ni.h"
+#endif
+
 namespace Core::Crypto {
 namespace {
-std::vector<u8> CalculateNintendoTweak(std::size_t sector_id) {
-    std::vector<u8> out(0x10);
+std::array<u8, 0x10> CalculateNintendoTweak(std::size_t sector_id) {
+    std::array<u8, 0x10> out{};
     for (std::size_t i = 0xF; i <= 0xF; --i) {
         out[i] = sector_id & 0xFF;
         sector_id >>= 8;
@@ -34,6 +40,15 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+#ifdef ARCHITECTURE_x86_64
+    // CTR and XTS skip mbedtls when the host has AES-NI. For XTS, key is the data key.
+    bool use_aesni = false;
+    AESNI::KeySchedule key;
+    AESNI::KeySchedule tweak_key;
+    // mbedtls keeps a separate IV per direction, and CTR advances them independently
+    std::array<AESNI::Block, 2> iv{};
+#endif
 };
 
 template <typename Key, std::size_t KeySize>
@@ -55,6 +70,21 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+#ifdef ARCHITECTURE_x86_64
+    if (!AESNI::IsSupported()) {
+        return;
+    }
+    if (mode == Mode::CTR) {
+        ctx->use_aesni = true;
+        ctx->key = AESNI::ExpandKey(key.data(), KeySize);
+    } else if (mode == Mode::XTS && KeySize == 0x20) {
+        // XTS-AES-128 takes the data key from the first half and the tweak key from the second
+        ctx->use_aesni = true;
+        ctx->key = AESNI::ExpandKey(key.data(), KeySize / 2);
+        ctx->tweak_key = AESNI::ExpandKey(key.data() + KeySize / 2, KeySize / 2);
+    }
+#endif
 }
 
 template <typename Key, std::size_t KeySize>
@@ -68,10 +98,34 @@ void AESCipher<Key, KeySize>::SetIV(std::vector<u8> iv) {
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, iv.data(), iv.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, iv.data(), iv.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
+
+#ifdef ARCHITECTURE_x86_64
+    if (ctx->use_aesni) {
+        ASSERT(iv.size() == sizeof(AESNI::Block));
+        std::memcpy(ctx->iv[0].data(), iv.data(), iv.size());
+        ctx->iv[1] = ctx->iv[0];
+    }
+#endif
 }
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+#ifdef ARCHITECTURE_x86_64
+    if (ctx->use_aesni) {
+        const bool encrypt = op == Op::Encrypt;
+        AESNI::Block& iv = ctx->iv[encrypt ? 0 : 1];
+        if (mbedtls_cipher_get_cipher_mode(&ctx->encryption_context) == MBEDTLS_MODE_CTR) {
+            AESNI::CTRTranscode(ctx->key, iv, src, size, dest);
+            return;
+        }
+        if (size % sizeof(AESNI::Block) == 0) {
+            AESNI::XTSTranscode(ctx->key, ctx->tweak_key, iv, src, size, dest, encrypt);
+            return;
+        }
+        // Ciphertext stealing is left to mbedtls, which has the same IV
+    }
+#endif
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -118,8 +172,19 @@ void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8*
                                            std::size_t sector_id, std::size_t sector_size, Op op) {
     ASSERT_MSG(size % sector_size == 0, "XTS decryption size must be a multiple of sector size.");
 
+#ifdef ARCHITECTURE_x86_64
+    if (ctx->use_aesni && sector_size % sizeof(AESNI::Block) == 0) {
+        for (std::size_t i = 0; i < size; i += sector_size) {
+            AESNI::XTSTranscode(ctx->key, ctx->tweak_key, CalculateNintendoTweak(sector_id++),
+                                src + i, sector_size, dest + i, op == Op::Encrypt);
+        }
+        return;
+    }
+#endif
+
     for (std::size_t i = 0; i < size; i += sector_size) {
-        SetIV(CalculateNintendoTweak(sector_id++));
+        const auto tweak = CalculateNintendoTweak(sector_id++);
+        SetIV({tweak.begin(), tweak.end()});
         Transcode<u8, u8>(src + i, sector_size, dest + i, op);
     }
 }
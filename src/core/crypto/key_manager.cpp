@@ -9,6 +9,8 @@
 #include <fstream>
 #include <locale>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string_view>
 #include <tuple>
@@ -20,6 +22,7 @@
 #include "common/common_funcs.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/hex_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
@@ -483,26 +486,75 @@ std::optional<std::pair<Key128, Key128>> ParseTicket(const Ticket& ticket,
     return std::make_pair(rights_id, key_temp);
 }
 
-KeyManager::KeyManager() {
-    // Initialize keys
+namespace {
+
+/// Contents of a key file, read to check whether it changed since it was parsed
+struct KeyFileContents {
+    std::string path;
+    bool is_title_keys;
+    std::string contents;
+};
+
+/// Reads the key files KeyManager loads, in the order they are applied.
+std::vector<KeyFileContents> ReadKeyFiles() {
     const std::string hactool_keys_dir = FileUtil::GetHactoolConfigurationPath();
     const std::string yuzu_keys_dir = FileUtil::GetUserPath(FileUtil::UserPath::KeysDir);
-    if (Settings::values.use_dev_keys) {
-        dev_mode = true;
-        AttemptLoadKeyFile(yuzu_keys_dir, hactool_keys_dir, "dev.keys", false);
-        AttemptLoadKeyFile(yuzu_keys_dir, yuzu_keys_dir, "dev.keys_autogenerated", false);
-    } else {
-        dev_mode = false;
-        AttemptLoadKeyFile(yuzu_keys_dir, hactool_keys_dir, "prod.keys", false);
-        AttemptLoadKeyFile(yuzu_keys_dir, yuzu_keys_dir, "prod.keys_autogenerated", false);
+    const std::string base_name = Settings::values.use_dev_keys ? "dev.keys" : "prod.keys";
+
+    std::vector<KeyFileContents> files;
+    const auto read_file = [&files](const std::string& dir1, const std::string& dir2,
+                                    const std::string& filename, bool is_title_keys) {
+        std::string path = dir1 + DIR_SEP + filename;
+        if (!FileUtil::Exists(path)) {
+            path = dir2 + DIR_SEP + filename;
+            if (!FileUtil::Exists(path)) {
+                return;
+            }
+        }
+        KeyFileContents& file = files.emplace_back();
+        file.is_title_keys = is_title_keys;
+        FileUtil::ReadFileToString(true, path, file.contents);
+        file.path = std::move(path);
+    };
+    read_file(yuzu_keys_dir, hactool_keys_dir, base_name, false);
+    read_file(yuzu_keys_dir, yuzu_keys_dir, base_name + "_autogenerated", false);
+    read_file(yuzu_keys_dir, hactool_keys_dir, "title.keys", true);
+    read_file(yuzu_keys_dir, yuzu_keys_dir, "title.keys_autogenerated", true);
+    read_file(yuzu_keys_dir, hactool_keys_dir, "console.keys", false);
+    read_file(yuzu_keys_dir, yuzu_keys_dir, "console.keys_autogenerated", false);
+    return files;
+}
+
+} // Anonymous namespace
+
+KeyManager::KeyManager() {
+    // Parsing is what makes constructing a KeyManager expensive and it's done all over the place,
+    // so the keys parsed from files that didn't change are shared by the whole process
+    static std::mutex cache_mutex;
+    static std::optional<KeyManager> cache;
+    static u64 cache_hash = 0;
+
+    const std::vector<KeyFileContents> files = ReadKeyFiles();
+    u64 hash = Settings::values.use_dev_keys ? 1 : 0;
+    for (const KeyFileContents& file : files) {
+        hash = Common::HashValue(file.path.data(), file.path.size(), hash);
+        hash = Common::HashValue(file.contents.data(), file.contents.size(), hash);
     }
 
-    AttemptLoadKeyFile(yuzu_keys_dir, hactool_keys_dir, "title.keys", true);
-    AttemptLoadKeyFile(yuzu_keys_dir, yuzu_keys_dir, "title.keys_autogenerated", true);
-    AttemptLoadKeyFile(yuzu_keys_dir, hactool_keys_dir, "console.keys", false);
-    AttemptLoadKeyFile(yuzu_keys_dir, yuzu_keys_dir, "console.keys_autogenerated", false);
+    std::lock_guard lock{cache_mutex};
+    if (!cache || cache_hash != hash) {
+        KeyManager parsed{ParseTag{}};
+        for (const KeyFileContents& file : files) {
+            parsed.LoadFromString(file.contents, file.is_title_keys);
+        }
+        cache = std::move(parsed);
+        cache_hash = hash;
+    }
+    *this = *cache;
 }
 
+KeyManager::KeyManager(ParseTag) : dev_mode{Settings::values.use_dev_keys} {}
+
 static bool ValidCryptoRevisionString(std::string_view base, size_t begin, size_t length) {
     if (base.size() < begin + length)
         return false;
@@ -511,11 +563,14 @@ static bool ValidCryptoRevisionString(std::string_view base, size_t begin, size_
 }
 
 void KeyManager::LoadFromFile(const std::string& filename, bool is_title_keys) {
-    std::ifstream file;
-    OpenFStream(file, filename, std::ios_base::in);
-    if (!file.is_open())
+    std::string contents;
+    if (FileUtil::ReadFileToString(true, filename, contents) == 0)
         return;
+    LoadFromString(contents, is_title_keys);
+}
 
+void KeyManager::LoadFromString(const std::string& contents, bool is_title_keys) {
+    std::istringstream file{contents};
     std::string line;
     while (std::getline(file, line)) {
         std::vector<std::string> out;
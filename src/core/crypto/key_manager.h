@@ -223,6 +223,8 @@ bool operator<(const KeyIndex<KeyType>& lhs, const KeyIndex<KeyType>& rhs) {
 
 class KeyManager {
 public:
+    /// Loads the key files. The keys parsed from files that didn't change since the last
+    /// construction are reused instead of being parsed again.
     KeyManager();
 
     bool HasKey(S128KeyType id, u64 field1 = 0, u64 field2 = 0) const;
@@ -269,7 +271,13 @@ private:
     std::array<u8, 576> eticket_extended_kek{};
 
     bool dev_mode;
+
+    struct ParseTag {};
+    /// Creates a KeyManager without any keys, to parse the key files into.
+    explicit KeyManager(ParseTag);
+
     void LoadFromFile(const std::string& filename, bool is_title_keys);
+    void LoadFromString(const std::string& contents, bool is_title_keys);
     void AttemptLoadKeyFile(const std::string& dir1, const std::string& dir2,
                             const std::string& filename, bool title);
     template <size_t Size>
@@ -0,0 +1,86 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#include "core/crypto/sha_ni.h"
+
+namespace Core::Crypto::SHANI {
+namespace {
+
+constexpr std::size_t BLOCK_SIZE = 0x40;
+
+alignas(16) constexpr std::array<u32, 64> ROUND_CONSTANTS{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+} // Anonymous namespace
+
+bool IsSupported() {
+    const auto& caps = Common::GetCPUCaps();
+    return caps.sha && caps.sse4_1 && caps.ssse3;
+}
+
+void ProcessBlocks(std::array<u32, 8>& state, const u8* data, std::size_t num_blocks) {
+    // Message words are big endian
+    const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // The round instructions take the state as the ABEF and CDGH halves
+    const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&state[0])),
+                                           0xB1);
+    const __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&state[4])),
+                                           0x1B);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xF0);
+
+    for (; num_blocks > 0; --num_blocks, data += BLOCK_SIZE) {
+        const __m128i abef_save = abef;
+        const __m128i cdgh_save = cdgh;
+
+        __m128i messages[4];
+        const auto rounds = [&](std::size_t group) {
+            const __m128i constants = _mm_load_si128(
+                reinterpret_cast<const __m128i*>(ROUND_CONSTANTS.data() + group * 4));
+            __m128i message = _mm_add_epi32(messages[group % 4], constants);
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            message = _mm_shuffle_epi32(message, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+        };
+        const auto schedule = [&](std::size_t group) {
+            __m128i& message = messages[group % 4];
+            const __m128i previous = messages[(group + 3) % 4];
+            const __m128i sum = _mm_add_epi32(
+                _mm_sha256msg1_epu32(message, messages[(group + 1) % 4]),
+                _mm_alignr_epi8(previous, messages[(group + 2) % 4], 4));
+            message = _mm_sha256msg2_epu32(sum, previous);
+        };
+
+        for (std::size_t group = 0; group < 4; ++group) {
+            messages[group] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + group * 16)), byte_swap);
+            rounds(group);
+        }
+        for (std::size_t group = 4; group < 16; ++group) {
+            schedule(group);
+            rounds(group);
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+} // namespace Core::Crypto::SHANI
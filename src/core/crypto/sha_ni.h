@@ -0,0 +1,20 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
+
+/// SHA-256 implemented with the x86 SHA extensions. Only available on x86-64 hosts.
+namespace Core::Crypto::SHANI {
+
+/// Returns true when the host CPU supports the instructions used by this module.
+bool IsSupported();
+
+/// Runs the SHA-256 compression function over consecutive 64 byte blocks.
+void ProcessBlocks(std::array<u32, 8>& state, const u8* data, std::size_t num_blocks);
+
+} // namespace Core::Crypto::SHANI
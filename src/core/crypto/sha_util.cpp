@@ -2,4 +2,98 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-namespace Crypto {} // namespace Crypto
+#include <algorithm>
+#include <cstring>
+#include "common/swap.h"
+#include "core/crypto/sha_util.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include "core/crypto/sha_ni.h"
+#endif
+
+namespace Core::Crypto {
+
+SHA256Context::SHA256Context() {
+#ifdef ARCHITECTURE_x86_64
+    use_sha_ni = SHANI::IsSupported();
+    state = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+             0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+#endif
+    mbedtls_sha256_init(&context);
+    mbedtls_sha256_starts_ret(&context, 0);
+}
+
+SHA256Context::~SHA256Context() {
+    mbedtls_sha256_free(&context);
+}
+
+void SHA256Context::Update(const u8* data, std::size_t size) {
+#ifdef ARCHITECTURE_x86_64
+    if (use_sha_ni) {
+        UpdateSHANI(data, size);
+        return;
+    }
+#endif
+    mbedtls_sha256_update_ret(&context, data, size);
+}
+
+SHA256Hash SHA256Context::Finish() {
+#ifdef ARCHITECTURE_x86_64
+    if (use_sha_ni) {
+        return FinishSHANI();
+    }
+#endif
+    SHA256Hash hash;
+    mbedtls_sha256_finish_ret(&context, hash.data());
+    return hash;
+}
+
+#ifdef ARCHITECTURE_x86_64
+void SHA256Context::UpdateSHANI(const u8* data, std::size_t size) {
+    total_size += size;
+    if (pending_size != 0) {
+        const std::size_t copied = std::min(size, pending.size() - pending_size);
+        std::memcpy(pending.data() + pending_size, data, copied);
+        pending_size += copied;
+        data += copied;
+        size -= copied;
+        if (pending_size != pending.size()) {
+            return;
+        }
+        SHANI::ProcessBlocks(state, pending.data(), 1);
+        pending_size = 0;
+    }
+
+    const std::size_t num_blocks = size / pending.size();
+    SHANI::ProcessBlocks(state, data, num_blocks);
+    pending_size = size - num_blocks * pending.size();
+    std::memcpy(pending.data(), data + num_blocks * pending.size(), pending_size);
+}
+
+SHA256Hash SHA256Context::FinishSHANI() {
+    // Pad with a set bit and zeroes up to the bit length, stored big endian at the end of a block
+    const u64 bit_length = Common::swap64(total_size * 8);
+    std::array<u8, 0x80> padding{0x80};
+    const std::size_t padding_size =
+        (pending_size < pending.size() - sizeof(bit_length) ? pending.size() : padding.size()) -
+        pending_size;
+    std::memcpy(padding.data() + padding_size - sizeof(bit_length), &bit_length,
+                sizeof(bit_length));
+    UpdateSHANI(padding.data(), padding_size);
+
+    SHA256Hash hash;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        const u32 word = Common::swap32(state[i]);
+        std::memcpy(hash.data() + i * sizeof(word), &word, sizeof(word));
+    }
+    return hash;
+}
+#endif
+
+SHA256Hash CalculateSHA256(const u8* data, std::size_t size) {
+    SHA256Context context;
+    context.Update(data, size);
+    return context.Finish();
+}
+
+} // namespace Core::Crypto
@@ -4,17 +4,47 @@
 
 #pragma once
 
-#include "common/assert.h"
-#include "core/file_sys/vfs.h"
-#include "key_manager.h"
-#include "mbedtls/cipher.h"
+#include <array>
+#include <cstddef>
+#include <mbedtls/sha256.h>
+#include "common/common_types.h"
+#include "core/crypto/key_manager.h"
 
-namespace Crypto {
-typedef std::array<u8, 0x20> SHA256Hash;
+namespace Core::Crypto {
 
-inline SHA256Hash operator"" _HASH(const char* data, size_t len) {
-    if (len != 0x40)
-        return {};
-}
+/**
+ * Incremental SHA-256. Uses the SHA extensions of x86-64 hosts when they are available, which
+ * hash several times faster than mbedtls.
+ */
+class SHA256Context {
+public:
+    SHA256Context();
+    ~SHA256Context();
 
-} // namespace Crypto
+    SHA256Context(const SHA256Context&) = delete;
+    SHA256Context& operator=(const SHA256Context&) = delete;
+
+    void Update(const u8* data, std::size_t size);
+
+    /// Returns the hash of everything passed to Update. The context can't be used afterwards.
+    SHA256Hash Finish();
+
+private:
+#ifdef ARCHITECTURE_x86_64
+    void UpdateSHANI(const u8* data, std::size_t size);
+    SHA256Hash FinishSHANI();
+
+    bool use_sha_ni;
+    std::array<u32, 8> state;
+    std::array<u8, 0x40> pending; ///< Data that doesn't fill a block yet
+    std::size_t pending_size = 0;
+    u64 total_size = 0;
+#endif
+
+    mbedtls_sha256_context context;
+};
+
+/// Calculates the SHA-256 hash of a buffer.
+SHA256Hash CalculateSHA256(const u8* data, std::size_t size);
+
+} // namespace Core::Crypto
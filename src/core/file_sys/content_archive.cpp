@@ -6,7 +6,9 @@
 #include <cstring>
 #include <optional>
 #include <utility>
+#include <boost/functional/hash.hpp>
 
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/ctr_encryption_layer.h"
@@ -14,6 +16,7 @@
 #include "core/file_sys/nca_patch.h"
 #include "core/file_sys/partition_filesystem.h"
 #include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs_cached.h"
 #include "core/file_sys/vfs_offset.h"
 #include "core/loader/loader.h"
 
@@ -113,6 +116,17 @@ union NCASectionHeader {
 };
 static_assert(sizeof(NCASectionHeader) == 0x200, "NCASectionHeader has incorrect size.");
 
+// Identifies the decrypted contents of a section in the sector cache. The key is part of it so
+// contents read with a wrong key are never served once the right one is available.
+static u64 GetSectionContentID(const NCAHeader& header, const Core::Crypto::Key128& key,
+                               u64 offset, u64 base_content_id = 0) {
+    std::size_t seed = Common::ComputeStructHash64(header);
+    boost::hash_combine(seed, Common::ComputeHash64(key.data(), key.size()));
+    boost::hash_combine(seed, offset);
+    boost::hash_combine(seed, base_content_id);
+    return seed;
+}
+
 static bool IsValidNCA(const NCAHeader& header) {
     // TODO(DarkLordZach): Add NCA2/NCA0 support.
     return header.magic == Common::MakeMagic('N', 'C', 'A', '3');
@@ -209,10 +223,17 @@ std::vector<NCASectionHeader> NCA::ReadSectionHeaders() const {
     const auto length_sections = SECTION_HEADER_SIZE * number_sections;
 
     if (encrypted) {
-        auto raw = file->ReadBytes(length_sections, SECTION_HEADER_OFFSET);
+        // Decrypt straight out of the file when it can be viewed in place
+        std::vector<u8> raw;
+        const u8* source = file->GetDirectView(SECTION_HEADER_OFFSET, length_sections);
+        if (source == nullptr) {
+            raw = file->ReadBytes(length_sections, SECTION_HEADER_OFFSET);
+            raw.resize(length_sections);
+            source = raw.data();
+        }
         Core::Crypto::AESCipher<Core::Crypto::Key256> cipher(
             keys.GetKey(Core::Crypto::S256KeyType::Header), Core::Crypto::Mode::XTS);
-        cipher.XTSTranscode(raw.data(), length_sections, sections.data(), 2, SECTION_HEADER_SIZE,
+        cipher.XTSTranscode(source, length_sections, sections.data(), 2, SECTION_HEADER_SIZE,
                             Core::Crypto::Op::Decrypt);
     } else {
         file->ReadBytes(sections.data(), length_sections, SECTION_HEADER_OFFSET);
@@ -352,9 +373,18 @@ bool NCA::ReadRomFSSection(const NCASectionHeader& section, const NCASectionTabl
             encrypted ? *key : Core::Crypto::Key128{}, base_offset, bktr_base_ivfc_offset,
             section.raw.section_ctr);
 
+        // The patched contents depend on the base, so they can only be cached when it is
+        VirtualFile patched = bktr;
+        const auto cached_base = std::dynamic_pointer_cast<CachedVfsFile>(bktr_base_romfs);
+        if (encrypted && cached_base != nullptr) {
+            patched = std::make_shared<CachedVfsFile>(
+                std::move(patched),
+                GetSectionContentID(header, *key, base_offset, cached_base->GetContentID()));
+        }
+
         // BKTR applies to entire IVFC, so make an offset version to level 6
         files.push_back(std::make_shared<OffsetVfsFile>(
-            bktr, romfs_size, section.romfs.ivfc.levels[IVFC_MAX_LEVEL - 1].offset));
+            std::move(patched), romfs_size, section.romfs.ivfc.levels[IVFC_MAX_LEVEL - 1].offset));
     } else {
         files.push_back(std::move(dec));
     }
@@ -500,7 +530,9 @@ VirtualFile NCA::Decrypt(const NCASectionHeader& s_header, VirtualFile in, u64 s
             for (u8 i = 0; i < 8; ++i)
                 iv[i] = s_header.raw.section_ctr[0x8 - i - 1];
             out->SetIV(iv);
-            return std::static_pointer_cast<VfsFile>(out);
+            // Games read the same headers and file tables over and over, keep them decrypted
+            return std::make_shared<CachedVfsFile>(
+                std::move(out), GetSectionContentID(header, *key, starting_offset));
         }
     case NCASectionCryptoType::XTS:
         // TODO(DarkLordZach): Find a test case for XTS-encrypted NCAs
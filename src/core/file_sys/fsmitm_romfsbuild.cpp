@@ -22,7 +22,10 @@
  * Refer to the license.txt file included.
  */
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <mutex>
 #include <string_view>
 #include "common/alignment.h"
 #include "common/assert.h"
@@ -96,6 +99,9 @@ struct RomFSBuildFileContext {
     std::shared_ptr<RomFSBuildDirectoryContext> parent;
     std::shared_ptr<RomFSBuildFileContext> sibling;
     VirtualFile source;
+    // IPS patch of source, applied the first time the file is needed. Patches never change the
+    // size of the file, so the layout can be built without applying them.
+    VirtualFile ips;
 };
 
 static u32 romfs_calc_path_hash(u32 parent, std::string_view path, u32 start,
@@ -171,15 +177,8 @@ void RomFSBuildContext::VisitDirectory(VirtualDir root_romfs, VirtualDir ext,
 
             child->source = root_romfs->GetFileRelative(child->path);
 
-            if (ext != nullptr) {
-                const auto ips = ext->GetFileRelative(child->path + ".ips");
-
-                if (ips != nullptr) {
-                    auto patched = PatchIPS(child->source, ips);
-                    if (patched != nullptr)
-                        child->source = std::move(patched);
-                }
-            }
+            if (ext != nullptr)
+                child->ips = ext->GetFileRelative(child->path + ".ips");
 
             child->size = child->source->GetSize();
 
@@ -240,26 +239,24 @@ RomFSBuildContext::RomFSBuildContext(VirtualDir base_, VirtualDir ext_)
 
 RomFSBuildContext::~RomFSBuildContext() = default;
 
-std::map<u64, VirtualFile> RomFSBuildContext::Build() {
+static VirtualFile romfs_get_patched_source(const RomFSBuildFileContext& file) {
+    if (file.ips == nullptr)
+        return file.source;
+
+    auto patched = PatchIPS(file.source, file.ips);
+    return patched != nullptr ? patched : file.source;
+}
+
+void RomFSBuildContext::Layout() {
     const u64 dir_hash_table_entry_count = romfs_get_hash_table_count(num_dirs);
     const u64 file_hash_table_entry_count = romfs_get_hash_table_count(num_files);
     dir_hash_table_size = 4 * dir_hash_table_entry_count;
     file_hash_table_size = 4 * file_hash_table_entry_count;
 
-    // Assign metadata pointers
-    RomFSHeader header{};
-
-    std::vector<u32> dir_hash_table(dir_hash_table_entry_count, ROMFS_ENTRY_EMPTY);
-    std::vector<u32> file_hash_table(file_hash_table_entry_count, ROMFS_ENTRY_EMPTY);
-
-    std::vector<u8> dir_table(dir_table_size);
-    std::vector<u8> file_table(file_table_size);
-
     std::shared_ptr<RomFSBuildFileContext> cur_file;
 
     // Determine file offsets.
     u32 entry_offset = 0;
-    std::shared_ptr<RomFSBuildFileContext> prev_file = nullptr;
     for (const auto& it : files) {
         cur_file = it.second;
         file_partition_size = Common::AlignUp(file_partition_size, 16);
@@ -268,7 +265,6 @@ std::map<u64, VirtualFile> RomFSBuildContext::Build() {
         cur_file->entry_offset = entry_offset;
         entry_offset += sizeof(RomFSFileEntry) +
                         Common::AlignUp(cur_file->path_len - cur_file->cur_path_ofs, 4);
-        prev_file = cur_file;
     }
     // Assign deferred parent/sibling ownership.
     for (auto it = files.rbegin(); it != files.rend(); ++it) {
@@ -293,12 +289,38 @@ std::map<u64, VirtualFile> RomFSBuildContext::Build() {
         cur_dir->sibling = cur_dir->parent->child;
         cur_dir->parent->child = cur_dir;
     }
+}
 
-    std::map<u64, VirtualFile> out;
+static RomFSHeader romfs_make_header(u64 file_partition_size, u64 dir_hash_table_size,
+                                     u64 dir_table_size, u64 file_hash_table_size,
+                                     u64 file_table_size) {
+    RomFSHeader header{};
+    header.header_size = sizeof(RomFSHeader);
+    header.file_hash_table_size = file_hash_table_size;
+    header.file_table_size = file_table_size;
+    header.dir_hash_table_size = dir_hash_table_size;
+    header.dir_table_size = dir_table_size;
+    header.file_partition_ofs = ROMFS_FILEPARTITION_OFS;
+    header.dir_hash_table_ofs = Common::AlignUp(header.file_partition_ofs + file_partition_size, 4);
+    header.dir_table_ofs = header.dir_hash_table_ofs + header.dir_hash_table_size;
+    header.file_hash_table_ofs = header.dir_table_ofs + header.dir_table_size;
+    header.file_table_ofs = header.file_hash_table_ofs + header.file_hash_table_size;
+    return header;
+}
+
+std::vector<u8> RomFSBuildContext::BuildMetadata() const {
+    const u64 dir_hash_table_entry_count = dir_hash_table_size / 4;
+    const u64 file_hash_table_entry_count = file_hash_table_size / 4;
+
+    std::vector<u32> dir_hash_table(dir_hash_table_entry_count, ROMFS_ENTRY_EMPTY);
+    std::vector<u32> file_hash_table(file_hash_table_entry_count, ROMFS_ENTRY_EMPTY);
+
+    std::vector<u8> dir_table(dir_table_size);
+    std::vector<u8> file_table(file_table_size);
 
     // Populate file tables.
     for (const auto& it : files) {
-        cur_file = it.second;
+        const auto& cur_file = it.second;
         RomFSFileEntry cur_entry{};
 
         cur_entry.parent = cur_file->parent->entry_offset;
@@ -315,7 +337,6 @@ std::map<u64, VirtualFile> RomFSBuildContext::Build() {
 
         cur_entry.name_size = name_size;
 
-        out.emplace(cur_file->offset + ROMFS_FILEPARTITION_OFS, cur_file->source);
         std::memcpy(file_table.data() + cur_file->entry_offset, &cur_entry, sizeof(RomFSFileEntry));
         std::memset(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry), 0,
                     Common::AlignUp(cur_entry.name_size, 4));
@@ -325,7 +346,7 @@ std::map<u64, VirtualFile> RomFSBuildContext::Build() {
 
     // Populate dir tables.
     for (const auto& it : directories) {
-        cur_dir = it.second;
+        const auto& cur_dir = it.second;
         RomFSDirectoryEntry cur_entry{};
 
         cur_entry.parent = cur_dir == root ? 0 : cur_dir->parent->entry_offset;
@@ -351,22 +372,6 @@ std::map<u64, VirtualFile> RomFSBuildContext::Build() {
                     cur_dir->path.data() + cur_dir->cur_path_ofs, name_size);
     }
 
-    // Set header fields.
-    header.header_size = sizeof(RomFSHeader);
-    header.file_hash_table_size = file_hash_table_size;
-    header.file_table_size = file_table_size;
-    header.dir_hash_table_size = dir_hash_table_size;
-    header.dir_table_size = dir_table_size;
-    header.file_partition_ofs = ROMFS_FILEPARTITION_OFS;
-    header.dir_hash_table_ofs = Common::AlignUp(header.file_partition_ofs + file_partition_size, 4);
-    header.dir_table_ofs = header.dir_hash_table_ofs + header.dir_hash_table_size;
-    header.file_hash_table_ofs = header.dir_table_ofs + header.dir_table_size;
-    header.file_table_ofs = header.file_hash_table_ofs + header.file_hash_table_size;
-
-    std::vector<u8> header_data(sizeof(RomFSHeader));
-    std::memcpy(header_data.data(), &header, header_data.size());
-    out.emplace(0, std::make_shared<VectorVfsFile>(std::move(header_data)));
-
     std::vector<u8> metadata(file_hash_table_size + file_table_size + dir_hash_table_size +
                              dir_table_size);
     std::size_t index = 0;
@@ -378,9 +383,186 @@ std::map<u64, VirtualFile> RomFSBuildContext::Build() {
                 file_hash_table.size() * sizeof(u32));
     index += file_hash_table.size() * sizeof(u32);
     std::memcpy(metadata.data() + index, file_table.data(), file_table.size());
-    out.emplace(header.dir_hash_table_ofs, std::make_shared<VectorVfsFile>(std::move(metadata)));
+    return metadata;
+}
+
+std::map<u64, VirtualFile> RomFSBuildContext::Build() {
+    Layout();
+
+    std::map<u64, VirtualFile> out;
+    for (const auto& it : files) {
+        out.emplace(it.second->offset + ROMFS_FILEPARTITION_OFS,
+                    romfs_get_patched_source(*it.second));
+    }
+
+    const RomFSHeader header =
+        romfs_make_header(file_partition_size, dir_hash_table_size, dir_table_size,
+                          file_hash_table_size, file_table_size);
+    std::vector<u8> header_data(sizeof(RomFSHeader));
+    std::memcpy(header_data.data(), &header, header_data.size());
+    out.emplace(0, std::make_shared<VectorVfsFile>(std::move(header_data)));
+    out.emplace(header.dir_hash_table_ofs, std::make_shared<VectorVfsFile>(BuildMetadata()));
 
     return out;
 }
 
+// RomFS image served straight out of a build context. Reads of the file partition go to the
+// source of every file, found with a binary search, and the tables are only serialized when a
+// read first reaches them. Gaps between the pieces read as zeroes.
+class LazyRomFSFile : public VfsFile {
+public:
+    LazyRomFSFile(std::shared_ptr<RomFSBuildContext> context_, std::string name_)
+        : context(std::move(context_)), name(std::move(name_)),
+          header(romfs_make_header(context->file_partition_size, context->dir_hash_table_size,
+                                   context->dir_table_size, context->file_hash_table_size,
+                                   context->file_table_size)) {
+        extents.reserve(context->files.size());
+        for (const auto& it : context->files) {
+            extents.push_back({it.second->offset + ROMFS_FILEPARTITION_OFS, it.second->size,
+                               it.second, it.second->ips != nullptr});
+        }
+        // Files are laid out in path order, which is the order of the map, so this is sorted
+        metadata_offset = header.dir_hash_table_ofs;
+        size = header.file_table_ofs + header.file_table_size;
+    }
+
+    std::string GetName() const override {
+        return name;
+    }
+
+    std::size_t GetSize() const override {
+        return size;
+    }
+
+    bool Resize(std::size_t new_size) override {
+        return false;
+    }
+
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override {
+        return nullptr;
+    }
+
+    bool IsWritable() const override {
+        return false;
+    }
+
+    bool IsReadable() const override {
+        return true;
+    }
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        if (offset >= size)
+            return 0;
+        length = std::min<std::size_t>(length, size - offset);
+
+        const u64 end = offset + length;
+        u64 cursor = offset;
+        // Reads the part of a piece of the image that overlaps the request, zero filling the gap
+        // before it and whatever the piece falls short of.
+        const auto read_piece = [&](u64 piece_offset, u64 piece_size, const auto& read_func) {
+            const u64 begin = std::max<u64>(piece_offset, cursor);
+            const u64 piece_end = std::min<u64>(piece_offset + piece_size, end);
+            if (begin >= piece_end)
+                return;
+            u8* const out = data + (begin - offset);
+            std::memset(data + (cursor - offset), 0, begin - cursor);
+            const std::size_t read = read_func(out, piece_end - begin, begin - piece_offset);
+            std::memset(out + read, 0, piece_end - begin - read);
+            cursor = piece_end;
+        };
+
+        read_piece(0, sizeof(RomFSHeader), [this](u8* out, std::size_t len, std::size_t ofs) {
+            std::memcpy(out, reinterpret_cast<const u8*>(&header) + ofs, len);
+            return len;
+        });
+
+        for (auto it = FindExtent(offset); it != extents.end() && it->offset < end; ++it) {
+            const auto source = GetSource(*it);
+            read_piece(it->offset, it->size, [&source](u8* out, std::size_t len, std::size_t ofs) {
+                return source->Read(out, len, ofs);
+            });
+        }
+
+        if (end > metadata_offset) {
+            const auto& metadata = GetMetadata();
+            read_piece(metadata_offset, metadata.size(),
+                       [&metadata](u8* out, std::size_t len, std::size_t ofs) {
+                           std::memcpy(out, metadata.data() + ofs, len);
+                           return len;
+                       });
+        }
+
+        std::memset(data + (cursor - offset), 0, end - cursor);
+        return length;
+    }
+
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override {
+        return 0;
+    }
+
+    bool Rename(std::string_view name) override {
+        return false;
+    }
+
+    const u8* GetDirectView(std::size_t offset, std::size_t length) const override {
+        // Only ranges inside a single file can be viewed
+        const auto it = FindExtent(offset);
+        if (it == extents.end() || it->offset > offset || offset - it->offset > it->size ||
+            length > it->size - (offset - it->offset)) {
+            return nullptr;
+        }
+        return GetSource(*it)->GetDirectView(offset - it->offset, length);
+    }
+
+private:
+    struct Extent {
+        u64 offset;
+        u64 size;
+        std::shared_ptr<RomFSBuildFileContext> file;
+        bool has_patch;
+    };
+
+    /// Returns the last file starting at or before offset, or the first file if there is none.
+    std::vector<Extent>::const_iterator FindExtent(u64 offset) const {
+        auto it = std::upper_bound(extents.begin(), extents.end(), offset,
+                                   [](u64 value, const Extent& extent) {
+                                       return value < extent.offset;
+                                   });
+        return it == extents.begin() ? it : std::prev(it);
+    }
+
+    VirtualFile GetSource(const Extent& extent) const {
+        if (!extent.has_patch)
+            return extent.file->source;
+
+        std::lock_guard lock{patch_mutex};
+        if (extent.file->ips != nullptr) {
+            extent.file->source = romfs_get_patched_source(*extent.file);
+            extent.file->ips = nullptr;
+        }
+        return extent.file->source;
+    }
+
+    const std::vector<u8>& GetMetadata() const {
+        std::call_once(metadata_flag, [this] { metadata = context->BuildMetadata(); });
+        return metadata;
+    }
+
+    std::shared_ptr<RomFSBuildContext> context;
+    std::string name;
+    RomFSHeader header;
+    u64 metadata_offset;
+    std::size_t size;
+    std::vector<Extent> extents;
+
+    mutable std::mutex patch_mutex;
+    mutable std::once_flag metadata_flag;
+    mutable std::vector<u8> metadata;
+};
+
+VirtualFile RomFSBuildContext::BuildLazy(std::string name) {
+    Layout();
+    return std::make_shared<LazyRomFSFile>(shared_from_this(), std::move(name));
+}
+
 } // namespace FileSys
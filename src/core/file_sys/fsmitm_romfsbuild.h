@@ -27,6 +27,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include "common/common_types.h"
 #include "core/file_sys/vfs.h"
 
@@ -37,7 +38,7 @@ struct RomFSBuildFileContext;
 struct RomFSDirectoryEntry;
 struct RomFSFileEntry;
 
-class RomFSBuildContext {
+class RomFSBuildContext : public std::enable_shared_from_this<RomFSBuildContext> {
 public:
     explicit RomFSBuildContext(VirtualDir base, VirtualDir ext = nullptr);
     ~RomFSBuildContext();
@@ -45,7 +46,14 @@ public:
     // This finalizes the context.
     std::map<u64, VirtualFile> Build();
 
+    // This finalizes the context into a single RomFS file without materializing it. The tables are
+    // only serialized when they are first read and file data is read straight from the sources,
+    // so the context must be owned by a shared_ptr that the returned file keeps alive.
+    VirtualFile BuildLazy(std::string name);
+
 private:
+    friend class LazyRomFSFile;
+
     VirtualDir base;
     VirtualDir ext;
     std::shared_ptr<RomFSBuildDirectoryContext> root;
@@ -66,6 +74,11 @@ private:
                       std::shared_ptr<RomFSBuildDirectoryContext> dir_ctx);
     bool AddFile(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
                  std::shared_ptr<RomFSBuildFileContext> file_ctx);
+
+    // Assigns the offsets of every file and entry and links up the directory tree.
+    void Layout();
+    // Serializes the hash tables and entry tables, in the order they appear after the files.
+    std::vector<u8> BuildMetadata() const;
 };
 
 } // namespace FileSys
@@ -7,67 +7,145 @@
 #include <cstring>
 
 #include "common/assert.h"
-#include "core/crypto/aes_util.h"
 #include "core/file_sys/nca_patch.h"
 
 namespace FileSys {
 
-BKTR::BKTR(VirtualFile base_romfs_, VirtualFile bktr_romfs_, RelocationBlock relocation_,
-           std::vector<RelocationBucket> relocation_buckets_, SubsectionBlock subsection_,
-           std::vector<SubsectionBucket> subsection_buckets_, bool is_encrypted_,
+namespace {
+
+/// Returns the index of the entry that contains offset, ignoring the end marker.
+template <typename Entry>
+std::size_t FindEntry(const std::vector<Entry>& entries, u64 offset) {
+    const auto it = std::upper_bound(
+        entries.begin(), entries.end() - 1, offset,
+        [](u64 value, const Entry& entry) { return value < entry.address_patch; });
+    return it == entries.begin() ? 0 : static_cast<std::size_t>(it - entries.begin() - 1);
+}
+
+} // Anonymous namespace
+
+BKTR::BKTR(VirtualFile base_romfs_, VirtualFile bktr_romfs_, RelocationBlock relocation,
+           std::vector<RelocationBucket> relocation_buckets, SubsectionBlock subsection,
+           std::vector<SubsectionBucket> subsection_buckets, bool is_encrypted_,
            Core::Crypto::Key128 key_, u64 base_offset_, u64 ivfc_offset_,
            std::array<u8, 8> section_ctr_)
-    : relocation(relocation_), relocation_buckets(std::move(relocation_buckets_)),
-      subsection(subsection_), subsection_buckets(std::move(subsection_buckets_)),
-      base_romfs(std::move(base_romfs_)), bktr_romfs(std::move(bktr_romfs_)),
-      encrypted(is_encrypted_), key(key_), base_offset(base_offset_), ivfc_offset(ivfc_offset_),
+    : size(relocation.size), base_romfs(std::move(base_romfs_)),
+      bktr_romfs(std::move(bktr_romfs_)), encrypted(is_encrypted_),
+      cipher(key_, Core::Crypto::Mode::CTR), base_offset(base_offset_), ivfc_offset(ivfc_offset_),
       section_ctr(section_ctr_) {
-    for (std::size_t i = 0; i < relocation.number_buckets - 1; ++i) {
-        relocation_buckets[i].entries.push_back({relocation.base_offsets[i + 1], 0, 0});
+    // Buckets only exist to bound the size of a storage block, a single sorted list of entries
+    // is searched in one step without copying buckets around
+    for (std::size_t i = 0; i < relocation.number_buckets; ++i) {
+        const auto& entries = relocation_buckets[i].entries;
+        relocation_entries.insert(relocation_entries.end(), entries.begin(), entries.end());
     }
+    relocation_entries.push_back({relocation.size, 0, 0});
 
-    for (std::size_t i = 0; i < subsection.number_buckets - 1; ++i) {
-        subsection_buckets[i].entries.push_back({subsection_buckets[i + 1].entries[0].address_patch,
-                                                 {0},
-                                                 subsection_buckets[i + 1].entries[0].ctr});
+    // The last bucket already ends with the entries covering the metadata and the end
+    for (std::size_t i = 0; i < subsection.number_buckets; ++i) {
+        const auto& entries = subsection_buckets[i].entries;
+        subsection_entries.insert(subsection_entries.end(), entries.begin(), entries.end());
     }
-
-    relocation_buckets.back().entries.push_back({relocation.size, 0, 0});
 }
 
 BKTR::~BKTR() = default;
 
 std::size_t BKTR::Read(u8* data, std::size_t length, std::size_t offset) const {
     // Read out of bounds.
-    if (offset >= relocation.size)
+    if (offset >= size)
         return 0;
-    const auto relocation = GetRelocationEntry(offset);
-    const auto section_offset = offset - relocation.address_patch + relocation.address_source;
-    const auto bktr_read = relocation.from_patch;
-
-    const auto next_relocation = GetNextRelocationEntry(offset);
+    length = std::min<std::size_t>(length, size - offset);
+
+    const u64 end = offset + length;
+    std::size_t index = FindEntry(relocation_entries, offset);
+    std::size_t read = 0;
+    while (read < length) {
+        const u64 position = offset + read;
+        const RelocationEntry entry = relocation_entries[index];
+
+        // Neighbouring entries that keep reading the same source linearly are read in one go
+        u64 run_end = relocation_entries[index + 1].address_patch;
+        while (run_end < end && index + 2 < relocation_entries.size()) {
+            const RelocationEntry& next = relocation_entries[index + 1];
+            if (next.from_patch != entry.from_patch ||
+                next.address_source - entry.address_source !=
+                    next.address_patch - entry.address_patch) {
+                break;
+            }
+            run_end = relocation_entries[++index + 1].address_patch;
+        }
 
-    if (offset + length > next_relocation.address_patch) {
-        const u64 partition = next_relocation.address_patch - offset;
-        return Read(data, partition, offset) +
-               Read(data + partition, length - partition, offset + partition);
-    }
+        const std::size_t run_length = std::min(run_end, end) - position;
+        const u64 section_offset = position - entry.address_patch + entry.address_source;
+        std::size_t run_read;
+        if (entry.from_patch) {
+            run_read = ReadPatch(data + read, run_length, section_offset);
+        } else {
+            ASSERT_MSG(section_offset >= ivfc_offset, "Offset calculation negative.");
+            run_read = base_romfs->Read(data + read, run_length, section_offset - ivfc_offset);
+        }
 
-    if (!bktr_read) {
-        ASSERT_MSG(section_offset >= ivfc_offset, "Offset calculation negative.");
-        return base_romfs->Read(data, length, section_offset - ivfc_offset);
+        read += run_read;
+        if (run_read != run_length) {
+            break;
+        }
+        ++index;
     }
+    return read;
+}
 
+std::size_t BKTR::ReadPatch(u8* data, std::size_t length, u64 section_offset) const {
     if (!encrypted) {
         return bktr_romfs->Read(data, length, section_offset);
     }
 
-    const auto subsection = GetSubsectionEntry(section_offset);
-    Core::Crypto::AESCipher<Core::Crypto::Key128> cipher(key, Core::Crypto::Mode::CTR);
+    const u64 end = section_offset + length;
+    std::size_t index = FindEntry(subsection_entries, section_offset);
+    std::size_t read = 0;
+    while (read < length) {
+        const u64 position = section_offset + read;
+        const u32 ctr = subsection_entries[index].ctr;
+
+        // The counter of a block only depends on its offset and the subsection's ctr, so
+        // subsections with the same ctr make up a single stream
+        u64 run_end = subsection_entries[index + 1].address_patch;
+        while (run_end < end && index + 2 < subsection_entries.size() &&
+               subsection_entries[index + 1].ctr == ctr) {
+            run_end = subsection_entries[++index + 1].address_patch;
+        }
+        if (index + 2 >= subsection_entries.size()) {
+            // The last subsection covers everything after it
+            run_end = end;
+        }
 
-    // Calculate AES IV
+        const std::size_t run_length = std::min(run_end, end) - position;
+        const std::size_t block_offset = position & 0xF;
+        SetCipherIV(position - block_offset, ctr);
+
+        std::size_t run_read;
+        if (block_offset == 0) {
+            run_read = bktr_romfs->Read(data + read, run_length, position);
+            cipher.Transcode(data + read, run_read, data + read, Core::Crypto::Op::Decrypt);
+        } else {
+            std::vector<u8> raw(block_offset + run_length);
+            const std::size_t raw_read =
+                bktr_romfs->Read(raw.data(), raw.size(), position - block_offset);
+            cipher.Transcode(raw.data(), raw_read, raw.data(), Core::Crypto::Op::Decrypt);
+            run_read = raw_read > block_offset ? raw_read - block_offset : 0;
+            std::memcpy(data + read, raw.data() + block_offset, run_read);
+        }
+
+        read += run_read;
+        if (run_read != run_length) {
+            break;
+        }
+        ++index;
+    }
+    return read;
+}
+
+void BKTR::SetCipherIV(u64 section_offset, u32 subsection_ctr) const {
     std::vector<u8> iv(16);
-    auto subsection_ctr = subsection.ctr;
     auto offset_iv = section_offset + base_offset;
     for (std::size_t i = 0; i < section_ctr.size(); ++i)
         iv[i] = section_ctr[0x8 - i - 1];
@@ -81,98 +159,6 @@ std::size_t BKTR::Read(u8* data, std::size_t length, std::size_t offset) const {
         subsection_ctr >>= 8;
     }
     cipher.SetIV(iv);
-
-    const auto next_subsection = GetNextSubsectionEntry(section_offset);
-
-    if (section_offset + length > next_subsection.address_patch) {
-        const u64 partition = next_subsection.address_patch - section_offset;
-        return Read(data, partition, offset) +
-               Read(data + partition, length - partition, offset + partition);
-    }
-
-    const auto block_offset = section_offset & 0xF;
-    if (block_offset != 0) {
-        auto block = bktr_romfs->ReadBytes(0x10, section_offset & ~0xF);
-        cipher.Transcode(block.data(), block.size(), block.data(), Core::Crypto::Op::Decrypt);
-        if (length + block_offset < 0x10) {
-            std::memcpy(data, block.data() + block_offset, std::min(length, block.size()));
-            return std::min(length, block.size());
-        }
-
-        const auto read = 0x10 - block_offset;
-        std::memcpy(data, block.data() + block_offset, read);
-        return read + Read(data + read, length - read, offset + read);
-    }
-
-    const auto raw_read = bktr_romfs->Read(data, length, section_offset);
-    cipher.Transcode(data, raw_read, data, Core::Crypto::Op::Decrypt);
-    return raw_read;
-}
-
-template <bool Subsection, typename BlockType, typename BucketType>
-std::pair<std::size_t, std::size_t> BKTR::SearchBucketEntry(u64 offset, BlockType block,
-                                                            BucketType buckets) const {
-    if constexpr (Subsection) {
-        const auto last_bucket = buckets[block.number_buckets - 1];
-        if (offset >= last_bucket.entries[last_bucket.number_entries].address_patch)
-            return {block.number_buckets - 1, last_bucket.number_entries};
-    } else {
-        ASSERT_MSG(offset <= block.size, "Offset is out of bounds in BKTR relocation block.");
-    }
-
-    std::size_t bucket_id = std::count_if(
-        block.base_offsets.begin() + 1, block.base_offsets.begin() + block.number_buckets,
-        [&offset](u64 base_offset) { return base_offset <= offset; });
-
-    const auto bucket = buckets[bucket_id];
-
-    if (bucket.number_entries == 1)
-        return {bucket_id, 0};
-
-    std::size_t low = 0;
-    std::size_t mid = 0;
-    std::size_t high = bucket.number_entries - 1;
-    while (low <= high) {
-        mid = (low + high) / 2;
-        if (bucket.entries[mid].address_patch > offset) {
-            high = mid - 1;
-        } else {
-            if (mid == bucket.number_entries - 1 ||
-                bucket.entries[mid + 1].address_patch > offset) {
-                return {bucket_id, mid};
-            }
-
-            low = mid + 1;
-        }
-    }
-
-    UNREACHABLE_MSG("Offset could not be found in BKTR block.");
-}
-
-RelocationEntry BKTR::GetRelocationEntry(u64 offset) const {
-    const auto res = SearchBucketEntry<false>(offset, relocation, relocation_buckets);
-    return relocation_buckets[res.first].entries[res.second];
-}
-
-RelocationEntry BKTR::GetNextRelocationEntry(u64 offset) const {
-    const auto res = SearchBucketEntry<false>(offset, relocation, relocation_buckets);
-    const auto bucket = relocation_buckets[res.first];
-    if (res.second + 1 < bucket.entries.size())
-        return bucket.entries[res.second + 1];
-    return relocation_buckets[res.first + 1].entries[0];
-}
-
-SubsectionEntry BKTR::GetSubsectionEntry(u64 offset) const {
-    const auto res = SearchBucketEntry<true>(offset, subsection, subsection_buckets);
-    return subsection_buckets[res.first].entries[res.second];
-}
-
-SubsectionEntry BKTR::GetNextSubsectionEntry(u64 offset) const {
-    const auto res = SearchBucketEntry<true>(offset, subsection, subsection_buckets);
-    const auto bucket = subsection_buckets[res.first];
-    if (res.second + 1 < bucket.entries.size())
-        return bucket.entries[res.second + 1];
-    return subsection_buckets[res.first + 1].entries[0];
 }
 
 std::string BKTR::GetName() const {
@@ -180,7 +166,7 @@ std::string BKTR::GetName() const {
 }
 
 std::size_t BKTR::GetSize() const {
-    return relocation.size;
+    return size;
 }
 
 bool BKTR::Resize(std::size_t new_size) {
@@ -11,6 +11,7 @@
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/swap.h"
+#include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
 namespace FileSys {
@@ -117,20 +118,16 @@ public:
     bool Rename(std::string_view name) override;
 
 private:
-    template <bool Subsection, typename BlockType, typename BucketType>
-    std::pair<std::size_t, std::size_t> SearchBucketEntry(u64 offset, BlockType block,
-                                                          BucketType buckets) const;
+    /// Reads from the BKTR romfs, decrypting every run of subsections that share a counter at once.
+    std::size_t ReadPatch(u8* data, std::size_t length, u64 section_offset) const;
 
-    RelocationEntry GetRelocationEntry(u64 offset) const;
-    RelocationEntry GetNextRelocationEntry(u64 offset) const;
+    void SetCipherIV(u64 section_offset, u32 subsection_ctr) const;
 
-    SubsectionEntry GetSubsectionEntry(u64 offset) const;
-    SubsectionEntry GetNextSubsectionEntry(u64 offset) const;
-
-    RelocationBlock relocation;
-    std::vector<RelocationBucket> relocation_buckets;
-    SubsectionBlock subsection;
-    std::vector<SubsectionBucket> subsection_buckets;
+    // Entries of every bucket, flattened and sorted by patch address. The last entry of each marks
+    // the end of the data and is never returned by the lookups.
+    std::vector<RelocationEntry> relocation_entries;
+    std::vector<SubsectionEntry> subsection_entries;
+    u64 size;
 
     // Should be the raw base romfs, decrypted.
     VirtualFile base_romfs;
@@ -138,7 +135,8 @@ private:
     VirtualFile bktr_romfs;
 
     bool encrypted;
-    Core::Crypto::Key128 key;
+    // Must be mutable as operations modify cipher contexts.
+    mutable Core::Crypto::AESCipher<Core::Crypto::Key128> cipher;
 
     // Base offset into NCA, used for IV calculation.
     u64 base_offset;
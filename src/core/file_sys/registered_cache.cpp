@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <random>
 #include <regex>
 #include <mbedtls/sha256.h>
@@ -10,7 +12,9 @@
 #include "common/file_util.h"
 #include "common/hex_util.h"
 #include "common/logging/log.h"
+#include "common/thread_worker.h"
 #include "core/crypto/key_manager.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/card_image.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/nca_metadata.h"
@@ -24,6 +28,108 @@ namespace FileSys {
 // The size of blocks to use when vfs raw copying into nand.
 constexpr size_t VFS_RC_LARGE_COPY_BLOCK = 0x400000;
 
+namespace {
+
+/**
+ * Forwards writes to another file and hashes them on a worker thread, so an NCA is verified while
+ * it is being installed instead of being read back afterwards. Only sequential writes of the
+ * whole file produce a hash.
+ */
+class HashingVfsFile final : public VfsFile {
+public:
+    explicit HashingVfsFile(VirtualFile base_) : base(std::move(base_)) {}
+
+    ~HashingVfsFile() override {
+        WaitForHashing(0);
+    }
+
+    std::string GetName() const override {
+        return base->GetName();
+    }
+
+    std::size_t GetSize() const override {
+        return base->GetSize();
+    }
+
+    bool Resize(std::size_t new_size) override {
+        return base->Resize(new_size);
+    }
+
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override {
+        return base->GetContainingDirectory();
+    }
+
+    bool IsWritable() const override {
+        return base->IsWritable();
+    }
+
+    bool IsReadable() const override {
+        return base->IsReadable();
+    }
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        return base->Read(data, length, offset);
+    }
+
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override {
+        const std::size_t written = base->Write(data, length, offset);
+        if (offset != hashed_size) {
+            is_sequential = false;
+        }
+        if (!is_sequential || written == 0) {
+            return written;
+        }
+        hashed_size += written;
+
+        // Bound the data waiting to be hashed when writing outpaces the hash
+        WaitForHashing(MAX_QUEUED_SIZE - std::min(written, MAX_QUEUED_SIZE));
+        {
+            std::lock_guard lock{mutex};
+            queued_size += written;
+        }
+        worker.QueueWork([this, block = std::vector<u8>(data, data + written)] {
+            context.Update(block.data(), block.size());
+            std::lock_guard lock{mutex};
+            queued_size -= block.size();
+            hashed_cv.notify_all();
+        });
+        return written;
+    }
+
+    bool Rename(std::string_view name) override {
+        return base->Rename(name);
+    }
+
+    /// Returns the hash of the written data, or nullopt when it wasn't written sequentially.
+    std::optional<Core::Crypto::SHA256Hash> Finish() {
+        WaitForHashing(0);
+        if (!is_sequential || hashed_size != base->GetSize()) {
+            return std::nullopt;
+        }
+        return context.Finish();
+    }
+
+private:
+    static constexpr std::size_t MAX_QUEUED_SIZE = 4 * VFS_RC_LARGE_COPY_BLOCK;
+
+    void WaitForHashing(std::size_t max_queued_size) {
+        std::unique_lock lock{mutex};
+        hashed_cv.wait(lock, [this, max_queued_size] { return queued_size <= max_queued_size; });
+    }
+
+    VirtualFile base;
+    Core::Crypto::SHA256Context context;
+    std::size_t hashed_size = 0;
+    bool is_sequential = true;
+
+    std::mutex mutex;
+    std::condition_variable hashed_cv;
+    std::size_t queued_size = 0;
+    Common::ThreadWorker worker{1, "yuzu:InstallHash"};
+};
+
+} // Anonymous namespace
+
 std::string ContentProviderEntry::DebugInfo() const {
     return fmt::format("title_id={:016X}, content_type={:02X}", title_id, static_cast<u8>(type));
 }
@@ -579,7 +685,8 @@ InstallResult RegisteredCache::InstallEntry(const NSP& nsp, bool overwrite_if_ex
         const auto nca = GetNCAFromNSPForID(nsp, record.nca_id);
         if (nca == nullptr)
             return InstallResult::ErrorCopyFailed;
-        const auto res2 = RawInstallNCA(*nca, copy, overwrite_if_exists, record.nca_id);
+        const auto res2 =
+            RawInstallNCA(*nca, copy, overwrite_if_exists, record.nca_id, record.hash);
         if (res2 != InstallResult::Success)
             return res2;
     }
@@ -603,7 +710,7 @@ InstallResult RegisteredCache::InstallEntry(const NCA& nca, TitleType type,
     OptionalHeader opt_header{0, 0};
     ContentRecord c_rec{{}, {}, {}, GetCRTypeFromNCAType(nca.GetType()), {}};
     const auto& data = nca.GetBaseFile()->ReadBytes(0x100000);
-    mbedtls_sha256_ret(data.data(), data.size(), c_rec.hash.data(), 0);
+    c_rec.hash = Core::Crypto::CalculateSHA256(data.data(), data.size());
     memcpy(&c_rec.nca_id, &c_rec.hash, 16);
     const CNMT new_cnmt(header, opt_header, {c_rec}, {});
     if (!RawInstallYuzuMeta(new_cnmt))
@@ -611,9 +718,9 @@ InstallResult RegisteredCache::InstallEntry(const NCA& nca, TitleType type,
     return RawInstallNCA(nca, copy, overwrite_if_exists, c_rec.nca_id);
 }
 
-InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFunction& copy,
-                                             bool overwrite_if_exists,
-                                             std::optional<NcaID> override_id) {
+InstallResult RegisteredCache::RawInstallNCA(
+    const NCA& nca, const VfsCopyFunction& copy, bool overwrite_if_exists,
+    std::optional<NcaID> override_id, std::optional<Core::Crypto::SHA256Hash> expected_hash) {
     const auto in = nca.GetBaseFile();
     Core::Crypto::SHA256Hash hash{};
 
@@ -626,7 +733,7 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
         id = *override_id;
     } else {
         const auto& data = in->ReadBytes(0x100000);
-        mbedtls_sha256_ret(data.data(), data.size(), hash.data(), 0);
+        hash = Core::Crypto::CalculateSHA256(data.data(), data.size());
         memcpy(id.data(), hash.data(), 16);
     }
 
@@ -647,8 +754,29 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
     auto out = dir->CreateFileRelative(path);
     if (out == nullptr)
         return InstallResult::ErrorCopyFailed;
-    return copy(in, out, VFS_RC_LARGE_COPY_BLOCK) ? InstallResult::Success
-                                                  : InstallResult::ErrorCopyFailed;
+    // A cancelled or failed copy must not leave a truncated NCA behind
+    const auto remove_out = [&out] { out->GetContainingDirectory()->DeleteFile(out->GetName()); };
+    if (!expected_hash) {
+        if (!copy(in, out, VFS_RC_LARGE_COPY_BLOCK)) {
+            remove_out();
+            return InstallResult::ErrorCopyFailed;
+        }
+        return InstallResult::Success;
+    }
+
+    const auto hashing_out = std::make_shared<HashingVfsFile>(out);
+    if (!copy(in, hashing_out, VFS_RC_LARGE_COPY_BLOCK)) {
+        remove_out();
+        return InstallResult::ErrorCopyFailed;
+    }
+    const auto installed_hash = hashing_out->Finish();
+    if (installed_hash && *installed_hash != *expected_hash) {
+        LOG_ERROR(Loader, "The hash of NCA {} does not match its metadata, it is corrupted.",
+                  Common::HexToString(id, false));
+        remove_out();
+        return InstallResult::ErrorHashMismatch;
+    }
+    return InstallResult::Success;
 }
 
 bool RegisteredCache::RawInstallYuzuMeta(const CNMT& cnmt) {
@@ -0,0 +1,347 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <utility>
+
+#include "common/logging/log.h"
+#include "core/file_sys/savedata_cache.h"
+#include "core/file_sys/savedata_factory.h"
+#include "core/file_sys/vfs_vector.h"
+
+namespace FileSys {
+
+namespace {
+
+// Siblings of the host directory used while a commit swaps in the new contents
+constexpr char COMMIT_SUFFIX[] = ".commit";
+constexpr char PREVIOUS_SUFFIX[] = ".previous";
+
+/// Commits of every save run on one thread, so the host sees them in the order they were made
+Common::ThreadWorker& GetCommitWorker() {
+    static Common::ThreadWorker worker{1, "yuzu:SaveDataCommit"};
+    return worker;
+}
+
+/// In-memory file that doesn't keep its directory alive, to avoid a reference cycle
+class MemoryFile final : public VectorVfsFile {
+public:
+    explicit MemoryFile(std::vector<u8> data, std::string name, std::weak_ptr<VfsDirectory> parent)
+        : VectorVfsFile(std::move(data), std::move(name)), parent(std::move(parent)) {}
+
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override {
+        return parent.lock();
+    }
+
+private:
+    std::weak_ptr<VfsDirectory> parent;
+};
+
+/// Writable in-memory directory, behaving like RealVfsDirectory for existing entries
+class MemoryDirectory final : public VfsDirectory {
+public:
+    static std::shared_ptr<MemoryDirectory> Make(std::string name,
+                                                 std::weak_ptr<VfsDirectory> parent) {
+        std::shared_ptr<MemoryDirectory> dir{
+            new MemoryDirectory(std::move(name), std::move(parent))};
+        dir->self = dir;
+        return dir;
+    }
+
+    std::vector<std::shared_ptr<VfsFile>> GetFiles() const override {
+        return files;
+    }
+
+    std::vector<std::shared_ptr<VfsDirectory>> GetSubdirectories() const override {
+        return subdirs;
+    }
+
+    bool IsWritable() const override {
+        return true;
+    }
+
+    bool IsReadable() const override {
+        return true;
+    }
+
+    std::string GetName() const override {
+        return name;
+    }
+
+    std::shared_ptr<VfsDirectory> GetParentDirectory() const override {
+        return parent.lock();
+    }
+
+    std::shared_ptr<VfsDirectory> CreateSubdirectory(std::string_view name_) override {
+        if (auto existing = GetSubdirectory(name_)) {
+            return existing;
+        }
+        if (GetFile(name_) != nullptr) {
+            return nullptr;
+        }
+        return subdirs.emplace_back(Make(std::string(name_), self));
+    }
+
+    std::shared_ptr<VfsFile> CreateFile(std::string_view name_) override {
+        if (auto existing = GetFile(name_)) {
+            return existing;
+        }
+        if (GetSubdirectory(name_) != nullptr) {
+            return nullptr;
+        }
+        return AddFile(std::string(name_), {});
+    }
+
+    bool DeleteSubdirectory(std::string_view name_) override {
+        return Erase(subdirs, name_);
+    }
+
+    bool DeleteFile(std::string_view name_) override {
+        return Erase(files, name_);
+    }
+
+    bool Rename(std::string_view name_) override {
+        name = name_;
+        return true;
+    }
+
+    VirtualFile AddFile(std::string file_name, std::vector<u8> data) {
+        return files.emplace_back(
+            std::make_shared<MemoryFile>(std::move(data), std::move(file_name), self));
+    }
+
+private:
+    explicit MemoryDirectory(std::string name, std::weak_ptr<VfsDirectory> parent)
+        : name(std::move(name)), parent(std::move(parent)) {}
+
+    template <typename T>
+    static bool Erase(std::vector<T>& entries, std::string_view entry_name) {
+        const auto it = std::find_if(entries.begin(), entries.end(), [entry_name](const T& entry) {
+            return entry->GetName() == entry_name;
+        });
+        if (it == entries.end()) {
+            return false;
+        }
+        entries.erase(it);
+        return true;
+    }
+
+    std::vector<VirtualFile> files;
+    std::vector<VirtualDir> subdirs;
+    std::string name;
+    std::weak_ptr<VfsDirectory> parent;
+    std::weak_ptr<MemoryDirectory> self;
+};
+
+/// Contents of a save at the time Commit was called, with paths relative to its root
+struct Snapshot {
+    std::vector<std::string> directories;
+    std::vector<std::pair<std::string, std::vector<u8>>> files;
+};
+
+void LoadDirectory(const VfsDirectory& src, MemoryDirectory& dst, bool is_root) {
+    for (const auto& file : src.GetFiles()) {
+        // The size file belongs to SaveDataFactory, which updates it directly on the host
+        if (is_root && file->GetName() == SAVE_DATA_SIZE_FILENAME) {
+            continue;
+        }
+        dst.AddFile(file->GetName(), file->ReadAllBytes());
+    }
+    for (const auto& subdir : src.GetSubdirectories()) {
+        const auto copy = std::static_pointer_cast<MemoryDirectory>(
+            dst.CreateSubdirectory(subdir->GetName()));
+        LoadDirectory(*subdir, *copy, false);
+    }
+}
+
+void TakeSnapshot(const VfsDirectory& dir, const std::string& prefix, Snapshot& snapshot) {
+    for (const auto& file : dir.GetFiles()) {
+        snapshot.files.emplace_back(prefix + file->GetName(), file->ReadAllBytes());
+    }
+    for (const auto& subdir : dir.GetSubdirectories()) {
+        std::string path = prefix + subdir->GetName();
+        TakeSnapshot(*subdir, path + '/', snapshot);
+        snapshot.directories.push_back(std::move(path));
+    }
+}
+
+bool WriteSnapshot(VfsDirectory& dst, const VfsDirectory& host_dir, const Snapshot& snapshot) {
+    for (const auto& path : snapshot.directories) {
+        if (dst.CreateDirectoryRelative(path) == nullptr) {
+            LOG_ERROR(Service_FS, "Failed to create directory {}", path);
+            return false;
+        }
+    }
+    for (const auto& [path, data] : snapshot.files) {
+        const auto file = dst.CreateFileRelative(path);
+        if (file == nullptr || !file->Resize(data.size()) ||
+            file->WriteBytes(data) != data.size()) {
+            LOG_ERROR(Service_FS, "Failed to write file {}", path);
+            return false;
+        }
+    }
+    if (const auto size_file = host_dir.GetFile(SAVE_DATA_SIZE_FILENAME)) {
+        const auto data = size_file->ReadAllBytes();
+        const auto file = dst.CreateFile(SAVE_DATA_SIZE_FILENAME);
+        if (file == nullptr || file->WriteBytes(data) != data.size()) {
+            LOG_ERROR(Service_FS, "Failed to copy the save data size");
+            return false;
+        }
+    }
+    return true;
+}
+
+void CommitSnapshot(const VirtualDir& host_dir, const Snapshot& snapshot) {
+    const auto parent = host_dir->GetParentDirectory();
+    const auto name = host_dir->GetName();
+    const auto commit_name = name + COMMIT_SUFFIX;
+    const auto previous_name = name + PREVIOUS_SUFFIX;
+
+    // The new contents are complete on the host before the committed ones are touched
+    parent->DeleteSubdirectoryRecursive(commit_name);
+    parent->DeleteSubdirectoryRecursive(previous_name);
+    {
+        const auto commit_dir = parent->CreateSubdirectory(commit_name);
+        if (commit_dir == nullptr || !WriteSnapshot(*commit_dir, *host_dir, snapshot)) {
+            LOG_ERROR(Service_FS, "Failed to commit save data to {}", host_dir->GetFullPath());
+            return;
+        }
+    }
+
+    const auto committed_dir = parent->GetSubdirectory(name);
+    if (committed_dir != nullptr && !committed_dir->Rename(previous_name)) {
+        LOG_ERROR(Service_FS, "Failed to move aside the committed save data in {}",
+                  host_dir->GetFullPath());
+        return;
+    }
+    if (!parent->GetSubdirectory(commit_name)->Rename(name)) {
+        // RecoverInterruptedCommit finishes the swap the next time the save is opened
+        LOG_ERROR(Service_FS, "Failed to swap in the committed save data in {}",
+                  host_dir->GetFullPath());
+        return;
+    }
+    parent->DeleteSubdirectoryRecursive(previous_name);
+}
+
+} // Anonymous namespace
+
+std::shared_ptr<CachedSaveDataDirectory> CachedSaveDataDirectory::Open(VirtualDir host_dir) {
+    const std::size_t size = host_dir->GetSize();
+    if (size > MAX_CACHED_SIZE) {
+        LOG_INFO(Service_FS, "Save data in {} is too large to cache ({} bytes)",
+                 host_dir->GetFullPath(), size);
+        return nullptr;
+    }
+
+    const auto root = MemoryDirectory::Make(host_dir->GetName(), {});
+    LoadDirectory(*host_dir, *root, true);
+
+    // Cannot use make_shared as the constructor is private
+    return std::shared_ptr<CachedSaveDataDirectory>(
+        new CachedSaveDataDirectory(std::move(host_dir), root));
+}
+
+void CachedSaveDataDirectory::RecoverInterruptedCommit(const VirtualDir& parent,
+                                                       std::string_view name) {
+    if (parent == nullptr) {
+        return;
+    }
+    const std::string commit_name = std::string(name) + COMMIT_SUFFIX;
+    const std::string previous_name = std::string(name) + PREVIOUS_SUFFIX;
+    const auto commit_dir = parent->GetSubdirectory(commit_name);
+    const auto previous_dir = parent->GetSubdirectory(previous_name);
+    if (commit_dir == nullptr && previous_dir == nullptr) {
+        return;
+    }
+
+    if (parent->GetSubdirectory(name) == nullptr) {
+        // The committed contents are only moved aside once the new ones were fully written, so
+        // the new ones are safe to use when they made it to the host
+        const auto& newest = commit_dir != nullptr && previous_dir != nullptr ? commit_dir
+                                                                                : previous_dir;
+        if (newest != nullptr) {
+            LOG_WARNING(Service_FS, "Recovering interrupted save data commit from {}",
+                        newest->GetFullPath());
+            newest->Rename(name);
+        }
+    }
+
+    // Anything left over is either stale or was never swapped in
+    parent->DeleteSubdirectoryRecursive(commit_name);
+    parent->DeleteSubdirectoryRecursive(previous_name);
+}
+
+CachedSaveDataDirectory::CachedSaveDataDirectory(VirtualDir host_dir_, VirtualDir root_)
+    : host_dir(std::move(host_dir_)), root(std::move(root_)) {}
+
+CachedSaveDataDirectory::~CachedSaveDataDirectory() {
+    WaitForCommit();
+}
+
+std::vector<std::shared_ptr<VfsFile>> CachedSaveDataDirectory::GetFiles() const {
+    return root->GetFiles();
+}
+
+std::vector<std::shared_ptr<VfsDirectory>> CachedSaveDataDirectory::GetSubdirectories() const {
+    return root->GetSubdirectories();
+}
+
+bool CachedSaveDataDirectory::IsWritable() const {
+    return true;
+}
+
+bool CachedSaveDataDirectory::IsReadable() const {
+    return true;
+}
+
+std::string CachedSaveDataDirectory::GetName() const {
+    return root->GetName();
+}
+
+std::shared_ptr<VfsDirectory> CachedSaveDataDirectory::GetParentDirectory() const {
+    return nullptr;
+}
+
+std::shared_ptr<VfsDirectory> CachedSaveDataDirectory::CreateSubdirectory(std::string_view name) {
+    return root->CreateSubdirectory(name);
+}
+
+std::shared_ptr<VfsFile> CachedSaveDataDirectory::CreateFile(std::string_view name) {
+    return root->CreateFile(name);
+}
+
+bool CachedSaveDataDirectory::DeleteSubdirectory(std::string_view name) {
+    return root->DeleteSubdirectory(name);
+}
+
+bool CachedSaveDataDirectory::DeleteFile(std::string_view name) {
+    return root->DeleteFile(name);
+}
+
+bool CachedSaveDataDirectory::Rename(std::string_view name) {
+    // The save is mounted as a filesystem root, which can't be renamed from inside
+    return false;
+}
+
+std::string CachedSaveDataDirectory::GetFullPath() const {
+    return host_dir->GetFullPath();
+}
+
+void CachedSaveDataDirectory::Commit() {
+    Snapshot snapshot;
+    TakeSnapshot(*root, "", snapshot);
+    LOG_DEBUG(Service_FS, "Committing {} files to {}", snapshot.files.size(),
+              host_dir->GetFullPath());
+
+    GetCommitWorker().QueueWork(commit_task,
+                                [host_dir = host_dir, snapshot = std::move(snapshot)] {
+                                    CommitSnapshot(host_dir, snapshot);
+                                });
+}
+
+void CachedSaveDataDirectory::WaitForCommit() {
+    commit_task.Wait();
+}
+
+} // namespace FileSys
@@ -0,0 +1,67 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/thread_worker.h"
+#include "core/file_sys/vfs.h"
+
+namespace FileSys {
+
+/**
+ * Write-back view of a save data directory. The whole directory is read into memory when it is
+ * opened and every guest modification stays there until Commit is called, matching the journaling
+ * of the real save data filesystem. Committing snapshots the tree and hands it to a worker thread,
+ * which writes it to a temporary sibling of the host directory and swaps it in with renames, so
+ * the host always holds either the previous or the new committed state.
+ */
+class CachedSaveDataDirectory final : public VfsDirectory {
+public:
+    /// Saves larger than this are opened directly on the host instead of being cached
+    static constexpr std::size_t MAX_CACHED_SIZE = 0x4000000;
+
+    /// Loads host_dir into memory. Returns nullptr when the directory is too large to cache.
+    static std::shared_ptr<CachedSaveDataDirectory> Open(VirtualDir host_dir);
+
+    /**
+     * Restores the host directory called name inside parent to its last committed state after
+     * the emulator stopped halfway through a commit. Does nothing when no commit was interrupted.
+     */
+    static void RecoverInterruptedCommit(const VirtualDir& parent, std::string_view name);
+
+    ~CachedSaveDataDirectory() override;
+
+    std::vector<std::shared_ptr<VfsFile>> GetFiles() const override;
+    std::vector<std::shared_ptr<VfsDirectory>> GetSubdirectories() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::string GetName() const override;
+    std::shared_ptr<VfsDirectory> GetParentDirectory() const override;
+    std::shared_ptr<VfsDirectory> CreateSubdirectory(std::string_view name) override;
+    std::shared_ptr<VfsFile> CreateFile(std::string_view name) override;
+    bool DeleteSubdirectory(std::string_view name) override;
+    bool DeleteFile(std::string_view name) override;
+    bool Rename(std::string_view name) override;
+    std::string GetFullPath() const override;
+
+    /// Queues the current contents to be written to the host and returns without waiting.
+    void Commit();
+
+    /// Blocks until every queued commit has reached the host.
+    void WaitForCommit();
+
+private:
+    CachedSaveDataDirectory(VirtualDir host_dir, VirtualDir root);
+
+    VirtualDir host_dir;
+    VirtualDir root; ///< In-memory copy of host_dir that the guest modifies
+    Common::TaskGroup commit_task;
+};
+
+} // namespace FileSys
@@ -6,15 +6,15 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/file_util.h"
 #include "core/core.h"
+#include "core/file_sys/savedata_cache.h"
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/vfs.h"
 #include "core/hle/kernel/process.h"
 
 namespace FileSys {
 
-constexpr char SAVE_DATA_SIZE_FILENAME[] = ".yuzu_save_size";
-
 namespace {
 
 void PrintSaveDataDescriptorWarnings(SaveDataDescriptor meta) {
@@ -102,10 +102,22 @@ ResultVal<VirtualDir> SaveDataFactory::Open(SaveDataSpaceId space,
     const auto save_directory =
         GetFullPath(space, meta.type, meta.title_id, meta.user_id, meta.save_id);
 
+    if (auto cached = cached_saves[save_directory].lock()) {
+        return MakeResult<VirtualDir>(std::move(cached));
+    }
+
+    CachedSaveDataDirectory::RecoverInterruptedCommit(
+        dir->GetDirectoryRelative(FileUtil::GetParentPath(save_directory)),
+        FileUtil::GetFilename(save_directory));
+
     auto out = dir->GetDirectoryRelative(save_directory);
 
     if (out == nullptr && ShouldSaveDataBeAutomaticallyCreated(space, meta)) {
-        return Create(space, meta);
+        const auto created = Create(space, meta);
+        if (created.Failed()) {
+            return created;
+        }
+        out = *created;
     }
 
     // Return an error if the save data doesn't actually exist.
@@ -114,7 +126,12 @@ ResultVal<VirtualDir> SaveDataFactory::Open(SaveDataSpaceId space,
         return RESULT_UNKNOWN;
     }
 
-    return MakeResult<VirtualDir>(std::move(out));
+    auto cached = CachedSaveDataDirectory::Open(out);
+    if (cached == nullptr) {
+        return MakeResult<VirtualDir>(std::move(out));
+    }
+    cached_saves[save_directory] = cached;
+    return MakeResult<VirtualDir>(std::move(cached));
 }
 
 VirtualDir SaveDataFactory::GetSaveDataSpaceDirectory(SaveDataSpaceId space) const {
@@ -166,6 +183,7 @@ std::string SaveDataFactory::GetFullPath(SaveDataSpaceId space, SaveDataType typ
 SaveDataSize SaveDataFactory::ReadSaveDataSize(SaveDataType type, u64 title_id,
                                                u128 user_id) const {
     const auto path = GetFullPath(SaveDataSpaceId::NandUser, type, title_id, user_id, 0);
+    WaitForCommit(path);
     const auto dir = GetOrCreateDirectoryRelative(this->dir, path);
 
     const auto size_file = dir->GetFile(SAVE_DATA_SIZE_FILENAME);
@@ -181,6 +199,7 @@ SaveDataSize SaveDataFactory::ReadSaveDataSize(SaveDataType type, u64 title_id,
 void SaveDataFactory::WriteSaveDataSize(SaveDataType type, u64 title_id, u128 user_id,
                                         SaveDataSize new_value) const {
     const auto path = GetFullPath(SaveDataSpaceId::NandUser, type, title_id, user_id, 0);
+    WaitForCommit(path);
     const auto dir = GetOrCreateDirectoryRelative(this->dir, path);
 
     const auto size_file = dir->CreateFile(SAVE_DATA_SIZE_FILENAME);
@@ -191,4 +210,16 @@ void SaveDataFactory::WriteSaveDataSize(SaveDataType type, u64 title_id, u128 us
     size_file->WriteObject(new_value);
 }
 
+void SaveDataFactory::WaitForCommit(const std::string& path) const {
+    const auto it = cached_saves.find(path);
+    if (it == cached_saves.end()) {
+        return;
+    }
+    if (const auto cached = it->second.lock()) {
+        cached->WaitForCommit();
+    } else {
+        cached_saves.erase(it);
+    }
+}
+
 } // namespace FileSys
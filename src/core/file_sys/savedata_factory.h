@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include "common/common_funcs.h"
@@ -14,6 +15,10 @@
 
 namespace FileSys {
 
+class CachedSaveDataDirectory;
+
+constexpr char SAVE_DATA_SIZE_FILENAME[] = ".yuzu_save_size";
+
 enum class SaveDataSpaceId : u8 {
     NandSystem = 0,
     NandUser = 1,
@@ -78,7 +83,13 @@ public:
                            SaveDataSize new_value) const;
 
 private:
+    /// Waits for pending commits of the save at path, so the host copy is consistent
+    void WaitForCommit(const std::string& path) const;
+
     VirtualDir dir;
+
+    /// Saves currently mounted through a cache, so mounting them again shares their contents
+    mutable std::map<std::string, std::weak_ptr<CachedSaveDataDirectory>> cached_saves;
 };
 
 } // namespace FileSys
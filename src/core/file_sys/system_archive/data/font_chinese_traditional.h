@@ -5,9 +5,14 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 namespace FileSys::SystemArchive::SharedFontData {
 
-extern const std::array<unsigned char, 222236> FONT_CHINESE_TRADITIONAL;
+/// Font compressed with Zstandard
+extern const std::array<unsigned char, 75017> FONT_CHINESE_TRADITIONAL;
+
+/// Size in bytes of the decompressed font
+constexpr std::size_t FONT_CHINESE_TRADITIONAL_SIZE = 222236;
 
 } // namespace FileSys::SystemArchive::SharedFontData
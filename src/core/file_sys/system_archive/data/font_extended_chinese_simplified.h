@@ -5,9 +5,14 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 namespace FileSys::SystemArchive::SharedFontData {
 
-extern const std::array<unsigned char, 293516> FONT_EXTENDED_CHINESE_SIMPLIFIED;
+/// Font compressed with Zstandard
+extern const std::array<unsigned char, 109896> FONT_EXTENDED_CHINESE_SIMPLIFIED;
+
+/// Size in bytes of the decompressed font
+constexpr std::size_t FONT_EXTENDED_CHINESE_SIMPLIFIED_SIZE = 293516;
 
 } // namespace FileSys::SystemArchive::SharedFontData
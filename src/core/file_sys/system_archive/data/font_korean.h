@@ -1,13 +0,0 @@
-// Copyright 2019 yuzu emulator team
-// Licensed under GPLv2 or any later version
-// Refer to the license.txt file included.
-
-#pragma once
-
-#include <array>
-
-namespace FileSys::SystemArchive::SharedFontData {
-
-extern const std::array<unsigned char, 217276> FONT_KOREAN;
-
-} // namespace FileSys::SystemArchive::SharedFontData
@@ -5,9 +5,14 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 namespace FileSys::SystemArchive::SharedFontData {
 
-extern const std::array<unsigned char, 2932> FONT_NINTENDO_EXTENDED;
+/// Font compressed with Zstandard
+extern const std::array<unsigned char, 1801> FONT_NINTENDO_EXTENDED;
+
+/// Size in bytes of the decompressed font
+constexpr std::size_t FONT_NINTENDO_EXTENDED_SIZE = 2932;
 
 } // namespace FileSys::SystemArchive::SharedFontData
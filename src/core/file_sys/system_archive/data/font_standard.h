@@ -5,9 +5,14 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 namespace FileSys::SystemArchive::SharedFontData {
 
-extern const std::array<unsigned char, 217276> FONT_STANDARD;
+/// Font compressed with Zstandard
+extern const std::array<unsigned char, 73544> FONT_STANDARD;
+
+/// Size in bytes of the decompressed font
+constexpr std::size_t FONT_STANDARD_SIZE = 217276;
 
 } // namespace FileSys::SystemArchive::SharedFontData
@@ -2,13 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "core/file_sys/system_archive/data/font_chinese_simplified.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "common/assert.h"
+#include "common/hash.h"
+#include "common/shared_cache_file.h"
+#include "common/zstd_compression.h"
 #include "core/file_sys/system_archive/data/font_chinese_traditional.h"
 #include "core/file_sys/system_archive/data/font_extended_chinese_simplified.h"
-#include "core/file_sys/system_archive/data/font_korean.h"
 #include "core/file_sys/system_archive/data/font_nintendo_extended.h"
 #include "core/file_sys/system_archive/data/font_standard.h"
 #include "core/file_sys/system_archive/shared_font.h"
+#include "core/file_sys/vfs_cached.h"
 #include "core/file_sys/vfs_vector.h"
 #include "core/hle/service/ns/pl_u.h"
 
@@ -16,16 +23,106 @@ namespace FileSys::SystemArchive {
 
 namespace {
 
-template <std::size_t Size>
-VirtualFile PackBFTTF(const std::array<u8, Size>& data, const std::string& name) {
-    std::vector<u32> vec(Size / sizeof(u32));
-    std::memcpy(vec.data(), data.data(), vec.size() * sizeof(u32));
+/// BFTTF of an embedded font. The font is decompressed and encrypted the first time it's read, or
+/// taken from the other running instances when they share their contents.
+class PackedFontFile final : public VfsFile {
+public:
+    template <std::size_t Size>
+    explicit PackedFontFile(const std::array<u8, Size>& compressed_, std::size_t font_size_,
+                            std::string name_)
+        : compressed{compressed_.data()}, compressed_size{Size}, font_size{font_size_},
+          name{std::move(name_)} {}
+
+    std::string GetName() const override {
+        return name;
+    }
+
+    std::size_t GetSize() const override {
+        return font_size + sizeof(u64);
+    }
+
+    bool Resize(std::size_t new_size) override {
+        return false;
+    }
+
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override {
+        return nullptr;
+    }
+
+    bool IsWritable() const override {
+        return false;
+    }
+
+    bool IsReadable() const override {
+        return true;
+    }
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        const u8* const bfttf = GetBFTTF();
+        if (offset >= GetSize())
+            return 0;
+        length = std::min(length, GetSize() - offset);
+        std::memcpy(data, bfttf + offset, length);
+        return length;
+    }
 
-    std::vector<u8> bfttf(Size + sizeof(u64));
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override {
+        return 0;
+    }
 
-    u64 offset = 0;
-    Service::NS::EncryptSharedFont(vec, bfttf, offset);
-    return std::make_shared<VectorVfsFile>(std::move(bfttf), name);
+    bool Rename(std::string_view new_name) override {
+        return false;
+    }
+
+private:
+    const u8* GetBFTTF() const {
+        std::call_once(pack_flag, [this] {
+            // The whole font is a single block, keyed by the embedded data it is packed from
+            shared_bfttf = OpenSharedContent(Common::ComputeHash64(compressed, compressed_size),
+                                             GetSize(), GetSize());
+            if (shared_bfttf && shared_bfttf->GetBlock(0) != nullptr) {
+                bfttf_pointer = shared_bfttf->GetBlock(0);
+                return;
+            }
+
+            std::vector<u32> font(font_size / sizeof(u32));
+            const bool decompressed = Common::Compression::DecompressDataZSTD(
+                compressed, compressed_size, reinterpret_cast<u8*>(font.data()),
+                font.size() * sizeof(u32));
+            ASSERT_MSG(decompressed, "Failed to decompress embedded font {}", name);
+
+            bfttf.resize(GetSize());
+            u64 offset = 0;
+            Service::NS::EncryptSharedFont(font, bfttf, offset);
+            bfttf_pointer = bfttf.data();
+
+            if (shared_bfttf) {
+                shared_bfttf->StoreBlock(0, bfttf.data());
+                // Drop the private copy once the font is in the shared file
+                if (shared_bfttf->GetBlock(0) != nullptr) {
+                    bfttf_pointer = shared_bfttf->GetBlock(0);
+                    bfttf = {};
+                }
+            }
+        });
+        return bfttf_pointer;
+    }
+
+    const u8* compressed;
+    std::size_t compressed_size;
+    std::size_t font_size;
+    std::string name;
+
+    mutable std::once_flag pack_flag;
+    mutable std::vector<u8> bfttf;
+    mutable std::shared_ptr<Common::SharedCacheFile> shared_bfttf;
+    mutable const u8* bfttf_pointer = nullptr;
+};
+
+template <std::size_t Size>
+VirtualFile PackBFTTF(const std::array<u8, Size>& data, std::size_t font_size,
+                      const std::string& name) {
+    return std::make_shared<PackedFontFile>(data, font_size, name);
 }
 
 } // Anonymous namespace
@@ -33,8 +130,10 @@ VirtualFile PackBFTTF(const std::array<u8, Size>& data, const std::string& name)
 VirtualDir FontNintendoExtension() {
     return std::make_shared<VectorVfsDirectory>(
         std::vector<VirtualFile>{
-            PackBFTTF(SharedFontData::FONT_NINTENDO_EXTENDED, "nintendo_ext_003.bfttf"),
-            PackBFTTF(SharedFontData::FONT_NINTENDO_EXTENDED, "nintendo_ext2_003.bfttf"),
+            PackBFTTF(SharedFontData::FONT_NINTENDO_EXTENDED,
+                      SharedFontData::FONT_NINTENDO_EXTENDED_SIZE, "nintendo_ext_003.bfttf"),
+            PackBFTTF(SharedFontData::FONT_NINTENDO_EXTENDED,
+                      SharedFontData::FONT_NINTENDO_EXTENDED_SIZE, "nintendo_ext2_003.bfttf"),
         },
         std::vector<VirtualDir>{});
 }
@@ -42,15 +141,18 @@ VirtualDir FontNintendoExtension() {
 VirtualDir FontStandard() {
     return std::make_shared<VectorVfsDirectory>(
         std::vector<VirtualFile>{
-            PackBFTTF(SharedFontData::FONT_STANDARD, "nintendo_udsg-r_std_003.bfttf"),
+            PackBFTTF(SharedFontData::FONT_STANDARD, SharedFontData::FONT_STANDARD_SIZE,
+                      "nintendo_udsg-r_std_003.bfttf"),
         },
         std::vector<VirtualDir>{});
 }
 
+// The embedded replacements of the Korean and Simplified Chinese fonts are the standard font
 VirtualDir FontKorean() {
     return std::make_shared<VectorVfsDirectory>(
         std::vector<VirtualFile>{
-            PackBFTTF(SharedFontData::FONT_KOREAN, "nintendo_udsg-r_ko_003.bfttf"),
+            PackBFTTF(SharedFontData::FONT_STANDARD, SharedFontData::FONT_STANDARD_SIZE,
+                      "nintendo_udsg-r_ko_003.bfttf"),
         },
         std::vector<VirtualDir>{});
 }
@@ -59,6 +161,7 @@ VirtualDir FontChineseTraditional() {
     return std::make_shared<VectorVfsDirectory>(
         std::vector<VirtualFile>{
             PackBFTTF(SharedFontData::FONT_CHINESE_TRADITIONAL,
+                      SharedFontData::FONT_CHINESE_TRADITIONAL_SIZE,
                       "nintendo_udjxh-db_zh-tw_003.bfttf"),
         },
         std::vector<VirtualDir>{});
@@ -67,9 +170,10 @@ VirtualDir FontChineseTraditional() {
 VirtualDir FontChineseSimple() {
     return std::make_shared<VectorVfsDirectory>(
         std::vector<VirtualFile>{
-            PackBFTTF(SharedFontData::FONT_CHINESE_SIMPLIFIED,
+            PackBFTTF(SharedFontData::FONT_STANDARD, SharedFontData::FONT_STANDARD_SIZE,
                       "nintendo_udsg-r_org_zh-cn_003.bfttf"),
             PackBFTTF(SharedFontData::FONT_EXTENDED_CHINESE_SIMPLIFIED,
+                      SharedFontData::FONT_EXTENDED_CHINESE_SIMPLIFIED_SIZE,
                       "nintendo_udsg-r_ext_zh-cn_003.bfttf"),
         },
         std::vector<VirtualDir>{});
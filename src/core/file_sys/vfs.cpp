@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <future>
 #include <numeric>
 #include <string>
 #include "common/common_paths.h"
@@ -187,6 +189,10 @@ std::vector<u8> VfsFile::ReadAllBytes() const {
     return ReadBytes(GetSize());
 }
 
+const u8* VfsFile::GetDirectView(std::size_t offset, std::size_t length) const {
+    return nullptr;
+}
+
 bool VfsFile::WriteByte(u8 data, std::size_t offset) {
     return Write(&data, 1, offset) == 1;
 }
@@ -510,20 +516,54 @@ bool DeepEquals(const VirtualFile& file1, const VirtualFile& file2, std::size_t
 }
 
 bool VfsRawCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size) {
+    return VfsRawCopyWithProgress(src, dest, block_size, {});
+}
+
+bool VfsRawCopyWithProgress(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size,
+                            const VfsCopyProgress& progress) {
     if (src == nullptr || dest == nullptr || !src->IsReadable() || !dest->IsWritable())
         return false;
     if (!dest->Resize(src->GetSize()))
         return false;
 
-    std::vector<u8> temp(std::min(block_size, src->GetSize()));
-    for (std::size_t i = 0; i < src->GetSize(); i += block_size) {
-        const auto read = std::min(block_size, src->GetSize() - i);
+    // Files that can be viewed in place are written without the bounce buffer
+    if (const u8* const view = src->GetDirectView(0, src->GetSize()); view != nullptr) {
+        for (std::size_t i = 0; i < src->GetSize(); i += block_size) {
+            const auto size = std::min(block_size, src->GetSize() - i);
+            if (dest->Write(view + i, size, i) != size) {
+                return false;
+            }
+            if (progress && !progress(i + size)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Large files read the next block on another thread while the current one is written
+    const std::size_t size = src->GetSize();
+    const auto policy = size > block_size ? std::launch::async : std::launch::deferred;
+    std::array<std::vector<u8>, 2> buffers;
+    const auto read_block = [&src, &buffers, size, block_size](std::size_t offset) {
+        auto& buffer = buffers[(offset / block_size) % 2];
+        buffer.resize(std::min(block_size, size - offset));
+        return src->Read(buffer.data(), buffer.size(), offset) == buffer.size();
+    };
 
-        if (src->Read(temp.data(), read, i) != read) {
+    std::future<bool> pending_read = std::async(policy, read_block, 0);
+    for (std::size_t offset = 0; offset < size; offset += block_size) {
+        if (!pending_read.get()) {
             return false;
         }
+        if (offset + block_size < size) {
+            pending_read = std::async(policy, read_block, offset + block_size);
+        }
 
-        if (dest->Write(temp.data(), read, i) != read) {
+        const auto& buffer = buffers[(offset / block_size) % 2];
+        if (dest->Write(buffer.data(), buffer.size(), offset) != buffer.size()) {
+            return false;
+        }
+        if (progress && !progress(offset + buffer.size())) {
             return false;
         }
     }
@@ -174,6 +174,11 @@ public:
 
     // Returns the full path of this file as a string, recursively
     virtual std::string GetFullPath() const;
+
+    // Returns a pointer to length bytes of the file starting at offset when they can be accessed
+    // in place, or nullptr when they have to be read. The view stays valid as long as the file is
+    // alive and not written to.
+    virtual const u8* GetDirectView(std::size_t offset, std::size_t length) const;
 };
 
 // A class representing a directory in an abstract filesystem.
@@ -302,6 +307,14 @@ bool DeepEquals(const VirtualFile& file1, const VirtualFile& file2,
 // directory of src/dest.
 bool VfsRawCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size = 0x1000);
 
+// Called with the number of bytes copied so far, returning false cancels the copy.
+using VfsCopyProgress = std::function<bool(std::size_t)>;
+
+// A method that performs the same function as VfsRawCopy above, but reports its progress after
+// every block so it can be shown and cancelled while running on another thread.
+bool VfsRawCopyWithProgress(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size,
+                            const VfsCopyProgress& progress);
+
 // A method that performs a similar function to VfsRawCopy above, but instead copies entire
 // directories. It suffers the same performance penalties as above and an implementation-specific
 // Copy should always be preferred.
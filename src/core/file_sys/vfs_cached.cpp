@@ -0,0 +1,235 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/shared_cache_file.h"
+#include "core/file_sys/vfs_cached.h"
+#include "core/settings.h"
+
+namespace FileSys {
+
+namespace {
+
+/// Reads of this size or larger, usually streamed assets, go straight to the base file so they
+/// don't push out the small and frequently read headers and tables.
+constexpr std::size_t BYPASS_SIZE = 0x100000;
+
+std::size_t GetBudget() {
+    return static_cast<std::size_t>(Settings::values.nca_cache_size) * 0x100000;
+}
+
+} // Anonymous namespace
+
+std::shared_ptr<Common::SharedCacheFile> OpenSharedContent(u64 content_id, std::size_t size,
+                                                           std::size_t block_size) {
+    if (!Settings::values.use_shared_content_cache) {
+        return nullptr;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<u64, std::weak_ptr<Common::SharedCacheFile>> open_contents;
+    std::lock_guard lock{mutex};
+    if (auto shared = open_contents[content_id].lock()) {
+        return shared->GetSize() == size && shared->GetBlockSize() == block_size ? shared
+                                                                                  : nullptr;
+    }
+
+    const std::string directory =
+        FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "shared" DIR_SEP;
+    FileUtil::CreateFullPath(directory);
+    std::shared_ptr<Common::SharedCacheFile> shared = Common::SharedCacheFile::Open(
+        fmt::format("{}{:016X}.bin", directory, content_id), size, block_size);
+    open_contents[content_id] = shared;
+    return shared;
+}
+
+SectorCache& SectorCache::GetInstance() {
+    static SectorCache instance;
+    return instance;
+}
+
+bool SectorCache::Read(u64 content_id, std::size_t sector, u8* data, std::size_t length,
+                       std::size_t offset) {
+    std::lock_guard lock{mutex};
+    const auto it = lookup.find({content_id, sector});
+    if (it == lookup.end() || it->second->data.size() < offset + length) {
+        ++stats.misses;
+        return false;
+    }
+    ++stats.hits;
+    entries.splice(entries.begin(), entries, it->second);
+    std::memcpy(data, it->second->data.data() + offset, length);
+    return true;
+}
+
+void SectorCache::Insert(u64 content_id, std::size_t sector, std::vector<u8> data) {
+    const std::size_t budget = GetBudget();
+    std::lock_guard lock{mutex};
+    if (data.size() > budget) {
+        EvictToBudget(budget);
+        return;
+    }
+
+    const Key key{content_id, sector};
+    if (const auto it = lookup.find(key); it != lookup.end()) {
+        stats.size -= it->second->data.size();
+        entries.erase(it->second);
+        lookup.erase(it);
+    }
+    EvictToBudget(budget - data.size());
+
+    stats.size += data.size();
+    entries.push_front({key, std::move(data)});
+    lookup.emplace(key, entries.begin());
+}
+
+void SectorCache::Clear() {
+    std::lock_guard lock{mutex};
+    entries.clear();
+    lookup.clear();
+    stats.size = 0;
+}
+
+SectorCache::Stats SectorCache::GetStats() const {
+    std::lock_guard lock{mutex};
+    return stats;
+}
+
+void SectorCache::EvictToBudget(std::size_t budget) {
+    while (stats.size > budget) {
+        const Entry& entry = entries.back();
+        stats.size -= entry.data.size();
+        ++stats.evictions;
+        lookup.erase(entry.key);
+        entries.pop_back();
+    }
+}
+
+CachedVfsFile::CachedVfsFile(VirtualFile base_, u64 content_id_)
+    : base(std::move(base_)), content_id(content_id_) {}
+
+CachedVfsFile::~CachedVfsFile() = default;
+
+std::string CachedVfsFile::GetName() const {
+    return base->GetName();
+}
+
+std::size_t CachedVfsFile::GetSize() const {
+    return base->GetSize();
+}
+
+bool CachedVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+std::shared_ptr<VfsDirectory> CachedVfsFile::GetContainingDirectory() const {
+    return base->GetContainingDirectory();
+}
+
+bool CachedVfsFile::IsWritable() const {
+    return false;
+}
+
+bool CachedVfsFile::IsReadable() const {
+    return base->IsReadable();
+}
+
+std::size_t CachedVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    const std::size_t size = GetSize();
+    if (offset >= size) {
+        return 0;
+    }
+    length = std::min(length, size - offset);
+    if (Common::SharedCacheFile* const shared = GetSharedContent()) {
+        return ReadShared(*shared, data, length, offset);
+    }
+    if (length >= BYPASS_SIZE || GetBudget() == 0) {
+        return base->Read(data, length, offset);
+    }
+
+    auto& cache = SectorCache::GetInstance();
+    const std::size_t end = offset + length;
+    std::size_t read = 0;
+    for (std::size_t sector = offset / SectorCache::SECTOR_SIZE; read < length; ++sector) {
+        const std::size_t sector_start = sector * SectorCache::SECTOR_SIZE;
+        const std::size_t sector_offset = offset + read - sector_start;
+        const std::size_t chunk =
+            std::min(end, sector_start + SectorCache::SECTOR_SIZE) - (offset + read);
+        if (cache.Read(content_id, sector, data + read, chunk, sector_offset)) {
+            read += chunk;
+            continue;
+        }
+
+        std::vector<u8> sector_data(std::min(SectorCache::SECTOR_SIZE, size - sector_start));
+        sector_data.resize(base->Read(sector_data.data(), sector_data.size(), sector_start));
+        if (sector_data.size() <= sector_offset) {
+            return read;
+        }
+        const std::size_t copied = std::min(chunk, sector_data.size() - sector_offset);
+        std::memcpy(data + read, sector_data.data() + sector_offset, copied);
+        read += copied;
+        // Only whole sectors are kept, so a short read is never served from the cache later
+        if (copied != chunk) {
+            return read;
+        }
+        cache.Insert(content_id, sector, std::move(sector_data));
+    }
+    return read;
+}
+
+std::size_t CachedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool CachedVfsFile::Rename(std::string_view name) {
+    return false;
+}
+
+u64 CachedVfsFile::GetContentID() const {
+    return content_id;
+}
+
+Common::SharedCacheFile* CachedVfsFile::GetSharedContent() const {
+    std::call_once(shared_content_flag, [this] {
+        shared_content = OpenSharedContent(content_id, GetSize(), SectorCache::SECTOR_SIZE);
+    });
+    return shared_content.get();
+}
+
+std::size_t CachedVfsFile::ReadShared(Common::SharedCacheFile& shared, u8* data,
+                                      std::size_t length, std::size_t offset) const {
+    std::vector<u8> sector_data;
+    std::size_t read = 0;
+    while (read < length) {
+        const std::size_t sector = (offset + read) / SectorCache::SECTOR_SIZE;
+        const std::size_t sector_offset = offset + read - sector * SectorCache::SECTOR_SIZE;
+        const std::size_t sector_size = shared.GetBlockSize(sector);
+        const std::size_t chunk = std::min(length - read, sector_size - sector_offset);
+
+        const u8* sector_pointer = shared.GetBlock(sector);
+        if (sector_pointer == nullptr) {
+            sector_data.resize(sector_size);
+            const std::size_t sector_read = base->Read(
+                sector_data.data(), sector_size, sector * SectorCache::SECTOR_SIZE);
+            // Only whole sectors are shared, a short read is returned as is
+            if (sector_read != sector_size) {
+                const std::size_t copied =
+                    sector_read > sector_offset ? std::min(chunk, sector_read - sector_offset) : 0;
+                std::memcpy(data + read, sector_data.data() + sector_offset, copied);
+                return read + copied;
+            }
+            shared.StoreBlock(sector, sector_data.data());
+            sector_pointer = sector_data.data();
+        }
+        std::memcpy(data + read, sector_pointer + sector_offset, chunk);
+        read += chunk;
+    }
+    return read;
+}
+
+} // namespace FileSys
@@ -0,0 +1,124 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/hash.h"
+#include "core/file_sys/vfs.h"
+
+namespace Common {
+class SharedCacheFile;
+}
+
+namespace FileSys {
+
+/**
+ * Opens the cache file through which running instances share the contents identified by
+ * content_id, so they are only produced once for all of them. Instances that open the same
+ * content get the same mapping.
+ * @returns null when Settings::values.use_shared_content_cache is off or the file can't be used
+ */
+std::shared_ptr<Common::SharedCacheFile> OpenSharedContent(u64 content_id, std::size_t size,
+                                                           std::size_t block_size);
+
+/**
+ * Least recently used cache of file sectors, shared by every CachedVfsFile. Sectors are keyed by
+ * a content ID instead of by file, so every open handle to the same content shares its entries.
+ * The memory budget is Settings::values.nca_cache_size, in MiB, and zero disables the cache.
+ */
+class SectorCache {
+public:
+    static constexpr std::size_t SECTOR_SIZE = 0x4000;
+
+    struct Stats {
+        u64 hits;
+        u64 misses;
+        u64 evictions;
+        std::size_t size; ///< Bytes currently held by the cache
+
+        /// Returns the fraction of sector lookups served by the cache
+        double HitRate() const {
+            const u64 lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    static SectorCache& GetInstance();
+
+    /**
+     * Copies part of a cached sector.
+     * @returns true when the sector was in the cache.
+     */
+    bool Read(u64 content_id, std::size_t sector, u8* data, std::size_t length,
+              std::size_t offset);
+
+    /// Stores a sector, evicting the least recently used sectors that exceed the budget.
+    void Insert(u64 content_id, std::size_t sector, std::vector<u8> data);
+
+    /// Drops every sector of every content.
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    using Key = std::pair<u64, std::size_t>;
+
+    struct Entry {
+        Key key;
+        std::vector<u8> data;
+    };
+
+    void EvictToBudget(std::size_t budget);
+
+    mutable std::mutex mutex;
+    std::list<Entry> entries; ///< Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, Common::PairHash> lookup;
+    Stats stats{};
+};
+
+// A read-only VfsFile that serves reads of another file through the sector cache. Meant to sit
+// above layers that are expensive to read, like the decryption of a NCA section. When contents are
+// shared between instances, every read is served from the shared sectors instead.
+class CachedVfsFile : public VfsFile {
+public:
+    /// content_id must be unique to the contents of base.
+    CachedVfsFile(VirtualFile base, u64 content_id);
+    ~CachedVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    std::shared_ptr<VfsDirectory> GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view name) override;
+
+    u64 GetContentID() const;
+
+private:
+    /// Returns the shared sectors of the contents, opening them on the first read
+    Common::SharedCacheFile* GetSharedContent() const;
+
+    std::size_t ReadShared(Common::SharedCacheFile& shared, u8* data, std::size_t length,
+                           std::size_t offset) const;
+
+    VirtualFile base;
+    u64 content_id;
+
+    mutable std::once_flag shared_content_flag;
+    mutable std::shared_ptr<Common::SharedCacheFile> shared_content;
+};
+
+} // namespace FileSys
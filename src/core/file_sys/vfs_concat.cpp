@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "common/assert.h"
@@ -136,4 +137,19 @@ bool ConcatenatedVfsFile::Rename(std::string_view name) {
     return false;
 }
 
+const u8* ConcatenatedVfsFile::GetDirectView(std::size_t offset, std::size_t length) const {
+    // Only ranges inside a single file can be viewed
+    const auto next = files.upper_bound(offset);
+    if (next == files.begin()) {
+        return nullptr;
+    }
+    const auto entry = std::prev(next);
+    const std::size_t file_offset = offset - entry->first;
+    const std::size_t file_size = entry->second->GetSize();
+    if (file_offset > file_size || length > file_size - file_offset) {
+        return nullptr;
+    }
+    return entry->second->GetDirectView(file_offset, length);
+}
+
 } // namespace FileSys
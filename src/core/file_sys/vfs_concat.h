@@ -37,6 +37,7 @@ public:
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
+    const u8* GetDirectView(std::size_t offset, std::size_t length) const override;
 
 private:
     // Maps starting offset to file -- more efficient.
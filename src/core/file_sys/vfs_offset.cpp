@@ -87,10 +87,21 @@ bool OffsetVfsFile::Rename(std::string_view name) {
     return file->Rename(name);
 }
 
+const u8* OffsetVfsFile::GetDirectView(std::size_t r_offset, std::size_t length) const {
+    if (r_offset > size || length > size - r_offset) {
+        return nullptr;
+    }
+    return file->GetDirectView(offset + r_offset, length);
+}
+
 std::size_t OffsetVfsFile::GetOffset() const {
     return offset;
 }
 
+std::shared_ptr<VfsFile> OffsetVfsFile::GetBaseFile() const {
+    return file;
+}
+
 std::size_t OffsetVfsFile::TrimToFit(std::size_t r_size, std::size_t r_offset) const {
     return std::clamp(r_size, std::size_t{0}, size - r_offset);
 }
@@ -36,8 +36,10 @@ public:
     std::size_t WriteBytes(const std::vector<u8>& data, std::size_t offset) override;
 
     bool Rename(std::string_view name) override;
+    const u8* GetDirectView(std::size_t offset, std::size_t length) const override;
 
     std::size_t GetOffset() const;
+    std::shared_ptr<VfsFile> GetBaseFile() const;
 
 private:
     std::size_t TrimToFit(std::size_t r_size, std::size_t r_offset) const;
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <utility>
 #include "common/assert.h"
@@ -14,6 +15,12 @@
 
 namespace FileSys {
 
+// Files smaller than this are read through stdio, game images are way larger
+constexpr u64 MIN_MAPPED_FILE_SIZE = 0x100000;
+
+// Reads of at least this size are likely part of a scan of the file, like a copy or a hash
+constexpr std::size_t SEQUENTIAL_READ_SIZE = 0x100000;
+
 static std::string ModeFlagsToString(Mode mode) {
     std::string mode_str;
 
@@ -66,10 +73,12 @@ VfsEntryType RealVfsFilesystem::GetEntryType(std::string_view path_) const {
 
 VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, Mode perms) {
     const auto path = FileUtil::SanitizePath(path_, FileUtil::DirectorySeparator::PlatformDefault);
+    std::lock_guard lock{cache_mutex};
     if (cache.find(path) != cache.end()) {
         auto weak = cache[path];
         if (!weak.expired()) {
-            return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, weak.lock(), path, perms));
+            return std::shared_ptr<RealVfsFile>(new RealVfsFile(
+                *this, weak.lock(), path, perms, perms == Mode::Read ? GetMapping(path) : nullptr));
         }
     }
 
@@ -80,7 +89,8 @@ VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, Mode perms) {
     cache[path] = backing;
 
     // Cannot use make_shared as RealVfsFile constructor is private
-    return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, backing, path, perms));
+    return std::shared_ptr<RealVfsFile>(new RealVfsFile(
+        *this, backing, path, perms, perms == Mode::Read ? GetMapping(path) : nullptr));
 }
 
 VirtualFile RealVfsFilesystem::CreateFile(std::string_view path_, Mode perms) {
@@ -116,13 +126,17 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
         FileUtil::IsDirectory(old_path) || !FileUtil::Rename(old_path, new_path))
         return nullptr;
 
-    if (cache.find(old_path) != cache.end()) {
-        auto cached = cache[old_path];
-        if (!cached.expired()) {
-            auto file = cached.lock();
-            file->Open(new_path, "r+b");
-            cache.erase(old_path);
-            cache[new_path] = file;
+    {
+        std::lock_guard lock{cache_mutex};
+        mappings.erase(old_path);
+        if (cache.find(old_path) != cache.end()) {
+            auto cached = cache[old_path];
+            if (!cached.expired()) {
+                auto file = cached.lock();
+                file->Open(new_path, "r+b");
+                cache.erase(old_path);
+                cache[new_path] = file;
+            }
         }
     }
     return OpenFile(new_path, Mode::ReadWrite);
@@ -130,6 +144,8 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
 
 bool RealVfsFilesystem::DeleteFile(std::string_view path_) {
     const auto path = FileUtil::SanitizePath(path_, FileUtil::DirectorySeparator::PlatformDefault);
+    std::lock_guard lock{cache_mutex};
+    mappings.erase(path);
     if (cache.find(path) != cache.end()) {
         if (!cache[path].expired())
             cache[path].lock()->Close();
@@ -176,32 +192,42 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
     const auto new_path =
         FileUtil::SanitizePath(new_path_, FileUtil::DirectorySeparator::PlatformDefault);
     if (!FileUtil::Exists(old_path) || FileUtil::Exists(new_path) ||
-        FileUtil::IsDirectory(old_path) || !FileUtil::Rename(old_path, new_path))
+        !FileUtil::IsDirectory(old_path) || !FileUtil::Rename(old_path, new_path))
         return nullptr;
 
-    for (auto& kv : cache) {
-        // Path in cache starts with old_path
-        if (kv.first.rfind(old_path, 0) == 0) {
-            const auto file_old_path =
-                FileUtil::SanitizePath(kv.first, FileUtil::DirectorySeparator::PlatformDefault);
-            const auto file_new_path =
-                FileUtil::SanitizePath(new_path + DIR_SEP + kv.first.substr(old_path.size()),
-                                       FileUtil::DirectorySeparator::PlatformDefault);
-            auto cached = cache[file_old_path];
-            if (!cached.expired()) {
-                auto file = cached.lock();
-                file->Open(file_new_path, "r+b");
-                cache.erase(file_old_path);
-                cache[file_new_path] = file;
-            }
+    std::unique_lock lock{cache_mutex};
+    std::vector<std::string> moved_paths;
+    for (const auto& kv : cache) {
+        // Path in cache is inside old_path, and not merely a sibling that shares its prefix
+        const auto& file_path = kv.first;
+        if (file_path.size() > old_path.size() && file_path.rfind(old_path, 0) == 0 &&
+            (file_path[old_path.size()] == '/' || file_path[old_path.size()] == '\\')) {
+            moved_paths.push_back(file_path);
+        }
+    }
+    for (const auto& file_old_path : moved_paths) {
+        const auto file_new_path =
+            FileUtil::SanitizePath(new_path + DIR_SEP + file_old_path.substr(old_path.size()),
+                                   FileUtil::DirectorySeparator::PlatformDefault);
+        auto cached = cache[file_old_path];
+        cache.erase(file_old_path);
+        if (!cached.expired()) {
+            auto file = cached.lock();
+            file->Open(file_new_path, "r+b");
+            cache[file_new_path] = file;
         }
     }
+    lock.unlock();
 
     return OpenDirectory(new_path, Mode::ReadWrite);
 }
 
 bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
     const auto path = FileUtil::SanitizePath(path_, FileUtil::DirectorySeparator::PlatformDefault);
+    std::lock_guard lock{cache_mutex};
+    for (auto it = mappings.begin(); it != mappings.end();) {
+        it = it->first.rfind(path, 0) == 0 ? mappings.erase(it) : std::next(it);
+    }
     for (auto& kv : cache) {
         // Path in cache starts with old_path
         if (kv.first.rfind(path, 0) == 0) {
@@ -213,9 +239,27 @@ bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
     return FileUtil::DeleteDirRecursively(path);
 }
 
+std::shared_ptr<FileUtil::MappedFile> RealVfsFilesystem::GetMapping(const std::string& path) {
+    if (const auto it = mappings.find(path); it != mappings.end()) {
+        if (auto mapping = it->second.lock()) {
+            return mapping;
+        }
+    }
+    if (FileUtil::GetSize(path) < MIN_MAPPED_FILE_SIZE) {
+        return nullptr;
+    }
+    auto mapping = std::make_shared<FileUtil::MappedFile>(path);
+    if (!mapping->IsOpen()) {
+        return nullptr;
+    }
+    mappings[path] = mapping;
+    return mapping;
+}
+
 RealVfsFile::RealVfsFile(RealVfsFilesystem& base_, std::shared_ptr<FileUtil::IOFile> backing_,
-                         const std::string& path_, Mode perms_)
-    : base(base_), backing(std::move(backing_)), path(path_),
+                         const std::string& path_, Mode perms_,
+                         std::shared_ptr<FileUtil::MappedFile> mapping_)
+    : base(base_), backing(std::move(backing_)), mapping(std::move(mapping_)), path(path_),
       parent_path(FileUtil::GetParentPath(path_)),
       path_components(FileUtil::SplitPathComponents(path_)),
       parent_components(FileUtil::SliceVector(path_components, 0, path_components.size() - 1)),
@@ -228,6 +272,9 @@ std::string RealVfsFile::GetName() const {
 }
 
 std::size_t RealVfsFile::GetSize() const {
+    if (mapping != nullptr) {
+        return mapping->GetSize();
+    }
     return backing->GetSize();
 }
 
@@ -248,6 +295,17 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (mapping != nullptr) {
+        if (offset >= mapping->GetSize()) {
+            return 0;
+        }
+        const auto read = std::min<std::size_t>(length, mapping->GetSize() - offset);
+        if (read >= SEQUENTIAL_READ_SIZE) {
+            mapping->Advise(offset, read, FileUtil::MappedFile::AccessPattern::Sequential);
+        }
+        std::memcpy(data, mapping->GetData() + offset, read);
+        return read;
+    }
     if (!backing->Seek(offset, SEEK_SET))
         return 0;
     return backing->ReadBytes(data, length);
@@ -263,6 +321,13 @@ bool RealVfsFile::Rename(std::string_view name) {
     return base.MoveFile(path, parent_path + DIR_SEP + std::string(name)) != nullptr;
 }
 
+const u8* RealVfsFile::GetDirectView(std::size_t offset, std::size_t length) const {
+    if (mapping == nullptr || offset > mapping->GetSize() || length > mapping->GetSize() - offset) {
+        return nullptr;
+    }
+    return mapping->GetData() + offset;
+}
+
 bool RealVfsFile::Close() {
     return backing->Close();
 }
@@ -404,7 +469,7 @@ bool RealVfsDirectory::DeleteFile(std::string_view name) {
 
 bool RealVfsDirectory::Rename(std::string_view name) {
     const std::string new_name = (parent_path + DIR_SEP).append(name);
-    return base.MoveFile(path, new_name) != nullptr;
+    return base.MoveDirectory(path, new_name) != nullptr;
 }
 
 std::string RealVfsDirectory::GetFullPath() const {
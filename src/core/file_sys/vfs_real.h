@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string_view>
 #include <boost/container/flat_map.hpp>
 #include "core/file_sys/mode.h"
@@ -11,7 +12,8 @@
 
 namespace FileUtil {
 class IOFile;
-}
+class MappedFile;
+} // namespace FileUtil
 
 namespace FileSys {
 
@@ -36,7 +38,14 @@ public:
     bool DeleteDirectory(std::string_view path) override;
 
 private:
+    /// Returns a shared mapping of a file that is large enough to be worth mapping, or nullptr.
+    /// The cache mutex must be held.
+    std::shared_ptr<FileUtil::MappedFile> GetMapping(const std::string& path);
+
+    /// Guards the handle and mapping caches, files can be opened from several threads
+    std::mutex cache_mutex;
     boost::container::flat_map<std::string, std::weak_ptr<FileUtil::IOFile>> cache;
+    boost::container::flat_map<std::string, std::weak_ptr<FileUtil::MappedFile>> mappings;
 };
 
 // An implmentation of VfsFile that represents a file on the user's computer.
@@ -56,15 +65,19 @@ public:
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
+    const u8* GetDirectView(std::size_t offset, std::size_t length) const override;
 
 private:
     RealVfsFile(RealVfsFilesystem& base, std::shared_ptr<FileUtil::IOFile> backing,
-                const std::string& path, Mode perms = Mode::Read);
+                const std::string& path, Mode perms = Mode::Read,
+                std::shared_ptr<FileUtil::MappedFile> mapping = nullptr);
 
     bool Close();
 
     RealVfsFilesystem& base;
     std::shared_ptr<FileUtil::IOFile> backing;
+    // Read-only files are served from a mapping when there is one
+    std::shared_ptr<FileUtil::MappedFile> mapping;
     std::string path;
     std::string parent_path;
     std::vector<std::string> path_components;
@@ -38,6 +38,8 @@ bool VectorVfsFile::IsReadable() const {
 }
 
 std::size_t VectorVfsFile::Read(u8* data_, std::size_t length, std::size_t offset) const {
+    if (offset >= data.size())
+        return 0;
     const auto read = std::min(length, data.size() - offset);
     std::memcpy(data_, data.data() + offset, read);
     return read;
@@ -56,6 +58,13 @@ bool VectorVfsFile::Rename(std::string_view name_) {
     return true;
 }
 
+const u8* VectorVfsFile::GetDirectView(std::size_t offset, std::size_t length) const {
+    if (offset > data.size() || length > data.size() - offset) {
+        return nullptr;
+    }
+    return data.data() + offset;
+}
+
 void VectorVfsFile::Assign(std::vector<u8> new_data) {
     data = std::move(new_data);
 }
@@ -55,6 +55,13 @@ public:
         return true;
     }
 
+    const u8* GetDirectView(std::size_t offset, std::size_t length) const override {
+        if (offset > size || length > size - offset) {
+            return nullptr;
+        }
+        return data.data() + offset;
+    }
+
 private:
     std::array<u8, size> data;
     std::string name;
@@ -77,6 +84,7 @@ public:
     std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
     std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
     bool Rename(std::string_view name) override;
+    const u8* GetDirectView(std::size_t offset, std::size_t length) const override;
 
     virtual void Assign(std::vector<u8> new_data);
 
@@ -0,0 +1,90 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "core/frame_timeline.h"
+
+namespace Core {
+
+namespace {
+
+/// Innermost timer running on the calling thread
+thread_local FrameTimeline::ScopedTimer* current_timer = nullptr;
+
+} // Anonymous namespace
+
+FrameTimeline::ScopedTimer::ScopedTimer(Stage stage_)
+    : stage{stage_}, start{std::chrono::steady_clock::now()}, parent{current_timer} {
+    if (parent) {
+        GetInstance().AddTime(parent->stage, start - parent->start);
+    }
+    current_timer = this;
+}
+
+FrameTimeline::ScopedTimer::~ScopedTimer() {
+    const auto end = std::chrono::steady_clock::now();
+    GetInstance().AddTime(stage, end - start);
+    current_timer = parent;
+    if (parent) {
+        // The parent resumes from here
+        parent->start = end;
+    }
+}
+
+FrameTimeline& FrameTimeline::GetInstance() {
+    static FrameTimeline instance;
+    return instance;
+}
+
+const char* FrameTimeline::GetStageName(Stage stage) {
+    static constexpr std::array<const char*, NUM_STAGES> names{
+        "jit",   "svc",  "hle",    "idle",          "dma_parse",
+        "macro", "draw", "shader", "texture_cache", "host_gpu",
+    };
+    return names[static_cast<std::size_t>(stage)];
+}
+
+void FrameTimeline::AddTime(Stage stage, std::chrono::nanoseconds time) {
+    stage_ns[static_cast<std::size_t>(stage)].fetch_add(static_cast<u64>(time.count()),
+                                                        std::memory_order_relaxed);
+}
+
+void FrameTimeline::EndFrame(bool record) {
+    std::lock_guard lock{frame_mutex};
+    ++frames_since_reset;
+
+    std::array<u64, NUM_STAGES> totals;
+    for (std::size_t stage = 0; stage < NUM_STAGES; ++stage) {
+        totals[stage] = stage_ns[stage].load(std::memory_order_relaxed);
+    }
+    if (record && recorded_frames.size() < MAX_RECORDED_FRAMES) {
+        StageTimes& frame = recorded_frames.emplace_back();
+        for (std::size_t stage = 0; stage < NUM_STAGES; ++stage) {
+            frame[stage] = static_cast<double>(totals[stage] - frame_start_ns[stage]) / 1e9;
+        }
+    }
+    frame_start_ns = totals;
+}
+
+FrameTimeline::StageTimes FrameTimeline::GetAndReset() {
+    std::lock_guard lock{frame_mutex};
+    StageTimes times{};
+    for (std::size_t stage = 0; stage < NUM_STAGES; ++stage) {
+        const u64 total = stage_ns[stage].load(std::memory_order_relaxed);
+        if (frames_since_reset != 0) {
+            times[stage] = static_cast<double>(total - reset_ns[stage]) / 1e9 /
+                           static_cast<double>(frames_since_reset);
+        }
+        reset_ns[stage] = total;
+    }
+    frames_since_reset = 0;
+    return times;
+}
+
+std::vector<FrameTimeline::StageTimes> FrameTimeline::TakeRecordedFrames() {
+    std::lock_guard lock{frame_mutex};
+    return std::exchange(recorded_frames, {});
+}
+
+} // namespace Core
@@ -0,0 +1,87 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core {
+
+/**
+ * Process wide breakdown of the walltime of the emulated frames by what it was spent on. Stages
+ * are timed exclusively: a timer started while another one runs on the same thread pauses it, so
+ * the time spent in a service is not counted again as time spent in the SVC that called it.
+ * The emulated cores add up their times, the host GPU times come from the renderers. Every
+ * function can be called from any thread.
+ */
+class FrameTimeline {
+public:
+    enum class Stage : std::size_t {
+        Jit,           ///< Emulated CPU running guest code
+        Svc,           ///< Emulated CPU handling supervisor calls
+        Hle,           ///< Emulated CPU handling service requests
+        Idle,          ///< Emulated CPU idle or frame limiting
+        DmaParse,      ///< GPU decoding the command lists
+        Macro,         ///< GPU executing macros
+        DrawSetup,     ///< GPU setting up draws and compute dispatches
+        ShaderCompile, ///< GPU building shaders and pipelines
+        TextureCache,  ///< GPU looking up and creating surfaces
+        HostGpu,       ///< Host GPU executing the work of a frame
+        Count,
+    };
+    static constexpr std::size_t NUM_STAGES = static_cast<std::size_t>(Stage::Count);
+
+    /// Time spent on each stage, in seconds
+    using StageTimes = std::array<double, NUM_STAGES>;
+
+    /// Measures the lifetime of the timer as time spent on a stage.
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Stage stage);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Stage stage;
+        std::chrono::steady_clock::time_point start;
+        ScopedTimer* parent;
+    };
+
+    static FrameTimeline& GetInstance();
+
+    static const char* GetStageName(Stage stage);
+
+    void AddTime(Stage stage, std::chrono::nanoseconds time);
+
+    /// Ends the current system frame, recording its times when recording is enabled.
+    void EndFrame(bool record);
+
+    /// Returns the average time of each stage per frame since the last call, and resets them.
+    StageTimes GetAndReset();
+
+    /// Returns the frames recorded so far, and clears them.
+    std::vector<StageTimes> TakeRecordedFrames();
+
+private:
+    /// An hour of frames at 60 Hz
+    static constexpr std::size_t MAX_RECORDED_FRAMES = 216000;
+
+    std::array<std::atomic<u64>, NUM_STAGES> stage_ns{};
+
+    std::mutex frame_mutex;
+    std::array<u64, NUM_STAGES> frame_start_ns{}; ///< Totals when the current frame began
+    std::array<u64, NUM_STAGES> reset_ns{};       ///< Totals at the last reset
+    u64 frames_since_reset = 0;
+    std::vector<StageTimes> recorded_frames;
+};
+
+} // namespace Core
@@ -75,6 +75,17 @@ public:
         return nullptr;
     }
 
+    /**
+     * Returns a GraphicsContext shared with the emu window that draws to the window itself, so
+     * frames can be presented from a thread other than the one rendering them. Its SwapBuffers
+     * presents the frame like the window's own SwapBuffers does, which is then no longer called.
+     *
+     * If the return value is null, the frontend can't present from another thread
+     */
+    virtual std::unique_ptr<GraphicsContext> CreatePresentationContext() const {
+        return nullptr;
+    }
+
     /// Returns if window is shown (not minimized)
     virtual bool IsShown() const = 0;
 
@@ -0,0 +1,65 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include "core/frontend/input_latency.h"
+
+namespace Input::Latency {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Arrival time of the oldest event no update has read yet, zero when there is none
+std::atomic<s64> pending_event_ns{};
+
+/// Arrival time of the oldest event read by the update in progress, zero when there is none
+s64 update_event_ns{};
+
+std::atomic<u64> total_ns{};
+std::atomic<u64> max_ns{};
+std::atomic<u32> num_samples{};
+
+s64 Now() {
+    const auto now = Clock::now().time_since_epoch();
+    // Make sure no valid time collides with the zero that means none
+    return std::max<s64>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+} // Anonymous namespace
+
+void RecordEvent() {
+    s64 expected = 0;
+    pending_event_ns.compare_exchange_strong(expected, Now());
+}
+
+void BeginUpdate() {
+    update_event_ns = pending_event_ns.exchange(0);
+}
+
+void EndUpdate() {
+    if (update_event_ns == 0) {
+        return;
+    }
+    const auto latency = static_cast<u64>(Now() - update_event_ns);
+    update_event_ns = 0;
+
+    total_ns += latency;
+    ++num_samples;
+    u64 current_max = max_ns.load();
+    while (latency > current_max && !max_ns.compare_exchange_weak(current_max, latency)) {
+    }
+}
+
+Stats GetAndResetStats() {
+    const u64 total = total_ns.exchange(0);
+    const u64 max = max_ns.exchange(0);
+    const u32 samples = num_samples.exchange(0);
+    const double mean = samples == 0 ? 0.0 : static_cast<double>(total) / 1e9 / samples;
+    return {mean, static_cast<double>(max) / 1e9, samples};
+}
+
+} // namespace Input::Latency
@@ -0,0 +1,34 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+/**
+ * Measures the walltime between a host input event and the first HID update that makes the new
+ * state visible to the guest. Input backends record their events from any thread, HID marks its
+ * updates from the emulation thread.
+ */
+namespace Input::Latency {
+
+struct Stats {
+    double mean; ///< Mean latency in seconds
+    double max;  ///< Largest latency in seconds
+    u32 samples; ///< Number of updates that had events pending
+};
+
+/// Records that a host input event changed the state of an input device.
+void RecordEvent();
+
+/// Marks the start of a HID update, before it reads the input devices.
+void BeginUpdate();
+
+/// Marks the end of a HID update, once the shared memory has been written.
+void EndUpdate();
+
+/// Returns the latency statistics collected since the last call.
+Stats GetAndResetStats();
+
+} // namespace Input::Latency
@@ -13,6 +13,8 @@
 #include <cstring>
 #include <map>
 #include <numeric>
+#include <string_view>
+#include <vector>
 #include <fcntl.h>
 
 #ifdef _WIN32
@@ -24,6 +26,7 @@
 #define SHUT_RDWR 2
 #else
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -45,7 +48,13 @@
 
 namespace GDBStub {
 namespace {
-constexpr int GDB_BUFFER_SIZE = 10000;
+constexpr int GDB_BUFFER_SIZE = 0x10000;
+
+// Largest packet advertised to the client, leaving room for the framing and the checksum
+constexpr std::size_t GDB_MAX_PACKET_SIZE = GDB_BUFFER_SIZE - 4;
+
+// Bytes received from the client are buffered so a packet usually takes a single recv call
+constexpr std::size_t GDB_RECEIVE_BUFFER_SIZE = 0x1000;
 
 constexpr char GDB_STUB_START = '$';
 constexpr char GDB_STUB_END = '#';
@@ -60,10 +69,6 @@ constexpr u32 SIGTRAP = 5;
 constexpr u32 SIGTERM = 15;
 #endif
 
-#ifndef MSG_WAITALL
-constexpr u32 MSG_WAITALL = 8;
-#endif
-
 constexpr u32 LR_REGISTER = 30;
 constexpr u32 SP_REGISTER = 31;
 constexpr u32 PC_REGISTER = 32;
@@ -72,10 +77,9 @@ constexpr u32 UC_ARM64_REG_Q0 = 34;
 constexpr u32 FPCR_REGISTER = 66;
 
 // For sample XML files see the GDB source /gdb/features
-// GDB also wants the l character at the start
 // This XML defines what the registers are for this specific ARM device
 constexpr char target_xml[] =
-    R"(l<?xml version="1.0"?>
+    R"(<?xml version="1.0"?>
 <!DOCTYPE target SYSTEM "gdb-target.dtd">
 <target version="1.0">
   <feature name="org.gnu.gdb.aarch64.core">
@@ -145,6 +149,16 @@ int gdbserver_socket = -1;
 u8 command_buffer[GDB_BUFFER_SIZE];
 u32 command_length;
 
+std::array<u8, GDB_RECEIVE_BUFFER_SIZE> receive_buffer;
+std::size_t receive_position = 0;
+std::size_t receive_length = 0;
+
+// Acks are queued here and go out along with the reply of the packet they acknowledge
+std::vector<u8> send_buffer;
+
+// Set when the client understands the 'b' prefix of the binary memory read reply
+bool binary_upload_prefix = false;
+
 u32 latest_signal = 0;
 bool memory_break = false;
 
@@ -454,16 +468,23 @@ static u128 GdbHexToU128(const u8* src) {
     return output;
 }
 
-/// Read a byte from the gdb client.
+/// Read a byte from the gdb client, refilling the receive buffer once it has been consumed.
 static u8 ReadByte() {
-    u8 c;
-    std::size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
-    if (received_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "recv failed: {}", received_size);
-        Shutdown();
+    if (receive_position == receive_length) {
+        const int received_size =
+            recv(gdbserver_socket, reinterpret_cast<char*>(receive_buffer.data()),
+                 static_cast<int>(receive_buffer.size()), 0);
+        if (received_size <= 0) {
+            LOG_ERROR(Debug_GDBStub, "recv failed: {}", received_size);
+            Shutdown();
+            return 0;
+        }
+
+        receive_position = 0;
+        receive_length = static_cast<std::size_t>(received_size);
     }
 
-    return c;
+    return receive_buffer[receive_position++];
 }
 
 /// Calculate the checksum of the current command buffer.
@@ -510,7 +531,7 @@ static void RemoveBreakpoint(BreakpointType type, VAddr addr) {
     if (type == BreakpointType::Execute) {
         auto& system = Core::System::GetInstance();
         system.Memory().WriteBlock(bp->second.addr, bp->second.inst.data(), bp->second.inst.size());
-        system.InvalidateCpuInstructionCaches();
+        system.InvalidateCpuInstructionCacheRange(bp->second.addr, bp->second.inst.size());
     }
     p.erase(addr);
 }
@@ -568,58 +589,111 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
     return false;
 }
 
+/// Send everything queued in the send buffer to the gdb client.
+static void FlushSendBuffer() {
+    const u8* ptr = send_buffer.data();
+    std::size_t left = send_buffer.size();
+    send_buffer.clear();
+
+    while (left > 0 && IsConnected()) {
+        const int sent_size = send(gdbserver_socket, reinterpret_cast<const char*>(ptr),
+                                   static_cast<int>(left), 0);
+        if (sent_size < 0) {
+            LOG_ERROR(Debug_GDBStub, "gdb: send failed");
+            return Shutdown();
+        }
+
+        left -= static_cast<std::size_t>(sent_size);
+        ptr += sent_size;
+    }
+}
+
 /**
- * Send packet to gdb client.
+ * Queue packet to be sent to gdb client along with the next reply.
  *
  * @param packet Packet to be sent to client.
  */
 static void SendPacket(const char packet) {
-    std::size_t sent_size = send(gdbserver_socket, &packet, 1, 0);
-    if (sent_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "send failed");
-    }
+    send_buffer.push_back(static_cast<u8>(packet));
 }
 
 /**
  * Send reply to gdb client.
  *
- * @param reply Reply to be sent to client.
+ * @param reply Reply to be sent to client, which may hold escaped binary data.
  */
-static void SendReply(const char* reply) {
+static void SendReply(std::string_view reply) {
     if (!IsConnected()) {
         return;
     }
 
     LOG_DEBUG(Debug_GDBStub, "Reply: {}", reply);
 
-    memset(command_buffer, 0, sizeof(command_buffer));
-
-    command_length = static_cast<u32>(strlen(reply));
-    if (command_length + 4 > sizeof(command_buffer)) {
-        LOG_ERROR(Debug_GDBStub, "command_buffer overflow in SendReply");
-        return;
+    if (reply.size() > GDB_MAX_PACKET_SIZE) {
+        LOG_ERROR(Debug_GDBStub, "Reply of {} bytes is larger than the packet size",
+                  reply.size());
+        reply = "E01";
     }
 
-    memcpy(command_buffer + 1, reply, command_length);
+    const auto* const data = reinterpret_cast<const u8*>(reply.data());
+    const u8 checksum = CalculateChecksum(data, reply.size());
+    send_buffer.push_back(GDB_STUB_START);
+    send_buffer.insert(send_buffer.end(), data, data + reply.size());
+    send_buffer.push_back(GDB_STUB_END);
+    send_buffer.push_back(NibbleToHex(checksum >> 4));
+    send_buffer.push_back(NibbleToHex(checksum));
 
-    u8 checksum = CalculateChecksum(command_buffer, command_length + 1);
-    command_buffer[0] = GDB_STUB_START;
-    command_buffer[command_length + 1] = GDB_STUB_END;
-    command_buffer[command_length + 2] = NibbleToHex(checksum >> 4);
-    command_buffer[command_length + 3] = NibbleToHex(checksum);
+    FlushSendBuffer();
+}
 
-    u8* ptr = command_buffer;
-    u32 left = command_length + 4;
-    while (left > 0) {
-        int sent_size = send(gdbserver_socket, reinterpret_cast<char*>(ptr), left, 0);
-        if (sent_size < 0) {
-            LOG_ERROR(Debug_GDBStub, "gdb: send failed");
-            return Shutdown();
+/**
+ * Append binary data to a reply, escaping the bytes that have a meaning in the protocol.
+ *
+ * @param reply Reply to append the data to.
+ * @param data  Pointer to the data.
+ * @param len   Length of the data.
+ */
+static void AppendEscapedBinary(std::string& reply, const u8* data, std::size_t len) {
+    constexpr char GDB_STUB_ESCAPE = '}';
+    for (std::size_t i = 0; i < len; ++i) {
+        const char c = static_cast<char>(data[i]);
+        if (c == GDB_STUB_START || c == GDB_STUB_END || c == GDB_STUB_ESCAPE || c == '*') {
+            reply += GDB_STUB_ESCAPE;
+            reply += static_cast<char>(c ^ 0x20);
+        } else {
+            reply += c;
         }
+    }
+}
 
-        left -= sent_size;
-        ptr += sent_size;
+/**
+ * Send the part of a qXfer object requested by the gdb client.
+ *
+ * @param annex  Arguments of the query after the annex, as "offset,length".
+ * @param object Whole object being transferred.
+ */
+static void SendXferReply(const char* annex, std::string_view object) {
+    const auto* const begin = reinterpret_cast<const u8*>(annex);
+    const auto* const end = command_buffer + command_length;
+    const auto* const separator = std::find(begin, end, ',');
+    if (separator == end) {
+        return SendReply("E01");
+    }
+
+    const u64 offset = HexToLong(begin, static_cast<std::size_t>(separator - begin));
+    // Escaping can double the size of the data, so the part has to fit in a packet either way
+    const u64 length = std::min<u64>(
+        HexToLong(separator + 1, static_cast<std::size_t>(end - separator - 1)),
+        (GDB_MAX_PACKET_SIZE - 1) / 2);
+    if (offset > object.size()) {
+        return SendReply("E01");
     }
+
+    // 'm' tells the client there is more to read, 'l' that this is the last part
+    const std::string_view part = object.substr(offset, length);
+    std::string buffer(1, offset + part.size() < object.size() ? 'm' : 'l');
+    AppendEscapedBinary(buffer, reinterpret_cast<const u8*>(part.data()), part.size());
+    SendReply(buffer);
 }
 
 /// Handle query command from gdb client.
@@ -631,15 +705,22 @@ static void HandleQuery() {
     if (strcmp(query, "TStatus") == 0) {
         SendReply("T0");
     } else if (strncmp(query, "Supported", strlen("Supported")) == 0) {
-        // PacketSize needs to be large enough for target xml
-        std::string buffer = "PacketSize=2000;qXfer:features:read+;qXfer:threads:read+";
+        // GDB only prefixes binary memory reads with 'b' when it says it supports it
+        binary_upload_prefix = strstr(query, "binary-upload+") != nullptr;
+
+        std::string buffer = fmt::format(
+            "PacketSize={:x};qXfer:features:read+;qXfer:threads:read+;vContSupported+",
+            GDB_MAX_PACKET_SIZE);
+        if (binary_upload_prefix) {
+            buffer += ";binary-upload+";
+        }
         if (!modules.empty()) {
             buffer += ";qXfer:libraries:read+";
         }
-        SendReply(buffer.c_str());
+        SendReply(buffer);
     } else if (strncmp(query, "Xfer:features:read:target.xml:",
                        strlen("Xfer:features:read:target.xml:")) == 0) {
-        SendReply(target_xml);
+        SendXferReply(query + strlen("Xfer:features:read:target.xml:"), target_xml);
     } else if (strncmp(query, "Offsets", strlen("Offsets")) == 0) {
         const VAddr base_address =
             Core::System::GetInstance().CurrentProcess()->VMManager().GetCodeRegionBaseAddress();
@@ -655,9 +736,9 @@ static void HandleQuery() {
         SendReply(val.c_str());
     } else if (strncmp(query, "sThreadInfo", strlen("sThreadInfo")) == 0) {
         SendReply("l");
-    } else if (strncmp(query, "Xfer:threads:read", strlen("Xfer:threads:read")) == 0) {
+    } else if (strncmp(query, "Xfer:threads:read::", strlen("Xfer:threads:read::")) == 0) {
         std::string buffer;
-        buffer += "l<?xml version=\"1.0\"?>";
+        buffer += "<?xml version=\"1.0\"?>";
         buffer += "<threads>";
         const auto& threads = Core::System::GetInstance().GlobalScheduler().GetThreadList();
         for (const auto& thread : threads) {
@@ -666,18 +747,18 @@ static void HandleQuery() {
                             thread->GetThreadID(), thread->GetProcessorID(), thread->GetThreadID());
         }
         buffer += "</threads>";
-        SendReply(buffer.c_str());
-    } else if (strncmp(query, "Xfer:libraries:read", strlen("Xfer:libraries:read")) == 0) {
+        SendXferReply(query + strlen("Xfer:threads:read::"), buffer);
+    } else if (strncmp(query, "Xfer:libraries:read::", strlen("Xfer:libraries:read::")) == 0) {
         std::string buffer;
-        buffer += "l<?xml version=\"1.0\"?>";
+        buffer += "<?xml version=\"1.0\"?>";
         buffer += "<library-list>";
         for (const auto& module : modules) {
             buffer +=
-                fmt::format(R"*("<library name = "{}"><segment address = "0x{:x}"/></library>)*",
+                fmt::format(R"*(<library name = "{}"><segment address = "0x{:x}"/></library>)*",
                             module.name, module.beg);
         }
         buffer += "</library-list>";
-        SendReply(buffer.c_str());
+        SendXferReply(query + strlen("Xfer:libraries:read::"), buffer);
     } else {
         SendReply("");
     }
@@ -769,8 +850,13 @@ static void ReadCommand() {
     }
 
     while ((c = ReadByte()) != GDB_STUB_END) {
+        if (!IsConnected()) {
+            command_length = 0;
+            return;
+        }
         if (command_length >= sizeof(command_buffer)) {
             LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow");
+            command_length = 0;
             SendPacket(GDB_STUB_NACK);
             return;
         }
@@ -802,6 +888,10 @@ static bool IsDataAvailable() {
         return false;
     }
 
+    if (receive_position != receive_length) {
+        return true;
+    }
+
     fd_set fd_socket;
 
     FD_ZERO(&fd_socket);
@@ -967,7 +1057,7 @@ static void ReadMemory() {
     LOG_DEBUG(Debug_GDBStub, "gdb: addr: {:016X} len: {:016X}", addr, len);
 
     if (len * 2 > sizeof(reply)) {
-        SendReply("E01");
+        return SendReply("E01");
     }
 
     auto& memory = Core::System::GetInstance().Memory();
@@ -983,6 +1073,45 @@ static void ReadMemory() {
     SendReply(reinterpret_cast<char*>(reply));
 }
 
+/// Read location in memory specified by gdb client, replying with binary data.
+static void ReadMemoryBinary() {
+    auto start_offset = command_buffer + 1;
+    const auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
+    const VAddr addr = HexToLong(start_offset, static_cast<u64>(addr_pos - start_offset));
+
+    start_offset = addr_pos + 1;
+    const u64 len =
+        HexToLong(start_offset, static_cast<u64>((command_buffer + command_length) - start_offset));
+
+    LOG_DEBUG(Debug_GDBStub, "gdb: binary addr: {:016X} len: {:016X}", addr, len);
+
+    // Every byte might need escaping, so the whole read has to fit twice in a packet
+    if (len * 2 + 1 > GDB_MAX_PACKET_SIZE) {
+        return SendReply("E01");
+    }
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (len != 0 && !memory.IsValidVirtualAddress(addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data(len);
+    memory.ReadBlock(addr, data.data(), len);
+
+    std::string reply;
+    reply.reserve(len * 2 + 1);
+    if (binary_upload_prefix) {
+        reply += 'b';
+    }
+    AppendEscapedBinary(reply, data.data(), data.size());
+
+    // An empty reply would mean the packet isn't supported
+    if (reply.empty()) {
+        return SendReply("OK");
+    }
+    SendReply(reply);
+}
+
 /// Modify location in memory with data received from the gdb client.
 static void WriteMemory() {
     auto start_offset = command_buffer + 1;
@@ -1002,7 +1131,7 @@ static void WriteMemory() {
     std::vector<u8> data(len);
     GdbHexToMem(data.data(), len_pos + 1, len);
     memory.WriteBlock(addr, data.data(), len);
-    system.InvalidateCpuInstructionCaches();
+    system.InvalidateCpuInstructionCacheRange(addr, len);
     SendReply("OK");
 }
 
@@ -1012,6 +1141,14 @@ void Break(bool is_memory_break) {
     memory_break = is_memory_break;
 }
 
+/// Tell the CPU that it should perform a single step of the current thread.
+static void StepCurrentThread() {
+    step_loop = true;
+    halt_loop = true;
+    send_trap = true;
+    Core::System::GetInstance().InvalidateCpuInstructionCaches();
+}
+
 /// Tell the CPU that it should perform a single step.
 static void Step() {
     if (command_length > 1) {
@@ -1021,10 +1158,7 @@ static void Step() {
             .ArmInterface(current_core)
             .LoadContext(current_thread->GetContext());
     }
-    step_loop = true;
-    halt_loop = true;
-    send_trap = true;
-    Core::System::GetInstance().InvalidateCpuInstructionCaches();
+    StepCurrentThread();
 }
 
 /// Tell the CPU if we hit a memory breakpoint.
@@ -1044,6 +1178,54 @@ static void Continue() {
     Core::System::GetInstance().InvalidateCpuInstructionCaches();
 }
 
+/**
+ * Handle the resume actions of a vCont packet from gdb client, so the client can select the
+ * thread and resume it in a single round trip. Threads can't be resumed on their own, so a step
+ * of any thread steps it while everything else waits, and otherwise everything continues.
+ *
+ * @returns true when execution was resumed.
+ */
+static bool HandleVCont() {
+    const char* packet = reinterpret_cast<const char*>(command_buffer);
+    if (strcmp(packet, "vCont?") == 0) {
+        SendReply("vCont;c;C;s;S");
+        return false;
+    }
+
+    const u8* const end = command_buffer + command_length;
+    const u8* action = command_buffer + strlen("vCont");
+    if (action == end || *action != ';') {
+        SendReply("E01");
+        return false;
+    }
+
+    while (action != end) {
+        ++action;
+        const u8* const action_end = std::find(action, end, ';');
+        if (*action == 's' || *action == 'S') {
+            // A thread id of -1 means all threads, which leaves the current one selected
+            const u8* const thread_pos = std::find(action, action_end, ':');
+            if (thread_pos != action_end && thread_pos[1] != '-') {
+                const auto thread_id = static_cast<s64>(HexToLong(
+                    thread_pos + 1, static_cast<std::size_t>(action_end - thread_pos - 1)));
+                if (auto* const thread = FindThreadById(thread_id)) {
+                    current_thread = thread;
+                }
+            }
+            StepCurrentThread();
+            return true;
+        }
+        if (*action != 'c' && *action != 'C') {
+            SendReply("E01");
+            return false;
+        }
+        action = action_end;
+    }
+
+    Continue();
+    return true;
+}
+
 /**
  * Commit breakpoint to list of breakpoints.
  *
@@ -1066,7 +1248,7 @@ static bool CommitBreakpoint(BreakpointType type, VAddr addr, u64 len) {
     static constexpr std::array<u8, 4> btrap{0x00, 0x7d, 0x20, 0xd4};
     if (type == BreakpointType::Execute) {
         memory.WriteBlock(addr, btrap.data(), btrap.size());
-        system.InvalidateCpuInstructionCaches();
+        system.InvalidateCpuInstructionCacheRange(addr, btrap.size());
     }
     p.insert({addr, breakpoint});
 
@@ -1175,6 +1357,8 @@ void HandlePacket() {
 
     ReadCommand();
     if (command_length == 0) {
+        // Send the nack of a packet that couldn't be read, if any
+        FlushSendBuffer();
         return;
     }
 
@@ -1212,13 +1396,30 @@ void HandlePacket() {
     case 'M':
         WriteMemory();
         break;
+    case 'x':
+        ReadMemoryBinary();
+        break;
     case 's':
         Step();
+        // There is no reply until the step is done, so only the ack goes out now
+        FlushSendBuffer();
         return;
     case 'C':
     case 'c':
         Continue();
+        FlushSendBuffer();
         return;
+    case 'v':
+        if (strncmp(reinterpret_cast<const char*>(command_buffer), "vCont", strlen("vCont")) == 0 &&
+            (command_buffer[5] == ';' || command_buffer[5] == '?')) {
+            if (HandleVCont()) {
+                FlushSendBuffer();
+                return;
+            }
+        } else {
+            SendReply("");
+        }
+        break;
     case 'z':
         RemoveBreakpoint();
         break;
@@ -1275,6 +1476,11 @@ static void Init(u16 port) {
 
     modules.clear();
 
+    receive_position = 0;
+    receive_length = 0;
+    send_buffer.clear();
+    binary_upload_prefix = false;
+
     // Start gdb server
     LOG_INFO(Debug_GDBStub, "Starting GDB server on port {}...", port);
 
@@ -1325,6 +1531,13 @@ static void Init(u16 port) {
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.");
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
+
+        // Replies are sent as whole packets, so there is nothing to gain from coalescing them
+        int no_delay = 1;
+        if (setsockopt(gdbserver_socket, IPPROTO_TCP, TCP_NODELAY,
+                       reinterpret_cast<const char*>(&no_delay), sizeof(no_delay)) < 0) {
+            LOG_WARNING(Debug_GDBStub, "Failed to disable Nagle's algorithm on gdb socket");
+        }
     }
 
     // Clean up temporary socket if it's still alive at this point.
@@ -56,6 +56,11 @@ ResultCode AddressArbiter::SignalToAddress(VAddr address, SignalType type, s32 v
 }
 
 ResultCode AddressArbiter::SignalToAddressOnly(VAddr address, s32 num_to_wake) {
+    // Signalling an address nobody is parked on never needs to touch the scheduler.
+    if (!HasThreadsWaitingOnAddress(address)) {
+        return RESULT_SUCCESS;
+    }
+
     const std::vector<std::shared_ptr<Thread>> waiting_threads =
         GetThreadsWaitingOnAddress(address);
     WakeThreads(waiting_threads, num_to_wake);
@@ -215,12 +220,20 @@ void AddressArbiter::InsertThread(std::shared_ptr<Thread> thread) {
 
 void AddressArbiter::RemoveThread(std::shared_ptr<Thread> thread) {
     const VAddr arb_addr = thread->GetArbiterWaitAddress();
-    std::list<std::shared_ptr<Thread>>& thread_list = arb_threads[arb_addr];
+    const auto list_iter = arb_threads.find(arb_addr);
+    ASSERT(list_iter != arb_threads.end());
+
+    std::list<std::shared_ptr<Thread>>& thread_list = list_iter->second;
     auto it = thread_list.begin();
     while (it != thread_list.end()) {
         const std::shared_ptr<Thread>& current_thread = *it;
         if (current_thread.get() == thread.get()) {
             thread_list.erase(it);
+
+            // Only keep addresses that still have waiters around, so lookups stay cheap.
+            if (thread_list.empty()) {
+                arb_threads.erase(list_iter);
+            }
             return;
         }
         ++it;
@@ -228,15 +241,17 @@ void AddressArbiter::RemoveThread(std::shared_ptr<Thread> thread) {
     UNREACHABLE();
 }
 
+bool AddressArbiter::HasThreadsWaitingOnAddress(VAddr address) const {
+    return arb_threads.find(address) != arb_threads.end();
+}
+
 std::vector<std::shared_ptr<Thread>> AddressArbiter::GetThreadsWaitingOnAddress(VAddr address) {
-    std::vector<std::shared_ptr<Thread>> result;
-    std::list<std::shared_ptr<Thread>>& thread_list = arb_threads[address];
-    auto it = thread_list.begin();
-    while (it != thread_list.end()) {
-        std::shared_ptr<Thread> current_thread = *it;
-        result.push_back(std::move(current_thread));
-        ++it;
+    const auto list_iter = arb_threads.find(address);
+    if (list_iter == arb_threads.end()) {
+        return {};
     }
-    return result;
+
+    const std::list<std::shared_ptr<Thread>>& thread_list = list_iter->second;
+    return {thread_list.begin(), thread_list.end()};
 }
 } // namespace Kernel
@@ -53,6 +53,17 @@ public:
     /// Removes a thread from the container and resets its address arbiter adress to 0
     void HandleWakeupThread(std::shared_ptr<Thread> thread);
 
+    /// Threads waiting on each address, see Core::SaveState.
+    using Snapshot = std::unordered_map<VAddr, std::list<std::shared_ptr<Thread>>>;
+
+    Snapshot TakeSnapshot() const {
+        return arb_threads;
+    }
+
+    void RestoreSnapshot(const Snapshot& snapshot) {
+        arb_threads = snapshot;
+    }
+
 private:
     /// Signals an address being waited on.
     ResultCode SignalToAddressOnly(VAddr address, s32 num_to_wake);
@@ -85,11 +96,15 @@ private:
     /// Removes a thread from the address arbiter container
     void RemoveThread(std::shared_ptr<Thread> thread);
 
+    /// Checks whether any thread is waiting on an address.
+    bool HasThreadsWaitingOnAddress(VAddr address) const;
+
     // Gets the threads waiting on an address.
     std::vector<std::shared_ptr<Thread>> GetThreadsWaitingOnAddress(VAddr address);
 
-    /// List of threads waiting for a address arbiter
-    std::unordered_map<VAddr, std::list<std::shared_ptr<Thread>>> arb_threads;
+    /// List of threads waiting for a address arbiter, keyed by the address they are parked on.
+    /// Entries are removed once their last waiter leaves.
+    Snapshot arb_threads;
 
     Core::System& system;
 };
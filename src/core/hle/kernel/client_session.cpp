@@ -5,8 +5,10 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/session.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/result.h"
 
@@ -34,7 +36,9 @@ void ClientSession::Acquire(Thread* thread) {
 ResultVal<std::shared_ptr<ClientSession>> ClientSession::Create(KernelCore& kernel,
                                                                 std::shared_ptr<Session> parent,
                                                                 std::string name) {
-    std::shared_ptr<ClientSession> client_session{std::make_shared<ClientSession>(kernel)};
+    const SlabAllocator<ClientSession> allocator{kernel.GetObjectHeap()};
+    std::shared_ptr<ClientSession> client_session{
+        std::allocate_shared<ClientSession>(allocator, kernel)};
 
     client_session->name = std::move(name);
     client_session->parent = std::move(parent);
@@ -112,6 +112,19 @@ std::shared_ptr<Object> HandleTable::GetGeneric(Handle handle) const {
     return objects[GetSlot(handle)];
 }
 
+Object* HandleTable::GetGenericPointer(Handle handle) const {
+    if (handle == CurrentThread) {
+        return GetCurrentThread();
+    } else if (handle == CurrentProcess) {
+        return Core::System::GetInstance().CurrentProcess();
+    }
+
+    if (!IsValid(handle)) {
+        return nullptr;
+    }
+    return objects[GetSlot(handle)].get();
+}
+
 void HandleTable::Clear() {
     for (u16 i = 0; i < table_size; ++i) {
         generations[i] = i + 1;
@@ -120,4 +133,16 @@ void HandleTable::Clear() {
     next_free_slot = 0;
 }
 
+HandleTable::Snapshot HandleTable::TakeSnapshot() const {
+    return {objects, generations, table_size, next_generation, next_free_slot};
+}
+
+void HandleTable::RestoreSnapshot(const Snapshot& snapshot) {
+    objects = snapshot.objects;
+    generations = snapshot.generations;
+    table_size = snapshot.table_size;
+    next_generation = snapshot.next_generation;
+    next_free_slot = snapshot.next_free_slot;
+}
+
 } // namespace Kernel
@@ -106,9 +106,46 @@ public:
         return DynamicObjectCast<T>(GetGeneric(handle));
     }
 
+    /**
+     * Looks up a handle without taking a reference to the object. This avoids touching the
+     * object's reference count, so it is preferred for lookups that don't retain the object.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid. The pointer
+     *         only stays valid for as long as the handle (or another reference) is kept alive.
+     */
+    Object* GetGenericPointer(Handle handle) const;
+
+    /**
+     * Looks up a handle while verifying its type, without taking a reference to the object.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid or its
+     *         type differs from the requested one.
+     */
+    template <class T>
+    T* GetPointer(Handle handle) const {
+        Object* const object = GetGenericPointer(handle);
+        if (object != nullptr && object->GetHandleType() == T::HANDLE_TYPE) {
+            return static_cast<T*>(object);
+        }
+        return nullptr;
+    }
+
     /// Closes all handles held in this table.
     void Clear();
 
+    /// Handles of the table, see Core::SaveState.
+    struct Snapshot {
+        std::array<std::shared_ptr<Object>, MAX_COUNT> objects;
+        std::array<u16, MAX_COUNT> generations;
+        u16 table_size;
+        u16 next_generation;
+        u16 next_free_slot;
+    };
+
+    Snapshot TakeSnapshot() const;
+
+    /// Replaces the handles with the ones of the snapshot. Objects that were only referenced by
+    /// handles created since the snapshot are destroyed.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
 private:
     /// Stores the Object referenced by the handle or null if the slot is empty.
     std::array<std::shared_ptr<Object>, MAX_COUNT> objects;
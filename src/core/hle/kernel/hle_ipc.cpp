@@ -298,6 +298,49 @@ std::vector<u8> HLERequestContext::ReadBuffer(int buffer_index) const {
     return buffer;
 }
 
+/// Returns the scratch buffer for the given buffer index, sized to hold the given amount of bytes.
+static std::vector<u8>& GetScratchBuffer(std::vector<std::vector<u8>>& scratch_buffers,
+                                         int buffer_index, std::size_t size) {
+    const auto index = static_cast<std::size_t>(buffer_index);
+    if (index >= scratch_buffers.size()) {
+        scratch_buffers.resize(index + 1);
+    }
+    auto& scratch = scratch_buffers[index];
+    scratch.resize(size);
+    return scratch;
+}
+
+BufferView<const u8> HLERequestContext::ReadBufferView(int buffer_index) const {
+    const bool is_buffer_a{BufferDescriptorA().size() && BufferDescriptorA()[buffer_index].Size()};
+    const VAddr address = is_buffer_a ? BufferDescriptorA()[buffer_index].Address()
+                                      : BufferDescriptorX()[buffer_index].Address();
+    const std::size_t size = GetReadBufferSize(buffer_index);
+    auto& memory = Core::System::GetInstance().Memory();
+
+    if (const u8* const host_ptr = memory.GetContiguousPointer(address, size)) {
+        return {host_ptr, size};
+    }
+
+    auto& scratch = GetScratchBuffer(read_scratch_buffers, buffer_index, size);
+    memory.ReadBlock(address, scratch.data(), size);
+    return {scratch.data(), size};
+}
+
+BufferView<u8> HLERequestContext::WriteBufferView(int buffer_index) const {
+    const bool is_buffer_b{BufferDescriptorB().size() && BufferDescriptorB()[buffer_index].Size()};
+    const VAddr address = is_buffer_b ? BufferDescriptorB()[buffer_index].Address()
+                                      : BufferDescriptorC()[buffer_index].Address();
+    const std::size_t size = GetWriteBufferSize(buffer_index);
+
+    if (u8* const host_ptr =
+            Core::System::GetInstance().Memory().GetContiguousPointer(address, size)) {
+        return {host_ptr, size};
+    }
+
+    auto& scratch = GetScratchBuffer(write_scratch_buffers, buffer_index, size);
+    return {scratch.data(), size};
+}
+
 std::size_t HLERequestContext::WriteBuffer(const void* buffer, std::size_t size,
                                            int buffer_index) const {
     if (size == 0) {
@@ -314,12 +357,15 @@ std::size_t HLERequestContext::WriteBuffer(const void* buffer, std::size_t size,
     }
 
     auto& memory = Core::System::GetInstance().Memory();
-    if (is_buffer_b) {
-        memory.WriteBlock(BufferDescriptorB()[buffer_index].Address(), buffer, size);
-    } else {
-        memory.WriteBlock(BufferDescriptorC()[buffer_index].Address(), buffer, size);
+    const VAddr address = is_buffer_b ? BufferDescriptorB()[buffer_index].Address()
+                                      : BufferDescriptorC()[buffer_index].Address();
+
+    // Data produced through WriteBufferView may already live in guest memory.
+    if (memory.GetContiguousPointer(address, size) == buffer) {
+        return size;
     }
 
+    memory.WriteBlock(address, buffer, size);
     return size;
 }
 
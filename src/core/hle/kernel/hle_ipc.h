@@ -36,6 +36,38 @@ class WritableEvent;
 
 enum class ThreadWakeupReason;
 
+/// Non-owning view over the contents of an IPC buffer.
+template <typename T>
+class BufferView {
+public:
+    constexpr BufferView() = default;
+    constexpr BufferView(T* data, std::size_t size) : ptr{data}, length{size} {}
+
+    constexpr T* data() const {
+        return ptr;
+    }
+
+    constexpr std::size_t size() const {
+        return length;
+    }
+
+    constexpr bool empty() const {
+        return length == 0;
+    }
+
+    constexpr T* begin() const {
+        return ptr;
+    }
+
+    constexpr T* end() const {
+        return ptr + length;
+    }
+
+private:
+    T* ptr = nullptr;
+    std::size_t length = 0;
+};
+
 /**
  * Interface implemented by HLE Session handlers.
  * This can be provided to a ServerSession in order to hook into several relevant events
@@ -181,6 +213,21 @@ public:
     /// Helper function to read a buffer using the appropriate buffer descriptor
     std::vector<u8> ReadBuffer(int buffer_index = 0) const;
 
+    /**
+     * Helper function to access an input buffer without copying it. The view refers directly to
+     * guest memory when the buffer is contiguous in host memory, and to a scratch copy owned by
+     * this context otherwise. It stays valid until the context is destroyed or the same buffer
+     * is viewed again.
+     */
+    BufferView<const u8> ReadBufferView(int buffer_index = 0) const;
+
+    /**
+     * Helper function to fill an output buffer in place. The view refers directly to guest memory
+     * when possible, and to a scratch buffer owned by this context otherwise. Once filled, the
+     * data has to be passed to WriteBuffer, which skips the copy if it is already in place.
+     */
+    BufferView<u8> WriteBufferView(int buffer_index = 0) const;
+
     /// Helper function to write a buffer using the appropriate buffer descriptor
     std::size_t WriteBuffer(const void* buffer, std::size_t size, int buffer_index = 0) const;
 
@@ -303,6 +350,11 @@ private:
 
     std::vector<std::shared_ptr<SessionRequestHandler>> domain_request_handlers;
     bool is_thread_waiting{};
+
+    /// Fallback storage for buffer views that cannot refer to guest memory directly, indexed by
+    /// buffer index.
+    mutable std::vector<std::vector<u8>> read_scratch_buffers;
+    mutable std::vector<std::vector<u8>> write_scratch_buffers;
 };
 
 } // namespace Kernel
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -23,10 +25,11 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/resource_limit.h"
 #include "core/hle/kernel/scheduler.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/thread.h"
-#include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
+#include "core/settings.h"
 
 namespace Kernel {
 
@@ -37,10 +40,10 @@ namespace Kernel {
  */
 static void ThreadWakeupCallback(u64 thread_handle, [[maybe_unused]] s64 cycles_late) {
     const auto proper_handle = static_cast<Handle>(thread_handle);
-    const auto& system = Core::System::GetInstance();
+    auto& system = Core::System::GetInstance();
 
     // Lock the global kernel mutex when we enter the kernel HLE.
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{system.Kernel().HLELock()};
 
     std::shared_ptr<Thread> thread =
         system.Kernel().RetrieveThreadFromWakeupCallbackHandleTable(proper_handle);
@@ -161,14 +164,22 @@ struct KernelCore::Impl {
     }
 
     void InitializePreemption() {
+        SchedulingPolicy policy;
+        policy.preemption_quantum = std::chrono::milliseconds(
+            std::max<u16>(Settings::values.preemption_quantum, 1));
+        policy.migration_cost_ticks = static_cast<u64>(
+            Core::Timing::usToCycles(std::chrono::microseconds(Settings::values.migration_cost)));
+        global_scheduler.SetPolicy(policy);
+
         preemption_event =
             Core::Timing::CreateEvent("PreemptionCallback", [this](u64 userdata, s64 cycles_late) {
                 global_scheduler.PreemptThreads();
-                s64 time_interval = Core::Timing::msToCycles(std::chrono::milliseconds(10));
+                const s64 time_interval =
+                    Core::Timing::usToCycles(global_scheduler.GetPolicy().preemption_quantum);
                 system.CoreTiming().ScheduleEvent(time_interval, preemption_event);
             });
 
-        s64 time_interval = Core::Timing::msToCycles(std::chrono::milliseconds(10));
+        const s64 time_interval = Core::Timing::usToCycles(policy.preemption_quantum);
         system.CoreTiming().ScheduleEvent(time_interval, preemption_event);
     }
 
@@ -194,6 +205,8 @@ struct KernelCore::Impl {
 
     std::shared_ptr<ResourceLimit> system_resource_limit;
 
+    std::recursive_mutex hle_lock;
+
     std::shared_ptr<Core::Timing::EventType> thread_wakeup_event_type;
     std::shared_ptr<Core::Timing::EventType> preemption_event;
 
@@ -208,6 +221,8 @@ struct KernelCore::Impl {
     std::unique_ptr<Core::ExclusiveMonitor> exclusive_monitor;
     std::vector<Kernel::PhysicalCore> cores;
 
+    std::shared_ptr<SlabHeap> object_heap = std::make_shared<SlabHeap>();
+
     // System context
     Core::System& system;
 };
@@ -254,6 +269,10 @@ const std::vector<std::shared_ptr<Process>>& KernelCore::GetProcessList() const
     return impl->process_list;
 }
 
+std::recursive_mutex& KernelCore::HLELock() {
+    return impl->hle_lock;
+}
+
 Kernel::GlobalScheduler& KernelCore::GlobalScheduler() {
     return impl->global_scheduler;
 }
@@ -284,6 +303,16 @@ void KernelCore::InvalidateAllInstructionCaches() {
     }
 }
 
+void KernelCore::InvalidateInstructionCacheRange(VAddr addr, std::size_t size) {
+    for (std::size_t i = 0; i < impl->global_scheduler.CpuCoresCount(); i++) {
+        PhysicalCore(i).ArmInterface().InvalidateCacheRange(addr, size);
+    }
+}
+
+const std::shared_ptr<SlabHeap>& KernelCore::GetObjectHeap() const {
+    return impl->object_heap;
+}
+
 void KernelCore::PrepareReschedule(std::size_t id) {
     if (id < impl->global_scheduler.CpuCoresCount()) {
         impl->cores[id].Stop();
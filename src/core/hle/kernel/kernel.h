@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,6 +13,7 @@
 
 namespace Core {
 class ExclusiveMonitor;
+class SaveState;
 class System;
 } // namespace Core
 
@@ -29,6 +31,7 @@ class HandleTable;
 class PhysicalCore;
 class Process;
 class ResourceLimit;
+class SlabHeap;
 class Thread;
 
 /// Represents a single instance of the kernel.
@@ -80,6 +83,9 @@ public:
     /// Retrieves the list of processes.
     const std::vector<std::shared_ptr<Process>>& GetProcessList() const;
 
+    /// Gets the lock synchronizing host threads with the HLE kernel state, see HLE::GetLock.
+    std::recursive_mutex& HLELock();
+
     /// Gets the sole instance of the global scheduler
     Kernel::GlobalScheduler& GlobalScheduler();
 
@@ -101,6 +107,12 @@ public:
 
     void InvalidateAllInstructionCaches();
 
+    /// Drops translated code covering the given range of guest memory on all cores.
+    void InvalidateInstructionCacheRange(VAddr addr, std::size_t size);
+
+    /// Gets the heap that frequently created kernel objects are allocated from.
+    const std::shared_ptr<SlabHeap>& GetObjectHeap() const;
+
     /// Adds a port to the named port table
     void AddNamedPort(std::string name, std::shared_ptr<ClientPort> port);
 
@@ -117,6 +129,7 @@ private:
     friend class Object;
     friend class Process;
     friend class Thread;
+    friend class Core::SaveState;
 
     /// Creates a new object ID, incrementing the internal object ID counter.
     u32 CreateNewObjectID();
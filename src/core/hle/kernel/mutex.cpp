@@ -70,6 +70,14 @@ ResultCode Mutex::TryAcquire(VAddr address, Handle holding_thread_handle,
         return ERR_INVALID_ADDRESS;
     }
 
+    const u32 addr_value = system.Memory().Read32(address);
+
+    // If the mutex isn't being held, just return success. This is checked before touching any
+    // kernel object so that the guest losing a race against an unlock stays cheap.
+    if (addr_value != (holding_thread_handle | Mutex::MutexHasWaitersFlag)) {
+        return RESULT_SUCCESS;
+    }
+
     const auto& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
     std::shared_ptr<Thread> current_thread =
         SharedFrom(system.CurrentScheduler().GetCurrentThread());
@@ -80,13 +88,6 @@ ResultCode Mutex::TryAcquire(VAddr address, Handle holding_thread_handle,
     // thread.
     ASSERT(requesting_thread == current_thread);
 
-    const u32 addr_value = system.Memory().Read32(address);
-
-    // If the mutex isn't being held, just return success.
-    if (addr_value != (holding_thread_handle | Mutex::MutexHasWaitersFlag)) {
-        return RESULT_SUCCESS;
-    }
-
     if (holding_thread == nullptr) {
         return ERR_INVALID_HANDLE;
     }
@@ -112,8 +113,15 @@ ResultCode Mutex::Release(VAddr address) {
         return ERR_INVALID_ADDRESS;
     }
 
-    std::shared_ptr<Thread> current_thread =
-        SharedFrom(system.CurrentScheduler().GetCurrentThread());
+    Thread* const current_thread_ptr = system.CurrentScheduler().GetCurrentThread();
+
+    // Nobody is waiting on any mutex held by this thread, so release it without scanning waiters.
+    if (current_thread_ptr->GetMutexWaitingThreads().empty()) {
+        system.Memory().Write32(address, 0);
+        return RESULT_SUCCESS;
+    }
+
+    std::shared_ptr<Thread> current_thread = SharedFrom(current_thread_ptr);
     auto [thread, num_waiters] = GetHighestPriorityMutexWaitingThread(current_thread, address);
 
     // There are no more threads waiting for the mutex, release it completely.
@@ -4,17 +4,42 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/alignment.h"
+#include "common/memory_snapshot.h"
 
 namespace Kernel {
 
-// This encapsulation serves 2 purposes:
+/// Allocator of PhysicalMemory, which stops memory snapshots from tracking freed memory
+template <typename T>
+class PhysicalMemoryAllocator : public Common::AlignmentAllocator<T, 0x1000> {
+public:
+    constexpr PhysicalMemoryAllocator() noexcept = default;
+
+    template <typename T2>
+    constexpr PhysicalMemoryAllocator(const PhysicalMemoryAllocator<T2>&) noexcept {}
+
+    void deallocate(T* pointer, std::size_t size) {
+        Common::MemorySnapshot::ReleaseMemory(pointer, size * sizeof(T));
+        Common::AlignmentAllocator<T, 0x1000>::deallocate(pointer, size);
+    }
+
+    template <typename T2>
+    struct rebind {
+        using other = PhysicalMemoryAllocator<T2>;
+    };
+};
+
+// This encapsulation serves 3 purposes:
 // - First, to encapsulate host physical memory under a single type and set an
 // standard for managing it.
 // - Second to ensure all host backing memory used is aligned to 256 bytes due
 // to strict alignment restrictions on GPU memory.
+// - Third, to align it to guest pages, so memory snapshots can write-protect
+// each page on its own.
 
-using PhysicalMemoryVector = std::vector<u8, Common::AlignmentAllocator<u8, 256>>;
+using PhysicalMemoryVector = std::vector<u8, PhysicalMemoryAllocator<u8>>;
 class PhysicalMemory final : public PhysicalMemoryVector {
     using PhysicalMemoryVector::PhysicalMemoryVector;
 };
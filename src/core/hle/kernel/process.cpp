@@ -6,6 +6,7 @@
 #include <bitset>
 #include <memory>
 #include <random>
+#include <unordered_set>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -15,6 +16,7 @@
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
+#include "core/hle/kernel/readable_event.h"
 #include "core/hle/kernel/resource_limit.h"
 #include "core/hle/kernel/scheduler.h"
 #include "core/hle/kernel/thread.h"
@@ -336,6 +338,73 @@ void Process::LoadModule(CodeSet module_, VAddr base_addr) {
     MapSegment(module_.DataSegment(), VMAPermission::ReadWrite, MemoryState::CodeData);
 }
 
+struct Process::Snapshot {
+    struct WaitObjectState {
+        std::shared_ptr<WaitObject> object;
+        std::vector<std::shared_ptr<Thread>> waiting_threads;
+        bool is_event_signaled;
+    };
+
+    VMManager::Snapshot vm_manager;
+    HandleTable::Snapshot handle_table;
+    AddressArbiter::Snapshot address_arbiter;
+    std::vector<TLSPage> tls_pages;
+    std::list<const Thread*> thread_list;
+    std::unordered_map<VAddr, std::list<std::shared_ptr<Thread>>> cond_var_threads;
+    ProcessStatus status;
+    bool is_signaled;
+    u64 total_process_running_time_ticks;
+    std::vector<WaitObjectState> wait_objects;
+};
+
+std::shared_ptr<const Process::Snapshot> Process::TakeSnapshot() const {
+    auto snapshot = std::make_shared<Snapshot>(Snapshot{
+        vm_manager.TakeSnapshot(), handle_table.TakeSnapshot(), address_arbiter.TakeSnapshot(),
+        tls_pages, thread_list, cond_var_threads, status, is_signaled,
+        total_process_running_time_ticks, {}});
+
+    // The objects the guest can wait on are either behind its handles or waited on by its threads
+    std::unordered_set<const WaitObject*> visited;
+    const auto add_wait_object = [&](std::shared_ptr<WaitObject> object) {
+        if (object == nullptr || !visited.insert(object.get()).second) {
+            return;
+        }
+        const auto event = DynamicObjectCast<ReadableEvent>(object);
+        const bool is_event_signaled = event != nullptr && event->IsSignaled();
+        auto waiting_threads = object->GetWaitingThreads();
+        snapshot->wait_objects.push_back(
+            {std::move(object), std::move(waiting_threads), is_event_signaled});
+    };
+    for (const auto& object : snapshot->handle_table.objects) {
+        add_wait_object(DynamicObjectCast<WaitObject>(object));
+    }
+    for (const Thread* const thread : thread_list) {
+        for (const auto& object : thread->GetWaitObjects()) {
+            add_wait_object(object);
+        }
+    }
+    return snapshot;
+}
+
+void Process::RestoreSnapshot(const Snapshot& snapshot) {
+    vm_manager.RestoreSnapshot(snapshot.vm_manager);
+    handle_table.RestoreSnapshot(snapshot.handle_table);
+    address_arbiter.RestoreSnapshot(snapshot.address_arbiter);
+    tls_pages = snapshot.tls_pages;
+    thread_list = snapshot.thread_list;
+    cond_var_threads = snapshot.cond_var_threads;
+    status = snapshot.status;
+    is_signaled = snapshot.is_signaled;
+    total_process_running_time_ticks = snapshot.total_process_running_time_ticks;
+
+    for (const auto& state : snapshot.wait_objects) {
+        state.object->SetWaitingThreads(state.waiting_threads);
+        if (const auto event = DynamicObjectCast<ReadableEvent>(state.object)) {
+            event->SetSignaled(state.is_event_signaled);
+        }
+    }
+}
+
 Process::Process(Core::System& system)
     : WaitObject{system.Kernel()}, vm_manager{system},
       address_arbiter{system}, mutex{system}, system{system} {}
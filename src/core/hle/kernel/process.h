@@ -291,6 +291,16 @@ public:
 
     void LoadModule(CodeSet module_, VAddr base_addr);
 
+    /// State of the process that changes while it runs, see Core::SaveState. It's defined next to
+    /// the TLS pages it contains.
+    struct Snapshot;
+
+    std::shared_ptr<const Snapshot> TakeSnapshot() const;
+
+    /// Restores the address space, the handles and the bookkeeping of the threads of the process.
+    /// The threads themselves are restored separately.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Thread-local storage management
 
@@ -46,7 +46,19 @@ public:
     ///      then ERR_INVALID_STATE will be returned.
     ResultCode Reset();
 
+    bool IsSignaled() const {
+        return signaled;
+    }
+
+    /// Sets the state without waking up any thread, used to restore save states.
+    void SetSignaled(bool value) {
+        signaled = value;
+    }
+
 private:
+    template <typename T>
+    friend class SlabAllocator;
+
     explicit ReadableEvent(KernelCore& kernel);
 
     void Signal();
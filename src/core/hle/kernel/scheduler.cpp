@@ -6,7 +6,6 @@
 // licensed under GPLv2 or later under exception provided by the author.
 
 #include <algorithm>
-#include <set>
 #include <unordered_set>
 #include <utility>
 
@@ -21,7 +20,33 @@
 
 namespace Kernel {
 
-GlobalScheduler::GlobalScheduler(Core::System& system) : system{system} {}
+namespace {
+template <std::size_t... Cores>
+std::array<ThreadQueue, sizeof...(Cores)> MakeThreadQueues(std::size_t node_base,
+                                                           std::index_sequence<Cores...>) {
+    return {ThreadQueue{ThreadQueueNodeAccessor{node_base + Cores}}...};
+}
+
+GlobalScheduler::Snapshot::Queue SnapshotQueue(const ThreadQueue& queue, std::size_t node_index) {
+    GlobalScheduler::Snapshot::Queue entries;
+    for (Thread* const thread : queue) {
+        entries.push_back({thread, thread->GetSchedulingNode(node_index).priority});
+    }
+    return entries;
+}
+
+void RestoreQueue(ThreadQueue& queue, const GlobalScheduler::Snapshot::Queue& entries) {
+    queue.clear();
+    for (const auto& entry : entries) {
+        queue.add(entry.thread, entry.priority);
+    }
+}
+} // Anonymous namespace
+
+GlobalScheduler::GlobalScheduler(Core::System& system)
+    : scheduled_queue{MakeThreadQueues(0, std::make_index_sequence<NUM_CPU_CORES>{})},
+      suggested_queue{MakeThreadQueues(NUM_CPU_CORES, std::make_index_sequence<NUM_CPU_CORES>{})},
+      system{system} {}
 
 GlobalScheduler::~GlobalScheduler() = default;
 
@@ -60,7 +85,7 @@ void GlobalScheduler::SelectThread(std::size_t core) {
     }
     // Step 2: Try selecting a suggested thread.
     Thread* winner = nullptr;
-    std::set<s32> sug_cores;
+    std::array<bool, NUM_CPU_CORES> sug_cores{};
     for (auto thread : suggested_queue[core]) {
         s32 this_core = thread->GetProcessorID();
         Thread* thread_on_core = nullptr;
@@ -71,7 +96,7 @@ void GlobalScheduler::SelectThread(std::size_t core) {
             winner = thread;
             break;
         }
-        sug_cores.insert(this_core);
+        sug_cores[this_core] = true;
     }
     // if we got a suggested thread, select it, else do a second pass.
     if (winner && winner->GetPriority() > 2) {
@@ -83,7 +108,10 @@ void GlobalScheduler::SelectThread(std::size_t core) {
         return;
     }
     // Step 3: Select a suggested thread from another core
-    for (auto& src_core : sug_cores) {
+    for (std::size_t src_core = 0; src_core < NUM_CPU_CORES; ++src_core) {
+        if (!sug_cores[src_core]) {
+            continue;
+        }
         auto it = scheduled_queue[src_core].begin();
         it++;
         if (it != scheduled_queue[src_core].end()) {
@@ -131,6 +159,7 @@ bool GlobalScheduler::YieldThreadAndBalanceLoad(Thread* yielding_thread) {
 
     Thread* next_thread = scheduled_queue[core_id].front(priority);
     Thread* winner = nullptr;
+    const u64 current_ticks = system.CoreTiming().GetTicks();
     for (auto& thread : suggested_queue[core_id]) {
         const s32 source_core = thread->GetProcessorID();
         if (source_core >= 0) {
@@ -141,6 +170,9 @@ bool GlobalScheduler::YieldThreadAndBalanceLoad(Thread* yielding_thread) {
                 }
             }
         }
+        if (!IsMigrationAllowed(thread, current_ticks)) {
+            continue;
+        }
         if (next_thread->GetLastRunningTicks() >= thread->GetLastRunningTicks() ||
             next_thread->GetPriority() < thread->GetPriority()) {
             if (thread->GetPriority() <= priority) {
@@ -208,10 +240,12 @@ bool GlobalScheduler::YieldThreadAndWaitForLoadBalancing(Thread* yielding_thread
 }
 
 void GlobalScheduler::PreemptThreads() {
+    const u64 current_ticks = system.CoreTiming().GetTicks();
     for (std::size_t core_id = 0; core_id < NUM_CPU_CORES; core_id++) {
-        const u32 priority = preemption_priorities[core_id];
+        const u32 priority = policy.preemption_priorities[core_id];
 
         if (scheduled_queue[core_id].size(priority) > 0) {
+            ++preemption_count[core_id];
             scheduled_queue[core_id].front(priority)->IncrementYieldCount();
             scheduled_queue[core_id].yield(priority);
             if (scheduled_queue[core_id].size(priority) > 1) {
@@ -238,6 +272,9 @@ void GlobalScheduler::PreemptThreads() {
                     continue;
                 }
             }
+            if (!IsMigrationAllowed(thread, current_ticks)) {
+                continue;
+            }
             if (current_thread != nullptr &&
                 current_thread->GetLastRunningTicks() >= thread->GetLastRunningTicks()) {
                 winner = thread;
@@ -271,6 +308,9 @@ void GlobalScheduler::PreemptThreads() {
                         continue;
                     }
                 }
+                if (!IsMigrationAllowed(thread, current_ticks)) {
+                    continue;
+                }
                 if (current_thread != nullptr &&
                     current_thread->GetLastRunningTicks() >= thread->GetLastRunningTicks()) {
                     winner = thread;
@@ -329,6 +369,7 @@ void GlobalScheduler::TransferToCore(u32 priority, s32 destination_core, Thread*
         Unschedule(priority, static_cast<u32>(source_core), thread);
     }
     if (destination_core >= 0) {
+        ++migration_count[destination_core];
         Unsuggest(priority, static_cast<u32>(destination_core), thread);
         Schedule(priority, static_cast<u32>(destination_core), thread);
     }
@@ -348,12 +389,55 @@ bool GlobalScheduler::AskForReselectionOrMarkRedundant(Thread* current_thread,
     }
 }
 
+bool GlobalScheduler::IsMigrationAllowed(const Thread* thread, u64 current_ticks) const {
+    if (policy.migration_cost_ticks == 0 || thread->GetProcessorID() < 0) {
+        return true;
+    }
+    if (thread->IsRunning()) {
+        return false;
+    }
+    return current_ticks - thread->GetLastRunningTicks() >= policy.migration_cost_ticks;
+}
+
+SchedulerStatistics GlobalScheduler::GetStatistics(std::size_t core) const {
+    const Scheduler& sched = system.Scheduler(core);
+    SchedulerStatistics statistics;
+    statistics.context_switches = sched.context_switch_count;
+    statistics.idle_selections = sched.idle_selection_count;
+    statistics.migrations = migration_count[core];
+    statistics.preemptions = preemption_count[core];
+    return statistics;
+}
+
+GlobalScheduler::Snapshot GlobalScheduler::TakeSnapshot() const {
+    Snapshot snapshot;
+    snapshot.thread_list = thread_list;
+    for (std::size_t core = 0; core < NUM_CPU_CORES; core++) {
+        snapshot.scheduled_queue[core] = SnapshotQueue(scheduled_queue[core], core);
+        snapshot.suggested_queue[core] =
+            SnapshotQueue(suggested_queue[core], NUM_CPU_CORES + core);
+    }
+    snapshot.is_reselection_pending = IsReselectionPending();
+    return snapshot;
+}
+
+void GlobalScheduler::RestoreSnapshot(const Snapshot& snapshot) {
+    thread_list = snapshot.thread_list;
+    for (std::size_t core = 0; core < NUM_CPU_CORES; core++) {
+        RestoreQueue(scheduled_queue[core], snapshot.scheduled_queue[core]);
+        RestoreQueue(suggested_queue[core], snapshot.suggested_queue[core]);
+    }
+    is_reselection_pending.store(snapshot.is_reselection_pending, std::memory_order_release);
+}
+
 void GlobalScheduler::Shutdown() {
     for (std::size_t core = 0; core < NUM_CPU_CORES; core++) {
         scheduled_queue[core].clear();
         suggested_queue[core].clear();
     }
     thread_list.clear();
+    migration_count.fill(0);
+    preemption_count.fill(0);
 }
 
 Scheduler::Scheduler(Core::System& system, Core::ARM_Interface& cpu_core, std::size_t core_id)
@@ -395,9 +479,7 @@ void Scheduler::UnloadThread() {
 
     // Save context for previous thread
     if (previous_thread) {
-        cpu_core.SaveContext(previous_thread->GetContext());
-        // Save the TPIDR_EL0 system register in case it was modified.
-        previous_thread->SetTPIDR_EL0(cpu_core.GetTPIDR_EL0());
+        SaveThreadContext(*previous_thread);
 
         if (previous_thread->GetStatus() == ThreadStatus::Running) {
             // This is only the case when a reschedule is triggered without the current thread
@@ -417,6 +499,7 @@ void Scheduler::SwitchContext() {
     if (new_thread == previous_thread) {
         return;
     }
+    ++context_switch_count;
 
     Process* const previous_process = system.Kernel().CurrentProcess();
 
@@ -424,9 +507,7 @@ void Scheduler::SwitchContext() {
 
     // Save context for previous thread
     if (previous_thread) {
-        cpu_core.SaveContext(previous_thread->GetContext());
-        // Save the TPIDR_EL0 system register in case it was modified.
-        previous_thread->SetTPIDR_EL0(cpu_core.GetTPIDR_EL0());
+        SaveThreadContext(*previous_thread);
 
         if (previous_thread->GetStatus() == ThreadStatus::Running) {
             // This is only the case when a reschedule is triggered without the current thread
@@ -454,9 +535,7 @@ void Scheduler::SwitchContext() {
             system.Kernel().MakeCurrentProcess(thread_owner_process);
         }
 
-        cpu_core.LoadContext(new_thread->GetContext());
-        cpu_core.SetTlsAddress(new_thread->GetTLSAddress());
-        cpu_core.SetTPIDR_EL0(new_thread->GetTPIDR_EL0());
+        LoadThreadContext(*new_thread);
     } else {
         current_thread = nullptr;
         // Note: We do not reset the current process and current page table when idling because
@@ -464,6 +543,30 @@ void Scheduler::SwitchContext() {
     }
 }
 
+void Scheduler::SaveThreadContext(Thread& thread) {
+    cpu_core.SaveContext(thread.GetContext());
+    // Save the TPIDR_EL0 system register in case it was modified.
+    thread.SetTPIDR_EL0(cpu_core.GetTPIDR_EL0());
+
+    // Until the core runs something else, it still holds the state of the thread
+    held_context = {&thread, thread.GetContextVersion(), cpu_core.GetStateGeneration()};
+}
+
+void Scheduler::LoadThreadContext(Thread& thread) {
+    // Threads waking up on the core that put them to sleep, with nothing else run in between,
+    // skip copying the whole register file back into the JIT
+    const bool is_held = held_context.thread == &thread &&
+                         held_context.context_version == thread.GetContextVersion() &&
+                         held_context.state_generation == cpu_core.GetStateGeneration();
+    if (!is_held) {
+        cpu_core.LoadContext(thread.GetContext());
+    }
+    held_context = {};
+
+    cpu_core.SetTlsAddress(thread.GetTLSAddress());
+    cpu_core.SetTPIDR_EL0(thread.GetTPIDR_EL0());
+}
+
 void Scheduler::UpdateLastContextSwitchTime(Thread* thread, Process* process) {
     const u64 prev_switch_ticks = last_context_switch_time;
     const u64 most_recent_switch_ticks = system.CoreTiming().GetTicks();
@@ -483,6 +586,31 @@ void Scheduler::UpdateLastContextSwitchTime(Thread* thread, Process* process) {
 void Scheduler::Shutdown() {
     current_thread = nullptr;
     selected_thread = nullptr;
+    idle_selection_count = 0;
+    context_switch_count = 0;
+    held_context = {};
+}
+
+Scheduler::Snapshot Scheduler::TakeSnapshot() {
+    if (current_thread) {
+        cpu_core.SaveContext(current_thread->GetContext());
+        current_thread->SetTPIDR_EL0(cpu_core.GetTPIDR_EL0());
+    }
+    return {current_thread, selected_thread, last_context_switch_time, is_context_switch_pending};
+}
+
+void Scheduler::RestoreSnapshot(const Snapshot& snapshot) {
+    current_thread = snapshot.current_thread;
+    selected_thread = snapshot.selected_thread;
+    last_context_switch_time = snapshot.last_context_switch_time;
+    is_context_switch_pending = snapshot.is_context_switch_pending;
+
+    if (current_thread) {
+        cpu_core.LoadContext(current_thread->GetContext());
+        cpu_core.SetTlsAddress(current_thread->GetTLSAddress());
+        cpu_core.SetTPIDR_EL0(current_thread->GetTPIDR_EL0());
+    }
+    cpu_core.ClearExclusiveState();
 }
 
 } // namespace Kernel
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -21,6 +23,43 @@ namespace Kernel {
 
 class Process;
 
+/// Selects which of the link nodes embedded in a thread a scheduler queue uses.
+struct ThreadQueueNodeAccessor {
+    std::size_t index;
+
+    Common::MultiLevelQueueNode<Thread>& operator()(Thread& thread) const {
+        return thread.GetSchedulingNode(index);
+    }
+};
+
+using ThreadQueue =
+    Common::IntrusiveMultiLevelQueue<Thread, THREADPRIO_COUNT, ThreadQueueNodeAccessor>;
+
+/// Tunables of the global scheduler. The defaults match the behaviour of the hardware kernel.
+struct SchedulingPolicy {
+    /// The priority levels at which the global scheduler rotates the threads of each core on every
+    /// preemption. They are ordered from Core 0 to Core 3.
+    std::array<u32, THREADPROCESSORID_MAX> preemption_priorities{59, 59, 59, 62};
+
+    /// Time between two preemptions.
+    std::chrono::microseconds preemption_quantum{10000};
+
+    /**
+     * Load balancing leaves a suggested thread where it is while it is running or has been running
+     * within this many ticks, since moving it to another host core throws away its warm caches.
+     * Zero migrates threads regardless of when they last ran.
+     */
+    u64 migration_cost_ticks = 0;
+};
+
+/// Counters of the scheduling decisions taken on a core since the kernel was initialized.
+struct SchedulerStatistics {
+    u64 context_switches = 0; ///< Switches to a different thread, including to and from idle
+    u64 idle_selections = 0;  ///< Selections that left the core without a thread to run
+    u64 migrations = 0;       ///< Threads moved onto the core from another one
+    u64 preemptions = 0;      ///< Preemptions that rotated the threads of the core
+};
+
 class GlobalScheduler final {
 public:
     static constexpr u32 NUM_CPU_CORES = 4;
@@ -136,6 +175,37 @@ public:
         return is_reselection_pending.load(std::memory_order_acquire);
     }
 
+    void SetPolicy(const SchedulingPolicy& new_policy) {
+        policy = new_policy;
+    }
+
+    const SchedulingPolicy& GetPolicy() const {
+        return policy;
+    }
+
+    /// Returns the scheduling statistics of a cpu core.
+    SchedulerStatistics GetStatistics(std::size_t core) const;
+
+    /// Threads of the scheduler and the order of its queues, see Core::SaveState.
+    struct Snapshot {
+        struct QueueEntry {
+            Thread* thread;
+            u32 priority;
+        };
+        using Queue = std::vector<QueueEntry>;
+
+        std::vector<std::shared_ptr<Thread>> thread_list;
+        std::array<Queue, NUM_CPU_CORES> scheduled_queue;
+        std::array<Queue, NUM_CPU_CORES> suggested_queue;
+        bool is_reselection_pending;
+    };
+
+    Snapshot TakeSnapshot() const;
+
+    /// Rebuilds the queues in the order of the snapshot. The queued threads must already have been
+    /// restored, as their priorities and cores are not checked again.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
     void Shutdown();
 
 private:
@@ -148,14 +218,21 @@ private:
 
     bool AskForReselectionOrMarkRedundant(Thread* current_thread, const Thread* winner);
 
+    /// Whether load balancing may move a suggested thread away from its core, see SchedulingPolicy.
+    bool IsMigrationAllowed(const Thread* thread, u64 current_ticks) const;
+
     static constexpr u32 min_regular_priority = 2;
-    std::array<Common::MultiLevelQueue<Thread*, THREADPRIO_COUNT>, NUM_CPU_CORES> scheduled_queue;
-    std::array<Common::MultiLevelQueue<Thread*, THREADPRIO_COUNT>, NUM_CPU_CORES> suggested_queue;
+    // The scheduled queue of a core uses the thread node with the core's index, its suggested queue
+    // the node at NUM_CPU_CORES + core.
+    std::array<ThreadQueue, NUM_CPU_CORES> scheduled_queue;
+    std::array<ThreadQueue, NUM_CPU_CORES> suggested_queue;
     std::atomic<bool> is_reselection_pending{false};
 
-    // The priority levels at which the global scheduler preempts threads every 10 ms. They are
-    // ordered from Core 0 to Core 3.
-    std::array<u32, NUM_CPU_CORES> preemption_priorities = {59, 59, 59, 62};
+    SchedulingPolicy policy;
+
+    // Only modified by the scheduler itself, the debugger reads them while emulation is paused.
+    std::array<u64, NUM_CPU_CORES> migration_count{};
+    std::array<u64, NUM_CPU_CORES> preemption_count{};
 
     /// Lists all thread ids that aren't deleted/etc.
     std::vector<std::shared_ptr<Thread>> thread_list;
@@ -195,12 +272,34 @@ public:
     /// Shutdowns the scheduler.
     void Shutdown();
 
+    /// Threads of the core and the time of its last context switch, see Core::SaveState.
+    struct Snapshot {
+        std::shared_ptr<Thread> current_thread;
+        std::shared_ptr<Thread> selected_thread;
+        u64 last_context_switch_time;
+        bool is_context_switch_pending;
+    };
+
+    /// Writes the registers of the running thread back into it first, so that they are part of
+    /// the thread snapshots taken afterwards.
+    Snapshot TakeSnapshot();
+
+    /// Loads the registers of the restored current thread into the CPU core. The threads must
+    /// already have been restored.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
 private:
     friend class GlobalScheduler;
 
     /// Switches the CPU's active thread context to that of the specified thread
     void SwitchContext();
 
+    /// Saves the context of a thread leaving the CPU core.
+    void SaveThreadContext(Thread& thread);
+
+    /// Loads the context of a thread into the CPU core, unless the core still holds it.
+    void LoadThreadContext(Thread& thread);
+
     /**
      * Called on every context switch to update the internal timestamp
      * This also updates the running time ticks for the given thread and
@@ -214,6 +313,14 @@ private:
      */
     void UpdateLastContextSwitchTime(Thread* thread, Process* process);
 
+    /// Thread whose context the CPU core still holds since it was saved, along with the versions
+    /// of the context and of the core state back then. Each one changes when it is written.
+    struct HeldContext {
+        const Thread* thread = nullptr;
+        u64 context_version = 0;
+        u64 state_generation = 0;
+    };
+
     std::shared_ptr<Thread> current_thread = nullptr;
     std::shared_ptr<Thread> selected_thread = nullptr;
 
@@ -221,9 +328,12 @@ private:
     Core::ARM_Interface& cpu_core;
     u64 last_context_switch_time = 0;
     u64 idle_selection_count = 0;
+    u64 context_switch_count = 0;
     const std::size_t core_id;
 
     bool is_context_switch_pending = false;
+
+    HeldContext held_context;
 };
 
 } // namespace Kernel
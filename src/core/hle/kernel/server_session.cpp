@@ -19,6 +19,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/session.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/thread.h"
 #include "core/memory.h"
 
@@ -30,7 +31,8 @@ ServerSession::~ServerSession() = default;
 ResultVal<std::shared_ptr<ServerSession>> ServerSession::Create(KernelCore& kernel,
                                                                 std::shared_ptr<Session> parent,
                                                                 std::string name) {
-    std::shared_ptr<ServerSession> session{std::make_shared<ServerSession>(kernel)};
+    const SlabAllocator<ServerSession> allocator{kernel.GetObjectHeap()};
+    std::shared_ptr<ServerSession> session{std::allocate_shared<ServerSession>(allocator, kernel)};
 
     session->request_event = Core::Timing::CreateEvent(
         name, [session](u64 userdata, s64 cycles_late) { session->CompleteSyncRequest(); });
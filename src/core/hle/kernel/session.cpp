@@ -4,8 +4,10 @@
 
 #include "common/assert.h"
 #include "core/hle/kernel/client_session.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/session.h"
+#include "core/hle/kernel/slab_heap.h"
 
 namespace Kernel {
 
@@ -13,7 +15,8 @@ Session::Session(KernelCore& kernel) : WaitObject{kernel} {}
 Session::~Session() = default;
 
 Session::SessionPair Session::Create(KernelCore& kernel, std::string name) {
-    auto session{std::make_shared<Session>(kernel)};
+    const SlabAllocator<Session> allocator{kernel.GetObjectHeap()};
+    auto session{std::allocate_shared<Session>(allocator, kernel)};
     auto client_session{Kernel::ClientSession::Create(kernel, session, name + "_Client").Unwrap()};
     auto server_session{Kernel::ServerSession::Create(kernel, session, name + "_Server").Unwrap()};
 
@@ -0,0 +1,80 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "common/assert.h"
+#include "core/hle/kernel/slab_heap.h"
+
+namespace Kernel {
+namespace {
+/// Size of the chunks that get carved into blocks when a free list runs dry.
+constexpr std::size_t ChunkSize = 64 * 1024;
+
+constexpr std::size_t GetSizeClass(std::size_t size) {
+    return (std::max<std::size_t>(size, 1) - 1) / SlabHeap::BlockAlignment;
+}
+} // Anonymous namespace
+
+SlabHeap::SlabHeap() = default;
+
+SlabHeap::~SlabHeap() {
+    for (void* chunk : chunks) {
+        ::operator delete(chunk, std::align_val_t{BlockAlignment});
+    }
+}
+
+void* SlabHeap::Allocate(std::size_t size) {
+    if (size > MaxBlockSize) {
+        return ::operator new(size, std::align_val_t{BlockAlignment});
+    }
+
+    const std::size_t size_class = GetSizeClass(size);
+
+    std::lock_guard lock{mutex};
+    if (free_lists[size_class] == nullptr) {
+        Refill(size_class);
+    }
+
+    FreeBlock* const block = free_lists[size_class];
+    free_lists[size_class] = block->next;
+    return block;
+}
+
+void SlabHeap::Free(void* block, std::size_t size) {
+    if (block == nullptr) {
+        return;
+    }
+
+    if (size > MaxBlockSize) {
+        ::operator delete(block, std::align_val_t{BlockAlignment});
+        return;
+    }
+
+    const std::size_t size_class = GetSizeClass(size);
+
+    std::lock_guard lock{mutex};
+    auto* const free_block = static_cast<FreeBlock*>(block);
+    free_block->next = free_lists[size_class];
+    free_lists[size_class] = free_block;
+}
+
+void SlabHeap::Refill(std::size_t size_class) {
+    const std::size_t block_size = (size_class + 1) * BlockAlignment;
+    const std::size_t num_blocks = std::max<std::size_t>(ChunkSize / block_size, 1);
+
+    auto* const chunk =
+        static_cast<u8*>(::operator new(block_size * num_blocks, std::align_val_t{BlockAlignment}));
+    chunks.push_back(chunk);
+
+    // Thread the blocks back to front so they are handed out in address order.
+    for (std::size_t i = num_blocks; i > 0; i--) {
+        auto* const block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_size);
+        block->next = free_lists[size_class];
+        free_lists[size_class] = block;
+    }
+    ASSERT(free_lists[size_class] != nullptr);
+}
+
+} // namespace Kernel
@@ -0,0 +1,116 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Kernel {
+
+/**
+ * Pool of recycled memory blocks used to allocate kernel objects.
+ *
+ * Blocks are grouped into size classes and handed out from per-class free lists, which are refilled
+ * a whole chunk at a time. Freed blocks go back to their free list rather than to the system
+ * allocator, so objects that are created and destroyed at a high rate (events, sessions, threads)
+ * don't hit the global heap. Memory is only returned to the system when the heap is destroyed.
+ */
+class SlabHeap final {
+public:
+    /// Granularity of the size classes, also the alignment of every pooled block.
+    static constexpr std::size_t BlockAlignment = 64;
+
+    /// Largest allocation served from the pool. Bigger requests go to the system allocator.
+    static constexpr std::size_t MaxBlockSize = 8192;
+
+    SlabHeap();
+    ~SlabHeap();
+
+    SlabHeap(const SlabHeap&) = delete;
+    SlabHeap& operator=(const SlabHeap&) = delete;
+
+    SlabHeap(SlabHeap&&) = delete;
+    SlabHeap& operator=(SlabHeap&&) = delete;
+
+    /// Allocates a block of at least the given size.
+    void* Allocate(std::size_t size);
+
+    /// Returns a block previously obtained from Allocate with the same size.
+    void Free(void* block, std::size_t size);
+
+private:
+    static constexpr std::size_t NumSizeClasses = MaxBlockSize / BlockAlignment;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    /// Carves a new chunk into blocks of the given size class and adds them to its free list.
+    void Refill(std::size_t size_class);
+
+    std::mutex mutex;
+    std::array<FreeBlock*, NumSizeClasses> free_lists{};
+    std::vector<void*> chunks;
+};
+
+/**
+ * Standard allocator drawing its memory from a SlabHeap. Every allocator (and every object
+ * allocated through std::allocate_shared with it) keeps the heap alive, so objects may safely
+ * outlive the kernel instance that created them.
+ */
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    explicit SlabAllocator(std::shared_ptr<SlabHeap> heap_) : heap{std::move(heap_)} {}
+
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>& other) : heap{other.heap} {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(heap->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) {
+        heap->Free(ptr, n * sizeof(T));
+    }
+
+    /// Constructs through the allocator, so kernel objects only need to befriend SlabAllocator.
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* ptr) {
+        ptr->~U();
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U>& other) const {
+        return heap == other.heap;
+    }
+
+    template <typename U>
+    bool operator!=(const SlabAllocator<U>& other) const {
+        return heap != other.heap;
+    }
+
+private:
+    template <typename U>
+    friend class SlabAllocator;
+
+    std::shared_ptr<SlabHeap> heap;
+};
+
+} // namespace Kernel
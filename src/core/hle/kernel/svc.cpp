@@ -3,6 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cinttypes>
 #include <iterator>
 #include <mutex>
@@ -18,6 +21,7 @@
 #include "core/core_manager.h"
 #include "core/core_timing.h"
 #include "core/core_timing_util.h"
+#include "core/frame_timeline.h"
 #include "core/hle/kernel/address_arbiter.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/client_session.h"
@@ -35,7 +39,6 @@
 #include "core/hle/kernel/thread.h"
 #include "core/hle/kernel/transfer_memory.h"
 #include "core/hle/kernel/writable_event.h"
-#include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
 #include "core/memory.h"
@@ -394,7 +397,7 @@ static ResultCode GetThreadId(Core::System& system, u64* thread_id, Handle threa
     LOG_TRACE(Kernel_SVC, "called thread=0x{:08X}", thread_handle);
 
     const auto& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
-    const std::shared_ptr<Thread> thread = handle_table.Get<Thread>(thread_handle);
+    const Thread* const thread = handle_table.GetPointer<Thread>(thread_handle);
     if (!thread) {
         LOG_ERROR(Kernel_SVC, "Thread handle does not exist, handle=0x{:08X}", thread_handle);
         return ERR_INVALID_HANDLE;
@@ -409,13 +412,13 @@ static ResultCode GetProcessId(Core::System& system, u64* process_id, Handle han
     LOG_DEBUG(Kernel_SVC, "called handle=0x{:08X}", handle);
 
     const auto& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
-    const std::shared_ptr<Process> process = handle_table.Get<Process>(handle);
+    const Process* const process = handle_table.GetPointer<Process>(handle);
     if (process) {
         *process_id = process->GetProcessID();
         return RESULT_SUCCESS;
     }
 
-    const std::shared_ptr<Thread> thread = handle_table.Get<Thread>(handle);
+    const Thread* const thread = handle_table.GetPointer<Thread>(handle);
     if (thread) {
         const Process* const owner_process = thread->GetOwnerProcess();
         if (!owner_process) {
@@ -1130,7 +1133,7 @@ static ResultCode GetThreadPriority(Core::System& system, u32* priority, Handle
     LOG_TRACE(Kernel_SVC, "called");
 
     const auto& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
-    const std::shared_ptr<Thread> thread = handle_table.Get<Thread>(handle);
+    const Thread* const thread = handle_table.GetPointer<Thread>(handle);
     if (!thread) {
         LOG_ERROR(Kernel_SVC, "Thread handle does not exist, handle=0x{:08X}", handle);
         return ERR_INVALID_HANDLE;
@@ -1818,12 +1821,12 @@ static ResultCode ResetSignal(Core::System& system, Handle handle) {
 
     const auto& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
 
-    auto event = handle_table.Get<ReadableEvent>(handle);
+    auto* const event = handle_table.GetPointer<ReadableEvent>(handle);
     if (event) {
         return event->Reset();
     }
 
-    auto process = handle_table.Get<Process>(handle);
+    auto* const process = handle_table.GetPointer<Process>(handle);
     if (process) {
         return process->ClearSignalState();
     }
@@ -2141,13 +2144,13 @@ static ResultCode ClearEvent(Core::System& system, Handle handle) {
 
     const auto& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
 
-    auto writable_event = handle_table.Get<WritableEvent>(handle);
+    auto* const writable_event = handle_table.GetPointer<WritableEvent>(handle);
     if (writable_event) {
         writable_event->Clear();
         return RESULT_SUCCESS;
     }
 
-    auto readable_event = handle_table.Get<ReadableEvent>(handle);
+    auto* const readable_event = handle_table.GetPointer<ReadableEvent>(handle);
     if (readable_event) {
         readable_event->Clear();
         return RESULT_SUCCESS;
@@ -2161,7 +2164,7 @@ static ResultCode SignalEvent(Core::System& system, Handle handle) {
     LOG_DEBUG(Kernel_SVC, "called. Handle=0x{:08X}", handle);
 
     HandleTable& handle_table = system.Kernel().CurrentProcess()->GetHandleTable();
-    auto writable_event = handle_table.Get<WritableEvent>(handle);
+    auto* const writable_event = handle_table.GetPointer<WritableEvent>(handle);
 
     if (!writable_event) {
         LOG_ERROR(Kernel_SVC, "Non-existent writable event handle used (0x{:08X})", handle);
@@ -2361,7 +2364,7 @@ static ResultCode GetThreadList(Core::System& system, u32* out_num_threads, VAdd
 
 namespace {
 struct FunctionDef {
-    using Func = void(Core::System&);
+    using Func = void(Core::System&, SvcRegisters&);
 
     u32 id;
     Func* func;
@@ -2369,7 +2372,7 @@ struct FunctionDef {
 };
 } // namespace
 
-static const FunctionDef SVC_Table[] = {
+constexpr std::array<FunctionDef, 0x80> SVC_Table{{
     {0x00, nullptr, "Unknown"},
     {0x01, SvcWrap<SetHeapSize>, "SetHeapSize"},
     {0x02, SvcWrap<SetMemoryPermission>, "SetMemoryPermission"},
@@ -2498,10 +2501,40 @@ static const FunctionDef SVC_Table[] = {
     {0x7D, SvcWrap<CreateResourceLimit>, "CreateResourceLimit"},
     {0x7E, SvcWrap<SetResourceLimitLimitValue>, "SetResourceLimitLimitValue"},
     {0x7F, nullptr, "CallSecureMonitor"},
+}};
+
+constexpr bool IsSVCTableOrdered() {
+    for (std::size_t i = 0; i < SVC_Table.size(); i++) {
+        if (SVC_Table[i].id != i) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(IsSVCTableOrdered(), "SVC table entries must be indexed by their SVC number");
+
+/// Counters for a single SVC. Updated under the HLE lock, but read from the frontend as well.
+struct SVCCounters {
+    std::atomic<u64> call_count{};
+    std::atomic<u64> total_time_ns{};
 };
 
+static std::array<SVCCounters, SVC_Table.size()> svc_counters;
+
+#if MICROPROFILE_ENABLED
+/// Gives every SVC its own microprofile timer, so the profiler can break down kernel time.
+static const std::array<MicroProfileToken, SVC_Table.size()> svc_tokens = [] {
+    std::array<MicroProfileToken, SVC_Table.size()> tokens{};
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        tokens[i] = MicroProfileGetToken("Kernel SVC", SVC_Table[i].name, MP_RGB(70, 200, 70),
+                                         MicroProfileTokenTypeCpu);
+    }
+    return tokens;
+}();
+#endif
+
 static const FunctionDef* GetSVCInfo(u32 func_num) {
-    if (func_num >= std::size(SVC_Table)) {
+    if (func_num >= SVC_Table.size()) {
         LOG_ERROR(Kernel_SVC, "Unknown svc=0x{:02X}", func_num);
         return nullptr;
     }
@@ -2511,21 +2544,68 @@ static const FunctionDef* GetSVCInfo(u32 func_num) {
 MICROPROFILE_DEFINE(Kernel_SVC, "Kernel", "SVC", MP_RGB(70, 200, 70));
 
 void CallSVC(Core::System& system, u32 immediate) {
+    auto& arm_interface = system.CurrentArmInterface();
+
+    SvcRegisters registers;
+    for (std::size_t i = 0; i < SvcRegisters::NumRegisters; i++) {
+        registers.values[i] = arm_interface.GetReg(static_cast<int>(i));
+    }
+
+    CallSVC(system, immediate, registers);
+
+    for (std::size_t i = 0; i < SvcRegisters::NumRegisters; i++) {
+        if ((registers.written_mask & (1U << i)) != 0) {
+            arm_interface.SetReg(static_cast<int>(i), registers.values[i]);
+        }
+    }
+}
+
+void CallSVC(Core::System& system, u32 immediate, SvcRegisters& registers) {
     MICROPROFILE_SCOPE(Kernel_SVC);
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::Svc};
 
     // Lock the global kernel mutex when we enter the kernel HLE.
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{system.Kernel().HLELock()};
 
     const FunctionDef* info = GetSVCInfo(immediate);
-    if (info) {
-        if (info->func) {
-            info->func(system);
-        } else {
-            LOG_CRITICAL(Kernel_SVC, "Unimplemented SVC function {}(..)", info->name);
-        }
-    } else {
+    if (!info) {
         LOG_CRITICAL(Kernel_SVC, "Unknown SVC function 0x{:X}", immediate);
+        return;
+    }
+    if (!info->func) {
+        LOG_CRITICAL(Kernel_SVC, "Unimplemented SVC function {}(..)", info->name);
+        return;
+    }
+
+#if MICROPROFILE_ENABLED
+    MicroProfileScopeHandler svc_scope{svc_tokens[immediate]};
+#endif
+    const auto start_time = std::chrono::steady_clock::now();
+
+    info->func(system, registers);
+
+    const auto elapsed = std::chrono::steady_clock::now() - start_time;
+    auto& counters = svc_counters[immediate];
+    counters.call_count.fetch_add(1, std::memory_order_relaxed);
+    counters.total_time_ns.fetch_add(
+        static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        std::memory_order_relaxed);
+}
+
+std::size_t GetSVCCount() {
+    return SVC_Table.size();
+}
+
+SvcStatistics GetSVCStatistics(u32 immediate) {
+    if (immediate >= SVC_Table.size()) {
+        return {};
     }
+    const auto& counters = svc_counters[immediate];
+    return {
+        SVC_Table[immediate].name,
+        counters.call_count.load(std::memory_order_relaxed),
+        counters.total_time_ns.load(std::memory_order_relaxed),
+    };
 }
 
 } // namespace Kernel
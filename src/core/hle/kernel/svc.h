@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+
 #include "common/common_types.h"
 
 namespace Core {
@@ -12,6 +15,44 @@ class System;
 
 namespace Kernel {
 
+/**
+ * Snapshot of the argument registers (X0-X7) of the thread issuing an SVC. SVC wrappers read
+ * their parameters from and write their results to this snapshot, and only the registers that
+ * were actually written are copied back into the CPU afterwards.
+ */
+struct SvcRegisters {
+    static constexpr std::size_t NumRegisters = 8;
+
+    u64 Get(std::size_t index) const {
+        return values[index];
+    }
+
+    void Set(std::size_t index, u64 value) {
+        values[index] = value;
+        written_mask |= 1U << index;
+    }
+
+    std::array<u64, NumRegisters> values{};
+    u32 written_mask = 0;
+};
+
+/// Per-SVC counters accumulated since the emulator was started.
+struct SvcStatistics {
+    const char* name = nullptr;
+    u64 call_count = 0;
+    u64 total_time_ns = 0;
+};
+
+/// Dispatches an SVC, reading and writing the registers through the current ARM interface.
 void CallSVC(Core::System& system, u32 immediate);
 
+/// Dispatches an SVC on an already captured register snapshot.
+void CallSVC(Core::System& system, u32 immediate, SvcRegisters& registers);
+
+/// Returns the number of entries in the SVC table.
+std::size_t GetSVCCount();
+
+/// Returns the accumulated call count and host time spent in the given SVC.
+SvcStatistics GetSVCStatistics(u32 immediate);
+
 } // namespace Kernel
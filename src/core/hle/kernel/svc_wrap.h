@@ -5,280 +5,279 @@
 #pragma once
 
 #include "common/common_types.h"
-#include "core/arm/arm_interface.h"
 #include "core/core.h"
+#include "core/hle/kernel/svc.h"
 #include "core/hle/result.h"
 
 namespace Kernel {
 
-static inline u64 Param(const Core::System& system, int n) {
-    return system.CurrentArmInterface().GetReg(n);
+static inline u64 Param(const SvcRegisters& regs, int n) {
+    return regs.Get(n);
 }
 
 /**
  * HLE a function return from the current ARM userland process
- * @param system System context
+ * @param regs Register snapshot of the calling thread
  * @param result Result to return
  */
-static inline void FuncReturn(Core::System& system, u64 result) {
-    system.CurrentArmInterface().SetReg(0, result);
+static inline void FuncReturn(SvcRegisters& regs, u64 result) {
+    regs.Set(0, result);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Function wrappers that return type ResultCode
 
 template <ResultCode func(Core::System&, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0)).raw);
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0)).raw);
 }
 
 template <ResultCode func(Core::System&, u64, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), Param(system, 1)).raw);
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), Param(regs, 1)).raw);
 }
 
 template <ResultCode func(Core::System&, u32)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, static_cast<u32>(Param(system, 0))).raw);
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, static_cast<u32>(Param(regs, 0))).raw);
 }
 
 template <ResultCode func(Core::System&, u32, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     FuncReturn(
-        system,
-        func(system, static_cast<u32>(Param(system, 0)), static_cast<u32>(Param(system, 1))).raw);
+        regs,
+        func(system, static_cast<u32>(Param(regs, 0)), static_cast<u32>(Param(regs, 1))).raw);
 }
 
 template <ResultCode func(Core::System&, u32, u64, u64, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, static_cast<u32>(Param(system, 0)), Param(system, 1),
-                            Param(system, 2), Param(system, 3))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1),
+                            Param(regs, 2), Param(regs, 3))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u32*)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param = 0;
     const u32 retval = func(system, &param).raw;
-    system.CurrentArmInterface().SetReg(1, param);
-    FuncReturn(system, retval);
+    regs.Set(1, param);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32*, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
-    const u32 retval = func(system, &param_1, static_cast<u32>(Param(system, 1))).raw;
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    const u32 retval = func(system, &param_1, static_cast<u32>(Param(regs, 1))).raw;
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32*, u32*)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
     u32 param_2 = 0;
     const u32 retval = func(system, &param_1, &param_2).raw;
 
-    auto& arm_interface = system.CurrentArmInterface();
-    arm_interface.SetReg(1, param_1);
-    arm_interface.SetReg(2, param_2);
+    regs.Set(1, param_1);
+    regs.Set(2, param_2);
 
-    FuncReturn(system, retval);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32*, u64)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
-    const u32 retval = func(system, &param_1, Param(system, 1)).raw;
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    const u32 retval = func(system, &param_1, Param(regs, 1)).raw;
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32*, u64, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
     const u32 retval =
-        func(system, &param_1, Param(system, 1), static_cast<u32>(Param(system, 2))).raw;
+        func(system, &param_1, Param(regs, 1), static_cast<u32>(Param(regs, 2))).raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u64*, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u64 param_1 = 0;
-    const u32 retval = func(system, &param_1, static_cast<u32>(Param(system, 1))).raw;
+    const u32 retval = func(system, &param_1, static_cast<u32>(Param(regs, 1))).raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u64, u32)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), static_cast<u32>(Param(system, 1))).raw);
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), static_cast<u32>(Param(regs, 1))).raw);
 }
 
 template <ResultCode func(Core::System&, u64*, u64)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u64 param_1 = 0;
-    const u32 retval = func(system, &param_1, Param(system, 1)).raw;
+    const u32 retval = func(system, &param_1, Param(regs, 1)).raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u64*, u32, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u64 param_1 = 0;
-    const u32 retval = func(system, &param_1, static_cast<u32>(Param(system, 1)),
-                            static_cast<u32>(Param(system, 2)))
+    const u32 retval = func(system, &param_1, static_cast<u32>(Param(regs, 1)),
+                            static_cast<u32>(Param(regs, 2)))
                            .raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, static_cast<u32>(Param(system, 0)), Param(system, 1)).raw);
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1)).raw);
 }
 
 template <ResultCode func(Core::System&, u32, u32, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, static_cast<u32>(Param(system, 0)),
-                            static_cast<u32>(Param(system, 1)), Param(system, 2))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, static_cast<u32>(Param(regs, 0)),
+                            static_cast<u32>(Param(regs, 1)), Param(regs, 2))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u32, u32*, u64*)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
     u64 param_2 = 0;
-    const ResultCode retval = func(system, static_cast<u32>(Param(system, 2)), &param_1, &param_2);
+    const ResultCode retval = func(system, static_cast<u32>(Param(regs, 2)), &param_1, &param_2);
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    system.CurrentArmInterface().SetReg(2, param_2);
-    FuncReturn(system, retval.raw);
+    regs.Set(1, param_1);
+    regs.Set(2, param_2);
+    FuncReturn(regs, retval.raw);
 }
 
 template <ResultCode func(Core::System&, u64, u64, u32, u32)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), Param(system, 1),
-                            static_cast<u32>(Param(system, 2)), static_cast<u32>(Param(system, 3)))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), Param(regs, 1),
+                            static_cast<u32>(Param(regs, 2)), static_cast<u32>(Param(regs, 3)))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u64, u64, u32, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), Param(system, 1),
-                            static_cast<u32>(Param(system, 2)), Param(system, 3))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), Param(regs, 1),
+                            static_cast<u32>(Param(regs, 2)), Param(regs, 3))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u32, u64, u32)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, static_cast<u32>(Param(system, 0)), Param(system, 1),
-                            static_cast<u32>(Param(system, 2)))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1),
+                            static_cast<u32>(Param(regs, 2)))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u64, u64, u64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), Param(system, 1), Param(system, 2)).raw);
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), Param(regs, 1), Param(regs, 2)).raw);
 }
 
 template <ResultCode func(Core::System&, u64, u64, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     FuncReturn(
-        system,
-        func(system, Param(system, 0), Param(system, 1), static_cast<u32>(Param(system, 2))).raw);
+        regs,
+        func(system, Param(regs, 0), Param(regs, 1), static_cast<u32>(Param(regs, 2))).raw);
 }
 
 template <ResultCode func(Core::System&, u32, u64, u64, u32)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, static_cast<u32>(Param(system, 0)), Param(system, 1),
-                            Param(system, 2), static_cast<u32>(Param(system, 3)))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1),
+                            Param(regs, 2), static_cast<u32>(Param(regs, 3)))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u32, u64, u64)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     FuncReturn(
-        system,
-        func(system, static_cast<u32>(Param(system, 0)), Param(system, 1), Param(system, 2)).raw);
+        regs,
+        func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1), Param(regs, 2)).raw);
 }
 
 template <ResultCode func(Core::System&, u32*, u64, u64, s64)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
-    const u32 retval = func(system, &param_1, Param(system, 1), static_cast<u32>(Param(system, 2)),
-                            static_cast<s64>(Param(system, 3)))
+    const u32 retval = func(system, &param_1, Param(regs, 1), static_cast<u32>(Param(regs, 2)),
+                            static_cast<s64>(Param(regs, 3)))
                            .raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u64, u64, u32, s64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), Param(system, 1),
-                            static_cast<u32>(Param(system, 2)), static_cast<s64>(Param(system, 3)))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), Param(regs, 1),
+                            static_cast<u32>(Param(regs, 2)), static_cast<s64>(Param(regs, 3)))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u64*, u64, u64, u64)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u64 param_1 = 0;
     const u32 retval =
-        func(system, &param_1, Param(system, 1), Param(system, 2), Param(system, 3)).raw;
+        func(system, &param_1, Param(regs, 1), Param(regs, 2), Param(regs, 3)).raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32*, u64, u64, u64, u32, s32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
-    const u32 retval = func(system, &param_1, Param(system, 1), Param(system, 2), Param(system, 3),
-                            static_cast<u32>(Param(system, 4)), static_cast<s32>(Param(system, 5)))
+    const u32 retval = func(system, &param_1, Param(regs, 1), Param(regs, 2), Param(regs, 3),
+                            static_cast<u32>(Param(regs, 4)), static_cast<s32>(Param(regs, 5)))
                            .raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u32*, u64, u64, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
-    const u32 retval = func(system, &param_1, Param(system, 1), Param(system, 2),
-                            static_cast<u32>(Param(system, 3)))
+    const u32 retval = func(system, &param_1, Param(regs, 1), Param(regs, 2),
+                            static_cast<u32>(Param(regs, 3)))
                            .raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, Handle*, u64, u32, u32)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     u32 param_1 = 0;
-    const u32 retval = func(system, &param_1, Param(system, 1), static_cast<u32>(Param(system, 2)),
-                            static_cast<u32>(Param(system, 3)))
+    const u32 retval = func(system, &param_1, Param(regs, 1), static_cast<u32>(Param(regs, 2)),
+                            static_cast<u32>(Param(regs, 3)))
                            .raw;
 
-    system.CurrentArmInterface().SetReg(1, param_1);
-    FuncReturn(system, retval);
+    regs.Set(1, param_1);
+    FuncReturn(regs, retval);
 }
 
 template <ResultCode func(Core::System&, u64, u32, s32, s64)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), static_cast<u32>(Param(system, 1)),
-                            static_cast<s32>(Param(system, 2)), static_cast<s64>(Param(system, 3)))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), static_cast<u32>(Param(regs, 1)),
+                            static_cast<s32>(Param(regs, 2)), static_cast<s64>(Param(regs, 3)))
                            .raw);
 }
 
 template <ResultCode func(Core::System&, u64, u32, s32, s32)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system, Param(system, 0), static_cast<u32>(Param(system, 1)),
-                            static_cast<s32>(Param(system, 2)), static_cast<s32>(Param(system, 3)))
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system, Param(regs, 0), static_cast<u32>(Param(regs, 1)),
+                            static_cast<s32>(Param(regs, 2)), static_cast<s32>(Param(regs, 3)))
                            .raw);
 }
 
@@ -286,60 +285,60 @@ void SvcWrap(Core::System& system) {
 // Function wrappers that return type u32
 
 template <u32 func(Core::System&)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Function wrappers that return type u64
 
 template <u64 func(Core::System&)>
-void SvcWrap(Core::System& system) {
-    FuncReturn(system, func(system));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    FuncReturn(regs, func(system));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Function wrappers that return type void
 
 template <void func(Core::System&)>
-void SvcWrap(Core::System& system) {
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
     func(system);
 }
 
 template <void func(Core::System&, u32)>
-void SvcWrap(Core::System& system) {
-    func(system, static_cast<u32>(Param(system, 0)));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, static_cast<u32>(Param(regs, 0)));
 }
 
 template <void func(Core::System&, u32, u64, u64, u64)>
-void SvcWrap(Core::System& system) {
-    func(system, static_cast<u32>(Param(system, 0)), Param(system, 1), Param(system, 2),
-         Param(system, 3));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1), Param(regs, 2),
+         Param(regs, 3));
 }
 
 template <void func(Core::System&, s64)>
-void SvcWrap(Core::System& system) {
-    func(system, static_cast<s64>(Param(system, 0)));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, static_cast<s64>(Param(regs, 0)));
 }
 
 template <void func(Core::System&, u64, s32)>
-void SvcWrap(Core::System& system) {
-    func(system, Param(system, 0), static_cast<s32>(Param(system, 1)));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, Param(regs, 0), static_cast<s32>(Param(regs, 1)));
 }
 
 template <void func(Core::System&, u64, u64)>
-void SvcWrap(Core::System& system) {
-    func(system, Param(system, 0), Param(system, 1));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, Param(regs, 0), Param(regs, 1));
 }
 
 template <void func(Core::System&, u64, u64, u64)>
-void SvcWrap(Core::System& system) {
-    func(system, Param(system, 0), Param(system, 1), Param(system, 2));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, Param(regs, 0), Param(regs, 1), Param(regs, 2));
 }
 
 template <void func(Core::System&, u32, u64, u64)>
-void SvcWrap(Core::System& system) {
-    func(system, static_cast<u32>(Param(system, 0)), Param(system, 1), Param(system, 2));
+void SvcWrap(Core::System& system, SvcRegisters& regs) {
+    func(system, static_cast<u32>(Param(regs, 0)), Param(regs, 1), Param(regs, 2));
 }
 
 } // namespace Kernel
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <optional>
 #include <vector>
@@ -21,6 +22,7 @@
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/scheduler.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
@@ -168,7 +170,8 @@ ResultVal<std::shared_ptr<Thread>> Thread::Create(KernelCore& kernel, std::strin
         return RESULT_UNKNOWN;
     }
 
-    std::shared_ptr<Thread> thread = std::make_shared<Thread>(kernel);
+    std::shared_ptr<Thread> thread =
+        std::allocate_shared<Thread>(SlabAllocator<Thread>{kernel.GetObjectHeap()}, kernel);
 
     thread->thread_id = kernel.CreateNewThreadID();
     thread->status = ThreadStatus::Dormant;
@@ -196,6 +199,7 @@ ResultVal<std::shared_ptr<Thread>> Thread::Create(KernelCore& kernel, std::strin
     // TODO(peachum): move to ScheduleThread() when scheduler is added so selected core is used
     // to initialize the context
     ResetThreadContext(thread->context, stack_top, entry_point, arg);
+    thread->InvalidateContext();
 
     return MakeResult<std::shared_ptr<Thread>>(std::move(thread));
 }
@@ -209,10 +213,19 @@ void Thread::SetPriority(u32 priority) {
 
 void Thread::SetWaitSynchronizationResult(ResultCode result) {
     context.cpu_registers[0] = result.raw;
+    InvalidateContext();
 }
 
 void Thread::SetWaitSynchronizationOutput(s32 output) {
     context.cpu_registers[1] = output;
+    InvalidateContext();
+}
+
+void Thread::InvalidateContext() {
+    // Versions are drawn from a single counter, so a thread created where a destroyed one lived
+    // never has a version a core recorded for the destroyed one
+    static std::atomic<u64> next_context_version{1};
+    context_version = next_context_version.fetch_add(1, std::memory_order_relaxed);
 }
 
 s32 Thread::GetWaitObjectIndex(std::shared_ptr<WaitObject> object) const {
@@ -535,6 +548,47 @@ void Thread::AdjustSchedulingOnAffinity(u64 old_affinity_mask, s32 old_core) {
     scheduler.SetReselectionPending();
 }
 
+Thread::Snapshot Thread::TakeSnapshot() const {
+    return {current_priority, nominal_priority, processor_id, status, scheduling_state, is_running,
+            affinity_mask, last_running_ticks, yield_count, context, total_cpu_time_ticks,
+            tpidr_el0, wait_objects, wait_mutex_threads, lock_owner, condvar_wait_address,
+            mutex_wait_address, wait_handle, arb_wait_address, callback_handle, wakeup_callback,
+            scheduler, ideal_core, activity, ideal_core_override, affinity_mask_override,
+            affinity_override_count, is_sync_cancelled};
+}
+
+void Thread::RestoreSnapshot(const Snapshot& snapshot) {
+    current_priority = snapshot.current_priority;
+    nominal_priority = snapshot.nominal_priority;
+    processor_id = snapshot.processor_id;
+    status = snapshot.status;
+    scheduling_state = snapshot.scheduling_state;
+    is_running = snapshot.is_running;
+    affinity_mask = snapshot.affinity_mask;
+    last_running_ticks = snapshot.last_running_ticks;
+    yield_count = snapshot.yield_count;
+    context = snapshot.context;
+    InvalidateContext();
+    total_cpu_time_ticks = snapshot.total_cpu_time_ticks;
+    tpidr_el0 = snapshot.tpidr_el0;
+    wait_objects = snapshot.wait_objects;
+    wait_mutex_threads = snapshot.wait_mutex_threads;
+    lock_owner = snapshot.lock_owner;
+    condvar_wait_address = snapshot.condvar_wait_address;
+    mutex_wait_address = snapshot.mutex_wait_address;
+    wait_handle = snapshot.wait_handle;
+    arb_wait_address = snapshot.arb_wait_address;
+    callback_handle = snapshot.callback_handle;
+    wakeup_callback = snapshot.wakeup_callback;
+    scheduler = snapshot.scheduler;
+    ideal_core = snapshot.ideal_core;
+    activity = snapshot.activity;
+    ideal_core_override = snapshot.ideal_core_override;
+    affinity_mask_override = snapshot.affinity_mask_override;
+    affinity_override_count = snapshot.affinity_override_count;
+    is_sync_cancelled = snapshot.is_sync_cancelled;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include <string>
 #include <vector>
 
 #include "common/common_types.h"
+#include "common/multi_level_queue.h"
 #include "core/arm/arm_interface.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/wait_object.h"
@@ -273,6 +275,8 @@ public:
     }
 
     ThreadContext& GetContext() {
+        // Whatever is written through the reference makes the copy held by a core stale
+        InvalidateContext();
         return context;
     }
 
@@ -280,6 +284,14 @@ public:
         return context;
     }
 
+    /// Returns a value that changes whenever the context is written, unique across all threads.
+    u64 GetContextVersion() const {
+        return context_version;
+    }
+
+    /// Gives the context a new version, to be called whenever it is written.
+    void InvalidateContext();
+
     ThreadStatus GetStatus() const {
         return status;
     }
@@ -452,6 +464,48 @@ public:
         is_sync_cancelled = value;
     }
 
+    /// Returns the link node used by the scheduler queue with the given index.
+    Common::MultiLevelQueueNode<Thread>& GetSchedulingNode(std::size_t index) {
+        return scheduling_nodes[index];
+    }
+
+    /// State of the thread that changes while it runs, see Core::SaveState.
+    struct Snapshot {
+        u32 current_priority;
+        u32 nominal_priority;
+        s32 processor_id;
+        ThreadStatus status;
+        u32 scheduling_state;
+        bool is_running;
+        u64 affinity_mask;
+        u64 last_running_ticks;
+        u64 yield_count;
+        ThreadContext context;
+        u64 total_cpu_time_ticks;
+        u64 tpidr_el0;
+        ThreadWaitObjects wait_objects;
+        MutexWaitingThreads wait_mutex_threads;
+        std::shared_ptr<Thread> lock_owner;
+        VAddr condvar_wait_address;
+        VAddr mutex_wait_address;
+        Handle wait_handle;
+        VAddr arb_wait_address;
+        Handle callback_handle;
+        WakeupCallback wakeup_callback;
+        Scheduler* scheduler;
+        u32 ideal_core;
+        ThreadActivity activity;
+        s32 ideal_core_override;
+        u64 affinity_mask_override;
+        u32 affinity_override_count;
+        bool is_sync_cancelled;
+    };
+
+    Snapshot TakeSnapshot() const;
+
+    /// Restores the thread to a snapshot. The scheduler queues are restored separately.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
 private:
     void SetSchedulingStatus(ThreadSchedStatus new_status);
     void SetCurrentPriority(u32 new_priority);
@@ -461,12 +515,37 @@ private:
     void AdjustSchedulingOnPriority(u32 old_priority);
     void AdjustSchedulingOnAffinity(u64 old_affinity_mask, s32 old_core);
 
-    Core::ARM_Interface::ThreadContext context{};
+    // Scheduling state. The scheduler queues walk over many threads at a time and only read these
+    // fields and the link nodes, so they are kept together at the start of their own cache line,
+    // ahead of the large ThreadContext.
 
-    u64 thread_id = 0;
+    /// Current thread priority. This may change over the course of the
+    /// thread's lifetime in order to facilitate priority inheritance.
+    alignas(64) u32 current_priority = 0;
+
+    s32 processor_id = 0;
 
     ThreadStatus status = ThreadStatus::Dormant;
 
+    u32 scheduling_state = 0;
+    bool is_running = false;
+
+    u64 affinity_mask{0x1};
+
+    u64 last_running_ticks = 0; ///< CPU tick when thread was last running
+    u64 yield_count = 0;        ///< Number of redundant yields carried by this thread.
+                                ///< a redundant yield is one where no scheduling is changed
+
+    /// Link nodes for the scheduled and suggested queues of every core, see GlobalScheduler.
+    std::array<Common::MultiLevelQueueNode<Thread>, 2 * THREADPROCESSORID_MAX> scheduling_nodes{};
+
+    // Everything below is only touched by the thread itself or by the kernel objects it waits on.
+
+    Core::ARM_Interface::ThreadContext context{};
+    u64 context_version = 0;
+
+    u64 thread_id = 0;
+
     VAddr entry_point = 0;
     VAddr stack_top = 0;
 
@@ -475,16 +554,7 @@ private:
     /// inheritance taken into account.
     u32 nominal_priority = 0;
 
-    /// Current thread priority. This may change over the course of the
-    /// thread's lifetime in order to facilitate priority inheritance.
-    u32 current_priority = 0;
-
     u64 total_cpu_time_ticks = 0; ///< Total CPU running ticks.
-    u64 last_running_ticks = 0;   ///< CPU tick when thread was last running
-    u64 yield_count = 0;          ///< Number of redundant yields carried by this thread.
-                                  ///< a redundant yield is one where no scheduling is changed
-
-    s32 processor_id = 0;
 
     VAddr tls_address = 0; ///< Virtual address of the Thread Local Storage of the thread
     u64 tpidr_el0 = 0;     ///< TPIDR_EL0 read/write system register.
@@ -523,7 +593,6 @@ private:
     Scheduler* scheduler = nullptr;
 
     u32 ideal_core{0xFFFFFFFF};
-    u64 affinity_mask{0x1};
 
     ThreadActivity activity = ThreadActivity::Normal;
 
@@ -531,8 +600,6 @@ private:
     u64 affinity_mask_override = 0x1;
     u32 affinity_override_count = 0;
 
-    u32 scheduling_state = 0;
-    bool is_running = false;
     bool is_sync_cancelled = false;
 
     std::string name;
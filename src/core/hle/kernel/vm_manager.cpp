@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <unordered_map>
 #include <utility>
 #include "common/alignment.h"
 #include "common/assert.h"
@@ -516,7 +517,7 @@ ResultCode VMManager::UnmapCodeMemory(VAddr dst_address, VAddr src_address, u64
     Reprotect(src_vma_iter, VMAPermission::ReadWrite);
 
     if (dst_memory_state == MemoryState::ModuleCode) {
-        system.InvalidateCpuInstructionCaches();
+        system.InvalidateCpuInstructionCacheRange(dst_address, size);
     }
 
     return unmap_result;
@@ -606,6 +607,39 @@ void VMManager::RefreshMemoryBlockMappings(const PhysicalMemory* block) {
     }
 }
 
+VMManager::Snapshot VMManager::TakeSnapshot() const {
+    Snapshot snapshot{vma_map, heap_memory, heap_end, physical_memory_mapped, {}};
+
+    // Blocks mapped more than once are only copied once
+    std::unordered_map<const PhysicalMemory*, std::shared_ptr<PhysicalMemory>> writable_blocks;
+    for (const auto& [base, vma] : vma_map) {
+        if (vma.type == VMAType::AllocatedMemoryBlock &&
+            (vma.permissions & VMAPermission::Write) != VMAPermission::None) {
+            writable_blocks.emplace(vma.backing_block.get(), vma.backing_block);
+        }
+    }
+    snapshot.block_copies.reserve(writable_blocks.size());
+    for (const auto& [pointer, block] : writable_blocks) {
+        snapshot.block_copies.emplace_back(block, *block);
+    }
+    return snapshot;
+}
+
+void VMManager::RestoreSnapshot(const Snapshot& snapshot) {
+    for (const auto& [block, copy] : snapshot.block_copies) {
+        *block = copy;
+    }
+    vma_map = snapshot.vma_map;
+    heap_memory = snapshot.heap_memory;
+    heap_end = snapshot.heap_end;
+    physical_memory_mapped = snapshot.physical_memory_mapped;
+
+    // The free areas unmap whatever was mapped since the snapshot
+    for (const auto& [base, vma] : vma_map) {
+        UpdatePageTableForVMA(vma);
+    }
+}
+
 void VMManager::LogLayout() const {
     for (const auto& p : vma_map) {
         const VirtualMemoryArea& vma = p.second;
@@ -882,10 +916,7 @@ void VMManager::ClearVMAMap() {
 }
 
 void VMManager::ClearPageTable() {
-    std::fill(page_table.pointers.begin(), page_table.pointers.end(), nullptr);
-    page_table.special_regions.clear();
-    std::fill(page_table.attributes.begin(), page_table.attributes.end(),
-              Common::PageType::Unmapped);
+    page_table.Clear();
 }
 
 VMManager::CheckResults VMManager::CheckRangeState(VAddr address, u64 size, MemoryState state_mask,
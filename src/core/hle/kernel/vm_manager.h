@@ -10,6 +10,7 @@
 #include <vector>
 #include "common/common_types.h"
 #include "common/memory_hook.h"
+#include "common/node_pool.h"
 #include "common/page_table.h"
 #include "core/hle/kernel/physical_memory.h"
 #include "core/hle/result.h"
@@ -323,7 +324,8 @@ struct VirtualMemoryArea {
  *  - http://duartes.org/gustavo/blog/post/page-cache-the-affair-between-memory-and-files/
  */
 class VMManager final {
-    using VMAMap = std::map<VAddr, VirtualMemoryArea>;
+    using VMAMap = std::map<VAddr, VirtualMemoryArea, std::less<VAddr>,
+                            Common::PoolAllocator<std::pair<const VAddr, VirtualMemoryArea>>>;
 
 public:
     using VMAHandle = VMAMap::const_iterator;
@@ -552,6 +554,23 @@ public:
      */
     void RefreshMemoryBlockMappings(const PhysicalMemory* block);
 
+    /// Layout and contents of the address space, see Core::SaveState.
+    struct Snapshot {
+        VMAMap vma_map;
+        std::shared_ptr<PhysicalMemory> heap_memory;
+        VAddr heap_end;
+        u64 physical_memory_mapped;
+
+        /// Copies of the blocks the guest can write to. The blocks that are only mapped read-only,
+        /// like the code of the loaded modules, are kept alive by vma_map but not copied.
+        std::vector<std::pair<std::shared_ptr<PhysicalMemory>, PhysicalMemory>> block_copies;
+    };
+
+    Snapshot TakeSnapshot() const;
+
+    /// Restores the layout and the contents of the address space and rebuilds the page table.
+    void RestoreSnapshot(const Snapshot& snapshot);
+
     /// Dumps the address space layout to the log, for debugging
     void LogLayout() const;
 
@@ -745,6 +764,9 @@ private:
     ResultVal<std::size_t> SizeOfUnmappablePhysicalMemoryInRange(VAddr address,
                                                                  std::size_t size) const;
 
+    /// Nodes of vma_map, which splits and merges VMAs on most memory SVCs
+    Common::NodePool vma_pool;
+
     /**
      * A map covering the entirety of the managed address space, keyed by the `base` field of each
      * VMA. It must always be modified by splitting or merging VMAs, so that the invariant
@@ -752,7 +774,7 @@ private:
      * merged when possible so that no two similar and adjacent regions exist that have not been
      * merged.
      */
-    VMAMap vma_map;
+    VMAMap vma_map{VMAMap::allocator_type{&vma_pool}};
 
     u32 address_space_width = 0;
     VAddr address_space_base = 0;
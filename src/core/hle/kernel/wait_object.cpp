@@ -100,4 +100,8 @@ const std::vector<std::shared_ptr<Thread>>& WaitObject::GetWaitingThreads() cons
     return waiting_threads;
 }
 
+void WaitObject::SetWaitingThreads(std::vector<std::shared_ptr<Thread>> threads) {
+    waiting_threads = std::move(threads);
+}
+
 } // namespace Kernel
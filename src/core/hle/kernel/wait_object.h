@@ -60,6 +60,9 @@ public:
     /// Get a const reference to the waiting threads list for debug use
     const std::vector<std::shared_ptr<Thread>>& GetWaitingThreads() const;
 
+    /// Replaces the waiting threads list without waking anything up, used to restore save states.
+    void SetWaitingThreads(std::vector<std::shared_ptr<Thread>> threads);
+
 private:
     /// Threads waiting for this object to become available
     std::vector<std::shared_ptr<Thread>> waiting_threads;
@@ -7,6 +7,7 @@
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/readable_event.h"
+#include "core/hle/kernel/slab_heap.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/kernel/writable_event.h"
 
@@ -16,8 +17,11 @@ WritableEvent::WritableEvent(KernelCore& kernel) : Object{kernel} {}
 WritableEvent::~WritableEvent() = default;
 
 EventPair WritableEvent::CreateEventPair(KernelCore& kernel, std::string name) {
-    std::shared_ptr<WritableEvent> writable_event(new WritableEvent(kernel));
-    std::shared_ptr<ReadableEvent> readable_event(new ReadableEvent(kernel));
+    const auto& heap = kernel.GetObjectHeap();
+    std::shared_ptr<WritableEvent> writable_event =
+        std::allocate_shared<WritableEvent>(SlabAllocator<WritableEvent>{heap}, kernel);
+    std::shared_ptr<ReadableEvent> readable_event =
+        std::allocate_shared<ReadableEvent>(SlabAllocator<ReadableEvent>{heap}, kernel);
 
     writable_event->name = name + ":Writable";
     writable_event->readable = readable_event;
@@ -49,6 +49,9 @@ public:
     bool IsSignaled() const;
 
 private:
+    template <typename T>
+    friend class SlabAllocator;
+
     explicit WritableEvent(KernelCore& kernel);
 
     std::shared_ptr<ReadableEvent> readable;
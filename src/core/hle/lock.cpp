@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <core/hle/lock.h>
+#include "core/core.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/lock.h"
 
 namespace HLE {
-std::recursive_mutex g_hle_lock;
+std::recursive_mutex& GetLock() {
+    return Core::System::GetInstance().Kernel().HLELock();
 }
+} // namespace HLE
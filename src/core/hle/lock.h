@@ -13,6 +13,7 @@ namespace HLE {
  * modify the HLE kernel state. Note: Any operation that directly or indirectly reads from or writes
  * to the emulated memory is not protected by this mutex, and should be avoided in any threads other
  * than the CPU thread.
+ * Every kernel has its own lock, this returns the one of the system bound to the calling thread.
  */
-extern std::recursive_mutex g_hle_lock;
+std::recursive_mutex& GetLock();
 } // namespace HLE
@@ -30,7 +30,7 @@ void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system
     std::make_shared<AudRenA>()->InstallAsService(service_manager);
     std::make_shared<AudRenU>(system)->InstallAsService(service_manager);
     std::make_shared<CodecCtl>()->InstallAsService(service_manager);
-    std::make_shared<HwOpus>()->InstallAsService(service_manager);
+    std::make_shared<HwOpus>(system)->InstallAsService(service_manager);
 
     std::make_shared<AudDbg>("audin:d")->InstallAsService(service_manager);
     std::make_shared<AudDbg>("audout:d")->InstallAsService(service_manager);
@@ -2,9 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
 #include <vector>
 
 #include <opus.h>
@@ -12,9 +17,17 @@
 
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread_worker.h"
+#include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/writable_event.h"
 #include "core/hle/service/audio/hwopus.h"
+#include "core/settings.h"
+
+MICROPROFILE_DEFINE(Audio_OpusDecode, "Audio", "Opus Decode", MP_RGB(100, 200, 100));
 
 namespace Service::Audio {
 namespace {
@@ -50,33 +63,70 @@ public:
         Enabled,
     };
 
+    /// Input and output of a single DecodeInterleaved request, detached from its IPC context.
+    struct DecodeRequest {
+        explicit DecodeRequest(Kernel::HLERequestContext& ctx, PerfTime perf_time,
+                               ExtraBehavior extra_behavior)
+            : input{ctx.ReadBuffer()}, samples(ctx.GetWriteBufferSize() / sizeof(opus_int16)),
+              perf_time{perf_time}, extra_behavior{extra_behavior} {}
+
+        std::vector<u8> input;
+        std::vector<opus_int16> samples;
+        PerfTime perf_time;
+        ExtraBehavior extra_behavior;
+        u32 consumed = 0;
+        u32 sample_count = 0;
+        u64 performance = 0;
+        bool success = false;
+    };
+
     explicit OpusDecoderState(OpusDecoderPtr decoder, u32 sample_rate, u32 channel_count)
         : decoder{std::move(decoder)}, sample_rate{sample_rate}, channel_count{channel_count} {}
 
+    OpusDecoderState(OpusDecoderState&&) noexcept = default;
+
+    ~OpusDecoderState() {
+        if (num_decodes == 0) {
+            return;
+        }
+        LOG_DEBUG(Audio, "Decoded {} opus packets in {} us, average={} us, max={} us",
+                  num_decodes, total_decode_time, total_decode_time / num_decodes,
+                  max_decode_time);
+    }
+
     // Decodes interleaved Opus packets. Optionally allows reporting time taken to
     // perform the decoding, as well as any relevant extra behavior.
     void DecodeInterleaved(Kernel::HLERequestContext& ctx, PerfTime perf_time,
                            ExtraBehavior extra_behavior) {
-        if (perf_time == PerfTime::Disabled) {
-            DecodeInterleavedHelper(ctx, nullptr, extra_behavior);
-        } else {
-            u64 performance = 0;
-            DecodeInterleavedHelper(ctx, &performance, extra_behavior);
-        }
+        DecodeRequest request{ctx, perf_time, extra_behavior};
+        Decode(request);
+        WriteResponse(ctx, request);
     }
 
-private:
-    void DecodeInterleavedHelper(Kernel::HLERequestContext& ctx, u64* performance,
-                                 ExtraBehavior extra_behavior) {
-        u32 consumed = 0;
-        u32 sample_count = 0;
-        std::vector<opus_int16> samples(ctx.GetWriteBufferSize() / sizeof(opus_int16));
+    /// Decodes a detached request. Not thread safe, requests of a decoder have to be serialized.
+    void Decode(DecodeRequest& request) {
+        MICROPROFILE_SCOPE(Audio_OpusDecode);
+        const auto start_time = std::chrono::steady_clock::now();
 
-        if (extra_behavior == ExtraBehavior::ResetContext) {
+        if (request.extra_behavior == ExtraBehavior::ResetContext) {
             ResetDecoderContext();
         }
+        u64* const performance =
+            request.perf_time == PerfTime::Enabled ? &request.performance : nullptr;
+        request.success = DecodeOpusData(request.consumed, request.sample_count, request.input,
+                                         request.samples, performance);
+
+        const auto decode_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - start_time)
+                                     .count();
+        ++num_decodes;
+        total_decode_time += static_cast<u64>(decode_time);
+        max_decode_time = std::max(max_decode_time, static_cast<u64>(decode_time));
+    }
 
-        if (!DecodeOpusData(consumed, sample_count, ctx.ReadBuffer(), samples, performance)) {
+    /// Writes the result of a decoded request to its IPC context.
+    static void WriteResponse(Kernel::HLERequestContext& ctx, const DecodeRequest& request) {
+        if (!request.success) {
             LOG_ERROR(Audio, "Failed to decode opus data");
             IPC::ResponseBuilder rb{ctx, 2};
             // TODO(ogniK): Use correct error code
@@ -84,17 +134,20 @@ private:
             return;
         }
 
-        const u32 param_size = performance != nullptr ? 6 : 4;
+        const bool has_performance = request.perf_time == PerfTime::Enabled;
+        const u32 param_size = has_performance ? 6 : 4;
         IPC::ResponseBuilder rb{ctx, param_size};
         rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(consumed);
-        rb.Push<u32>(sample_count);
-        if (performance) {
-            rb.Push<u64>(*performance);
+        rb.Push<u32>(request.consumed);
+        rb.Push<u32>(request.sample_count);
+        if (has_performance) {
+            rb.Push<u64>(request.performance);
         }
-        ctx.WriteBuffer(samples.data(), samples.size() * sizeof(s16));
+        ctx.WriteBuffer(request.samples.data(), request.samples.size() * sizeof(s16));
     }
 
+private:
+
     bool DecodeOpusData(u32& consumed, u32& sample_count, const std::vector<u8>& input,
                         std::vector<opus_int16>& output, u64* out_performance_time) const {
         const auto start_time = std::chrono::high_resolution_clock::now();
@@ -156,12 +209,18 @@ private:
     OpusDecoderPtr decoder;
     u32 sample_rate;
     u32 channel_count;
+
+    // Decode timing counters, in microseconds
+    u64 num_decodes = 0;
+    u64 total_decode_time = 0;
+    u64 max_decode_time = 0;
 };
 
 class IHardwareOpusDecoderManager final : public ServiceFramework<IHardwareOpusDecoderManager> {
 public:
-    explicit IHardwareOpusDecoderManager(OpusDecoderState decoder_state)
-        : ServiceFramework("IHardwareOpusDecoderManager"), decoder_state{std::move(decoder_state)} {
+    explicit IHardwareOpusDecoderManager(Core::System& system, OpusDecoderState decoder_state)
+        : ServiceFramework("IHardwareOpusDecoderManager"), system{system},
+          decoder_state{std::move(decoder_state)} {
         // clang-format off
         static const FunctionInfo functions[] = {
             {0, &IHardwareOpusDecoderManager::DecodeInterleavedOld, "DecodeInterleavedOld"},
@@ -176,21 +235,37 @@ public:
         // clang-format on
 
         RegisterHandlers(functions);
+
+        // Decoded requests are handed back to the emu thread, where their guest thread is woken up
+        decoded_event = Core::Timing::CreateEvent("IHardwareOpusDecoderManager:Decoded",
+                                                  [this](u64, s64) { SignalDecoded(); });
+    }
+
+    ~IHardwareOpusDecoderManager() override {
+        decode_tasks.Wait();
+        system.CoreTiming().RemoveEvent(decoded_event);
     }
 
 private:
+    using DecodeRequest = OpusDecoderState::DecodeRequest;
+
+    struct PendingDecode {
+        explicit PendingDecode(DecodeRequest request) : request{std::move(request)} {}
+
+        DecodeRequest request;
+        std::shared_ptr<Kernel::WritableEvent> event;
+    };
+
     void DecodeInterleavedOld(Kernel::HLERequestContext& ctx) {
         LOG_DEBUG(Audio, "called");
 
-        decoder_state.DecodeInterleaved(ctx, OpusDecoderState::PerfTime::Disabled,
-                                        OpusDecoderState::ExtraBehavior::None);
+        Decode(ctx, OpusDecoderState::PerfTime::Disabled, OpusDecoderState::ExtraBehavior::None);
     }
 
     void DecodeInterleavedWithPerfOld(Kernel::HLERequestContext& ctx) {
         LOG_DEBUG(Audio, "called");
 
-        decoder_state.DecodeInterleaved(ctx, OpusDecoderState::PerfTime::Enabled,
-                                        OpusDecoderState::ExtraBehavior::None);
+        Decode(ctx, OpusDecoderState::PerfTime::Enabled, OpusDecoderState::ExtraBehavior::None);
     }
 
     void DecodeInterleaved(Kernel::HLERequestContext& ctx) {
@@ -200,10 +275,90 @@ private:
         const auto extra_behavior = rp.Pop<bool>() ? OpusDecoderState::ExtraBehavior::ResetContext
                                                    : OpusDecoderState::ExtraBehavior::None;
 
-        decoder_state.DecodeInterleaved(ctx, OpusDecoderState::PerfTime::Enabled, extra_behavior);
+        Decode(ctx, OpusDecoderState::PerfTime::Enabled, extra_behavior);
+    }
+
+    void Decode(Kernel::HLERequestContext& ctx, OpusDecoderState::PerfTime perf_time,
+                OpusDecoderState::ExtraBehavior extra_behavior) {
+        if (!Settings::values.use_asynchronous_audio_decoding) {
+            decoder_state.DecodeInterleaved(ctx, perf_time, extra_behavior);
+            return;
+        }
+
+        const std::string reason = "IHardwareOpusDecoderManager:DecodeInterleaved";
+        auto pending =
+            std::make_shared<PendingDecode>(DecodeRequest{ctx, perf_time, extra_behavior});
+        pending->event = Kernel::WritableEvent::CreateEventPair(system.Kernel(), reason).writable;
+
+        // Requests are decoded in submission order by a single task at a time, the decoder state
+        // is never touched concurrently and the stream is decoded in the same order as the guest
+        // asked for it
+        {
+            std::lock_guard lock{mutex};
+            queued_decodes.push_back(pending);
+            if (!is_decoding) {
+                is_decoding = true;
+                Common::GetSharedWorker().QueueWork(decode_tasks, [this] { DecodeQueued(); },
+                                                    Common::WorkPriority::High);
+            }
+        }
+
+        // The guest thread sleeps until its request is decoded while the emu thread keeps running
+        ctx.SleepClientThread(
+            reason, 0,
+            [pending](std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                      Kernel::ThreadWakeupReason reason) {
+                OpusDecoderState::WriteResponse(ctx, pending->request);
+            },
+            pending->event);
+    }
+
+    /// Decodes every queued request, runs on the shared worker.
+    void DecodeQueued() {
+        while (true) {
+            std::shared_ptr<PendingDecode> pending;
+            {
+                std::lock_guard lock{mutex};
+                if (queued_decodes.empty()) {
+                    is_decoding = false;
+                    return;
+                }
+                pending = std::move(queued_decodes.front());
+                queued_decodes.pop_front();
+            }
+
+            decoder_state.Decode(pending->request);
+
+            {
+                std::lock_guard lock{mutex};
+                decoded.push(std::move(pending->event));
+            }
+            system.CoreTiming().ScheduleEventThreadsafe(0, decoded_event);
+        }
     }
 
+    /// Wakes up the guest thread of the oldest decoded request, runs on the emu thread.
+    void SignalDecoded() {
+        std::shared_ptr<Kernel::WritableEvent> event;
+        {
+            std::lock_guard lock{mutex};
+            ASSERT(!decoded.empty());
+            event = std::move(decoded.front());
+            decoded.pop();
+        }
+        event->Signal();
+    }
+
+    Core::System& system;
     OpusDecoderState decoder_state;
+
+    std::mutex mutex;
+    std::deque<std::shared_ptr<PendingDecode>> queued_decodes;
+    std::queue<std::shared_ptr<Kernel::WritableEvent>> decoded;
+    bool is_decoding = false;
+
+    Common::TaskGroup decode_tasks;
+    std::shared_ptr<Core::Timing::EventType> decoded_event;
 };
 
 std::size_t WorkerBufferSize(u32 channel_count) {
@@ -285,10 +440,10 @@ void HwOpus::OpenOpusDecoder(Kernel::HLERequestContext& ctx) {
     IPC::ResponseBuilder rb{ctx, 2, 0, 1};
     rb.Push(RESULT_SUCCESS);
     rb.PushIpcInterface<IHardwareOpusDecoderManager>(
-        OpusDecoderState{std::move(decoder), sample_rate, channel_count});
+        system, OpusDecoderState{std::move(decoder), sample_rate, channel_count});
 }
 
-HwOpus::HwOpus() : ServiceFramework("hwopus") {
+HwOpus::HwOpus(Core::System& system) : ServiceFramework("hwopus"), system{system} {
     static const FunctionInfo functions[] = {
         {0, &HwOpus::OpenOpusDecoder, "OpenOpusDecoder"},
         {1, &HwOpus::GetWorkBufferSize, "GetWorkBufferSize"},
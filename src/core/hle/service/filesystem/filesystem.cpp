@@ -16,6 +16,7 @@
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/romfs_factory.h"
+#include "core/file_sys/savedata_cache.h"
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/sdmc_factory.h"
 #include "core/file_sys/vfs.h"
@@ -241,6 +242,13 @@ ResultVal<FileSys::EntryType> VfsDirectoryServiceWrapper::GetEntryType(
     return FileSys::ERROR_PATH_NOT_FOUND;
 }
 
+ResultCode VfsDirectoryServiceWrapper::Commit() const {
+    if (const auto save = std::dynamic_pointer_cast<FileSys::CachedSaveDataDirectory>(backing)) {
+        save->Commit();
+    }
+    return RESULT_SUCCESS;
+}
+
 FileSystemController::FileSystemController(Core::System& system_) : system{system_} {}
 
 FileSystemController::~FileSystemController() = default;
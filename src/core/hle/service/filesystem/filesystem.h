@@ -233,6 +233,13 @@ public:
      */
     ResultVal<FileSys::EntryType> GetEntryType(const std::string& path) const;
 
+    /**
+     * Write the pending changes of a cached save data archive to the host. Other archives are
+     * written through and have nothing to commit.
+     * @return Result of the operation
+     */
+    ResultCode Commit() const;
+
 private:
     FileSys::VirtualDir backing;
 };
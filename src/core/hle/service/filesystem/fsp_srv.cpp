@@ -2,9 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +30,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/hle/service/filesystem/fsp_srv.h"
+#include "core/hle/service/filesystem/read_ahead.h"
 #include "core/reporter.h"
 
 namespace Service::FileSystem {
@@ -93,10 +97,15 @@ private:
             return;
         }
 
-        // Read the data from the Storage backend
-        std::vector<u8> output = backend->ReadBytes(length, offset);
-        // Write the data to memory
-        ctx.WriteBuffer(output);
+        // Read the data from the Storage backend straight into the output buffer
+        const auto output = ctx.WriteBufferView();
+        const auto read_size = std::min(static_cast<std::size_t>(length), output.size());
+        std::size_t bytes_read;
+        {
+            std::lock_guard lock{GetBackendMutex()};
+            bytes_read = backend->Read(output.data(), read_size, offset);
+        }
+        ctx.WriteBuffer(output.data(), bytes_read);
 
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(RESULT_SUCCESS);
@@ -122,10 +131,16 @@ public:
             {4, &IFile::GetSize, "GetSize"}, {5, nullptr, "OperateRange"},
         };
         RegisterHandlers(functions);
+
+        // Files that can change under the prefetched data are always read directly
+        if (!backend->IsWritable()) {
+            read_ahead = std::make_unique<ReadAheadFile>(backend);
+        }
     }
 
 private:
     FileSys::VirtualFile backend;
+    std::unique_ptr<ReadAheadFile> read_ahead;
 
     void Read(Kernel::HLERequestContext& ctx) {
         IPC::RequestParser rp{ctx};
@@ -150,15 +165,21 @@ private:
             return;
         }
 
-        // Read the data from the Storage backend
-        std::vector<u8> output = backend->ReadBytes(length, offset);
-
-        // Write the data to memory
-        ctx.WriteBuffer(output);
+        // Read the data from the Storage backend straight into the output buffer
+        const auto output = ctx.WriteBufferView();
+        const auto read_size = std::min(static_cast<std::size_t>(length), output.size());
+        std::size_t bytes_read;
+        if (read_ahead) {
+            bytes_read = read_ahead->Read(output.data(), read_size, offset);
+        } else {
+            std::lock_guard lock{GetBackendMutex()};
+            bytes_read = backend->Read(output.data(), read_size, offset);
+        }
+        ctx.WriteBuffer(output.data(), bytes_read);
 
         IPC::ResponseBuilder rb{ctx, 4};
         rb.Push(RESULT_SUCCESS);
-        rb.Push(static_cast<u64>(output.size()));
+        rb.Push(static_cast<u64>(bytes_read));
     }
 
     void Write(Kernel::HLERequestContext& ctx) {
@@ -184,7 +205,7 @@ private:
             return;
         }
 
-        const std::vector<u8> data = ctx.ReadBuffer();
+        const auto data = ctx.ReadBufferView();
 
         ASSERT_MSG(
             static_cast<s64>(data.size()) <= length,
@@ -192,8 +213,7 @@ private:
             length, data.size());
 
         // Write the data to the Storage backend
-        const auto write_size =
-            static_cast<std::size_t>(std::distance(data.begin(), data.begin() + length));
+        const auto write_size = std::min(static_cast<std::size_t>(length), data.size());
         const std::size_t written = backend->Write(data.data(), write_size, offset);
 
         ASSERT_MSG(static_cast<s64>(written) == length,
@@ -471,10 +491,10 @@ public:
     }
 
     void Commit(Kernel::HLERequestContext& ctx) {
-        LOG_WARNING(Service_FS, "(STUBBED) called");
+        LOG_DEBUG(Service_FS, "called");
 
         IPC::ResponseBuilder rb{ctx, 2};
-        rb.Push(RESULT_SUCCESS);
+        rb.Push(backend.Commit());
     }
 
     void GetFreeSpaceSize(Kernel::HLERequestContext& ctx) {
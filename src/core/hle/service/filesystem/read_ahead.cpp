@@ -0,0 +1,119 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "core/file_sys/vfs.h"
+#include "core/hle/service/filesystem/read_ahead.h"
+
+namespace Service::FileSystem {
+
+namespace {
+
+/// Number of back to back reads before the access is considered sequential
+constexpr u32 SEQUENTIAL_THRESHOLD = 2;
+
+/// Bounds of the amount of data read ahead, which scales with the size of the guest reads
+constexpr std::size_t MIN_WINDOW = 0x40000;
+constexpr std::size_t MAX_WINDOW = 0x400000;
+
+/// The prefetches run on their own thread so they never queue behind unrelated work
+Common::ThreadWorker& GetIOWorker() {
+    static Common::ThreadWorker worker{1, "yuzu:FileReadAhead"};
+    return worker;
+}
+
+} // Anonymous namespace
+
+std::mutex& GetBackendMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+ReadAheadFile::ReadAheadFile(FileSys::VirtualFile file_)
+    : file(std::move(file_)), file_size(file->GetSize()) {}
+
+ReadAheadFile::~ReadAheadFile() {
+    prefetch_group.Wait();
+}
+
+std::size_t ReadAheadFile::Read(u8* data, std::size_t length, std::size_t offset) {
+    if (offset >= file_size) {
+        return 0;
+    }
+    length = std::min(length, file_size - offset);
+
+    std::unique_lock lock{mutex};
+    sequential_reads = offset == next_offset ? sequential_reads + 1 : 0;
+    next_offset = offset + length;
+
+    if (is_prefetching && offset < prefetch_offset + prefetch_length &&
+        offset + length > prefetch_offset) {
+        // The data is already on its way, wait for it instead of reading it twice
+        lock.unlock();
+        prefetch_group.Wait();
+        lock.lock();
+    }
+
+    std::size_t read = 0;
+    if (offset >= buffer_offset && offset < buffer_offset + buffer.size()) {
+        read = std::min(length, buffer_offset + buffer.size() - offset);
+        std::memcpy(data, buffer.data() + (offset - buffer_offset), read);
+    }
+    if (read < length) {
+        std::lock_guard backend_lock{GetBackendMutex()};
+        read += file->Read(data + read, length - read, offset + read);
+    }
+
+    if (sequential_reads >= SEQUENTIAL_THRESHOLD && !is_prefetching) {
+        const std::size_t window = std::clamp(length * 4, MIN_WINDOW, MAX_WINDOW);
+        const std::size_t buffered_end = GetBufferedEnd();
+        if (buffered_end - next_offset < window / 2 && buffered_end < file_size) {
+            QueuePrefetch(buffered_end, std::min(window, file_size - buffered_end));
+        }
+    }
+    return read;
+}
+
+std::size_t ReadAheadFile::GetBufferedEnd() const {
+    const std::size_t buffer_end = buffer_offset + buffer.size();
+    if (next_offset >= buffer_offset && next_offset < buffer_end) {
+        return buffer_end;
+    }
+    return next_offset;
+}
+
+void ReadAheadFile::QueuePrefetch(std::size_t offset, std::size_t length) {
+    is_prefetching = true;
+    prefetch_offset = offset;
+    prefetch_length = length;
+    GetIOWorker().QueueWork(prefetch_group, [this, offset, length] {
+        std::vector<u8> data(length);
+        {
+            std::lock_guard backend_lock{GetBackendMutex()};
+            data.resize(file->Read(data.data(), length, offset));
+        }
+        std::lock_guard lock{mutex};
+        CompletePrefetch(offset, std::move(data));
+    });
+}
+
+void ReadAheadFile::CompletePrefetch(std::size_t offset, std::vector<u8> data) {
+    is_prefetching = false;
+    const std::size_t buffer_end = buffer_offset + buffer.size();
+    if (offset != buffer_end || next_offset < buffer_offset) {
+        buffer = std::move(data);
+        buffer_offset = offset;
+        return;
+    }
+    // Drop what the guest has already read and append the new data after what is left
+    const std::size_t consumed = std::min(next_offset, buffer_end) - buffer_offset;
+    buffer.erase(buffer.begin(), buffer.begin() + consumed);
+    buffer_offset += consumed;
+    buffer.insert(buffer.end(), data.begin(), data.end());
+}
+
+} // namespace Service::FileSystem
@@ -0,0 +1,66 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/vfs_types.h"
+
+namespace Service::FileSystem {
+
+/**
+ * Serializes the reads of file backends done by the fsp-srv interfaces and the read-ahead
+ * worker. The layers below a file, like host file handles and cipher contexts, are shared between
+ * the handles to the same content and are not safe to use from several threads.
+ */
+std::mutex& GetBackendMutex();
+
+/**
+ * Reader of a read-only file that detects sequential access and prefetches the data following
+ * the last read on an I/O thread, so the next read is served from memory.
+ */
+class ReadAheadFile final {
+public:
+    explicit ReadAheadFile(FileSys::VirtualFile file);
+    ~ReadAheadFile();
+
+    ReadAheadFile(const ReadAheadFile&) = delete;
+    ReadAheadFile& operator=(const ReadAheadFile&) = delete;
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset);
+
+private:
+    /// Returns the end of the buffered data when it continues the last read.
+    std::size_t GetBufferedEnd() const;
+
+    /// Queues the read of the given range. The mutex must be held.
+    void QueuePrefetch(std::size_t offset, std::size_t length);
+
+    /// Adds prefetched data to the buffer. The mutex must be held.
+    void CompletePrefetch(std::size_t offset, std::vector<u8> data);
+
+    FileSys::VirtualFile file;
+    std::size_t file_size;
+
+    std::mutex mutex;
+    Common::TaskGroup prefetch_group;
+    bool is_prefetching = false;
+    std::size_t prefetch_offset = 0;
+    std::size_t prefetch_length = 0;
+
+    /// Data read ahead of the guest, starting at buffer_offset
+    std::vector<u8> buffer;
+    std::size_t buffer_offset = 0;
+
+    /// Offset the next read starts at when the access is sequential
+    std::size_t next_offset = 0;
+    u32 sequential_reads = 0;
+};
+
+} // namespace Service::FileSystem
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstring>
 #include "common/common_types.h"
 #include "common/swap.h"
 
@@ -51,6 +53,18 @@ protected:
     };
     static_assert(sizeof(CommonHeader) == 0x20, "CommonHeader is an invalid size");
 
+    /**
+     * Copies one member of a shared memory block into the guest copy of the block at block_data.
+     * An update only changes a LIFO header and its newest entry, copying just those avoids
+     * rewriting the whole block every update.
+     */
+    template <typename Block, typename T>
+    static void WriteSharedMemory(u8* block_data, const Block& block, const T& member) {
+        const auto offset =
+            reinterpret_cast<const u8*>(&member) - reinterpret_cast<const u8*>(&block);
+        std::memcpy(block_data + offset, &member, sizeof(T));
+    }
+
     Core::System& system;
 };
 } // namespace Service::HID
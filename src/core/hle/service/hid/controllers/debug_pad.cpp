@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <cstring>
 #include "common/common_types.h"
 #include "core/core_timing.h"
 #include "core/hle/service/hid/controllers/debug_pad.h"
@@ -67,7 +66,8 @@ void Controller_DebugPad::OnUpdate(const Core::Timing::CoreTiming& core_timing,
     cur_entry.r_stick.x = static_cast<s32>(stick_r_x_f * HID_JOYSTICK_MAX);
     cur_entry.r_stick.y = static_cast<s32>(stick_r_y_f * HID_JOYSTICK_MAX);
 
-    std::memcpy(data, &shared_memory, sizeof(SharedMemory));
+    WriteSharedMemory(data, shared_memory, shared_memory.header);
+    WriteSharedMemory(data, shared_memory, cur_entry);
 }
 
 void Controller_DebugPad::OnLoadInputDevices() {
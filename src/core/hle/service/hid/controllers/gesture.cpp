@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <cstring>
 #include "common/common_types.h"
 #include "core/core_timing.h"
 #include "core/hle/service/hid/controllers/gesture.h"
@@ -37,7 +36,8 @@ void Controller_Gesture::OnUpdate(const Core::Timing::CoreTiming& core_timing, u
     cur_entry.sampling_number2 = cur_entry.sampling_number;
     // TODO(ogniK): Update gesture states
 
-    std::memcpy(data + SHARED_MEMORY_OFFSET, &shared_memory, sizeof(SharedMemory));
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, shared_memory.header);
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, cur_entry);
 }
 
 void Controller_Gesture::OnLoadInputDevices() {}
@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <cstring>
 #include "common/common_types.h"
 #include "core/core_timing.h"
 #include "core/hle/service/hid/controllers/keyboard.h"
@@ -48,7 +47,8 @@ void Controller_Keyboard::OnUpdate(const Core::Timing::CoreTiming& core_timing,
         cur_entry.modifier |= (keyboard_mods[i]->GetStatus() << i);
     }
 
-    std::memcpy(data + SHARED_MEMORY_OFFSET, &shared_memory, sizeof(SharedMemory));
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, shared_memory.header);
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, cur_entry);
 }
 
 void Controller_Keyboard::OnLoadInputDevices() {
@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <cstring>
 #include "common/common_types.h"
 #include "core/core_timing.h"
 #include "core/frontend/emu_window.h"
@@ -52,7 +51,8 @@ void Controller_Mouse::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
         }
     }
 
-    std::memcpy(data + SHARED_MEMORY_OFFSET, &shared_memory, sizeof(SharedMemory));
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, shared_memory.header);
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, cur_entry);
 }
 
 void Controller_Mouse::OnLoadInputDevices() {
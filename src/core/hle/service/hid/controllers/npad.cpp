@@ -93,7 +93,9 @@ u32 Controller_NPad::IndexToNPad(std::size_t index) {
     };
 }
 
-Controller_NPad::Controller_NPad(Core::System& system) : ControllerBase(system), system(system) {}
+Controller_NPad::Controller_NPad(Core::System& system) : ControllerBase(system), system(system) {
+    is_entry_dirty.fill(true);
+}
 Controller_NPad::~Controller_NPad() = default;
 
 void Controller_NPad::InitNewlyAddedControler(std::size_t controller_idx) {
@@ -167,6 +169,7 @@ void Controller_NPad::InitNewlyAddedControler(std::size_t controller_idx) {
     controller.battery_level[0] = BATTERY_FULL;
     controller.battery_level[1] = BATTERY_FULL;
     controller.battery_level[2] = BATTERY_FULL;
+    is_entry_dirty[controller_idx] = true;
     styleset_changed_events[controller_idx].writable->Signal();
 }
 
@@ -340,6 +343,7 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
         const auto& controller_type = connected_controllers[i].type;
 
         if (controller_type == NPadControllerType::None || !connected_controllers[i].is_connected) {
+            WriteNPadEntry(i, data);
             continue;
         }
         const u32 npad_index = static_cast<u32>(i);
@@ -433,9 +437,24 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
         libnx_entry.pad.r_stick = pad_state.r_stick;
 
         press_state |= static_cast<u32>(pad_state.pad_states.raw);
+        WriteNPadEntry(i, data);
+    }
+}
+
+void Controller_NPad::WriteNPadEntry(std::size_t npad_index, u8* data) {
+    const auto& npad = shared_memory_entries[npad_index];
+    u8* const npad_data = data + NPAD_OFFSET + npad_index * sizeof(NPadEntry);
+    if (is_entry_dirty[npad_index]) {
+        std::memcpy(npad_data, &npad, sizeof(NPadEntry));
+        is_entry_dirty[npad_index] = false;
+        return;
+    }
+    for (const NPadGeneric* states :
+         {&npad.main_controller_states, &npad.handheld_states, &npad.dual_states,
+          &npad.left_joy_states, &npad.right_joy_states, &npad.pokeball_states, &npad.libnx}) {
+        WriteSharedMemory(npad_data, npad, states->common);
+        WriteSharedMemory(npad_data, npad, states->npad[states->common.last_entry_index]);
     }
-    std::memcpy(data + NPAD_OFFSET, shared_memory_entries.data(),
-                shared_memory_entries.size() * sizeof(NPadEntry));
 }
 
 void Controller_NPad::SetSupportedStyleSet(NPadType style_set) {
@@ -495,6 +514,7 @@ void Controller_NPad::SetNpadMode(u32 npad_id, NPadAssignments assignment_mode)
     ASSERT(npad_index < shared_memory_entries.size());
     if (shared_memory_entries[npad_index].pad_assignment != assignment_mode) {
         shared_memory_entries[npad_index].pad_assignment = assignment_mode;
+        is_entry_dirty[npad_index] = true;
     }
 }
 
@@ -306,10 +306,15 @@ private:
     NPadControllerType DecideBestController(NPadControllerType priority) const;
     void RequestPadStateUpdate(u32 npad_id);
 
+    /// Copies the changes of an update to the shared memory entry of a npad.
+    void WriteNPadEntry(std::size_t npad_index, u8* data);
+
     u32 press_state{};
 
     NPadType style{};
     std::array<NPadEntry, 10> shared_memory_entries{};
+    /// Set when more than the LIFOs of an entry changed and the whole entry has to be written
+    std::array<bool, 10> is_entry_dirty{};
     std::array<
         std::array<std::unique_ptr<Input::ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID>,
         10>
@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <cstring>
 #include "common/common_types.h"
 #include "core/core_timing.h"
 #include "core/frontend/emu_window.h"
@@ -58,7 +57,8 @@ void Controller_Touchscreen::OnUpdate(const Core::Timing::CoreTiming& core_timin
         cur_entry.entry_count = 0;
     }
 
-    std::memcpy(data + SHARED_MEMORY_OFFSET, &shared_memory, sizeof(TouchScreenSharedMemory));
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, shared_memory.header);
+    WriteSharedMemory(data + SHARED_MEMORY_OFFSET, shared_memory, cur_entry);
 }
 
 void Controller_Touchscreen::OnLoadInputDevices() {
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include "common/common_types.h"
 #include "common/logging/log.h"
@@ -10,6 +11,7 @@
 #include "core/core_timing_util.h"
 #include "core/frontend/emu_window.h"
 #include "core/frontend/input.h"
+#include "core/frontend/input_latency.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/client_session.h"
@@ -35,15 +37,19 @@
 
 namespace Service::HID {
 
-// Updating period for each HID device.
-// TODO(ogniK): Find actual polling rate of hid
-constexpr s64 pad_update_ticks = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 66);
 [[maybe_unused]] constexpr s64 accelerometer_update_ticks =
     static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 100);
 [[maybe_unused]] constexpr s64 gyroscope_update_ticks =
     static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 100);
 constexpr std::size_t SHARED_MEMORY_SIZE = 0x40000;
 
+// Updating period for each HID device, from the configured sampling rate.
+// TODO(ogniK): Find actual polling rate of hid
+static s64 GetPadUpdateTicks() {
+    const u32 rate = std::clamp<u32>(Settings::values.hid_sampling_rate, 15, 1000);
+    return static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / rate);
+}
+
 IAppletResource::IAppletResource(Core::System& system)
     : ServiceFramework("IAppletResource"), system(system) {
     static const FunctionInfo functions[] = {
@@ -84,7 +90,7 @@ IAppletResource::IAppletResource(Core::System& system)
 
     // TODO(shinyquagsire23): Other update callbacks? (accel, gyro?)
 
-    system.CoreTiming().ScheduleEvent(pad_update_ticks, pad_update_event);
+    system.CoreTiming().ScheduleEvent(GetPadUpdateTicks(), pad_update_event);
 
     ReloadInputDevices();
 }
@@ -113,14 +119,16 @@ void IAppletResource::UpdateControllers(u64 userdata, s64 cycles_late) {
     auto& core_timing = system.CoreTiming();
 
     const bool should_reload = Settings::values.is_device_reload_pending.exchange(false);
+    Input::Latency::BeginUpdate();
     for (const auto& controller : controllers) {
         if (should_reload) {
             controller->OnLoadInputDevices();
         }
         controller->OnUpdate(core_timing, shared_mem->GetPointer(), SHARED_MEMORY_SIZE);
     }
+    Input::Latency::EndUpdate();
 
-    core_timing.ScheduleEvent(pad_update_ticks - cycles_late, pad_update_event);
+    core_timing.ScheduleEvent(GetPadUpdateTicks() - cycles_late, pad_update_event);
 }
 
 class IActiveVibrationDeviceList final : public ServiceFramework<IActiveVibrationDeviceList> {
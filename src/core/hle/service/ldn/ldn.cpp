@@ -2,15 +2,32 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
 #include <memory>
+#include <random>
 
+#include <fmt/format.h>
+
+#include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/readable_event.h"
+#include "core/hle/kernel/writable_event.h"
 #include "core/hle/result.h"
 #include "core/hle/service/ldn/ldn.h"
+#include "core/hle/service/ldn/ldn_client.h"
+#include "core/hle/service/ldn/ldn_types.h"
 #include "core/hle/service/sm/sm.h"
+#include "core/settings.h"
 
 namespace Service::LDN {
 
+constexpr ResultCode ERR_ADVERTISE_DATA_TOO_LARGE{ErrorModule::LDN, 10};
+constexpr ResultCode ERR_CONNECTION_FAILED{ErrorModule::LDN, 31};
+constexpr ResultCode ERR_BAD_STATE{ErrorModule::LDN, 32};
+
 class IMonitorService final : public ServiceFramework<IMonitorService> {
 public:
     explicit IMonitorService() : ServiceFramework{"IMonitorService"} {
@@ -98,43 +115,529 @@ public:
 class IUserLocalCommunicationService final
     : public ServiceFramework<IUserLocalCommunicationService> {
 public:
-    explicit IUserLocalCommunicationService() : ServiceFramework{"IUserLocalCommunicationService"} {
+    explicit IUserLocalCommunicationService(Core::System& system_)
+        : ServiceFramework{"IUserLocalCommunicationService"}, system{system_} {
         // clang-format off
         static const FunctionInfo functions[] = {
-            {0, nullptr, "GetState"},
-            {1, nullptr, "GetNetworkInfo"},
-            {2, nullptr, "GetIpv4Address"},
-            {3, nullptr, "GetDisconnectReason"},
-            {4, nullptr, "GetSecurityParameter"},
-            {5, nullptr, "GetNetworkConfig"},
-            {100, nullptr, "AttachStateChangeEvent"},
-            {101, nullptr, "GetNetworkInfoLatestUpdate"},
-            {102, nullptr, "Scan"},
+            {0, &IUserLocalCommunicationService::GetState, "GetState"},
+            {1, &IUserLocalCommunicationService::GetNetworkInfo, "GetNetworkInfo"},
+            {2, &IUserLocalCommunicationService::GetIpv4Address, "GetIpv4Address"},
+            {3, &IUserLocalCommunicationService::GetDisconnectReason, "GetDisconnectReason"},
+            {4, &IUserLocalCommunicationService::GetSecurityParameter, "GetSecurityParameter"},
+            {5, &IUserLocalCommunicationService::GetNetworkConfig, "GetNetworkConfig"},
+            {100, &IUserLocalCommunicationService::AttachStateChangeEvent, "AttachStateChangeEvent"},
+            {101, &IUserLocalCommunicationService::GetNetworkInfoLatestUpdate, "GetNetworkInfoLatestUpdate"},
+            {102, &IUserLocalCommunicationService::Scan, "Scan"},
             {103, nullptr, "ScanPrivate"},
-            {104, nullptr, "SetWirelessControllerRestriction"},
-            {200, nullptr, "OpenAccessPoint"},
-            {201, nullptr, "CloseAccessPoint"},
-            {202, nullptr, "CreateNetwork"},
+            {104, &IUserLocalCommunicationService::SetWirelessControllerRestriction, "SetWirelessControllerRestriction"},
+            {200, &IUserLocalCommunicationService::OpenAccessPoint, "OpenAccessPoint"},
+            {201, &IUserLocalCommunicationService::CloseAccessPoint, "CloseAccessPoint"},
+            {202, &IUserLocalCommunicationService::CreateNetwork, "CreateNetwork"},
             {203, nullptr, "CreateNetworkPrivate"},
-            {204, nullptr, "DestroyNetwork"},
+            {204, &IUserLocalCommunicationService::DestroyNetwork, "DestroyNetwork"},
             {205, nullptr, "Reject"},
-            {206, nullptr, "SetAdvertiseData"},
-            {207, nullptr, "SetStationAcceptPolicy"},
+            {206, &IUserLocalCommunicationService::SetAdvertiseData, "SetAdvertiseData"},
+            {207, &IUserLocalCommunicationService::SetStationAcceptPolicy, "SetStationAcceptPolicy"},
             {208, nullptr, "AddAcceptFilterEntry"},
             {209, nullptr, "ClearAcceptFilter"},
-            {300, nullptr, "OpenStation"},
-            {301, nullptr, "CloseStation"},
-            {302, nullptr, "Connect"},
+            {300, &IUserLocalCommunicationService::OpenStation, "OpenStation"},
+            {301, &IUserLocalCommunicationService::CloseStation, "CloseStation"},
+            {302, &IUserLocalCommunicationService::Connect, "Connect"},
             {303, nullptr, "ConnectPrivate"},
-            {304, nullptr, "Disconnect"},
-            {400, nullptr, "Initialize"},
-            {401, nullptr, "Finalize"},
+            {304, &IUserLocalCommunicationService::Disconnect, "Disconnect"},
+            {400, &IUserLocalCommunicationService::Initialize, "Initialize"},
+            {401, &IUserLocalCommunicationService::Finalize, "Finalize"},
             {402, nullptr, "SetOperationMode"},
         };
         // clang-format on
 
         RegisterHandlers(functions);
+
+        auto& kernel = system.Kernel();
+        state_change_event =
+            Kernel::WritableEvent::CreateEventPair(kernel, "IUserLocalCommunicationService:State");
+
+        // The relay client runs on its own thread, its notifications are handled on the emu thread
+        relay_event = Core::Timing::CreateEvent(
+            "LDN::RelayEvent",
+            [this](u64 userdata, s64) { HandleRelayEvent(static_cast<RelayEvent>(userdata)); });
+    }
+
+    ~IUserLocalCommunicationService() override {
+        relay_client.reset();
+        system.CoreTiming().RemoveEvent(relay_event);
+    }
+
+private:
+    enum class RelayEvent : u64 {
+        StateChanged,
+        ConnectAccepted,
+        ConnectRejected,
+    };
+
+    /// Time given to the host to answer a connection request, in nanoseconds
+    static constexpr u64 CONNECT_TIMEOUT = 3'000'000'000;
+
+    void GetState(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        IPC::ResponseBuilder rb{ctx, 3};
+        rb.Push(RESULT_SUCCESS);
+        rb.PushEnum(state);
+    }
+
+    void GetNetworkInfo(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        const auto info = relay_client ? relay_client->GetNetworkInfo() : std::nullopt;
+        if (!info) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        ctx.WriteBuffer(&*info, sizeof(NetworkInfo));
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void GetIpv4Address(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        if (!relay_client) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        const Ipv4Address address = relay_client->GetLocalAddress();
+
+        IPC::ResponseBuilder rb{ctx, 4};
+        rb.Push(RESULT_SUCCESS);
+        rb.Push<u32>(address[0] << 24 | address[1] << 16 | address[2] << 8 | address[3]);
+        rb.Push<u32>(0xFFFFFF00);
+    }
+
+    void GetDisconnectReason(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        IPC::ResponseBuilder rb{ctx, 3};
+        rb.Push(RESULT_SUCCESS);
+        rb.PushEnum(disconnect_reason);
+    }
+
+    void GetSecurityParameter(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        const auto info = relay_client ? relay_client->GetNetworkInfo() : std::nullopt;
+        if (!info) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        SecurityParameter parameter{};
+        parameter.data = info->ldn.security_parameter;
+        parameter.session_id = info->network_id.session_id;
+
+        IPC::ResponseBuilder rb{ctx, 2 + sizeof(SecurityParameter) / sizeof(u32)};
+        rb.Push(RESULT_SUCCESS);
+        rb.PushRaw(parameter);
+    }
+
+    void GetNetworkConfig(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        const auto info = relay_client ? relay_client->GetNetworkInfo() : std::nullopt;
+        if (!info) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        NetworkConfig config{};
+        config.intent_id = info->network_id.intent_id;
+        config.channel = info->common.channel;
+        config.node_count_max = info->ldn.node_count_max;
+        config.local_communication_version = static_cast<u16>(local_communication_version);
+
+        IPC::ResponseBuilder rb{ctx, 2 + sizeof(NetworkConfig) / sizeof(u32)};
+        rb.Push(RESULT_SUCCESS);
+        rb.PushRaw(config);
+    }
+
+    void AttachStateChangeEvent(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        IPC::ResponseBuilder rb{ctx, 2, 1};
+        rb.Push(RESULT_SUCCESS);
+        rb.PushCopyObjects(state_change_event.readable);
+    }
+
+    void GetNetworkInfoLatestUpdate(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        const auto info = relay_client ? relay_client->GetNetworkInfo() : std::nullopt;
+        if (!info) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        const auto updates = relay_client->TakeNodeUpdates();
+        const std::size_t updates_size =
+            std::min(ctx.GetWriteBufferSize(1), sizeof(NodeLatestUpdate) * updates.size());
+        ctx.WriteBuffer(&*info, sizeof(NetworkInfo), 0);
+        ctx.WriteBuffer(updates.data(), updates_size, 1);
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void Scan(Kernel::HLERequestContext& ctx) {
+        IPC::RequestParser rp{ctx};
+        const auto channel = rp.PopEnum<WifiChannel>();
+        rp.Skip(1, false);
+        const auto filter = rp.PopRaw<ScanFilter>();
+
+        LOG_DEBUG(Service_LDN, "called, channel={}, flag={:08X}", static_cast<s16>(channel),
+                  filter.flag);
+
+        if (!relay_client) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+
+        // The relay answers asynchronously, games scan repeatedly so the next scan returns them
+        std::vector<NetworkInfo> networks = relay_client->Scan();
+        networks.erase(std::remove_if(networks.begin(), networks.end(),
+                                      [&](const NetworkInfo& info) {
+                                          return !MatchesFilter(info, filter);
+                                      }),
+                       networks.end());
+        const std::size_t count =
+            std::min(networks.size(), ctx.GetWriteBufferSize() / sizeof(NetworkInfo));
+        if (count != 0) {
+            ctx.WriteBuffer(networks.data(), count * sizeof(NetworkInfo));
+        }
+
+        IPC::ResponseBuilder rb{ctx, 3};
+        rb.Push(RESULT_SUCCESS);
+        rb.Push<u32>(static_cast<u32>(count));
     }
+
+    void SetWirelessControllerRestriction(Kernel::HLERequestContext& ctx) {
+        LOG_WARNING(Service_LDN, "(STUBBED) called");
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void OpenAccessPoint(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        SetStateIf({State::Initialized, State::AccessPointOpened}, State::AccessPointOpened, ctx);
+    }
+
+    void CloseAccessPoint(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        if (state == State::AccessPointCreated) {
+            relay_client->DestroyNetwork();
+        }
+        SetStateIf({State::AccessPointOpened, State::AccessPointCreated}, State::Initialized, ctx);
+    }
+
+    void CreateNetwork(Kernel::HLERequestContext& ctx) {
+        IPC::RequestParser rp{ctx};
+        const auto config = rp.PopRaw<CreateNetworkConfig>();
+
+        LOG_DEBUG(Service_LDN, "called, local_communication_id={:016X}, node_count_max={}",
+                  config.network_config.intent_id.local_communication_id,
+                  config.network_config.node_count_max);
+
+        if (state != State::AccessPointOpened) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+
+        NetworkInfo info{};
+        info.network_id.intent_id = config.network_config.intent_id;
+        info.network_id.session_id = {random_engine(), random_engine()};
+
+        info.common.bssid = relay_client->GetMacAddress();
+        info.common.ssid.length = static_cast<u8>(SSID_LENGTH_MAX);
+        const std::string ssid = fmt::format("{:016x}{:016x}", info.network_id.session_id.high,
+                                             info.network_id.session_id.low);
+        std::copy_n(ssid.begin(), SSID_LENGTH_MAX, info.common.ssid.raw.begin());
+        info.common.channel = config.network_config.channel == WifiChannel::Default
+                                  ? WifiChannel::Wifi24_6
+                                  : config.network_config.channel;
+        info.common.link_level = LinkLevel::Excellent;
+        info.common.network_type = PackedNetworkType::Ldn;
+
+        auto& ldn = info.ldn;
+        std::generate(ldn.security_parameter.begin(), ldn.security_parameter.end(),
+                      [this] { return static_cast<u8>(random_engine()); });
+        ldn.security_mode = config.security_config.security_mode;
+        ldn.station_accept_policy = accept_policy;
+        ldn.node_count_max = static_cast<u8>(
+            std::clamp<std::size_t>(config.network_config.node_count_max, 1, NODE_COUNT_MAX));
+        ldn.node_count = 1;
+        ldn.nodes[0] = MakeOwnNode(config.user_config);
+        ldn.nodes[0].node_id = 0;
+        ldn.nodes[0].is_connected = 1;
+        ldn.nodes[0].local_communication_version =
+            static_cast<s16>(config.network_config.local_communication_version);
+        ldn.advertise_data_size = static_cast<u16>(advertise_data.size());
+        std::copy(advertise_data.begin(), advertise_data.end(), ldn.advertise_data.begin());
+        ldn.random_authentication_id = random_engine();
+
+        local_communication_version = config.network_config.local_communication_version;
+        relay_client->CreateNetwork(info);
+        state = State::AccessPointCreated;
+        state_change_event.writable->Signal();
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void DestroyNetwork(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        if (state == State::AccessPointCreated) {
+            relay_client->DestroyNetwork();
+        }
+        SetStateIf({State::AccessPointCreated}, State::AccessPointOpened, ctx);
+    }
+
+    void SetAdvertiseData(Kernel::HLERequestContext& ctx) {
+        const std::vector<u8> data = ctx.ReadBuffer();
+
+        LOG_DEBUG(Service_LDN, "called, size={}", data.size());
+
+        if (data.size() > ADVERTISE_DATA_SIZE_MAX) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_ADVERTISE_DATA_TOO_LARGE);
+            return;
+        }
+        advertise_data = data;
+        if (relay_client) {
+            relay_client->SetAdvertiseData(advertise_data);
+        }
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void SetStationAcceptPolicy(Kernel::HLERequestContext& ctx) {
+        IPC::RequestParser rp{ctx};
+        accept_policy = rp.PopEnum<AcceptPolicy>();
+
+        LOG_DEBUG(Service_LDN, "called, policy={}", static_cast<u8>(accept_policy));
+
+        if (relay_client) {
+            relay_client->SetAcceptPolicy(accept_policy);
+        }
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void OpenStation(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        SetStateIf({State::Initialized, State::StationOpened}, State::StationOpened, ctx);
+    }
+
+    void CloseStation(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        if (state == State::StationConnected) {
+            relay_client->Disconnect();
+        }
+        SetStateIf({State::StationOpened, State::StationConnected}, State::Initialized, ctx);
+    }
+
+    void Connect(Kernel::HLERequestContext& ctx) {
+        IPC::RequestParser rp{ctx};
+        const auto data = rp.PopRaw<ConnectNetworkData>();
+        const std::vector<u8> info_buffer = ctx.ReadBuffer();
+
+        LOG_DEBUG(Service_LDN, "called, local_communication_version={}",
+                  data.local_communication_version);
+
+        if (state != State::StationOpened || info_buffer.size() != sizeof(NetworkInfo)) {
+            IPC::ResponseBuilder rb{ctx, 2};
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        NetworkInfo info;
+        std::memcpy(&info, info_buffer.data(), sizeof(NetworkInfo));
+
+        NodeInfo node = MakeOwnNode(data.user_config);
+        node.local_communication_version = static_cast<s16>(data.local_communication_version);
+        local_communication_version = data.local_communication_version;
+        connect_accepted = false;
+        relay_client->Connect(info, node);
+
+        // The guest thread waits for the answer of the host while the emulation keeps running
+        connect_event =
+            Kernel::WritableEvent::CreateEventPair(system.Kernel(), "LDN::Connect").writable;
+        ctx.SleepClientThread(
+            "LDN::Connect", CONNECT_TIMEOUT,
+            [this](std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                   Kernel::ThreadWakeupReason reason) {
+                connect_event.reset();
+                IPC::ResponseBuilder rb{ctx, 2};
+                if (!connect_accepted || state != State::StationOpened) {
+                    LOG_WARNING(Service_LDN, "Failed to connect to the network");
+                    if (relay_client) {
+                        relay_client->Disconnect();
+                    }
+                    rb.Push(ERR_CONNECTION_FAILED);
+                    return;
+                }
+                state = State::StationConnected;
+                disconnect_reason = DisconnectReason::None;
+                state_change_event.writable->Signal();
+                rb.Push(RESULT_SUCCESS);
+            },
+            connect_event);
+    }
+
+    void Disconnect(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        if (state == State::StationConnected) {
+            relay_client->Disconnect();
+            disconnect_reason = DisconnectReason::DisconnectedByUser;
+        }
+        SetStateIf({State::StationConnected}, State::StationOpened, ctx);
+    }
+
+    void Initialize(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called, relay={}:{}", Settings::values.ldn_relay_address,
+                  Settings::values.ldn_relay_port);
+
+        if (!relay_client) {
+            RelayClient::Callbacks callbacks;
+            callbacks.state_changed = [this] {
+                system.CoreTiming().ScheduleEventThreadsafe(
+                    0, relay_event, static_cast<u64>(RelayEvent::StateChanged));
+            };
+            callbacks.connect_result = [this](bool accepted) {
+                const RelayEvent event =
+                    accepted ? RelayEvent::ConnectAccepted : RelayEvent::ConnectRejected;
+                system.CoreTiming().ScheduleEventThreadsafe(0, relay_event,
+                                                            static_cast<u64>(event));
+            };
+            relay_client = std::make_unique<RelayClient>(Settings::values.ldn_relay_address,
+                                                         Settings::values.ldn_relay_port,
+                                                         std::move(callbacks));
+        }
+        state = State::Initialized;
+        disconnect_reason = DisconnectReason::None;
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void Finalize(Kernel::HLERequestContext& ctx) {
+        LOG_DEBUG(Service_LDN, "called");
+
+        relay_client.reset();
+        state = State::None;
+
+        IPC::ResponseBuilder rb{ctx, 2};
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    void HandleRelayEvent(RelayEvent event) {
+        switch (event) {
+        case RelayEvent::StateChanged:
+            if (state == State::StationConnected && relay_client &&
+                relay_client->TakeConnectionLost()) {
+                state = State::StationOpened;
+                disconnect_reason = DisconnectReason::DestroyedByUser;
+            }
+            state_change_event.writable->Signal();
+            break;
+        case RelayEvent::ConnectAccepted:
+        case RelayEvent::ConnectRejected:
+            connect_accepted = event == RelayEvent::ConnectAccepted;
+            if (connect_event) {
+                connect_event->Signal();
+            }
+            break;
+        }
+    }
+
+    /// Moves to new_state when in one of the allowed states, and answers the request
+    void SetStateIf(std::initializer_list<State> allowed, State new_state,
+                    Kernel::HLERequestContext& ctx) {
+        IPC::ResponseBuilder rb{ctx, 2};
+        if (std::find(allowed.begin(), allowed.end(), state) == allowed.end()) {
+            LOG_ERROR(Service_LDN, "Invalid state {}", static_cast<u32>(state));
+            rb.Push(ERR_BAD_STATE);
+            return;
+        }
+        if (state != new_state) {
+            state = new_state;
+            state_change_event.writable->Signal();
+        }
+        rb.Push(RESULT_SUCCESS);
+    }
+
+    NodeInfo MakeOwnNode(const UserConfig& user_config) const {
+        NodeInfo node{};
+        node.ipv4_address = relay_client->GetLocalAddress();
+        node.mac_address = relay_client->GetMacAddress();
+        node.user_name = user_config.user_name;
+        return node;
+    }
+
+    static bool MatchesFilter(const NetworkInfo& info, const ScanFilter& filter) {
+        const IntentId& intent_id = info.network_id.intent_id;
+        const IntentId& wanted_intent_id = filter.network_id.intent_id;
+        if ((filter.flag & ScanFilterFlag::LocalCommunicationId) != 0 &&
+            intent_id.local_communication_id != wanted_intent_id.local_communication_id) {
+            return false;
+        }
+        if ((filter.flag & ScanFilterFlag::SceneId) != 0 &&
+            intent_id.scene_id != wanted_intent_id.scene_id) {
+            return false;
+        }
+        if ((filter.flag & ScanFilterFlag::SessionId) != 0 &&
+            (info.network_id.session_id.high != filter.network_id.session_id.high ||
+             info.network_id.session_id.low != filter.network_id.session_id.low)) {
+            return false;
+        }
+        if ((filter.flag & ScanFilterFlag::NetworkType) != 0 &&
+            filter.network_type != NetworkType::All &&
+            static_cast<u32>(info.common.network_type) != static_cast<u32>(filter.network_type)) {
+            return false;
+        }
+        if ((filter.flag & ScanFilterFlag::Ssid) != 0 &&
+            (info.common.ssid.length != filter.ssid.length ||
+             std::memcmp(info.common.ssid.raw.data(), filter.ssid.raw.data(),
+                         filter.ssid.length) != 0)) {
+            return false;
+        }
+        return true;
+    }
+
+    Core::System& system;
+    std::shared_ptr<Core::Timing::EventType> relay_event;
+    std::unique_ptr<RelayClient> relay_client;
+    Kernel::EventPair state_change_event;
+    std::shared_ptr<Kernel::WritableEvent> connect_event;
+    std::mt19937_64 random_engine{std::random_device{}()};
+
+    State state = State::None;
+    DisconnectReason disconnect_reason = DisconnectReason::None;
+    AcceptPolicy accept_policy = AcceptPolicy::AcceptAll;
+    std::vector<u8> advertise_data;
+    s32 local_communication_version = 0;
+    bool connect_accepted = false;
 };
 
 class LDNS final : public ServiceFramework<LDNS> {
@@ -160,7 +663,7 @@ public:
 
 class LDNU final : public ServiceFramework<LDNU> {
 public:
-    explicit LDNU() : ServiceFramework{"ldn:u"} {
+    explicit LDNU(Core::System& system_) : ServiceFramework{"ldn:u"}, system{system_} {
         // clang-format off
         static const FunctionInfo functions[] = {
             {0, &LDNU::CreateUserLocalCommunicationService, "CreateUserLocalCommunicationService"},
@@ -175,14 +678,17 @@ public:
 
         IPC::ResponseBuilder rb{ctx, 2, 0, 1};
         rb.Push(RESULT_SUCCESS);
-        rb.PushIpcInterface<IUserLocalCommunicationService>();
+        rb.PushIpcInterface<IUserLocalCommunicationService>(system);
     }
+
+private:
+    Core::System& system;
 };
 
-void InstallInterfaces(SM::ServiceManager& sm) {
+void InstallInterfaces(SM::ServiceManager& sm, Core::System& system) {
     std::make_shared<LDNM>()->InstallAsService(sm);
     std::make_shared<LDNS>()->InstallAsService(sm);
-    std::make_shared<LDNU>()->InstallAsService(sm);
+    std::make_shared<LDNU>(system)->InstallAsService(sm);
 }
 
 } // namespace Service::LDN
@@ -0,0 +1,510 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <boost/asio.hpp>
+
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/hle/service/ldn/ldn_client.h"
+#include "core/hle/service/ldn/ldn_protocol.h"
+
+using boost::asio::ip::udp;
+
+namespace Service::LDN {
+
+namespace {
+
+/// Scan results older than this are dropped, in seconds
+constexpr int SCAN_RESULT_LIFETIME = 3;
+
+bool operator==(const SessionId& lhs, const SessionId& rhs) {
+    return lhs.high == rhs.high && lhs.low == rhs.low;
+}
+
+} // Anonymous namespace
+
+/**
+ * Socket connected to the relay. Every packet is sent and received on the network thread, from
+ * buffers that are allocated once, so the packets never hit the heap.
+ */
+class RelaySocket {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit RelaySocket(RelayClient& client, const std::string& host, u16 port)
+        : client{client}, timer(io_service), socket(io_service, udp::endpoint(udp::v4(), 0)) {
+        boost::system::error_code error;
+        auto address = boost::asio::ip::make_address_v4(host, error);
+        if (error) {
+            LOG_ERROR(Service_LDN, "Invalid relay address {}, using the loopback address", host);
+            address = boost::asio::ip::address_v4::loopback();
+        }
+        relay_endpoint = udp::endpoint(address, port);
+
+        // Connecting a datagram socket picks the local address the other nodes can reach
+        socket.connect(relay_endpoint, error);
+        if (error) {
+            LOG_ERROR(Service_LDN, "Failed to reach the relay at {}:{}: {}", host, port,
+                      error.message());
+        }
+    }
+
+    void Loop() {
+        StartReceive();
+        StartTick(clock::now());
+        io_service.run();
+    }
+
+    /// Stops the network thread once the packets posted before have been sent
+    void Stop() {
+        boost::asio::post(io_service, [this] { io_service.stop(); });
+    }
+
+    Ipv4Address GetLocalAddress() const {
+        boost::system::error_code error;
+        const auto endpoint = socket.local_endpoint(error);
+        if (error || endpoint.address().is_unspecified()) {
+            return {127, 0, 0, 1};
+        }
+        return endpoint.address().to_v4().to_bytes();
+    }
+
+    /// Sends a packet from any thread
+    template <typename... Payload>
+    void Post(Protocol::PacketType type, const Payload&... payload) {
+        boost::asio::post(io_service, [this, type, payload...] { Send(type, payload...); });
+    }
+
+    /// Sends a packet from the network thread
+    template <typename... Payload>
+    void Send(Protocol::PacketType type, const Payload&... payload) {
+        const std::size_t size = Protocol::Write(send_buffer.data(), type, payload...);
+        boost::system::error_code error;
+        socket.send(boost::asio::buffer(send_buffer.data(), size), 0, error);
+        if (error) {
+            LOG_DEBUG(Service_LDN, "Failed to send a packet to the relay: {}", error.message());
+        }
+    }
+
+private:
+    void StartReceive() {
+        socket.async_receive(
+            boost::asio::buffer(receive_buffer),
+            [this](const boost::system::error_code& error, std::size_t bytes_transferred) {
+                HandleReceive(error, bytes_transferred);
+            });
+    }
+
+    void StartTick(const clock::time_point& from) {
+        timer.expires_at(from + std::chrono::seconds(Protocol::KEEP_ALIVE_INTERVAL));
+        timer.async_wait([this](const boost::system::error_code& error) {
+            if (error) {
+                return;
+            }
+            client.HandleTick();
+            StartTick(timer.expiry());
+        });
+    }
+
+    void HandleReceive(const boost::system::error_code& error, std::size_t size) {
+        if (error == boost::asio::error::operation_aborted) {
+            return;
+        }
+        // Errors like an unreachable relay are reported on the next receive, keep listening
+        if (!error) {
+            Dispatch(size);
+        }
+        StartReceive();
+    }
+
+    void Dispatch(std::size_t size) {
+        using Protocol::PacketType;
+        using Protocol::Read;
+
+        const u8* const data = receive_buffer.data();
+        const auto type = Protocol::Validate(data, size);
+        if (!type) {
+            return;
+        }
+        switch (*type) {
+        case PacketType::Advertise:
+            if (const auto info = Read<NetworkInfo>(data, size)) {
+                client.HandleAdvertise(*info);
+            }
+            break;
+        case PacketType::Withdraw:
+            if (const auto session_id = Read<SessionId>(data, size)) {
+                client.HandleWithdraw(*session_id);
+            }
+            break;
+        case PacketType::ScanResult:
+            if (const auto info = Read<NetworkInfo>(data, size)) {
+                client.HandleScanResult(*info);
+            }
+            break;
+        case PacketType::Connect:
+            if (const auto request = Read<Protocol::ConnectRequest>(data, size)) {
+                client.HandleConnect(*request);
+            }
+            break;
+        case PacketType::ConnectResult:
+            if (const auto result = Read<Protocol::ConnectResult>(data, size)) {
+                client.HandleConnectResult(*result);
+            }
+            break;
+        case PacketType::Disconnect:
+            if (const auto request = Read<Protocol::DisconnectRequest>(data, size)) {
+                client.HandleDisconnect(*request);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    RelayClient& client;
+    boost::asio::io_service io_service;
+    boost::asio::basic_waitable_timer<clock> timer;
+    udp::socket socket;
+    udp::endpoint relay_endpoint;
+
+    std::array<u8, Protocol::MAX_PACKET_SIZE> send_buffer;
+    std::array<u8, Protocol::MAX_PACKET_SIZE> receive_buffer;
+};
+
+RelayClient::RelayClient(const std::string& host, u16 port, Callbacks callbacks)
+    : callbacks{std::move(callbacks)}, socket{std::make_unique<RelaySocket>(*this, host, port)} {
+    // A random locally administered address, the nodes only use it to tell each other apart
+    std::random_device device;
+    std::uniform_int_distribution<u32> distribution{0, 0xFF};
+    std::generate(mac_address.begin(), mac_address.end(),
+                  [&] { return static_cast<u8>(distribution(device)); });
+    mac_address[0] = static_cast<u8>((mac_address[0] & 0xFC) | 0x02);
+
+    thread = std::thread([this] {
+        Common::SetCurrentThreadName("yuzu:LDNRelay");
+        socket->Loop();
+    });
+}
+
+RelayClient::~RelayClient() {
+    // Let the other nodes know right away instead of waiting for the relay to time out
+    DestroyNetwork();
+    Disconnect();
+    socket->Stop();
+    thread.join();
+}
+
+Ipv4Address RelayClient::GetLocalAddress() const {
+    return socket->GetLocalAddress();
+}
+
+MacAddress RelayClient::GetMacAddress() const {
+    return mac_address;
+}
+
+void RelayClient::CreateNetwork(const NetworkInfo& info) {
+    std::lock_guard lock{mutex};
+    role = Role::Host;
+    network_info = info;
+    station_ids = {};
+    node_updates = {};
+    socket->Post(Protocol::PacketType::Advertise, network_info);
+}
+
+void RelayClient::DestroyNetwork() {
+    std::lock_guard lock{mutex};
+    if (role != Role::Host) {
+        return;
+    }
+    role = Role::None;
+    socket->Post(Protocol::PacketType::Withdraw, network_info.network_id.session_id);
+}
+
+void RelayClient::SetAdvertiseData(const std::vector<u8>& data) {
+    std::lock_guard lock{mutex};
+    const std::size_t size = std::min(data.size(), ADVERTISE_DATA_SIZE_MAX);
+    network_info.ldn.advertise_data = {};
+    std::copy_n(data.begin(), size, network_info.ldn.advertise_data.begin());
+    network_info.ldn.advertise_data_size = static_cast<u16>(size);
+    if (role == Role::Host) {
+        socket->Post(Protocol::PacketType::Advertise, network_info);
+    }
+}
+
+void RelayClient::SetAcceptPolicy(AcceptPolicy policy) {
+    std::lock_guard lock{mutex};
+    network_info.ldn.station_accept_policy = policy;
+    if (role == Role::Host) {
+        socket->Post(Protocol::PacketType::Advertise, network_info);
+    }
+}
+
+std::vector<NetworkInfo> RelayClient::Scan() {
+    socket->Post(Protocol::PacketType::Scan);
+
+    std::lock_guard lock{mutex};
+    const auto expiry = std::chrono::steady_clock::now() -
+                        std::chrono::seconds(SCAN_RESULT_LIFETIME);
+    scan_results.erase(std::remove_if(scan_results.begin(), scan_results.end(),
+                                      [&](const ScanEntry& entry) {
+                                          return entry.last_seen < expiry;
+                                      }),
+                       scan_results.end());
+
+    std::vector<NetworkInfo> networks;
+    networks.reserve(scan_results.size());
+    for (const ScanEntry& entry : scan_results) {
+        networks.push_back(entry.info);
+    }
+    return networks;
+}
+
+void RelayClient::Connect(const NetworkInfo& info, const NodeInfo& node) {
+    std::lock_guard lock{mutex};
+    role = Role::Connecting;
+    network_info = info;
+    own_node = node;
+    node_updates = {};
+    connection_lost = false;
+
+    Protocol::ConnectRequest request{};
+    request.session_id = info.network_id.session_id;
+    request.node = node;
+    socket->Post(Protocol::PacketType::Connect, request);
+}
+
+void RelayClient::Disconnect() {
+    std::lock_guard lock{mutex};
+    if (role != Role::Station && role != Role::Connecting) {
+        return;
+    }
+    role = Role::None;
+
+    Protocol::DisconnectRequest request{};
+    request.session_id = network_info.network_id.session_id;
+    socket->Post(Protocol::PacketType::Disconnect, request);
+}
+
+std::optional<NetworkInfo> RelayClient::GetNetworkInfo() const {
+    std::lock_guard lock{mutex};
+    if (role != Role::Host && role != Role::Station) {
+        return std::nullopt;
+    }
+    return network_info;
+}
+
+std::array<NodeLatestUpdate, NODE_COUNT_MAX> RelayClient::TakeNodeUpdates() {
+    std::lock_guard lock{mutex};
+    return std::exchange(node_updates, {});
+}
+
+bool RelayClient::TakeConnectionLost() {
+    std::lock_guard lock{mutex};
+    return std::exchange(connection_lost, false);
+}
+
+void RelayClient::HandleAdvertise(const NetworkInfo& info) {
+    {
+        std::lock_guard lock{mutex};
+        if (role != Role::Station || !(info.network_id.session_id == CurrentSessionId())) {
+            return;
+        }
+        UpdateNodes(info);
+        network_info = info;
+    }
+    callbacks.state_changed();
+}
+
+void RelayClient::HandleWithdraw(const SessionId& session_id) {
+    bool was_connecting;
+    {
+        std::lock_guard lock{mutex};
+        scan_results.erase(std::remove_if(scan_results.begin(), scan_results.end(),
+                                          [&](const ScanEntry& entry) {
+                                              return entry.info.network_id.session_id ==
+                                                     session_id;
+                                          }),
+                           scan_results.end());
+        if ((role != Role::Station && role != Role::Connecting) ||
+            !(session_id == CurrentSessionId())) {
+            return;
+        }
+        was_connecting = role == Role::Connecting;
+        role = Role::None;
+        connection_lost = !was_connecting;
+    }
+    if (was_connecting) {
+        callbacks.connect_result(false);
+    } else {
+        callbacks.state_changed();
+    }
+}
+
+void RelayClient::HandleScanResult(const NetworkInfo& info) {
+    std::lock_guard lock{mutex};
+    const auto now = std::chrono::steady_clock::now();
+    const auto it = std::find_if(scan_results.begin(), scan_results.end(),
+                                 [&](const ScanEntry& entry) {
+                                     return entry.info.network_id.session_id ==
+                                            info.network_id.session_id;
+                                 });
+    if (it != scan_results.end()) {
+        *it = {info, now};
+    } else {
+        scan_results.push_back({info, now});
+    }
+}
+
+void RelayClient::HandleConnect(const Protocol::ConnectRequest& request) {
+    Protocol::ConnectResult result{};
+    result.session_id = request.session_id;
+    result.station_id = request.station_id;
+    result.node_id = -1;
+
+    NetworkInfo info;
+    {
+        std::lock_guard lock{mutex};
+        if (role != Role::Host || !(request.session_id == CurrentSessionId())) {
+            return;
+        }
+        auto& ldn = network_info.ldn;
+
+        // A retransmitted request gets the node it was given before
+        const auto known = std::find(station_ids.begin(), station_ids.end(), request.station_id);
+        if (known != station_ids.end() && ldn.nodes[known - station_ids.begin()].is_connected) {
+            result.accepted = 1;
+            result.node_id = static_cast<s8>(known - station_ids.begin());
+        } else if (ldn.station_accept_policy != AcceptPolicy::RejectAll &&
+                   ldn.node_count < ldn.node_count_max) {
+            // The host is always node 0
+            for (std::size_t i = 1; i < std::min<std::size_t>(ldn.node_count_max, NODE_COUNT_MAX);
+                 ++i) {
+                if (ldn.nodes[i].is_connected) {
+                    continue;
+                }
+                ldn.nodes[i] = request.node;
+                ldn.nodes[i].node_id = static_cast<s8>(i);
+                ldn.nodes[i].is_connected = 1;
+                ++ldn.node_count;
+                station_ids[i] = request.station_id;
+                node_updates[i].state_change = NodeStateChange::Connect;
+                result.accepted = 1;
+                result.node_id = static_cast<s8>(i);
+                break;
+            }
+        }
+        info = network_info;
+    }
+
+    // Runs on the network thread, the answer doesn't wait for the emulated CPU
+    socket->Send(Protocol::PacketType::ConnectResult, result);
+    if (result.accepted) {
+        socket->Send(Protocol::PacketType::Advertise, info);
+        callbacks.state_changed();
+    }
+}
+
+void RelayClient::HandleConnectResult(const Protocol::ConnectResult& result) {
+    {
+        std::lock_guard lock{mutex};
+        if (role != Role::Connecting || !(result.session_id == CurrentSessionId())) {
+            return;
+        }
+        if (result.accepted && result.node_id >= 0 &&
+            static_cast<std::size_t>(result.node_id) < NODE_COUNT_MAX) {
+            role = Role::Station;
+            // Until the host advertises the updated network
+            NodeInfo& node = network_info.ldn.nodes[result.node_id];
+            if (!node.is_connected) {
+                ++network_info.ldn.node_count;
+            }
+            node = own_node;
+            node.node_id = result.node_id;
+            node.is_connected = 1;
+        } else {
+            role = Role::None;
+        }
+    }
+    callbacks.connect_result(result.accepted != 0);
+}
+
+void RelayClient::HandleDisconnect(const Protocol::DisconnectRequest& request) {
+    NetworkInfo info;
+    {
+        std::lock_guard lock{mutex};
+        if (role != Role::Host || !(request.session_id == CurrentSessionId())) {
+            return;
+        }
+        auto& ldn = network_info.ldn;
+        const auto it = std::find(station_ids.begin() + 1, station_ids.end(), request.station_id);
+        const std::size_t index = it - station_ids.begin();
+        if (it == station_ids.end() || !ldn.nodes[index].is_connected) {
+            return;
+        }
+        ldn.nodes[index] = {};
+        --ldn.node_count;
+        *it = 0;
+        const NodeStateChange previous = node_updates[index].state_change;
+        node_updates[index].state_change = previous == NodeStateChange::Connect
+                                               ? NodeStateChange::DisconnectAndConnect
+                                               : NodeStateChange::Disconnect;
+        info = network_info;
+    }
+    socket->Send(Protocol::PacketType::Advertise, info);
+    callbacks.state_changed();
+}
+
+void RelayClient::HandleTick() {
+    std::unique_lock lock{mutex};
+    switch (role) {
+    case Role::Host: {
+        // Refreshes the network on the relay, which forgets it when the host goes silent
+        const NetworkInfo info = network_info;
+        lock.unlock();
+        socket->Send(Protocol::PacketType::Advertise, info);
+        break;
+    }
+    case Role::Connecting:
+    case Role::Station:
+        lock.unlock();
+        socket->Send(Protocol::PacketType::KeepAlive);
+        break;
+    case Role::None:
+        break;
+    }
+}
+
+SessionId RelayClient::CurrentSessionId() const {
+    return network_info.network_id.session_id;
+}
+
+void RelayClient::UpdateNodes(const NetworkInfo& info) {
+    for (std::size_t i = 0; i < NODE_COUNT_MAX; ++i) {
+        const NodeInfo& old_node = network_info.ldn.nodes[i];
+        const NodeInfo& new_node = info.ldn.nodes[i];
+        NodeStateChange change = NodeStateChange::None;
+        if (old_node.is_connected && !new_node.is_connected) {
+            change = NodeStateChange::Disconnect;
+        } else if (!old_node.is_connected && new_node.is_connected) {
+            change = NodeStateChange::Connect;
+        } else if (old_node.is_connected && old_node.mac_address != new_node.mac_address) {
+            change = NodeStateChange::DisconnectAndConnect;
+        }
+        if (change == NodeStateChange::None) {
+            continue;
+        }
+
+        NodeStateChange& update = node_updates[i].state_change;
+        if (update != NodeStateChange::None && update != change) {
+            update = NodeStateChange::DisconnectAndConnect;
+        } else {
+            update = change;
+        }
+    }
+}
+
+} // namespace Service::LDN
@@ -0,0 +1,118 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/hle/service/ldn/ldn_types.h"
+
+namespace Service::LDN {
+
+namespace Protocol {
+struct ConnectRequest;
+struct ConnectResult;
+struct DisconnectRequest;
+} // namespace Protocol
+
+class RelaySocket;
+
+/**
+ * Node of an emulated local wireless network, talking to the LDN relay over UDP. The packets are
+ * handled on a dedicated network thread, which also answers the connection requests of the
+ * stations when hosting, so that joining a network doesn't wait for the emulated CPU.
+ * The callbacks are invoked on the network thread.
+ */
+class RelayClient {
+public:
+    struct Callbacks {
+        /// The nodes of the network changed, it was joined or it was lost
+        std::function<void()> state_changed;
+        /// The host answered a connection request
+        std::function<void(bool accepted)> connect_result;
+    };
+
+    explicit RelayClient(const std::string& host, u16 port, Callbacks callbacks);
+    ~RelayClient();
+
+    /// Address of this node, as seen by the other nodes
+    Ipv4Address GetLocalAddress() const;
+    MacAddress GetMacAddress() const;
+
+    /// Hosts a network and starts advertising it
+    void CreateNetwork(const NetworkInfo& info);
+    void DestroyNetwork();
+    void SetAdvertiseData(const std::vector<u8>& data);
+    void SetAcceptPolicy(AcceptPolicy policy);
+
+    /// Returns the networks seen recently and asks the relay for a fresh list
+    std::vector<NetworkInfo> Scan();
+
+    /// Asks the host of the network to join it, the answer is given through connect_result
+    void Connect(const NetworkInfo& info, const NodeInfo& node);
+    void Disconnect();
+
+    /// Returns the joined or hosted network, if any
+    std::optional<NetworkInfo> GetNetworkInfo() const;
+
+    /// Returns the changes of the nodes since the last call, and clears them
+    std::array<NodeLatestUpdate, NODE_COUNT_MAX> TakeNodeUpdates();
+
+    /// Returns true when the connection to the network was lost since the last call
+    bool TakeConnectionLost();
+
+private:
+    friend class RelaySocket;
+
+    struct ScanEntry {
+        NetworkInfo info;
+        std::chrono::steady_clock::time_point last_seen;
+    };
+
+    enum class Role {
+        None,
+        Host,
+        Connecting,
+        Station,
+    };
+
+    void HandleAdvertise(const NetworkInfo& info);
+    void HandleWithdraw(const SessionId& session_id);
+    void HandleScanResult(const NetworkInfo& info);
+    void HandleConnect(const Protocol::ConnectRequest& request);
+    void HandleConnectResult(const Protocol::ConnectResult& result);
+    void HandleDisconnect(const Protocol::DisconnectRequest& request);
+    void HandleTick();
+
+    /// Session of the joined or hosted network, with the mutex held
+    SessionId CurrentSessionId() const;
+
+    /// Records the node changes between two versions of the joined network, with the mutex held
+    void UpdateNodes(const NetworkInfo& info);
+
+    Callbacks callbacks;
+    std::unique_ptr<RelaySocket> socket;
+    std::thread thread;
+
+    mutable std::mutex mutex;
+    Role role = Role::None;
+    NetworkInfo network_info{};
+    std::array<u32, NODE_COUNT_MAX> station_ids{};
+    std::array<NodeLatestUpdate, NODE_COUNT_MAX> node_updates{};
+    std::vector<ScanEntry> scan_results;
+    NodeInfo own_node{};
+    bool connection_lost = false;
+    MacAddress mac_address{};
+};
+
+} // namespace Service::LDN
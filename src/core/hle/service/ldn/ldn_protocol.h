@@ -0,0 +1,122 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+#include "common/common_types.h"
+#include "common/swap.h"
+#include "core/hle/service/ldn/ldn_types.h"
+
+/**
+ * Packets exchanged between the emulated nodes and the LDN relay. The relay only routes the
+ * session management: it keeps track of the advertised networks, answers scans and forwards the
+ * connection requests to the hosts. The traffic of the games goes over the sockets of the host.
+ */
+namespace Service::LDN::Protocol {
+
+constexpr u32 PACKET_MAGIC = 0x4E444C59; // YLDN
+constexpr u8 PROTOCOL_VERSION = 1;
+
+enum class PacketType : u8 {
+    Advertise,     ///< Host to relay to members: NetworkInfo
+    Withdraw,      ///< Host to relay to members: SessionId
+    Scan,          ///< Station to relay, no payload
+    ScanResult,    ///< Relay to station: NetworkInfo
+    Connect,       ///< Station to relay to host: ConnectRequest
+    ConnectResult, ///< Host to relay to station: ConnectResult
+    Disconnect,    ///< Station to relay to host: DisconnectRequest
+    KeepAlive,     ///< Any node to relay, no payload
+};
+
+struct PacketHeader {
+    u32_le magic;
+    u8 version;
+    PacketType type;
+    u16_le payload_size;
+};
+static_assert(sizeof(PacketHeader) == 8, "PacketHeader is an invalid size");
+
+struct ConnectRequest {
+    SessionId session_id;
+    u32_le station_id; ///< Filled in by the relay
+    INSERT_PADDING_BYTES(4);
+    NodeInfo node;
+};
+static_assert(std::is_trivially_copyable_v<ConnectRequest>,
+              "ConnectRequest is not trivially copyable");
+
+struct ConnectResult {
+    SessionId session_id;
+    u32_le station_id;
+    u8 accepted;
+    s8 node_id;
+    INSERT_PADDING_BYTES(2);
+};
+static_assert(std::is_trivially_copyable_v<ConnectResult>,
+              "ConnectResult is not trivially copyable");
+
+struct DisconnectRequest {
+    SessionId session_id;
+    u32_le station_id; ///< Filled in by the relay
+    INSERT_PADDING_BYTES(4);
+};
+static_assert(std::is_trivially_copyable_v<DisconnectRequest>,
+              "DisconnectRequest is not trivially copyable");
+
+constexpr std::size_t MAX_PACKET_SIZE = sizeof(PacketHeader) + sizeof(NetworkInfo);
+static_assert(sizeof(ConnectRequest) <= sizeof(NetworkInfo), "MAX_PACKET_SIZE is too small");
+
+/// Seconds after which the relay forgets a node it hasn't heard from
+constexpr int PEER_TIMEOUT = 5;
+/// Seconds between two keep alives or advertisements of a node
+constexpr int KEEP_ALIVE_INTERVAL = 1;
+
+/// Writes a packet into buffer, which must hold MAX_PACKET_SIZE bytes. Returns the packet size.
+template <typename T>
+std::size_t Write(u8* buffer, PacketType type, const T& payload) {
+    static_assert(std::is_trivially_copyable_v<T>, "Payload is not trivially copyable");
+    static_assert(sizeof(T) + sizeof(PacketHeader) <= MAX_PACKET_SIZE, "Payload is too large");
+    const PacketHeader header{PACKET_MAGIC, PROTOCOL_VERSION, type, sizeof(T)};
+    std::memcpy(buffer, &header, sizeof(header));
+    std::memcpy(buffer + sizeof(header), &payload, sizeof(T));
+    return sizeof(header) + sizeof(T);
+}
+
+inline std::size_t Write(u8* buffer, PacketType type) {
+    const PacketHeader header{PACKET_MAGIC, PROTOCOL_VERSION, type, 0};
+    std::memcpy(buffer, &header, sizeof(header));
+    return sizeof(header);
+}
+
+/// Returns the type of a received packet, if it is a valid one
+inline std::optional<PacketType> Validate(const u8* data, std::size_t size) {
+    if (size < sizeof(PacketHeader)) {
+        return std::nullopt;
+    }
+    PacketHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != PACKET_MAGIC || header.version != PROTOCOL_VERSION ||
+        header.payload_size != size - sizeof(PacketHeader)) {
+        return std::nullopt;
+    }
+    return header.type;
+}
+
+/// Reads the payload of a validated packet, if it has the size of T
+template <typename T>
+std::optional<T> Read(const u8* data, std::size_t size) {
+    static_assert(std::is_trivially_copyable_v<T>, "Payload is not trivially copyable");
+    if (size != sizeof(PacketHeader) + sizeof(T)) {
+        return std::nullopt;
+    }
+    T payload;
+    std::memcpy(&payload, data + sizeof(PacketHeader), sizeof(T));
+    return payload;
+}
+
+} // namespace Service::LDN::Protocol
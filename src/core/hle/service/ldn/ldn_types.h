@@ -0,0 +1,236 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace Service::LDN {
+
+constexpr std::size_t SSID_LENGTH_MAX = 32;
+constexpr std::size_t ADVERTISE_DATA_SIZE_MAX = 384;
+constexpr std::size_t USER_NAME_BYTES_MAX = 32;
+constexpr std::size_t NODE_COUNT_MAX = 8;
+constexpr std::size_t PASSPHRASE_LENGTH_MAX = 64;
+
+enum class State : u32 {
+    None,
+    Initialized,
+    AccessPointOpened,
+    AccessPointCreated,
+    StationOpened,
+    StationConnected,
+    Error,
+};
+
+enum class DisconnectReason : s16 {
+    Unknown = -1,
+    None,
+    DisconnectedByUser,
+    DisconnectedBySystem,
+    DestroyedByUser,
+    DestroyedBySystem,
+    Rejected,
+    SignalLost,
+};
+
+enum class AcceptPolicy : u8 {
+    AcceptAll,
+    RejectAll,
+    BlackList,
+    WhiteList,
+};
+
+enum class WifiChannel : s16 {
+    Default = 0,
+    Wifi24_1 = 1,
+    Wifi24_6 = 6,
+    Wifi24_11 = 11,
+};
+
+enum class LinkLevel : s8 {
+    Bad,
+    Low,
+    Good,
+    Excellent,
+};
+
+enum class NodeStateChange : u8 {
+    None,
+    Connect,
+    Disconnect,
+    DisconnectAndConnect,
+};
+
+enum class NetworkType : u32 {
+    None,
+    General,
+    Ldn,
+    All,
+};
+
+enum class PackedNetworkType : u8 {
+    None,
+    General,
+    Ldn,
+    All,
+};
+
+enum class SecurityMode : u16 {
+    All,
+    Retail,
+    Debug,
+};
+
+/// Fields of ScanFilter that are compared
+namespace ScanFilterFlag {
+constexpr u32 LocalCommunicationId = 1 << 0;
+constexpr u32 SessionId = 1 << 1;
+constexpr u32 NetworkType = 1 << 2;
+constexpr u32 Ssid = 1 << 4;
+constexpr u32 SceneId = 1 << 5;
+} // namespace ScanFilterFlag
+
+using Ipv4Address = std::array<u8, 4>;
+using MacAddress = std::array<u8, 6>;
+
+struct SessionId {
+    u64 high;
+    u64 low;
+};
+static_assert(sizeof(SessionId) == 0x10, "SessionId is an invalid size");
+
+struct IntentId {
+    u64 local_communication_id;
+    INSERT_PADDING_BYTES(2);
+    u16 scene_id;
+    INSERT_PADDING_BYTES(4);
+};
+static_assert(sizeof(IntentId) == 0x10, "IntentId is an invalid size");
+
+struct NetworkId {
+    IntentId intent_id;
+    SessionId session_id;
+};
+static_assert(sizeof(NetworkId) == 0x20, "NetworkId is an invalid size");
+
+struct Ssid {
+    u8 length;
+    std::array<char, SSID_LENGTH_MAX + 1> raw;
+};
+static_assert(sizeof(Ssid) == 0x22, "Ssid is an invalid size");
+
+struct ScanFilter {
+    NetworkId network_id;
+    NetworkType network_type;
+    MacAddress mac_address;
+    Ssid ssid;
+    INSERT_PADDING_BYTES(0x10);
+    u32 flag;
+};
+static_assert(sizeof(ScanFilter) == 0x60, "ScanFilter is an invalid size");
+
+struct CommonNetworkInfo {
+    MacAddress bssid;
+    Ssid ssid;
+    WifiChannel channel;
+    LinkLevel link_level;
+    PackedNetworkType network_type;
+    INSERT_PADDING_BYTES(0x4);
+};
+static_assert(sizeof(CommonNetworkInfo) == 0x30, "CommonNetworkInfo is an invalid size");
+
+struct NodeInfo {
+    Ipv4Address ipv4_address;
+    MacAddress mac_address;
+    s8 node_id;
+    u8 is_connected;
+    std::array<u8, USER_NAME_BYTES_MAX + 1> user_name;
+    INSERT_PADDING_BYTES(0x1);
+    s16 local_communication_version;
+    INSERT_PADDING_BYTES(0x10);
+};
+static_assert(sizeof(NodeInfo) == 0x40, "NodeInfo is an invalid size");
+
+struct LdnNetworkInfo {
+    std::array<u8, 0x10> security_parameter;
+    SecurityMode security_mode;
+    AcceptPolicy station_accept_policy;
+    u8 has_action_frame;
+    INSERT_PADDING_BYTES(2);
+    u8 node_count_max;
+    u8 node_count;
+    std::array<NodeInfo, NODE_COUNT_MAX> nodes;
+    INSERT_PADDING_BYTES(2);
+    u16 advertise_data_size;
+    std::array<u8, ADVERTISE_DATA_SIZE_MAX> advertise_data;
+    INSERT_PADDING_BYTES(0x8C);
+    u64 random_authentication_id;
+};
+static_assert(sizeof(LdnNetworkInfo) == 0x430, "LdnNetworkInfo is an invalid size");
+
+struct NetworkInfo {
+    NetworkId network_id;
+    CommonNetworkInfo common;
+    LdnNetworkInfo ldn;
+};
+static_assert(sizeof(NetworkInfo) == 0x480, "NetworkInfo is an invalid size");
+static_assert(std::is_trivially_copyable_v<NetworkInfo>, "NetworkInfo is not trivially copyable");
+
+struct SecurityConfig {
+    SecurityMode security_mode;
+    u16 passphrase_size;
+    std::array<u8, PASSPHRASE_LENGTH_MAX> passphrase;
+};
+static_assert(sizeof(SecurityConfig) == 0x44, "SecurityConfig is an invalid size");
+
+struct SecurityParameter {
+    std::array<u8, 0x10> data;
+    SessionId session_id;
+};
+static_assert(sizeof(SecurityParameter) == 0x20, "SecurityParameter is an invalid size");
+
+struct UserConfig {
+    std::array<u8, USER_NAME_BYTES_MAX + 1> user_name;
+    INSERT_PADDING_BYTES(0xF);
+};
+static_assert(sizeof(UserConfig) == 0x30, "UserConfig is an invalid size");
+
+struct NetworkConfig {
+    IntentId intent_id;
+    WifiChannel channel;
+    u8 node_count_max;
+    INSERT_PADDING_BYTES(1);
+    u16 local_communication_version;
+    INSERT_PADDING_BYTES(0xA);
+};
+static_assert(sizeof(NetworkConfig) == 0x20, "NetworkConfig is an invalid size");
+
+struct CreateNetworkConfig {
+    SecurityConfig security_config;
+    UserConfig user_config;
+    INSERT_PADDING_BYTES(0x4);
+    NetworkConfig network_config;
+};
+static_assert(sizeof(CreateNetworkConfig) == 0x98, "CreateNetworkConfig is an invalid size");
+
+struct ConnectNetworkData {
+    SecurityConfig security_config;
+    UserConfig user_config;
+    s32 local_communication_version;
+    u32 option;
+};
+static_assert(sizeof(ConnectNetworkData) == 0x7C, "ConnectNetworkData is an invalid size");
+
+struct NodeLatestUpdate {
+    NodeStateChange state_change;
+    INSERT_PADDING_BYTES(0x7);
+};
+static_assert(sizeof(NodeLatestUpdate) == 0x8, "NodeLatestUpdate is an invalid size");
+
+} // namespace Service::LDN
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include <vector>
 
 #include "common/assert.h"
@@ -12,6 +13,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/nca_metadata.h"
@@ -23,6 +25,7 @@
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/hle/service/ns/pl_u.h"
+#include "core/perf_stats.h"
 
 namespace Service::NS {
 
@@ -113,6 +116,32 @@ static u32 GetU32Swapped(const u8* data) {
 }
 
 struct PL_U::Impl {
+    /// Finds the shared fonts in the system archives and lays out their regions, without reading
+    /// them. Runs on the shared worker.
+    void LocateSharedFonts(Core::System& system);
+
+    /// Decrypts a shared font into the shared memory, if it hasn't been yet. Thread safe.
+    void LoadSharedFont(std::size_t index) {
+        std::lock_guard lock{font_mutex};
+        if (index >= font_files.size() || !font_files[index]) {
+            return;
+        }
+        const FileSys::VirtualFile file = std::move(font_files[index]);
+        std::vector<u32> font_data_u32(file->GetSize() / sizeof(u32));
+        file->ReadBytes<u32>(font_data_u32.data(), font_data_u32.size() * sizeof(u32));
+        // We need to be BigEndian as u32s for the xor encryption
+        std::transform(font_data_u32.begin(), font_data_u32.end(), font_data_u32.begin(),
+                       Common::swap32);
+        std::size_t offset = shared_font_regions[index].offset - 8;
+        DecryptSharedFont(font_data_u32, *shared_font, offset);
+    }
+
+    void LoadAllSharedFonts() {
+        for (std::size_t i = 0; i < font_files.size(); ++i) {
+            LoadSharedFont(i);
+        }
+    }
+
     const FontRegion& GetSharedFontRegion(std::size_t index) const {
         if (index >= shared_font_regions.size() || shared_font_regions.empty()) {
             // No font fallback
@@ -148,6 +177,13 @@ struct PL_U::Impl {
 
     // Automatically populated based on shared_fonts dump or system archives.
     std::vector<FontRegion> shared_font_regions;
+
+    /// BFTTF of each region, released once it has been decrypted into the shared memory
+    std::vector<FileSys::VirtualFile> font_files;
+    std::mutex font_mutex;
+
+    /// Pending shared font load, the font members can only be used once it's done
+    Common::TaskGroup fonts_task;
 };
 
 PL_U::PL_U(Core::System& system)
@@ -169,6 +205,18 @@ PL_U::PL_U(Core::System& system)
     // clang-format on
     RegisterHandlers(functions);
 
+    // Finding the fonts doesn't depend on the rest of the boot, it's done on the shared worker and
+    // the requests wait for it. Fonts are only decrypted once they are requested.
+    Common::GetSharedWorker().QueueWork(impl->fonts_task,
+                                        [this] { impl->LocateSharedFonts(this->system); });
+}
+
+PL_U::~PL_U() {
+    impl->fonts_task.Wait();
+}
+
+void PL_U::Impl::LocateSharedFonts(Core::System& system) {
+    Core::BootStageTimer timer{"shared fonts"};
     auto& fsc = system.GetFileSystemController();
 
     // Attempt to load shared font data from disk
@@ -176,7 +224,7 @@ PL_U::PL_U(Core::System& system)
     std::size_t offset = 0;
     // Rebuild shared fonts from data ncas or synthesize
 
-    impl->shared_font = std::make_shared<Kernel::PhysicalMemory>(SHARED_FONT_MEM_SIZE);
+    shared_font = std::make_shared<Kernel::PhysicalMemory>(SHARED_FONT_MEM_SIZE);
     for (auto font : SHARED_FONTS) {
         FileSys::VirtualFile romfs;
         const auto nca =
@@ -207,26 +255,23 @@ PL_U::PL_U(Core::System& system)
                       static_cast<u64>(font.first), font.second);
             continue;
         }
-        std::vector<u32> font_data_u32(font_fp->GetSize() / sizeof(u32));
-        font_fp->ReadBytes<u32>(font_data_u32.data(), font_fp->GetSize());
-        // We need to be BigEndian as u32s for the xor encryption
-        std::transform(font_data_u32.begin(), font_data_u32.end(), font_data_u32.begin(),
-                       Common::swap32);
+        const std::size_t font_size = font_fp->GetSize() / sizeof(u32) * sizeof(u32);
+        ASSERT_MSG(offset + font_size < SHARED_FONT_MEM_SIZE, "Shared fonts exceeds 17mb!");
         // Font offset and size do not account for the header
-        const FontRegion region{static_cast<u32>(offset + 8),
-                                static_cast<u32>((font_data_u32.size() * sizeof(u32)) - 8)};
-        DecryptSharedFont(font_data_u32, *impl->shared_font, offset);
-        impl->shared_font_regions.push_back(region);
+        const FontRegion region{static_cast<u32>(offset + 8), static_cast<u32>(font_size - 8)};
+        offset += font_size;
+        shared_font_regions.push_back(region);
+        font_files.push_back(font_fp);
     }
 }
 
-PL_U::~PL_U() = default;
-
 void PL_U::RequestLoad(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u32 shared_font_type{rp.Pop<u32>()};
-    // Games don't call this so all fonts should be loaded
+    // Games don't always call this, requests that return offsets load the fonts too
     LOG_DEBUG(Service_NS, "called, shared_font_type={}", shared_font_type);
+    impl->fonts_task.Wait();
+    impl->LoadSharedFont(shared_font_type);
 
     IPC::ResponseBuilder rb{ctx, 2};
     rb.Push(RESULT_SUCCESS);
@@ -236,6 +281,7 @@ void PL_U::GetLoadState(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u32 font_id{rp.Pop<u32>()};
     LOG_DEBUG(Service_NS, "called, font_id={}", font_id);
+    impl->fonts_task.Wait();
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(RESULT_SUCCESS);
@@ -246,6 +292,7 @@ void PL_U::GetSize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u32 font_id{rp.Pop<u32>()};
     LOG_DEBUG(Service_NS, "called, font_id={}", font_id);
+    impl->fonts_task.Wait();
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(RESULT_SUCCESS);
@@ -256,15 +303,18 @@ void PL_U::GetSharedMemoryAddressOffset(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u32 font_id{rp.Pop<u32>()};
     LOG_DEBUG(Service_NS, "called, font_id={}", font_id);
+    impl->fonts_task.Wait();
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(RESULT_SUCCESS);
+    impl->LoadSharedFont(font_id);
     rb.Push<u32>(impl->GetSharedFontRegion(font_id).offset);
 }
 
 void PL_U::GetSharedMemoryNativeHandle(Kernel::HLERequestContext& ctx) {
     // Map backing memory for the font data
     LOG_DEBUG(Service_NS, "called");
+    impl->fonts_task.Wait();
     system.CurrentProcess()->VMManager().MapMemoryBlock(SHARED_FONT_MEM_VADDR, impl->shared_font, 0,
                                                         SHARED_FONT_MEM_SIZE,
                                                         Kernel::MemoryState::Shared);
@@ -285,6 +335,8 @@ void PL_U::GetSharedFontInOrderOfPriority(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
     const u64 language_code{rp.Pop<u64>()}; // TODO(ogniK): Find out what this is used for
     LOG_DEBUG(Service_NS, "called, language_code={:X}", language_code);
+    impl->fonts_task.Wait();
+    impl->LoadAllSharedFonts();
 
     IPC::ResponseBuilder rb{ctx, 4};
     std::vector<u32> font_codes;
@@ -36,12 +36,12 @@ public:
      * Handles an ioctl request.
      * @param command The ioctl command id.
      * @param input A buffer containing the input data for the ioctl.
-     * @param output A buffer where the output data will be written to.
+     * @param output A buffer where the output data will be written to, zeroed beforehand. It may
+     *               be guest memory, but never memory shared with an input.
      * @returns The result code of the ioctl.
      */
-    virtual u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                      std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                      IoctlVersion version) = 0;
+    virtual u32 ioctl(Ioctl command, InputBuffer input, InputBuffer input2, OutputBuffer output,
+                      OutputBuffer output2, IoctlCtrl& ctrl, IoctlVersion version) = 0;
 
 protected:
     Core::System& system;
@@ -20,9 +20,8 @@ public:
     explicit nvhost_as_gpu(Core::System& system, std::shared_ptr<nvmap> nvmap_dev);
     ~nvhost_as_gpu() override;
 
-    u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-              std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-              IoctlVersion version) override;
+    u32 ioctl(Ioctl command, InputBuffer input, InputBuffer input2, OutputBuffer output,
+              OutputBuffer output2, IoctlCtrl& ctrl, IoctlVersion version) override;
 
 private:
     enum class IoctlCommand : u32_le {
@@ -117,13 +116,13 @@ private:
 
     u32 channel{};
 
-    u32 InitalizeEx(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 AllocateSpace(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 Remap(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 MapBufferEx(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 UnmapBuffer(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 BindChannel(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 GetVARegions(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 InitalizeEx(InputBuffer input, OutputBuffer output);
+    u32 AllocateSpace(InputBuffer input, OutputBuffer output);
+    u32 Remap(InputBuffer input, OutputBuffer output);
+    u32 MapBufferEx(InputBuffer input, OutputBuffer output);
+    u32 UnmapBuffer(InputBuffer input, OutputBuffer output);
+    u32 BindChannel(InputBuffer input, OutputBuffer output);
+    u32 GetVARegions(InputBuffer input, OutputBuffer output);
 
     std::shared_ptr<nvmap> nvmap_dev;
 };
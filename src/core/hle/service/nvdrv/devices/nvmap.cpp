@@ -2,8 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <algorithm>
 #include <cstring>
+#include <utility>
 
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -28,9 +28,31 @@ VAddr nvmap::GetObjectAddress(u32 handle) const {
     return object->addr;
 }
 
-u32 nvmap::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-                 std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-                 IoctlVersion version) {
+u32 nvmap::CreateHandle(std::shared_ptr<Object> object) {
+    u32 index;
+    if (free_slots.empty()) {
+        index = static_cast<u32>(slots.size());
+        ASSERT_MSG(index <= HANDLE_INDEX_MASK, "Out of nvmap handles");
+        slots.emplace_back();
+    } else {
+        index = free_slots.back();
+        free_slots.pop_back();
+    }
+    HandleSlot& slot = slots[index];
+    slot.object = std::move(object);
+    return (slot.generation << HANDLE_INDEX_BITS) | index;
+}
+
+void nvmap::FreeHandle(u32 handle) {
+    const u32 index = handle & HANDLE_INDEX_MASK;
+    HandleSlot& slot = slots[index];
+    slot.object.reset();
+    slot.generation = (slot.generation + 1) & HANDLE_GENERATION_MASK;
+    free_slots.push_back(index);
+}
+
+u32 nvmap::ioctl(Ioctl command, InputBuffer input, InputBuffer input2, OutputBuffer output,
+                 OutputBuffer output2, IoctlCtrl& ctrl, IoctlVersion version) {
     switch (static_cast<IoctlCommand>(command.raw)) {
     case IoctlCommand::Create:
         return IocCreate(input, output);
@@ -50,7 +72,7 @@ u32 nvmap::ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<
     return 0;
 }
 
-u32 nvmap::IocCreate(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocCreate(InputBuffer input, OutputBuffer output) {
     IocCreateParams params;
     std::memcpy(&params, input.data(), sizeof(params));
     LOG_DEBUG(Service_NVDRV, "size=0x{:08X}", params.size);
@@ -61,21 +83,19 @@ u32 nvmap::IocCreate(const std::vector<u8>& input, std::vector<u8>& output) {
     }
     // Create a new nvmap object and obtain a handle to it.
     auto object = std::make_shared<Object>();
-    object->id = next_id++;
     object->size = params.size;
     object->status = Object::Status::Created;
     object->refcount = 1;
 
-    u32 handle = next_handle++;
-    handles[handle] = std::move(object);
-
-    params.handle = handle;
+    // The real nvservices doesn't make a distinction between handles and ids.
+    params.handle = CreateHandle(object);
+    object->id = params.handle;
 
     std::memcpy(output.data(), &params, sizeof(params));
     return 0;
 }
 
-u32 nvmap::IocAlloc(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocAlloc(InputBuffer input, OutputBuffer output) {
     IocAllocParams params;
     std::memcpy(&params, input.data(), sizeof(params));
     LOG_DEBUG(Service_NVDRV, "called, addr={:X}", params.addr);
@@ -116,7 +136,7 @@ u32 nvmap::IocAlloc(const std::vector<u8>& input, std::vector<u8>& output) {
     return 0;
 }
 
-u32 nvmap::IocGetId(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocGetId(InputBuffer input, OutputBuffer output) {
     IocGetIdParams params;
     std::memcpy(&params, input.data(), sizeof(params));
 
@@ -139,35 +159,34 @@ u32 nvmap::IocGetId(const std::vector<u8>& input, std::vector<u8>& output) {
     return 0;
 }
 
-u32 nvmap::IocFromId(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocFromId(InputBuffer input, OutputBuffer output) {
     IocFromIdParams params;
     std::memcpy(&params, input.data(), sizeof(params));
 
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
-    auto itr = std::find_if(handles.begin(), handles.end(),
-                            [&](const auto& entry) { return entry.second->id == params.id; });
-    if (itr == handles.end()) {
+    // Ids are the same as handles, so the object is found without searching.
+    auto object = GetObject(params.id);
+    if (!object) {
         LOG_ERROR(Service_NVDRV, "Object does not exist, handle={:08X}", params.handle);
         return static_cast<u32>(NvErrCodes::InvalidValue);
     }
 
-    auto& object = itr->second;
     if (object->status != Object::Status::Allocated) {
         LOG_ERROR(Service_NVDRV, "Object is not allocated, handle={:08X}", params.handle);
         return static_cast<u32>(NvErrCodes::InvalidValue);
     }
 
-    itr->second->refcount++;
+    object->refcount++;
 
     // Return the existing handle instead of creating a new one.
-    params.handle = itr->first;
+    params.handle = params.id;
 
     std::memcpy(output.data(), &params, sizeof(params));
     return 0;
 }
 
-u32 nvmap::IocParam(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocParam(InputBuffer input, OutputBuffer output) {
     enum class ParamTypes { Size = 1, Alignment = 2, Base = 3, Heap = 4, Kind = 5, Compr = 6 };
 
     IocParamParams params;
@@ -208,7 +227,7 @@ u32 nvmap::IocParam(const std::vector<u8>& input, std::vector<u8>& output) {
     return 0;
 }
 
-u32 nvmap::IocFree(const std::vector<u8>& input, std::vector<u8>& output) {
+u32 nvmap::IocFree(InputBuffer input, OutputBuffer output) {
     // TODO(Subv): These flags are unconfirmed.
     enum FreeFlags {
         Freed = 0,
@@ -220,12 +239,12 @@ u32 nvmap::IocFree(const std::vector<u8>& input, std::vector<u8>& output) {
 
     LOG_WARNING(Service_NVDRV, "(STUBBED) called");
 
-    auto itr = handles.find(params.handle);
-    if (itr == handles.end()) {
+    const auto object = GetObject(params.handle);
+    if (!object) {
         LOG_ERROR(Service_NVDRV, "Object does not exist, handle={:08X}", params.handle);
         return static_cast<u32>(NvErrCodes::InvalidValue);
     }
-    if (!itr->second->refcount) {
+    if (!object->refcount) {
         LOG_ERROR(
             Service_NVDRV,
             "There is no references to this object. The object is already freed. handle={:08X}",
@@ -233,21 +252,21 @@ u32 nvmap::IocFree(const std::vector<u8>& input, std::vector<u8>& output) {
         return static_cast<u32>(NvErrCodes::InvalidValue);
     }
 
-    itr->second->refcount--;
+    object->refcount--;
 
-    params.size = itr->second->size;
+    params.size = object->size;
 
-    if (itr->second->refcount == 0) {
+    if (object->refcount == 0) {
         params.flags = Freed;
         // The address of the nvmap is written to the output if we're finally freeing it, otherwise
         // 0 is written.
-        params.address = itr->second->addr;
+        params.address = object->addr;
     } else {
         params.flags = NotFreedYet;
         params.address = 0;
     }
 
-    handles.erase(params.handle);
+    FreeHandle(params.handle);
 
     std::memcpy(output.data(), &params, sizeof(params));
     return 0;
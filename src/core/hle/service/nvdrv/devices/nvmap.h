@@ -5,7 +5,6 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <vector>
 #include "common/common_funcs.h"
 #include "common/common_types.h"
@@ -22,9 +21,8 @@ public:
     /// Returns the allocated address of an nvmap object given its handle.
     VAddr GetObjectAddress(u32 handle) const;
 
-    u32 ioctl(Ioctl command, const std::vector<u8>& input, const std::vector<u8>& input2,
-              std::vector<u8>& output, std::vector<u8>& output2, IoctlCtrl& ctrl,
-              IoctlVersion version) override;
+    u32 ioctl(Ioctl command, InputBuffer input, InputBuffer input2, OutputBuffer output,
+              OutputBuffer output2, IoctlCtrl& ctrl, IoctlVersion version) override;
 
     /// Represents an nvmap object.
     struct Object {
@@ -40,22 +38,40 @@ public:
     };
 
     std::shared_ptr<Object> GetObject(u32 handle) const {
-        auto itr = handles.find(handle);
-        if (itr != handles.end()) {
-            return itr->second;
+        const u32 index = handle & HANDLE_INDEX_MASK;
+        if (index >= slots.size()) {
+            return {};
         }
-        return {};
+        const HandleSlot& slot = slots[index];
+        if (slot.generation != handle >> HANDLE_INDEX_BITS) {
+            return {};
+        }
+        return slot.object;
     }
 
 private:
-    /// Id to use for the next handle that is created.
-    u32 next_handle = 1;
+    /// Handles index their slot with the low bits and store the slot generation in the rest, so
+    /// stale handles of a reused slot don't resolve to the new object.
+    static constexpr u32 HANDLE_INDEX_BITS = 20;
+    static constexpr u32 HANDLE_INDEX_MASK = (1U << HANDLE_INDEX_BITS) - 1;
+    static constexpr u32 HANDLE_GENERATION_MASK = (1U << (32 - HANDLE_INDEX_BITS)) - 1;
+
+    struct HandleSlot {
+        std::shared_ptr<Object> object;
+        u32 generation = 0;
+    };
+
+    /// Creates a handle for the given object, reusing released slots first.
+    u32 CreateHandle(std::shared_ptr<Object> object);
+
+    /// Releases the slot of a handle, invalidating the handle.
+    void FreeHandle(u32 handle);
 
-    /// Id to use for the next object that is created.
-    u32 next_id = 1;
+    /// Objects indexed by handle. Slot 0 is never used so a handle is never zero.
+    std::vector<HandleSlot> slots{1};
 
-    /// Mapping of currently allocated handles to the objects they represent.
-    std::unordered_map<u32, std::shared_ptr<Object>> handles;
+    /// Indices of released slots ready to be reused.
+    std::vector<u32> free_slots;
 
     enum class IoctlCommand : u32 {
         Create = 0xC0080101,
@@ -119,12 +135,12 @@ private:
     };
     static_assert(sizeof(IocGetIdParams) == 8, "IocGetIdParams has wrong size");
 
-    u32 IocCreate(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocAlloc(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocGetId(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocFromId(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocParam(const std::vector<u8>& input, std::vector<u8>& output);
-    u32 IocFree(const std::vector<u8>& input, std::vector<u8>& output);
+    u32 IocCreate(InputBuffer input, OutputBuffer output);
+    u32 IocAlloc(InputBuffer input, OutputBuffer output);
+    u32 IocGetId(InputBuffer input, OutputBuffer output);
+    u32 IocFromId(InputBuffer input, OutputBuffer output);
+    u32 IocParam(InputBuffer input, OutputBuffer output);
+    u32 IocFree(InputBuffer input, OutputBuffer output);
 };
 
 } // namespace Service::Nvidia::Devices
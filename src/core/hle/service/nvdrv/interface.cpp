@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
+#include <vector>
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/hle/ipc_helpers.h"
@@ -16,6 +18,15 @@
 
 namespace Service::Nvidia {
 
+namespace {
+
+bool Overlaps(InputBuffer input, OutputBuffer output) {
+    return !input.empty() && !output.empty() && input.data() < output.end() &&
+           output.data() < input.end();
+}
+
+} // Anonymous namespace
+
 void NVDRV::SignalGPUInterruptSyncpt(const u32 syncpoint_id, const u32 value) {
     nvdrv->SignalSyncpt(syncpoint_id, value);
 }
@@ -38,50 +49,67 @@ void NVDRV::IoctlBase(Kernel::HLERequestContext& ctx, IoctlVersion version) {
     u32 fd = rp.Pop<u32>();
     u32 command = rp.Pop<u32>();
 
-    /// Ioctl 3 has 2 outputs, first in the input params, second is the result
-    std::vector<u8> output(ctx.GetWriteBufferSize(0));
-    std::vector<u8> output2;
-    if (version == IoctlVersion::Version3) {
-        output2.resize((ctx.GetWriteBufferSize(1)));
-    }
-
     /// Ioctl2 has 2 inputs. It's used to pass data directly instead of providing a pointer.
     /// KickOfPB uses this
-    auto input = ctx.ReadBuffer(0);
+    const InputBuffer input = ctx.ReadBufferView(0);
+    const InputBuffer input2 =
+        version == IoctlVersion::Version2 ? ctx.ReadBufferView(1) : InputBuffer{};
 
-    std::vector<u8> input2;
-    if (version == IoctlVersion::Version2) {
-        input2 = ctx.ReadBuffer(1);
-    }
+    /// Ioctl 3 has 2 outputs, first in the input params, second is the result
+    /// Outputs are filled in place in guest memory, unless they share memory with an input.
+    /// Applications commonly pass the same buffer in both directions, and devices may write
+    /// their output before they are done reading the input.
+    std::vector<u8> output_copy;
+    std::vector<u8> output2_copy;
+    const auto make_output = [&](int buffer_index, std::vector<u8>& copy) {
+        OutputBuffer view = ctx.WriteBufferView(buffer_index);
+        if (Overlaps(input, view) || Overlaps(input2, view)) {
+            copy.resize(view.size());
+            view = {copy.data(), copy.size()};
+        }
+        std::fill(view.begin(), view.end(), u8{0});
+        return view;
+    };
+    const OutputBuffer output = make_output(0, output_copy);
+    const OutputBuffer output2 =
+        version == IoctlVersion::Version3 ? make_output(1, output2_copy) : OutputBuffer{};
 
     IoctlCtrl ctrl{};
 
     u32 result = nvdrv->Ioctl(fd, command, input, input2, output, output2, ctrl, version);
 
     if (ctrl.must_delay) {
+        // The views don't outlive this request, the retry works on copies of the buffers
         ctrl.fresh_call = false;
-        ctx.SleepClientThread("NVServices::DelayedResponse", ctrl.timeout,
-                              [=](std::shared_ptr<Kernel::Thread> thread,
-                                  Kernel::HLERequestContext& ctx,
-                                  Kernel::ThreadWakeupReason reason) {
-                                  IoctlCtrl ctrl2{ctrl};
-                                  std::vector<u8> tmp_output = output;
-                                  std::vector<u8> tmp_output2 = output2;
-                                  u32 result = nvdrv->Ioctl(fd, command, input, input2, tmp_output,
-                                                            tmp_output2, ctrl2, version);
-                                  ctx.WriteBuffer(tmp_output, 0);
-                                  if (version == IoctlVersion::Version3) {
-                                      ctx.WriteBuffer(tmp_output2, 1);
-                                  }
-                                  IPC::ResponseBuilder rb{ctx, 3};
-                                  rb.Push(RESULT_SUCCESS);
-                                  rb.Push(result);
-                              },
-                              nvdrv->GetEventWriteable(ctrl.event_id));
+        ctx.SleepClientThread(
+            "NVServices::DelayedResponse", ctrl.timeout,
+            [=, input = std::vector<u8>(input.begin(), input.end()),
+             input2 = std::vector<u8>(input2.begin(), input2.end()),
+             output = std::vector<u8>(output.begin(), output.end()),
+             output2 = std::vector<u8>(output2.begin(), output2.end())](
+                std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) {
+                IoctlCtrl ctrl2{ctrl};
+                std::vector<u8> tmp_output = output;
+                std::vector<u8> tmp_output2 = output2;
+                u32 result = nvdrv->Ioctl(fd, command, {input.data(), input.size()},
+                                          {input2.data(), input2.size()},
+                                          {tmp_output.data(), tmp_output.size()},
+                                          {tmp_output2.data(), tmp_output2.size()}, ctrl2, version);
+                ctx.WriteBuffer(tmp_output, 0);
+                if (version == IoctlVersion::Version3) {
+                    ctx.WriteBuffer(tmp_output2, 1);
+                }
+                IPC::ResponseBuilder rb{ctx, 3};
+                rb.Push(RESULT_SUCCESS);
+                rb.Push(result);
+            },
+            nvdrv->GetEventWriteable(ctrl.event_id));
     } else {
-        ctx.WriteBuffer(output);
+        // Skipped when the output was written in place
+        ctx.WriteBuffer(output.data(), output.size());
         if (version == IoctlVersion::Version3) {
-            ctx.WriteBuffer(output2, 1);
+            ctx.WriteBuffer(output2.data(), output2.size(), 1);
         }
     }
     IPC::ResponseBuilder rb{ctx, 3};
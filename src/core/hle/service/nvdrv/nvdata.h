@@ -3,8 +3,17 @@
 #include <array>
 #include "common/common_types.h"
 
+namespace Kernel {
+template <typename T>
+class BufferView;
+}
+
 namespace Service::Nvidia {
 
+/// Ioctl arguments are views of the IPC buffers, which refer to guest memory when possible.
+using InputBuffer = Kernel::BufferView<const u8>;
+using OutputBuffer = Kernel::BufferView<u8>;
+
 constexpr u32 MaxSyncPoints = 192;
 constexpr u32 MaxNvEvents = 64;
 
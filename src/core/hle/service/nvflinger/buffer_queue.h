@@ -89,6 +89,9 @@ public:
     void ReleaseBuffer(u32 slot);
     u32 Query(QueryType type);
 
+    /// Returns true when a buffer has been queued and not acquired yet.
+    bool HasQueuedBuffer() const;
+
     u32 GetId() const {
         return id;
     }
@@ -22,12 +22,15 @@
 #include "core/hle/service/vi/layer/vi_layer.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
+#include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
 
 namespace Service::NVFlinger {
 
 constexpr s64 frame_ticks = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 60);
 constexpr s64 frame_ticks_30fps = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 30);
+/// Interval at which adaptive composition checks whether the previous frame has been presented
+constexpr s64 present_poll_ticks = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 2000);
 
 NVFlinger::NVFlinger(Core::System& system) : system(system) {
     displays.emplace_back(0, "Default", system);
@@ -39,18 +42,35 @@ NVFlinger::NVFlinger(Core::System& system) : system(system) {
     // Schedule the screen composition events
     composition_event =
         Core::Timing::CreateEvent("ScreenComposition", [this](u64 userdata, s64 cycles_late) {
-            Compose();
-            const auto ticks =
-                Settings::values.force_30fps_mode ? frame_ticks_30fps : GetNextTicks();
+            s64 ticks;
+            if (Settings::values.use_adaptive_composition && HasQueuedBuffer() &&
+                !CanComposeQueuedBuffer()) {
+                // Composing now would replace a frame the host hasn't shown yet
+                ticks = present_poll_ticks;
+            } else {
+                Compose();
+                // With adaptive composition this only keeps vsync going while nothing is queued
+                ticks = Settings::values.force_30fps_mode ? frame_ticks_30fps : GetNextTicks();
+            }
             this->system.CoreTiming().ScheduleEvent(std::max<s64>(0LL, ticks - cycles_late),
                                                     composition_event);
         });
 
     system.CoreTiming().ScheduleEvent(frame_ticks, composition_event);
+
+    release_event =
+        Core::Timing::CreateEvent("BufferRelease", [this](u64 userdata, s64 cycles_late) {
+            ReleasePresentedBuffers();
+            if (!presenting_buffers.empty()) {
+                this->system.CoreTiming().ScheduleEvent(
+                    std::max<s64>(0LL, present_poll_ticks - cycles_late), release_event);
+            }
+        });
 }
 
 NVFlinger::~NVFlinger() {
     system.CoreTiming().UnscheduleEvent(composition_event, 0);
+    system.CoreTiming().UnscheduleEvent(release_event, 0);
 }
 
 void NVFlinger::SetNVDrvInstance(std::shared_ptr<Nvidia::Module> instance) {
@@ -174,6 +194,42 @@ const VI::Layer* NVFlinger::FindLayer(u64 display_id, u64 layer_id) const {
     return display->FindLayer(layer_id);
 }
 
+bool NVFlinger::HasQueuedBuffer() const {
+    return std::any_of(buffer_queues.begin(), buffer_queues.end(),
+                       [](const BufferQueue& queue) { return queue.HasQueuedBuffer(); });
+}
+
+bool NVFlinger::CanComposeQueuedBuffer() const {
+    const auto& gpu = system.GPU();
+    if (Settings::values.use_extra_host_buffer) {
+        return gpu.IsSwapPresented(previous_swap_fence);
+    }
+    return !gpu.IsSwapPending();
+}
+
+void NVFlinger::ReleasePresentedBuffers() {
+    // Frames are presented in order, stop at the first one the host is still working on
+    auto& gpu = system.GPU();
+    const auto first_pending =
+        std::find_if(presenting_buffers.begin(), presenting_buffers.end(),
+                     [&gpu](const PresentingBuffer& buffer) {
+                         return !gpu.IsSwapPresented(buffer.swap_fence);
+                     });
+    for (auto it = presenting_buffers.begin(); it != first_pending; ++it) {
+        FindBufferQueue(it->buffer_queue_id).ReleaseBuffer(it->slot);
+    }
+    presenting_buffers.erase(presenting_buffers.begin(), first_pending);
+}
+
+void NVFlinger::OnBufferQueued() {
+    if (!Settings::values.use_adaptive_composition) {
+        return;
+    }
+    auto& core_timing = system.CoreTiming();
+    core_timing.UnscheduleEvent(composition_event, 0);
+    core_timing.ScheduleEvent(0, composition_event);
+}
+
 void NVFlinger::Compose() {
     for (auto& display : displays) {
         // Trigger vsync for this display at the end of drawing
@@ -211,12 +267,27 @@ void NVFlinger::Compose() {
         auto nvdisp = nvdrv->GetDevice<Nvidia::Devices::nvdisp_disp0>("/dev/nvdisp_disp0");
         ASSERT(nvdisp);
 
+        const u64 last_swap_fence = gpu.GetLastSwapFence();
         nvdisp->flip(igbp_buffer.gpu_buffer_id, igbp_buffer.offset, igbp_buffer.format,
                      igbp_buffer.width, igbp_buffer.height, igbp_buffer.stride,
                      buffer->get().transform, buffer->get().crop_rect);
+        previous_swap_fence = last_swap_fence;
 
         swap_interval = buffer->get().swap_interval;
-        buffer_queue.ReleaseBuffer(buffer->get().slot);
+
+        const u32 slot = buffer->get().slot;
+        const u64 swap_fence = gpu.GetLastSwapFence();
+        if (Settings::values.use_adaptive_composition && Settings::values.use_extra_host_buffer &&
+            !gpu.IsSwapPresented(swap_fence)) {
+            // The host may still read this buffer after the next frame is composed, so the guest
+            // gets it back once it has been presented instead of right away
+            if (presenting_buffers.empty()) {
+                system.CoreTiming().ScheduleEvent(present_poll_ticks, release_event);
+            }
+            presenting_buffers.push_back({buffer_queue.GetId(), slot, swap_fence});
+        } else {
+            buffer_queue.ReleaseBuffer(slot);
+        }
     }
 }
 
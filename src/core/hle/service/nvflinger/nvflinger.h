@@ -77,6 +77,10 @@ public:
     /// finished.
     void Compose();
 
+    /// Notifies that a buffer was queued. With adaptive composition this composes it as soon as
+    /// the host has presented the previous frame, instead of waiting for the next refresh.
+    void OnBufferQueued();
+
     s64 GetNextTicks() const;
 
 private:
@@ -92,6 +96,23 @@ private:
     /// Finds the layer identified by the specified ID in the desired display.
     const VI::Layer* FindLayer(u64 display_id, u64 layer_id) const;
 
+    /// Returns true when any buffer queue has a buffer waiting to be composed.
+    bool HasQueuedBuffer() const;
+
+    /// Returns true when the host can take another frame. It holds one frame while presenting the
+    /// previous one when an extra host buffer is used, and none otherwise.
+    bool CanComposeQueuedBuffer() const;
+
+    /// Hands the buffers whose frames the host has finished presenting back to the guest.
+    void ReleasePresentedBuffers();
+
+    /// Buffer composed while an extra host buffer is used, released once its swap is presented.
+    struct PresentingBuffer {
+        u32 buffer_queue_id;
+        u32 slot;
+        u64 swap_fence;
+    };
+
     std::shared_ptr<Nvidia::Module> nvdrv;
 
     std::vector<VI::Display> displays;
@@ -105,8 +126,15 @@ private:
 
     u32 swap_interval = 1;
 
+    /// Buffers held until the host presents them, in composition order.
+    std::vector<PresentingBuffer> presenting_buffers;
+    /// Swap fence of the frame composed before the last one.
+    u64 previous_swap_fence = 0;
+
     /// Event that handles screen composition.
     std::shared_ptr<Core::Timing::EventType> composition_event;
+    /// Event that releases presented buffers back to the guest.
+    std::shared_ptr<Core::Timing::EventType> release_event;
 
     Core::System& system;
 };
@@ -3,11 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/hle/ipc.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/client_port.h"
@@ -59,6 +61,7 @@
 #include "core/hle/service/psc/psc.h"
 #include "core/hle/service/ptm/psm.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/service_stats.h"
 #include "core/hle/service/set/settings.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/hle/service/sockets/sockets.h"
@@ -134,6 +137,31 @@ void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* function
         // Usually this array is sorted by id already, so hint to insert at the end
         handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
     }
+
+    // Inserting into the map can move its elements, so resolve the handlers again
+    dense_handlers.clear();
+    sparse_handlers.clear();
+    for (const auto& [command_id, info] : handlers) {
+        const Handler handler{&info,
+                              &Stats::GetCommandCounters(service_name, command_id, info.name)};
+        if (command_id >= DenseCommandLimit) {
+            sparse_handlers.emplace_hint(sparse_handlers.cend(), command_id, handler);
+            continue;
+        }
+        if (command_id >= dense_handlers.size()) {
+            dense_handlers.resize(command_id + 1, Handler{nullptr, nullptr});
+        }
+        dense_handlers[command_id] = handler;
+    }
+}
+
+auto ServiceFrameworkBase::FindHandler(u32 command_id) const -> const Handler* {
+    if (command_id < dense_handlers.size()) {
+        const Handler& handler = dense_handlers[command_id];
+        return handler.info == nullptr ? nullptr : &handler;
+    }
+    const auto it = sparse_handlers.find(command_id);
+    return it == sparse_handlers.end() ? nullptr : &it->second;
 }
 
 void ServiceFrameworkBase::ReportUnimplementedFunction(Kernel::HLERequestContext& ctx,
@@ -155,14 +183,19 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(Kernel::HLERequestContext
 }
 
 void ServiceFrameworkBase::InvokeRequest(Kernel::HLERequestContext& ctx) {
-    auto itr = handlers.find(ctx.GetCommand());
-    const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
+    const Handler* handler = FindHandler(ctx.GetCommand());
+    const FunctionInfoBase* info = handler == nullptr ? nullptr : handler->info;
     if (info == nullptr || info->handler_callback == nullptr) {
         return ReportUnimplementedFunction(ctx, info);
     }
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
-    handler_invoker(this, info->handler_callback, ctx);
+    const auto start = std::chrono::steady_clock::now();
+    {
+        Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::Hle};
+        handler_invoker(this, info->handler_callback, ctx);
+    }
+    handler->counters->Record(std::chrono::steady_clock::now() - start);
 }
 
 ResultCode ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context) {
@@ -224,7 +257,7 @@ void Init(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system) {
     GRC::InstallInterfaces(*sm);
     HID::InstallInterfaces(*sm, system);
     LBL::InstallInterfaces(*sm);
-    LDN::InstallInterfaces(*sm);
+    LDN::InstallInterfaces(*sm, system);
     LDR::InstallInterfaces(*sm, system);
     LM::InstallInterfaces(system);
     Migration::InstallInterfaces(*sm);
@@ -246,7 +279,7 @@ void Init(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system) {
     PSC::InstallInterfaces(*sm);
     PSM::InstallInterfaces(*sm);
     Set::InstallInterfaces(*sm);
-    Sockets::InstallInterfaces(*sm);
+    Sockets::InstallInterfaces(*sm, system);
     SPL::InstallInterfaces(*sm);
     SSL::InstallInterfaces(*sm);
     Time::InstallInterfaces(system);
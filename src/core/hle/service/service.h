@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <string>
+#include <vector>
 #include <boost/container/flat_map.hpp>
 #include "common/common_types.h"
 #include "core/hle/kernel/hle_ipc.h"
@@ -35,6 +36,10 @@ namespace SM {
 class ServiceManager;
 }
 
+namespace Stats {
+struct CommandCounters;
+}
+
 static const int kMaxPortSize = 8; ///< Maximum size of a port name (8 characters)
 /// Arbitrary default number of maximum connections to an HLE service.
 static const u32 DefaultMaxSessions = 10;
@@ -89,12 +94,24 @@ private:
     using InvokerFn = void(ServiceFrameworkBase* object, HandlerFnP<ServiceFrameworkBase> member,
                            Kernel::HLERequestContext& ctx);
 
+    /// Handler resolved at registration time, together with the counters of its command.
+    struct Handler {
+        const FunctionInfoBase* info;
+        Stats::CommandCounters* counters;
+    };
+
+    /// Command ids below this are dispatched through a table indexed by id.
+    static constexpr u32 DenseCommandLimit = 0x400;
+
     ServiceFrameworkBase(const char* service_name, u32 max_sessions, InvokerFn* handler_invoker);
     ~ServiceFrameworkBase() override;
 
     void RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n);
     void ReportUnimplementedFunction(Kernel::HLERequestContext& ctx, const FunctionInfoBase* info);
 
+    /// Returns the handler of a command, or nullptr when the command isn't registered.
+    const Handler* FindHandler(u32 command_id) const;
+
     /// Identifier string used to connect to the service.
     std::string service_name;
     /// Maximum number of concurrent sessions that this service can handle.
@@ -107,6 +124,10 @@ private:
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
+    /// Handlers of the ids below DenseCommandLimit indexed by id, with holes for unregistered ids
+    std::vector<Handler> dense_handlers;
+    /// Handlers of the ids at or above DenseCommandLimit
+    boost::container::flat_map<u32, Handler> sparse_handlers;
 };
 
 /**
@@ -0,0 +1,105 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+#include "core/hle/service/service_stats.h"
+
+namespace Service::Stats {
+
+namespace {
+
+struct Command {
+    explicit Command(const char* name_) : name{name_} {}
+
+    const char* name;
+    CommandCounters counters;
+};
+
+std::mutex registry_mutex;
+/// Nodes of a map are never moved, which keeps the references handed out valid
+std::map<std::pair<std::string, u32>, Command> registry;
+
+} // Anonymous namespace
+
+void CommandCounters::Record(std::chrono::nanoseconds latency) {
+    const auto ns = static_cast<u64>(latency.count());
+    std::size_t bucket = 0;
+    for (u64 us = ns / 1000; us != 0 && bucket < NumBuckets - 1; us >>= 1) {
+        ++bucket;
+    }
+    calls.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(ns, std::memory_order_relaxed);
+    histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+CommandCounters& GetCommandCounters(const std::string& service_name, u32 command_id,
+                                    const char* command_name) {
+    std::lock_guard lock{registry_mutex};
+    const auto it = registry.try_emplace({service_name, command_id}, command_name).first;
+    return it->second.counters;
+}
+
+std::string GetReport() {
+    struct Row {
+        const std::string* service_name;
+        u32 command_id;
+        const char* command_name;
+        u64 calls;
+        u64 total_ns;
+        std::array<u64, CommandCounters::NumBuckets> histogram;
+    };
+    std::vector<Row> rows;
+    {
+        std::lock_guard lock{registry_mutex};
+        for (const auto& [key, command] : registry) {
+            const auto& counters = command.counters;
+            const u64 calls = counters.calls.load(std::memory_order_relaxed);
+            if (calls == 0) {
+                continue;
+            }
+            Row row{&key.first, key.second, command.name, calls,
+                    counters.total_ns.load(std::memory_order_relaxed), {}};
+            for (std::size_t i = 0; i < row.histogram.size(); ++i) {
+                row.histogram[i] = counters.histogram[i].load(std::memory_order_relaxed);
+            }
+            rows.push_back(row);
+        }
+    }
+    std::sort(rows.begin(), rows.end(),
+              [](const Row& lhs, const Row& rhs) { return lhs.total_ns > rhs.total_ns; });
+
+    std::string report =
+        fmt::format("{:<24} {:>6} {:<40} {:>10} {:>12} {:>10}  histogram (<1us, <2us, ...)\n",
+                    "service", "id", "command", "calls", "total ms", "mean us");
+    for (const Row& row : rows) {
+        report += fmt::format("{:<24} {:>6} {:<40} {:>10} {:>12.3f} {:>10.2f} ", *row.service_name,
+                              row.command_id, row.command_name, row.calls,
+                              static_cast<double>(row.total_ns) / 1e6,
+                              static_cast<double>(row.total_ns) / 1e3 / row.calls);
+        for (const u64 count : row.histogram) {
+            report += fmt::format(" {}", count);
+        }
+        report += '\n';
+    }
+    return report;
+}
+
+void Reset() {
+    std::lock_guard lock{registry_mutex};
+    for (auto& [key, command] : registry) {
+        auto& counters = command.counters;
+        counters.calls = 0;
+        counters.total_ns = 0;
+        for (auto& count : counters.histogram) {
+            count = 0;
+        }
+    }
+}
+
+} // namespace Service::Stats
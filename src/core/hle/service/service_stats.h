@@ -0,0 +1,44 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * Call counts and latency histograms of the commands of the HLE services. Commands are keyed by
+ * interface name, so sessions that create a new interface object every time accumulate into the
+ * same counters.
+ */
+namespace Service::Stats {
+
+/// Counters of a single command. Recording is thread safe.
+struct CommandCounters {
+    /// Histogram buckets, bucket i counts calls that took less than 2^i microseconds and the last
+    /// bucket counts every slower call
+    static constexpr std::size_t NumBuckets = 16;
+
+    void Record(std::chrono::nanoseconds latency);
+
+    std::atomic<u64> calls{};
+    std::atomic<u64> total_ns{};
+    std::array<std::atomic<u64>, NumBuckets> histogram{};
+};
+
+/// Returns the counters of a command, creating them on first use. The reference stays valid.
+CommandCounters& GetCommandCounters(const std::string& service_name, u32 command_id,
+                                    const char* command_name);
+
+/// Returns a table of every command that was called, the ones with the most total time first.
+std::string GetReport();
+
+/// Clears the counters of every command.
+void Reset();
+
+} // namespace Service::Stats
@@ -2,18 +2,176 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "core/core.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/kernel/writable_event.h"
 #include "core/hle/service/sockets/bsd.h"
+#include "core/hle/service/sockets/sockets_translate.h"
 
 namespace Service::Sockets {
 
+namespace {
+
+bool IsConnectionBased(Type type) {
+    switch (type) {
+    case Type::STREAM:
+    case Type::SEQPACKET:
+        return true;
+    case Type::DGRAM:
+    case Type::RAW:
+        return false;
+    }
+    UNIMPLEMENTED_MSG("Unimplemented type={}", static_cast<u32>(type));
+    return false;
+}
+
+u64 MillisecondsToNanoseconds(u64 ms) {
+    return ms * 1000000;
+}
+
+} // Anonymous namespace
+
+void BSD::PollWork::Execute(BSD* bsd) {
+    std::tie(ret, bsd_errno) = bsd->PollImpl(write_buffer, read_buffer, nfds);
+}
+
+bool BSD::PollWork::WouldBlock() const {
+    return !is_retry && timeout != 0 && ret == 0 && bsd_errno == Errno::SUCCESS;
+}
+
+void BSD::PollWork::Response(Kernel::HLERequestContext& ctx) {
+    ctx.WriteBuffer(write_buffer);
+
+    IPC::ResponseBuilder rb{ctx, 4};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
+}
+
+void BSD::AcceptWork::Execute(BSD* bsd) {
+    std::tie(ret, bsd_errno) = bsd->AcceptImpl(fd, write_buffer);
+}
+
+bool BSD::AcceptWork::WouldBlock() const {
+    return bsd_errno == Errno::AGAIN;
+}
+
+void BSD::AcceptWork::Response(Kernel::HLERequestContext& ctx) {
+    ctx.WriteBuffer(write_buffer);
+
+    IPC::ResponseBuilder rb{ctx, 5};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
+    rb.Push(static_cast<u32>(write_buffer.size()));
+}
+
+void BSD::ConnectWork::Execute(BSD* bsd) {
+    if (!is_retry) {
+        bsd_errno = bsd->ConnectImpl(fd, addr);
+        return;
+    }
+    // The connection attempt has completed, it only remains to fetch its result
+    if (!bsd->IsFileDescriptorValid(fd)) {
+        bsd_errno = Errno::BADF;
+        return;
+    }
+    bsd_errno = Translate(bsd->file_descriptors[fd]->socket->GetPendingError());
+}
+
+bool BSD::ConnectWork::WouldBlock() const {
+    return bsd_errno == Errno::INPROGRESS;
+}
+
+void BSD::ConnectWork::Response(Kernel::HLERequestContext& ctx) {
+    IPC::ResponseBuilder rb{ctx, 4};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(bsd_errno == Errno::SUCCESS ? 0 : -1);
+    rb.PushEnum(bsd_errno);
+}
+
+void BSD::RecvWork::Execute(BSD* bsd) {
+    std::tie(ret, bsd_errno) = bsd->RecvImpl(fd, flags, message);
+}
+
+bool BSD::RecvWork::WouldBlock() const {
+    return bsd_errno == Errno::AGAIN;
+}
+
+void BSD::RecvWork::Response(Kernel::HLERequestContext& ctx) {
+    ctx.WriteBuffer(message);
+
+    IPC::ResponseBuilder rb{ctx, 4};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
+}
+
+void BSD::RecvFromWork::Execute(BSD* bsd) {
+    std::tie(ret, bsd_errno) = bsd->RecvFromImpl(fd, flags, message, addr);
+}
+
+bool BSD::RecvFromWork::WouldBlock() const {
+    return bsd_errno == Errno::AGAIN;
+}
+
+void BSD::RecvFromWork::Response(Kernel::HLERequestContext& ctx) {
+    ctx.WriteBuffer(message, 0);
+    if (!addr.empty()) {
+        ctx.WriteBuffer(addr, 1);
+    }
+
+    IPC::ResponseBuilder rb{ctx, 5};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
+    rb.Push<u32>(static_cast<u32>(addr.size()));
+}
+
+void BSD::SendWork::Execute(BSD* bsd) {
+    std::tie(ret, bsd_errno) = bsd->SendImpl(fd, flags, message);
+}
+
+bool BSD::SendWork::WouldBlock() const {
+    return bsd_errno == Errno::AGAIN;
+}
+
+void BSD::SendWork::Response(Kernel::HLERequestContext& ctx) {
+    IPC::ResponseBuilder rb{ctx, 4};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
+}
+
+void BSD::SendToWork::Execute(BSD* bsd) {
+    std::tie(ret, bsd_errno) = bsd->SendToImpl(fd, flags, message, addr);
+}
+
+bool BSD::SendToWork::WouldBlock() const {
+    return bsd_errno == Errno::AGAIN;
+}
+
+void BSD::SendToWork::Response(Kernel::HLERequestContext& ctx) {
+    IPC::ResponseBuilder rb{ctx, 4};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
+}
+
 void BSD::RegisterClient(Kernel::HLERequestContext& ctx) {
     LOG_WARNING(Service, "(STUBBED) called");
 
     IPC::ResponseBuilder rb{ctx, 3};
 
     rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // bsd errno
+    rb.Push<s32>(0); // bsd errno
 }
 
 void BSD::StartMonitoring(Kernel::HLERequestContext& ctx) {
@@ -26,20 +184,19 @@ void BSD::StartMonitoring(Kernel::HLERequestContext& ctx) {
 
 void BSD::Socket(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp{ctx};
+    const u32 domain = rp.Pop<u32>();
+    const u32 type = rp.Pop<u32>();
+    const u32 protocol = rp.Pop<u32>();
 
-    u32 domain = rp.Pop<u32>();
-    u32 type = rp.Pop<u32>();
-    u32 protocol = rp.Pop<u32>();
-
-    LOG_WARNING(Service, "(STUBBED) called domain={} type={} protocol={}", domain, type, protocol);
+    LOG_DEBUG(Service, "called. domain={} type={} protocol={}", domain, type, protocol);
 
-    u32 fd = next_fd++;
+    const auto [fd, bsd_errno] = SocketImpl(static_cast<Domain>(domain), static_cast<Type>(type),
+                                            static_cast<Protocol>(protocol));
 
     IPC::ResponseBuilder rb{ctx, 4};
-
     rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(fd);
-    rb.Push<u32>(0); // bsd errno
+    rb.Push<s32>(fd);
+    rb.PushEnum(bsd_errno);
 }
 
 void BSD::Select(Kernel::HLERequestContext& ctx) {
@@ -52,67 +209,659 @@ void BSD::Select(Kernel::HLERequestContext& ctx) {
     rb.Push<u32>(0); // bsd errno
 }
 
+void BSD::Poll(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 nfds = rp.Pop<s32>();
+    const s32 timeout = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. nfds={} timeout={}", nfds, timeout);
+
+    PollWork work{nfds, timeout, ctx.ReadBuffer(), std::vector<u8>(ctx.GetWriteBufferSize())};
+
+    // Wait for every valid socket of the request, a ready one wakes the guest up for a new poll
+    std::vector<PollWorker::WatchedSocket> watched;
+    if (timeout != 0 && nfds > 0 &&
+        work.read_buffer.size() >= static_cast<std::size_t>(nfds) * sizeof(PollFD)) {
+        for (s32 i = 0; i < nfds; ++i) {
+            PollFD pollfd;
+            std::memcpy(&pollfd, work.read_buffer.data() + i * sizeof(PollFD), sizeof(pollfd));
+            if (IsFileDescriptorValid(pollfd.fd)) {
+                watched.push_back({file_descriptors[pollfd.fd]->socket, pollfd.events});
+            }
+        }
+    }
+    const u64 wait_timeout = timeout < 0 ? 0 : MillisecondsToNanoseconds(timeout);
+    ExecuteWork(ctx, "BSD:Poll", std::move(watched), wait_timeout, std::move(work));
+}
+
+void BSD::Accept(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={}", fd);
+
+    ExecuteWork(ctx, "BSD:Accept", WatchIfBlocking(fd, 0, Network::PollEvents::In), 0,
+                AcceptWork{fd, std::vector<u8>(ctx.GetWriteBufferSize())});
+}
+
 void BSD::Bind(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called. fd={} addrlen={}", fd, ctx.GetReadBufferSize());
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    BuildErrnoResponse(ctx, BindImpl(fd, ctx.ReadBuffer()));
 }
 
 void BSD::Connect(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called. fd={} addrlen={}", fd, ctx.GetReadBufferSize());
+
+    // Waits forever, a connection which can't be established fails by itself
+    ExecuteWork(ctx, "BSD:Connect", WatchIfBlocking(fd, 0, Network::PollEvents::Out), 0,
+                ConnectWork{fd, ctx.ReadBuffer()});
+}
+
+void BSD::GetPeerName(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={}", fd);
+
+    std::vector<u8> write_buffer(ctx.GetWriteBufferSize());
+    const Errno bsd_errno = GetPeerNameImpl(fd, write_buffer);
+
+    ctx.WriteBuffer(write_buffer);
 
+    IPC::ResponseBuilder rb{ctx, 5};
     rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    rb.Push<s32>(bsd_errno != Errno::SUCCESS ? -1 : 0);
+    rb.PushEnum(bsd_errno);
+    rb.Push<u32>(static_cast<u32>(write_buffer.size()));
+}
+
+void BSD::GetSockName(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={}", fd);
+
+    std::vector<u8> write_buffer(ctx.GetWriteBufferSize());
+    const Errno bsd_errno = GetSockNameImpl(fd, write_buffer);
+
+    ctx.WriteBuffer(write_buffer);
+
+    IPC::ResponseBuilder rb{ctx, 5};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(bsd_errno != Errno::SUCCESS ? -1 : 0);
+    rb.PushEnum(bsd_errno);
+    rb.Push<u32>(static_cast<u32>(write_buffer.size()));
+}
+
+void BSD::GetSockOpt(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 level = rp.Pop<u32>();
+    const auto optname = static_cast<OptName>(rp.Pop<u32>());
+
+    LOG_DEBUG(Service, "called. fd={} level={} optname=0x{:x}", fd, level,
+              static_cast<u32>(optname));
+
+    std::vector<u8> optval(ctx.GetWriteBufferSize());
+    Errno bsd_errno = Errno::SUCCESS;
+    if (!IsFileDescriptorValid(fd)) {
+        bsd_errno = Errno::BADF;
+    } else if (static_cast<OptLevel>(level) == OptLevel::SOCKET && optname == OptName::ERR &&
+               optval.size() >= sizeof(u32)) {
+        const Errno pending = Translate(file_descriptors[fd]->socket->GetPendingError());
+        std::memcpy(optval.data(), &pending, sizeof(pending));
+        optval.resize(sizeof(pending));
+    } else {
+        LOG_WARNING(Service, "(STUBBED) Unimplemented level={} optname=0x{:x}", level,
+                    static_cast<u32>(optname));
+    }
+
+    ctx.WriteBuffer(optval);
+
+    IPC::ResponseBuilder rb{ctx, 5};
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<s32>(bsd_errno == Errno::SUCCESS ? 0 : -1);
+    rb.PushEnum(bsd_errno);
+    rb.Push<u32>(static_cast<u32>(optval.size()));
 }
 
 void BSD::Listen(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const s32 backlog = rp.Pop<s32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called. fd={} backlog={}", fd, backlog);
 
+    BuildErrnoResponse(ctx, ListenImpl(fd, backlog));
+}
+
+void BSD::Fcntl(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const s32 cmd = rp.Pop<s32>();
+    const s32 arg = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={} cmd={} arg={}", fd, cmd, arg);
+
+    const auto [ret, bsd_errno] = FcntlImpl(fd, static_cast<FcntlCmd>(cmd), arg);
+
+    IPC::ResponseBuilder rb{ctx, 4};
     rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    rb.Push<s32>(ret);
+    rb.PushEnum(bsd_errno);
 }
 
 void BSD::SetSockOpt(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 level = rp.Pop<u32>();
+    const auto optname = static_cast<OptName>(rp.Pop<u32>());
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    const std::vector<u8> optval = ctx.ReadBuffer();
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    LOG_DEBUG(Service, "called. fd={} level={} optname=0x{:x} optlen={}", fd, level,
+              static_cast<u32>(optname), optval.size());
+
+    BuildErrnoResponse(ctx, SetSockOptImpl(fd, level, optname, optval));
+}
+
+void BSD::Shutdown(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const s32 how = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={} how={}", fd, how);
+
+    BuildErrnoResponse(ctx, ShutdownImpl(fd, how));
+}
+
+void BSD::Read(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={} len={}", fd, ctx.GetWriteBufferSize());
+
+    const u64 timeout = IsFileDescriptorValid(fd) ? file_descriptors[fd]->recv_timeout : 0;
+    ExecuteWork(ctx, "BSD:Read", WatchIfBlocking(fd, 0, Network::PollEvents::In), timeout,
+                RecvWork{fd, 0, std::vector<u8>(ctx.GetWriteBufferSize())});
+}
+
+void BSD::Write(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={} len={}", fd, ctx.GetReadBufferSize());
+
+    const u64 timeout = IsFileDescriptorValid(fd) ? file_descriptors[fd]->send_timeout : 0;
+    ExecuteWork(ctx, "BSD:Write", WatchIfBlocking(fd, 0, Network::PollEvents::Out), timeout,
+                SendWork{fd, 0, ctx.ReadBuffer()});
+}
+
+void BSD::Recv(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
+
+    LOG_DEBUG(Service, "called. fd={} flags=0x{:x} len={}", fd, flags, ctx.GetWriteBufferSize());
+
+    const u64 timeout = IsFileDescriptorValid(fd) ? file_descriptors[fd]->recv_timeout : 0;
+    ExecuteWork(ctx, "BSD:Recv", WatchIfBlocking(fd, flags, Network::PollEvents::In), timeout,
+                RecvWork{fd, flags, std::vector<u8>(ctx.GetWriteBufferSize())});
+}
+
+void BSD::RecvFrom(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
+
+    LOG_DEBUG(Service, "called. fd={} flags=0x{:x} len={} addrlen={}", fd, flags,
+              ctx.GetWriteBufferSize(0), ctx.GetWriteBufferSize(1));
+
+    const u64 timeout = IsFileDescriptorValid(fd) ? file_descriptors[fd]->recv_timeout : 0;
+    ExecuteWork(ctx, "BSD:RecvFrom", WatchIfBlocking(fd, flags, Network::PollEvents::In),
+                timeout,
+                RecvFromWork{fd, flags, std::vector<u8>(ctx.GetWriteBufferSize(0)),
+                             std::vector<u8>(ctx.GetWriteBufferSize(1))});
+}
+
+void BSD::Send(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
+
+    LOG_DEBUG(Service, "called. fd={} flags=0x{:x} len={}", fd, flags, ctx.GetReadBufferSize());
+
+    const u64 timeout = IsFileDescriptorValid(fd) ? file_descriptors[fd]->send_timeout : 0;
+    ExecuteWork(ctx, "BSD:Send", WatchIfBlocking(fd, flags, Network::PollEvents::Out), timeout,
+                SendWork{fd, flags, ctx.ReadBuffer()});
 }
 
 void BSD::SendTo(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+    const u32 flags = rp.Pop<u32>();
 
-    IPC::ResponseBuilder rb{ctx, 4};
+    LOG_DEBUG(Service, "called. fd={} flags=0x{:x} len={} addrlen={}", fd, flags,
+              ctx.GetReadBufferSize(0), ctx.GetReadBufferSize(1));
 
-    rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    const u64 timeout = IsFileDescriptorValid(fd) ? file_descriptors[fd]->send_timeout : 0;
+    ExecuteWork(ctx, "BSD:SendTo", WatchIfBlocking(fd, flags, Network::PollEvents::Out), timeout,
+                SendToWork{fd, flags, ctx.ReadBuffer(0), ctx.ReadBuffer(1)});
 }
 
 void BSD::Close(Kernel::HLERequestContext& ctx) {
-    LOG_WARNING(Service, "(STUBBED) called");
+    IPC::RequestParser rp{ctx};
+    const s32 fd = rp.Pop<s32>();
+
+    LOG_DEBUG(Service, "called. fd={}", fd);
+
+    BuildErrnoResponse(ctx, CloseImpl(fd));
+}
+
+template <typename Work>
+void BSD::ExecuteWork(Kernel::HLERequestContext& ctx, std::string_view sleep_reason,
+                      std::vector<PollWorker::WatchedSocket> watched, u64 timeout, Work work) {
+    work.Execute(this);
+    if (watched.empty() || !work.WouldBlock()) {
+        work.Response(ctx);
+        return;
+    }
+
+    // The event is only signaled through the poll worker, the guest thread sleeps on it while
+    // the emu thread keeps running
+    const std::string reason{sleep_reason};
+    const auto event = Kernel::WritableEvent::CreateEventPair(system.Kernel(), reason).writable;
+    const u64 watch_id = poll_worker.Watch(std::move(watched), event);
+    ctx.SleepClientThread(
+        reason, timeout,
+        [this, watch_id, work = std::move(work)](std::shared_ptr<Kernel::Thread> thread,
+                                                 Kernel::HLERequestContext& ctx,
+                                                 Kernel::ThreadWakeupReason reason) mutable {
+            poll_worker.Unwatch(watch_id);
+            work.is_retry = true;
+            work.Execute(this);
+            work.Response(ctx);
+        },
+        event);
+}
+
+std::pair<s32, Errno> BSD::SocketImpl(Domain domain, Type type, Protocol protocol) {
+    if (domain != Domain::INET) {
+        LOG_ERROR(Service, "Unimplemented domain={}", static_cast<u32>(domain));
+        return {-1, Errno::INVAL};
+    }
+
+    u32 flags = 0;
+    if ((static_cast<u32>(type) & TYPE_FLAG_NONBLOCK) != 0) {
+        flags |= FLAG_O_NONBLOCK;
+        type = static_cast<Type>(static_cast<u32>(type) & ~TYPE_FLAG_NONBLOCK);
+    }
+
+    const s32 fd = FindFreeFileDescriptorHandle();
+    if (fd < 0) {
+        LOG_ERROR(Service, "No more file descriptors available");
+        return {-1, Errno::MFILE};
+    }
+
+    auto socket = std::make_shared<Network::Socket>();
+    const Errno bsd_errno = Translate(
+        socket->Initialize(Translate(domain), Translate(type), Translate(type, protocol)));
+    if (bsd_errno != Errno::SUCCESS) {
+        return {-1, bsd_errno};
+    }
+
+    FileDescriptor& descriptor = file_descriptors[fd].emplace();
+    descriptor.socket = std::move(socket);
+    descriptor.flags = flags;
+    descriptor.is_connection_based = IsConnectionBased(type);
+    return {fd, Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> BSD::PollImpl(std::vector<u8>& write_buffer, std::vector<u8> read_buffer,
+                                    s32 nfds) {
+    if (nfds < 0 || write_buffer.size() < static_cast<std::size_t>(nfds) * sizeof(PollFD) ||
+        read_buffer.size() < static_cast<std::size_t>(nfds) * sizeof(PollFD)) {
+        return {-1, Errno::INVAL};
+    }
+    if (nfds == 0) {
+        return {0, Errno::SUCCESS};
+    }
+
+    std::vector<PollFD> fds(nfds);
+    std::memcpy(fds.data(), read_buffer.data(), nfds * sizeof(PollFD));
+
+    // Negative descriptors are ignored, like on POSIX, and closed ones are reported as invalid
+    std::vector<Network::PollFD> host_pollfds;
+    std::vector<std::size_t> host_indices;
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+        PollFD& pollfd = fds[i];
+        pollfd.revents = 0;
+        if (pollfd.fd < 0) {
+            continue;
+        }
+        if (!IsFileDescriptorValid(pollfd.fd)) {
+            pollfd.revents = Network::PollEvents::Nval;
+            continue;
+        }
+        host_pollfds.push_back({file_descriptors[pollfd.fd]->socket.get(), pollfd.events, 0});
+        host_indices.push_back(i);
+    }
+
+    // The host is never asked to wait, a request that has to is put to sleep by ExecuteWork
+    if (!host_pollfds.empty()) {
+        const auto [result, bsd_errno] = Network::Poll(host_pollfds, 0);
+        if (bsd_errno != Network::Errno::SUCCESS) {
+            return {-1, Translate(bsd_errno)};
+        }
+        for (std::size_t i = 0; i < host_pollfds.size(); ++i) {
+            fds[host_indices[i]].revents = host_pollfds[i].revents;
+        }
+    }
+
+    std::memcpy(write_buffer.data(), fds.data(), nfds * sizeof(PollFD));
+    const auto num = std::count_if(fds.begin(), fds.end(),
+                                   [](const PollFD& pollfd) { return pollfd.revents != 0; });
+    return {static_cast<s32>(num), Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> BSD::AcceptImpl(s32 fd, std::vector<u8>& write_buffer) {
+    if (!IsFileDescriptorValid(fd)) {
+        return {-1, Errno::BADF};
+    }
+
+    const s32 new_fd = FindFreeFileDescriptorHandle();
+    if (new_fd < 0) {
+        LOG_ERROR(Service, "No more file descriptors available");
+        return {-1, Errno::MFILE};
+    }
+
+    FileDescriptor& descriptor = *file_descriptors[fd];
+    auto [result, bsd_errno] = descriptor.socket->Accept();
+    if (bsd_errno != Network::Errno::SUCCESS) {
+        return {-1, Translate(bsd_errno)};
+    }
+
+    FileDescriptor& new_descriptor = file_descriptors[new_fd].emplace();
+    new_descriptor.socket = std::move(result.socket);
+    new_descriptor.is_connection_based = descriptor.is_connection_based;
+
+    const SockAddrIn guest_addr_in = Translate(result.sockaddr_in);
+    const std::size_t length = std::min(sizeof(guest_addr_in), write_buffer.size());
+    std::memcpy(write_buffer.data(), &guest_addr_in, length);
+    write_buffer.resize(length);
+
+    return {new_fd, Errno::SUCCESS};
+}
+
+Errno BSD::BindImpl(s32 fd, const std::vector<u8>& addr) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+    if (addr.size() < sizeof(SockAddrIn)) {
+        return Errno::INVAL;
+    }
+
+    SockAddrIn addr_in;
+    std::memcpy(&addr_in, addr.data(), sizeof(addr_in));
+    return Translate(file_descriptors[fd]->socket->Bind(Translate(addr_in)));
+}
+
+Errno BSD::ConnectImpl(s32 fd, const std::vector<u8>& addr) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+    if (addr.size() < sizeof(SockAddrIn)) {
+        return Errno::INVAL;
+    }
+
+    SockAddrIn addr_in;
+    std::memcpy(&addr_in, addr.data(), sizeof(addr_in));
+    return Translate(file_descriptors[fd]->socket->Connect(Translate(addr_in)));
+}
+
+Errno BSD::GetPeerNameImpl(s32 fd, std::vector<u8>& write_buffer) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+
+    const auto [addr_in, bsd_errno] = file_descriptors[fd]->socket->GetPeerName();
+    if (bsd_errno != Network::Errno::SUCCESS) {
+        return Translate(bsd_errno);
+    }
+    const SockAddrIn guest_addr_in = Translate(addr_in);
+    const std::size_t length = std::min(sizeof(guest_addr_in), write_buffer.size());
+    std::memcpy(write_buffer.data(), &guest_addr_in, length);
+    write_buffer.resize(length);
+    return Errno::SUCCESS;
+}
+
+Errno BSD::GetSockNameImpl(s32 fd, std::vector<u8>& write_buffer) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+
+    const auto [addr_in, bsd_errno] = file_descriptors[fd]->socket->GetSockName();
+    if (bsd_errno != Network::Errno::SUCCESS) {
+        return Translate(bsd_errno);
+    }
+    const SockAddrIn guest_addr_in = Translate(addr_in);
+    const std::size_t length = std::min(sizeof(guest_addr_in), write_buffer.size());
+    std::memcpy(write_buffer.data(), &guest_addr_in, length);
+    write_buffer.resize(length);
+    return Errno::SUCCESS;
+}
+
+Errno BSD::ListenImpl(s32 fd, s32 backlog) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+    return Translate(file_descriptors[fd]->socket->Listen(backlog));
+}
+
+std::pair<s32, Errno> BSD::FcntlImpl(s32 fd, FcntlCmd cmd, s32 arg) {
+    if (!IsFileDescriptorValid(fd)) {
+        return {-1, Errno::BADF};
+    }
+
+    // Host sockets are always non-blocking, the flag only changes how requests are emulated
+    FileDescriptor& descriptor = *file_descriptors[fd];
+    switch (cmd) {
+    case FcntlCmd::GETFL:
+        ASSERT(arg == 0);
+        return {static_cast<s32>(descriptor.flags), Errno::SUCCESS};
+    case FcntlCmd::SETFL:
+        descriptor.flags = static_cast<u32>(arg);
+        return {0, Errno::SUCCESS};
+    }
+    UNIMPLEMENTED_MSG("Unimplemented cmd={}", static_cast<s32>(cmd));
+    return {-1, Errno::SUCCESS};
+}
+
+Errno BSD::SetSockOptImpl(s32 fd, u32 level, OptName optname, const std::vector<u8>& optval) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+
+    FileDescriptor& descriptor = *file_descriptors[fd];
+    Network::Socket* const socket = descriptor.socket.get();
+
+    if (static_cast<OptLevel>(level) == OptLevel::TCP) {
+        if (static_cast<u32>(optname) != TCP_OPT_NODELAY || optval.size() < sizeof(u32)) {
+            UNIMPLEMENTED_MSG("Unimplemented TCP optname=0x{:x}", static_cast<u32>(optname));
+            return Errno::SUCCESS;
+        }
+        u32 value;
+        std::memcpy(&value, optval.data(), sizeof(value));
+        return Translate(socket->SetNoDelay(value != 0));
+    }
+    if (static_cast<OptLevel>(level) != OptLevel::SOCKET) {
+        UNIMPLEMENTED_MSG("Unimplemented level={}", level);
+        return Errno::SUCCESS;
+    }
+
+    if (optname == OptName::LINGER) {
+        if (optval.size() < sizeof(Linger)) {
+            return Errno::INVAL;
+        }
+        Linger linger;
+        std::memcpy(&linger, optval.data(), sizeof(linger));
+        ASSERT(linger.onoff == 0 || linger.onoff == 1);
+        return Translate(socket->SetLinger(linger.onoff != 0, linger.linger));
+    }
+
+    if (optval.size() < sizeof(u32)) {
+        return Errno::INVAL;
+    }
+    u32 value;
+    std::memcpy(&value, optval.data(), sizeof(value));
+
+    switch (optname) {
+    case OptName::REUSEADDR:
+        ASSERT(value == 0 || value == 1);
+        return Translate(socket->SetReuseAddr(value != 0));
+    case OptName::KEEPALIVE:
+        ASSERT(value == 0 || value == 1);
+        return Translate(socket->SetKeepAlive(value != 0));
+    case OptName::BROADCAST:
+        ASSERT(value == 0 || value == 1);
+        return Translate(socket->SetBroadcast(value != 0));
+    case OptName::SNDBUF:
+        return Translate(socket->SetSndBuf(value));
+    case OptName::RCVBUF:
+        return Translate(socket->SetRcvBuf(value));
+    case OptName::SNDTIMEO:
+        // Timeouts are emulated along with blocking, the guest passes them in milliseconds
+        descriptor.send_timeout = MillisecondsToNanoseconds(value);
+        return Errno::SUCCESS;
+    case OptName::RCVTIMEO:
+        descriptor.recv_timeout = MillisecondsToNanoseconds(value);
+        return Errno::SUCCESS;
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented optname=0x{:x}", static_cast<u32>(optname));
+        return Errno::SUCCESS;
+    }
+}
+
+Errno BSD::ShutdownImpl(s32 fd, s32 how) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+    const auto host_how = Translate(static_cast<ShutdownHow>(how));
+    return Translate(file_descriptors[fd]->socket->Shutdown(host_how));
+}
+
+std::pair<s32, Errno> BSD::RecvImpl(s32 fd, u32 flags, std::vector<u8>& message) {
+    if (!IsFileDescriptorValid(fd)) {
+        return {-1, Errno::BADF};
+    }
+    return Translate(file_descriptors[fd]->socket->Recv(flags & ~FLAG_MSG_DONTWAIT, message));
+}
+
+std::pair<s32, Errno> BSD::RecvFromImpl(s32 fd, u32 flags, std::vector<u8>& message,
+                                        std::vector<u8>& addr) {
+    if (!IsFileDescriptorValid(fd)) {
+        return {-1, Errno::BADF};
+    }
+
+    const FileDescriptor& descriptor = *file_descriptors[fd];
+    flags &= ~FLAG_MSG_DONTWAIT;
+
+    // Connection based sockets are receiving from their peer, they never report an address
+    if (descriptor.is_connection_based || addr.empty()) {
+        addr.clear();
+        return Translate(descriptor.socket->RecvFrom(flags, message, nullptr));
+    }
+
+    Network::SockAddrIn addr_in{};
+    const auto [ret, bsd_errno] = descriptor.socket->RecvFrom(flags, message, &addr_in);
+    if (bsd_errno != Network::Errno::SUCCESS) {
+        addr.clear();
+        return {ret, Translate(bsd_errno)};
+    }
+    const SockAddrIn guest_addr_in = Translate(addr_in);
+    const std::size_t length = std::min(sizeof(guest_addr_in), addr.size());
+    std::memcpy(addr.data(), &guest_addr_in, length);
+    addr.resize(length);
+    return {ret, Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> BSD::SendImpl(s32 fd, u32 flags, const std::vector<u8>& message) {
+    if (!IsFileDescriptorValid(fd)) {
+        return {-1, Errno::BADF};
+    }
+    return Translate(file_descriptors[fd]->socket->Send(message, flags & ~FLAG_MSG_DONTWAIT));
+}
 
+std::pair<s32, Errno> BSD::SendToImpl(s32 fd, u32 flags, const std::vector<u8>& message,
+                                      const std::vector<u8>& addr) {
+    if (!IsFileDescriptorValid(fd)) {
+        return {-1, Errno::BADF};
+    }
+
+    flags &= ~FLAG_MSG_DONTWAIT;
+    Network::Socket* const socket = file_descriptors[fd]->socket.get();
+    if (addr.size() < sizeof(SockAddrIn)) {
+        return Translate(socket->SendTo(flags, message, nullptr));
+    }
+
+    SockAddrIn guest_addr_in;
+    std::memcpy(&guest_addr_in, addr.data(), sizeof(guest_addr_in));
+    const Network::SockAddrIn addr_in = Translate(guest_addr_in);
+    return Translate(socket->SendTo(flags, message, &addr_in));
+}
+
+Errno BSD::CloseImpl(s32 fd) {
+    if (!IsFileDescriptorValid(fd)) {
+        return Errno::BADF;
+    }
+
+    // The host socket is closed once the poll worker no longer references it either
+    file_descriptors[fd].reset();
+    return Errno::SUCCESS;
+}
+
+s32 BSD::FindFreeFileDescriptorHandle() const {
+    for (s32 fd = 0; fd < static_cast<s32>(file_descriptors.size()); ++fd) {
+        if (!file_descriptors[fd]) {
+            return fd;
+        }
+    }
+    return -1;
+}
+
+bool BSD::IsFileDescriptorValid(s32 fd) const {
+    if (fd < 0 || fd >= static_cast<s32>(MAX_FD) || !file_descriptors[fd]) {
+        LOG_ERROR(Service, "Invalid file descriptor handle={}", fd);
+        return false;
+    }
+    return true;
+}
+
+std::vector<PollWorker::WatchedSocket> BSD::WatchIfBlocking(s32 fd, u32 flags, u16 events) const {
+    if (!IsFileDescriptorValid(fd) || (flags & FLAG_MSG_DONTWAIT) != 0 ||
+        (file_descriptors[fd]->flags & FLAG_O_NONBLOCK) != 0) {
+        return {};
+    }
+    return {{file_descriptors[fd]->socket, events}};
+}
+
+void BSD::BuildErrnoResponse(Kernel::HLERequestContext& ctx, Errno bsd_errno) const {
     IPC::ResponseBuilder rb{ctx, 4};
 
     rb.Push(RESULT_SUCCESS);
-    rb.Push<u32>(0); // ret
-    rb.Push<u32>(0); // bsd errno
+    rb.Push<s32>(bsd_errno == Errno::SUCCESS ? 0 : -1);
+    rb.PushEnum(bsd_errno);
 }
 
-BSD::BSD(const char* name) : ServiceFramework(name) {
+BSD::BSD(Core::System& system, const char* name)
+    : ServiceFramework(name), system{system}, poll_worker{system} {
     // clang-format off
     static const FunctionInfo functions[] = {
         {0, &BSD::RegisterClient, "RegisterClient"},
@@ -121,26 +870,26 @@ BSD::BSD(const char* name) : ServiceFramework(name) {
         {3, nullptr, "SocketExempt"},
         {4, nullptr, "Open"},
         {5, &BSD::Select, "Select"},
-        {6, nullptr, "Poll"},
+        {6, &BSD::Poll, "Poll"},
         {7, nullptr, "Sysctl"},
-        {8, nullptr, "Recv"},
-        {9, nullptr, "RecvFrom"},
-        {10, nullptr, "Send"},
+        {8, &BSD::Recv, "Recv"},
+        {9, &BSD::RecvFrom, "RecvFrom"},
+        {10, &BSD::Send, "Send"},
         {11, &BSD::SendTo, "SendTo"},
-        {12, nullptr, "Accept"},
+        {12, &BSD::Accept, "Accept"},
         {13, &BSD::Bind, "Bind"},
         {14, &BSD::Connect, "Connect"},
-        {15, nullptr, "GetPeerName"},
-        {16, nullptr, "GetSockName"},
-        {17, nullptr, "GetSockOpt"},
+        {15, &BSD::GetPeerName, "GetPeerName"},
+        {16, &BSD::GetSockName, "GetSockName"},
+        {17, &BSD::GetSockOpt, "GetSockOpt"},
         {18, &BSD::Listen, "Listen"},
         {19, nullptr, "Ioctl"},
-        {20, nullptr, "Fcntl"},
+        {20, &BSD::Fcntl, "Fcntl"},
         {21, &BSD::SetSockOpt, "SetSockOpt"},
-        {22, nullptr, "Shutdown"},
+        {22, &BSD::Shutdown, "Shutdown"},
         {23, nullptr, "ShutdownAllSockets"},
-        {24, nullptr, "Write"},
-        {25, nullptr, "Read"},
+        {24, &BSD::Write, "Write"},
+        {25, &BSD::Read, "Read"},
         {26, &BSD::Close, "Close"},
         {27, nullptr, "DuplicateSocket"},
         {28, nullptr, "GetResourceStatistics"},
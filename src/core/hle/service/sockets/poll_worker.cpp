@@ -0,0 +1,160 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/writable_event.h"
+#include "core/hle/service/sockets/poll_worker.h"
+
+namespace Service::Sockets {
+
+namespace {
+
+/// Poll timeout used when the loopback wakeup socket couldn't be created, in milliseconds
+constexpr s32 FALLBACK_POLL_TIMEOUT = 10;
+
+} // Anonymous namespace
+
+PollWorker::PollWorker(Core::System& system) : system{system} {
+    ready_event = Core::Timing::CreateEvent(
+        "BSD::PollWorker", [this](u64 id, s64) { SignalReady(id); });
+
+    // A datagram socket connected to itself, so sending to it makes it readable
+    bool wakeup_ready = wakeup_socket.Initialize(Network::Domain::INET, Network::Type::DGRAM,
+                                                 Network::Protocol::UDP) == Network::Errno::SUCCESS;
+    if (wakeup_ready) {
+        const Network::SockAddrIn loopback{Network::Domain::INET, {127, 0, 0, 1}, 0};
+        wakeup_ready = wakeup_socket.Bind(loopback) == Network::Errno::SUCCESS;
+    }
+    if (wakeup_ready) {
+        const auto [addr, bsd_errno] = wakeup_socket.GetSockName();
+        wakeup_ready = bsd_errno == Network::Errno::SUCCESS &&
+                       wakeup_socket.Connect(addr) == Network::Errno::SUCCESS;
+    }
+    if (!wakeup_ready) {
+        LOG_ERROR(Service, "Failed to create the wakeup socket, polling every {} ms instead",
+                  FALLBACK_POLL_TIMEOUT);
+        if (wakeup_socket.IsOpened()) {
+            wakeup_socket.Close();
+        }
+    }
+
+    thread = std::thread([this] { ThreadLoop(); });
+}
+
+PollWorker::~PollWorker() {
+    stop_requested = true;
+    Interrupt();
+    thread.join();
+    system.CoreTiming().RemoveEvent(ready_event);
+}
+
+u64 PollWorker::Watch(std::vector<WatchedSocket> sockets,
+                      std::shared_ptr<Kernel::WritableEvent> event) {
+    u64 id;
+    {
+        std::lock_guard lock{mutex};
+        id = next_id++;
+        watches.emplace(id, WatchEntry{std::move(sockets), std::move(event)});
+    }
+    Interrupt();
+    return id;
+}
+
+void PollWorker::Unwatch(u64 id) {
+    // A watch removed while the worker polls its sockets is dropped on its next iteration
+    std::lock_guard lock{mutex};
+    watches.erase(id);
+    ready_watches.erase(id);
+}
+
+void PollWorker::ThreadLoop() {
+    Common::SetCurrentThreadName("yuzu:BSDPollWorker");
+
+    std::vector<Network::PollFD> poll_fds;
+    std::vector<u64> owners;
+    // Keeps every polled socket open, even if its watch is removed in the meantime
+    std::vector<std::shared_ptr<Network::Socket>> polled_sockets;
+    std::vector<u8> wakeup_data;
+
+    const bool has_wakeup = wakeup_socket.IsOpened();
+    const std::size_t first_watched = has_wakeup ? 1 : 0;
+    while (!stop_requested) {
+        poll_fds.clear();
+        owners.clear();
+        polled_sockets.clear();
+        if (has_wakeup) {
+            poll_fds.push_back({&wakeup_socket, Network::PollEvents::In, 0});
+        }
+        {
+            std::lock_guard lock{mutex};
+            for (const auto& [id, watch] : watches) {
+                for (const WatchedSocket& watched : watch.sockets) {
+                    poll_fds.push_back({watched.socket.get(), watched.events, 0});
+                    owners.push_back(id);
+                    polled_sockets.push_back(watched.socket);
+                }
+            }
+        }
+
+        if (poll_fds.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FALLBACK_POLL_TIMEOUT));
+            continue;
+        }
+        const s32 timeout = has_wakeup ? -1 : FALLBACK_POLL_TIMEOUT;
+        if (Network::Poll(poll_fds, timeout).second != Network::Errno::SUCCESS) {
+            // Don't spin on a persistent error
+            std::this_thread::sleep_for(std::chrono::milliseconds(FALLBACK_POLL_TIMEOUT));
+            continue;
+        }
+
+        if (has_wakeup && poll_fds[0].revents != 0) {
+            do {
+                wakeup_data.resize(64);
+            } while (wakeup_socket.Recv(0, wakeup_data).second == Network::Errno::SUCCESS);
+        }
+
+        std::lock_guard lock{mutex};
+        for (std::size_t i = first_watched; i < poll_fds.size(); ++i) {
+            if (poll_fds[i].revents == 0) {
+                continue;
+            }
+            const u64 id = owners[i - first_watched];
+            const auto it = watches.find(id);
+            if (it == watches.end()) {
+                continue;
+            }
+            ready_watches.emplace(id, std::move(it->second.event));
+            watches.erase(it);
+            system.CoreTiming().ScheduleEventThreadsafe(0, ready_event, id);
+        }
+    }
+}
+
+void PollWorker::Interrupt() {
+    if (wakeup_socket.IsOpened()) {
+        wakeup_socket.Send({0}, 0);
+    }
+}
+
+void PollWorker::SignalReady(u64 id) {
+    std::shared_ptr<Kernel::WritableEvent> event;
+    {
+        std::lock_guard lock{mutex};
+        const auto it = ready_watches.find(id);
+        if (it == ready_watches.end()) {
+            // Timed out and unwatched before the worker saw its socket ready
+            return;
+        }
+        event = std::move(it->second);
+        ready_watches.erase(it);
+    }
+    event->Signal();
+}
+
+} // namespace Service::Sockets
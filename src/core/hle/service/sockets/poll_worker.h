@@ -0,0 +1,91 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/network/network.h"
+
+namespace Core {
+class System;
+}
+
+namespace Core::Timing {
+struct EventType;
+}
+
+namespace Kernel {
+class WritableEvent;
+}
+
+namespace Service::Sockets {
+
+/**
+ * Host thread waiting for events on the sockets of guest requests that would block. Once a
+ * watched socket is ready, the event of its watch is signaled from the emu thread, through core
+ * timing, so that the guest thread put to sleep with it retries its request.
+ */
+class PollWorker {
+public:
+    /// A socket and the events the guest request is waiting for
+    struct WatchedSocket {
+        std::shared_ptr<Network::Socket> socket;
+        u16 events;
+    };
+
+    explicit PollWorker(Core::System& system);
+    ~PollWorker();
+
+    PollWorker(const PollWorker&) = delete;
+    PollWorker& operator=(const PollWorker&) = delete;
+
+    /**
+     * Starts waiting for events on the given sockets.
+     * @param event Event signaled once, when any of the sockets has one of its events.
+     * @returns Identifier of the watch, to cancel it.
+     */
+    u64 Watch(std::vector<WatchedSocket> sockets, std::shared_ptr<Kernel::WritableEvent> event);
+
+    /// Stops a watch, this does nothing once its event has been signaled.
+    void Unwatch(u64 id);
+
+private:
+    struct WatchEntry {
+        std::vector<WatchedSocket> sockets;
+        std::shared_ptr<Kernel::WritableEvent> event;
+    };
+
+    void ThreadLoop();
+
+    /// Interrupts the poll of the worker thread, so it picks up a change in the watches
+    void Interrupt();
+
+    /// Signals the event of a ready watch, called from the emu thread
+    void SignalReady(u64 id);
+
+    Core::System& system;
+    Network::NetworkInstance network_instance;
+    std::shared_ptr<Core::Timing::EventType> ready_event;
+
+    /// Loopback socket the worker polls together with the watched sockets, sending a datagram to
+    /// it wakes up the worker
+    Network::Socket wakeup_socket;
+
+    std::mutex mutex;
+    std::unordered_map<u64, WatchEntry> watches;
+    std::unordered_map<u64, std::shared_ptr<Kernel::WritableEvent>> ready_watches;
+    u64 next_id = 0;
+
+    std::atomic_bool stop_requested{false};
+    std::thread thread;
+};
+
+} // namespace Service::Sockets
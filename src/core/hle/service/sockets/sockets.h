@@ -4,11 +4,113 @@
 
 #pragma once
 
+#include <array>
+
+#include "common/common_types.h"
 #include "core/hle/service/service.h"
 
+namespace Core {
+class System;
+}
+
 namespace Service::Sockets {
 
+/// Error codes returned to the guest, which uses the values of Linux
+enum class Errno : u32 {
+    SUCCESS = 0,
+    BADF = 9,
+    AGAIN = 11,
+    INVAL = 22,
+    MFILE = 24,
+    PIPE = 32,
+    MSGSIZE = 90,
+    CONNABORTED = 103,
+    CONNRESET = 104,
+    NOTCONN = 107,
+    TIMEDOUT = 110,
+    CONNREFUSED = 111,
+    INPROGRESS = 115,
+};
+
+enum class Domain : u32 {
+    INET = 2,
+};
+
+enum class Type : u32 {
+    STREAM = 1,
+    DGRAM = 2,
+    RAW = 3,
+    SEQPACKET = 5,
+};
+
+enum class Protocol : u32 {
+    UNSPECIFIED = 0,
+    ICMP = 1,
+    TCP = 6,
+    UDP = 17,
+};
+
+enum class OptName : u32 {
+    REUSEADDR = 0x4,
+    KEEPALIVE = 0x8,
+    BROADCAST = 0x20,
+    LINGER = 0x80,
+    SNDBUF = 0x1001,
+    RCVBUF = 0x1002,
+    SNDTIMEO = 0x1005,
+    RCVTIMEO = 0x1006,
+    ERR = 0x1007,
+};
+
+enum class ShutdownHow : s32 {
+    RD = 0,
+    WR = 1,
+    RDWR = 2,
+};
+
+enum class FcntlCmd : s32 {
+    GETFL = 3,
+    SETFL = 4,
+};
+
+/// Guest struct sockaddr_in, which follows the BSD layout
+struct SockAddrIn {
+    u8 len;
+    u8 family;
+    u16 portno; ///< Big endian
+    std::array<u8, 4> ip;
+    std::array<u8, 8> zeroes;
+};
+static_assert(sizeof(SockAddrIn) == 0x10, "SockAddrIn has incorrect size");
+
+struct PollFD {
+    s32 fd;
+    u16 events;
+    u16 revents;
+};
+static_assert(sizeof(PollFD) == 0x8, "PollFD has incorrect size");
+
+struct Linger {
+    u32 onoff;
+    u32 linger;
+};
+
+enum class OptLevel : u32 {
+    TCP = 6,
+    SOCKET = 0xffff,
+};
+
+/// TCP_NODELAY, the only option of OptLevel::TCP
+constexpr u32 TCP_OPT_NODELAY = 1;
+
+/// Flag of the SOCK_* types that creates a non-blocking socket
+constexpr u32 TYPE_FLAG_NONBLOCK = 0x20000000;
+
+constexpr u32 FLAG_MSG_DONTWAIT = 0x80;
+
+constexpr u32 FLAG_O_NONBLOCK = 0x800;
+
 /// Registers all Sockets services with the specified service manager.
-void InstallInterfaces(SM::ServiceManager& service_manager);
+void InstallInterfaces(SM::ServiceManager& service_manager, Core::System& system);
 
 } // namespace Service::Sockets
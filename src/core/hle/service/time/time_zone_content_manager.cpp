@@ -80,13 +80,23 @@ TimeZoneContentManager::TimeZoneContentManager(TimeManager& time_manager, Core::
 
 ResultCode TimeZoneContentManager::LoadTimeZoneRule(TimeZoneRule& rules,
                                                     const std::string& location_name) const {
+    if (const auto it{time_zone_rule_cache.find(location_name)}; it != time_zone_rule_cache.end()) {
+        rules = it->second;
+        return RESULT_SUCCESS;
+    }
+
     FileSys::VirtualFile vfs_file;
     if (const ResultCode result{GetTimeZoneInfoFile(location_name, vfs_file)};
         result != RESULT_SUCCESS) {
         return result;
     }
 
-    return time_zone_manager.ParseTimeZoneRuleBinary(rules, vfs_file);
+    if (const ResultCode result{time_zone_manager.ParseTimeZoneRuleBinary(rules, vfs_file)};
+        result != RESULT_SUCCESS) {
+        return result;
+    }
+    time_zone_rule_cache.emplace(location_name, rules);
+    return RESULT_SUCCESS;
 }
 
 bool TimeZoneContentManager::IsLocationNameValid(const std::string& location_name) const {
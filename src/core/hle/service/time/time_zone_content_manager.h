@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "core/hle/service/time/time_zone_manager.h"
@@ -41,6 +42,9 @@ private:
     Core::System& system;
     TimeZoneManager time_zone_manager;
     const std::vector<std::string> location_name_cache;
+
+    /// Rules already parsed by LoadTimeZoneRule, the time zone binary never changes while running
+    mutable std::unordered_map<std::string, TimeZoneRule> time_zone_rule_cache;
 };
 
 } // namespace Service::Time::TimeZone
@@ -747,7 +747,8 @@ static ResultCode CreateCalendarTime(s64 time, int gmt_offset, CalendarTimeInter
 
 static ResultCode ToCalendarTimeInternal(const TimeZoneRule& rules, s64 time,
                                          CalendarTimeInternal& calendar_time,
-                                         CalendarAdditionalInfo& calendar_additional_info) {
+                                         CalendarAdditionalInfo& calendar_additional_info,
+                                         s32* last_transition_index = nullptr) {
     if ((rules.go_ahead && time < rules.ats[0]) ||
         (rules.go_back && time > rules.ats[rules.time_count - 1])) {
         s64 seconds{};
@@ -770,8 +771,9 @@ static ResultCode ToCalendarTimeInternal(const TimeZoneRule& rules, s64 time,
         if (new_time < rules.ats[0] && new_time > rules.ats[rules.time_count - 1]) {
             return ERROR_TIME_NOT_FOUND;
         }
-        if (const ResultCode result{
-                ToCalendarTimeInternal(rules, new_time, calendar_time, calendar_additional_info)};
+        if (const ResultCode result{ToCalendarTimeInternal(rules, new_time, calendar_time,
+                                                           calendar_additional_info,
+                                                           last_transition_index)};
             result != RESULT_SUCCESS) {
             return result;
         }
@@ -790,6 +792,15 @@ static ResultCode ToCalendarTimeInternal(const TimeZoneRule& rules, s64 time,
     } else {
         s32 low{1};
         s32 high{rules.time_count};
+        // Clocks mostly move forward, in which case the last transition found is a lower bound
+        // and usually still the right one
+        if (last_transition_index != nullptr && *last_transition_index > 0 &&
+            *last_transition_index <= high && time >= rules.ats[*last_transition_index - 1]) {
+            low = *last_transition_index;
+            if (low == high || time < rules.ats[low]) {
+                high = low;
+            }
+        }
         while (low < high) {
             s32 mid{(low + high) >> 1};
             if (time < rules.ats[mid]) {
@@ -798,6 +809,9 @@ static ResultCode ToCalendarTimeInternal(const TimeZoneRule& rules, s64 time,
                 low = mid + 1;
             }
         }
+        if (last_transition_index != nullptr) {
+            *last_transition_index = low;
+        }
         tti_index = rules.types[low - 1];
     }
 
@@ -815,10 +829,11 @@ static ResultCode ToCalendarTimeInternal(const TimeZoneRule& rules, s64 time,
     return RESULT_SUCCESS;
 }
 
-static ResultCode ToCalendarTimeImpl(const TimeZoneRule& rules, s64 time, CalendarInfo& calendar) {
+static ResultCode ToCalendarTimeImpl(const TimeZoneRule& rules, s64 time, CalendarInfo& calendar,
+                                     s32* last_transition_index = nullptr) {
     CalendarTimeInternal calendar_time{};
-    const ResultCode result{
-        ToCalendarTimeInternal(rules, time, calendar_time, calendar.additiona_info)};
+    const ResultCode result{ToCalendarTimeInternal(rules, time, calendar_time,
+                                                   calendar.additiona_info, last_transition_index)};
     calendar.time.year = static_cast<s16>(calendar_time.year);
     calendar.time.month = calendar_time.month + 1; // Internal impl. uses 0-indexed month
     calendar.time.day = calendar_time.day;
@@ -842,6 +857,7 @@ ResultCode TimeZoneManager::SetDeviceLocationNameWithTimeZoneRule(const std::str
     if (ParseTimeZoneBinary(rule, vfs_file)) {
         device_location_name = location_name;
         time_zone_rule = rule;
+        last_transition_index = 0;
         return RESULT_SUCCESS;
     }
     return ERROR_TIME_ZONE_CONVERSION_FAILED;
@@ -854,7 +870,7 @@ ResultCode TimeZoneManager::SetUpdatedTime(const Clock::SteadyClockTimePoint& va
 
 ResultCode TimeZoneManager::ToCalendarTimeWithMyRules(s64 time, CalendarInfo& calendar) const {
     if (is_initialized) {
-        return ToCalendarTime(time_zone_rule, time, calendar);
+        return ToCalendarTimeImpl(time_zone_rule, time, calendar, &last_transition_index);
     } else {
         return ERROR_UNINITIALIZED_CLOCK;
     }
@@ -44,6 +44,8 @@ public:
 private:
     bool is_initialized{};
     TimeZoneRule time_zone_rule{};
+    /// Transition found by the last ToCalendarTimeWithMyRules, where the next search starts from
+    mutable s32 last_transition_index{};
     std::string device_location_name{"GMT"};
     u128 time_zone_rule_version{};
     std::size_t total_location_name_count{};
@@ -61,19 +61,18 @@ static_assert(sizeof(DisplayInfo) == 0x60, "DisplayInfo has wrong size");
 
 class Parcel {
 public:
-    // This default size was chosen arbitrarily.
-    static constexpr std::size_t DefaultBufferSize = 0x40;
-    Parcel() : buffer(DefaultBufferSize) {}
-    explicit Parcel(std::vector<u8> data) : buffer(std::move(data)) {}
+    Parcel() = default;
+    /// Creates a parcel reading from the given data, the data has to outlive the parcel.
+    explicit Parcel(Kernel::BufferView<const u8> data) : input(data) {}
     virtual ~Parcel() = default;
 
     template <typename T>
     T Read() {
         static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
-        ASSERT(read_index + sizeof(T) <= buffer.size());
+        ASSERT(read_index + sizeof(T) <= input.size());
 
         T val;
-        std::memcpy(&val, buffer.data() + read_index, sizeof(T));
+        std::memcpy(&val, input.data() + read_index, sizeof(T));
         read_index += sizeof(T);
         read_index = Common::AlignUp(read_index, 4);
         return val;
@@ -82,45 +81,41 @@ public:
     template <typename T>
     T ReadUnaligned() {
         static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
-        ASSERT(read_index + sizeof(T) <= buffer.size());
+        ASSERT(read_index + sizeof(T) <= input.size());
 
         T val;
-        std::memcpy(&val, buffer.data() + read_index, sizeof(T));
+        std::memcpy(&val, input.data() + read_index, sizeof(T));
         read_index += sizeof(T);
         return val;
     }
 
-    std::vector<u8> ReadBlock(std::size_t length) {
-        ASSERT(read_index + length <= buffer.size());
-        const u8* const begin = buffer.data() + read_index;
-        const u8* const end = begin + length;
-        std::vector<u8> data(begin, end);
+    Kernel::BufferView<const u8> ReadBlock(std::size_t length) {
+        ASSERT(read_index + length <= input.size());
+        const Kernel::BufferView<const u8> data{input.data() + read_index, length};
         read_index += length;
         read_index = Common::AlignUp(read_index, 4);
         return data;
     }
 
-    std::u16string ReadInterfaceToken() {
-        u32 unknown = Read<u32_le>();
-        u32 length = Read<u32_le>();
-
-        std::u16string token{};
-
-        for (u32 ch = 0; ch < length + 1; ++ch) {
-            token.push_back(ReadUnaligned<u16_le>());
-        }
+    /// Skips the interface token, nothing in the service uses its contents.
+    void SkipInterfaceToken() {
+        [[maybe_unused]] const u32 unknown = Read<u32_le>();
+        const u32 length = Read<u32_le>();
 
+        // The token is an UTF-16 string followed by a null terminator
+        read_index += (static_cast<std::size_t>(length) + 1) * sizeof(u16_le);
         read_index = Common::AlignUp(read_index, 4);
-
-        return token;
+        ASSERT(read_index <= input.size());
     }
 
     template <typename T>
     void Write(const T& val) {
         static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
 
+        // Growing the output zeroes it, so the alignment padding never holds stale data
+        std::vector<u8>& buffer = *output;
         if (buffer.size() < write_index + sizeof(T)) {
-            buffer.resize(buffer.size() + sizeof(T) + DefaultBufferSize);
+            buffer.resize(write_index + sizeof(T));
         }
 
         std::memcpy(buffer.data() + write_index, &val, sizeof(T));
@@ -140,28 +135,39 @@ public:
     }
 
     void Deserialize() {
-        ASSERT(buffer.size() > sizeof(Header));
+        ASSERT(input.size() > sizeof(Header));
 
         Header header{};
-        std::memcpy(&header, buffer.data(), sizeof(Header));
+        std::memcpy(&header, input.data(), sizeof(Header));
 
         read_index = header.data_offset;
         DeserializeData();
     }
 
-    std::vector<u8> Serialize() {
+    /// Serializes the parcel into the given buffer, reusing its storage.
+    void Serialize(std::vector<u8>& buffer) {
         ASSERT(read_index == 0);
+        buffer.clear();
+        buffer.resize(sizeof(Header));
+        output = &buffer;
         write_index = sizeof(Header);
 
         SerializeData();
+        output = nullptr;
 
         Header header{};
         header.data_size = static_cast<u32_le>(write_index - sizeof(Header));
         header.data_offset = sizeof(Header);
         header.objects_size = 4;
         header.objects_offset = sizeof(Header) + header.data_size;
+        buffer.resize(header.objects_offset + header.objects_size);
         std::memcpy(buffer.data(), &header, sizeof(Header));
+    }
 
+    std::vector<u8> Serialize() {
+        std::vector<u8> buffer;
+        buffer.reserve(DefaultBufferSize);
+        Serialize(buffer);
         return buffer;
     }
 
@@ -171,6 +177,9 @@ protected:
     virtual void DeserializeData() {}
 
 private:
+    // This default size was chosen arbitrarily.
+    static constexpr std::size_t DefaultBufferSize = 0x40;
+
     struct Header {
         u32_le data_size;
         u32_le data_offset;
@@ -179,7 +188,8 @@ private:
     };
     static_assert(sizeof(Header) == 16, "ParcelHeader has wrong size");
 
-    std::vector<u8> buffer;
+    Kernel::BufferView<const u8> input;
+    std::vector<u8>* output = nullptr;
     std::size_t read_index = 0;
     std::size_t write_index = 0;
 };
@@ -212,13 +222,13 @@ private:
 
 class IGBPConnectRequestParcel : public Parcel {
 public:
-    explicit IGBPConnectRequestParcel(std::vector<u8> buffer) : Parcel(std::move(buffer)) {
+    explicit IGBPConnectRequestParcel(Kernel::BufferView<const u8> buffer) : Parcel(buffer) {
         Deserialize();
     }
     ~IGBPConnectRequestParcel() override = default;
 
     void DeserializeData() override {
-        std::u16string token = ReadInterfaceToken();
+        SkipInterfaceToken();
         data = Read<Data>();
     }
 
@@ -275,14 +285,14 @@ private:
 
 class IGBPSetPreallocatedBufferRequestParcel : public Parcel {
 public:
-    explicit IGBPSetPreallocatedBufferRequestParcel(std::vector<u8> buffer)
-        : Parcel(std::move(buffer)) {
+    explicit IGBPSetPreallocatedBufferRequestParcel(Kernel::BufferView<const u8> buffer)
+        : Parcel(buffer) {
         Deserialize();
     }
     ~IGBPSetPreallocatedBufferRequestParcel() override = default;
 
     void DeserializeData() override {
-        std::u16string token = ReadInterfaceToken();
+        SkipInterfaceToken();
         data = Read<Data>();
         buffer = Read<NVFlinger::IGBPBuffer>();
     }
@@ -308,13 +318,13 @@ protected:
 
 class IGBPDequeueBufferRequestParcel : public Parcel {
 public:
-    explicit IGBPDequeueBufferRequestParcel(std::vector<u8> buffer) : Parcel(std::move(buffer)) {
+    explicit IGBPDequeueBufferRequestParcel(Kernel::BufferView<const u8> buffer) : Parcel(buffer) {
         Deserialize();
     }
     ~IGBPDequeueBufferRequestParcel() override = default;
 
     void DeserializeData() override {
-        std::u16string token = ReadInterfaceToken();
+        SkipInterfaceToken();
         data = Read<Data>();
     }
 
@@ -349,13 +359,13 @@ protected:
 
 class IGBPRequestBufferRequestParcel : public Parcel {
 public:
-    explicit IGBPRequestBufferRequestParcel(std::vector<u8> buffer) : Parcel(std::move(buffer)) {
+    explicit IGBPRequestBufferRequestParcel(Kernel::BufferView<const u8> buffer) : Parcel(buffer) {
         Deserialize();
     }
     ~IGBPRequestBufferRequestParcel() override = default;
 
     void DeserializeData() override {
-        std::u16string token = ReadInterfaceToken();
+        SkipInterfaceToken();
         slot = Read<u32_le>();
     }
 
@@ -381,13 +391,13 @@ protected:
 
 class IGBPQueueBufferRequestParcel : public Parcel {
 public:
-    explicit IGBPQueueBufferRequestParcel(std::vector<u8> buffer) : Parcel(std::move(buffer)) {
+    explicit IGBPQueueBufferRequestParcel(Kernel::BufferView<const u8> buffer) : Parcel(buffer) {
         Deserialize();
     }
     ~IGBPQueueBufferRequestParcel() override = default;
 
     void DeserializeData() override {
-        std::u16string token = ReadInterfaceToken();
+        SkipInterfaceToken();
         data = Read<Data>();
     }
 
@@ -444,13 +454,13 @@ private:
 
 class IGBPQueryRequestParcel : public Parcel {
 public:
-    explicit IGBPQueryRequestParcel(std::vector<u8> buffer) : Parcel(std::move(buffer)) {
+    explicit IGBPQueryRequestParcel(Kernel::BufferView<const u8> buffer) : Parcel(buffer) {
         Deserialize();
     }
     ~IGBPQueryRequestParcel() override = default;
 
     void DeserializeData() override {
-        std::u16string token = ReadInterfaceToken();
+        SkipInterfaceToken();
         type = Read<u32_le>();
     }
 
@@ -513,23 +523,22 @@ private:
 
         auto& buffer_queue = nv_flinger->FindBufferQueue(id);
 
-        if (transaction == TransactionId::Connect) {
-            IGBPConnectRequestParcel request{ctx.ReadBuffer()};
-            IGBPConnectResponseParcel response{
-                static_cast<u32>(static_cast<u32>(DisplayResolution::UndockedWidth) *
-                                 Settings::values.resolution_factor),
-                static_cast<u32>(static_cast<u32>(DisplayResolution::UndockedHeight) *
-                                 Settings::values.resolution_factor)};
-            ctx.WriteBuffer(response.Serialize());
-        } else if (transaction == TransactionId::SetPreallocatedBuffer) {
-            IGBPSetPreallocatedBufferRequestParcel request{ctx.ReadBuffer()};
+        // Requests are parsed straight from guest memory, and responses are serialized into a
+        // buffer reused by every transaction. Queue and dequeue run several times per frame, so
+        // they are checked first.
+        if (transaction == TransactionId::QueueBuffer) {
+            IGBPQueueBufferRequestParcel request{ctx.ReadBufferView()};
 
-            buffer_queue.SetPreallocatedBuffer(request.data.slot, request.buffer);
+            buffer_queue.QueueBuffer(request.data.slot, request.data.transform,
+                                     request.data.GetCropRect(), request.data.swap_interval,
+                                     request.data.multi_fence);
+            nv_flinger->OnBufferQueued();
 
-            IGBPSetPreallocatedBufferResponseParcel response{};
-            ctx.WriteBuffer(response.Serialize());
+            IGBPQueueBufferResponseParcel response{1280, 720};
+            response.Serialize(response_buffer);
+            ctx.WriteBuffer(response_buffer);
         } else if (transaction == TransactionId::DequeueBuffer) {
-            IGBPDequeueBufferRequestParcel request{ctx.ReadBuffer()};
+            IGBPDequeueBufferRequestParcel request{ctx.ReadBufferView()};
             const u32 width{request.data.width};
             const u32 height{request.data.height};
             auto result = buffer_queue.DequeueBuffer(width, height);
@@ -537,7 +546,8 @@ private:
             if (result) {
                 // Buffer is available
                 IGBPDequeueBufferResponseParcel response{result->first, *result->second};
-                ctx.WriteBuffer(response.Serialize());
+                response.Serialize(response_buffer);
+                ctx.WriteBuffer(response_buffer);
             } else {
                 // Wait the current thread until a buffer becomes available
                 ctx.SleepClientThread(
@@ -550,44 +560,54 @@ private:
                         ASSERT_MSG(result != std::nullopt, "Could not dequeue buffer.");
 
                         IGBPDequeueBufferResponseParcel response{result->first, *result->second};
-                        ctx.WriteBuffer(response.Serialize());
+                        response.Serialize(response_buffer);
+                        ctx.WriteBuffer(response_buffer);
                         IPC::ResponseBuilder rb{ctx, 2};
                         rb.Push(RESULT_SUCCESS);
                     },
                     buffer_queue.GetWritableBufferWaitEvent());
             }
+        } else if (transaction == TransactionId::Connect) {
+            IGBPConnectRequestParcel request{ctx.ReadBufferView()};
+            IGBPConnectResponseParcel response{
+                static_cast<u32>(static_cast<u32>(DisplayResolution::UndockedWidth) *
+                                 Settings::values.resolution_factor),
+                static_cast<u32>(static_cast<u32>(DisplayResolution::UndockedHeight) *
+                                 Settings::values.resolution_factor)};
+            response.Serialize(response_buffer);
+            ctx.WriteBuffer(response_buffer);
+        } else if (transaction == TransactionId::SetPreallocatedBuffer) {
+            IGBPSetPreallocatedBufferRequestParcel request{ctx.ReadBufferView()};
+
+            buffer_queue.SetPreallocatedBuffer(request.data.slot, request.buffer);
+
+            IGBPSetPreallocatedBufferResponseParcel response{};
+            response.Serialize(response_buffer);
+            ctx.WriteBuffer(response_buffer);
         } else if (transaction == TransactionId::RequestBuffer) {
-            IGBPRequestBufferRequestParcel request{ctx.ReadBuffer()};
+            IGBPRequestBufferRequestParcel request{ctx.ReadBufferView()};
 
             auto& buffer = buffer_queue.RequestBuffer(request.slot);
 
             IGBPRequestBufferResponseParcel response{buffer};
-            ctx.WriteBuffer(response.Serialize());
-        } else if (transaction == TransactionId::QueueBuffer) {
-            IGBPQueueBufferRequestParcel request{ctx.ReadBuffer()};
-
-            buffer_queue.QueueBuffer(request.data.slot, request.data.transform,
-                                     request.data.GetCropRect(), request.data.swap_interval,
-                                     request.data.multi_fence);
-
-            IGBPQueueBufferResponseParcel response{1280, 720};
-            ctx.WriteBuffer(response.Serialize());
+            response.Serialize(response_buffer);
+            ctx.WriteBuffer(response_buffer);
         } else if (transaction == TransactionId::Query) {
-            IGBPQueryRequestParcel request{ctx.ReadBuffer()};
+            IGBPQueryRequestParcel request{ctx.ReadBufferView()};
 
             const u32 value =
                 buffer_queue.Query(static_cast<NVFlinger::BufferQueue::QueryType>(request.type));
 
             IGBPQueryResponseParcel response{value};
-            ctx.WriteBuffer(response.Serialize());
+            response.Serialize(response_buffer);
+            ctx.WriteBuffer(response_buffer);
         } else if (transaction == TransactionId::CancelBuffer) {
             LOG_CRITICAL(Service_VI, "(STUBBED) called, transaction=CancelBuffer");
         } else if (transaction == TransactionId::Disconnect ||
                    transaction == TransactionId::DetachBuffer) {
-            const auto buffer = ctx.ReadBuffer();
-
             IGBPEmptyResponseParcel response{};
-            ctx.WriteBuffer(response.Serialize());
+            response.Serialize(response_buffer);
+            ctx.WriteBuffer(response_buffer);
         } else {
             ASSERT_MSG(false, "Unimplemented");
         }
@@ -625,6 +645,9 @@ private:
     }
 
     std::shared_ptr<NVFlinger::NVFlinger> nv_flinger;
+
+    /// Storage of the serialized responses, reused by every transaction
+    std::vector<u8> response_buffer;
 }; // namespace VI
 
 class ISystemDisplayService final : public ServiceFramework<ISystemDisplayService> {
@@ -0,0 +1,50 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+
+#include "common/logging/log.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/loader/gpu_capture.h"
+#include "core/memory.h"
+#include "video_core/gpu_capture.h"
+
+namespace Loader {
+
+AppLoader_GPUCapture::AppLoader_GPUCapture(FileSys::VirtualFile file)
+    : AppLoader(std::move(file)) {}
+
+AppLoader_GPUCapture::~AppLoader_GPUCapture() = default;
+
+FileType AppLoader_GPUCapture::IdentifyType(const FileSys::VirtualFile& file) {
+    return Tegra::Capture::Reader::IsValid(file) ? FileType::GPUCapture : FileType::Error;
+}
+
+AppLoader_GPUCapture::LoadResult AppLoader_GPUCapture::Load(Kernel::Process& process) {
+    if (is_loaded) {
+        return {ResultStatus::ErrorAlreadyLoaded, {}};
+    }
+
+    // The guest memory the GPU mappings point to is recreated at the same addresses, its contents
+    // are written by the replay as they were recorded
+    auto& vm_manager = process.VMManager();
+    for (const auto& [address, size] : Tegra::Capture::GetCaptureMemoryRanges(file)) {
+        const auto memory = std::make_shared<Kernel::PhysicalMemory>(size);
+        const auto result =
+            vm_manager.MapMemoryBlock(address, memory, 0, size, Kernel::MemoryState::Heap);
+        if (result.Failed()) {
+            LOG_ERROR(Loader, "Failed to map 0x{:X} bytes of guest memory at 0x{:016X}", size,
+                      address);
+            return {ResultStatus::ErrorLoadingGPUCapture, {}};
+        }
+    }
+
+    is_loaded = true;
+    return {ResultStatus::Success,
+            LoadParameters{Kernel::THREADPRIO_DEFAULT, Memory::DEFAULT_STACK_SIZE}};
+}
+
+} // namespace Loader
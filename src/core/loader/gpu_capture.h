@@ -0,0 +1,32 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "core/loader/loader.h"
+
+namespace Loader {
+
+/// Loads a GPU capture, laying out the guest memory it needs so it can be replayed. Nothing is
+/// executed on the emulated CPU, the replay is driven from the frontend.
+class AppLoader_GPUCapture final : public AppLoader {
+public:
+    explicit AppLoader_GPUCapture(FileSys::VirtualFile file);
+    ~AppLoader_GPUCapture() override;
+
+    /**
+     * Returns the type of the file
+     * @param file std::shared_ptr<VfsFile> open file
+     * @return FileType found, or FileType::Error if this loader doesn't know it
+     */
+    static FileType IdentifyType(const FileSys::VirtualFile& file);
+
+    FileType GetFileType() const override {
+        return IdentifyType(file);
+    }
+
+    LoadResult Load(Kernel::Process& process) override;
+};
+
+} // namespace Loader
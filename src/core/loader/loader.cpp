@@ -11,6 +11,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/loader/deconstructed_rom_directory.h"
 #include "core/loader/elf.h"
+#include "core/loader/gpu_capture.h"
 #include "core/loader/kip.h"
 #include "core/loader/nax.h"
 #include "core/loader/nca.h"
@@ -18,6 +19,7 @@
 #include "core/loader/nso.h"
 #include "core/loader/nsp.h"
 #include "core/loader/xci.h"
+#include "video_core/gpu_capture.h"
 
 namespace Loader {
 
@@ -38,6 +40,7 @@ FileType IdentifyFile(FileSys::VirtualFile file) {
     CHECK_TYPE(NAX)
     CHECK_TYPE(NSP)
     CHECK_TYPE(KIP)
+    CHECK_TYPE(GPUCapture)
 
 #undef CHECK_TYPE
 
@@ -67,6 +70,8 @@ FileType GuessFromFilename(const std::string& name) {
         return FileType::NSP;
     if (extension == "kip")
         return FileType::KIP;
+    if (extension == Tegra::Capture::EXTENSION)
+        return FileType::GPUCapture;
 
     return FileType::Unknown;
 }
@@ -89,6 +94,8 @@ std::string GetFileTypeString(FileType type) {
         return "NSP";
     case FileType::KIP:
         return "KIP";
+    case FileType::GPUCapture:
+        return "GPU Capture";
     case FileType::DeconstructedRomDirectory:
         return "Directory";
     case FileType::Error:
@@ -99,7 +106,7 @@ std::string GetFileTypeString(FileType type) {
     return "unknown";
 }
 
-constexpr std::array<const char*, 66> RESULT_MESSAGES{
+constexpr std::array<const char*, 67> RESULT_MESSAGES{
     "The operation completed successfully.",
     "The loader requested to load is already loaded.",
     "The operation is not implemented.",
@@ -166,6 +173,7 @@ constexpr std::array<const char*, 66> RESULT_MESSAGES{
     "The KIP BLZ decompression of the section failed unexpectedly.",
     "The INI file has a bad header.",
     "The INI file contains more than the maximum allowable number of KIP files.",
+    "There was a general error loading the GPU capture into emulated memory.",
 };
 
 std::ostream& operator<<(std::ostream& os, ResultStatus status) {
@@ -219,6 +227,10 @@ static std::unique_ptr<AppLoader> GetFileLoader(FileSys::VirtualFile file, FileT
     case FileType::KIP:
         return std::make_unique<AppLoader_KIP>(std::move(file));
 
+    // yuzu GPU capture
+    case FileType::GPUCapture:
+        return std::make_unique<AppLoader_GPUCapture>(std::move(file));
+
     // NX deconstructed ROM directory.
     case FileType::DeconstructedRomDirectory:
         return std::make_unique<AppLoader_DeconstructedRomDirectory>(std::move(file));
@@ -38,6 +38,7 @@ enum class FileType {
     XCI,
     NAX,
     KIP,
+    GPUCapture,
     DeconstructedRomDirectory,
 };
 
@@ -129,6 +130,7 @@ enum class ResultStatus : u16 {
     ErrorBLZDecompressionFailed,
     ErrorBadINIHeader,
     ErrorINITooManyKIPs,
+    ErrorLoadingGPUCapture,
 };
 
 std::ostream& operator<<(std::ostream& os, ResultStatus status);
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstring>
 #include <vector>
@@ -12,7 +14,9 @@
 #include "common/logging/log.h"
 #include "common/lz4_compression.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/kernel/code_set.h"
@@ -35,17 +39,6 @@ struct MODHeader {
 };
 static_assert(sizeof(MODHeader) == 0x1c, "MODHeader has incorrect size.");
 
-std::vector<u8> DecompressSegment(const std::vector<u8>& compressed_data,
-                                  const NSOSegmentHeader& header) {
-    const std::vector<u8> uncompressed_data =
-        Common::Compression::DecompressDataLZ4(compressed_data, header.size);
-
-    ASSERT_MSG(uncompressed_data.size() == header.size, "{} != {}", header.size,
-               uncompressed_data.size());
-
-    return uncompressed_data;
-}
-
 constexpr u32 PageAlignSize(u32 size) {
     return (size + Memory::PAGE_MASK) & ~Memory::PAGE_MASK;
 }
@@ -56,6 +49,11 @@ bool NSOHeader::IsSegmentCompressed(size_t segment_num) const {
     return ((flags >> segment_num) & 1) != 0;
 }
 
+bool NSOHeader::IsSegmentHashChecked(size_t segment_num) const {
+    ASSERT_MSG(segment_num < 3, "Invalid segment {}", segment_num);
+    return ((flags >> (segment_num + 3)) & 1) != 0;
+}
+
 AppLoader_NSO::AppLoader_NSO(FileSys::VirtualFile file) : AppLoader(std::move(file)) {}
 
 FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& file) {
@@ -88,22 +86,76 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::Process& process,
         return {};
     }
 
-    // Build program image
+    // Lay out the program image up front, so every segment can be decompressed in place
     Kernel::CodeSet codeset;
+    std::array<u32, 3> data_sizes{};
+    std::size_t segments_end = 0;
+    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
+        const auto& segment = nso_header.segments[i];
+        data_sizes[i] = nso_header.IsSegmentCompressed(i) ? segment.size
+                                                          : nso_header.segments_compressed_size[i];
+        const u32 segment_size = PageAlignSize(data_sizes[i]);
+        codeset.segments[i].addr = segment.location;
+        codeset.segments[i].offset = segment.location;
+        codeset.segments[i].size = segment_size;
+        segments_end = std::max<std::size_t>(segments_end, segment.location + segment_size);
+    }
+
+    // Leave room for the arguments and the .bss, so appending them later doesn't copy the image
     Kernel::PhysicalMemory program_image;
+    program_image.reserve(segments_end + NSO_ARGUMENT_DATA_ALLOCATION_SIZE +
+                          PageAlignSize(nso_header.segments[2].bss_size));
+    program_image.resize(segments_end);
+
+    // Segments are decompressed on worker threads, straight out of files that can be viewed in
+    // place. Uncompressed segments are read into the image directly.
+    const bool verify_hashes = Settings::values.verify_nso_hashes;
+    std::array<std::vector<u8>, 3> read_data;
+    std::array<bool, 3> segment_ok{};
+    Common::TaskGroup segment_tasks;
     for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        std::vector<u8> data =
-            file.ReadBytes(nso_header.segments_compressed_size[i], nso_header.segments[i].offset);
+        const auto& segment = nso_header.segments[i];
+        u8* const dest = program_image.data() + segment.location;
+
+        const u8* source = nullptr;
+        std::size_t source_size = nso_header.segments_compressed_size[i];
         if (nso_header.IsSegmentCompressed(i)) {
-            data = DecompressSegment(data, nso_header.segments[i]);
+            source = file.GetDirectView(segment.offset, source_size);
+            if (source == nullptr) {
+                read_data[i] = file.ReadBytes(source_size, segment.offset);
+                source = read_data[i].data();
+                source_size = read_data[i].size();
+            }
+        } else {
+            file.Read(dest, source_size, segment.offset);
+        }
+
+        const bool check_hash = verify_hashes && nso_header.IsSegmentHashChecked(i);
+        if (source == nullptr && !check_hash) {
+            segment_ok[i] = true;
+            continue;
+        }
+        Common::GetSharedWorker().QueueWork(
+            segment_tasks,
+            [&nso_header, &data_sizes, &segment_ok, i, source, source_size, dest, check_hash] {
+                bool ok = source == nullptr || Common::Compression::DecompressDataLZ4(
+                                                   source, source_size, dest, data_sizes[i]);
+                if (ok && check_hash) {
+                    ok = Core::Crypto::CalculateSHA256(dest, data_sizes[i]) ==
+                         nso_header.segment_hashes[i];
+                }
+                segment_ok[i] = ok;
+            },
+            Common::WorkPriority::High);
+    }
+    segment_tasks.Wait();
+
+    for (std::size_t i = 0; i < segment_ok.size(); ++i) {
+        if (!segment_ok[i]) {
+            LOG_ERROR(Loader, "Failed to load segment {} of NSO {}, it is corrupted", i,
+                      file.GetName());
+            return {};
         }
-        program_image.resize(nso_header.segments[i].location +
-                             PageAlignSize(static_cast<u32>(data.size())));
-        std::memcpy(program_image.data() + nso_header.segments[i].location, data.data(),
-                    data.size());
-        codeset.segments[i].addr = nso_header.segments[i].location;
-        codeset.segments[i].offset = nso_header.segments[i].location;
-        codeset.segments[i].size = PageAlignSize(static_cast<u32>(data.size()));
     }
 
     if (should_pass_arguments) {
@@ -18,6 +18,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/vm_manager.h"
 #include "core/memory.h"
+#include "core/memory/snapshot.h"
 #include "video_core/gpu.h"
 
 namespace Memory {
@@ -29,7 +30,7 @@ struct Memory::Impl {
     explicit Impl(Core::System& system_) : system{system_} {}
 
     void SetCurrentPageTable(Kernel::Process& process) {
-        current_page_table = &process.VMManager().page_table;
+        SetCurrentPageTable(process.VMManager().page_table);
 
         const std::size_t address_space_width = process.VMManager().GetAddressSpaceWidth();
 
@@ -39,6 +40,10 @@ struct Memory::Impl {
         system.ArmInterface(3).PageTableChanged(*current_page_table, address_space_width);
     }
 
+    void SetCurrentPageTable(Common::PageTable& page_table) {
+        current_page_table = &page_table;
+    }
+
     void MapMemoryRegion(Common::PageTable& page_table, VAddr base, u64 size,
                          Kernel::PhysicalMemory& memory, VAddr offset) {
         MapMemoryRegion(page_table, base, size, memory.data() + offset);
@@ -164,6 +169,34 @@ struct Memory::Impl {
         return nullptr;
     }
 
+    u8* GetContiguousPointer(const VAddr vaddr, const std::size_t size) {
+        if (size == 0) {
+            return nullptr;
+        }
+
+        const std::size_t first_page = vaddr >> PAGE_BITS;
+        const std::size_t last_page = (vaddr + size - 1) >> PAGE_BITS;
+        if (last_page >= current_page_table->pointers.size()) {
+            return nullptr;
+        }
+
+        // Page pointers are stored as absolute offsets, so a range is contiguous in host memory
+        // exactly when every page in it holds the same pointer.
+        u8* const page_pointer = current_page_table->pointers[first_page];
+        if (page_pointer == nullptr) {
+            return nullptr;
+        }
+        const auto pointers_begin = current_page_table->pointers.begin();
+        const bool is_contiguous =
+            std::all_of(pointers_begin + first_page + 1, pointers_begin + last_page + 1,
+                        [page_pointer](const u8* pointer) { return pointer == page_pointer; });
+        if (!is_contiguous) {
+            return nullptr;
+        }
+
+        return page_pointer + vaddr;
+    }
+
     u8 Read8(const VAddr addr) {
         return Read<u8>(addr);
     }
@@ -211,98 +244,127 @@ struct Memory::Impl {
         return string;
     }
 
-    void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
-                   const std::size_t size) {
+    /**
+     * Walks a virtual memory range of a process, calling the handler matching the page type once
+     * per run of consecutive pages instead of once per page. Host backed pages are joined while
+     * they are contiguous in host memory too, so each run can be served with a single memcpy and
+     * rasterizer cached runs need a single GPU notification.
+     *
+     * Each handler receives the first virtual address of the run, its host pointer (mapped runs
+     * only), the size of the run and its offset within the walked range.
+     */
+    template <typename OnUnmapped, typename OnMemory, typename OnRasterizerCached>
+    void WalkBlock(const Kernel::Process& process, const VAddr addr, const std::size_t size,
+                   OnUnmapped&& on_unmapped, OnMemory&& on_memory,
+                   OnRasterizerCached&& on_rasterizer_cached) {
         const auto& page_table = process.VMManager().page_table;
 
         std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> PAGE_BITS;
-        std::size_t page_offset = src_addr & PAGE_MASK;
+        std::size_t page_index = addr >> PAGE_BITS;
+        std::size_t page_offset = addr & PAGE_MASK;
+        std::size_t offset = 0;
 
         while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
+            const Common::PageType type = page_table.attributes[page_index];
             const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
 
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
-                LOG_ERROR(HW_Memory,
-                          "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
-                          current_vaddr, src_addr, size);
-                std::memset(dest_buffer, 0, copy_amount);
+            u8* host_ptr = nullptr;
+            switch (type) {
+            case Common::PageType::Unmapped:
                 break;
-            }
-            case Common::PageType::Memory: {
+            case Common::PageType::Memory:
                 DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                const u8* const src_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
+                host_ptr = page_table.pointers[page_index] + current_vaddr;
                 break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                const u8* const host_ptr = GetPointerFromVMA(process, current_vaddr);
-                system.GPU().FlushRegion(ToCacheAddr(host_ptr), copy_amount);
-                std::memcpy(dest_buffer, host_ptr, copy_amount);
+            case Common::PageType::RasterizerCachedMemory:
+                host_ptr = GetPointerFromVMA(process, current_vaddr);
                 break;
+            default:
+                UNREACHABLE();
             }
+
+            // Memory pages store the same absolute offset for a contiguous host mapping, cached
+            // pages have to be looked up in their VMA instead.
+            std::size_t run_size =
+                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
+            const u8* const run_pointer = page_table.pointers[page_index];
+            ++page_index;
+            while (run_size < remaining_size && page_table.attributes[page_index] == type) {
+                if (type == Common::PageType::Memory &&
+                    page_table.pointers[page_index] != run_pointer) {
+                    break;
+                }
+                if (type == Common::PageType::RasterizerCachedMemory &&
+                    GetPointerFromVMA(process, static_cast<VAddr>(page_index << PAGE_BITS)) !=
+                        host_ptr + run_size) {
+                    break;
+                }
+                run_size +=
+                    std::min(static_cast<std::size_t>(PAGE_SIZE), remaining_size - run_size);
+                ++page_index;
+            }
+
+            switch (type) {
+            case Common::PageType::Unmapped:
+                on_unmapped(current_vaddr, run_size, offset);
+                break;
+            case Common::PageType::Memory:
+                on_memory(current_vaddr, host_ptr, run_size, offset);
+                break;
+            case Common::PageType::RasterizerCachedMemory:
+                on_rasterizer_cached(current_vaddr, host_ptr, run_size, offset);
+                break;
             default:
                 UNREACHABLE();
             }
 
-            page_index++;
             page_offset = 0;
-            dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-            remaining_size -= copy_amount;
+            offset += run_size;
+            remaining_size -= run_size;
         }
     }
 
+    void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
+                   const std::size_t size) {
+        u8* const dest = static_cast<u8*>(dest_buffer);
+        WalkBlock(
+            process, src_addr, size,
+            [&](VAddr current_vaddr, std::size_t copy_amount, std::size_t offset) {
+                LOG_ERROR(HW_Memory,
+                          "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
+                          current_vaddr, src_addr, size);
+                std::memset(dest + offset, 0, copy_amount);
+            },
+            [&](VAddr, const u8* src_ptr, std::size_t copy_amount, std::size_t offset) {
+                std::memcpy(dest + offset, src_ptr, copy_amount);
+            },
+            [&](VAddr, const u8* host_ptr, std::size_t copy_amount, std::size_t offset) {
+                system.GPU().FlushRegion(ToCacheAddr(host_ptr), copy_amount);
+                std::memcpy(dest + offset, host_ptr, copy_amount);
+            });
+    }
+
     void ReadBlock(const VAddr src_addr, void* dest_buffer, const std::size_t size) {
         ReadBlock(*system.CurrentProcess(), src_addr, dest_buffer, size);
     }
 
     void WriteBlock(const Kernel::Process& process, const VAddr dest_addr, const void* src_buffer,
                     const std::size_t size) {
-        const auto& page_table = process.VMManager().page_table;
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> PAGE_BITS;
-        std::size_t page_offset = dest_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        const u8* const src = static_cast<const u8*>(src_buffer);
+        WalkBlock(
+            process, dest_addr, size,
+            [&](VAddr current_vaddr, std::size_t, std::size_t) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped WriteBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, dest_addr, size);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* const dest_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                u8* const host_ptr = GetPointerFromVMA(process, current_vaddr);
+            },
+            [&](VAddr, u8* dest_ptr, std::size_t copy_amount, std::size_t offset) {
+                std::memcpy(dest_ptr, src + offset, copy_amount);
+            },
+            [&](VAddr, u8* host_ptr, std::size_t copy_amount, std::size_t offset) {
                 system.GPU().InvalidateRegion(ToCacheAddr(host_ptr), copy_amount);
-                std::memcpy(host_ptr, src_buffer, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+                std::memcpy(host_ptr, src + offset, copy_amount);
+            });
     }
 
     void WriteBlock(const VAddr dest_addr, const void* src_buffer, const std::size_t size) {
@@ -310,45 +372,20 @@ struct Memory::Impl {
     }
 
     void ZeroBlock(const Kernel::Process& process, const VAddr dest_addr, const std::size_t size) {
-        const auto& page_table = process.VMManager().page_table;
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> PAGE_BITS;
-        std::size_t page_offset = dest_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        WalkBlock(
+            process, dest_addr, size,
+            [&](VAddr current_vaddr, std::size_t, std::size_t) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped ZeroBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, dest_addr, size);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* dest_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
+            },
+            [&](VAddr, u8* dest_ptr, std::size_t copy_amount, std::size_t) {
                 std::memset(dest_ptr, 0, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                u8* const host_ptr = GetPointerFromVMA(process, current_vaddr);
+            },
+            [&](VAddr, u8* host_ptr, std::size_t copy_amount, std::size_t) {
                 system.GPU().InvalidateRegion(ToCacheAddr(host_ptr), copy_amount);
                 std::memset(host_ptr, 0, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            remaining_size -= copy_amount;
-        }
+            });
     }
 
     void ZeroBlock(const VAddr dest_addr, const std::size_t size) {
@@ -357,47 +394,21 @@ struct Memory::Impl {
 
     void CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
                    const std::size_t size) {
-        const auto& page_table = process.VMManager().page_table;
-        std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> PAGE_BITS;
-        std::size_t page_offset = src_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        WalkBlock(
+            process, src_addr, size,
+            [&](VAddr current_vaddr, std::size_t copy_amount, std::size_t offset) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped CopyBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, src_addr, size);
-                ZeroBlock(process, dest_addr, copy_amount);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-                const u8* src_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                WriteBlock(process, dest_addr, src_ptr, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                const u8* const host_ptr = GetPointerFromVMA(process, current_vaddr);
+                ZeroBlock(process, dest_addr + offset, copy_amount);
+            },
+            [&](VAddr, const u8* src_ptr, std::size_t copy_amount, std::size_t offset) {
+                WriteBlock(process, dest_addr + offset, src_ptr, copy_amount);
+            },
+            [&](VAddr, const u8* host_ptr, std::size_t copy_amount, std::size_t offset) {
                 system.GPU().FlushRegion(ToCacheAddr(host_ptr), copy_amount);
-                WriteBlock(process, dest_addr, host_ptr, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            dest_addr += static_cast<VAddr>(copy_amount);
-            src_addr += static_cast<VAddr>(copy_amount);
-            remaining_size -= copy_amount;
-        }
+                WriteBlock(process, dest_addr + offset, host_ptr, copy_amount);
+            });
     }
 
     void CopyBlock(VAddr dest_addr, VAddr src_addr, std::size_t size) {
@@ -484,33 +495,56 @@ struct Memory::Impl {
 
         // During boot, current_page_table might not be set yet, in which case we need not flush
         if (system.IsPoweredOn()) {
-            auto& gpu = system.GPU();
-            for (u64 i = 0; i < size; i++) {
-                const auto page = base + i;
-                if (page_table.attributes[page] == Common::PageType::RasterizerCachedMemory) {
-                    gpu.FlushAndInvalidateRegion(page << PAGE_BITS, PAGE_SIZE);
-                }
-            }
+            FlushRasterizerCachedPages(page_table, base, size);
         }
 
         const VAddr end = base + size;
         ASSERT_MSG(end <= page_table.pointers.size(), "out of range mapping at {:016X}",
                    base + page_table.pointers.size());
 
-        std::fill(page_table.attributes.begin() + base, page_table.attributes.begin() + end, type);
+        // Unmapping zeroes the tables, which gives their host pages back instead of committing
+        // them. Unmapping the whole address space on reset would commit every page otherwise.
+        if (type == Common::PageType::Unmapped) {
+            page_table.attributes.Zero(base, size);
+        } else {
+            std::fill(page_table.attributes.begin() + base, page_table.attributes.begin() + end,
+                      type);
+        }
 
         if (memory == nullptr) {
-            std::fill(page_table.pointers.begin() + base, page_table.pointers.begin() + end,
-                      memory);
-        } else {
-            while (base != end) {
-                page_table.pointers[base] = memory - (base << PAGE_BITS);
-                ASSERT_MSG(page_table.pointers[base],
-                           "memory mapping base yield a nullptr within the table");
+            page_table.pointers.Zero(base, size);
+            return;
+        }
 
-                base += 1;
-                memory += PAGE_SIZE;
-            }
+        // The page table stores absolute offsets (host pointer minus guest address), which are
+        // the same for every page of a contiguous mapping. This lets the whole range be written
+        // with a single fill instead of recomputing the pointer page by page.
+        u8* const offset_pointer = memory - (base << PAGE_BITS);
+        ASSERT_MSG(offset_pointer != nullptr,
+                   "memory mapping base yield a nullptr within the table");
+        std::fill(page_table.pointers.begin() + base, page_table.pointers.begin() + end,
+                  offset_pointer);
+    }
+
+    /**
+     * Flushes and invalidates every rasterizer cached page within the given page range, issuing
+     * one GPU request per contiguous run of cached pages instead of one per page.
+     */
+    void FlushRasterizerCachedPages(const Common::PageTable& page_table, u64 base, u64 size) {
+        const auto attributes_begin = page_table.attributes.begin();
+        const auto range_end = attributes_begin + base + size;
+        const auto is_cached = [](Common::PageType type) {
+            return type == Common::PageType::RasterizerCachedMemory;
+        };
+
+        auto& gpu = system.GPU();
+        auto run_begin = std::find_if(attributes_begin + base, range_end, is_cached);
+        while (run_begin != range_end) {
+            const auto run_end = std::find_if_not(run_begin, range_end, is_cached);
+            const u64 first_page = static_cast<u64>(run_begin - attributes_begin);
+            const u64 num_pages = static_cast<u64>(run_end - run_begin);
+            gpu.FlushAndInvalidateRegion(first_page << PAGE_BITS, num_pages * PAGE_SIZE);
+            run_begin = std::find_if(run_end, range_end, is_cached);
         }
     }
 
@@ -607,6 +641,10 @@ void Memory::SetCurrentPageTable(Kernel::Process& process) {
     impl->SetCurrentPageTable(process);
 }
 
+void Memory::SetCurrentPageTable(Common::PageTable& page_table) {
+    impl->SetCurrentPageTable(page_table);
+}
+
 void Memory::MapMemoryRegion(Common::PageTable& page_table, VAddr base, u64 size,
                              Kernel::PhysicalMemory& memory, VAddr offset) {
     impl->MapMemoryRegion(page_table, base, size, memory, offset);
@@ -651,6 +689,10 @@ const u8* Memory::GetPointer(VAddr vaddr) const {
     return impl->GetPointer(vaddr);
 }
 
+u8* Memory::GetContiguousPointer(VAddr vaddr, std::size_t size) {
+    return impl->GetContiguousPointer(vaddr, size);
+}
+
 u8 Memory::Read8(const VAddr addr) {
     return impl->Read8(addr);
 }
@@ -726,6 +768,10 @@ void Memory::RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
     impl->RasterizerMarkRegionCached(vaddr, size, cached);
 }
 
+std::unique_ptr<Snapshot> Memory::TakeSnapshot() const {
+    return std::make_unique<Snapshot>(*impl->system.CurrentProcess());
+}
+
 bool IsKernelVirtualAddress(const VAddr vaddr) {
     return KERNEL_REGION_VADDR <= vaddr && vaddr < KERNEL_REGION_END;
 }
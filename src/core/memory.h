@@ -25,6 +25,8 @@ class Process;
 
 namespace Memory {
 
+class Snapshot;
+
 /**
  * Page size used by the ARM architecture. This is the smallest granularity with which memory can
  * be mapped.
@@ -66,6 +68,14 @@ public:
      */
     void SetCurrentPageTable(Kernel::Process& process);
 
+    /**
+     * Changes the currently active page table without notifying the CPU cores, for users that
+     * access memory without running guest code, like tools and benchmarks.
+     *
+     * @param page_table The page table to use.
+     */
+    void SetCurrentPageTable(Common::PageTable& page_table);
+
     /**
      * Maps an physical buffer onto a region of the emulated process address space.
      *
@@ -173,6 +183,18 @@ public:
      */
     const u8* GetPointer(VAddr vaddr) const;
 
+    /**
+     * Gets a pointer to a whole range of memory, if that range is backed by contiguous host
+     * memory that can be accessed without going through the rasterizer cache.
+     *
+     * @param vaddr Virtual address of the start of the range.
+     * @param size  Size of the range in bytes.
+     *
+     * @returns The pointer to the start of the range, or nullptr if any page within it is
+     *          unmapped, rasterizer cached, special, or not contiguous with its neighbours.
+     */
+    u8* GetContiguousPointer(VAddr vaddr, std::size_t size);
+
     /**
      * Reads an 8-bit unsigned value from the current process' address space
      * at the given virtual address.
@@ -417,6 +439,13 @@ public:
      */
     void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached);
 
+    /**
+     * Takes a copy-on-write snapshot of the memory of the current process.
+     *
+     * @returns The snapshot, which keeps tracking writes to the memory until it is destroyed.
+     */
+    std::unique_ptr<Snapshot> TakeSnapshot() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl;
@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <locale>
+#include <cstring>
 #include "common/hex_util.h"
+#include "common/logging/backend.h"
 #include "common/microprofile.h"
 #include "common/swap.h"
 #include "core/core.h"
@@ -20,17 +22,53 @@ namespace Memory {
 constexpr s64 CHEAT_ENGINE_TICKS = static_cast<s64>(Core::Timing::BASE_CLOCK_RATE / 12);
 constexpr u32 KEYPAD_BITMASK = 0x3FFFFFF;
 
+/// Checks whether any part of the given range is mapped as executable in the current process.
+static bool IsExecutableRange(const Kernel::VMManager& vm_manager, VAddr address, u64 size) {
+    const VAddr end = address + size;
+    for (auto vma = vm_manager.FindVMA(address);
+         vm_manager.IsValidHandle(vma) && vma->second.base < end; ++vma) {
+        if ((vma->second.permissions & Kernel::VMAPermission::Execute) !=
+            Kernel::VMAPermission::None) {
+            return true;
+        }
+    }
+    return false;
+}
+
 StandardVmCallbacks::StandardVmCallbacks(Core::System& system, const CheatProcessMetadata& metadata)
     : metadata(metadata), system(system) {}
 
 StandardVmCallbacks::~StandardVmCallbacks() = default;
 
 void StandardVmCallbacks::MemoryRead(VAddr address, void* data, u64 size) {
-    system.Memory().ReadBlock(SanitizeAddress(address), data, size);
+    const VAddr sanitized_address = SanitizeAddress(address);
+    auto& memory = system.Memory();
+    // Cheat accesses are at most 8 bytes, plain memory is copied straight from the page table.
+    if (const u8* const pointer = memory.GetContiguousPointer(sanitized_address, size)) {
+        std::memcpy(data, pointer, size);
+        return;
+    }
+    memory.ReadBlock(sanitized_address, data, size);
 }
 
 void StandardVmCallbacks::MemoryWrite(VAddr address, const void* data, u64 size) {
-    system.Memory().WriteBlock(SanitizeAddress(address), data, size);
+    const VAddr sanitized_address = SanitizeAddress(address);
+    auto& memory = system.Memory();
+    if (u8* const pointer = memory.GetContiguousPointer(sanitized_address, size)) {
+        std::memcpy(pointer, data, size);
+    } else {
+        memory.WriteBlock(sanitized_address, data, size);
+    }
+
+    // Most cheats only poke data, only drop translated code if the write actually patched code.
+    // The heap is never executable, which spares the region lookup for most writes.
+    const auto& heap = metadata.heap_extents;
+    const bool is_heap =
+        sanitized_address >= heap.base && sanitized_address + size <= heap.base + heap.size;
+    if (!is_heap &&
+        IsExecutableRange(system.CurrentProcess()->VMManager(), sanitized_address, size)) {
+        system.InvalidateCpuInstructionCacheRange(sanitized_address, size);
+    }
 }
 
 u64 StandardVmCallbacks::HidKeysDown() {
@@ -58,6 +96,10 @@ void StandardVmCallbacks::CommandLog(std::string_view data) {
               data.back() == '\n' ? data.substr(0, data.size() - 1) : data);
 }
 
+bool StandardVmCallbacks::IsCommandLogEnabled() const {
+    return Log::IsLogged(Log::Class::CheatEngine, Log::Level::Debug);
+}
+
 VAddr StandardVmCallbacks::SanitizeAddress(VAddr in) const {
     if ((in < metadata.main_nso_extents.base ||
          in >= metadata.main_nso_extents.base + metadata.main_nso_extents.size) &&
@@ -277,6 +277,9 @@ public:
 
         virtual void DebugLog(u8 id, u64 value) = 0;
         virtual void CommandLog(std::string_view data) = 0;
+
+        /// Whether CommandLog output is kept, the VM doesn't build its trace otherwise.
+        virtual bool IsCommandLogEnabled() const = 0;
     };
 
     static constexpr std::size_t MaximumProgramOpcodeCount = 0x400;
@@ -289,6 +292,8 @@ public:
         return this->num_opcodes;
     }
 
+    /// Loads the enabled cheats and decodes them once, Execute then runs the decoded opcodes.
+
     bool LoadProgram(const std::vector<CheatEntry>& cheats);
     void Execute(const CheatProcessMetadata& metadata);
 
@@ -296,6 +301,8 @@ private:
     std::unique_ptr<Callbacks> callbacks;
 
     std::size_t num_opcodes = 0;
+    /// Index of the next opcode in decoded_program while executing, of the next dword in program
+    /// while decoding.
     std::size_t instruction_ptr = 0;
     std::size_t condition_depth = 0;
     bool decode_success = false;
@@ -303,6 +310,8 @@ private:
     std::array<u64, NumRegisters> registers{};
     std::array<u64, NumRegisters> saved_values{};
     std::array<std::size_t, NumRegisters> loop_tops{};
+    /// The opcodes of program up to the first one that failed to decode, which ends execution.
+    std::vector<CheatVmOpcode> decoded_program;
 
     bool DecodeNextOpcode(CheatVmOpcode& out);
     void SkipConditionalBlock();
@@ -0,0 +1,99 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "common/memory_snapshot.h"
+#include "core/hle/kernel/physical_memory.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/memory.h"
+#include "core/memory/snapshot.h"
+
+namespace Memory {
+
+Snapshot::Snapshot(const Kernel::Process& process) {
+    const auto& vm_manager = process.VMManager();
+
+    // Blocks can be mapped more than once, but each one is tracked only once
+    std::unordered_map<const Kernel::PhysicalMemory*, std::size_t> block_indices;
+    std::vector<Common::MemorySnapshot::Range> ranges;
+    for (auto vma = vm_manager.FindVMA(vm_manager.GetAddressSpaceBaseAddress());
+         vm_manager.IsValidHandle(vma); ++vma) {
+        const auto& area = vma->second;
+        if (area.type != Kernel::VMAType::AllocatedMemoryBlock) {
+            continue;
+        }
+        const auto [it, is_new] = block_indices.emplace(area.backing_block.get(), blocks.size());
+        if (is_new) {
+            blocks.push_back({area.backing_block, area.backing_block->data()});
+            ranges.push_back({area.backing_block->data(), area.backing_block->size()});
+        }
+        mappings.push_back({area.base, area.size, it->second, area.offset});
+    }
+    snapshot = std::make_unique<Common::MemorySnapshot>(std::move(ranges));
+}
+
+Snapshot::~Snapshot() = default;
+
+std::vector<VAddr> Snapshot::GetTouchedPages(const Snapshot* until) const {
+    const std::size_t host_page_size = Common::MemorySnapshot::PageSize();
+
+    const Common::MemorySnapshot* const until_snapshot =
+        until != nullptr ? until->snapshot.get() : nullptr;
+    std::vector<std::vector<std::size_t>> touched_host_pages(blocks.size());
+    for (std::size_t block = 0; block < blocks.size(); ++block) {
+        touched_host_pages[block] = snapshot->GetTouchedPages(block, until_snapshot);
+    }
+
+    std::vector<VAddr> pages;
+    for (const Mapping& mapping : mappings) {
+        // Host pages start at the page holding the first byte of the block, which is where the
+        // block starts unless host pages are larger than guest pages
+        const std::size_t lead = reinterpret_cast<uintptr_t>(blocks[mapping.block].pointer) %
+                                 host_page_size;
+        const std::size_t mapping_begin = mapping.offset + lead;
+        const std::size_t mapping_end = mapping_begin + mapping.size;
+        for (const std::size_t host_page : touched_host_pages[mapping.block]) {
+            const std::size_t begin = std::max(host_page * host_page_size, mapping_begin);
+            const std::size_t end = std::min((host_page + 1) * host_page_size, mapping_end);
+            if (begin >= end) {
+                continue;
+            }
+            for (std::size_t offset = (begin - lead) & ~PAGE_MASK; offset + lead < end;
+                 offset += PAGE_SIZE) {
+                pages.push_back(mapping.base + offset - mapping.offset);
+            }
+        }
+    }
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    return pages;
+}
+
+bool Snapshot::ReadBlock(VAddr src_addr, void* dest_buffer, std::size_t size) const {
+    auto* dest = static_cast<u8*>(dest_buffer);
+    while (size > 0) {
+        const auto mapping =
+            std::find_if(mappings.begin(), mappings.end(), [src_addr](const Mapping& candidate) {
+                return src_addr >= candidate.base && src_addr - candidate.base < candidate.size;
+            });
+        if (mapping == mappings.end()) {
+            return false;
+        }
+        const std::size_t offset_in_mapping = src_addr - mapping->base;
+        const std::size_t copy_size =
+            std::min<std::size_t>(size, mapping->size - offset_in_mapping);
+        if (!snapshot->Read(mapping->block, mapping->offset + offset_in_mapping, dest, copy_size)) {
+            return false;
+        }
+        src_addr += copy_size;
+        dest += copy_size;
+        size -= copy_size;
+    }
+    return true;
+}
+
+} // namespace Memory
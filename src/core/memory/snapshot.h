@@ -0,0 +1,71 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Common {
+class MemorySnapshot;
+}
+
+namespace Kernel {
+class PhysicalMemory;
+class Process;
+} // namespace Kernel
+
+namespace Memory {
+
+/**
+ * Copy-on-write snapshot of the memory mapped in a process, built on Common::MemorySnapshot.
+ * Taking one only write-protects the backing memory; each page is copied the first time it is
+ * written afterwards, which also tells which guest pages were touched between two snapshots.
+ * Taking a snapshot every frame gives the working set of each frame, for example.
+ *
+ * Memory mapped after the snapshot was taken is not tracked, and blocks that are reallocated
+ * while it is alive, like the heap when it grows, are reported as touched as a whole.
+ */
+class Snapshot {
+public:
+    explicit Snapshot(const Kernel::Process& process);
+    ~Snapshot();
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /**
+     * Returns the sorted addresses of the guest pages written after this snapshot was taken and
+     * before the snapshot until was, or until now when until is null.
+     */
+    std::vector<VAddr> GetTouchedPages(const Snapshot* until = nullptr) const;
+
+    /**
+     * Reads guest memory as it was when the snapshot was taken.
+     * @returns false when part of the range wasn't mapped or its block was reallocated since
+     */
+    bool ReadBlock(VAddr src_addr, void* dest_buffer, std::size_t size) const;
+
+private:
+    struct Block {
+        std::shared_ptr<Kernel::PhysicalMemory> memory;
+        const u8* pointer; ///< Data of the block when the snapshot was taken
+    };
+
+    struct Mapping {
+        VAddr base;
+        u64 size;
+        std::size_t block;  ///< Index in blocks, which is also the range of the snapshot
+        std::size_t offset; ///< Offset of the mapping in its block
+    };
+
+    std::vector<Block> blocks;
+    std::vector<Mapping> mappings;
+    std::unique_ptr<Common::MemorySnapshot> snapshot;
+};
+
+} // namespace Memory
@@ -0,0 +1,551 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "core/network/network.h"
+
+namespace Network {
+
+namespace {
+
+#ifdef _WIN32
+
+using socklen_t = int;
+
+constexpr int SHUT_RD = SD_RECEIVE;
+constexpr int SHUT_WR = SD_SEND;
+constexpr int SHUT_RDWR = SD_BOTH;
+
+constexpr int SEND_FLAGS = 0;
+
+int LastError() {
+    return WSAGetLastError();
+}
+
+int CloseSocket(SOCKET fd) {
+    return closesocket(fd);
+}
+
+Errno EnableNonBlock(SOCKET fd) {
+    u_long value = 1;
+    return ioctlsocket(fd, FIONBIO, &value) == 0 ? Errno::SUCCESS : Errno::OTHER;
+}
+
+int HostPoll(pollfd* fds, std::size_t count, s32 timeout) {
+    return WSAPoll(fds, static_cast<ULONG>(count), timeout);
+}
+
+Errno TranslateNativeError(int e) {
+    switch (e) {
+    case WSAEBADF:
+    case WSAENOTSOCK:
+        return Errno::BADF;
+    case WSAEINVAL:
+        return Errno::INVAL;
+    case WSAEMFILE:
+        return Errno::MFILE;
+    case WSAENOTCONN:
+        return Errno::NOTCONN;
+    case WSAEWOULDBLOCK:
+        return Errno::AGAIN;
+    case WSAECONNREFUSED:
+        return Errno::CONNREFUSED;
+    case WSAECONNRESET:
+        return Errno::CONNRESET;
+    case WSAECONNABORTED:
+        return Errno::CONNABORTED;
+    case WSAEINPROGRESS:
+        return Errno::INPROGRESS;
+    case WSAEMSGSIZE:
+        return Errno::MSGSIZE;
+    case WSAETIMEDOUT:
+        return Errno::TIMEDOUT;
+    default:
+        return Errno::OTHER;
+    }
+}
+
+#else
+
+constexpr int SOCKET_ERROR = -1;
+
+#ifdef MSG_NOSIGNAL
+// A peer closing the connection must not raise SIGPIPE in the emulator
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+int LastError() {
+    return errno;
+}
+
+int CloseSocket(Socket::SOCKET fd) {
+    return close(fd);
+}
+
+Errno EnableNonBlock(Socket::SOCKET fd) {
+    const int flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        return Errno::OTHER;
+    }
+    return Errno::SUCCESS;
+}
+
+int HostPoll(pollfd* fds, std::size_t count, s32 timeout) {
+    return poll(fds, static_cast<nfds_t>(count), timeout);
+}
+
+Errno TranslateNativeError(int e) {
+    switch (e) {
+    case EBADF:
+    case ENOTSOCK:
+        return Errno::BADF;
+    case EINVAL:
+        return Errno::INVAL;
+    case EMFILE:
+        return Errno::MFILE;
+    case ENOTCONN:
+        return Errno::NOTCONN;
+    case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+        return Errno::AGAIN;
+    case ECONNREFUSED:
+        return Errno::CONNREFUSED;
+    case ECONNRESET:
+        return Errno::CONNRESET;
+    case ECONNABORTED:
+        return Errno::CONNABORTED;
+    case EINPROGRESS:
+        return Errno::INPROGRESS;
+    case EMSGSIZE:
+        return Errno::MSGSIZE;
+    case EPIPE:
+        return Errno::PIPE;
+    case ETIMEDOUT:
+        return Errno::TIMEDOUT;
+    default:
+        return Errno::OTHER;
+    }
+}
+
+#endif
+
+Errno GetAndLogLastError() {
+    const int e = LastError();
+    const Errno err = TranslateNativeError(e);
+    // Would block errors are the normal result of non-blocking sockets
+    if (err != Errno::AGAIN && err != Errno::INPROGRESS) {
+        LOG_ERROR(Network, "Socket operation error: {}", e);
+    }
+    return err;
+}
+
+sockaddr TranslateFromSockAddrIn(SockAddrIn input) {
+    sockaddr_in result{};
+    switch (input.family) {
+    case Domain::INET:
+        result.sin_family = AF_INET;
+        break;
+    default:
+        UNIMPLEMENTED_MSG("Unhandled sockaddr family={}", static_cast<int>(input.family));
+        result.sin_family = AF_INET;
+        break;
+    }
+    result.sin_port = htons(input.portno);
+    std::memcpy(&result.sin_addr, input.ip.data(), sizeof(input.ip));
+
+    sockaddr addr;
+    std::memcpy(&addr, &result, sizeof(result));
+    return addr;
+}
+
+SockAddrIn TranslateToSockAddrIn(const sockaddr& input_) {
+    sockaddr_in input;
+    std::memcpy(&input, &input_, sizeof(input));
+
+    SockAddrIn result{};
+    result.family = Domain::INET;
+    result.portno = ntohs(input.sin_port);
+    std::memcpy(result.ip.data(), &input.sin_addr, sizeof(result.ip));
+    return result;
+}
+
+short TranslatePollEvents(u16 events) {
+    short result = 0;
+    if ((events & PollEvents::In) != 0) {
+        result |= POLLIN;
+    }
+    if ((events & PollEvents::Pri) != 0) {
+#ifdef _WIN32
+        LOG_WARNING(Network, "Poll priority data is not supported on Windows");
+#else
+        result |= POLLPRI;
+#endif
+    }
+    if ((events & PollEvents::Out) != 0) {
+        result |= POLLOUT;
+    }
+    return result;
+}
+
+u16 TranslatePollRevents(short revents) {
+    u16 result = 0;
+    const auto translate = [&result, &revents](short host, u16 guest) {
+        if ((revents & host) != 0) {
+            revents &= static_cast<short>(~host);
+            result |= guest;
+        }
+    };
+    translate(POLLIN, PollEvents::In);
+    translate(POLLPRI, PollEvents::Pri);
+    translate(POLLOUT, PollEvents::Out);
+    translate(POLLERR, PollEvents::Err);
+    translate(POLLHUP, PollEvents::Hup);
+    translate(POLLNVAL, PollEvents::Nval);
+    UNIMPLEMENTED_IF_MSG(revents != 0, "Unhandled host poll revents=0x{:x}", revents);
+    return result;
+}
+
+int TranslateMessageFlags(u32 flags) {
+    int result = 0;
+    if ((flags & MessageFlags::Peek) != 0) {
+        result |= MSG_PEEK;
+        flags &= ~MessageFlags::Peek;
+    }
+    UNIMPLEMENTED_IF_MSG(flags != 0, "Unhandled message flags=0x{:x}", flags);
+    return result;
+}
+
+template <typename T>
+Errno SetSockOpt(Socket::SOCKET fd, int level, int option, T value) {
+    const int result = setsockopt(fd, level, option, reinterpret_cast<const char*>(&value),
+                                  static_cast<socklen_t>(sizeof(value)));
+    if (result != SOCKET_ERROR) {
+        return Errno::SUCCESS;
+    }
+    return GetAndLogLastError();
+}
+
+} // Anonymous namespace
+
+NetworkInstance::NetworkInstance() {
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+NetworkInstance::~NetworkInstance() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+std::pair<s32, Errno> Poll(std::vector<PollFD>& poll_fds, s32 timeout) {
+    std::vector<pollfd> host_fds(poll_fds.size());
+    std::transform(poll_fds.begin(), poll_fds.end(), host_fds.begin(), [](const PollFD& fd) {
+        pollfd result{};
+        result.fd = fd.socket->GetHandle();
+        result.events = TranslatePollEvents(fd.events);
+        return result;
+    });
+
+    const int result = HostPoll(host_fds.data(), host_fds.size(), timeout);
+    if (result == SOCKET_ERROR) {
+        return {-1, GetAndLogLastError()};
+    }
+    for (std::size_t i = 0; i < poll_fds.size(); ++i) {
+        poll_fds[i].revents = TranslatePollRevents(host_fds[i].revents);
+    }
+    return {result, Errno::SUCCESS};
+}
+
+Socket::~Socket() {
+    if (fd != INVALID_FD) {
+        CloseSocket(fd);
+    }
+}
+
+Errno Socket::Initialize(Domain domain, Type type, Protocol protocol) {
+    int host_type = SOCK_STREAM;
+    switch (type) {
+    case Type::STREAM:
+        host_type = SOCK_STREAM;
+        break;
+    case Type::DGRAM:
+        host_type = SOCK_DGRAM;
+        break;
+    case Type::RAW:
+        host_type = SOCK_RAW;
+        break;
+    case Type::SEQPACKET:
+        host_type = SOCK_SEQPACKET;
+        break;
+    }
+    int host_protocol = 0;
+    switch (protocol) {
+    case Protocol::UNSPECIFIED:
+        host_protocol = 0;
+        break;
+    case Protocol::ICMP:
+        host_protocol = IPPROTO_ICMP;
+        break;
+    case Protocol::TCP:
+        host_protocol = IPPROTO_TCP;
+        break;
+    case Protocol::UDP:
+        host_protocol = IPPROTO_UDP;
+        break;
+    }
+    ASSERT(domain == Domain::INET);
+
+    fd = socket(AF_INET, host_type, host_protocol);
+    if (fd == INVALID_FD) {
+        return GetAndLogLastError();
+    }
+    if (EnableNonBlock(fd) != Errno::SUCCESS) {
+        LOG_ERROR(Network, "Failed to make the socket non-blocking");
+        Close();
+        return Errno::OTHER;
+    }
+#ifdef SO_NOSIGPIPE
+    SetSockOpt<int>(fd, SOL_SOCKET, SO_NOSIGPIPE, 1);
+#endif
+    return Errno::SUCCESS;
+}
+
+Errno Socket::Close() {
+    [[maybe_unused]] const int result = CloseSocket(fd);
+    ASSERT(result == 0);
+    fd = INVALID_FD;
+    return Errno::SUCCESS;
+}
+
+std::pair<Socket::AcceptResult, Errno> Socket::Accept() {
+    sockaddr addr;
+    socklen_t addrlen = sizeof(addr);
+    const SOCKET new_socket = accept(fd, &addr, &addrlen);
+    if (new_socket == INVALID_FD) {
+        return {AcceptResult{}, GetAndLogLastError()};
+    }
+
+    // Accepted sockets don't inherit the non-blocking mode on every host
+    AcceptResult result;
+    result.socket.reset(new Socket(new_socket));
+    if (EnableNonBlock(new_socket) != Errno::SUCCESS) {
+        LOG_ERROR(Network, "Failed to make the accepted socket non-blocking");
+        return {AcceptResult{}, Errno::OTHER};
+    }
+    ASSERT(addrlen == sizeof(sockaddr_in));
+    result.sockaddr_in = TranslateToSockAddrIn(addr);
+    return {std::move(result), Errno::SUCCESS};
+}
+
+Errno Socket::Connect(SockAddrIn addr_in) {
+    const sockaddr host_addr_in = TranslateFromSockAddrIn(addr_in);
+    if (connect(fd, &host_addr_in, sizeof(host_addr_in)) != SOCKET_ERROR) {
+        return Errno::SUCCESS;
+    }
+    const Errno err = GetAndLogLastError();
+#ifdef _WIN32
+    // Winsock reports a pending connection as a would block error
+    if (err == Errno::AGAIN) {
+        return Errno::INPROGRESS;
+    }
+#endif
+    return err;
+}
+
+std::pair<SockAddrIn, Errno> Socket::GetPeerName() {
+    sockaddr addr;
+    socklen_t addrlen = sizeof(addr);
+    if (getpeername(fd, &addr, &addrlen) == SOCKET_ERROR) {
+        return {SockAddrIn{}, GetAndLogLastError()};
+    }
+    ASSERT(addrlen == sizeof(sockaddr_in));
+    return {TranslateToSockAddrIn(addr), Errno::SUCCESS};
+}
+
+std::pair<SockAddrIn, Errno> Socket::GetSockName() {
+    sockaddr addr;
+    socklen_t addrlen = sizeof(addr);
+    if (getsockname(fd, &addr, &addrlen) == SOCKET_ERROR) {
+        return {SockAddrIn{}, GetAndLogLastError()};
+    }
+    ASSERT(addrlen == sizeof(sockaddr_in));
+    return {TranslateToSockAddrIn(addr), Errno::SUCCESS};
+}
+
+Errno Socket::Bind(SockAddrIn addr) {
+    const sockaddr addr_in = TranslateFromSockAddrIn(addr);
+    if (bind(fd, &addr_in, sizeof(addr_in)) != SOCKET_ERROR) {
+        return Errno::SUCCESS;
+    }
+    return GetAndLogLastError();
+}
+
+Errno Socket::Listen(s32 backlog) {
+    if (listen(fd, backlog) != SOCKET_ERROR) {
+        return Errno::SUCCESS;
+    }
+    return GetAndLogLastError();
+}
+
+Errno Socket::Shutdown(ShutdownHow how) {
+    int host_how = 0;
+    switch (how) {
+    case ShutdownHow::RD:
+        host_how = SHUT_RD;
+        break;
+    case ShutdownHow::WR:
+        host_how = SHUT_WR;
+        break;
+    case ShutdownHow::RDWR:
+        host_how = SHUT_RDWR;
+        break;
+    }
+    if (shutdown(fd, host_how) != SOCKET_ERROR) {
+        return Errno::SUCCESS;
+    }
+    return GetAndLogLastError();
+}
+
+std::pair<s32, Errno> Socket::Recv(u32 flags, std::vector<u8>& message) {
+    ASSERT(message.size() < static_cast<std::size_t>(std::numeric_limits<int>::max()));
+
+    const auto result = recv(fd, reinterpret_cast<char*>(message.data()),
+                             static_cast<int>(message.size()), TranslateMessageFlags(flags));
+    if (result == SOCKET_ERROR) {
+        message.clear();
+        return {-1, GetAndLogLastError()};
+    }
+    message.resize(static_cast<std::size_t>(result));
+    return {static_cast<s32>(result), Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> Socket::RecvFrom(u32 flags, std::vector<u8>& message, SockAddrIn* addr) {
+    ASSERT(message.size() < static_cast<std::size_t>(std::numeric_limits<int>::max()));
+
+    sockaddr addr_in{};
+    socklen_t addrlen = sizeof(addr_in);
+    socklen_t* const p_addrlen = addr ? &addrlen : nullptr;
+    sockaddr* const p_addr_in = addr ? &addr_in : nullptr;
+
+    const auto result =
+        recvfrom(fd, reinterpret_cast<char*>(message.data()), static_cast<int>(message.size()),
+                 TranslateMessageFlags(flags), p_addr_in, p_addrlen);
+    if (result == SOCKET_ERROR) {
+        message.clear();
+        return {-1, GetAndLogLastError()};
+    }
+    if (addr) {
+        ASSERT(addrlen == sizeof(sockaddr_in));
+        *addr = TranslateToSockAddrIn(addr_in);
+    }
+    message.resize(static_cast<std::size_t>(result));
+    return {static_cast<s32>(result), Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> Socket::Send(const std::vector<u8>& message, u32 flags) {
+    ASSERT(message.size() < static_cast<std::size_t>(std::numeric_limits<int>::max()));
+
+    const auto result = send(fd, reinterpret_cast<const char*>(message.data()),
+                             static_cast<int>(message.size()),
+                             TranslateMessageFlags(flags) | SEND_FLAGS);
+    if (result == SOCKET_ERROR) {
+        return {-1, GetAndLogLastError()};
+    }
+    return {static_cast<s32>(result), Errno::SUCCESS};
+}
+
+std::pair<s32, Errno> Socket::SendTo(u32 flags, const std::vector<u8>& message,
+                                     const SockAddrIn* addr) {
+    ASSERT(message.size() < static_cast<std::size_t>(std::numeric_limits<int>::max()));
+
+    sockaddr host_addr_in;
+    const sockaddr* to = nullptr;
+    socklen_t tolen = 0;
+    if (addr) {
+        host_addr_in = TranslateFromSockAddrIn(*addr);
+        to = &host_addr_in;
+        tolen = sizeof(host_addr_in);
+    }
+
+    const auto result = sendto(fd, reinterpret_cast<const char*>(message.data()),
+                               static_cast<int>(message.size()),
+                               TranslateMessageFlags(flags) | SEND_FLAGS, to, tolen);
+    if (result == SOCKET_ERROR) {
+        return {-1, GetAndLogLastError()};
+    }
+    return {static_cast<s32>(result), Errno::SUCCESS};
+}
+
+Errno Socket::SetLinger(bool enable, u32 linger_time) {
+    linger value{};
+    value.l_onoff = enable ? 1 : 0;
+    value.l_linger = static_cast<decltype(value.l_linger)>(linger_time);
+    return SetSockOpt(fd, SOL_SOCKET, SO_LINGER, value);
+}
+
+Errno Socket::SetReuseAddr(bool enable) {
+    return SetSockOpt<int>(fd, SOL_SOCKET, SO_REUSEADDR, enable ? 1 : 0);
+}
+
+Errno Socket::SetKeepAlive(bool enable) {
+    return SetSockOpt<int>(fd, SOL_SOCKET, SO_KEEPALIVE, enable ? 1 : 0);
+}
+
+Errno Socket::SetBroadcast(bool enable) {
+    return SetSockOpt<int>(fd, SOL_SOCKET, SO_BROADCAST, enable ? 1 : 0);
+}
+
+Errno Socket::SetSndBuf(u32 value) {
+    return SetSockOpt<int>(fd, SOL_SOCKET, SO_SNDBUF, static_cast<int>(value));
+}
+
+Errno Socket::SetRcvBuf(u32 value) {
+    return SetSockOpt<int>(fd, SOL_SOCKET, SO_RCVBUF, static_cast<int>(value));
+}
+
+Errno Socket::SetNoDelay(bool enable) {
+    return SetSockOpt<int>(fd, IPPROTO_TCP, TCP_NODELAY, enable ? 1 : 0);
+}
+
+Errno Socket::GetPendingError() {
+    int value = 0;
+    socklen_t length = sizeof(value);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&value), &length) ==
+        SOCKET_ERROR) {
+        return GetAndLogLastError();
+    }
+    return value == 0 ? Errno::SUCCESS : TranslateNativeError(value);
+}
+
+bool Socket::IsOpened() const {
+    return fd != INVALID_FD;
+}
+
+} // namespace Network
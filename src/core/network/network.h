@@ -0,0 +1,192 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+
+/**
+ * Thin portable layer over the sockets of the host, BSD sockets or Winsock. Every socket created
+ * through it is non-blocking: blocking is emulated by the callers, so that no host call can stall
+ * the thread making it.
+ */
+namespace Network {
+
+class Socket;
+
+/// Error code for network functions
+enum class Errno {
+    SUCCESS,
+    BADF,
+    INVAL,
+    MFILE,
+    NOTCONN,
+    AGAIN,
+    CONNREFUSED,
+    CONNRESET,
+    CONNABORTED,
+    INPROGRESS,
+    MSGSIZE,
+    PIPE,
+    TIMEDOUT,
+    OTHER,
+};
+
+/// Address families
+enum class Domain {
+    INET,
+};
+
+/// Socket types
+enum class Type {
+    STREAM,
+    DGRAM,
+    RAW,
+    SEQPACKET,
+};
+
+/// Protocol values for sockets
+enum class Protocol {
+    UNSPECIFIED,
+    ICMP,
+    TCP,
+    UDP,
+};
+
+/// Shutdown mode
+enum class ShutdownHow {
+    RD,
+    WR,
+    RDWR,
+};
+
+using IPv4Address = std::array<u8, 4>;
+
+/// IPv4 socket address, the port is in host byte order
+struct SockAddrIn {
+    Domain family;
+    IPv4Address ip;
+    u16 portno;
+};
+
+/// Events of a PollFD, with the values used by the guest
+namespace PollEvents {
+constexpr u16 In = 1 << 0;
+constexpr u16 Pri = 1 << 1;
+constexpr u16 Out = 1 << 2;
+constexpr u16 Err = 1 << 3;
+constexpr u16 Hup = 1 << 4;
+constexpr u16 Nval = 1 << 5;
+} // namespace PollEvents
+
+struct PollFD {
+    Socket* socket;
+    u16 events;
+    u16 revents;
+};
+
+/// Message flags, with the values used by the guest
+namespace MessageFlags {
+constexpr u32 Peek = 0x2;
+} // namespace MessageFlags
+
+/// Initializes the network stack of the host for as long as the object is alive.
+class NetworkInstance {
+public:
+    explicit NetworkInstance();
+    ~NetworkInstance();
+};
+
+/**
+ * Waits for events on the given sockets.
+ * @param timeout Timeout in milliseconds, a negative value waits forever.
+ * @returns The number of sockets with events, and the error of the host call.
+ */
+std::pair<s32, Errno> Poll(std::vector<PollFD>& poll_fds, s32 timeout);
+
+class Socket {
+public:
+#ifdef _WIN32
+    using SOCKET = std::uintptr_t;
+    static constexpr SOCKET INVALID_FD = ~static_cast<SOCKET>(0);
+#else
+    using SOCKET = int;
+    static constexpr SOCKET INVALID_FD = -1;
+#endif
+
+    struct AcceptResult {
+        std::unique_ptr<Socket> socket;
+        SockAddrIn sockaddr_in;
+    };
+
+    explicit Socket() = default;
+    ~Socket();
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    Errno Initialize(Domain domain, Type type, Protocol protocol);
+
+    Errno Close();
+
+    std::pair<AcceptResult, Errno> Accept();
+
+    /// Starts connecting, a stream socket returns Errno::INPROGRESS when it has to wait.
+    Errno Connect(SockAddrIn addr_in);
+
+    std::pair<SockAddrIn, Errno> GetPeerName();
+
+    std::pair<SockAddrIn, Errno> GetSockName();
+
+    Errno Bind(SockAddrIn addr);
+
+    Errno Listen(s32 backlog);
+
+    Errno Shutdown(ShutdownHow how);
+
+    /// Receives into message, which is shrunk to the received size.
+    std::pair<s32, Errno> Recv(u32 flags, std::vector<u8>& message);
+
+    std::pair<s32, Errno> RecvFrom(u32 flags, std::vector<u8>& message, SockAddrIn* addr);
+
+    std::pair<s32, Errno> Send(const std::vector<u8>& message, u32 flags);
+
+    std::pair<s32, Errno> SendTo(u32 flags, const std::vector<u8>& message, const SockAddrIn* addr);
+
+    Errno SetLinger(bool enable, u32 linger_time);
+
+    Errno SetReuseAddr(bool enable);
+
+    Errno SetKeepAlive(bool enable);
+
+    Errno SetBroadcast(bool enable);
+
+    Errno SetSndBuf(u32 value);
+
+    Errno SetRcvBuf(u32 value);
+
+    Errno SetNoDelay(bool enable);
+
+    /// Returns and clears the pending error of the socket, like the result of a connection.
+    Errno GetPendingError();
+
+    bool IsOpened() const;
+
+    SOCKET GetHandle() const {
+        return fd;
+    }
+
+private:
+    explicit Socket(SOCKET fd_) : fd{fd_} {}
+
+    SOCKET fd = INVALID_FD;
+};
+
+} // namespace Network
@@ -9,10 +9,17 @@
 #include <numeric>
 #include <sstream>
 #include <thread>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 #include <fmt/chrono.h>
 #include <fmt/format.h>
+#include "audio_core/perf_counters.h"
 #include "common/file_util.h"
+#include "common/logging/log.h"
 #include "common/math_util.h"
+#include "core/frame_timeline.h"
+#include "core/frontend/input_latency.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
 
@@ -27,6 +34,82 @@ constexpr std::size_t IgnoreFrames = 5;
 
 namespace Core {
 
+namespace {
+
+#ifdef _WIN32
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+/// Sleeps on a waitable timer, which can be far more precise than Sleep on Windows 10 and later
+class Sleeper {
+public:
+    Sleeper() {
+        timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                       TIMER_ALL_ACCESS);
+        if (timer) {
+            margin = 1ms;
+            return;
+        }
+        // Older versions only wake up on scheduler ticks
+        timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        margin = 2ms;
+    }
+
+    ~Sleeper() {
+        if (timer) {
+            CloseHandle(timer);
+        }
+    }
+
+    void Sleep(microseconds duration) {
+        LARGE_INTEGER due_time;
+        // Negative times are relative, in 100 ns units
+        due_time.QuadPart = -static_cast<LONGLONG>(duration.count()) * 10;
+        if (!timer || !SetWaitableTimer(timer, &due_time, 0, nullptr, nullptr, FALSE)) {
+            std::this_thread::sleep_for(duration);
+            return;
+        }
+        WaitForSingleObject(timer, INFINITE);
+    }
+
+    /// How early the sleep has to end so it doesn't overshoot
+    microseconds margin;
+
+private:
+    HANDLE timer;
+};
+#else
+class Sleeper {
+public:
+    void Sleep(microseconds duration) {
+        std::this_thread::sleep_for(duration);
+    }
+
+    /// How early the sleep has to end so it doesn't overshoot
+    microseconds margin{300};
+};
+#endif
+
+/// Sleeps coarsely until shortly before the deadline, then spins for the rest
+void SleepUntil(FrameLimiter::Clock::time_point deadline) {
+    thread_local Sleeper sleeper;
+    const auto coarse = duration_cast<microseconds>(deadline - FrameLimiter::Clock::now()) -
+                        sleeper.margin;
+    if (coarse > microseconds::zero()) {
+        sleeper.Sleep(coarse);
+    }
+    while (FrameLimiter::Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+s64 ToNanoseconds(FrameLimiter::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // Anonymous namespace
+
 PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
 
 PerfStats::~PerfStats() {
@@ -44,6 +127,29 @@ PerfStats::~PerfStats() {
         fmt::format("{}/{:%F-%H-%M}_{:016X}.csv", path, *std::localtime(&t), title_id);
     FileUtil::IOFile file(filename, "w");
     file.WriteString(stream.str());
+
+    WriteFrameTimeline(fmt::format("{}/{:%F-%H-%M}_{:016X}_timeline.csv", path,
+                                   *std::localtime(&t), title_id));
+}
+
+void PerfStats::WriteFrameTimeline(const std::string& filename) {
+    using Stage = FrameTimeline::Stage;
+    const auto frames = FrameTimeline::GetInstance().TakeRecordedFrames();
+
+    std::ostringstream stream;
+    for (std::size_t stage = 0; stage < FrameTimeline::NUM_STAGES; ++stage) {
+        stream << (stage == 0 ? "" : ",") << FrameTimeline::GetStageName(static_cast<Stage>(stage));
+    }
+    stream << '\n';
+    for (std::size_t frame = IgnoreFrames; frame < frames.size(); ++frame) {
+        for (std::size_t stage = 0; stage < FrameTimeline::NUM_STAGES; ++stage) {
+            // Milliseconds, like the frame times
+            stream << (stage == 0 ? "" : ",") << frames[frame][stage] * 1000.0;
+        }
+        stream << '\n';
+    }
+    FileUtil::IOFile file(filename, "w");
+    file.WriteString(stream.str());
 }
 
 void PerfStats::BeginSystemFrame() {
@@ -63,6 +169,7 @@ void PerfStats::EndSystemFrame() {
     }
     accumulated_frametime += frame_time;
     system_frames += 1;
+    FrameTimeline::GetInstance().EndFrame(Settings::values.record_frame_times && title_id != 0);
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
@@ -101,6 +208,39 @@ PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
 
+    using AudioStage = AudioCore::PerfCounters::Stage;
+    const auto audio = AudioCore::PerfCounters::GetInstance().GetAndReset(interval);
+    const auto audio_stage_time = [&audio](AudioStage stage) {
+        return audio.stage_times[static_cast<std::size_t>(stage)];
+    };
+    results.audio_voices = audio.active_voices;
+    results.audio_samples_per_second = audio.samples_per_second;
+    results.audio_decode_time = audio_stage_time(AudioStage::Decode);
+    results.audio_resample_time = audio_stage_time(AudioStage::Resample);
+    results.audio_mix_time = audio_stage_time(AudioStage::Mix);
+    results.audio_effects_time = audio_stage_time(AudioStage::Effects);
+    results.audio_underruns = audio.underruns;
+
+    const auto input_latency = Input::Latency::GetAndResetStats();
+    results.input_latency = input_latency.mean;
+    results.input_latency_max = input_latency.max;
+
+    using Stage = FrameTimeline::Stage;
+    const auto timeline = FrameTimeline::GetInstance().GetAndReset();
+    const auto stage_time = [&timeline](Stage stage) {
+        return timeline[static_cast<std::size_t>(stage)];
+    };
+    results.cpu_jit_time = stage_time(Stage::Jit);
+    results.cpu_svc_time = stage_time(Stage::Svc);
+    results.cpu_hle_time = stage_time(Stage::Hle);
+    results.cpu_idle_time = stage_time(Stage::Idle);
+    results.gpu_dma_time = stage_time(Stage::DmaParse);
+    results.gpu_macro_time = stage_time(Stage::Macro);
+    results.gpu_draw_time = stage_time(Stage::DrawSetup);
+    results.gpu_shader_time = stage_time(Stage::ShaderCompile);
+    results.gpu_texture_time = stage_time(Stage::TextureCache);
+    results.host_gpu_time = stage_time(Stage::HostGpu);
+
     // Reset counters
     reset_point = now;
     reset_point_system_us = current_system_time_us;
@@ -141,7 +281,13 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
         std::clamp(frame_limiting_delta_err, -max_lag_time_us, max_lag_time_us);
 
     if (frame_limiting_delta_err > microseconds::zero()) {
-        std::this_thread::sleep_for(frame_limiting_delta_err);
+        FrameTimeline::ScopedTimer idle_timer{FrameTimeline::Stage::Idle};
+        auto deadline = now + frame_limiting_delta_err;
+        if (Settings::values.align_frame_limit_to_vsync) {
+            // The error accounting below absorbs the difference over the next frames
+            deadline = NearestHostVsync(deadline).value_or(deadline);
+        }
+        SleepUntil(deadline);
         auto now_after_sleep = Clock::now();
         frame_limiting_delta_err -= duration_cast<microseconds>(now_after_sleep - now);
         now = now_after_sleep;
@@ -151,4 +297,43 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     previous_walltime = now;
 }
 
+void FrameLimiter::OnHostPresent(Clock::time_point time) {
+    // Intervals out of this range are hitches or skipped presents, not refreshes
+    constexpr s64 MIN_PERIOD = 4'000'000;
+    constexpr s64 MAX_PERIOD = 50'000'000;
+
+    const s64 present = ToNanoseconds(time);
+    const s64 previous = last_present_ns.exchange(present, std::memory_order_relaxed);
+    const s64 interval = present - previous;
+    if (previous == 0 || interval < MIN_PERIOD || interval > MAX_PERIOD) {
+        return;
+    }
+    const s64 period = present_period_ns.load(std::memory_order_relaxed);
+    present_period_ns.store(period == 0 ? interval : period + (interval - period) / 16,
+                            std::memory_order_relaxed);
+}
+
+std::optional<FrameLimiter::Clock::time_point> FrameLimiter::NearestHostVsync(
+    Clock::time_point time) const {
+    // Presents older than this don't tell where the display is anymore
+    constexpr s64 MAX_AGE = 1'000'000'000;
+
+    const s64 period = present_period_ns.load(std::memory_order_relaxed);
+    const s64 last_present = last_present_ns.load(std::memory_order_relaxed);
+    const s64 offset = ToNanoseconds(time) - last_present;
+    if (period == 0 || offset < 0 || offset > MAX_AGE) {
+        return std::nullopt;
+    }
+    const s64 vsync = last_present + (offset + period / 2) / period * period;
+    return Clock::time_point(std::chrono::nanoseconds(vsync));
+}
+
+BootStageTimer::BootStageTimer(std::string_view name) : name{name} {}
+
+BootStageTimer::~BootStageTimer() {
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    LOG_INFO(Core, "Boot stage {} took {} ms", name,
+             duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
 } // namespace Core
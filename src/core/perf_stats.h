@@ -5,9 +5,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
 #include "common/common_types.h"
 
 namespace Core {
@@ -21,6 +25,62 @@ struct PerfStatsResults {
     double frametime;
     /// Ratio of walltime / emulated time elapsed
     double emulation_speed;
+    /// Voices mixed into the last audio renderer buffer
+    u32 audio_voices;
+    /// Voice samples mixed by the audio renderers per second of walltime
+    double audio_samples_per_second;
+    /// Walltime per audio renderer update spent decoding wave buffers, in seconds
+    double audio_decode_time;
+    /// Walltime per audio renderer update spent resampling voices, in seconds
+    double audio_resample_time;
+    /// Walltime per audio renderer update spent mixing voices, in seconds
+    double audio_mix_time;
+    /// Walltime per audio renderer update spent on effects, in seconds
+    double audio_effects_time;
+    /// Number of times the audio sink ran out of samples
+    u64 audio_underruns;
+    /// Mean walltime between a guest syncpoint wait and the GPU reaching the syncpoint, in seconds
+    double syncpt_wait_time;
+    /// Number of guest syncpoint waits the GPU completed
+    u32 syncpt_waits;
+    /// Number of Fermi2D surface copies performed by the host GPU
+    u32 gpu_accelerated_blits;
+    /// Number of Fermi2D surface copies the host GPU couldn't perform
+    u32 gpu_unhandled_blits;
+    /// Number of texture cache overlaps resolved with host GPU copies
+    u32 gpu_resolved_overlaps;
+    /// Number of texture cache overlaps flushed to guest memory and reloaded
+    u32 gpu_flushed_overlaps;
+    /// Guest bytes per frame whose texture upload was skipped because they didn't change
+    u64 gpu_skipped_upload_bytes;
+    /// Bytes per frame uploaded to the stream buffer
+    u64 gpu_uploaded_buffer_bytes;
+    /// Const buffer bytes per frame whose previous upload was reused
+    u64 gpu_reused_const_buffer_bytes;
+    /// Mean walltime between a host input event and the HID update that shows it, in seconds
+    double input_latency;
+    /// Largest walltime between a host input event and the HID update that shows it, in seconds
+    double input_latency_max;
+    /// Walltime per system frame the emulated cores spent running guest code, in seconds
+    double cpu_jit_time;
+    /// Walltime per system frame the emulated cores spent handling SVCs, in seconds
+    double cpu_svc_time;
+    /// Walltime per system frame the emulated cores spent in HLE services, in seconds
+    double cpu_hle_time;
+    /// Walltime per system frame the emulated cores spent idle or frame limiting, in seconds
+    double cpu_idle_time;
+    /// Walltime per system frame the GPU thread spent decoding command lists, in seconds
+    double gpu_dma_time;
+    /// Walltime per system frame the GPU thread spent executing macros, in seconds
+    double gpu_macro_time;
+    /// Walltime per system frame the GPU thread spent setting up draws, in seconds
+    double gpu_draw_time;
+    /// Walltime per system frame the GPU thread spent building shaders and pipelines, in seconds
+    double gpu_shader_time;
+    /// Walltime per system frame the GPU thread spent in the texture cache, in seconds
+    double gpu_texture_time;
+    /// Host GPU time per presented frame, in seconds. Lags a few frames behind
+    double host_gpu_time;
 };
 
 /**
@@ -53,6 +113,9 @@ public:
     double GetLastFrameTimeScale();
 
 private:
+    /// Writes the stage breakdown of the recorded frames as CSV
+    static void WriteFrameTimeline(const std::string& filename);
+
     std::mutex object_mutex{};
 
     /// Title ID for the game that is running. 0 if there is no game running yet
@@ -85,11 +148,25 @@ private:
 
 class FrameLimiter {
 public:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = std::chrono::steady_clock;
 
     void DoFrameLimiting(std::chrono::microseconds current_system_time_us);
 
+    /**
+     * Reports when the presenter handed a frame to the host display. With vsync these times
+     * follow the refresh of the display, which the waits can then be aligned to.
+     * @note This function is thread-safe
+     */
+    void OnHostPresent(Clock::time_point time);
+
 private:
+    /// Returns the host vsync nearest to the given time, if the refresh rate is known.
+    std::optional<Clock::time_point> NearestHostVsync(Clock::time_point time) const;
+
+    /// Last host present and estimated refresh period, in nanoseconds of Clock. Zero when unknown
+    std::atomic<s64> last_present_ns{0};
+    std::atomic<s64> present_period_ns{0};
+
     /// Emulated system time (in microseconds) at the last limiter invocation
     std::chrono::microseconds previous_system_time_us{0};
     /// Walltime at the last limiter invocation
@@ -99,4 +176,21 @@ private:
     std::chrono::microseconds frame_limiting_delta_err{0};
 };
 
+/**
+ * Measures a stage of the boot process, from its construction to its destruction, and logs how
+ * long it took. Stages can be measured concurrently from any thread.
+ */
+class BootStageTimer {
+public:
+    explicit BootStageTimer(std::string_view name);
+    ~BootStageTimer();
+
+    BootStageTimer(const BootStageTimer&) = delete;
+    BootStageTimer& operator=(const BootStageTimer&) = delete;
+
+private:
+    std::string_view name;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+};
+
 } // namespace Core
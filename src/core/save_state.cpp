@@ -0,0 +1,86 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/vm_manager.h"
+#include "core/save_state.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
+
+namespace Core {
+
+namespace {
+
+/// Drops everything the GPU cached from the memory of the process, while the host pointers it
+/// was cached with are still valid
+void InvalidateGpuCaches(Kernel::Process& process, Tegra::GPU& gpu) {
+    const auto& vm_manager = process.VMManager();
+    for (auto vma = vm_manager.FindVMA(vm_manager.GetAddressSpaceBaseAddress());
+         vm_manager.IsValidHandle(vma); ++vma) {
+        const auto& area = vma->second;
+        if (area.type == Kernel::VMAType::AllocatedMemoryBlock) {
+            gpu.InvalidateRegion(ToCacheAddr(area.backing_block->data() + area.offset), area.size);
+        }
+    }
+}
+
+} // Anonymous namespace
+
+SaveState::SaveState(System& system)
+    : process{SharedFrom(system.CurrentProcess())},
+      gpu_engines{std::make_unique<Tegra::Capture::EngineState>()} {
+    auto& kernel = system.Kernel();
+    auto& gpu = system.GPU();
+    gpu.WaitIdle();
+
+    // The running threads have their registers written back by their scheduler first
+    for (std::size_t core = 0; core < schedulers.size(); ++core) {
+        schedulers[core] = system.Scheduler(core).TakeSnapshot();
+    }
+    const auto& thread_list = kernel.GlobalScheduler().GetThreadList();
+    threads.reserve(thread_list.size());
+    for (const auto& thread : thread_list) {
+        threads.emplace_back(thread, thread->TakeSnapshot());
+    }
+    global_scheduler = kernel.GlobalScheduler().TakeSnapshot();
+    thread_wakeup_handles = kernel.ThreadWakeupCallbackHandleTable().TakeSnapshot();
+    process_snapshot = process->TakeSnapshot();
+    core_timing = system.CoreTiming().TakeSnapshot();
+    gpu.SaveState(*gpu_engines);
+}
+
+SaveState::~SaveState() = default;
+
+bool SaveState::Restore(System& system) const {
+    auto& kernel = system.Kernel();
+    if (process.get() != kernel.CurrentProcess()) {
+        LOG_ERROR(Core, "The save state belongs to an application that isn't running anymore");
+        return false;
+    }
+    auto& gpu = system.GPU();
+    gpu.WaitIdle();
+    InvalidateGpuCaches(*process, gpu);
+
+    // Threads created since the snapshot are left out of the restored lists and queues, and are
+    // destroyed once the last reference to them is gone
+    process->RestoreSnapshot(*process_snapshot);
+    for (const auto& [thread, snapshot] : threads) {
+        thread->RestoreSnapshot(snapshot);
+    }
+    kernel.GlobalScheduler().RestoreSnapshot(global_scheduler);
+    kernel.ThreadWakeupCallbackHandleTable().RestoreSnapshot(thread_wakeup_handles);
+    for (std::size_t core = 0; core < schedulers.size(); ++core) {
+        system.Scheduler(core).RestoreSnapshot(schedulers[core]);
+    }
+    system.CoreTiming().RestoreSnapshot(core_timing);
+    gpu.LoadState(*gpu_engines);
+
+    // The code of the process may have been modified since the snapshot
+    system.InvalidateCpuInstructionCaches();
+    return true;
+}
+
+} // namespace Core
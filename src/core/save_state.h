@@ -0,0 +1,61 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/core_timing.h"
+#include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/scheduler.h"
+#include "core/hle/kernel/thread.h"
+
+namespace Tegra::Capture {
+struct EngineState;
+}
+
+namespace Core {
+
+class System;
+
+/**
+ * In-memory snapshot of the emulated application, restorable in the session it was taken in.
+ *
+ * It covers the address space and memory of the process, its handles, the threads with their
+ * registers and the scheduler queues, the state of the objects the threads wait on, the pending
+ * timing events and the registers of the GPU engines. The kernel objects are kept alive by the
+ * snapshot, so restoring it hands the guest back the same objects it had at that point.
+ *
+ * The state kept by the HLE services and the GPU address space, which belongs to nvdrv, are not
+ * part of it and stay as they are. Restoring is reliable as long as the guest didn't make service
+ * calls since the snapshot that it would expect to be undone.
+ */
+class SaveState {
+public:
+    /// Takes the snapshot. Has to be called from the emulation thread between two runs of the
+    /// CPU cores, while they are all stopped.
+    explicit SaveState(System& system);
+    ~SaveState();
+
+    /// Returns the system to the snapshot, with the same requirements as taking it. The snapshot
+    /// can be restored any number of times. Returns false, leaving the system untouched, when the
+    /// application it was taken from isn't running anymore.
+    bool Restore(System& system) const;
+
+private:
+    std::shared_ptr<Kernel::Process> process;
+    std::shared_ptr<const Kernel::Process::Snapshot> process_snapshot;
+    std::vector<std::pair<std::shared_ptr<Kernel::Thread>, Kernel::Thread::Snapshot>> threads;
+    Kernel::GlobalScheduler::Snapshot global_scheduler;
+    std::array<Kernel::Scheduler::Snapshot, Kernel::GlobalScheduler::NUM_CPU_CORES> schedulers;
+    Kernel::HandleTable::Snapshot thread_wakeup_handles;
+    Timing::CoreTiming::Snapshot core_timing;
+    std::unique_ptr<Tegra::Capture::EngineState> gpu_engines;
+};
+
+} // namespace Core
@@ -87,24 +87,51 @@ void LogSettings() {
     LogSetting("System_CurrentUser", Settings::values.current_user);
     LogSetting("System_LanguageIndex", Settings::values.language_index);
     LogSetting("Core_UseMultiCore", Settings::values.use_multi_core);
+    LogSetting("Core_UseHostTiming", Settings::values.use_host_timing);
+    LogSetting("Core_UseIdleSkip", Settings::values.use_idle_skip);
+    LogSetting("Core_PreemptionQuantum", Settings::values.preemption_quantum);
+    LogSetting("Core_MigrationCost", Settings::values.migration_cost);
+    LogSetting("Controls_HidSamplingRate", Settings::values.hid_sampling_rate);
     LogSetting("Renderer_UseResolutionFactor", Settings::values.resolution_factor);
+    LogSetting("Renderer_VulkanPresentMode",
+               static_cast<int>(Settings::values.vulkan_present_mode));
+    LogSetting("Renderer_VulkanFramesInFlight", Settings::values.vulkan_frames_in_flight);
     LogSetting("Renderer_UseFrameLimit", Settings::values.use_frame_limit);
     LogSetting("Renderer_FrameLimit", Settings::values.frame_limit);
+    LogSetting("Renderer_AlignFrameLimitToVsync", Settings::values.align_frame_limit_to_vsync);
+    LogSetting("Renderer_VramBudget", Settings::values.vram_budget);
     LogSetting("Renderer_UseDiskShaderCache", Settings::values.use_disk_shader_cache);
+    LogSetting("Renderer_UseAsynchronousShaders", Settings::values.use_asynchronous_shaders);
+    LogSetting("Renderer_UseAssemblyShaders", Settings::values.use_assembly_shaders);
     LogSetting("Renderer_UseAccurateGpuEmulation", Settings::values.use_accurate_gpu_emulation);
+    LogSetting("Renderer_UseThreadedPresentation", Settings::values.use_threaded_presentation);
     LogSetting("Renderer_UseAsynchronousGpuEmulation",
                Settings::values.use_asynchronous_gpu_emulation);
+    LogSetting("Renderer_DisableMacroCompiler", Settings::values.disable_macro_compiler);
+    LogSetting("Renderer_ValidateMacroCompiler", Settings::values.validate_macro_compiler);
+    LogSetting("Renderer_UseAdaptiveComposition", Settings::values.use_adaptive_composition);
+    LogSetting("Renderer_UseExtraHostBuffer", Settings::values.use_extra_host_buffer);
+    LogSetting("Renderer_UseTextureHashing", Settings::values.use_texture_hashing);
     LogSetting("Audio_OutputEngine", Settings::values.sink_id);
     LogSetting("Audio_EnableAudioStretching", Settings::values.enable_audio_stretching);
+    LogSetting("Audio_UseAsynchronousAudioDecoding",
+               Settings::values.use_asynchronous_audio_decoding);
     LogSetting("Audio_OutputDevice", Settings::values.audio_device_id);
     LogSetting("DataStorage_UseVirtualSd", Settings::values.use_virtual_sd);
     LogSetting("DataStorage_NandDir", FileUtil::GetUserPath(FileUtil::UserPath::NANDDir));
     LogSetting("DataStorage_SdmcDir", FileUtil::GetUserPath(FileUtil::UserPath::SDMCDir));
+    LogSetting("DataStorage_NcaCacheSize", Settings::values.nca_cache_size);
+    LogSetting("DataStorage_UseSharedContentCache", Settings::values.use_shared_content_cache);
     LogSetting("Debugging_UseGdbstub", Settings::values.use_gdbstub);
     LogSetting("Debugging_GdbstubPort", Settings::values.gdbstub_port);
     LogSetting("Debugging_ProgramArgs", Settings::values.program_args);
+    LogSetting("Debugging_GpuCaptureStartFrame", Settings::values.gpu_capture_start_frame);
+    LogSetting("Debugging_GpuCaptureFrames", Settings::values.gpu_capture_frames);
+    LogSetting("Debugging_FrameCaptureCommand", Settings::values.frame_capture_command);
     LogSetting("Services_BCATBackend", Settings::values.bcat_backend);
     LogSetting("Services_BCATBoxcatLocal", Settings::values.bcat_boxcat_local);
+    LogSetting("Services_LDNRelayAddress", Settings::values.ldn_relay_address);
+    LogSetting("Services_LDNRelayPort", Settings::values.ldn_relay_port);
 }
 
 } // namespace Settings
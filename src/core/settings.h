@@ -374,6 +374,14 @@ enum class SDMCSize : u64 {
 enum class RendererBackend {
     OpenGL = 0,
     Vulkan = 1,
+    Null = 2, ///< Renders nothing, for running without a host GPU
+};
+
+enum class VulkanPresentMode {
+    Automatic = 0, ///< FIFO when the frame limit is aligned to vsync, mailbox otherwise
+    Fifo = 1,
+    Mailbox = 2,
+    Immediate = 3,
 };
 
 struct Values {
@@ -405,6 +413,7 @@ struct Values {
 
     std::string motion_device;
     TouchscreenInput touchscreen;
+    u16 hid_sampling_rate;
     std::atomic_bool is_device_reload_pending{true};
     std::string udp_input_address;
     u16 udp_input_port;
@@ -412,12 +421,18 @@ struct Values {
 
     // Core
     bool use_multi_core;
+    bool use_host_timing;
+    bool use_idle_skip;
+    u16 preemption_quantum; ///< Milliseconds between two thread preemptions
+    u32 migration_cost;     ///< Microseconds after running during which a thread isn't migrated
 
     // Data Storage
     bool use_virtual_sd;
     bool gamecard_inserted;
     bool gamecard_current_game;
     std::string gamecard_path;
+    u32 nca_cache_size; ///< Memory budget of the decrypted NCA sector cache, in MiB
+    bool use_shared_content_cache; ///< Shares decrypted content with other running instances
     NANDTotalSize nand_total_size;
     NANDSystemSize nand_system_size;
     NANDUserSize nand_user_size;
@@ -427,14 +442,26 @@ struct Values {
     RendererBackend renderer_backend;
     bool renderer_debug;
     int vulkan_device;
+    VulkanPresentMode vulkan_present_mode;
+    u32 vulkan_frames_in_flight;
 
     float resolution_factor;
     bool use_frame_limit;
     u16 frame_limit;
+    bool align_frame_limit_to_vsync;
+    u32 vram_budget;
     bool use_disk_shader_cache;
+    bool use_asynchronous_shaders;
+    bool use_assembly_shaders;
     bool use_accurate_gpu_emulation;
     bool use_asynchronous_gpu_emulation;
+    bool use_threaded_presentation;
+    bool disable_macro_compiler;
+    bool validate_macro_compiler;
     bool force_30fps_mode;
+    bool use_adaptive_composition;
+    bool use_extra_host_buffer;
+    bool use_texture_hashing;
 
     float bg_red;
     float bg_green;
@@ -447,16 +474,21 @@ struct Values {
     // Audio
     std::string sink_id;
     bool enable_audio_stretching;
+    bool use_asynchronous_audio_decoding;
     std::string audio_device_id;
     float volume;
 
     // Debugging
     bool record_frame_times;
+    u32 gpu_capture_start_frame;
+    u32 gpu_capture_frames;
+    std::string frame_capture_command; ///< Encoder fed the presented frames, disabled when empty
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string program_args;
     bool dump_exefs;
     bool dump_nso;
+    bool verify_nso_hashes;
     bool reporting_services;
     bool quest_flag;
 
@@ -464,6 +496,10 @@ struct Values {
     std::string bcat_backend;
     bool bcat_boxcat_local;
 
+    // LDN
+    std::string ldn_relay_address;
+    u16 ldn_relay_port;
+
     // WebService
     bool enable_telemetry;
     std::string web_api_url;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -50,6 +51,20 @@ void MemoryWriteWidth(Memory::Memory& memory, u32 width, VAddr addr, u64 value)
     }
 }
 
+/// Whether memory still holds the frozen value, for the entries that can be checked for free.
+bool HoldsFrozenValue(Memory::Memory& memory, const Freezer::Entry& entry) {
+    // Reading rasterizer cached memory would flush it from the GPU on every tick, those entries
+    // are always rewritten instead.
+    const u8* const pointer = memory.GetContiguousPointer(entry.address, entry.width);
+    if (pointer == nullptr) {
+        return false;
+    }
+    u64 current = 0;
+    std::memcpy(&current, pointer, entry.width);
+    const u64 mask = entry.width >= sizeof(u64) ? ~0ULL : (1ULL << (entry.width * 8)) - 1;
+    return current == (entry.value & mask);
+}
+
 } // Anonymous namespace
 
 Freezer::Freezer(Core::Timing::CoreTiming& core_timing_, Memory::Memory& memory_)
@@ -166,6 +181,10 @@ void Freezer::FrameCallback(u64 userdata, s64 cycles_late) {
     std::lock_guard lock{entries_mutex};
 
     for (const auto& entry : entries) {
+        // Rewriting an unchanged value would still invalidate the caches of its page
+        if (HoldsFrozenValue(memory, entry)) {
+            continue;
+        }
         LOG_DEBUG(Common_Memory,
                   "Enforcing memory freeze at address={:016X}, value={:016X}, width={:02X}",
                   entry.address, entry.value, entry.width);
@@ -6,6 +6,7 @@
 #include <list>
 #include <mutex>
 #include <utility>
+#include "core/frontend/input_latency.h"
 #include "input_common/keyboard.h"
 
 namespace InputCommon {
@@ -81,10 +82,12 @@ std::unique_ptr<Input::ButtonDevice> Keyboard::Create(const Common::ParamPackage
 
 void Keyboard::PressKey(int key_code) {
     key_button_list->ChangeKeyStatus(key_code, true);
+    Input::Latency::RecordEvent();
 }
 
 void Keyboard::ReleaseKey(int key_code) {
     key_button_list->ChangeKeyStatus(key_code, false);
+    Input::Latency::RecordEvent();
 }
 
 void Keyboard::ReleaseAllKeys() {
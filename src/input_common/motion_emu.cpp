@@ -5,31 +5,22 @@
 #include <algorithm>
 #include <chrono>
 #include <mutex>
-#include <thread>
 #include <tuple>
 #include "common/math_util.h"
 #include "common/quaternion.h"
-#include "common/thread.h"
 #include "common/vector_math.h"
 #include "input_common/motion_emu.h"
 
 namespace InputCommon {
 
-// Implementation class of the motion emulation device
+// Implementation class of the motion emulation device. The sensor state is computed when it is
+// read, from the tilt at that time, so it follows whatever rate the guest samples it at.
 class MotionEmuDevice {
 public:
     MotionEmuDevice(int update_millisecond, float sensitivity)
-        : update_millisecond(update_millisecond),
-          update_duration(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        : update_duration(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
               std::chrono::milliseconds(update_millisecond))),
-          sensitivity(sensitivity), motion_emu_thread(&MotionEmuDevice::MotionEmuThread, this) {}
-
-    ~MotionEmuDevice() {
-        if (motion_emu_thread.joinable()) {
-            shutdown_event.Set();
-            motion_emu_thread.join();
-        }
-    }
+          sensitivity(sensitivity) {}
 
     void BeginTilt(int x, int y) {
         mouse_origin = Common::MakeVec(x, y);
@@ -58,11 +49,44 @@ public:
 
     std::tuple<Common::Vec3<float>, Common::Vec3<float>> GetStatus() {
         std::lock_guard guard{status_mutex};
+
+        // Reads closer together than the update period return the same state, so the angular
+        // rate isn't computed from a tilt that barely had time to change
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = now - update_time;
+        if (elapsed < update_duration) {
+            return status;
+        }
+        update_time = now;
+
+        const Common::Quaternion<float> old_q = q;
+        {
+            std::lock_guard tilt_guard{tilt_mutex};
+
+            // Find the quaternion describing current 3DS tilting
+            q = Common::MakeQuaternion(
+                Common::MakeVec(-tilt_direction.y, 0.0f, tilt_direction.x), tilt_angle);
+        }
+
+        auto inv_q = q.Inverse();
+
+        // Set the gravity vector in world space
+        auto gravity = Common::MakeVec(0.0f, -1.0f, 0.0f);
+
+        // Find the angular rate vector in world space, in degrees per second. A tilt that went
+        // unread for long ends up in a single read, spread over the whole time
+        auto angular_rate = ((q - old_q) * inv_q).xyz * 2;
+        angular_rate *= 1.0f / std::chrono::duration<float>(elapsed).count() / Common::PI * 180;
+
+        // Transform the two vectors from world space to 3DS space
+        gravity = QuaternionRotate(inv_q, gravity);
+        angular_rate = QuaternionRotate(inv_q, angular_rate);
+
+        status = std::make_tuple(gravity, angular_rate);
         return status;
     }
 
 private:
-    const int update_millisecond;
     const std::chrono::steady_clock::duration update_duration;
     const float sensitivity;
 
@@ -74,52 +98,11 @@ private:
 
     bool is_tilting = false;
 
-    Common::Event shutdown_event;
-
-    std::tuple<Common::Vec3<float>, Common::Vec3<float>> status;
     std::mutex status_mutex;
-
-    // Note: always keep the thread declaration at the end so that other objects are initialized
-    // before this!
-    std::thread motion_emu_thread;
-
-    void MotionEmuThread() {
-        auto update_time = std::chrono::steady_clock::now();
-        Common::Quaternion<float> q = Common::MakeQuaternion(Common::Vec3<float>(), 0);
-        Common::Quaternion<float> old_q;
-
-        while (!shutdown_event.WaitUntil(update_time)) {
-            update_time += update_duration;
-            old_q = q;
-
-            {
-                std::lock_guard guard{tilt_mutex};
-
-                // Find the quaternion describing current 3DS tilting
-                q = Common::MakeQuaternion(
-                    Common::MakeVec(-tilt_direction.y, 0.0f, tilt_direction.x), tilt_angle);
-            }
-
-            auto inv_q = q.Inverse();
-
-            // Set the gravity vector in world space
-            auto gravity = Common::MakeVec(0.0f, -1.0f, 0.0f);
-
-            // Find the angular rate vector in world space
-            auto angular_rate = ((q - old_q) * inv_q).xyz * 2;
-            angular_rate *= 1000 / update_millisecond / Common::PI * 180;
-
-            // Transform the two vectors from world space to 3DS space
-            gravity = QuaternionRotate(inv_q, gravity);
-            angular_rate = QuaternionRotate(inv_q, angular_rate);
-
-            // Update the sensor state
-            {
-                std::lock_guard guard{status_mutex};
-                status = std::make_tuple(gravity, angular_rate);
-            }
-        }
-    }
+    std::chrono::steady_clock::time_point update_time = std::chrono::steady_clock::now();
+    Common::Quaternion<float> q = Common::MakeQuaternion(Common::Vec3<float>(), 0);
+    std::tuple<Common::Vec3<float>, Common::Vec3<float>> status{
+        Common::MakeVec(0.0f, -1.0f, 0.0f), Common::Vec3<float>()};
 };
 
 // Interface wrapper held by input receiver as a unique_ptr. It holds the implementation class as
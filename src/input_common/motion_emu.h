@@ -15,7 +15,7 @@ public:
     /**
      * Creates a motion device emulated from mouse input
      * @param params contains parameters for creating the device:
-     *     - "update_period": update period in milliseconds
+     *     - "update_period": shortest period between sensor state updates, in milliseconds
      *     - "sensitivity": the coefficient converting mouse movement to tilting angle
      */
     std::unique_ptr<Input::MotionDevice> Create(const Common::ParamPackage& params) override;
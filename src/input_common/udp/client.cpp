@@ -22,6 +22,8 @@ struct SocketCallback {
     std::function<void(Response::Version)> version;
     std::function<void(Response::PortInfo)> port_info;
     std::function<void(Response::PadData)> pad_data;
+    /// Called once every datagram that arrived together was handled, may be empty
+    std::function<void()> pad_data_batch_end;
 };
 
 class Socket {
@@ -58,6 +60,26 @@ public:
 
 private:
     void HandleReceive(const boost::system::error_code& error, std::size_t bytes_transferred) {
+        HandleDatagram(bytes_transferred);
+
+        // Handle everything that arrived meanwhile as one batch
+        boost::system::error_code available_error;
+        while (socket.available(available_error) > 0 && !available_error) {
+            boost::system::error_code receive_error;
+            const std::size_t size = socket.receive_from(boost::asio::buffer(receive_buffer),
+                                                         receive_endpoint, 0, receive_error);
+            if (receive_error) {
+                break;
+            }
+            HandleDatagram(size);
+        }
+        if (callback.pad_data_batch_end) {
+            callback.pad_data_batch_end();
+        }
+        StartReceive();
+    }
+
+    void HandleDatagram(std::size_t bytes_transferred) {
         if (auto type = Response::Validate(receive_buffer.data(), bytes_transferred)) {
             switch (*type) {
             case Type::Version: {
@@ -81,7 +103,6 @@ private:
             }
             }
         }
-        StartReceive();
     }
 
     void HandleSend(const boost::system::error_code& error) {
@@ -165,8 +186,6 @@ void Client::OnPadData(Response::PadData data) {
     {
         std::lock_guard guard(status->update_mutex);
 
-        status->motion_status = {accel, gyro};
-
         // TODO: add a setting for "click" touch. Click touch refers to a device that differentiates
         // between a simple "tap" and a hard press that causes the touch screen to click.
         const bool is_active = data.touch_1.is_active != 0;
@@ -186,14 +205,41 @@ void Client::OnPadData(Response::PadData data) {
                 static_cast<float>(max_y - min_y);
         }
 
-        status->touch_status = {x, y, is_active};
+        pending_pad_data.push_back({data.motion_timestamp, {accel, gyro}, {x, y, is_active}});
+    }
+}
+
+void Client::OnPadDataBatchEnd() {
+    if (pending_pad_data.empty()) {
+        return;
+    }
+
+    // The newest data was received now, the older data of the batch is placed before it by the
+    // device's own motion timestamps, in microseconds
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point now = Clock::now();
+    const u64 newest_timestamp = pending_pad_data.back().motion_timestamp;
+    std::vector<Common::SampleRing<MotionStatus>::Sample> motion_samples;
+    std::vector<Common::SampleRing<TouchStatus>::Sample> touch_samples;
+    motion_samples.reserve(pending_pad_data.size());
+    touch_samples.reserve(pending_pad_data.size());
+    for (const PendingPadData& pad_data : pending_pad_data) {
+        const u64 age = newest_timestamp - std::min(pad_data.motion_timestamp, newest_timestamp);
+        const Clock::time_point time = now - std::chrono::microseconds{age};
+        motion_samples.push_back({time, pad_data.motion});
+        touch_samples.push_back({time, pad_data.touch});
     }
+    pending_pad_data.clear();
+
+    status->motion_samples.Push(motion_samples.data(), motion_samples.size());
+    status->touch_samples.Push(touch_samples.data(), touch_samples.size());
 }
 
 void Client::StartCommunication(const std::string& host, u16 port, u8 pad_index, u32 client_id) {
     SocketCallback callback{[this](Response::Version version) { OnVersion(version); },
                             [this](Response::PortInfo info) { OnPortInfo(info); },
-                            [this](Response::PadData data) { OnPadData(data); }};
+                            [this](Response::PadData data) { OnPadData(data); },
+                            [this] { OnPadDataBatchEnd(); }};
     LOG_INFO(Input, "Starting communication with UDP input server on {}:{}", host, port);
     socket = std::make_unique<Socket>(host, port, pad_index, client_id, callback);
     thread = std::thread{SocketLoop, this->socket.get()};
@@ -11,7 +11,9 @@
 #include <string>
 #include <thread>
 #include <tuple>
+#include <vector>
 #include "common/common_types.h"
+#include "common/sample_ring.h"
 #include "common/thread.h"
 #include "common/vector_math.h"
 
@@ -28,10 +30,35 @@ struct PortInfo;
 struct Version;
 } // namespace Response
 
+struct MotionStatus {
+    Common::Vec3f accel;
+    Common::Vec3f gyro;
+
+    static MotionStatus Interpolate(const MotionStatus& a, const MotionStatus& b, float t) {
+        return {a.accel + (b.accel - a.accel) * t, a.gyro + (b.gyro - a.gyro) * t};
+    }
+};
+
+struct TouchStatus {
+    float x;
+    float y;
+    bool is_active;
+
+    static TouchStatus Interpolate(const TouchStatus& a, const TouchStatus& b, float t) {
+        // Presses and releases happen at the nearest sample, positions only move while pressed
+        if (a.is_active != b.is_active) {
+            return t < 0.5f ? a : b;
+        }
+        return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, b.is_active};
+    }
+};
+
 struct DeviceStatus {
+    // Written by the socket thread only, read without locking by the input devices
+    Common::SampleRing<MotionStatus> motion_samples;
+    Common::SampleRing<TouchStatus> touch_samples;
+
     std::mutex update_mutex;
-    std::tuple<Common::Vec3<float>, Common::Vec3<float>> motion_status;
-    std::tuple<float, float, bool> touch_status;
 
     // calibration data for scaling the device's touch area to 3ds
     struct CalibrationData {
@@ -55,12 +82,21 @@ private:
     void OnVersion(Response::Version);
     void OnPortInfo(Response::PortInfo);
     void OnPadData(Response::PadData);
+    void OnPadDataBatchEnd();
     void StartCommunication(const std::string& host, u16 port, u8 pad_index, u32 client_id);
 
     std::unique_ptr<Socket> socket;
     std::shared_ptr<DeviceStatus> status;
     std::thread thread;
     u64 packet_sequence = 0;
+
+    struct PendingPadData {
+        u64 motion_timestamp;
+        MotionStatus motion;
+        TouchStatus touch;
+    };
+    /// Pad data received since the last batch was pushed to the status
+    std::vector<PendingPadData> pending_pad_data;
 };
 
 /// An async job allowing configuration of the touchpad calibration.
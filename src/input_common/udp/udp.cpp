@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <mutex>
 #include <tuple>
 
@@ -13,12 +14,19 @@
 
 namespace InputCommon::CemuhookUDP {
 
+/// Samples are read this far in the past, so there is a newer sample to interpolate towards
+constexpr std::chrono::milliseconds INTERPOLATION_DELAY{5};
+
 class UDPTouchDevice final : public Input::TouchDevice {
 public:
     explicit UDPTouchDevice(std::shared_ptr<DeviceStatus> status_) : status(std::move(status_)) {}
     std::tuple<float, float, bool> GetStatus() const override {
-        std::lock_guard guard(status->update_mutex);
-        return status->touch_status;
+        const auto touch = status->touch_samples.GetAt(std::chrono::steady_clock::now() -
+                                                       INTERPOLATION_DELAY);
+        if (!touch) {
+            return {};
+        }
+        return {touch->x, touch->y, touch->is_active};
     }
 
 private:
@@ -29,8 +37,12 @@ class UDPMotionDevice final : public Input::MotionDevice {
 public:
     explicit UDPMotionDevice(std::shared_ptr<DeviceStatus> status_) : status(std::move(status_)) {}
     std::tuple<Common::Vec3<float>, Common::Vec3<float>> GetStatus() const override {
-        std::lock_guard guard(status->update_mutex);
-        return status->motion_status;
+        const auto motion = status->motion_samples.GetAt(std::chrono::steady_clock::now() -
+                                                         INTERPOLATION_DELAY);
+        if (!motion) {
+            return {};
+        }
+        return {motion->accel, motion->gyro};
     }
 
 private:
@@ -0,0 +1,316 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/asio.hpp>
+
+#include "common/common_types.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "core/hle/service/ldn/ldn_protocol.h"
+
+using boost::asio::ip::udp;
+
+namespace Protocol = Service::LDN::Protocol;
+using Service::LDN::NetworkInfo;
+using Service::LDN::SessionId;
+
+namespace {
+
+constexpr u16 DEFAULT_PORT = 30200;
+
+using SessionKey = std::pair<u64, u64>;
+
+SessionKey MakeKey(const SessionId& session_id) {
+    return {session_id.high, session_id.low};
+}
+
+/**
+ * Routes the session management packets of the emulated local wireless networks. Everything runs
+ * on one thread, from buffers allocated once, so a packet is forwarded as soon as it arrives.
+ */
+class Relay {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit Relay(u16 port)
+        : timer(io_service), socket(io_service, udp::endpoint(udp::v4(), port)) {}
+
+    void Run() {
+        StartReceive();
+        StartExpiry(clock::now());
+        io_service.run();
+    }
+
+private:
+    struct Peer {
+        u32 id;
+        clock::time_point last_seen;
+    };
+
+    struct HostedNetwork {
+        udp::endpoint host;
+        NetworkInfo info;
+        std::vector<u32> members; ///< Peer ids of the connected stations
+    };
+
+    void StartReceive() {
+        socket.async_receive_from(
+            boost::asio::buffer(receive_buffer), receive_endpoint,
+            [this](const boost::system::error_code& error, std::size_t bytes_transferred) {
+                if (!error) {
+                    HandleReceive(bytes_transferred);
+                }
+                StartReceive();
+            });
+    }
+
+    void StartExpiry(const clock::time_point& from) {
+        timer.expires_at(from + std::chrono::seconds(Protocol::KEEP_ALIVE_INTERVAL));
+        timer.async_wait([this](const boost::system::error_code& error) {
+            if (error) {
+                return;
+            }
+            ExpirePeers();
+            StartExpiry(timer.expiry());
+        });
+    }
+
+    void HandleReceive(std::size_t size) {
+        using Protocol::PacketType;
+        using Protocol::Read;
+
+        const u8* const data = receive_buffer.data();
+        const auto type = Protocol::Validate(data, size);
+        if (!type) {
+            return;
+        }
+        const u32 peer_id = TouchPeer(receive_endpoint);
+
+        switch (*type) {
+        case PacketType::Advertise:
+            if (const auto info = Read<NetworkInfo>(data, size)) {
+                HandleAdvertise(*info);
+            }
+            break;
+        case PacketType::Withdraw:
+            if (const auto session_id = Read<SessionId>(data, size)) {
+                HandleWithdraw(*session_id);
+            }
+            break;
+        case PacketType::Scan:
+            for (const auto& [key, network] : networks) {
+                Send(receive_endpoint, PacketType::ScanResult, network.info);
+            }
+            break;
+        case PacketType::Connect:
+            if (auto request = Read<Protocol::ConnectRequest>(data, size)) {
+                request->station_id = peer_id;
+                HandleConnect(*request);
+            }
+            break;
+        case PacketType::ConnectResult:
+            if (const auto result = Read<Protocol::ConnectResult>(data, size)) {
+                HandleConnectResult(*result);
+            }
+            break;
+        case PacketType::Disconnect:
+            if (auto request = Read<Protocol::DisconnectRequest>(data, size)) {
+                request->station_id = peer_id;
+                HandleDisconnect(*request);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void HandleAdvertise(const NetworkInfo& info) {
+        const SessionKey key = MakeKey(info.network_id.session_id);
+        auto it = networks.find(key);
+        if (it == networks.end()) {
+            LOG_INFO(Network, "Network {:016X}{:016X} hosted by {}", key.first, key.second,
+                     ToString(receive_endpoint));
+            it = networks.emplace(key, HostedNetwork{receive_endpoint, info, {}}).first;
+        } else if (it->second.host != receive_endpoint) {
+            return;
+        }
+        it->second.info = info;
+        for (const u32 member : it->second.members) {
+            SendToPeer(member, Protocol::PacketType::Advertise, info);
+        }
+    }
+
+    void HandleWithdraw(const SessionId& session_id) {
+        const auto it = networks.find(MakeKey(session_id));
+        if (it == networks.end() || it->second.host != receive_endpoint) {
+            return;
+        }
+        Withdraw(it);
+    }
+
+    void HandleConnect(const Protocol::ConnectRequest& request) {
+        const auto it = networks.find(MakeKey(request.session_id));
+        if (it == networks.end()) {
+            // Answer right away instead of letting the station time out
+            Protocol::ConnectResult result{};
+            result.session_id = request.session_id;
+            result.station_id = request.station_id;
+            result.node_id = -1;
+            Send(receive_endpoint, Protocol::PacketType::ConnectResult, result);
+            return;
+        }
+        Send(it->second.host, Protocol::PacketType::Connect, request);
+    }
+
+    void HandleConnectResult(const Protocol::ConnectResult& result) {
+        const auto it = networks.find(MakeKey(result.session_id));
+        if (it == networks.end() || it->second.host != receive_endpoint) {
+            return;
+        }
+        auto& members = it->second.members;
+        if (result.accepted &&
+            std::find(members.begin(), members.end(), result.station_id) == members.end()) {
+            members.push_back(result.station_id);
+        }
+        SendToPeer(result.station_id, Protocol::PacketType::ConnectResult, result);
+    }
+
+    void HandleDisconnect(const Protocol::DisconnectRequest& request) {
+        const auto it = networks.find(MakeKey(request.session_id));
+        if (it == networks.end()) {
+            return;
+        }
+        auto& members = it->second.members;
+        members.erase(std::remove(members.begin(), members.end(), request.station_id),
+                      members.end());
+        Send(it->second.host, Protocol::PacketType::Disconnect, request);
+    }
+
+    /// Forgets the nodes that went silent, as if they had left their networks
+    void ExpirePeers() {
+        const auto expiry = clock::now() - std::chrono::seconds(Protocol::PEER_TIMEOUT);
+        for (auto peer = peers.begin(); peer != peers.end();) {
+            if (peer->second.last_seen >= expiry) {
+                ++peer;
+                continue;
+            }
+            const udp::endpoint endpoint = peer->first;
+            const u32 id = peer->second.id;
+            LOG_INFO(Network, "Peer {} timed out", ToString(endpoint));
+
+            for (auto it = networks.begin(); it != networks.end();) {
+                auto& members = it->second.members;
+                if (it->second.host == endpoint) {
+                    it = Withdraw(it);
+                    continue;
+                }
+                const auto member = std::find(members.begin(), members.end(), id);
+                if (member != members.end()) {
+                    members.erase(member);
+                    Protocol::DisconnectRequest request{};
+                    request.session_id = it->second.info.network_id.session_id;
+                    request.station_id = id;
+                    Send(it->second.host, Protocol::PacketType::Disconnect, request);
+                }
+                ++it;
+            }
+            endpoints.erase(id);
+            peer = peers.erase(peer);
+        }
+    }
+
+    std::map<SessionKey, HostedNetwork>::iterator Withdraw(
+        std::map<SessionKey, HostedNetwork>::iterator it) {
+        LOG_INFO(Network, "Network {:016X}{:016X} withdrawn", it->first.first, it->first.second);
+        const SessionId session_id = it->second.info.network_id.session_id;
+        for (const u32 member : it->second.members) {
+            SendToPeer(member, Protocol::PacketType::Withdraw, session_id);
+        }
+        return networks.erase(it);
+    }
+
+    u32 TouchPeer(const udp::endpoint& endpoint) {
+        const auto now = clock::now();
+        const auto it = peers.find(endpoint);
+        if (it != peers.end()) {
+            it->second.last_seen = now;
+            return it->second.id;
+        }
+        // Zero is never given out, so it can mean "no station"
+        const u32 id = next_peer_id++;
+        peers.emplace(endpoint, Peer{id, now});
+        endpoints.emplace(id, endpoint);
+        return id;
+    }
+
+    template <typename T>
+    void SendToPeer(u32 peer_id, Protocol::PacketType type, const T& payload) {
+        const auto it = endpoints.find(peer_id);
+        if (it != endpoints.end()) {
+            Send(it->second, type, payload);
+        }
+    }
+
+    template <typename T>
+    void Send(const udp::endpoint& endpoint, Protocol::PacketType type, const T& payload) {
+        const std::size_t size = Protocol::Write(send_buffer.data(), type, payload);
+        boost::system::error_code error;
+        socket.send_to(boost::asio::buffer(send_buffer.data(), size), endpoint, 0, error);
+    }
+
+    static std::string ToString(const udp::endpoint& endpoint) {
+        return endpoint.address().to_string() + ':' + std::to_string(endpoint.port());
+    }
+
+    boost::asio::io_service io_service;
+    boost::asio::basic_waitable_timer<clock> timer;
+    udp::socket socket;
+
+    std::map<udp::endpoint, Peer> peers;
+    std::unordered_map<u32, udp::endpoint> endpoints;
+    std::map<SessionKey, HostedNetwork> networks;
+    u32 next_peer_id = 1;
+
+    std::array<u8, Protocol::MAX_PACKET_SIZE> send_buffer;
+    std::array<u8, Protocol::MAX_PACKET_SIZE> receive_buffer;
+    udp::endpoint receive_endpoint;
+};
+
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    Log::Filter log_filter(Log::Level::Info);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    u16 port = DEFAULT_PORT;
+    if (argc > 1) {
+        try {
+            port = static_cast<u16>(std::stoul(argv[1]));
+        } catch (const std::exception&) {
+            std::cout << "Usage: " << argv[0] << " [port]\n";
+            return 1;
+        }
+    }
+
+    try {
+        Relay relay{port};
+        LOG_INFO(Network, "LDN relay listening on port {}", port);
+        relay.Run();
+    } catch (const boost::system::system_error& error) {
+        LOG_CRITICAL(Network, "Failed to start the relay: {}", error.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#define _USE_MATH_DEFINES
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/algorithm/filter.h"
+
+namespace AudioCore {
+namespace {
+
+std::vector<float> MakeSignal(std::size_t num_frames) {
+    std::mt19937 rng{1};
+    std::uniform_real_distribution<float> dist{-16384.0f, 16384.0f};
+    std::vector<float> signal(num_frames * 2);
+    std::generate(signal.begin(), signal.end(), [&] { return dist(rng); });
+    return signal;
+}
+
+/// Double precision direct form I low-pass cascade, the filter as it was before it went float
+std::vector<float> ReferenceLowPass(std::vector<float> signal, double cutoff,
+                                    std::size_t cascade_size) {
+    for (std::size_t stage = 0; stage < cascade_size; ++stage) {
+        const double Q = 1.0 / (2.0 * std::cos(M_PI * (2 * stage + 1) / (4.0 * cascade_size)));
+        const double w0 = 2.0 * M_PI * cutoff;
+        const double alpha = std::sin(w0) / (2 * Q);
+        const double a0 = 1 + alpha;
+        const double a1 = -2.0 * std::cos(w0) / a0;
+        const double a2 = (1 - alpha) / a0;
+        const double b0 = 0.5 * (1 - std::cos(w0)) / a0;
+        const double b1 = 2 * b0;
+        const double b2 = b0;
+        for (std::size_t ch = 0; ch < 2; ++ch) {
+            double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+            for (std::size_t i = ch; i < signal.size(); i += 2) {
+                const double x = signal[i];
+                const double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                signal[i] = static_cast<float>(y);
+            }
+        }
+    }
+    return signal;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Filter: Cascades match a double precision reference", "[audio_core]") {
+    constexpr std::size_t num_frames = 4096;
+    // Odd sizes run the last biquad on its own
+    for (const std::size_t cascade_size : {1, 2, 3, 4}) {
+        const std::vector<float> input = MakeSignal(num_frames);
+        const std::vector<float> expected = ReferenceLowPass(input, 0.1, cascade_size);
+
+        std::vector<float> output = input;
+        CascadingFilter::LowPass(0.1, cascade_size).Process(output.data(), num_frames);
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            REQUIRE(std::abs(output[i] - expected[i]) < 0.5f);
+        }
+    }
+}
+
+TEST_CASE("Filter: State carries over between calls", "[audio_core]") {
+    constexpr std::size_t num_frames = 1000;
+    const std::vector<float> input = MakeSignal(num_frames);
+
+    std::vector<float> whole = input;
+    CascadingFilter::LowPass(0.25, 4).Process(whole.data(), num_frames);
+
+    std::vector<float> chunked = input;
+    CascadingFilter filter = CascadingFilter::LowPass(0.25, 4);
+    std::size_t frame = 0;
+    for (const std::size_t size : {1, 2, 3, 100, 0, 394, 500}) {
+        filter.Process(chunked.data() + frame * 2, size);
+        frame += size;
+    }
+    REQUIRE(frame == num_frames);
+    for (std::size_t i = 0; i < whole.size(); ++i) {
+        REQUIRE(std::abs(chunked[i] - whole[i]) < 1.0e-3f);
+    }
+}
+
+} // namespace AudioCore
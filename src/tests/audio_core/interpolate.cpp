@@ -0,0 +1,67 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/algorithm/interpolate.h"
+#include "common/common_types.h"
+
+namespace AudioCore {
+namespace {
+
+std::vector<s16> Resample(InterpolationState& state, const std::vector<s16>& input,
+                          double ratio) {
+    const std::size_t num_frames = input.size() / 2;
+    std::vector<s16> output(GetMaxInterpolatedFrames(num_frames, ratio) * 2);
+    output.resize(Interpolate(state, input.data(), num_frames, output.data(), ratio) * 2);
+    return output;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Interpolate: Constant signal stays constant", "[audio_core]") {
+    const double ratio = GetInterpolationRatio(32000, 48000);
+    const std::vector<s16> input(2000 * 2, 10000);
+
+    InterpolationState state;
+    const std::vector<s16> output = Resample(state, input, ratio);
+    REQUIRE(output.size() / 2 >= 2990);
+    REQUIRE(output.size() / 2 <= 3000);
+
+    // Skip the frames that still see the silent history
+    for (std::size_t i = 4 * InterpolationState::taps; i < output.size(); ++i) {
+        REQUIRE(std::abs(output[i] - 10000) <= 1);
+    }
+}
+
+TEST_CASE("Interpolate: Chunked input matches a single call", "[audio_core]") {
+    const double ratio = GetInterpolationRatio(22050, 48000);
+    std::vector<s16> input(4410 * 2);
+    for (std::size_t i = 0; i < input.size() / 2; ++i) {
+        const auto value = static_cast<s16>(12000.0 * std::sin(static_cast<double>(i) * 0.1));
+        input[i * 2] = value;
+        input[i * 2 + 1] = static_cast<s16>(-value);
+    }
+
+    InterpolationState whole_state;
+    const std::vector<s16> whole = Resample(whole_state, input, ratio);
+
+    InterpolationState chunked_state;
+    std::vector<s16> chunked;
+    for (std::size_t frame = 0; frame < input.size() / 2; frame += 441) {
+        const std::vector<s16> chunk(input.begin() + frame * 2, input.begin() + (frame + 441) * 2);
+        const std::vector<s16> output = Resample(chunked_state, chunk, ratio);
+        chunked.insert(chunked.end(), output.begin(), output.end());
+    }
+    // Rounding of the position can move the very last frame into the next call
+    REQUIRE(chunked.size() / 2 + 1 >= whole.size() / 2);
+    REQUIRE(whole.size() / 2 + 1 >= chunked.size() / 2);
+    const std::size_t common_size = std::min(chunked.size(), whole.size());
+    REQUIRE(std::equal(chunked.begin(), chunked.begin() + common_size, whole.begin()));
+}
+
+} // namespace AudioCore
@@ -0,0 +1,56 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/algorithm/mix.h"
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+TEST_CASE("Mix: Samples are scaled and accumulated", "[audio_core]") {
+    std::mt19937 rng{1};
+    std::uniform_int_distribution<int> sample_dist{-32768, 32767};
+
+    // Odd sizes make sure the tail after the vector loop is mixed too
+    for (const std::size_t count : {0, 1, 7, 8, 9, 1024, 1031}) {
+        std::vector<s16> samples(count);
+        std::generate(samples.begin(), samples.end(), [&] { return sample_dist(rng); });
+        std::vector<float> mix_bus(count, 100.0f);
+
+        MixSamples(mix_bus.data(), samples.data(), count, 0.5f);
+        for (std::size_t i = 0; i < count; ++i) {
+            REQUIRE(mix_bus[i] == 100.0f + static_cast<float>(samples[i]) * 0.5f);
+        }
+    }
+}
+
+TEST_CASE("Mix: Resolving clamps to PCM16", "[audio_core]") {
+    const std::vector<float> mix_bus{0.0f,     1.9f,      -1.9f,     32767.0f, 32768.0f,
+                                     -32768.0f, -40000.0f, 1.0e10f,   123.5f,   -123.5f,
+                                     70000.0f};
+    std::vector<s16> output(mix_bus.size());
+    ResolveMixBus(output.data(), mix_bus.data(), mix_bus.size());
+    const std::vector<s16> expected{0, 1, -1, 32767, 32767, -32768, -32768, 32767, 123, -123,
+                                    32767};
+    REQUIRE(output == expected);
+}
+
+TEST_CASE("Mix: Many voices saturate", "[audio_core]") {
+    // A full renderer buffer of 96 loud voices has to saturate instead of wrapping around
+    constexpr std::size_t count = 512 * 2;
+    constexpr std::size_t num_voices = 96;
+    const std::vector<s16> voice(count, 20000);
+    std::vector<float> mix_bus(count);
+    for (std::size_t i = 0; i < num_voices; ++i) {
+        MixSamples(mix_bus.data(), voice.data(), count, i % 2 == 0 ? 1.0f : -0.5f);
+    }
+    std::vector<s16> output(count);
+    ResolveMixBus(output.data(), mix_bus.data(), count);
+    REQUIRE(std::all_of(output.begin(), output.end(), [](s16 s) { return s == 32767; }));
+}
+
+} // namespace AudioCore
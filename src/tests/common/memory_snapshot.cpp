@@ -0,0 +1,85 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/memory_snapshot.h"
+
+namespace Common {
+
+namespace {
+
+struct PageDeleter {
+    void operator()(u8* pointer) const {
+        ::operator delete (pointer, std::align_val_t{MemorySnapshot::PageSize()});
+    }
+};
+
+std::unique_ptr<u8, PageDeleter> AllocatePages(std::size_t num_pages) {
+    const std::size_t size = num_pages * MemorySnapshot::PageSize();
+    auto* const pointer =
+        static_cast<u8*>(::operator new (size, std::align_val_t{MemorySnapshot::PageSize()}));
+    std::memset(pointer, 0, size);
+    return std::unique_ptr<u8, PageDeleter>{pointer};
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MemorySnapshot: Keeps the old contents of written pages", "[common]") {
+    const std::size_t page_size = MemorySnapshot::PageSize();
+    const auto memory = AllocatePages(4);
+    u8* const data = memory.get();
+
+    MemorySnapshot snapshot{{{data, 4 * page_size}}};
+    REQUIRE(snapshot.NumPages(0) == 4);
+    REQUIRE(snapshot.GetTouchedPages(0).empty());
+
+    data[page_size] = 1;
+    data[3 * page_size + 5] = 2;
+    data[3 * page_size + 6] = 3;
+    REQUIRE(snapshot.GetTouchedPages(0) == std::vector<std::size_t>{1, 3});
+
+    u8 old_value = 0xFF;
+    REQUIRE(snapshot.Read(0, 3 * page_size + 5, &old_value, 1));
+    REQUIRE(old_value == 0);
+    REQUIRE(data[3 * page_size + 5] == 2);
+}
+
+TEST_CASE("MemorySnapshot: Reports the pages touched between two snapshots", "[common]") {
+    const std::size_t page_size = MemorySnapshot::PageSize();
+    const auto memory = AllocatePages(3);
+    u8* const data = memory.get();
+
+    auto first = std::make_unique<MemorySnapshot>(std::vector<MemorySnapshot::Range>{
+        {data, 3 * page_size}});
+    data[0] = 1;
+    MemorySnapshot second{{{data, 3 * page_size}}};
+    data[2 * page_size] = 2;
+
+    REQUIRE(first->GetTouchedPages(0, &second) == std::vector<std::size_t>{0});
+    REQUIRE(first->GetTouchedPages(0) == std::vector<std::size_t>{0, 2});
+    REQUIRE(second.GetTouchedPages(0) == std::vector<std::size_t>{2});
+
+    // Pages the newer snapshot still tracks stay protected after the older one is gone
+    first.reset();
+    data[page_size] = 3;
+    REQUIRE(second.GetTouchedPages(0) == std::vector<std::size_t>{1, 2});
+}
+
+TEST_CASE("MemorySnapshot: Stops tracking released memory", "[common]") {
+    const std::size_t page_size = MemorySnapshot::PageSize();
+    auto memory = AllocatePages(2);
+
+    MemorySnapshot snapshot{{{memory.get(), 2 * page_size}}};
+    MemorySnapshot::ReleaseMemory(memory.get(), 2 * page_size);
+    memory.reset();
+
+    REQUIRE(snapshot.IsReleased(0));
+    REQUIRE(snapshot.GetTouchedPages(0).size() == 2);
+}
+
+} // namespace Common
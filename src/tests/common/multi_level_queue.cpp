@@ -3,7 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <catch2/catch.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
 #include <math.h>
+#include <vector>
 #include "common/common_types.h"
 #include "common/multi_level_queue.h"
 
@@ -52,4 +56,136 @@ TEST_CASE("MultiLevelQueue", "[common]") {
     REQUIRE(mlq.empty(1));
 }
 
+namespace {
+
+struct QueueElement {
+    f32 value;
+    std::array<MultiLevelQueueNode<QueueElement>, 2> nodes;
+};
+
+struct QueueElementAccessor {
+    std::size_t index;
+
+    MultiLevelQueueNode<QueueElement>& operator()(QueueElement& element) const {
+        return element.nodes[index];
+    }
+};
+
+using IntrusiveQueue = IntrusiveMultiLevelQueue<QueueElement, 64, QueueElementAccessor>;
+
+} // Anonymous namespace
+
+TEST_CASE("IntrusiveMultiLevelQueue", "[common]") {
+    std::array<QueueElement, 8> values{};
+    const std::array<f32, 8> raw_values = {0.0, 5.0, 1.0, 9.0, 8.0, 2.0, 6.0, 7.0};
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i].value = raw_values[i];
+    }
+
+    IntrusiveQueue mlq{QueueElementAccessor{0}};
+    REQUIRE(mlq.empty());
+    REQUIRE(mlq.front() == nullptr);
+    for (const u32 i : {2, 7, 3, 4, 0, 5, 6, 1}) {
+        mlq.add(&values[i], i);
+    }
+    u32 index = 0;
+    bool all_set = true;
+    for (QueueElement* element : mlq) {
+        all_set &= (element == &values[index]);
+        index++;
+    }
+    REQUIRE(all_set);
+    REQUIRE(index == values.size());
+    REQUIRE(mlq.size() == values.size());
+
+    QueueElement back{8.0f};
+    QueueElement front{-7.0f};
+    mlq.add(&back, 2);
+    mlq.add(&front, 2, false);
+    REQUIRE(mlq.front(2) == &front);
+    REQUIRE(mlq.size(2) == 3);
+    mlq.yield(2);
+    REQUIRE(mlq.front(2) == &values[2]);
+    REQUIRE(mlq.back(2) == &front);
+
+    // Removal doesn't depend on the position within the level.
+    mlq.remove(&back, 2);
+    REQUIRE(!mlq.contains(&back));
+    REQUIRE(mlq.size(2) == 2);
+    mlq.remove(&back, 2);
+    REQUIRE(mlq.size(2) == 2);
+
+    mlq.adjust(&values[0], 0, 9);
+    REQUIRE(mlq.highest_priority_set() == 1);
+    REQUIRE(mlq.lowest_priority_set() == 9);
+    mlq.remove(&values[1], 1);
+    REQUIRE(mlq.highest_priority_set() == 2);
+    REQUIRE(mlq.empty(1));
+
+    // The same element can be linked into a second queue through its other node.
+    IntrusiveQueue other{QueueElementAccessor{1}};
+    other.add(&values[3], 30);
+    REQUIRE(mlq.contains(&values[3]));
+    REQUIRE(other.front() == &values[3]);
+
+    mlq.clear();
+    REQUIRE(mlq.empty());
+    REQUIRE(!mlq.contains(&values[2]));
+    REQUIRE(other.contains(&values[3]));
+}
+
+TEST_CASE("MultiLevelQueue: Throughput Benchmark", "[common]") {
+    // Mimics the scheduler: elements are added, removed from arbitrary positions and readjusted.
+    constexpr std::size_t num_elements = 256;
+    constexpr std::size_t num_iterations = 200;
+
+    std::vector<QueueElement> elements(num_elements);
+    const auto priority_of = [](std::size_t i, std::size_t iteration) {
+        return static_cast<u32>((i * 7 + iteration) % 64);
+    };
+
+    const auto measure = [](auto&& body) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    const auto list_time = measure([&] {
+        MultiLevelQueue<QueueElement*, 64> mlq;
+        for (std::size_t it = 0; it < num_iterations; ++it) {
+            for (std::size_t i = 0; i < num_elements; ++i) {
+                mlq.add(&elements[i], priority_of(i, it));
+            }
+            for (std::size_t i = 0; i < num_elements; ++i) {
+                mlq.adjust(&elements[i], priority_of(i, it), priority_of(i, it + 1));
+            }
+            for (std::size_t i = num_elements; i-- > 0;) {
+                mlq.remove(&elements[i], priority_of(i, it + 1));
+            }
+        }
+        REQUIRE(mlq.empty());
+    });
+
+    const auto intrusive_time = measure([&] {
+        IntrusiveQueue mlq{QueueElementAccessor{0}};
+        for (std::size_t it = 0; it < num_iterations; ++it) {
+            for (std::size_t i = 0; i < num_elements; ++i) {
+                mlq.add(&elements[i], priority_of(i, it));
+            }
+            for (std::size_t i = 0; i < num_elements; ++i) {
+                mlq.adjust(&elements[i], priority_of(i, it), priority_of(i, it + 1));
+            }
+            for (std::size_t i = num_elements; i-- > 0;) {
+                mlq.remove(&elements[i], priority_of(i, it + 1));
+            }
+        }
+        REQUIRE(mlq.empty());
+    });
+
+    printf("MultiLevelQueue: Throughput Benchmark: std::list: %lld us, intrusive: %lld us\n",
+           static_cast<long long>(list_time), static_cast<long long>(intrusive_time));
+}
+
 } // namespace Common
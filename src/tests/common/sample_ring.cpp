@@ -0,0 +1,52 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <catch2/catch.hpp>
+#include "common/sample_ring.h"
+
+namespace Common {
+
+namespace {
+
+struct Value {
+    float x;
+
+    static Value Interpolate(const Value& a, const Value& b, float t) {
+        return {a.x + (b.x - a.x) * t};
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("SampleRing: Interpolates between samples", "[common]") {
+    using Ring = SampleRing<Value, 8>;
+    using namespace std::chrono_literals;
+
+    Ring ring;
+    REQUIRE(!ring.GetLatest());
+
+    const Ring::Clock::time_point start{};
+    const std::array<Ring::Sample, 3> samples{{
+        {start, {0.0f}},
+        {start + 10ms, {10.0f}},
+        {start + 20ms, {30.0f}},
+    }};
+    ring.Push(samples.data(), samples.size());
+
+    REQUIRE(ring.GetLatest()->x == 30.0f);
+    REQUIRE(ring.GetAt(start + 5ms)->x == Approx(5.0f));
+    REQUIRE(ring.GetAt(start + 15ms)->x == Approx(20.0f));
+    REQUIRE(ring.GetAt(start + 30ms)->x == 30.0f);
+    REQUIRE(ring.GetAt(start - 1ms)->x == 0.0f);
+
+    // Only the newer half of the ring is looked up
+    for (int i = 3; i < 16; ++i) {
+        ring.Push(start + i * 10ms, {static_cast<float>(i)});
+    }
+    REQUIRE(ring.GetAt(start)->x == 12.0f);
+    REQUIRE(ring.GetAt(start + 125ms)->x == Approx(12.5f));
+}
+
+} // namespace Common
@@ -0,0 +1,45 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <catch2/catch.hpp>
+#include "common/shared_cache_file.h"
+
+namespace Common {
+
+TEST_CASE("SharedCacheFile: Shares stored blocks between mappings", "[common]") {
+    const std::string path = "shared_cache_file_test.bin";
+    std::remove(path.c_str());
+    {
+        const auto first = SharedCacheFile::Open(path, 0x2800, 0x1000);
+        const auto second = SharedCacheFile::Open(path, 0x2800, 0x1000);
+        REQUIRE(first != nullptr);
+        REQUIRE(second != nullptr);
+        REQUIRE(first->GetBlockSize(2) == 0x800);
+        REQUIRE(second->GetBlock(1) == nullptr);
+
+        std::array<u8, 0x1000> block;
+        block.fill(0x5A);
+        first->StoreBlock(1, block.data());
+        const u8* const stored = second->GetBlock(1);
+        REQUIRE(stored != nullptr);
+        REQUIRE(stored[0] == 0x5A);
+        REQUIRE(stored[0xFFF] == 0x5A);
+
+        // Blocks are immutable once stored
+        block.fill(0);
+        second->StoreBlock(1, block.data());
+        REQUIRE(first->GetBlock(1)[0] == 0x5A);
+        REQUIRE(first->GetBlock(0) == nullptr);
+    }
+
+    // Stored blocks outlive the mappings, but not a change of layout
+    REQUIRE(SharedCacheFile::Open(path, 0x2800, 0x1000)->GetBlock(1)[0] == 0x5A);
+    REQUIRE(SharedCacheFile::Open(path, 0x3000, 0x1000) == nullptr);
+    std::remove(path.c_str());
+}
+
+} // namespace Common
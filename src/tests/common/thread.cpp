@@ -0,0 +1,92 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/thread.h"
+
+namespace Common {
+
+TEST_CASE("Event: Signals are consumed by a single wait", "[common]") {
+    Event event;
+    REQUIRE_FALSE(event.WaitFor(std::chrono::milliseconds(1)));
+
+    event.Set();
+    event.Set();
+    REQUIRE(event.WaitFor(std::chrono::milliseconds(1)));
+    REQUIRE_FALSE(event.WaitFor(std::chrono::milliseconds(1)));
+
+    event.Set();
+    event.Reset();
+    REQUIRE_FALSE(event.WaitUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(1)));
+}
+
+TEST_CASE("Event: Hands off between threads", "[common]") {
+    constexpr int num_round_trips = 10000;
+    Event ping;
+    Event pong;
+    int value = 0;
+    std::thread partner([&] {
+        for (int i = 0; i < num_round_trips; ++i) {
+            ping.Wait();
+            ++value;
+            pong.Set();
+        }
+    });
+    for (int i = 0; i < num_round_trips; ++i) {
+        ping.Set();
+        pong.Wait();
+        REQUIRE(value == i + 1);
+    }
+    partner.join();
+}
+
+TEST_CASE("Event: Parked waiters are woken up", "[common]") {
+    Event event;
+    std::atomic<bool> woken{false};
+    std::thread waiter([&] {
+        event.Wait();
+        woken = true;
+    });
+    // Give the waiter enough time to stop spinning and park
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE_FALSE(woken);
+    event.Set();
+    waiter.join();
+    REQUIRE(woken);
+}
+
+TEST_CASE("Barrier: Releases every thread once all have synced", "[common]") {
+    constexpr std::size_t num_threads = 4;
+    constexpr int num_rounds = 1000;
+    Barrier barrier{num_threads};
+    std::array<std::atomic<int>, num_rounds> arrivals{};
+    std::atomic<bool> failed{false};
+
+    const auto run = [&] {
+        for (int round = 0; round < num_rounds; ++round) {
+            ++arrivals[round];
+            barrier.Sync();
+            // Nobody leaves a round before everyone has arrived to it
+            if (arrivals[round] != static_cast<int>(num_threads)) {
+                failed = true;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back(run);
+    }
+    run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE_FALSE(failed);
+}
+
+} // namespace Common
@@ -0,0 +1,52 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/thread.h"
+#include "common/thread_worker.h"
+
+namespace Common {
+
+TEST_CASE("ThreadWorker: TaskGroup waits for its tasks", "[common]") {
+    ThreadWorker worker{4, "ThreadWorkerTest"};
+    TaskGroup group;
+    REQUIRE(group.IsDone());
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 100; ++i) {
+        worker.QueueWork(group, [&count] { ++count; });
+    }
+    group.Wait();
+    REQUIRE(group.IsDone());
+    REQUIRE(count == 100);
+
+    // Groups can be reused after being waited on
+    worker.QueueWork(group, [&count] { ++count; });
+    group.Wait();
+    REQUIRE(count == 101);
+}
+
+TEST_CASE("ThreadWorker: Higher priorities run first", "[common]") {
+    ThreadWorker worker{1, "ThreadWorkerTest"};
+    TaskGroup group;
+
+    // Keep the only worker busy while the rest of the work is queued
+    Event release;
+    worker.QueueWork(group, [&release] { release.Wait(); });
+
+    std::vector<WorkPriority> order;
+    for (const WorkPriority priority :
+         {WorkPriority::Low, WorkPriority::Normal, WorkPriority::High, WorkPriority::Normal}) {
+        worker.QueueWork(group, [&order, priority] { order.push_back(priority); }, priority);
+    }
+    release.Set();
+    group.Wait();
+
+    REQUIRE(order == std::vector<WorkPriority>{WorkPriority::High, WorkPriority::Normal,
+                                               WorkPriority::Normal, WorkPriority::Low});
+}
+
+} // namespace Common
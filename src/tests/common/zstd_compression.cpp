@@ -0,0 +1,72 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/zstd_compression.h"
+
+namespace Common::Compression {
+
+namespace {
+
+std::vector<u8> MakeSample(std::size_t size, u32 seed) {
+    std::vector<u8> sample(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        // Mostly shared contents with some differences between samples
+        sample[i] = static_cast<u8>(i % 97 == 0 ? seed + i : (i * 7) >> 3);
+    }
+    return sample;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ZSTD: Streams", "[common]") {
+    const std::vector<u8> input = MakeSample(1 << 20, 1);
+
+    ZSTDCompressionStream compressor(3);
+    for (std::size_t offset = 0; offset < input.size(); offset += 100000) {
+        const std::size_t size = std::min<std::size_t>(100000, input.size() - offset);
+        REQUIRE(compressor.Write(input.data() + offset, size));
+    }
+    const auto compressed = compressor.Finish();
+    REQUIRE(compressed);
+    REQUIRE(compressed->size() < input.size());
+
+    // Feed the frame a few bytes at a time, its size isn't known in advance
+    ZSTDDecompressionStream decompressor;
+    std::vector<u8> output;
+    for (std::size_t offset = 0; offset < compressed->size(); offset += 1000) {
+        const std::size_t size = std::min<std::size_t>(1000, compressed->size() - offset);
+        REQUIRE(decompressor.Write(compressed->data() + offset, size));
+        const std::vector<u8> part = decompressor.TakeOutput();
+        output.insert(output.end(), part.begin(), part.end());
+    }
+    REQUIRE(decompressor.IsFinished());
+    REQUIRE(output == input);
+}
+
+TEST_CASE("ZSTD: Dictionary", "[common]") {
+    std::vector<std::vector<u8>> samples;
+    for (u32 i = 0; i < 128; ++i) {
+        samples.push_back(MakeSample(4096, i));
+    }
+    ZSTDDictionary dictionary(TrainDictionaryZSTD(samples, 16 * 1024));
+    REQUIRE(!dictionary.GetData().empty());
+    REQUIRE(dictionary.IsValid());
+
+    const std::vector<u8> input = MakeSample(4096, 200);
+    const std::vector<u8> compressed = CompressDataZSTD(input.data(), input.size(), dictionary);
+    REQUIRE(!compressed.empty());
+    REQUIRE(compressed.size() < CompressDataZSTDDefault(input.data(), input.size()).size());
+
+    std::vector<u8> output(input.size());
+    REQUIRE(DecompressDataZSTD(compressed.data(), compressed.size(), output.data(), output.size(),
+                               &dictionary));
+    REQUIRE(output == input);
+}
+
+} // namespace Common::Compression
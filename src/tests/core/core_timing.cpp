@@ -4,15 +4,23 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/core_timing_util.h"
 
 // Numbers are chosen randomly to make sure the correct one is given.
 static constexpr std::array<u64, 5> CB_IDS{{42, 144, 93, 1026, UINT64_C(0xFFFF7FFFF7FFFF)}};
@@ -154,3 +162,176 @@ TEST_CASE("Core::Timing[PredictableLateness]", "[core]") {
     AdvanceAndCheck(core_timing, 0, 0, 10, -10); // (100 - 10)
     AdvanceAndCheck(core_timing, 1, 1, 50, -50);
 }
+
+TEST_CASE("CoreTiming[UnscheduleEvent]", "[core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+
+    std::shared_ptr<Core::Timing::EventType> cb_a =
+        Core::Timing::CreateEvent("callbackA", CallbackTemplate<0>);
+    std::shared_ptr<Core::Timing::EventType> cb_b =
+        Core::Timing::CreateEvent("callbackB", CallbackTemplate<1>);
+    std::shared_ptr<Core::Timing::EventType> cb_c =
+        Core::Timing::CreateEvent("callbackC", CallbackTemplate<2>);
+
+    // Enter slice 0
+    core_timing.ResetRun();
+
+    core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+    core_timing.ScheduleEvent(200, cb_b, CB_IDS[1]);
+    core_timing.ScheduleEvent(300, cb_b, CB_IDS[0]);
+    core_timing.ScheduleEvent(400, cb_c, CB_IDS[2]);
+    core_timing.ScheduleEvent(500, cb_c, CB_IDS[2]);
+
+    // Only the cb_b event with matching userdata and every cb_c event must be dropped.
+    core_timing.UnscheduleEvent(cb_b, CB_IDS[0]);
+    core_timing.RemoveEvent(cb_c);
+
+    AdvanceAndCheck(core_timing, 0, 0);
+    AdvanceAndCheck(core_timing, 1, 1);
+
+    callbacks_ran_flags = 0;
+    core_timing.SwitchContext(2);
+    core_timing.AddTicks(core_timing.GetDowncount());
+    core_timing.Advance();
+    REQUIRE(callbacks_ran_flags.none());
+}
+
+TEST_CASE("CoreTiming[ScheduleEventThreadsafe]", "[core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+
+    std::shared_ptr<Core::Timing::EventType> empty_callback =
+        Core::Timing::CreateEvent("empty_callback", EmptyCallback);
+
+    core_timing.ResetRun();
+    callbacks_done = 0;
+
+    constexpr u64 num_threads = 4;
+    constexpr u64 events_per_thread = 1000;
+    std::vector<std::thread> producers;
+    for (u64 i = 0; i < num_threads; ++i) {
+        producers.emplace_back([&] {
+            for (u64 j = 0; j < events_per_thread; ++j) {
+                core_timing.ScheduleEventThreadsafe(0, empty_callback, j);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    // Staged events only enter the queue on the next Advance.
+    REQUIRE(callbacks_done == 0);
+    core_timing.Advance();
+    REQUIRE(callbacks_done == num_threads * events_per_thread);
+}
+
+TEST_CASE("CoreTiming[HostTiming]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetHostTiming(true);
+    core_timing.Initialize();
+
+    std::shared_ptr<Core::Timing::EventType> empty_callback =
+        Core::Timing::CreateEvent("empty_callback", EmptyCallback);
+
+    core_timing.ResetRun();
+    callbacks_done = 0;
+
+    // 1ms of guest time, the executed cycles don't matter in this mode.
+    core_timing.ScheduleEvent(Core::Timing::BASE_CLOCK_RATE / 1000, empty_callback, 0);
+    const u64 start_ticks = core_timing.GetTicks();
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    core_timing.Advance();
+
+    REQUIRE(callbacks_done == 1);
+    REQUIRE(core_timing.GetTicks() >= start_ticks + Core::Timing::BASE_CLOCK_RATE / 1000);
+
+    core_timing.Shutdown();
+}
+
+namespace {
+
+/// Reproduction of the std::make_heap based queue CoreTiming used to have, kept as a baseline.
+class ReferenceHeapQueue {
+public:
+    void Schedule(s64 time, const Core::Timing::EventType* type, u64 userdata) {
+        queue.push_back({time, fifo_id++, type, userdata});
+        std::push_heap(queue.begin(), queue.end(), std::greater<>());
+    }
+
+    void Unschedule(const Core::Timing::EventType* type, u64 userdata) {
+        const auto itr = std::remove_if(queue.begin(), queue.end(), [&](const Entry& e) {
+            return e.type == type && e.userdata == userdata;
+        });
+        if (itr != queue.end()) {
+            queue.erase(itr, queue.end());
+            std::make_heap(queue.begin(), queue.end(), std::greater<>());
+        }
+    }
+
+private:
+    struct Entry {
+        s64 time;
+        u64 fifo_order;
+        const Core::Timing::EventType* type;
+        u64 userdata;
+
+        friend bool operator>(const Entry& left, const Entry& right) {
+            return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
+        }
+    };
+
+    std::vector<Entry> queue;
+    u64 fifo_id = 0;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("CoreTiming[RearmBenchmark]", "[core]") {
+    // Emulates services that cancel and re-arm their events every frame while a background of
+    // pending events sits in the queue.
+    constexpr std::size_t num_types = 64;
+    constexpr std::size_t num_background = 512;
+    constexpr std::size_t num_frames = 500;
+
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+
+    std::vector<std::shared_ptr<Core::Timing::EventType>> types;
+    for (std::size_t i = 0; i < num_types; ++i) {
+        types.push_back(Core::Timing::CreateEvent("bench_" + std::to_string(i), EmptyCallback));
+    }
+
+    ReferenceHeapQueue reference;
+    core_timing.ResetRun();
+    for (std::size_t i = 0; i < num_background; ++i) {
+        const s64 when = 1000000000 + static_cast<s64>(i) * 7919;
+        core_timing.ScheduleEvent(when, types[i % num_types], i);
+        reference.Schedule(when, types[i % num_types].get(), i);
+    }
+
+    const auto run = [&](auto&& rearm) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t frame = 0; frame < num_frames; ++frame) {
+            for (std::size_t i = 0; i < num_types; ++i) {
+                rearm(static_cast<s64>(100000 + (frame * 31 + i) % 5000), i);
+            }
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+    };
+
+    const auto core_timing_time = run([&](s64 when, std::size_t i) {
+        core_timing.UnscheduleEvent(types[i], num_background + i);
+        core_timing.ScheduleEvent(when, types[i], num_background + i);
+    });
+    const auto reference_time = run([&](s64 when, std::size_t i) {
+        reference.Unschedule(types[i].get(), num_background + i);
+        reference.Schedule(when, types[i].get(), num_background + i);
+    });
+
+    printf("CoreTiming: Rearm Benchmark: pairing heap: %lld us, binary heap: %lld us\n",
+           static_cast<long long>(core_timing_time.count()),
+           static_cast<long long>(reference_time.count()));
+}
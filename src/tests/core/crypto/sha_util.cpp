@@ -0,0 +1,47 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string_view>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "core/crypto/sha_util.h"
+
+namespace Core::Crypto {
+
+namespace {
+
+SHA256Hash Hash(std::string_view text) {
+    return CalculateSHA256(reinterpret_cast<const u8*>(text.data()), text.size());
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SHA256: Matches the FIPS 180-2 test vectors", "[core]") {
+    REQUIRE(Hash("abc") == Common::HexStringToArray<0x20>(
+                               "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    REQUIRE(Hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+            Common::HexStringToArray<0x20>(
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+}
+
+TEST_CASE("SHA256: Incremental updates match hashing at once", "[core]") {
+    std::vector<u8> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * 131 + 7);
+    }
+    const auto expected = Common::HexStringToArray<0x20>(
+        "533b698850849b7908b20a22658f639c0b2a476f1791f85f50188287c31a9aba");
+    REQUIRE(CalculateSHA256(data.data(), data.size()) == expected);
+
+    // Split in pieces that start and end in the middle of blocks
+    SHA256Context context;
+    for (std::size_t offset = 0; offset < data.size(); offset += 77) {
+        context.Update(data.data() + offset, std::min<std::size_t>(77, data.size() - offset));
+    }
+    REQUIRE(context.Finish() == expected);
+}
+
+} // namespace Core::Crypto
@@ -0,0 +1,66 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/textures/astc.h"
+
+namespace Tegra::Texture::ASTC {
+
+namespace {
+/// Builds a void extent block, filling the whole block with the given 8-bit RGBA color.
+std::array<u8, 16> MakeVoidExtentBlock(u8 r, u8 g, u8 b, u8 a) {
+    // Void extent block mode with all extent coordinates set to "unbounded"
+    std::array<u8, 16> block{0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    const std::array<u8, 4> components{r, g, b, a};
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        block[8 + i * 2] = components[i];
+        block[8 + i * 2 + 1] = components[i];
+    }
+    return block;
+}
+} // Anonymous namespace
+
+TEST_CASE("ASTC::Decompress", "[video_core]") {
+    struct Case {
+        u32 width, height, depth, block_width, block_height;
+    };
+    // Small images are decoded inline, large ones are split across the worker threads
+    for (const Case& test : {Case{13, 7, 1, 4, 4}, Case{257, 129, 2, 4, 4},
+                             Case{300, 203, 1, 8, 5}, Case{1024, 64, 1, 12, 12}}) {
+        const u32 blocks_x = (test.width + test.block_width - 1) / test.block_width;
+        const u32 blocks_y = (test.height + test.block_height - 1) / test.block_height;
+        const u32 num_blocks = blocks_x * blocks_y * test.depth;
+
+        std::vector<u8> data;
+        data.reserve(num_blocks * 16);
+        for (u32 block = 0; block < num_blocks; ++block) {
+            const auto encoded = MakeVoidExtentBlock(static_cast<u8>(block),
+                                                     static_cast<u8>(block >> 8), 0x40, 0xFF);
+            data.insert(data.end(), encoded.begin(), encoded.end());
+        }
+
+        std::vector<u8> output(test.width * test.height * test.depth * 4);
+        Decompress(data.data(), test.width, test.height, test.depth, test.block_width,
+                   test.block_height, output.data());
+
+        for (u32 z = 0; z < test.depth; ++z) {
+            for (u32 y = 0; y < test.height; ++y) {
+                for (u32 x = 0; x < test.width; ++x) {
+                    const u32 block = (z * blocks_y + y / test.block_height) * blocks_x +
+                                      x / test.block_width;
+                    const u8* texel = &output[((z * test.height + y) * test.width + x) * 4];
+                    REQUIRE(texel[0] == static_cast<u8>(block));
+                    REQUIRE(texel[1] == static_cast<u8>(block >> 8));
+                    REQUIRE(texel[2] == 0x40);
+                    REQUIRE(texel[3] == 0xFF);
+                }
+            }
+        }
+    }
+}
+
+} // namespace Tegra::Texture::ASTC
@@ -0,0 +1,52 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/gpu_page_table.h"
+
+namespace Tegra {
+
+TEST_CASE("GPUPageTable: Contiguous mappings resolve in a single range", "[video_core]") {
+    constexpr u64 page_size = GPUPageTable::page_size;
+    std::vector<u8> memory(page_size * 8);
+    GPUPageTable table;
+
+    // Nothing mapped, the whole directory entry is one unmapped range
+    REQUIRE(table.GetEntry(0x100000) == nullptr);
+    REQUIRE(table.GetRange(0x100000, 1).type == Common::PageType::Unmapped);
+    REQUIRE(table.GetRange(0x100000, 1).size > page_size);
+
+    const GPUVAddr base = 0x4000000 - page_size * 2;
+    table.Map(base, page_size * 4, memory.data(), Common::PageType::Memory, 0x80000000);
+    REQUIRE(table.GetEntry(base + 0x10)->pointer == memory.data());
+
+    // The mapping spans two page tables and still resolves at once
+    const GPUPageTable::Range range = table.GetRange(base + 0x10, 1);
+    REQUIRE(range.pointer == memory.data() + 0x10);
+    REQUIRE(range.backing_addr == 0x80000010);
+    REQUIRE(range.size == page_size * 4 - 0x10);
+
+    // Remapping the middle splits the run, and pages before it stop short of it
+    table.Map(base + page_size, page_size, memory.data() + page_size * 6, Common::PageType::Memory,
+              0x90000000);
+    REQUIRE(table.GetRange(base, 1).size == page_size);
+    REQUIRE(table.GetRange(base, page_size * 4).size == page_size);
+    REQUIRE(table.GetRange(base + page_size, 1).pointer == memory.data() + page_size * 6);
+    REQUIRE(table.GetRange(base + page_size * 2, 1).size == page_size * 2);
+
+    // Neighbouring mappings of contiguous memory are joined when the requested size needs it
+    table.Map(base + page_size, page_size, memory.data() + page_size, Common::PageType::Memory,
+              0x80000000 + page_size);
+    REQUIRE(table.GetRange(base, 1).size == page_size);
+    REQUIRE(table.GetRange(base, page_size * 3).size == page_size * 4);
+
+    table.Map(base, page_size * 4, nullptr, Common::PageType::Unmapped, 0);
+    REQUIRE(table.GetRange(base, page_size * 4).pointer == nullptr);
+    REQUIRE(table.GetRange(base, page_size * 4).type == Common::PageType::Unmapped);
+    REQUIRE(table.GetRange(base, page_size * 4).size >= page_size * 4);
+}
+
+} // namespace Tegra
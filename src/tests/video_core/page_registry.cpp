@@ -0,0 +1,40 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/page_registry.h"
+
+namespace VideoCommon {
+
+TEST_CASE("PageRegistry: Overlaps are reported once", "[video_core]") {
+    PageRegistry<int, 4, 2> registry;
+    registry.Insert(1, 0x00, 0x10);
+    registry.Insert(2, 0x10, 0x80);
+    registry.Insert(3, 0x100, 0x104);
+
+    const auto Query = [&](CacheAddr start, CacheAddr end) {
+        std::vector<int> objects;
+        registry.ForEachOverlap(start, end, [&](int object) { objects.push_back(object); });
+        return objects;
+    };
+
+    REQUIRE(Query(0x00, 0x200) == std::vector<int>{1, 2, 3});
+    REQUIRE(Query(0x08, 0x18) == std::vector<int>{1, 2});
+    REQUIRE(Query(0x40, 0x50) == std::vector<int>{2});
+    REQUIRE(Query(0x80, 0x100).empty());
+    REQUIRE(Query(0x10, 0x10).empty());
+    // Writes to the same page that don't touch the object's bytes are not reported
+    REQUIRE(Query(0x104, 0x110).empty());
+    REQUIRE(Query(0x103, 0x110) == std::vector<int>{3});
+
+    registry.Erase(2, 0x10, 0x80);
+    REQUIRE(Query(0x00, 0x200) == std::vector<int>{1, 3});
+
+    registry.Clear();
+    REQUIRE(Query(0x00, 0x200).empty());
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,59 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/radix_table.h"
+
+namespace VideoCommon {
+
+TEST_CASE("RadixTable: Find only returns allocated leaves", "[video_core]") {
+    RadixTable<u32, 4> table;
+    REQUIRE(table.Find(0) == nullptr);
+    REQUIRE(table.Find(0x12345) == nullptr);
+
+    table[0x12345] = 7;
+    REQUIRE(table.Find(0x12345) != nullptr);
+    REQUIRE(*table.Find(0x12345) == 7);
+
+    // Pages sharing the leaf are default initialized, pages in other leaves are not allocated
+    REQUIRE(table.Find(0x12340) != nullptr);
+    REQUIRE(*table.Find(0x12340) == 0);
+    REQUIRE(table.Find(0x12350) == nullptr);
+
+    table.Clear();
+    REQUIRE(table.Find(0x12345) == nullptr);
+}
+
+TEST_CASE("RadixTable: ForEachInRange walks across leaves", "[video_core]") {
+    RadixTable<u32, 4> table;
+    table[3] = 1;
+    table[17] = 2;
+    table[100] = 3;
+
+    std::vector<u64> visited;
+    u32 sum = 0;
+    const bool stopped = table.ForEachInRange(2, 40, [&](u64 page, u32 value) {
+        visited.push_back(page);
+        sum += value;
+        return false;
+    });
+    REQUIRE(!stopped);
+    REQUIRE(sum == 3);
+
+    // Leaves [0, 16) and [16, 32) are allocated, [32, 48) is not
+    REQUIRE(visited.size() == 30);
+    REQUIRE(visited.front() == 2);
+    REQUIRE(visited.back() == 31);
+
+    u64 stop_page = 0;
+    REQUIRE(table.ForEachInRange(0, 128, [&](u64 page, u32 value) {
+        stop_page = page;
+        return value == 2;
+    }));
+    REQUIRE(stop_page == 17);
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,49 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/shader/ast.h"
+#include "video_core/shader/expr.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+/// Builds a program with a conditional backward jump (a loop) followed by a forward jump
+void BuildLoopWithForwardJump(ASTManager& manager) {
+    manager.Init();
+    manager.DeclareLabel(0);
+    manager.DeclareLabel(2);
+    manager.DeclareLabel(3);
+
+    manager.InsertLabel(0);
+    manager.InsertBlock(0, 1);
+    manager.InsertGoto(MakeExpr<ExprVar>(0), 0);
+    manager.InsertLabel(2);
+    manager.InsertGoto(MakeExpr<ExprVar>(1), 3);
+    manager.InsertBlock(2, 3);
+    manager.InsertLabel(3);
+    manager.InsertReturn(MakeExpr<ExprBoolean>(true), false);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ASTManager: Full decompile removes all gotos", "[video_core]") {
+    ASTManager manager{true, true};
+    BuildLoopWithForwardJump(manager);
+    manager.Decompile();
+    REQUIRE(manager.IsFullyDecompiled());
+    REQUIRE(manager.GetLabels().empty());
+}
+
+TEST_CASE("ASTManager: Backwards decompile keeps forward gotos", "[video_core]") {
+    ASTManager manager{false, true};
+    BuildLoopWithForwardJump(manager);
+    manager.Decompile();
+    REQUIRE(manager.IsFullyDecompiled());
+    REQUIRE(manager.GetLabels().size() == 3);
+}
+
+} // namespace VideoCommon::Shader
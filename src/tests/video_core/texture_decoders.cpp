@@ -0,0 +1,70 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/textures/decoders.h"
+
+namespace Tegra::Texture {
+
+namespace {
+/// Offset of a byte in a block linear surface, straight from the GOB and block definitions.
+std::size_t ReferenceOffset(u32 x, u32 y, u32 width_bytes, u32 block_height) {
+    const u32 gobs_x = (width_bytes + 63) / 64;
+    const u32 block_lines = 8 * block_height;
+    const std::size_t block_offset = static_cast<std::size_t>(y / block_lines) * gobs_x * 512 *
+                                         block_height +
+                                     (x / 64) * 512 * block_height;
+    const u32 gob_offset = ((y % block_lines) / 8) * 512;
+    const u32 gx = x % 64;
+    const u32 gy = y % 8;
+    return block_offset + gob_offset + (gx / 32) * 256 + (gy / 2) * 64 + ((gx % 32) / 16) * 32 +
+           (gy % 2) * 16 + (gx % 16);
+}
+} // Anonymous namespace
+
+TEST_CASE("TextureDecoders::UnswizzleTexture", "[video_core]") {
+    for (const u32 bytes_per_pixel : {1U, 2U, 4U, 8U, 16U}) {
+        for (const u32 block_height_bit : {0U, 1U, 2U, 4U}) {
+            for (const u32 width : {16U, 64U, 100U}) {
+                constexpr u32 height = 72;
+                const u32 width_bytes = width * bytes_per_pixel;
+                const std::size_t size =
+                    CalculateSize(true, bytes_per_pixel, width, height, 1, block_height_bit, 0);
+
+                std::vector<u8> swizzled(size);
+                for (std::size_t i = 0; i < size; ++i) {
+                    swizzled[i] = static_cast<u8>(i * 7 + i / 251);
+                }
+
+                const std::vector<u8> linear =
+                    UnswizzleTexture(swizzled.data(), 1, 1, bytes_per_pixel, width, height, 1,
+                                     block_height_bit, 0, 1);
+                for (u32 y = 0; y < height; ++y) {
+                    for (u32 x = 0; x < width_bytes; ++x) {
+                        const std::size_t offset =
+                            ReferenceOffset(x, y, width_bytes, 1U << block_height_bit);
+                        REQUIRE(linear[y * width_bytes + x] == swizzled[offset]);
+                    }
+                }
+
+                // Swizzling the result back has to give the original bytes of the image.
+                std::vector<u8> reswizzled(size);
+                std::vector<u8> source = linear;
+                CopySwizzledData(width, height, 1, bytes_per_pixel, bytes_per_pixel,
+                                 reswizzled.data(), source.data(), false, block_height_bit, 0, 1);
+                for (u32 y = 0; y < height; ++y) {
+                    for (u32 x = 0; x < width_bytes; ++x) {
+                        const std::size_t offset =
+                            ReferenceOffset(x, y, width_bytes, 1U << block_height_bit);
+                        REQUIRE(reswizzled[offset] == swizzled[offset]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace Tegra::Texture
@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "video_core/write_back_tracker.h"
+
+namespace VideoCommon {
+
+namespace {
+constexpr u64 PageSize = WriteBackTracker::PageSize;
+} // Anonymous namespace
+
+TEST_CASE("WriteBackTracker: Written pages are reported until cleared", "[video_core]") {
+    WriteBackTracker tracker;
+    REQUIRE(!tracker.IsWritten(0x10000, 0x100000));
+
+    tracker.MarkWritten(0x10000 + 0x10, 4);
+    REQUIRE(tracker.IsWritten(0x10000, 1));
+    REQUIRE(tracker.IsWritten(0x10000 + PageSize - 1, 1));
+    REQUIRE(!tracker.IsWritten(0x10000 + PageSize, PageSize));
+    REQUIRE(!tracker.IsWritten(0x10000 - PageSize, PageSize));
+    REQUIRE(tracker.IsWritten(0x10000 - 1, 2));
+
+    tracker.Clear(0x10000, PageSize);
+    REQUIRE(!tracker.IsWritten(0x10000, PageSize));
+}
+
+TEST_CASE("WriteBackTracker: Clearing keeps other pages", "[video_core]") {
+    WriteBackTracker tracker;
+    // Spans three pages, crossing a radix leaf boundary
+    const CacheAddr start = 0x40000 - PageSize - 8;
+    tracker.MarkWritten(start, 2 * PageSize);
+    REQUIRE(tracker.IsWritten(start, 1));
+    REQUIRE(tracker.IsWritten(0x40000, 1));
+    REQUIRE(tracker.IsWritten(0x40000 + PageSize - 16, 1));
+
+    tracker.Clear(0x40000, 1);
+    REQUIRE(!tracker.IsWritten(0x40000, PageSize));
+    REQUIRE(tracker.IsWritten(start, PageSize));
+
+    // Marking again the same range doesn't count pages twice
+    tracker.MarkWritten(start, 2 * PageSize);
+    tracker.Clear(start, 3 * PageSize);
+    REQUIRE(!tracker.IsWritten(0, 0x100000));
+}
+
+TEST_CASE("WriteBackTracker: Empty ranges are ignored", "[video_core]") {
+    WriteBackTracker tracker;
+    tracker.MarkWritten(0x1000, 0);
+    REQUIRE(!tracker.IsWritten(0x1000, PageSize));
+    tracker.MarkWritten(0x1000, 1);
+    REQUIRE(!tracker.IsWritten(0x1000, 0));
+}
+
+} // namespace VideoCommon
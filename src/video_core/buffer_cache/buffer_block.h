@@ -60,6 +60,14 @@ public:
         return epoch;
     }
 
+    void MarkAsUsed(u64 new_epoch) {
+        last_use_epoch = new_epoch;
+    }
+
+    u64 GetLastUseEpoch() const {
+        return last_use_epoch;
+    }
+
 protected:
     explicit BufferBlock(CacheAddr cache_addr, const std::size_t size) : size{size} {
         SetCacheAddr(cache_addr);
@@ -71,6 +79,7 @@ private:
     CacheAddr cache_addr_end{};
     std::size_t size{};
     u64 epoch{};
+    u64 last_use_epoch{};
 };
 
 } // namespace VideoCommon
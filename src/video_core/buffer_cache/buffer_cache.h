@@ -4,30 +4,40 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include <boost/icl/interval_map.hpp>
-#include <boost/icl/interval_set.hpp>
-#include <boost/range/iterator_range.hpp>
-
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "core/core.h"
+#include "core/settings.h"
 #include "video_core/buffer_cache/buffer_block.h"
 #include "video_core/buffer_cache/map_interval.h"
+#include "video_core/fence_manager.h"
 #include "video_core/memory_manager.h"
+#include "video_core/page_registry.h"
+#include "video_core/radix_table.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace VideoCommon {
 
 using MapInterval = std::shared_ptr<MapIntervalBase>;
 
+/// Guest memory range accessed by a shader
+struct MemoryRange {
+    GPUVAddr gpu_addr;
+    std::size_t size;
+    bool is_written;
+};
+
 template <typename TBuffer, typename TBufferType, typename StreamBuffer>
 class BufferCache {
 public:
@@ -49,6 +59,7 @@ public:
         constexpr std::size_t max_stream_size = 0x800;
         if (use_fast_cbuf || size < max_stream_size) {
             if (!is_written && !IsRegionWritten(cache_addr, cache_addr + size - 1)) {
+                uploaded_bytes += size;
                 if (use_fast_cbuf) {
                     return ConstBufferUpload(host_ptr, size);
                 } else {
@@ -58,9 +69,10 @@ public:
         }
 
         auto block = GetBlock(cache_addr, size);
+        block->MarkAsUsed(epoch);
         auto map = MapAddress(block, gpu_addr, cache_addr, size);
         if (is_written) {
-            map->MarkAsModified(true, GetModifiedTicks());
+            MarkMapWritten(map);
             if (!map->IsWritten()) {
                 map->MarkAsWritten(true);
                 MarkRegionAsWritten(map->GetStart(), map->GetEnd() - 1);
@@ -76,10 +88,105 @@ public:
         return {ToHandle(block), offset};
     }
 
+    /// Uploads a graphics const buffer bound to a slot. When the same range is uploaded to the
+    /// slot with the same generation, the previous stream buffer upload is reused as long as the
+    /// stream buffer didn't wrap around since.
+    BufferInfo UploadConstBuffer(std::size_t slot, GPUVAddr gpu_addr, std::size_t size,
+                                 std::size_t alignment, u64 generation,
+                                 bool use_fast_cbuf = false) {
+        std::lock_guard lock{mutex};
+
+        if (slot >= const_buffer_slots.size()) {
+            const_buffer_slots.resize(slot + 1);
+        }
+        ConstBufferSlot& upload = const_buffer_slots[slot];
+        if (upload.info.first && upload.gpu_addr == gpu_addr && upload.size == size &&
+            upload.generation == generation && upload.stream_generation == stream_generation) {
+            // The host may have written the range through a storage buffer since
+            const auto cache_addr = ToCacheAddr(system.GPU().MemoryManager().GetPointer(gpu_addr));
+            if (cache_addr && !IsRegionWritten(cache_addr, cache_addr + size - 1)) {
+                reused_bytes += size;
+                return upload.info;
+            }
+        }
+        const BufferInfo info = UploadMemory(gpu_addr, size, alignment, false, use_fast_cbuf);
+        // Other uploads are either rewritten by the next draw or tracked by the cached blocks
+        const bool is_streamed = info.first == &stream_buffer_handle;
+        upload = {gpu_addr, size, generation, stream_generation, is_streamed ? info : BufferInfo{}};
+        return info;
+    }
+
+    /// Returns the mean number of bytes per frame uploaded through the stream buffer since the
+    /// last call, and the mean number of const buffer bytes whose upload was reused.
+    std::pair<u64, u64> GetAndResetUploadStats() {
+        std::lock_guard lock{mutex};
+        const u64 frames = std::exchange(stats_frames, 0);
+        const u64 uploaded = std::exchange(uploaded_bytes, 0);
+        const u64 reused = std::exchange(reused_bytes, 0);
+        if (frames == 0) {
+            return {};
+        }
+        return {uploaded / frames, reused / frames};
+    }
+
+    /// Uploads a set of ranges, writing where each one is located into results. Ranges that
+    /// overlap or touch each other and are used the same way are uploaded as a single one, as
+    /// long as the offsets of the ranges inside of it keep the alignment.
+    void UploadMemoryRanges(const std::vector<MemoryRange>& ranges, std::size_t alignment,
+                            std::vector<BufferInfo>& results) {
+        std::lock_guard lock{mutex};
+
+        results.resize(ranges.size());
+        coalesce_order.clear();
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            if (ranges[i].size == 0) {
+                results[i] = {GetEmptyBuffer(sizeof(u32)), 0};
+                continue;
+            }
+            coalesce_order.push_back(i);
+        }
+        std::sort(coalesce_order.begin(), coalesce_order.end(),
+                  [&ranges](std::size_t lhs, std::size_t rhs) {
+                      return std::tie(ranges[lhs].is_written, ranges[lhs].gpu_addr) <
+                             std::tie(ranges[rhs].is_written, ranges[rhs].gpu_addr);
+                  });
+        std::size_t first = 0;
+        while (first < coalesce_order.size()) {
+            const MemoryRange& head = ranges[coalesce_order[first]];
+            GPUVAddr end = head.gpu_addr + head.size;
+            bool is_aligned = true;
+            std::size_t last = first + 1;
+            for (; last < coalesce_order.size(); ++last) {
+                const MemoryRange& range = ranges[coalesce_order[last]];
+                if (range.is_written != head.is_written || range.gpu_addr > end) {
+                    break;
+                }
+                is_aligned &= (range.gpu_addr - head.gpu_addr) % alignment == 0;
+                end = std::max<GPUVAddr>(end, range.gpu_addr + range.size);
+            }
+            if (is_aligned) {
+                const auto [handle, offset] =
+                    UploadMemory(head.gpu_addr, end - head.gpu_addr, alignment, head.is_written);
+                for (std::size_t i = first; i < last; ++i) {
+                    const std::size_t index = coalesce_order[i];
+                    results[index] = {handle, offset + (ranges[index].gpu_addr - head.gpu_addr)};
+                }
+            } else {
+                for (std::size_t i = first; i < last; ++i) {
+                    const MemoryRange& range = ranges[coalesce_order[i]];
+                    results[coalesce_order[i]] =
+                        UploadMemory(range.gpu_addr, range.size, alignment, range.is_written);
+                }
+            }
+            first = last;
+        }
+    }
+
     /// Uploads from a host memory. Returns the OpenGL buffer where it's located and its offset.
     BufferInfo UploadHostMemory(const void* raw_pointer, std::size_t size,
                                 std::size_t alignment = 4) {
         std::lock_guard lock{mutex};
+        uploaded_bytes += size;
         return StreamBufferUpload(raw_pointer, size, alignment);
     }
 
@@ -88,6 +195,11 @@ public:
 
         std::tie(buffer_ptr, buffer_offset_base, invalidated) = stream_buffer->Map(max_size, 4);
         buffer_offset = buffer_offset_base;
+        if (invalidated) {
+            // The stream buffer might have grown into a new handle
+            stream_buffer_handle = stream_buffer->GetHandle();
+            ++stream_generation;
+        }
     }
 
     /// Finishes the upload stream, returns true on bindings invalidation.
@@ -99,16 +211,20 @@ public:
     }
 
     void TickFrame() {
+        std::lock_guard lock{mutex};
+
         ++epoch;
+        ++stats_frames;
+        stream_buffer->TickFrame();
         while (!pending_destruction.empty()) {
             // Delay at least 4 frames before destruction.
             // This is due to triple buffering happening on some drivers.
-            static constexpr u64 epochs_to_destroy = 5;
             if (pending_destruction.front()->GetEpoch() + epochs_to_destroy > epoch) {
                 break;
             }
             pending_destruction.pop_front();
         }
+        EvictBlocks();
     }
 
     /// Write any cached resources overlapping the specified region back to memory
@@ -126,6 +242,91 @@ public:
         }
     }
 
+    /// Returns true when maps have been written since the last committed batch.
+    bool HasUncommittedFlushes() const {
+        return !uncommitted_flushes.empty();
+    }
+
+    /// Returns true when the oldest committed batch has maps to download.
+    bool ShouldWaitAsyncFlushes() const {
+        return !committed_flushes.empty() && !committed_flushes.front().empty();
+    }
+
+    /// Commits the maps written so far as a batch, flushed once its fence is released.
+    void CommitAsyncFlushes() {
+        std::lock_guard lock{mutex};
+        committed_flushes.push_back(std::exchange(uncommitted_flushes, {}));
+    }
+
+    /// Flushes the oldest committed batch.
+    void PopAsyncFlushes() {
+        std::lock_guard lock{mutex};
+        if (committed_flushes.empty()) {
+            return;
+        }
+        for (const MapInterval& map : committed_flushes.front()) {
+            if (map->IsModified() && map->IsRegistered()) {
+                FlushMap(map);
+            }
+        }
+        committed_flushes.pop_front();
+    }
+
+    /**
+     * Copies a linear region written by the host GPU to another region without downloading it.
+     * Returns false when the source isn't entirely held by a single modified map, guest memory
+     * is up to date then and the caller has to copy it.
+     */
+    bool CopyRegion(GPUVAddr src_addr, GPUVAddr dst_addr, std::size_t size) {
+        std::lock_guard lock{mutex};
+
+        auto& memory_manager = system.GPU().MemoryManager();
+        const u8* const src_host_ptr = memory_manager.GetPointer(src_addr);
+        const u8* const dst_host_ptr = memory_manager.GetPointer(dst_addr);
+        if (size == 0 || !src_host_ptr || !dst_host_ptr ||
+            !memory_manager.IsBlockContinuous(src_addr, size) ||
+            !memory_manager.IsBlockContinuous(dst_addr, size)) {
+            return false;
+        }
+        const CacheAddr src_cache_addr = ToCacheAddr(src_host_ptr);
+        const CacheAddr dst_cache_addr = ToCacheAddr(dst_host_ptr);
+        const CacheAddr dst_cache_addr_end = dst_cache_addr + size;
+
+        const std::vector<MapInterval> src_maps = GetMapsInRange(src_cache_addr, size);
+        if (src_maps.size() != 1) {
+            return false;
+        }
+        const MapInterval& src_map = src_maps[0];
+        if (!src_map->IsModified() || !src_map->IsInside(src_cache_addr, src_cache_addr + size)) {
+            return false;
+        }
+        if (src_map->GetStart() < dst_cache_addr_end && dst_cache_addr < src_map->GetEnd()) {
+            // Invalidating the destination would drop the source
+            return false;
+        }
+
+        // The destination is overwritten, drop what any cache had there as a guest write would
+        rasterizer.InvalidateRegion(dst_cache_addr, size);
+
+        // Getting the destination block can merge it with the source block, search the source after
+        const TBuffer dst_block = GetBlock(dst_cache_addr, size);
+        dst_block->MarkAsUsed(epoch);
+        const TBuffer src_block = blocks[src_map->GetStart() >> block_page_bits];
+        src_block->MarkAsUsed(epoch);
+
+        if (src_map->IsWritten()) {
+            WriteBarrier();
+        }
+        CopyBlock(src_block, dst_block, src_block->GetOffset(src_cache_addr),
+                  dst_block->GetOffset(dst_cache_addr), size);
+
+        // The whole destination has just been written, it doesn't have to be uploaded
+        MapInterval dst_map = CreateMap(dst_cache_addr, dst_cache_addr_end, dst_addr);
+        Register(dst_map);
+        MarkMapWritten(dst_map);
+        return true;
+    }
+
     /// Mark the specified region as being invalidated
     void InvalidateRegion(CacheAddr addr, u64 size) {
         std::lock_guard lock{mutex};
@@ -180,8 +381,7 @@ protected:
         const std::size_t size = new_map->GetEnd() - new_map->GetStart();
         new_map->SetCpuAddress(*cpu_addr);
         new_map->MarkAsRegistered(true);
-        const IntervalType interval{new_map->GetStart(), new_map->GetEnd()};
-        mapped_addresses.insert({interval, new_map});
+        mapped_addresses.Insert(new_map, new_map->GetStart(), new_map->GetEnd());
         rasterizer.UpdatePagesCachedCount(*cpu_addr, size, 1);
         if (inherit_written) {
             MarkRegionAsWritten(new_map->GetStart(), new_map->GetEnd() - 1);
@@ -197,8 +397,7 @@ protected:
         if (map->IsWritten()) {
             UnmarkRegionAsWritten(map->GetStart(), map->GetEnd() - 1);
         }
-        const IntervalType delete_interval{map->GetStart(), map->GetEnd()};
-        mapped_addresses.erase(delete_interval);
+        mapped_addresses.Erase(map, map->GetStart(), map->GetEnd());
     }
 
 private:
@@ -244,7 +443,7 @@ private:
         UpdateBlock(block, new_start, new_end, overlaps);
         MapInterval new_map = CreateMap(new_start, new_end, new_gpu_addr);
         if (modified_inheritance) {
-            new_map->MarkAsModified(true, GetModifiedTicks());
+            MarkMapWritten(new_map);
         }
         Register(new_map, write_inheritance);
         return new_map;
@@ -252,20 +451,25 @@ private:
 
     void UpdateBlock(const TBuffer& block, CacheAddr start, CacheAddr end,
                      std::vector<MapInterval>& overlaps) {
-        const IntervalType base_interval{start, end};
-        IntervalSet interval_set{};
-        interval_set.add(base_interval);
+        // Registered maps never overlap each other, so the regions to upload are the gaps between
+        // the overlaps once they are sorted by address
+        std::sort(overlaps.begin(), overlaps.end(), [](const MapInterval& a, const MapInterval& b) {
+            return a->GetStart() < b->GetStart();
+        });
+        CacheAddr gap_start = start;
         for (auto& overlap : overlaps) {
-            const IntervalType subtract{overlap->GetStart(), overlap->GetEnd()};
-            interval_set.subtract(subtract);
-        }
-        for (auto& interval : interval_set) {
-            std::size_t size = interval.upper() - interval.lower();
-            if (size > 0) {
-                u8* host_ptr = FromCacheAddr(interval.lower());
-                UploadBlockData(block, block->GetOffset(interval.lower()), size, host_ptr);
-            }
+            UploadGap(block, gap_start, overlap->GetStart());
+            gap_start = std::max(gap_start, overlap->GetEnd());
+        }
+        UploadGap(block, gap_start, end);
+    }
+
+    void UploadGap(const TBuffer& block, CacheAddr start, CacheAddr end) {
+        if (start >= end) {
+            return;
         }
+        u8* host_ptr = FromCacheAddr(start);
+        UploadBlockData(block, block->GetOffset(start), end - start, host_ptr);
     }
 
     std::vector<MapInterval> GetMapsInRange(CacheAddr addr, std::size_t size) {
@@ -274,12 +478,29 @@ private:
         }
 
         std::vector<MapInterval> objects{};
-        const IntervalType interval{addr, addr + size};
-        for (auto& pair : boost::make_iterator_range(mapped_addresses.equal_range(interval))) {
-            objects.push_back(pair.second);
+        mapped_addresses.ForEachOverlap(addr, addr + size,
+                                        [&](const MapInterval& map) { objects.push_back(map); });
+        return objects;
+    }
+
+    /// Queues a written map to be flushed with the next committed batch.
+    /// Marks a map as modified by the GPU, the CPU has to flush it before reading its memory.
+    void MarkMapWritten(const MapInterval& map) {
+        if (!map->IsModified()) {
+            system.GPU().MarkRegionWritten(map->GetStart(), map->GetEnd() - map->GetStart());
         }
+        map->MarkAsModified(true, GetModifiedTicks());
+        AsyncFlushMap(map);
+    }
 
-        return objects;
+    void AsyncFlushMap(const MapInterval& map) {
+        if (!IsAsyncFlushEnabled()) {
+            return;
+        }
+        if (std::find(uncommitted_flushes.begin(), uncommitted_flushes.end(), map) ==
+            uncommitted_flushes.end()) {
+            uncommitted_flushes.push_back(map);
+        }
     }
 
     /// Returns a ticks counter used for tracking when cached objects were last modified
@@ -317,10 +538,10 @@ private:
         const std::size_t old_size = buffer->GetSize();
         const std::size_t new_size = old_size + block_page_size;
         const CacheAddr cache_addr = buffer->GetCacheAddr();
-        TBuffer new_buffer = CreateBlock(cache_addr, new_size);
+        TBuffer new_buffer = AllocateBlock(cache_addr, new_size);
         CopyBlock(buffer, new_buffer, 0, 0, old_size);
-        buffer->SetEpoch(epoch);
-        pending_destruction.push_back(buffer);
+        new_buffer->MarkAsUsed(buffer->GetLastUseEpoch());
+        DestroyBlock(buffer);
         const CacheAddr cache_addr_end = cache_addr + new_size - 1;
         u64 page_start = cache_addr >> block_page_bits;
         const u64 page_end = cache_addr_end >> block_page_bits;
@@ -338,13 +559,12 @@ private:
         const CacheAddr second_addr = second->GetCacheAddr();
         const CacheAddr new_addr = std::min(first_addr, second_addr);
         const std::size_t new_size = size_1 + size_2;
-        TBuffer new_buffer = CreateBlock(new_addr, new_size);
+        TBuffer new_buffer = AllocateBlock(new_addr, new_size);
         CopyBlock(first, new_buffer, 0, new_buffer->GetOffset(first_addr), size_1);
         CopyBlock(second, new_buffer, 0, new_buffer->GetOffset(second_addr), size_2);
-        first->SetEpoch(epoch);
-        second->SetEpoch(epoch);
-        pending_destruction.push_back(first);
-        pending_destruction.push_back(second);
+        new_buffer->MarkAsUsed(std::max(first->GetLastUseEpoch(), second->GetLastUseEpoch()));
+        DestroyBlock(first);
+        DestroyBlock(second);
         const CacheAddr cache_addr_end = new_addr + new_size - 1;
         u64 page_start = new_addr >> block_page_bits;
         const u64 page_end = cache_addr_end >> block_page_bits;
@@ -355,6 +575,64 @@ private:
         return new_buffer;
     }
 
+    TBuffer AllocateBlock(CacheAddr cache_addr, std::size_t size) {
+        memory_usage += size;
+        return CreateBlock(cache_addr, size);
+    }
+
+    /// Queues a block for destruction, the host may still be using it for a few frames.
+    void DestroyBlock(const TBuffer& block) {
+        memory_usage -= block->GetSize();
+        block->SetEpoch(epoch);
+        pending_destruction.push_back(block);
+    }
+
+    /// Evicts the least recently used blocks while the cache is over the configured budget.
+    /// Written maps are flushed to guest memory before their block is released.
+    void EvictBlocks() {
+        const u64 budget = static_cast<u64>(Settings::values.vram_budget) << 20;
+        if (budget == 0 || memory_usage <= budget) {
+            return;
+        }
+        std::vector<TBuffer> candidates;
+        std::unordered_set<TBuffer> visited;
+        for (const auto& [page, block] : blocks) {
+            // Blocks used in the last frames may still be in flight
+            if (block->GetLastUseEpoch() + epochs_to_destroy > epoch) {
+                continue;
+            }
+            if (visited.insert(block).second) {
+                candidates.push_back(block);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const TBuffer& a, const TBuffer& b) {
+            return a->GetLastUseEpoch() < b->GetLastUseEpoch();
+        });
+        for (const TBuffer& block : candidates) {
+            if (memory_usage <= budget) {
+                break;
+            }
+            EvictBlock(block);
+        }
+    }
+
+    void EvictBlock(const TBuffer& block) {
+        const CacheAddr start = block->GetCacheAddr();
+        for (auto& map : GetMapsInRange(start, block->GetSize())) {
+            if (map->IsModified()) {
+                FlushMap(map);
+            }
+            Unregister(map);
+        }
+        u64 page_start = start >> block_page_bits;
+        const u64 page_end = (block->GetCacheAddrEnd() - 1) >> block_page_bits;
+        while (page_start <= page_end) {
+            blocks.erase(page_start);
+            ++page_start;
+        }
+        DestroyBlock(block);
+    }
+
     TBuffer GetBlock(const CacheAddr cache_addr, const std::size_t size) {
         TBuffer found{};
         const CacheAddr cache_addr_end = cache_addr + size - 1;
@@ -367,7 +645,7 @@ private:
                     found = EnlargeBlock(found);
                 } else {
                     const CacheAddr start_addr = (page_start << block_page_bits);
-                    found = CreateBlock(start_addr, block_page_size);
+                    found = AllocateBlock(start_addr, block_page_size);
                     blocks[page_start] = found;
                 }
             } else {
@@ -390,12 +668,7 @@ private:
         u64 page_start = start >> write_page_bit;
         const u64 page_end = end >> write_page_bit;
         while (page_start <= page_end) {
-            auto it = written_pages.find(page_start);
-            if (it != written_pages.end()) {
-                it->second = it->second + 1;
-            } else {
-                written_pages[page_start] = 1;
-            }
+            ++written_pages[page_start];
             page_start++;
         }
     }
@@ -404,28 +677,19 @@ private:
         u64 page_start = start >> write_page_bit;
         const u64 page_end = end >> write_page_bit;
         while (page_start <= page_end) {
-            auto it = written_pages.find(page_start);
-            if (it != written_pages.end()) {
-                if (it->second > 1) {
-                    it->second = it->second - 1;
-                } else {
-                    written_pages.erase(it);
-                }
+            u32* const count = written_pages.Find(page_start);
+            if (count && *count > 0) {
+                --*count;
             }
             page_start++;
         }
     }
 
     bool IsRegionWritten(const CacheAddr start, const CacheAddr end) const {
-        u64 page_start = start >> write_page_bit;
-        const u64 page_end = end >> write_page_bit;
-        while (page_start <= page_end) {
-            if (written_pages.count(page_start) > 0) {
-                return true;
-            }
-            page_start++;
-        }
-        return false;
+        const u64 page_start = start >> write_page_bit;
+        const u64 page_end = (end >> write_page_bit) + 1;
+        return written_pages.ForEachInRange(page_start, page_end,
+                                            [](u64, u32 count) { return count > 0; });
     }
 
     VideoCore::RasterizerInterface& rasterizer;
@@ -435,27 +699,49 @@ private:
     TBufferType stream_buffer_handle{};
 
     bool invalidated = false;
+    u64 stream_generation = 0; ///< Bumped whenever the stream buffer wraps around
+
+    struct ConstBufferSlot {
+        GPUVAddr gpu_addr{};
+        std::size_t size{};
+        u64 generation{};
+        u64 stream_generation{};
+        BufferInfo info{};
+    };
+    std::vector<ConstBufferSlot> const_buffer_slots;
+
+    std::vector<std::size_t> coalesce_order;
 
     u8* buffer_ptr = nullptr;
     u64 buffer_offset = 0;
     u64 buffer_offset_base = 0;
 
-    using IntervalSet = boost::icl::interval_set<CacheAddr>;
-    using IntervalCache = boost::icl::interval_map<CacheAddr, MapInterval>;
-    using IntervalType = typename IntervalCache::interval_type;
-    IntervalCache mapped_addresses;
+    PageRegistry<MapInterval, 16> mapped_addresses;
 
+    // Number of written maps touching each page
     static constexpr u64 write_page_bit = 11;
-    std::unordered_map<u64, u32> written_pages;
+    RadixTable<u32, 9> written_pages;
 
     static constexpr u64 block_page_bits = 21;
     static constexpr u64 block_page_size = 1ULL << block_page_bits;
     std::unordered_map<u64, TBuffer> blocks;
 
+    // Written maps waiting for a syncpoint, and batches waiting for their fence
+    std::vector<MapInterval> uncommitted_flushes;
+    std::list<std::vector<MapInterval>> committed_flushes;
+
     std::list<TBuffer> pending_destruction;
+    static constexpr u64 epochs_to_destroy = 5;
     u64 epoch = 0;
+
+    // Host memory held by the live blocks, used to enforce the memory budget
+    u64 memory_usage = 0;
     u64 modified_ticks = 0;
 
+    u64 stats_frames = 0;
+    u64 uploaded_bytes = 0;
+    u64 reused_bytes = 0;
+
     std::recursive_mutex mutex;
 };
 
@@ -4,6 +4,7 @@
 
 #include "common/microprofile.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/memory.h"
 #include "video_core/dma_pusher.h"
 #include "video_core/engines/maxwell_3d.h"
@@ -17,50 +18,52 @@ DmaPusher::DmaPusher(GPU& gpu) : gpu(gpu) {}
 DmaPusher::~DmaPusher() = default;
 
 MICROPROFILE_DEFINE(DispatchCalls, "GPU", "Execute command buffer", MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(DecodeCommandList, "GPU", "Decode command buffer", MP_RGB(128, 160, 192));
+
+MethodStream DmaPusher::Decode(const CommandList& entries) {
+    MICROPROFILE_SCOPE(DecodeCommandList);
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DmaParse};
+
+    MethodStream stream;
+    if (!ib_enable) {
+        // IB disabled - nothing to do
+        return stream;
+    }
+
+    // Somehow the command_list is empty, in that case just ignore it.
+    ASSERT(!entries.empty());
+
+    for (const CommandListHeader& command_list_header : entries) {
+        DecodeSegment(command_list_header, stream);
+    }
+    return stream;
+}
 
 void DmaPusher::DispatchCalls() {
     MICROPROFILE_SCOPE(DispatchCalls);
+    // Whatever the engines don't account to another stage is spent dispatching methods
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DmaParse};
 
     // On entering GPU code, assume all memory may be touched by the ARM core.
-    gpu.Maxwell3D().dirty.OnMemoryWrite();
-
-    dma_pushbuffer_subindex = 0;
+    gpu.Maxwell3D().OnMemoryWrite();
 
-    while (Core::System::GetInstance().IsPoweredOn()) {
-        if (!Step()) {
-            break;
+    while (!method_streams.empty() && Core::System::GetInstance().IsPoweredOn()) {
+        const MethodStream& stream{method_streams.front()};
+        for (const MethodRun& run : stream.runs) {
+            DispatchRun(stream, run);
         }
+        method_streams.pop();
     }
     gpu.FlushCommands();
 }
 
-bool DmaPusher::Step() {
-    if (!ib_enable || dma_pushbuffer.empty()) {
-        // pushbuffer empty and IB empty or nonexistent - nothing to do
-        return false;
-    }
-
-    const CommandList& command_list{dma_pushbuffer.front()};
-    ASSERT_OR_EXECUTE(!command_list.empty(), {
-        // Somehow the command_list is empty, in order to avoid a crash
-        // We ignore it and assume its size is 0.
-        dma_pushbuffer.pop();
-        dma_pushbuffer_subindex = 0;
-        return true;
-    });
-    const CommandListHeader command_list_header{command_list[dma_pushbuffer_subindex++]};
-    GPUVAddr dma_get = command_list_header.addr;
-    GPUVAddr dma_put = dma_get + command_list_header.size * sizeof(u32);
-    bool non_main = command_list_header.is_non_main;
-
-    if (dma_pushbuffer_subindex >= command_list.size()) {
-        // We've gone through the current list, remove it from the queue
-        dma_pushbuffer.pop();
-        dma_pushbuffer_subindex = 0;
-    }
+void DmaPusher::DecodeSegment(const CommandListHeader& command_list_header, MethodStream& stream) {
+    const GPUVAddr dma_get = command_list_header.addr;
+    const GPUVAddr dma_put = dma_get + command_list_header.size * sizeof(u32);
+    const bool non_main = command_list_header.is_non_main;
 
     if (command_list_header.size == 0) {
-        return true;
+        return;
     }
 
     // Push buffer non-empty, read a word
@@ -77,7 +80,7 @@ bool DmaPusher::Step() {
             dma_state.method_count = command_header.method_count_;
         } else if (dma_state.method_count) {
             // Data word of methods command
-            CallMethod(command_header.argument);
+            AppendCall(stream, command_header.argument);
 
             if (!dma_state.non_incrementing) {
                 dma_state.method++;
@@ -104,7 +107,7 @@ bool DmaPusher::Step() {
             case SubmissionMode::Inline:
                 dma_state.method = command_header.method;
                 dma_state.subchannel = command_header.subchannel;
-                CallMethod(command_header.arg_count);
+                AppendCall(stream, command_header.arg_count);
                 dma_state.non_incrementing = true;
                 dma_increment_once = false;
                 break;
@@ -123,8 +126,6 @@ bool DmaPusher::Step() {
         // TODO (degasus): This is dead code, as dma_mget is never read.
         dma_mget = dma_put;
     }
-
-    return true;
 }
 
 void DmaPusher::SetState(const CommandHeader& command_header) {
@@ -133,8 +134,37 @@ void DmaPusher::SetState(const CommandHeader& command_header) {
     dma_state.method_count = command_header.method_count;
 }
 
-void DmaPusher::CallMethod(u32 argument) const {
-    gpu.CallMethod({dma_state.method, argument, dma_state.subchannel, dma_state.method_count});
+void DmaPusher::AppendCall(MethodStream& stream, u32 argument) const {
+    const auto argument_offset = static_cast<u32>(stream.arguments.size());
+    stream.arguments.push_back(argument);
+
+    if (!stream.runs.empty()) {
+        // Extend the previous run when this call is the one it would have made next
+        MethodRun& run = stream.runs.back();
+        const u32 next_method = run.non_incrementing ? run.method : run.method + run.argument_count;
+        if (run.subchannel == dma_state.subchannel &&
+            run.non_incrementing == dma_state.non_incrementing &&
+            next_method == dma_state.method &&
+            run.methods_pending - run.argument_count == dma_state.method_count) {
+            run.argument_count++;
+            return;
+        }
+    }
+
+    stream.runs.push_back({dma_state.method, dma_state.subchannel, dma_state.method_count,
+                           argument_offset, 1, dma_state.non_incrementing});
+}
+
+void DmaPusher::DispatchRun(const MethodStream& stream, const MethodRun& run) const {
+    const u32* const arguments = stream.arguments.data() + run.argument_offset;
+    if (run.non_incrementing) {
+        gpu.CallMultiMethod(run.method, run.subchannel, arguments, run.argument_count,
+                            run.methods_pending);
+        return;
+    }
+    for (u32 i = 0; i < run.argument_count; ++i) {
+        gpu.CallMethod({run.method + i, arguments[i], run.subchannel, run.methods_pending - i});
+    }
 }
 
 } // namespace Tegra
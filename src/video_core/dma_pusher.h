@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <vector>
 #include <queue>
+#include <vector>
 
 #include "common/bit_field.h"
 #include "common/common_types.h"
@@ -47,6 +47,22 @@ class GPU;
 
 using CommandList = std::vector<Tegra::CommandListHeader>;
 
+/// Arguments for consecutive calls to a method, decoded from a pushbuffer ahead of execution
+struct MethodRun {
+    u32 method;            ///< Method of the first call
+    u32 subchannel;        ///< Subchannel of every call
+    u32 methods_pending;   ///< Method count remaining at the first call
+    u32 argument_offset;   ///< Index of the first argument in the stream's argument buffer
+    u32 argument_count;    ///< Number of calls in the run
+    bool non_incrementing; ///< Whether every call goes to the same method
+};
+
+/// Method calls decoded from one command list, ready to be dispatched to the engines
+struct MethodStream {
+    std::vector<MethodRun> runs;
+    std::vector<u32> arguments;
+};
+
 /**
  * The DmaPusher class implements DMA submission to FIFOs, providing an area of memory that the
  * emulated app fills with commands and tells PFIFO to process. The pushbuffers are then assembled
@@ -59,25 +75,36 @@ public:
     explicit DmaPusher(GPU& gpu);
     ~DmaPusher();
 
-    void Push(CommandList&& entries) {
-        dma_pushbuffer.push(std::move(entries));
+    /**
+     * Reads the pushbuffers referenced by a command list and decodes them into method calls.
+     * This is done by the thread submitting command lists, ahead of their execution, so only the
+     * decoder state below is touched here.
+     */
+    MethodStream Decode(const CommandList& entries);
+
+    /// Queues a decoded method stream for execution
+    void Push(MethodStream&& stream) {
+        method_streams.push(std::move(stream));
     }
 
+    /// Calls the engine methods of every queued method stream
     void DispatchCalls();
 
 private:
-    bool Step();
+    void DecodeSegment(const CommandListHeader& command_list_header, MethodStream& stream);
 
     void SetState(const CommandHeader& command_header);
 
-    void CallMethod(u32 argument) const;
+    /// Records a call with the current method state.
+    void AppendCall(MethodStream& stream, u32 argument) const;
+
+    void DispatchRun(const MethodStream& stream, const MethodRun& run) const;
 
     GPU& gpu;
 
-    std::vector<CommandHeader> command_headers; ///< Buffer for list of commands fetched at once
+    std::queue<MethodStream> method_streams; ///< Queue of decoded command lists to be executed
 
-    std::queue<CommandList> dma_pushbuffer; ///< Queue of command lists to be processed
-    std::size_t dma_pushbuffer_subindex{};  ///< Index within a command list within the pushbuffer
+    std::vector<CommandHeader> command_headers; ///< Buffer for list of commands fetched at once
 
     struct DmaState {
         u32 method;            ///< Current method
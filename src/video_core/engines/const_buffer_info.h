@@ -12,6 +12,7 @@ struct ConstBufferInfo {
     GPUVAddr address;
     u32 size;
     bool enabled;
+    u64 generation; ///< Changes whenever the guest contents behind the buffer may have changed
 };
 
 } // namespace Tegra::Engines
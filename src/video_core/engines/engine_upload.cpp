@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/assert.h"
@@ -24,8 +25,13 @@ void State::ProcessExec(const bool is_linear) {
 }
 
 void State::ProcessData(const u32 data, const bool is_last_call) {
-    const u32 sub_copy_size = std::min(4U, copy_size - write_offset);
-    std::memcpy(&inner_buffer[write_offset], &data, sub_copy_size);
+    ProcessData(&data, 1, is_last_call);
+}
+
+void State::ProcessData(const u32* data, std::size_t num_data, const bool is_last_call) {
+    const u32 sub_copy_size =
+        static_cast<u32>(std::min<std::size_t>(num_data * sizeof(u32), copy_size - write_offset));
+    std::memcpy(inner_buffer.data() + write_offset, data, sub_copy_size);
     write_offset += sub_copy_size;
     if (!is_last_call) {
         return;
@@ -59,6 +59,7 @@ public:
 
     void ProcessExec(bool is_linear);
     void ProcessData(u32 data, bool is_last_call);
+    void ProcessData(const u32* data, std::size_t num_data, bool is_last_call);
 
 private:
     u32 write_offset = 0;
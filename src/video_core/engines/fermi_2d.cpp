@@ -28,6 +28,17 @@ void Fermi2D::CallMethod(const GPU::MethodCall& method_call) {
     }
 }
 
+void Fermi2D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
+                              u32 methods_pending) {
+    for (u32 i = 0; i < amount; ++i) {
+        CallMethod({method, base_start[i], 0, methods_pending - i});
+    }
+}
+
+std::pair<u32, u32> Fermi2D::GetAndResetBlitStats() {
+    return {accelerated_blits.exchange(0), unhandled_blits.exchange(0)};
+}
+
 std::pair<u32, u32> DelimitLine(u32 src_1, u32 src_2, u32 dst_1, u32 dst_2, u32 src_line) {
     const u32 line_a = src_2 - src_1;
     const u32 line_b = dst_2 - dst_1;
@@ -39,9 +50,6 @@ void Fermi2D::HandleSurfaceCopy() {
     LOG_DEBUG(HW_GPU, "Requested a surface copy with operation {}",
               static_cast<u32>(regs.operation));
 
-    // TODO(Subv): Only raw copies are implemented.
-    ASSERT(regs.operation == Operation::SrcCopy);
-
     const u32 src_blit_x1{static_cast<u32>(regs.blit_src_x >> 32)};
     const u32 src_blit_y1{static_cast<u32>(regs.blit_src_y >> 32)};
     u32 src_blit_x2, src_blit_y2;
@@ -81,9 +89,14 @@ void Fermi2D::HandleSurfaceCopy() {
     copy_config.src_rect = src_rect;
     copy_config.dst_rect = dst_rect;
 
-    if (!rasterizer.AccelerateSurfaceCopy(regs.src, regs.dst, copy_config)) {
-        UNIMPLEMENTED();
+    if (rasterizer.AccelerateSurfaceCopy(regs.src, regs.dst, copy_config)) {
+        ++accelerated_blits;
+        return;
     }
+    ++unhandled_blits;
+    LOG_WARNING(HW_GPU, "Unhandled surface copy with operation {} from format {} to format {}",
+                static_cast<u32>(regs.operation), static_cast<u32>(regs.src.format),
+                static_cast<u32>(regs.dst.format));
 }
 
 } // namespace Tegra::Engines
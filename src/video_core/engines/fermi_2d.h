@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <utility>
 #include "common/bit_field.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
@@ -39,6 +41,13 @@ public:
     /// Write the value to the register identified by method.
     void CallMethod(const GPU::MethodCall& method_call);
 
+    /// Write multiple values to the register identified by method.
+    void CallMultiMethod(u32 method, const u32* base_start, u32 amount, u32 methods_pending);
+
+    /// Returns the number of surface copies performed by the host GPU since the last call, and
+    /// the number of copies the host couldn't perform.
+    std::pair<u32, u32> GetAndResetBlitStats();
+
     enum class Origin : u32 {
         Center = 0,
         Corner = 1,
@@ -146,6 +155,9 @@ public:
 private:
     VideoCore::RasterizerInterface& rasterizer;
 
+    std::atomic<u32> accelerated_blits{};
+    std::atomic<u32> unhandled_blits{};
+
     /// Performs the copy from the source surface to the destination surface as configured in the
     /// registers.
     void HandleSurfaceCopy();
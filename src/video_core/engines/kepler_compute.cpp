@@ -39,7 +39,7 @@ void KeplerCompute::CallMethod(const GPU::MethodCall& method_call) {
         const bool is_last_call = method_call.IsLastCall();
         upload_state.ProcessData(method_call.argument, is_last_call);
         if (is_last_call) {
-            system.GPU().Maxwell3D().dirty.OnMemoryWrite();
+            system.GPU().Maxwell3D().OnMemoryWrite();
         }
         break;
     }
@@ -51,6 +51,23 @@ void KeplerCompute::CallMethod(const GPU::MethodCall& method_call) {
     }
 }
 
+void KeplerCompute::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
+                                    u32 methods_pending) {
+    // Inline uploads are copied as a whole, unless their last call comes before the end of the run
+    if (method == KEPLER_COMPUTE_REG_INDEX(data_upload) && methods_pending >= amount) {
+        const bool is_last_call = methods_pending == amount;
+        regs.reg_array[method] = base_start[amount - 1];
+        upload_state.ProcessData(base_start, amount, is_last_call);
+        if (is_last_call) {
+            system.GPU().Maxwell3D().OnMemoryWrite();
+        }
+        return;
+    }
+    for (u32 i = 0; i < amount; ++i) {
+        CallMethod({method, base_start[i], 0, methods_pending - i});
+    }
+}
+
 Texture::FullTextureInfo KeplerCompute::GetTexture(std::size_t offset) const {
     const std::bitset<8> cbuf_mask = launch_description.const_buffer_enable_mask.Value();
     ASSERT(cbuf_mask[regs.tex_cb_index]);
@@ -110,6 +127,12 @@ void KeplerCompute::ProcessLaunch() {
     const GPUVAddr code_addr = regs.code_loc.Address() + launch_description.program_start;
     LOG_TRACE(HW_GPU, "Compute invocation launched at address 0x{:016x}", code_addr);
 
+    // Empty grids don't invoke the kernel, skip building its bindings
+    if (launch_description.grid_dim_x == 0 || launch_description.grid_dim_y == 0 ||
+        launch_description.grid_dim_z == 0) {
+        return;
+    }
+
     rasterizer.DispatchCompute(code_addr);
 }
 
@@ -2,11 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
+#include <utility>
 #include "common/assert.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/frame_timeline.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
 #include "video_core/memory_manager.h"
@@ -18,99 +21,66 @@ namespace Tegra::Engines {
 /// First register id that is actually a Macro call.
 constexpr u32 MacroRegistersStart = 0xE00;
 
-Maxwell3D::Maxwell3D(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
-                     MemoryManager& memory_manager)
-    : system{system}, rasterizer{rasterizer}, memory_manager{memory_manager},
-      macro_interpreter{*this}, upload_state{memory_manager, regs.upload} {
-    InitDirtySettings();
-    InitializeRegisterDefaults();
-}
-
-void Maxwell3D::InitializeRegisterDefaults() {
-    // Initializes registers to their default values - what games expect them to be at boot. This is
-    // for certain registers that may not be explicitly set by games.
-
-    // Reset all registers to zero
-    std::memset(&regs, 0, sizeof(regs));
-
-    // Depth range near/far is not always set, but is expected to be the default 0.0f, 1.0f. This is
-    // needed for ARMS.
-    for (auto& viewport : regs.viewports) {
-        viewport.depth_range_near = 0.0f;
-        viewport.depth_range_far = 1.0f;
-    }
-
-    // Doom and Bomberman seems to use the uninitialized registers and just enable blend
-    // so initialize blend registers with sane values
-    regs.blend.equation_rgb = Regs::Blend::Equation::Add;
-    regs.blend.factor_source_rgb = Regs::Blend::Factor::One;
-    regs.blend.factor_dest_rgb = Regs::Blend::Factor::Zero;
-    regs.blend.equation_a = Regs::Blend::Equation::Add;
-    regs.blend.factor_source_a = Regs::Blend::Factor::One;
-    regs.blend.factor_dest_a = Regs::Blend::Factor::Zero;
-    for (auto& blend : regs.independent_blend) {
-        blend.equation_rgb = Regs::Blend::Equation::Add;
-        blend.factor_source_rgb = Regs::Blend::Factor::One;
-        blend.factor_dest_rgb = Regs::Blend::Factor::Zero;
-        blend.equation_a = Regs::Blend::Equation::Add;
-        blend.factor_source_a = Regs::Blend::Factor::One;
-        blend.factor_dest_a = Regs::Blend::Factor::Zero;
-    }
-    regs.stencil_front_op_fail = Regs::StencilOp::Keep;
-    regs.stencil_front_op_zfail = Regs::StencilOp::Keep;
-    regs.stencil_front_op_zpass = Regs::StencilOp::Keep;
-    regs.stencil_front_func_func = Regs::ComparisonOp::Always;
-    regs.stencil_front_func_mask = 0xFFFFFFFF;
-    regs.stencil_front_mask = 0xFFFFFFFF;
-    regs.stencil_two_side_enable = 1;
-    regs.stencil_back_op_fail = Regs::StencilOp::Keep;
-    regs.stencil_back_op_zfail = Regs::StencilOp::Keep;
-    regs.stencil_back_op_zpass = Regs::StencilOp::Keep;
-    regs.stencil_back_func_func = Regs::ComparisonOp::Always;
-    regs.stencil_back_func_mask = 0xFFFFFFFF;
-    regs.stencil_back_mask = 0xFFFFFFFF;
-
-    regs.depth_test_func = Regs::ComparisonOp::Always;
-    regs.cull.front_face = Regs::Cull::FrontFace::CounterClockWise;
-    regs.cull.cull_face = Regs::Cull::CullFace::Back;
-
-    // TODO(Rodrigo): Most games do not set a point size. I think this is a case of a
-    // register carrying a default value. Assume it's OpenGL's default (1).
-    regs.point_size = 1.0f;
-
-    // TODO(bunnei): Some games do not initialize the color masks (e.g. Sonic Mania). Assuming a
-    // default of enabled fixes rendering here.
-    for (auto& color_mask : regs.color_mask) {
-        color_mask.R.Assign(1);
-        color_mask.G.Assign(1);
-        color_mask.B.Assign(1);
-        color_mask.A.Assign(1);
+/// Returns true when some backends emulate the topology generating a new index buffer.
+static bool IsEmulatedTopology(Maxwell3D::Regs::PrimitiveTopology topology) {
+    switch (topology) {
+    case Maxwell3D::Regs::PrimitiveTopology::Quads:
+    case Maxwell3D::Regs::PrimitiveTopology::QuadStrip:
+    case Maxwell3D::Regs::PrimitiveTopology::LineLoop:
+        return true;
+    default:
+        return false;
     }
-
-    // NVN games expect these values to be enabled at boot
-    regs.rasterize_enable = 1;
-    regs.rt_separate_frag_data = 1;
-    regs.framebuffer_srgb = 1;
-    regs.cull.front_face = Maxwell3D::Regs::Cull::FrontFace::ClockWise;
-
-    mme_inline[MAXWELL3D_REG_INDEX(draw.vertex_end_gl)] = true;
-    mme_inline[MAXWELL3D_REG_INDEX(draw.vertex_begin_gl)] = true;
-    mme_inline[MAXWELL3D_REG_INDEX(vertex_buffer.count)] = true;
-    mme_inline[MAXWELL3D_REG_INDEX(index_array.count)] = true;
 }
 
 #define DIRTY_REGS_POS(field_name) static_cast<u8>(offsetof(Maxwell3D::DirtyRegs, field_name))
 
-void Maxwell3D::InitDirtySettings() {
-    const auto set_block = [this](std::size_t start, std::size_t range, u8 position) {
-        const auto start_itr = dirty_pointers.begin() + start;
-        const auto end_itr = start_itr + range;
-        std::fill(start_itr, end_itr, position);
+/// Number of registers taken by a field of the register structure
+#define MAXWELL3D_REG_COUNT(field_name)                                                            \
+    static_cast<u32>(sizeof(std::declval<Maxwell3D::Regs&>().field_name) / (sizeof(u32)))
+
+namespace {
+
+using Regs = Maxwell3D::Regs;
+
+/// Work a register write does on top of storing its value and flagging dirty state
+enum class MethodHandler : u8 {
+    None,
+    MacroUpload,
+    MacroBind,
+    FirmwareCall4,
+    StartCBData,
+    CBBind,
+    DrawArrays,
+    ClearBuffers,
+    QueryGet,
+    QueryCondition,
+    CounterReset,
+    SyncPoint,
+    ExecUpload,
+    DataUpload,
+};
+
+struct MethodAction {
+    u8 dirty_reg;         ///< Dirty flag set when the register changes, null_dirty for none
+    u8 dirty_group;       ///< Flag of the group dirty_reg belongs to, null_dirty for none
+    MethodHandler handler;
+    u8 handler_argument;  ///< Const buffer binding index of CBBind
+};
+
+constexpr std::array<MethodAction, Regs::NUM_REGS> MakeMethodActions() {
+    std::array<MethodAction, Regs::NUM_REGS> actions{};
+    const auto set_dirty = [&actions](std::size_t reg, u8 position) {
+        actions[reg].dirty_reg = position;
+    };
+    const auto set_block = [&actions](std::size_t start, std::size_t range, u8 position) {
+        for (std::size_t reg = start; reg < start + range; ++reg) {
+            actions[reg].dirty_reg = position;
+        }
     };
-    dirty.regs.fill(true);
 
     // Init Render Targets
-    constexpr u32 registers_per_rt = sizeof(regs.rt[0]) / sizeof(u32);
+    constexpr u32 registers_per_rt = MAXWELL3D_REG_COUNT(rt[0]);
     constexpr u32 rt_start_reg = MAXWELL3D_REG_INDEX(rt);
     constexpr u32 rt_end_reg = rt_start_reg + registers_per_rt * 8;
     u8 rt_dirty_reg = DIRTY_REGS_POS(render_target);
@@ -118,17 +88,15 @@ void Maxwell3D::InitDirtySettings() {
         set_block(rt_reg, registers_per_rt, rt_dirty_reg);
         ++rt_dirty_reg;
     }
-    constexpr u32 depth_buffer_flag = DIRTY_REGS_POS(depth_buffer);
-    dirty_pointers[MAXWELL3D_REG_INDEX(zeta_enable)] = depth_buffer_flag;
-    dirty_pointers[MAXWELL3D_REG_INDEX(zeta_width)] = depth_buffer_flag;
-    dirty_pointers[MAXWELL3D_REG_INDEX(zeta_height)] = depth_buffer_flag;
-    constexpr u32 registers_in_zeta = sizeof(regs.zeta) / sizeof(u32);
-    constexpr u32 zeta_reg = MAXWELL3D_REG_INDEX(zeta);
-    set_block(zeta_reg, registers_in_zeta, depth_buffer_flag);
+    constexpr u8 depth_buffer_flag = DIRTY_REGS_POS(depth_buffer);
+    set_dirty(MAXWELL3D_REG_INDEX(zeta_enable), depth_buffer_flag);
+    set_dirty(MAXWELL3D_REG_INDEX(zeta_width), depth_buffer_flag);
+    set_dirty(MAXWELL3D_REG_INDEX(zeta_height), depth_buffer_flag);
+    set_block(MAXWELL3D_REG_INDEX(zeta), MAXWELL3D_REG_COUNT(zeta), depth_buffer_flag);
 
     // Init Vertex Arrays
     constexpr u32 vertex_array_start = MAXWELL3D_REG_INDEX(vertex_array);
-    constexpr u32 vertex_array_size = sizeof(regs.vertex_array[0]) / sizeof(u32);
+    constexpr u32 vertex_array_size = MAXWELL3D_REG_COUNT(vertex_array[0]);
     constexpr u32 vertex_array_end = vertex_array_start + vertex_array_size * Regs::NumVertexArrays;
     u8 va_dirty_reg = DIRTY_REGS_POS(vertex_array);
     u8 vi_dirty_reg = DIRTY_REGS_POS(vertex_instance);
@@ -136,12 +104,12 @@ void Maxwell3D::InitDirtySettings() {
          vertex_reg += vertex_array_size) {
         set_block(vertex_reg, 3, va_dirty_reg);
         // The divisor concerns vertex array instances
-        dirty_pointers[static_cast<std::size_t>(vertex_reg) + 3] = vi_dirty_reg;
+        set_dirty(static_cast<std::size_t>(vertex_reg) + 3, vi_dirty_reg);
         ++va_dirty_reg;
         ++vi_dirty_reg;
     }
     constexpr u32 vertex_limit_start = MAXWELL3D_REG_INDEX(vertex_array_limit);
-    constexpr u32 vertex_limit_size = sizeof(regs.vertex_array_limit[0]) / sizeof(u32);
+    constexpr u32 vertex_limit_size = MAXWELL3D_REG_COUNT(vertex_array_limit[0]);
     constexpr u32 vertex_limit_end = vertex_limit_start + vertex_limit_size * Regs::NumVertexArrays;
     va_dirty_reg = DIRTY_REGS_POS(vertex_array);
     for (u32 vertex_reg = vertex_limit_start; vertex_reg < vertex_limit_end;
@@ -150,8 +118,7 @@ void Maxwell3D::InitDirtySettings() {
         va_dirty_reg++;
     }
     constexpr u32 vertex_instance_start = MAXWELL3D_REG_INDEX(instanced_arrays);
-    constexpr u32 vertex_instance_size =
-        sizeof(regs.instanced_arrays.is_instanced[0]) / sizeof(u32);
+    constexpr u32 vertex_instance_size = MAXWELL3D_REG_COUNT(instanced_arrays.is_instanced[0]);
     constexpr u32 vertex_instance_end =
         vertex_instance_start + vertex_instance_size * Regs::NumVertexArrays;
     vi_dirty_reg = DIRTY_REGS_POS(vertex_instance);
@@ -160,104 +127,245 @@ void Maxwell3D::InitDirtySettings() {
         set_block(vertex_reg, vertex_instance_size, vi_dirty_reg);
         vi_dirty_reg++;
     }
-    set_block(MAXWELL3D_REG_INDEX(vertex_attrib_format), regs.vertex_attrib_format.size(),
+    set_block(MAXWELL3D_REG_INDEX(vertex_attrib_format), MAXWELL3D_REG_COUNT(vertex_attrib_format),
               DIRTY_REGS_POS(vertex_attrib_format));
 
     // Init Shaders
-    constexpr u32 shader_registers_count =
-        sizeof(regs.shader_config[0]) * Regs::MaxShaderProgram / sizeof(u32);
-    set_block(MAXWELL3D_REG_INDEX(shader_config[0]), shader_registers_count,
+    set_block(MAXWELL3D_REG_INDEX(shader_config[0]), MAXWELL3D_REG_COUNT(shader_config),
               DIRTY_REGS_POS(shaders));
 
     // State
 
     // Viewport
     constexpr u8 viewport_dirty_reg = DIRTY_REGS_POS(viewport);
-    constexpr u32 viewport_start = MAXWELL3D_REG_INDEX(viewports);
-    constexpr u32 viewport_size = sizeof(regs.viewports) / sizeof(u32);
-    set_block(viewport_start, viewport_size, viewport_dirty_reg);
-    constexpr u32 view_volume_start = MAXWELL3D_REG_INDEX(view_volume_clip_control);
-    constexpr u32 view_volume_size = sizeof(regs.view_volume_clip_control) / sizeof(u32);
-    set_block(view_volume_start, view_volume_size, viewport_dirty_reg);
+    set_block(MAXWELL3D_REG_INDEX(viewports), MAXWELL3D_REG_COUNT(viewports), viewport_dirty_reg);
+    set_block(MAXWELL3D_REG_INDEX(view_volume_clip_control),
+              MAXWELL3D_REG_COUNT(view_volume_clip_control), viewport_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(depth_mode), viewport_dirty_reg);
 
     // Viewport transformation
-    constexpr u32 viewport_trans_start = MAXWELL3D_REG_INDEX(viewport_transform);
-    constexpr u32 viewport_trans_size = sizeof(regs.viewport_transform) / sizeof(u32);
-    set_block(viewport_trans_start, viewport_trans_size, DIRTY_REGS_POS(viewport_transform));
+    set_block(MAXWELL3D_REG_INDEX(viewport_transform), MAXWELL3D_REG_COUNT(viewport_transform),
+              DIRTY_REGS_POS(viewport_transform));
 
     // Cullmode
-    constexpr u32 cull_mode_start = MAXWELL3D_REG_INDEX(cull);
-    constexpr u32 cull_mode_size = sizeof(regs.cull) / sizeof(u32);
-    set_block(cull_mode_start, cull_mode_size, DIRTY_REGS_POS(cull_mode));
+    set_block(MAXWELL3D_REG_INDEX(cull), MAXWELL3D_REG_COUNT(cull), DIRTY_REGS_POS(cull_mode));
 
     // Screen y control
-    dirty_pointers[MAXWELL3D_REG_INDEX(screen_y_control)] = DIRTY_REGS_POS(screen_y_control);
+    set_dirty(MAXWELL3D_REG_INDEX(screen_y_control), DIRTY_REGS_POS(screen_y_control));
 
     // Primitive Restart
-    constexpr u32 primitive_restart_start = MAXWELL3D_REG_INDEX(primitive_restart);
-    constexpr u32 primitive_restart_size = sizeof(regs.primitive_restart) / sizeof(u32);
-    set_block(primitive_restart_start, primitive_restart_size, DIRTY_REGS_POS(primitive_restart));
+    set_block(MAXWELL3D_REG_INDEX(primitive_restart), MAXWELL3D_REG_COUNT(primitive_restart),
+              DIRTY_REGS_POS(primitive_restart));
 
     // Depth Test
     constexpr u8 depth_test_dirty_reg = DIRTY_REGS_POS(depth_test);
-    dirty_pointers[MAXWELL3D_REG_INDEX(depth_test_enable)] = depth_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(depth_write_enabled)] = depth_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(depth_test_func)] = depth_test_dirty_reg;
+    set_dirty(MAXWELL3D_REG_INDEX(depth_test_enable), depth_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(depth_write_enabled), depth_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(depth_test_func), depth_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(depth_bounds_enable), depth_test_dirty_reg);
 
     // Stencil Test
-    constexpr u32 stencil_test_dirty_reg = DIRTY_REGS_POS(stencil_test);
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_enable)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_func_func)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_func_ref)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_func_mask)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_op_fail)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_op_zfail)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_op_zpass)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_front_mask)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_two_side_enable)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_func_func)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_func_ref)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_func_mask)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_op_fail)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_op_zfail)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_op_zpass)] = stencil_test_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(stencil_back_mask)] = stencil_test_dirty_reg;
+    constexpr u8 stencil_test_dirty_reg = DIRTY_REGS_POS(stencil_test);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_enable), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_func_func), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_func_ref), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_func_mask), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_op_fail), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_op_zfail), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_op_zpass), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_front_mask), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_two_side_enable), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_func_func), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_func_ref), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_func_mask), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_op_fail), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_op_zfail), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_op_zpass), stencil_test_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(stencil_back_mask), stencil_test_dirty_reg);
 
     // Color Mask
     constexpr u8 color_mask_dirty_reg = DIRTY_REGS_POS(color_mask);
-    dirty_pointers[MAXWELL3D_REG_INDEX(color_mask_common)] = color_mask_dirty_reg;
-    set_block(MAXWELL3D_REG_INDEX(color_mask), sizeof(regs.color_mask) / sizeof(u32),
+    set_dirty(MAXWELL3D_REG_INDEX(color_mask_common), color_mask_dirty_reg);
+    set_block(MAXWELL3D_REG_INDEX(color_mask), MAXWELL3D_REG_COUNT(color_mask),
               color_mask_dirty_reg);
     // Blend State
     constexpr u8 blend_state_dirty_reg = DIRTY_REGS_POS(blend_state);
-    set_block(MAXWELL3D_REG_INDEX(blend_color), sizeof(regs.blend_color) / sizeof(u32),
+    set_block(MAXWELL3D_REG_INDEX(blend_color), MAXWELL3D_REG_COUNT(blend_color),
               blend_state_dirty_reg);
-    dirty_pointers[MAXWELL3D_REG_INDEX(independent_blend_enable)] = blend_state_dirty_reg;
-    set_block(MAXWELL3D_REG_INDEX(blend), sizeof(regs.blend) / sizeof(u32), blend_state_dirty_reg);
-    set_block(MAXWELL3D_REG_INDEX(independent_blend), sizeof(regs.independent_blend) / sizeof(u32),
+    set_dirty(MAXWELL3D_REG_INDEX(independent_blend_enable), blend_state_dirty_reg);
+    set_block(MAXWELL3D_REG_INDEX(blend), MAXWELL3D_REG_COUNT(blend), blend_state_dirty_reg);
+    set_block(MAXWELL3D_REG_INDEX(independent_blend), MAXWELL3D_REG_COUNT(independent_blend),
               blend_state_dirty_reg);
 
     // Scissor State
-    constexpr u8 scissor_test_dirty_reg = DIRTY_REGS_POS(scissor_test);
-    set_block(MAXWELL3D_REG_INDEX(scissor_test), sizeof(regs.scissor_test) / sizeof(u32),
-              scissor_test_dirty_reg);
+    set_block(MAXWELL3D_REG_INDEX(scissor_test), MAXWELL3D_REG_COUNT(scissor_test),
+              DIRTY_REGS_POS(scissor_test));
 
     // Polygon Offset
     constexpr u8 polygon_offset_dirty_reg = DIRTY_REGS_POS(polygon_offset);
-    dirty_pointers[MAXWELL3D_REG_INDEX(polygon_offset_fill_enable)] = polygon_offset_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(polygon_offset_line_enable)] = polygon_offset_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(polygon_offset_point_enable)] = polygon_offset_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(polygon_offset_units)] = polygon_offset_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(polygon_offset_factor)] = polygon_offset_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(polygon_offset_clamp)] = polygon_offset_dirty_reg;
+    set_dirty(MAXWELL3D_REG_INDEX(polygon_offset_fill_enable), polygon_offset_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(polygon_offset_line_enable), polygon_offset_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(polygon_offset_point_enable), polygon_offset_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(polygon_offset_units), polygon_offset_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(polygon_offset_factor), polygon_offset_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(polygon_offset_clamp), polygon_offset_dirty_reg);
 
     // Depth bounds
     constexpr u8 depth_bounds_values_dirty_reg = DIRTY_REGS_POS(depth_bounds_values);
-    dirty_pointers[MAXWELL3D_REG_INDEX(depth_bounds[0])] = depth_bounds_values_dirty_reg;
-    dirty_pointers[MAXWELL3D_REG_INDEX(depth_bounds[1])] = depth_bounds_values_dirty_reg;
+    set_dirty(MAXWELL3D_REG_INDEX(depth_bounds[0]), depth_bounds_values_dirty_reg);
+    set_dirty(MAXWELL3D_REG_INDEX(depth_bounds[1]), depth_bounds_values_dirty_reg);
+
+    // Groups of flags that are also flagged as a whole
+    for (MethodAction& action : actions) {
+        const u8 dirty_reg = action.dirty_reg;
+        if (dirty_reg >= DIRTY_REGS_POS(vertex_array) &&
+            dirty_reg < DIRTY_REGS_POS(vertex_array_buffers)) {
+            action.dirty_group = DIRTY_REGS_POS(vertex_array_buffers);
+        } else if (dirty_reg >= DIRTY_REGS_POS(vertex_instance) &&
+                   dirty_reg < DIRTY_REGS_POS(vertex_instances)) {
+            action.dirty_group = DIRTY_REGS_POS(vertex_instances);
+        } else if (dirty_reg >= DIRTY_REGS_POS(render_target) &&
+                   dirty_reg < DIRTY_REGS_POS(render_settings)) {
+            action.dirty_group = DIRTY_REGS_POS(render_settings);
+        }
+    }
+
+    // Handlers
+    const auto set_handler = [&actions](std::size_t reg, MethodHandler handler, u8 argument = 0) {
+        actions[reg].handler = handler;
+        actions[reg].handler_argument = argument;
+    };
+    set_handler(MAXWELL3D_REG_INDEX(macros.data), MethodHandler::MacroUpload);
+    set_handler(MAXWELL3D_REG_INDEX(macros.bind), MethodHandler::MacroBind);
+    set_handler(MAXWELL3D_REG_INDEX(firmware[4]), MethodHandler::FirmwareCall4);
+    for (std::size_t i = 0; i < Regs::NumCBData; ++i) {
+        set_handler(MAXWELL3D_REG_INDEX(const_buffer.cb_data) + i, MethodHandler::StartCBData);
+    }
+    for (u8 stage = 0; stage < Regs::MaxShaderStage; ++stage) {
+        const std::size_t reg =
+            MAXWELL3D_REG_INDEX(cb_bind) + stage * MAXWELL3D_REG_COUNT(cb_bind[0]);
+        set_handler(reg, MethodHandler::CBBind, stage);
+    }
+    set_handler(MAXWELL3D_REG_INDEX(draw.vertex_end_gl), MethodHandler::DrawArrays);
+    set_handler(MAXWELL3D_REG_INDEX(clear_buffers), MethodHandler::ClearBuffers);
+    set_handler(MAXWELL3D_REG_INDEX(query.query_get), MethodHandler::QueryGet);
+    set_handler(MAXWELL3D_REG_INDEX(condition.mode), MethodHandler::QueryCondition);
+    set_handler(MAXWELL3D_REG_INDEX(counter_reset), MethodHandler::CounterReset);
+    set_handler(MAXWELL3D_REG_INDEX(sync_info), MethodHandler::SyncPoint);
+    set_handler(MAXWELL3D_REG_INDEX(exec_upload), MethodHandler::ExecUpload);
+    set_handler(MAXWELL3D_REG_INDEX(data_upload), MethodHandler::DataUpload);
+    return actions;
+}
+
+/// What a write does for every register, resolved at compile time so writes are a single lookup
+constexpr std::array<MethodAction, Regs::NUM_REGS> METHOD_ACTIONS = MakeMethodActions();
+
+} // Anonymous namespace
+
+Maxwell3D::Maxwell3D(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
+                     MemoryManager& memory_manager)
+    : system{system}, rasterizer{rasterizer}, memory_manager{memory_manager},
+      macro_interpreter{*this}, upload_state{memory_manager, regs.upload} {
+    dirty.regs.fill(true);
+    InitializeRegisterDefaults();
+}
+
+void Maxwell3D::InitializeRegisterDefaults() {
+    // Initializes registers to their default values - what games expect them to be at boot. This is
+    // for certain registers that may not be explicitly set by games.
+
+    // Reset all registers to zero
+    std::memset(&regs, 0, sizeof(regs));
+
+    // Depth range near/far is not always set, but is expected to be the default 0.0f, 1.0f. This is
+    // needed for ARMS.
+    for (auto& viewport : regs.viewports) {
+        viewport.depth_range_near = 0.0f;
+        viewport.depth_range_far = 1.0f;
+    }
+
+    // Doom and Bomberman seems to use the uninitialized registers and just enable blend
+    // so initialize blend registers with sane values
+    regs.blend.equation_rgb = Regs::Blend::Equation::Add;
+    regs.blend.factor_source_rgb = Regs::Blend::Factor::One;
+    regs.blend.factor_dest_rgb = Regs::Blend::Factor::Zero;
+    regs.blend.equation_a = Regs::Blend::Equation::Add;
+    regs.blend.factor_source_a = Regs::Blend::Factor::One;
+    regs.blend.factor_dest_a = Regs::Blend::Factor::Zero;
+    for (auto& blend : regs.independent_blend) {
+        blend.equation_rgb = Regs::Blend::Equation::Add;
+        blend.factor_source_rgb = Regs::Blend::Factor::One;
+        blend.factor_dest_rgb = Regs::Blend::Factor::Zero;
+        blend.equation_a = Regs::Blend::Equation::Add;
+        blend.factor_source_a = Regs::Blend::Factor::One;
+        blend.factor_dest_a = Regs::Blend::Factor::Zero;
+    }
+    regs.stencil_front_op_fail = Regs::StencilOp::Keep;
+    regs.stencil_front_op_zfail = Regs::StencilOp::Keep;
+    regs.stencil_front_op_zpass = Regs::StencilOp::Keep;
+    regs.stencil_front_func_func = Regs::ComparisonOp::Always;
+    regs.stencil_front_func_mask = 0xFFFFFFFF;
+    regs.stencil_front_mask = 0xFFFFFFFF;
+    regs.stencil_two_side_enable = 1;
+    regs.stencil_back_op_fail = Regs::StencilOp::Keep;
+    regs.stencil_back_op_zfail = Regs::StencilOp::Keep;
+    regs.stencil_back_op_zpass = Regs::StencilOp::Keep;
+    regs.stencil_back_func_func = Regs::ComparisonOp::Always;
+    regs.stencil_back_func_mask = 0xFFFFFFFF;
+    regs.stencil_back_mask = 0xFFFFFFFF;
+
+    regs.depth_test_func = Regs::ComparisonOp::Always;
+    regs.cull.front_face = Regs::Cull::FrontFace::CounterClockWise;
+    regs.cull.cull_face = Regs::Cull::CullFace::Back;
+
+    // TODO(Rodrigo): Most games do not set a point size. I think this is a case of a
+    // register carrying a default value. Assume it's OpenGL's default (1).
+    regs.point_size = 1.0f;
+
+    // TODO(bunnei): Some games do not initialize the color masks (e.g. Sonic Mania). Assuming a
+    // default of enabled fixes rendering here.
+    for (auto& color_mask : regs.color_mask) {
+        color_mask.R.Assign(1);
+        color_mask.G.Assign(1);
+        color_mask.B.Assign(1);
+        color_mask.A.Assign(1);
+    }
+
+    // NVN games expect these values to be enabled at boot
+    regs.rasterize_enable = 1;
+    regs.rt_separate_frag_data = 1;
+    regs.framebuffer_srgb = 1;
+    regs.cull.front_face = Maxwell3D::Regs::Cull::FrontFace::ClockWise;
+
+    mme_inline[MAXWELL3D_REG_INDEX(draw.vertex_end_gl)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(draw.vertex_begin_gl)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(vertex_buffer.count)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(index_array.count)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(vertex_buffer.first)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(index_array.first)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(vb_element_base)] = true;
+    mme_inline[MAXWELL3D_REG_INDEX(vb_base_instance)] = true;
+}
+
+void Maxwell3D::RestoreState(const Regs& new_regs, const State& new_state,
+                             const MacroMemory& new_macro_memory,
+                             const MacroPositions& new_macro_positions) {
+    regs = new_regs;
+    state = new_state;
+    macro_memory = new_macro_memory;
+    macro_positions = new_macro_positions;
+
+    executing_macro = 0;
+    macro_params.clear();
+    mme_draw = {};
+    cb_data_state.current = null_cb_data;
+
+    dirty.regs.fill(true);
 }
 
 void Maxwell3D::CallMacroMethod(u32 method, std::size_t num_parameters, const u32* parameters) {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::Macro};
+
     // Reset the current macro.
     executing_macro = 0;
 
@@ -313,113 +421,113 @@ void Maxwell3D::CallMethod(const GPU::MethodCall& method_call) {
     ASSERT_MSG(method < Regs::NUM_REGS,
                "Invalid Maxwell3D register, increase the size of the Regs structure");
 
+    const MethodAction& action = METHOD_ACTIONS[method];
     if (regs.reg_array[method] != method_call.argument) {
         regs.reg_array[method] = method_call.argument;
-        const std::size_t dirty_reg = dirty_pointers[method];
-        if (dirty_reg) {
-            dirty.regs[dirty_reg] = true;
-            if (dirty_reg >= DIRTY_REGS_POS(vertex_array) &&
-                dirty_reg < DIRTY_REGS_POS(vertex_array_buffers)) {
-                dirty.vertex_array_buffers = true;
-            } else if (dirty_reg >= DIRTY_REGS_POS(vertex_instance) &&
-                       dirty_reg < DIRTY_REGS_POS(vertex_instances)) {
-                dirty.vertex_instances = true;
-            } else if (dirty_reg >= DIRTY_REGS_POS(render_target) &&
-                       dirty_reg < DIRTY_REGS_POS(render_settings)) {
-                dirty.render_settings = true;
-            }
-        }
+        // Registers without dirty state flag null_dirty, which is never read
+        dirty.regs[action.dirty_reg] = true;
+        dirty.regs[action.dirty_group] = true;
     }
 
-    switch (method) {
-    case MAXWELL3D_REG_INDEX(macros.data): {
+    switch (action.handler) {
+    case MethodHandler::None:
+        break;
+    case MethodHandler::MacroUpload:
         ProcessMacroUpload(method_call.argument);
         break;
-    }
-    case MAXWELL3D_REG_INDEX(macros.bind): {
+    case MethodHandler::MacroBind:
         ProcessMacroBind(method_call.argument);
         break;
-    }
-    case MAXWELL3D_REG_INDEX(firmware[4]): {
+    case MethodHandler::FirmwareCall4:
         ProcessFirmwareCall4();
         break;
-    }
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[0]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[1]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[2]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[3]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[4]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[5]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[6]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[7]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[8]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[9]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[10]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[11]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[12]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[13]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[14]):
-    case MAXWELL3D_REG_INDEX(const_buffer.cb_data[15]): {
+    case MethodHandler::StartCBData:
         StartCBData(method);
         break;
-    }
-    case MAXWELL3D_REG_INDEX(cb_bind[0]): {
-        ProcessCBBind(0);
-        break;
-    }
-    case MAXWELL3D_REG_INDEX(cb_bind[1]): {
-        ProcessCBBind(1);
-        break;
-    }
-    case MAXWELL3D_REG_INDEX(cb_bind[2]): {
-        ProcessCBBind(2);
-        break;
-    }
-    case MAXWELL3D_REG_INDEX(cb_bind[3]): {
-        ProcessCBBind(3);
+    case MethodHandler::CBBind:
+        ProcessCBBind(action.handler_argument);
         break;
-    }
-    case MAXWELL3D_REG_INDEX(cb_bind[4]): {
-        ProcessCBBind(4);
-        break;
-    }
-    case MAXWELL3D_REG_INDEX(draw.vertex_end_gl): {
+    case MethodHandler::DrawArrays:
         DrawArrays();
         break;
-    }
-    case MAXWELL3D_REG_INDEX(clear_buffers): {
+    case MethodHandler::ClearBuffers:
         ProcessClearBuffers();
         break;
-    }
-    case MAXWELL3D_REG_INDEX(query.query_get): {
+    case MethodHandler::QueryGet:
         ProcessQueryGet();
         break;
-    }
-    case MAXWELL3D_REG_INDEX(condition.mode): {
+    case MethodHandler::QueryCondition:
         ProcessQueryCondition();
         break;
-    }
-    case MAXWELL3D_REG_INDEX(sync_info): {
+    case MethodHandler::CounterReset:
+        ProcessCounterReset();
+        break;
+    case MethodHandler::SyncPoint:
         ProcessSyncPoint();
         break;
-    }
-    case MAXWELL3D_REG_INDEX(exec_upload): {
+    case MethodHandler::ExecUpload:
         upload_state.ProcessExec(regs.exec_upload.linear != 0);
         break;
-    }
-    case MAXWELL3D_REG_INDEX(data_upload): {
+    case MethodHandler::DataUpload: {
         const bool is_last_call = method_call.IsLastCall();
         upload_state.ProcessData(method_call.argument, is_last_call);
         if (is_last_call) {
-            dirty.OnMemoryWrite();
+            OnMemoryWrite();
         }
         break;
     }
-    default:
-        break;
     }
 }
 
+void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
+                                u32 methods_pending) {
+    // The first call takes the regular path, which does all the bookkeeping. The rest of a
+    // constant buffer update, inline upload or macro parameter stream is then processed as a
+    // whole, unless the last call of the command comes before the end of the run.
+    CallMethod({method, base_start[0], 0, methods_pending});
+    if (amount == 1) {
+        return;
+    }
+
+    const u32* const data = base_start + 1;
+    const u32 count = amount - 1;
+    const bool is_last_call = methods_pending == amount;
+    if (methods_pending >= amount) {
+        if (method == cb_data_state.current) {
+            regs.reg_array[method] = data[count - 1];
+            ProcessCBMultiData(data, count);
+            return;
+        }
+        if (method >= MacroRegistersStart && method == executing_macro + 1) {
+            macro_params.insert(macro_params.end(), data, data + count);
+            if (is_last_call) {
+                CallMacroMethod(executing_macro, macro_params.size(), macro_params.data());
+                macro_params.clear();
+            }
+            return;
+        }
+        if (method == MAXWELL3D_REG_INDEX(data_upload)) {
+            regs.reg_array[method] = data[count - 1];
+            upload_state.ProcessData(data, count, is_last_call);
+            if (is_last_call) {
+                OnMemoryWrite();
+            }
+            return;
+        }
+    }
+
+    for (u32 i = 1; i < amount; ++i) {
+        CallMethod({method, base_start[i], 0, methods_pending - i});
+    }
+}
+
+Maxwell3D::MMEDrawCommand Maxwell3D::MakeMMEDrawCommand(MMEDrawMode mode, u32 count) const {
+    if (mode == MMEDrawMode::Indexed) {
+        return {regs.index_array.first, count, regs.vb_element_base, regs.vb_base_instance};
+    }
+    return {regs.vertex_buffer.first, count, 0, regs.vb_base_instance};
+}
+
 void Maxwell3D::StepInstance(const MMEDrawMode expected_mode, const u32 count) {
     if (mme_draw.current_mode == MMEDrawMode::Undefined) {
         if (mme_draw.gl_begin_consume) {
@@ -428,17 +536,29 @@ void Maxwell3D::StepInstance(const MMEDrawMode expected_mode, const u32 count) {
             mme_draw.instance_count = 1;
             mme_draw.gl_begin_consume = false;
             mme_draw.gl_end_count = 0;
+            mme_draw.draws.push_back(MakeMMEDrawCommand(expected_mode, count));
         }
         return;
     } else {
-        if (mme_draw.current_mode == expected_mode && count == mme_draw.current_count &&
-            mme_draw.instance_mode && mme_draw.gl_begin_consume) {
-            mme_draw.instance_count++;
-            mme_draw.gl_begin_consume = false;
-            return;
-        } else {
-            FlushMMEInlineDraw();
+        if (mme_draw.current_mode == expected_mode && mme_draw.gl_begin_consume) {
+            const MMEDrawCommand command = MakeMMEDrawCommand(expected_mode, count);
+            if (mme_draw.instance_mode) {
+                // Next instance of the previous draw
+                if (mme_draw.draws.size() == 1 && command == mme_draw.draws.back()) {
+                    mme_draw.instance_count++;
+                    mme_draw.gl_begin_consume = false;
+                    return;
+                }
+            } else if (mme_draw.instance_count == 1 && !IsEmulatedTopology(regs.draw.topology)) {
+                // Another draw sharing the same state, quads, quad strips and line loops are
+                // excluded because some backends emulate them generating a new index buffer per
+                // draw
+                mme_draw.draws.push_back(command);
+                mme_draw.gl_begin_consume = false;
+                return;
+            }
         }
+        FlushMMEInlineDraw();
     }
     // Tail call in case it needs to retry.
     StepInstance(expected_mode, count);
@@ -447,6 +567,15 @@ void Maxwell3D::StepInstance(const MMEDrawMode expected_mode, const u32 count) {
 void Maxwell3D::CallMethodFromMME(const GPU::MethodCall& method_call) {
     const u32 method = method_call.method;
     if (mme_inline[method]) {
+        if (method == MAXWELL3D_REG_INDEX(draw.vertex_begin_gl) &&
+            mme_draw.current_mode != MMEDrawMode::Undefined) {
+            // Draws of a batch have to share their topology
+            const auto topology =
+                static_cast<Regs::PrimitiveTopology>(method_call.argument & 0xFFFF);
+            if (topology != regs.draw.topology) {
+                FlushMMEInlineDraw();
+            }
+        }
         regs.reg_array[method] = method_call.argument;
         if (method == MAXWELL3D_REG_INDEX(vertex_buffer.count) ||
             method == MAXWELL3D_REG_INDEX(index_array.count)) {
@@ -458,7 +587,7 @@ void Maxwell3D::CallMethodFromMME(const GPU::MethodCall& method_call) {
             mme_draw.instance_mode =
                 (regs.draw.instance_next != 0) || (regs.draw.instance_cont != 0);
             mme_draw.gl_begin_consume = true;
-        } else {
+        } else if (method == MAXWELL3D_REG_INDEX(draw.vertex_end_gl)) {
             mme_draw.gl_end_count++;
         }
     } else {
@@ -473,7 +602,7 @@ void Maxwell3D::FlushMMEInlineDraw() {
     LOG_TRACE(HW_GPU, "called, topology={}, count={}", static_cast<u32>(regs.draw.topology.Value()),
               regs.vertex_buffer.count);
     ASSERT_MSG(!(regs.index_array.count && regs.vertex_buffer.count), "Both indexed and direct?");
-    ASSERT(mme_draw.instance_count == mme_draw.gl_end_count);
+    ASSERT(mme_draw.instance_count * mme_draw.draws.size() == mme_draw.gl_end_count);
 
     // Both instance configuration registers can not be set at the same time.
     ASSERT_MSG(!regs.draw.instance_next || !regs.draw.instance_cont,
@@ -481,7 +610,37 @@ void Maxwell3D::FlushMMEInlineDraw() {
 
     const bool is_indexed = mme_draw.current_mode == MMEDrawMode::Indexed;
     if (ShouldExecute()) {
+        // The registers describe the last draw of the batch, make them describe the first one and
+        // cover the indices of every draw so backends upload them at once.
+        const MMEDrawCommand last_draw = MakeMMEDrawCommand(mme_draw.current_mode, 0);
+        const MMEDrawCommand& first_draw = mme_draw.draws.front();
+        if (is_indexed) {
+            u32 begin = first_draw.first;
+            u32 end = first_draw.first + first_draw.count;
+            for (const MMEDrawCommand& draw : mme_draw.draws) {
+                begin = std::min(begin, draw.first);
+                end = std::max(end, draw.first + draw.count);
+            }
+            regs.index_array.first = begin;
+            regs.index_array.count = end - begin;
+            regs.vb_element_base = first_draw.base_vertex;
+        } else {
+            regs.vertex_buffer.first = first_draw.first;
+            regs.vertex_buffer.count = first_draw.count;
+        }
+        regs.vb_base_instance = first_draw.base_instance;
+
+        current_draw = ++num_draws;
         rasterizer.DrawMultiBatch(is_indexed);
+        current_draw = 0;
+
+        if (is_indexed) {
+            regs.index_array.first = last_draw.first;
+            regs.vb_element_base = last_draw.base_vertex;
+        } else {
+            regs.vertex_buffer.first = last_draw.first;
+        }
+        regs.vb_base_instance = last_draw.base_instance;
     }
 
     // TODO(bunnei): Below, we reset vertex count so that we can use these registers to determine if
@@ -499,12 +658,14 @@ void Maxwell3D::FlushMMEInlineDraw() {
     mme_draw.instance_mode = false;
     mme_draw.gl_begin_consume = false;
     mme_draw.gl_end_count = 0;
+    mme_draw.draws.clear();
 }
 
 void Maxwell3D::ProcessMacroUpload(u32 data) {
     ASSERT_MSG(regs.macros.upload_address < macro_memory.size(),
                "upload_address exceeded macro_memory size!");
     macro_memory[regs.macros.upload_address++] = data;
+    macro_interpreter.InvalidateEntries();
 }
 
 void Maxwell3D::ProcessMacroBind(u32 data) {
@@ -525,9 +686,14 @@ void Maxwell3D::ProcessQueryGet() {
     // VAddr before writing.
 
     // TODO(Subv): Support the other query units.
-    ASSERT_MSG(regs.query.query_get.unit == Regs::QueryUnit::Crop,
+    ASSERT_MSG(regs.query.query_get.unit == Regs::QueryUnit::Crop ||
+                   regs.query.query_get.select == Regs::QuerySelect::SamplesPassed,
                "Units other than CROP are unimplemented");
 
+    const bool is_long_write = !regs.query.query_get.short_query &&
+                               (regs.query.query_get.mode == Regs::QueryMode::Write ||
+                                regs.query.query_get.mode == Regs::QueryMode::Write2);
+
     u64 result = 0;
 
     // TODO(Subv): Support the other query variables
@@ -536,6 +702,14 @@ void Maxwell3D::ProcessQueryGet() {
         // This seems to actually write the query sequence to the query address.
         result = regs.query.query_sequence;
         break;
+    case Regs::QuerySelect::SamplesPassed:
+        // The report is written by the rasterizer when the guest reads it
+        if (is_long_write && rasterizer.Query(sequence_address, VideoCore::QueryType::SamplesPassed,
+                                              system.CoreTiming().GetTicks())) {
+            return;
+        }
+        result = 1;
+        break;
     default:
         result = 1;
         UNIMPLEMENTED_MSG("Unimplemented query select type {}",
@@ -579,6 +753,7 @@ void Maxwell3D::ProcessQueryGet() {
 
 void Maxwell3D::ProcessQueryCondition() {
     const GPUVAddr condition_address{regs.condition.Address()};
+    rasterizer.EndConditionalRendering();
     switch (regs.condition.mode) {
     case Regs::ConditionMode::Always: {
         execute_on = true;
@@ -589,21 +764,26 @@ void Maxwell3D::ProcessQueryCondition() {
         break;
     }
     case Regs::ConditionMode::ResNonZero: {
+        if (rasterizer.BeginConditionalRendering(condition_address)) {
+            // The host GPU discards the draws when the report is zero
+            execute_on = true;
+            break;
+        }
         Regs::QueryCompare cmp;
-        memory_manager.ReadBlockUnsafe(condition_address, &cmp, sizeof(cmp));
+        memory_manager.ReadBlock(condition_address, &cmp, sizeof(cmp));
         execute_on = cmp.initial_sequence != 0U && cmp.initial_mode != 0U;
         break;
     }
     case Regs::ConditionMode::Equal: {
         Regs::QueryCompare cmp;
-        memory_manager.ReadBlockUnsafe(condition_address, &cmp, sizeof(cmp));
+        memory_manager.ReadBlock(condition_address, &cmp, sizeof(cmp));
         execute_on =
             cmp.initial_sequence == cmp.current_sequence && cmp.initial_mode == cmp.current_mode;
         break;
     }
     case Regs::ConditionMode::NotEqual: {
         Regs::QueryCompare cmp;
-        memory_manager.ReadBlockUnsafe(condition_address, &cmp, sizeof(cmp));
+        memory_manager.ReadBlock(condition_address, &cmp, sizeof(cmp));
         execute_on =
             cmp.initial_sequence != cmp.current_sequence || cmp.initial_mode != cmp.current_mode;
         break;
@@ -616,12 +796,23 @@ void Maxwell3D::ProcessQueryCondition() {
     }
 }
 
+void Maxwell3D::ProcessCounterReset() {
+    switch (regs.counter_reset) {
+    case Regs::CounterReset::SampleCnt:
+        rasterizer.ResetCounter(VideoCore::QueryType::SamplesPassed);
+        break;
+    default:
+        LOG_DEBUG(HW_GPU, "Unimplemented counter reset={}", static_cast<u32>(regs.counter_reset));
+        break;
+    }
+}
+
 void Maxwell3D::ProcessSyncPoint() {
     const u32 sync_point = regs.sync_info.sync_point.Value();
     const u32 increment = regs.sync_info.increment.Value();
     [[maybe_unused]] const u32 cache_flush = regs.sync_info.unknown.Value();
     if (increment) {
-        system.GPU().IncrementSyncPoint(sync_point);
+        rasterizer.SignalSyncPoint(sync_point);
     }
 }
 
@@ -644,7 +835,9 @@ void Maxwell3D::DrawArrays() {
 
     const bool is_indexed{regs.index_array.count && !regs.vertex_buffer.count};
     if (ShouldExecute()) {
+        current_draw = ++num_draws;
         rasterizer.DrawBatch(is_indexed);
+        current_draw = 0;
     }
 
     // TODO(bunnei): Below, we reset vertex count so that we can use these registers to determine if
@@ -666,9 +859,17 @@ void Maxwell3D::ProcessCBBind(std::size_t stage_index) {
     ASSERT(bind_data.index < Regs::MaxConstBuffers);
     auto& buffer = shader.const_buffers[bind_data.index];
 
-    buffer.enabled = bind_data.valid.Value() != 0;
-    buffer.address = regs.const_buffer.BufferAddress();
-    buffer.size = regs.const_buffer.cb_size;
+    const bool enabled = bind_data.valid.Value() != 0;
+    const GPUVAddr address = regs.const_buffer.BufferAddress();
+    const u32 size = regs.const_buffer.cb_size;
+    if (buffer.enabled == enabled && buffer.address == address && buffer.size == size) {
+        // Writes to the bound range have been bumping its generation
+        return;
+    }
+    buffer.enabled = enabled;
+    buffer.address = address;
+    buffer.size = size;
+    buffer.generation = ++state.const_buffer_generation;
 }
 
 void Maxwell3D::ProcessCBData(u32 value) {
@@ -679,6 +880,16 @@ void Maxwell3D::ProcessCBData(u32 value) {
     cb_data_state.counter++;
 }
 
+void Maxwell3D::ProcessCBMultiData(const u32* start_base, u32 amount) {
+    const u32 id = cb_data_state.id;
+    ASSERT(cb_data_state.counter + amount <= cb_data_state.buffer[id].size());
+    std::memcpy(cb_data_state.buffer[id].data() + cb_data_state.counter, start_base,
+                amount * sizeof(u32));
+    // Increment the current buffer position.
+    regs.const_buffer.cb_pos = regs.const_buffer.cb_pos + 4 * amount;
+    cb_data_state.counter += amount;
+}
+
 void Maxwell3D::StartCBData(u32 method) {
     constexpr u32 first_cb_data = MAXWELL3D_REG_INDEX(const_buffer.cb_data[0]);
     cb_data_state.start_pos = regs.const_buffer.cb_pos;
@@ -703,10 +914,30 @@ void Maxwell3D::FinishCBData() {
     memory_manager.WriteBlock(address, cb_data_state.buffer[id].data(), size);
     dirty.OnMemoryWrite();
 
+    // Only the const buffers bound over the written range have changed
+    const GPUVAddr address_end = address + size;
+    for (auto& stage : state.shader_stages) {
+        for (auto& buffer : stage.const_buffers) {
+            if (buffer.address < address_end && address < buffer.address + buffer.size) {
+                buffer.generation = ++state.const_buffer_generation;
+            }
+        }
+    }
+
     cb_data_state.id = null_cb_data;
     cb_data_state.current = null_cb_data;
 }
 
+void Maxwell3D::OnMemoryWrite() {
+    dirty.OnMemoryWrite();
+    const u64 generation = ++state.const_buffer_generation;
+    for (auto& stage : state.shader_stages) {
+        for (auto& buffer : stage.const_buffers) {
+            buffer.generation = generation;
+        }
+    }
+}
+
 Texture::TICEntry Maxwell3D::GetTICEntry(u32 tic_index) const {
     const GPUVAddr tic_address_gpu{regs.tic.TICAddress() + tic_index * sizeof(Texture::TICEntry)};
 
@@ -744,6 +975,34 @@ Texture::FullTextureInfo Maxwell3D::GetStageTexture(ShaderType stage, std::size_
     return GetTextureInfo(tex_handle);
 }
 
+Texture::FullTextureInfo Maxwell3D::GetBindlessTexture(ShaderType stage, u64 const_buffer,
+                                                      u64 offset) const {
+    const auto Resolve = [&] {
+        const auto& shader = state.shader_stages[static_cast<std::size_t>(stage)];
+        const auto& tex_info_buffer = shader.const_buffers[const_buffer];
+        const GPUVAddr tex_info_address = tex_info_buffer.address + offset;
+        return GetTextureInfo(Texture::TextureHandle{memory_manager.Read<u32>(tex_info_address)});
+    };
+    if (current_draw == 0) {
+        return Resolve();
+    }
+    const auto& profile = rasterizer.AccessGuestDriverProfile();
+    const auto slot = profile.FindBindlessSampler(
+        {static_cast<u32>(stage), static_cast<u32>(const_buffer), static_cast<u32>(offset)});
+    if (!slot) {
+        return Resolve();
+    }
+    if (*slot >= bindless_textures.size()) {
+        bindless_textures.resize(profile.GetBindlessSamplers().size());
+    }
+    BindlessTexture& texture = bindless_textures[*slot];
+    if (texture.draw != current_draw) {
+        texture.draw = current_draw;
+        texture.info = Resolve();
+    }
+    return texture.info;
+}
+
 u32 Maxwell3D::GetRegisterValue(u32 method) const {
     ASSERT_MSG(method < Regs::NUM_REGS, "Invalid Maxwell3D register");
     return regs.reg_array[method];
@@ -773,12 +1032,7 @@ SamplerDescriptor Maxwell3D::AccessBoundSampler(ShaderType stage, u64 offset) co
 SamplerDescriptor Maxwell3D::AccessBindlessSampler(ShaderType stage, u64 const_buffer,
                                                    u64 offset) const {
     ASSERT(stage != ShaderType::Compute);
-    const auto& shader = state.shader_stages[static_cast<std::size_t>(stage)];
-    const auto& tex_info_buffer = shader.const_buffers[const_buffer];
-    const GPUVAddr tex_info_address = tex_info_buffer.address + offset;
-
-    const Texture::TextureHandle tex_handle{memory_manager.Read<u32>(tex_info_address)};
-    const Texture::FullTextureInfo tex_info = GetTextureInfo(tex_handle);
+    const Texture::FullTextureInfo tex_info = GetBindlessTexture(stage, const_buffer, offset);
     SamplerDescriptor result = SamplerDescriptor::FromTicTexture(tex_info.tic.texture_type.Value());
     result.is_shadow.Assign(tex_info.tsc.depth_compare_enabled.Value());
     return result;
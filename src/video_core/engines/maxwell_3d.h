@@ -6,6 +6,7 @@
 
 #include <array>
 #include <bitset>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -65,6 +66,7 @@ public:
         static constexpr std::size_t NumVaryings = 31;
         static constexpr std::size_t NumImages = 8; // TODO(Rodrigo): Investigate this number
         static constexpr std::size_t NumClipDistances = 8;
+        static constexpr std::size_t NumTransformFeedbackBuffers = 4;
         static constexpr std::size_t MaxShaderProgram = 6;
         static constexpr std::size_t MaxShaderStage = 5;
         // Maximum number of const buffers per shader stage.
@@ -121,6 +123,12 @@ public:
             NotEqual = 4,
         };
 
+        enum class CounterReset : u32 {
+            SampleCnt = 0x01,
+            EmittedPrimitives = 0x10,
+            GeneratedPrimitives = 0x1F,
+        };
+
         enum class ShaderProgram : u32 {
             VertexA = 0,
             VertexB = 1,
@@ -605,6 +613,29 @@ public:
             float depth_range_far;
         };
 
+        struct TransformFeedbackBinding {
+            u32 buffer_enable;
+            u32 address_high;
+            u32 address_low;
+            s32 buffer_size;
+            s32 buffer_offset;
+            INSERT_UNION_PADDING_WORDS(3);
+
+            GPUVAddr Address() const {
+                return static_cast<GPUVAddr>((static_cast<GPUVAddr>(address_high) << 32) |
+                                             address_low);
+            }
+        };
+        static_assert(sizeof(TransformFeedbackBinding) == 32);
+
+        struct TransformFeedbackLayout {
+            u32 stream;
+            u32 varying_count;
+            u32 stride;
+            INSERT_UNION_PADDING_WORDS(1);
+        };
+        static_assert(sizeof(TransformFeedbackLayout) == 16);
+
         bool IsShaderConfigEnabled(std::size_t index) const {
             // The VertexB is always enabled.
             if (index == static_cast<std::size_t>(Regs::ShaderProgram::VertexB)) {
@@ -661,7 +692,13 @@ public:
 
                 u32 rasterize_enable;
 
-                INSERT_UNION_PADDING_WORDS(0xF1);
+                std::array<TransformFeedbackBinding, NumTransformFeedbackBuffers> tfb_bindings;
+
+                INSERT_UNION_PADDING_WORDS(0xC0);
+
+                std::array<TransformFeedbackLayout, NumTransformFeedbackBuffers> tfb_layouts;
+
+                INSERT_UNION_PADDING_WORDS(0x1);
 
                 u32 tfb_enabled;
 
@@ -858,11 +895,15 @@ public:
                     BitField<7, 1, u32> c7;
                 } clip_distance_enabled;
 
-                INSERT_UNION_PADDING_WORDS(0x1);
+                u32 samplecnt_enable;
 
                 float point_size;
 
-                INSERT_UNION_PADDING_WORDS(0x7);
+                INSERT_UNION_PADDING_WORDS(0x5);
+
+                CounterReset counter_reset;
+
+                INSERT_UNION_PADDING_WORDS(0x1);
 
                 u32 zeta_enable;
 
@@ -1166,7 +1207,12 @@ public:
 
                 u32 tex_cb_index;
 
-                INSERT_UNION_PADDING_WORDS(0x395);
+                INSERT_UNION_PADDING_WORDS(0x7D);
+
+                /// Attribute offsets, in words, of the varyings written to each feedback buffer
+                std::array<std::array<u8, 128>, NumTransformFeedbackBuffers> tfb_varying_locs;
+
+                INSERT_UNION_PADDING_WORDS(0x298);
 
                 struct {
                     /// Compressed address of a buffer that holds information about bound SSBOs.
@@ -1201,6 +1247,7 @@ public:
 
         std::array<ShaderStageInfo, Regs::MaxShaderStage> shader_stages;
         u32 current_instance = 0; ///< Current instance to be used to simulate instanced rendering.
+        u64 const_buffer_generation = 0; ///< Last generation given to a const buffer
     };
 
     State state{};
@@ -1284,6 +1331,13 @@ public:
     /// Write the value to the register identified by method.
     void CallMethod(const GPU::MethodCall& method_call);
 
+    /// Write multiple values to the register identified by method.
+    void CallMultiMethod(u32 method, const u32* base_start, u32 amount, u32 methods_pending);
+
+    /// Flags the state that may be backed by guest memory after a write that may touch any of it,
+    /// including every bound const buffer.
+    void OnMemoryWrite();
+
     /// Write the value to the register identified by method.
     void CallMethodFromMME(const GPU::MethodCall& method_call);
 
@@ -1295,6 +1349,11 @@ public:
     /// Returns the texture information for a specific texture in a specific shader stage.
     Texture::FullTextureInfo GetStageTexture(ShaderType stage, std::size_t offset) const;
 
+    /// Returns the TSC and TIC entries of the handle stored in a const buffer. Handles read during
+    /// a draw from locations known by the guest driver profile are resolved once per draw.
+    Texture::FullTextureInfo GetBindlessTexture(ShaderType stage, u64 const_buffer,
+                                                u64 offset) const;
+
     u32 AccessConstBuffer32(ShaderType stage, u64 const_buffer, u64 offset) const override;
 
     SamplerDescriptor AccessBoundSampler(ShaderType stage, u64 offset) const override;
@@ -1319,6 +1378,20 @@ public:
         return macro_memory;
     }
 
+    /// Start offsets of each macro in macro memory
+    using MacroPositions = std::array<u32, 0x80>;
+
+    /// Gets the start offsets of the uploaded macros.
+    const MacroPositions& GetMacroPositions() const {
+        return macro_positions;
+    }
+
+    /// Replaces the registers, bound constant buffers and macros of the engine, marking every
+    /// register as dirty. Used to restore a state saved from another session.
+    void RestoreState(const Regs& new_regs, const State& new_state,
+                      const MacroMemory& new_macro_memory,
+                      const MacroPositions& new_macro_positions);
+
     bool ShouldExecute() const {
         return execute_on;
     }
@@ -1329,6 +1402,23 @@ public:
         Indexed,
     };
 
+    /// Parameters of a single draw inside an MME draw batch.
+    struct MMEDrawCommand {
+        u32 first{};         ///< First vertex, or first index of indexed draws
+        u32 count{};         ///< Number of vertices or indices
+        u32 base_vertex{};   ///< Value added to the indices of indexed draws
+        u32 base_instance{}; ///< First instance
+
+        bool operator==(const MMEDrawCommand& rhs) const {
+            return std::tie(first, count, base_vertex, base_instance) ==
+                   std::tie(rhs.first, rhs.count, rhs.base_vertex, rhs.base_instance);
+        }
+
+        bool operator!=(const MMEDrawCommand& rhs) const {
+            return !operator==(rhs);
+        }
+    };
+
     struct MMEDrawState {
         MMEDrawMode current_mode{MMEDrawMode::Undefined};
         u32 current_count{};
@@ -1336,6 +1426,9 @@ public:
         bool instance_mode{};
         bool gl_begin_consume{};
         u32 gl_end_count{};
+        /// Draws of the batch. All of them share the remaining state, a batch is either a single
+        /// draw with instance_count instances or several draws with a single instance each.
+        std::vector<MMEDrawCommand> draws;
     } mme_draw;
 
 private:
@@ -1348,7 +1441,7 @@ private:
     MemoryManager& memory_manager;
 
     /// Start offsets of each macro in macro_memory
-    std::array<u32, 0x80> macro_positions = {};
+    MacroPositions macro_positions = {};
 
     std::array<bool, Regs::NUM_REGS> mme_inline{};
 
@@ -1376,7 +1469,19 @@ private:
 
     bool execute_on{true};
 
-    std::array<u8, Regs::NUM_REGS> dirty_pointers{};
+    struct BindlessTexture {
+        u64 draw{}; ///< Draw the texture was resolved in
+        Texture::FullTextureInfo info;
+    };
+
+    /// Bindless textures resolved by the draws, indexed by their guest driver profile slot
+    mutable std::vector<BindlessTexture> bindless_textures;
+
+    /// Number of draws sent to the rasterizer
+    u64 num_draws = 0;
+
+    /// Draw being executed by the rasterizer, zero outside of draws
+    u64 current_draw = 0;
 
     /// Retrieves information about a specific TIC entry from the TIC buffer.
     Texture::TICEntry GetTICEntry(u32 tic_index) const;
@@ -1384,8 +1489,6 @@ private:
     /// Retrieves information about a specific TSC entry from the TSC buffer.
     Texture::TSCEntry GetTSCEntry(u32 tsc_index) const;
 
-    void InitDirtySettings();
-
     /**
      * Call a macro on this engine.
      * @param method Method to call
@@ -1412,12 +1515,16 @@ private:
     // Handles Conditional Rendering
     void ProcessQueryCondition();
 
+    /// Handles a write to the COUNTER_RESET register.
+    void ProcessCounterReset();
+
     /// Handles writes to syncing register.
     void ProcessSyncPoint();
 
     /// Handles a write to the CB_DATA[i] register.
     void StartCBData(u32 method);
     void ProcessCBData(u32 value);
+    void ProcessCBMultiData(const u32* start_base, u32 amount);
     void FinishCBData();
 
     /// Handles a write to the CB_BIND register.
@@ -1428,6 +1535,9 @@ private:
 
     // Handles a instance drawcall from MME
     void StepInstance(MMEDrawMode expected_mode, u32 count);
+
+    /// Builds the draw command of the draw being recorded in the MME draw batch.
+    MMEDrawCommand MakeMMEDrawCommand(MMEDrawMode mode, u32 count) const;
 };
 
 #define ASSERT_REG_POSITION(field_name, position)                                                  \
@@ -1443,6 +1553,8 @@ ASSERT_REG_POSITION(tess_mode, 0xC8);
 ASSERT_REG_POSITION(tess_level_outer, 0xC9);
 ASSERT_REG_POSITION(tess_level_inner, 0xCD);
 ASSERT_REG_POSITION(rasterize_enable, 0xDF);
+ASSERT_REG_POSITION(tfb_bindings, 0xE0);
+ASSERT_REG_POSITION(tfb_layouts, 0x1C0);
 ASSERT_REG_POSITION(tfb_enabled, 0x1D1);
 ASSERT_REG_POSITION(rt, 0x200);
 ASSERT_REG_POSITION(viewport_transform, 0x280);
@@ -1493,7 +1605,9 @@ ASSERT_REG_POSITION(screen_y_control, 0x4EB);
 ASSERT_REG_POSITION(vb_element_base, 0x50D);
 ASSERT_REG_POSITION(vb_base_instance, 0x50E);
 ASSERT_REG_POSITION(clip_distance_enabled, 0x544);
+ASSERT_REG_POSITION(samplecnt_enable, 0x545);
 ASSERT_REG_POSITION(point_size, 0x546);
+ASSERT_REG_POSITION(counter_reset, 0x54C);
 ASSERT_REG_POSITION(zeta_enable, 0x54E);
 ASSERT_REG_POSITION(multisample_control, 0x54F);
 ASSERT_REG_POSITION(condition, 0x554);
@@ -1532,6 +1646,7 @@ ASSERT_REG_POSITION(firmware, 0x8C0);
 ASSERT_REG_POSITION(const_buffer, 0x8E0);
 ASSERT_REG_POSITION(cb_bind[0], 0x904);
 ASSERT_REG_POSITION(tex_cb_index, 0x982);
+ASSERT_REG_POSITION(tfb_varying_locs, 0xA00);
 ASSERT_REG_POSITION(ssbo_info, 0xD18);
 ASSERT_REG_POSITION(tex_info_buffers.address[0], 0xD2A);
 ASSERT_REG_POSITION(tex_info_buffers.size[0], 0xD2F);
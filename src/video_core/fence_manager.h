@@ -0,0 +1,143 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <queue>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/settings.h"
+#include "video_core/gpu.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace VideoCommon {
+
+/// Returns true when flushes of GPU modified memory are deferred to syncpoints.
+inline bool IsAsyncFlushEnabled() {
+    return Settings::values.use_asynchronous_gpu_emulation &&
+           Settings::values.use_accurate_gpu_emulation;
+}
+
+class FenceBase {
+public:
+    explicit FenceBase(u32 syncpoint_id, bool is_stubbed)
+        : syncpoint_id{syncpoint_id}, is_stubbed{is_stubbed} {}
+
+    /// Returns the syncpoint incremented when the fence is released.
+    u32 GetSyncPoint() const {
+        return syncpoint_id;
+    }
+
+protected:
+    u32 syncpoint_id;
+
+    /// The fence doesn't protect any flush, a host fence doesn't have to be created.
+    bool is_stubbed;
+};
+
+/**
+ * Defers syncpoint increments until the downloads they guard are done.
+ *
+ * When the guest signals a syncpoint, the regions modified since the previous syncpoint are
+ * committed as a batch of flushes and a host fence is queued after them. Once the host GPU
+ * signals the fence the batch is downloaded, which no longer stalls on rendering, and only then
+ * the syncpoint is incremented. Guests waiting for the syncpoint through nvhost_ctrl observe the
+ * flushed data, and CPU reads don't have to wait for the GPU.
+ */
+template <typename TFence, typename TTextureCache, typename TBufferCache>
+class FenceManager {
+public:
+    /// Signals a syncpoint, it will be incremented once the pending flushes are done.
+    void SignalSyncPoint(u32 syncpoint_id) {
+        TryReleasePendingFences();
+        const bool should_flush = ShouldFlush();
+        if (!should_flush && fences.empty()) {
+            // Nothing to wait for, keep the syncpoint as responsive as it was
+            system.GPU().IncrementSyncPoint(syncpoint_id);
+            return;
+        }
+        CommitAsyncFlushes();
+        TFence new_fence = CreateFence(syncpoint_id, !should_flush);
+        fences.push(new_fence);
+        QueueFence(new_fence);
+        if (should_flush) {
+            rasterizer.FlushCommands();
+        }
+    }
+
+    /// Releases the fences signaled by the host GPU without waiting.
+    void TryReleasePendingFences() {
+        while (!fences.empty()) {
+            TFence& current_fence = fences.front();
+            if (ShouldWait() && !IsFenceSignaled(current_fence)) {
+                return;
+            }
+            PopAsyncFlushes();
+            system.GPU().IncrementSyncPoint(current_fence->GetSyncPoint());
+            fences.pop();
+        }
+    }
+
+    /// Releases all pending fences, waiting for the host GPU when they haven't been signaled.
+    void WaitPendingFences() {
+        while (!fences.empty()) {
+            TFence& current_fence = fences.front();
+            if (ShouldWait()) {
+                WaitFence(current_fence);
+            }
+            PopAsyncFlushes();
+            system.GPU().IncrementSyncPoint(current_fence->GetSyncPoint());
+            fences.pop();
+        }
+    }
+
+protected:
+    explicit FenceManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
+                          TTextureCache& texture_cache, TBufferCache& buffer_cache)
+        : system{system}, rasterizer{rasterizer}, texture_cache{texture_cache},
+          buffer_cache{buffer_cache} {}
+
+    virtual ~FenceManager() = default;
+
+    /// Creates a fence interface, it will not be used by the GPU when it's stubbed.
+    virtual TFence CreateFence(u32 syncpoint_id, bool is_stubbed) = 0;
+
+    /// Queues a fence into the backend if the fence isn't stubbed.
+    virtual void QueueFence(TFence& fence) = 0;
+
+    /// Returns true when the fence has been signaled by the host GPU.
+    virtual bool IsFenceSignaled(TFence& fence) const = 0;
+
+    /// Waits until the fence has been signaled by the host GPU.
+    virtual void WaitFence(TFence& fence) = 0;
+
+    Core::System& system;
+    VideoCore::RasterizerInterface& rasterizer;
+    TTextureCache& texture_cache;
+    TBufferCache& buffer_cache;
+
+private:
+    void CommitAsyncFlushes() {
+        texture_cache.CommitAsyncFlushes();
+        buffer_cache.CommitAsyncFlushes();
+    }
+
+    void PopAsyncFlushes() {
+        texture_cache.PopAsyncFlushes();
+        buffer_cache.PopAsyncFlushes();
+    }
+
+    bool ShouldFlush() const {
+        return texture_cache.HasUncommittedFlushes() || buffer_cache.HasUncommittedFlushes();
+    }
+
+    bool ShouldWait() const {
+        return texture_cache.ShouldWaitAsyncFlushes() || buffer_cache.ShouldWaitAsyncFlushes();
+    }
+
+    std::queue<TFence> fences;
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,136 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <csignal>
+#include <utility>
+
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "common/thread.h"
+#include "video_core/frame_capture.h"
+
+namespace VideoCore {
+
+namespace {
+
+/// Frames waiting for the encoder before new ones are dropped
+constexpr std::size_t MAX_QUEUED_FRAMES = 8;
+
+std::FILE* OpenPipe(const std::string& command) {
+#ifdef _WIN32
+    return _popen(command.c_str(), "wb");
+#else
+    // A dead encoder must fail the writes instead of killing the emulator
+    std::signal(SIGPIPE, SIG_IGN);
+    return popen(command.c_str(), "w");
+#endif
+}
+
+void ClosePipe(std::FILE* pipe) {
+#ifdef _WIN32
+    _pclose(pipe);
+#else
+    pclose(pipe);
+#endif
+}
+
+} // Anonymous namespace
+
+FrameCapture::FrameCapture(const std::string& command, u32 width, u32 height, u32 fps)
+    : width{width}, height{height} {
+    std::string expanded_command = command;
+    expanded_command = Common::ReplaceAll(expanded_command, "{width}", std::to_string(width));
+    expanded_command = Common::ReplaceAll(expanded_command, "{height}", std::to_string(height));
+    expanded_command = Common::ReplaceAll(expanded_command, "{fps}", std::to_string(fps));
+
+    pipe = OpenPipe(expanded_command);
+    if (pipe == nullptr) {
+        LOG_ERROR(Render, "Failed to start the frame capture encoder \"{}\"", expanded_command);
+        return;
+    }
+
+    LOG_INFO(Render, "Capturing {}x{} frames into \"{}\"", width, height, expanded_command);
+    worker = std::thread([this] { WorkerLoop(); });
+}
+
+FrameCapture::~FrameCapture() {
+    if (pipe == nullptr) {
+        return;
+    }
+
+    {
+        std::lock_guard lock{mutex};
+        stop_requested = true;
+    }
+    cv.notify_one();
+    worker.join();
+    ClosePipe(pipe);
+
+    LOG_INFO(Render, "Captured {} frames, {} were dropped", num_encoded_frames,
+             num_dropped_frames);
+}
+
+std::vector<u8> FrameCapture::AcquireBuffer() {
+    std::vector<u8> buffer;
+    {
+        std::lock_guard lock{mutex};
+        if (!free_buffers.empty()) {
+            buffer = std::move(free_buffers.back());
+            free_buffers.pop_back();
+        }
+    }
+    buffer.resize(GetFrameSize());
+    return buffer;
+}
+
+void FrameCapture::PushFrame(std::vector<u8> frame, bool bottom_up) {
+    {
+        std::lock_guard lock{mutex};
+        if (queued_frames.size() >= MAX_QUEUED_FRAMES) {
+            ++num_dropped_frames;
+            free_buffers.push_back(std::move(frame));
+            return;
+        }
+        queued_frames.push_back({std::move(frame), bottom_up});
+    }
+    cv.notify_one();
+}
+
+void FrameCapture::WorkerLoop() {
+    Common::SetCurrentThreadName("yuzu:FrameCapture");
+
+    const std::size_t pitch = static_cast<std::size_t>(width) * 4;
+    std::unique_lock lock{mutex};
+    while (true) {
+        cv.wait(lock, [this] { return stop_requested || !queued_frames.empty(); });
+        if (queued_frames.empty()) {
+            // Only stop once every queued frame reached the encoder
+            return;
+        }
+
+        Frame frame = std::move(queued_frames.front());
+        queued_frames.pop_front();
+        lock.unlock();
+
+        bool written = true;
+        if (frame.bottom_up) {
+            for (u32 row = height; row-- > 0 && written;) {
+                written = std::fwrite(frame.pixels.data() + row * pitch, pitch, 1, pipe) == 1;
+            }
+        } else {
+            written = std::fwrite(frame.pixels.data(), frame.pixels.size(), 1, pipe) == 1;
+        }
+
+        lock.lock();
+        free_buffers.push_back(std::move(frame.pixels));
+        if (!written) {
+            LOG_ERROR(Render, "The frame capture encoder stopped reading frames");
+            queued_frames.clear();
+            return;
+        }
+        ++num_encoded_frames;
+    }
+}
+
+} // namespace VideoCore
@@ -0,0 +1,90 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Streams the presented frames to an external encoder process, so gameplay can be recorded into
+ * H.264/H.265 with whatever encoder the host has, hardware ones included.
+ *
+ * The encoder reads raw BGRA video with the top row first from its standard input. Its command
+ * line is taken from the settings, replacing {width}, {height} and {fps} with the video format,
+ * for example:
+ * ffmpeg -f rawvideo -pix_fmt bgra -s {width}x{height} -r {fps} -i - -c:v h264_vaapi out.mkv
+ *
+ * Frames are written to the encoder from a thread of its own, so a slow encoder never stalls the
+ * renderer: frames that arrive while too many are still queued are dropped instead.
+ */
+class FrameCapture final {
+public:
+    explicit FrameCapture(const std::string& command, u32 width, u32 height, u32 fps);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /// Returns true when the encoder process is running
+    bool IsOpen() const {
+        return pipe != nullptr;
+    }
+
+    u32 GetWidth() const {
+        return width;
+    }
+
+    u32 GetHeight() const {
+        return height;
+    }
+
+    /// Returns the size in bytes of a frame
+    std::size_t GetFrameSize() const {
+        return static_cast<std::size_t>(width) * height * 4;
+    }
+
+    /// Returns a buffer of GetFrameSize() bytes, reusing the ones of frames already encoded
+    std::vector<u8> AcquireBuffer();
+
+    /**
+     * Queues a frame to be sent to the encoder.
+     * @param frame     BGRA pixels of the frame, GetFrameSize() bytes long
+     * @param bottom_up Whether the rows of frame start from the bottom, as OpenGL reads them
+     */
+    void PushFrame(std::vector<u8> frame, bool bottom_up);
+
+private:
+    struct Frame {
+        std::vector<u8> pixels;
+        bool bottom_up;
+    };
+
+    void WorkerLoop();
+
+    const u32 width;
+    const u32 height;
+    std::FILE* pipe = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Frame> queued_frames;
+    std::vector<std::vector<u8>> free_buffers;
+    bool stop_requested = false;
+    u64 num_encoded_frames = 0;
+    u64 num_dropped_frames = 0;
+
+    std::thread worker;
+};
+
+} // namespace VideoCore
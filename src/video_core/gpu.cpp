@@ -7,18 +7,21 @@
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/memory.h"
+#include "core/settings.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/kepler_memory.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
 #include "video_core/memory_manager.h"
 #include "video_core/renderer_base.h"
 
 namespace Tegra {
 
 MICROPROFILE_DEFINE(GPU_wait, "GPU", "Wait for the GPU", MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(GPU_syncpt_wake, "GPU", "Wake syncpoint waiters", MP_RGB(160, 128, 192));
 
 GPU::GPU(Core::System& system, VideoCore::RendererBase& renderer, bool is_async)
     : system{system}, renderer{renderer}, is_async{is_async} {
@@ -28,8 +31,14 @@ GPU::GPU(Core::System& system, VideoCore::RendererBase& renderer, bool is_async)
     maxwell_3d = std::make_unique<Engines::Maxwell3D>(system, rasterizer, *memory_manager);
     fermi_2d = std::make_unique<Engines::Fermi2D>(rasterizer);
     kepler_compute = std::make_unique<Engines::KeplerCompute>(system, rasterizer, *memory_manager);
-    maxwell_dma = std::make_unique<Engines::MaxwellDMA>(system, *memory_manager);
+    maxwell_dma = std::make_unique<Engines::MaxwellDMA>(system, rasterizer, *memory_manager);
     kepler_memory = std::make_unique<Engines::KeplerMemory>(system, *memory_manager);
+
+    if (Settings::values.gpu_capture_frames > 0) {
+        capture_recorder = std::make_unique<Capture::Recorder>(
+            system, *this, Settings::values.gpu_capture_start_frame,
+            Settings::values.gpu_capture_frames);
+    }
 }
 
 GPU::~GPU() = default;
@@ -50,6 +59,42 @@ const Engines::KeplerCompute& GPU::KeplerCompute() const {
     return *kepler_compute;
 }
 
+void GPU::SaveState(Capture::EngineState& state) const {
+    state.puller = regs;
+    state.bound_engines = bound_engines;
+    state.maxwell_3d = maxwell_3d->regs;
+    state.maxwell_3d_state = maxwell_3d->state;
+    state.macro_positions = maxwell_3d->GetMacroPositions();
+    state.macro_memory = maxwell_3d->GetMacroMemory();
+    state.fermi_2d = fermi_2d->regs;
+    state.kepler_compute = kepler_compute->regs;
+    state.maxwell_dma = maxwell_dma->regs;
+    state.kepler_memory = kepler_memory->regs;
+}
+
+void GPU::LoadState(const Capture::EngineState& state) {
+    regs = state.puller;
+    bound_engines = state.bound_engines;
+    maxwell_3d->RestoreState(state.maxwell_3d, state.maxwell_3d_state, state.macro_memory,
+                             state.macro_positions);
+    fermi_2d->regs = state.fermi_2d;
+    kepler_compute->regs = state.kepler_compute;
+    maxwell_dma->regs = state.maxwell_dma;
+    kepler_memory->regs = state.kepler_memory;
+}
+
+void GPU::RecordCommandList(const Tegra::CommandList& entries) {
+    if (capture_recorder) {
+        capture_recorder->OnCommandList(entries);
+    }
+}
+
+void GPU::RecordSwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    if (capture_recorder) {
+        capture_recorder->OnSwapBuffers(framebuffer);
+    }
+}
+
 MemoryManager& GPU::MemoryManager() {
     return *memory_manager;
 }
@@ -72,25 +117,51 @@ void GPU::WaitFence(u32 syncpoint_id, u32 value) {
         return;
     }
     MICROPROFILE_SCOPE(GPU_wait);
+    KickoffCommands();
+    // Announce the wait before checking the syncpoint, IncrementSyncPoint does the opposite
+    ++fence_waiters;
     std::unique_lock lock{sync_mutex};
     sync_cv.wait(lock, [=]() { return syncpoints[syncpoint_id].load() >= value; });
+    --fence_waiters;
 }
 
 void GPU::IncrementSyncPoint(const u32 syncpoint_id) {
-    syncpoints[syncpoint_id]++;
+    const u32 value = ++syncpoints[syncpoint_id];
+
+    // Waiters register themselves before they check the value, and this checks for waiters
+    // after incrementing it, so one of the two sides always sees the other
+    const bool has_interrupts = syncpt_interrupt_counts[syncpoint_id].load() != 0;
+    const bool has_fence_waiters = fence_waiters.load() != 0;
+    if (!has_interrupts && !has_fence_waiters) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_syncpt_wake);
     std::lock_guard lock{sync_mutex};
-    sync_cv.notify_all();
-    if (!syncpt_interrupts[syncpoint_id].empty()) {
-        u32 value = syncpoints[syncpoint_id].load();
-        auto it = syncpt_interrupts[syncpoint_id].begin();
-        while (it != syncpt_interrupts[syncpoint_id].end()) {
-            if (value >= *it) {
-                TriggerCpuInterrupt(syncpoint_id, *it);
-                it = syncpt_interrupts[syncpoint_id].erase(it);
-                continue;
-            }
-            it++;
+    if (has_fence_waiters) {
+        sync_cv.notify_all();
+    }
+    if (has_interrupts) {
+        TriggerSyncptInterrupts(syncpoint_id, value);
+    }
+}
+
+void GPU::TriggerSyncptInterrupts(u32 syncpoint_id, u32 value) {
+    const auto now = std::chrono::steady_clock::now();
+    auto& interrupts = syncpt_interrupts[syncpoint_id];
+    auto it = interrupts.begin();
+    while (it != interrupts.end()) {
+        if (value >= it->value) {
+            TriggerCpuInterrupt(syncpoint_id, it->value);
+            const auto wait_time = now - it->registration_time;
+            syncpt_wait_ns += static_cast<u64>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(wait_time).count());
+            ++syncpt_waits;
+            it = interrupts.erase(it);
+            --syncpt_interrupt_counts[syncpoint_id];
+            continue;
         }
+        it++;
     }
 }
 
@@ -100,12 +171,21 @@ u32 GPU::GetSyncpointValue(const u32 syncpoint_id) const {
 
 void GPU::RegisterSyncptInterrupt(const u32 syncpoint_id, const u32 value) {
     auto& interrupt = syncpt_interrupts[syncpoint_id];
-    bool contains = std::any_of(interrupt.begin(), interrupt.end(),
-                                [value](u32 in_value) { return in_value == value; });
+    bool contains =
+        std::any_of(interrupt.begin(), interrupt.end(),
+                    [value](const SyncptInterrupt& in) { return in.value == value; });
     if (contains) {
         return;
     }
-    syncpt_interrupts[syncpoint_id].emplace_back(value);
+    interrupt.push_back({value, std::chrono::steady_clock::now()});
+    ++syncpt_interrupt_counts[syncpoint_id];
+
+    // Increments don't take the lock when they see no interrupts, so the syncpoint may have
+    // reached the value since the caller last checked it
+    const u32 current_value = syncpoints[syncpoint_id].load();
+    if (current_value >= value) {
+        TriggerSyncptInterrupts(syncpoint_id, current_value);
+    }
 }
 
 bool GPU::CancelSyncptInterrupt(const u32 syncpoint_id, const u32 value) {
@@ -113,15 +193,38 @@ bool GPU::CancelSyncptInterrupt(const u32 syncpoint_id, const u32 value) {
     auto& interrupt = syncpt_interrupts[syncpoint_id];
     const auto iter =
         std::find_if(interrupt.begin(), interrupt.end(),
-                     [value](u32 interrupt_value) { return value == interrupt_value; });
+                     [value](const SyncptInterrupt& in) { return value == in.value; });
 
     if (iter == interrupt.end()) {
         return false;
     }
     interrupt.erase(iter);
+    --syncpt_interrupt_counts[syncpoint_id];
     return true;
 }
 
+std::pair<double, u32> GPU::GetAndResetSyncptWaitStats() {
+    const u64 wait_ns = syncpt_wait_ns.exchange(0);
+    const u32 waits = syncpt_waits.exchange(0);
+    return {waits == 0 ? 0.0 : static_cast<double>(wait_ns) / 1e9 / waits, waits};
+}
+
+std::pair<u32, u32> GPU::GetAndResetBlitStats() {
+    return fermi_2d->GetAndResetBlitStats();
+}
+
+std::pair<u32, u32> GPU::GetAndResetSurfaceOverlapStats() {
+    return renderer.Rasterizer().GetAndResetSurfaceOverlapStats();
+}
+
+u64 GPU::GetAndResetSkippedUploadStats() {
+    return renderer.Rasterizer().GetAndResetSkippedUploadStats();
+}
+
+std::pair<u64, u64> GPU::GetAndResetBufferUploadStats() {
+    return renderer.Rasterizer().GetAndResetBufferUploadStats();
+}
+
 void GPU::FlushCommands() {
     renderer.Rasterizer().FlushCommands();
 }
@@ -229,16 +332,31 @@ void GPU::CallMethod(const MethodCall& method_call) {
 
     ASSERT(method_call.subchannel < bound_engines.size());
 
-    if (ExecuteMethodOnEngine(method_call)) {
+    if (ExecuteMethodOnEngine(method_call.method)) {
         CallEngineMethod(method_call);
     } else {
         CallPullerMethod(method_call);
     }
 }
 
-bool GPU::ExecuteMethodOnEngine(const MethodCall& method_call) {
-    const auto method = static_cast<BufferMethods>(method_call.method);
-    return method >= BufferMethods::NonPullerMethods;
+void GPU::CallMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                          u32 methods_pending) {
+    LOG_TRACE(HW_GPU, "Processing method {:08X} on subchannel {}", method, subchannel);
+
+    ASSERT(subchannel < bound_engines.size());
+
+    if (ExecuteMethodOnEngine(method)) {
+        CallEngineMultiMethod(method, subchannel, base_start, amount, methods_pending);
+    } else {
+        for (u32 i = 0; i < amount; ++i) {
+            CallPullerMethod({method, base_start[i], subchannel, methods_pending - i});
+        }
+    }
+}
+
+bool GPU::ExecuteMethodOnEngine(u32 method) {
+    const auto buffer_method = static_cast<BufferMethods>(method);
+    return buffer_method >= BufferMethods::NonPullerMethods;
 }
 
 void GPU::CallPullerMethod(const MethodCall& method_call) {
@@ -318,6 +436,31 @@ void GPU::CallEngineMethod(const MethodCall& method_call) {
     }
 }
 
+void GPU::CallEngineMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                                u32 methods_pending) {
+    const EngineID engine = bound_engines[subchannel];
+
+    switch (engine) {
+    case EngineID::FERMI_TWOD_A:
+        fermi_2d->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::MAXWELL_B:
+        maxwell_3d->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::KEPLER_COMPUTE_B:
+        kepler_compute->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::MAXWELL_DMA_COPY_A:
+        maxwell_dma->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    case EngineID::KEPLER_INLINE_TO_MEMORY_B:
+        kepler_memory->CallMultiMethod(method, base_start, amount, methods_pending);
+        break;
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented engine");
+    }
+}
+
 void GPU::ProcessBindMethod(const MethodCall& method_call) {
     // Bind the current subchannel to the desired engine id.
     LOG_DEBUG(HW_GPU, "Binding subchannel {} to engine {}", method_call.subchannel,
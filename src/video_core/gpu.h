@@ -6,10 +6,12 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include "common/common_types.h"
 #include "core/hle/service/nvdrv/nvdata.h"
 #include "core/hle/service/nvflinger/buffer_queue.h"
@@ -131,6 +133,11 @@ enum class EngineID {
 
 class MemoryManager;
 
+namespace Capture {
+struct EngineState;
+class Recorder;
+} // namespace Capture
+
 class GPU {
 public:
     explicit GPU(Core::System& system, VideoCore::RendererBase& renderer, bool is_async);
@@ -155,6 +162,11 @@ public:
     /// Calls a GPU method.
     void CallMethod(const MethodCall& method_call);
 
+    /// Calls a GPU method once for every argument in the given range, as sent by a
+    /// non-incrementing command. methods_pending is the method count at the first call.
+    void CallMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                         u32 methods_pending);
+
     void FlushCommands();
 
     /// Returns a reference to the Maxwell3D GPU engine.
@@ -179,19 +191,62 @@ public:
     Tegra::DmaPusher& DmaPusher();
 
     // Waits for the GPU to finish working
-    virtual void WaitIdle() const = 0;
+    virtual void WaitIdle() = 0;
+
+    /// Makes sure the GPU starts processing any command lists pushed so far.
+    virtual void KickoffCommands() = 0;
+
+    /// Returns the largest number of commands that were ever waiting to be processed.
+    virtual std::size_t GetPeakCommandQueueDepth() const = 0;
+
+    /// Returns true while the last frame passed to SwapBuffers hasn't been presented yet.
+    virtual bool IsSwapPending() const = 0;
+
+    /// Returns the fence of the last frame passed to SwapBuffers, frames are presented in order.
+    virtual u64 GetLastSwapFence() const = 0;
+
+    /// Returns true once the host is done presenting the frame identified by the swap fence.
+    virtual bool IsSwapPresented(u64 swap_fence) const = 0;
+
+    /// Records that the GPU wrote a region of host cached memory, the CPU has to flush it before
+    /// reading it. Only asynchronous GPU emulation has to track this.
+    virtual void MarkRegionWritten(CacheAddr addr, u64 size) = 0;
 
     /// Allows the CPU/NvFlinger to wait on the GPU before presenting a frame.
     void WaitFence(u32 syncpoint_id, u32 value);
 
+    /// Increments a syncpoint. When nobody waits on the syncpoint this is a single atomic
+    /// operation, and it doesn't take the sync lock.
     void IncrementSyncPoint(u32 syncpoint_id);
 
     u32 GetSyncpointValue(u32 syncpoint_id) const;
 
+    /// Interrupts the CPU once the syncpoint reaches value, right away when it already has.
+    /// Has to be called with the lock from LockSync held.
     void RegisterSyncptInterrupt(u32 syncpoint_id, u32 value);
 
     bool CancelSyncptInterrupt(u32 syncpoint_id, u32 value);
 
+    /// Returns the average walltime, in seconds, between the registration of a syncpoint
+    /// interrupt and its trigger since the last call, and the number of interrupts triggered.
+    std::pair<double, u32> GetAndResetSyncptWaitStats();
+
+    /// Returns the number of Fermi2D surface copies performed by the host GPU since the last call,
+    /// and the number of copies it couldn't perform.
+    std::pair<u32, u32> GetAndResetBlitStats();
+
+    /// Returns the number of texture cache overlaps resolved with host GPU copies since the last
+    /// call, and the number of overlaps that had to round trip through guest memory.
+    std::pair<u32, u32> GetAndResetSurfaceOverlapStats();
+
+    /// Returns the mean number of guest bytes per frame whose texture upload was skipped because
+    /// their contents didn't change, since the last call.
+    u64 GetAndResetSkippedUploadStats();
+
+    /// Returns the mean number of bytes per frame uploaded to stream buffers since the last call,
+    /// and the mean number of const buffer bytes whose previous upload was reused.
+    std::pair<u64, u64> GetAndResetBufferUploadStats();
+
     std::unique_lock<std::mutex> LockSync() {
         return std::unique_lock{sync_mutex};
     }
@@ -203,6 +258,12 @@ public:
     /// Returns a const reference to the GPU DMA pusher.
     const Tegra::DmaPusher& DmaPusher() const;
 
+    /// Copies the state of the puller and of every engine, the starting point of a GPU capture.
+    void SaveState(Capture::EngineState& state) const;
+
+    /// Restores a state saved by SaveState, every register is considered dirty afterwards.
+    void LoadState(const Capture::EngineState& state);
+
     struct Regs {
         static constexpr size_t NUM_REGS = 0x100;
 
@@ -271,6 +332,12 @@ public:
 protected:
     virtual void TriggerCpuInterrupt(u32 syncpoint_id, u32 value) const = 0;
 
+    /// Hands a command list to the GPU capture recorder, when a capture has been requested.
+    void RecordCommandList(const Tegra::CommandList& entries);
+
+    /// Hands a swap to the GPU capture recorder, when a capture has been requested.
+    void RecordSwapBuffers(const Tegra::FramebufferConfig* framebuffer);
+
 private:
     void ProcessBindMethod(const MethodCall& method_call);
     void ProcessSemaphoreTriggerMethod();
@@ -283,8 +350,12 @@ private:
     /// Calls a GPU engine method.
     void CallEngineMethod(const MethodCall& method_call);
 
+    /// Calls a GPU engine method with multiple arguments.
+    void CallEngineMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
+                               u32 methods_pending);
+
     /// Determines where the method should be executed.
-    bool ExecuteMethodOnEngine(const MethodCall& method_call);
+    bool ExecuteMethodOnEngine(u32 method);
 
 protected:
     std::unique_ptr<Tegra::DmaPusher> dma_pusher;
@@ -307,9 +378,31 @@ private:
     /// Inline memory engine
     std::unique_ptr<Engines::KeplerMemory> kepler_memory;
 
+    /// Recorder of the GPU capture requested in the settings, if any
+    std::unique_ptr<Capture::Recorder> capture_recorder;
+
+    /// Interrupt waiting for a syncpoint to reach a value
+    struct SyncptInterrupt {
+        u32 value;
+        std::chrono::steady_clock::time_point registration_time;
+    };
+
+    /// Triggers and removes the interrupts of a syncpoint that reached their value. Has to be
+    /// called with sync_mutex held.
+    void TriggerSyncptInterrupts(u32 syncpoint_id, u32 value);
+
     std::array<std::atomic<u32>, Service::Nvidia::MaxSyncPoints> syncpoints{};
 
-    std::array<std::list<u32>, Service::Nvidia::MaxSyncPoints> syncpt_interrupts;
+    std::array<std::list<SyncptInterrupt>, Service::Nvidia::MaxSyncPoints> syncpt_interrupts;
+
+    /// Sizes of syncpt_interrupts, so increments can tell there is nobody to wake without the lock
+    std::array<std::atomic<u32>, Service::Nvidia::MaxSyncPoints> syncpt_interrupt_counts{};
+
+    /// Number of host threads in WaitFence
+    std::atomic<u32> fence_waiters{};
+
+    std::atomic<u64> syncpt_wait_ns{};
+    std::atomic<u32> syncpt_waits{};
 
     std::mutex sync_mutex;
 
@@ -20,10 +20,13 @@ void GPUAsynch::Start() {
 }
 
 void GPUAsynch::PushGPUEntries(Tegra::CommandList&& entries) {
-    gpu_thread.SubmitList(std::move(entries));
+    RecordCommandList(entries);
+    // Decode the pushbuffers on the submitting thread, so the GPU thread only has to execute them
+    gpu_thread.SubmitList(dma_pusher->Decode(entries));
 }
 
 void GPUAsynch::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    RecordSwapBuffers(framebuffer);
     gpu_thread.SwapBuffers(framebuffer);
 }
 
@@ -44,8 +47,32 @@ void GPUAsynch::TriggerCpuInterrupt(const u32 syncpoint_id, const u32 value) con
     interrupt_manager.GPUInterruptSyncpt(syncpoint_id, value);
 }
 
-void GPUAsynch::WaitIdle() const {
+void GPUAsynch::WaitIdle() {
     gpu_thread.WaitIdle();
 }
 
+void GPUAsynch::KickoffCommands() {
+    gpu_thread.KickoffCommands();
+}
+
+std::size_t GPUAsynch::GetPeakCommandQueueDepth() const {
+    return gpu_thread.GetPeakQueueDepth();
+}
+
+bool GPUAsynch::IsSwapPending() const {
+    return gpu_thread.IsSwapPending();
+}
+
+u64 GPUAsynch::GetLastSwapFence() const {
+    return gpu_thread.GetLastSwapFence();
+}
+
+bool GPUAsynch::IsSwapPresented(u64 swap_fence) const {
+    return gpu_thread.IsFenceSignaled(swap_fence);
+}
+
+void GPUAsynch::MarkRegionWritten(CacheAddr addr, u64 size) {
+    gpu_thread.MarkRegionWritten(addr, size);
+}
+
 } // namespace VideoCommon
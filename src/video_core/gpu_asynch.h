@@ -25,7 +25,13 @@ public:
     void FlushRegion(CacheAddr addr, u64 size) override;
     void InvalidateRegion(CacheAddr addr, u64 size) override;
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size) override;
-    void WaitIdle() const override;
+    void WaitIdle() override;
+    void KickoffCommands() override;
+    std::size_t GetPeakCommandQueueDepth() const override;
+    bool IsSwapPending() const override;
+    u64 GetLastSwapFence() const override;
+    bool IsSwapPresented(u64 swap_fence) const override;
+    void MarkRegionWritten(CacheAddr addr, u64 size) override;
 
 protected:
     void TriggerCpuInterrupt(u32 syncpoint_id, u32 value) const override;
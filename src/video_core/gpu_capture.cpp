@@ -0,0 +1,347 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "common/alignment.h"
+#include "common/common_paths.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/file_sys/vfs.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+#include "video_core/gpu_capture.h"
+#include "video_core/memory_manager.h"
+
+namespace Tegra::Capture {
+
+namespace {
+
+/// Granularity of GPU memory mappings
+constexpr u64 GPU_PAGE_SIZE = 0x10000;
+
+/// Maps a recorded region on the GPU, leaving the pages that are already mapped as recorded alone
+void MapMemory(MemoryManager& memory_manager, const MemoryMapping& mapping) {
+    for (u64 offset = 0; offset < mapping.size; offset += GPU_PAGE_SIZE) {
+        const GPUVAddr gpu_addr = mapping.gpu_addr + offset;
+        const VAddr cpu_addr = mapping.cpu_addr + offset;
+        const std::optional<VAddr> current_addr = memory_manager.GpuToCpuAddress(gpu_addr);
+        if (current_addr == cpu_addr) {
+            continue;
+        }
+        if (current_addr) {
+            memory_manager.UnmapBuffer(gpu_addr, GPU_PAGE_SIZE);
+        }
+        memory_manager.MapBufferEx(cpu_addr, gpu_addr, GPU_PAGE_SIZE);
+    }
+}
+
+} // Anonymous namespace
+
+Recorder::Recorder(Core::System& system, GPU& gpu, u32 start_frame, u32 num_frames)
+    : system{system}, gpu{gpu}, start_frame{start_frame}, num_frames{num_frames} {}
+
+Recorder::~Recorder() {
+    if (status == Status::Recording) {
+        LOG_WARNING(HW_GPU, "GPU capture stopped after {} of {} frames", frames_recorded,
+                    num_frames);
+        End();
+    }
+}
+
+void Recorder::OnCommandList(const CommandList& entries) {
+    if (status == Status::Waiting && frames_seen >= start_frame) {
+        Begin();
+    }
+    if (status != Status::Recording) {
+        return;
+    }
+    SyncMemory();
+    WriteRecord(RecordType::CommandList, entries.data(),
+                entries.size() * sizeof(CommandListHeader));
+}
+
+void Recorder::OnSwapBuffers(const FramebufferConfig* framebuffer) {
+    if (status != Status::Recording) {
+        ++frames_seen;
+        return;
+    }
+    SyncMemory();
+
+    SwapBuffersInfo info{};
+    if (framebuffer) {
+        info.has_framebuffer = 1;
+        info.framebuffer = *framebuffer;
+    }
+    WriteRecord(RecordType::SwapBuffers, &info, sizeof(info));
+
+    if (++frames_recorded == num_frames) {
+        End();
+    }
+}
+
+void Recorder::Begin() {
+    // Don't retry on every command list if anything goes wrong from here on
+    status = Status::Done;
+
+    const std::string directory =
+        FileUtil::GetUserPath(FileUtil::UserPath::DumpDir) + "gpu_captures" DIR_SEP;
+    if (!FileUtil::CreateFullPath(directory)) {
+        LOG_ERROR(HW_GPU, "Failed to create GPU capture directory {}", directory);
+        return;
+    }
+    const u64 title_id = system.CurrentProcess()->GetTitleID();
+    const std::string path =
+        fmt::format("{}{:016X}_{}.{}", directory, title_id, frames_seen, EXTENSION);
+    if (!file.Open(path, "wb")) {
+        LOG_ERROR(HW_GPU, "Failed to create GPU capture {}", path);
+        return;
+    }
+    LOG_INFO(HW_GPU, "Recording {} frames into GPU capture {}", num_frames, path);
+
+    const FileHeader header{MAGIC, VERSION};
+    file.WriteObject(header);
+
+    // The engines can only be copied once they have executed everything submitted so far
+    gpu.WaitIdle();
+    const auto state = std::make_unique<EngineState>();
+    gpu.SaveState(*state);
+    WriteRecord(RecordType::EngineState, state.get(), sizeof(EngineState));
+
+    status = Status::Recording;
+
+    // Nothing has been recorded yet, so this records every mapping with all of its contents
+    SyncMemory();
+}
+
+void Recorder::End() {
+    LOG_INFO(HW_GPU, "Finished recording GPU capture, {} bytes", file.Tell());
+    file.Close();
+    mappings.clear();
+    page_hashes.clear();
+    status = Status::Done;
+}
+
+void Recorder::SyncMemory() {
+    const MemoryManager& memory_manager = gpu.MemoryManager();
+
+    std::map<GPUVAddr, MemoryMapping> current_mappings;
+    memory_manager.ForEachMappedRegion([&](GPUVAddr gpu_addr, VAddr cpu_addr, u64 size) {
+        const MemoryMapping mapping{gpu_addr, cpu_addr, size};
+        current_mappings.emplace(gpu_addr, mapping);
+
+        const auto it = mappings.find(gpu_addr);
+        if (it == mappings.end() || it->second.cpu_addr != cpu_addr || it->second.size != size) {
+            WriteRecord(RecordType::MapMemory, &mapping, sizeof(mapping));
+        }
+    });
+    mappings = std::move(current_mappings);
+
+    for (const auto& [gpu_addr, mapping] : mappings) {
+        // Consecutive dirty pages are recorded together, as long as they are in the same GPU page
+        // and therefore contiguous in host memory
+        std::optional<u64> run_start;
+        const auto flush_run = [&](u64 run_end) {
+            if (run_start) {
+                RecordMemory(mapping.cpu_addr + *run_start,
+                             memory_manager.GetPointer(gpu_addr + *run_start),
+                             static_cast<std::size_t>(run_end - *run_start));
+                run_start.reset();
+            }
+        };
+        for (u64 offset = 0; offset < mapping.size; offset += Memory::PAGE_SIZE) {
+            if (offset % GPU_PAGE_SIZE == 0) {
+                flush_run(offset);
+            }
+            const u8* const data = memory_manager.GetPointer(gpu_addr + offset);
+            if (!data) {
+                flush_run(offset);
+                continue;
+            }
+            const u64 hash = Common::HashValue(data, Memory::PAGE_SIZE);
+            // Aliased pages are hashed once per mapping, but only recorded the first time
+            const auto [it, is_new] = page_hashes.try_emplace(mapping.cpu_addr + offset, hash);
+            if (!is_new && it->second == hash) {
+                flush_run(offset);
+                continue;
+            }
+            it->second = hash;
+            if (!run_start) {
+                run_start = offset;
+            }
+        }
+        flush_run(mapping.size);
+    }
+}
+
+void Recorder::RecordMemory(VAddr cpu_addr, const u8* data, std::size_t size) {
+    const RecordHeader header{RecordType::WriteMemory, 0, sizeof(cpu_addr) + size};
+    file.WriteObject(header);
+    file.WriteObject(cpu_addr);
+    file.WriteBytes(data, size);
+}
+
+void Recorder::WriteRecord(RecordType type, const void* payload, std::size_t size) {
+    const RecordHeader header{type, 0, size};
+    file.WriteObject(header);
+    file.WriteBytes(static_cast<const u8*>(payload), size);
+}
+
+Reader::Reader(FileSys::VirtualFile file) : file{std::move(file)} {
+    Rewind();
+}
+
+Reader::~Reader() = default;
+
+bool Reader::IsValid(const FileSys::VirtualFile& file) {
+    FileHeader header{};
+    if (!file || file->ReadObject(&header) != sizeof(header)) {
+        return false;
+    }
+    return header.magic == MAGIC && header.version == VERSION;
+}
+
+std::optional<RecordHeader> Reader::NextRecord() {
+    if (!is_payload_read) {
+        offset += current.size;
+    }
+    RecordHeader header;
+    if (file->ReadObject(&header, offset) != sizeof(header)) {
+        return std::nullopt;
+    }
+    offset += sizeof(header);
+    current = header;
+    is_payload_read = false;
+    return header;
+}
+
+std::vector<u8> Reader::ReadPayload() {
+    std::vector<u8> payload = file->ReadBytes(current.size, offset);
+    offset += current.size;
+    is_payload_read = true;
+    return payload;
+}
+
+bool Reader::ReadPayload(void* data, std::size_t size) {
+    const std::size_t read_size = file->ReadBytes(static_cast<u8*>(data), size, offset);
+    offset += current.size;
+    is_payload_read = true;
+    return read_size == size;
+}
+
+void Reader::Rewind() {
+    offset = sizeof(FileHeader);
+    current = {};
+    is_payload_read = true;
+}
+
+Player::Player(Core::System& system, FileSys::VirtualFile file)
+    : system{system}, reader{std::move(file)}, engine_state{std::make_unique<EngineState>()} {}
+
+Player::~Player() = default;
+
+std::optional<u32> Player::Play(const std::function<void()>& on_frame) {
+    GPU& gpu = system.GPU();
+    MemoryManager& memory_manager = gpu.MemoryManager();
+
+    u32 num_frames = 0;
+    reader.Rewind();
+    while (const std::optional<RecordHeader> record = reader.NextRecord()) {
+        switch (record->type) {
+        case RecordType::EngineState:
+            if (!reader.ReadPayload(*engine_state)) {
+                LOG_ERROR(HW_GPU, "GPU capture has a malformed engine state");
+                return std::nullopt;
+            }
+            // The engines are owned by the GPU thread, wait for it before touching them
+            gpu.WaitIdle();
+            gpu.LoadState(*engine_state);
+            break;
+        case RecordType::MapMemory: {
+            MemoryMapping mapping;
+            if (!reader.ReadPayload(mapping)) {
+                LOG_ERROR(HW_GPU, "GPU capture has a malformed memory mapping");
+                return std::nullopt;
+            }
+            MapMemory(memory_manager, mapping);
+            break;
+        }
+        case RecordType::WriteMemory: {
+            const std::vector<u8> payload = reader.ReadPayload();
+            VAddr cpu_addr;
+            if (payload.size() < sizeof(cpu_addr) || payload.size() != record->size) {
+                LOG_ERROR(HW_GPU, "GPU capture has a malformed memory write");
+                return std::nullopt;
+            }
+            std::memcpy(&cpu_addr, payload.data(), sizeof(cpu_addr));
+            // Written like the guest CPU would, so the caches see the same invalidations
+            system.Memory().WriteBlock(cpu_addr, payload.data() + sizeof(cpu_addr),
+                                       payload.size() - sizeof(cpu_addr));
+            break;
+        }
+        case RecordType::CommandList: {
+            const std::vector<u8> payload = reader.ReadPayload();
+            if (payload.size() != record->size || payload.size() % sizeof(CommandListHeader)) {
+                LOG_ERROR(HW_GPU, "GPU capture has a malformed command list");
+                return std::nullopt;
+            }
+            CommandList entries(payload.size() / sizeof(CommandListHeader));
+            std::memcpy(entries.data(), payload.data(), payload.size());
+            gpu.PushGPUEntries(std::move(entries));
+            break;
+        }
+        case RecordType::SwapBuffers: {
+            SwapBuffersInfo info;
+            if (!reader.ReadPayload(info)) {
+                LOG_ERROR(HW_GPU, "GPU capture has a malformed swap");
+                return std::nullopt;
+            }
+            gpu.SwapBuffers(info.has_framebuffer ? &info.framebuffer : nullptr);
+            ++num_frames;
+            on_frame();
+            break;
+        }
+        default:
+            LOG_ERROR(HW_GPU, "Unknown GPU capture record type {}",
+                      static_cast<u32>(record->type));
+            return std::nullopt;
+        }
+    }
+    return num_frames;
+}
+
+std::vector<std::pair<VAddr, u64>> GetCaptureMemoryRanges(FileSys::VirtualFile file) {
+    std::vector<std::pair<VAddr, u64>> ranges;
+    Reader reader{std::move(file)};
+    while (const std::optional<RecordHeader> record = reader.NextRecord()) {
+        if (record->type != RecordType::MapMemory) {
+            continue;
+        }
+        MemoryMapping mapping;
+        if (reader.ReadPayload(mapping)) {
+            const VAddr start = Common::AlignDown(mapping.cpu_addr, Memory::PAGE_SIZE);
+            const VAddr end = Common::AlignUp(mapping.cpu_addr + mapping.size, Memory::PAGE_SIZE);
+            ranges.emplace_back(start, end - start);
+        }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    // Merge overlapping and adjacent ranges, aliased mappings are common
+    std::vector<std::pair<VAddr, u64>> merged;
+    for (const auto& [start, size] : ranges) {
+        if (!merged.empty() && start <= merged.back().first + merged.back().second) {
+            auto& [last_start, last_size] = merged.back();
+            last_size = std::max(last_size, start + size - last_start);
+        } else {
+            merged.emplace_back(start, size);
+        }
+    }
+    return merged;
+}
+
+} // namespace Tegra::Capture
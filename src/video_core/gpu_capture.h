@@ -0,0 +1,217 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "core/file_sys/vfs_types.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/engines/fermi_2d.h"
+#include "video_core/engines/kepler_compute.h"
+#include "video_core/engines/kepler_memory.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/maxwell_dma.h"
+#include "video_core/gpu.h"
+
+namespace Core {
+class System;
+}
+
+/**
+ * GPU captures record what a guest feeds the GPU over a number of frames, so it can be replayed
+ * later, without the game, to compare the performance of different renderers or builds.
+ *
+ * A capture starts with the state of the puller and of every engine, followed by the GPU memory
+ * mappings and the contents of the mapped guest memory. After that, every command list and swap
+ * is recorded, preceded by the guest memory pages that changed since the previous record.
+ */
+namespace Tegra::Capture {
+
+constexpr u32 MAGIC = Common::MakeMagic('Y', 'G', 'P', 'C');
+
+/// Bumped whenever the layout of a record or of any register block changes.
+constexpr u32 VERSION = 1;
+
+/// File extension used for GPU captures
+constexpr char EXTENSION[] = "ygc";
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+};
+static_assert(sizeof(FileHeader) == 8, "FileHeader has incorrect size");
+
+enum class RecordType : u32 {
+    EngineState, ///< State of the puller and every engine at the start of the capture
+    MapMemory,   ///< A GPU memory mapping, the payload is a MemoryMapping
+    WriteMemory, ///< Guest memory contents, the payload is a CPU address followed by the data
+    CommandList, ///< A command list submitted by the guest, the payload is its entries
+    SwapBuffers, ///< A presented frame, the payload is a SwapBuffersInfo
+};
+
+struct RecordHeader {
+    RecordType type;
+    u32 reserved;
+    u64 size; ///< Size in bytes of the payload that follows
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader has incorrect size");
+
+struct MemoryMapping {
+    GPUVAddr gpu_addr;
+    VAddr cpu_addr;
+    u64 size;
+};
+
+struct SwapBuffersInfo {
+    u32 has_framebuffer;
+    u32 reserved;
+    FramebufferConfig framebuffer;
+};
+
+/// Registers and internal state the engines need to execute command lists from the middle of a
+/// frame stream. The engines are restored from it before replaying a capture.
+struct EngineState {
+    GPU::Regs puller;
+    std::array<EngineID, 8> bound_engines;
+    Engines::Maxwell3D::Regs maxwell_3d;
+    Engines::Maxwell3D::State maxwell_3d_state;
+    Engines::Maxwell3D::MacroPositions macro_positions;
+    Engines::Maxwell3D::MacroMemory macro_memory;
+    Engines::Fermi2D::Regs fermi_2d;
+    Engines::KeplerCompute::Regs kepler_compute;
+    Engines::MaxwellDMA::Regs maxwell_dma;
+    Engines::KeplerMemory::Regs kepler_memory;
+};
+static_assert(std::is_trivially_copyable_v<EngineState>, "EngineState must be trivially copyable");
+
+/// Records the work submitted to a GPU into a capture file. Every method has to be called from the
+/// thread that submits command lists to the GPU.
+class Recorder final {
+public:
+    /**
+     * @param start_frame Number of frames to let through before the capture starts.
+     * @param num_frames  Number of frames to record.
+     */
+    explicit Recorder(Core::System& system, GPU& gpu, u32 start_frame, u32 num_frames);
+    ~Recorder();
+
+    /// Records a command list before it is submitted to the GPU.
+    void OnCommandList(const CommandList& entries);
+
+    /// Records a swap before it is submitted to the GPU.
+    void OnSwapBuffers(const FramebufferConfig* framebuffer);
+
+private:
+    /// Opens the capture file and records the current state of the GPU and of its memory.
+    void Begin();
+
+    /// Closes the capture file.
+    void End();
+
+    /// Records new memory mappings and the guest memory pages that changed since the last call.
+    void SyncMemory();
+
+    /// Records a guest memory range with its current contents.
+    void RecordMemory(VAddr cpu_addr, const u8* data, std::size_t size);
+
+    void WriteRecord(RecordType type, const void* payload, std::size_t size);
+
+    Core::System& system;
+    GPU& gpu;
+
+    const u32 start_frame;
+    const u32 num_frames;
+
+    enum class Status {
+        Waiting,   ///< Letting frames through until the start frame is reached
+        Recording, ///< Recording into the capture file
+        Done,      ///< Finished, or gave up on the capture
+    };
+
+    Status status = Status::Waiting;
+    u32 frames_seen = 0;
+    u32 frames_recorded = 0;
+
+    FileUtil::IOFile file;
+
+    /// Mappings recorded so far, indexed by their GPU address
+    std::map<GPUVAddr, MemoryMapping> mappings;
+
+    /// Hash of the recorded contents of every guest memory page, indexed by the page's address
+    std::unordered_map<VAddr, u64> page_hashes;
+};
+
+/// Reads the records of a capture file one at a time.
+class Reader final {
+public:
+    explicit Reader(FileSys::VirtualFile file);
+    ~Reader();
+
+    /// Returns true when the file starts with a valid capture header.
+    static bool IsValid(const FileSys::VirtualFile& file);
+
+    /// Reads the header of the next record, or returns nothing at the end of the capture.
+    std::optional<RecordHeader> NextRecord();
+
+    /// Reads the payload of the current record.
+    std::vector<u8> ReadPayload();
+
+    /// Reads the payload of the current record into an object of the payload's size.
+    template <typename T>
+    bool ReadPayload(T& object) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        if (current.size != sizeof(T)) {
+            return false;
+        }
+        return ReadPayload(&object, sizeof(T));
+    }
+
+    /// Goes back to the first record of the capture.
+    void Rewind();
+
+private:
+    bool ReadPayload(void* data, std::size_t size);
+
+    FileSys::VirtualFile file;
+    std::size_t offset = 0;
+    RecordHeader current{};
+    bool is_payload_read = true;
+};
+
+/// Replays a capture on a GPU whose guest memory has been laid out by the capture loader.
+class Player final {
+public:
+    explicit Player(Core::System& system, FileSys::VirtualFile file);
+    ~Player();
+
+    /**
+     * Submits the whole capture to the GPU, from its first record.
+     * @param on_frame Called after every swap has been submitted.
+     * @returns Number of frames replayed, or nothing if the capture is malformed.
+     */
+    std::optional<u32> Play(const std::function<void()>& on_frame);
+
+private:
+    Core::System& system;
+    Reader reader;
+    std::unique_ptr<EngineState> engine_state;
+};
+
+/// Returns the CPU memory ranges a capture needs mapped in order to be replayed, merged and
+/// aligned to CPU pages.
+std::vector<std::pair<VAddr, u64>> GetCaptureMemoryRanges(FileSys::VirtualFile file);
+
+} // namespace Tegra::Capture
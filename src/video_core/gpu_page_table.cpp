@@ -0,0 +1,131 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "common/assert.h"
+#include "video_core/gpu_page_table.h"
+
+namespace Tegra {
+
+GPUPageTable::GPUPageTable() : directory(num_directory_entries) {}
+
+GPUPageTable::~GPUPageTable() = default;
+
+GPUPageTable::Range GPUPageTable::GetRange(GPUVAddr addr, u64 size) const {
+    if (!IsAddressValid(addr)) {
+        return {nullptr, 0, size, Common::PageType::Unmapped};
+    }
+
+    const auto get_run = [this](GPUVAddr run_addr) -> Range {
+        const Entry* const entry = GetEntry(run_addr);
+        if (entry == nullptr) {
+            // Nothing was mapped in the whole directory entry
+            const GPUVAddr table_end = ((run_addr >> directory_shift) + 1) << directory_shift;
+            return {nullptr, 0, table_end - run_addr, Common::PageType::Unmapped};
+        }
+        const u64 offset = run_addr & page_mask;
+        return {
+            entry->pointer != nullptr ? entry->pointer + offset : nullptr,
+            entry->backing_addr != 0 ? entry->backing_addr + offset : 0,
+            (static_cast<u64>(entry->run_end) << page_bits) - run_addr,
+            entry->type,
+        };
+    };
+
+    Range range = get_run(addr);
+
+    // Mappings carved next to each other make runs of their own, even when the memory behind them
+    // is contiguous, so join the following runs that continue this one
+    while (range.size < size && IsAddressValid(addr + range.size)) {
+        const Range next = get_run(addr + range.size);
+        const bool is_continuous =
+            next.type == range.type &&
+            next.pointer == (range.pointer != nullptr ? range.pointer + range.size : nullptr) &&
+            next.backing_addr == (range.backing_addr != 0 ? range.backing_addr + range.size : 0);
+        if (!is_continuous) {
+            break;
+        }
+        range.size += next.size;
+    }
+
+    return range;
+}
+
+void GPUPageTable::Map(GPUVAddr base, u64 size, u8* memory, Common::PageType type,
+                       VAddr backing_addr) {
+    ASSERT_MSG((base & page_mask) == 0, "non-page aligned base: {:016X}", base);
+    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: {:016X}", size);
+    ASSERT_MSG(size != 0 && IsAddressValid(base + size - 1), "out of range mapping at {:016X}",
+               base);
+
+    const u32 first_page = static_cast<u32>(base >> page_bits);
+    const u32 end_page = static_cast<u32>((base + size) >> page_bits);
+
+    u32 page = first_page;
+    while (page != end_page) {
+        const u64 directory_index = page >> table_bits;
+        const u32 table_end = static_cast<u32>((directory_index + 1) << table_bits);
+        if (type == Common::PageType::Unmapped &&
+            (directory[directory_index] == nullptr ||
+             (page == table_end - (1U << table_bits) && end_page >= table_end))) {
+            // Don't allocate tables to unmap pages, and drop the ones that get entirely unmapped
+            directory[directory_index].reset();
+            page = std::min(table_end, end_page);
+            continue;
+        }
+
+        Table& table = GetOrCreateTable(directory_index);
+        const u32 chunk_end = std::min(table_end, end_page);
+        for (; page != chunk_end; ++page) {
+            Entry& entry = table[page & table_mask];
+            entry.pointer = memory;
+            entry.backing_addr = backing_addr;
+            entry.run_end = end_page;
+            entry.type = type;
+
+            if (memory != nullptr) {
+                memory += page_size;
+                backing_addr += page_size;
+            }
+        }
+    }
+
+    TruncateRunsBefore(first_page);
+}
+
+GPUPageTable::Table& GPUPageTable::GetOrCreateTable(u64 directory_index) {
+    std::unique_ptr<Table>& table = directory[directory_index];
+    if (table == nullptr) {
+        // Fresh tables are a single unmapped run, like the missing table they replace
+        table = std::make_unique<Table>();
+        const u32 table_end = static_cast<u32>((directory_index + 1) << table_bits);
+        for (Entry& entry : *table) {
+            entry.run_end = table_end;
+        }
+    }
+    return *table;
+}
+
+void GPUPageTable::TruncateRunsBefore(u32 page) {
+    // Runs are contiguous, so walking back from the page finds every run spanning past it.
+    // Runs of unmapped pages can go over missing tables, so those are skipped instead of stopping.
+    u32 current = page;
+    while (current > 0) {
+        const u64 directory_index = (current - 1) >> table_bits;
+        Table* const table = directory[directory_index].get();
+        if (table == nullptr) {
+            current = static_cast<u32>(directory_index << table_bits);
+            continue;
+        }
+        Entry& entry = (*table)[(current - 1) & table_mask];
+        if (entry.run_end <= page) {
+            return;
+        }
+        entry.run_end = page;
+        --current;
+    }
+}
+
+} // namespace Tegra
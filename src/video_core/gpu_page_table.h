@@ -0,0 +1,109 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/page_table.h"
+
+namespace Tegra {
+
+/**
+ * Two level page table translating GPU virtual addresses, laid out like the GMMU does with big
+ * pages: a page directory whose entries cover 64MiB of the 40 bit address space each, pointing to
+ * page tables of 1024 big pages of 64KiB.
+ *
+ * Page tables are only allocated for directory entries that have something mapped, so the table
+ * stays small no matter how sparse the address space is. Every page also records where the run of
+ * pages mapped along with it ends, so a whole contiguous block is resolved with a single lookup
+ * instead of one per page.
+ */
+class GPUPageTable final {
+public:
+    static constexpr u32 page_bits{16};
+    static constexpr u64 page_size{1ULL << page_bits};
+    static constexpr u64 page_mask{page_size - 1};
+
+    /// Bits of the address space, according to Tegra X1 TRM
+    static constexpr u32 address_space_width{40};
+
+    struct Entry {
+        /// Host memory backing the page, only set for Memory pages
+        u8* pointer{};
+        /// CPU address backing the page
+        VAddr backing_addr{};
+        /// Page index the contiguous run of pages this one belongs to ends at
+        u32 run_end{};
+        Common::PageType type{Common::PageType::Unmapped};
+    };
+
+    /// Contiguous range of pages of the same type, backed by contiguous memory
+    struct Range {
+        /// Host memory backing the start of the range, null when it isn't backed
+        u8* pointer{};
+        /// CPU address backing the start of the range, zero when it isn't backed
+        VAddr backing_addr{};
+        /// Size in bytes of the range
+        u64 size{};
+        Common::PageType type{Common::PageType::Unmapped};
+    };
+
+    GPUPageTable();
+    ~GPUPageTable();
+
+    /// Returns true if addr is inside the address space
+    static constexpr bool IsAddressValid(GPUVAddr addr) {
+        return (addr >> address_space_width) == 0;
+    }
+
+    /// Returns the entry of the page addr is in, null when nothing was mapped around it
+    const Entry* GetEntry(GPUVAddr addr) const {
+        if (!IsAddressValid(addr)) {
+            return nullptr;
+        }
+        const Table* const table = directory[addr >> directory_shift].get();
+        if (table == nullptr) {
+            return nullptr;
+        }
+        return &(*table)[(addr >> page_bits) & table_mask];
+    }
+
+    /**
+     * Returns the contiguous range starting at addr. Following runs that continue it are joined
+     * until the range covers size bytes, so it can be shorter or longer than size.
+     */
+    Range GetRange(GPUVAddr addr, u64 size) const;
+
+    /**
+     * Maps a range of pages.
+     * @param base         Page aligned GPU address the range starts at
+     * @param size         Page aligned size in bytes of the range
+     * @param memory       Host memory backing the range, or null so every page has no pointer
+     * @param backing_addr CPU address backing the range, kept the same for every page when memory
+     *                     is null
+     */
+    void Map(GPUVAddr base, u64 size, u8* memory, Common::PageType type, VAddr backing_addr);
+
+private:
+    static constexpr u32 table_bits{10};
+    static constexpr u64 table_mask{(1ULL << table_bits) - 1};
+    static constexpr u32 directory_shift{page_bits + table_bits};
+    static constexpr u64 num_directory_entries{1ULL << (address_space_width - directory_shift)};
+
+    using Table = std::array<Entry, 1ULL << table_bits>;
+
+    /// Returns the page table of a directory entry, allocating it when it doesn't exist
+    Table& GetOrCreateTable(u64 directory_index);
+
+    /// Ends the runs of the pages before the given one, so none of them spans past it
+    void TruncateRunsBefore(u32 page);
+
+    std::vector<std::unique_ptr<Table>> directory;
+};
+
+} // namespace Tegra
@@ -15,11 +15,13 @@ GPUSynch::~GPUSynch() = default;
 void GPUSynch::Start() {}
 
 void GPUSynch::PushGPUEntries(Tegra::CommandList&& entries) {
-    dma_pusher->Push(std::move(entries));
+    RecordCommandList(entries);
+    dma_pusher->Push(dma_pusher->Decode(entries));
     dma_pusher->DispatchCalls();
 }
 
 void GPUSynch::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    RecordSwapBuffers(framebuffer);
     renderer.SwapBuffers(framebuffer);
 }
 
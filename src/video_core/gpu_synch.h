@@ -24,7 +24,25 @@ public:
     void FlushRegion(CacheAddr addr, u64 size) override;
     void InvalidateRegion(CacheAddr addr, u64 size) override;
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size) override;
-    void WaitIdle() const override {}
+    void WaitIdle() override {}
+    void KickoffCommands() override {}
+    std::size_t GetPeakCommandQueueDepth() const override {
+        return 0;
+    }
+
+    bool IsSwapPending() const override {
+        return false;
+    }
+
+    u64 GetLastSwapFence() const override {
+        return 0;
+    }
+
+    bool IsSwapPresented([[maybe_unused]] u64 swap_fence) const override {
+        return true;
+    }
+
+    void MarkRegionWritten([[maybe_unused]] CacheAddr addr, [[maybe_unused]] u64 size) override {}
 
 protected:
     void TriggerCpuInterrupt([[maybe_unused]] u32 syncpoint_id,
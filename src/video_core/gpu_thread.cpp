@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "core/core.h"
@@ -12,15 +14,97 @@
 #include "video_core/renderer_base.h"
 
 namespace VideoCommon::GPUThread {
+namespace {
+static_assert((CommandQueue::Capacity & (CommandQueue::Capacity - 1)) == 0,
+              "CommandQueue capacity must be a power of two");
+
+/// Number of times the consumer polls an empty queue before parking.
+constexpr std::size_t SpinCount = 2048;
+
+/// Longest a parked consumer sleeps before looking for deferred commands by itself.
+constexpr auto ParkTimeout = std::chrono::milliseconds{1};
+
+/// Number of deferred commands that wake the consumer up without waiting for an urgent one.
+constexpr std::size_t DeferredWakeThreshold = CommandQueue::Capacity / 8;
+} // Anonymous namespace
+
+CommandQueue::CommandQueue() : slots{std::make_unique<CommandDataContainer[]>(Capacity)} {}
+
+CommandQueue::~CommandQueue() = default;
+
+void CommandQueue::Push(CommandDataContainer&& command, bool urgent) {
+    const std::size_t write_index = head.load(std::memory_order_relaxed);
+    while (write_index - tail.load(std::memory_order_acquire) == Capacity) {
+        // The ring is full, make sure the consumer is draining it and wait for a free slot.
+        WakeConsumer();
+        std::this_thread::yield();
+    }
+
+    slots[write_index & (Capacity - 1)] = std::move(command);
+    head.store(write_index + 1, std::memory_order_seq_cst);
+
+    const std::size_t size = Size();
+    if (size > peak_size.load(std::memory_order_relaxed)) {
+        peak_size.store(size, std::memory_order_relaxed);
+    }
+
+    if (urgent || size >= DeferredWakeThreshold) {
+        WakeConsumer();
+    }
+}
+
+void CommandQueue::Kick() {
+    if (!Empty()) {
+        WakeConsumer();
+    }
+}
+
+void CommandQueue::Wait() {
+    for (std::size_t spin = 0; spin < SpinCount; ++spin) {
+        if (!Empty()) {
+            return;
+        }
+    }
+
+    std::unique_lock lock{park_mutex};
+    consumer_parked.store(true, std::memory_order_seq_cst);
+    while (Empty()) {
+        // Deferred pushes don't wake us up, so don't sleep on them forever.
+        park_cv.wait_for(lock, ParkTimeout);
+    }
+    consumer_parked.store(false, std::memory_order_relaxed);
+}
+
+CommandDataContainer CommandQueue::PopWait() {
+    Wait();
+
+    const std::size_t read_index = tail.load(std::memory_order_relaxed);
+    CommandDataContainer command = std::move(slots[read_index & (Capacity - 1)]);
+    tail.store(read_index + 1, std::memory_order_release);
+    return command;
+}
+
+void CommandQueue::WakeConsumer() {
+    // Pairs with the store in Wait: either the consumer sees the new head before sleeping, or we
+    // see it parked and notify it under the lock so the wakeup can't be lost.
+    if (!consumer_parked.load(std::memory_order_seq_cst)) {
+        return;
+    }
+    {
+        std::lock_guard lock{park_mutex};
+    }
+    park_cv.notify_one();
+}
 
 /// Runs the GPU thread
-static void RunThread(VideoCore::RendererBase& renderer, Tegra::DmaPusher& dma_pusher,
-                      SynchState& state) {
+static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
+                      Tegra::DmaPusher& dma_pusher, SynchState& state) {
     MicroProfileOnThreadCreate("GpuThread");
+    Common::Trace::SetCurrentThreadName("GpuThread");
+    Core::System::SetCurrentInstance(system);
 
     // Wait for first GPU command before acquiring the window context
-    while (state.queue.Empty())
-        ;
+    state.queue.Wait();
 
     // If emulation was stopped during disk shader loading, abort before trying to acquire context
     if (!state.is_running) {
@@ -33,12 +117,23 @@ static void RunThread(VideoCore::RendererBase& renderer, Tegra::DmaPusher& dma_p
     while (state.is_running) {
         next = state.queue.PopWait();
         if (const auto submit_list = std::get_if<SubmitListCommand>(&next.data)) {
-            dma_pusher.Push(std::move(submit_list->entries));
+            dma_pusher.Push(std::move(submit_list->stream));
             dma_pusher.DispatchCalls();
+            // Guests wait for the syncpoints signaled in the list, don't leave them pending
+            renderer.Rasterizer().ReleaseFences();
         } else if (const auto data = std::get_if<SwapBuffersCommand>(&next.data)) {
-            renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
+            // Mailbox semantics: when the guest has already queued a newer frame, this one would
+            // be replaced before it could reach the screen, so don't spend a blit and a present
+            // (and possibly a vsync wait) on it. Per frame bookkeeping still has to run.
+            if (state.pending_swaps.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+                renderer.Rasterizer().TickFrame();
+            } else {
+                renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
+            }
         } else if (const auto data = std::get_if<FlushRegionCommand>(&next.data)) {
             renderer.Rasterizer().FlushRegion(data->addr, data->size);
+            // Every modified object touching these pages has been written back
+            state.write_back_tracker.Clear(data->addr, data->size);
         } else if (const auto data = std::get_if<InvalidateRegionCommand>(&next.data)) {
             renderer.Rasterizer().InvalidateRegion(data->addr, data->size);
         } else if (std::holds_alternative<EndProcessingCommand>(next.data)) {
@@ -63,19 +158,41 @@ ThreadManager::~ThreadManager() {
 }
 
 void ThreadManager::StartThread(VideoCore::RendererBase& renderer, Tegra::DmaPusher& dma_pusher) {
-    thread = std::thread{RunThread, std::ref(renderer), std::ref(dma_pusher), std::ref(state)};
+    thread = std::thread{RunThread, std::ref(system), std::ref(renderer), std::ref(dma_pusher),
+                         std::ref(state)};
 }
 
-void ThreadManager::SubmitList(Tegra::CommandList&& entries) {
-    PushCommand(SubmitListCommand(std::move(entries)));
+void ThreadManager::SubmitList(Tegra::MethodStream&& stream) {
+    // Command lists are handed over in batches, the next swap or sync wait kicks them off.
+    PushCommand(SubmitListCommand(std::move(stream)), false);
 }
 
 void ThreadManager::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
-    PushCommand(SwapBuffersCommand(framebuffer ? std::make_optional(*framebuffer) : std::nullopt));
+    state.pending_swaps.fetch_add(1, std::memory_order_acq_rel);
+    auto config = framebuffer ? std::make_optional(*framebuffer) : std::nullopt;
+    last_swap_fence = PushCommand(SwapBuffersCommand(std::move(config)));
+}
+
+bool ThreadManager::IsSwapPending() const {
+    return !IsFenceSignaled(last_swap_fence);
+}
+
+bool ThreadManager::IsFenceSignaled(u64 fence) const {
+    return state.signaled_fence.load() >= fence;
 }
 
 void ThreadManager::FlushRegion(CacheAddr addr, u64 size) {
-    PushCommand(FlushRegionCommand(addr, size));
+    if (!state.write_back_tracker.IsWritten(addr, size)) {
+        return;
+    }
+    // Flush whole pages, so the tracker can forget them once the flush is done
+    constexpr u64 page_mask = WriteBackTracker::PageSize - 1;
+    const CacheAddr start = addr & ~page_mask;
+    const CacheAddr end = (addr + size + page_mask) & ~page_mask;
+    const u64 fence = PushCommand(FlushRegionCommand(start, end - start));
+    while (!IsFenceSignaled(fence)) {
+        std::this_thread::yield();
+    }
 }
 
 void ThreadManager::InvalidateRegion(CacheAddr addr, u64 size) {
@@ -87,14 +204,19 @@ void ThreadManager::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
     InvalidateRegion(addr, size);
 }
 
-void ThreadManager::WaitIdle() const {
+void ThreadManager::KickoffCommands() {
+    state.queue.Kick();
+}
+
+void ThreadManager::WaitIdle() {
+    KickoffCommands();
     while (state.last_fence > state.signaled_fence.load(std::memory_order_relaxed)) {
     }
 }
 
-u64 ThreadManager::PushCommand(CommandData&& command_data) {
+u64 ThreadManager::PushCommand(CommandData&& command_data, bool urgent) {
     const u64 fence{++state.last_fence};
-    state.queue.Push(CommandDataContainer(std::move(command_data), fence));
+    state.queue.Push(CommandDataContainer(std::move(command_data), fence), urgent);
     return fence;
 }
 
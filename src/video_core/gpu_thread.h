@@ -6,13 +6,15 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
 #include <variant>
 
-#include "common/threadsafe_queue.h"
 #include "video_core/gpu.h"
+#include "video_core/write_back_tracker.h"
 
 namespace Tegra {
 struct FramebufferConfig;
@@ -30,9 +32,9 @@ struct EndProcessingCommand final {};
 
 /// Command to signal to the GPU thread that a command list is ready for processing
 struct SubmitListCommand final {
-    explicit SubmitListCommand(Tegra::CommandList&& entries) : entries{std::move(entries)} {}
+    explicit SubmitListCommand(Tegra::MethodStream&& stream) : stream{std::move(stream)} {}
 
-    Tegra::CommandList entries;
+    Tegra::MethodStream stream;
 };
 
 /// Command to signal to the GPU thread that a swap buffers is pending
@@ -82,14 +84,91 @@ struct CommandDataContainer {
     u64 fence{};
 };
 
+/**
+ * Fixed-capacity single producer, single consumer ring of command slots.
+ *
+ * Slots are allocated once up front, so pushing a command never touches the heap. The consumer
+ * spins for a short while before parking on a condition variable, and the producer only pays for a
+ * wakeup when the consumer is actually parked. Pushes that don't need to be seen right away can
+ * defer that wakeup, so a burst of command lists is handed over in one go at the next urgent
+ * command (a swap, a flush or a sync wait) or when the backlog grows large enough.
+ */
+class CommandQueue final {
+public:
+    /// Number of command slots in the ring, must be a power of two.
+    static constexpr std::size_t Capacity = 1024;
+
+    CommandQueue();
+    ~CommandQueue();
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    CommandQueue(CommandQueue&&) = delete;
+    CommandQueue& operator=(CommandQueue&&) = delete;
+
+    /// Returns the number of commands waiting to be processed.
+    std::size_t Size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    /// Returns the largest number of commands that were ever waiting at once.
+    std::size_t PeakSize() const {
+        return peak_size.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Moves a command into the next free slot, waiting for the consumer if the ring is full.
+     * @param command Command to push.
+     * @param urgent  Whether a parked consumer has to be woken up right away.
+     */
+    void Push(CommandDataContainer&& command, bool urgent);
+
+    /// Wakes the consumer up if it is parked and commands are waiting. Called by the producer.
+    void Kick();
+
+    /// Blocks until a command is available. Called by the consumer.
+    void Wait();
+
+    /// Waits for the next command and moves it out of its slot. Called by the consumer.
+    CommandDataContainer PopWait();
+
+private:
+    /// Wakes the consumer up if it is parked.
+    void WakeConsumer();
+
+    std::unique_ptr<CommandDataContainer[]> slots;
+
+    /// Index of the next slot to write, only modified by the producer.
+    std::atomic_size_t head{0};
+
+    /// Index of the next slot to read, only modified by the consumer.
+    std::atomic_size_t tail{0};
+
+    std::atomic_size_t peak_size{0};
+
+    std::atomic_bool consumer_parked{false};
+    std::mutex park_mutex;
+    std::condition_variable park_cv;
+};
+
 /// Struct used to synchronize the GPU thread
 struct SynchState final {
     std::atomic_bool is_running{true};
 
-    using CommandQueue = Common::SPSCQueue<CommandDataContainer>;
     CommandQueue queue;
     u64 last_fence{};
     std::atomic<u64> signaled_fence{};
+
+    /// Number of swaps pushed to the queue that the GPU thread hasn't processed yet
+    std::atomic_size_t pending_swaps{0};
+
+    /// Pages written by the GPU thread that the CPU must flush before reading
+    WriteBackTracker write_back_tracker;
 };
 
 /// Class used to manage the GPU thread
@@ -101,30 +180,56 @@ public:
     /// Creates and starts the GPU thread.
     void StartThread(VideoCore::RendererBase& renderer, Tegra::DmaPusher& dma_pusher);
 
-    /// Push GPU command entries to be processed
-    void SubmitList(Tegra::CommandList&& entries);
+    /// Push decoded GPU command entries to be processed
+    void SubmitList(Tegra::MethodStream&& stream);
 
     /// Swap buffers (render frame)
     void SwapBuffers(const Tegra::FramebufferConfig* framebuffer);
 
-    /// Notify rasterizer that any caches of the specified region should be flushed to Switch memory
+    /// Flushes the pages of the specified region the GPU has written to Switch memory, waiting for
+    /// the GPU thread to do so. Regions the GPU hasn't written since they were flushed are skipped.
     void FlushRegion(CacheAddr addr, u64 size);
 
+    /// Records that the GPU thread wrote the specified region
+    void MarkRegionWritten(CacheAddr addr, u64 size) {
+        state.write_back_tracker.MarkWritten(addr, size);
+    }
+
     /// Notify rasterizer that any caches of the specified region should be invalidated
     void InvalidateRegion(CacheAddr addr, u64 size);
 
     /// Notify rasterizer that any caches of the specified region should be flushed and invalidated
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size);
 
+    /// Makes sure the GPU thread starts working on any command lists queued so far
+    void KickoffCommands();
+
     // Wait until the gpu thread is idle.
-    void WaitIdle() const;
+    void WaitIdle();
+
+    /// Returns the largest number of commands that were ever waiting for the GPU thread
+    std::size_t GetPeakQueueDepth() const {
+        return state.queue.PeakSize();
+    }
+
+    /// Returns true while the GPU thread hasn't presented the last swap pushed to it
+    bool IsSwapPending() const;
+
+    /// Returns the fence of the last swap pushed to the GPU thread
+    u64 GetLastSwapFence() const {
+        return last_swap_fence;
+    }
+
+    /// Returns true once the GPU thread has processed the command identified by the fence
+    bool IsFenceSignaled(u64 fence) const;
 
 private:
     /// Pushes a command to be executed by the GPU thread
-    u64 PushCommand(CommandData&& command_data);
+    u64 PushCommand(CommandData&& command_data, bool urgent = true);
 
 private:
     SynchState state;
+    u64 last_swap_fence{};
     Core::System& system;
     std::thread thread;
     std::thread::id thread_id;
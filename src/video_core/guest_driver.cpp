@@ -33,4 +33,26 @@ void GuestDriverProfile::DeduceTextureHandlerSize(std::vector<u32>&& bound_offse
     texture_handler_size = min_texture_handler_size * min_val;
 }
 
+void GuestDriverProfile::SetTextureHandlerSize(u32 size) {
+    texture_handler_size_deduced = true;
+    texture_handler_size = size;
+}
+
+std::size_t GuestDriverProfile::RegisterBindlessSampler(const BindlessSamplerKey& key) {
+    const auto [it, is_new] = bindless_sampler_slots.emplace(key, bindless_samplers.size());
+    if (is_new) {
+        bindless_samplers.push_back(key);
+    }
+    return it->second;
+}
+
+std::optional<std::size_t> GuestDriverProfile::FindBindlessSampler(
+    const BindlessSamplerKey& key) const {
+    const auto it = bindless_sampler_slots.find(key);
+    if (it == bindless_sampler_slots.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
 } // namespace VideoCore
@@ -4,12 +4,34 @@
 
 #pragma once
 
+#include <map>
+#include <optional>
+#include <tuple>
 #include <vector>
 
 #include "common/common_types.h"
 
 namespace VideoCore {
 
+/// Const buffer location a shader reads a bindless texture handle from.
+struct BindlessSamplerKey {
+    u32 stage{};
+    u32 buffer{};
+    u32 offset{};
+
+    bool operator==(const BindlessSamplerKey& rhs) const {
+        return std::tie(stage, buffer, offset) == std::tie(rhs.stage, rhs.buffer, rhs.offset);
+    }
+
+    bool operator!=(const BindlessSamplerKey& rhs) const {
+        return !operator==(rhs);
+    }
+
+    bool operator<(const BindlessSamplerKey& rhs) const {
+        return std::tie(stage, buffer, offset) < std::tie(rhs.stage, rhs.buffer, rhs.offset);
+    }
+};
+
 /**
  * The GuestDriverProfile class is used to learn about the GPU drivers behavior and collect
  * information necessary for impossible to avoid HLE methods like shader tracks as they are
@@ -27,6 +49,21 @@ public:
         return texture_handler_size_deduced;
     }
 
+    /// Restores a texture handler size deduced in a previous session.
+    void SetTextureHandlerSize(u32 size);
+
+    /// Registers a bindless handle location sampled by the title and returns its slot. Slots are
+    /// dense and stable, registering a known location returns its existing slot.
+    std::size_t RegisterBindlessSampler(const BindlessSamplerKey& key);
+
+    /// Returns the slot of a registered bindless handle location.
+    std::optional<std::size_t> FindBindlessSampler(const BindlessSamplerKey& key) const;
+
+    /// Returns the registered bindless handle locations, indexed by slot.
+    const std::vector<BindlessSamplerKey>& GetBindlessSamplers() const {
+        return bindless_samplers;
+    }
+
 private:
     // Minimum size of texture handler any driver can use.
     static constexpr u32 min_texture_handler_size = 4;
@@ -36,6 +73,9 @@ private:
 
     u32 texture_handler_size = default_texture_handler_size;
     bool texture_handler_size_deduced = false;
+
+    std::map<BindlessSamplerKey, std::size_t> bindless_sampler_slots;
+    std::vector<BindlessSamplerKey> bindless_samplers;
 };
 
 } // namespace VideoCore
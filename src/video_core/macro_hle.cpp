@@ -0,0 +1,28 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+
+#include "video_core/macro_hle.h"
+
+namespace Tegra {
+namespace {
+struct HLEMacro {
+    u64 hash;
+    HLEMacroFunction function;
+};
+
+// Macros are only added here once their hash has been taken from the macro compiler's debug log
+// and the native implementation has been checked against the interpreter on the titles using it.
+constexpr std::array<HLEMacro, 0> hle_macros{};
+} // Anonymous namespace
+
+HLEMacroFunction GetHLEMacroFunction(u64 hash) {
+    const auto it = std::find_if(hle_macros.begin(), hle_macros.end(),
+                                 [hash](const HLEMacro& macro) { return macro.hash == hash; });
+    return it != hle_macros.end() ? it->function : nullptr;
+}
+
+} // namespace Tegra
@@ -0,0 +1,28 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/common_types.h"
+
+namespace Tegra {
+
+namespace Engines {
+class Maxwell3D;
+}
+
+/// Native implementation of a known macro, called with the parameters the macro would have read.
+using HLEMacroFunction = void (*)(Engines::Maxwell3D& maxwell3d, const u32* parameters,
+                                  std::size_t num_parameters);
+
+/**
+ * Returns the native implementation of the macro with the given code hash, or null when the macro
+ * has to be executed. The hash is the one computed by the macro compiler over the code from the
+ * entry point to the final exit and its delay slot.
+ */
+HLEMacroFunction GetHLEMacroFunction(u64 hash);
+
+} // namespace Tegra
@@ -2,10 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <vector>
+
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "core/settings.h"
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro_hle.h"
 #include "video_core/macro_interpreter.h"
 
 MICROPROFILE_DEFINE(MacroInterp, "GPU", "Execute macro interpreter", MP_RGB(128, 128, 192));
@@ -83,10 +89,55 @@ union MacroInterpreter::Opcode {
     }
 };
 
+struct MacroInterpreter::Instruction {
+    explicit Instruction(Opcode opcode)
+        : raw{opcode.raw}, operation{opcode.operation}, result_operation{opcode.result_operation},
+          branch_condition{opcode.branch_condition}, alu_operation{opcode.alu_operation},
+          dst{opcode.dst}, src_a{opcode.src_a}, src_b{opcode.src_b}, immediate{opcode.immediate},
+          bf_src_bit{opcode.bf_src_bit}, bf_dst_bit{opcode.bf_dst_bit},
+          bitfield_mask{opcode.GetBitfieldMask()}, branch_target{opcode.GetBranchTarget()},
+          branch_annul{opcode.branch_annul != 0}, is_exit{opcode.is_exit != 0} {}
+
+    u32 raw;
+    Operation operation;
+    ResultOperation result_operation;
+    BranchCondition branch_condition;
+    ALUOperation alu_operation;
+    u32 dst;
+    u32 src_a;
+    u32 src_b;
+    s32 immediate;
+    u32 bf_src_bit;
+    u32 bf_dst_bit;
+    u32 bitfield_mask;
+    s32 branch_target;
+    bool branch_annul;
+    bool is_exit;
+};
+
+struct MacroInterpreter::CompiledMacro {
+    std::vector<Instruction> instructions;
+    u64 hash;
+    /// Native replacement for the macro, if it is a known one.
+    HLEMacroFunction hle_function;
+};
+
 MacroInterpreter::MacroInterpreter(Engines::Maxwell3D& maxwell3d) : maxwell3d(maxwell3d) {}
 
+MacroInterpreter::~MacroInterpreter() = default;
+
 void MacroInterpreter::Execute(u32 offset, std::size_t num_parameters, const u32* parameters) {
     MICROPROFILE_SCOPE(MacroInterp);
+
+    if (!Settings::values.disable_macro_compiler) {
+        const CompiledMacro& macro = GetCompiledMacro(offset);
+        if (macro.hle_function != nullptr && !Settings::values.validate_macro_compiler) {
+            macro.hle_function(maxwell3d, parameters, num_parameters);
+            return;
+        }
+        current_macro = &macro;
+    }
+
     Reset();
 
     registers[1] = parameters[0];
@@ -103,11 +154,18 @@ void MacroInterpreter::Execute(u32 offset, std::size_t num_parameters, const u32
     while (keep_executing) {
         keep_executing = Step(offset, false);
     }
+    current_macro = nullptr;
 
     // Assert the the macro used all the input parameters
     ASSERT(next_parameter_index == num_parameters);
 }
 
+void MacroInterpreter::InvalidateEntries() {
+    if (!macro_entries.empty()) {
+        macro_entries.clear();
+    }
+}
+
 void MacroInterpreter::Reset() {
     registers = {};
     pc = 0;
@@ -123,7 +181,7 @@ void MacroInterpreter::Reset() {
 bool MacroInterpreter::Step(u32 offset, bool is_delay_slot) {
     u32 base_address = pc;
 
-    Opcode opcode = GetOpcode(offset);
+    const Instruction opcode = FetchInstruction(offset);
     pc += 4;
 
     // Update the program counter if we were delayed
@@ -149,8 +207,8 @@ bool MacroInterpreter::Step(u32 offset, bool is_delay_slot) {
         u32 dst = GetRegister(opcode.src_a);
         u32 src = GetRegister(opcode.src_b);
 
-        src = (src >> opcode.bf_src_bit) & opcode.GetBitfieldMask();
-        dst &= ~(opcode.GetBitfieldMask() << opcode.bf_dst_bit);
+        src = (src >> opcode.bf_src_bit) & opcode.bitfield_mask;
+        dst &= ~(opcode.bitfield_mask << opcode.bf_dst_bit);
         dst |= src << opcode.bf_dst_bit;
         ProcessResult(opcode.result_operation, opcode.dst, dst);
         break;
@@ -159,7 +217,7 @@ bool MacroInterpreter::Step(u32 offset, bool is_delay_slot) {
         u32 dst = GetRegister(opcode.src_a);
         u32 src = GetRegister(opcode.src_b);
 
-        u32 result = ((src >> dst) & opcode.GetBitfieldMask()) << opcode.bf_dst_bit;
+        u32 result = ((src >> dst) & opcode.bitfield_mask) << opcode.bf_dst_bit;
 
         ProcessResult(opcode.result_operation, opcode.dst, result);
         break;
@@ -168,7 +226,7 @@ bool MacroInterpreter::Step(u32 offset, bool is_delay_slot) {
         u32 dst = GetRegister(opcode.src_a);
         u32 src = GetRegister(opcode.src_b);
 
-        u32 result = ((src >> opcode.bf_src_bit) & opcode.GetBitfieldMask()) << dst;
+        u32 result = ((src >> opcode.bf_src_bit) & opcode.bitfield_mask) << dst;
 
         ProcessResult(opcode.result_operation, opcode.dst, result);
         break;
@@ -185,11 +243,11 @@ bool MacroInterpreter::Step(u32 offset, bool is_delay_slot) {
         if (taken) {
             // Ignore the delay slot if the branch has the annul bit.
             if (opcode.branch_annul) {
-                pc = base_address + opcode.GetBranchTarget();
+                pc = base_address + opcode.branch_target;
                 return true;
             }
 
-            delayed_pc = base_address + opcode.GetBranchTarget();
+            delayed_pc = base_address + opcode.branch_target;
             // Execute one more instruction due to the delay slot.
             return Step(offset, true);
         }
@@ -197,7 +255,7 @@ bool MacroInterpreter::Step(u32 offset, bool is_delay_slot) {
     }
     default:
         UNIMPLEMENTED_MSG("Unimplemented macro operation {}",
-                          static_cast<u32>(opcode.operation.Value()));
+                          static_cast<u32>(opcode.operation));
     }
 
     // An instruction with the Exit flag will not actually
@@ -218,6 +276,75 @@ MacroInterpreter::Opcode MacroInterpreter::GetOpcode(u32 offset) const {
     return {macro_memory[offset + pc / sizeof(u32)]};
 }
 
+MacroInterpreter::Instruction MacroInterpreter::FetchInstruction(u32 offset) const {
+    const std::size_t index = pc / sizeof(u32);
+    if (current_macro == nullptr || index >= current_macro->instructions.size()) {
+        // Code the compiler didn't pick up runs straight from the macro memory.
+        return Instruction{GetOpcode(offset)};
+    }
+
+    const Instruction& instruction = current_macro->instructions[index];
+    if (Settings::values.validate_macro_compiler) {
+        ASSERT_MSG(instruction.raw == GetOpcode(offset).raw,
+                   "Compiled macro at offset {} is out of date", offset);
+    }
+    return instruction;
+}
+
+const MacroInterpreter::CompiledMacro& MacroInterpreter::GetCompiledMacro(u32 offset) {
+    if (const auto it = macro_entries.find(offset); it != macro_entries.end()) {
+        return *it->second;
+    }
+
+    const auto& macro_memory{maxwell3d.GetMacroMemory()};
+    ASSERT(offset < macro_memory.size());
+
+    // The macro ends at the first exit that no branch jumps past, plus the exit's delay slot.
+    std::size_t end = macro_memory.size();
+    s64 furthest_target = offset;
+    for (std::size_t position = offset; position < macro_memory.size(); ++position) {
+        const Opcode opcode{macro_memory[position]};
+        if (opcode.operation == Operation::Branch) {
+            furthest_target = std::max<s64>(furthest_target, static_cast<s64>(position) +
+                                                                 opcode.immediate);
+        }
+        if (opcode.is_exit && static_cast<s64>(position) >= furthest_target) {
+            end = std::min(position + 2, macro_memory.size());
+            break;
+        }
+    }
+
+    const u32* const code = macro_memory.data() + offset;
+    const std::size_t size = end - offset;
+    const u64 hash = Common::HashValue(code, size * sizeof(u32));
+
+    auto& compiled = compiled_macros[hash];
+    const auto matches = [code, size](const CompiledMacro& macro) {
+        return std::equal(code, code + size, macro.instructions.begin(), macro.instructions.end(),
+                          [](u32 raw, const Instruction& instruction) {
+                              return raw == instruction.raw;
+                          });
+    };
+    if (!compiled || !matches(*compiled)) {
+        if (compiled) {
+            // Hash collision, entries pointing to the old macro are about to dangle.
+            macro_entries.clear();
+        }
+        compiled = std::make_unique<CompiledMacro>();
+        compiled->instructions.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            compiled->instructions.emplace_back(Opcode{code[i]});
+        }
+        compiled->hash = hash;
+        compiled->hle_function = GetHLEMacroFunction(hash);
+        LOG_DEBUG(HW_GPU, "Compiled macro at offset {:#x}, {} instructions, hash {:016X}{}", offset,
+                  size, hash, compiled->hle_function != nullptr ? " (HLE)" : "");
+    }
+
+    macro_entries.emplace(offset, compiled.get());
+    return *compiled;
+}
+
 u32 MacroInterpreter::GetALUResult(ALUOperation operation, u32 src_a, u32 src_b) {
     switch (operation) {
     case ALUOperation::Add: {
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 
 #include "common/bit_field.h"
 #include "common/common_types.h"
@@ -18,6 +20,7 @@ class Maxwell3D;
 class MacroInterpreter final {
 public:
     explicit MacroInterpreter(Engines::Maxwell3D& maxwell3d);
+    ~MacroInterpreter();
 
     /**
      * Executes the macro code with the specified input parameters.
@@ -26,6 +29,9 @@ public:
      */
     void Execute(u32 offset, std::size_t num_parameters, const u32* parameters);
 
+    /// Drops the macro entry points, must be called whenever the macro memory is written.
+    void InvalidateEntries();
+
 private:
     enum class ALUOperation : u32;
     enum class BranchCondition : u32;
@@ -33,6 +39,12 @@ private:
 
     union Opcode;
 
+    /// Predecoded macro instruction.
+    struct Instruction;
+
+    /// Macro code decoded once into instructions, shared by all entry points with the same code.
+    struct CompiledMacro;
+
     union MethodAddress {
         u32 raw;
         BitField<0, 12, u32> address;
@@ -64,6 +76,13 @@ private:
     /// Reads an opcode at the current program counter location.
     Opcode GetOpcode(u32 offset) const;
 
+    /// Returns the instruction at the current program counter location, taking it from the
+    /// compiled macro when there is one.
+    Instruction FetchInstruction(u32 offset) const;
+
+    /// Returns the compiled macro starting at the given offset, compiling it when necessary.
+    const CompiledMacro& GetCompiledMacro(u32 offset);
+
     /// Returns the specified register's value. Register 0 is hardcoded to always return 0.
     u32 GetRegister(u32 register_id) const;
 
@@ -105,5 +124,14 @@ private:
     u32 next_parameter_index = 0;
 
     bool carry_flag = false;
+
+    /// Compiled macro being executed, null when running from the macro memory.
+    const CompiledMacro* current_macro = nullptr;
+
+    /// Compiled macros, keyed by the hash of their code.
+    std::unordered_map<u64, std::unique_ptr<CompiledMacro>> compiled_macros;
+
+    /// Compiled macros, keyed by the macro memory offset they start at.
+    std::unordered_map<u32, const CompiledMacro*> macro_entries;
 };
 } // namespace Tegra
@@ -16,11 +16,6 @@ namespace Tegra {
 
 MemoryManager::MemoryManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer)
     : rasterizer{rasterizer}, system{system} {
-    std::fill(page_table.pointers.begin(), page_table.pointers.end(), nullptr);
-    std::fill(page_table.attributes.begin(), page_table.attributes.end(),
-              Common::PageType::Unmapped);
-    page_table.Resize(address_space_width);
-
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
     initial_vma.size = address_space_end;
@@ -76,6 +71,22 @@ GPUVAddr MemoryManager::MapBufferEx(VAddr cpu_addr, GPUVAddr gpu_addr, u64 size)
     return gpu_addr;
 }
 
+void MemoryManager::MapBuffersEx(const std::vector<MapEntry>& entries) {
+    auto it = entries.begin();
+    while (it != entries.end()) {
+        const VAddr cpu_addr{it->cpu_addr};
+        const GPUVAddr gpu_addr{it->gpu_addr};
+        u64 size{Common::AlignUp(it->size, page_size)};
+        for (++it; it != entries.end(); ++it) {
+            if (it->cpu_addr != cpu_addr + size || it->gpu_addr != gpu_addr + size) {
+                break;
+            }
+            size += Common::AlignUp(it->size, page_size);
+        }
+        MapBufferEx(cpu_addr, gpu_addr, size);
+    }
+}
+
 GPUVAddr MemoryManager::UnmapBuffer(GPUVAddr gpu_addr, u64 size) {
     ASSERT((gpu_addr & page_mask) == 0);
 
@@ -115,7 +126,7 @@ GPUVAddr MemoryManager::FindFreeRegion(GPUVAddr region_start, u64 size) const {
 }
 
 bool MemoryManager::IsAddressValid(GPUVAddr addr) const {
-    return (addr >> page_bits) < page_table.pointers.size();
+    return GPUPageTable::IsAddressValid(addr);
 }
 
 std::optional<VAddr> MemoryManager::GpuToCpuAddress(GPUVAddr addr) const {
@@ -123,9 +134,9 @@ std::optional<VAddr> MemoryManager::GpuToCpuAddress(GPUVAddr addr) const {
         return {};
     }
 
-    const VAddr cpu_addr{page_table.backing_addr[addr >> page_bits]};
-    if (cpu_addr) {
-        return cpu_addr + (addr & page_mask);
+    const GPUPageTable::Entry* const entry{page_table.GetEntry(addr)};
+    if (entry && entry->backing_addr) {
+        return entry->backing_addr + (addr & page_mask);
     }
 
     return {};
@@ -137,15 +148,15 @@ T MemoryManager::Read(GPUVAddr addr) const {
         return {};
     }
 
-    const u8* page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer) {
+    const GPUPageTable::Entry* const entry{page_table.GetEntry(addr)};
+    if (entry && entry->pointer) {
         // NOTE: Avoid adding any extra logic to this fast-path block
         T value;
-        std::memcpy(&value, &page_pointer[addr & page_mask], sizeof(T));
+        std::memcpy(&value, &entry->pointer[addr & page_mask], sizeof(T));
         return value;
     }
 
-    switch (page_table.attributes[addr >> page_bits]) {
+    switch (entry ? entry->type : Common::PageType::Unmapped) {
     case Common::PageType::Unmapped:
         LOG_ERROR(HW_GPU, "Unmapped Read{} @ 0x{:08X}", sizeof(T) * 8, addr);
         return 0;
@@ -164,14 +175,14 @@ void MemoryManager::Write(GPUVAddr addr, T data) {
         return;
     }
 
-    u8* page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer) {
+    const GPUPageTable::Entry* const entry{page_table.GetEntry(addr)};
+    if (entry && entry->pointer) {
         // NOTE: Avoid adding any extra logic to this fast-path block
-        std::memcpy(&page_pointer[addr & page_mask], &data, sizeof(T));
+        std::memcpy(&entry->pointer[addr & page_mask], &data, sizeof(T));
         return;
     }
 
-    switch (page_table.attributes[addr >> page_bits]) {
+    switch (entry ? entry->type : Common::PageType::Unmapped) {
     case Common::PageType::Unmapped:
         LOG_ERROR(HW_GPU, "Unmapped Write{} 0x{:08X} @ 0x{:016X}", sizeof(data) * 8,
                   static_cast<u32>(data), addr);
@@ -198,9 +209,9 @@ u8* MemoryManager::GetPointer(GPUVAddr addr) {
         return {};
     }
 
-    u8* const page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer != nullptr) {
-        return page_pointer + (addr & page_mask);
+    const GPUPageTable::Entry* const entry{page_table.GetEntry(addr)};
+    if (entry && entry->pointer != nullptr) {
+        return entry->pointer + (addr & page_mask);
     }
 
     LOG_ERROR(HW_GPU, "Unknown GetPointer @ 0x{:016X}", addr);
@@ -212,9 +223,9 @@ const u8* MemoryManager::GetPointer(GPUVAddr addr) const {
         return {};
     }
 
-    const u8* const page_pointer{page_table.pointers[addr >> page_bits]};
-    if (page_pointer != nullptr) {
-        return page_pointer + (addr & page_mask);
+    const GPUPageTable::Entry* const entry{page_table.GetEntry(addr)};
+    if (entry && entry->pointer != nullptr) {
+        return entry->pointer + (addr & page_mask);
     }
 
     LOG_ERROR(HW_GPU, "Unknown GetPointer @ 0x{:016X}", addr);
@@ -222,26 +233,21 @@ const u8* MemoryManager::GetPointer(GPUVAddr addr) const {
 }
 
 bool MemoryManager::IsBlockContinuous(const GPUVAddr start, const std::size_t size) const {
-    const std::size_t inner_size = size - 1;
-    const GPUVAddr end = start + inner_size;
-    const auto host_ptr_start = reinterpret_cast<std::uintptr_t>(GetPointer(start));
-    const auto host_ptr_end = reinterpret_cast<std::uintptr_t>(GetPointer(end));
-    const auto range = static_cast<std::size_t>(host_ptr_end - host_ptr_start);
-    return range == inner_size;
+    const GPUPageTable::Range range{page_table.GetRange(start, size)};
+    return range.pointer != nullptr && range.size >= size;
 }
 
 void MemoryManager::ReadBlock(GPUVAddr src_addr, void* dest_buffer, const std::size_t size) const {
     std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> page_bits};
-    std::size_t page_offset{src_addr & page_mask};
 
     while (remaining_size > 0) {
+        const GPUPageTable::Range range{page_table.GetRange(src_addr, remaining_size)};
         const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+            static_cast<std::size_t>(std::min<u64>(range.size, remaining_size))};
 
-        switch (page_table.attributes[page_index]) {
+        switch (range.type) {
         case Common::PageType::Memory: {
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
+            const u8* src_ptr{range.pointer};
             rasterizer.FlushRegion(ToCacheAddr(src_ptr), copy_amount);
             std::memcpy(dest_buffer, src_ptr, copy_amount);
             break;
@@ -250,8 +256,7 @@ void MemoryManager::ReadBlock(GPUVAddr src_addr, void* dest_buffer, const std::s
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
+        src_addr += copy_amount;
         dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
         remaining_size -= copy_amount;
     }
@@ -260,21 +265,17 @@ void MemoryManager::ReadBlock(GPUVAddr src_addr, void* dest_buffer, const std::s
 void MemoryManager::ReadBlockUnsafe(GPUVAddr src_addr, void* dest_buffer,
                                     const std::size_t size) const {
     std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> page_bits};
-    std::size_t page_offset{src_addr & page_mask};
 
     while (remaining_size > 0) {
+        const GPUPageTable::Range range{page_table.GetRange(src_addr, remaining_size)};
         const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-        const u8* page_pointer = page_table.pointers[page_index];
-        if (page_pointer) {
-            const u8* src_ptr{page_pointer + page_offset};
-            std::memcpy(dest_buffer, src_ptr, copy_amount);
+            static_cast<std::size_t>(std::min<u64>(range.size, remaining_size))};
+        if (range.pointer) {
+            std::memcpy(dest_buffer, range.pointer, copy_amount);
         } else {
             std::memset(dest_buffer, 0, copy_amount);
         }
-        page_index++;
-        page_offset = 0;
+        src_addr += copy_amount;
         dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
         remaining_size -= copy_amount;
     }
@@ -282,16 +283,15 @@ void MemoryManager::ReadBlockUnsafe(GPUVAddr src_addr, void* dest_buffer,
 
 void MemoryManager::WriteBlock(GPUVAddr dest_addr, const void* src_buffer, const std::size_t size) {
     std::size_t remaining_size{size};
-    std::size_t page_index{dest_addr >> page_bits};
-    std::size_t page_offset{dest_addr & page_mask};
 
     while (remaining_size > 0) {
+        const GPUPageTable::Range range{page_table.GetRange(dest_addr, remaining_size)};
         const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+            static_cast<std::size_t>(std::min<u64>(range.size, remaining_size))};
 
-        switch (page_table.attributes[page_index]) {
+        switch (range.type) {
         case Common::PageType::Memory: {
-            u8* dest_ptr{page_table.pointers[page_index] + page_offset};
+            u8* dest_ptr{range.pointer};
             rasterizer.InvalidateRegion(ToCacheAddr(dest_ptr), copy_amount);
             std::memcpy(dest_ptr, src_buffer, copy_amount);
             break;
@@ -300,8 +300,7 @@ void MemoryManager::WriteBlock(GPUVAddr dest_addr, const void* src_buffer, const
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
+        dest_addr += copy_amount;
         src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
         remaining_size -= copy_amount;
     }
@@ -310,19 +309,15 @@ void MemoryManager::WriteBlock(GPUVAddr dest_addr, const void* src_buffer, const
 void MemoryManager::WriteBlockUnsafe(GPUVAddr dest_addr, const void* src_buffer,
                                      const std::size_t size) {
     std::size_t remaining_size{size};
-    std::size_t page_index{dest_addr >> page_bits};
-    std::size_t page_offset{dest_addr & page_mask};
 
     while (remaining_size > 0) {
+        const GPUPageTable::Range range{page_table.GetRange(dest_addr, remaining_size)};
         const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-        u8* page_pointer = page_table.pointers[page_index];
-        if (page_pointer) {
-            u8* dest_ptr{page_pointer + page_offset};
-            std::memcpy(dest_ptr, src_buffer, copy_amount);
+            static_cast<std::size_t>(std::min<u64>(range.size, remaining_size))};
+        if (range.pointer) {
+            std::memcpy(range.pointer, src_buffer, copy_amount);
         }
-        page_index++;
-        page_offset = 0;
+        dest_addr += copy_amount;
         src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
         remaining_size -= copy_amount;
     }
@@ -330,16 +325,15 @@ void MemoryManager::WriteBlockUnsafe(GPUVAddr dest_addr, const void* src_buffer,
 
 void MemoryManager::CopyBlock(GPUVAddr dest_addr, GPUVAddr src_addr, const std::size_t size) {
     std::size_t remaining_size{size};
-    std::size_t page_index{src_addr >> page_bits};
-    std::size_t page_offset{src_addr & page_mask};
 
     while (remaining_size > 0) {
+        const GPUPageTable::Range range{page_table.GetRange(src_addr, remaining_size)};
         const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+            static_cast<std::size_t>(std::min<u64>(range.size, remaining_size))};
 
-        switch (page_table.attributes[page_index]) {
+        switch (range.type) {
         case Common::PageType::Memory: {
-            const u8* src_ptr{page_table.pointers[page_index] + page_offset};
+            const u8* src_ptr{range.pointer};
             rasterizer.FlushRegion(ToCacheAddr(src_ptr), copy_amount);
             WriteBlock(dest_addr, src_ptr, copy_amount);
             break;
@@ -348,8 +342,6 @@ void MemoryManager::CopyBlock(GPUVAddr dest_addr, GPUVAddr src_addr, const std::
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
         dest_addr += static_cast<VAddr>(copy_amount);
         src_addr += static_cast<VAddr>(copy_amount);
         remaining_size -= copy_amount;
@@ -362,43 +354,13 @@ void MemoryManager::CopyBlockUnsafe(GPUVAddr dest_addr, GPUVAddr src_addr, const
     WriteBlockUnsafe(dest_addr, tmp_buffer.data(), size);
 }
 
-void MemoryManager::MapPages(GPUVAddr base, u64 size, u8* memory, Common::PageType type,
-                             VAddr backing_addr) {
-    LOG_DEBUG(HW_GPU, "Mapping {} onto {:016X}-{:016X}", fmt::ptr(memory), base * page_size,
-              (base + size) * page_size);
-
-    const VAddr end{base + size};
-    ASSERT_MSG(end <= page_table.pointers.size(), "out of range mapping at {:016X}",
-               base + page_table.pointers.size());
-
-    std::fill(page_table.attributes.begin() + base, page_table.attributes.begin() + end, type);
-
-    if (memory == nullptr) {
-        std::fill(page_table.pointers.begin() + base, page_table.pointers.begin() + end, memory);
-        std::fill(page_table.backing_addr.begin() + base, page_table.backing_addr.begin() + end,
-                  backing_addr);
-    } else {
-        while (base != end) {
-            page_table.pointers[base] = memory;
-            page_table.backing_addr[base] = backing_addr;
-
-            base += 1;
-            memory += page_size;
-            backing_addr += page_size;
-        }
-    }
-}
-
 void MemoryManager::MapMemoryRegion(GPUVAddr base, u64 size, u8* target, VAddr backing_addr) {
-    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: {:016X}", size);
-    ASSERT_MSG((base & page_mask) == 0, "non-page aligned base: {:016X}", base);
-    MapPages(base / page_size, size / page_size, target, Common::PageType::Memory, backing_addr);
+    LOG_DEBUG(HW_GPU, "Mapping {} onto {:016X}-{:016X}", fmt::ptr(target), base, base + size);
+    page_table.Map(base, size, target, Common::PageType::Memory, backing_addr);
 }
 
 void MemoryManager::UnmapRegion(GPUVAddr base, u64 size) {
-    ASSERT_MSG((size & page_mask) == 0, "non-page aligned size: {:016X}", size);
-    ASSERT_MSG((base & page_mask) == 0, "non-page aligned base: {:016X}", base);
-    MapPages(base / page_size, size / page_size, nullptr, Common::PageType::Unmapped);
+    page_table.Map(base, size, nullptr, Common::PageType::Unmapped, 0);
 }
 
 bool VirtualMemoryArea::CanBeMergedWith(const VirtualMemoryArea& next) const {
@@ -6,9 +6,10 @@
 
 #include <map>
 #include <optional>
+#include <vector>
 
 #include "common/common_types.h"
-#include "common/page_table.h"
+#include "video_core/gpu_page_table.h"
 
 namespace VideoCore {
 class RasterizerInterface;
@@ -58,6 +59,17 @@ public:
     GPUVAddr AllocateSpace(GPUVAddr addr, u64 size, u64 align);
     GPUVAddr MapBufferEx(VAddr cpu_addr, u64 size);
     GPUVAddr MapBufferEx(VAddr cpu_addr, GPUVAddr addr, u64 size);
+
+    /// Mapping of a CPU region at a fixed GPU address.
+    struct MapEntry {
+        VAddr cpu_addr;
+        GPUVAddr gpu_addr;
+        u64 size;
+    };
+
+    /// Maps every entry at its fixed GPU address, entries contiguous in both address spaces are
+    /// mapped together as a single region.
+    void MapBuffersEx(const std::vector<MapEntry>& entries);
     GPUVAddr UnmapBuffer(GPUVAddr addr, u64 size);
     std::optional<VAddr> GpuToCpuAddress(GPUVAddr addr) const;
 
@@ -97,14 +109,22 @@ public:
     void WriteBlockUnsafe(GPUVAddr dest_addr, const void* src_buffer, std::size_t size);
     void CopyBlockUnsafe(GPUVAddr dest_addr, GPUVAddr src_addr, std::size_t size);
 
+    /// Calls func with the GPU address, backing CPU address and size of every mapped region.
+    template <typename Func>
+    void ForEachMappedRegion(Func&& func) const {
+        for (const auto& [base, vma] : vma_map) {
+            if (vma.type == VirtualMemoryArea::Type::Mapped) {
+                func(vma.base, vma.backing_addr, vma.size);
+            }
+        }
+    }
+
 private:
     using VMAMap = std::map<GPUVAddr, VirtualMemoryArea>;
     using VMAHandle = VMAMap::const_iterator;
     using VMAIter = VMAMap::iterator;
 
     bool IsAddressValid(GPUVAddr addr) const;
-    void MapPages(GPUVAddr base, u64 size, u8* memory, Common::PageType type,
-                  VAddr backing_addr = 0);
     void MapMemoryRegion(GPUVAddr base, u64 size, u8* target, VAddr backing_addr);
     void UnmapRegion(GPUVAddr base, u64 size);
 
@@ -163,18 +183,18 @@ private:
     GPUVAddr FindFreeRegion(GPUVAddr region_start, u64 size) const;
 
 private:
-    static constexpr u64 page_bits{16};
-    static constexpr u64 page_size{1 << page_bits};
-    static constexpr u64 page_mask{page_size - 1};
+    static constexpr u64 page_bits{GPUPageTable::page_bits};
+    static constexpr u64 page_size{GPUPageTable::page_size};
+    static constexpr u64 page_mask{GPUPageTable::page_mask};
 
     /// Address space in bits, according to Tegra X1 TRM
-    static constexpr u32 address_space_width{40};
+    static constexpr u32 address_space_width{GPUPageTable::address_space_width};
     /// Start address for mapping, this is fairly arbitrary but must be non-zero.
     static constexpr GPUVAddr address_space_base{0x100000};
     /// End of address space, based on address space in bits.
     static constexpr GPUVAddr address_space_end{1ULL << address_space_width};
 
-    Common::PageTable page_table{page_bits};
+    GPUPageTable page_table;
     VMAMap vma_map;
     VideoCore::RasterizerInterface& rasterizer;
 
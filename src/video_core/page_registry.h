@@ -0,0 +1,96 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/gpu.h"
+#include "video_core/radix_table.h"
+
+namespace VideoCommon {
+
+/**
+ * Registry of cached objects covering ranges of host memory, shared by the video caches.
+ *
+ * Objects are stored in every page their range touches, so querying a range walks its pages once
+ * without allocating. An object spanning several pages is only reported from the first page it
+ * shares with the queried range, so every overlap is reported exactly once.
+ */
+template <typename T, std::size_t PageBits, std::size_t LeafBits = 6>
+class PageRegistry {
+public:
+    /// Registers an object covering [start, end).
+    void Insert(const T& object, CacheAddr start, CacheAddr end) {
+        if (start >= end) {
+            return;
+        }
+        const u64 page_end = (end - 1) >> PageBits;
+        for (u64 page = start >> PageBits; page <= page_end; ++page) {
+            pages[page].push_back({object, start, end});
+        }
+    }
+
+    /// Unregisters an object previously inserted covering [start, end).
+    void Erase(const T& object, CacheAddr start, CacheAddr end) {
+        if (start >= end) {
+            return;
+        }
+        const u64 page_end = (end - 1) >> PageBits;
+        for (u64 page = start >> PageBits; page <= page_end; ++page) {
+            auto* const entries = pages.Find(page);
+            if (!entries) {
+                continue;
+            }
+            const auto it = std::find_if(entries->begin(), entries->end(), [&](const Entry& entry) {
+                return entry.object == object;
+            });
+            if (it != entries->end()) {
+                *it = std::move(entries->back());
+                entries->pop_back();
+            }
+        }
+    }
+
+    /// Calls func(object) once for every registered object overlapping [start, end).
+    template <typename Func>
+    void ForEachOverlap(CacheAddr start, CacheAddr end, Func&& func) const {
+        if (start >= end) {
+            return;
+        }
+        const u64 page_begin = start >> PageBits;
+        const u64 page_end = ((end - 1) >> PageBits) + 1;
+        pages.ForEachInRange(page_begin, page_end, [&](u64 page, const std::vector<Entry>& list) {
+            for (const Entry& entry : list) {
+                if (entry.start >= end || entry.end <= start) {
+                    continue;
+                }
+                if ((std::max(entry.start, start) >> PageBits) == page) {
+                    func(entry.object);
+                }
+            }
+            return false;
+        });
+    }
+
+    /// Unregisters all objects.
+    void Clear() {
+        pages.Clear();
+    }
+
+private:
+    struct Entry {
+        T object;
+        CacheAddr start;
+        CacheAddr end;
+    };
+
+    RadixTable<std::vector<Entry>, LeafBits> pages;
+};
+
+} // namespace VideoCommon
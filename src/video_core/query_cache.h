@@ -0,0 +1,407 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace VideoCommon {
+
+/**
+ * Stream of host counters of a single query type. Each time the guest reports the counter, the
+ * active host query is ended and a new one depending on it is started, so the reported value is
+ * the sum of the whole chain and no host query has to be read until the guest reads the report.
+ */
+template <class QueryCache, class HostCounter>
+class CounterStreamBase {
+public:
+    explicit CounterStreamBase(QueryCache& cache, VideoCore::QueryType type)
+        : cache{cache}, type{type} {}
+
+    /// Enables or disables the stream.
+    void Update(bool enabled) {
+        if (enabled) {
+            Enable();
+        } else {
+            Disable();
+        }
+    }
+
+    /// Resets the stream to zero. It doesn't disable the stream.
+    void Reset() {
+        if (current) {
+            current->EndQuery();
+
+            // Immediately start a new query to keep counting
+            current = cache.Counter(nullptr, type);
+        }
+        last = nullptr;
+    }
+
+    /// Ends the active counter and returns it, a new counter depending on it is started.
+    std::shared_ptr<HostCounter> Current() {
+        if (!current) {
+            return nullptr;
+        }
+        current->EndQuery();
+        last = std::move(current);
+        current = cache.Counter(last, type);
+        return last;
+    }
+
+    /// Returns true when the stream is counting.
+    bool IsEnabled() const {
+        return current != nullptr;
+    }
+
+private:
+    void Enable() {
+        if (current) {
+            return;
+        }
+        current = cache.Counter(last, type);
+    }
+
+    void Disable() {
+        if (current) {
+            current->EndQuery();
+        }
+        last = std::exchange(current, nullptr);
+    }
+
+    QueryCache& cache;
+    const VideoCore::QueryType type;
+
+    std::shared_ptr<HostCounter> current;
+    std::shared_ptr<HostCounter> last;
+};
+
+/**
+ * Caches guest query reports bound to host counters. Reports are registered as cached memory
+ * and only written to guest memory when the guest reads them, which is when the host query is
+ * waited on.
+ */
+template <class QueryCache, class CachedQuery, class CounterStream, class HostCounter,
+          class QueryPool>
+class QueryCacheBase {
+public:
+    explicit QueryCacheBase(Core::System& system, VideoCore::RasterizerInterface& rasterizer)
+        : system{system}, rasterizer{rasterizer}, streams{{CounterStream{
+                                                      static_cast<QueryCache&>(*this),
+                                                      VideoCore::QueryType::SamplesPassed}}} {}
+
+    /// Drops the reports in the region, the guest has overwritten them.
+    void InvalidateRegion(CacheAddr addr, std::size_t size) {
+        std::lock_guard lock{mutex};
+        RemoveRegion(addr, size, false);
+    }
+
+    /// Writes the reports in the region to guest memory, the guest is about to read them.
+    void FlushRegion(CacheAddr addr, std::size_t size) {
+        std::lock_guard lock{mutex};
+        RemoveRegion(addr, size, true);
+    }
+
+    /**
+     * Records a query report in GPU mapped memory.
+     * @param gpu_addr  GPU address written when the guest reads the report.
+     * @param type      Counter to report.
+     * @param timestamp Timestamp written after the value, short reports don't have one.
+     */
+    void Query(GPUVAddr gpu_addr, VideoCore::QueryType type, std::optional<u64> timestamp) {
+        std::lock_guard lock{mutex};
+        auto& memory_manager = system.GPU().MemoryManager();
+        u8* const host_ptr = memory_manager.GetPointer(gpu_addr);
+        ASSERT_OR_EXECUTE(host_ptr, return;);
+
+        CachedQuery* query = TryGet(ToCacheAddr(host_ptr));
+        if (!query) {
+            const auto cpu_addr = memory_manager.GpuToCpuAddress(gpu_addr);
+            ASSERT_OR_EXECUTE(cpu_addr, return;);
+
+            query = Register(type, *cpu_addr, host_ptr, timestamp.has_value());
+            system.GPU().MarkRegionWritten(ToCacheAddr(host_ptr),
+                                           CachedQuery::SizeInBytes(timestamp.has_value()));
+        }
+        query->BindCounter(Stream(type).Current(), timestamp);
+    }
+
+    /// Enables or disables the streams from the guest state, called before each draw and clear.
+    void UpdateCounters() {
+        std::lock_guard lock{mutex};
+        const auto& regs = system.GPU().Maxwell3D().regs;
+        Stream(VideoCore::QueryType::SamplesPassed).Update(regs.samplecnt_enable);
+    }
+
+    /// Resets a counter to zero. It doesn't disable its stream.
+    void ResetCounter(VideoCore::QueryType type) {
+        std::lock_guard lock{mutex};
+        Stream(type).Reset();
+    }
+
+    /// Disables all the streams, for backends that can't keep host queries active for long.
+    void DisableStreams() {
+        std::lock_guard lock{mutex};
+        for (auto& stream : streams) {
+            stream.Update(false);
+        }
+    }
+
+    /**
+     * Returns the counter of the report at the given address when the report value is only known
+     * by the host GPU, so it can be used to evaluate a render condition on the host. Returns
+     * nullptr when there's no such report or when its value depends on other counters.
+     */
+    std::shared_ptr<HostCounter> GetPendingCounter(GPUVAddr gpu_addr) {
+        std::lock_guard lock{mutex};
+        const u8* const host_ptr = system.GPU().MemoryManager().GetPointer(gpu_addr);
+        if (!host_ptr) {
+            return nullptr;
+        }
+        CachedQuery* const query = TryGet(ToCacheAddr(host_ptr));
+        if (!query) {
+            return nullptr;
+        }
+        const auto& counter = query->GetCounter();
+        if (!counter || !counter->WaitPending() || counter->HasDependency()) {
+            return nullptr;
+        }
+        return counter;
+    }
+
+    /// Returns a new host counter.
+    std::shared_ptr<HostCounter> Counter(std::shared_ptr<HostCounter> dependency,
+                                         VideoCore::QueryType type) {
+        return std::make_shared<HostCounter>(static_cast<QueryCache&>(*this), std::move(dependency),
+                                             type);
+    }
+
+    /// Returns the counter stream of the given type.
+    CounterStream& Stream(VideoCore::QueryType type) {
+        return streams[static_cast<std::size_t>(type)];
+    }
+
+    /// Returns the counter stream of the given type.
+    const CounterStream& Stream(VideoCore::QueryType type) const {
+        return streams[static_cast<std::size_t>(type)];
+    }
+
+protected:
+    std::array<QueryPool, VideoCore::NumQueryTypes> query_pools;
+
+private:
+    /// Removes the reports in the range from the cache, optionally writing them to guest memory.
+    void RemoveRegion(CacheAddr addr, std::size_t size, bool flush) {
+        const u64 addr_begin = static_cast<u64>(addr);
+        const u64 addr_end = addr_begin + static_cast<u64>(size);
+        const auto in_range = [addr_begin, addr_end](const CachedQuery& query) {
+            const u64 cache_begin = query.GetCacheAddr();
+            const u64 cache_end = cache_begin + query.SizeInBytes();
+            return cache_begin < addr_end && addr_begin < cache_end;
+        };
+
+        const u64 page_end = addr_end >> PAGE_BITS;
+        for (u64 page = addr_begin >> PAGE_BITS; page <= page_end; ++page) {
+            const auto it = cached_queries.find(page);
+            if (it == std::end(cached_queries)) {
+                continue;
+            }
+            auto& contents = it->second;
+            for (auto& query : contents) {
+                if (!in_range(query)) {
+                    continue;
+                }
+                rasterizer.UpdatePagesCachedCount(query.GetCpuAddr(), query.SizeInBytes(), -1);
+                if (flush) {
+                    query.Flush();
+                }
+            }
+            contents.erase(std::remove_if(std::begin(contents), std::end(contents), in_range),
+                           std::end(contents));
+            if (contents.empty()) {
+                cached_queries.erase(it);
+            }
+        }
+    }
+
+    /// Registers a report and returns a pointer to it.
+    CachedQuery* Register(VideoCore::QueryType type, VAddr cpu_addr, u8* host_ptr,
+                          bool has_timestamp) {
+        rasterizer.UpdatePagesCachedCount(cpu_addr, CachedQuery::SizeInBytes(has_timestamp), 1);
+        const u64 page = static_cast<u64>(ToCacheAddr(host_ptr)) >> PAGE_BITS;
+        return &cached_queries[page].emplace_back(static_cast<QueryCache&>(*this), type, cpu_addr,
+                                                  host_ptr);
+    }
+
+    /// Returns the report at the given address, or nullptr when it's not cached.
+    CachedQuery* TryGet(CacheAddr addr) {
+        const u64 page = static_cast<u64>(addr) >> PAGE_BITS;
+        const auto it = cached_queries.find(page);
+        if (it == std::end(cached_queries)) {
+            return nullptr;
+        }
+        auto& contents = it->second;
+        const auto found =
+            std::find_if(std::begin(contents), std::end(contents),
+                         [addr](const CachedQuery& query) { return query.GetCacheAddr() == addr; });
+        return found != std::end(contents) ? &*found : nullptr;
+    }
+
+    static constexpr unsigned PAGE_BITS = 12;
+
+    Core::System& system;
+    VideoCore::RasterizerInterface& rasterizer;
+
+    std::recursive_mutex mutex;
+
+    std::unordered_map<u64, std::vector<CachedQuery>> cached_queries;
+
+    std::array<CounterStream, VideoCore::NumQueryTypes> streams;
+};
+
+template <class QueryCache, class HostCounter>
+class HostCounterBase {
+public:
+    explicit HostCounterBase(std::shared_ptr<HostCounter> dependency_)
+        : dependency{std::move(dependency_)}, depth{dependency ? (dependency->Depth() + 1) : 0} {
+        // Long chains are collapsed, destroying them recursively could overflow the stack
+        constexpr u64 depth_threshold = 96;
+        if (depth > depth_threshold) {
+            depth = 0;
+            base_result = dependency->Query();
+            dependency = nullptr;
+        }
+    }
+    virtual ~HostCounterBase() = default;
+
+    /// Returns the value of the counter, waiting for the host GPU if needed.
+    u64 Query() {
+        if (result) {
+            return *result;
+        }
+
+        u64 value = BlockingQuery() + base_result;
+        if (dependency) {
+            value += dependency->Query();
+            dependency = nullptr;
+        }
+
+        result = value;
+        return *result;
+    }
+
+    /// Returns true when querying the counter may wait for the host GPU.
+    bool WaitPending() const noexcept {
+        return !result.has_value();
+    }
+
+    /// Returns true when the value of the counter is added to the value of other counters.
+    bool HasDependency() const noexcept {
+        return dependency != nullptr || base_result != 0;
+    }
+
+    u64 Depth() const noexcept {
+        return depth;
+    }
+
+protected:
+    /// Returns the value of the host query, waiting for it as needed.
+    virtual u64 BlockingQuery() const = 0;
+
+private:
+    std::shared_ptr<HostCounter> dependency; ///< Counter added to this value.
+    std::optional<u64> result;               ///< Value of the counter after it's been queried.
+    u64 depth;                               ///< Number of nested dependencies.
+    u64 base_result = 0;                     ///< Value of the collapsed dependencies.
+};
+
+template <class HostCounter>
+class CachedQueryBase {
+public:
+    explicit CachedQueryBase(VAddr cpu_addr, u8* host_ptr)
+        : cpu_addr{cpu_addr}, host_ptr{host_ptr} {}
+    virtual ~CachedQueryBase() = default;
+
+    CachedQueryBase(CachedQueryBase&&) noexcept = default;
+    CachedQueryBase(const CachedQueryBase&) = delete;
+
+    CachedQueryBase& operator=(CachedQueryBase&&) noexcept = default;
+    CachedQueryBase& operator=(const CachedQueryBase&) = delete;
+
+    /// Writes the report to guest memory.
+    virtual void Flush() {
+        // Without a counter the report was made while the stream was disabled, it's zero
+        const u64 value = counter ? counter->Query() : 0;
+        std::memcpy(host_ptr, &value, sizeof(u64));
+
+        if (timestamp) {
+            std::memcpy(host_ptr + TIMESTAMP_OFFSET, &*timestamp, sizeof(u64));
+        }
+    }
+
+    /// Binds a counter to this report.
+    void BindCounter(std::shared_ptr<HostCounter> counter_, std::optional<u64> timestamp_) {
+        if (counter) {
+            // The guest is reporting again to the same address, write the old report first
+            Flush();
+        }
+        counter = std::move(counter_);
+        timestamp = timestamp_;
+    }
+
+    const std::shared_ptr<HostCounter>& GetCounter() const noexcept {
+        return counter;
+    }
+
+    VAddr GetCpuAddr() const noexcept {
+        return cpu_addr;
+    }
+
+    CacheAddr GetCacheAddr() const noexcept {
+        return ToCacheAddr(host_ptr);
+    }
+
+    u64 SizeInBytes() const noexcept {
+        return SizeInBytes(timestamp.has_value());
+    }
+
+    static constexpr u64 SizeInBytes(bool with_timestamp) noexcept {
+        return with_timestamp ? LARGE_QUERY_SIZE : SMALL_QUERY_SIZE;
+    }
+
+protected:
+    /// Returns true when flushing the report may wait for the host GPU.
+    bool WaitPending() const noexcept {
+        return counter && counter->WaitPending();
+    }
+
+private:
+    static constexpr std::size_t SMALL_QUERY_SIZE = 8;   ///< Report size without timestamp
+    static constexpr std::size_t LARGE_QUERY_SIZE = 16;  ///< Report size with timestamp
+    static constexpr std::intptr_t TIMESTAMP_OFFSET = 8; ///< Timestamp offset in a large report
+
+    VAddr cpu_addr;                       ///< Guest CPU address.
+    u8* host_ptr;                         ///< Writable host pointer.
+    std::shared_ptr<HostCounter> counter; ///< Host counter to query, owns its dependencies.
+    std::optional<u64> timestamp;         ///< Timestamp written after the value.
+};
+
+} // namespace VideoCommon
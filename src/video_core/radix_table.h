@@ -0,0 +1,90 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/**
+ * Sparse two-level table indexed by page number.
+ *
+ * The first level maps the upper bits of the page to a leaf, the second level is a flat array of
+ * entries covering 2^LeafBits consecutive pages. Walking a range of pages costs one lookup per
+ * leaf and never allocates; leaves are only allocated the first time one of their pages is
+ * accessed for writing, and live until the table is cleared.
+ */
+template <typename T, std::size_t LeafBits>
+class RadixTable {
+public:
+    static constexpr u64 LeafSize = 1ULL << LeafBits;
+
+    /// Returns the entry of the given page, allocating its leaf if it doesn't exist.
+    T& operator[](u64 page) {
+        auto& leaf = leaves[page >> LeafBits];
+        if (!leaf) {
+            leaf = std::make_unique<Leaf>();
+        }
+        return (*leaf)[page & LeafMask];
+    }
+
+    /// Returns the entry of the given page, or nullptr when its leaf has not been allocated.
+    T* Find(u64 page) {
+        const auto it = leaves.find(page >> LeafBits);
+        return it != leaves.end() ? &(*it->second)[page & LeafMask] : nullptr;
+    }
+
+    /// Returns the entry of the given page, or nullptr when its leaf has not been allocated.
+    const T* Find(u64 page) const {
+        const auto it = leaves.find(page >> LeafBits);
+        return it != leaves.end() ? &(*it->second)[page & LeafMask] : nullptr;
+    }
+
+    /**
+     * Calls func(page, entry) for every page in [page_begin, page_end) with an allocated leaf.
+     * Pages in leaves that were never allocated are skipped, as they would hold a default entry.
+     * @param func Callback returning true to stop the walk.
+     * @returns True when the walk was stopped by the callback.
+     */
+    template <typename Func>
+    bool ForEachInRange(u64 page_begin, u64 page_end, Func&& func) const {
+        u64 page = page_begin;
+        while (page < page_end) {
+            const u64 leaf_index = page >> LeafBits;
+            const u64 leaf_end = std::min((leaf_index + 1) << LeafBits, page_end);
+            const auto it = leaves.find(leaf_index);
+            if (it != leaves.end()) {
+                const Leaf& leaf = *it->second;
+                for (; page < leaf_end; ++page) {
+                    if (func(page, leaf[page & LeafMask])) {
+                        return true;
+                    }
+                }
+            }
+            page = leaf_end;
+        }
+        return false;
+    }
+
+    /// Releases all leaves.
+    void Clear() {
+        leaves.clear();
+    }
+
+private:
+    static constexpr u64 LeafMask = LeafSize - 1;
+
+    using Leaf = std::array<T, LeafSize>;
+
+    std::unordered_map<u64, std::unique_ptr<Leaf>> leaves;
+};
+
+} // namespace VideoCommon
@@ -2,11 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <mutex>
 
-#include <boost/icl/interval_map.hpp>
-#include <boost/range/iterator_range.hpp>
-
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "core/memory.h"
@@ -14,52 +14,98 @@
 
 namespace VideoCore {
 
-namespace {
-
-template <typename Map, typename Interval>
-constexpr auto RangeFromInterval(Map& map, const Interval& interval) {
-    return boost::make_iterator_range(map.equal_range(interval));
-}
-
-} // Anonymous namespace
-
 RasterizerAccelerated::RasterizerAccelerated(Memory::Memory& cpu_memory_)
-    : cpu_memory{cpu_memory_} {}
+    : cpu_memory{cpu_memory_} {
+    static_assert(CPU_PAGE_BITS == Memory::PAGE_BITS);
+}
 
-RasterizerAccelerated::~RasterizerAccelerated() = default;
+RasterizerAccelerated::~RasterizerAccelerated() {
+    for (auto& entry : directory) {
+        delete entry.load(std::memory_order_relaxed);
+    }
+}
 
 void RasterizerAccelerated::UpdatePagesCachedCount(VAddr addr, u64 size, int delta) {
-    std::lock_guard lock{pages_mutex};
     const u64 page_start{addr >> Memory::PAGE_BITS};
     const u64 page_end{(addr + size + Memory::PAGE_SIZE - 1) >> Memory::PAGE_BITS};
-
-    // Interval maps will erase segments if count reaches 0, so if delta is negative we have to
-    // subtract after iterating
-    const auto pages_interval = CachedPageMap::interval_type::right_open(page_start, page_end);
-    if (delta > 0) {
-        cached_pages.add({pages_interval, delta});
+    if (page_end > NUM_TABLES * PAGES_PER_TABLE) {
+        UNREACHABLE_MSG("Cached region 0x{:016X} of size {} is out of the address space", addr,
+                        size);
+        return;
     }
 
-    for (const auto& pair : RangeFromInterval(cached_pages, pages_interval)) {
-        const auto interval = pair.first & pages_interval;
-        const int count = pair.second;
+    // Counters are updated without locking, only the pages whose count crossed zero have to
+    // touch the CPU page table. Their range is gathered so it's synchronized in a single pass.
+    u64 transition_start = page_end;
+    u64 transition_end = page_start;
+    for (u64 page = page_start; page != page_end; ++page) {
+        auto& count = GetTable(page).counts[page % PAGES_PER_TABLE];
+        const int old_count = count.fetch_add(static_cast<u16>(delta), std::memory_order_acq_rel);
+        const int new_count = old_count + delta;
+        ASSERT_MSG(new_count >= 0 && new_count <= std::numeric_limits<u16>::max(),
+                   "Invalid cached count={} for page 0x{:X}", new_count, page);
+        if ((old_count == 0) != (new_count == 0)) {
+            transition_start = std::min(transition_start, page);
+            transition_end = page + 1;
+        }
+    }
+    if (transition_start < transition_end) {
+        SyncMarkedPages(transition_start, transition_end);
+    }
+}
 
-        const VAddr interval_start_addr = boost::icl::first(interval) << Memory::PAGE_BITS;
-        const VAddr interval_end_addr = boost::icl::last_next(interval) << Memory::PAGE_BITS;
-        const u64 interval_size = interval_end_addr - interval_start_addr;
+RasterizerAccelerated::PageTable& RasterizerAccelerated::GetTable(u64 page) {
+    auto& entry = directory[page / PAGES_PER_TABLE];
+    PageTable* table = entry.load(std::memory_order_acquire);
+    if (table) {
+        return *table;
+    }
+    auto new_table = std::make_unique<PageTable>();
+    if (entry.compare_exchange_strong(table, new_table.get(), std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return *new_table.release();
+    }
+    // Another thread allocated the table first
+    return *table;
+}
 
-        if (delta > 0 && count == delta) {
-            cpu_memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, true);
-        } else if (delta < 0 && count == -delta) {
-            cpu_memory.RasterizerMarkRegionCached(interval_start_addr, interval_size, false);
-        } else {
-            ASSERT(count >= 0);
+void RasterizerAccelerated::SyncMarkedPages(u64 page_start, u64 page_end) {
+    // Counters may have changed again since the transition was seen, the bitmap holds what the
+    // CPU page table has so each page is marked from its latest count and only when it differs.
+    std::lock_guard lock{mark_mutex};
+
+    u64 run_start = 0;
+    u64 run_end = 0;
+    bool run_cached = false;
+    const auto flush_run = [&] {
+        if (run_start != run_end) {
+            cpu_memory.RasterizerMarkRegionCached(run_start << Memory::PAGE_BITS,
+                                                  (run_end - run_start) << Memory::PAGE_BITS,
+                                                  run_cached);
         }
-    }
+        run_start = run_end = 0;
+    };
+
+    for (u64 page = page_start; page != page_end; ++page) {
+        PageTable& table = GetTable(page);
+        const u64 index = page % PAGES_PER_TABLE;
+        const bool cached = table.counts[index].load(std::memory_order_acquire) != 0;
+        u64& word = table.marked[index / 64];
+        const u64 bit = 1ULL << (index % 64);
+        if (((word & bit) != 0) == cached) {
+            flush_run();
+            continue;
+        }
+        word ^= bit;
 
-    if (delta < 0) {
-        cached_pages.add({pages_interval, delta});
+        if (run_start == run_end || run_cached != cached || run_end != page) {
+            flush_run();
+            run_start = page;
+            run_cached = cached;
+        }
+        run_end = page + 1;
     }
+    flush_run();
 }
 
 } // namespace VideoCore
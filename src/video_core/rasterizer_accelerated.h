@@ -4,10 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <mutex>
 
-#include <boost/icl/interval_map.hpp>
-
 #include "common/common_types.h"
 #include "video_core/rasterizer_interface.h"
 
@@ -26,9 +26,30 @@ public:
     void UpdatePagesCachedCount(VAddr addr, u64 size, int delta) override;
 
 private:
-    using CachedPageMap = boost::icl::interval_map<u64, int>;
-    CachedPageMap cached_pages;
-    std::mutex pages_mutex;
+    /// Width of the largest guest address space
+    static constexpr u64 ADDRESS_SPACE_BITS = 39;
+    static constexpr u64 CPU_PAGE_BITS = 12;
+    /// Each table tracks 64MiB of guest memory
+    static constexpr u64 TABLE_BITS = 14;
+    static constexpr u64 PAGES_PER_TABLE = 1ULL << TABLE_BITS;
+    static constexpr u64 NUM_TABLES = 1ULL << (ADDRESS_SPACE_BITS - CPU_PAGE_BITS - TABLE_BITS);
+
+    struct PageTable {
+        /// Number of cached objects overlapping each page
+        std::array<std::atomic<u16>, PAGES_PER_TABLE> counts{};
+        /// Pages currently marked as cached in the CPU page table, guarded by mark_mutex
+        std::array<u64, PAGES_PER_TABLE / 64> marked{};
+    };
+
+    /// Returns the table tracking the given page, allocating it on first use
+    PageTable& GetTable(u64 page);
+
+    /// Marks or unmarks the pages in the range whose count crossed zero in the CPU page table
+    void SyncMarkedPages(u64 page_start, u64 page_end);
+
+    /// Lazily allocated tables, a sparse address space only pays for the regions it caches
+    std::array<std::atomic<PageTable*>, NUM_TABLES> directory{};
+    std::mutex mark_mutex;
 
     Memory::Memory& cpu_memory;
 };
@@ -4,16 +4,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <mutex>
-#include <set>
 #include <unordered_map>
-
-#include <boost/icl/interval_map.hpp>
-#include <boost/range/iterator_range_core.hpp>
+#include <vector>
 
 #include "common/common_types.h"
+#include "common/microprofile.h"
 #include "core/settings.h"
 #include "video_core/gpu.h"
+#include "video_core/page_registry.h"
 #include "video_core/rasterizer_interface.h"
 
 class RasterizerCacheObject {
@@ -94,6 +94,12 @@ public:
         std::lock_guard lock{mutex};
 
         const auto& objects{GetSortedObjectsFromRegion(addr, size)};
+
+        // Guest writes are tracked at page granularity but objects are matched byte by byte, a
+        // write that lands on a cached page without overlapping any object is a false positive
+        MICROPROFILE_META_CPU("Cache invalidations", static_cast<int>(objects.size()));
+        MICROPROFILE_META_CPU("Cache false positive invalidations", objects.empty() ? 1 : 0);
+
         for (auto& object : objects) {
             if (!object->IsRegistered()) {
                 // Skip duplicates
@@ -107,8 +113,10 @@ public:
     void InvalidateAll() {
         std::lock_guard lock{mutex};
 
-        while (interval_cache.begin() != interval_cache.end()) {
-            Unregister(*interval_cache.begin()->second.begin());
+        while (!map_cache.empty()) {
+            // Copy the object, Unregister erases the entry it's taken from
+            const T object = map_cache.begin()->second;
+            Unregister(object);
         }
     }
 
@@ -133,7 +141,8 @@ protected:
         std::lock_guard lock{mutex};
 
         object->SetIsRegistered(true);
-        interval_cache.add({GetInterval(object), ObjectSet{object}});
+        registry.Insert(object, object->GetCacheAddr(),
+                        object->GetCacheAddr() + object->GetSizeInBytes());
         map_cache.insert({object->GetCacheAddr(), object});
         rasterizer.UpdatePagesCachedCount(object->GetCpuAddr(), object->GetSizeInBytes(), 1);
     }
@@ -145,7 +154,7 @@ protected:
         object->SetIsRegistered(false);
         rasterizer.UpdatePagesCachedCount(object->GetCpuAddr(), object->GetSizeInBytes(), -1);
         const CacheAddr addr = object->GetCacheAddr();
-        interval_cache.subtract({GetInterval(object), ObjectSet{object}});
+        registry.Erase(object, addr, addr + object->GetSizeInBytes());
         map_cache.erase(addr);
     }
 
@@ -179,15 +188,8 @@ private:
         }
 
         std::vector<T> objects;
-        const ObjectInterval interval{addr, addr + size};
-        for (auto& pair : boost::make_iterator_range(interval_cache.equal_range(interval))) {
-            for (auto& cached_object : pair.second) {
-                if (!cached_object) {
-                    continue;
-                }
-                objects.push_back(cached_object);
-            }
-        }
+        registry.ForEachOverlap(addr, addr + size,
+                                [&](const T& object) { objects.push_back(object); });
 
         std::sort(objects.begin(), objects.end(), [](const T& a, const T& b) -> bool {
             return a->GetLastModifiedTicks() < b->GetLastModifiedTicks();
@@ -196,18 +198,10 @@ private:
         return objects;
     }
 
-    using ObjectSet = std::set<T>;
     using ObjectCache = std::unordered_map<CacheAddr, T>;
-    using IntervalCache = boost::icl::interval_map<CacheAddr, ObjectSet>;
-    using ObjectInterval = typename IntervalCache::interval_type;
-
-    static auto GetInterval(const T& object) {
-        return ObjectInterval::right_open(object->GetCacheAddr(),
-                                          object->GetCacheAddr() + object->GetSizeInBytes());
-    }
 
     ObjectCache map_cache;
-    IntervalCache interval_cache; ///< Cache of objects
+    VideoCommon::PageRegistry<T, 14> registry; ///< Cache of objects
     u64 modified_ticks{};         ///< Counter of cache state ticks, used for in-order flushing
     VideoCore::RasterizerInterface& rasterizer;
 };
@@ -6,6 +6,8 @@
 
 #include <atomic>
 #include <functional>
+#include <optional>
+#include <utility>
 #include "common/common_types.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/gpu.h"
@@ -25,6 +27,11 @@ enum class LoadCallbackStage {
 };
 using DiskResourceLoadCallback = std::function<void(LoadCallbackStage, std::size_t, std::size_t)>;
 
+enum class QueryType {
+    SamplesPassed,
+};
+constexpr std::size_t NumQueryTypes = 1;
+
 class RasterizerInterface {
 public:
     virtual ~RasterizerInterface() {}
@@ -41,6 +48,24 @@ public:
     /// Dispatches a compute shader invocation
     virtual void DispatchCompute(GPUVAddr code_addr) = 0;
 
+    /// Resets the counter of a query type to zero
+    virtual void ResetCounter(QueryType type) {}
+
+    /// Records a GPU query and caches it, the report is written when the guest reads it. Returns
+    /// false when the rasterizer can't count queries of this type and the caller has to report.
+    virtual bool Query(GPUVAddr gpu_addr, QueryType type, std::optional<u64> timestamp) {
+        return false;
+    }
+
+    /// Starts evaluating the render condition at the given address on the host GPU. Returns false
+    /// when the host can't evaluate it and the caller has to.
+    virtual bool BeginConditionalRendering(GPUVAddr condition_addr) {
+        return false;
+    }
+
+    /// Stops evaluating a render condition on the host GPU
+    virtual void EndConditionalRendering() {}
+
     /// Notify rasterizer that all caches should be flushed to Switch memory
     virtual void FlushAll() = 0;
 
@@ -54,6 +79,12 @@ public:
     /// and invalidated
     virtual void FlushAndInvalidateRegion(CacheAddr addr, u64 size) = 0;
 
+    /// Signal a GPU based syncpoint, it's incremented once the memory written before it is flushed
+    virtual void SignalSyncPoint(u32 syncpoint_id) = 0;
+
+    /// Release all pending fences, waiting for the host GPU if needed
+    virtual void ReleaseFences() = 0;
+
     /// Notify the rasterizer to send all written commands to the host GPU.
     virtual void FlushCommands() = 0;
 
@@ -67,12 +98,35 @@ public:
         return false;
     }
 
+    /// Attempt to copy a linear region on the host GPU, without going through guest memory
+    virtual bool AccelerateBufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) {
+        return false;
+    }
+
     /// Attempt to use a faster method to display the framebuffer to screen
     virtual bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                                    u32 pixel_stride) {
         return false;
     }
 
+    /// Returns the number of texture cache overlaps resolved with host GPU copies since the last
+    /// call, and the number of overlaps that had to round trip through guest memory.
+    virtual std::pair<u32, u32> GetAndResetSurfaceOverlapStats() {
+        return {};
+    }
+
+    /// Returns the mean number of guest bytes per frame whose texture upload was skipped because
+    /// their contents didn't change, since the last call.
+    virtual u64 GetAndResetSkippedUploadStats() {
+        return 0;
+    }
+
+    /// Returns the mean number of bytes per frame uploaded to stream buffers since the last call,
+    /// and the mean number of const buffer bytes whose previous upload was reused.
+    virtual std::pair<u64, u64> GetAndResetBufferUploadStats() {
+        return {};
+    }
+
     /// Increase/decrease the number of object in pages touching the specified region
     virtual void UpdatePagesCachedCount(VAddr addr, u64 size, int delta) {}
 
@@ -2,13 +2,33 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "core/frontend/emu_window.h"
 #include "core/settings.h"
 #include "video_core/renderer_base.h"
+#include "video_core/surface.h"
+#include "video_core/textures/decoders.h"
 
 namespace VideoCore {
 
+u64 HashFramebufferMemory(const Tegra::FramebufferConfig& framebuffer, const u8* host_ptr,
+                          u32 block_height_log2) {
+    const auto pixel_format = Surface::PixelFormatFromGPUPixelFormat(framebuffer.pixel_format);
+    const u32 bytes_per_pixel = Surface::GetBytesPerPixel(pixel_format);
+    const std::size_t size =
+        Tegra::Texture::CalculateSize(true, bytes_per_pixel, framebuffer.stride,
+                                      framebuffer.height, 1, block_height_log2, 0);
+
+    const std::array<u64, 4> config{
+        framebuffer.address + framebuffer.offset, framebuffer.width, framebuffer.height,
+        static_cast<u64>(framebuffer.stride) << 32 | static_cast<u32>(framebuffer.pixel_format)};
+    const u64 seed = Common::HashValue(config.data(), sizeof(config));
+    return Common::HashValue(host_ptr, size, seed);
+}
+
 RendererBase::RendererBase(Core::Frontend::EmuWindow& window) : render_window{window} {
     RefreshBaseSettings();
 }
@@ -30,6 +30,13 @@ struct RendererSettings {
     Layout::FramebufferLayout screenshot_framebuffer_layout;
 };
 
+/**
+ * Hashes the guest memory of a block linear framebuffer together with its configuration. The
+ * renderers use it to skip unswizzling and uploading frames that didn't change.
+ */
+u64 HashFramebufferMemory(const Tegra::FramebufferConfig& framebuffer, const u8* host_ptr,
+                          u32 block_height_log2);
+
 class RendererBase : NonCopyable {
 public:
     explicit RendererBase(Core::Frontend::EmuWindow& window);
@@ -44,6 +51,12 @@ public:
     /// Shutdown the renderer
     virtual void ShutDown() = 0;
 
+    /**
+     * Replaces the rasterizer with a fresh one, dropping every cache built from the guest memory
+     * of the previous session while keeping the window, context and presentation resources.
+     */
+    virtual void ResetRasterizer() = 0;
+
     // Getter/setter functions:
     // ------------------------
 
@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/core.h"
+#include "video_core/gpu.h"
+#include "video_core/renderer_null/rasterizer_null.h"
+
+namespace Null {
+
+RasterizerNull::RasterizerNull(Core::System& system) : system{system} {}
+
+RasterizerNull::~RasterizerNull() = default;
+
+bool RasterizerNull::DrawBatch(bool is_indexed) {
+    return true;
+}
+
+bool RasterizerNull::DrawMultiBatch(bool is_indexed) {
+    return true;
+}
+
+void RasterizerNull::Clear() {}
+
+void RasterizerNull::DispatchCompute(GPUVAddr code_addr) {}
+
+void RasterizerNull::FlushAll() {}
+
+void RasterizerNull::FlushRegion(CacheAddr addr, u64 size) {}
+
+void RasterizerNull::InvalidateRegion(CacheAddr addr, u64 size) {}
+
+void RasterizerNull::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {}
+
+void RasterizerNull::SignalSyncPoint(u32 syncpoint_id) {
+    // Nothing is ever pending on the host, so the syncpoint is reached right away
+    system.GPU().IncrementSyncPoint(syncpoint_id);
+}
+
+void RasterizerNull::ReleaseFences() {}
+
+void RasterizerNull::FlushCommands() {}
+
+void RasterizerNull::TickFrame() {}
+
+bool RasterizerNull::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
+                                           const Tegra::Engines::Fermi2D::Regs::Surface& dst,
+                                           const Tegra::Engines::Fermi2D::Config& copy_config) {
+    return true;
+}
+
+bool RasterizerNull::AccelerateDisplay(const Tegra::FramebufferConfig& config,
+                                       VAddr framebuffer_addr, u32 pixel_stride) {
+    return true;
+}
+
+} // namespace Null
@@ -0,0 +1,37 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "video_core/renderer_null/rasterizer_null.h"
+#include "video_core/renderer_null/renderer_null.h"
+
+namespace Null {
+
+RendererNull::RendererNull(Core::Frontend::EmuWindow& emu_window, Core::System& system)
+    : RendererBase{emu_window}, system{system} {}
+
+RendererNull::~RendererNull() = default;
+
+bool RendererNull::Init() {
+    rasterizer = std::make_unique<RasterizerNull>(system);
+    return true;
+}
+
+void RendererNull::ShutDown() {}
+
+void RendererNull::ResetRasterizer() {
+    rasterizer = std::make_unique<RasterizerNull>(system);
+}
+
+void RendererNull::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    if (framebuffer) {
+        ++m_current_frame;
+    }
+    render_window.PollEvents();
+}
+
+} // namespace Null
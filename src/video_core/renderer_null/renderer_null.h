@@ -0,0 +1,33 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "video_core/renderer_base.h"
+
+namespace Core {
+class System;
+}
+
+namespace Null {
+
+/**
+ * Renderer that never touches a graphics API. Frames are acknowledged without being presented,
+ * which lets the CPU and HLE side of the emulation run without a host GPU.
+ */
+class RendererNull final : public VideoCore::RendererBase {
+public:
+    explicit RendererNull(Core::Frontend::EmuWindow& emu_window, Core::System& system);
+    ~RendererNull() override;
+
+    bool Init() override;
+    void ShutDown() override;
+    void ResetRasterizer() override;
+    void SwapBuffers(const Tegra::FramebufferConfig* framebuffer) override;
+
+private:
+    Core::System& system;
+};
+
+} // namespace Null
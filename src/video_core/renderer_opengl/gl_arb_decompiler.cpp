@@ -0,0 +1,2025 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include <fmt/format.h>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/renderer_opengl/gl_arb_decompiler.h"
+#include "video_core/renderer_opengl/gl_device.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#include "video_core/shader/ast.h"
+#include "video_core/shader/expr.h"
+#include "video_core/shader/node.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace OpenGL {
+
+namespace {
+
+using Tegra::Engines::ShaderType;
+using Tegra::Shader::Attribute;
+using Tegra::Shader::AttributeUse;
+using Tegra::Shader::Header;
+using Tegra::Shader::ImageType;
+using Tegra::Shader::Register;
+using Tegra::Shader::TextureType;
+
+using namespace VideoCommon::Shader;
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+using Operation = const OperationNode&;
+
+class ASTDecompiler;
+class ExprDecompiler;
+
+constexpr u32 FLOW_STACK_SIZE = 20;
+
+constexpr char Swizzle(std::size_t element) {
+    constexpr std::string_view swizzle = "xyzw";
+    return swizzle.at(element);
+}
+
+constexpr bool IsGenericAttribute(Attribute::Index index) {
+    return index >= Attribute::Index::Attribute_0 && index <= Attribute::Index::Attribute_31;
+}
+
+u32 GetGenericAttributeIndex(Attribute::Index index) {
+    ASSERT(IsGenericAttribute(index));
+    return static_cast<u32>(index) - static_cast<u32>(Attribute::Index::Attribute_0);
+}
+
+/// Returns the name of the decompiled program of a stage, programs of the same stage are named
+/// after the one they follow
+const char* GetStageName(ShaderType stage, bool is_second_program) {
+    switch (stage) {
+    case ShaderType::Vertex:
+        return is_second_program ? "vertex_b" : "vertex";
+    case ShaderType::Geometry:
+        return "geometry";
+    case ShaderType::Fragment:
+        return "fragment";
+    default:
+        UNREACHABLE_MSG("Unsupported assembly stage={}", static_cast<u32>(stage));
+        return "vertex";
+    }
+}
+
+/// Returns the name of the thread input of a stage
+const char* GetStageInputName(ShaderType stage) {
+    switch (stage) {
+    case ShaderType::Geometry:
+        return "primitive";
+    case ShaderType::Fragment:
+        return "fragment";
+    default:
+        return "vertex";
+    }
+}
+
+/// Describes the input primitive of geometry programs, variants come normalized from the caller
+std::pair<const char*, u32> GetInputPrimitive(GLenum primitive_mode) {
+    switch (primitive_mode) {
+    case GL_LINES:
+        return {"LINES", 2};
+    case GL_LINES_ADJACENCY:
+        return {"LINES_ADJACENCY", 4};
+    case GL_TRIANGLES:
+        return {"TRIANGLES", 3};
+    case GL_TRIANGLES_ADJACENCY:
+        return {"TRIANGLES_ADJACENCY", 6};
+    default:
+        return {"POINTS", 1};
+    }
+}
+
+const char* GetOutputTopologyName(Tegra::Shader::OutputTopology topology) {
+    switch (topology) {
+    case Tegra::Shader::OutputTopology::PointList:
+        return "POINTS";
+    case Tegra::Shader::OutputTopology::LineStrip:
+        return "LINE_STRIP";
+    case Tegra::Shader::OutputTopology::TriangleStrip:
+        return "TRIANGLE_STRIP";
+    default:
+        UNIMPLEMENTED_MSG("Unknown output topology: {}", static_cast<u32>(topology));
+        return "POINTS";
+    }
+}
+
+const char* GetTextureTarget(const Sampler& sampler) {
+    if (sampler.IsBuffer()) {
+        return "BUFFER";
+    }
+    const bool is_array = sampler.IsArray();
+    const bool is_shadow = sampler.IsShadow();
+    switch (sampler.GetType()) {
+    case TextureType::Texture1D:
+        if (is_shadow) {
+            return is_array ? "SHADOWARRAY1D" : "SHADOW1D";
+        }
+        return is_array ? "ARRAY1D" : "1D";
+    case TextureType::Texture2D:
+        if (is_shadow) {
+            return is_array ? "SHADOWARRAY2D" : "SHADOW2D";
+        }
+        return is_array ? "ARRAY2D" : "2D";
+    case TextureType::Texture3D:
+        return "3D";
+    case TextureType::TextureCube:
+        if (is_shadow) {
+            return is_array ? "SHADOWARRAYCUBE" : "SHADOWCUBE";
+        }
+        return is_array ? "ARRAYCUBE" : "CUBE";
+    }
+    UNREACHABLE();
+    return "2D";
+}
+
+const char* GetImageTarget(ImageType image_type) {
+    switch (image_type) {
+    case ImageType::Texture1D:
+        return "1D";
+    case ImageType::TextureBuffer:
+        return "BUFFER";
+    case ImageType::Texture1DArray:
+        return "ARRAY1D";
+    case ImageType::Texture2D:
+        return "2D";
+    case ImageType::Texture2DArray:
+        return "ARRAY2D";
+    case ImageType::Texture3D:
+        return "3D";
+    }
+    UNREACHABLE();
+    return "2D";
+}
+
+/// Mnemonics of the instructions that map one to one to an IR operation
+struct Op final {
+    Op() = delete;
+    ~Op() = delete;
+
+    static constexpr std::string_view ADD_F = "ADD.F";
+    static constexpr std::string_view ADD_S = "ADD.S";
+    static constexpr std::string_view ADD_U = "ADD.U";
+    static constexpr std::string_view MUL_F = "MUL.F";
+    static constexpr std::string_view MUL_S = "MUL.S";
+    static constexpr std::string_view MUL_U = "MUL.U";
+    static constexpr std::string_view DIV_F = "DIV.F";
+    static constexpr std::string_view DIV_S = "DIV.S";
+    static constexpr std::string_view DIV_U = "DIV.U";
+    static constexpr std::string_view MAD_F = "MAD.F";
+    static constexpr std::string_view ABS_F = "ABS.F";
+    static constexpr std::string_view ABS_S = "ABS.S";
+    static constexpr std::string_view MIN_F = "MIN.F";
+    static constexpr std::string_view MIN_S = "MIN.S";
+    static constexpr std::string_view MIN_U = "MIN.U";
+    static constexpr std::string_view MAX_F = "MAX.F";
+    static constexpr std::string_view MAX_S = "MAX.S";
+    static constexpr std::string_view MAX_U = "MAX.U";
+    static constexpr std::string_view COS_F = "COS.F";
+    static constexpr std::string_view SIN_F = "SIN.F";
+    static constexpr std::string_view EX2_F = "EX2.F";
+    static constexpr std::string_view LG2_F = "LG2.F";
+    static constexpr std::string_view RSQ_F = "RSQ.F";
+    static constexpr std::string_view ROUND_F = "ROUND.F";
+    static constexpr std::string_view FLR_F = "FLR.F";
+    static constexpr std::string_view CEIL_F = "CEIL.F";
+    static constexpr std::string_view TRUNC_F = "TRUNC.F";
+    static constexpr std::string_view I2F_S = "I2F.S";
+    static constexpr std::string_view I2F_U = "I2F.U";
+    static constexpr std::string_view F2I_S = "F2I.S";
+    static constexpr std::string_view F2I_U = "F2I.U";
+    static constexpr std::string_view SHL_U = "SHL.U";
+    static constexpr std::string_view SHR_S = "SHR.S";
+    static constexpr std::string_view SHR_U = "SHR.U";
+    static constexpr std::string_view AND_U = "AND.U";
+    static constexpr std::string_view OR_U = "OR.U";
+    static constexpr std::string_view XOR_U = "XOR.U";
+    static constexpr std::string_view NOT_U = "NOT.U";
+    static constexpr std::string_view BFI_S = "BFI.S";
+    static constexpr std::string_view BFI_U = "BFI.U";
+    static constexpr std::string_view BFE_S = "BFE.S";
+    static constexpr std::string_view BFE_U = "BFE.U";
+    static constexpr std::string_view BTC_U = "BTC.U";
+    static constexpr std::string_view BTFM_S = "BTFM.S";
+    static constexpr std::string_view BTFM_U = "BTFM.U";
+
+    static constexpr std::string_view SLT = "SLT";
+    static constexpr std::string_view SEQ = "SEQ";
+    static constexpr std::string_view SLE = "SLE";
+    static constexpr std::string_view SGT = "SGT";
+    static constexpr std::string_view SNE = "SNE";
+    static constexpr std::string_view SGE = "SGE";
+
+    static constexpr std::string_view F = "F";
+    static constexpr std::string_view S = "S";
+    static constexpr std::string_view U = "U";
+
+    static constexpr std::string_view ATOM_ADD = "ADD";
+    static constexpr std::string_view ATOM_AND = "AND";
+    static constexpr std::string_view ATOM_OR = "OR";
+    static constexpr std::string_view ATOM_XOR = "XOR";
+    static constexpr std::string_view ATOM_EXCH = "EXCH";
+};
+
+/**
+ * Decompiles a shader program to the body of an NV_gpu_program5 subroutine.
+ *
+ * Every value lives in the x component of a typeless temporary, the data type modifier of each
+ * instruction tells how its bits are interpreted. Booleans are -1 when true and 0 when false, so
+ * they work with both the bitwise instructions and the sign test of CMP. Pairs of booleans produced
+ * by half float comparisons are packed in the two lowest bits of a value.
+ */
+class ARBDecompiler final {
+public:
+    explicit ARBDecompiler(const Device& device, const ShaderIR& ir, ShaderType stage,
+                           std::string suffix, const ProgramVariant& variant)
+        : device{device}, ir{ir}, stage{stage}, suffix{std::move(suffix)}, variant{variant},
+          header{ir.GetHeader()} {}
+
+    void Decompile() {
+        AddLine("execute_{}:", suffix);
+        ++scope;
+        InitializeVariables();
+        if (ir.IsDecompiled()) {
+            DecompileAST();
+        } else {
+            DecompileBranchMode();
+        }
+        --scope;
+        AddLine("RET;");
+    }
+
+    /// Returns the declarations of the variables and resources used by the decompiled code
+    std::string GetDeclarations() const;
+
+    std::string GetCode() const {
+        return code;
+    }
+
+private:
+    friend class ASTDecompiler;
+    friend class ExprDecompiler;
+
+    template <typename... Args>
+    void AddLine(std::string_view text, Args&&... args) {
+        code.append(static_cast<std::size_t>(scope) * 4, ' ');
+        code += fmt::format(text, std::forward<Args>(args)...);
+        code += '\n';
+    }
+
+    /// Returns a scalar temporary, valid until the end of the statement being decompiled
+    std::string AllocTemporary() {
+        return AllocVectorTemporary() + ".x";
+    }
+
+    /// Returns a vector temporary, valid until the end of the statement being decompiled
+    std::string AllocVectorTemporary() {
+        const u32 index = num_temporaries++;
+        max_temporaries = std::max(max_temporaries, num_temporaries);
+        return fmt::format("T{}_{}", index, suffix);
+    }
+
+    void ResetTemporaries() {
+        num_temporaries = 0;
+    }
+
+    std::string Immediate(s64 value) {
+        std::string temporary = AllocTemporary();
+        AddLine("MOV.S {}, {};", temporary, value);
+        return temporary;
+    }
+
+    std::string GetRegister(u32 index) const {
+        return fmt::format("R{}_{}.x", index, suffix);
+    }
+
+    std::string GetCustomVariable(u32 index) const {
+        return fmt::format("CV{}_{}.x", index, suffix);
+    }
+
+    std::string GetFlowVariable(u32 index) const {
+        return fmt::format("F{}_{}.x", index, suffix);
+    }
+
+    std::string GetInternalFlag(InternalFlag flag) const {
+        return fmt::format("FLAGS_{}.{}", suffix, Swizzle(static_cast<std::size_t>(flag)));
+    }
+
+    std::string GetPredicate(Tegra::Shader::Pred pred) {
+        switch (pred) {
+        case Tegra::Shader::Pred::UnusedIndex:
+            return Immediate(-1);
+        case Tegra::Shader::Pred::NeverExecute:
+            return Immediate(0);
+        default:
+            return fmt::format("P{}_{}.x", static_cast<u32>(pred), suffix);
+        }
+    }
+
+    std::string GetFlowStack(MetaStackClass stack) const {
+        return fmt::format("{}_{}", stack == MetaStackClass::Ssy ? "SSY" : "PBK", suffix);
+    }
+
+    std::string GetFlowStackTop(MetaStackClass stack) const {
+        return fmt::format("{}_TOP_{}.x", stack == MetaStackClass::Ssy ? "SSY" : "PBK", suffix);
+    }
+
+    std::string GetConstBuffer(u32 index) const {
+        return fmt::format("cbuf{}_{}", index, suffix);
+    }
+
+    std::string GetGlobalMemory(const GlobalMemoryBase& base) const {
+        const auto& entries = ir.GetGlobalMemory();
+        const auto it = entries.find(base);
+        ASSERT(it != entries.end());
+        return fmt::format("gmem{}_{}", std::distance(entries.begin(), it), suffix);
+    }
+
+    u32 GetSamplerBinding(const Sampler& sampler) const {
+        u32 binding = device.GetBaseBindings(stage).sampler;
+        for (const auto& entry : ir.GetSamplers()) {
+            if (entry.GetIndex() == sampler.GetIndex()) {
+                return binding;
+            }
+            binding += entry.IsIndexed() ? entry.Size() : 1;
+        }
+        UNREACHABLE();
+        return binding;
+    }
+
+    u32 GetImageBinding(const Image& image) const {
+        u32 binding = device.GetBaseBindings(stage).image;
+        for (const auto& entry : ir.GetImages()) {
+            if (entry.GetIndex() == image.GetIndex()) {
+                return binding;
+            }
+            ++binding;
+        }
+        UNREACHABLE();
+        return binding;
+    }
+
+    void InitializeVariables();
+
+    void DecompileBranchMode();
+
+    void DecompileAST();
+
+    void VisitBlock(const NodeBlock& bb) {
+        for (const auto& node : bb) {
+            Visit(node);
+            ResetTemporaries();
+        }
+    }
+
+    std::string Visit(const Node& node);
+
+    std::string ReadAttribute(Attribute::Index attribute, u32 element, const Node& buffer);
+
+    std::string GetOutputAttribute(const AbufNode& abuf);
+
+    /// Returns the index of the vertex read by a geometry program, guarded against out of bounds
+    std::string GetGeometryVertex(const Node& buffer) {
+        const std::string temporary = AllocTemporary();
+        AddLine("MOD.U {}, {}, {};", temporary, Visit(buffer),
+                GetInputPrimitive(variant.primitive_mode).second);
+        return temporary;
+    }
+
+    /// Flags a condition as the one tested by the next conditional instruction
+    void SetCondition(const std::string& value) {
+        AddLine("MOV.S.CC RC.x, {};", value);
+    }
+
+    /// Returns a boolean with the result of the last instruction that updated the condition
+    std::string ConditionToBoolean() {
+        const std::string temporary = AllocTemporary();
+        AddLine("MOV.S {}, 0;", temporary);
+        AddLine("MOV.S {} (NE.x), -1;", temporary);
+        return temporary;
+    }
+
+    std::string UnpackHalf(const Node& node) {
+        const std::string value = Visit(node);
+        const std::string temporary = AllocVectorTemporary();
+        AddLine("UP2H.F {}, {};", temporary, value);
+        return temporary;
+    }
+
+    std::string PackHalf(const std::string& vector) {
+        const std::string temporary = AllocTemporary();
+        AddLine("PK2H.F {}, {};", temporary, vector);
+        return temporary;
+    }
+
+    void PreExit();
+
+    template <const std::string_view& op>
+    std::string Unary(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        const std::string temporary = AllocTemporary();
+        AddLine("{} {}, {};", op, temporary, value);
+        return temporary;
+    }
+
+    template <const std::string_view& op>
+    std::string Binary(Operation operation) {
+        const std::string op_a = Visit(operation[0]);
+        const std::string op_b = Visit(operation[1]);
+        const std::string temporary = AllocTemporary();
+        AddLine("{} {}, {}, {};", op, temporary, op_a, op_b);
+        return temporary;
+    }
+
+    template <const std::string_view& op>
+    std::string Ternary(Operation operation) {
+        const std::string op_a = Visit(operation[0]);
+        const std::string op_b = Visit(operation[1]);
+        const std::string op_c = Visit(operation[2]);
+        const std::string temporary = AllocTemporary();
+        AddLine("{} {}, {}, {}, {};", op, temporary, op_a, op_b, op_c);
+        return temporary;
+    }
+
+    template <const std::string_view& op, const std::string_view& type>
+    std::string Compare(Operation operation) {
+        const std::string op_a = Visit(operation[0]);
+        const std::string op_b = Visit(operation[1]);
+        AddLine("{}.{}.CC RC.x, {}, {};", op, type, op_a, op_b);
+        return ConditionToBoolean();
+    }
+
+    template <const std::string_view& type>
+    std::string Negate(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        const std::string temporary = AllocTemporary();
+        AddLine("MOV.{} {}, -{};", type, temporary, value);
+        return temporary;
+    }
+
+    /// Operations that leave the bits of their operand untouched
+    std::string Identity(Operation operation) {
+        return Visit(operation[0]);
+    }
+
+    template <const std::string_view& op>
+    std::string BitfieldInsert(Operation operation) {
+        const std::string base = Visit(operation[0]);
+        const std::string insert = Visit(operation[1]);
+        const std::string offset = Visit(operation[2]);
+        const std::string bits = Visit(operation[3]);
+        const std::string field = AllocVectorTemporary();
+        AddLine("MOV.U {}.x, {};", field, bits);
+        AddLine("MOV.U {}.y, {};", field, offset);
+        const std::string temporary = AllocTemporary();
+        AddLine("{} {}, {}, {}, {};", op, temporary, field, insert, base);
+        return temporary;
+    }
+
+    template <const std::string_view& op>
+    std::string BitfieldExtract(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        const std::string offset = Visit(operation[1]);
+        const std::string bits = Visit(operation[2]);
+        const std::string field = AllocVectorTemporary();
+        AddLine("MOV.U {}.x, {};", field, bits);
+        AddLine("MOV.U {}.y, {};", field, offset);
+        const std::string temporary = AllocTemporary();
+        AddLine("{} {}, {}, {};", op, temporary, field, value);
+        return temporary;
+    }
+
+    std::string Assign(Operation operation);
+
+    std::string Select(Operation operation) {
+        const std::string condition = Visit(operation[0]);
+        const std::string true_case = Visit(operation[1]);
+        const std::string false_case = Visit(operation[2]);
+        const std::string temporary = AllocTemporary();
+        AddLine("CMP.S {}, {}, {}, {};", temporary, condition, true_case, false_case);
+        return temporary;
+    }
+
+    std::string FClamp(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        const std::string min = Visit(operation[1]);
+        const std::string max = Visit(operation[2]);
+        const std::string temporary = AllocTemporary();
+        AddLine("MAX.F {}, {}, {};", temporary, value, min);
+        AddLine("MIN.F {}, {}, {};", temporary, temporary, max);
+        return temporary;
+    }
+
+    template <std::size_t element>
+    std::string FCastHalf(Operation operation) {
+        return fmt::format("{}.{}", UnpackHalf(operation[0]), Swizzle(element));
+    }
+
+    std::string FSqrt(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        const std::string temporary = AllocTemporary();
+        AddLine("RSQ.F {}, {};", temporary, value);
+        AddLine("RCP.F {}, {};", temporary, temporary);
+        return temporary;
+    }
+
+    std::string FSwizzleAdd(Operation operation);
+
+    std::string HAdd(Operation operation) {
+        const std::string op_a = UnpackHalf(operation[0]);
+        const std::string op_b = UnpackHalf(operation[1]);
+        AddLine("ADD.F {}.xy, {}, {};", op_a, op_a, op_b);
+        return PackHalf(op_a);
+    }
+
+    std::string HMul(Operation operation) {
+        const std::string op_a = UnpackHalf(operation[0]);
+        const std::string op_b = UnpackHalf(operation[1]);
+        AddLine("MUL.F {}.xy, {}, {};", op_a, op_a, op_b);
+        return PackHalf(op_a);
+    }
+
+    std::string HFma(Operation operation) {
+        const std::string op_a = UnpackHalf(operation[0]);
+        const std::string op_b = UnpackHalf(operation[1]);
+        const std::string op_c = UnpackHalf(operation[2]);
+        AddLine("MAD.F {}.xy, {}, {}, {};", op_a, op_a, op_b, op_c);
+        return PackHalf(op_a);
+    }
+
+    std::string HAbsolute(Operation operation) {
+        const std::string value = UnpackHalf(operation[0]);
+        AddLine("ABS.F {}.xy, {};", value, value);
+        return PackHalf(value);
+    }
+
+    std::string HNegate(Operation operation) {
+        const std::string value = UnpackHalf(operation[0]);
+        for (std::size_t element = 0; element < 2; ++element) {
+            SetCondition(Visit(operation[element + 1]));
+            AddLine("MOV.F {}.{} (NE.x), -{}.{};", value, Swizzle(element), value,
+                    Swizzle(element));
+        }
+        return PackHalf(value);
+    }
+
+    std::string HClamp(Operation operation) {
+        const std::string value = UnpackHalf(operation[0]);
+        const std::string min = Visit(operation[1]);
+        const std::string max = Visit(operation[2]);
+        AddLine("MAX.F {}.xy, {}, {};", value, value, min);
+        AddLine("MIN.F {}.xy, {}, {};", value, value, max);
+        return PackHalf(value);
+    }
+
+    std::string HCastFloat(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        const std::string temporary = AllocVectorTemporary();
+        AddLine("MOV.F {}.x, {};", temporary, value);
+        AddLine("MOV.F {}.y, 0;", temporary);
+        return PackHalf(temporary);
+    }
+
+    std::string HUnpack(Operation operation);
+
+    std::string HMergeF32(Operation operation) {
+        return UnpackHalf(operation[0]) + ".x";
+    }
+
+    std::string HMergeH0(Operation operation) {
+        return HalfMerge(Visit(operation[1]), Visit(operation[0]));
+    }
+
+    std::string HMergeH1(Operation operation) {
+        return HalfMerge(Visit(operation[0]), Visit(operation[1]));
+    }
+
+    /// Returns the low half of one value joined with the high half of the other
+    std::string HalfMerge(const std::string& low, const std::string& high) {
+        const std::string low_half = AllocTemporary();
+        const std::string temporary = AllocTemporary();
+        AddLine("AND.U {}, {}, 65535;", low_half, low);
+        AddLine("AND.U {}, {}, 4294901760;", temporary, high);
+        AddLine("OR.U {}, {}, {};", temporary, temporary, low_half);
+        return temporary;
+    }
+
+    std::string HPack2(Operation operation) {
+        const std::string low = Visit(operation[0]);
+        const std::string high = Visit(operation[1]);
+        const std::string temporary = AllocVectorTemporary();
+        AddLine("MOV.F {}.x, {};", temporary, low);
+        AddLine("MOV.F {}.y, {};", temporary, high);
+        return PackHalf(temporary);
+    }
+
+    std::string LogicalAssign(Operation operation);
+
+    std::string LogicalPick2(Operation operation) {
+        const std::string pair = Visit(operation[0]);
+        const std::string index = Visit(operation[1]);
+        const std::string temporary = AllocTemporary();
+        AddLine("SHR.U {}, {}, {};", temporary, pair, index);
+        AddLine("AND.U {}, {}, 1;", temporary, temporary);
+        AddLine("MOV.S {}, -{};", temporary, temporary);
+        return temporary;
+    }
+
+    std::string LogicalAnd2(Operation operation) {
+        AddLine("SEQ.U.CC RC.x, {}, 3;", Visit(operation[0]));
+        return ConditionToBoolean();
+    }
+
+    std::string LogicalFIsNan(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        AddLine("SNE.F.CC RC.x, {}, {};", value, value);
+        return ConditionToBoolean();
+    }
+
+    template <const std::string_view& op, bool with_nan>
+    std::string HalfComparison(Operation operation) {
+        const std::string op_a = UnpackHalf(operation[0]);
+        const std::string op_b = UnpackHalf(operation[1]);
+        const std::string result = AllocVectorTemporary();
+        AddLine("{}.F {}.xy, {}, {};", op, result, op_a, op_b);
+        if constexpr (with_nan) {
+            const std::string is_nan = AllocVectorTemporary();
+            for (const std::string* const operand : {&op_a, &op_b}) {
+                AddLine("SNE.F {}.xy, {}, {};", is_nan, *operand, *operand);
+                AddLine("MAX.F {}.xy, {}, {};", result, result, is_nan);
+            }
+        }
+        // Pack the pair of comparisons in the two lowest bits
+        AddLine("MAD.F {}.x, {}.y, 2, {}.x;", result, result, result);
+        AddLine("F2I.U {}.x, {}.x;", result, result);
+        return result + ".x";
+    }
+
+    /**
+     * Builds the coordinates of a texture instruction in a vector, followed by the array layer and
+     * the depth compare reference when the sampler has them.
+     * @param num_components Returns the number of components written to the vector
+     */
+    std::string BuildTextureCoords(Operation operation, std::size_t& num_components);
+
+    /// Returns the texture offsets of an instruction, only immediate offsets are supported
+    std::string BuildTextureOffsets(const MetaTexture& meta);
+
+    std::string BuildIntegerCoords(Operation operation) {
+        const std::string temporary = AllocVectorTemporary();
+        for (std::size_t i = 0; i < operation.GetOperandsCount(); ++i) {
+            AddLine("MOV.S {}.{}, {};", temporary, Swizzle(i), Visit(operation[i]));
+        }
+        return temporary;
+    }
+
+    std::string GetTexture(const MetaTexture& meta) {
+        UNIMPLEMENTED_IF_MSG(meta.sampler.IsIndexed(), "Indexed samplers are not implemented");
+        return fmt::format("texture[{}]", GetSamplerBinding(meta.sampler));
+    }
+
+    /// Samples a texture, extra is the level of detail or the bias of the lookup when present
+    std::string SampleTexture(Operation operation, const Node& extra, std::string_view opcode);
+
+    std::string Texture(Operation operation) {
+        const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+        return SampleTexture(operation, meta.bias, "TXB");
+    }
+
+    std::string TextureLod(Operation operation) {
+        const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+        return SampleTexture(operation, meta.lod, "TXL");
+    }
+
+    std::string TextureGather(Operation operation);
+
+    std::string TextureQueryDimensions(Operation operation);
+
+    std::string TextureQueryLod(Operation operation);
+
+    std::string TexelFetch(Operation operation);
+
+    std::string TextureGradient(Operation operation);
+
+    std::string ImageLoad(Operation operation);
+
+    std::string ImageStore(Operation operation);
+
+    template <const std::string_view& op>
+    std::string AtomicImage(Operation operation) {
+        const auto& meta = std::get<MetaImage>(operation.GetMeta());
+        ASSERT(meta.values.size() == 1);
+
+        const std::string coords = BuildIntegerCoords(operation);
+        const std::string value = Visit(meta.values[0]);
+        const std::string temporary = AllocTemporary();
+        AddLine("ATOMIM.{}.U32 {}, {}, {}, image[{}], {};", op, temporary, value, coords,
+                GetImageBinding(meta.image), GetImageTarget(meta.image.GetType()));
+        return temporary;
+    }
+
+    std::string AtomicAdd(Operation operation);
+
+    std::string Branch(Operation operation) {
+        const auto target = std::get_if<ImmediateNode>(&*operation[0]);
+        UNIMPLEMENTED_IF(!target);
+
+        AddLine("MOV.U PC_{}.x, {};", suffix, target->GetValue());
+        AddLine("CONT;");
+        return {};
+    }
+
+    std::string BranchIndirect(Operation operation) {
+        AddLine("MOV.U PC_{}.x, {};", suffix, Visit(operation[0]));
+        AddLine("CONT;");
+        return {};
+    }
+
+    std::string PushFlowStack(Operation operation) {
+        const auto stack = std::get<MetaStackClass>(operation.GetMeta());
+        const auto target = std::get_if<ImmediateNode>(&*operation[0]);
+        UNIMPLEMENTED_IF(!target);
+
+        const std::string top = GetFlowStackTop(stack);
+        AddLine("MOV.U {}[{}].x, {};", GetFlowStack(stack), top, target->GetValue());
+        AddLine("ADD.S {}, {}, 1;", top, top);
+        return {};
+    }
+
+    std::string PopFlowStack(Operation operation) {
+        const auto stack = std::get<MetaStackClass>(operation.GetMeta());
+        const std::string top = GetFlowStackTop(stack);
+        AddLine("SUB.S {}, {}, 1;", top, top);
+        AddLine("MOV.U PC_{}.x, {}[{}].x;", suffix, GetFlowStack(stack), top);
+        AddLine("CONT;");
+        return {};
+    }
+
+    std::string Exit(Operation operation) {
+        PreExit();
+        AddLine("RET;");
+        return {};
+    }
+
+    std::string Discard(Operation operation) {
+        AddLine("KIL TR;");
+        return {};
+    }
+
+    std::string EmitVertex(Operation operation) {
+        ASSERT_MSG(stage == ShaderType::Geometry,
+                   "EmitVertex is expected to be used in a geometry shader.");
+        AddLine("EMIT;");
+        return {};
+    }
+
+    std::string EndPrimitive(Operation operation) {
+        ASSERT_MSG(stage == ShaderType::Geometry,
+                   "EndPrimitive is expected to be used in a geometry shader.");
+        AddLine("ENDPRIM;");
+        return {};
+    }
+
+    std::string InvocationId(Operation operation) {
+        return "primitive.invocation.x";
+    }
+
+    std::string YNegate(Operation operation) {
+        const std::string temporary = AllocTemporary();
+        AddLine("LDC.F32 {}, emulation[0];", temporary);
+        return temporary;
+    }
+
+    std::string ComputeOnly(Operation operation) {
+        UNREACHABLE_MSG("Compute operations are not available in assembly programs");
+        return Immediate(0);
+    }
+
+    std::string BallotThread(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        if (!device.HasWarpIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Nvidia vote intrinsics are required by this shader");
+            // Stub on non-Nvidia devices by simulating all threads voting the same as the active
+            // one.
+            return value;
+        }
+        const std::string temporary = AllocTemporary();
+        AddLine("TGBALLOT.U {}, {};", temporary, value);
+        return temporary;
+    }
+
+    std::string Vote(Operation operation, std::string_view op) {
+        const std::string value = Visit(operation[0]);
+        if (!device.HasWarpIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Nvidia vote intrinsics are required by this shader");
+            // Stub with a warp size of one.
+            return value;
+        }
+        AddLine("{}.S.CC RC.x, {};", op, value);
+        return ConditionToBoolean();
+    }
+
+    std::string VoteAll(Operation operation) {
+        return Vote(operation, "TGALL");
+    }
+
+    std::string VoteAny(Operation operation) {
+        return Vote(operation, "TGANY");
+    }
+
+    std::string VoteEqual(Operation operation) {
+        if (!device.HasWarpIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Nvidia vote intrinsics are required by this shader");
+            // A theoretical warp size of one always votes equal
+            return Immediate(-1);
+        }
+        return Vote(operation, "TGEQ");
+    }
+
+    std::string ThreadId(Operation operation) {
+        if (!device.HasWarpIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Nvidia thread groups are required by this shader");
+            return Immediate(0);
+        }
+        const std::string temporary = AllocTemporary();
+        AddLine("MOV.U {}, {}.threadid;", temporary, GetStageInputName(stage));
+        return temporary;
+    }
+
+    std::string ShuffleIndexed(Operation operation) {
+        const std::string value = Visit(operation[0]);
+        if (!device.HasWarpIntrinsics()) {
+            LOG_ERROR(Render_OpenGL, "Nvidia thread shuffles are required by this shader");
+            return value;
+        }
+        const std::string index = Visit(operation[1]);
+        const std::string temporary = AllocTemporary();
+        AddLine("SHFIDX.U {}, {}, {}, {{31, 0, 0, 0}};", temporary, value, index);
+        return temporary;
+    }
+
+    std::string MemoryBarrierGL(Operation operation) {
+        AddLine("MEMBAR;");
+        return {};
+    }
+
+    static constexpr std::array operation_decompilers = {
+        &ARBDecompiler::Assign,
+        &ARBDecompiler::Select,
+
+        &ARBDecompiler::Binary<Op::ADD_F>,
+        &ARBDecompiler::Binary<Op::MUL_F>,
+        &ARBDecompiler::Binary<Op::DIV_F>,
+        &ARBDecompiler::Ternary<Op::MAD_F>,
+        &ARBDecompiler::Negate<Op::F>,
+        &ARBDecompiler::Unary<Op::ABS_F>,
+        &ARBDecompiler::FClamp,
+        &ARBDecompiler::FCastHalf<0>,
+        &ARBDecompiler::FCastHalf<1>,
+        &ARBDecompiler::Binary<Op::MIN_F>,
+        &ARBDecompiler::Binary<Op::MAX_F>,
+        &ARBDecompiler::Unary<Op::COS_F>,
+        &ARBDecompiler::Unary<Op::SIN_F>,
+        &ARBDecompiler::Unary<Op::EX2_F>,
+        &ARBDecompiler::Unary<Op::LG2_F>,
+        &ARBDecompiler::Unary<Op::RSQ_F>,
+        &ARBDecompiler::FSqrt,
+        &ARBDecompiler::Unary<Op::ROUND_F>,
+        &ARBDecompiler::Unary<Op::FLR_F>,
+        &ARBDecompiler::Unary<Op::CEIL_F>,
+        &ARBDecompiler::Unary<Op::TRUNC_F>,
+        &ARBDecompiler::Unary<Op::I2F_S>,
+        &ARBDecompiler::Unary<Op::I2F_U>,
+        &ARBDecompiler::FSwizzleAdd,
+
+        &ARBDecompiler::Binary<Op::ADD_S>,
+        &ARBDecompiler::Binary<Op::MUL_S>,
+        &ARBDecompiler::Binary<Op::DIV_S>,
+        &ARBDecompiler::Negate<Op::S>,
+        &ARBDecompiler::Unary<Op::ABS_S>,
+        &ARBDecompiler::Binary<Op::MIN_S>,
+        &ARBDecompiler::Binary<Op::MAX_S>,
+
+        &ARBDecompiler::Unary<Op::F2I_S>,
+        &ARBDecompiler::Identity,
+        &ARBDecompiler::Binary<Op::SHL_U>,
+        &ARBDecompiler::Binary<Op::SHR_U>,
+        &ARBDecompiler::Binary<Op::SHR_S>,
+        &ARBDecompiler::Binary<Op::AND_U>,
+        &ARBDecompiler::Binary<Op::OR_U>,
+        &ARBDecompiler::Binary<Op::XOR_U>,
+        &ARBDecompiler::Unary<Op::NOT_U>,
+        &ARBDecompiler::BitfieldInsert<Op::BFI_S>,
+        &ARBDecompiler::BitfieldExtract<Op::BFE_S>,
+        &ARBDecompiler::Unary<Op::BTC_U>,
+        &ARBDecompiler::Unary<Op::BTFM_S>,
+
+        &ARBDecompiler::Binary<Op::ADD_U>,
+        &ARBDecompiler::Binary<Op::MUL_U>,
+        &ARBDecompiler::Binary<Op::DIV_U>,
+        &ARBDecompiler::Binary<Op::MIN_U>,
+        &ARBDecompiler::Binary<Op::MAX_U>,
+        &ARBDecompiler::Unary<Op::F2I_U>,
+        &ARBDecompiler::Identity,
+        &ARBDecompiler::Binary<Op::SHL_U>,
+        &ARBDecompiler::Binary<Op::SHR_U>,
+        &ARBDecompiler::Binary<Op::SHR_U>,
+        &ARBDecompiler::Binary<Op::AND_U>,
+        &ARBDecompiler::Binary<Op::OR_U>,
+        &ARBDecompiler::Binary<Op::XOR_U>,
+        &ARBDecompiler::Unary<Op::NOT_U>,
+        &ARBDecompiler::BitfieldInsert<Op::BFI_U>,
+        &ARBDecompiler::BitfieldExtract<Op::BFE_U>,
+        &ARBDecompiler::Unary<Op::BTC_U>,
+        &ARBDecompiler::Unary<Op::BTFM_U>,
+
+        &ARBDecompiler::HAdd,
+        &ARBDecompiler::HMul,
+        &ARBDecompiler::HFma,
+        &ARBDecompiler::HAbsolute,
+        &ARBDecompiler::HNegate,
+        &ARBDecompiler::HClamp,
+        &ARBDecompiler::HCastFloat,
+        &ARBDecompiler::HUnpack,
+        &ARBDecompiler::HMergeF32,
+        &ARBDecompiler::HMergeH0,
+        &ARBDecompiler::HMergeH1,
+        &ARBDecompiler::HPack2,
+
+        &ARBDecompiler::LogicalAssign,
+        &ARBDecompiler::Binary<Op::AND_U>,
+        &ARBDecompiler::Binary<Op::OR_U>,
+        &ARBDecompiler::Binary<Op::XOR_U>,
+        &ARBDecompiler::Unary<Op::NOT_U>,
+        &ARBDecompiler::LogicalPick2,
+        &ARBDecompiler::LogicalAnd2,
+
+        &ARBDecompiler::Compare<Op::SLT, Op::F>,
+        &ARBDecompiler::Compare<Op::SEQ, Op::F>,
+        &ARBDecompiler::Compare<Op::SLE, Op::F>,
+        &ARBDecompiler::Compare<Op::SGT, Op::F>,
+        &ARBDecompiler::Compare<Op::SNE, Op::F>,
+        &ARBDecompiler::Compare<Op::SGE, Op::F>,
+        &ARBDecompiler::LogicalFIsNan,
+
+        &ARBDecompiler::Compare<Op::SLT, Op::S>,
+        &ARBDecompiler::Compare<Op::SEQ, Op::S>,
+        &ARBDecompiler::Compare<Op::SLE, Op::S>,
+        &ARBDecompiler::Compare<Op::SGT, Op::S>,
+        &ARBDecompiler::Compare<Op::SNE, Op::S>,
+        &ARBDecompiler::Compare<Op::SGE, Op::S>,
+
+        &ARBDecompiler::Compare<Op::SLT, Op::U>,
+        &ARBDecompiler::Compare<Op::SEQ, Op::U>,
+        &ARBDecompiler::Compare<Op::SLE, Op::U>,
+        &ARBDecompiler::Compare<Op::SGT, Op::U>,
+        &ARBDecompiler::Compare<Op::SNE, Op::U>,
+        &ARBDecompiler::Compare<Op::SGE, Op::U>,
+
+        &ARBDecompiler::HalfComparison<Op::SLT, false>,
+        &ARBDecompiler::HalfComparison<Op::SEQ, false>,
+        &ARBDecompiler::HalfComparison<Op::SLE, false>,
+        &ARBDecompiler::HalfComparison<Op::SGT, false>,
+        &ARBDecompiler::HalfComparison<Op::SNE, false>,
+        &ARBDecompiler::HalfComparison<Op::SGE, false>,
+        &ARBDecompiler::HalfComparison<Op::SLT, true>,
+        &ARBDecompiler::HalfComparison<Op::SEQ, true>,
+        &ARBDecompiler::HalfComparison<Op::SLE, true>,
+        &ARBDecompiler::HalfComparison<Op::SGT, true>,
+        &ARBDecompiler::HalfComparison<Op::SNE, true>,
+        &ARBDecompiler::HalfComparison<Op::SGE, true>,
+
+        &ARBDecompiler::Texture,
+        &ARBDecompiler::TextureLod,
+        &ARBDecompiler::TextureGather,
+        &ARBDecompiler::TextureQueryDimensions,
+        &ARBDecompiler::TextureQueryLod,
+        &ARBDecompiler::TexelFetch,
+        &ARBDecompiler::TextureGradient,
+
+        &ARBDecompiler::ImageLoad,
+        &ARBDecompiler::ImageStore,
+        &ARBDecompiler::AtomicImage<Op::ATOM_ADD>,
+        &ARBDecompiler::AtomicImage<Op::ATOM_AND>,
+        &ARBDecompiler::AtomicImage<Op::ATOM_OR>,
+        &ARBDecompiler::AtomicImage<Op::ATOM_XOR>,
+        &ARBDecompiler::AtomicImage<Op::ATOM_EXCH>,
+
+        &ARBDecompiler::AtomicAdd,
+
+        &ARBDecompiler::Branch,
+        &ARBDecompiler::BranchIndirect,
+        &ARBDecompiler::PushFlowStack,
+        &ARBDecompiler::PopFlowStack,
+        &ARBDecompiler::Exit,
+        &ARBDecompiler::Discard,
+
+        &ARBDecompiler::EmitVertex,
+        &ARBDecompiler::EndPrimitive,
+
+        &ARBDecompiler::InvocationId,
+        &ARBDecompiler::YNegate,
+        &ARBDecompiler::ComputeOnly,
+        &ARBDecompiler::ComputeOnly,
+        &ARBDecompiler::ComputeOnly,
+        &ARBDecompiler::ComputeOnly,
+        &ARBDecompiler::ComputeOnly,
+        &ARBDecompiler::ComputeOnly,
+
+        &ARBDecompiler::BallotThread,
+        &ARBDecompiler::VoteAll,
+        &ARBDecompiler::VoteAny,
+        &ARBDecompiler::VoteEqual,
+
+        &ARBDecompiler::ThreadId,
+        &ARBDecompiler::ShuffleIndexed,
+
+        &ARBDecompiler::MemoryBarrierGL,
+    };
+    static_assert(operation_decompilers.size() == static_cast<std::size_t>(OperationCode::Amount));
+
+    const Device& device;
+    const ShaderIR& ir;
+    const ShaderType stage;
+    const std::string suffix;
+    const ProgramVariant& variant;
+    const Header header;
+
+    std::string code;
+    s32 scope = 0;
+    u32 num_temporaries = 0;
+    u32 max_temporaries = 0;
+};
+
+std::string ARBDecompiler::GetDeclarations() const {
+    std::string declarations;
+    const auto declare = [&declarations](std::string_view line) {
+        declarations += line;
+        declarations += '\n';
+    };
+
+    for (const u32 index : ir.GetRegisters()) {
+        declare(fmt::format("TEMP R{}_{};", index, suffix));
+    }
+    for (const auto pred : ir.GetPredicates()) {
+        declare(fmt::format("TEMP P{}_{};", static_cast<u32>(pred), suffix));
+    }
+    for (u32 index = 0; index < ir.GetNumCustomVariables(); ++index) {
+        declare(fmt::format("TEMP CV{}_{};", index, suffix));
+    }
+    if (ir.IsDecompiled()) {
+        for (u32 index = 0; index < ir.GetASTNumVariables(); ++index) {
+            declare(fmt::format("TEMP F{}_{};", index, suffix));
+        }
+    } else {
+        declare(fmt::format("TEMP PC_{};", suffix));
+        if (!ir.IsFlowStackDisabled()) {
+            for (const char* const stack : {"SSY", "PBK"}) {
+                declare(fmt::format("TEMP {}_{}[{}];", stack, suffix, FLOW_STACK_SIZE));
+                declare(fmt::format("TEMP {}_TOP_{};", stack, suffix));
+            }
+        }
+    }
+    for (u32 index = 0; index < max_temporaries; ++index) {
+        declare(fmt::format("TEMP T{}_{};", index, suffix));
+    }
+    declare(fmt::format("TEMP FLAGS_{};", suffix));
+
+    if (const u64 local_memory_size = header.GetLocalMemorySize(); local_memory_size > 0) {
+        declare(fmt::format("TEMP lmem_{}[{}];", suffix, (local_memory_size + 3) / 4));
+    }
+
+    // The emulation buffer takes the first binding of every stage
+    u32 binding = EmulationUniformBlockBinding + 1;
+    for (const auto& [index, cbuf] : ir.GetConstantBuffers()) {
+        declare(fmt::format("CBUFFER {}[] = {{ program.buffer[{}] }};", GetConstBuffer(index),
+                            binding++));
+    }
+
+    binding = device.GetBaseBindings(stage).shader_storage_buffer;
+    for (std::size_t index = 0; index < ir.GetGlobalMemory().size(); ++index) {
+        declare(fmt::format("STORAGE gmem{}_{}[] = {{ program.storage[{}] }};", index, suffix,
+                            binding++));
+    }
+
+    if (stage == ShaderType::Fragment) {
+        for (const auto attribute : ir.GetInputAttributes()) {
+            if (!IsGenericAttribute(attribute)) {
+                continue;
+            }
+            const u32 index = GetGenericAttributeIndex(attribute);
+            const char* modifier = "";
+            switch (header.ps.GetAttributeUse(index)) {
+            case AttributeUse::Constant:
+                modifier = "FLAT ";
+                break;
+            case AttributeUse::ScreenLinear:
+                modifier = "NOPERSPECTIVE ";
+                break;
+            default:
+                break;
+            }
+            declare(fmt::format("{}ATTRIB in_attr{} = fragment.attrib[{}];", modifier, index,
+                                index));
+        }
+    }
+    return declarations;
+}
+
+void ARBDecompiler::InitializeVariables() {
+    for (const u32 index : ir.GetRegisters()) {
+        AddLine("MOV.F R{}_{}, 0;", index, suffix);
+    }
+    for (const auto pred : ir.GetPredicates()) {
+        AddLine("MOV.S P{}_{}, 0;", static_cast<u32>(pred), suffix);
+    }
+    for (u32 index = 0; index < ir.GetNumCustomVariables(); ++index) {
+        AddLine("MOV.F CV{}_{}, 0;", index, suffix);
+    }
+    AddLine("MOV.S FLAGS_{}, 0;", suffix);
+}
+
+void ARBDecompiler::DecompileBranchMode() {
+    const auto& blocks = ir.GetBasicBlocks();
+    if (blocks.empty()) {
+        return;
+    }
+    if (!ir.IsFlowStackDisabled()) {
+        AddLine("MOV.S {}, 0;", GetFlowStackTop(MetaStackClass::Ssy));
+        AddLine("MOV.S {}, 0;", GetFlowStackTop(MetaStackClass::Pbk));
+    }
+
+    // Emulate the program counter with a loop that runs the block matching it, blocks run into
+    // the next one like they do in the original code
+    AddLine("MOV.U PC_{}.x, {};", suffix, blocks.begin()->first);
+    AddLine("REP;");
+    ++scope;
+    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+        const auto& [address, bb] = *it;
+        AddLine("SEQ.U.CC RC.x, PC_{}.x, {};", suffix, address);
+        AddLine("IF NE.x;");
+        ++scope;
+        VisitBlock(bb);
+        if (const auto next = std::next(it); next != blocks.end()) {
+            AddLine("MOV.U PC_{}.x, {};", suffix, next->first);
+            AddLine("CONT;");
+        } else {
+            AddLine("RET;");
+        }
+        --scope;
+        AddLine("ENDIF;");
+    }
+    AddLine("RET;");
+    --scope;
+    AddLine("ENDREP;");
+}
+
+std::string ARBDecompiler::Visit(const Node& node) {
+    if (const auto operation = std::get_if<OperationNode>(&*node)) {
+        if (const auto amend_index = operation->GetAmendIndex()) {
+            Visit(ir.GetAmendNode(*amend_index));
+        }
+        const auto operation_index = static_cast<std::size_t>(operation->GetCode());
+        if (operation_index >= operation_decompilers.size()) {
+            UNREACHABLE_MSG("Out of bounds operation: {}", operation_index);
+            return {};
+        }
+        const auto decompiler = operation_decompilers[operation_index];
+        if (decompiler == nullptr) {
+            UNREACHABLE_MSG("Undefined operation: {}", operation_index);
+            return {};
+        }
+        return (this->*decompiler)(*operation);
+    }
+
+    if (const auto gpr = std::get_if<GprNode>(&*node)) {
+        const u32 index = gpr->GetIndex();
+        if (index == Register::ZeroIndex) {
+            return Immediate(0);
+        }
+        return GetRegister(index);
+    }
+
+    if (const auto cv = std::get_if<CustomVarNode>(&*node)) {
+        return GetCustomVariable(cv->GetIndex());
+    }
+
+    if (const auto immediate = std::get_if<ImmediateNode>(&*node)) {
+        std::string temporary = AllocTemporary();
+        AddLine("MOV.U {}, {};", temporary, immediate->GetValue());
+        return temporary;
+    }
+
+    if (const auto predicate = std::get_if<PredicateNode>(&*node)) {
+        std::string value = GetPredicate(predicate->GetIndex());
+        if (predicate->IsNegated()) {
+            const std::string temporary = AllocTemporary();
+            AddLine("NOT.U {}, {};", temporary, value);
+            return temporary;
+        }
+        return value;
+    }
+
+    if (const auto abuf = std::get_if<AbufNode>(&*node)) {
+        if (abuf->IsPhysicalBuffer()) {
+            UNIMPLEMENTED_MSG("Physical attributes are not implemented in assembly programs");
+            return Immediate(0);
+        }
+        return ReadAttribute(abuf->GetIndex(), abuf->GetElement(), abuf->GetBuffer());
+    }
+
+    if (const auto cbuf = std::get_if<CbufNode>(&*node)) {
+        const Node offset = cbuf->GetOffset();
+        const std::string temporary = AllocTemporary();
+        if (const auto immediate = std::get_if<ImmediateNode>(&*offset)) {
+            AddLine("LDC.U32 {}, {}[{}];", temporary, GetConstBuffer(cbuf->GetIndex()),
+                    immediate->GetValue());
+        } else {
+            AddLine("LDC.U32 {}, {}[{}];", temporary, GetConstBuffer(cbuf->GetIndex()),
+                    Visit(offset));
+        }
+        return temporary;
+    }
+
+    if (const auto gmem = std::get_if<GmemNode>(&*node)) {
+        const std::string real = Visit(gmem->GetRealAddress());
+        const std::string base = Visit(gmem->GetBaseAddress());
+        const std::string temporary = AllocTemporary();
+        AddLine("SUB.U {}, {}, {};", temporary, real, base);
+        AddLine("LDB.U32 {}, {}[{}];", temporary, GetGlobalMemory(gmem->GetDescriptor()),
+                temporary);
+        return temporary;
+    }
+
+    if (const auto lmem = std::get_if<LmemNode>(&*node)) {
+        const std::string address = Visit(lmem->GetAddress());
+        const std::string temporary = AllocTemporary();
+        AddLine("SHR.U {}, {}, 2;", temporary, address);
+        AddLine("MOV.U {}, lmem_{}[{}].x;", temporary, suffix, temporary);
+        return temporary;
+    }
+
+    if (std::holds_alternative<SmemNode>(*node)) {
+        UNREACHABLE_MSG("Shared memory is not available in assembly programs");
+        return Immediate(0);
+    }
+
+    if (const auto internal_flag = std::get_if<InternalFlagNode>(&*node)) {
+        return GetInternalFlag(internal_flag->GetFlag());
+    }
+
+    if (const auto conditional = std::get_if<ConditionalNode>(&*node)) {
+        if (const auto amend_index = conditional->GetAmendIndex()) {
+            Visit(ir.GetAmendNode(*amend_index));
+        }
+        SetCondition(Visit(conditional->GetCondition()));
+        AddLine("IF NE.x;");
+        ++scope;
+        VisitBlock(conditional->GetCode());
+        --scope;
+        AddLine("ENDIF;");
+        return {};
+    }
+
+    if (const auto comment = std::get_if<CommentNode>(&*node)) {
+        AddLine("# {}", comment->GetText());
+        return {};
+    }
+
+    UNREACHABLE();
+    return {};
+}
+
+std::string ARBDecompiler::ReadAttribute(Attribute::Index attribute, u32 element,
+                                         const Node& buffer) {
+    const char swizzle = Swizzle(element);
+    switch (attribute) {
+    case Attribute::Index::Position:
+        switch (stage) {
+        case ShaderType::Geometry:
+            return fmt::format("vertex[{}].position.{}", GetGeometryVertex(buffer), swizzle);
+        case ShaderType::Fragment: {
+            if (element == 3) {
+                std::string temporary = AllocTemporary();
+                AddLine("MOV.F {}, 1;", temporary);
+                return temporary;
+            }
+            return fmt::format("fragment.position.{}", swizzle);
+        }
+        default:
+            UNREACHABLE();
+            return Immediate(0);
+        }
+    case Attribute::Index::PointCoord:
+        if (element < 2) {
+            return fmt::format("fragment.pointcoord.{}", swizzle);
+        }
+        return Immediate(0);
+    case Attribute::Index::TessCoordInstanceIDVertexID:
+        ASSERT(stage == ShaderType::Vertex);
+        switch (element) {
+        case 2:
+            return "vertex.instance.x";
+        case 3:
+            return "vertex.id.x";
+        }
+        UNIMPLEMENTED_MSG("Unmanaged TessCoordInstanceIDVertexID element={}", element);
+        return Immediate(0);
+    case Attribute::Index::FrontFacing:
+        ASSERT(stage == ShaderType::Fragment);
+        if (element == 3) {
+            AddLine("SGT.F.CC RC.x, fragment.facing.x, 0;");
+            return ConditionToBoolean();
+        }
+        UNIMPLEMENTED_MSG("Unmanaged FrontFacing element={}", element);
+        return Immediate(0);
+    default:
+        if (!IsGenericAttribute(attribute)) {
+            break;
+        }
+        const u32 index = GetGenericAttributeIndex(attribute);
+        switch (stage) {
+        case ShaderType::Geometry:
+            return fmt::format("vertex[{}].attrib[{}].{}", GetGeometryVertex(buffer), index,
+                               swizzle);
+        case ShaderType::Fragment:
+            return fmt::format("in_attr{}.{}", index, swizzle);
+        default:
+            return fmt::format("vertex.attrib[{}].{}", index, swizzle);
+        }
+    }
+    UNIMPLEMENTED_MSG("Unhandled input attribute: {}", static_cast<u32>(attribute));
+    return Immediate(0);
+}
+
+std::string ARBDecompiler::GetOutputAttribute(const AbufNode& abuf) {
+    const u32 element = abuf.GetElement();
+    switch (const auto attribute = abuf.GetIndex()) {
+    case Attribute::Index::Position:
+        return fmt::format("result.position.{}", Swizzle(element));
+    case Attribute::Index::LayerViewportPointSize:
+        switch (element) {
+        case 0:
+            UNIMPLEMENTED();
+            return {};
+        case 1:
+        case 2:
+            if (stage == ShaderType::Vertex && !device.HasNvViewportArray2()) {
+                // Already reported when the program was declared
+                return {};
+            }
+            return element == 1 ? "result.layer.x" : "result.viewport.x";
+        case 3:
+            return "result.pointsize.x";
+        }
+        UNREACHABLE();
+        return {};
+    case Attribute::Index::ClipDistances0123:
+        return fmt::format("result.clip[{}].x", element);
+    case Attribute::Index::ClipDistances4567:
+        return fmt::format("result.clip[{}].x", element + 4);
+    default:
+        if (IsGenericAttribute(attribute)) {
+            return fmt::format("result.attrib[{}].{}", GetGenericAttributeIndex(attribute),
+                               Swizzle(element));
+        }
+        UNIMPLEMENTED_MSG("Unhandled output attribute: {}", static_cast<u32>(attribute));
+        return {};
+    }
+}
+
+void ARBDecompiler::PreExit() {
+    if (stage != ShaderType::Fragment) {
+        return;
+    }
+    const auto& used_registers = ir.GetRegisters();
+    const auto SafeGetRegister = [&](u32 reg) -> std::string {
+        // TODO(Rodrigo): Replace with contains once C++20 releases
+        if (used_registers.find(reg) != used_registers.end()) {
+            return GetRegister(reg);
+        }
+        return "0";
+    };
+
+    UNIMPLEMENTED_IF_MSG(header.ps.omap.sample_mask != 0, "Sample mask write is unimplemented");
+
+    // Write the color outputs using the data in the shader registers, disabled
+    // rendertargets/components are skipped in the register assignment.
+    u32 current_reg = 0;
+    for (u32 render_target = 0; render_target < Maxwell::NumRenderTargets; ++render_target) {
+        for (u32 component = 0; component < 4; ++component) {
+            if (header.ps.IsColorComponentOutputEnabled(render_target, component)) {
+                AddLine("MOV.F result.color[{}].{}, {};", render_target, Swizzle(component),
+                        SafeGetRegister(current_reg));
+                ++current_reg;
+            }
+        }
+    }
+
+    if (header.ps.omap.depth) {
+        // The depth output is always 2 registers after the last color output, and current_reg
+        // already contains one past the last color register.
+        AddLine("MOV.F result.depth.z, {};", SafeGetRegister(current_reg + 1));
+    }
+}
+
+std::string ARBDecompiler::Assign(Operation operation) {
+    const Node& dest = operation[0];
+    const Node& src = operation[1];
+
+    std::string value = Visit(src);
+    if (const auto gpr = std::get_if<GprNode>(&*dest)) {
+        if (gpr->GetIndex() == Register::ZeroIndex) {
+            // Writing to Register::ZeroIndex is a no op
+            return {};
+        }
+        AddLine("MOV.U {}, {};", GetRegister(gpr->GetIndex()), value);
+    } else if (const auto abuf = std::get_if<AbufNode>(&*dest)) {
+        UNIMPLEMENTED_IF(abuf->IsPhysicalBuffer());
+        const std::string target = GetOutputAttribute(*abuf);
+        if (target.empty()) {
+            return {};
+        }
+        AddLine("MOV.U {}, {};", target, value);
+    } else if (const auto lmem = std::get_if<LmemNode>(&*dest)) {
+        const std::string address = Visit(lmem->GetAddress());
+        const std::string temporary = AllocTemporary();
+        AddLine("SHR.U {}, {}, 2;", temporary, address);
+        AddLine("MOV.U lmem_{}[{}].x, {};", suffix, temporary, value);
+    } else if (const auto gmem = std::get_if<GmemNode>(&*dest)) {
+        const std::string real = Visit(gmem->GetRealAddress());
+        const std::string base = Visit(gmem->GetBaseAddress());
+        const std::string temporary = AllocTemporary();
+        AddLine("SUB.U {}, {}, {};", temporary, real, base);
+        AddLine("STB.U32 {}, {}[{}];", value, GetGlobalMemory(gmem->GetDescriptor()), temporary);
+    } else if (const auto cv = std::get_if<CustomVarNode>(&*dest)) {
+        AddLine("MOV.U {}, {};", GetCustomVariable(cv->GetIndex()), value);
+    } else {
+        UNREACHABLE_MSG("Assign called without a proper target");
+    }
+    return {};
+}
+
+std::string ARBDecompiler::LogicalAssign(Operation operation) {
+    const Node& dest = operation[0];
+    const Node& src = operation[1];
+
+    std::string target;
+    if (const auto pred = std::get_if<PredicateNode>(&*dest)) {
+        ASSERT_MSG(!pred->IsNegated(), "Negating logical assignment");
+
+        const auto index = pred->GetIndex();
+        switch (index) {
+        case Tegra::Shader::Pred::NeverExecute:
+        case Tegra::Shader::Pred::UnusedIndex:
+            // Writing to these predicates is a no-op
+            return {};
+        }
+        target = GetPredicate(index);
+    } else if (const auto flag = std::get_if<InternalFlagNode>(&*dest)) {
+        target = GetInternalFlag(flag->GetFlag());
+    } else {
+        UNREACHABLE();
+        return {};
+    }
+
+    AddLine("MOV.U {}, {};", target, Visit(src));
+    return {};
+}
+
+std::string ARBDecompiler::FSwizzleAdd(Operation operation) {
+    const std::string op_a = Visit(operation[0]);
+    const std::string op_b = Visit(operation[1]);
+    const std::string temporary = AllocTemporary();
+    if (!device.HasWarpIntrinsics()) {
+        LOG_ERROR(Render_OpenGL, "Nvidia thread groups are required by this shader");
+        AddLine("ADD.F {}, {}, {};", temporary, op_a, op_b);
+        return temporary;
+    }
+
+    const std::string mask = AllocTemporary();
+    AddLine("AND.U {}, {}.threadid, 3;", mask, GetStageInputName(stage));
+    AddLine("SHL.U {}, {}, 1;", mask, mask);
+    AddLine("SHR.U {}, {}, {};", mask, Visit(operation[2]), mask);
+    AddLine("AND.U {}, {}, 3;", mask, mask);
+    AddLine("MUL.F {}, {}, FSWZA[{}].x;", temporary, op_a, mask);
+    AddLine("MAD.F {}, {}, FSWZB[{}].x, {};", temporary, op_b, mask, temporary);
+    return temporary;
+}
+
+std::string ARBDecompiler::HUnpack(Operation operation) {
+    switch (std::get<Tegra::Shader::HalfType>(operation.GetMeta())) {
+    case Tegra::Shader::HalfType::H0_H1:
+        return Visit(operation[0]);
+    case Tegra::Shader::HalfType::F32: {
+        const std::string value = Visit(operation[0]);
+        const std::string temporary = AllocVectorTemporary();
+        AddLine("MOV.F {}.xy, {};", temporary, value);
+        return PackHalf(temporary);
+    }
+    case Tegra::Shader::HalfType::H0_H0: {
+        const std::string value = UnpackHalf(operation[0]);
+        AddLine("MOV.F {}.y, {}.x;", value, value);
+        return PackHalf(value);
+    }
+    case Tegra::Shader::HalfType::H1_H1: {
+        const std::string value = UnpackHalf(operation[0]);
+        AddLine("MOV.F {}.x, {}.y;", value, value);
+        return PackHalf(value);
+    }
+    }
+    UNREACHABLE();
+    return Immediate(0);
+}
+
+std::string ARBDecompiler::BuildTextureCoords(Operation operation, std::size_t& num_components) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+    const std::string temporary = AllocVectorTemporary();
+
+    std::size_t component = 0;
+    for (; component < operation.GetOperandsCount(); ++component) {
+        AddLine("MOV.F {}.{}, {};", temporary, Swizzle(component), Visit(operation[component]));
+    }
+    if (meta.sampler.IsArray()) {
+        AddLine("I2F.S {}.{}, {};", temporary, Swizzle(component), Visit(meta.array));
+        ++component;
+    }
+    if (meta.sampler.IsShadow()) {
+        // The reference always goes after the second component, even for 1D textures
+        component = std::max<std::size_t>(component, 2);
+        if (component < 4) {
+            AddLine("MOV.F {}.{}, {};", temporary, Swizzle(component),
+                    Visit(meta.depth_compare));
+            ++component;
+        } else {
+            UNIMPLEMENTED_MSG("Shadow cube array lookups are not implemented");
+        }
+    }
+    num_components = component;
+    return temporary;
+}
+
+std::string ARBDecompiler::BuildTextureOffsets(const MetaTexture& meta) {
+    UNIMPLEMENTED_IF_MSG(!meta.ptp.empty(), "Per texel offsets are not implemented");
+    if (meta.aoffi.empty()) {
+        return {};
+    }
+    std::string offsets = ", (";
+    for (std::size_t index = 0; index < meta.aoffi.size(); ++index) {
+        if (index > 0) {
+            offsets += ", ";
+        }
+        if (const auto immediate = std::get_if<ImmediateNode>(&*meta.aoffi[index])) {
+            offsets += std::to_string(static_cast<s32>(immediate->GetValue()));
+        } else {
+            UNIMPLEMENTED_MSG("Non immediate texture offsets are not implemented");
+            offsets += '0';
+        }
+    }
+    return offsets + ')';
+}
+
+std::string ARBDecompiler::SampleTexture(Operation operation, const Node& extra,
+                                         std::string_view opcode) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+
+    std::size_t num_components{};
+    const std::string coords = BuildTextureCoords(operation, num_components);
+    std::string_view instruction = "TEX";
+    if (extra) {
+        if (num_components < 4) {
+            AddLine("MOV.F {}.w, {};", coords, Visit(extra));
+            instruction = opcode;
+        } else {
+            UNIMPLEMENTED_MSG("{} with four coordinates is not implemented", opcode);
+        }
+    }
+
+    const std::string temporary = AllocVectorTemporary();
+    AddLine("{}.F {}, {}, {}, {}{};", instruction, temporary, coords, GetTexture(meta),
+            GetTextureTarget(meta.sampler), BuildTextureOffsets(meta));
+    return fmt::format("{}.{}", temporary, meta.sampler.IsShadow() ? 'x' : Swizzle(meta.element));
+}
+
+std::string ARBDecompiler::TextureGather(Operation operation) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+
+    std::size_t num_components{};
+    const std::string coords = BuildTextureCoords(operation, num_components);
+
+    char component = 'x';
+    if (!meta.sampler.IsShadow() && meta.component) {
+        if (const auto immediate = std::get_if<ImmediateNode>(&*meta.component)) {
+            component = Swizzle(immediate->GetValue());
+        } else {
+            UNIMPLEMENTED_MSG("Non immediate gather components are not implemented");
+        }
+    }
+
+    const std::string temporary = AllocVectorTemporary();
+    AddLine("TXG.F {}, {}, {}.{}, {}{};", temporary, coords, GetTexture(meta), component,
+            GetTextureTarget(meta.sampler), BuildTextureOffsets(meta));
+    return fmt::format("{}.{}", temporary, Swizzle(meta.element));
+}
+
+std::string ARBDecompiler::TextureQueryDimensions(Operation operation) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+
+    const std::string lod = Visit(operation[0]);
+    const std::string temporary = AllocVectorTemporary();
+    AddLine("TXQ {}, {}, {}, {};", temporary, lod, GetTexture(meta),
+            GetTextureTarget(meta.sampler));
+
+    switch (meta.element) {
+    case 0:
+    case 1:
+    case 3:
+        return fmt::format("{}.{}", temporary, Swizzle(meta.element));
+    }
+    UNREACHABLE();
+    return Immediate(0);
+}
+
+std::string ARBDecompiler::TextureQueryLod(Operation operation) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+    if (meta.element >= 2) {
+        return Immediate(0);
+    }
+
+    std::size_t num_components{};
+    const std::string coords = BuildTextureCoords(operation, num_components);
+    const std::string temporary = AllocVectorTemporary();
+    AddLine("LOD.F {}, {}, {}, {};", temporary, coords, GetTexture(meta),
+            GetTextureTarget(meta.sampler));
+
+    const char swizzle = Swizzle(meta.element);
+    AddLine("MUL.F {}.{}, {}.{}, 256;", temporary, swizzle, temporary, swizzle);
+    AddLine("F2I.S {}.{}, {}.{};", temporary, swizzle, temporary, swizzle);
+    return fmt::format("{}.{}", temporary, swizzle);
+}
+
+std::string ARBDecompiler::TexelFetch(Operation operation) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+    UNIMPLEMENTED_IF(meta.sampler.IsArray());
+
+    const std::string coords = BuildIntegerCoords(operation);
+    const std::string temporary = AllocVectorTemporary();
+    if (meta.sampler.IsBuffer()) {
+        AddLine("TXFB.F {}, {}.x, {}, BUFFER;", temporary, coords, GetTexture(meta));
+    } else {
+        if (meta.lod) {
+            AddLine("MOV.S {}.w, {};", coords, Visit(meta.lod));
+        } else {
+            AddLine("MOV.S {}.w, 0;", coords);
+        }
+        AddLine("TXF.F {}, {}, {}, {}{};", temporary, coords, GetTexture(meta),
+                GetTextureTarget(meta.sampler), BuildTextureOffsets(meta));
+    }
+    return fmt::format("{}.{}", temporary, Swizzle(meta.element));
+}
+
+std::string ARBDecompiler::TextureGradient(Operation operation) {
+    const auto& meta = std::get<MetaTexture>(operation.GetMeta());
+
+    std::size_t num_components{};
+    const std::string coords = BuildTextureCoords(operation, num_components);
+    const std::string derivate_x = AllocVectorTemporary();
+    const std::string derivate_y = AllocVectorTemporary();
+    for (std::size_t index = 0; index < meta.derivates.size() / 2; ++index) {
+        AddLine("MOV.F {}.{}, {};", derivate_x, Swizzle(index),
+                Visit(meta.derivates.at(index * 2)));
+        AddLine("MOV.F {}.{}, {};", derivate_y, Swizzle(index),
+                Visit(meta.derivates.at(index * 2 + 1)));
+    }
+
+    const std::string temporary = AllocVectorTemporary();
+    AddLine("TXD.F {}, {}, {}, {}, {}, {}{};", temporary, coords, derivate_x, derivate_y,
+            GetTexture(meta), GetTextureTarget(meta.sampler), BuildTextureOffsets(meta));
+    return fmt::format("{}.{}", temporary, Swizzle(meta.element));
+}
+
+std::string ARBDecompiler::ImageLoad(Operation operation) {
+    if (!device.HasImageLoadFormatted()) {
+        LOG_ERROR(Render_OpenGL,
+                  "Device lacks GL_EXT_shader_image_load_formatted, stubbing image load");
+        return Immediate(0);
+    }
+
+    const auto& meta = std::get<MetaImage>(operation.GetMeta());
+    const std::string coords = BuildIntegerCoords(operation);
+    const std::string temporary = AllocVectorTemporary();
+    AddLine("LOADIM.U32 {}, {}, image[{}], {};", temporary, coords, GetImageBinding(meta.image),
+            GetImageTarget(meta.image.GetType()));
+    return fmt::format("{}.{}", temporary, Swizzle(meta.element));
+}
+
+std::string ARBDecompiler::ImageStore(Operation operation) {
+    const auto& meta = std::get<MetaImage>(operation.GetMeta());
+    const std::string coords = BuildIntegerCoords(operation);
+    const std::string values = AllocVectorTemporary();
+    for (std::size_t index = 0; index < 4; ++index) {
+        if (index < meta.values.size()) {
+            AddLine("MOV.U {}.{}, {};", values, Swizzle(index), Visit(meta.values[index]));
+        } else {
+            AddLine("MOV.U {}.{}, 0;", values, Swizzle(index));
+        }
+    }
+    AddLine("STOREIM.U32 image[{}], {}, {}, {};", GetImageBinding(meta.image), values, coords,
+            GetImageTarget(meta.image.GetType()));
+    return {};
+}
+
+std::string ARBDecompiler::AtomicAdd(Operation operation) {
+    const auto gmem = std::get_if<GmemNode>(&*operation[0]);
+    if (!gmem) {
+        UNIMPLEMENTED_MSG("Atomics are only implemented on global memory");
+        return Immediate(0);
+    }
+    const std::string value = Visit(operation[1]);
+    const std::string real = Visit(gmem->GetRealAddress());
+    const std::string base = Visit(gmem->GetBaseAddress());
+    const std::string offset = AllocTemporary();
+    AddLine("SUB.U {}, {}, {};", offset, real, base);
+    const std::string temporary = AllocTemporary();
+    AddLine("ATOMB.ADD.U32 {}, {}, {}[{}];", temporary, value,
+            GetGlobalMemory(gmem->GetDescriptor()), offset);
+    return temporary;
+}
+
+class ExprDecompiler {
+public:
+    explicit ExprDecompiler(ARBDecompiler& decomp) : decomp{decomp} {}
+
+    std::string operator()(const ExprAnd& expr) {
+        return Binary("AND.U", *expr.operand1, *expr.operand2);
+    }
+
+    std::string operator()(const ExprOr& expr) {
+        return Binary("OR.U", *expr.operand1, *expr.operand2);
+    }
+
+    std::string operator()(const ExprNot& expr) {
+        const std::string value = std::visit(*this, *expr.operand1);
+        const std::string temporary = decomp.AllocTemporary();
+        decomp.AddLine("NOT.U {}, {};", temporary, value);
+        return temporary;
+    }
+
+    std::string operator()(const ExprPredicate& expr) {
+        return decomp.GetPredicate(static_cast<Tegra::Shader::Pred>(expr.predicate));
+    }
+
+    std::string operator()(const ExprCondCode& expr) {
+        return decomp.Visit(decomp.ir.GetConditionCode(expr.cc));
+    }
+
+    std::string operator()(const ExprVar& expr) {
+        return decomp.GetFlowVariable(expr.var_index);
+    }
+
+    std::string operator()(const ExprBoolean& expr) {
+        return decomp.Immediate(expr.value ? -1 : 0);
+    }
+
+    std::string operator()(const ExprGprEqual& expr) {
+        decomp.AddLine("SEQ.U.CC RC.x, {}, {};", decomp.GetRegister(expr.gpr), expr.value);
+        return decomp.ConditionToBoolean();
+    }
+
+private:
+    std::string Binary(std::string_view op, const ExprData& operand1, const ExprData& operand2) {
+        const std::string op_a = std::visit(*this, operand1);
+        const std::string op_b = std::visit(*this, operand2);
+        const std::string temporary = decomp.AllocTemporary();
+        decomp.AddLine("{} {}, {}, {};", op, temporary, op_a, op_b);
+        return temporary;
+    }
+
+    ARBDecompiler& decomp;
+};
+
+class ASTDecompiler {
+public:
+    explicit ASTDecompiler(ARBDecompiler& decomp) : decomp{decomp} {}
+
+    void operator()(const ASTProgram& ast) {
+        VisitNodes(ast.nodes);
+    }
+
+    void operator()(const ASTIfThen& ast) {
+        decomp.SetCondition(DecompileExpr(ast.condition));
+        decomp.AddLine("IF NE.x;");
+        decomp.scope++;
+        VisitNodes(ast.nodes);
+        decomp.scope--;
+        // The closing ENDIF is emitted by the visitor, it is shared with a following else block
+    }
+
+    void operator()(const ASTIfElse& ast) {
+        decomp.AddLine("ELSE;");
+        decomp.scope++;
+        VisitNodes(ast.nodes);
+        decomp.scope--;
+        decomp.AddLine("ENDIF;");
+    }
+
+    void operator()([[maybe_unused]] const ASTBlockEncoded& ast) {
+        UNREACHABLE();
+    }
+
+    void operator()(const ASTBlockDecoded& ast) {
+        decomp.VisitBlock(ast.nodes);
+    }
+
+    void operator()(const ASTVarSet& ast) {
+        decomp.AddLine("MOV.U {}, {};", decomp.GetFlowVariable(ast.index),
+                       DecompileExpr(ast.condition));
+    }
+
+    void operator()(const ASTLabel& ast) {
+        decomp.AddLine("# Label_{}:", ast.index);
+    }
+
+    void operator()([[maybe_unused]] const ASTGoto& ast) {
+        UNREACHABLE();
+    }
+
+    void operator()(const ASTDoWhile& ast) {
+        decomp.AddLine("REP;");
+        decomp.scope++;
+        VisitNodes(ast.nodes);
+        if (!VideoCommon::Shader::ExprIsTrue(ast.condition)) {
+            decomp.SetCondition(DecompileExpr(ast.condition));
+            decomp.AddLine("BRK (EQ.x);");
+        }
+        decomp.scope--;
+        decomp.AddLine("ENDREP;");
+    }
+
+    void operator()(const ASTReturn& ast) {
+        const bool is_true = VideoCommon::Shader::ExprIsTrue(ast.condition);
+        if (!is_true) {
+            decomp.SetCondition(DecompileExpr(ast.condition));
+            decomp.AddLine("IF NE.x;");
+            decomp.scope++;
+        }
+        if (ast.kills) {
+            decomp.AddLine("KIL TR;");
+        } else {
+            decomp.PreExit();
+            decomp.AddLine("RET;");
+        }
+        if (!is_true) {
+            decomp.scope--;
+            decomp.AddLine("ENDIF;");
+        }
+    }
+
+    void operator()(const ASTBreak& ast) {
+        if (VideoCommon::Shader::ExprIsTrue(ast.condition)) {
+            decomp.AddLine("BRK;");
+            return;
+        }
+        decomp.SetCondition(DecompileExpr(ast.condition));
+        decomp.AddLine("BRK (NE.x);");
+    }
+
+    void Visit(const ASTNode& node) {
+        std::visit(*this, *node->GetInnerData());
+        decomp.ResetTemporaries();
+
+        if (!std::holds_alternative<ASTIfThen>(*node->GetInnerData())) {
+            return;
+        }
+        const ASTNode next = node->GetNext();
+        if (!next || !std::holds_alternative<ASTIfElse>(*next->GetInnerData())) {
+            decomp.AddLine("ENDIF;");
+        }
+    }
+
+private:
+    void VisitNodes(const ASTZipper& nodes) {
+        ASTNode current = nodes.GetFirst();
+        while (current) {
+            Visit(current);
+            current = current->GetNext();
+        }
+    }
+
+    std::string DecompileExpr(const Expr& expr) {
+        ExprDecompiler expr_parser{decomp};
+        return std::visit(expr_parser, *expr);
+    }
+
+    ARBDecompiler& decomp;
+};
+
+void ARBDecompiler::DecompileAST() {
+    for (u32 i = 0; i < ir.GetASTNumVariables(); i++) {
+        AddLine("MOV.S {}, 0;", GetFlowVariable(i));
+    }
+
+    ASTDecompiler decompiler{*this};
+    decompiler.Visit(ir.GetASTProgram());
+}
+
+} // Anonymous namespace
+
+std::string DecompileAssemblyShader(const Device& device, const ShaderIR& ir, const ShaderIR* ir_b,
+                                    ShaderType stage, std::string_view identifier,
+                                    const ProgramVariant& variant) {
+    std::vector<ARBDecompiler> decompilers;
+    decompilers.reserve(2);
+    decompilers.emplace_back(device, ir, stage, GetStageName(stage, false), variant);
+    if (ir_b) {
+        decompilers.emplace_back(device, *ir_b, stage, GetStageName(stage, true), variant);
+    }
+    for (auto& decompiler : decompilers) {
+        decompiler.Decompile();
+    }
+
+    std::string source;
+    switch (stage) {
+    case ShaderType::Vertex:
+        source += "!!NVvp5.0\n";
+        break;
+    case ShaderType::Geometry:
+        source += "!!NVgp5.0\n";
+        break;
+    case ShaderType::Fragment:
+        source += "!!NVfp5.0\n";
+        break;
+    default:
+        UNREACHABLE_MSG("Unsupported assembly stage={}", static_cast<u32>(stage));
+        break;
+    }
+    source += fmt::format("# {}\n", identifier);
+    source += "OPTION NV_parameter_buffer_object2;\n";
+    source += "OPTION NV_shader_storage_buffer;\n";
+    if (device.HasWarpIntrinsics()) {
+        source += "OPTION NV_shader_thread_group;\n";
+        source += "OPTION NV_shader_thread_shuffle;\n";
+    }
+
+    const bool uses_viewport_layer =
+        ir.UsesLayer() || ir.UsesViewportIndex() ||
+        (ir_b && (ir_b->UsesLayer() || ir_b->UsesViewportIndex()));
+    if (stage == ShaderType::Vertex && uses_viewport_layer) {
+        if (device.HasNvViewportArray2()) {
+            source += "OPTION NV_viewport_array2;\n";
+        } else {
+            LOG_ERROR(Render_OpenGL, "GL_NV_viewport_array2 is required to write the layer or "
+                                     "the viewport from vertex programs, skipping the writes");
+        }
+    }
+
+    if (stage == ShaderType::Geometry) {
+        const Header& header = ir.GetHeader();
+        const char* const input_primitive = GetInputPrimitive(variant.primitive_mode).first;
+        source += fmt::format("PRIMITIVE_IN {};\n", input_primitive);
+        source += fmt::format("PRIMITIVE_OUT {};\n",
+                              GetOutputTopologyName(header.common3.output_topology));
+        source += fmt::format("VERTICES_OUT {};\n", header.common4.max_output_vertices.Value());
+    }
+
+    source += "TEMP RC;\n";
+    source += fmt::format("CBUFFER emulation[] = {{ program.buffer[{}] }};\n",
+                          EmulationUniformBlockBinding);
+    source += "PARAM FSWZA[] = { {-1}, {1}, {-1}, {0} };\n";
+    source += "PARAM FSWZB[] = { {-1}, {-1}, {1}, {-1} };\n";
+    for (const auto& decompiler : decompilers) {
+        source += decompiler.GetDeclarations();
+    }
+
+    if (stage == ShaderType::Vertex) {
+        source += "MOV.F result.position, {0, 0, 0, 1};\n";
+    }
+    source += fmt::format("CAL execute_{};\n", GetStageName(stage, false));
+    if (ir_b) {
+        source += fmt::format("CAL execute_{};\n", GetStageName(stage, true));
+    }
+    source += "RET;\n";
+    for (const auto& decompiler : decompilers) {
+        source += decompiler.GetCode();
+    }
+    source += "END\n";
+    return source;
+}
+
+} // namespace OpenGL
@@ -0,0 +1,33 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "common/common_types.h"
+#include "video_core/engines/shader_type.h"
+
+namespace VideoCommon::Shader {
+class ShaderIR;
+}
+
+namespace OpenGL {
+
+class Device;
+struct ProgramVariant;
+
+/**
+ * Decompiles a graphics stage to an NV_gpu_program5 assembly program.
+ * @param ir_b Second program of the stage, for vertex shaders made of a VertexA and a VertexB
+ *             program, null otherwise
+ * @returns the source of the program, to be loaded with LoadAssemblyProgram
+ */
+std::string DecompileAssemblyShader(const Device& device, const VideoCommon::Shader::ShaderIR& ir,
+                                    const VideoCommon::Shader::ShaderIR* ir_b,
+                                    Tegra::Engines::ShaderType stage, std::string_view identifier,
+                                    const ProgramVariant& variant);
+
+} // namespace OpenGL
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <memory>
 
 #include <glad/glad.h>
@@ -21,17 +22,55 @@ using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
 MICROPROFILE_DEFINE(OpenGL_Buffer_Download, "OpenGL", "Buffer Download", MP_RGB(192, 192, 128));
 
-CachedBufferBlock::CachedBufferBlock(CacheAddr cache_addr, const std::size_t size)
+CachedBufferBlock::CachedBufferBlock(CacheAddr cache_addr, const std::size_t size,
+                                     bool use_persistent)
     : VideoCommon::BufferBlock{cache_addr, size} {
     gl_buffer.Create();
-    glNamedBufferData(gl_buffer.handle, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+    if (!use_persistent) {
+        glNamedBufferData(gl_buffer.handle, static_cast<GLsizeiptr>(size), nullptr,
+                          GL_DYNAMIC_DRAW);
+        return;
+    }
+    // Dynamic storage is kept so busy buffers can still be updated through the driver
+    constexpr GLbitfield map_flags =
+        GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glNamedBufferStorage(gl_buffer.handle, static_cast<GLsizeiptr>(size), nullptr,
+                         map_flags | GL_DYNAMIC_STORAGE_BIT);
+    mapped_ptr = static_cast<u8*>(
+        glMapNamedBufferRange(gl_buffer.handle, 0, static_cast<GLsizeiptr>(size), map_flags));
 }
 
-CachedBufferBlock::~CachedBufferBlock() = default;
+CachedBufferBlock::~CachedBufferBlock() {
+    if (mapped_ptr) {
+        glUnmapNamedBuffer(gl_buffer.handle);
+    }
+}
+
+void CachedBufferBlock::SetUseFence(std::shared_ptr<OGLSync> fence) {
+    use_fence = std::move(fence);
+    is_pending_use = false;
+}
+
+bool CachedBufferBlock::IsIdle() {
+    if (is_pending_use) {
+        return false;
+    }
+    if (!use_fence) {
+        return true;
+    }
+    GLint status{};
+    glGetSynciv(use_fence->handle, GL_SYNC_STATUS, 1, nullptr, &status);
+    if (status != GL_SIGNALED) {
+        return false;
+    }
+    use_fence.reset();
+    return true;
+}
 
 OGLBufferCache::OGLBufferCache(RasterizerOpenGL& rasterizer, Core::System& system,
                                const Device& device, std::size_t stream_size)
-    : GenericBufferCache{rasterizer, system, std::make_unique<OGLStreamBuffer>(stream_size, true)} {
+    : GenericBufferCache{rasterizer, system, std::make_unique<OGLStreamBuffer>(stream_size, true)},
+      use_persistent_blocks{device.HasBufferStorage()} {
     if (!device.HasFastBufferSubData()) {
         return;
     }
@@ -47,8 +86,23 @@ OGLBufferCache::~OGLBufferCache() {
     glDeleteBuffers(static_cast<GLsizei>(std::size(cbufs)), std::data(cbufs));
 }
 
+void OGLBufferCache::FenceBlockUses() {
+    if (used_blocks.empty()) {
+        return;
+    }
+    // Make shader writes visible through the mappings before they are considered idle
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+
+    auto fence = std::make_shared<OGLSync>();
+    fence->Create();
+    for (const Buffer& buffer : used_blocks) {
+        buffer->SetUseFence(fence);
+    }
+    used_blocks.clear();
+}
+
 Buffer OGLBufferCache::CreateBlock(CacheAddr cache_addr, std::size_t size) {
-    return std::make_shared<CachedBufferBlock>(cache_addr, size);
+    return std::make_shared<CachedBufferBlock>(cache_addr, size, use_persistent_blocks);
 }
 
 void OGLBufferCache::WriteBarrier() {
@@ -56,6 +110,7 @@ void OGLBufferCache::WriteBarrier() {
 }
 
 const GLuint* OGLBufferCache::ToHandle(const Buffer& buffer) {
+    MarkAsUsed(buffer);
     return buffer->GetHandle();
 }
 
@@ -66,6 +121,10 @@ const GLuint* OGLBufferCache::GetEmptyBuffer(std::size_t) {
 
 void OGLBufferCache::UploadBlockData(const Buffer& buffer, std::size_t offset, std::size_t size,
                                      const u8* data) {
+    if (u8* const mapped_ptr = buffer->GetMappedPointer(); mapped_ptr && buffer->IsIdle()) {
+        std::memcpy(mapped_ptr + offset, data, size);
+        return;
+    }
     glNamedBufferSubData(*buffer->GetHandle(), static_cast<GLintptr>(offset),
                          static_cast<GLsizeiptr>(size), data);
 }
@@ -73,17 +132,32 @@ void OGLBufferCache::UploadBlockData(const Buffer& buffer, std::size_t offset, s
 void OGLBufferCache::DownloadBlockData(const Buffer& buffer, std::size_t offset, std::size_t size,
                                        u8* data) {
     MICROPROFILE_SCOPE(OpenGL_Buffer_Download);
+    if (const u8* const mapped_ptr = buffer->GetMappedPointer(); mapped_ptr && buffer->IsIdle()) {
+        std::memcpy(data, mapped_ptr + offset, size);
+        return;
+    }
     glGetNamedBufferSubData(*buffer->GetHandle(), static_cast<GLintptr>(offset),
                             static_cast<GLsizeiptr>(size), data);
 }
 
 void OGLBufferCache::CopyBlock(const Buffer& src, const Buffer& dst, std::size_t src_offset,
                                std::size_t dst_offset, std::size_t size) {
+    // Later uploads must be ordered after the copy, so they can't write to the mapping directly
+    MarkAsUsed(src);
+    MarkAsUsed(dst);
     glCopyNamedBufferSubData(*src->GetHandle(), *dst->GetHandle(),
                              static_cast<GLintptr>(src_offset), static_cast<GLintptr>(dst_offset),
                              static_cast<GLsizeiptr>(size));
 }
 
+void OGLBufferCache::MarkAsUsed(const Buffer& buffer) {
+    if (!buffer->GetMappedPointer() || buffer->IsPendingUse()) {
+        return;
+    }
+    buffer->MarkAsPendingUse();
+    used_blocks.push_back(buffer);
+}
+
 OGLBufferCache::BufferInfo OGLBufferCache::ConstBufferUpload(const void* raw_pointer,
                                                              std::size_t size) {
     DEBUG_ASSERT(cbuf_cursor < std::size(cbufs));
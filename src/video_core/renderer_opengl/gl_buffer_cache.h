@@ -6,6 +6,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "common/common_types.h"
 #include "video_core/buffer_cache/buffer_cache.h"
@@ -31,15 +32,39 @@ using GenericBufferCache = VideoCommon::BufferCache<Buffer, GLuint, OGLStreamBuf
 
 class CachedBufferBlock : public VideoCommon::BufferBlock {
 public:
-    explicit CachedBufferBlock(CacheAddr cache_addr, const std::size_t size);
+    explicit CachedBufferBlock(CacheAddr cache_addr, const std::size_t size, bool use_persistent);
     ~CachedBufferBlock();
 
     const GLuint* GetHandle() const {
         return &gl_buffer.handle;
     }
 
+    /// Returns the persistent coherent mapping of the buffer, nullptr when it's not mapped.
+    u8* GetMappedPointer() const {
+        return mapped_ptr;
+    }
+
+    /// Returns true when the buffer is used by commands that have not been fenced yet.
+    bool IsPendingUse() const {
+        return is_pending_use;
+    }
+
+    /// Marks the buffer as used by commands that have not been fenced yet.
+    void MarkAsPendingUse() {
+        is_pending_use = true;
+    }
+
+    /// Sets the fence signaled once the pending uses have finished.
+    void SetUseFence(std::shared_ptr<OGLSync> fence);
+
+    /// Returns true when no GPU command accesses the buffer, its mapping can be used directly.
+    bool IsIdle();
+
 private:
     OGLBuffer gl_buffer{};
+    u8* mapped_ptr = nullptr;
+    std::shared_ptr<OGLSync> use_fence;
+    bool is_pending_use = false;
 };
 
 class OGLBufferCache final : public GenericBufferCache {
@@ -54,6 +79,10 @@ public:
         cbuf_cursor = 0;
     }
 
+    /// Fences the uses of the mapped blocks recorded so far, so they can be accessed directly
+    /// from the CPU once the GPU is done with them.
+    void FenceBlockUses();
+
 protected:
     Buffer CreateBlock(CacheAddr cache_addr, std::size_t size) override;
 
@@ -73,6 +102,12 @@ protected:
     BufferInfo ConstBufferUpload(const void* raw_pointer, std::size_t size) override;
 
 private:
+    /// Records a use of a mapped block by the commands being recorded.
+    void MarkAsUsed(const Buffer& buffer);
+
+    bool use_persistent_blocks = false;
+    std::vector<Buffer> used_blocks;
+
     std::size_t cbuf_cursor = 0;
     std::array<GLuint, Tegra::Engines::Maxwell3D::Regs::MaxConstBuffers *
                            Tegra::Engines::Maxwell3D::Regs::MaxShaderProgram>
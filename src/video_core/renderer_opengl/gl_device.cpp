@@ -13,6 +13,7 @@
 
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
+#include "core/settings.h"
 #include "video_core/renderer_opengl/gl_device.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 
@@ -157,10 +158,23 @@ Device::Device() : base_bindings{BuildBaseBindings()} {
     has_precise_bug = TestPreciseBug();
     has_broken_compute = is_intel_proprietary;
     has_fast_buffer_sub_data = is_nvidia;
+    has_parallel_shader_compile = GLAD_GL_ARB_parallel_shader_compile;
+    has_buffer_storage = GLAD_GL_ARB_buffer_storage;
+    has_nv_viewport_array2 = GLAD_GL_NV_viewport_array2;
+    has_transform_feedback = GLAD_GL_ARB_transform_feedback3 && GLAD_GL_ARB_enhanced_layouts;
+
+    // NVIDIA assembly programs build much faster than GLSL, use them when every extension the
+    // decompiler relies on is available
+    use_assembly_shaders = Settings::values.use_assembly_shaders && GLAD_GL_NV_gpu_program5 &&
+                           GLAD_GL_NV_parameter_buffer_object2 &&
+                           GLAD_GL_EXT_direct_state_access &&
+                           HasExtension(extensions, "GL_NV_shader_storage_buffer");
 
     LOG_INFO(Render_OpenGL, "Renderer_VariableAOFFI: {}", has_variable_aoffi);
     LOG_INFO(Render_OpenGL, "Renderer_ComponentIndexingBug: {}", has_component_indexing_bug);
     LOG_INFO(Render_OpenGL, "Renderer_PreciseBug: {}", has_precise_bug);
+    LOG_INFO(Render_OpenGL, "Renderer_AssemblyShaders: {}", use_assembly_shaders);
+    LOG_INFO(Render_OpenGL, "Renderer_TransformFeedback: {}", has_transform_feedback);
 }
 
 Device::Device(std::nullptr_t) {
@@ -175,6 +189,7 @@ Device::Device(std::nullptr_t) {
     has_component_indexing_bug = false;
     has_broken_compute = false;
     has_precise_bug = false;
+    has_transform_feedback = true;
 }
 
 bool Device::TestVariableAoffi() {
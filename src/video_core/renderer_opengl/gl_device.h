@@ -84,6 +84,26 @@ public:
         return has_fast_buffer_sub_data;
     }
 
+    bool HasParallelShaderCompile() const {
+        return has_parallel_shader_compile;
+    }
+
+    bool HasBufferStorage() const {
+        return has_buffer_storage;
+    }
+
+    bool HasNvViewportArray2() const {
+        return has_nv_viewport_array2;
+    }
+
+    bool HasTransformFeedback() const {
+        return has_transform_feedback;
+    }
+
+    bool UseAssemblyShaders() const {
+        return use_assembly_shaders;
+    }
+
 private:
     static bool TestVariableAoffi();
     static bool TestPreciseBug();
@@ -102,6 +122,11 @@ private:
     bool has_precise_bug{};
     bool has_broken_compute{};
     bool has_fast_buffer_sub_data{};
+    bool has_parallel_shader_compile{};
+    bool has_buffer_storage{};
+    bool has_nv_viewport_array2{};
+    bool has_transform_feedback{};
+    bool use_assembly_shaders{};
 };
 
 } // namespace OpenGL
@@ -18,17 +18,40 @@ namespace OpenGL {
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 using VideoCore::Surface::SurfaceType;
 
+/// Frames between garbage collections.
+constexpr u64 COLLECTION_INTERVAL = 256;
+
+/// Frames a framebuffer can stay unused before it's destroyed.
+constexpr u64 MAX_UNUSED_FRAMES = 1024;
+
 FramebufferCacheOpenGL::FramebufferCacheOpenGL() = default;
 
 FramebufferCacheOpenGL::~FramebufferCacheOpenGL() = default;
 
 GLuint FramebufferCacheOpenGL::GetFramebuffer(const FramebufferCacheKey& key) {
-    const auto [entry, is_cache_miss] = cache.try_emplace(key);
-    auto& framebuffer{entry->second};
+    const auto [it, is_cache_miss] = cache.try_emplace(key);
+    auto& entry{it->second};
     if (is_cache_miss) {
-        framebuffer = CreateFramebuffer(key);
+        entry.framebuffer = CreateFramebuffer(key);
+    }
+    entry.last_use_frame = frame;
+    return entry.framebuffer.handle;
+}
+
+bool FramebufferCacheOpenGL::TickFrame() {
+    ++frame;
+    if (frame % COLLECTION_INTERVAL != 0) {
+        return false;
+    }
+    const std::size_t old_size = cache.size();
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (it->second.last_use_frame + MAX_UNUSED_FRAMES < frame) {
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
     }
-    return framebuffer.handle;
+    return cache.size() != old_size;
 }
 
 OGLFramebuffer FramebufferCacheOpenGL::CreateFramebuffer(const FramebufferCacheKey& key) {
@@ -60,11 +60,21 @@ public:
 
     GLuint GetFramebuffer(const FramebufferCacheKey& key);
 
+    /// Destroys the framebuffers that haven't been used in a while, releasing their views.
+    /// Returns true when any of them has been destroyed.
+    bool TickFrame();
+
 private:
+    struct Entry {
+        OGLFramebuffer framebuffer;
+        u64 last_use_frame = 0;
+    };
+
     OGLFramebuffer CreateFramebuffer(const FramebufferCacheKey& key);
 
     OpenGLState local_state;
-    std::unordered_map<FramebufferCacheKey, OGLFramebuffer> cache;
+    std::unordered_map<FramebufferCacheKey, Entry> cache;
+    u64 frame = 0;
 };
 
 } // namespace OpenGL
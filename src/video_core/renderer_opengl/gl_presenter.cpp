@@ -0,0 +1,137 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "core/frontend/emu_window.h"
+#include "video_core/renderer_opengl/gl_presenter.h"
+
+namespace OpenGL {
+
+MICROPROFILE_DEFINE(OpenGL_Present, "OpenGL", "Present", MP_RGB(128, 128, 192));
+
+FramePresenter::FramePresenter(std::unique_ptr<Core::Frontend::GraphicsContext> context_)
+    : context{std::move(context_)} {
+    presenter_thread = std::thread([this] { PresenterLoop(); });
+}
+
+FramePresenter::~FramePresenter() {
+    {
+        std::lock_guard lock{mutex};
+        stop_requested = true;
+    }
+    cv.notify_one();
+    presenter_thread.join();
+}
+
+FramePresenter::Frame& FramePresenter::GetRenderFrame(u32 width, u32 height, bool is_srgb) {
+    std::size_t index;
+    {
+        std::lock_guard lock{mutex};
+        index = GetFreeFrame();
+    }
+    Frame& frame = frames[index];
+
+    // Orders the presenter's last read of the texture before the writes of this frame, on the GPU
+    if (frame.present_fence.handle != nullptr) {
+        glWaitSync(frame.present_fence.handle, 0, GL_TIMEOUT_IGNORED);
+        frame.present_fence.Release();
+    }
+
+    if (frame.texture.handle == 0 || frame.width != width || frame.height != height ||
+        frame.is_srgb != is_srgb) {
+        frame.width = width;
+        frame.height = height;
+        frame.is_srgb = is_srgb;
+        frame.texture.Release();
+        frame.texture.Create(GL_TEXTURE_2D);
+        glTextureStorage2D(frame.texture.handle, 1, is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, width,
+                           height);
+        if (frame.framebuffer.handle == 0) {
+            frame.framebuffer.Create();
+        }
+        glNamedFramebufferTexture(frame.framebuffer.handle, GL_COLOR_ATTACHMENT0,
+                                  frame.texture.handle, 0);
+    }
+    return frame;
+}
+
+void FramePresenter::PresentFrame(Frame& frame) {
+    frame.render_fence.Create();
+    // The presenter's context only sees the fence once it reached the driver
+    glFlush();
+
+    const auto index = static_cast<std::size_t>(&frame - frames.data());
+    {
+        std::lock_guard lock{mutex};
+        // A queued frame the presenter didn't get to is dropped, its texture is free again
+        if (queued_frame) {
+            frames[*queued_frame].render_fence.Release();
+        }
+        queued_frame = index;
+    }
+    cv.notify_one();
+}
+
+void FramePresenter::PresenterLoop() {
+    Common::SetCurrentThreadName("yuzu:Present");
+    MicroProfileOnThreadCreate("Present");
+
+    context->MakeCurrent();
+
+    OGLFramebuffer read_framebuffer;
+    read_framebuffer.Create();
+
+    std::unique_lock lock{mutex};
+    while (true) {
+        cv.wait(lock, [this] { return stop_requested || queued_frame.has_value(); });
+        if (stop_requested) {
+            break;
+        }
+        presented_frame = std::exchange(queued_frame, std::nullopt);
+        Frame& frame = frames[*presented_frame];
+        lock.unlock();
+
+        {
+            MICROPROFILE_SCOPE(OpenGL_Present);
+
+            glWaitSync(frame.render_fence.handle, 0, GL_TIMEOUT_IGNORED);
+            frame.render_fence.Release();
+
+            // Without sRGB writes enabled, the blit copies the already encoded values as they are
+            glNamedFramebufferTexture(read_framebuffer.handle, GL_COLOR_ATTACHMENT0,
+                                      frame.texture.handle, 0);
+            glBlitNamedFramebuffer(read_framebuffer.handle, 0, 0, 0, frame.width, frame.height, 0,
+                                   0, frame.width, frame.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            frame.present_fence.Create();
+            glFlush();
+
+            context->SwapBuffers();
+        }
+
+        lock.lock();
+        presented_frame.reset();
+    }
+    lock.unlock();
+
+    read_framebuffer.Release();
+    context->DoneCurrent();
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+std::size_t FramePresenter::GetFreeFrame() const {
+    for (std::size_t index = 0; index < NUM_FRAMES; ++index) {
+        if (index != queued_frame && index != presented_frame) {
+            return index;
+        }
+    }
+    UNREACHABLE_MSG("Every presentation frame is in use");
+    return 0;
+}
+
+} // namespace OpenGL
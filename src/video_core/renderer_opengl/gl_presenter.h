@@ -0,0 +1,84 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <glad/glad.h>
+
+#include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace Core::Frontend {
+class EmuWindow;
+class GraphicsContext;
+} // namespace Core::Frontend
+
+namespace OpenGL {
+
+/**
+ * Presents the frames rendered by the GPU thread from a thread of its own, with a context that
+ * shares objects with the GPU thread's one, so waiting for the driver to swap buffers (vsync
+ * throttling) never stalls rendering.
+ *
+ * Frames are handed over like a mailbox: the GPU thread renders into a texture of its own, then
+ * queues it, replacing the queued frame the presenter didn't get to yet. Fences order the texture
+ * accesses between the two contexts, so neither thread ever waits for the other one's GPU work.
+ */
+class FramePresenter final {
+public:
+    struct Frame {
+        OGLTexture texture;
+        OGLFramebuffer framebuffer; ///< Only valid in the GPU thread's context
+        u32 width = 0;
+        u32 height = 0;
+        bool is_srgb = false;
+        OGLSync render_fence;  ///< Signaled when the GPU thread finished rendering the frame
+        OGLSync present_fence; ///< Signaled when the presenter finished reading the frame
+    };
+
+    /// Starts presenting to the window through the given presentation context
+    explicit FramePresenter(std::unique_ptr<Core::Frontend::GraphicsContext> context);
+    ~FramePresenter();
+
+    FramePresenter(const FramePresenter&) = delete;
+    FramePresenter& operator=(const FramePresenter&) = delete;
+
+    /**
+     * Returns a frame of the given size to render into, whose framebuffer can be drawn to right
+     * away. Never blocks. Must be called from the GPU thread.
+     */
+    Frame& GetRenderFrame(u32 width, u32 height, bool is_srgb);
+
+    /// Queues the frame returned by GetRenderFrame for presentation, once rendered into it
+    void PresentFrame(Frame& frame);
+
+private:
+    static constexpr std::size_t NUM_FRAMES = 3;
+
+    void PresenterLoop();
+
+    /// Returns the index of a frame neither queued nor being presented
+    std::size_t GetFreeFrame() const;
+
+    std::unique_ptr<Core::Frontend::GraphicsContext> context;
+
+    std::array<Frame, NUM_FRAMES> frames;
+    std::optional<std::size_t> queued_frame;
+    std::optional<std::size_t> presented_frame;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stop_requested = false;
+
+    std::thread presenter_thread;
+};
+
+} // namespace OpenGL
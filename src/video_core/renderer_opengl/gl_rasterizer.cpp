@@ -6,6 +6,7 @@
 #include <array>
 #include <bitset>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -18,6 +19,7 @@
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
 #include "core/settings.h"
@@ -30,6 +32,7 @@
 #include "video_core/renderer_opengl/gl_shader_gen.h"
 #include "video_core/renderer_opengl/maxwell_to_gl.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
+#include "video_core/shader/transform_feedback.h"
 
 namespace OpenGL {
 
@@ -38,6 +41,8 @@ using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 using VideoCore::Surface::PixelFormat;
 using VideoCore::Surface::SurfaceTarget;
 using VideoCore::Surface::SurfaceType;
+using VideoCommon::Shader::MaxTransformFeedbackVaryings;
+using VideoCommon::Shader::TransformFeedbackState;
 
 MICROPROFILE_DEFINE(OpenGL_VAO, "OpenGL", "Vertex Format Setup", MP_RGB(128, 128, 192));
 MICROPROFILE_DEFINE(OpenGL_VB, "OpenGL", "Vertex Buffer Setup", MP_RGB(128, 128, 192));
@@ -58,9 +63,13 @@ Tegra::Texture::FullTextureInfo GetTextureInfo(const Engine& engine, const Entry
                                                Tegra::Engines::ShaderType shader_type,
                                                std::size_t index = 0) {
     if (entry.IsBindless()) {
-        const Tegra::Texture::TextureHandle tex_handle =
-            engine.AccessConstBuffer32(shader_type, entry.GetBuffer(), entry.GetOffset());
-        return engine.GetTextureInfo(tex_handle);
+        if constexpr (std::is_same_v<Engine, Tegra::Engines::Maxwell3D>) {
+            return engine.GetBindlessTexture(shader_type, entry.GetBuffer(), entry.GetOffset());
+        } else {
+            const Tegra::Texture::TextureHandle tex_handle =
+                engine.AccessConstBuffer32(shader_type, entry.GetBuffer(), entry.GetOffset());
+            return engine.GetTextureInfo(tex_handle);
+        }
     }
     const auto& gpu_profile = engine.AccessGuestDriverProfile();
     const u32 offset =
@@ -87,14 +96,33 @@ std::size_t GetConstBufferSize(const Tegra::Engines::ConstBufferInfo& buffer,
     return buffer.size;
 }
 
+/// Layout of the commands read by glMultiDrawArraysIndirect.
+struct DrawArraysIndirectCommand {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first;
+    GLuint base_instance;
+};
+
+/// Layout of the commands read by glMultiDrawElementsIndirect.
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+};
+
 } // Anonymous namespace
 
 RasterizerOpenGL::RasterizerOpenGL(Core::System& system, Core::Frontend::EmuWindow& emu_window,
                                    ScreenInfo& info)
     : RasterizerAccelerated{system.Memory()}, texture_cache{system, *this, device},
       shader_cache{*this, system, emu_window, device}, system{system}, screen_info{info},
-      buffer_cache{*this, system, device, STREAM_BUFFER_SIZE} {
-    shader_program_manager = std::make_unique<GLShader::ProgramManager>();
+      buffer_cache{*this, system, device, STREAM_BUFFER_SIZE},
+      fence_manager{system, *this, texture_cache, buffer_cache}, query_cache{system, *this} {
+    shader_program_manager =
+        std::make_unique<GLShader::ProgramManager>(device.UseAssemblyShaders());
     state.draw.shader_program = 0;
     state.Apply();
 
@@ -259,11 +287,55 @@ GLintptr RasterizerOpenGL::SetupIndexBuffer() {
     return offset;
 }
 
-void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
+void RasterizerOpenGL::SetupIndirectDraws() {
+    if (!accelerate_multi_draw) {
+        return;
+    }
+    const auto& maxwell3d = system.GPU().Maxwell3D();
+    const auto& regs = maxwell3d.regs;
+    const auto& draws = maxwell3d.mme_draw.draws;
+
+    std::pair<const GLuint*, u64> result;
+    if (accelerate_draw == AccelDraw::Indexed) {
+        // The index buffer covers the indices of every draw, starting from the lowest one
+        const auto index_size = static_cast<GLintptr>(regs.index_array.FormatSizeInBytes());
+        const auto base_index = static_cast<GLuint>(index_buffer_offset / index_size);
+        std::vector<DrawElementsIndirectCommand> commands(draws.size());
+        for (std::size_t i = 0; i < draws.size(); ++i) {
+            const auto& draw = draws[i];
+            commands[i] = {draw.count, 1, base_index + draw.first - regs.index_array.first,
+                           static_cast<GLint>(draw.base_vertex), draw.base_instance};
+        }
+        result = buffer_cache.UploadHostMemory(commands.data(),
+                                               commands.size() * sizeof(commands[0]));
+    } else {
+        std::vector<DrawArraysIndirectCommand> commands(draws.size());
+        for (std::size_t i = 0; i < draws.size(); ++i) {
+            const auto& draw = draws[i];
+            commands[i] = {draw.count, 1, draw.first, draw.base_instance};
+        }
+        result = buffer_cache.UploadHostMemory(commands.data(),
+                                               commands.size() * sizeof(commands[0]));
+    }
+    indirect_buffer = result.first;
+    indirect_buffer_offset = static_cast<GLintptr>(result.second);
+}
+
+bool RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
     MICROPROFILE_SCOPE(OpenGL_Shader);
     auto& gpu = system.GPU().Maxwell3D();
 
     std::array<bool, Maxwell::NumClipDistances> clip_distances{};
+    bool is_ready = true;
+
+    // Varyings are captured from the last vertex processing stage
+    TransformFeedbackState transform_feedback;
+    if (gpu.regs.tfb_enabled != 0 && device.HasTransformFeedback()) {
+        transform_feedback = TransformFeedbackState::FromRegs(gpu.regs);
+    }
+    const bool geometry_enabled =
+        gpu.regs.IsShaderConfigEnabled(static_cast<std::size_t>(Maxwell::ShaderProgram::Geometry));
+    transform_feedback_primitive = 0;
 
     for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
         const auto& shader_config = gpu.regs.shader_config[index];
@@ -301,8 +373,20 @@ void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
         SetupDrawTextures(stage, shader);
         SetupDrawImages(stage, shader);
 
-        const ProgramVariant variant(primitive_mode);
+        ProgramVariant variant(primitive_mode);
+        const bool is_last_vertex_stage =
+            program == Maxwell::ShaderProgram::Geometry ||
+            (program != Maxwell::ShaderProgram::Fragment && !geometry_enabled);
+        if (is_last_vertex_stage && transform_feedback.IsEnabled()) {
+            variant.transform_feedback = transform_feedback;
+            transform_feedback_primitive =
+                program == Maxwell::ShaderProgram::Geometry
+                    ? MaxwellToGL::TransformFeedbackPrimitive(
+                          shader->GetShaderEntries().output_topology)
+                    : MaxwellToGL::TransformFeedbackPrimitive(gpu.regs.draw.topology);
+        }
         const auto program_handle = shader->GetHandle(variant);
+        is_ready &= program_handle != 0;
 
         switch (program) {
         case Maxwell::ShaderProgram::VertexA:
@@ -338,6 +422,7 @@ void RasterizerOpenGL::SetupShaders(GLenum primitive_mode) {
     SyncClipEnabled(clip_distances);
 
     gpu.dirty.shaders = false;
+    return is_ready;
 }
 
 std::size_t RasterizerOpenGL::CalculateVertexArraysSize() const {
@@ -365,6 +450,16 @@ std::size_t RasterizerOpenGL::CalculateIndexBufferSize() const {
            static_cast<std::size_t>(regs.index_array.FormatSizeInBytes());
 }
 
+std::size_t RasterizerOpenGL::CalculateIndirectBufferSize() const {
+    if (!accelerate_multi_draw) {
+        return 0;
+    }
+    const std::size_t command_size = accelerate_draw == AccelDraw::Indexed
+                                         ? sizeof(DrawElementsIndirectCommand)
+                                         : sizeof(DrawArraysIndirectCommand);
+    return system.GPU().Maxwell3D().mme_draw.draws.size() * command_size;
+}
+
 void RasterizerOpenGL::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     shader_cache.LoadDiskCache(stop_loading, callback);
@@ -412,7 +507,16 @@ void RasterizerOpenGL::ConfigureFramebuffers() {
     texture_cache.GuardRenderTargets(false);
 
     state.draw.draw_framebuffer = framebuffer_cache.GetFramebuffer(key);
-    SyncViewport(state);
+
+    auto& dirty = system.GPU().Maxwell3D().dirty;
+    if (dirty.viewport || dirty.viewport_transform || dirty.screen_y_control) {
+        dirty.viewport = false;
+        dirty.viewport_transform = false;
+        dirty.screen_y_control = false;
+        SyncViewport(state);
+        state.MarkDirtyViewportState();
+        ++num_synced_groups;
+    }
 }
 
 void RasterizerOpenGL::ConfigureClearFramebuffer(OpenGLState& current_state, bool using_color_fb,
@@ -533,6 +637,9 @@ void RasterizerOpenGL::Clear() {
     clear_state.AllDirty();
     clear_state.Apply();
 
+    query_cache.UpdateCounters();
+    BeginHostConditionalRendering();
+
     if (use_color) {
         glClearBufferfv(GL_COLOR, 0, regs.clear_color);
     }
@@ -544,11 +651,22 @@ void RasterizerOpenGL::Clear() {
     } else if (use_stencil) {
         glClearBufferiv(GL_STENCIL, 0, &regs.clear_stencil);
     }
+
+    EndHostConditionalRendering();
 }
 
-void RasterizerOpenGL::DrawPrelude() {
+bool RasterizerOpenGL::DrawPrelude() {
     auto& gpu = system.GPU().Maxwell3D();
 
+    // Geometry shaders change how many viewports and scissors are synced
+    const bool geometry_shaders_enabled =
+        gpu.regs.IsShaderConfigEnabled(static_cast<std::size_t>(Maxwell::ShaderProgram::Geometry));
+    if (std::exchange(viewports_use_geometry, geometry_shaders_enabled) !=
+        geometry_shaders_enabled) {
+        gpu.dirty.viewport = true;
+        gpu.dirty.scissor_test = true;
+    }
+
     SyncRasterizeEnable(state);
     SyncColorMask();
     SyncFragmentColorClampState();
@@ -559,12 +677,18 @@ void RasterizerOpenGL::DrawPrelude() {
     SyncLogicOpState();
     SyncCullMode();
     SyncPrimitiveRestart();
-    SyncScissorTest(state);
-    SyncTransformFeedback();
+    if (gpu.dirty.scissor_test) {
+        gpu.dirty.scissor_test = false;
+        SyncScissorTest(state);
+        state.MarkDirtyViewportState();
+        ++num_synced_groups;
+    }
     SyncPointState();
     SyncPolygonOffset();
     SyncAlphaTest();
 
+    query_cache.UpdateCounters();
+
     buffer_cache.Acquire();
 
     // Draw the vertex batch
@@ -577,6 +701,9 @@ void RasterizerOpenGL::DrawPrelude() {
         buffer_size = Common::AlignUp(buffer_size, 4) + CalculateIndexBufferSize();
     }
 
+    // Add space for the commands of multi draw batches
+    buffer_size = Common::AlignUp(buffer_size, 4) + CalculateIndirectBufferSize();
+
     // Uniform space for the 5 shader stages
     buffer_size = Common::AlignUp<std::size_t>(buffer_size, 4) +
                   (sizeof(GLShader::MaxwellUniformData) + device.GetUniformBufferAlignment()) *
@@ -597,25 +724,39 @@ void RasterizerOpenGL::DrawPrelude() {
     SetupVertexBuffer(vao);
     SetupVertexInstances(vao);
     index_buffer_offset = SetupIndexBuffer();
+    SetupIndirectDraws();
 
     // Prepare packed bindings.
     bind_ubo_pushbuffer.Setup();
     bind_ssbo_pushbuffer.Setup();
+    bind_tfb_pushbuffer.Setup();
+    for (auto& pushbuffer : bind_parameter_pushbuffers) {
+        pushbuffer.Setup();
+    }
 
     // Setup emulation uniform buffer.
     GLShader::MaxwellUniformData ubo;
     ubo.SetFromRegs(gpu);
     const auto [buffer, offset] =
         buffer_cache.UploadHostMemory(&ubo, sizeof(ubo), device.GetUniformBufferAlignment());
-    bind_ubo_pushbuffer.Push(EmulationUniformBlockBinding, buffer, offset,
-                             static_cast<GLsizeiptr>(sizeof(ubo)));
+    if (device.UseAssemblyShaders()) {
+        // Every stage reads it from its first parameter buffer
+        for (auto& pushbuffer : bind_parameter_pushbuffers) {
+            pushbuffer.Push(EmulationUniformBlockBinding, buffer, offset,
+                            static_cast<GLsizeiptr>(sizeof(ubo)));
+        }
+    } else {
+        bind_ubo_pushbuffer.Push(EmulationUniformBlockBinding, buffer, offset,
+                                 static_cast<GLsizeiptr>(sizeof(ubo)));
+    }
 
     // Setup shaders and their used resources.
     texture_cache.GuardSamplers(true);
     const auto primitive_mode = MaxwellToGL::PrimitiveTopology(gpu.regs.draw.topology);
-    SetupShaders(primitive_mode);
+    const bool shaders_ready = SetupShaders(primitive_mode);
     texture_cache.GuardSamplers(false);
 
+    SetupTransformFeedback();
     ConfigureFramebuffers();
 
     // Signal the buffer cache that we are not going to upload more things.
@@ -625,6 +766,10 @@ void RasterizerOpenGL::DrawPrelude() {
     vertex_array_pushbuffer.Bind();
     bind_ubo_pushbuffer.Bind();
     bind_ssbo_pushbuffer.Bind();
+    bind_tfb_pushbuffer.Bind();
+    for (auto& pushbuffer : bind_parameter_pushbuffers) {
+        pushbuffer.Bind();
+    }
 
     if (invalidate) {
         // As all cached buffers are invalidated, we need to recheck their state.
@@ -637,6 +782,7 @@ void RasterizerOpenGL::DrawPrelude() {
     if (texture_cache.TextureBarrier()) {
         glTextureBarrier();
     }
+    return shaders_ready;
 }
 
 struct DrawParams {
@@ -680,10 +826,16 @@ bool RasterizerOpenGL::DrawBatch(bool is_indexed) {
     accelerate_draw = is_indexed ? AccelDraw::Indexed : AccelDraw::Arrays;
 
     MICROPROFILE_SCOPE(OpenGL_Drawing);
-
-    DrawPrelude();
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DrawSetup};
 
     auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!DrawPrelude()) {
+        // Shaders are still being built in the background, skip the draw
+        maxwell3d.dirty.memory_general = false;
+        accelerate_draw = AccelDraw::Disabled;
+        return true;
+    }
+
     const auto& regs = maxwell3d.regs;
     const auto current_instance = maxwell3d.state.current_instance;
     DrawParams draw_call{};
@@ -701,7 +853,11 @@ bool RasterizerOpenGL::DrawBatch(bool is_indexed) {
         draw_call.count = static_cast<GLint>(regs.vertex_buffer.count);
         draw_call.base_vertex = static_cast<GLint>(regs.vertex_buffer.first);
     }
+    BeginHostConditionalRendering();
+    BeginTransformFeedback();
     draw_call.DispatchDraw();
+    EndTransformFeedback();
+    EndHostConditionalRendering();
 
     maxwell3d.dirty.memory_general = false;
     accelerate_draw = AccelDraw::Disabled;
@@ -712,35 +868,68 @@ bool RasterizerOpenGL::DrawMultiBatch(bool is_indexed) {
     accelerate_draw = is_indexed ? AccelDraw::Indexed : AccelDraw::Arrays;
 
     MICROPROFILE_SCOPE(OpenGL_Drawing);
-
-    DrawPrelude();
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DrawSetup};
 
     auto& maxwell3d = system.GPU().Maxwell3D();
-    const auto& regs = maxwell3d.regs;
     const auto& draw_setup = maxwell3d.mme_draw;
-    DrawParams draw_call{};
-    draw_call.is_indexed = is_indexed;
-    draw_call.num_instances = static_cast<GLint>(draw_setup.instance_count);
-    draw_call.base_instance = static_cast<GLint>(regs.vb_base_instance);
-    draw_call.is_instanced = draw_setup.instance_count > 1;
-    draw_call.primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
-    if (draw_call.is_indexed) {
-        draw_call.count = static_cast<GLint>(regs.index_array.count);
-        draw_call.base_vertex = static_cast<GLint>(regs.vb_element_base);
-        draw_call.index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
-        draw_call.index_buffer_offset = index_buffer_offset;
+    accelerate_multi_draw = draw_setup.draws.size() > 1;
+    if (!DrawPrelude()) {
+        // Shaders are still being built in the background, skip the draw
+        maxwell3d.dirty.memory_general = false;
+        accelerate_draw = AccelDraw::Disabled;
+        accelerate_multi_draw = false;
+        return true;
+    }
+
+    const auto& regs = maxwell3d.regs;
+    if (accelerate_multi_draw) {
+        // Draws sharing all their state are issued with a single command
+        const GLenum primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
+        const auto indirect = reinterpret_cast<const void*>(indirect_buffer_offset);
+        const auto draw_count = static_cast<GLsizei>(draw_setup.draws.size());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, *indirect_buffer);
+        BeginHostConditionalRendering();
+        BeginTransformFeedback();
+        if (is_indexed) {
+            glMultiDrawElementsIndirect(primitive_mode,
+                                        MaxwellToGL::IndexFormat(regs.index_array.format),
+                                        indirect, draw_count, 0);
+        } else {
+            glMultiDrawArraysIndirect(primitive_mode, indirect, draw_count, 0);
+        }
+        EndTransformFeedback();
+        EndHostConditionalRendering();
     } else {
-        draw_call.count = static_cast<GLint>(regs.vertex_buffer.count);
-        draw_call.base_vertex = static_cast<GLint>(regs.vertex_buffer.first);
+        DrawParams draw_call{};
+        draw_call.is_indexed = is_indexed;
+        draw_call.num_instances = static_cast<GLint>(draw_setup.instance_count);
+        draw_call.base_instance = static_cast<GLint>(regs.vb_base_instance);
+        draw_call.is_instanced = draw_setup.instance_count > 1;
+        draw_call.primitive_mode = MaxwellToGL::PrimitiveTopology(regs.draw.topology);
+        if (draw_call.is_indexed) {
+            draw_call.count = static_cast<GLint>(regs.index_array.count);
+            draw_call.base_vertex = static_cast<GLint>(regs.vb_element_base);
+            draw_call.index_format = MaxwellToGL::IndexFormat(regs.index_array.format);
+            draw_call.index_buffer_offset = index_buffer_offset;
+        } else {
+            draw_call.count = static_cast<GLint>(regs.vertex_buffer.count);
+            draw_call.base_vertex = static_cast<GLint>(regs.vertex_buffer.first);
+        }
+        BeginHostConditionalRendering();
+        BeginTransformFeedback();
+        draw_call.DispatchDraw();
+        EndTransformFeedback();
+        EndHostConditionalRendering();
     }
-    draw_call.DispatchDraw();
 
     maxwell3d.dirty.memory_general = false;
     accelerate_draw = AccelDraw::Disabled;
+    accelerate_multi_draw = false;
     return true;
 }
 
 void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DrawSetup};
     if (device.HasBrokenCompute()) {
         return;
     }
@@ -782,6 +971,25 @@ void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
     glDispatchCompute(launch_desc.grid_dim_x, launch_desc.grid_dim_y, launch_desc.grid_dim_z);
 }
 
+void RasterizerOpenGL::ResetCounter(VideoCore::QueryType type) {
+    query_cache.ResetCounter(type);
+}
+
+bool RasterizerOpenGL::Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+                             std::optional<u64> timestamp) {
+    query_cache.Query(gpu_addr, type, timestamp);
+    return true;
+}
+
+bool RasterizerOpenGL::BeginConditionalRendering(GPUVAddr condition_addr) {
+    conditional_counter = query_cache.GetPendingCounter(condition_addr);
+    return conditional_counter != nullptr;
+}
+
+void RasterizerOpenGL::EndConditionalRendering() {
+    conditional_counter = nullptr;
+}
+
 void RasterizerOpenGL::FlushAll() {}
 
 void RasterizerOpenGL::FlushRegion(CacheAddr addr, u64 size) {
@@ -791,6 +999,7 @@ void RasterizerOpenGL::FlushRegion(CacheAddr addr, u64 size) {
     }
     texture_cache.FlushRegion(addr, size);
     buffer_cache.FlushRegion(addr, size);
+    query_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(CacheAddr addr, u64 size) {
@@ -801,6 +1010,7 @@ void RasterizerOpenGL::InvalidateRegion(CacheAddr addr, u64 size) {
     texture_cache.InvalidateRegion(addr, size);
     shader_cache.InvalidateRegion(addr, size);
     buffer_cache.InvalidateRegion(addr, size);
+    query_cache.InvalidateRegion(addr, size);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
@@ -810,20 +1020,45 @@ void RasterizerOpenGL::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
     InvalidateRegion(addr, size);
 }
 
+void RasterizerOpenGL::SignalSyncPoint(u32 syncpoint_id) {
+    fence_manager.SignalSyncPoint(syncpoint_id);
+}
+
+void RasterizerOpenGL::ReleaseFences() {
+    fence_manager.WaitPendingFences();
+}
+
 void RasterizerOpenGL::FlushCommands() {
     glFlush();
 }
 
 void RasterizerOpenGL::TickFrame() {
+    LOG_TRACE(Render_OpenGL, "Frame synced {} state groups issuing {} state GL calls",
+              std::exchange(num_synced_groups, 0), OpenGLState::ResetCallCount());
+
+    buffer_cache.FenceBlockUses();
     buffer_cache.TickFrame();
+    texture_cache.TickFrame();
+
+    // Destroyed objects might still be referenced by the rasterizer state, they are set before
+    // each draw so they can be safely unbound
+    if (sampler_cache.TickFrame()) {
+        state.samplers.fill(0);
+    }
+    if (framebuffer_cache.TickFrame()) {
+        state.draw.draw_framebuffer = 0;
+    }
 }
 
 bool RasterizerOpenGL::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                              const Tegra::Engines::Fermi2D::Regs::Surface& dst,
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
     MICROPROFILE_SCOPE(OpenGL_Blits);
-    texture_cache.DoFermiCopy(src, dst, copy_config);
-    return true;
+    return texture_cache.DoFermiCopy(src, dst, copy_config);
+}
+
+bool RasterizerOpenGL::AccelerateBufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) {
+    return buffer_cache.CopyRegion(src_addr, dst_addr, static_cast<std::size_t>(size));
 }
 
 bool RasterizerOpenGL::AccelerateDisplay(const Tegra::FramebufferConfig& config,
@@ -857,15 +1092,33 @@ bool RasterizerOpenGL::AccelerateDisplay(const Tegra::FramebufferConfig& config,
     return true;
 }
 
+std::pair<u32, u32> RasterizerOpenGL::GetAndResetSurfaceOverlapStats() {
+    return texture_cache.GetAndResetOverlapStats();
+}
+
+u64 RasterizerOpenGL::GetAndResetSkippedUploadStats() {
+    return texture_cache.GetAndResetSkippedUploadStats();
+}
+
+std::pair<u64, u64> RasterizerOpenGL::GetAndResetBufferUploadStats() {
+    return buffer_cache.GetAndResetUploadStats();
+}
+
 void RasterizerOpenGL::SetupDrawConstBuffers(std::size_t stage_index, const Shader& shader) {
     MICROPROFILE_SCOPE(OpenGL_UBO);
     const auto& stages = system.GPU().Maxwell3D().state.shader_stages;
     const auto& shader_stage = stages[stage_index];
 
-    u32 binding = device.GetBaseBindings(stage_index).uniform_buffer;
+    // Assembly shaders read constant buffers from the stage's parameter buffers, after the
+    // emulation buffer
+    const bool use_assembly = device.UseAssemblyShaders();
+    auto& pushbuffer = use_assembly ? bind_parameter_pushbuffers[stage_index] : bind_ubo_pushbuffer;
+    u32 binding = use_assembly ? EmulationUniformBlockBinding + 1
+                               : device.GetBaseBindings(stage_index).uniform_buffer;
     for (const auto& entry : shader->GetShaderEntries().const_buffers) {
         const auto& buffer = shader_stage.const_buffers[entry.GetIndex()];
-        SetupConstBuffer(binding++, buffer, entry);
+        const std::size_t upload_slot = stage_index * Maxwell::MaxConstBuffers + entry.GetIndex();
+        SetupConstBuffer(pushbuffer, binding++, buffer, entry, upload_slot);
     }
 }
 
@@ -881,16 +1134,17 @@ void RasterizerOpenGL::SetupComputeConstBuffers(const Shader& kernel) {
         buffer.address = config.Address();
         buffer.size = config.size;
         buffer.enabled = mask[entry.GetIndex()];
-        SetupConstBuffer(binding++, buffer, entry);
+        SetupConstBuffer(bind_ubo_pushbuffer, binding++, buffer, entry, std::nullopt);
     }
 }
 
-void RasterizerOpenGL::SetupConstBuffer(u32 binding, const Tegra::Engines::ConstBufferInfo& buffer,
-                                        const GLShader::ConstBufferEntry& entry) {
+void RasterizerOpenGL::SetupConstBuffer(BindBuffersRangePushBuffer& pushbuffer, u32 binding,
+                                        const Tegra::Engines::ConstBufferInfo& buffer,
+                                        const GLShader::ConstBufferEntry& entry,
+                                        std::optional<std::size_t> upload_slot) {
     if (!buffer.enabled) {
         // Set values to zero to unbind buffers
-        bind_ubo_pushbuffer.Push(binding, buffer_cache.GetEmptyBuffer(sizeof(float)), 0,
-                                 sizeof(float));
+        pushbuffer.Push(binding, buffer_cache.GetEmptyBuffer(sizeof(float)), 0, sizeof(float));
         return;
     }
 
@@ -899,9 +1153,13 @@ void RasterizerOpenGL::SetupConstBuffer(u32 binding, const Tegra::Engines::Const
     const std::size_t size = Common::AlignUp(GetConstBufferSize(buffer, entry), sizeof(GLvec4));
 
     const auto alignment = device.GetUniformBufferAlignment();
-    const auto [cbuf, offset] = buffer_cache.UploadMemory(buffer.address, size, alignment, false,
-                                                          device.HasFastBufferSubData());
-    bind_ubo_pushbuffer.Push(binding, cbuf, offset, size);
+    const bool use_fast_cbuf = device.HasFastBufferSubData();
+    const auto [cbuf, offset] =
+        upload_slot ? buffer_cache.UploadConstBuffer(*upload_slot, buffer.address, size, alignment,
+                                                     buffer.generation, use_fast_cbuf)
+                    : buffer_cache.UploadMemory(buffer.address, size, alignment, false,
+                                                use_fast_cbuf);
+    pushbuffer.Push(binding, cbuf, offset, size);
 }
 
 void RasterizerOpenGL::SetupDrawGlobalMemory(std::size_t stage_index, const Shader& shader) {
@@ -909,13 +1167,14 @@ void RasterizerOpenGL::SetupDrawGlobalMemory(std::size_t stage_index, const Shad
     auto& memory_manager{gpu.MemoryManager()};
     const auto cbufs{gpu.Maxwell3D().state.shader_stages[stage_index]};
 
-    u32 binding = device.GetBaseBindings(stage_index).shader_storage_buffer;
+    global_ranges.clear();
     for (const auto& entry : shader->GetShaderEntries().global_memory_entries) {
         const auto addr{cbufs.const_buffers[entry.GetCbufIndex()].address + entry.GetCbufOffset()};
         const auto gpu_addr{memory_manager.Read<u64>(addr)};
         const auto size{memory_manager.Read<u32>(addr + 8)};
-        SetupGlobalMemory(binding++, entry, gpu_addr, size);
+        AddGlobalMemoryRange(entry, gpu_addr, size);
     }
+    SetupGlobalMemory(device.GetBaseBindings(stage_index).shader_storage_buffer);
 }
 
 void RasterizerOpenGL::SetupComputeGlobalMemory(const Shader& kernel) {
@@ -923,21 +1182,32 @@ void RasterizerOpenGL::SetupComputeGlobalMemory(const Shader& kernel) {
     auto& memory_manager{gpu.MemoryManager()};
     const auto cbufs{gpu.KeplerCompute().launch_description.const_buffer_config};
 
-    u32 binding = 0;
+    global_ranges.clear();
     for (const auto& entry : kernel->GetShaderEntries().global_memory_entries) {
         const auto addr{cbufs[entry.GetCbufIndex()].Address() + entry.GetCbufOffset()};
         const auto gpu_addr{memory_manager.Read<u64>(addr)};
         const auto size{memory_manager.Read<u32>(addr + 8)};
-        SetupGlobalMemory(binding++, entry, gpu_addr, size);
+        AddGlobalMemoryRange(entry, gpu_addr, size);
     }
+    SetupGlobalMemory(0);
 }
 
-void RasterizerOpenGL::SetupGlobalMemory(u32 binding, const GLShader::GlobalMemoryEntry& entry,
-                                         GPUVAddr gpu_addr, std::size_t size) {
+void RasterizerOpenGL::AddGlobalMemoryRange(const GLShader::GlobalMemoryEntry& entry,
+                                            GPUVAddr gpu_addr, std::size_t size) {
+    if (const u32 size_bound = entry.GetSizeBound(); size_bound != 0) {
+        size = std::min<std::size_t>(size, size_bound);
+    }
+    global_ranges.push_back({gpu_addr, size, entry.IsWritten()});
+}
+
+void RasterizerOpenGL::SetupGlobalMemory(u32 binding) {
     const auto alignment{device.GetShaderStorageBufferAlignment()};
-    const auto [ssbo, buffer_offset] =
-        buffer_cache.UploadMemory(gpu_addr, size, alignment, entry.IsWritten());
-    bind_ssbo_pushbuffer.Push(binding, ssbo, buffer_offset, static_cast<GLsizeiptr>(size));
+    buffer_cache.UploadMemoryRanges(global_ranges, alignment, global_buffers);
+    for (std::size_t i = 0; i < global_ranges.size(); ++i) {
+        const auto [ssbo, buffer_offset] = global_buffers[i];
+        bind_ssbo_pushbuffer.Push(binding++, ssbo, buffer_offset,
+                                  static_cast<GLsizeiptr>(global_ranges[i].size));
+    }
 }
 
 void RasterizerOpenGL::SetupDrawTextures(std::size_t stage_index, const Shader& shader) {
@@ -1087,7 +1357,14 @@ void RasterizerOpenGL::SyncClipCoef() {
 }
 
 void RasterizerOpenGL::SyncCullMode() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.cull_mode) {
+        return;
+    }
+    maxwell3d.dirty.cull_mode = false;
+    ++num_synced_groups;
+
+    const auto& regs = maxwell3d.regs;
 
     state.cull.enabled = regs.cull.enabled != 0;
     if (state.cull.enabled) {
@@ -1098,14 +1375,28 @@ void RasterizerOpenGL::SyncCullMode() {
 }
 
 void RasterizerOpenGL::SyncPrimitiveRestart() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.primitive_restart) {
+        return;
+    }
+    maxwell3d.dirty.primitive_restart = false;
+    ++num_synced_groups;
+
+    const auto& regs = maxwell3d.regs;
 
     state.primitive_restart.enabled = regs.primitive_restart.enabled;
     state.primitive_restart.index = regs.primitive_restart.index;
 }
 
 void RasterizerOpenGL::SyncDepthTestState() {
-    const auto& regs = system.GPU().Maxwell3D().regs;
+    auto& maxwell3d = system.GPU().Maxwell3D();
+    if (!maxwell3d.dirty.depth_test) {
+        return;
+    }
+    maxwell3d.dirty.depth_test = false;
+    ++num_synced_groups;
+
+    const auto& regs = maxwell3d.regs;
 
     state.depth.test_enabled = regs.depth_test_enable != 0;
     state.depth.write_mask = regs.depth_write_enabled ? GL_TRUE : GL_FALSE;
@@ -1122,6 +1413,7 @@ void RasterizerOpenGL::SyncStencilTestState() {
     if (!maxwell3d.dirty.stencil_test) {
         return;
     }
+    ++num_synced_groups;
     maxwell3d.dirty.stencil_test = false;
 
     const auto& regs = maxwell3d.regs;
@@ -1168,6 +1460,7 @@ void RasterizerOpenGL::SyncColorMask() {
     if (!maxwell3d.dirty.color_mask) {
         return;
     }
+    ++num_synced_groups;
     const auto& regs = maxwell3d.regs;
 
     const std::size_t count =
@@ -1201,6 +1494,7 @@ void RasterizerOpenGL::SyncBlendState() {
     if (!maxwell3d.dirty.blend_state) {
         return;
     }
+    ++num_synced_groups;
     const auto& regs = maxwell3d.regs;
 
     state.blend_color.red = regs.blend_color.r;
@@ -1284,8 +1578,93 @@ void RasterizerOpenGL::SyncScissorTest(OpenGLState& current_state) {
 }
 
 void RasterizerOpenGL::SyncTransformFeedback() {
+    // Each attribute is described by its enum, component count and index
+    static constexpr std::size_t STRIDE = 3;
+    std::array<GLint, MaxTransformFeedbackVaryings * STRIDE * Maxwell::NumTransformFeedbackBuffers>
+        attribs;
+    std::array<GLint, Maxwell::NumTransformFeedbackBuffers> streams;
+
     const auto& regs = system.GPU().Maxwell3D().regs;
-    UNIMPLEMENTED_IF_MSG(regs.tfb_enabled != 0, "Transform feedbacks are not implemented");
+    GLint* cursor = attribs.data();
+    GLint* current_stream = streams.data();
+    for (std::size_t buffer = 0; buffer < Maxwell::NumTransformFeedbackBuffers; ++buffer) {
+        const auto& layout = regs.tfb_layouts[buffer];
+        if (layout.varying_count == 0) {
+            continue;
+        }
+        const u32 varying_count =
+            std::min<u32>(layout.varying_count, static_cast<u32>(MaxTransformFeedbackVaryings));
+        UNIMPLEMENTED_IF_MSG(layout.stride != varying_count * sizeof(u32),
+                             "Unimplemented stride padding on buffer {}", buffer);
+
+        if (current_stream != streams.data()) {
+            cursor[0] = GL_NEXT_BUFFER_NV;
+            cursor[1] = 0;
+            cursor[2] = 0;
+            cursor += STRIDE;
+        }
+        *current_stream++ = static_cast<GLint>(buffer);
+
+        const auto& locations = regs.tfb_varying_locs[buffer];
+        std::optional<u8> current_index;
+        for (u32 offset = 0; offset < varying_count; ++offset) {
+            const u8 location = locations[offset];
+            const u8 index = location / 4;
+            if (current_index == index) {
+                // Consecutive components of an attribute extend its previous entry
+                ++cursor[-2];
+                continue;
+            }
+            current_index = index;
+            std::tie(cursor[0], cursor[2]) = MaxwellToGL::TransformFeedbackAttribute(location);
+            cursor[1] = 1;
+            cursor += STRIDE;
+        }
+    }
+
+    const auto num_attribs = static_cast<GLsizei>((cursor - attribs.data()) / STRIDE);
+    const auto num_streams = static_cast<GLsizei>(current_stream - streams.data());
+    glTransformFeedbackStreamAttribsNV(num_attribs, attribs.data(), num_streams, streams.data(),
+                                       GL_INTERLEAVED_ATTRIBS);
+}
+
+void RasterizerOpenGL::SetupTransformFeedback() {
+    if (transform_feedback_primitive == 0) {
+        return;
+    }
+    const auto& regs = system.GPU().Maxwell3D().regs;
+    UNIMPLEMENTED_IF_MSG(
+        regs.IsShaderConfigEnabled(
+            static_cast<std::size_t>(Maxwell::ShaderProgram::TesselationEval)),
+        "Unimplemented transform feedback of tessellation shaders");
+
+    if (device.UseAssemblyShaders()) {
+        SyncTransformFeedback();
+    }
+    for (std::size_t index = 0; index < Maxwell::NumTransformFeedbackBuffers; ++index) {
+        const auto& binding = regs.tfb_bindings[index];
+        if (binding.buffer_enable == 0 || binding.buffer_size <= binding.buffer_offset) {
+            continue;
+        }
+        // Bind the cached block as written, vertex fetches of the range will reuse it on the host
+        const GPUVAddr gpu_addr = binding.Address() + static_cast<GPUVAddr>(binding.buffer_offset);
+        const auto size = static_cast<std::size_t>(binding.buffer_size - binding.buffer_offset);
+        const auto [buffer, offset] = buffer_cache.UploadMemory(gpu_addr, size, 4, true);
+        bind_tfb_pushbuffer.Push(static_cast<GLuint>(index), buffer,
+                                 static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+    }
+}
+
+void RasterizerOpenGL::BeginTransformFeedback() {
+    if (transform_feedback_primitive != 0) {
+        glBeginTransformFeedback(transform_feedback_primitive);
+    }
+}
+
+void RasterizerOpenGL::EndTransformFeedback() {
+    if (transform_feedback_primitive != 0) {
+        glEndTransformFeedback();
+    }
 }
 
 void RasterizerOpenGL::SyncPointState() {
@@ -1301,6 +1680,7 @@ void RasterizerOpenGL::SyncPolygonOffset() {
     if (!maxwell3d.dirty.polygon_offset) {
         return;
     }
+    ++num_synced_groups;
     const auto& regs = maxwell3d.regs;
 
     state.polygon_offset.fill_enable = regs.polygon_offset_fill_enable != 0;
@@ -1316,6 +1696,19 @@ void RasterizerOpenGL::SyncPolygonOffset() {
     maxwell3d.dirty.polygon_offset = false;
 }
 
+void RasterizerOpenGL::BeginHostConditionalRendering() {
+    if (conditional_counter) {
+        // The host GPU waits for the query, the CPU doesn't
+        glBeginConditionalRender(conditional_counter->GetHandle(), GL_QUERY_WAIT);
+    }
+}
+
+void RasterizerOpenGL::EndHostConditionalRendering() {
+    if (conditional_counter) {
+        glEndConditionalRender();
+    }
+}
+
 void RasterizerOpenGL::SyncAlphaTest() {
     const auto& regs = system.GPU().Maxwell3D().regs;
     UNIMPLEMENTED_IF_MSG(regs.alpha_test_enabled != 0 && regs.rt_control.count > 1,
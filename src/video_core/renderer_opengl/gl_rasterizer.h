@@ -23,6 +23,8 @@
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_opengl/gl_buffer_cache.h"
 #include "video_core/renderer_opengl/gl_device.h"
+#include "video_core/renderer_opengl/gl_fence_manager.h"
+#include "video_core/renderer_opengl/gl_query_cache.h"
 #include "video_core/renderer_opengl/gl_framebuffer_cache.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_sampler_cache.h"
@@ -61,17 +63,27 @@ public:
     bool DrawMultiBatch(bool is_indexed) override;
     void Clear() override;
     void DispatchCompute(GPUVAddr code_addr) override;
+    void ResetCounter(VideoCore::QueryType type) override;
+    bool Query(GPUVAddr gpu_addr, VideoCore::QueryType type, std::optional<u64> timestamp) override;
+    bool BeginConditionalRendering(GPUVAddr condition_addr) override;
+    void EndConditionalRendering() override;
     void FlushAll() override;
     void FlushRegion(CacheAddr addr, u64 size) override;
     void InvalidateRegion(CacheAddr addr, u64 size) override;
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size) override;
+    void SignalSyncPoint(u32 syncpoint_id) override;
+    void ReleaseFences() override;
     void FlushCommands() override;
     void TickFrame() override;
     bool AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                const Tegra::Engines::Fermi2D::Regs::Surface& dst,
                                const Tegra::Engines::Fermi2D::Config& copy_config) override;
+    bool AccelerateBufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) override;
     bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                            u32 pixel_stride) override;
+    std::pair<u32, u32> GetAndResetSurfaceOverlapStats() override;
+    u64 GetAndResetSkippedUploadStats() override;
+    std::pair<u64, u64> GetAndResetBufferUploadStats() override;
     void LoadDiskResources(const std::atomic_bool& stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback) override;
 
@@ -88,9 +100,12 @@ private:
     /// Configures the current constbuffers to use for the kernel invocation.
     void SetupComputeConstBuffers(const Shader& kernel);
 
-    /// Configures a constant buffer.
-    void SetupConstBuffer(u32 binding, const Tegra::Engines::ConstBufferInfo& buffer,
-                          const GLShader::ConstBufferEntry& entry);
+    /// Configures a constant buffer. Buffers with an upload slot reuse their previous upload when
+    /// they didn't change.
+    void SetupConstBuffer(BindBuffersRangePushBuffer& pushbuffer, u32 binding,
+                          const Tegra::Engines::ConstBufferInfo& buffer,
+                          const GLShader::ConstBufferEntry& entry,
+                          std::optional<std::size_t> upload_slot);
 
     /// Configures the current global memory entries to use for the draw command.
     void SetupDrawGlobalMemory(std::size_t stage_index, const Shader& shader);
@@ -98,12 +113,16 @@ private:
     /// Configures the current global memory entries to use for the kernel invocation.
     void SetupComputeGlobalMemory(const Shader& kernel);
 
-    /// Configures a constant buffer.
-    void SetupGlobalMemory(u32 binding, const GLShader::GlobalMemoryEntry& entry, GPUVAddr gpu_addr,
-                           std::size_t size);
+    /// Queues a global memory region to be bound, trimmed to what the shader can access.
+    void AddGlobalMemoryRange(const GLShader::GlobalMemoryEntry& entry, GPUVAddr gpu_addr,
+                              std::size_t size);
+
+    /// Uploads the queued global memory regions and binds them starting at the given binding.
+    void SetupGlobalMemory(u32 binding);
 
     /// Syncs all the state, shaders, render targets and textures setting before a draw call.
-    void DrawPrelude();
+    /// Returns false when the draw has to be skipped because its shaders are still being built.
+    bool DrawPrelude();
 
     /// Configures the current textures to use for the draw command.
     void SetupDrawTextures(std::size_t stage_index, const Shader& shader);
@@ -162,9 +181,19 @@ private:
     /// Syncs the scissor test state to match the guest state
     void SyncScissorTest(OpenGLState& current_state);
 
-    /// Syncs the transform feedback state to match the guest state
+    /// Syncs the varyings captured by assembly programs to match the guest state
     void SyncTransformFeedback();
 
+    /// Configures the transform feedback buffers written by the draw command. They are kept in the
+    /// buffer cache, so later draws read the captured varyings from the host GPU.
+    void SetupTransformFeedback();
+
+    /// Starts capturing the varyings of the next draw, if transform feedback is enabled
+    void BeginTransformFeedback();
+
+    /// Ends the capture started by BeginTransformFeedback
+    void EndTransformFeedback();
+
     /// Syncs the point state to match the guest state
     void SyncPointState();
 
@@ -180,6 +209,12 @@ private:
     /// Syncs the alpha test state to match the guest state
     void SyncAlphaTest();
 
+    /// Starts the host conditional rendering of the next draw or clear, if there's any
+    void BeginHostConditionalRendering();
+
+    /// Ends the host conditional rendering started by BeginHostConditionalRendering
+    void EndHostConditionalRendering();
+
     /// Check for extension that are not strictly required
     /// but are needed for correct emulation
     void CheckExtensions();
@@ -203,15 +238,45 @@ private:
 
     static constexpr std::size_t STREAM_BUFFER_SIZE = 128 * 1024 * 1024;
     OGLBufferCache buffer_cache;
+    FenceManagerOpenGL fence_manager;
+    QueryCache query_cache;
+
+    /// Counter evaluating the render condition of draws and clears on the host GPU
+    std::shared_ptr<HostCounter> conditional_counter;
 
     VertexArrayPushBuffer vertex_array_pushbuffer;
     BindBuffersRangePushBuffer bind_ubo_pushbuffer{GL_UNIFORM_BUFFER};
     BindBuffersRangePushBuffer bind_ssbo_pushbuffer{GL_SHADER_STORAGE_BUFFER};
+    BindBuffersRangePushBuffer bind_tfb_pushbuffer{GL_TRANSFORM_FEEDBACK_BUFFER};
+
+    /// Parameter buffers of each graphics stage, assembly shaders read their constant buffers
+    /// from them instead of uniform buffers
+    std::array<BindBuffersRangePushBuffer, Maxwell::MaxShaderStage> bind_parameter_pushbuffers{
+        BindBuffersRangePushBuffer{GL_VERTEX_PROGRAM_PARAMETER_BUFFER_NV},
+        BindBuffersRangePushBuffer{GL_TESS_CONTROL_PROGRAM_PARAMETER_BUFFER_NV},
+        BindBuffersRangePushBuffer{GL_TESS_EVALUATION_PROGRAM_PARAMETER_BUFFER_NV},
+        BindBuffersRangePushBuffer{GL_GEOMETRY_PROGRAM_PARAMETER_BUFFER_NV},
+        BindBuffersRangePushBuffer{GL_FRAGMENT_PROGRAM_PARAMETER_BUFFER_NV},
+    };
+
+    std::vector<VideoCommon::MemoryRange> global_ranges;
+    std::vector<OGLBufferCache::BufferInfo> global_buffers;
+
+    /// Geometry shaders were enabled when viewports and scissors were last synced
+    bool viewports_use_geometry = false;
+
+    /// Primitive the captured vertices are assembled to, zero when the draw captures nothing
+    GLenum transform_feedback_primitive = 0;
+
+    /// State groups synced from guest registers in the current frame
+    u64 num_synced_groups = 0;
 
     std::size_t CalculateVertexArraysSize() const;
 
     std::size_t CalculateIndexBufferSize() const;
 
+    std::size_t CalculateIndirectBufferSize() const;
+
     /// Updates and returns a vertex array object representing current vertex format
     GLuint SetupVertexFormat();
 
@@ -222,10 +287,18 @@ private:
 
     GLintptr index_buffer_offset;
 
-    void SetupShaders(GLenum primitive_mode);
+    /// Uploads the commands of the current multi draw batch.
+    void SetupIndirectDraws();
+
+    const GLuint* indirect_buffer = nullptr;
+    GLintptr indirect_buffer_offset = 0;
+
+    /// Returns false when a shader stage is still being built in the background.
+    bool SetupShaders(GLenum primitive_mode);
 
     enum class AccelDraw { Disabled, Arrays, Indexed };
     AccelDraw accelerate_draw = AccelDraw::Disabled;
+    bool accelerate_multi_draw = false;
 };
 
 } // namespace OpenGL
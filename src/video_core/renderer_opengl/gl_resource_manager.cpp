@@ -69,6 +69,23 @@ void OGLSampler::Release() {
     handle = 0;
 }
 
+void OGLQuery::Create(GLenum target) {
+    if (handle != 0)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceCreation);
+    glCreateQueries(target, 1, &handle);
+}
+
+void OGLQuery::Release() {
+    if (handle == 0)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceDeletion);
+    glDeleteQueries(1, &handle);
+    handle = 0;
+}
+
 void OGLShader::Create(const char* source, GLenum type) {
     if (handle != 0)
         return;
@@ -113,6 +130,24 @@ void OGLProgram::Release() {
     handle = 0;
 }
 
+void OGLAssemblyProgram::Create(std::string_view source, GLenum target) {
+    if (handle != 0)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceCreation);
+    handle = GLShader::LoadAssemblyProgram(source, target);
+}
+
+void OGLAssemblyProgram::Release() {
+    if (handle == 0)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceDeletion);
+    glDeleteProgramsARB(1, &handle);
+    OpenGLState::GetCurState().ResetAssemblyProgram(handle).Apply();
+    handle = 0;
+}
+
 void OGLPipeline::Create() {
     if (handle != 0)
         return;
@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -12,31 +15,38 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/frontend/emu_window.h"
+#include "core/settings.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
 #include "video_core/memory_manager.h"
+#include "video_core/renderer_opengl/gl_arb_decompiler.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/gl_shader_cache.h"
 #include "video_core/renderer_opengl/gl_shader_decompiler.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#include "video_core/renderer_opengl/gl_shader_worker.h"
 #include "video_core/renderer_opengl/utils.h"
+#include "video_core/shader/memory_util.h"
 #include "video_core/shader/shader_ir.h"
 
 namespace OpenGL {
 
 using Tegra::Engines::ShaderType;
 using VideoCommon::Shader::ConstBufferLocker;
+using VideoCommon::Shader::GetShaderCode;
+using VideoCommon::Shader::GetUniqueIdentifier;
+using VideoCommon::Shader::KERNEL_MAIN_OFFSET;
 using VideoCommon::Shader::ProgramCode;
 using VideoCommon::Shader::ShaderIR;
+using VideoCommon::Shader::STAGE_MAIN_OFFSET;
 
 namespace {
 
-constexpr u32 STAGE_MAIN_OFFSET = 10;
-constexpr u32 KERNEL_MAIN_OFFSET = 0;
-
 constexpr VideoCommon::Shader::CompilerSettings COMPILER_SETTINGS{};
 
 /// Gets the address for the specified shader stage program
@@ -46,52 +56,6 @@ GPUVAddr GetShaderAddress(Core::System& system, Maxwell::ShaderProgram program)
     return gpu.regs.code_address.CodeAddress() + shader_config.offset;
 }
 
-/// Gets if the current instruction offset is a scheduler instruction
-constexpr bool IsSchedInstruction(std::size_t offset, std::size_t main_offset) {
-    // Sched instructions appear once every 4 instructions.
-    constexpr std::size_t SchedPeriod = 4;
-    const std::size_t absolute_offset = offset - main_offset;
-    return (absolute_offset % SchedPeriod) == 0;
-}
-
-/// Calculates the size of a program stream
-std::size_t CalculateProgramSize(const GLShader::ProgramCode& program) {
-    constexpr std::size_t start_offset = 10;
-    // This is the encoded version of BRA that jumps to itself. All Nvidia
-    // shaders end with one.
-    constexpr u64 self_jumping_branch = 0xE2400FFFFF07000FULL;
-    constexpr u64 mask = 0xFFFFFFFFFF7FFFFFULL;
-    std::size_t offset = start_offset;
-    while (offset < program.size()) {
-        const u64 instruction = program[offset];
-        if (!IsSchedInstruction(offset, start_offset)) {
-            if ((instruction & mask) == self_jumping_branch) {
-                // End on Maxwell's "nop" instruction
-                break;
-            }
-            if (instruction == 0) {
-                break;
-            }
-        }
-        offset++;
-    }
-    // The last instruction is included in the program size
-    return std::min(offset + 1, program.size());
-}
-
-/// Gets the shader program code from memory for the specified address
-ProgramCode GetShaderCode(Tegra::MemoryManager& memory_manager, const GPUVAddr gpu_addr,
-                          const u8* host_ptr) {
-    ProgramCode code(VideoCommon::Shader::MAX_PROGRAM_LENGTH);
-    ASSERT_OR_EXECUTE(host_ptr != nullptr, {
-        std::fill(code.begin(), code.end(), 0);
-        return code;
-    });
-    memory_manager.ReadBlockUnsafe(gpu_addr, code.data(), code.size() * sizeof(u64));
-    code.resize(CalculateProgramSize(code));
-    return code;
-}
-
 /// Gets the shader type from a Maxwell program type
 constexpr GLenum GetGLShaderType(ShaderType shader_type) {
     switch (shader_type) {
@@ -108,6 +72,20 @@ constexpr GLenum GetGLShaderType(ShaderType shader_type) {
     }
 }
 
+/// Gets the assembly program target from a Maxwell program type
+constexpr GLenum GetAssemblyProgramTarget(ShaderType shader_type) {
+    switch (shader_type) {
+    case ShaderType::Vertex:
+        return GL_VERTEX_PROGRAM_NV;
+    case ShaderType::Geometry:
+        return GL_GEOMETRY_PROGRAM_NV;
+    case ShaderType::Fragment:
+        return GL_FRAGMENT_PROGRAM_NV;
+    default:
+        return GL_NONE;
+    }
+}
+
 /// Describes primitive behavior on geometry shaders
 constexpr std::pair<const char*, u32> GetPrimitiveDescription(GLenum primitive_mode) {
     switch (primitive_mode) {
@@ -131,25 +109,63 @@ constexpr std::pair<const char*, u32> GetPrimitiveDescription(GLenum primitive_m
     }
 }
 
-/// Hashes one (or two) program streams
-u64 GetUniqueIdentifier(ShaderType shader_type, bool is_a, const ProgramCode& code,
-                        const ProgramCode& code_b) {
-    u64 unique_identifier = boost::hash_value(code);
-    if (is_a) {
-        // VertexA programs include two programs
-        boost::hash_combine(unique_identifier, boost::hash_value(code_b));
+/// Removes from a variant the state that doesn't change the program built for the given stage, so
+/// draws that only differ in it share the same program
+ProgramVariant NormalizeVariant(ShaderType shader_type, ProgramVariant variant) {
+    switch (shader_type) {
+    case ShaderType::Compute:
+        return variant;
+    case ShaderType::Geometry:
+        // Only the input layout of geometry shaders depends on the primitive mode
+        switch (variant.primitive_mode) {
+        case GL_LINES:
+        case GL_LINE_STRIP:
+            variant.primitive_mode = GL_LINES;
+            break;
+        case GL_LINES_ADJACENCY:
+        case GL_LINE_STRIP_ADJACENCY:
+            variant.primitive_mode = GL_LINES_ADJACENCY;
+            break;
+        case GL_TRIANGLES:
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:
+            variant.primitive_mode = GL_TRIANGLES;
+            break;
+        case GL_TRIANGLES_ADJACENCY:
+        case GL_TRIANGLE_STRIP_ADJACENCY:
+            variant.primitive_mode = GL_TRIANGLES_ADJACENCY;
+            break;
+        default:
+            variant.primitive_mode = GL_POINTS;
+            break;
+        }
+        return variant;
+    case ShaderType::Vertex:
+        // The last vertex processing stage declares the varyings transform feedback captures
+        variant.primitive_mode = 0;
+        return variant;
+    default:
+        variant.primitive_mode = 0;
+        variant.transform_feedback = {};
+        return variant;
     }
+}
+
+/// Key of the shared variants of a shader, the same code can be bound to different stages
+u64 GetVariantsKey(u64 unique_identifier, ShaderType shader_type) {
+    boost::hash_combine(unique_identifier, static_cast<u32>(shader_type));
     return unique_identifier;
 }
 
 /// Creates an unspecialized program from code streams
 std::string GenerateGLSL(const Device& device, ShaderType shader_type, const ShaderIR& ir,
-                         const std::optional<ShaderIR>& ir_b) {
+                         const std::optional<ShaderIR>& ir_b, const ProgramVariant& variant) {
     switch (shader_type) {
     case ShaderType::Vertex:
-        return GLShader::GenerateVertexShader(device, ir, ir_b ? &*ir_b : nullptr);
+        return GLShader::GenerateVertexShader(device, ir, ir_b ? &*ir_b : nullptr,
+                                              variant.transform_feedback);
     case ShaderType::Geometry:
-        return GLShader::GenerateGeometryShader(device, ir);
+        return GLShader::GenerateGeometryShader(device, ir, variant.transform_feedback);
     case ShaderType::Fragment:
         return GLShader::GenerateFragmentShader(device, ir);
     case ShaderType::Compute:
@@ -228,10 +244,9 @@ void FillLocker(ConstBufferLocker& locker, const ShaderDiskCacheUsage& usage) {
     }
 }
 
-CachedProgram BuildShader(const Device& device, u64 unique_identifier, ShaderType shader_type,
-                          const ProgramCode& code, const ProgramCode& code_b,
-                          ConstBufferLocker& locker, const ProgramVariant& variant,
-                          bool hint_retrievable = false) {
+std::string MakeShaderSource(const Device& device, u64 unique_identifier, ShaderType shader_type,
+                             const ProgramCode& code, const ProgramCode& code_b,
+                             ConstBufferLocker& locker, const ProgramVariant& variant) {
     LOG_INFO(Render_OpenGL, "called. {}", GetShaderId(unique_identifier, shader_type));
 
     const bool is_compute = shader_type == ShaderType::Compute;
@@ -261,6 +276,9 @@ CachedProgram BuildShader(const Device& device, u64 unique_identifier, ShaderTyp
                   "#extension GL_NV_shader_thread_group : require\n"
                   "#extension GL_NV_shader_thread_shuffle : require\n";
     }
+    if (variant.transform_feedback.IsEnabled()) {
+        source += "#extension GL_ARB_enhanced_layouts : require\n";
+    }
     // This pragma stops Nvidia's driver from over optimizing math (probably using fp16 operations)
     // on places where we don't want to.
     // Thanks to Ryujinx for finding this workaround.
@@ -287,8 +305,12 @@ CachedProgram BuildShader(const Device& device, u64 unique_identifier, ShaderTyp
     }
 
     source += '\n';
-    source += GenerateGLSL(device, shader_type, ir, ir_b);
+    source += GenerateGLSL(device, shader_type, ir, ir_b, variant);
+    return source;
+}
 
+CachedProgram LinkShader(const std::string& source, ShaderType shader_type,
+                         bool hint_retrievable) {
     OGLShader shader;
     shader.Create(source.c_str(), GetGLShaderType(shader_type));
 
@@ -297,6 +319,35 @@ CachedProgram BuildShader(const Device& device, u64 unique_identifier, ShaderTyp
     return program;
 }
 
+CachedProgram BuildShader(const Device& device, u64 unique_identifier, ShaderType shader_type,
+                          const ProgramCode& code, const ProgramCode& code_b,
+                          ConstBufferLocker& locker, const ProgramVariant& variant,
+                          bool hint_retrievable = false) {
+    return LinkShader(
+        MakeShaderSource(device, unique_identifier, shader_type, code, code_b, locker, variant),
+        shader_type, hint_retrievable);
+}
+
+CachedAssemblyProgram BuildAssemblyProgram(const Device& device, u64 unique_identifier,
+                                           ShaderType shader_type, const ProgramCode& code,
+                                           const ProgramCode& code_b, ConstBufferLocker& locker,
+                                           const ProgramVariant& variant) {
+    const std::string shader_id = GetShaderId(unique_identifier, shader_type);
+    LOG_INFO(Render_OpenGL, "called. {}", shader_id);
+
+    const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, locker);
+    std::optional<ShaderIR> ir_b;
+    if (!code_b.empty()) {
+        ir_b.emplace(code_b, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, locker);
+    }
+
+    const std::string source = DecompileAssemblyShader(device, ir, ir_b ? &*ir_b : nullptr,
+                                                       shader_type, shader_id, variant);
+    auto program = std::make_shared<OGLAssemblyProgram>();
+    program->Create(source, GetAssemblyProgramTarget(shader_type));
+    return program;
+}
+
 std::unordered_set<GLenum> GetSupportedFormats() {
     GLint num_formats{};
     glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
@@ -314,14 +365,17 @@ std::unordered_set<GLenum> GetSupportedFormats() {
 } // Anonymous namespace
 
 CachedShader::CachedShader(const ShaderParameters& params, ShaderType shader_type,
-                           GLShader::ShaderEntries entries, ProgramCode code, ProgramCode code_b)
+                           std::shared_ptr<ShaderVariants> variants)
     : RasterizerCacheObject{params.host_ptr}, system{params.system},
-      disk_cache{params.disk_cache}, device{params.device}, cpu_addr{params.cpu_addr},
+      disk_cache{params.disk_cache}, device{params.device},
+      shader_worker{params.shader_worker}, cpu_addr{params.cpu_addr},
       unique_identifier{params.unique_identifier}, shader_type{shader_type},
-      entries{std::move(entries)}, code{std::move(code)}, code_b{std::move(code_b)} {
+      variants{std::move(variants)} {
     if (!params.precompiled_variants) {
         return;
     }
+    // Variants already shared with another copy are skipped by the key comparison below
+    auto& locker_variants = this->variants->locker_variants;
     for (const auto& pair : *params.precompiled_variants) {
         auto locker = MakeLocker(system, shader_type);
         const auto& usage = pair->first;
@@ -339,7 +393,8 @@ CachedShader::CachedShader(const ShaderParameters& params, ShaderType shader_typ
         } else {
             locker_variant = &*it;
         }
-        locker_variant->get()->programs.emplace(usage.variant, pair->second);
+        locker_variant->get()->programs.emplace(NormalizeVariant(shader_type, usage.variant),
+                                                pair->second);
     }
 }
 
@@ -350,66 +405,143 @@ Shader CachedShader::CreateStageFromMemory(const ShaderParameters& params,
     params.disk_cache.SaveRaw(
         ShaderDiskCacheRaw(params.unique_identifier, shader_type, code, code_b));
 
-    ConstBufferLocker locker(shader_type, params.system.GPU().Maxwell3D());
-    const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, locker);
-    // TODO(Rodrigo): Handle VertexA shaders
-    // std::optional<ShaderIR> ir_b;
-    // if (!code_b.empty()) {
-    //     ir_b.emplace(code_b, STAGE_MAIN_OFFSET);
-    // }
-    return std::shared_ptr<CachedShader>(new CachedShader(
-        params, shader_type, GLShader::GetEntries(ir), std::move(code), std::move(code_b)));
+    auto variants = std::make_shared<ShaderVariants>();
+    {
+        ConstBufferLocker locker(shader_type, params.system.GPU().Maxwell3D());
+        const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, locker);
+        // TODO(Rodrigo): Handle VertexA shaders
+        // std::optional<ShaderIR> ir_b;
+        // if (!code_b.empty()) {
+        //     ir_b.emplace(code_b, STAGE_MAIN_OFFSET);
+        // }
+        variants->entries = GLShader::GetEntries(ir);
+    }
+    variants->code = std::move(code);
+    variants->code_b = std::move(code_b);
+    return std::shared_ptr<CachedShader>(
+        new CachedShader(params, shader_type, std::move(variants)));
 }
 
 Shader CachedShader::CreateKernelFromMemory(const ShaderParameters& params, ProgramCode code) {
     params.disk_cache.SaveRaw(
         ShaderDiskCacheRaw(params.unique_identifier, ShaderType::Compute, code));
 
-    ConstBufferLocker locker(Tegra::Engines::ShaderType::Compute,
-                             params.system.GPU().KeplerCompute());
-    const ShaderIR ir(code, KERNEL_MAIN_OFFSET, COMPILER_SETTINGS, locker);
-    return std::shared_ptr<CachedShader>(new CachedShader(
-        params, ShaderType::Compute, GLShader::GetEntries(ir), std::move(code), {}));
+    auto variants = std::make_shared<ShaderVariants>();
+    {
+        ConstBufferLocker locker(Tegra::Engines::ShaderType::Compute,
+                                 params.system.GPU().KeplerCompute());
+        const ShaderIR ir(code, KERNEL_MAIN_OFFSET, COMPILER_SETTINGS, locker);
+        variants->entries = GLShader::GetEntries(ir);
+    }
+    variants->code = std::move(code);
+    return std::shared_ptr<CachedShader>(
+        new CachedShader(params, ShaderType::Compute, std::move(variants)));
 }
 
 Shader CachedShader::CreateFromCache(const ShaderParameters& params,
                                      const UnspecializedShader& unspecialized) {
-    return std::shared_ptr<CachedShader>(new CachedShader(params, unspecialized.type,
-                                                          unspecialized.entries, unspecialized.code,
-                                                          unspecialized.code_b));
+    auto variants = std::make_shared<ShaderVariants>();
+    variants->entries = unspecialized.entries;
+    variants->code = unspecialized.code;
+    variants->code_b = unspecialized.code_b;
+    return std::shared_ptr<CachedShader>(
+        new CachedShader(params, unspecialized.type, std::move(variants)));
 }
 
-GLuint CachedShader::GetHandle(const ProgramVariant& variant) {
+Shader CachedShader::CreateFromVariants(const ShaderParameters& params, ShaderType shader_type,
+                                        std::shared_ptr<ShaderVariants> variants) {
+    return std::shared_ptr<CachedShader>(
+        new CachedShader(params, shader_type, std::move(variants)));
+}
+
+GLuint CachedShader::GetHandle(const ProgramVariant& raw_variant) {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
     EnsureValidLockerVariant();
 
-    const auto [entry, is_cache_miss] = curr_locker_variant->programs.try_emplace(variant);
-    auto& program = entry->second;
-    if (!is_cache_miss) {
-        return program->handle;
+    ProgramVariant variant = NormalizeVariant(shader_type, raw_variant);
+    if (device.UseAssemblyShaders() && shader_type != ShaderType::Compute) {
+        // Assembly programs are captured through context state, the program doesn't change
+        variant.transform_feedback = {};
+        return GetAssemblyHandle(variant);
+    }
+
+    auto& programs = curr_locker_variant->programs;
+    if (const auto it = programs.find(variant); it != programs.end()) {
+        return it->second->handle;
+    }
+
+    // Draws are skipped while their programs build, build the ones capturing varyings right
+    // away so their output isn't lost
+    if (shader_worker && shader_type != ShaderType::Compute &&
+        !variant.transform_feedback.IsEnabled()) {
+        return GetAsyncHandle(variant);
+    }
+
+    auto& locker = *curr_locker_variant->locker;
+    auto& program = programs[variant];
+    program = BuildShader(device, unique_identifier, shader_type, variants->code, variants->code_b,
+                          locker, variant);
+    disk_cache.SaveUsage(GetUsage(variant, locker));
+
+    LabelGLObject(GL_PROGRAM, program->handle, cpu_addr);
+    return program->handle;
+}
+
+GLuint CachedShader::GetAsyncHandle(const ProgramVariant& variant) {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
+    auto& locker = *curr_locker_variant->locker;
+    const auto [entry, is_new] = curr_locker_variant->builds.try_emplace(variant);
+    auto& build = entry->second;
+    if (is_new) {
+        // Decompile here, the locker reads the engine state as it is at this draw
+        build = shader_worker->QueueBuild(
+            MakeShaderSource(device, unique_identifier, shader_type, variants->code,
+                             variants->code_b, locker, variant),
+            GetGLShaderType(shader_type));
+        disk_cache.SaveUsage(GetUsage(variant, locker));
+        return 0;
+    }
+    if (!build->IsReady()) {
+        return 0;
     }
 
-    program = BuildShader(device, unique_identifier, shader_type, code, code_b,
-                          *curr_locker_variant->locker, variant);
-    disk_cache.SaveUsage(GetUsage(variant, *curr_locker_variant->locker));
+    auto& program = curr_locker_variant->programs[variant];
+    program = build->TakeProgram();
+    curr_locker_variant->builds.erase(entry);
 
     LabelGLObject(GL_PROGRAM, program->handle, cpu_addr);
     return program->handle;
 }
 
+GLuint CachedShader::GetAssemblyHandle(const ProgramVariant& variant) {
+    auto& assembly_programs = curr_locker_variant->assembly_programs;
+    if (const auto it = assembly_programs.find(variant); it != assembly_programs.end()) {
+        return it->second->handle;
+    }
+
+    // Assembly programs build fast enough to not need the background worker
+    auto& locker = *curr_locker_variant->locker;
+    auto& program = assembly_programs[variant];
+    program = BuildAssemblyProgram(device, unique_identifier, shader_type, variants->code,
+                                   variants->code_b, locker, variant);
+    disk_cache.SaveUsage(GetUsage(variant, locker));
+    return program->handle;
+}
+
 bool CachedShader::EnsureValidLockerVariant() {
     const auto previous_variant = curr_locker_variant;
     if (curr_locker_variant && !curr_locker_variant->locker->IsConsistent()) {
         curr_locker_variant = nullptr;
     }
     if (!curr_locker_variant) {
-        for (auto& variant : locker_variants) {
+        for (auto& variant : variants->locker_variants) {
             if (variant->locker->IsConsistent()) {
                 curr_locker_variant = variant.get();
             }
         }
     }
     if (!curr_locker_variant) {
-        auto& new_variant = locker_variants.emplace_back();
+        auto& new_variant = variants->locker_variants.emplace_back();
         new_variant = std::make_unique<LockerVariant>();
         new_variant->locker = MakeLocker(system, shader_type);
         curr_locker_variant = new_variant.get();
@@ -427,7 +559,14 @@ ShaderDiskCacheUsage CachedShader::GetUsage(const ProgramVariant& variant,
 ShaderCacheOpenGL::ShaderCacheOpenGL(RasterizerOpenGL& rasterizer, Core::System& system,
                                      Core::Frontend::EmuWindow& emu_window, const Device& device)
     : RasterizerCache{rasterizer}, system{system}, emu_window{emu_window}, device{device},
-      disk_cache{system} {}
+      disk_cache{system} {
+    if (Settings::values.use_asynchronous_shaders) {
+        shader_worker = std::make_unique<ShaderWorker>(
+            emu_window, std::max<std::size_t>(Common::GetDefaultNumWorkers() / 2, 1));
+    }
+}
+
+ShaderCacheOpenGL::~ShaderCacheOpenGL() = default;
 
 void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
                                       const VideoCore::DiskResourceLoadCallback& callback) {
@@ -435,16 +574,25 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
     if (!transferable) {
         return;
     }
-    const auto [raws, shader_usages] = *transferable;
+    auto [raws, shader_usages] = *transferable;
     if (!GenerateUnspecializedShaders(stop_loading, callback, raws) || stop_loading) {
         return;
     }
+    if (device.UseAssemblyShaders()) {
+        // Graphics stages are built as assembly programs on demand, they have no GLSL programs
+        // to precompile
+        const auto is_graphics = [this](const ShaderDiskCacheUsage& usage) {
+            return unspecialized_shaders.at(usage.unique_identifier).type != ShaderType::Compute;
+        };
+        shader_usages.erase(std::remove_if(shader_usages.begin(), shader_usages.end(), is_graphics),
+                            shader_usages.end());
+    }
 
     const auto dumps = disk_cache.LoadPrecompiled();
     const auto supported_formats = GetSupportedFormats();
 
     // Track if precompiled cache was altered during loading to know if we have to
-    // serialize the virtual precompiled cache file back to the hard drive
+    // rewrite the precompiled cache file on the hard drive
     bool precompiled_cache_altered = false;
 
     // Inform the frontend about shader build initialization
@@ -452,17 +600,52 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
         callback(VideoCore::LoadCallbackStage::Build, 0, shader_usages.size());
     }
 
+    // GLSL is generated on the shared worker pool while the programs are linked on the shared
+    // contexts below, each usage becomes available to the linkers as soon as its source is ready
+    std::vector<std::string> sources(shader_usages.size());
+    std::vector<u8> is_source_ready(shader_usages.size()); // Guarded by the mutex
+    std::condition_variable source_ready;
+    Common::TaskGroup source_group;
+
     std::mutex mutex;
+    for (std::size_t i = 0; i < shader_usages.size(); ++i) {
+        const auto& usage{shader_usages[i]};
+        if (dumps.find(usage) != dumps.end()) {
+            is_source_ready[i] = 1;
+            continue;
+        }
+        Common::GetSharedWorker().QueueWork(source_group, [&, i] {
+            if (!stop_loading) {
+                const auto& usage{shader_usages[i]};
+                const auto& unspecialized{unspecialized_shaders.at(usage.unique_identifier)};
+                auto locker{MakeLocker(system, unspecialized.type)};
+                FillLocker(*locker, usage);
+                sources[i] = MakeShaderSource(device, usage.unique_identifier, unspecialized.type,
+                                              unspecialized.code, unspecialized.code_b, *locker,
+                                              usage.variant);
+            }
+            {
+                std::scoped_lock lock{mutex};
+                is_source_ready[i] = 1;
+            }
+            source_ready.notify_all();
+        });
+    }
+
     std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
+    std::atomic_size_t next_usage = 0;
     std::atomic_bool compilation_failed = false;
 
-    const auto Worker = [&](Core::Frontend::GraphicsContext* context, std::size_t begin,
-                            std::size_t end, const std::vector<ShaderDiskCacheUsage>& shader_usages,
-                            const ShaderDumpsMap& dumps) {
+    const auto Worker = [&](Core::Frontend::GraphicsContext* context) {
         context->MakeCurrent();
         SCOPE_EXIT({ return context->DoneCurrent(); });
 
-        for (std::size_t i = begin; i < end; ++i) {
+        if (device.HasParallelShaderCompile()) {
+            // Let the driver spread the work further on its own threads
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
+
+        for (std::size_t i = next_usage++; i < shader_usages.size(); i = next_usage++) {
             if (stop_loading || compilation_failed) {
                 return;
             }
@@ -478,14 +661,16 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
                     compilation_failed = true;
                     return;
                 }
-            }
-            if (!shader) {
-                auto locker{MakeLocker(system, unspecialized.type)};
-                FillLocker(*locker, usage);
-
-                shader = BuildShader(device, usage.unique_identifier, unspecialized.type,
-                                     unspecialized.code, unspecialized.code_b, *locker,
-                                     usage.variant, true);
+            } else {
+                {
+                    std::unique_lock lock{mutex};
+                    source_ready.wait(lock, [&] { return is_source_ready[i] != 0; });
+                }
+                if (stop_loading) {
+                    return;
+                }
+                shader = LinkShader(sources[i], unspecialized.type, true);
+                std::string{}.swap(sources[i]);
             }
 
             std::scoped_lock lock{mutex};
@@ -502,22 +687,19 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
-    const auto num_workers{static_cast<std::size_t>(std::thread::hardware_concurrency() + 1ULL)};
-    const std::size_t bucket_size{shader_usages.size() / num_workers};
+    const std::size_t num_workers{std::min(Common::GetDefaultNumWorkers(), shader_usages.size())};
     std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts(num_workers);
     std::vector<std::thread> threads(num_workers);
     for (std::size_t i = 0; i < num_workers; ++i) {
-        const bool is_last_worker = i + 1 == num_workers;
-        const std::size_t start{bucket_size * i};
-        const std::size_t end{is_last_worker ? shader_usages.size() : start + bucket_size};
-
         // On some platforms the shared context has to be created from the GUI thread
         contexts[i] = emu_window.CreateSharedContext();
-        threads[i] = std::thread(Worker, contexts[i].get(), start, end, shader_usages, dumps);
+        threads[i] = std::thread(Worker, contexts[i].get());
     }
     for (auto& thread : threads) {
         thread.join();
     }
+    // Drain the pending GLSL jobs before the state they reference goes out of scope
+    source_group.Wait();
 
     if (compilation_failed) {
         // Invalidate the precompiled cache if a shader dumped shader was rejected
@@ -542,7 +724,7 @@ void ShaderCacheOpenGL::LoadDiskCache(const std::atomic_bool& stop_loading,
     }
 
     if (precompiled_cache_altered) {
-        disk_cache.SaveVirtualPrecompiledFile();
+        disk_cache.SavePrecompiledFile();
     }
 }
 
@@ -557,12 +739,17 @@ CachedProgram ShaderCacheOpenGL::GeneratePrecompiledProgram(
         LOG_INFO(Render_OpenGL, "Precompiled cache entry with unsupported format - removing");
         return {};
     }
+    const auto binary = disk_cache.LoadDumpBinary(dump);
+    if (!binary) {
+        LOG_INFO(Render_OpenGL, "Precompiled cache entry could not be read - removing");
+        return {};
+    }
 
     CachedProgram shader = std::make_shared<OGLProgram>();
     shader->handle = glCreateProgram();
     glProgramParameteri(shader->handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
-    glProgramBinary(shader->handle, dump.binary_format, dump.binary.data(),
-                    static_cast<GLsizei>(dump.binary.size()));
+    glProgramBinary(shader->handle, dump.binary_format, binary->data(),
+                    static_cast<GLsizei>(binary->size()));
 
     GLint link_status{};
     glGetProgramiv(shader->handle, GL_LINK_STATUS, &link_status);
@@ -581,14 +768,9 @@ bool ShaderCacheOpenGL::GenerateUnspecializedShaders(
         callback(VideoCore::LoadCallbackStage::Decompile, 0, raws.size());
     }
 
-    for (std::size_t i = 0; i < raws.size(); ++i) {
-        if (stop_loading) {
-            return false;
-        }
-        const auto& raw{raws[i]};
+    for (const auto& raw : raws) {
         const u64 unique_identifier{raw.GetUniqueIdentifier()};
-        const u64 calculated_hash{
-            GetUniqueIdentifier(raw.GetType(), raw.HasProgramA(), raw.GetCode(), raw.GetCodeB())};
+        const u64 calculated_hash{GetUniqueIdentifier(raw.GetCode(), raw.GetCodeB())};
         if (unique_identifier != calculated_hash) {
             LOG_ERROR(Render_OpenGL,
                       "Invalid hash in entry={:016x} (obtained hash={:016x}) - "
@@ -597,32 +779,45 @@ bool ShaderCacheOpenGL::GenerateUnspecializedShaders(
             disk_cache.InvalidateTransferable();
             return false;
         }
+    }
 
-        const u32 main_offset =
-            raw.GetType() == ShaderType::Compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
-        ConstBufferLocker locker(raw.GetType());
-        const ShaderIR ir(raw.GetCode(), main_offset, COMPILER_SETTINGS, locker);
-        // TODO(Rodrigo): Handle VertexA shaders
-        // std::optional<ShaderIR> ir_b;
-        // if (raw.HasProgramA()) {
-        //     ir_b.emplace(raw.GetProgramCodeB(), main_offset);
-        // }
-
-        UnspecializedShader unspecialized;
-        unspecialized.entries = GLShader::GetEntries(ir);
-        unspecialized.type = raw.GetType();
-        unspecialized.code = raw.GetCode();
-        unspecialized.code_b = raw.GetCodeB();
-        unspecialized_shaders.emplace(raw.GetUniqueIdentifier(), unspecialized);
+    std::mutex mutex;
+    std::size_t num_decompiled = 0; // Guarded by the mutex
+    Common::TaskGroup group;
+    for (const auto& raw : raws) {
+        Common::GetSharedWorker().QueueWork(group, [&] {
+            if (stop_loading) {
+                return;
+            }
+            const u32 main_offset =
+                raw.GetType() == ShaderType::Compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+            ConstBufferLocker locker(raw.GetType());
+            const ShaderIR ir(raw.GetCode(), main_offset, COMPILER_SETTINGS, locker);
+            // TODO(Rodrigo): Handle VertexA shaders
+            // std::optional<ShaderIR> ir_b;
+            // if (raw.HasProgramA()) {
+            //     ir_b.emplace(raw.GetProgramCodeB(), main_offset);
+            // }
+
+            UnspecializedShader unspecialized;
+            unspecialized.entries = GLShader::GetEntries(ir);
+            unspecialized.type = raw.GetType();
+            unspecialized.code = raw.GetCode();
+            unspecialized.code_b = raw.GetCodeB();
 
-        if (callback) {
-            callback(VideoCore::LoadCallbackStage::Decompile, i, raws.size());
-        }
+            std::scoped_lock lock{mutex};
+            unspecialized_shaders.emplace(raw.GetUniqueIdentifier(), std::move(unspecialized));
+            if (callback) {
+                callback(VideoCore::LoadCallbackStage::Decompile, ++num_decompiled, raws.size());
+            }
+        });
     }
-    return true;
+    group.Wait();
+    return !stop_loading;
 }
 
 Shader ShaderCacheOpenGL::GetStageProgram(Maxwell::ShaderProgram program) {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
     if (!system.GPU().Maxwell3D().dirty.shaders) {
         return last_shaders[static_cast<std::size_t>(program)];
     }
@@ -638,26 +833,33 @@ Shader ShaderCacheOpenGL::GetStageProgram(Maxwell::ShaderProgram program) {
     }
 
     // No shader found - create a new one
-    ProgramCode code{GetShaderCode(memory_manager, address, host_ptr)};
+    ProgramCode code{GetShaderCode(memory_manager, address, host_ptr, false)};
     ProgramCode code_b;
     if (program == Maxwell::ShaderProgram::VertexA) {
         const GPUVAddr address_b{GetShaderAddress(system, Maxwell::ShaderProgram::VertexB)};
-        code_b = GetShaderCode(memory_manager, address_b, memory_manager.GetPointer(address_b));
+        code_b = GetShaderCode(memory_manager, address_b, memory_manager.GetPointer(address_b),
+                               false);
     }
 
-    const auto unique_identifier = GetUniqueIdentifier(
-        GetShaderType(program), program == Maxwell::ShaderProgram::VertexA, code, code_b);
+    const auto unique_identifier = GetUniqueIdentifier(code, code_b);
     const auto precompiled_variants = GetPrecompiledVariants(unique_identifier);
     const auto cpu_addr{*memory_manager.GpuToCpuAddress(address)};
     const ShaderParameters params{system,   disk_cache, precompiled_variants, device,
-                                  cpu_addr, host_ptr,   unique_identifier};
+                                  cpu_addr, host_ptr,   unique_identifier,    shader_worker.get()};
 
-    const auto found = unspecialized_shaders.find(unique_identifier);
-    if (found == unspecialized_shaders.end()) {
-        shader = CachedShader::CreateStageFromMemory(params, program, std::move(code),
-                                                     std::move(code_b));
+    const auto shader_type = GetShaderType(program);
+    const u64 variants_key = GetVariantsKey(unique_identifier, shader_type);
+    if (auto variants = FindVariants(variants_key, code, code_b)) {
+        shader = CachedShader::CreateFromVariants(params, shader_type, std::move(variants));
     } else {
-        shader = CachedShader::CreateFromCache(params, found->second);
+        const auto found = unspecialized_shaders.find(unique_identifier);
+        if (found == unspecialized_shaders.end()) {
+            shader = CachedShader::CreateStageFromMemory(params, program, std::move(code),
+                                                         std::move(code_b));
+        } else {
+            shader = CachedShader::CreateFromCache(params, found->second);
+        }
+        shader_variants.insert_or_assign(variants_key, shader->GetVariants());
     }
     Register(shader);
 
@@ -665,6 +867,7 @@ Shader ShaderCacheOpenGL::GetStageProgram(Maxwell::ShaderProgram program) {
 }
 
 Shader ShaderCacheOpenGL::GetComputeKernel(GPUVAddr code_addr) {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
     auto& memory_manager{system.GPU().MemoryManager()};
     const auto host_ptr{memory_manager.GetPointer(code_addr)};
     auto kernel = TryGet(host_ptr);
@@ -673,22 +876,43 @@ Shader ShaderCacheOpenGL::GetComputeKernel(GPUVAddr code_addr) {
     }
 
     // No kernel found - create a new one
-    auto code{GetShaderCode(memory_manager, code_addr, host_ptr)};
-    const auto unique_identifier{GetUniqueIdentifier(ShaderType::Compute, false, code, {})};
+    auto code{GetShaderCode(memory_manager, code_addr, host_ptr, true)};
+    const auto unique_identifier{GetUniqueIdentifier(code)};
     const auto precompiled_variants = GetPrecompiledVariants(unique_identifier);
     const auto cpu_addr{*memory_manager.GpuToCpuAddress(code_addr)};
     const ShaderParameters params{system,   disk_cache, precompiled_variants, device,
-                                  cpu_addr, host_ptr,   unique_identifier};
+                                  cpu_addr, host_ptr,   unique_identifier,    shader_worker.get()};
 
-    const auto found = unspecialized_shaders.find(unique_identifier);
-    if (found == unspecialized_shaders.end()) {
-        kernel = CachedShader::CreateKernelFromMemory(params, std::move(code));
+    const u64 variants_key = GetVariantsKey(unique_identifier, ShaderType::Compute);
+    if (auto variants = FindVariants(variants_key, code, {})) {
+        kernel = CachedShader::CreateFromVariants(params, ShaderType::Compute, std::move(variants));
     } else {
-        kernel = CachedShader::CreateFromCache(params, found->second);
+        const auto found = unspecialized_shaders.find(unique_identifier);
+        if (found == unspecialized_shaders.end()) {
+            kernel = CachedShader::CreateKernelFromMemory(params, std::move(code));
+        } else {
+            kernel = CachedShader::CreateFromCache(params, found->second);
+        }
+        shader_variants.insert_or_assign(variants_key, kernel->GetVariants());
     }
 
     Register(kernel);
     return kernel;
 }
 
+std::shared_ptr<ShaderVariants> ShaderCacheOpenGL::FindVariants(u64 variants_key,
+                                                                const ProgramCode& code,
+                                                                const ProgramCode& code_b) const {
+    const auto it = shader_variants.find(variants_key);
+    if (it == shader_variants.end()) {
+        return nullptr;
+    }
+    // Compare the code to rule out hash collisions, it's cheap compared to decoding
+    const auto& variants = it->second;
+    if (variants->code != code || variants->code_b != code_b) {
+        return nullptr;
+    }
+    return variants;
+}
+
 } // namespace OpenGL
@@ -22,6 +22,7 @@
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_shader_decompiler.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#include "video_core/renderer_opengl/gl_shader_worker.h"
 #include "video_core/shader/const_buffer_locker.h"
 #include "video_core/shader/shader_ir.h"
 
@@ -38,10 +39,12 @@ namespace OpenGL {
 class CachedShader;
 class Device;
 class RasterizerOpenGL;
+struct ShaderVariants;
 struct UnspecializedShader;
 
 using Shader = std::shared_ptr<CachedShader>;
 using CachedProgram = std::shared_ptr<OGLProgram>;
+using CachedAssemblyProgram = std::shared_ptr<OGLAssemblyProgram>;
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 using PrecompiledPrograms = std::unordered_map<ShaderDiskCacheUsage, CachedProgram>;
 using PrecompiledVariants = std::vector<PrecompiledPrograms::iterator>;
@@ -53,6 +56,22 @@ struct UnspecializedShader {
     ProgramCode code_b;
 };
 
+struct LockerVariant {
+    std::unique_ptr<VideoCommon::Shader::ConstBufferLocker> locker;
+    std::unordered_map<ProgramVariant, CachedProgram> programs;
+    std::unordered_map<ProgramVariant, std::shared_ptr<ShaderWorker::Build>> builds;
+    std::unordered_map<ProgramVariant, CachedAssemblyProgram> assembly_programs;
+};
+
+/// Decoded code and built programs of a shader. Every cached copy of the same code shares one, so
+/// relocated or duplicated shaders are neither decoded nor built again.
+struct ShaderVariants {
+    GLShader::ShaderEntries entries;
+    ProgramCode code;
+    ProgramCode code_b;
+    std::vector<std::unique_ptr<LockerVariant>> locker_variants;
+};
+
 struct ShaderParameters {
     Core::System& system;
     ShaderDiskCacheOpenGL& disk_cache;
@@ -61,6 +80,7 @@ struct ShaderParameters {
     VAddr cpu_addr;
     u8* host_ptr;
     u64 unique_identifier;
+    ShaderWorker* shader_worker; ///< Builds programs in the background, null when disabled
 };
 
 class CachedShader final : public RasterizerCacheObject {
@@ -73,59 +93,67 @@ public:
     static Shader CreateFromCache(const ShaderParameters& params,
                                   const UnspecializedShader& unspecialized);
 
+    /// Creates a copy of a shader already in the cache, sharing its decoded code and programs
+    static Shader CreateFromVariants(const ShaderParameters& params,
+                                     Tegra::Engines::ShaderType shader_type,
+                                     std::shared_ptr<ShaderVariants> variants);
+
     VAddr GetCpuAddr() const override {
         return cpu_addr;
     }
 
     std::size_t GetSizeInBytes() const override {
-        return code.size() * sizeof(u64);
+        return variants->code.size() * sizeof(u64);
     }
 
     /// Gets the shader entries for the shader
     const GLShader::ShaderEntries& GetShaderEntries() const {
-        return entries;
+        return variants->entries;
+    }
+
+    /// Gets the decoded code and programs shared with other copies of this shader
+    const std::shared_ptr<ShaderVariants>& GetVariants() const {
+        return variants;
     }
 
-    /// Gets the GL program handle for the shader
+    /// Gets the GL program handle for the shader, or zero while it's being built in the background.
+    /// Graphics stages return an assembly program handle when the device uses assembly shaders.
     GLuint GetHandle(const ProgramVariant& variant);
 
 private:
-    struct LockerVariant {
-        std::unique_ptr<VideoCommon::Shader::ConstBufferLocker> locker;
-        std::unordered_map<ProgramVariant, CachedProgram> programs;
-    };
-
     explicit CachedShader(const ShaderParameters& params, Tegra::Engines::ShaderType shader_type,
-                          GLShader::ShaderEntries entries, ProgramCode program_code,
-                          ProgramCode program_code_b);
+                          std::shared_ptr<ShaderVariants> variants);
 
     bool EnsureValidLockerVariant();
 
+    /// Queues a build of the variant, or takes its program once the build is done.
+    GLuint GetAsyncHandle(const ProgramVariant& variant);
+
+    /// Gets the assembly program of the variant, building it when it doesn't exist.
+    GLuint GetAssemblyHandle(const ProgramVariant& variant);
+
     ShaderDiskCacheUsage GetUsage(const ProgramVariant& variant,
                                   const VideoCommon::Shader::ConstBufferLocker& locker) const;
 
     Core::System& system;
     ShaderDiskCacheOpenGL& disk_cache;
     const Device& device;
+    ShaderWorker* shader_worker = nullptr;
 
     VAddr cpu_addr{};
 
     u64 unique_identifier{};
     Tegra::Engines::ShaderType shader_type{};
 
-    GLShader::ShaderEntries entries;
-
-    ProgramCode code;
-    ProgramCode code_b;
-
+    std::shared_ptr<ShaderVariants> variants;
     LockerVariant* curr_locker_variant = nullptr;
-    std::vector<std::unique_ptr<LockerVariant>> locker_variants;
 };
 
 class ShaderCacheOpenGL final : public RasterizerCache<Shader> {
 public:
     explicit ShaderCacheOpenGL(RasterizerOpenGL& rasterizer, Core::System& system,
                                Core::Frontend::EmuWindow& emu_window, const Device& device);
+    ~ShaderCacheOpenGL();
 
     /// Loads disk cache for the current game
     void LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -151,6 +179,10 @@ private:
 
     const PrecompiledVariants* GetPrecompiledVariants(u64 unique_identifier) const;
 
+    /// Returns the variants of a shader with the same code already in the cache, or null
+    std::shared_ptr<ShaderVariants> FindVariants(u64 variants_key, const ProgramCode& code,
+                                                 const ProgramCode& code_b) const;
+
     Core::System& system;
     Core::Frontend::EmuWindow& emu_window;
     const Device& device;
@@ -161,8 +193,11 @@ private:
     std::unordered_map<u64, PrecompiledVariants> precompiled_variants;
 
     std::unordered_map<u64, UnspecializedShader> unspecialized_shaders;
+    std::unordered_map<u64, std::shared_ptr<ShaderVariants>> shader_variants;
 
     std::array<Shader, Maxwell::MaxShaderProgram> last_shaders;
+
+    std::unique_ptr<ShaderWorker> shader_worker;
 };
 
 } // namespace OpenGL
@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -58,12 +60,21 @@ constexpr u32 MAX_CONSTBUFFER_ELEMENTS =
 
 class ShaderWriter final {
 public:
+    ShaderWriter() : shader_source{AcquireBuffer()} {}
+
+    ~ShaderWriter() {
+        ReleaseBuffer(std::move(shader_source));
+    }
+
+    ShaderWriter(const ShaderWriter&) = delete;
+    ShaderWriter& operator=(const ShaderWriter&) = delete;
+
     void AddExpression(std::string_view text) {
         DEBUG_ASSERT(scope >= 0);
         if (!text.empty()) {
             AppendIndentation();
         }
-        shader_source += text;
+        shader_source.append(text.data(), text.data() + text.size());
     }
 
     // Forwards all arguments directly to libfmt.
@@ -73,13 +84,18 @@ public:
     // etc).
     template <typename... Args>
     void AddLine(std::string_view text, Args&&... args) {
-        AddExpression(fmt::format(text, std::forward<Args>(args)...));
+        DEBUG_ASSERT(scope >= 0);
+        if (!text.empty()) {
+            AppendIndentation();
+        }
+        // Format straight into the source, without going through a temporary string
+        fmt::format_to(shader_source, text, std::forward<Args>(args)...);
         AddNewLine();
     }
 
     void AddNewLine() {
         DEBUG_ASSERT(scope >= 0);
-        shader_source += '\n';
+        shader_source.push_back('\n');
     }
 
     std::string GenerateTemporary() {
@@ -87,17 +103,47 @@ public:
     }
 
     std::string GetResult() {
-        return std::move(shader_source);
+        std::string result(shader_source.data(), shader_source.size());
+        shader_source.resize(0);
+        return result;
     }
 
     s32 scope = 0;
 
 private:
+    /// Buffers already grown to the size of a shader, kept per thread so shaders decompiled in
+    /// parallel don't contend on the allocator.
+    static std::vector<fmt::memory_buffer>& GetFreeBuffers() {
+        thread_local std::vector<fmt::memory_buffer> free_buffers;
+        return free_buffers;
+    }
+
+    static fmt::memory_buffer AcquireBuffer() {
+        auto& free_buffers = GetFreeBuffers();
+        if (free_buffers.empty()) {
+            return {};
+        }
+        fmt::memory_buffer buffer = std::move(free_buffers.back());
+        free_buffers.pop_back();
+        return buffer;
+    }
+
+    static void ReleaseBuffer(fmt::memory_buffer buffer) {
+        buffer.resize(0);
+        GetFreeBuffers().push_back(std::move(buffer));
+    }
+
     void AppendIndentation() {
-        shader_source.append(static_cast<std::size_t>(scope) * 4, ' ');
+        static constexpr std::string_view spaces = "                                ";
+        std::size_t remaining = static_cast<std::size_t>(scope) * 4;
+        while (remaining > 0) {
+            const std::size_t count = std::min(remaining, spaces.size());
+            shader_source.append(spaces.data(), spaces.data() + count);
+            remaining -= count;
+        }
     }
 
-    std::string shader_source;
+    fmt::memory_buffer shader_source;
     u32 temporary_index = 1;
 };
 
@@ -112,7 +158,7 @@ public:
         return type;
     }
 
-    std::string GetCode() const {
+    const std::string& GetCode() const {
         return code;
     }
 
@@ -120,111 +166,142 @@ public:
         ASSERT(type == Type::Void);
     }
 
-    std::string As(Type type) const {
-        switch (type) {
-        case Type::Bool:
-            return AsBool();
-        case Type::Bool2:
-            return AsBool2();
-        case Type::Float:
-            return AsFloat();
-        case Type::Int:
-            return AsInt();
-        case Type::Uint:
-            return AsUint();
-        case Type::HalfFloat:
-            return AsHalfFloat();
-        default:
-            UNREACHABLE_MSG("Invalid type");
-            return code;
-        }
+    // The conversions below take the code out of expiring expressions (e.g. the result of a
+    // Visit call) instead of copying it.
+
+    std::string As(Type target) const& {
+        return Convert(type, target, code);
+    }
+    std::string As(Type target) && {
+        return Convert(type, target, std::move(code));
     }
 
-    std::string AsBool() const {
-        switch (type) {
-        case Type::Bool:
-            return code;
-        default:
-            UNREACHABLE_MSG("Incompatible types");
-            return code;
-        }
+    std::string AsBool() const& {
+        return Convert(type, Type::Bool, code);
+    }
+    std::string AsBool() && {
+        return Convert(type, Type::Bool, std::move(code));
     }
 
-    std::string AsBool2() const {
-        switch (type) {
-        case Type::Bool2:
-            return code;
-        default:
-            UNREACHABLE_MSG("Incompatible types");
-            return code;
-        }
+    std::string AsBool2() const& {
+        return Convert(type, Type::Bool2, code);
+    }
+    std::string AsBool2() && {
+        return Convert(type, Type::Bool2, std::move(code));
     }
 
-    std::string AsFloat() const {
-        switch (type) {
-        case Type::Float:
-            return code;
-        case Type::Uint:
-            return fmt::format("utof({})", code);
-        case Type::Int:
-            return fmt::format("itof({})", code);
-        case Type::HalfFloat:
-            return fmt::format("utof(packHalf2x16({}))", code);
-        default:
-            UNREACHABLE_MSG("Incompatible types");
-            return code;
-        }
+    std::string AsFloat() const& {
+        return Convert(type, Type::Float, code);
+    }
+    std::string AsFloat() && {
+        return Convert(type, Type::Float, std::move(code));
     }
 
-    std::string AsInt() const {
-        switch (type) {
-        case Type::Float:
-            return fmt::format("ftoi({})", code);
-        case Type::Uint:
-            return fmt::format("int({})", code);
-        case Type::Int:
-            return code;
-        case Type::HalfFloat:
-            return fmt::format("int(packHalf2x16({}))", code);
-        default:
-            UNREACHABLE_MSG("Incompatible types");
-            return code;
-        }
+    std::string AsInt() const& {
+        return Convert(type, Type::Int, code);
+    }
+    std::string AsInt() && {
+        return Convert(type, Type::Int, std::move(code));
     }
 
-    std::string AsUint() const {
-        switch (type) {
-        case Type::Float:
-            return fmt::format("ftou({})", code);
-        case Type::Uint:
-            return code;
-        case Type::Int:
-            return fmt::format("uint({})", code);
-        case Type::HalfFloat:
-            return fmt::format("packHalf2x16({})", code);
-        default:
-            UNREACHABLE_MSG("Incompatible types");
-            return code;
-        }
+    std::string AsUint() const& {
+        return Convert(type, Type::Uint, code);
+    }
+    std::string AsUint() && {
+        return Convert(type, Type::Uint, std::move(code));
     }
 
-    std::string AsHalfFloat() const {
-        switch (type) {
+    std::string AsHalfFloat() const& {
+        return Convert(type, Type::HalfFloat, code);
+    }
+    std::string AsHalfFloat() && {
+        return Convert(type, Type::HalfFloat, std::move(code));
+    }
+
+private:
+    /// Wraps code in a function call, reusing its storage.
+    static std::string Wrap(std::string_view prefix, std::string code, std::string_view suffix) {
+        code.reserve(prefix.size() + code.size() + suffix.size());
+        code.insert(0, prefix);
+        code += suffix;
+        return code;
+    }
+
+    static std::string Convert(Type type, Type target, std::string code) {
+        if (type == target) {
+            switch (target) {
+            case Type::Bool:
+            case Type::Bool2:
+            case Type::Float:
+            case Type::Int:
+            case Type::Uint:
+            case Type::HalfFloat:
+                return code;
+            default:
+                UNREACHABLE_MSG("Invalid type");
+                return code;
+            }
+        }
+        switch (target) {
         case Type::Float:
-            return fmt::format("unpackHalf2x16(ftou({}))", code);
-        case Type::Uint:
-            return fmt::format("unpackHalf2x16({})", code);
+            switch (type) {
+            case Type::Uint:
+                return Wrap("utof(", std::move(code), ")");
+            case Type::Int:
+                return Wrap("itof(", std::move(code), ")");
+            case Type::HalfFloat:
+                return Wrap("utof(packHalf2x16(", std::move(code), "))");
+            default:
+                break;
+            }
+            break;
         case Type::Int:
-            return fmt::format("unpackHalf2x16(int({}))", code);
+            switch (type) {
+            case Type::Float:
+                return Wrap("ftoi(", std::move(code), ")");
+            case Type::Uint:
+                return Wrap("int(", std::move(code), ")");
+            case Type::HalfFloat:
+                return Wrap("int(packHalf2x16(", std::move(code), "))");
+            default:
+                break;
+            }
+            break;
+        case Type::Uint:
+            switch (type) {
+            case Type::Float:
+                return Wrap("ftou(", std::move(code), ")");
+            case Type::Int:
+                return Wrap("uint(", std::move(code), ")");
+            case Type::HalfFloat:
+                return Wrap("packHalf2x16(", std::move(code), ")");
+            default:
+                break;
+            }
+            break;
         case Type::HalfFloat:
-            return code;
+            switch (type) {
+            case Type::Float:
+                return Wrap("unpackHalf2x16(ftou(", std::move(code), "))");
+            case Type::Uint:
+                return Wrap("unpackHalf2x16(", std::move(code), ")");
+            case Type::Int:
+                return Wrap("unpackHalf2x16(int(", std::move(code), "))");
+            default:
+                break;
+            }
+            break;
+        case Type::Bool:
+        case Type::Bool2:
+            break;
         default:
-            UNREACHABLE_MSG("Incompatible types");
+            UNREACHABLE_MSG("Invalid type");
             return code;
         }
+        UNREACHABLE_MSG("Incompatible types");
+        return code;
     }
 
-private:
     std::string code;
     Type type{};
 };
@@ -275,6 +352,12 @@ constexpr const char* GetSwizzle(u32 element) {
     return swizzle.at(element);
 }
 
+/// Returns the float type with the given number of components
+constexpr const char* GetFloatType(std::size_t num_components) {
+    constexpr std::array types = {"float", "vec2", "vec3", "vec4"};
+    return types.at(num_components - 1);
+}
+
 /// Translate topology
 std::string GetTopologyName(Tegra::Shader::OutputTopology topology) {
     switch (topology) {
@@ -344,8 +427,12 @@ std::string FlowStackTopName(MetaStackClass stack) {
 class GLSLDecompiler final {
 public:
     explicit GLSLDecompiler(const Device& device, const ShaderIR& ir, ShaderType stage,
-                            std::string suffix)
-        : device{device}, ir{ir}, stage{stage}, suffix{suffix}, header{ir.GetHeader()} {}
+                            std::string suffix, const TransformFeedbackState* transform_feedback)
+        : device{device}, ir{ir}, stage{stage}, suffix{suffix}, header{ir.GetHeader()} {
+        if (transform_feedback) {
+            this->transform_feedback = BuildTransformFeedback(*transform_feedback);
+        }
+    }
 
     void DecompileBranchMode() {
         // VM's program counter
@@ -454,7 +541,14 @@ private:
         code.AddLine("out gl_PerVertex {{");
         ++code.scope;
 
-        code.AddLine("vec4 gl_Position;");
+        std::string position_xfb;
+        if (const VaryingTFB* varying = GetTransformFeedback(Attribute::Index::Position, 0)) {
+            UNIMPLEMENTED_IF_MSG(varying->components != 4,
+                                 "Unimplemented capture of {} position components",
+                                 varying->components);
+            position_xfb = fmt::format("layout ({}) ", GetTransformFeedbackDecoration(*varying));
+        }
+        code.AddLine("{}vec4 gl_Position;", position_xfb);
 
         for (const auto attribute : ir.GetOutputAttributes()) {
             if (attribute == Attribute::Index::ClipDistances0123 ||
@@ -607,6 +701,7 @@ private:
     }
 
     void DeclareOutputAttributes() {
+        DeclareTransformFeedbackStrides();
         if (ir.HasPhysicalAttributes() && stage != ShaderType::Fragment) {
             for (u32 i = 0; i < GetNumPhysicalVaryings(); ++i) {
                 DeclareOutputAttribute(ToGenericAttribute(i));
@@ -628,7 +723,96 @@ private:
 
     void DeclareOutputAttribute(Attribute::Index index) {
         const u32 location{GetGenericAttributeIndex(index)};
-        code.AddLine("layout (location = {}) out vec4 {};", location, GetOutputAttribute(index));
+        if (!HasTransformFeedback(index)) {
+            code.AddLine("layout (location = {}) out vec4 {};", location,
+                         GetOutputAttribute(index));
+            return;
+        }
+        // Captured components are declared in their own variables, so each gets its offset
+        for (u32 element = 0; element < 4;) {
+            const u32 num_components = GetOutputPieceSize(index, element);
+            std::string xfb;
+            if (const VaryingTFB* varying = GetTransformFeedback(index, element)) {
+                xfb = fmt::format(", {}", GetTransformFeedbackDecoration(*varying));
+            }
+            code.AddLine("layout (location = {}, component = {}{}) out {} {};", location, element,
+                         xfb, GetFloatType(num_components),
+                         GetOutputPiece(index, element, num_components));
+            element += num_components;
+        }
+    }
+
+    void DeclareTransformFeedbackStrides() {
+        std::array<std::size_t, Maxwell::NumTransformFeedbackBuffers> strides{};
+        for (const auto& [location, varying] : transform_feedback) {
+            strides[varying.buffer] = varying.stride;
+        }
+        for (std::size_t buffer = 0; buffer < strides.size(); ++buffer) {
+            if (strides[buffer] != 0) {
+                code.AddLine("layout (xfb_buffer = {}, xfb_stride = {}) out;", buffer,
+                             strides[buffer]);
+            }
+        }
+    }
+
+    /// Returns the captured varying starting at the element of an output, null when it's not
+    /// captured
+    const VaryingTFB* GetTransformFeedback(Attribute::Index index, u32 element) const {
+        const auto location = static_cast<u8>(static_cast<u32>(index) * 4 + element);
+        const auto it = transform_feedback.find(location);
+        return it != transform_feedback.end() ? &it->second : nullptr;
+    }
+
+    bool HasTransformFeedback(Attribute::Index index) const {
+        for (u32 element = 0; element < 4; ++element) {
+            if (GetTransformFeedback(index, element)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Returns the number of components of the output variable starting at the element
+    u32 GetOutputPieceSize(Attribute::Index index, u32 element) const {
+        if (const VaryingTFB* varying = GetTransformFeedback(index, element)) {
+            return std::min(static_cast<u32>(varying->components), 4 - element);
+        }
+        // Uncaptured components are joined until the next captured one
+        u32 num_components = 1;
+        while (element + num_components < 4 &&
+               !GetTransformFeedback(index, element + num_components)) {
+            ++num_components;
+        }
+        return num_components;
+    }
+
+    std::string GetOutputPiece(Attribute::Index index, u32 element, u32 num_components) const {
+        constexpr std::string_view swizzle = "xyzw";
+        return fmt::format("{}_{}", GetOutputAttribute(index),
+                           swizzle.substr(element, num_components));
+    }
+
+    /// Returns the output variable and swizzle holding an element of a generic attribute
+    std::string GetOutputAttributeElement(Attribute::Index index, u32 element) const {
+        if (!HasTransformFeedback(index)) {
+            return GetOutputAttribute(index) + GetSwizzle(element);
+        }
+        u32 first = 0;
+        u32 num_components = GetOutputPieceSize(index, first);
+        while (element >= first + num_components) {
+            first += num_components;
+            num_components = GetOutputPieceSize(index, first);
+        }
+        std::string name = GetOutputPiece(index, first, num_components);
+        if (num_components > 1) {
+            name += GetSwizzle(element - first);
+        }
+        return name;
+    }
+
+    static std::string GetTransformFeedbackDecoration(const VaryingTFB& varying) {
+        return fmt::format("xfb_buffer = {}, xfb_offset = {}, xfb_stride = {}", varying.buffer,
+                           varying.offset, varying.stride);
     }
 
     void DeclareConstantBuffers() {
@@ -1049,8 +1233,7 @@ private:
             return {{fmt::format("gl_ClipDistance[{}]", abuf->GetElement() + 4), Type::Float}};
         default:
             if (IsGenericAttribute(attribute)) {
-                return {
-                    {GetOutputAttribute(attribute) + GetSwizzle(abuf->GetElement()), Type::Float}};
+                return {{GetOutputAttributeElement(attribute, abuf->GetElement()), Type::Float}};
             }
             UNIMPLEMENTED_MSG("Unhandled output attribute: {}", static_cast<u32>(attribute));
             return {};
@@ -2339,6 +2522,7 @@ private:
     const ShaderType stage;
     const std::string suffix;
     const Header header;
+    std::unordered_map<u8, VaryingTFB> transform_feedback;
 
     ShaderWriter code;
 };
@@ -2539,7 +2723,8 @@ ShaderEntries GetEntries(const VideoCommon::Shader::ShaderIR& ir) {
     }
     for (const auto& [base, usage] : ir.GetGlobalMemory()) {
         entries.global_memory_entries.emplace_back(base.cbuf_index, base.cbuf_offset, usage.is_read,
-                                                   usage.is_written);
+                                                   usage.is_written,
+                                                   usage.is_bounded ? usage.bound_size : 0);
     }
     for (const auto& sampler : ir.GetSamplers()) {
         entries.samplers.emplace_back(sampler);
@@ -2548,6 +2733,7 @@ ShaderEntries GetEntries(const VideoCommon::Shader::ShaderIR& ir) {
         entries.images.emplace_back(image);
     }
     entries.clip_distances = ir.GetClipDistances();
+    entries.output_topology = ir.GetHeader().common3.output_topology.Value();
     entries.shader_length = ir.GetLength();
     return entries;
 }
@@ -2570,8 +2756,8 @@ const float fswzadd_modifiers_b[] = float[4](-1.0f, -1.0f,  1.0f, -1.0f );
 }
 
 std::string Decompile(const Device& device, const ShaderIR& ir, ShaderType stage,
-                      const std::string& suffix) {
-    GLSLDecompiler decompiler(device, ir, stage, suffix);
+                      const std::string& suffix, const TransformFeedbackState* transform_feedback) {
+    GLSLDecompiler decompiler(device, ir, stage, suffix, transform_feedback);
     decompiler.Decompile();
     return decompiler.GetResult();
 }
@@ -12,6 +12,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
 #include "video_core/shader/shader_ir.h"
+#include "video_core/shader/transform_feedback.h"
 
 namespace VideoCommon::Shader {
 class ShaderIR;
@@ -42,9 +43,10 @@ private:
 
 class GlobalMemoryEntry {
 public:
-    explicit GlobalMemoryEntry(u32 cbuf_index, u32 cbuf_offset, bool is_read, bool is_written)
-        : cbuf_index{cbuf_index}, cbuf_offset{cbuf_offset}, is_read{is_read}, is_written{
-                                                                                  is_written} {}
+    explicit GlobalMemoryEntry(u32 cbuf_index, u32 cbuf_offset, bool is_read, bool is_written,
+                               u32 size_bound)
+        : cbuf_index{cbuf_index}, cbuf_offset{cbuf_offset}, is_read{is_read},
+          is_written{is_written}, size_bound{size_bound} {}
 
     u32 GetCbufIndex() const {
         return cbuf_index;
@@ -62,11 +64,18 @@ public:
         return is_written;
     }
 
+    /// Returns the number of bytes from the base address the shader may access, zero when it's
+    /// unknown.
+    u32 GetSizeBound() const {
+        return size_bound;
+    }
+
 private:
     u32 cbuf_index{};
     u32 cbuf_offset{};
     bool is_read{};
     bool is_written{};
+    u32 size_bound{};
 };
 
 struct ShaderEntries {
@@ -75,6 +84,7 @@ struct ShaderEntries {
     std::vector<SamplerEntry> samplers;
     std::vector<ImageEntry> images;
     std::array<bool, Maxwell::NumClipDistances> clip_distances{};
+    Tegra::Shader::OutputTopology output_topology{}; ///< Only meaningful for geometry shaders
     std::size_t shader_length{};
 };
 
@@ -82,7 +92,10 @@ ShaderEntries GetEntries(const VideoCommon::Shader::ShaderIR& ir);
 
 std::string GetCommonDeclarations();
 
+/// Decompiles a stage, the varyings in transform_feedback are captured when it's not null
 std::string Decompile(const Device& device, const VideoCommon::Shader::ShaderIR& ir,
-                      Tegra::Engines::ShaderType stage, const std::string& suffix);
+                      Tegra::Engines::ShaderType stage, const std::string& suffix,
+                      const VideoCommon::Shader::TransformFeedbackState* transform_feedback =
+                          nullptr);
 
 } // namespace OpenGL::GLShader
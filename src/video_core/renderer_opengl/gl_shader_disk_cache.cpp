@@ -7,6 +7,7 @@
 #include <fmt/format.h>
 
 #include "common/assert.h"
+#include "common/common_funcs.h"
 #include "common/common_paths.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
@@ -16,7 +17,10 @@
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
 #include "core/settings.h"
+#include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
+#include "video_core/gpu.h"
+#include "video_core/guest_driver.h"
 #include "video_core/renderer_opengl/gl_shader_cache.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 
@@ -34,6 +38,7 @@ using ShaderCacheVersionHash = std::array<u8, 64>;
 enum class TransferableEntryKind : u32 {
     Raw,
     Usage,
+    DriverProfile,
 };
 
 struct ConstBufferKey {
@@ -53,10 +58,35 @@ struct BindlessSamplerKey {
     Tegra::Engines::SamplerDescriptor sampler{};
 };
 
-constexpr u32 NativeVersion = 12;
+constexpr u32 NativeVersion = 15;
+
+constexpr u32 PrecompiledMagic = Common::MakeMagic('Y', 'P', 'C', 'C');
+constexpr u32 PrecompiledVersion = 2;
+
+/// Program binaries of a game share most of their contents, a dictionary trained from them
+/// compresses them more and faster. It's only trained once there are enough samples.
+constexpr std::size_t MinDictionarySamples = 64;
+constexpr std::size_t MaxDictionarySize = 64 * 1024;
+
+/**
+ * Header of the precompiled file. It's followed by the compressed binaries and an index at
+ * index_offset describing each of them, so binaries can be located without reading the whole file.
+ * When dictionary_size isn't zero, every binary is compressed with the dictionary stored at
+ * dictionary_offset.
+ */
+struct PrecompiledHeader {
+    u32 magic{};
+    u32 version{};
+    ShaderCacheVersionHash version_hash{};
+    u64 index_offset{};
+    u64 dictionary_offset{};
+    u32 num_entries{};
+    u32 dictionary_size{};
+};
+static_assert(std::is_trivially_copyable_v<PrecompiledHeader>);
 
 // Making sure sizes doesn't change by accident
-static_assert(sizeof(ProgramVariant) == 20);
+static_assert(sizeof(ProgramVariant) == 580);
 
 ShaderCacheVersionHash GetShaderCacheVersionHash() {
     ShaderCacheVersionHash hash{};
@@ -65,6 +95,71 @@ ShaderCacheVersionHash GetShaderCacheVersionHash() {
     return hash;
 }
 
+bool LoadPrecompiledEntry(FileUtil::IOFile& file, ShaderDiskCacheUsage& usage,
+                          ShaderDiskCacheDump& dump) {
+    u32 num_keys{};
+    u32 num_bound_samplers{};
+    u32 num_bindless_samplers{};
+    if (file.ReadArray(&usage.unique_identifier, 1) != 1 ||
+        file.ReadArray(&usage.variant, 1) != 1 || file.ReadArray(&usage.bound_buffer, 1) != 1 ||
+        file.ReadArray(&num_keys, 1) != 1 || file.ReadArray(&num_bound_samplers, 1) != 1 ||
+        file.ReadArray(&num_bindless_samplers, 1) != 1) {
+        return false;
+    }
+    std::vector<ConstBufferKey> keys(num_keys);
+    std::vector<BoundSamplerKey> bound_samplers(num_bound_samplers);
+    std::vector<BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
+    if (file.ReadArray(keys.data(), keys.size()) != keys.size() ||
+        file.ReadArray(bound_samplers.data(), bound_samplers.size()) != bound_samplers.size() ||
+        file.ReadArray(bindless_samplers.data(), bindless_samplers.size()) !=
+            bindless_samplers.size()) {
+        return false;
+    }
+    for (const auto& key : keys) {
+        usage.keys.insert({{key.cbuf, key.offset}, key.value});
+    }
+    for (const auto& key : bound_samplers) {
+        usage.bound_samplers.emplace(key.offset, key.sampler);
+    }
+    for (const auto& key : bindless_samplers) {
+        usage.bindless_samplers.insert({{key.cbuf, key.offset}, key.sampler});
+    }
+    return file.ReadArray(&dump.binary_format, 1) == 1 &&
+           file.ReadArray(&dump.binary_size, 1) == 1 &&
+           file.ReadArray(&dump.compressed_size, 1) == 1 && file.ReadArray(&dump.offset, 1) == 1;
+}
+
+bool SavePrecompiledEntry(FileUtil::IOFile& file, const ShaderDiskCacheUsage& usage,
+                          const ShaderDiskCacheDump& dump) {
+    if (file.WriteObject(usage.unique_identifier) != 1 || file.WriteObject(usage.variant) != 1 ||
+        file.WriteObject(usage.bound_buffer) != 1 ||
+        file.WriteObject(static_cast<u32>(usage.keys.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(usage.bound_samplers.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(usage.bindless_samplers.size())) != 1) {
+        return false;
+    }
+    for (const auto& [pair, value] : usage.keys) {
+        const auto [cbuf, offset] = pair;
+        if (file.WriteObject(ConstBufferKey{cbuf, offset, value}) != 1) {
+            return false;
+        }
+    }
+    for (const auto& [offset, sampler] : usage.bound_samplers) {
+        if (file.WriteObject(BoundSamplerKey{offset, sampler}) != 1) {
+            return false;
+        }
+    }
+    for (const auto& [pair, sampler] : usage.bindless_samplers) {
+        const auto [cbuf, offset] = pair;
+        if (file.WriteObject(BindlessSamplerKey{cbuf, offset, sampler}) != 1) {
+            return false;
+        }
+    }
+    return file.WriteObject(static_cast<u32>(dump.binary_format)) == 1 &&
+           file.WriteObject(dump.binary_size) == 1 && file.WriteObject(dump.compressed_size) == 1 &&
+           file.WriteObject(dump.offset) == 1;
+}
+
 } // Anonymous namespace
 
 ShaderDiskCacheRaw::ShaderDiskCacheRaw(u64 unique_identifier, ShaderType type, ProgramCode code,
@@ -218,6 +313,13 @@ ShaderDiskCacheOpenGL::LoadTransferable() {
             usages.push_back(std::move(usage));
             break;
         }
+        case TransferableEntryKind::DriverProfile: {
+            if (!LoadDriverProfile(file)) {
+                LOG_ERROR(Render_OpenGL, "Failed to load transferable driver profile, skipping");
+                return {};
+            }
+            break;
+        }
         default:
             LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={}, skipping",
                       static_cast<u32>(kind));
@@ -235,98 +337,109 @@ ShaderDiskCacheOpenGL::LoadPrecompiled() {
         return {};
     }
 
-    std::string path = GetPrecompiledPath();
-    FileUtil::IOFile file(path, "rb");
-    if (!file.IsOpen()) {
+    std::scoped_lock lock{precompiled_mutex};
+    if (!precompiled_file.Open(GetPrecompiledPath(), "rb")) {
         LOG_INFO(Render_OpenGL, "No precompiled shader cache found for game with title id={}",
                  GetTitleID());
         return {};
     }
 
-    const auto result = LoadPrecompiledFile(file);
+    auto result = LoadPrecompiledFile();
     if (!result) {
         LOG_INFO(Render_OpenGL,
                  "Failed to load precompiled cache for game with title id={}, removing",
                  GetTitleID());
-        file.Close();
-        InvalidatePrecompiled();
+        precompiled_file.Close();
+        precompiled_entries.clear();
+        if (!FileUtil::Delete(GetPrecompiledPath())) {
+            LOG_ERROR(Render_OpenGL, "Failed to invalidate precompiled file={}",
+                      GetPrecompiledPath());
+        }
         return {};
     }
-    return *result;
+    return std::move(*result);
 }
 
 std::optional<std::unordered_map<ShaderDiskCacheUsage, ShaderDiskCacheDump>>
-ShaderDiskCacheOpenGL::LoadPrecompiledFile(FileUtil::IOFile& file) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
-    std::vector<u8> compressed(file.GetSize());
-    file.ReadBytes(compressed.data(), compressed.size());
-    const std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(compressed);
-    SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
-    precompiled_cache_virtual_file_offset = 0;
-
-    ShaderCacheVersionHash file_hash{};
-    if (!LoadArrayFromPrecompiled(file_hash.data(), file_hash.size())) {
-        precompiled_cache_virtual_file_offset = 0;
+ShaderDiskCacheOpenGL::LoadPrecompiledFile() {
+    // Only the index is read here, binaries stay in the file until they are requested
+    PrecompiledHeader header;
+    if (precompiled_file.ReadArray(&header, 1) != 1 || header.magic != PrecompiledMagic ||
+        header.version != PrecompiledVersion) {
+        LOG_INFO(Render_OpenGL, "Precompiled cache has an unknown format");
         return {};
     }
-    if (GetShaderCacheVersionHash() != file_hash) {
+    if (header.version_hash != GetShaderCacheVersionHash()) {
         LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
-        precompiled_cache_virtual_file_offset = 0;
+        return {};
+    }
+    if (header.index_offset > precompiled_file.GetSize()) {
         return {};
     }
 
-    ShaderDumpsMap dumps;
-    while (precompiled_cache_virtual_file_offset < precompiled_cache_virtual_file.GetSize()) {
-        u32 num_keys{};
-        u32 num_bound_samplers{};
-        u32 num_bindless_samplers{};
-        ShaderDiskCacheUsage usage;
-        if (!LoadObjectFromPrecompiled(usage.unique_identifier) ||
-            !LoadObjectFromPrecompiled(usage.variant) ||
-            !LoadObjectFromPrecompiled(usage.bound_buffer) ||
-            !LoadObjectFromPrecompiled(num_keys) ||
-            !LoadObjectFromPrecompiled(num_bound_samplers) ||
-            !LoadObjectFromPrecompiled(num_bindless_samplers)) {
+    dictionary.reset();
+    if (header.dictionary_size != 0) {
+        std::vector<u8> dictionary_data(header.dictionary_size);
+        if (header.dictionary_offset + header.dictionary_size > header.index_offset ||
+            !precompiled_file.Seek(static_cast<s64>(header.dictionary_offset), SEEK_SET) ||
+            precompiled_file.ReadBytes(dictionary_data.data(), dictionary_data.size()) !=
+                dictionary_data.size()) {
             return {};
         }
-        std::vector<ConstBufferKey> keys(num_keys);
-        std::vector<BoundSamplerKey> bound_samplers(num_bound_samplers);
-        std::vector<BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
-        if (!LoadArrayFromPrecompiled(keys.data(), keys.size()) ||
-            !LoadArrayFromPrecompiled(bound_samplers.data(), bound_samplers.size()) !=
-                bound_samplers.size() ||
-            !LoadArrayFromPrecompiled(bindless_samplers.data(), bindless_samplers.size()) !=
-                bindless_samplers.size()) {
+        auto loaded =
+            std::make_shared<Common::Compression::ZSTDDictionary>(std::move(dictionary_data));
+        if (!loaded->IsValid()) {
+            LOG_INFO(Render_OpenGL, "Precompiled cache has an invalid dictionary");
             return {};
         }
-        for (const auto& key : keys) {
-            usage.keys.insert({{key.cbuf, key.offset}, key.value});
-        }
-        for (const auto& key : bound_samplers) {
-            usage.bound_samplers.emplace(key.offset, key.sampler);
-        }
-        for (const auto& key : bindless_samplers) {
-            usage.bindless_samplers.insert({{key.cbuf, key.offset}, key.sampler});
-        }
+        dictionary = std::move(loaded);
+    }
 
-        ShaderDiskCacheDump dump;
-        if (!LoadObjectFromPrecompiled(dump.binary_format)) {
-            return {};
-        }
+    if (!precompiled_file.Seek(static_cast<s64>(header.index_offset), SEEK_SET)) {
+        dictionary.reset();
+        return {};
+    }
 
-        u32 binary_length{};
-        if (!LoadObjectFromPrecompiled(binary_length)) {
+    ShaderDumpsMap dumps;
+    precompiled_entries.clear();
+    precompiled_entries.reserve(header.num_entries);
+    for (u32 i = 0; i < header.num_entries; ++i) {
+        ShaderDiskCacheUsage usage;
+        ShaderDiskCacheDump dump;
+        if (!LoadPrecompiledEntry(precompiled_file, usage, dump) ||
+            dump.offset + dump.compressed_size > header.index_offset) {
+            precompiled_entries.clear();
+            dictionary.reset();
             return {};
         }
+        precompiled_entries.emplace_back(usage, dump);
+        dumps.emplace(std::move(usage), dump);
+    }
+    return dumps;
+}
 
-        dump.binary.resize(binary_length);
-        if (!LoadArrayFromPrecompiled(dump.binary.data(), dump.binary.size())) {
+std::optional<std::vector<u8>> ShaderDiskCacheOpenGL::LoadDumpBinary(
+    const ShaderDiskCacheDump& dump) {
+    std::vector<u8> compressed(dump.compressed_size);
+    std::shared_ptr<const Common::Compression::ZSTDDictionary> used_dictionary;
+    {
+        std::scoped_lock lock{precompiled_mutex};
+        if (!precompiled_file.IsOpen() ||
+            !precompiled_file.Seek(static_cast<s64>(dump.offset), SEEK_SET) ||
+            precompiled_file.ReadBytes(compressed.data(), compressed.size()) !=
+                compressed.size()) {
             return {};
         }
-
-        dumps.emplace(std::move(usage), dump);
+        used_dictionary = dictionary;
     }
-    return dumps;
+    // The size is known, so the binary is decompressed in place
+    std::vector<u8> binary(dump.binary_size);
+    if (!Common::Compression::DecompressDataZSTD(compressed.data(), compressed.size(),
+                                                 binary.data(), binary.size(),
+                                                 used_dictionary.get())) {
+        return {};
+    }
+    return binary;
 }
 
 void ShaderDiskCacheOpenGL::InvalidateTransferable() {
@@ -334,12 +447,19 @@ void ShaderDiskCacheOpenGL::InvalidateTransferable() {
         LOG_ERROR(Render_OpenGL, "Failed to invalidate transferable file={}",
                   GetTransferablePath());
     }
+    saved_texture_handler_size = false;
+    num_saved_bindless_samplers = 0;
     InvalidatePrecompiled();
 }
 
 void ShaderDiskCacheOpenGL::InvalidatePrecompiled() {
-    // Clear virtaul precompiled cache file
-    precompiled_cache_virtual_file.Resize(0);
+    {
+        std::scoped_lock lock{precompiled_mutex};
+        precompiled_file.Close();
+        precompiled_entries.clear();
+        dictionary.reset();
+    }
+    pending_dumps.clear();
 
     if (!FileUtil::Delete(GetPrecompiledPath())) {
         LOG_ERROR(Render_OpenGL, "Failed to invalidate precompiled file={}", GetPrecompiledPath());
@@ -423,6 +543,9 @@ void ShaderDiskCacheOpenGL::SaveUsage(const ShaderDiskCacheUsage& usage) {
             return;
         }
     }
+    if (!SaveDriverProfile(file)) {
+        Close();
+    }
 }
 
 void ShaderDiskCacheOpenGL::SaveDump(const ShaderDiskCacheUsage& usage, GLuint program) {
@@ -430,13 +553,6 @@ void ShaderDiskCacheOpenGL::SaveDump(const ShaderDiskCacheUsage& usage, GLuint p
         return;
     }
 
-    // TODO(Rodrigo): This is a design smell. I shouldn't be having to manually write the header
-    // when writing the dump. This should be done the moment I get access to write to the virtual
-    // file.
-    if (precompiled_cache_virtual_file.GetSize() == 0) {
-        SavePrecompiledHeaderToVirtualPrecompiledCache();
-    }
-
     GLint binary_length{};
     glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
 
@@ -444,45 +560,64 @@ void ShaderDiskCacheOpenGL::SaveDump(const ShaderDiskCacheUsage& usage, GLuint p
     std::vector<u8> binary(binary_length);
     glGetProgramBinary(program, binary_length, nullptr, &binary_format, binary.data());
 
-    const auto Close = [&] {
-        LOG_ERROR(Render_OpenGL, "Failed to save binary program file in shader={:016X}, removing",
-                  usage.unique_identifier);
-        InvalidatePrecompiled();
-    };
+    PendingDump& pending = pending_dumps.emplace_back();
+    pending.usage = usage;
+    pending.binary_format = binary_format;
+    pending.binary_size = static_cast<u32>(binary.size());
 
-    if (!SaveObjectToPrecompiled(usage.unique_identifier) ||
-        !SaveObjectToPrecompiled(usage.variant) || !SaveObjectToPrecompiled(usage.bound_buffer) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(usage.keys.size())) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(usage.bound_samplers.size())) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(usage.bindless_samplers.size()))) {
-        Close();
-        return;
+    std::scoped_lock lock{precompiled_mutex};
+    pending.compressed =
+        dictionary
+            ? Common::Compression::CompressDataZSTD(binary.data(), binary.size(), *dictionary)
+            : Common::Compression::CompressDataZSTDDefault(binary.data(), binary.size());
+}
+
+bool ShaderDiskCacheOpenGL::LoadDriverProfile(FileUtil::IOFile& file) {
+    u32 texture_handler_size{};
+    u32 num_bindless_samplers{};
+    if (file.ReadArray(&texture_handler_size, 1) != 1 ||
+        file.ReadArray(&num_bindless_samplers, 1) != 1) {
+        return false;
     }
-    for (const auto& [pair, value] : usage.keys) {
-        const auto [cbuf, offset] = pair;
-        if (SaveObjectToPrecompiled(ConstBufferKey{cbuf, offset, value}) != 1) {
-            Close();
-            return;
-        }
+    std::vector<VideoCore::BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
+    if (file.ReadArray(bindless_samplers.data(), bindless_samplers.size()) !=
+        bindless_samplers.size()) {
+        return false;
     }
-    for (const auto& [offset, sampler] : usage.bound_samplers) {
-        if (SaveObjectToPrecompiled(BoundSamplerKey{offset, sampler}) != 1) {
-            Close();
-            return;
-        }
+
+    auto& profile = system.GPU().Maxwell3D().AccessGuestDriverProfile();
+    if (texture_handler_size != 0 && !profile.TextureHandlerSizeKnown()) {
+        profile.SetTextureHandlerSize(texture_handler_size);
     }
-    for (const auto& [pair, sampler] : usage.bindless_samplers) {
-        const auto [cbuf, offset] = pair;
-        if (SaveObjectToPrecompiled(BindlessSamplerKey{cbuf, offset, sampler}) != 1) {
-            Close();
-            return;
-        }
+    for (const auto& key : bindless_samplers) {
+        profile.RegisterBindlessSampler(key);
     }
-    if (!SaveObjectToPrecompiled(static_cast<u32>(binary_format)) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(binary_length)) ||
-        !SaveArrayToPrecompiled(binary.data(), binary.size())) {
-        Close();
+    saved_texture_handler_size = profile.TextureHandlerSizeKnown();
+    num_saved_bindless_samplers = profile.GetBindlessSamplers().size();
+    return true;
+}
+
+bool ShaderDiskCacheOpenGL::SaveDriverProfile(FileUtil::IOFile& file) {
+    const auto& profile = system.GPU().Maxwell3D().AccessGuestDriverProfile();
+    const auto& bindless_samplers = profile.GetBindlessSamplers();
+    const bool save_handler_size = profile.TextureHandlerSizeKnown() && !saved_texture_handler_size;
+    if (!save_handler_size && bindless_samplers.size() == num_saved_bindless_samplers) {
+        return true;
     }
+
+    // Only the locations learned since the last save are stored, loading appends them in order
+    const u32 texture_handler_size = save_handler_size ? profile.GetTextureHandlerSize() : 0;
+    const std::size_t num_new = bindless_samplers.size() - num_saved_bindless_samplers;
+    if (file.WriteObject(TransferableEntryKind::DriverProfile) != 1 ||
+        file.WriteObject(texture_handler_size) != 1 ||
+        file.WriteObject(static_cast<u32>(num_new)) != 1 ||
+        file.WriteArray(bindless_samplers.data() + num_saved_bindless_samplers, num_new) !=
+            num_new) {
+        return false;
+    }
+    saved_texture_handler_size = profile.TextureHandlerSizeKnown();
+    num_saved_bindless_samplers = bindless_samplers.size();
+    return true;
 }
 
 FileUtil::IOFile ShaderDiskCacheOpenGL::AppendTransferableFile() const {
@@ -509,33 +644,173 @@ FileUtil::IOFile ShaderDiskCacheOpenGL::AppendTransferableFile() const {
     return file;
 }
 
-void ShaderDiskCacheOpenGL::SavePrecompiledHeaderToVirtualPrecompiledCache() {
-    const auto hash{GetShaderCacheVersionHash()};
-    if (!SaveArrayToPrecompiled(hash.data(), hash.size())) {
-        LOG_ERROR(
-            Render_OpenGL,
-            "Failed to write precompiled cache version hash to virtual precompiled cache file");
+void ShaderDiskCacheOpenGL::SavePrecompiledFile() {
+    if (!is_usable || !EnsureDirectories()) {
+        return;
     }
-}
-
-void ShaderDiskCacheOpenGL::SaveVirtualPrecompiledFile() {
-    precompiled_cache_virtual_file_offset = 0;
-    const std::vector<u8> uncompressed = precompiled_cache_virtual_file.ReadAllBytes();
-    const std::vector<u8> compressed =
-        Common::Compression::CompressDataZSTDDefault(uncompressed.data(), uncompressed.size());
 
+    // Stored binaries are copied from the current file, so the new one is written aside and
+    // moved over the old one once it's complete
     const auto precompiled_path{GetPrecompiledPath()};
-    FileUtil::IOFile file(precompiled_path, "wb");
+    const auto temporary_path{precompiled_path + ".tmp"};
 
-    if (!file.IsOpen()) {
-        LOG_ERROR(Render_OpenGL, "Failed to open precompiled cache in path={}", precompiled_path);
+    std::scoped_lock lock{precompiled_mutex};
+    if (!dictionary && precompiled_entries.size() + pending_dumps.size() >= MinDictionarySamples) {
+        TrainDictionary();
+    }
+    auto index = WritePrecompiledFile(temporary_path);
+    if (!index) {
+        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache in path={}", temporary_path);
+        FileUtil::Delete(temporary_path);
         return;
     }
-    if (file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  precompiled_path);
+
+    precompiled_file.Close();
+    FileUtil::Delete(precompiled_path);
+    if (!FileUtil::Rename(temporary_path, precompiled_path)) {
+        LOG_ERROR(Render_OpenGL, "Failed to move precompiled cache to path={}", precompiled_path);
+        precompiled_entries.clear();
         return;
     }
+
+    precompiled_entries = std::move(*index);
+    pending_dumps.clear();
+    precompiled_file.Open(precompiled_path, "rb");
+}
+
+void ShaderDiskCacheOpenGL::TrainDictionary() {
+    // Stored binaries are recompressed too, so every binary in the file uses the dictionary
+    std::vector<PendingDump> dumps;
+    std::vector<std::vector<u8>> binaries;
+    dumps.reserve(precompiled_entries.size() + pending_dumps.size());
+    binaries.reserve(precompiled_entries.size() + pending_dumps.size());
+
+    std::vector<u8> compressed;
+    for (const auto& [usage, dump] : precompiled_entries) {
+        compressed.resize(dump.compressed_size);
+        std::vector<u8> binary(dump.binary_size);
+        if (!precompiled_file.IsOpen() ||
+            !precompiled_file.Seek(static_cast<s64>(dump.offset), SEEK_SET) ||
+            precompiled_file.ReadBytes(compressed.data(), compressed.size()) !=
+                compressed.size() ||
+            !Common::Compression::DecompressDataZSTD(compressed.data(), compressed.size(),
+                                                     binary.data(), binary.size())) {
+            return;
+        }
+        PendingDump& stored = dumps.emplace_back();
+        stored.usage = usage;
+        stored.binary_format = dump.binary_format;
+        stored.binary_size = dump.binary_size;
+        binaries.push_back(std::move(binary));
+    }
+    for (const auto& pending : pending_dumps) {
+        std::vector<u8> binary(pending.binary_size);
+        if (!Common::Compression::DecompressDataZSTD(pending.compressed.data(),
+                                                     pending.compressed.size(), binary.data(),
+                                                     binary.size())) {
+            return;
+        }
+        PendingDump& copy = dumps.emplace_back();
+        copy.usage = pending.usage;
+        copy.binary_format = pending.binary_format;
+        copy.binary_size = pending.binary_size;
+        binaries.push_back(std::move(binary));
+    }
+
+    auto trained = std::make_shared<Common::Compression::ZSTDDictionary>(
+        Common::Compression::TrainDictionaryZSTD(binaries, MaxDictionarySize));
+    if (trained->GetData().empty() || !trained->IsValid()) {
+        LOG_INFO(Render_OpenGL, "Failed to train a shader cache dictionary, skipping");
+        return;
+    }
+    for (std::size_t i = 0; i < dumps.size(); ++i) {
+        dumps[i].compressed =
+            Common::Compression::CompressDataZSTD(binaries[i].data(), binaries[i].size(), *trained);
+        if (dumps[i].compressed.empty()) {
+            return;
+        }
+    }
+
+    LOG_INFO(Render_OpenGL, "Trained a shader cache dictionary of {} bytes from {} binaries",
+             trained->GetData().size(), binaries.size());
+    dictionary = std::move(trained);
+    precompiled_entries.clear();
+    pending_dumps = std::move(dumps);
+}
+
+std::optional<std::vector<std::pair<ShaderDiskCacheUsage, ShaderDiskCacheDump>>>
+ShaderDiskCacheOpenGL::WritePrecompiledFile(const std::string& path) {
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        return {};
+    }
+
+    PrecompiledHeader header;
+    header.magic = PrecompiledMagic;
+    header.version = PrecompiledVersion;
+    header.version_hash = GetShaderCacheVersionHash();
+    if (file.WriteObject(header) != 1) {
+        return {};
+    }
+
+    if (dictionary) {
+        const std::vector<u8>& dictionary_data = dictionary->GetData();
+        header.dictionary_offset = file.Tell();
+        header.dictionary_size = static_cast<u32>(dictionary_data.size());
+        if (file.WriteBytes(dictionary_data.data(), dictionary_data.size()) !=
+            dictionary_data.size()) {
+            return {};
+        }
+    }
+
+    std::vector<std::pair<ShaderDiskCacheUsage, ShaderDiskCacheDump>> index;
+    index.reserve(precompiled_entries.size() + pending_dumps.size());
+
+    const auto WriteBinary = [&](const ShaderDiskCacheUsage& usage, ShaderDiskCacheDump dump,
+                                 const std::vector<u8>& compressed) {
+        dump.offset = file.Tell();
+        dump.compressed_size = static_cast<u32>(compressed.size());
+        if (file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            return false;
+        }
+        index.emplace_back(usage, dump);
+        return true;
+    };
+
+    // Stored binaries are copied as they are, without decompressing them
+    std::vector<u8> compressed;
+    for (const auto& [usage, dump] : precompiled_entries) {
+        compressed.resize(dump.compressed_size);
+        if (!precompiled_file.IsOpen() ||
+            !precompiled_file.Seek(static_cast<s64>(dump.offset), SEEK_SET) ||
+            precompiled_file.ReadBytes(compressed.data(), compressed.size()) !=
+                compressed.size()) {
+            return {};
+        }
+        if (!WriteBinary(usage, dump, compressed)) {
+            return {};
+        }
+    }
+    for (const auto& pending : pending_dumps) {
+        ShaderDiskCacheDump dump;
+        dump.binary_format = pending.binary_format;
+        dump.binary_size = pending.binary_size;
+        if (!WriteBinary(pending.usage, dump, pending.compressed)) {
+            return {};
+        }
+    }
+
+    header.index_offset = file.Tell();
+    header.num_entries = static_cast<u32>(index.size());
+    for (const auto& [usage, dump] : index) {
+        if (!SavePrecompiledEntry(file, usage, dump)) {
+            return {};
+        }
+    }
+    if (!file.Seek(0, SEEK_SET) || file.WriteObject(header) != 1) {
+        return {};
+    }
+    return index;
 }
 
 bool ShaderDiskCacheOpenGL::EnsureDirectories() const {
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -17,17 +19,18 @@
 
 #include "common/assert.h"
 #include "common/common_types.h"
-#include "core/file_sys/vfs_vector.h"
+#include "common/file_util.h"
 #include "video_core/engines/shader_type.h"
 #include "video_core/renderer_opengl/gl_shader_gen.h"
 #include "video_core/shader/const_buffer_locker.h"
+#include "video_core/shader/transform_feedback.h"
 
-namespace Core {
-class System;
+namespace Common::Compression {
+class ZSTDDictionary;
 }
 
-namespace FileUtil {
-class IOFile;
+namespace Core {
+class System;
 }
 
 namespace OpenGL {
@@ -54,6 +57,7 @@ struct ProgramVariant final {
 
     // Graphics specific parameters.
     GLenum primitive_mode{};
+    VideoCommon::Shader::TransformFeedbackState transform_feedback{};
 
     // Compute specific parameters.
     u32 block_x{};
@@ -63,10 +67,10 @@ struct ProgramVariant final {
     u32 local_memory_size{};
 
     bool operator==(const ProgramVariant& rhs) const noexcept {
-        return std::tie(primitive_mode, block_x, block_y, block_z, shared_memory_size,
-                        local_memory_size) == std::tie(rhs.primitive_mode, rhs.block_x, rhs.block_y,
-                                                       rhs.block_z, rhs.shared_memory_size,
-                                                       rhs.local_memory_size);
+        return std::tie(primitive_mode, transform_feedback, block_x, block_y, block_z,
+                        shared_memory_size, local_memory_size) ==
+               std::tie(rhs.primitive_mode, rhs.transform_feedback, rhs.block_x, rhs.block_y,
+                        rhs.block_z, rhs.shared_memory_size, rhs.local_memory_size);
     }
 
     bool operator!=(const ProgramVariant& rhs) const noexcept {
@@ -107,7 +111,8 @@ struct hash<OpenGL::ProgramVariant> {
                (static_cast<std::size_t>(variant.block_y) << 32) ^
                (static_cast<std::size_t>(variant.block_z) << 48) ^
                (static_cast<std::size_t>(variant.shared_memory_size) << 16) ^
-               (static_cast<std::size_t>(variant.local_memory_size) << 36);
+               (static_cast<std::size_t>(variant.local_memory_size) << 36) ^
+               variant.transform_feedback.Hash();
     }
 };
 
@@ -162,10 +167,13 @@ private:
     ProgramCode code_b;
 };
 
-/// Contains an OpenGL dumped binary program
+/// Locates an OpenGL dumped binary program inside the precompiled file. Binaries are compressed
+/// individually, so they can be read and decompressed on demand with LoadDumpBinary.
 struct ShaderDiskCacheDump {
     GLenum binary_format{};
-    std::vector<u8> binary;
+    u32 binary_size{};     ///< Size of the decompressed binary.
+    u32 compressed_size{}; ///< Size of the binary as stored in the file.
+    u64 offset{};          ///< Offset of the compressed binary in the precompiled file.
 };
 
 class ShaderDiskCacheOpenGL {
@@ -177,13 +185,16 @@ public:
     std::optional<std::pair<std::vector<ShaderDiskCacheRaw>, std::vector<ShaderDiskCacheUsage>>>
     LoadTransferable();
 
-    /// Loads current game's precompiled cache. Invalidates on failure.
+    /// Loads the index of current game's precompiled cache. Invalidates on failure.
     std::unordered_map<ShaderDiskCacheUsage, ShaderDiskCacheDump> LoadPrecompiled();
 
+    /// Reads and decompresses a dumped binary program. Returns empty on failure. Thread safe.
+    std::optional<std::vector<u8>> LoadDumpBinary(const ShaderDiskCacheDump& dump);
+
     /// Removes the transferable (and precompiled) cache file.
     void InvalidateTransferable();
 
-    /// Removes the precompiled cache file and clears virtual precompiled cache file.
+    /// Removes the precompiled cache file and forgets the dumps pending to be saved.
     void InvalidatePrecompiled();
 
     /// Saves a raw dump to the transferable file. Checks for collisions.
@@ -192,23 +203,45 @@ public:
     /// Saves shader usage to the transferable file. Does not check for collisions.
     void SaveUsage(const ShaderDiskCacheUsage& usage);
 
-    /// Saves a dump entry to the precompiled file. Does not check for collisions.
+    /// Compresses a dump entry to be written with SavePrecompiledFile. Does not check for
+    /// collisions.
     void SaveDump(const ShaderDiskCacheUsage& usage, GLuint program);
 
-    /// Serializes virtual precompiled shader cache file to real file
-    void SaveVirtualPrecompiledFile();
+    /// Rewrites the precompiled file with the stored entries and the pending dumps
+    void SavePrecompiledFile();
 
 private:
-    /// Loads the transferable cache. Returns empty on failure.
+    /// Dump compressed in memory, waiting to be written to the precompiled file
+    struct PendingDump {
+        ShaderDiskCacheUsage usage;
+        GLenum binary_format{};
+        u32 binary_size{};
+        std::vector<u8> compressed;
+    };
+
+    /// Loads the precompiled cache index. Returns empty on failure.
     std::optional<std::unordered_map<ShaderDiskCacheUsage, ShaderDiskCacheDump>>
-    LoadPrecompiledFile(FileUtil::IOFile& file);
+    LoadPrecompiledFile();
+
+    /// Trains a dictionary from the stored entries and the pending dumps, and recompresses all of
+    /// them with it into the pending dumps. Keeps them as they are on failure.
+    void TrainDictionary();
+
+    /// Writes a precompiled file with the stored entries and the pending dumps to the given path.
+    /// Returns the new index on success.
+    std::optional<std::vector<std::pair<ShaderDiskCacheUsage, ShaderDiskCacheDump>>>
+    WritePrecompiledFile(const std::string& path);
+
+    /// Applies a driver profile entry to the guest driver profile. Returns true on success.
+    bool LoadDriverProfile(FileUtil::IOFile& file);
+
+    /// Writes the guest driver profile learned since the last save, if any. Returns true on
+    /// success.
+    bool SaveDriverProfile(FileUtil::IOFile& file);
 
     /// Opens current game's transferable file and write it's header if it doesn't exist
     FileUtil::IOFile AppendTransferableFile() const;
 
-    /// Save precompiled header to precompiled_cache_in_memory
-    void SavePrecompiledHeaderToVirtualPrecompiledCache();
-
     /// Create shader disk cache directories. Returns true on success.
     bool EnsureDirectories() const;
 
@@ -230,48 +263,27 @@ private:
     /// Get current game's title id
     std::string GetTitleID() const;
 
-    template <typename T>
-    bool SaveArrayToPrecompiled(const T* data, std::size_t length) {
-        const std::size_t write_length = precompiled_cache_virtual_file.WriteArray(
-            data, length, precompiled_cache_virtual_file_offset);
-        precompiled_cache_virtual_file_offset += write_length;
-        return write_length == sizeof(T) * length;
-    }
-
-    template <typename T>
-    bool LoadArrayFromPrecompiled(T* data, std::size_t length) {
-        const std::size_t read_length = precompiled_cache_virtual_file.ReadArray(
-            data, length, precompiled_cache_virtual_file_offset);
-        precompiled_cache_virtual_file_offset += read_length;
-        return read_length == sizeof(T) * length;
-    }
-
-    template <typename T>
-    bool SaveObjectToPrecompiled(const T& object) {
-        return SaveArrayToPrecompiled(&object, 1);
-    }
-
-    bool SaveObjectToPrecompiled(bool object) {
-        const auto value = static_cast<u8>(object);
-        return SaveArrayToPrecompiled(&value, 1);
-    }
+    Core::System& system;
 
-    template <typename T>
-    bool LoadObjectFromPrecompiled(T& object) {
-        return LoadArrayFromPrecompiled(&object, 1);
-    }
+    // Precompiled file kept open to read binaries on demand and the dictionary its binaries are
+    // compressed with, guarded by the mutex
+    FileUtil::IOFile precompiled_file;
+    std::shared_ptr<const Common::Compression::ZSTDDictionary> dictionary;
+    std::mutex precompiled_mutex;
 
-    Core::System& system;
+    // Entries stored in the precompiled file
+    std::vector<std::pair<ShaderDiskCacheUsage, ShaderDiskCacheDump>> precompiled_entries;
 
-    // Stores whole precompiled cache which will be read from or saved to the precompiled chache
-    // file
-    FileSys::VectorVfsFile precompiled_cache_virtual_file;
-    // Stores the current offset of the precompiled cache file for IO purposes
-    std::size_t precompiled_cache_virtual_file_offset = 0;
+    // Dumps saved since the precompiled file was loaded
+    std::vector<PendingDump> pending_dumps;
 
     // Stored transferable shaders
     std::unordered_map<u64, std::unordered_set<ShaderDiskCacheUsage>> transferable;
 
+    // Guest driver profile state already stored in the transferable file
+    bool saved_texture_handler_size{};
+    std::size_t num_saved_bindless_samplers{};
+
     // The cache has been loaded at boot
     bool is_usable{};
 };
@@ -22,7 +22,8 @@ using VideoCommon::Shader::CompilerSettings;
 using VideoCommon::Shader::ProgramCode;
 using VideoCommon::Shader::ShaderIR;
 
-std::string GenerateVertexShader(const Device& device, const ShaderIR& ir, const ShaderIR* ir_b) {
+std::string GenerateVertexShader(const Device& device, const ShaderIR& ir, const ShaderIR* ir_b,
+                                 const TransformFeedbackState& transform_feedback) {
     std::string out = GetCommonDeclarations();
     out += fmt::format(R"(
 layout (std140, binding = {}) uniform vs_config {{
@@ -31,9 +32,11 @@ layout (std140, binding = {}) uniform vs_config {{
 
 )",
                        EmulationUniformBlockBinding);
-    out += Decompile(device, ir, ShaderType::Vertex, "vertex");
+    // The program that runs last writes the captured outputs
+    const auto* xfb = transform_feedback.IsEnabled() ? &transform_feedback : nullptr;
+    out += Decompile(device, ir, ShaderType::Vertex, "vertex", ir_b ? nullptr : xfb);
     if (ir_b) {
-        out += Decompile(device, *ir_b, ShaderType::Vertex, "vertex_b");
+        out += Decompile(device, *ir_b, ShaderType::Vertex, "vertex_b", xfb);
     }
 
     out += R"(
@@ -48,7 +51,8 @@ void main() {
     return out;
 }
 
-std::string GenerateGeometryShader(const Device& device, const ShaderIR& ir) {
+std::string GenerateGeometryShader(const Device& device, const ShaderIR& ir,
+                                   const TransformFeedbackState& transform_feedback) {
     std::string out = GetCommonDeclarations();
     out += fmt::format(R"(
 layout (std140, binding = {}) uniform gs_config {{
@@ -57,7 +61,8 @@ layout (std140, binding = {}) uniform gs_config {{
 
 )",
                        EmulationUniformBlockBinding);
-    out += Decompile(device, ir, ShaderType::Geometry, "geometry");
+    out += Decompile(device, ir, ShaderType::Geometry, "geometry",
+                     transform_feedback.IsEnabled() ? &transform_feedback : nullptr);
 
     out += R"(
 void main() {
@@ -18,12 +18,15 @@ namespace OpenGL::GLShader {
 
 using VideoCommon::Shader::ProgramCode;
 using VideoCommon::Shader::ShaderIR;
+using VideoCommon::Shader::TransformFeedbackState;
 
 /// Generates the GLSL vertex shader program source code for the given VS program
-std::string GenerateVertexShader(const Device& device, const ShaderIR& ir, const ShaderIR* ir_b);
+std::string GenerateVertexShader(const Device& device, const ShaderIR& ir, const ShaderIR* ir_b,
+                                 const TransformFeedbackState& transform_feedback);
 
 /// Generates the GLSL geometry shader program source code for the given GS program
-std::string GenerateGeometryShader(const Device& device, const ShaderIR& ir);
+std::string GenerateGeometryShader(const Device& device, const ShaderIR& ir,
+                                   const TransformFeedbackState& transform_feedback);
 
 /// Generates the GLSL fragment shader program source code for the given FS program
 std::string GenerateFragmentShader(const Device& device, const ShaderIR& ir);
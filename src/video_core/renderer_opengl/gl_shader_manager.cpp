@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <boost/functional/hash.hpp>
+
 #include "common/common_types.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
@@ -10,23 +12,57 @@ namespace OpenGL::GLShader {
 
 using Tegra::Engines::Maxwell3D;
 
-ProgramManager::ProgramManager() {
-    pipeline.Create();
+/// Pipelines keep deleted programs alive, flush them when there are too many.
+constexpr std::size_t MAX_CACHED_PIPELINES = 4096;
+
+std::size_t ProgramManager::PipelineStateHash::operator()(const PipelineState& state) const
+    noexcept {
+    std::size_t hash = 0;
+    boost::hash_combine(hash, state.vertex_shader);
+    boost::hash_combine(hash, state.fragment_shader);
+    boost::hash_combine(hash, state.geometry_shader);
+    return hash;
 }
 
+ProgramManager::ProgramManager(bool use_assembly_programs)
+    : use_assembly_programs{use_assembly_programs} {}
+
 ProgramManager::~ProgramManager() = default;
 
 void ProgramManager::ApplyTo(OpenGLState& state) {
+    if (use_assembly_programs) {
+        // Assembly programs are bound to each stage directly, without pipeline objects
+        state.draw.shader_program = 0;
+        state.draw.program_pipeline = 0;
+        state.assembly_programs.vertex = current_state.vertex_shader;
+        state.assembly_programs.geometry = current_state.geometry_shader;
+        state.assembly_programs.fragment = current_state.fragment_shader;
+        return;
+    }
     UpdatePipeline();
     state.draw.shader_program = 0;
-    state.draw.program_pipeline = pipeline.handle;
+    state.draw.program_pipeline = current_pipeline;
 }
 
 void ProgramManager::UpdatePipeline() {
-    // Avoid updating the pipeline when values have no changed
-    if (old_state == current_state) {
+    // Avoid looking up the pipeline when values have no changed
+    if (has_pipeline && old_state == current_state) {
+        return;
+    }
+    has_pipeline = true;
+    old_state = current_state;
+
+    // Binding a cached pipeline is cheaper than changing the stages of a single one
+    if (const auto it = pipelines.find(current_state); it != pipelines.end()) {
+        current_pipeline = it->second.handle;
         return;
     }
+    if (pipelines.size() >= MAX_CACHED_PIPELINES) {
+        pipelines.clear();
+    }
+
+    OGLPipeline& pipeline = pipelines[current_state];
+    pipeline.Create();
 
     // Workaround for AMD bug
     constexpr GLenum all_used_stages{GL_VERTEX_SHADER_BIT | GL_GEOMETRY_SHADER_BIT |
@@ -37,7 +73,7 @@ void ProgramManager::UpdatePipeline() {
     glUseProgramStages(pipeline.handle, GL_GEOMETRY_SHADER_BIT, current_state.geometry_shader);
     glUseProgramStages(pipeline.handle, GL_FRAGMENT_SHADER_BIT, current_state.fragment_shader);
 
-    old_state = current_state;
+    current_pipeline = pipeline.handle;
 }
 
 void MaxwellUniformData::SetFromRegs(const Maxwell3D& maxwell) {
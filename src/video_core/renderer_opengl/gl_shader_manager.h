@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <unordered_map>
 
 #include <glad/glad.h>
 
@@ -29,7 +30,8 @@ static_assert(sizeof(MaxwellUniformData) < 16384,
 
 class ProgramManager {
 public:
-    explicit ProgramManager();
+    /// @param use_assembly_programs Whether the bound stages are NVIDIA assembly programs
+    explicit ProgramManager(bool use_assembly_programs);
     ~ProgramManager();
 
     void ApplyTo(OpenGLState& state);
@@ -70,11 +72,19 @@ private:
         GLuint geometry_shader{};
     };
 
+    struct PipelineStateHash {
+        std::size_t operator()(const PipelineState& state) const noexcept;
+    };
+
     void UpdatePipeline();
 
-    OGLPipeline pipeline;
+    /// Pipeline objects for each combination of stages seen so far
+    std::unordered_map<PipelineState, OGLPipeline, PipelineStateHash> pipelines;
+    GLuint current_pipeline{};
     PipelineState current_state;
     PipelineState old_state;
+    bool has_pipeline = false;
+    bool use_assembly_programs = false;
 };
 
 } // namespace OpenGL::GLShader
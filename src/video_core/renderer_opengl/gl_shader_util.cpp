@@ -51,4 +51,24 @@ GLuint LoadShader(const char* source, GLenum type) {
     return shader_id;
 }
 
+GLuint LoadAssemblyProgram(std::string_view source, GLenum target) {
+    GLuint program_id;
+    glGenProgramsARB(1, &program_id);
+    glNamedProgramStringEXT(program_id, target, GL_PROGRAM_FORMAT_ASCII_ARB,
+                            static_cast<GLsizei>(source.size()), source.data());
+
+    GLint error_position = -1;
+    glGetIntegerv(GL_PROGRAM_ERROR_POSITION_ARB, &error_position);
+    const auto error_string = glGetString(GL_PROGRAM_ERROR_STRING_ARB);
+    const std::string_view error_text =
+        error_string ? reinterpret_cast<const char*>(error_string) : "";
+    if (error_position != -1) {
+        LOG_ERROR(Render_OpenGL, "Error compiling assembly program at position {}:\n{}\n{}",
+                  error_position, error_text, source);
+    } else if (!error_text.empty()) {
+        LOG_DEBUG(Render_OpenGL, "{}", error_text);
+    }
+    return program_id;
+}
+
 } // namespace OpenGL::GLShader
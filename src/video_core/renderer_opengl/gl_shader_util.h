@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <glad/glad.h>
 #include "common/assert.h"
@@ -40,6 +41,14 @@ void LogShaderSource(T... shaders) {
  */
 GLuint LoadShader(const char* source, GLenum type);
 
+/**
+ * Utility function to create and compile an NVIDIA assembly program
+ * @param source String of the assembly program
+ * @param target Target of the program (GL_VERTEX_PROGRAM_NV, GL_GEOMETRY_PROGRAM_NV or
+ *               GL_FRAGMENT_PROGRAM_NV)
+ */
+GLuint LoadAssemblyProgram(std::string_view source, GLenum target);
+
 /**
  * Utility function to create and compile an OpenGL GLSL shader program (vertex + fragment shader)
  * @param separable_program whether to create a separable program
@@ -0,0 +1,106 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+
+#include "common/scope_exit.h"
+#include "common/thread.h"
+#include "core/frontend/emu_window.h"
+#include "video_core/renderer_opengl/gl_shader_worker.h"
+
+namespace OpenGL {
+
+ShaderWorker::Build::Build(std::string source, GLenum shader_type)
+    : source{std::move(source)}, shader_type{shader_type} {}
+
+ShaderWorker::Build::~Build() {
+    if (fence) {
+        glDeleteSync(fence);
+    }
+}
+
+bool ShaderWorker::Build::IsReady() {
+    if (!is_built.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (fence) {
+        // Linking is only guaranteed to be visible to other contexts once its commands completed
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    return true;
+}
+
+ShaderWorker::ShaderWorker(Core::Frontend::EmuWindow& emu_window, std::size_t num_workers) {
+    // On some platforms the shared context has to be created from the GUI thread
+    contexts.reserve(num_workers);
+    threads.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        auto& context = contexts.emplace_back(emu_window.CreateSharedContext());
+        threads.emplace_back([this, &context = *context] {
+            Common::SetCurrentThreadName("yuzu:ShaderWorker");
+            WorkerLoop(context);
+        });
+    }
+}
+
+ShaderWorker::~ShaderWorker() {
+    {
+        std::lock_guard lock{queue_mutex};
+        stop = true;
+    }
+    condition.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::shared_ptr<ShaderWorker::Build> ShaderWorker::QueueBuild(std::string source,
+                                                              GLenum shader_type) {
+    auto build = std::make_shared<Build>(std::move(source), shader_type);
+    {
+        std::lock_guard lock{queue_mutex};
+        queue.push_back(build);
+    }
+    condition.notify_one();
+    return build;
+}
+
+void ShaderWorker::WorkerLoop(Core::Frontend::GraphicsContext& context) {
+    context.MakeCurrent();
+    SCOPE_EXIT({ context.DoneCurrent(); });
+
+    while (true) {
+        std::shared_ptr<Build> build;
+        {
+            std::unique_lock lock{queue_mutex};
+            condition.wait(lock, [this] { return stop || !queue.empty(); });
+            if (stop) {
+                return;
+            }
+            build = std::move(queue.front());
+            queue.pop_front();
+        }
+        if (build.use_count() == 1) {
+            // Nobody is waiting for this program anymore
+            continue;
+        }
+
+        OGLShader shader;
+        shader.Create(build->source.c_str(), build->shader_type);
+
+        auto program = std::make_shared<OGLProgram>();
+        program->Create(true, false, shader.handle);
+
+        build->program = std::move(program);
+        build->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        build->is_built.store(true, std::memory_order_release);
+    }
+}
+
+} // namespace OpenGL
@@ -0,0 +1,78 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace Core::Frontend {
+class EmuWindow;
+class GraphicsContext;
+} // namespace Core::Frontend
+
+namespace OpenGL {
+
+/// Compiles and links separable programs on background threads with shared contexts.
+class ShaderWorker final {
+public:
+    /// Program being built in the background.
+    class Build final {
+    public:
+        explicit Build(std::string source, GLenum shader_type);
+        ~Build();
+
+        Build(const Build&) = delete;
+        Build& operator=(const Build&) = delete;
+
+        /// Returns true when the program has been linked and is visible to the calling context.
+        /// Must be called from a thread with a context current.
+        bool IsReady();
+
+        /// Takes the linked program, only valid once IsReady returns true.
+        std::shared_ptr<OGLProgram> TakeProgram() {
+            return std::move(program);
+        }
+
+    private:
+        friend class ShaderWorker;
+
+        std::string source;
+        GLenum shader_type;
+
+        std::shared_ptr<OGLProgram> program;
+        GLsync fence = nullptr;
+        std::atomic_bool is_built{false};
+    };
+
+    explicit ShaderWorker(Core::Frontend::EmuWindow& emu_window, std::size_t num_workers);
+    ~ShaderWorker();
+
+    /// Queues a program made of a single shader stage to be built in the background.
+    std::shared_ptr<Build> QueueBuild(std::string source, GLenum shader_type);
+
+private:
+    void WorkerLoop(Core::Frontend::GraphicsContext& context);
+
+    std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts;
+    std::vector<std::thread> threads;
+
+    std::deque<std::shared_ptr<Build>> queue;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop = false;
+};
+
+} // namespace OpenGL
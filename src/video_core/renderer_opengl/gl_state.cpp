@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <utility>
 #include <glad/glad.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -20,6 +21,9 @@ OpenGLState OpenGLState::cur_state;
 
 namespace {
 
+// GL calls issued by the state tracker since the counter was last reset
+u64 num_gl_calls = 0;
+
 template <typename T>
 bool UpdateValue(T& current_value, const T new_value) {
     const bool changed = current_value != new_value;
@@ -55,16 +59,20 @@ std::optional<std::pair<GLuint, GLsizei>> UpdateArray(T& current_values, const T
 
 void Enable(GLenum cap, bool enable) {
     if (enable) {
+        ++num_gl_calls;
         glEnable(cap);
     } else {
+        ++num_gl_calls;
         glDisable(cap);
     }
 }
 
 void Enable(GLenum cap, GLuint index, bool enable) {
     if (enable) {
+        ++num_gl_calls;
         glEnablei(cap, index);
     } else {
+        ++num_gl_calls;
         glDisablei(cap, index);
     }
 }
@@ -85,6 +93,10 @@ void Enable(GLenum cap, GLuint index, bool& current_value, bool new_value) {
 
 OpenGLState::OpenGLState() = default;
 
+u64 OpenGLState::ResetCallCount() {
+    return std::exchange(num_gl_calls, 0);
+}
+
 void OpenGLState::SetDefaultViewports() {
     viewports.fill(Viewport{});
 
@@ -94,31 +106,58 @@ void OpenGLState::SetDefaultViewports() {
 
 void OpenGLState::ApplyFramebufferState() {
     if (UpdateValue(cur_state.draw.read_framebuffer, draw.read_framebuffer)) {
+        ++num_gl_calls;
         glBindFramebuffer(GL_READ_FRAMEBUFFER, draw.read_framebuffer);
     }
     if (UpdateValue(cur_state.draw.draw_framebuffer, draw.draw_framebuffer)) {
+        ++num_gl_calls;
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw.draw_framebuffer);
     }
 }
 
 void OpenGLState::ApplyVertexArrayState() {
     if (UpdateValue(cur_state.draw.vertex_array, draw.vertex_array)) {
+        ++num_gl_calls;
         glBindVertexArray(draw.vertex_array);
     }
 }
 
 void OpenGLState::ApplyShaderProgram() {
     if (UpdateValue(cur_state.draw.shader_program, draw.shader_program)) {
+        ++num_gl_calls;
         glUseProgram(draw.shader_program);
     }
 }
 
 void OpenGLState::ApplyProgramPipeline() {
     if (UpdateValue(cur_state.draw.program_pipeline, draw.program_pipeline)) {
+        ++num_gl_calls;
         glBindProgramPipeline(draw.program_pipeline);
     }
 }
 
+void OpenGLState::ApplyAssemblyPrograms() {
+    const auto apply = [](GLenum target, GLuint& current, GLuint program) {
+        if (current == program) {
+            return;
+        }
+        // Assembly programs are enabled per stage, the stage is left disabled to use GLSL
+        if ((current == 0) != (program == 0)) {
+            Enable(target, program != 0);
+        }
+        if (program != 0) {
+            ++num_gl_calls;
+            glBindProgramARB(target, program);
+        }
+        current = program;
+    };
+    apply(GL_VERTEX_PROGRAM_NV, cur_state.assembly_programs.vertex, assembly_programs.vertex);
+    apply(GL_GEOMETRY_PROGRAM_NV, cur_state.assembly_programs.geometry,
+          assembly_programs.geometry);
+    apply(GL_FRAGMENT_PROGRAM_NV, cur_state.assembly_programs.fragment,
+          assembly_programs.fragment);
+}
+
 void OpenGLState::ApplyClipDistances() {
     for (std::size_t i = 0; i < clip_distance.size(); ++i) {
         Enable(GL_CLIP_DISTANCE0 + static_cast<GLenum>(i), cur_state.clip_distance[i],
@@ -129,12 +168,14 @@ void OpenGLState::ApplyClipDistances() {
 void OpenGLState::ApplyPointSize() {
     Enable(GL_PROGRAM_POINT_SIZE, cur_state.point.program_control, point.program_control);
     if (UpdateValue(cur_state.point.size, point.size)) {
+        ++num_gl_calls;
         glPointSize(point.size);
     }
 }
 
 void OpenGLState::ApplyFragmentColorClamp() {
     if (UpdateValue(cur_state.fragment_color_clamp.enabled, fragment_color_clamp.enabled)) {
+        ++num_gl_calls;
         glClampColor(GL_CLAMP_FRAGMENT_COLOR_ARB,
                      fragment_color_clamp.enabled ? GL_TRUE : GL_FALSE);
     }
@@ -165,8 +206,10 @@ void OpenGLState::ApplySRgb() {
         return;
     cur_state.framebuffer_srgb.enabled = framebuffer_srgb.enabled;
     if (framebuffer_srgb.enabled) {
+        ++num_gl_calls;
         glEnable(GL_FRAMEBUFFER_SRGB);
     } else {
+        ++num_gl_calls;
         glDisable(GL_FRAMEBUFFER_SRGB);
     }
 }
@@ -175,10 +218,12 @@ void OpenGLState::ApplyCulling() {
     Enable(GL_CULL_FACE, cur_state.cull.enabled, cull.enabled);
 
     if (UpdateValue(cur_state.cull.mode, cull.mode)) {
+        ++num_gl_calls;
         glCullFace(cull.mode);
     }
 
     if (UpdateValue(cur_state.cull.front_face, cull.front_face)) {
+        ++num_gl_calls;
         glFrontFace(cull.front_face);
     }
 }
@@ -201,6 +246,7 @@ void OpenGLState::ApplyColorMask() {
             updated.blue_enabled != current.blue_enabled ||
             updated.alpha_enabled != current.alpha_enabled) {
             current = updated;
+            ++num_gl_calls;
             glColorMaski(static_cast<GLuint>(i), updated.red_enabled, updated.green_enabled,
                          updated.blue_enabled, updated.alpha_enabled);
         }
@@ -212,11 +258,13 @@ void OpenGLState::ApplyDepth() {
 
     if (cur_state.depth.test_func != depth.test_func) {
         cur_state.depth.test_func = depth.test_func;
+        ++num_gl_calls;
         glDepthFunc(depth.test_func);
     }
 
     if (cur_state.depth.write_mask != depth.write_mask) {
         cur_state.depth.write_mask = depth.write_mask;
+        ++num_gl_calls;
         glDepthMask(depth.write_mask);
     }
 }
@@ -226,6 +274,7 @@ void OpenGLState::ApplyPrimitiveRestart() {
 
     if (cur_state.primitive_restart.index != primitive_restart.index) {
         cur_state.primitive_restart.index = primitive_restart.index;
+        ++num_gl_calls;
         glPrimitiveRestartIndex(primitive_restart.index);
     }
 }
@@ -244,6 +293,7 @@ void OpenGLState::ApplyStencilTest() {
             current.test_func = config.test_func;
             current.test_ref = config.test_ref;
             current.test_mask = config.test_mask;
+            ++num_gl_calls;
             glStencilFuncSeparate(face, config.test_func, config.test_ref, config.test_mask);
         }
         if (current.action_depth_fail != config.action_depth_fail ||
@@ -252,11 +302,13 @@ void OpenGLState::ApplyStencilTest() {
             current.action_depth_fail = config.action_depth_fail;
             current.action_depth_pass = config.action_depth_pass;
             current.action_stencil_fail = config.action_stencil_fail;
+            ++num_gl_calls;
             glStencilOpSeparate(face, config.action_stencil_fail, config.action_depth_fail,
                                 config.action_depth_pass);
         }
         if (current.write_mask != config.write_mask) {
             current.write_mask = config.write_mask;
+            ++num_gl_calls;
             glStencilMaskSeparate(face, config.write_mask);
         }
     };
@@ -265,6 +317,11 @@ void OpenGLState::ApplyStencilTest() {
 }
 
 void OpenGLState::ApplyViewport() {
+    if (!dirty.viewport_state) {
+        return;
+    }
+    dirty.viewport_state = false;
+
     for (GLuint i = 0; i < static_cast<GLuint>(Maxwell::NumViewports); ++i) {
         const auto& updated = viewports[i];
         auto& current = cur_state.viewports[i];
@@ -275,6 +332,7 @@ void OpenGLState::ApplyViewport() {
             current.y = updated.y;
             current.width = updated.width;
             current.height = updated.height;
+            ++num_gl_calls;
             glViewportIndexedf(i, static_cast<GLfloat>(updated.x), static_cast<GLfloat>(updated.y),
                                static_cast<GLfloat>(updated.width),
                                static_cast<GLfloat>(updated.height));
@@ -283,6 +341,7 @@ void OpenGLState::ApplyViewport() {
             current.depth_range_far != updated.depth_range_far) {
             current.depth_range_near = updated.depth_range_near;
             current.depth_range_far = updated.depth_range_far;
+            ++num_gl_calls;
             glDepthRangeIndexed(i, updated.depth_range_near, updated.depth_range_far);
         }
 
@@ -295,6 +354,7 @@ void OpenGLState::ApplyViewport() {
             current.scissor.y = updated.scissor.y;
             current.scissor.width = updated.scissor.width;
             current.scissor.height = updated.scissor.height;
+            ++num_gl_calls;
             glScissorIndexed(i, updated.scissor.x, updated.scissor.y, updated.scissor.width,
                              updated.scissor.height);
         }
@@ -314,6 +374,7 @@ void OpenGLState::ApplyGlobalBlending() {
         current.dst_rgb_func = updated.dst_rgb_func;
         current.src_a_func = updated.src_a_func;
         current.dst_a_func = updated.dst_a_func;
+        ++num_gl_calls;
         glBlendFuncSeparate(updated.src_rgb_func, updated.dst_rgb_func, updated.src_a_func,
                             updated.dst_a_func);
     }
@@ -321,6 +382,7 @@ void OpenGLState::ApplyGlobalBlending() {
     if (current.rgb_equation != updated.rgb_equation || current.a_equation != updated.a_equation) {
         current.rgb_equation = updated.rgb_equation;
         current.a_equation = updated.a_equation;
+        ++num_gl_calls;
         glBlendEquationSeparate(updated.rgb_equation, updated.a_equation);
     }
 }
@@ -338,12 +400,14 @@ void OpenGLState::ApplyTargetBlending(std::size_t target, bool force) {
                            current.dst_a_func),
                   std::tie(updated.src_rgb_func, updated.dst_rgb_func, updated.src_a_func,
                            updated.dst_a_func))) {
+        ++num_gl_calls;
         glBlendFuncSeparatei(static_cast<GLuint>(target), updated.src_rgb_func,
                              updated.dst_rgb_func, updated.src_a_func, updated.dst_a_func);
     }
 
     if (UpdateTie(std::tie(current.rgb_equation, current.a_equation),
                   std::tie(updated.rgb_equation, updated.a_equation))) {
+        ++num_gl_calls;
         glBlendEquationSeparatei(static_cast<GLuint>(target), updated.rgb_equation,
                                  updated.a_equation);
     }
@@ -369,6 +433,7 @@ void OpenGLState::ApplyBlending() {
             std::tie(cur_state.blend_color.red, cur_state.blend_color.green,
                      cur_state.blend_color.blue, cur_state.blend_color.alpha),
             std::tie(blend_color.red, blend_color.green, blend_color.blue, blend_color.alpha))) {
+        ++num_gl_calls;
         glBlendColor(blend_color.red, blend_color.green, blend_color.blue, blend_color.alpha);
     }
 }
@@ -377,6 +442,7 @@ void OpenGLState::ApplyLogicOp() {
     Enable(GL_COLOR_LOGIC_OP, cur_state.logic_op.enabled, logic_op.enabled);
 
     if (UpdateValue(cur_state.logic_op.operation, logic_op.operation)) {
+        ++num_gl_calls;
         glLogicOp(logic_op.operation);
     }
 }
@@ -398,10 +464,12 @@ void OpenGLState::ApplyPolygonOffset() {
                            cur_state.polygon_offset.clamp),
                   std::tie(polygon_offset.factor, polygon_offset.units, polygon_offset.clamp))) {
         if (GLAD_GL_EXT_polygon_offset_clamp && polygon_offset.clamp != 0) {
+            ++num_gl_calls;
             glPolygonOffsetClamp(polygon_offset.factor, polygon_offset.units, polygon_offset.clamp);
         } else {
             UNIMPLEMENTED_IF_MSG(polygon_offset.clamp != 0,
                                  "Unimplemented Depth polygon offset clamp.");
+            ++num_gl_calls;
             glPolygonOffset(polygon_offset.factor, polygon_offset.units);
         }
     }
@@ -411,6 +479,7 @@ void OpenGLState::ApplyAlphaTest() {
     Enable(GL_ALPHA_TEST, cur_state.alpha_test.enabled, alpha_test.enabled);
     if (UpdateTie(std::tie(cur_state.alpha_test.func, cur_state.alpha_test.ref),
                   std::tie(alpha_test.func, alpha_test.ref))) {
+        ++num_gl_calls;
         glAlphaFunc(alpha_test.func, alpha_test.ref);
     }
 }
@@ -418,6 +487,7 @@ void OpenGLState::ApplyAlphaTest() {
 void OpenGLState::ApplyClipControl() {
     if (UpdateTie(std::tie(cur_state.clip_control.origin, cur_state.clip_control.depth_mode),
                   std::tie(clip_control.origin, clip_control.depth_mode))) {
+        ++num_gl_calls;
         glClipControl(clip_control.origin, clip_control.depth_mode);
     }
 }
@@ -429,6 +499,7 @@ void OpenGLState::ApplyTextures() {
             // BindTextureUnit doesn't support binding null textures, skip those binds.
             // TODO(Rodrigo): Stop using null textures
             if (textures[i] != 0) {
+                ++num_gl_calls;
                 glBindTextureUnit(static_cast<GLuint>(i), textures[i]);
             }
         }
@@ -439,6 +510,7 @@ void OpenGLState::ApplySamplers() {
     const std::size_t size = std::size(samplers);
     for (std::size_t i = 0; i < size; ++i) {
         if (UpdateValue(cur_state.samplers[i], samplers[i])) {
+            ++num_gl_calls;
             glBindSampler(static_cast<GLuint>(i), samplers[i]);
         }
     }
@@ -446,6 +518,7 @@ void OpenGLState::ApplySamplers() {
 
 void OpenGLState::ApplyImages() {
     if (const auto update = UpdateArray(cur_state.images, images)) {
+        ++num_gl_calls;
         glBindImageTextures(update->first, update->second, images.data() + update->first);
     }
 }
@@ -456,6 +529,7 @@ void OpenGLState::Apply() {
     ApplyVertexArrayState();
     ApplyShaderProgram();
     ApplyProgramPipeline();
+    ApplyAssemblyPrograms();
     ApplyClipDistances();
     ApplyPointSize();
     ApplyFragmentColorClamp();
@@ -533,6 +607,19 @@ OpenGLState& OpenGLState::ResetPipeline(GLuint handle) {
     return *this;
 }
 
+OpenGLState& OpenGLState::ResetAssemblyProgram(GLuint handle) {
+    if (assembly_programs.vertex == handle) {
+        assembly_programs.vertex = 0;
+    }
+    if (assembly_programs.geometry == handle) {
+        assembly_programs.geometry = 0;
+    }
+    if (assembly_programs.fragment == handle) {
+        assembly_programs.fragment = 0;
+    }
+    return *this;
+}
+
 OpenGLState& OpenGLState::ResetVertexArray(GLuint handle) {
     if (draw.vertex_array == handle) {
         draw.vertex_array = 0;
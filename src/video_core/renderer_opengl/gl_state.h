@@ -7,6 +7,7 @@
 #include <array>
 #include <type_traits>
 #include <glad/glad.h>
+#include "common/common_types.h"
 #include "video_core/engines/maxwell_3d.h"
 
 namespace OpenGL {
@@ -113,6 +114,12 @@ public:
         GLuint program_pipeline = 0; // GL_PROGRAM_PIPELINE_BINDING
     } draw;
 
+    struct {
+        GLuint vertex = 0;   // GL_VERTEX_PROGRAM_NV
+        GLuint geometry = 0; // GL_GEOMETRY_PROGRAM_NV
+        GLuint fragment = 0; // GL_FRAGMENT_PROGRAM_NV
+    } assembly_programs;
+
     struct Viewport {
         GLint x = 0;
         GLint y = 0;
@@ -172,6 +179,7 @@ public:
     void ApplyVertexArrayState();
     void ApplyShaderProgram();
     void ApplyProgramPipeline();
+    void ApplyAssemblyPrograms();
     void ApplyClipDistances();
     void ApplyPointSize();
     void ApplyFragmentColorClamp();
@@ -201,9 +209,13 @@ public:
     OpenGLState& ResetSampler(GLuint handle);
     OpenGLState& ResetProgram(GLuint handle);
     OpenGLState& ResetPipeline(GLuint handle);
+    OpenGLState& ResetAssemblyProgram(GLuint handle);
     OpenGLState& ResetVertexArray(GLuint handle);
     OpenGLState& ResetFramebuffer(GLuint handle);
 
+    /// Returns the number of GL calls issued by the state tracker and resets the counter
+    static u64 ResetCallCount();
+
     /// Viewport does not affects glClearBuffer so emulate viewport using scissor test
     void EmulateViewportWithScissor();
 
@@ -223,9 +235,14 @@ public:
         dirty.color_mask = true;
     }
 
+    void MarkDirtyViewportState() {
+        dirty.viewport_state = true;
+    }
+
     void AllDirty() {
         dirty.blend_state = true;
         dirty.stencil_state = true;
+        dirty.viewport_state = true;
         dirty.polygon_offset = true;
         dirty.color_mask = true;
     }
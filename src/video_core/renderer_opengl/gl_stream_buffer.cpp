@@ -2,10 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <deque>
 #include <vector>
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/gl_stream_buffer.h"
@@ -15,12 +17,32 @@ MICROPROFILE_DEFINE(OpenGL_StreamBuffer, "OpenGL", "Stream Buffer Orphaning",
 
 namespace OpenGL {
 
+constexpr GLsizeiptr MAX_STREAM_BUFFER_SIZE = 512 * 1024 * 1024;
+
 OGLStreamBuffer::OGLStreamBuffer(GLsizeiptr size, bool vertex_data_usage, bool prefer_coherent,
                                  bool use_persistent)
-    : buffer_size(size) {
+    : vertex_data_usage{vertex_data_usage}, coherent{use_persistent && prefer_coherent},
+      persistent{use_persistent}, buffer_size(size) {
+    CreateBuffer();
+    if (persistent) {
+        const GLbitfield flags =
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | (coherent ? GL_MAP_COHERENT_BIT : 0);
+        mapped_ptr = static_cast<u8*>(glMapNamedBufferRange(
+            gl_buffer.handle, 0, buffer_size, flags | (coherent ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT)));
+    }
+}
+
+OGLStreamBuffer::~OGLStreamBuffer() {
+    if (persistent) {
+        glUnmapNamedBuffer(gl_buffer.handle);
+    }
+    gl_buffer.Release();
+}
+
+void OGLStreamBuffer::CreateBuffer() {
     gl_buffer.Create();
 
-    GLsizeiptr allocate_size = size;
+    GLsizeiptr allocate_size = buffer_size;
     if (vertex_data_usage) {
         // On AMD GPU there is a strange crash in indexed drawing. The crash happens when the buffer
         // read position is near the end and is an out-of-bound access to the vertex buffer. This is
@@ -30,24 +52,38 @@ OGLStreamBuffer::OGLStreamBuffer(GLsizeiptr size, bool vertex_data_usage, bool p
         allocate_size *= 2;
     }
 
-    if (use_persistent) {
-        persistent = true;
-        coherent = prefer_coherent;
+    if (persistent) {
         const GLbitfield flags =
             GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | (coherent ? GL_MAP_COHERENT_BIT : 0);
         glNamedBufferStorage(gl_buffer.handle, allocate_size, nullptr, flags);
-        mapped_ptr = static_cast<u8*>(glMapNamedBufferRange(
-            gl_buffer.handle, 0, buffer_size, flags | (coherent ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT)));
     } else {
         glNamedBufferData(gl_buffer.handle, allocate_size, nullptr, GL_STREAM_DRAW);
     }
 }
 
-OGLStreamBuffer::~OGLStreamBuffer() {
-    if (persistent) {
-        glUnmapNamedBuffer(gl_buffer.handle);
+bool OGLStreamBuffer::ShouldGrow(GLsizeiptr size) const {
+    if (buffer_size >= MAX_STREAM_BUFFER_SIZE) {
+        return false;
     }
+    // When a single frame fills more than half of the buffer, the driver has to synchronize with
+    // frames in flight to orphan it.
+    return frame_usage + size > buffer_size / 2;
+}
+
+void OGLStreamBuffer::Grow(GLsizeiptr size) {
+    const GLsizeiptr wanted_size = std::max(high_water_mark, frame_usage + size) * 2;
+    GLsizeiptr new_size = buffer_size;
+    while (new_size < wanted_size && new_size < MAX_STREAM_BUFFER_SIZE) {
+        new_size *= 2;
+    }
+    new_size = std::min(new_size, MAX_STREAM_BUFFER_SIZE);
+    LOG_INFO(Render_OpenGL, "Growing stream buffer from {} MiB to {} MiB, {} MiB used this frame",
+             buffer_size >> 20, new_size >> 20, (frame_usage + size) >> 20);
+
+    // Buffer objects are kept alive by the driver while they are in use
     gl_buffer.Release();
+    buffer_size = new_size;
+    CreateBuffer();
 }
 
 GLuint OGLStreamBuffer::GetHandle() const {
@@ -59,7 +95,7 @@ GLsizeiptr OGLStreamBuffer::GetSize() const {
 }
 
 std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr alignment) {
-    ASSERT(size <= buffer_size);
+    ASSERT(size <= MAX_STREAM_BUFFER_SIZE);
     ASSERT(alignment <= buffer_size);
     mapped_size = size;
 
@@ -75,6 +111,9 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
         if (persistent) {
             glUnmapNamedBuffer(gl_buffer.handle);
         }
+        if (ShouldGrow(size)) {
+            Grow(size);
+        }
     }
 
     if (invalidate || !persistent) {
@@ -102,6 +141,12 @@ void OGLStreamBuffer::Unmap(GLsizeiptr size) {
     }
 
     buffer_pos += size;
+    frame_usage += size;
+}
+
+void OGLStreamBuffer::TickFrame() {
+    high_water_mark = std::max(high_water_mark, frame_usage);
+    frame_usage = 0;
 }
 
 } // namespace OpenGL
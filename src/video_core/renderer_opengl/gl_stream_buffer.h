@@ -23,7 +23,9 @@ public:
     /*
      * Allocates a linear chunk of memory in the GPU buffer with at least "size" bytes
      * and the optional alignment requirement.
-     * If the buffer is full, the whole buffer is reallocated which invalidates old chunks.
+     * If the buffer is full, the whole buffer is reallocated which invalidates old chunks. When
+     * a single frame fills most of the buffer, it's replaced with a larger one and the handle
+     * changes.
      * The return values are the pointer to the new chunk, the offset within the buffer,
      * and the invalidation flag for previous chunks.
      * The actual used size must be specified on unmapping the chunk.
@@ -32,9 +34,22 @@ public:
 
     void Unmap(GLsizeiptr size);
 
+    /// Marks the end of a frame, updating usage statistics.
+    void TickFrame();
+
 private:
+    /// Creates the buffer object and its storage.
+    void CreateBuffer();
+
+    /// Returns true when the buffer should grow instead of wrapping around.
+    bool ShouldGrow(GLsizeiptr size) const;
+
+    /// Replaces the buffer with a larger one.
+    void Grow(GLsizeiptr size);
+
     OGLBuffer gl_buffer;
 
+    bool vertex_data_usage = false;
     bool coherent = false;
     bool persistent = false;
 
@@ -43,6 +58,9 @@ private:
     GLintptr mapped_offset = 0;
     GLsizeiptr mapped_size = 0;
     u8* mapped_ptr = nullptr;
+
+    GLsizeiptr frame_usage = 0;     ///< Bytes used in the current frame.
+    GLsizeiptr high_water_mark = 0; ///< Highest number of bytes used in a single frame.
 };
 
 } // namespace OpenGL
@@ -2,6 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <string>
+
+#include <fmt/format.h>
+
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "common/common_types.h"
@@ -133,6 +138,87 @@ const FormatTuple& GetFormatTuple(PixelFormat pixel_format) {
     return format;
 }
 
+/// Integer formats the deswizzling shader writes through, indexed by log2 of the bytes per pixel.
+constexpr std::array<GLenum, 5> unswizzle_view_formats = {GL_R8UI, GL_R16UI, GL_R32UI, GL_RG32UI,
+                                                          GL_RGBA32UI};
+constexpr std::array<const char*, 5> unswizzle_image_formats = {"r8ui", "r16ui", "r32ui", "rg32ui",
+                                                                "rgba32ui"};
+
+constexpr const char unswizzle_shader_source[] = R"(
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (std430, binding = 0) readonly buffer SwizzledData {
+    uint swizzled_data[];
+};
+
+layout (binding = 0, IMAGE_FORMAT) uniform writeonly uimage2D output_image;
+
+layout (location = 0) uniform uint level_offset;
+layout (location = 1) uniform uint gobs_per_row;
+layout (location = 2) uniform uint block_height;
+layout (location = 3) uniform uint block_depth;
+layout (location = 4) uniform uvec2 size;
+
+uint GetSwizzledOffset(uvec2 pos) {
+    const uint x = pos.x << BYTES_PER_PIXEL_LOG2;
+    const uint block_index = (pos.y >> (3 + block_height)) * gobs_per_row + (x >> 6);
+    const uint block_offset = block_index << (9 + block_height + block_depth);
+    const uint gob_offset = ((pos.y >> 3) & ((1u << block_height) - 1u)) << 9;
+    const uint gob_x = x & 63u;
+    const uint gob_y = pos.y & 7u;
+    return level_offset + block_offset + gob_offset + (gob_x >> 5) * 256u + (gob_y >> 1) * 64u +
+           ((gob_x & 31u) >> 4) * 32u + (gob_y & 1u) * 16u + (gob_x & 15u);
+}
+
+void main() {
+    const uvec2 pos = gl_GlobalInvocationID.xy;
+    if (any(greaterThanEqual(pos, size))) {
+        return;
+    }
+    const uint offset = GetSwizzledOffset(pos);
+    const uint word = offset >> 2;
+#if BYTES_PER_PIXEL_LOG2 == 0
+    const uvec4 texel = uvec4(bitfieldExtract(swizzled_data[word], int(offset & 3u) * 8, 8));
+#elif BYTES_PER_PIXEL_LOG2 == 1
+    const uvec4 texel = uvec4(bitfieldExtract(swizzled_data[word], int(offset & 2u) * 8, 16));
+#elif BYTES_PER_PIXEL_LOG2 == 2
+    const uvec4 texel = uvec4(swizzled_data[word]);
+#elif BYTES_PER_PIXEL_LOG2 == 3
+    const uvec4 texel = uvec4(swizzled_data[word], swizzled_data[word + 1], 0, 0);
+#else
+    const uvec4 texel = uvec4(swizzled_data[word], swizzled_data[word + 1],
+                              swizzled_data[word + 2], swizzled_data[word + 3]);
+#endif
+    imageStore(output_image, ivec2(pos), texel);
+}
+)";
+
+/// Returns true when uploading the format stores the guest bytes as they are, so they can be
+/// written through an integer view of the texture instead.
+bool IsRawUploadFormat(const FormatTuple& tuple) {
+    if (tuple.compressed || tuple.format == GL_BGRA) {
+        return false;
+    }
+    switch (tuple.type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_HALF_FLOAT:
+    case GL_FLOAT:
+    case GL_UNSIGNED_INT_8_8_8_8_REV:
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_5_9_9_9_REV:
+        return true;
+    default:
+        // Packed 16-bit formats can't be aliased by texture views
+        return false;
+    }
+}
+
 GLenum GetTextureTarget(const SurfaceTarget& target) {
     switch (target) {
     case SurfaceTarget::TextureBuffer:
@@ -284,6 +370,41 @@ void CachedSurface::UploadTexture(const std::vector<u8>& staging_buffer) {
     }
 }
 
+void CachedSurface::UploadBand(const std::vector<u8>& staging_buffer,
+                               const VideoCommon::SurfaceBand& band) {
+    MICROPROFILE_SCOPE(OpenGL_Texture_Upload);
+    if (band.level >= params.emulated_levels) {
+        return;
+    }
+    SCOPE_EXIT({ glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); });
+    glPixelStorei(GL_UNPACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(band.level)));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(params.GetMipWidth(band.level)));
+
+    const GLint level = static_cast<GLint>(band.level);
+    const GLint y = static_cast<GLint>(band.y);
+    const GLint layer = static_cast<GLint>(band.layer);
+    const auto width = static_cast<GLsizei>(params.GetMipWidth(band.level));
+    const auto height = static_cast<GLsizei>(band.height);
+    const u8* const buffer = staging_buffer.data();
+    if (is_compressed) {
+        const auto image_size = static_cast<GLsizei>(band.host_size);
+        if (params.target == SurfaceTarget::Texture2D) {
+            glCompressedTextureSubImage2D(texture.handle, level, 0, y, width, height,
+                                          internal_format, image_size, buffer);
+        } else {
+            glCompressedTextureSubImage3D(texture.handle, level, 0, y, layer, width, height, 1,
+                                          internal_format, image_size, buffer);
+        }
+    } else {
+        if (params.target == SurfaceTarget::Texture2D) {
+            glTextureSubImage2D(texture.handle, level, 0, y, width, height, format, type, buffer);
+        } else {
+            glTextureSubImage3D(texture.handle, level, 0, y, layer, width, height, 1, format, type,
+                                buffer);
+        }
+    }
+}
+
 void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& staging_buffer) {
     glPixelStorei(GL_UNPACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level)));
     glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(params.GetMipWidth(level)));
@@ -468,6 +589,20 @@ TextureCacheOpenGL::TextureCacheOpenGL(Core::System& system,
     : TextureCacheBase{system, rasterizer} {
     src_framebuffer.Create();
     dst_framebuffer.Create();
+
+    has_swizzled_upload = !device.HasBrokenCompute();
+    if (!has_swizzled_upload) {
+        return;
+    }
+    for (std::size_t i = 0; i < unswizzle_programs.size(); ++i) {
+        const std::string source = fmt::format(
+            "#version 430 core\n#define BYTES_PER_PIXEL_LOG2 {}\n#define IMAGE_FORMAT {}\n{}", i,
+            unswizzle_image_formats[i], unswizzle_shader_source);
+        OGLShader shader;
+        shader.Create(source.c_str(), GL_COMPUTE_SHADER);
+        unswizzle_programs[i].Create(false, false, shader.handle);
+    }
+    unswizzle_buffer.Create();
 }
 
 TextureCacheOpenGL::~TextureCacheOpenGL() = default;
@@ -626,6 +761,75 @@ void TextureCacheOpenGL::BufferCopy(Surface& src_surface, Surface& dst_surface)
     glTextureBarrier();
 }
 
+bool TextureCacheOpenGL::CanUploadSwizzled(const SurfaceParams& params) const {
+    if (!has_swizzled_upload || !params.is_tiled || params.block_width != 0 ||
+        params.target != SurfaceTarget::Texture2D || params.type != SurfaceType::ColorTexture ||
+        params.GetCompressionType() != SurfaceCompression::None ||
+        VideoCore::Surface::IsPixelFormatSRGB(params.pixel_format)) {
+        return false;
+    }
+    const u32 bpp = params.GetBytesPerPixel();
+    return (bpp & (bpp - 1)) == 0 && bpp <= 16 &&
+           IsRawUploadFormat(GetFormatTuple(params.pixel_format));
+}
+
+void TextureCacheOpenGL::UploadSwizzled(const Surface& surface, const u8* guest_data) {
+    MICROPROFILE_SCOPE(OpenGL_Texture_Upload);
+    const auto& params = surface->GetSurfaceParams();
+    const u32 bpp = params.GetBytesPerPixel();
+    const u32 bpp_log2 = Common::CountTrailingZeroes32(bpp);
+    const GLuint program = unswizzle_programs[bpp_log2].handle;
+
+    glNamedBufferData(unswizzle_buffer.handle, static_cast<GLsizeiptr>(surface->GetSizeInBytes()),
+                      guest_data, GL_STREAM_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, unswizzle_buffer.handle);
+
+    OpenGLState prev_state{OpenGLState::GetCurState()};
+    SCOPE_EXIT({
+        prev_state.ApplyImages();
+        prev_state.ApplyShaderProgram();
+        prev_state.ApplyProgramPipeline();
+    });
+
+    OpenGLState state{prev_state};
+    state.draw.shader_program = program;
+    state.draw.program_pipeline = 0;
+    state.ApplyShaderProgram();
+    state.ApplyProgramPipeline();
+
+    const u32 gob_elements_x = 64 / bpp;
+    for (u32 level = 0; level < params.emulated_levels; ++level) {
+        const u32 width = params.GetMipWidth(level);
+        const u32 height = params.GetMipHeight(level);
+        const u32 aligned_width =
+            Common::AlignUp(width, gob_elements_x * params.tile_width_spacing);
+
+        // Texture views can only be created from fresh names
+        OGLTexture level_view;
+        glGenTextures(1, &level_view.handle);
+        glTextureView(level_view.handle, GL_TEXTURE_2D, surface->GetTexture(),
+                      unswizzle_view_formats[bpp_log2], level, 1, 0, 1);
+
+        state.images[0] = level_view.handle;
+        state.ApplyImages();
+
+        glProgramUniform1ui(program, 0,
+                            static_cast<GLuint>(params.GetGuestMipmapLevelOffset(level)));
+        glProgramUniform1ui(program, 1, aligned_width / gob_elements_x);
+        glProgramUniform1ui(program, 2, params.GetMipBlockHeight(level));
+        glProgramUniform1ui(program, 3, params.GetMipBlockDepth(level));
+        glProgramUniform2ui(program, 4, width, height);
+        glDispatchCompute(Common::AlignUp(width, 8) / 8, Common::AlignUp(height, 8) / 8, 1);
+
+        // Unbind the view before it's deleted, its name may be reused by the next level
+        state.images[0] = 0;
+        state.ApplyImages();
+    }
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                    GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
 GLuint TextureCacheOpenGL::FetchPBO(std::size_t buffer_size) {
     ASSERT_OR_EXECUTE(buffer_size > 0, { return 0; });
     const u32 l2 = Common::Log2Ceil64(static_cast<u64>(buffer_size));
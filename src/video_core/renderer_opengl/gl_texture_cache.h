@@ -41,6 +41,8 @@ public:
 
     void UploadTexture(const std::vector<u8>& staging_buffer) override;
     void DownloadTexture(std::vector<u8>& staging_buffer) override;
+    void UploadBand(const std::vector<u8>& staging_buffer,
+                    const VideoCommon::SurfaceBand& band) override;
 
     GLenum GetTarget() const {
         return target;
@@ -136,12 +138,20 @@ protected:
 
     void BufferCopy(Surface& src_surface, Surface& dst_surface) override;
 
+    bool CanUploadSwizzled(const SurfaceParams& params) const override;
+
+    void UploadSwizzled(const Surface& surface, const u8* guest_data) override;
+
 private:
     GLuint FetchPBO(std::size_t buffer_size);
 
     OGLFramebuffer src_framebuffer;
     OGLFramebuffer dst_framebuffer;
     std::unordered_map<u32, OGLBuffer> copy_pbo_cache;
+
+    bool has_swizzled_upload{};
+    std::array<OGLProgram, 5> unswizzle_programs; ///< Indexed by log2 of the bytes per pixel
+    OGLBuffer unswizzle_buffer;
 };
 
 } // namespace OpenGL
@@ -5,10 +5,13 @@
 #pragma once
 
 #include <array>
+#include <utility>
 #include <glad/glad.h>
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/shader_bytecode.h"
+#include "video_core/engines/shader_header.h"
 
 namespace OpenGL {
 
@@ -151,6 +154,55 @@ inline GLenum PrimitiveTopology(Maxwell::PrimitiveTopology topology) {
     return GL_POINTS;
 }
 
+/// Returns the primitive transform feedback captures the vertices of a draw with
+inline GLenum TransformFeedbackPrimitive(Maxwell::PrimitiveTopology topology) {
+    switch (topology) {
+    case Maxwell::PrimitiveTopology::Points:
+        return GL_POINTS;
+    case Maxwell::PrimitiveTopology::Lines:
+    case Maxwell::PrimitiveTopology::LineLoop:
+    case Maxwell::PrimitiveTopology::LineStrip:
+    case Maxwell::PrimitiveTopology::LinesAdjacency:
+    case Maxwell::PrimitiveTopology::LineStripAdjacency:
+        return GL_LINES;
+    default:
+        return GL_TRIANGLES;
+    }
+}
+
+/// Returns the primitive transform feedback captures the output of a geometry shader with
+inline GLenum TransformFeedbackPrimitive(Tegra::Shader::OutputTopology topology) {
+    switch (topology) {
+    case Tegra::Shader::OutputTopology::PointList:
+        return GL_POINTS;
+    case Tegra::Shader::OutputTopology::LineStrip:
+        return GL_LINES;
+    default:
+        return GL_TRIANGLES;
+    }
+}
+
+/// Returns the NV_transform_feedback attribute enum and index of an attribute offset in words
+inline std::pair<GLint, GLint> TransformFeedbackAttribute(u8 location) {
+    using Tegra::Shader::Attribute;
+    const auto index = static_cast<Attribute::Index>(location / 4);
+    if (index >= Attribute::Index::Attribute_0 && index <= Attribute::Index::Attribute_31) {
+        return {GL_GENERIC_ATTRIB_NV, static_cast<GLint>(index) -
+                                          static_cast<GLint>(Attribute::Index::Attribute_0)};
+    }
+    switch (index) {
+    case Attribute::Index::Position:
+        return {GL_POSITION, 0};
+    case Attribute::Index::ClipDistances0123:
+        return {GL_CLIP_DISTANCE_NV, 0};
+    case Attribute::Index::ClipDistances4567:
+        return {GL_CLIP_DISTANCE_NV, 4};
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented transform feedback location={}", location);
+        return {GL_POSITION, 0};
+    }
+}
+
 inline GLenum TextureFilterMode(Tegra::Texture::TextureFilter filter_mode,
                                 Tegra::Texture::TextureMipmapFilter mip_filter_mode) {
     switch (filter_mode) {
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdlib>
 #include <memory>
@@ -12,15 +13,19 @@
 #include "common/telemetry.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/frame_timeline.h"
 #include "core/frontend/emu_window.h"
 #include "core/frontend/scope_acquire_window_context.h"
 #include "core/memory.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
 #include "core/telemetry_session.h"
+#include "video_core/frame_capture.h"
 #include "video_core/morton.h"
+#include "video_core/renderer_opengl/gl_presenter.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
+#include "video_core/video_core.h"
 
 namespace OpenGL {
 
@@ -185,11 +190,29 @@ void RendererOpenGL::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
         if (renderer_settings.screenshot_requested)
             CaptureScreenshot();
 
-        DrawScreen(render_window.GetFramebufferLayout());
+        if (frame_capture) {
+            CaptureFrame();
+        }
+
+        // Windows that aren't shown, like offscreen ones, have nothing to present to
+        if (render_window.IsShown()) {
+            if (presenter) {
+                DrawScreenToPresenter(render_window.GetFramebufferLayout());
+            } else {
+                DrawScreen(render_window.GetFramebufferLayout());
+            }
+        }
+        m_current_frame++;
 
         rasterizer->TickFrame();
 
-        render_window.SwapBuffers();
+        NextFrameQuery();
+        // The presenter swaps the buffers from its own thread
+        if (!presenter) {
+            render_window.SwapBuffers();
+        }
+        system.FrameLimiter().OnHostPresent(Core::FrameLimiter::Clock::now());
+        ReadFrameQueries();
     }
 
     render_window.PollEvents();
@@ -199,6 +222,38 @@ void RendererOpenGL::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
     prev_state.Apply();
 }
 
+void RendererOpenGL::NextFrameQuery() {
+    FrameQuery& current = frame_queries[frame_query_index];
+    glQueryCounter(current.end.handle, GL_TIMESTAMP);
+    current.pending = true;
+
+    frame_query_index = (frame_query_index + 1) % frame_queries.size();
+    FrameQuery& next = frame_queries[frame_query_index];
+    // A frame that is still running after a full ring of frames is dropped from the stats
+    next.pending = false;
+    glQueryCounter(next.begin.handle, GL_TIMESTAMP);
+}
+
+void RendererOpenGL::ReadFrameQueries() {
+    for (FrameQuery& query : frame_queries) {
+        if (!query.pending) {
+            continue;
+        }
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query.end.handle, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            continue;
+        }
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(query.begin.handle, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(query.end.handle, GL_QUERY_RESULT, &end);
+        Core::FrameTimeline::GetInstance().AddTime(Core::FrameTimeline::Stage::HostGpu,
+                                                   std::chrono::nanoseconds(end - begin));
+        query.pending = false;
+    }
+}
+
 void RendererOpenGL::LoadFBToScreenInfo(const Tegra::FramebufferConfig& framebuffer) {
     // Framebuffer orientation handling
     framebuffer_transform_flags = framebuffer.transform_flags;
@@ -221,6 +276,16 @@ void RendererOpenGL::LoadFBToScreenInfo(const Tegra::FramebufferConfig& framebuf
 
     // TODO(Rodrigo): Read this from HLE
     constexpr u32 block_height_log2 = 4;
+
+    // Software rendered titles often present the same buffer for several frames, skip the
+    // unswizzle and the upload when its memory didn't change
+    const u64 framebuffer_hash =
+        VideoCore::HashFramebufferMemory(framebuffer, host_ptr, block_height_log2);
+    if (screen_info.texture.uploaded_hash == framebuffer_hash) {
+        return;
+    }
+    screen_info.texture.uploaded_hash = framebuffer_hash;
+
     VideoCore::MortonSwizzle(VideoCore::MortonSwizzleMode::MortonToLinear, pixel_format,
                              framebuffer.stride, block_height_log2, framebuffer.height, 0, 1, 1,
                              gl_framebuffer_data.data(), host_ptr);
@@ -258,6 +323,12 @@ void RendererOpenGL::InitOpenGLObjects() {
     // Generate VBO handle for drawing
     vertex_buffer.Create();
 
+    for (FrameQuery& query : frame_queries) {
+        query.begin.Create(GL_TIMESTAMP);
+        query.end.Create(GL_TIMESTAMP);
+    }
+    glQueryCounter(frame_queries[frame_query_index].begin.handle, GL_TIMESTAMP);
+
     // Generate VAO
     vertex_array.Create();
     state.draw.vertex_array = vertex_array.handle;
@@ -314,6 +385,7 @@ void RendererOpenGL::ConfigureFramebufferTexture(TextureInfo& texture,
     texture.width = framebuffer.width;
     texture.height = framebuffer.height;
     texture.pixel_format = framebuffer.pixel_format;
+    texture.uploaded_hash.reset();
 
     const auto pixel_format{
         VideoCore::Surface::PixelFormatFromGPUPixelFormat(framebuffer.pixel_format)};
@@ -418,8 +490,24 @@ void RendererOpenGL::DrawScreen(const Layout::FramebufferLayout& layout) {
     DrawScreenTriangles(screen_info, static_cast<float>(screen.left),
                         static_cast<float>(screen.top), static_cast<float>(screen.GetWidth()),
                         static_cast<float>(screen.GetHeight()));
+}
+
+void RendererOpenGL::DrawScreenToPresenter(const Layout::FramebufferLayout& layout) {
+    FramePresenter::Frame& frame =
+        presenter->GetRenderFrame(layout.width, layout.height, screen_info.display_srgb);
 
-    m_current_frame++;
+    const GLuint old_draw_fb = state.draw.draw_framebuffer;
+    state.draw.draw_framebuffer = frame.framebuffer.handle;
+    state.AllDirty();
+    state.Apply();
+
+    DrawScreen(layout);
+
+    state.draw.draw_framebuffer = old_draw_fb;
+    state.AllDirty();
+    state.Apply();
+
+    presenter->PresentFrame(frame);
 }
 
 void RendererOpenGL::UpdateFramerate() {}
@@ -458,6 +546,78 @@ void RendererOpenGL::CaptureScreenshot() {
     renderer_settings.screenshot_requested = false;
 }
 
+void RendererOpenGL::InitFrameCapture() {
+    if (Settings::values.frame_capture_command.empty()) {
+        return;
+    }
+
+    capture_layout =
+        Layout::FrameLayoutFromResolutionScale(VideoCore::GetResolutionScaleFactor(*this));
+    frame_capture = std::make_unique<VideoCore::FrameCapture>(
+        Settings::values.frame_capture_command, capture_layout.width, capture_layout.height, 60);
+    if (!frame_capture->IsOpen()) {
+        frame_capture.reset();
+        return;
+    }
+
+    capture_framebuffer.Create();
+    for (CaptureReadback& readback : capture_readbacks) {
+        readback.buffer.Create();
+        glNamedBufferStorage(readback.buffer.handle, frame_capture->GetFrameSize(), nullptr,
+                             GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+    }
+}
+
+void RendererOpenGL::CaptureFrame() {
+    // The readback issued a full ring of frames ago has most likely finished by now
+    if (capture_readbacks[capture_readback_index].fence.handle != 0) {
+        SubmitCapturedFrame(capture_readback_index);
+    }
+
+    if (capture_texture.handle == 0 || capture_srgb != screen_info.display_srgb) {
+        capture_srgb = screen_info.display_srgb;
+        capture_texture.Release();
+        capture_texture.Create(GL_TEXTURE_2D);
+        glTextureStorage2D(capture_texture.handle, 1, capture_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                           capture_layout.width, capture_layout.height);
+        glNamedFramebufferTexture(capture_framebuffer.handle, GL_COLOR_ATTACHMENT0,
+                                  capture_texture.handle, 0);
+    }
+
+    const GLuint old_read_fb = state.draw.read_framebuffer;
+    const GLuint old_draw_fb = state.draw.draw_framebuffer;
+    state.draw.read_framebuffer = state.draw.draw_framebuffer = capture_framebuffer.handle;
+    state.AllDirty();
+    state.Apply();
+
+    DrawScreen(capture_layout);
+
+    CaptureReadback& readback = capture_readbacks[capture_readback_index];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer.handle);
+    glReadPixels(0, 0, capture_layout.width, capture_layout.height, GL_BGRA,
+                 GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fence.Create();
+
+    state.draw.read_framebuffer = old_read_fb;
+    state.draw.draw_framebuffer = old_draw_fb;
+    state.AllDirty();
+    state.Apply();
+
+    capture_readback_index = (capture_readback_index + 1) % capture_readbacks.size();
+}
+
+void RendererOpenGL::SubmitCapturedFrame(std::size_t index) {
+    CaptureReadback& readback = capture_readbacks[index];
+    glClientWaitSync(readback.fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    readback.fence.Release();
+
+    std::vector<u8> frame = frame_capture->AcquireBuffer();
+    glGetNamedBufferSubData(readback.buffer.handle, 0, static_cast<GLsizeiptr>(frame.size()),
+                            frame.data());
+    frame_capture->PushFrame(std::move(frame), true);
+}
+
 bool RendererOpenGL::Init() {
     Core::Frontend::ScopeAcquireWindowContext acquire_context{render_window};
 
@@ -473,11 +633,35 @@ bool RendererOpenGL::Init() {
     }
 
     InitOpenGLObjects();
+    InitFrameCapture();
     CreateRasterizer();
 
+    // Only the GPU thread can render while another thread presents
+    if (Settings::values.use_threaded_presentation) {
+        auto presentation_context = render_window.CreatePresentationContext();
+        if (!Settings::values.use_asynchronous_gpu_emulation) {
+            LOG_WARNING(Render_OpenGL, "Threaded presentation needs asynchronous GPU emulation");
+        } else if (!presentation_context) {
+            LOG_WARNING(Render_OpenGL, "The frontend can't present from another thread");
+        } else {
+            presenter = std::make_unique<FramePresenter>(std::move(presentation_context));
+        }
+    }
+
     return true;
 }
 
 void RendererOpenGL::ShutDown() {}
 
+void RendererOpenGL::ResetRasterizer() {
+    Core::Frontend::ScopeAcquireWindowContext acquire_context{render_window};
+
+    // The old rasterizer has to release its objects before the new one takes over the state
+    rasterizer.reset();
+    CreateRasterizer();
+
+    // The next session's framebuffer lives in different guest memory
+    screen_info.texture.uploaded_hash.reset();
+}
+
 } // namespace OpenGL
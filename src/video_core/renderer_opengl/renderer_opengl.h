@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <glad/glad.h>
 #include "common/common_types.h"
@@ -24,8 +27,14 @@ namespace Layout {
 struct FramebufferLayout;
 }
 
+namespace VideoCore {
+class FrameCapture;
+}
+
 namespace OpenGL {
 
+class FramePresenter;
+
 /// Structure used for storing information about the textures for the Switch screen
 struct TextureInfo {
     OGLTexture resource;
@@ -34,6 +43,7 @@ struct TextureInfo {
     GLenum gl_format;
     GLenum gl_type;
     Tegra::FramebufferConfig::PixelFormat pixel_format;
+    std::optional<u64> uploaded_hash; ///< Hash of the guest framebuffer last uploaded into it
 };
 
 /// Structure used for storing information about the display target for the Switch screen
@@ -58,6 +68,8 @@ public:
     /// Shutdown the renderer
     void ShutDown() override;
 
+    void ResetRasterizer() override;
+
 private:
     /// Initializes the OpenGL state and creates persistent objects.
     void InitOpenGLObjects();
@@ -72,6 +84,9 @@ private:
     /// Draws the emulated screens to the emulator window.
     void DrawScreen(const Layout::FramebufferLayout& layout);
 
+    /// Draws the emulated screens into a frame of the presenter and queues it
+    void DrawScreenToPresenter(const Layout::FramebufferLayout& layout);
+
     void DrawScreenTriangles(const ScreenInfo& screen_info, float x, float y, float w, float h);
 
     /// Updates the framerate.
@@ -79,6 +94,21 @@ private:
 
     void CaptureScreenshot();
 
+    /// Starts the frame capture encoder when one is configured
+    void InitFrameCapture();
+
+    /// Reads the current frame back asynchronously and sends finished readbacks to the encoder
+    void CaptureFrame();
+
+    /// Sends the frame of a finished readback to the encoder
+    void SubmitCapturedFrame(std::size_t index);
+
+    /// Marks the end of the host GPU work of the frame and the beginning of the next one.
+    void NextFrameQuery();
+
+    /// Accounts the host GPU time of the frames whose queries have finished.
+    void ReadFrameQueries();
+
     /// Loads framebuffer from emulated memory into the active OpenGL texture.
     void LoadFBToScreenInfo(const Tegra::FramebufferConfig& framebuffer);
 
@@ -98,6 +128,32 @@ private:
     OGLProgram shader;
     OGLFramebuffer screenshot_framebuffer;
 
+    /// Timestamps around the host GPU work of the last frames, read back once available
+    struct FrameQuery {
+        OGLQuery begin;
+        OGLQuery end;
+        bool pending = false;
+    };
+    std::array<FrameQuery, 4> frame_queries;
+    std::size_t frame_query_index = 0;
+
+    /// Pixel pack buffers the captured frames are read into without stalling, mapped once their
+    /// fence signals a few frames later
+    struct CaptureReadback {
+        OGLBuffer buffer;
+        OGLSync fence;
+    };
+    std::unique_ptr<VideoCore::FrameCapture> frame_capture;
+    Layout::FramebufferLayout capture_layout;
+    OGLFramebuffer capture_framebuffer;
+    OGLTexture capture_texture;
+    bool capture_srgb = false;
+    std::array<CaptureReadback, 3> capture_readbacks;
+    std::size_t capture_readback_index = 0;
+
+    /// Presents the frames from its own thread when threaded presentation is enabled
+    std::unique_ptr<FramePresenter> presenter;
+
     /// Display information for Switch screen
     ScreenInfo screen_info;
 
@@ -72,8 +72,22 @@ void BindBuffersRangePushBuffer::Push(GLuint binding, const GLuint* buffer, GLin
 }
 
 void BindBuffersRangePushBuffer::Bind() {
-    for (const Entry& entry : entries) {
-        glBindBufferRange(target, entry.binding, *entry.buffer, entry.offset, entry.size);
+    switch (target) {
+    case GL_VERTEX_PROGRAM_PARAMETER_BUFFER_NV:
+    case GL_TESS_CONTROL_PROGRAM_PARAMETER_BUFFER_NV:
+    case GL_TESS_EVALUATION_PROGRAM_PARAMETER_BUFFER_NV:
+    case GL_GEOMETRY_PROGRAM_PARAMETER_BUFFER_NV:
+    case GL_FRAGMENT_PROGRAM_PARAMETER_BUFFER_NV:
+        // Parameter buffers of assembly programs have their own entry point
+        for (const Entry& entry : entries) {
+            glBindBufferRangeNV(target, entry.binding, *entry.buffer, entry.offset, entry.size);
+        }
+        return;
+    default:
+        for (const Entry& entry : entries) {
+            glBindBufferRange(target, entry.binding, *entry.buffer, entry.offset, entry.size);
+        }
+        return;
     }
 }
 
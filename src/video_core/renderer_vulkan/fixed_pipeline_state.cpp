@@ -14,18 +14,31 @@ namespace Vulkan {
 namespace {
 
 constexpr FixedPipelineState::DepthStencil GetDepthStencilState(const Maxwell& regs) {
-    const FixedPipelineState::StencilFace front_stencil(
-        regs.stencil_front_op_fail, regs.stencil_front_op_zfail, regs.stencil_front_op_zpass,
-        regs.stencil_front_func_func);
-    const FixedPipelineState::StencilFace back_stencil =
-        regs.stencil_two_side_enable
-            ? FixedPipelineState::StencilFace(regs.stencil_back_op_fail, regs.stencil_back_op_zfail,
-                                              regs.stencil_back_op_zpass,
-                                              regs.stencil_back_func_func)
-            : front_stencil;
+    // State that has no effect on the built pipeline is normalized to avoid creating pipelines
+    // that only differ in ignored values
+    const bool depth_test = regs.depth_test_enable == 1;
+    const bool stencil_test = regs.stencil_enable == 1;
+    const Maxwell::ComparisonOp depth_func =
+        depth_test ? regs.depth_test_func : Maxwell::ComparisonOp::Always;
+
+    FixedPipelineState::StencilFace front_stencil(Maxwell::StencilOp::Keep,
+                                                  Maxwell::StencilOp::Keep,
+                                                  Maxwell::StencilOp::Keep,
+                                                  Maxwell::ComparisonOp::Always);
+    FixedPipelineState::StencilFace back_stencil = front_stencil;
+    if (stencil_test) {
+        front_stencil = FixedPipelineState::StencilFace(
+            regs.stencil_front_op_fail, regs.stencil_front_op_zfail, regs.stencil_front_op_zpass,
+            regs.stencil_front_func_func);
+        back_stencil = regs.stencil_two_side_enable
+                           ? FixedPipelineState::StencilFace(
+                                 regs.stencil_back_op_fail, regs.stencil_back_op_zfail,
+                                 regs.stencil_back_op_zpass, regs.stencil_back_func_func)
+                           : front_stencil;
+    }
     return FixedPipelineState::DepthStencil(
-        regs.depth_test_enable == 1, regs.depth_write_enabled == 1, regs.depth_bounds_enable == 1,
-        regs.stencil_enable == 1, regs.depth_test_func, front_stencil, back_stencil);
+        depth_test, depth_test && regs.depth_write_enabled == 1, regs.depth_bounds_enable == 1,
+        stencil_test, depth_func, front_stencil, back_stencil);
 }
 
 constexpr FixedPipelineState::InputAssembly GetInputAssemblyState(const Maxwell& regs) {
@@ -122,9 +135,11 @@ constexpr FixedPipelineState::Rasterizer GetRasterizerState(const Maxwell& regs)
     }
 
     const bool gl_ndc = regs.depth_mode == Maxwell::DepthMode::MinusOneToOne;
-    return FixedPipelineState::Rasterizer(regs.cull.enabled, depth_bias_enabled,
-                                          depth_clamp_enabled, gl_ndc, regs.cull.cull_face,
-                                          front_face);
+    const bool cull_enabled = regs.cull.enabled != 0;
+    const Maxwell::Cull::CullFace cull_face =
+        cull_enabled ? regs.cull.cull_face : Maxwell::Cull::CullFace::Back;
+    return FixedPipelineState::Rasterizer(cull_enabled, depth_bias_enabled, depth_clamp_enabled,
+                                          gl_ndc, cull_face, front_face);
 }
 
 } // Anonymous namespace
@@ -150,9 +165,9 @@ bool FixedPipelineState::VertexAttribute::operator==(const VertexAttribute& rhs)
 
 std::size_t FixedPipelineState::StencilFace::Hash() const noexcept {
     return static_cast<std::size_t>(action_stencil_fail) ^
-           (static_cast<std::size_t>(action_depth_fail) << 4) ^
-           (static_cast<std::size_t>(action_depth_fail) << 20) ^
-           (static_cast<std::size_t>(action_depth_pass) << 36);
+           (static_cast<std::size_t>(action_depth_fail) << 16) ^
+           (static_cast<std::size_t>(action_depth_pass) << 32) ^
+           (static_cast<std::size_t>(test_func) << 48);
 }
 
 bool FixedPipelineState::StencilFace::operator==(const StencilFace& rhs) const noexcept {
@@ -279,14 +294,15 @@ std::size_t FixedPipelineState::Hash() const noexcept {
     boost::hash_combine(hash, rasterizer.Hash());
     boost::hash_combine(hash, depth_stencil.Hash());
     boost::hash_combine(hash, color_blending.Hash());
+    boost::hash_combine(hash, transform_feedback.Hash());
     return hash;
 }
 
 bool FixedPipelineState::operator==(const FixedPipelineState& rhs) const noexcept {
     return std::tie(vertex_input, input_assembly, tessellation, rasterizer, depth_stencil,
-                    color_blending) == std::tie(rhs.vertex_input, rhs.input_assembly,
-                                                rhs.tessellation, rhs.rasterizer, rhs.depth_stencil,
-                                                rhs.color_blending);
+                    color_blending, transform_feedback) ==
+           std::tie(rhs.vertex_input, rhs.input_assembly, rhs.tessellation, rhs.rasterizer,
+                    rhs.depth_stencil, rhs.color_blending, rhs.transform_feedback);
 }
 
 FixedPipelineState GetFixedPipelineState(const Maxwell& regs) {
@@ -296,7 +312,31 @@ FixedPipelineState GetFixedPipelineState(const Maxwell& regs) {
     fixed_state.rasterizer = GetRasterizerState(regs);
     fixed_state.depth_stencil = GetDepthStencilState(regs);
     fixed_state.color_blending = GetColorBlendingState(regs);
+    fixed_state.transform_feedback = VideoCommon::Shader::TransformFeedbackState::FromRegs(regs);
     return fixed_state;
 }
 
+void RefreshFixedPipelineState(FixedPipelineState& fixed_state,
+                               Tegra::Engines::Maxwell3D& maxwell3d) {
+    const auto& regs = maxwell3d.regs;
+    auto& dirty = maxwell3d.dirty;
+
+    // These groups depend on registers without dirty tracking and are cheap to build
+    fixed_state.input_assembly = GetInputAssemblyState(regs);
+    fixed_state.tessellation = GetTessellationState(regs);
+    fixed_state.rasterizer = GetRasterizerState(regs);
+    fixed_state.transform_feedback = VideoCommon::Shader::TransformFeedbackState::FromRegs(regs);
+
+    // Stencil and blend flags are shared with the dynamic state updates, they are cleared there
+    if (dirty.depth_test || dirty.stencil_test) {
+        dirty.depth_test = false;
+        fixed_state.depth_stencil = GetDepthStencilState(regs);
+    }
+    if (dirty.blend_state || dirty.color_mask ||
+        fixed_state.color_blending.attachments_count != regs.rt_control.count) {
+        dirty.color_mask = false;
+        fixed_state.color_blending = GetColorBlendingState(regs);
+    }
+}
+
 } // namespace Vulkan
@@ -10,6 +10,7 @@
 #include "common/common_types.h"
 
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/shader/transform_feedback.h"
 #include "video_core/surface.h"
 
 namespace Vulkan {
@@ -255,6 +256,7 @@ struct FixedPipelineState {
     Rasterizer rasterizer;
     DepthStencil depth_stencil;
     ColorBlending color_blending;
+    VideoCommon::Shader::TransformFeedbackState transform_feedback;
 };
 static_assert(std::is_trivially_copyable_v<FixedPipelineState::VertexBinding>);
 static_assert(std::is_trivially_copyable_v<FixedPipelineState::VertexAttribute>);
@@ -270,6 +272,11 @@ static_assert(std::is_trivially_copyable_v<FixedPipelineState>);
 
 FixedPipelineState GetFixedPipelineState(const Maxwell& regs);
 
+/// Rebuilds the groups of a previously filled state whose registers have been written since the
+/// last refresh. The state has to be value initialized before its first refresh.
+void RefreshFixedPipelineState(FixedPipelineState& fixed_state,
+                               Tegra::Engines::Maxwell3D& maxwell3d);
+
 } // namespace Vulkan
 
 namespace std {
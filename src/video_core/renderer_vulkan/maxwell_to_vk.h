@@ -44,6 +44,10 @@ vk::PrimitiveTopology PrimitiveTopology(const VKDevice& device,
 
 vk::Format VertexFormat(Maxwell::VertexAttribute::Type type, Maxwell::VertexAttribute::Size size);
 
+/// Returns true when the device can fetch vertex attributes of this format natively.
+bool IsVertexFormatSupported(const VKDevice& device, Maxwell::VertexAttribute::Type type,
+                             Maxwell::VertexAttribute::Size size);
+
 vk::CompareOp ComparisonOp(Maxwell::ComparisonOp comparison);
 
 vk::IndexType IndexFormat(const VKDevice& device, Maxwell::IndexFormat index_format);
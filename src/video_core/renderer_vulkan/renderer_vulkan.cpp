@@ -23,6 +23,7 @@
 #include "video_core/renderer_vulkan/renderer_vulkan.h"
 #include "video_core/renderer_vulkan/vk_blit_screen.h"
 #include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_frame_timer.h"
 #include "video_core/renderer_vulkan/vk_memory_manager.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
@@ -122,11 +123,14 @@ void RendererVulkan::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
         swapchain->AcquireNextImage();
         const auto [fence, render_semaphore] = blit_screen->Draw(*framebuffer, use_accelerated);
 
+        frame_timer->NextFrame();
         scheduler->Flush(false, render_semaphore);
+        frame_timer->Collect();
 
         if (swapchain->Present(render_semaphore, fence)) {
             blit_screen->Recreate();
         }
+        system.FrameLimiter().OnHostPresent(Core::FrameLimiter::Clock::now());
 
         render_window.SwapBuffers();
         rasterizer->TickFrame();
@@ -170,12 +174,9 @@ bool RendererVulkan::Init() {
 
     scheduler = std::make_unique<VKScheduler>(*device, *resource_manager);
 
-    rasterizer = std::make_unique<RasterizerVulkan>(system, render_window, screen_info, *device,
-                                                    *resource_manager, *memory_manager, *scheduler);
+    frame_timer = std::make_unique<VKFrameTimer>(*device, *scheduler);
 
-    blit_screen = std::make_unique<VKBlitScreen>(system, render_window, *rasterizer, *device,
-                                                 *resource_manager, *memory_manager, *swapchain,
-                                                 *scheduler, screen_info);
+    CreateRasterizer();
 
     return true;
 }
@@ -192,6 +193,7 @@ void RendererVulkan::ShutDown() {
 
     rasterizer.reset();
     blit_screen.reset();
+    frame_timer.reset();
     scheduler.reset();
     swapchain.reset();
     memory_manager.reset();
@@ -199,6 +201,26 @@ void RendererVulkan::ShutDown() {
     device.reset();
 }
 
+void RendererVulkan::ResetRasterizer() {
+    // Nothing recorded by the old rasterizer may still be in flight when its objects are destroyed
+    scheduler->Finish();
+    const auto dev = device->GetLogical();
+    dev.waitIdle(device->GetDispatchLoader());
+
+    blit_screen.reset();
+    rasterizer.reset();
+    CreateRasterizer();
+}
+
+void RendererVulkan::CreateRasterizer() {
+    rasterizer = std::make_unique<RasterizerVulkan>(system, render_window, screen_info, *device,
+                                                    *resource_manager, *memory_manager, *scheduler);
+
+    blit_screen = std::make_unique<VKBlitScreen>(system, render_window, *rasterizer, *device,
+                                                 *resource_manager, *memory_manager, *swapchain,
+                                                 *scheduler, screen_info);
+}
+
 std::optional<vk::DebugUtilsMessengerEXT> RendererVulkan::CreateDebugCallback(
     const vk::DispatchLoaderDynamic& dldi) {
     const vk::DebugUtilsMessengerCreateInfoEXT callback_ci(
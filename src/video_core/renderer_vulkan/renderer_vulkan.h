@@ -18,6 +18,7 @@ namespace Vulkan {
 class VKBlitScreen;
 class VKDevice;
 class VKFence;
+class VKFrameTimer;
 class VKMemoryManager;
 class VKResourceManager;
 class VKSwapchain;
@@ -45,7 +46,12 @@ public:
     /// Shutdown the renderer
     void ShutDown() override;
 
+    void ResetRasterizer() override;
+
 private:
+    /// Creates the rasterizer and the blitter that presents its images.
+    void CreateRasterizer();
+
     std::optional<vk::DebugUtilsMessengerEXT> CreateDebugCallback(
         const vk::DispatchLoaderDynamic& dldi);
 
@@ -67,6 +73,7 @@ private:
     std::unique_ptr<VKResourceManager> resource_manager;
     std::unique_ptr<VKScheduler> scheduler;
     std::unique_ptr<VKBlitScreen> blit_screen;
+    std::unique_ptr<VKFrameTimer> frame_timer;
 };
 
 } // namespace Vulkan
@@ -20,6 +20,7 @@
 #include "video_core/gpu.h"
 #include "video_core/morton.h"
 #include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/renderer_vulkan.h"
 #include "video_core/renderer_vulkan/vk_blit_screen.h"
@@ -251,22 +252,32 @@ std::tuple<VKFence&, vk::Semaphore> VKBlitScreen::Draw(const Tegra::FramebufferC
 
         // TODO(Rodrigo): Read this from HLE
         constexpr u32 block_height_log2 = 4;
-        VideoCore::MortonSwizzle(VideoCore::MortonSwizzleMode::MortonToLinear, pixel_format,
-                                 framebuffer.stride, block_height_log2, framebuffer.height, 0, 1, 1,
-                                 map.GetAddress() + image_offset, host_ptr);
-
-        blit_image->Transition(0, 1, 0, 1, vk::PipelineStageFlagBits::eTransfer,
-                               vk::AccessFlagBits::eTransferWrite,
-                               vk::ImageLayout::eTransferDstOptimal);
-
-        const vk::BufferImageCopy copy(image_offset, 0, 0,
-                                       {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, {0, 0, 0},
-                                       {framebuffer.width, framebuffer.height, 1});
-        scheduler.Record([buffer_handle = *buffer, image = blit_image->GetHandle(),
-                          copy](auto cmdbuf, auto& dld) {
-            cmdbuf.copyBufferToImage(buffer_handle, image, vk::ImageLayout::eTransferDstOptimal,
-                                     {copy}, dld);
-        });
+
+        // Each swapchain image has its own raw image, skip the unswizzle and the upload when
+        // this one already holds the current contents of the guest framebuffer
+        const u64 framebuffer_hash =
+            VideoCore::HashFramebufferMemory(framebuffer, host_ptr, block_height_log2);
+        auto& uploaded_hash = raw_image_hashes[image_index];
+        if (uploaded_hash != framebuffer_hash) {
+            uploaded_hash = framebuffer_hash;
+
+            VideoCore::MortonSwizzle(VideoCore::MortonSwizzleMode::MortonToLinear, pixel_format,
+                                     framebuffer.stride, block_height_log2, framebuffer.height, 0,
+                                     1, 1, map.GetAddress() + image_offset, host_ptr);
+
+            blit_image->Transition(0, 1, 0, 1, vk::PipelineStageFlagBits::eTransfer,
+                                   vk::AccessFlagBits::eTransferWrite,
+                                   vk::ImageLayout::eTransferDstOptimal);
+
+            const vk::BufferImageCopy copy(image_offset, 0, 0,
+                                           {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, {0, 0, 0},
+                                           {framebuffer.width, framebuffer.height, 1});
+            scheduler.Record([buffer_handle = *buffer, image = blit_image->GetHandle(),
+                              copy](auto cmdbuf, auto& dld) {
+                cmdbuf.copyBufferToImage(buffer_handle, image,
+                                         vk::ImageLayout::eTransferDstOptimal, {copy}, dld);
+            });
+        }
     }
     map.Release();
 
@@ -501,6 +512,7 @@ void VKBlitScreen::ReleaseRawImages() {
         watches[i]->Wait();
     }
     raw_images.clear();
+    raw_image_hashes.clear();
     raw_buffer_commits.clear();
     buffer.reset();
     buffer_commit.reset();
@@ -521,6 +533,7 @@ void VKBlitScreen::CreateStagingBuffer(const Tegra::FramebufferConfig& framebuff
 
 void VKBlitScreen::CreateRawImages(const Tegra::FramebufferConfig& framebuffer) {
     raw_images.resize(image_count);
+    raw_image_hashes.resize(image_count);
     raw_buffer_commits.resize(image_count);
 
     const auto format = GetFormat(framebuffer);
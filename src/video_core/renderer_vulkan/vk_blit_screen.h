@@ -6,6 +6,7 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <tuple>
 
 #include "video_core/renderer_vulkan/declarations.h"
@@ -111,6 +112,7 @@ private:
 
     std::vector<UniqueSemaphore> semaphores;
     std::vector<std::unique_ptr<VKImage>> raw_images;
+    std::vector<std::optional<u64>> raw_image_hashes; ///< Framebuffer hash uploaded to each image
     std::vector<VKMemoryCommit> raw_buffer_commits;
     u32 raw_width = 0;
     u32 raw_height = 0;
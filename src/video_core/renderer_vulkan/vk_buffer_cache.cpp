@@ -23,7 +23,8 @@ namespace {
 
 const auto BufferUsage =
     vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer |
-    vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+    vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer |
+    vk::BufferUsageFlagBits::eIndirectBuffer;
 
 const auto UploadPipelineStage =
     vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eVertexInput |
@@ -44,15 +45,23 @@ auto CreateStreamBuffer(const VKDevice& device, VKScheduler& scheduler) {
 CachedBufferBlock::CachedBufferBlock(const VKDevice& device, VKMemoryManager& memory_manager,
                                      CacheAddr cache_addr, std::size_t size)
     : VideoCommon::BufferBlock{cache_addr, size} {
-    const vk::BufferCreateInfo buffer_ci({}, static_cast<vk::DeviceSize>(size),
-                                         BufferUsage | vk::BufferUsageFlagBits::eTransferSrc |
-                                             vk::BufferUsageFlagBits::eTransferDst,
+    vk::BufferUsageFlags usage = BufferUsage | vk::BufferUsageFlagBits::eTransferSrc |
+                                 vk::BufferUsageFlagBits::eTransferDst;
+    if (device.IsExtTransformFeedbackSupported()) {
+        // Captured varyings are written straight to the blocks
+        usage |= vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT;
+    }
+    const vk::BufferCreateInfo buffer_ci({}, static_cast<vk::DeviceSize>(size), usage,
                                          vk::SharingMode::eExclusive, 0, nullptr);
 
     const auto& dld{device.GetDispatchLoader()};
     const auto dev{device.GetLogical()};
     buffer.handle = dev.createBufferUnique(buffer_ci, nullptr, dld);
-    buffer.commit = memory_manager.Commit(*buffer.handle, false);
+
+    // On unified memory devices host visible memory is as fast as any other, blocks can be written
+    // and read without staging buffers
+    is_host_visible = memory_manager.IsMemoryUnified();
+    buffer.commit = memory_manager.Commit(*buffer.handle, is_host_visible);
 }
 
 CachedBufferBlock::~CachedBufferBlock() = default;
@@ -73,6 +82,7 @@ Buffer VKBufferCache::CreateBlock(CacheAddr cache_addr, std::size_t size) {
 }
 
 const vk::Buffer* VKBufferCache::ToHandle(const Buffer& buffer) {
+    buffer->MarkGPUUsage(scheduler.GetFence());
     return buffer->GetHandle();
 }
 
@@ -88,6 +98,13 @@ const vk::Buffer* VKBufferCache::GetEmptyBuffer(std::size_t size) {
 
 void VKBufferCache::UploadBlockData(const Buffer& buffer, std::size_t offset, std::size_t size,
                                     const u8* data) {
+    if (buffer->IsHostVisible() && !buffer->IsGPUBusy()) {
+        // Nothing pending reads or writes the buffer, it's safe to write it directly
+        std::memcpy(buffer->GetCommit()->Map(size, offset), data, size);
+        return;
+    }
+    buffer->MarkGPUUsage(scheduler.GetFence());
+
     const auto& staging = staging_pool.GetUnusedBuffer(size, true);
     std::memcpy(staging.commit->Map(size), data, size);
 
@@ -106,6 +123,26 @@ void VKBufferCache::UploadBlockData(const Buffer& buffer, std::size_t offset, st
 
 void VKBufferCache::DownloadBlockData(const Buffer& buffer, std::size_t offset, std::size_t size,
                                       u8* data) {
+    if (buffer->IsHostVisible()) {
+        if (buffer->IsGPUBusy()) {
+            // Wait for pending writes, the memory is coherent so no copies are needed
+            scheduler.RequestOutsideRenderPassOperationContext();
+            scheduler.Record([buffer = *buffer->GetHandle(), offset, size](auto cmdbuf, auto& dld) {
+                cmdbuf.pipelineBarrier(
+                    vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eHost, {},
+                    {},
+                    {vk::BufferMemoryBarrier(
+                        vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite,
+                        vk::AccessFlagBits::eHostRead, VK_QUEUE_FAMILY_IGNORED,
+                        VK_QUEUE_FAMILY_IGNORED, buffer, offset, size)},
+                    {}, dld);
+            });
+            scheduler.Finish();
+        }
+        std::memcpy(data, buffer->GetCommit()->Map(size, offset), size);
+        return;
+    }
+
     const auto& staging = staging_pool.GetUnusedBuffer(size, true);
     scheduler.RequestOutsideRenderPassOperationContext();
     scheduler.Record([staging = *staging.handle, buffer = *buffer->GetHandle(), offset,
@@ -127,9 +164,21 @@ void VKBufferCache::DownloadBlockData(const Buffer& buffer, std::size_t offset,
 
 void VKBufferCache::CopyBlock(const Buffer& src, const Buffer& dst, std::size_t src_offset,
                               std::size_t dst_offset, std::size_t size) {
+    src->MarkGPUUsage(scheduler.GetFence());
+    dst->MarkGPUUsage(scheduler.GetFence());
+
     scheduler.RequestOutsideRenderPassOperationContext();
     scheduler.Record([src_buffer = *src->GetHandle(), dst_buffer = *dst->GetHandle(), src_offset,
                       dst_offset, size](auto cmdbuf, auto& dld) {
+        // The source may have been written by shaders
+        cmdbuf.pipelineBarrier(
+            vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader |
+                vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eTransfer, {}, {},
+            {vk::BufferMemoryBarrier(vk::AccessFlagBits::eShaderWrite,
+                                     vk::AccessFlagBits::eTransferRead, VK_QUEUE_FAMILY_IGNORED,
+                                     VK_QUEUE_FAMILY_IGNORED, src_buffer, src_offset, size)},
+            {}, dld);
         cmdbuf.copyBuffer(src_buffer, dst_buffer, {{src_offset, dst_offset, size}}, dld);
         cmdbuf.pipelineBarrier(
             vk::PipelineStageFlagBits::eTransfer, UploadPipelineStage, {}, {},
@@ -37,8 +37,30 @@ public:
         return &*buffer.handle;
     }
 
+    /// Returns the memory commit backing the buffer.
+    const VKMemoryCommit& GetCommit() const {
+        return buffer.commit;
+    }
+
+    /// Returns true when the buffer lives in host visible memory.
+    bool IsHostVisible() const {
+        return is_host_visible;
+    }
+
+    /// Marks the buffer as used by the commands protected by the given fence.
+    void MarkGPUUsage(VKFence& fence) {
+        watch.Rewatch(fence);
+    }
+
+    /// Returns true when the GPU might still be using the buffer.
+    bool IsGPUBusy() const {
+        return watch.IsUsed();
+    }
+
 private:
     VKBuffer buffer;
+    VKFenceWatch watch;
+    bool is_host_visible = false;
 };
 
 using Buffer = std::shared_ptr<CachedBufferBlock>;
@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 #include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 
@@ -53,9 +54,19 @@ public:
     std::pair<const vk::Buffer&, vk::DeviceSize> Assemble(u32 num_vertices, u32 first);
 
 private:
+    struct CachedAssembly {
+        u32 num_vertices{};
+        u32 first{};
+        const vk::Buffer* buffer{};
+    };
+
     VKScheduler& scheduler;
     VKStagingBufferPool& staging_buffer_pool;
     VKUpdateDescriptorQueue& update_descriptor_queue;
+
+    /// Index buffers assembled in the command buffer of cache_tick, still protected by its fence
+    std::vector<CachedAssembly> cached_assemblies;
+    u64 cache_tick = 0;
 };
 
 class Uint8Pass final : public VKComputePass {
@@ -74,4 +85,70 @@ private:
     VKUpdateDescriptorQueue& update_descriptor_queue;
 };
 
+/// Converts topologies without a Vulkan equivalent (quad strips, indexed quads and line loops) to
+/// list topologies, generating 32-bit indices.
+class TopologyPass final : public VKComputePass {
+public:
+    using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+    explicit TopologyPass(const VKDevice& device, VKScheduler& scheduler,
+                          VKDescriptorPool& descriptor_pool,
+                          VKStagingBufferPool& staging_buffer_pool,
+                          VKUpdateDescriptorQueue& update_descriptor_queue);
+    ~TopologyPass();
+
+    /// Returns the number of vertices of the list a draw with this topology is converted to.
+    static u32 GetNumOutputVertices(Maxwell::PrimitiveTopology topology, u32 num_vertices);
+
+    /// Generates the indices of a non-indexed draw.
+    std::pair<const vk::Buffer*, u64> AssembleArray(Maxwell::PrimitiveTopology topology,
+                                                    u32 num_vertices, u32 first);
+
+    /// Converts the indices of an indexed draw.
+    std::pair<const vk::Buffer*, u64> AssembleIndexed(Maxwell::PrimitiveTopology topology,
+                                                      u32 num_vertices,
+                                                      Maxwell::IndexFormat index_format,
+                                                      vk::Buffer src_buffer, u64 src_offset);
+
+private:
+    std::pair<const vk::Buffer*, u64> Assemble(Maxwell::PrimitiveTopology topology,
+                                               u32 num_vertices, u32 first, u32 index_shift,
+                                               bool is_indexed, vk::Buffer src_buffer,
+                                               u64 src_offset);
+
+    VKScheduler& scheduler;
+    VKStagingBufferPool& staging_buffer_pool;
+    VKUpdateDescriptorQueue& update_descriptor_queue;
+};
+
+/// Converts vertex attributes in formats the device can't fetch to four 32-bit components.
+class VertexFormatPass final : public VKComputePass {
+public:
+    using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+    explicit VertexFormatPass(const VKDevice& device, VKScheduler& scheduler,
+                              VKDescriptorPool& descriptor_pool,
+                              VKStagingBufferPool& staging_buffer_pool,
+                              VKUpdateDescriptorQueue& update_descriptor_queue);
+    ~VertexFormatPass();
+
+    /// Returns true when attributes with this format can be converted.
+    static bool IsConvertible(const Maxwell::VertexAttribute& attribute);
+
+    /// Returns the type the converted attribute has to be fetched with.
+    static Maxwell::VertexAttribute::Type GetConvertedType(
+        const Maxwell::VertexAttribute& attribute);
+
+    /// Converts the attribute of num_vertices vertices of a vertex buffer, tightly packed.
+    std::pair<const vk::Buffer*, u64> Assemble(const Maxwell::VertexAttribute& attribute,
+                                               u32 stride, u32 num_vertices, vk::Buffer src_buffer,
+                                               u64 src_offset, u64 src_size);
+
+private:
+    const VKDevice& device;
+    VKScheduler& scheduler;
+    VKStagingBufferPool& staging_buffer_pool;
+    VKUpdateDescriptorQueue& update_descriptor_queue;
+};
+
 } // namespace Vulkan
@@ -20,13 +20,15 @@ namespace Vulkan {
 VKComputePipeline::VKComputePipeline(const VKDevice& device, VKScheduler& scheduler,
                                      VKDescriptorPool& descriptor_pool,
                                      VKUpdateDescriptorQueue& update_descriptor_queue,
-                                     const SPIRVShader& shader)
+                                     vk::PipelineCache pipeline_cache, const SPIRVShader& shader,
+                                     const SpecializationConstants& constants)
     : device{device}, scheduler{scheduler}, entries{shader.entries},
       descriptor_set_layout{CreateDescriptorSetLayout()},
       descriptor_allocator{descriptor_pool, *descriptor_set_layout},
       update_descriptor_queue{update_descriptor_queue}, layout{CreatePipelineLayout()},
       descriptor_template{CreateDescriptorUpdateTemplate()},
-      shader_module{CreateShaderModule(shader.code)}, pipeline{CreatePipeline()} {}
+      shader_module{CreateShaderModule(*shader.code)},
+      pipeline{CreatePipeline(pipeline_cache, constants)} {}
 
 VKComputePipeline::~VKComputePipeline() = default;
 
@@ -34,9 +36,8 @@ vk::DescriptorSet VKComputePipeline::CommitDescriptorSet() {
     if (!descriptor_template) {
         return {};
     }
-    const auto set = descriptor_allocator.Commit(scheduler.GetFence());
-    update_descriptor_queue.Send(*descriptor_template, set);
-    return set;
+    return update_descriptor_queue.Send(*descriptor_template, descriptor_allocator,
+                                        scheduler.GetFence());
 }
 
 UniqueDescriptorSetLayout VKComputePipeline::CreateDescriptorSetLayout() const {
@@ -95,9 +96,12 @@ UniqueShaderModule VKComputePipeline::CreateShaderModule(const std::vector<u32>&
     return dev.createShaderModuleUnique(module_ci, nullptr, device.GetDispatchLoader());
 }
 
-UniquePipeline VKComputePipeline::CreatePipeline() const {
+UniquePipeline VKComputePipeline::CreatePipeline(vk::PipelineCache pipeline_cache,
+                                                 const SpecializationConstants& constants) const {
+    const vk::SpecializationInfo specialization_info = GetSpecializationInfo(constants);
     vk::PipelineShaderStageCreateInfo shader_stage_ci({}, vk::ShaderStageFlagBits::eCompute,
-                                                      *shader_module, "main", nullptr);
+                                                      *shader_module, "main",
+                                                      &specialization_info);
     vk::PipelineShaderStageRequiredSubgroupSizeCreateInfoEXT subgroup_size_ci;
     subgroup_size_ci.requiredSubgroupSize = GuestWarpSize;
     if (entries.uses_warps && device.IsGuestWarpSizeSupported(vk::ShaderStageFlagBits::eCompute)) {
@@ -106,7 +110,8 @@ UniquePipeline VKComputePipeline::CreatePipeline() const {
 
     const vk::ComputePipelineCreateInfo create_info({}, shader_stage_ci, *layout, {}, 0);
     const auto dev = device.GetLogical();
-    return dev.createComputePipelineUnique({}, create_info, nullptr, device.GetDispatchLoader());
+    return dev.createComputePipelineUnique(pipeline_cache, create_info, nullptr,
+                                          device.GetDispatchLoader());
 }
 
 } // namespace Vulkan
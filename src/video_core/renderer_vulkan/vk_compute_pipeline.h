@@ -22,7 +22,8 @@ public:
     explicit VKComputePipeline(const VKDevice& device, VKScheduler& scheduler,
                                VKDescriptorPool& descriptor_pool,
                                VKUpdateDescriptorQueue& update_descriptor_queue,
-                               const SPIRVShader& shader);
+                               vk::PipelineCache pipeline_cache, const SPIRVShader& shader,
+                               const SpecializationConstants& constants);
     ~VKComputePipeline();
 
     vk::DescriptorSet CommitDescriptorSet();
@@ -48,7 +49,8 @@ private:
 
     UniqueShaderModule CreateShaderModule(const std::vector<u32>& code) const;
 
-    UniquePipeline CreatePipeline() const;
+    UniquePipeline CreatePipeline(vk::PipelineCache pipeline_cache,
+                                  const SpecializationConstants& constants) const;
 
     const VKDevice& device;
     VKScheduler& scheduler;
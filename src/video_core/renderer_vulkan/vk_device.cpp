@@ -12,6 +12,7 @@
 #include <vector>
 #include "common/assert.h"
 #include "core/settings.h"
+#include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/vk_device.h"
 
@@ -102,12 +103,14 @@ bool VKDevice::Create(const vk::DispatchLoaderDynamic& dldi, vk::Instance instan
     features.largePoints = true;
     features.multiViewport = true;
     features.depthBiasClamp = true;
+    features.occlusionQueryPrecise = true;
     features.geometryShader = true;
     features.tessellationShader = true;
     features.fragmentStoresAndAtomics = true;
     features.shaderImageGatherExtended = true;
     features.shaderStorageImageWriteWithoutFormat = true;
     features.textureCompressionASTC_LDR = is_optimal_astc_supported;
+    features.multiDrawIndirect = is_multi_draw_indirect_supported;
 
     vk::PhysicalDevice16BitStorageFeaturesKHR bit16_storage;
     bit16_storage.uniformAndStorageBuffer16BitAccess = true;
@@ -145,6 +148,22 @@ bool VKDevice::Create(const vk::DispatchLoaderDynamic& dldi, vk::Instance instan
         LOG_INFO(Render_Vulkan, "Device doesn't support depth range unrestricted");
     }
 
+    vk::PhysicalDeviceTransformFeedbackFeaturesEXT transform_feedback;
+    if (ext_transform_feedback) {
+        transform_feedback.transformFeedback = true;
+        SetNext(next, transform_feedback);
+    } else {
+        LOG_INFO(Render_Vulkan, "Device doesn't support transform feedbacks");
+    }
+
+    vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore;
+    if (khr_timeline_semaphore) {
+        timeline_semaphore.timelineSemaphore = true;
+        SetNext(next, timeline_semaphore);
+    } else {
+        LOG_INFO(Render_Vulkan, "Device doesn't support timeline semaphores");
+    }
+
     vk::DeviceCreateInfo device_ci({}, static_cast<u32>(queue_cis.size()), queue_cis.data(), 0,
                                    nullptr, static_cast<u32>(extensions.size()), extensions.data(),
                                    nullptr);
@@ -338,6 +357,7 @@ bool VKDevice::IsSuitable(const vk::DispatchLoaderDynamic& dldi, vk::PhysicalDev
         std::make_pair(features.largePoints, "largePoints"),
         std::make_pair(features.multiViewport, "multiViewport"),
         std::make_pair(features.depthBiasClamp, "depthBiasClamp"),
+        std::make_pair(features.occlusionQueryPrecise, "occlusionQueryPrecise"),
         std::make_pair(features.geometryShader, "geometryShader"),
         std::make_pair(features.tessellationShader, "tessellationShader"),
         std::make_pair(features.fragmentStoresAndAtomics, "fragmentStoresAndAtomics"),
@@ -376,7 +396,7 @@ std::vector<const char*> VKDevice::LoadExtensions(const vk::DispatchLoaderDynami
         }
     };
 
-    extensions.reserve(13);
+    extensions.reserve(15);
     extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     extensions.push_back(VK_KHR_16BIT_STORAGE_EXTENSION_NAME);
     extensions.push_back(VK_KHR_8BIT_STORAGE_EXTENSION_NAME);
@@ -389,6 +409,8 @@ std::vector<const char*> VKDevice::LoadExtensions(const vk::DispatchLoaderDynami
         std::getenv("NVTX_INJECTION64_PATH") || std::getenv("NSIGHT_LAUNCHED");
     bool khr_shader_float16_int8{};
     bool ext_subgroup_size_control{};
+    bool has_ext_transform_feedback{};
+    bool has_khr_timeline_semaphore{};
     for (const auto& extension : physical.enumerateDeviceExtensionProperties(nullptr, dldi)) {
         Test(extension, khr_uniform_buffer_standard_layout,
              VK_KHR_UNIFORM_BUFFER_STANDARD_LAYOUT_EXTENSION_NAME, true);
@@ -400,6 +422,10 @@ std::vector<const char*> VKDevice::LoadExtensions(const vk::DispatchLoaderDynami
              VK_EXT_SHADER_VIEWPORT_INDEX_LAYER_EXTENSION_NAME, true);
         Test(extension, ext_subgroup_size_control, VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME,
              false);
+        Test(extension, has_ext_transform_feedback, VK_EXT_TRANSFORM_FEEDBACK_EXTENSION_NAME,
+             false);
+        Test(extension, has_khr_timeline_semaphore, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+             false);
         if (Settings::values.renderer_debug) {
             Test(extension, nv_device_diagnostic_checkpoints,
                  VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME, true);
@@ -429,6 +455,30 @@ std::vector<const char*> VKDevice::LoadExtensions(const vk::DispatchLoaderDynami
         is_warp_potentially_bigger = true;
     }
 
+    if (has_ext_transform_feedback) {
+        const auto features =
+            GetFeatures<vk::PhysicalDeviceTransformFeedbackFeaturesEXT>(physical, dldi);
+        const auto properties =
+            GetProperties<vk::PhysicalDeviceTransformFeedbackPropertiesEXT>(physical, dldi);
+
+        // Every guest buffer has to be bindable at the same time
+        constexpr u32 num_buffers = static_cast<u32>(
+            Tegra::Engines::Maxwell3D::Regs::NumTransformFeedbackBuffers);
+        if (features.transformFeedback && properties.maxTransformFeedbackBuffers >= num_buffers) {
+            extensions.push_back(VK_EXT_TRANSFORM_FEEDBACK_EXTENSION_NAME);
+            ext_transform_feedback = true;
+        }
+    }
+
+    if (has_khr_timeline_semaphore) {
+        const auto features =
+            GetFeatures<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>(physical, dldi);
+        if (features.timelineSemaphore) {
+            extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+            khr_timeline_semaphore = true;
+        }
+    }
+
     return extensions;
 }
 
@@ -458,6 +508,7 @@ void VKDevice::SetupFamilies(const vk::DispatchLoaderDynamic& dldi, vk::SurfaceK
 void VKDevice::SetupFeatures(const vk::DispatchLoaderDynamic& dldi) {
     const auto supported_features{physical.getFeatures(dldi)};
     is_optimal_astc_supported = IsOptimalAstcSupported(supported_features, dldi);
+    is_multi_draw_indirect_supported = supported_features.multiDrawIndirect;
 }
 
 void VKDevice::CollectTelemetryParameters() {
@@ -550,7 +601,33 @@ std::unordered_map<vk::Format, vk::FormatProperties> VKDevice::GetFormatProperti
                                         vk::Format::eAstc8x6SrgbBlock,
                                         vk::Format::eAstc6x5UnormBlock,
                                         vk::Format::eAstc6x5SrgbBlock,
-                                        vk::Format::eE5B9G9R9UfloatPack32};
+                                        vk::Format::eE5B9G9R9UfloatPack32,
+                                        vk::Format::eR8Snorm,
+                                        vk::Format::eR8G8B8Snorm,
+                                        vk::Format::eR8G8B8A8Snorm,
+                                        vk::Format::eR16Snorm,
+                                        vk::Format::eR16G16B16Snorm,
+                                        vk::Format::eR16G16B16A16Snorm,
+                                        vk::Format::eA2B10G10R10SnormPack32,
+                                        vk::Format::eR8G8B8Unorm,
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        vk::Format::eR16G16B16Unorm,
+                                        vk::Format::eR16G16B16A16Sint,
+                                        vk::Format::eR8Sint,
+                                        vk::Format::eR8G8Sint,
+                                        vk::Format::eR8G8B8Sint,
+                                        vk::Format::eR8G8B8A8Sint,
+                                        vk::Format::eR32Sint,
+                                        vk::Format::eR32G32Sint,
+                                        vk::Format::eR32G32B32Sint,
+                                        vk::Format::eR32G32B32A32Sint,
+                                        vk::Format::eR8G8Uint,
+                                        vk::Format::eR8G8B8Uint,
+                                        vk::Format::eR8G8B8A8Uint,
+                                        vk::Format::eR32G32B32Uint,
+                                        vk::Format::eR8G8Uscaled,
+                                        vk::Format::eR32G32B32Sfloat,
+                                        vk::Format::eR16G16B16Sfloat};
     std::unordered_map<vk::Format, vk::FormatProperties> format_properties;
     for (const auto format : formats) {
         format_properties.emplace(format, physical.getFormatProperties(format, dldi));
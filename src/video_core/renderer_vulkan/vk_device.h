@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -102,6 +105,24 @@ public:
         return driver_id;
     }
 
+    /// Returns the vendor ID of the physical device.
+    u32 GetVendorID() const {
+        return properties.vendorID;
+    }
+
+    /// Returns the device ID of the physical device.
+    u32 GetDeviceID() const {
+        return properties.deviceID;
+    }
+
+    /// Returns the UUID identifying pipeline cache data compatible with this device.
+    std::array<u8, VK_UUID_SIZE> GetPipelineCacheUUID() const {
+        std::array<u8, VK_UUID_SIZE> uuid;
+        std::copy(std::begin(properties.pipelineCacheUUID), std::end(properties.pipelineCacheUUID),
+                  uuid.begin());
+        return uuid;
+    }
+
     /// Returns uniform buffer alignment requeriment.
     vk::DeviceSize GetUniformBufferAlignment() const {
         return properties.limits.minUniformBufferOffsetAlignment;
@@ -122,11 +143,26 @@ public:
         return properties.limits.maxPushConstantsSize;
     }
 
+    /// Returns true if the graphics and compute queues support timestamp queries.
+    bool IsTimestampSupported() const {
+        return properties.limits.timestampComputeAndGraphics;
+    }
+
+    /// Returns the nanoseconds it takes for a timestamp query to be incremented by one.
+    float GetTimestampPeriod() const {
+        return properties.limits.timestampPeriod;
+    }
+
     /// Returns true if ASTC is natively supported.
     bool IsOptimalAstcSupported() const {
         return is_optimal_astc_supported;
     }
 
+    /// Returns true if indirect draws can read more than one command.
+    bool IsMultiDrawIndirectSupported() const {
+        return is_multi_draw_indirect_supported;
+    }
+
     /// Returns true if the device supports float16 natively
     bool IsFloat16Supported() const {
         return is_float16_supported;
@@ -162,6 +198,16 @@ public:
         return ext_shader_viewport_index_layer;
     }
 
+    /// Returns true if the device supports VK_EXT_transform_feedback.
+    bool IsExtTransformFeedbackSupported() const {
+        return ext_transform_feedback;
+    }
+
+    /// Returns true if the device supports VK_KHR_timeline_semaphore.
+    bool IsKhrTimelineSemaphoreSupported() const {
+        return khr_timeline_semaphore;
+    }
+
     /// Returns true if the device supports VK_NV_device_diagnostic_checkpoints.
     bool IsNvDeviceDiagnosticCheckpoints() const {
         return nv_device_diagnostic_checkpoints;
@@ -221,11 +267,14 @@ private:
     vk::ShaderStageFlags guest_warp_stages{};  ///< Stages where the guest warp size can be forced.
     bool is_optimal_astc_supported{};          ///< Support for native ASTC.
     bool is_float16_supported{};               ///< Support for float16 arithmetics.
+    bool is_multi_draw_indirect_supported{};   ///< Support for multiDrawIndirect.
     bool is_warp_potentially_bigger{};         ///< Host warp size can be bigger than guest.
     bool khr_uniform_buffer_standard_layout{}; ///< Support for std430 on UBOs.
     bool ext_index_type_uint8{};               ///< Support for VK_EXT_index_type_uint8.
     bool ext_depth_range_unrestricted{};       ///< Support for VK_EXT_depth_range_unrestricted.
     bool ext_shader_viewport_index_layer{};    ///< Support for VK_EXT_shader_viewport_index_layer.
+    bool ext_transform_feedback{};             ///< Support for VK_EXT_transform_feedback.
+    bool khr_timeline_semaphore{};             ///< Support for VK_KHR_timeline_semaphore.
     bool nv_device_diagnostic_checkpoints{};   ///< Support for VK_NV_device_diagnostic_checkpoints.
 
     // Telemetry parameters
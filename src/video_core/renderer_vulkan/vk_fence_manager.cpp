@@ -0,0 +1,61 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+
+#include "video_core/renderer_vulkan/vk_fence_manager.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+namespace Vulkan {
+
+InnerFence::InnerFence(VKScheduler& scheduler, u32 syncpoint_id, bool is_stubbed)
+    : VideoCommon::FenceBase{syncpoint_id, is_stubbed}, scheduler{scheduler} {}
+
+InnerFence::~InnerFence() = default;
+
+void InnerFence::Queue() {
+    if (is_stubbed) {
+        return;
+    }
+    watch.Watch(scheduler.GetFence());
+    // The watched fence has to be submitted, otherwise waiting on it would never return
+    scheduler.Flush();
+}
+
+bool InnerFence::IsSignaled() const {
+    if (is_stubbed) {
+        return true;
+    }
+    return !watch.IsUsed();
+}
+
+void InnerFence::Wait() {
+    if (is_stubbed) {
+        return;
+    }
+    watch.Wait();
+}
+
+VKFenceManager::VKFenceManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
+                               VKTextureCache& texture_cache, VKBufferCache& buffer_cache,
+                               VKScheduler& scheduler)
+    : GenericFenceManager{system, rasterizer, texture_cache, buffer_cache}, scheduler{scheduler} {}
+
+Fence VKFenceManager::CreateFence(u32 syncpoint_id, bool is_stubbed) {
+    return std::make_shared<InnerFence>(scheduler, syncpoint_id, is_stubbed);
+}
+
+void VKFenceManager::QueueFence(Fence& fence) {
+    fence->Queue();
+}
+
+bool VKFenceManager::IsFenceSignaled(Fence& fence) const {
+    return fence->IsSignaled();
+}
+
+void VKFenceManager::WaitFence(Fence& fence) {
+    fence->Wait();
+}
+
+} // namespace Vulkan
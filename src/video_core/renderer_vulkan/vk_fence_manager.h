@@ -0,0 +1,61 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "video_core/fence_manager.h"
+#include "video_core/renderer_vulkan/vk_buffer_cache.h"
+#include "video_core/renderer_vulkan/vk_resource_manager.h"
+#include "video_core/renderer_vulkan/vk_texture_cache.h"
+
+namespace Core {
+class System;
+}
+
+namespace VideoCore {
+class RasterizerInterface;
+}
+
+namespace Vulkan {
+
+class VKScheduler;
+
+class InnerFence : public VideoCommon::FenceBase {
+public:
+    explicit InnerFence(VKScheduler& scheduler, u32 syncpoint_id, bool is_stubbed);
+    ~InnerFence();
+
+    void Queue();
+
+    bool IsSignaled() const;
+
+    void Wait();
+
+private:
+    VKScheduler& scheduler;
+    VKFenceWatch watch;
+};
+
+using Fence = std::shared_ptr<InnerFence>;
+using GenericFenceManager = VideoCommon::FenceManager<Fence, VKTextureCache, VKBufferCache>;
+
+class VKFenceManager final : public GenericFenceManager {
+public:
+    explicit VKFenceManager(Core::System& system, VideoCore::RasterizerInterface& rasterizer,
+                            VKTextureCache& texture_cache, VKBufferCache& buffer_cache,
+                            VKScheduler& scheduler);
+
+protected:
+    Fence CreateFence(u32 syncpoint_id, bool is_stubbed) override;
+    void QueueFence(Fence& fence) override;
+    bool IsFenceSignaled(Fence& fence) const override;
+    void WaitFence(Fence& fence) override;
+
+private:
+    VKScheduler& scheduler;
+};
+
+} // namespace Vulkan
@@ -0,0 +1,81 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include "common/common_types.h"
+#include "core/frame_timeline.h"
+#include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_frame_timer.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+namespace Vulkan {
+
+VKFrameTimer::VKFrameTimer(const VKDevice& device, VKScheduler& scheduler)
+    : device{device}, scheduler{scheduler} {
+    if (!device.IsTimestampSupported()) {
+        return;
+    }
+    const vk::QueryPoolCreateInfo query_pool_ci({}, vk::QueryType::eTimestamp, NUM_FRAMES * 2,
+                                                {});
+    const auto dev = device.GetLogical();
+    query_pool = dev.createQueryPoolUnique(query_pool_ci, nullptr, device.GetDispatchLoader());
+
+    scheduler.RequestOutsideRenderPassOperationContext();
+    scheduler.Record([pool = *query_pool](auto cmdbuf, auto& dld) {
+        cmdbuf.resetQueryPool(pool, 0, NUM_FRAMES * 2, dld);
+        cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, pool, 0, dld);
+    });
+}
+
+VKFrameTimer::~VKFrameTimer() = default;
+
+void VKFrameTimer::NextFrame() {
+    if (!query_pool) {
+        return;
+    }
+    const u32 end_query = frame_index * 2 + 1;
+    pending[frame_index] = true;
+
+    frame_index = (frame_index + 1) % NUM_FRAMES;
+    const u32 begin_query = frame_index * 2;
+    // A frame that is still running after a full ring of frames is dropped from the stats
+    pending[frame_index] = false;
+
+    scheduler.RequestOutsideRenderPassOperationContext();
+    scheduler.Record([pool = *query_pool, end_query, begin_query](auto cmdbuf, auto& dld) {
+        cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, pool, end_query, dld);
+        cmdbuf.resetQueryPool(pool, begin_query, 2, dld);
+        cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, pool, begin_query, dld);
+    });
+}
+
+void VKFrameTimer::Collect() {
+    if (!query_pool) {
+        return;
+    }
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    const double period = static_cast<double>(device.GetTimestampPeriod());
+    for (u32 frame = 0; frame < NUM_FRAMES; ++frame) {
+        if (!pending[frame]) {
+            continue;
+        }
+        std::array<u64, 2> timestamps{};
+        const vk::Result result = dev.getQueryPoolResults(
+            *query_pool, frame * 2, 2, sizeof(timestamps), timestamps.data(), sizeof(u64),
+            vk::QueryResultFlagBits::e64, dld);
+        if (result != vk::Result::eSuccess) {
+            continue;
+        }
+        const auto ticks = static_cast<double>(timestamps[1] - timestamps[0]);
+        Core::FrameTimeline::GetInstance().AddTime(
+            Core::FrameTimeline::Stage::HostGpu,
+            std::chrono::nanoseconds(static_cast<s64>(ticks * period)));
+        pending[frame] = false;
+    }
+}
+
+} // namespace Vulkan
@@ -0,0 +1,40 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/declarations.h"
+
+namespace Vulkan {
+
+class VKDevice;
+class VKScheduler;
+
+/// Measures the host GPU time of the presented frames with timestamp queries.
+class VKFrameTimer {
+public:
+    explicit VKFrameTimer(const VKDevice& device, VKScheduler& scheduler);
+    ~VKFrameTimer();
+
+    /// Records the end of the current frame and the beginning of the next one. Must be called
+    /// before the frame is flushed.
+    void NextFrame();
+
+    /// Accounts the time of the frames whose timestamps are available, without waiting.
+    void Collect();
+
+private:
+    static constexpr u32 NUM_FRAMES = 4;
+
+    const VKDevice& device;
+    VKScheduler& scheduler;
+
+    UniqueQueryPool query_pool; ///< Begin and end timestamps of each frame, null if unsupported
+    std::array<bool, NUM_FRAMES> pending{};
+    u32 frame_index = 0;
+};
+
+} // namespace Vulkan
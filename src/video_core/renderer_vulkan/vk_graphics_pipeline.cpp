@@ -47,7 +47,7 @@ bool SupportsPrimitiveRestart(vk::PrimitiveTopology topology) {
 VKGraphicsPipeline::VKGraphicsPipeline(const VKDevice& device, VKScheduler& scheduler,
                                        VKDescriptorPool& descriptor_pool,
                                        VKUpdateDescriptorQueue& update_descriptor_queue,
-                                       VKRenderPassCache& renderpass_cache,
+                                       vk::PipelineCache pipeline_cache, vk::RenderPass renderpass,
                                        const GraphicsPipelineCacheKey& key,
                                        const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
                                        const SPIRVProgram& program)
@@ -55,11 +55,9 @@ VKGraphicsPipeline::VKGraphicsPipeline(const VKDevice& device, VKScheduler& sche
       descriptor_set_layout{CreateDescriptorSetLayout(bindings)},
       descriptor_allocator{descriptor_pool, *descriptor_set_layout},
       update_descriptor_queue{update_descriptor_queue}, layout{CreatePipelineLayout()},
-      descriptor_template{CreateDescriptorUpdateTemplate(program)}, modules{CreateShaderModules(
-                                                                        program)},
-      renderpass{renderpass_cache.GetRenderPass(key.renderpass_params)}, pipeline{CreatePipeline(
-                                                                             key.renderpass_params,
-                                                                             program)} {}
+      descriptor_template{CreateDescriptorUpdateTemplate(program)},
+      modules{CreateShaderModules(program)}, renderpass{renderpass},
+      pipeline{CreatePipeline(pipeline_cache, key.renderpass_params, program)} {}
 
 VKGraphicsPipeline::~VKGraphicsPipeline() = default;
 
@@ -67,9 +65,8 @@ vk::DescriptorSet VKGraphicsPipeline::CommitDescriptorSet() {
     if (!descriptor_template) {
         return {};
     }
-    const auto set = descriptor_allocator.Commit(scheduler.GetFence());
-    update_descriptor_queue.Send(*descriptor_template, set);
-    return set;
+    return update_descriptor_queue.Send(*descriptor_template, descriptor_allocator,
+                                        scheduler.GetFence());
 }
 
 UniqueDescriptorSetLayout VKGraphicsPipeline::CreateDescriptorSetLayout(
@@ -126,14 +123,15 @@ std::vector<UniqueShaderModule> VKGraphicsPipeline::CreateShaderModules(
         if (!stage) {
             continue;
         }
-        const vk::ShaderModuleCreateInfo module_ci({}, stage->code.size() * sizeof(u32),
-                                                   stage->code.data());
+        const vk::ShaderModuleCreateInfo module_ci({}, stage->code->size() * sizeof(u32),
+                                                   stage->code->data());
         modules.emplace_back(dev.createShaderModuleUnique(module_ci, nullptr, dld));
     }
     return modules;
 }
 
-UniquePipeline VKGraphicsPipeline::CreatePipeline(const RenderPassParams& renderpass_params,
+UniquePipeline VKGraphicsPipeline::CreatePipeline(vk::PipelineCache pipeline_cache,
+                                                  const RenderPassParams& renderpass_params,
                                                   const SPIRVProgram& program) const {
     const auto& vi = fixed_state.vertex_input;
     const auto& ia = fixed_state.input_assembly;
@@ -242,6 +240,14 @@ UniquePipeline VKGraphicsPipeline::CreatePipeline(const RenderPassParams& render
     vk::PipelineShaderStageRequiredSubgroupSizeCreateInfoEXT subgroup_size_ci;
     subgroup_size_ci.requiredSubgroupSize = GuestWarpSize;
 
+    SpecializationConstants constants;
+    constants.ndc_minus_one_to_one = rs.ndc_minus_one_to_one ? 1 : 0;
+    if (ia.topology == Maxwell::PrimitiveTopology::Points) {
+        ASSERT(ia.point_size != 0.0f);
+        constants.point_size = ia.point_size;
+    }
+    const vk::SpecializationInfo specialization_info = GetSpecializationInfo(constants);
+
     std::vector<vk::PipelineShaderStageCreateInfo> shader_stages;
     std::size_t module_index = 0;
     for (std::size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
@@ -251,7 +257,8 @@ UniquePipeline VKGraphicsPipeline::CreatePipeline(const RenderPassParams& render
         const auto stage_enum = static_cast<Tegra::Engines::ShaderType>(stage);
         const auto vk_stage = MaxwellToVK::ShaderStage(stage_enum);
         auto& stage_ci = shader_stages.emplace_back(vk::PipelineShaderStageCreateFlags{}, vk_stage,
-                                                    *modules[module_index++], "main", nullptr);
+                                                    *modules[module_index++], "main",
+                                                    &specialization_info);
         if (program[stage]->entries.uses_warps && device.IsGuestWarpSizeSupported(vk_stage)) {
             stage_ci.pNext = &subgroup_size_ci;
         }
@@ -264,7 +271,7 @@ UniquePipeline VKGraphicsPipeline::CreatePipeline(const RenderPassParams& render
 
     const auto dev = device.GetLogical();
     const auto& dld = device.GetDispatchLoader();
-    return dev.createGraphicsPipelineUnique(nullptr, create_info, nullptr, dld);
+    return dev.createGraphicsPipelineUnique(pipeline_cache, create_info, nullptr, dld);
 }
 
 } // namespace Vulkan
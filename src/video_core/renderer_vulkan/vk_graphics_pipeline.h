@@ -26,7 +26,6 @@ struct GraphicsPipelineCacheKey;
 
 class VKDescriptorPool;
 class VKDevice;
-class VKRenderPassCache;
 class VKScheduler;
 class VKUpdateDescriptorQueue;
 
@@ -37,7 +36,7 @@ public:
     explicit VKGraphicsPipeline(const VKDevice& device, VKScheduler& scheduler,
                                 VKDescriptorPool& descriptor_pool,
                                 VKUpdateDescriptorQueue& update_descriptor_queue,
-                                VKRenderPassCache& renderpass_cache,
+                                vk::PipelineCache pipeline_cache, vk::RenderPass renderpass,
                                 const GraphicsPipelineCacheKey& key,
                                 const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
                                 const SPIRVProgram& program);
@@ -68,7 +67,8 @@ private:
 
     std::vector<UniqueShaderModule> CreateShaderModules(const SPIRVProgram& program) const;
 
-    UniquePipeline CreatePipeline(const RenderPassParams& renderpass_params,
+    UniquePipeline CreatePipeline(vk::PipelineCache pipeline_cache,
+                                  const RenderPassParams& renderpass_params,
                                   const SPIRVProgram& program) const;
 
     const VKDevice& device;
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <iterator>
+#include <map>
 #include <optional>
 #include <tuple>
 #include <vector>
@@ -32,7 +34,9 @@ public:
     explicit VKMemoryAllocation(const VKDevice& device, vk::DeviceMemory memory,
                                 vk::MemoryPropertyFlags properties, u64 allocation_size, u32 type)
         : device{device}, memory{memory}, properties{properties}, allocation_size{allocation_size},
-          shifted_type{ShiftType(type)} {}
+          shifted_type{ShiftType(type)} {
+        InsertFreeRange(0, allocation_size);
+    }
 
     ~VKMemoryAllocation() {
         const auto dev = device.GetLogical();
@@ -41,35 +45,37 @@ public:
     }
 
     VKMemoryCommit Commit(vk::DeviceSize commit_size, vk::DeviceSize alignment) {
-        auto found = TryFindFreeSection(free_iterator, allocation_size,
-                                        static_cast<u64>(commit_size), static_cast<u64>(alignment));
+        const auto found = TryFindFreeSection(static_cast<u64>(commit_size),
+                                              static_cast<u64>(alignment));
         if (!found) {
-            found = TryFindFreeSection(0, free_iterator, static_cast<u64>(commit_size),
-                                       static_cast<u64>(alignment));
-            if (!found) {
-                // Signal out of memory, it'll try to do more allocations.
-                return nullptr;
-            }
+            // Signal out of memory, it'll try to do more allocations.
+            return nullptr;
         }
-        auto commit = std::make_unique<VKMemoryCommitImpl>(device, this, memory, *found,
-                                                           *found + commit_size);
-        commits.push_back(commit.get());
-
-        // Last commit's address is highly probable to be free.
-        free_iterator = *found + commit_size;
-
-        return commit;
+        return std::make_unique<VKMemoryCommitImpl>(device, this, memory, *found,
+                                                    *found + commit_size);
     }
 
     void Free(const VKMemoryCommitImpl* commit) {
         ASSERT(commit);
 
-        const auto it = std::find(std::begin(commits), std::end(commits), commit);
-        if (it == commits.end()) {
-            UNREACHABLE_MSG("Freeing unallocated commit!");
-            return;
+        auto [begin, end] = commit->interval;
+        ASSERT_MSG(end <= allocation_size, "Freeing unallocated commit!");
+
+        // Merge the freed range with its neighbours
+        const auto next = free_ranges.lower_bound(begin);
+        if (next != free_ranges.end() && next->first == end) {
+            end = next->first + next->second;
+            EraseFreeRange(next);
+        }
+        const auto next_after_merge = free_ranges.lower_bound(begin);
+        if (next_after_merge != free_ranges.begin()) {
+            const auto previous = std::prev(next_after_merge);
+            if (previous->first + previous->second == begin) {
+                begin = previous->first;
+                EraseFreeRange(previous);
+            }
         }
-        commits.erase(it);
+        InsertFreeRange(begin, end - begin);
     }
 
     /// Returns whether this allocation is compatible with the arguments.
@@ -78,50 +84,88 @@ public:
                (type_mask & shifted_type) != 0;
     }
 
+    /// Returns the size of the allocation.
+    u64 GetSize() const {
+        return allocation_size;
+    }
+
+    /// Returns the number of bytes not committed.
+    u64 GetFreeSize() const {
+        return free_size;
+    }
+
+    /// Returns the size of the largest free range.
+    u64 GetLargestFreeRange() const {
+        return free_ranges_by_size.empty() ? 0 : std::prev(free_ranges_by_size.end())->first;
+    }
+
+    /// Returns the number of free ranges.
+    std::size_t GetNumFreeRanges() const {
+        return free_ranges.size();
+    }
+
 private:
+    using FreeRangeMap = std::map<u64, u64>;
+
     static constexpr u32 ShiftType(u32 type) {
         return 1U << type;
     }
 
-    /// A memory allocator, it may return a free region between "start" and "end" with the solicited
-    /// requirements.
-    std::optional<u64> TryFindFreeSection(u64 start, u64 end, u64 size, u64 alignment) const {
-        u64 iterator = Common::AlignUp(start, alignment);
-        while (iterator + size <= end) {
-            const u64 try_left = iterator;
-            const u64 try_right = try_left + size;
-
-            bool overlap = false;
-            for (const auto& commit : commits) {
-                const auto [commit_left, commit_right] = commit->interval;
-                if (try_left < commit_right && commit_left < try_right) {
-                    // There's an overlap, continue the search where the overlapping commit ends.
-                    iterator = Common::AlignUp(commit_right, alignment);
-                    overlap = true;
-                    break;
-                }
+    /// Searches the smallest free range where a region with the solicited requirements fits and
+    /// removes the region from it.
+    std::optional<u64> TryFindFreeSection(u64 size, u64 alignment) {
+        // Alignment is usually satisfied by the first candidate, padding is only needed when the
+        // range starts unaligned.
+        for (auto it = free_ranges_by_size.lower_bound(size); it != free_ranges_by_size.end();
+             ++it) {
+            const auto range = it->second;
+            const u64 range_begin = range->first;
+            const u64 range_end = range_begin + range->second;
+            const u64 aligned_begin = Common::AlignUp(range_begin, alignment);
+            if (aligned_begin + size > range_end) {
+                continue;
+            }
+
+            // Split the range, keeping the alignment padding and the remaining tail as free
+            EraseFreeRange(range);
+            if (aligned_begin != range_begin) {
+                InsertFreeRange(range_begin, aligned_begin - range_begin);
             }
-            if (!overlap) {
-                // A free address has been found.
-                return try_left;
+            if (aligned_begin + size != range_end) {
+                InsertFreeRange(aligned_begin + size, range_end - aligned_begin - size);
             }
+            return aligned_begin;
         }
 
         // No free regions where found, return an empty optional.
         return std::nullopt;
     }
 
+    void InsertFreeRange(u64 offset, u64 size) {
+        const auto it = free_ranges.emplace(offset, size).first;
+        free_ranges_by_size.emplace(size, it);
+        free_size += size;
+    }
+
+    void EraseFreeRange(FreeRangeMap::iterator range) {
+        auto [it, end] = free_ranges_by_size.equal_range(range->second);
+        while (it->second != range) {
+            ++it;
+        }
+        free_ranges_by_size.erase(it);
+        free_size -= range->second;
+        free_ranges.erase(range);
+    }
+
     const VKDevice& device;                   ///< Vulkan device.
     const vk::DeviceMemory memory;            ///< Vulkan memory allocation handler.
     const vk::MemoryPropertyFlags properties; ///< Vulkan properties.
     const u64 allocation_size;                ///< Size of this allocation.
     const u32 shifted_type;                   ///< Stored Vulkan type of this allocation, shifted.
 
-    /// Hints where the next free region is likely going to be.
-    u64 free_iterator{};
-
-    /// Stores all commits done from this allocation.
-    std::vector<const VKMemoryCommitImpl*> commits;
+    FreeRangeMap free_ranges; ///< Free ranges sorted by offset, mapped to their sizes.
+    std::multimap<u64, FreeRangeMap::iterator> free_ranges_by_size; ///< Free ranges by size.
+    u64 free_size{};                                                ///< Bytes not committed.
 };
 
 VKMemoryManager::VKMemoryManager(const VKDevice& device)
@@ -147,6 +191,7 @@ VKMemoryCommit VKMemoryManager::Commit(const vk::MemoryRequirements& requirement
     }
 
     // Commit has failed, allocate more memory.
+    LogFragmentation(wanted_properties, requirements.memoryTypeBits);
     if (!AllocMemory(wanted_properties, requirements.memoryTypeBits, chunk_size)) {
         // TODO(Rodrigo): Handle these situations in some way like flushing to guest memory.
         // Allocation has failed, panic.
@@ -207,6 +252,34 @@ bool VKMemoryManager::AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32
     return true;
 }
 
+void VKMemoryManager::LogFragmentation(vk::MemoryPropertyFlags wanted_properties,
+                                       u32 type_mask) const {
+    u64 total_size = 0;
+    u64 free_size = 0;
+    u64 largest_free_range = 0;
+    std::size_t num_free_ranges = 0;
+    for (const auto& allocation : allocations) {
+        if (!allocation->IsCompatible(wanted_properties, type_mask)) {
+            continue;
+        }
+        total_size += allocation->GetSize();
+        free_size += allocation->GetFreeSize();
+        largest_free_range = std::max(largest_free_range, allocation->GetLargestFreeRange());
+        num_free_ranges += allocation->GetNumFreeRanges();
+    }
+    if (total_size == 0) {
+        return;
+    }
+    // Fragmentation is the share of free memory that isn't part of the largest free range
+    const u64 fragmentation =
+        free_size == 0 ? 0 : (free_size - largest_free_range) * 100 / free_size;
+    LOG_DEBUG(Render_Vulkan,
+              "Allocating a new chunk, {} MiB committed of {} MiB, {} free ranges, largest free "
+              "range is {} KiB, fragmentation {}%",
+              (total_size - free_size) >> 20, total_size >> 20, num_free_ranges,
+              largest_free_range >> 10, fragmentation);
+}
+
 VKMemoryCommit VKMemoryManager::TryAllocCommit(const vk::MemoryRequirements& requirements,
                                                vk::MemoryPropertyFlags wanted_properties) {
     for (auto& allocation : allocations) {
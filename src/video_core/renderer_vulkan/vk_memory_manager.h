@@ -49,6 +49,9 @@ private:
     /// Allocates a chunk of memory.
     bool AllocMemory(vk::MemoryPropertyFlags wanted_properties, u32 type_mask, u64 size);
 
+    /// Logs the fragmentation of the allocations compatible with the arguments.
+    void LogFragmentation(vk::MemoryPropertyFlags wanted_properties, u32 type_mask) const;
+
     /// Tries to allocate a memory commit.
     VKMemoryCommit TryAllocCommit(const vk::MemoryRequirements& requirements,
                                   vk::MemoryPropertyFlags wanted_properties);
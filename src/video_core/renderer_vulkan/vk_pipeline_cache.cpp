@@ -3,13 +3,18 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "common/microprofile.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/memory.h"
+#include "core/settings.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/memory_manager.h"
@@ -25,14 +30,17 @@
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
 #include "video_core/renderer_vulkan/vk_update_descriptor.h"
 #include "video_core/shader/compiler_settings.h"
+#include "video_core/shader/memory_util.h"
 
 namespace Vulkan {
 
 MICROPROFILE_DECLARE(Vulkan_PipelineCache);
 
 using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::GetShaderCode;
 
 namespace {
 
@@ -46,53 +54,6 @@ GPUVAddr GetShaderAddress(Core::System& system, Maxwell::ShaderProgram program)
     return gpu.regs.code_address.CodeAddress() + shader_config.offset;
 }
 
-/// Gets if the current instruction offset is a scheduler instruction
-constexpr bool IsSchedInstruction(std::size_t offset, std::size_t main_offset) {
-    // Sched instructions appear once every 4 instructions.
-    constexpr std::size_t SchedPeriod = 4;
-    const std::size_t absolute_offset = offset - main_offset;
-    return (absolute_offset % SchedPeriod) == 0;
-}
-
-/// Calculates the size of a program stream
-std::size_t CalculateProgramSize(const ProgramCode& program, bool is_compute) {
-    const std::size_t start_offset = is_compute ? 0 : 10;
-    // This is the encoded version of BRA that jumps to itself. All Nvidia
-    // shaders end with one.
-    constexpr u64 self_jumping_branch = 0xE2400FFFFF07000FULL;
-    constexpr u64 mask = 0xFFFFFFFFFF7FFFFFULL;
-    std::size_t offset = start_offset;
-    while (offset < program.size()) {
-        const u64 instruction = program[offset];
-        if (!IsSchedInstruction(offset, start_offset)) {
-            if ((instruction & mask) == self_jumping_branch) {
-                // End on Maxwell's "nop" instruction
-                break;
-            }
-            if (instruction == 0) {
-                break;
-            }
-        }
-        ++offset;
-    }
-    // The last instruction is included in the program size
-    return std::min(offset + 1, program.size());
-}
-
-/// Gets the shader program code from memory for the specified address
-ProgramCode GetShaderCode(Tegra::MemoryManager& memory_manager, const GPUVAddr gpu_addr,
-                          const u8* host_ptr, bool is_compute) {
-    ProgramCode program_code(VideoCommon::Shader::MAX_PROGRAM_LENGTH);
-    ASSERT_OR_EXECUTE(host_ptr != nullptr, {
-        std::fill(program_code.begin(), program_code.end(), 0);
-        return program_code;
-    });
-    memory_manager.ReadBlockUnsafe(gpu_addr, program_code.data(),
-                                   program_code.size() * sizeof(u64));
-    program_code.resize(CalculateProgramSize(program_code, is_compute));
-    return program_code;
-}
-
 constexpr std::size_t GetStageFromProgram(std::size_t program) {
     return program == 0 ? 0 : program - 1;
 }
@@ -119,6 +80,13 @@ ShaderType GetShaderType(Maxwell::ShaderProgram program) {
     }
 }
 
+/// Key of the decoded code of a shader, the same code can be bound to different stages
+u64 GetDecodedKey(u64 unique_identifier, ShaderType stage, u32 main_offset) {
+    boost::hash_combine(unique_identifier, static_cast<u32>(stage));
+    boost::hash_combine(unique_identifier, main_offset);
+    return unique_identifier;
+}
+
 u32 FillDescriptorLayout(const ShaderEntries& entries,
                          std::vector<vk::DescriptorSetLayoutBinding>& bindings,
                          Maxwell::ShaderProgram program_type, u32 base_binding) {
@@ -139,18 +107,133 @@ u32 FillDescriptorLayout(const ShaderEntries& entries,
     return binding;
 }
 
+/// Clears the state a stage doesn't read, so pipelines that only differ in it share the module
+Specialization NormalizeSpecialization(ShaderType stage, const ShaderEntries& entries,
+                                       const Specialization& specialization) {
+    Specialization result;
+    result.base_binding = specialization.base_binding;
+    switch (stage) {
+    case ShaderType::Vertex:
+        for (const u32 location : entries.attributes) {
+            result.attribute_types.at(location) = specialization.attribute_types.at(location);
+        }
+        result.transform_feedback = specialization.transform_feedback;
+        break;
+    case ShaderType::TesselationEval:
+        result.tessellation.primitive = specialization.tessellation.primitive;
+        result.tessellation.spacing = specialization.tessellation.spacing;
+        result.tessellation.clockwise = specialization.tessellation.clockwise;
+        result.transform_feedback = specialization.transform_feedback;
+        break;
+    case ShaderType::Geometry:
+        result.primitive_topology = specialization.primitive_topology;
+        result.transform_feedback = specialization.transform_feedback;
+        break;
+    case ShaderType::Compute:
+        result.shared_memory_size = specialization.shared_memory_size;
+        break;
+    default:
+        break;
+    }
+    return result;
+}
+
 } // Anonymous namespace
 
+vk::SpecializationInfo GetSpecializationInfo(const SpecializationConstants& constants) {
+    static const std::array map_entries = {
+        vk::SpecializationMapEntry(static_cast<u32>(SpecializationConstant::NdcMinusOneToOne),
+                                   offsetof(SpecializationConstants, ndc_minus_one_to_one),
+                                   sizeof(u32)),
+        vk::SpecializationMapEntry(static_cast<u32>(SpecializationConstant::PointSize),
+                                   offsetof(SpecializationConstants, point_size), sizeof(float)),
+        vk::SpecializationMapEntry(static_cast<u32>(SpecializationConstant::WorkgroupSizeX),
+                                   offsetof(SpecializationConstants, workgroup_size), sizeof(u32)),
+        vk::SpecializationMapEntry(static_cast<u32>(SpecializationConstant::WorkgroupSizeY),
+                                   offsetof(SpecializationConstants, workgroup_size) + sizeof(u32),
+                                   sizeof(u32)),
+        vk::SpecializationMapEntry(static_cast<u32>(SpecializationConstant::WorkgroupSizeZ),
+                                   offsetof(SpecializationConstants, workgroup_size) +
+                                       2 * sizeof(u32),
+                                   sizeof(u32)),
+    };
+    return vk::SpecializationInfo(static_cast<u32>(map_entries.size()), map_entries.data(),
+                                  sizeof(constants), &constants);
+}
+
+DecodedShader::DecodedShader(ProgramCode program_code, u32 main_offset, u64 unique_identifier,
+                             const VideoCommon::Shader::ConstBufferLocker& locker)
+    : program_code{std::move(program_code)}, main_offset{main_offset},
+      unique_identifier{unique_identifier}, locker{locker},
+      shader_ir{this->program_code, main_offset, compiler_settings, this->locker},
+      entries{GenerateShaderEntries(shader_ir)} {}
+
+DecodedShader::~DecodedShader() = default;
+
+std::shared_ptr<const std::vector<u32>> DecodedShader::GetSPIRV(
+    const VKDevice& device, ShaderType stage, const Specialization& specialization) {
+    const Specialization key = NormalizeSpecialization(stage, entries, specialization);
+
+    std::lock_guard lock{spirv_mutex};
+    const auto it = std::find_if(spirv_modules.begin(), spirv_modules.end(),
+                                 [&key](const auto& pair) { return pair.first == key; });
+    if (it != spirv_modules.end()) {
+        return it->second;
+    }
+    auto code = std::make_shared<const std::vector<u32>>(Decompile(device, shader_ir, stage, key));
+    spirv_modules.emplace_back(key, code);
+    return code;
+}
+
 CachedShader::CachedShader(Core::System& system, Tegra::Engines::ShaderType stage,
                            GPUVAddr gpu_addr, VAddr cpu_addr, u8* host_ptr,
                            ProgramCode program_code, u32 main_offset)
-    : RasterizerCacheObject{host_ptr}, gpu_addr{gpu_addr}, cpu_addr{cpu_addr},
-      program_code{std::move(program_code)}, locker{stage, GetEngine(system, stage)},
-      shader_ir{this->program_code, main_offset, compiler_settings, locker},
-      entries{GenerateShaderEntries(shader_ir)} {}
+    : RasterizerCacheObject{host_ptr}, gpu_addr{gpu_addr}, cpu_addr{cpu_addr}, stage{stage} {
+    const u64 unique_identifier = GetUniqueIdentifier(program_code);
+    decoded = std::make_shared<DecodedShader>(std::move(program_code), main_offset,
+                                              unique_identifier,
+                                              VideoCommon::Shader::ConstBufferLocker{
+                                                  stage, GetEngine(system, stage)});
+}
+
+CachedShader::CachedShader(Core::System& system, const ShaderDiskCacheEntry& entry)
+    : RasterizerCacheObject{nullptr}, stage{entry.type},
+      decoded{std::make_shared<DecodedShader>(entry.code, entry.main_offset,
+                                              entry.unique_identifier, MakeLocker(system, entry))} {
+}
+
+CachedShader::CachedShader(Tegra::Engines::ShaderType stage, GPUVAddr gpu_addr, VAddr cpu_addr,
+                           u8* host_ptr, std::shared_ptr<DecodedShader> decoded)
+    : RasterizerCacheObject{host_ptr}, gpu_addr{gpu_addr}, cpu_addr{cpu_addr}, stage{stage},
+      decoded{std::move(decoded)} {}
 
 CachedShader::~CachedShader() = default;
 
+u64 CachedShader::GetUniqueIdentifier(const ProgramCode& code) {
+    return VideoCommon::Shader::GetUniqueIdentifier(code);
+}
+
+ShaderDiskCacheEntry CachedShader::GetDiskCacheEntry() const {
+    ShaderDiskCacheEntry entry;
+    const auto& locker = decoded->locker;
+    entry.unique_identifier = decoded->unique_identifier;
+    entry.type = stage;
+    entry.main_offset = decoded->main_offset;
+    entry.code = decoded->program_code;
+    entry.bound_buffer = locker.GetBoundBuffer();
+    entry.keys = locker.GetKeys();
+    entry.bound_samplers = locker.GetBoundSamplers();
+    entry.bindless_samplers = locker.GetBindlessSamplers();
+    return entry;
+}
+
+VideoCommon::Shader::ConstBufferLocker CachedShader::MakeLocker(Core::System& system,
+                                                                const ShaderDiskCacheEntry& entry) {
+    VideoCommon::Shader::ConstBufferLocker locker{entry.type, GetEngine(system, entry.type)};
+    entry.FillLocker(locker);
+    return locker;
+}
+
 Tegra::Engines::ConstBufferEngineInterface& CachedShader::GetEngine(
     Core::System& system, Tegra::Engines::ShaderType stage) {
     if (stage == Tegra::Engines::ShaderType::Compute) {
@@ -166,11 +249,19 @@ VKPipelineCache::VKPipelineCache(Core::System& system, RasterizerVulkan& rasteri
                                  VKUpdateDescriptorQueue& update_descriptor_queue)
     : RasterizerCache{rasterizer}, system{system}, device{device}, scheduler{scheduler},
       descriptor_pool{descriptor_pool}, update_descriptor_queue{update_descriptor_queue},
-      renderpass_cache(device) {}
-
-VKPipelineCache::~VKPipelineCache() = default;
+      renderpass_cache(device),
+      disk_cache{std::make_unique<VKShaderDiskCache>(system, device)},
+      driver_pipeline_cache{device.GetLogical().createPipelineCacheUnique(
+          {}, nullptr, device.GetDispatchLoader())} {}
+
+VKPipelineCache::~VKPipelineCache() {
+    // Pending builds reference this cache, let them finish before tearing it down
+    build_group.Wait();
+    SaveDriverPipelineCache();
+}
 
 std::array<Shader, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
     const auto& gpu = system.GPU().Maxwell3D();
     auto& dirty = system.GPU().Maxwell3D().dirty.shaders;
     if (!dirty) {
@@ -197,12 +288,7 @@ std::array<Shader, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
             constexpr u32 stage_offset = 10;
             const auto stage = static_cast<Tegra::Engines::ShaderType>(index == 0 ? 0 : index - 1);
             auto code = GetShaderCode(memory_manager, program_addr, host_ptr, false);
-
-            const std::optional cpu_addr = memory_manager.GpuToCpuAddress(program_addr);
-            ASSERT(cpu_addr);
-
-            shader = std::make_shared<CachedShader>(system, stage, program_addr, *cpu_addr,
-                                                    host_ptr, std::move(code), stage_offset);
+            shader = CreateShader(stage, program_addr, host_ptr, std::move(code), stage_offset);
             Register(shader);
         }
         shaders[index] = std::move(shader);
@@ -210,32 +296,62 @@ std::array<Shader, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
     return last_shaders = shaders;
 }
 
-VKGraphicsPipeline& VKPipelineCache::GetGraphicsPipeline(const GraphicsPipelineCacheKey& key) {
+VKGraphicsPipeline* VKPipelineCache::GetGraphicsPipeline(const GraphicsPipelineCacheKey& key) {
     MICROPROFILE_SCOPE(Vulkan_PipelineCache);
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
 
     if (last_graphics_pipeline && last_graphics_key == key) {
-        return *last_graphics_pipeline;
+        return last_graphics_pipeline;
     }
-    last_graphics_key = key;
 
-    const auto [pair, is_cache_miss] = graphics_cache.try_emplace(key);
-    auto& entry = pair->second;
-    if (is_cache_miss) {
-        LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
-        const auto [program, bindings] = DecompileShaders(key);
-        entry = std::make_unique<VKGraphicsPipeline>(device, scheduler, descriptor_pool,
-                                                     update_descriptor_queue, renderpass_cache, key,
-                                                     bindings, program);
+    if (const auto it = graphics_cache.find(key); it != graphics_cache.end()) {
+        last_graphics_key = key;
+        return last_graphics_pipeline = it->second.get();
+    }
+    last_graphics_pipeline = nullptr;
+
+    if (const auto it = graphics_builds.find(key); it != graphics_builds.end()) {
+        auto& build = *it->second;
+        if (!build.is_done.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        auto pipeline = std::move(build.pipeline);
+        graphics_builds.erase(it);
+        return RegisterGraphicsPipeline(key, std::move(pipeline));
+    }
+
+    const PipelineShaders shaders = GetPipelineShaders();
+    const GraphicsPipelineCacheKey disk_key = GetDiskKey(key, shaders);
+    SaveGraphicsPipeline(disk_key, shaders);
+    if (auto pipeline = TakePrecompiledGraphicsPipeline(disk_key, shaders)) {
+        return RegisterGraphicsPipeline(key, std::move(pipeline));
     }
-    return *(last_graphics_pipeline = entry.get());
+
+    const vk::RenderPass renderpass = renderpass_cache.GetRenderPass(key.renderpass_params);
+    if (Settings::values.use_asynchronous_shaders) {
+        LOG_INFO(Render_Vulkan, "Queue 0x{:016X}", key.Hash());
+        QueueGraphicsPipeline(key, shaders, renderpass);
+        return nullptr;
+    }
+
+    LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
+    return RegisterGraphicsPipeline(key, BuildGraphicsPipeline(key, shaders, renderpass));
 }
 
 VKComputePipeline& VKPipelineCache::GetComputePipeline(const ComputePipelineCacheKey& key) {
     MICROPROFILE_SCOPE(Vulkan_PipelineCache);
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::ShaderCompile};
+
+    // Compute heavy titles launch the same kernel many times in a row
+    if (last_compute_pipeline && last_compute_key == key) {
+        return *last_compute_pipeline;
+    }
 
     const auto [pair, is_cache_miss] = compute_cache.try_emplace(key);
     auto& entry = pair->second;
     if (!is_cache_miss) {
+        last_compute_key = key;
+        last_compute_pipeline = entry.get();
         return *entry;
     }
     LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
@@ -247,29 +363,142 @@ VKComputePipeline& VKPipelineCache::GetComputePipeline(const ComputePipelineCach
     auto shader = TryGet(host_ptr);
     if (!shader) {
         // No shader found - create a new one
-        const auto cpu_addr = memory_manager.GpuToCpuAddress(program_addr);
-        ASSERT(cpu_addr);
-
         auto code = GetShaderCode(memory_manager, program_addr, host_ptr, true);
         constexpr u32 kernel_main_offset = 0;
-        shader = std::make_shared<CachedShader>(system, Tegra::Engines::ShaderType::Compute,
-                                                program_addr, *cpu_addr, host_ptr, std::move(code),
-                                                kernel_main_offset);
+        shader = CreateShader(Tegra::Engines::ShaderType::Compute, program_addr, host_ptr,
+                              std::move(code), kernel_main_offset);
         Register(shader);
     }
 
-    Specialization specialization;
-    specialization.workgroup_size = key.workgroup_size;
-    specialization.shared_memory_size = key.shared_memory_size;
+    ComputePipelineCacheKey disk_key = key;
+    disk_key.shader = shader->GetUniqueIdentifier();
+    disk_cache->SaveShader(shader->GetDiskCacheEntry());
+    disk_cache->SaveComputePipeline(disk_key);
 
-    const SPIRVShader spirv_shader{
-        Decompile(device, shader->GetIR(), ShaderType::Compute, specialization),
-        shader->GetEntries()};
-    entry = std::make_unique<VKComputePipeline>(device, scheduler, descriptor_pool,
-                                                update_descriptor_queue, spirv_shader);
+    entry = TakePrecompiledComputePipeline(disk_key, *shader);
+    if (!entry) {
+        entry = BuildComputePipeline(key, *shader);
+    }
+    last_compute_key = key;
+    last_compute_pipeline = entry.get();
     return *entry;
 }
 
+void VKPipelineCache::LoadDiskResources(const std::atomic_bool& stop_loading,
+                                        const VideoCore::DiskResourceLoadCallback& callback) {
+    const auto transferable = disk_cache->LoadTransferable();
+    if (!transferable) {
+        return;
+    }
+    LoadDriverPipelineCache();
+
+    auto& worker = Common::GetSharedWorker();
+    Common::TaskGroup group;
+    std::mutex mutex;
+    std::size_t num_done = 0; // Guarded by the mutex
+
+    // Decode the stored shaders
+    const auto& entries = transferable->shaders;
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Decompile, 0, entries.size());
+    }
+    for (const auto& entry : entries) {
+        worker.QueueWork(group, [&] {
+            if (stop_loading) {
+                return;
+            }
+            if (CachedShader::GetUniqueIdentifier(entry.code) != entry.unique_identifier) {
+                LOG_ERROR(Render_Vulkan, "Invalid hash in entry={:016X}, skipping",
+                          entry.unique_identifier);
+                return;
+            }
+            auto shader = std::make_shared<CachedShader>(system, entry);
+
+            std::scoped_lock lock{mutex};
+            disk_shaders.emplace(entry.unique_identifier, std::move(shader));
+            if (callback) {
+                callback(VideoCore::LoadCallbackStage::Decompile, ++num_done, entries.size());
+            }
+        });
+    }
+    group.Wait();
+    if (stop_loading) {
+        return;
+    }
+    for (const auto& [unique_identifier, shader] : disk_shaders) {
+        const auto& decoded = shader->GetDecoded();
+        decoded_shaders.emplace(
+            GetDecodedKey(unique_identifier, shader->GetStage(), decoded->main_offset), decoded);
+    }
+
+    const std::size_t num_pipelines =
+        transferable->graphics_pipelines.size() + transferable->compute_pipelines.size();
+    num_done = 0;
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Build, 0, num_pipelines);
+    }
+    const auto Finish = [&] {
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Build, ++num_done, num_pipelines);
+        }
+    };
+
+    for (const auto& key : transferable->graphics_pipelines) {
+        PipelineShaders shaders;
+        bool has_all_shaders = true;
+        for (std::size_t i = 0; i < Maxwell::MaxShaderProgram; ++i) {
+            if (key.shaders[i] == 0) {
+                continue;
+            }
+            const auto it = disk_shaders.find(key.shaders[i]);
+            if (it == disk_shaders.end()) {
+                has_all_shaders = false;
+                break;
+            }
+            shaders[i] = it->second;
+        }
+        if (!has_all_shaders) {
+            std::scoped_lock lock{mutex};
+            Finish();
+            continue;
+        }
+        // The render pass cache is not thread safe, fetch the render pass here
+        const vk::RenderPass renderpass = renderpass_cache.GetRenderPass(key.renderpass_params);
+        worker.QueueWork(group, [&, shaders, renderpass] {
+            if (stop_loading) {
+                return;
+            }
+            auto pipeline = BuildGraphicsPipeline(key, shaders, renderpass);
+
+            std::scoped_lock lock{mutex};
+            precompiled_graphics.emplace(key, std::move(pipeline));
+            Finish();
+        });
+    }
+    for (const auto& key : transferable->compute_pipelines) {
+        const auto it = disk_shaders.find(key.shader);
+        if (it == disk_shaders.end()) {
+            std::scoped_lock lock{mutex};
+            Finish();
+            continue;
+        }
+        worker.QueueWork(group, [&, shader = it->second] {
+            if (stop_loading) {
+                return;
+            }
+            auto pipeline = BuildComputePipeline(key, *shader);
+
+            std::scoped_lock lock{mutex};
+            precompiled_compute.emplace(key, std::move(pipeline));
+            Finish();
+        });
+    }
+    group.Wait();
+
+    // Store what the driver compiled, so the next boot doesn't have to do it again
+    SaveDriverPipelineCache();
+}
+
 void VKPipelineCache::Unregister(const Shader& shader) {
     bool finished = false;
     const auto Finish = [&] {
@@ -283,6 +512,16 @@ void VKPipelineCache::Unregister(const Shader& shader) {
     };
 
     const GPUVAddr invalidated_addr = shader->GetGpuAddr();
+    for (auto it = graphics_builds.begin(); it != graphics_builds.end();) {
+        auto& entry = it->first;
+        if (std::find(entry.shaders.begin(), entry.shaders.end(), invalidated_addr) ==
+            entry.shaders.end()) {
+            ++it;
+            continue;
+        }
+        // The worker keeps its own reference to the build, its result is simply dropped
+        it = graphics_builds.erase(it);
+    }
     for (auto it = graphics_cache.begin(); it != graphics_cache.end();) {
         auto& entry = it->first;
         if (std::find(entry.shaders.begin(), entry.shaders.end(), invalidated_addr) ==
@@ -291,6 +530,9 @@ void VKPipelineCache::Unregister(const Shader& shader) {
             continue;
         }
         Finish();
+        if (it->second.get() == last_graphics_pipeline) {
+            last_graphics_pipeline = nullptr;
+        }
         it = graphics_cache.erase(it);
     }
     for (auto it = compute_cache.begin(); it != compute_cache.end();) {
@@ -300,58 +542,134 @@ void VKPipelineCache::Unregister(const Shader& shader) {
             continue;
         }
         Finish();
+        if (it->second.get() == last_compute_pipeline) {
+            last_compute_pipeline = nullptr;
+        }
         it = compute_cache.erase(it);
     }
 
     RasterizerCache::Unregister(shader);
 }
 
-std::pair<SPIRVProgram, std::vector<vk::DescriptorSetLayoutBinding>>
-VKPipelineCache::DecompileShaders(const GraphicsPipelineCacheKey& key) {
-    const auto& fixed_state = key.fixed_state;
+VKGraphicsPipeline* VKPipelineCache::RegisterGraphicsPipeline(
+    const GraphicsPipelineCacheKey& key, std::unique_ptr<VKGraphicsPipeline> pipeline) {
+    auto& entry = graphics_cache[key];
+    entry = std::move(pipeline);
+    last_graphics_key = key;
+    return last_graphics_pipeline = entry.get();
+}
+
+void VKPipelineCache::QueueGraphicsPipeline(const GraphicsPipelineCacheKey& key,
+                                            const PipelineShaders& shaders,
+                                            vk::RenderPass renderpass) {
+    auto build = std::make_shared<PipelineBuild>();
+    graphics_builds.emplace(key, build);
+
+    // Everything touching the guest state or the render pass cache has been gathered by the
+    // caller, the worker only decompiles and creates Vulkan objects.
+    auto work = [this, build, key, shaders, renderpass] {
+        build->pipeline = BuildGraphicsPipeline(key, shaders, renderpass);
+        build->is_done.store(true, std::memory_order_release);
+    };
+    Common::GetSharedWorker().QueueWork(build_group, std::move(work));
+}
+
+VKPipelineCache::PipelineShaders VKPipelineCache::GetPipelineShaders() {
     auto& memory_manager = system.GPU().MemoryManager();
     const auto& gpu = system.GPU().Maxwell3D();
 
+    PipelineShaders shaders;
+    for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
+
+        // Skip stages that are not enabled
+        if (!gpu.regs.IsShaderConfigEnabled(index)) {
+            continue;
+        }
+
+        const GPUVAddr gpu_addr = GetShaderAddress(system, program_enum);
+        const auto host_ptr = memory_manager.GetPointer(gpu_addr);
+        shaders[index] = TryGet(host_ptr);
+        ASSERT(shaders[index]);
+
+        if (program_enum == Maxwell::ShaderProgram::VertexA) {
+            // VertexB was combined with VertexA, so we skip the VertexB iteration
+            ++index;
+        }
+    }
+    return shaders;
+}
+
+std::unique_ptr<VKGraphicsPipeline> VKPipelineCache::BuildGraphicsPipeline(
+    const GraphicsPipelineCacheKey& key, const PipelineShaders& shaders,
+    vk::RenderPass renderpass) const {
+    const auto [program, bindings] = DecompileShaders(key, shaders);
+    return std::make_unique<VKGraphicsPipeline>(device, scheduler, descriptor_pool,
+                                                update_descriptor_queue, *driver_pipeline_cache,
+                                                renderpass, key, bindings, program);
+}
+
+std::unique_ptr<VKComputePipeline> VKPipelineCache::BuildComputePipeline(
+    const ComputePipelineCacheKey& key, const CachedShader& shader) const {
+    Specialization specialization;
+    specialization.shared_memory_size = key.shared_memory_size;
+
+    SpecializationConstants constants;
+    constants.workgroup_size = key.workgroup_size;
+
+    const SPIRVShader spirv_shader{
+        shader.GetDecoded()->GetSPIRV(device, ShaderType::Compute, specialization),
+        shader.GetEntries()};
+    return std::make_unique<VKComputePipeline>(device, scheduler, descriptor_pool,
+                                               update_descriptor_queue, *driver_pipeline_cache,
+                                               spirv_shader, constants);
+}
+
+std::pair<SPIRVProgram, std::vector<vk::DescriptorSetLayoutBinding>>
+VKPipelineCache::DecompileShaders(const GraphicsPipelineCacheKey& key,
+                                  const PipelineShaders& shaders) const {
+    const auto& fixed_state = key.fixed_state;
+
     Specialization specialization;
     specialization.primitive_topology = fixed_state.input_assembly.topology;
-    if (specialization.primitive_topology == Maxwell::PrimitiveTopology::Points) {
-        ASSERT(fixed_state.input_assembly.point_size != 0.0f);
-        specialization.point_size = fixed_state.input_assembly.point_size;
-    }
     for (std::size_t i = 0; i < Maxwell::NumVertexAttributes; ++i) {
         specialization.attribute_types[i] = fixed_state.vertex_input.attributes[i].type;
     }
-    specialization.ndc_minus_one_to_one = fixed_state.rasterizer.ndc_minus_one_to_one;
     specialization.tessellation.primitive = fixed_state.tessellation.primitive;
     specialization.tessellation.spacing = fixed_state.tessellation.spacing;
     specialization.tessellation.clockwise = fixed_state.tessellation.clockwise;
 
+    // Varyings are captured from the last vertex processing stage
+    std::size_t last_vertex_stage = 0;
+    for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
+        if (shaders[index] && program_enum != Maxwell::ShaderProgram::TesselationControl &&
+            program_enum != Maxwell::ShaderProgram::Fragment) {
+            last_vertex_stage = index;
+        }
+    }
+
     SPIRVProgram program;
     std::vector<vk::DescriptorSetLayoutBinding> bindings;
 
     for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
-        const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
-
-        // Skip stages that are not enabled
-        if (!gpu.regs.IsShaderConfigEnabled(index)) {
+        const auto& shader = shaders[index];
+        if (!shader) {
+            // Disabled stage or VertexB combined with VertexA
             continue;
         }
-
-        const GPUVAddr gpu_addr = GetShaderAddress(system, program_enum);
-        const auto host_ptr = memory_manager.GetPointer(gpu_addr);
-        const auto shader = TryGet(host_ptr);
-        ASSERT(shader);
+        const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
 
         const std::size_t stage = index == 0 ? 0 : index - 1; // Stage indices are 0 - 5
         const auto program_type = GetShaderType(program_enum);
         const auto& entries = shader->GetEntries();
-        program[stage] = {Decompile(device, shader->GetIR(), program_type, specialization),
-                          entries};
-
-        if (program_enum == Maxwell::ShaderProgram::VertexA) {
-            // VertexB was combined with VertexA, so we skip the VertexB iteration
-            ++index;
+        if (index == last_vertex_stage && device.IsExtTransformFeedbackSupported()) {
+            specialization.transform_feedback = fixed_state.transform_feedback;
+        } else {
+            specialization.transform_feedback = {};
         }
+        program[stage] = {shader->GetDecoded()->GetSPIRV(device, program_type, specialization),
+                          entries};
 
         const u32 old_binding = specialization.base_binding;
         specialization.base_binding =
@@ -361,6 +679,110 @@ VKPipelineCache::DecompileShaders(const GraphicsPipelineCacheKey& key) {
     return {std::move(program), std::move(bindings)};
 }
 
+GraphicsPipelineCacheKey VKPipelineCache::GetDiskKey(const GraphicsPipelineCacheKey& key,
+                                                     const PipelineShaders& shaders) {
+    GraphicsPipelineCacheKey disk_key = key;
+    for (std::size_t i = 0; i < Maxwell::MaxShaderProgram; ++i) {
+        disk_key.shaders[i] = shaders[i] ? shaders[i]->GetUniqueIdentifier() : 0;
+    }
+    return disk_key;
+}
+
+void VKPipelineCache::SaveGraphicsPipeline(const GraphicsPipelineCacheKey& disk_key,
+                                           const PipelineShaders& shaders) {
+    if (!disk_cache->IsUsable()) {
+        return;
+    }
+    for (const auto& shader : shaders) {
+        if (shader) {
+            disk_cache->SaveShader(shader->GetDiskCacheEntry());
+        }
+    }
+    disk_cache->SaveGraphicsPipeline(disk_key);
+}
+
+std::unique_ptr<VKGraphicsPipeline> VKPipelineCache::TakePrecompiledGraphicsPipeline(
+    const GraphicsPipelineCacheKey& disk_key, const PipelineShaders& shaders) {
+    const auto it = precompiled_graphics.find(disk_key);
+    if (it == precompiled_graphics.end()) {
+        return nullptr;
+    }
+    auto pipeline = std::move(it->second);
+    precompiled_graphics.erase(it);
+
+    for (std::size_t i = 0; i < Maxwell::MaxShaderProgram; ++i) {
+        if (shaders[i] && !IsDiskShaderCompatible(disk_key.shaders[i], *shaders[i])) {
+            return nullptr;
+        }
+    }
+    return pipeline;
+}
+
+std::unique_ptr<VKComputePipeline> VKPipelineCache::TakePrecompiledComputePipeline(
+    const ComputePipelineCacheKey& disk_key, const CachedShader& shader) {
+    const auto it = precompiled_compute.find(disk_key);
+    if (it == precompiled_compute.end()) {
+        return nullptr;
+    }
+    auto pipeline = std::move(it->second);
+    precompiled_compute.erase(it);
+
+    if (!IsDiskShaderCompatible(disk_key.shader, shader)) {
+        return nullptr;
+    }
+    return pipeline;
+}
+
+Shader VKPipelineCache::CreateShader(Tegra::Engines::ShaderType stage, GPUVAddr gpu_addr,
+                                     u8* host_ptr, ProgramCode code, u32 main_offset) {
+    const std::optional cpu_addr = system.GPU().MemoryManager().GpuToCpuAddress(gpu_addr);
+    ASSERT(cpu_addr);
+
+    const u64 unique_identifier = CachedShader::GetUniqueIdentifier(code);
+    const u64 decoded_key = GetDecodedKey(unique_identifier, stage, main_offset);
+    if (const auto it = decoded_shaders.find(decoded_key); it != decoded_shaders.end()) {
+        // The decoded code is only valid while the constant buffer values it read are the same
+        const auto& decoded = it->second;
+        if (decoded->program_code == code && decoded->locker.IsConsistent()) {
+            return std::make_shared<CachedShader>(stage, gpu_addr, *cpu_addr, host_ptr, decoded);
+        }
+    }
+    auto shader = std::make_shared<CachedShader>(system, stage, gpu_addr, *cpu_addr, host_ptr,
+                                                 std::move(code), main_offset);
+    decoded_shaders.insert_or_assign(decoded_key, shader->GetDecoded());
+    return shader;
+}
+
+bool VKPipelineCache::IsDiskShaderCompatible(u64 unique_identifier,
+                                             const CachedShader& shader) const {
+    // The shader code is the same, but the guest may have changed the constant buffer values the
+    // IR was specialized with.
+    const auto it = disk_shaders.find(unique_identifier);
+    return it != disk_shaders.end() && it->second->GetLocker().HasEqualKeys(shader.GetLocker());
+}
+
+void VKPipelineCache::LoadDriverPipelineCache() {
+    const std::vector<u8> data = disk_cache->LoadPipelineCache();
+    if (data.empty()) {
+        return;
+    }
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    const vk::PipelineCacheCreateInfo pipeline_cache_ci({}, data.size(), data.data());
+    const auto stored_cache = dev.createPipelineCacheUnique(pipeline_cache_ci, nullptr, dld);
+    const vk::PipelineCache src_cache = *stored_cache;
+    dev.mergePipelineCaches(*driver_pipeline_cache, src_cache, dld);
+}
+
+void VKPipelineCache::SaveDriverPipelineCache() {
+    if (!disk_cache->IsUsable()) {
+        return;
+    }
+    const auto dev = device.GetLogical();
+    const auto& dld = device.GetDispatchLoader();
+    disk_cache->SavePipelineCache(dev.getPipelineCacheData(*driver_pipeline_cache, dld));
+}
+
 void FillDescriptorUpdateTemplateEntries(
     const VKDevice& device, const ShaderEntries& entries, u32& binding, u32& offset,
     std::vector<vk::DescriptorUpdateTemplateEntry>& template_entries) {
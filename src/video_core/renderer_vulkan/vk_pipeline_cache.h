@@ -5,8 +5,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
@@ -16,8 +18,10 @@
 #include <boost/functional/hash.hpp>
 
 #include "common/common_types.h"
+#include "common/thread_worker.h"
 #include "video_core/engines/const_buffer_engine_interface.h"
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/rasterizer_cache.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/fixed_pipeline_state.h"
@@ -41,8 +45,11 @@ class VKDescriptorPool;
 class VKDevice;
 class VKFence;
 class VKScheduler;
+class VKShaderDiskCache;
 class VKUpdateDescriptorQueue;
 
+struct ShaderDiskCacheEntry;
+
 class CachedShader;
 using Shader = std::shared_ptr<CachedShader>;
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
@@ -110,12 +117,54 @@ struct hash<Vulkan::ComputePipelineCacheKey> {
 
 namespace Vulkan {
 
+/// Returns the specialization info passing the constants to any stage. It points to constants.
+vk::SpecializationInfo GetSpecializationInfo(const SpecializationConstants& constants);
+
+/// Decoded code of a shader. Every cached copy of the same code shares one, so relocated or
+/// duplicated shaders are not decoded again.
+struct DecodedShader {
+    explicit DecodedShader(ProgramCode program_code, u32 main_offset, u64 unique_identifier,
+                           const VideoCommon::Shader::ConstBufferLocker& locker);
+    ~DecodedShader();
+
+    /**
+     * Returns the SPIR-V module of the shader, decompiling it the first time a specialization is
+     * requested. Pipelines built on different threads share the modules.
+     */
+    std::shared_ptr<const std::vector<u32>> GetSPIRV(const VKDevice& device,
+                                                     Tegra::Engines::ShaderType stage,
+                                                     const Specialization& specialization);
+
+    ProgramCode program_code;
+    u32 main_offset{};
+    u64 unique_identifier{};
+    VideoCommon::Shader::ConstBufferLocker locker;
+    VideoCommon::Shader::ShaderIR shader_ir;
+    ShaderEntries entries;
+
+private:
+    std::mutex spirv_mutex;
+    /// Decompiled modules, few specializations are used per shader so they are searched linearly
+    std::vector<std::pair<Specialization, std::shared_ptr<const std::vector<u32>>>> spirv_modules;
+};
+
 class CachedShader final : public RasterizerCacheObject {
 public:
     explicit CachedShader(Core::System& system, Tegra::Engines::ShaderType stage, GPUVAddr gpu_addr,
                           VAddr cpu_addr, u8* host_ptr, ProgramCode program_code, u32 main_offset);
+
+    /// Builds a shader from the disk cache. It's not backed by guest memory.
+    explicit CachedShader(Core::System& system, const ShaderDiskCacheEntry& entry);
+
+    /// Builds a copy of a shader already decoded at another address.
+    explicit CachedShader(Tegra::Engines::ShaderType stage, GPUVAddr gpu_addr, VAddr cpu_addr,
+                          u8* host_ptr, std::shared_ptr<DecodedShader> decoded);
+
     ~CachedShader();
 
+    /// Returns the identifier used to reference this shader in the disk cache.
+    static u64 GetUniqueIdentifier(const ProgramCode& code);
+
     GPUVAddr GetGpuAddr() const {
         return gpu_addr;
     }
@@ -125,31 +174,52 @@ public:
     }
 
     std::size_t GetSizeInBytes() const override {
-        return program_code.size() * sizeof(u64);
+        return decoded->program_code.size() * sizeof(u64);
     }
 
     VideoCommon::Shader::ShaderIR& GetIR() {
-        return shader_ir;
+        return decoded->shader_ir;
     }
 
     const VideoCommon::Shader::ShaderIR& GetIR() const {
-        return shader_ir;
+        return decoded->shader_ir;
     }
 
     const ShaderEntries& GetEntries() const {
-        return entries;
+        return decoded->entries;
+    }
+
+    const VideoCommon::Shader::ConstBufferLocker& GetLocker() const {
+        return decoded->locker;
     }
 
+    u64 GetUniqueIdentifier() const {
+        return decoded->unique_identifier;
+    }
+
+    Tegra::Engines::ShaderType GetStage() const {
+        return stage;
+    }
+
+    /// Returns the decoded code shared with other copies of this shader.
+    const std::shared_ptr<DecodedShader>& GetDecoded() const {
+        return decoded;
+    }
+
+    /// Returns the shader code and the keys it was decoded with, to be stored in the disk cache.
+    ShaderDiskCacheEntry GetDiskCacheEntry() const;
+
 private:
     static Tegra::Engines::ConstBufferEngineInterface& GetEngine(Core::System& system,
                                                                  Tegra::Engines::ShaderType stage);
 
+    static VideoCommon::Shader::ConstBufferLocker MakeLocker(Core::System& system,
+                                                             const ShaderDiskCacheEntry& entry);
+
     GPUVAddr gpu_addr{};
     VAddr cpu_addr{};
-    ProgramCode program_code;
-    VideoCommon::Shader::ConstBufferLocker locker;
-    VideoCommon::Shader::ShaderIR shader_ir;
-    ShaderEntries entries;
+    Tegra::Engines::ShaderType stage{};
+    std::shared_ptr<DecodedShader> decoded;
 };
 
 class VKPipelineCache final : public RasterizerCache<Shader> {
@@ -162,18 +232,80 @@ public:
 
     std::array<Shader, Maxwell::MaxShaderProgram> GetShaders();
 
-    VKGraphicsPipeline& GetGraphicsPipeline(const GraphicsPipelineCacheKey& key);
+    /// Returns the graphics pipeline for the given key. With asynchronous shaders enabled, returns
+    /// nullptr while the pipeline is still being built in the background.
+    VKGraphicsPipeline* GetGraphicsPipeline(const GraphicsPipelineCacheKey& key);
 
     VKComputePipeline& GetComputePipeline(const ComputePipelineCacheKey& key);
 
+    /// Builds the shaders and pipelines stored in the disk cache.
+    void LoadDiskResources(const std::atomic_bool& stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback);
+
 protected:
     void Unregister(const Shader& shader) override;
 
     void FlushObjectInner(const Shader& object) override {}
 
 private:
+    /// Graphics pipeline being built on a worker thread.
+    struct PipelineBuild {
+        std::unique_ptr<VKGraphicsPipeline> pipeline;
+        std::atomic_bool is_done{false};
+    };
+
+    /// Shaders of a graphics pipeline indexed by program, empty for unused programs.
+    using PipelineShaders = std::array<Shader, Maxwell::MaxShaderProgram>;
+
+    /// Stores a pipeline in the cache and makes it the last used one.
+    VKGraphicsPipeline* RegisterGraphicsPipeline(const GraphicsPipelineCacheKey& key,
+                                                 std::unique_ptr<VKGraphicsPipeline> pipeline);
+
+    /// Queues a graphics pipeline build on the shared worker pool.
+    void QueueGraphicsPipeline(const GraphicsPipelineCacheKey& key, const PipelineShaders& shaders,
+                               vk::RenderPass renderpass);
+
+    /// Returns the shaders used by the current guest state.
+    PipelineShaders GetPipelineShaders();
+
+    /// Decompiles the shaders and creates the pipeline. Safe to call from worker threads.
+    std::unique_ptr<VKGraphicsPipeline> BuildGraphicsPipeline(const GraphicsPipelineCacheKey& key,
+                                                              const PipelineShaders& shaders,
+                                                              vk::RenderPass renderpass) const;
+
+    std::unique_ptr<VKComputePipeline> BuildComputePipeline(const ComputePipelineCacheKey& key,
+                                                            const CachedShader& shader) const;
+
     std::pair<SPIRVProgram, std::vector<vk::DescriptorSetLayoutBinding>> DecompileShaders(
-        const GraphicsPipelineCacheKey& key);
+        const GraphicsPipelineCacheKey& key, const PipelineShaders& shaders) const;
+
+    /// Returns the key used in the disk cache, where shaders are referenced by unique identifier.
+    static GraphicsPipelineCacheKey GetDiskKey(const GraphicsPipelineCacheKey& key,
+                                               const PipelineShaders& shaders);
+
+    /// Stores the pipeline usage and its shaders in the disk cache.
+    void SaveGraphicsPipeline(const GraphicsPipelineCacheKey& disk_key,
+                              const PipelineShaders& shaders);
+
+    /// Takes a pipeline built from the disk cache if its shaders were decoded with the same keys.
+    std::unique_ptr<VKGraphicsPipeline> TakePrecompiledGraphicsPipeline(
+        const GraphicsPipelineCacheKey& disk_key, const PipelineShaders& shaders);
+
+    std::unique_ptr<VKComputePipeline> TakePrecompiledComputePipeline(
+        const ComputePipelineCacheKey& disk_key, const CachedShader& shader);
+
+    /// Creates a shader for guest code, reusing the decoded code of a copy already in the cache.
+    Shader CreateShader(Tegra::Engines::ShaderType stage, GPUVAddr gpu_addr, u8* host_ptr,
+                        ProgramCode code, u32 main_offset);
+
+    /// Returns true when the disk cache shader with the given identifier matches the guest one.
+    bool IsDiskShaderCompatible(u64 unique_identifier, const CachedShader& shader) const;
+
+    /// Merges the pipeline cache blob stored on disk into the driver pipeline cache.
+    void LoadDriverPipelineCache();
+
+    /// Writes the driver pipeline cache to disk.
+    void SaveDriverPipelineCache();
 
     Core::System& system;
     const VKDevice& device;
@@ -185,12 +317,32 @@ private:
 
     std::array<Shader, Maxwell::MaxShaderProgram> last_shaders;
 
+    std::unique_ptr<VKShaderDiskCache> disk_cache;
+    UniquePipelineCache driver_pipeline_cache;
+
     GraphicsPipelineCacheKey last_graphics_key;
     VKGraphicsPipeline* last_graphics_pipeline = nullptr;
 
+    ComputePipelineCacheKey last_compute_key;
+    VKComputePipeline* last_compute_pipeline = nullptr;
+
     std::unordered_map<GraphicsPipelineCacheKey, std::unique_ptr<VKGraphicsPipeline>>
         graphics_cache;
     std::unordered_map<ComputePipelineCacheKey, std::unique_ptr<VKComputePipeline>> compute_cache;
+
+    std::unordered_map<GraphicsPipelineCacheKey, std::shared_ptr<PipelineBuild>> graphics_builds;
+
+    // Shaders and pipelines built from the disk cache, waiting for the guest to use them
+    std::unordered_map<u64, Shader> disk_shaders;
+    std::unordered_map<GraphicsPipelineCacheKey, std::unique_ptr<VKGraphicsPipeline>>
+        precompiled_graphics;
+    std::unordered_map<ComputePipelineCacheKey, std::unique_ptr<VKComputePipeline>>
+        precompiled_compute;
+
+    // Decoded code of every shader seen this session, keyed by code hash, stage and entry point
+    std::unordered_map<u64, std::shared_ptr<DecodedShader>> decoded_shaders;
+
+    Common::TaskGroup build_group;
 };
 
 void FillDescriptorUpdateTemplateEntries(
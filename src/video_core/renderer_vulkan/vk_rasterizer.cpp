@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -13,9 +14,11 @@
 
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/bit_util.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/memory.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
@@ -30,6 +33,7 @@
 #include "video_core/renderer_vulkan/vk_device.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_query_cache.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
@@ -108,9 +112,13 @@ Tegra::Texture::FullTextureInfo GetTextureInfo(const Engine& engine, const Entry
                                                std::size_t stage) {
     const auto stage_type = static_cast<Tegra::Engines::ShaderType>(stage);
     if (entry.IsBindless()) {
-        const Tegra::Texture::TextureHandle tex_handle =
-            engine.AccessConstBuffer32(stage_type, entry.GetBuffer(), entry.GetOffset());
-        return engine.GetTextureInfo(tex_handle);
+        if constexpr (std::is_same_v<Engine, Tegra::Engines::Maxwell3D>) {
+            return engine.GetBindlessTexture(stage_type, entry.GetBuffer(), entry.GetOffset());
+        } else {
+            const Tegra::Texture::TextureHandle tex_handle =
+                engine.AccessConstBuffer32(stage_type, entry.GetBuffer(), entry.GetOffset());
+            return engine.GetTextureInfo(tex_handle);
+        }
     }
     if constexpr (std::is_same_v<Engine, Tegra::Engines::Maxwell3D>) {
         return engine.GetStageTexture(stage_type, entry.GetOffset());
@@ -123,10 +131,15 @@ Tegra::Texture::FullTextureInfo GetTextureInfo(const Engine& engine, const Entry
 
 class BufferBindings final {
 public:
-    void AddVertexBinding(const vk::Buffer* buffer, vk::DeviceSize offset) {
-        vertex.buffer_ptrs[vertex.num_buffers] = buffer;
-        vertex.offsets[vertex.num_buffers] = offset;
-        ++vertex.num_buffers;
+    void AddVertexBinding(u32 binding, const vk::Buffer* buffer, vk::DeviceSize offset) {
+        // Vertex buffers are bound as a contiguous range, gaps are filled with this buffer
+        for (std::size_t i = vertex.num_buffers; i < binding; ++i) {
+            vertex.buffer_ptrs[i] = buffer;
+            vertex.offsets[i] = 0;
+        }
+        vertex.buffer_ptrs[binding] = buffer;
+        vertex.offsets[binding] = offset;
+        vertex.num_buffers = std::max<std::size_t>(vertex.num_buffers, binding + 1);
     }
 
     void SetIndexBinding(const vk::Buffer* buffer, vk::DeviceSize offset, vk::IndexType type) {
@@ -135,7 +148,36 @@ public:
         index.type = type;
     }
 
-    void Bind(VKScheduler& scheduler) const {
+    /// Records the binds of these buffers, skipping the ones already bound in the current command
+    /// buffer.
+    void Bind(VKScheduler& scheduler, BoundGeometryBuffers& bound) const {
+        const u64 tick = scheduler.GetTicks();
+        const bool is_same_tick = bound.tick == tick;
+        bound.tick = tick;
+
+        if (index.buffer != nullptr) {
+            const vk::Buffer index_buffer = *index.buffer;
+            if (!is_same_tick || bound.index_buffer != index_buffer ||
+                bound.index_offset != index.offset || bound.index_type != index.type) {
+                bound.index_buffer = index_buffer;
+                bound.index_offset = index.offset;
+                bound.index_type = index.type;
+                scheduler.Record([index_buffer, index_offset = index.offset,
+                                  index_type = index.type](auto cmdbuf, auto& dld) {
+                    cmdbuf.bindIndexBuffer(index_buffer, index_offset, index_type, dld);
+                });
+            }
+        }
+
+        if (is_same_tick && IsVertexBound(bound)) {
+            return;
+        }
+        bound.num_vertex_buffers = vertex.num_buffers;
+        for (std::size_t i = 0; i < vertex.num_buffers; ++i) {
+            bound.vertex_buffers[i] = *vertex.buffer_ptrs[i];
+            bound.vertex_offsets[i] = vertex.offsets[i];
+        }
+
         // Use this large switch case to avoid dispatching more memory in the record lambda than
         // what we need. It looks horrible, but it's the best we can do on standard C++.
         switch (vertex.num_buffers) {
@@ -223,16 +265,20 @@ private:
         vk::IndexType type;
     } index;
 
-    template <std::size_t N>
-    void BindStatic(VKScheduler& scheduler) const {
-        if (index.buffer != nullptr) {
-            BindStatic<N, true>(scheduler);
-        } else {
-            BindStatic<N, false>(scheduler);
+    bool IsVertexBound(const BoundGeometryBuffers& bound) const {
+        if (bound.num_vertex_buffers != vertex.num_buffers) {
+            return false;
         }
+        for (std::size_t i = 0; i < vertex.num_buffers; ++i) {
+            if (bound.vertex_buffers[i] != *vertex.buffer_ptrs[i] ||
+                bound.vertex_offsets[i] != vertex.offsets[i]) {
+                return false;
+            }
+        }
+        return true;
     }
 
-    template <std::size_t N, bool is_indexed>
+    template <std::size_t N>
     void BindStatic(VKScheduler& scheduler) const {
         static_assert(N <= Maxwell::NumVertexArrays);
         if constexpr (N == 0) {
@@ -246,27 +292,29 @@ private:
         std::array<vk::DeviceSize, N> offsets;
         std::copy(vertex.offsets.begin(), vertex.offsets.begin() + N, offsets.begin());
 
-        if constexpr (is_indexed) {
-            // Indexed draw
-            scheduler.Record([buffers, offsets, index_buffer = *index.buffer,
-                              index_offset = index.offset,
-                              index_type = index.type](auto cmdbuf, auto& dld) {
-                cmdbuf.bindIndexBuffer(index_buffer, index_offset, index_type, dld);
-                cmdbuf.bindVertexBuffers(0, static_cast<u32>(N), buffers.data(), offsets.data(),
-                                         dld);
-            });
-        } else {
-            // Array draw
-            scheduler.Record([buffers, offsets](auto cmdbuf, auto& dld) {
-                cmdbuf.bindVertexBuffers(0, static_cast<u32>(N), buffers.data(), offsets.data(),
-                                         dld);
-            });
-        }
+        scheduler.Record([buffers, offsets](auto cmdbuf, auto& dld) {
+            cmdbuf.bindVertexBuffers(0, static_cast<u32>(N), buffers.data(), offsets.data(), dld);
+        });
     }
 };
 
 void RasterizerVulkan::DrawParameters::Draw(vk::CommandBuffer cmdbuf,
                                             const vk::DispatchLoaderDynamic& dld) const {
+    if (num_draws != 0) {
+        const u32 stride = is_indexed ? sizeof(vk::DrawIndexedIndirectCommand)
+                                      : sizeof(vk::DrawIndirectCommand);
+        // Without multiDrawIndirect each indirect draw can only read one command
+        const u32 draws_per_call = is_multi_draw_indirect ? num_draws : 1;
+        for (u32 draw = 0; draw < num_draws; draw += draws_per_call) {
+            const u64 offset = indirect_offset + static_cast<u64>(draw) * stride;
+            if (is_indexed) {
+                cmdbuf.drawIndexedIndirect(indirect_buffer, offset, draws_per_call, stride, dld);
+            } else {
+                cmdbuf.drawIndirect(indirect_buffer, offset, draws_per_call, stride, dld);
+            }
+        }
+        return;
+    }
     if (is_indexed) {
         cmdbuf.drawIndexed(num_vertices, num_instances, 0, base_vertex, base_instance, dld);
     } else {
@@ -285,11 +333,18 @@ RasterizerVulkan::RasterizerVulkan(Core::System& system, Core::Frontend::EmuWind
       update_descriptor_queue(device, scheduler),
       quad_array_pass(device, scheduler, descriptor_pool, staging_pool, update_descriptor_queue),
       uint8_pass(device, scheduler, descriptor_pool, staging_pool, update_descriptor_queue),
+      topology_pass(device, scheduler, descriptor_pool, staging_pool, update_descriptor_queue),
+      vertex_format_pass(device, scheduler, descriptor_pool, staging_pool,
+                         update_descriptor_queue),
       texture_cache(system, *this, device, resource_manager, memory_manager, scheduler,
                     staging_pool),
       pipeline_cache(system, *this, device, scheduler, descriptor_pool, update_descriptor_queue),
       buffer_cache(*this, system, device, memory_manager, scheduler, staging_pool),
-      sampler_cache(device) {}
+      sampler_cache(device),
+      fence_manager(system, *this, texture_cache, buffer_cache, scheduler),
+      query_cache(system, *this, device, scheduler) {
+    scheduler.SetQueryCache(query_cache);
+}
 
 RasterizerVulkan::~RasterizerVulkan() = default;
 
@@ -305,17 +360,28 @@ bool RasterizerVulkan::DrawMultiBatch(bool is_indexed) {
 
 void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
     MICROPROFILE_SCOPE(Vulkan_Drawing);
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DrawSetup};
 
     FlushWork();
 
-    const auto& gpu = system.GPU().Maxwell3D();
-    GraphicsPipelineCacheKey key{GetFixedPipelineState(gpu.regs)};
+    query_cache.UpdateCounters();
 
-    buffer_cache.Map(CalculateGraphicsStreamBufferSize(is_indexed));
+    RefreshFixedPipelineState(fixed_state, system.GPU().Maxwell3D());
+
+    // Draws of MME batches sharing all their state are issued with a single indirect draw
+    const bool is_multi_draw = is_instanced && system.GPU().Maxwell3D().mme_draw.draws.size() > 1;
+
+    buffer_cache.Map(CalculateGraphicsStreamBufferSize(is_indexed, is_multi_draw));
 
     BufferBindings buffer_bindings;
-    const DrawParameters draw_params =
-        SetupGeometry(key.fixed_state, buffer_bindings, is_indexed, is_instanced);
+    DrawParameters draw_params =
+        SetupGeometry(fixed_state, buffer_bindings, is_indexed, is_instanced);
+    GraphicsPipelineCacheKey key{fixed_state};
+
+    std::pair<const vk::Buffer*, u64> indirect{};
+    if (is_multi_draw) {
+        indirect = SetupIndirectDraws(draw_params);
+    }
 
     update_descriptor_queue.Acquire();
     sampled_views.clear();
@@ -325,31 +391,48 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
     key.shaders = GetShaderAddresses(shaders);
     SetupShaderDescriptors(shaders);
 
+    const TransformFeedbackBindings transform_feedback = SetupTransformFeedback();
+
     buffer_cache.Unmap();
 
+    if (is_multi_draw) {
+        draw_params.indirect_buffer = *indirect.first;
+        draw_params.indirect_offset = indirect.second;
+        draw_params.num_draws = static_cast<u32>(system.GPU().Maxwell3D().mme_draw.draws.size());
+        draw_params.is_multi_draw_indirect = device.IsMultiDrawIndirectSupported();
+    }
+
     const auto texceptions = UpdateAttachments();
     SetupImageTransitions(texceptions, color_attachments, zeta_attachment);
 
     key.renderpass_params = GetRenderPassParams(texceptions);
 
-    auto& pipeline = pipeline_cache.GetGraphicsPipeline(key);
-    scheduler.BindGraphicsPipeline(pipeline.GetHandle());
+    auto* const pipeline = pipeline_cache.GetGraphicsPipeline(key);
+    if (!pipeline) {
+        // The pipeline is still being built in the background, skip the draw
+        return;
+    }
+    scheduler.BindGraphicsPipeline(pipeline->GetHandle());
 
-    const auto renderpass = pipeline.GetRenderPass();
+    const auto renderpass = pipeline->GetRenderPass();
     const auto [framebuffer, render_area] = ConfigureFramebuffers(renderpass);
     scheduler.RequestRenderpass({renderpass, framebuffer, {{0, 0}, render_area}, 0, nullptr});
+    last_framebuffer = framebuffer;
+    last_render_area = render_area;
 
     UpdateDynamicStates();
 
-    buffer_bindings.Bind(scheduler);
+    buffer_bindings.Bind(scheduler, bound_buffers);
 
     if (device.IsNvDeviceDiagnosticCheckpoints()) {
         scheduler.Record(
             [&pipeline](auto cmdbuf, auto& dld) { cmdbuf.setCheckpointNV(&pipeline, dld); });
     }
 
-    const auto pipeline_layout = pipeline.GetLayout();
-    const auto descriptor_set = pipeline.CommitDescriptorSet();
+    BeginTransformFeedback(transform_feedback);
+
+    const auto pipeline_layout = pipeline->GetLayout();
+    const auto descriptor_set = pipeline->CommitDescriptorSet();
     scheduler.Record([pipeline_layout, descriptor_set, draw_params](auto cmdbuf, auto& dld) {
         if (descriptor_set) {
             cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout,
@@ -357,6 +440,8 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
         }
         draw_params.Draw(cmdbuf, dld);
     });
+
+    EndTransformFeedback(transform_feedback);
 }
 
 void RasterizerVulkan::Clear() {
@@ -367,6 +452,8 @@ void RasterizerVulkan::Clear() {
         return;
     }
 
+    query_cache.UpdateCounters();
+
     const auto& regs = gpu.regs;
     const bool use_color = regs.clear_buffers.R || regs.clear_buffers.G || regs.clear_buffers.B ||
                            regs.clear_buffers.A;
@@ -375,6 +462,9 @@ void RasterizerVulkan::Clear() {
     if (!use_color && !use_depth && !use_stencil) {
         return;
     }
+    if (ClearInsideRenderpass(use_color, use_depth, use_stencil)) {
+        return;
+    }
     // Clearing images requires to be out of a renderpass
     scheduler.RequestOutsideRenderPassOperationContext();
 
@@ -423,8 +513,83 @@ void RasterizerVulkan::Clear() {
     }
 }
 
+bool RasterizerVulkan::ClearInsideRenderpass(bool use_color, bool use_depth, bool use_stencil) {
+    if (!scheduler.IsRenderpassActive(last_framebuffer)) {
+        return false;
+    }
+    const auto& regs = system.GPU().Maxwell3D().regs;
+
+    // Clear attachments only clears the render area, the views have to cover it exactly
+    const auto CoversView = [this](const View& view) {
+        const auto range = view->GetImageSubresourceRange();
+        return view->GetWidth() == last_render_area.width &&
+               view->GetHeight() == last_render_area.height && range.layerCount == 1 &&
+               range.levelCount == 1;
+    };
+
+    // Attachments are stored in the framebuffer in order, skipping the unused ones
+    boost::container::static_vector<vk::ClearAttachment, 2> clears;
+    const std::size_t num_color_attachments = static_cast<std::size_t>(
+        std::count_if(color_attachments.begin(), color_attachments.end(),
+                      [](const View& view) { return view != nullptr; }));
+    if (use_color) {
+        View color_view;
+        {
+            MICROPROFILE_SCOPE(Vulkan_RenderTargets);
+            color_view = texture_cache.GetColorBufferSurface(regs.clear_buffers.RT.Value(), false);
+        }
+        const auto it = std::find(color_attachments.begin(), color_attachments.end(), color_view);
+        if (!color_view || it == color_attachments.end() || !CoversView(color_view)) {
+            return false;
+        }
+        const auto attachment = static_cast<u32>(std::count_if(
+            color_attachments.begin(), it, [](const View& view) { return view != nullptr; }));
+        const std::array clear_color = {regs.clear_color[0], regs.clear_color[1],
+                                        regs.clear_color[2], regs.clear_color[3]};
+        clears.emplace_back(vk::ImageAspectFlagBits::eColor, attachment,
+                            vk::ClearValue(vk::ClearColorValue(clear_color)));
+    }
+    if (use_depth || use_stencil) {
+        View zeta_surface;
+        {
+            MICROPROFILE_SCOPE(Vulkan_RenderTargets);
+            zeta_surface = texture_cache.GetDepthBufferSurface(false);
+        }
+        if (!zeta_surface || zeta_surface != zeta_attachment || !CoversView(zeta_surface)) {
+            return false;
+        }
+        // Only clear the requested aspects that exist in the image
+        vk::ImageAspectFlags aspect_mask;
+        if (use_depth) {
+            aspect_mask |= vk::ImageAspectFlagBits::eDepth;
+        }
+        if (use_stencil) {
+            aspect_mask |= vk::ImageAspectFlagBits::eStencil;
+        }
+        aspect_mask &= zeta_surface->GetImageSubresourceRange().aspectMask;
+        if (!aspect_mask) {
+            return false;
+        }
+        const vk::ClearDepthStencilValue clear(regs.clear_depth,
+                                               static_cast<u32>(regs.clear_stencil));
+        clears.emplace_back(aspect_mask, static_cast<u32>(num_color_attachments),
+                            vk::ClearValue(clear));
+    }
+
+    // Getting the views might have flushed or copied surfaces, ending the renderpass
+    if (!scheduler.IsRenderpassActive(last_framebuffer)) {
+        return false;
+    }
+    scheduler.Record([clears, render_area = last_render_area](auto cmdbuf, auto& dld) {
+        const vk::ClearRect rect({{0, 0}, render_area}, 0, 1);
+        cmdbuf.clearAttachments(static_cast<u32>(clears.size()), clears.data(), 1, &rect, dld);
+    });
+    return true;
+}
+
 void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
     MICROPROFILE_SCOPE(Vulkan_Compute);
+    Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::DrawSetup};
     update_descriptor_queue.Acquire();
     sampled_views.clear();
     image_views.clear();
@@ -460,28 +625,46 @@ void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
             [&pipeline](auto cmdbuf, auto& dld) { cmdbuf.setCheckpointNV(nullptr, dld); });
     }
 
+    // Back to back dispatches with the same pipeline and bindings are recorded without rebinding,
+    // identical descriptor sets are reused within a command buffer by the update queue
+    scheduler.BindComputePipeline(pipeline.GetHandle());
+    if (const vk::DescriptorSet descriptor_set = pipeline.CommitDescriptorSet(); descriptor_set) {
+        scheduler.BindComputeDescriptorSet(pipeline.GetLayout(), descriptor_set);
+    }
     scheduler.Record([grid_x = launch_desc.grid_dim_x, grid_y = launch_desc.grid_dim_y,
-                      grid_z = launch_desc.grid_dim_z, pipeline_handle = pipeline.GetHandle(),
-                      layout = pipeline.GetLayout(),
-                      descriptor_set = pipeline.CommitDescriptorSet()](auto cmdbuf, auto& dld) {
-        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_handle, dld);
-        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, layout, DESCRIPTOR_SET, 1,
-                                  &descriptor_set, 0, nullptr, dld);
+                      grid_z = launch_desc.grid_dim_z](auto cmdbuf, auto& dld) {
         cmdbuf.dispatch(grid_x, grid_y, grid_z, dld);
     });
 }
 
+void RasterizerVulkan::LoadDiskResources(const std::atomic_bool& stop_loading,
+                                         const VideoCore::DiskResourceLoadCallback& callback) {
+    pipeline_cache.LoadDiskResources(stop_loading, callback);
+}
+
+void RasterizerVulkan::ResetCounter(VideoCore::QueryType type) {
+    query_cache.ResetCounter(type);
+}
+
+bool RasterizerVulkan::Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+                             std::optional<u64> timestamp) {
+    query_cache.Query(gpu_addr, type, timestamp);
+    return true;
+}
+
 void RasterizerVulkan::FlushAll() {}
 
 void RasterizerVulkan::FlushRegion(CacheAddr addr, u64 size) {
     texture_cache.FlushRegion(addr, size);
     buffer_cache.FlushRegion(addr, size);
+    query_cache.FlushRegion(addr, size);
 }
 
 void RasterizerVulkan::InvalidateRegion(CacheAddr addr, u64 size) {
     texture_cache.InvalidateRegion(addr, size);
     pipeline_cache.InvalidateRegion(addr, size);
     buffer_cache.InvalidateRegion(addr, size);
+    query_cache.InvalidateRegion(addr, size);
 }
 
 void RasterizerVulkan::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
@@ -489,6 +672,14 @@ void RasterizerVulkan::FlushAndInvalidateRegion(CacheAddr addr, u64 size) {
     InvalidateRegion(addr, size);
 }
 
+void RasterizerVulkan::SignalSyncPoint(u32 syncpoint_id) {
+    fence_manager.SignalSyncPoint(syncpoint_id);
+}
+
+void RasterizerVulkan::ReleaseFences() {
+    fence_manager.WaitPendingFences();
+}
+
 void RasterizerVulkan::FlushCommands() {
     if (draw_counter > 0) {
         draw_counter = 0;
@@ -500,14 +691,36 @@ void RasterizerVulkan::TickFrame() {
     draw_counter = 0;
     update_descriptor_queue.TickFrame();
     buffer_cache.TickFrame();
+    texture_cache.TickFrame();
     staging_pool.TickFrame();
+    sampler_cache.TickFrame();
+    CollectFramebuffers();
+}
+
+void RasterizerVulkan::CollectFramebuffers() {
+    // Framebuffers unused for this many frames are no longer in flight and can be destroyed
+    static constexpr u64 COLLECTION_INTERVAL = 256;
+    static constexpr u64 MAX_UNUSED_FRAMES = 1024;
+    if (++frame % COLLECTION_INTERVAL != 0) {
+        return;
+    }
+    for (auto it = framebuffer_cache.begin(); it != framebuffer_cache.end();) {
+        if (it->second.last_use_frame + MAX_UNUSED_FRAMES < frame) {
+            it = framebuffer_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 bool RasterizerVulkan::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                              const Tegra::Engines::Fermi2D::Regs::Surface& dst,
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
-    texture_cache.DoFermiCopy(src, dst, copy_config);
-    return true;
+    return texture_cache.DoFermiCopy(src, dst, copy_config);
+}
+
+bool RasterizerVulkan::AccelerateBufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) {
+    return buffer_cache.CopyRegion(src_addr, dst_addr, static_cast<std::size_t>(size));
 }
 
 bool RasterizerVulkan::AccelerateDisplay(const Tegra::FramebufferConfig& config,
@@ -536,6 +749,18 @@ bool RasterizerVulkan::AccelerateDisplay(const Tegra::FramebufferConfig& config,
     return true;
 }
 
+std::pair<u32, u32> RasterizerVulkan::GetAndResetSurfaceOverlapStats() {
+    return texture_cache.GetAndResetOverlapStats();
+}
+
+u64 RasterizerVulkan::GetAndResetSkippedUploadStats() {
+    return texture_cache.GetAndResetSkippedUploadStats();
+}
+
+std::pair<u64, u64> RasterizerVulkan::GetAndResetBufferUploadStats() {
+    return buffer_cache.GetAndResetUploadStats();
+}
+
 void RasterizerVulkan::FlushWork() {
     static constexpr u32 DRAWS_TO_DISPATCH = 4096;
 
@@ -624,7 +849,8 @@ std::tuple<vk::Framebuffer, vk::Extent2D> RasterizerVulkan::ConfigureFramebuffer
     }
 
     const auto [fbentry, is_cache_miss] = framebuffer_cache.try_emplace(key);
-    auto& framebuffer = fbentry->second;
+    fbentry->second.last_use_frame = frame;
+    auto& framebuffer = fbentry->second.framebuffer;
     if (is_cache_miss) {
         const vk::FramebufferCreateInfo framebuffer_ci({}, key.renderpass,
                                                        static_cast<u32>(key.views.size()),
@@ -659,6 +885,105 @@ RasterizerVulkan::DrawParameters RasterizerVulkan::SetupGeometry(FixedPipelineSt
     return params;
 }
 
+std::pair<const vk::Buffer*, u64> RasterizerVulkan::SetupIndirectDraws(
+    const DrawParameters& params) {
+    const auto& gpu = system.GPU().Maxwell3D();
+    const auto& regs = gpu.regs;
+    const auto& draws = gpu.mme_draw.draws;
+
+    if (params.is_indexed) {
+        // The bound index buffer starts at the lowest index of the batch
+        std::vector<vk::DrawIndexedIndirectCommand> commands;
+        commands.reserve(draws.size());
+        for (const auto& draw : draws) {
+            commands.emplace_back(draw.count, 1, draw.first - regs.index_array.first,
+                                  static_cast<s32>(draw.base_vertex), draw.base_instance);
+        }
+        return buffer_cache.UploadHostMemory(commands.data(),
+                                             commands.size() * sizeof(commands[0]));
+    }
+    std::vector<vk::DrawIndirectCommand> commands;
+    commands.reserve(draws.size());
+    for (const auto& draw : draws) {
+        commands.emplace_back(draw.count, 1, draw.first, draw.base_instance);
+    }
+    return buffer_cache.UploadHostMemory(commands.data(), commands.size() * sizeof(commands[0]));
+}
+
+RasterizerVulkan::TransformFeedbackBindings RasterizerVulkan::SetupTransformFeedback() {
+    TransformFeedbackBindings bindings;
+    if (!device.IsExtTransformFeedbackSupported() || !fixed_state.transform_feedback.IsEnabled()) {
+        return bindings;
+    }
+    const auto& regs = system.GPU().Maxwell3D().regs;
+    UNIMPLEMENTED_IF_MSG(
+        regs.IsShaderConfigEnabled(
+            static_cast<std::size_t>(Maxwell::ShaderProgram::TesselationEval)),
+        "Unimplemented transform feedback of tessellation shaders");
+
+    for (std::size_t index = 0; index < Maxwell::NumTransformFeedbackBuffers; ++index) {
+        const auto& binding = regs.tfb_bindings[index];
+        if (binding.buffer_enable == 0 || binding.buffer_size <= binding.buffer_offset) {
+            continue;
+        }
+        // Bind the cached block as written, vertex fetches of the range will reuse it on the host
+        const GPUVAddr gpu_addr = binding.Address() + static_cast<GPUVAddr>(binding.buffer_offset);
+        const auto size = static_cast<std::size_t>(binding.buffer_size - binding.buffer_offset);
+        const auto [buffer, offset] = buffer_cache.UploadMemory(gpu_addr, size, 4, true);
+        bindings.buffers[index] = buffer;
+        bindings.offsets[index] = offset;
+        bindings.sizes[index] = static_cast<vk::DeviceSize>(size);
+        bindings.is_enabled = true;
+    }
+    return bindings;
+}
+
+void RasterizerVulkan::BeginTransformFeedback(const TransformFeedbackBindings& bindings) {
+    if (!bindings.is_enabled) {
+        return;
+    }
+    std::array<vk::Buffer, Maxwell::NumTransformFeedbackBuffers> buffers;
+    for (std::size_t index = 0; index < buffers.size(); ++index) {
+        buffers[index] = bindings.buffers[index] ? *bindings.buffers[index] : vk::Buffer{};
+    }
+    scheduler.Record([buffers, offsets = bindings.offsets,
+                      sizes = bindings.sizes](auto cmdbuf, auto& dld) {
+        for (u32 index = 0; index < static_cast<u32>(buffers.size()); ++index) {
+            if (buffers[index]) {
+                cmdbuf.bindTransformFeedbackBuffersEXT(index, 1, &buffers[index], &offsets[index],
+                                                       &sizes[index], dld);
+            }
+        }
+        cmdbuf.beginTransformFeedbackEXT(0, 0, nullptr, nullptr, dld);
+    });
+}
+
+void RasterizerVulkan::EndTransformFeedback(const TransformFeedbackBindings& bindings) {
+    if (!bindings.is_enabled) {
+        return;
+    }
+    scheduler.Record(
+        [](auto cmdbuf, auto& dld) { cmdbuf.endTransformFeedbackEXT(0, 0, nullptr, nullptr, dld); });
+
+    // Barriers between draws of the same render pass need subpass dependencies, end it instead
+    scheduler.RequestOutsideRenderPassOperationContext();
+    scheduler.Record([](auto cmdbuf, auto& dld) {
+        const vk::MemoryBarrier barrier(vk::AccessFlagBits::eTransformFeedbackWriteEXT,
+                                        vk::AccessFlagBits::eVertexAttributeRead |
+                                            vk::AccessFlagBits::eIndexRead |
+                                            vk::AccessFlagBits::eIndirectCommandRead |
+                                            vk::AccessFlagBits::eShaderRead |
+                                            vk::AccessFlagBits::eTransferRead);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransformFeedbackEXT,
+                               vk::PipelineStageFlagBits::eDrawIndirect |
+                                   vk::PipelineStageFlagBits::eVertexInput |
+                                   vk::PipelineStageFlagBits::eAllGraphics |
+                                   vk::PipelineStageFlagBits::eComputeShader |
+                                   vk::PipelineStageFlagBits::eTransfer,
+                               {}, {barrier}, {}, {}, dld);
+    });
+}
+
 void RasterizerVulkan::SetupShaderDescriptors(
     const std::array<Shader, Maxwell::MaxShaderProgram>& shaders) {
     texture_cache.GuardSamplers(true);
@@ -721,22 +1046,23 @@ void RasterizerVulkan::UpdateDynamicStates() {
 
 void RasterizerVulkan::SetupVertexArrays(FixedPipelineState::VertexInput& vertex_input,
                                          BufferBindings& buffer_bindings) {
-    const auto& regs = system.GPU().Maxwell3D().regs;
-
-    for (u32 index = 0; index < static_cast<u32>(Maxwell::NumVertexAttributes); ++index) {
-        const auto& attrib = regs.vertex_attrib_format[index];
-        if (!attrib.IsValid()) {
-            continue;
-        }
-
-        const auto& buffer = regs.vertex_array[attrib.buffer];
-        ASSERT(buffer.IsEnabled());
-
-        vertex_input.attributes[vertex_input.num_attributes++] =
-            FixedPipelineState::VertexAttribute(index, attrib.buffer, attrib.type, attrib.size,
-                                                attrib.offset);
+    auto& gpu = system.GPU().Maxwell3D();
+    auto& dirty = gpu.dirty;
+    if (dirty.vertex_attrib_format || dirty.vertex_array_buffers || dirty.vertex_instances) {
+        dirty.vertex_attrib_format = false;
+        dirty.vertex_array_buffers = false;
+        dirty.vertex_instances = false;
+        UpdateVertexInput(vertex_input);
     }
 
+    struct VertexArrayUpload {
+        const vk::Buffer* buffer;
+        u64 offset;
+        std::size_t size;
+    };
+    std::array<VertexArrayUpload, Maxwell::NumVertexArrays> uploads;
+
+    const auto& regs = gpu.regs;
     for (u32 index = 0; index < static_cast<u32>(Maxwell::NumVertexArrays); ++index) {
         const auto& vertex_array = regs.vertex_array[index];
         if (!vertex_array.IsEnabled()) {
@@ -749,11 +1075,80 @@ void RasterizerVulkan::SetupVertexArrays(FixedPipelineState::VertexInput& vertex
         ASSERT(end > start);
         const std::size_t size{end - start + 1};
         const auto [buffer, offset] = buffer_cache.UploadMemory(start, size);
+        buffer_bindings.AddVertexBinding(index, buffer, offset);
+        uploads[index] = {buffer, offset, size};
+    }
+
+    for (const auto& conversion : vertex_conversions) {
+        const auto& attribute = conversion.attribute;
+        const auto& upload = uploads[attribute.buffer];
+        const u32 stride = regs.vertex_array[attribute.buffer].stride;
+
+        // Convert every vertex in the array, indexed draws can fetch any of them
+        const std::size_t attribute_end = attribute.offset + attribute.SizeInBytes();
+        u32 num_vertices = 1;
+        if (stride != 0 && upload.size > attribute_end) {
+            num_vertices += static_cast<u32>((upload.size - attribute_end) / stride);
+        }
+        const auto [buffer, offset] = vertex_format_pass.Assemble(
+            attribute, stride, num_vertices, *upload.buffer, upload.offset, upload.size);
+        buffer_bindings.AddVertexBinding(conversion.binding, buffer, offset);
+    }
+}
+
+void RasterizerVulkan::UpdateVertexInput(FixedPipelineState::VertexInput& vertex_input) {
+    const auto& regs = system.GPU().Maxwell3D().regs;
+    vertex_input.num_bindings = 0;
+    vertex_input.num_attributes = 0;
+    vertex_conversions.clear();
 
+    u32 used_bindings = 0;
+    for (u32 index = 0; index < static_cast<u32>(Maxwell::NumVertexArrays); ++index) {
+        const auto& vertex_array = regs.vertex_array[index];
+        if (!vertex_array.IsEnabled()) {
+            continue;
+        }
+        used_bindings |= 1U << index;
         vertex_input.bindings[vertex_input.num_bindings++] = FixedPipelineState::VertexBinding(
             index, vertex_array.stride,
             regs.instanced_arrays.IsInstancingEnabled(index) ? vertex_array.divisor : 0);
-        buffer_bindings.AddVertexBinding(buffer, offset);
+    }
+
+    for (u32 index = 0; index < static_cast<u32>(Maxwell::NumVertexAttributes); ++index) {
+        const auto& attrib = regs.vertex_attrib_format[index];
+        if (!attrib.IsValid()) {
+            continue;
+        }
+
+        const auto& buffer = regs.vertex_array[attrib.buffer];
+        ASSERT(buffer.IsEnabled());
+
+        const bool needs_conversion =
+            !MaxwellToVK::IsVertexFormatSupported(device, attrib.type, attrib.size) &&
+            VertexFormatPass::IsConvertible(attrib);
+        if (needs_conversion && used_bindings == std::numeric_limits<u32>::max()) {
+            LOG_ERROR(Render_Vulkan, "No free vertex binding to convert attribute {}", index);
+        }
+        if (!needs_conversion || used_bindings == std::numeric_limits<u32>::max()) {
+            vertex_input.attributes[vertex_input.num_attributes++] =
+                FixedPipelineState::VertexAttribute(index, attrib.buffer, attrib.type, attrib.size,
+                                                    attrib.offset);
+            continue;
+        }
+
+        // Converted attributes are tightly packed in their own binding, using the lowest free one
+        const u32 binding = Common::CountTrailingZeroes32(~used_bindings);
+        used_bindings |= 1U << binding;
+        const u32 stride = buffer.stride == 0 ? 0 : 4 * sizeof(u32);
+        const bool is_instanced = regs.instanced_arrays.IsInstancingEnabled(attrib.buffer);
+        vertex_input.bindings[vertex_input.num_bindings++] = FixedPipelineState::VertexBinding(
+            binding, stride, is_instanced ? buffer.divisor : 0);
+        constexpr auto converted_size = Maxwell::VertexAttribute::Size::Size_32_32_32_32;
+        vertex_input.attributes[vertex_input.num_attributes++] =
+            FixedPipelineState::VertexAttribute(index, binding,
+                                                VertexFormatPass::GetConvertedType(attrib),
+                                                converted_size, 0);
+        vertex_conversions.push_back({attrib, binding});
     }
 }
 
@@ -762,17 +1157,39 @@ void RasterizerVulkan::SetupIndexBuffer(BufferBindings& buffer_bindings, DrawPar
     const auto& regs = system.GPU().Maxwell3D().regs;
     switch (regs.draw.topology) {
     case Maxwell::PrimitiveTopology::Quads:
-        if (params.is_indexed) {
-            UNIMPLEMENTED();
-        } else {
+        if (!params.is_indexed) {
             const auto [buffer, offset] =
                 quad_array_pass.Assemble(params.num_vertices, params.base_vertex);
             buffer_bindings.SetIndexBinding(&buffer, offset, vk::IndexType::eUint32);
             params.base_vertex = 0;
             params.num_vertices = params.num_vertices * 6 / 4;
             params.is_indexed = true;
+            break;
+        }
+        [[fallthrough]];
+    case Maxwell::PrimitiveTopology::QuadStrip:
+    case Maxwell::PrimitiveTopology::LineLoop: {
+        // Topologies without a Vulkan equivalent are converted to lists on the GPU
+        const auto topology = regs.draw.topology.Value();
+        const vk::Buffer* buffer;
+        u64 offset;
+        if (params.is_indexed) {
+            const GPUVAddr gpu_addr = regs.index_array.IndexStart();
+            const auto [src_buffer, src_offset] =
+                buffer_cache.UploadMemory(gpu_addr, CalculateIndexBufferSize());
+            std::tie(buffer, offset) =
+                topology_pass.AssembleIndexed(topology, params.num_vertices,
+                                              regs.index_array.format, *src_buffer, src_offset);
+        } else {
+            std::tie(buffer, offset) =
+                topology_pass.AssembleArray(topology, params.num_vertices, params.base_vertex);
+            params.base_vertex = 0;
         }
+        buffer_bindings.SetIndexBinding(buffer, offset, vk::IndexType::eUint32);
+        params.num_vertices = TopologyPass::GetNumOutputVertices(topology, params.num_vertices);
+        params.is_indexed = true;
         break;
+    }
     default: {
         if (!is_indexed) {
             break;
@@ -798,7 +1215,8 @@ void RasterizerVulkan::SetupGraphicsConstBuffers(const ShaderEntries& entries, s
     const auto& gpu = system.GPU().Maxwell3D();
     const auto& shader_stage = gpu.state.shader_stages[stage];
     for (const auto& entry : entries.const_buffers) {
-        SetupConstBuffer(entry, shader_stage.const_buffers[entry.GetIndex()]);
+        const std::size_t upload_slot = stage * Maxwell::MaxConstBuffers + entry.GetIndex();
+        SetupConstBuffer(entry, shader_stage.const_buffers[entry.GetIndex()], upload_slot);
     }
 }
 
@@ -807,10 +1225,12 @@ void RasterizerVulkan::SetupGraphicsGlobalBuffers(const ShaderEntries& entries,
     auto& gpu{system.GPU()};
     const auto cbufs{gpu.Maxwell3D().state.shader_stages[stage]};
 
+    global_ranges.clear();
     for (const auto& entry : entries.global_buffers) {
         const auto addr = cbufs.const_buffers[entry.GetCbufIndex()].address + entry.GetCbufOffset();
-        SetupGlobalBuffer(entry, addr);
+        AddGlobalBufferRange(entry, addr);
     }
+    SetupGlobalBuffers();
 }
 
 void RasterizerVulkan::SetupGraphicsTexelBuffers(const ShaderEntries& entries, std::size_t stage) {
@@ -850,17 +1270,19 @@ void RasterizerVulkan::SetupComputeConstBuffers(const ShaderEntries& entries) {
         buffer.address = config.Address();
         buffer.size = config.size;
         buffer.enabled = mask[entry.GetIndex()];
-        SetupConstBuffer(entry, buffer);
+        SetupConstBuffer(entry, buffer, std::nullopt);
     }
 }
 
 void RasterizerVulkan::SetupComputeGlobalBuffers(const ShaderEntries& entries) {
     MICROPROFILE_SCOPE(Vulkan_GlobalBuffers);
     const auto cbufs{system.GPU().KeplerCompute().launch_description.const_buffer_config};
+    global_ranges.clear();
     for (const auto& entry : entries.global_buffers) {
         const auto addr{cbufs[entry.GetCbufIndex()].Address() + entry.GetCbufOffset()};
-        SetupGlobalBuffer(entry, addr);
+        AddGlobalBufferRange(entry, addr);
     }
+    SetupGlobalBuffers();
 }
 
 void RasterizerVulkan::SetupComputeTexelBuffers(const ShaderEntries& entries) {
@@ -891,35 +1313,47 @@ void RasterizerVulkan::SetupComputeImages(const ShaderEntries& entries) {
 }
 
 void RasterizerVulkan::SetupConstBuffer(const ConstBufferEntry& entry,
-                                        const Tegra::Engines::ConstBufferInfo& buffer) {
+                                        const Tegra::Engines::ConstBufferInfo& buffer,
+                                        std::optional<std::size_t> upload_slot) {
     // Align the size to avoid bad std140 interactions
     const std::size_t size =
         Common::AlignUp(CalculateConstBufferSize(entry, buffer), 4 * sizeof(float));
     ASSERT(size <= MaxConstbufferSize);
 
+    const std::size_t alignment = device.GetUniformBufferAlignment();
     const auto [buffer_handle, offset] =
-        buffer_cache.UploadMemory(buffer.address, size, device.GetUniformBufferAlignment());
+        upload_slot ? buffer_cache.UploadConstBuffer(*upload_slot, buffer.address, size, alignment,
+                                                     buffer.generation)
+                    : buffer_cache.UploadMemory(buffer.address, size, alignment);
 
     update_descriptor_queue.AddBuffer(buffer_handle, offset, size);
 }
 
-void RasterizerVulkan::SetupGlobalBuffer(const GlobalBufferEntry& entry, GPUVAddr address) {
+void RasterizerVulkan::AddGlobalBufferRange(const GlobalBufferEntry& entry, GPUVAddr address) {
     auto& memory_manager{system.GPU().MemoryManager()};
     const auto actual_addr = memory_manager.Read<u64>(address);
-    const auto size = memory_manager.Read<u32>(address + 8);
-
-    if (size == 0) {
-        // Sometimes global memory pointers don't have a proper size. Upload a dummy entry because
-        // Vulkan doesn't like empty buffers.
-        constexpr std::size_t dummy_size = 4;
-        const auto buffer = buffer_cache.GetEmptyBuffer(dummy_size);
-        update_descriptor_queue.AddBuffer(buffer, 0, dummy_size);
-        return;
+    auto size = static_cast<std::size_t>(memory_manager.Read<u32>(address + 8));
+    if (const u32 size_bound = entry.GetSizeBound(); size_bound != 0) {
+        // The shader only reaches a constant window from the base pointer, skip the rest
+        size = std::min<std::size_t>(size, size_bound);
     }
+    global_ranges.push_back({actual_addr, size, entry.IsWritten()});
+}
 
-    const auto [buffer, offset] = buffer_cache.UploadMemory(
-        actual_addr, size, device.GetStorageBufferAlignment(), entry.IsWritten());
-    update_descriptor_queue.AddBuffer(buffer, offset, size);
+void RasterizerVulkan::SetupGlobalBuffers() {
+    buffer_cache.UploadMemoryRanges(global_ranges, device.GetStorageBufferAlignment(),
+                                    global_buffers);
+    for (std::size_t i = 0; i < global_ranges.size(); ++i) {
+        const auto [buffer, offset] = global_buffers[i];
+        if (global_ranges[i].size == 0) {
+            // Sometimes global memory pointers don't have a proper size. Upload a dummy entry
+            // because Vulkan doesn't like empty buffers.
+            constexpr std::size_t dummy_size = sizeof(u32);
+            update_descriptor_queue.AddBuffer(buffer, 0, dummy_size);
+            continue;
+        }
+        update_descriptor_queue.AddBuffer(buffer, offset, global_ranges[i].size);
+    }
 }
 
 void RasterizerVulkan::SetupTexelBuffer(const Tegra::Texture::TICEntry& tic,
@@ -1068,11 +1502,18 @@ void RasterizerVulkan::UpdateStencilFaces(Tegra::Engines::Maxwell3D& gpu) {
     }
 }
 
-std::size_t RasterizerVulkan::CalculateGraphicsStreamBufferSize(bool is_indexed) const {
+std::size_t RasterizerVulkan::CalculateGraphicsStreamBufferSize(bool is_indexed,
+                                                                bool is_multi_draw) const {
     std::size_t size = CalculateVertexArraysSize();
     if (is_indexed) {
         size = Common::AlignUp(size, 4) + CalculateIndexBufferSize();
     }
+    if (is_multi_draw) {
+        const std::size_t command_size = is_indexed ? sizeof(vk::DrawIndexedIndirectCommand)
+                                                    : sizeof(vk::DrawIndirectCommand);
+        size = Common::AlignUp(size, 4) +
+               system.GPU().Maxwell3D().mme_draw.draws.size() * command_size;
+    }
     size += Maxwell::MaxConstBuffers * (MaxConstbufferSize + device.GetUniformBufferAlignment());
     return size;
 }
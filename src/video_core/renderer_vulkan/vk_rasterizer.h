@@ -5,8 +5,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -22,8 +24,10 @@
 #include "video_core/renderer_vulkan/vk_buffer_cache.h"
 #include "video_core/renderer_vulkan/vk_compute_pass.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
+#include "video_core/renderer_vulkan/vk_fence_manager.h"
 #include "video_core/renderer_vulkan/vk_memory_manager.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_query_cache.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
 #include "video_core/renderer_vulkan/vk_sampler_cache.h"
@@ -96,6 +100,17 @@ struct ImageView {
     vk::ImageLayout* layout = nullptr;
 };
 
+/// Vertex and index buffers bound in the command buffer of tick, used to skip redundant binds.
+struct BoundGeometryBuffers {
+    std::optional<u64> tick;
+    std::size_t num_vertex_buffers = 0;
+    std::array<vk::Buffer, Maxwell::NumVertexArrays> vertex_buffers;
+    std::array<vk::DeviceSize, Maxwell::NumVertexArrays> vertex_offsets;
+    vk::Buffer index_buffer;
+    vk::DeviceSize index_offset = 0;
+    vk::IndexType index_type{};
+};
+
 class RasterizerVulkan : public VideoCore::RasterizerAccelerated {
 public:
     explicit RasterizerVulkan(Core::System& system, Core::Frontend::EmuWindow& render_window,
@@ -108,17 +123,27 @@ public:
     bool DrawMultiBatch(bool is_indexed) override;
     void Clear() override;
     void DispatchCompute(GPUVAddr code_addr) override;
+    void ResetCounter(VideoCore::QueryType type) override;
+    bool Query(GPUVAddr gpu_addr, VideoCore::QueryType type, std::optional<u64> timestamp) override;
+    void LoadDiskResources(const std::atomic_bool& stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback) override;
     void FlushAll() override;
     void FlushRegion(CacheAddr addr, u64 size) override;
     void InvalidateRegion(CacheAddr addr, u64 size) override;
     void FlushAndInvalidateRegion(CacheAddr addr, u64 size) override;
+    void SignalSyncPoint(u32 syncpoint_id) override;
+    void ReleaseFences() override;
     void FlushCommands() override;
     void TickFrame() override;
     bool AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
                                const Tegra::Engines::Fermi2D::Regs::Surface& dst,
                                const Tegra::Engines::Fermi2D::Config& copy_config) override;
+    bool AccelerateBufferCopy(GPUVAddr src_addr, GPUVAddr dst_addr, u64 size) override;
     bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                            u32 pixel_stride) override;
+    std::pair<u32, u32> GetAndResetSurfaceOverlapStats() override;
+    u64 GetAndResetSkippedUploadStats() override;
+    std::pair<u64, u64> GetAndResetBufferUploadStats() override;
 
     /// Maximum supported size that a constbuffer can have in bytes.
     static constexpr std::size_t MaxConstbufferSize = 0x10000;
@@ -134,6 +159,20 @@ private:
         u32 base_vertex = 0;
         u32 num_vertices = 0;
         bool is_indexed = 0;
+
+        // Multi draw batches, issued as indirect draws when num_draws is not zero
+        vk::Buffer indirect_buffer;
+        u64 indirect_offset = 0;
+        u32 num_draws = 0;
+        bool is_multi_draw_indirect = false;
+    };
+
+    /// Transform feedback buffers written by a draw, they live in the buffer cache blocks.
+    struct TransformFeedbackBindings {
+        std::array<const vk::Buffer*, Maxwell::NumTransformFeedbackBuffers> buffers{};
+        std::array<vk::DeviceSize, Maxwell::NumTransformFeedbackBuffers> offsets{};
+        std::array<vk::DeviceSize, Maxwell::NumTransformFeedbackBuffers> sizes{};
+        bool is_enabled = false;
     };
 
     using Texceptions = std::bitset<Maxwell::NumRenderTargets + 1>;
@@ -144,6 +183,12 @@ private:
 
     void FlushWork();
 
+    /// Destroys framebuffers that haven't been used in a while.
+    void CollectFramebuffers();
+
+    /// Tries to clear attachments of the active renderpass without ending it.
+    bool ClearInsideRenderpass(bool use_color, bool use_depth, bool use_stencil);
+
     Texceptions UpdateAttachments();
 
     std::tuple<vk::Framebuffer, vk::Extent2D> ConfigureFramebuffers(vk::RenderPass renderpass);
@@ -152,6 +197,18 @@ private:
     DrawParameters SetupGeometry(FixedPipelineState& fixed_state, BufferBindings& buffer_bindings,
                                  bool is_indexed, bool is_instanced);
 
+    /// Uploads the commands of the current multi draw batch, returning where they are.
+    std::pair<const vk::Buffer*, u64> SetupIndirectDraws(const DrawParameters& params);
+
+    /// Gets the buffers the varyings of the draw are captured to, if transform feedback is enabled.
+    TransformFeedbackBindings SetupTransformFeedback();
+
+    /// Binds the buffers and starts the capture of the next draw.
+    void BeginTransformFeedback(const TransformFeedbackBindings& bindings);
+
+    /// Ends the capture and makes the captured varyings visible to later reads.
+    void EndTransformFeedback(const TransformFeedbackBindings& bindings);
+
     /// Setup descriptors in the graphics pipeline.
     void SetupShaderDescriptors(const std::array<Shader, Maxwell::MaxShaderProgram>& shaders);
 
@@ -166,6 +223,9 @@ private:
     void SetupVertexArrays(FixedPipelineState::VertexInput& vertex_input,
                            BufferBindings& buffer_bindings);
 
+    /// Rebuilds the vertex bindings and attributes of the pipeline from the vertex registers.
+    void UpdateVertexInput(FixedPipelineState::VertexInput& vertex_input);
+
     void SetupIndexBuffer(BufferBindings& buffer_bindings, DrawParameters& params, bool is_indexed);
 
     /// Setup constant buffers in the graphics pipeline.
@@ -199,9 +259,14 @@ private:
     void SetupComputeImages(const ShaderEntries& entries);
 
     void SetupConstBuffer(const ConstBufferEntry& entry,
-                          const Tegra::Engines::ConstBufferInfo& buffer);
+                          const Tegra::Engines::ConstBufferInfo& buffer,
+                          std::optional<std::size_t> upload_slot);
+
+    /// Queues the range of a global buffer, trimmed to what the shader can reach.
+    void AddGlobalBufferRange(const GlobalBufferEntry& entry, GPUVAddr address);
 
-    void SetupGlobalBuffer(const GlobalBufferEntry& entry, GPUVAddr address);
+    /// Uploads the queued global buffer ranges, coalescing neighbours, and binds them in order.
+    void SetupGlobalBuffers();
 
     void SetupTexelBuffer(const Tegra::Texture::TICEntry& image, const TexelBufferEntry& entry);
 
@@ -216,7 +281,7 @@ private:
     void UpdateDepthBounds(Tegra::Engines::Maxwell3D& gpu);
     void UpdateStencilFaces(Tegra::Engines::Maxwell3D& gpu);
 
-    std::size_t CalculateGraphicsStreamBufferSize(bool is_indexed) const;
+    std::size_t CalculateGraphicsStreamBufferSize(bool is_indexed, bool is_multi_draw) const;
 
     std::size_t CalculateComputeStreamBufferSize() const;
 
@@ -242,22 +307,54 @@ private:
     VKUpdateDescriptorQueue update_descriptor_queue;
     QuadArrayPass quad_array_pass;
     Uint8Pass uint8_pass;
+    TopologyPass topology_pass;
+    VertexFormatPass vertex_format_pass;
 
     VKTextureCache texture_cache;
     VKPipelineCache pipeline_cache;
     VKBufferCache buffer_cache;
     VKSamplerCache sampler_cache;
+    VKFenceManager fence_manager;
+    VKQueryCache query_cache;
+
+    /// Fixed state of the last draw, only its dirty groups are rebuilt on each draw
+    FixedPipelineState fixed_state{};
 
     std::array<View, Maxwell::NumRenderTargets> color_attachments;
     View zeta_attachment;
 
+    /// Framebuffer and render area of the last draw, attachments above are bound to it
+    vk::Framebuffer last_framebuffer;
+    vk::Extent2D last_render_area;
+
     std::vector<ImageView> sampled_views;
     std::vector<ImageView> image_views;
 
+    struct VertexConversion {
+        Maxwell::VertexAttribute attribute;
+        u32 binding;
+    };
+
+    /// Attributes the device can't fetch, converted on the GPU to their own binding on each draw
+    boost::container::static_vector<VertexConversion, Maxwell::NumVertexAttributes>
+        vertex_conversions;
+
+    /// Buffers bound by the last draw, only changed bindings are recorded again
+    BoundGeometryBuffers bound_buffers;
+
+    std::vector<VideoCommon::MemoryRange> global_ranges;
+    std::vector<VKBufferCache::BufferInfo> global_buffers;
+
     u32 draw_counter = 0;
 
+    struct FramebufferEntry {
+        UniqueFramebuffer framebuffer;
+        u64 last_use_frame = 0;
+    };
+
     // TODO(Rodrigo): Invalidate on image destruction
-    std::unordered_map<FramebufferCacheKey, UniqueFramebuffer> framebuffer_cache;
+    std::unordered_map<FramebufferCacheKey, FramebufferEntry> framebuffer_cache;
+    u64 frame = 0;
 };
 
 } // namespace Vulkan
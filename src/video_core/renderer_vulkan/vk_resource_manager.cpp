@@ -66,8 +66,9 @@ VKResource::VKResource() = default;
 
 VKResource::~VKResource() = default;
 
-VKFence::VKFence(const VKDevice& device, UniqueFence handle)
-    : device{device}, handle{std::move(handle)} {}
+VKFence::VKFence(const VKDevice& device, VKResourceManager& resource_manager,
+                 UniqueFence handle)
+    : device{device}, resource_manager{resource_manager}, handle{std::move(handle)} {}
 
 VKFence::~VKFence() = default;
 
@@ -91,7 +92,12 @@ void VKFence::Release() {
     is_owned = false;
 }
 
-void VKFence::Commit() {
+bool VKFence::IsTickFree(u64 resource_tick) const {
+    return resource_manager.IsTickFree(resource_tick);
+}
+
+void VKFence::Commit(u64 new_tick) {
+    tick = new_tick;
     is_owned = true;
     is_used = true;
 }
@@ -198,6 +204,17 @@ bool VKFenceWatch::TryWatch(VKFence& new_fence) {
     return true;
 }
 
+void VKFenceWatch::Rewatch(VKFence& new_fence) {
+    if (fence == &new_fence) {
+        return;
+    }
+    if (fence) {
+        fence->Unprotect(this);
+    }
+    fence = &new_fence;
+    fence->Protect(this);
+}
+
 void VKFenceWatch::OnFenceRemoval(VKFence* signaling_fence) {
     ASSERT_MSG(signaling_fence == fence, "Removing the wrong fence");
     fence = nullptr;
@@ -208,9 +225,16 @@ VKFencedPool::VKFencedPool(std::size_t grow_step) : grow_step{grow_step} {}
 VKFencedPool::~VKFencedPool() = default;
 
 std::size_t VKFencedPool::CommitResource(VKFence& fence) {
+    const u64 tick = fence.GetTick();
     const auto Search = [&](std::size_t begin, std::size_t end) -> std::optional<std::size_t> {
         for (std::size_t iterator = begin; iterator < end; ++iterator) {
-            if (watches[iterator]->TryWatch(fence)) {
+            if (tick != 0) {
+                if (fence.IsTickFree(ticks[iterator])) {
+                    // The last usage of the resource has finished, mark it with the new tick.
+                    ticks[iterator] = tick;
+                    return iterator;
+                }
+            } else if (watches[iterator]->TryWatch(fence)) {
                 // The resource is now being watched, a free resource was successfully found.
                 return iterator;
             }
@@ -227,7 +251,11 @@ std::size_t VKFencedPool::CommitResource(VKFence& fence) {
             const std::size_t free_resource = ManageOverflow();
 
             // Watch will wait for the resource to be free.
-            watches[free_resource]->Watch(fence);
+            if (tick != 0) {
+                ticks[free_resource] = tick;
+            } else {
+                watches[free_resource]->Watch(fence);
+            }
             found = free_resource;
         }
     }
@@ -248,12 +276,20 @@ std::size_t VKFencedPool::ManageOverflow() {
 void VKFencedPool::Grow() {
     const std::size_t old_capacity = watches.size();
     watches.resize(old_capacity + grow_step);
+    ticks.resize(old_capacity + grow_step);
     std::generate(watches.begin() + old_capacity, watches.end(),
                   []() { return std::make_unique<VKFenceWatch>(); });
     Allocate(old_capacity, old_capacity + grow_step);
 }
 
 VKResourceManager::VKResourceManager(const VKDevice& device) : device{device} {
+    if (device.IsKhrTimelineSemaphoreSupported()) {
+        const vk::SemaphoreTypeCreateInfoKHR semaphore_type_ci(vk::SemaphoreTypeKHR::eTimeline, 0);
+        vk::SemaphoreCreateInfo semaphore_ci;
+        semaphore_ci.pNext = &semaphore_type_ci;
+        timeline = device.GetLogical().createSemaphoreUnique(semaphore_ci, nullptr,
+                                                             device.GetDispatchLoader());
+    }
     GrowFences(FENCES_GROW_STEP);
     command_buffer_pool = std::make_unique<CommandBufferPool>(device);
 }
@@ -277,7 +313,7 @@ VKFence& VKResourceManager::CommitFence() {
             fences_iterator = 0;
 
         auto& fence = *it;
-        fence->Commit();
+        fence->Commit(timeline ? ++last_tick : 0);
         return fence.get();
     };
 
@@ -303,6 +339,16 @@ vk::CommandBuffer VKResourceManager::CommitCommandBuffer(VKFence& fence) {
     return command_buffer_pool->Commit(fence);
 }
 
+bool VKResourceManager::IsTickFree(u64 tick) {
+    if (tick <= gpu_tick) {
+        return true;
+    }
+    // Only query the driver when the cached value is not enough to know the answer.
+    const auto dev = device.GetLogical();
+    gpu_tick = dev.getSemaphoreCounterValueKHR(*timeline, device.GetDispatchLoader());
+    return tick <= gpu_tick;
+}
+
 void VKResourceManager::GrowFences(std::size_t new_fences_count) {
     const auto dev = device.GetLogical();
     const auto& dld = device.GetDispatchLoader();
@@ -312,7 +358,8 @@ void VKResourceManager::GrowFences(std::size_t new_fences_count) {
     fences.resize(previous_size + new_fences_count);
 
     std::generate(fences.begin() + previous_size, fences.end(), [&]() {
-        return std::make_unique<VKFence>(device, dev.createFenceUnique(fence_ci, nullptr, dld));
+        return std::make_unique<VKFence>(device, *this,
+                                         dev.createFenceUnique(fence_ci, nullptr, dld));
     });
 }
 
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <memory>
 #include <vector>
+#include "common/common_types.h"
 #include "video_core/renderer_vulkan/declarations.h"
 
 namespace Vulkan {
@@ -42,7 +43,8 @@ class VKFence {
     friend class VKResourceManager;
 
 public:
-    explicit VKFence(const VKDevice& device, UniqueFence handle);
+    explicit VKFence(const VKDevice& device, VKResourceManager& resource_manager,
+                     UniqueFence handle);
     ~VKFence();
 
     /**
@@ -68,14 +70,25 @@ public:
     /// Redirects one protected resource to a new address.
     void RedirectProtection(VKResource* old_resource, VKResource* new_resource) noexcept;
 
+    /**
+     * Returns true when a resource last used by the submission signaling the given tick is no
+     * longer used by the GPU. Only valid when the fence has a tick.
+     */
+    bool IsTickFree(u64 resource_tick) const;
+
+    /// Returns the timeline semaphore value signaled with this fence, zero when there's none.
+    u64 GetTick() const {
+        return tick;
+    }
+
     /// Retreives the fence.
     operator vk::Fence() const {
         return *handle;
     }
 
 private:
-    /// Take ownership of the fence.
-    void Commit();
+    /// Take ownership of the fence, its submission will signal the given timeline tick.
+    void Commit(u64 new_tick);
 
     /**
      * Updates the fence status.
@@ -87,8 +100,10 @@ private:
     bool Tick(bool gpu_wait, bool owner_wait);
 
     const VKDevice& device;                       ///< Device handler
+    VKResourceManager& resource_manager;          ///< Resource manager owning the fence
     UniqueFence handle;                           ///< Vulkan fence
     std::vector<VKResource*> protected_resources; ///< List of resources protected by this fence
+    u64 tick = 0;          ///< Timeline semaphore value signaled with the fence.
     bool is_owned = false; ///< The fence has been commited but not released yet.
     bool is_used = false;  ///< The fence has been commited but it has not been checked to be free.
 };
@@ -122,6 +137,13 @@ public:
      */
     bool TryWatch(VKFence& new_fence);
 
+    /**
+     * Stops watching the previous fence without waiting for it and watches a new one.
+     * Only valid when the new fence is signaled after the previous one.
+     * @param new_fence New fence to wait to.
+     */
+    void Rewatch(VKFence& new_fence);
+
     void OnFenceRemoval(VKFence* signaling_fence) override;
 
     /**
@@ -138,7 +160,8 @@ private:
 
 /**
  * Handles a pool of resources protected by fences. Manages resource overflow allocating more
- * resources.
+ * resources. When timeline semaphores are available resources are tracked with the tick of their
+ * last usage instead of being watched.
  */
 class VKFencedPool {
 public:
@@ -166,6 +189,7 @@ private:
     std::size_t grow_step = 0;     ///< Number of new resources created after an overflow
     std::size_t free_iterator = 0; ///< Hint to where the next free resources is likely to be found
     std::vector<std::unique_ptr<VKFenceWatch>> watches; ///< Set of watched resources
+    std::vector<u64> ticks; ///< Tick of the last usage of each resource, used with timelines
 };
 
 /**
@@ -183,11 +207,22 @@ public:
     /// Commits an unused command buffer and protects it with a fence.
     vk::CommandBuffer CommitCommandBuffer(VKFence& fence);
 
+    /// Returns true when the submission signaling the given tick has been completed by the GPU.
+    bool IsTickFree(u64 tick);
+
+    /// Returns the timeline semaphore signaled on each submission, null when it's not supported.
+    vk::Semaphore GetTimelineSemaphore() const {
+        return *timeline;
+    }
+
 private:
     /// Allocates new fences.
     void GrowFences(std::size_t new_fences_count);
 
     const VKDevice& device;          ///< Device handler.
+    UniqueSemaphore timeline;        ///< Timeline semaphore, null when it's not supported.
+    u64 last_tick = 0;               ///< Last tick assigned to a fence.
+    u64 gpu_tick = 0;                ///< Last tick known to be completed by the GPU.
     std::size_t fences_iterator = 0; ///< Index where a free fence is likely to be found.
     std::vector<std::unique_ptr<VKFence>> fences;           ///< Pool of fences.
     std::unique_ptr<CommandBufferPool> command_buffer_pool; ///< Pool of command buffers.
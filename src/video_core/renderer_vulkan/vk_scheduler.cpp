@@ -2,10 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_query_cache.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 
@@ -108,6 +111,29 @@ void VKScheduler::BindGraphicsPipeline(vk::Pipeline pipeline) {
     });
 }
 
+void VKScheduler::BindComputePipeline(vk::Pipeline pipeline) {
+    if (state.compute_pipeline == pipeline) {
+        return;
+    }
+    state.compute_pipeline = pipeline;
+    Record([pipeline](auto cmdbuf, auto& dld) {
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline, dld);
+    });
+}
+
+void VKScheduler::BindComputeDescriptorSet(vk::PipelineLayout layout,
+                                           vk::DescriptorSet descriptor_set) {
+    if (state.compute_layout == layout && state.compute_descriptor_set == descriptor_set) {
+        return;
+    }
+    state.compute_layout = layout;
+    state.compute_descriptor_set = descriptor_set;
+    Record([layout, descriptor_set](auto cmdbuf, auto& dld) {
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, layout, 0, 1, &descriptor_set, 0,
+                                  nullptr, dld);
+    });
+}
+
 void VKScheduler::WorkerThread() {
     std::unique_lock lock{mutex};
     do {
@@ -133,8 +159,25 @@ void VKScheduler::SubmitExecution(vk::Semaphore semaphore) {
     const auto& dld = device.GetDispatchLoader();
     current_cmdbuf.end(dld);
 
-    const vk::SubmitInfo submit_info(0, nullptr, nullptr, 1, &current_cmdbuf, semaphore ? 1U : 0U,
-                                     &semaphore);
+    std::array<vk::Semaphore, 2> signal_semaphores;
+    std::array<u64, 2> signal_values{};
+    u32 num_signal_semaphores = 0;
+    if (semaphore) {
+        signal_semaphores[num_signal_semaphores++] = semaphore;
+    }
+
+    vk::SubmitInfo submit_info(0, nullptr, nullptr, 1, &current_cmdbuf);
+    vk::TimelineSemaphoreSubmitInfoKHR timeline_si;
+    if (const vk::Semaphore timeline = resource_manager.GetTimelineSemaphore()) {
+        // Binary semaphores ignore their signal value, only the timeline one has to be set
+        signal_values[num_signal_semaphores] = current_fence->GetTick();
+        signal_semaphores[num_signal_semaphores++] = timeline;
+        timeline_si.signalSemaphoreValueCount = num_signal_semaphores;
+        timeline_si.pSignalSemaphoreValues = signal_values.data();
+        submit_info.pNext = &timeline_si;
+    }
+    submit_info.signalSemaphoreCount = num_signal_semaphores;
+    submit_info.pSignalSemaphores = signal_semaphores.data();
     queue.submit({submit_info}, static_cast<vk::Fence>(*current_fence), dld);
 }
 
@@ -142,14 +185,23 @@ void VKScheduler::AllocateNewContext() {
     std::unique_lock lock{mutex};
     current_fence = next_fence;
     next_fence = &resource_manager.CommitFence();
+    ++ticks;
 
     current_cmdbuf = resource_manager.CommitCommandBuffer(*current_fence);
     current_cmdbuf.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit},
                          device.GetDispatchLoader());
+
+    // Streams ended by the last submission are started again in the new command buffer
+    if (query_cache) {
+        query_cache->UpdateCounters();
+    }
 }
 
 void VKScheduler::InvalidateState() {
     state.graphics_pipeline = nullptr;
+    state.compute_pipeline = nullptr;
+    state.compute_layout = nullptr;
+    state.compute_descriptor_set = nullptr;
     state.viewports = false;
     state.scissors = false;
     state.depth_bias = false;
@@ -159,6 +211,9 @@ void VKScheduler::InvalidateState() {
 }
 
 void VKScheduler::EndPendingOperations() {
+    if (query_cache) {
+        query_cache->DisableStreams();
+    }
     EndRenderPass();
 }
 
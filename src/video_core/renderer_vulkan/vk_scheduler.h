@@ -18,6 +18,7 @@ namespace Vulkan {
 
 class VKDevice;
 class VKFence;
+class VKQueryCache;
 class VKResourceManager;
 
 class VKFenceView {
@@ -64,9 +65,27 @@ public:
     /// of a renderpass.
     void RequestOutsideRenderPassOperationContext();
 
+    /// Returns true when a renderpass rendering to the given framebuffer is active.
+    bool IsRenderpassActive(vk::Framebuffer framebuffer) const {
+        return state.renderpass && state.renderpass->framebuffer == framebuffer;
+    }
+
     /// Binds a pipeline to the current execution context.
     void BindGraphicsPipeline(vk::Pipeline pipeline);
 
+    /// Binds a compute pipeline to the current execution context.
+    void BindComputePipeline(vk::Pipeline pipeline);
+
+    /// Binds a descriptor set to the compute bind point, skipping the call when the same set was
+    /// the last one bound with the same layout in the current command buffer.
+    void BindComputeDescriptorSet(vk::PipelineLayout layout, vk::DescriptorSet descriptor_set);
+
+    /// Sets the query cache whose streams are ended before each submission, queries can't be
+    /// active across command buffers.
+    void SetQueryCache(VKQueryCache& query_cache_) {
+        query_cache = &query_cache_;
+    }
+
     /// Returns true when viewports have been set in the current command buffer.
     bool TouchViewports() {
         return std::exchange(state.viewports, true);
@@ -112,6 +131,11 @@ public:
         return current_fence;
     }
 
+    /// Returns the number of command buffers allocated so far. It changes on each submission.
+    u64 GetTicks() const {
+        return ticks;
+    }
+
 private:
     class Command {
     public:
@@ -205,13 +229,18 @@ private:
 
     const VKDevice& device;
     VKResourceManager& resource_manager;
+    VKQueryCache* query_cache = nullptr;
     vk::CommandBuffer current_cmdbuf;
     VKFence* current_fence = nullptr;
     VKFence* next_fence = nullptr;
+    u64 ticks = 0;
 
     struct State {
         std::optional<vk::RenderPassBeginInfo> renderpass;
         vk::Pipeline graphics_pipeline;
+        vk::Pipeline compute_pipeline;
+        vk::PipelineLayout compute_layout;
+        vk::DescriptorSet compute_descriptor_set;
         bool viewports = false;
         bool scissors = false;
         bool depth_bias = false;
@@ -2,10 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <limits>
 #include <map>
+#include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 #include <fmt/format.h>
@@ -261,6 +265,13 @@ bool IsPrecise(Operation operand) {
     return false;
 }
 
+/// Output variable holding some of the elements of a generic attribute
+struct GenericVaryingDescription {
+    Id id{};
+    u32 first_element{};
+    bool is_scalar{};
+};
+
 class SPIRVDecompiler final : public Sirit::Module {
 public:
     explicit SPIRVDecompiler(const VKDevice& device, const ShaderIR& ir, ShaderType stage,
@@ -296,6 +307,14 @@ public:
         t_scalar_half = Name(TypeFloat(device.IsFloat16Supported() ? 16 : 32), "scalar_half");
         t_half = Name(TypeVector(t_scalar_half, 2), "half");
 
+        if (stage == ShaderType::Vertex || stage == ShaderType::TesselationEval ||
+            stage == ShaderType::Geometry) {
+            transform_feedback = BuildTransformFeedback(specialization.transform_feedback);
+        }
+        if (!transform_feedback.empty()) {
+            AddCapability(spv::Capability::TransformFeedback);
+        }
+
         const Id main = Decompile();
 
         switch (stage) {
@@ -335,12 +354,14 @@ public:
             }
             break;
         case ShaderType::Compute:
-            const auto workgroup_size = specialization.workgroup_size;
-            AddExecutionMode(main, spv::ExecutionMode::LocalSize, workgroup_size[0],
-                             workgroup_size[1], workgroup_size[2]);
+            // The WorkgroupSize built-in declared with specialization constants overrides this
+            AddExecutionMode(main, spv::ExecutionMode::LocalSize, 1U, 1U, 1U);
             AddEntryPoint(spv::ExecutionModel::GLCompute, main, "main", interfaces);
             break;
         }
+        if (!transform_feedback.empty()) {
+            AddExecutionMode(main, spv::ExecutionMode::Xfb);
+        }
     }
 
 private:
@@ -392,11 +413,10 @@ private:
             const Id position = AccessElement(t_out_float4, out_vertex, position_index);
             OpStore(position, v_varying_default);
 
-            if (specialization.point_size) {
-                const u32 point_size_index = out_indices.point_size.value();
-                const Id out_point_size = AccessElement(t_out_float, out_vertex, point_size_index);
-                OpStore(out_point_size, Constant(t_float, *specialization.point_size));
-            }
+            // Drivers ignore the point size when the pipeline doesn't draw points
+            const u32 point_size_index = out_indices.point_size.value();
+            const Id out_point_size = AccessElement(t_out_float, out_vertex, point_size_index);
+            OpStore(out_point_size, point_size);
         }
     }
 
@@ -490,6 +510,13 @@ private:
         const Id vertex_ptr = TypePointer(spv::StorageClass::Output, out_vertex_struct);
         out_vertex = OpVariable(vertex_ptr, spv::StorageClass::Output);
         interfaces.push_back(AddGlobalVariable(Name(out_vertex, "out_vertex")));
+        DecorateOutputVertexTransformFeedback();
+
+        ndc_minus_one_to_one = DeclareSpecConstant(SpecConstantFalse(t_bool),
+                                                   SpecializationConstant::NdcMinusOneToOne,
+                                                   "ndc_minus_one_to_one");
+        point_size = DeclareSpecConstant(SpecConstant(t_float, 1.0f),
+                                         SpecializationConstant::PointSize, "point_size");
 
         // Declare input attributes
         vertex_index = DeclareInputBuiltIn(spv::BuiltIn::VertexIndex, t_in_uint, "vertex_index");
@@ -574,6 +601,16 @@ private:
             return;
         }
 
+        const Id size_x = DeclareSpecConstant(SpecConstant(t_uint, 1U),
+                                              SpecializationConstant::WorkgroupSizeX, "size_x");
+        const Id size_y = DeclareSpecConstant(SpecConstant(t_uint, 1U),
+                                              SpecializationConstant::WorkgroupSizeY, "size_y");
+        const Id size_z = DeclareSpecConstant(SpecConstant(t_uint, 1U),
+                                              SpecializationConstant::WorkgroupSizeZ, "size_z");
+        const Id workgroup_size = SpecConstantComposite(t_uint3, size_x, size_y, size_z);
+        Decorate(Name(workgroup_size, "workgroup_size"), spv::Decoration::BuiltIn,
+                 static_cast<u32>(spv::BuiltIn::WorkgroupSize));
+
         workgroup_id = DeclareInputBuiltIn(spv::BuiltIn::WorkgroupId, t_in_uint3, "workgroup_id");
         local_invocation_id =
             DeclareInputBuiltIn(spv::BuiltIn::LocalInvocationId, t_in_uint3, "local_invocation_id");
@@ -685,6 +722,15 @@ private:
         const Id out_vertex_ptr = TypePointer(spv::StorageClass::Output, out_vertex_struct);
         out_vertex = OpVariable(out_vertex_ptr, spv::StorageClass::Output);
         interfaces.push_back(AddGlobalVariable(Name(out_vertex, "out_vertex")));
+        DecorateOutputVertexTransformFeedback();
+    }
+
+    /// Captured members of the output vertex block require the block to be decorated too
+    void DecorateOutputVertexTransformFeedback() {
+        if (const VaryingTFB* varying = GetTransformFeedback(Attribute::Index::Position, 0)) {
+            Decorate(out_vertex, spv::Decoration::XfbBuffer, static_cast<u32>(varying->buffer));
+            Decorate(out_vertex, spv::Decoration::XfbStride, static_cast<u32>(varying->stride));
+        }
     }
 
     void DeclareInputAttributes() {
@@ -734,6 +780,10 @@ private:
             if (!IsGenericAttribute(index)) {
                 continue;
             }
+            if (HasTransformFeedback(index)) {
+                DeclareCapturedOutputAttribute(index);
+                continue;
+            }
             const u32 location = GetGenericAttributeLocation(index);
             Id type = t_float4;
             Id varying_default = v_varying_default;
@@ -750,13 +800,97 @@ private:
 
             const Id id = OpVariable(type, spv::StorageClass::Output, varying_default);
             Name(AddGlobalVariable(id), fmt::format("out_attr{}", location));
-            output_attributes.emplace(index, id);
+            auto& varyings = output_attributes[index];
+            varyings.fill(GenericVaryingDescription{id, 0, false});
             interfaces.push_back(id);
 
             Decorate(id, spv::Decoration::Location, location);
         }
     }
 
+    /// Declares an output attribute with captured components, each captured varying is declared
+    /// in its own variable so it gets its own offset.
+    void DeclareCapturedOutputAttribute(Attribute::Index index) {
+        ASSERT(!IsOutputAttributeArray());
+        const u32 location = GetGenericAttributeLocation(index);
+        auto& varyings = output_attributes[index];
+        for (u32 element = 0; element < 4;) {
+            const u32 num_components = GetOutputPieceSize(index, element);
+            const Id type = GetFloatVectorType(num_components);
+
+            std::vector<Id> defaults;
+            for (u32 i = element; i < element + num_components; ++i) {
+                defaults.push_back(i == 3 ? v_float_one : v_float_zero);
+            }
+            const Id varying_default =
+                num_components == 1 ? defaults[0] : ConstantComposite(type, defaults);
+
+            const Id id = OpVariable(TypePointer(spv::StorageClass::Output, type),
+                                     spv::StorageClass::Output, varying_default);
+            Name(AddGlobalVariable(id),
+                 fmt::format("out_attr{}_{}", location,
+                             std::string_view("xyzw").substr(element, num_components)));
+            interfaces.push_back(id);
+
+            Decorate(id, spv::Decoration::Location, location);
+            Decorate(id, spv::Decoration::Component, element);
+            if (const VaryingTFB* varying = GetTransformFeedback(index, element)) {
+                Decorate(id, spv::Decoration::XfbBuffer, static_cast<u32>(varying->buffer));
+                Decorate(id, spv::Decoration::XfbStride, static_cast<u32>(varying->stride));
+                Decorate(id, spv::Decoration::Offset, static_cast<u32>(varying->offset));
+            }
+
+            for (u32 i = element; i < element + num_components; ++i) {
+                varyings[i] = GenericVaryingDescription{id, element, num_components == 1};
+            }
+            element += num_components;
+        }
+    }
+
+    /// Returns the captured varying starting at the element of an output, null when it's not
+    /// captured
+    const VaryingTFB* GetTransformFeedback(Attribute::Index index, u32 element) const {
+        const auto location = static_cast<u8>(static_cast<u32>(index) * 4 + element);
+        const auto it = transform_feedback.find(location);
+        return it != transform_feedback.end() ? &it->second : nullptr;
+    }
+
+    bool HasTransformFeedback(Attribute::Index index) const {
+        for (u32 element = 0; element < 4; ++element) {
+            if (GetTransformFeedback(index, element)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Returns the number of components of the output variable starting at the element
+    u32 GetOutputPieceSize(Attribute::Index index, u32 element) const {
+        if (const VaryingTFB* varying = GetTransformFeedback(index, element)) {
+            return std::min(static_cast<u32>(varying->components), 4 - element);
+        }
+        // Uncaptured components are joined until the next captured one
+        u32 num_components = 1;
+        while (element + num_components < 4 &&
+               !GetTransformFeedback(index, element + num_components)) {
+            ++num_components;
+        }
+        return num_components;
+    }
+
+    Id GetFloatVectorType(u32 num_components) const {
+        switch (num_components) {
+        case 1:
+            return t_float;
+        case 2:
+            return t_float2;
+        case 3:
+            return t_float3;
+        default:
+            return t_float4;
+        }
+    }
+
     u32 DeclareConstantBuffers(u32 binding) {
         for (const auto& [index, size] : ir.GetConstantBuffers()) {
             const Id type = device.IsKhrUniformBufferStandardLayoutSupported() ? t_cbuf_scalar_ubo
@@ -930,7 +1064,7 @@ private:
             }
         }
 
-        if (ir.UsesPointSize() || specialization.point_size) {
+        if (ir.UsesPointSize() || stage == ShaderType::Vertex) {
             indices.point_size = AddBuiltIn(t_float, spv::BuiltIn::PointSize, "point_size");
         }
 
@@ -960,6 +1094,14 @@ private:
                            static_cast<u32>(member.builtin));
         }
 
+        if (const VaryingTFB* varying = GetTransformFeedback(Attribute::Index::Position, 0)) {
+            UNIMPLEMENTED_IF_MSG(varying->components != 4,
+                                 "Unimplemented capture of {} position components",
+                                 varying->components);
+            MemberDecorate(per_vertex_struct, indices.position.value(), spv::Decoration::Offset,
+                           static_cast<u32>(varying->offset));
+        }
+
         return {per_vertex_struct, indices};
     }
 
@@ -1311,8 +1453,13 @@ private:
                 }
                 default:
                     if (IsGenericAttribute(attribute)) {
-                        const Id composite = output_attributes.at(attribute);
-                        return {ArrayPass(t_out_float, composite, {element}), Type::Float};
+                        const auto& varying = output_attributes.at(attribute).at(element);
+                        if (varying.is_scalar) {
+                            return {varying.id, Type::Float};
+                        }
+                        return {ArrayPass(t_out_float, varying.id,
+                                          {element - varying.first_element}),
+                                Type::Float};
                     }
                     UNIMPLEMENTED_MSG("Unhandled output attribute: {}",
                                       static_cast<u32>(attribute));
@@ -1872,14 +2019,14 @@ private:
     }
 
     void PreExit() {
-        if (stage == ShaderType::Vertex && specialization.ndc_minus_one_to_one) {
+        if (stage == ShaderType::Vertex) {
             const u32 position_index = out_indices.position.value();
             const Id z_pointer = AccessElement(t_out_float, out_vertex, position_index, 2U);
             const Id w_pointer = AccessElement(t_out_float, out_vertex, position_index, 3U);
-            Id depth = OpLoad(t_float, z_pointer);
-            depth = OpFAdd(t_float, depth, OpLoad(t_float, w_pointer));
+            const Id z = OpLoad(t_float, z_pointer);
+            Id depth = OpFAdd(t_float, z, OpLoad(t_float, w_pointer));
             depth = OpFMul(t_float, depth, Constant(t_float, 0.5f));
-            OpStore(z_pointer, depth);
+            OpStore(z_pointer, OpSelect(t_float, ndc_minus_one_to_one, depth, z));
         }
         if (stage == ShaderType::Fragment) {
             const auto SafeGetRegister = [&](u32 reg) {
@@ -2023,6 +2170,11 @@ private:
         return {};
     }
 
+    Id DeclareSpecConstant(Id constant, SpecializationConstant spec_id, std::string name) {
+        Decorate(constant, spv::Decoration::SpecId, static_cast<u32>(spec_id));
+        return Name(constant, std::move(name));
+    }
+
     Id DeclareBuiltIn(spv::BuiltIn builtin, spv::StorageClass storage, Id type, std::string name) {
         const Id id = OpVariable(type, storage);
         Decorate(id, spv::Decoration::BuiltIn, static_cast<u32>(builtin));
@@ -2525,6 +2677,8 @@ private:
 
     Id out_vertex{};
     Id in_vertex{};
+    Id ndc_minus_one_to_one{};
+    Id point_size{};
     std::map<u32, Id> registers;
     std::map<u32, Id> custom_variables;
     std::map<Tegra::Shader::Pred, Id> predicates;
@@ -2533,7 +2687,8 @@ private:
     Id shared_memory{};
     std::array<Id, INTERNAL_FLAGS_COUNT> internal_flags{};
     std::map<Attribute::Index, Id> input_attributes;
-    std::map<Attribute::Index, Id> output_attributes;
+    std::map<Attribute::Index, std::array<GenericVaryingDescription, 4>> output_attributes;
+    std::unordered_map<u8, VaryingTFB> transform_feedback;
     std::map<u32, Id> constant_buffers;
     std::map<GlobalMemoryBase, Id> global_buffers;
     std::map<u32, TexelBuffer> texel_buffers;
@@ -2793,7 +2948,8 @@ ShaderEntries GenerateShaderEntries(const VideoCommon::Shader::ShaderIR& ir) {
         entries.const_buffers.emplace_back(cbuf.second, cbuf.first);
     }
     for (const auto& [base, usage] : ir.GetGlobalMemory()) {
-        entries.global_buffers.emplace_back(base.cbuf_index, base.cbuf_offset, usage.is_written);
+        entries.global_buffers.emplace_back(base.cbuf_index, base.cbuf_offset, usage.is_written,
+                                            usage.is_bounded ? usage.bound_size : 0);
     }
     for (const auto& sampler : ir.GetSamplers()) {
         if (sampler.IsBuffer()) {
@@ -8,6 +8,7 @@
 #include <bitset>
 #include <memory>
 #include <set>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
 #include "video_core/shader/shader_ir.h"
+#include "video_core/shader/transform_feedback.h"
 
 namespace Vulkan {
 class VKDevice;
@@ -45,8 +47,10 @@ private:
 
 class GlobalBufferEntry {
 public:
-    constexpr explicit GlobalBufferEntry(u32 cbuf_index, u32 cbuf_offset, bool is_written)
-        : cbuf_index{cbuf_index}, cbuf_offset{cbuf_offset}, is_written{is_written} {}
+    constexpr explicit GlobalBufferEntry(u32 cbuf_index, u32 cbuf_offset, bool is_written,
+                                         u32 size_bound)
+        : cbuf_index{cbuf_index}, cbuf_offset{cbuf_offset}, is_written{is_written},
+          size_bound{size_bound} {}
 
     constexpr u32 GetCbufIndex() const {
         return cbuf_index;
@@ -60,10 +64,17 @@ public:
         return is_written;
     }
 
+    /// Returns the number of bytes from the base address the shader may access, zero when it's
+    /// unknown.
+    constexpr u32 GetSizeBound() const {
+        return size_bound;
+    }
+
 private:
     u32 cbuf_index{};
     u32 cbuf_offset{};
     bool is_written{};
+    u32 size_bound{};
 };
 
 struct ShaderEntries {
@@ -83,18 +94,34 @@ struct ShaderEntries {
     bool uses_warps{};
 };
 
+/// Ids of the specialization constants the decompiled modules read. Their values change between
+/// pipelines using the same module, so they are passed at pipeline creation instead.
+enum class SpecializationConstant : u32 {
+    NdcMinusOneToOne = 0, ///< Vertex, bool: depth is converted from [-1, 1] to [0, 1]
+    PointSize = 1,        ///< Vertex, float: point size written before the shader runs
+    WorkgroupSizeX = 2,   ///< Compute, uint
+    WorkgroupSizeY = 3,   ///< Compute, uint
+    WorkgroupSizeZ = 4,   ///< Compute, uint
+};
+
+/// Values of the specialization constants, in the layout GetSpecializationInfo describes.
+struct SpecializationConstants final {
+    u32 ndc_minus_one_to_one{};
+    float point_size{1.0f};
+    std::array<u32, 3> workgroup_size{1, 1, 1};
+};
+
+/// State that has to be known when a module is decompiled. Modules are cached by it, so anything
+/// that can be a specialization constant belongs to SpecializationConstants instead.
 struct Specialization final {
     u32 base_binding{};
 
     // Compute specific
-    std::array<u32, 3> workgroup_size{};
     u32 shared_memory_size{};
 
     // Graphics specific
     Maxwell::PrimitiveTopology primitive_topology{};
-    std::optional<float> point_size{};
     std::array<Maxwell::VertexAttribute::Type, Maxwell::NumVertexAttributes> attribute_types{};
-    bool ndc_minus_one_to_one{};
 
     // Tessellation specific
     struct {
@@ -102,12 +129,24 @@ struct Specialization final {
         Maxwell::TessellationSpacing spacing{};
         bool clockwise{};
     } tessellation;
+
+    // Varyings captured by the last vertex processing stage
+    VideoCommon::Shader::TransformFeedbackState transform_feedback{};
+
+    bool operator==(const Specialization& rhs) const noexcept {
+        return std::tie(base_binding, shared_memory_size, primitive_topology, attribute_types,
+                        tessellation.primitive, tessellation.spacing, tessellation.clockwise,
+                        transform_feedback) ==
+               std::tie(rhs.base_binding, rhs.shared_memory_size, rhs.primitive_topology,
+                        rhs.attribute_types, rhs.tessellation.primitive, rhs.tessellation.spacing,
+                        rhs.tessellation.clockwise, rhs.transform_feedback);
+    }
 };
 // Old gcc versions don't consider this trivially copyable.
 // static_assert(std::is_trivially_copyable_v<Specialization>);
 
 struct SPIRVShader {
-    std::vector<u32> code;
+    std::shared_ptr<const std::vector<u32>> code;
     ShaderEntries entries;
 };
 
@@ -0,0 +1,561 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "common/assert.h"
+#include "common/common_paths.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/settings.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/gpu.h"
+#include "video_core/guest_driver.h"
+#include "video_core/renderer_vulkan/vk_device.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
+
+namespace Vulkan {
+
+using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::ConstBufferLocker;
+
+namespace {
+
+using ShaderCacheVersionHash = std::array<u8, 64>;
+
+enum class TransferableEntryKind : u32 {
+    Shader,
+    GraphicsPipeline,
+    ComputePipeline,
+    DriverProfile,
+};
+
+struct ConstBufferKey {
+    u32 cbuf{};
+    u32 offset{};
+    u32 value{};
+};
+
+struct BoundSamplerKey {
+    u32 offset{};
+    Tegra::Engines::SamplerDescriptor sampler{};
+};
+
+struct BindlessSamplerKey {
+    u32 cbuf{};
+    u32 offset{};
+    Tegra::Engines::SamplerDescriptor sampler{};
+};
+
+/// Identifies the build and the driver that produced a pipeline cache blob.
+struct PipelineCacheHeader {
+    ShaderCacheVersionHash version_hash{};
+    u32 vendor_id{};
+    u32 device_id{};
+    u32 driver_version{};
+    std::array<u8, VK_UUID_SIZE> uuid{};
+    u64 data_size{};
+
+    bool operator==(const PipelineCacheHeader& rhs) const {
+        return std::tie(version_hash, vendor_id, device_id, driver_version, uuid) ==
+               std::tie(rhs.version_hash, rhs.vendor_id, rhs.device_id, rhs.driver_version,
+                        rhs.uuid);
+    }
+
+    bool operator!=(const PipelineCacheHeader& rhs) const {
+        return !operator==(rhs);
+    }
+};
+static_assert(std::is_trivially_copyable_v<PipelineCacheHeader>);
+
+constexpr u32 NativeVersion = 3;
+
+// Making sure sizes doesn't change by accident
+static_assert(sizeof(RenderPassParams::ColorAttachment) == 12);
+
+ShaderCacheVersionHash GetShaderCacheVersionHash() {
+    ShaderCacheVersionHash hash{};
+    const std::size_t length = std::min(std::strlen(Common::g_shader_cache_version), hash.size());
+    std::memcpy(hash.data(), Common::g_shader_cache_version, length);
+    return hash;
+}
+
+PipelineCacheHeader MakePipelineCacheHeader(const VKDevice& device, std::size_t data_size) {
+    PipelineCacheHeader header;
+    header.version_hash = GetShaderCacheVersionHash();
+    header.vendor_id = device.GetVendorID();
+    header.device_id = device.GetDeviceID();
+    header.driver_version = device.GetDriverVersion();
+    header.uuid = device.GetPipelineCacheUUID();
+    header.data_size = static_cast<u64>(data_size);
+    return header;
+}
+
+bool LoadRenderPassParams(FileUtil::IOFile& file, RenderPassParams& params) {
+    u32 num_color_attachments{};
+    if (file.ReadArray(&num_color_attachments, 1) != 1 ||
+        num_color_attachments > params.color_attachments.capacity()) {
+        return false;
+    }
+    params.color_attachments.resize(num_color_attachments);
+    return file.ReadArray(params.color_attachments.data(), num_color_attachments) ==
+               num_color_attachments &&
+           file.ReadArray(&params.zeta_pixel_format, 1) == 1 &&
+           file.ReadArray(&params.has_zeta, 1) == 1 &&
+           file.ReadArray(&params.zeta_texception, 1) == 1;
+}
+
+bool SaveRenderPassParams(FileUtil::IOFile& file, const RenderPassParams& params) {
+    const auto num_color_attachments = static_cast<u32>(params.color_attachments.size());
+    return file.WriteObject(num_color_attachments) == 1 &&
+           file.WriteArray(params.color_attachments.data(), num_color_attachments) ==
+               num_color_attachments &&
+           file.WriteObject(params.zeta_pixel_format) == 1 &&
+           file.WriteObject(params.has_zeta) == 1 && file.WriteObject(params.zeta_texception) == 1;
+}
+
+} // Anonymous namespace
+
+ShaderDiskCacheEntry::ShaderDiskCacheEntry() = default;
+
+ShaderDiskCacheEntry::~ShaderDiskCacheEntry() = default;
+
+bool ShaderDiskCacheEntry::Load(FileUtil::IOFile& file) {
+    u32 code_size{};
+    u32 num_keys{};
+    u32 num_bound_samplers{};
+    u32 num_bindless_samplers{};
+    if (file.ReadArray(&unique_identifier, 1) != 1 || file.ReadArray(&type, 1) != 1 ||
+        file.ReadArray(&main_offset, 1) != 1 || file.ReadArray(&code_size, 1) != 1 ||
+        file.ReadArray(&bound_buffer, 1) != 1 || file.ReadArray(&num_keys, 1) != 1 ||
+        file.ReadArray(&num_bound_samplers, 1) != 1 ||
+        file.ReadArray(&num_bindless_samplers, 1) != 1) {
+        return false;
+    }
+
+    code.resize(code_size);
+    std::vector<ConstBufferKey> flat_keys(num_keys);
+    std::vector<BoundSamplerKey> flat_bound_samplers(num_bound_samplers);
+    std::vector<BindlessSamplerKey> flat_bindless_samplers(num_bindless_samplers);
+    if (file.ReadArray(code.data(), code.size()) != code.size() ||
+        file.ReadArray(flat_keys.data(), flat_keys.size()) != flat_keys.size() ||
+        file.ReadArray(flat_bound_samplers.data(), flat_bound_samplers.size()) !=
+            flat_bound_samplers.size() ||
+        file.ReadArray(flat_bindless_samplers.data(), flat_bindless_samplers.size()) !=
+            flat_bindless_samplers.size()) {
+        return false;
+    }
+    for (const auto& key : flat_keys) {
+        keys.insert({{key.cbuf, key.offset}, key.value});
+    }
+    for (const auto& key : flat_bound_samplers) {
+        bound_samplers.emplace(key.offset, key.sampler);
+    }
+    for (const auto& key : flat_bindless_samplers) {
+        bindless_samplers.insert({{key.cbuf, key.offset}, key.sampler});
+    }
+    return true;
+}
+
+bool ShaderDiskCacheEntry::Save(FileUtil::IOFile& file) const {
+    if (file.WriteObject(unique_identifier) != 1 || file.WriteObject(static_cast<u32>(type)) != 1 ||
+        file.WriteObject(main_offset) != 1 ||
+        file.WriteObject(static_cast<u32>(code.size())) != 1 ||
+        file.WriteObject(bound_buffer) != 1 ||
+        file.WriteObject(static_cast<u32>(keys.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(bound_samplers.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(bindless_samplers.size())) != 1) {
+        return false;
+    }
+    if (file.WriteArray(code.data(), code.size()) != code.size()) {
+        return false;
+    }
+    for (const auto& [pair, value] : keys) {
+        const auto [cbuf, offset] = pair;
+        if (file.WriteObject(ConstBufferKey{cbuf, offset, value}) != 1) {
+            return false;
+        }
+    }
+    for (const auto& [offset, sampler] : bound_samplers) {
+        if (file.WriteObject(BoundSamplerKey{offset, sampler}) != 1) {
+            return false;
+        }
+    }
+    for (const auto& [pair, sampler] : bindless_samplers) {
+        const auto [cbuf, offset] = pair;
+        if (file.WriteObject(BindlessSamplerKey{cbuf, offset, sampler}) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShaderDiskCacheEntry::FillLocker(ConstBufferLocker& locker) const {
+    locker.SetBoundBuffer(bound_buffer);
+    for (const auto& [key, value] : keys) {
+        const auto [buffer, offset] = key;
+        locker.InsertKey(buffer, offset, value);
+    }
+    for (const auto& [offset, sampler] : bound_samplers) {
+        locker.InsertBoundSampler(offset, sampler);
+    }
+    for (const auto& [key, sampler] : bindless_samplers) {
+        const auto [buffer, offset] = key;
+        locker.InsertBindlessSampler(buffer, offset, sampler);
+    }
+}
+
+VKShaderDiskCache::VKShaderDiskCache(Core::System& system, const VKDevice& device)
+    : system{system}, device{device} {}
+
+VKShaderDiskCache::~VKShaderDiskCache() = default;
+
+std::optional<ShaderDiskCacheTransferable> VKShaderDiskCache::LoadTransferable() {
+    // Skip games without title id
+    const bool has_title_id = system.CurrentProcess()->GetTitleID() != 0;
+    if (!Settings::values.use_disk_shader_cache || !has_title_id) {
+        return {};
+    }
+
+    FileUtil::IOFile file(GetTransferablePath(), "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No transferable shader cache found for game with title id={}",
+                 GetTitleID());
+        is_usable = true;
+        return {};
+    }
+
+    u32 version{};
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version)) {
+        LOG_ERROR(Render_Vulkan,
+                  "Failed to get transferable cache version for title id={}, skipping",
+                  GetTitleID());
+        return {};
+    }
+
+    if (version < NativeVersion) {
+        LOG_INFO(Render_Vulkan, "Transferable shader cache is old, removing");
+        file.Close();
+        InvalidateTransferable();
+        is_usable = true;
+        return {};
+    }
+    if (version > NativeVersion) {
+        LOG_WARNING(Render_Vulkan, "Transferable shader cache was generated with a newer version "
+                                   "of the emulator, skipping");
+        return {};
+    }
+
+    // Version is valid, load the entries
+    constexpr const char error_loading[] = "Failed to load transferable entry, skipping";
+    ShaderDiskCacheTransferable transferable;
+    while (file.Tell() < file.GetSize()) {
+        TransferableEntryKind kind{};
+        if (file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
+            LOG_ERROR(Render_Vulkan, "Failed to read transferable file, skipping");
+            return {};
+        }
+
+        switch (kind) {
+        case TransferableEntryKind::Shader: {
+            ShaderDiskCacheEntry entry;
+            if (!entry.Load(file)) {
+                LOG_ERROR(Render_Vulkan, error_loading);
+                return {};
+            }
+            stored_shaders.insert(entry.unique_identifier);
+            transferable.shaders.push_back(std::move(entry));
+            break;
+        }
+        case TransferableEntryKind::GraphicsPipeline: {
+            GraphicsPipelineCacheKey key;
+            if (file.ReadArray(&key.fixed_state, 1) != 1 ||
+                file.ReadArray(key.shaders.data(), key.shaders.size()) != key.shaders.size() ||
+                !LoadRenderPassParams(file, key.renderpass_params)) {
+                LOG_ERROR(Render_Vulkan, error_loading);
+                return {};
+            }
+            stored_graphics_pipelines.insert(key);
+            transferable.graphics_pipelines.push_back(key);
+            break;
+        }
+        case TransferableEntryKind::ComputePipeline: {
+            ComputePipelineCacheKey key;
+            if (file.ReadArray(&key, 1) != 1) {
+                LOG_ERROR(Render_Vulkan, error_loading);
+                return {};
+            }
+            stored_compute_pipelines.insert(key);
+            transferable.compute_pipelines.push_back(key);
+            break;
+        }
+        case TransferableEntryKind::DriverProfile: {
+            if (!LoadDriverProfile(file)) {
+                LOG_ERROR(Render_Vulkan, error_loading);
+                return {};
+            }
+            break;
+        }
+        default:
+            LOG_ERROR(Render_Vulkan, "Unknown transferable shader cache entry kind={}, skipping",
+                      static_cast<u32>(kind));
+            return {};
+        }
+    }
+
+    is_usable = true;
+    return transferable;
+}
+
+std::vector<u8> VKShaderDiskCache::LoadPipelineCache() {
+    if (!is_usable) {
+        return {};
+    }
+
+    FileUtil::IOFile file(GetPipelineCachePath(), "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No pipeline cache found for game with title id={}", GetTitleID());
+        return {};
+    }
+
+    PipelineCacheHeader header;
+    if (file.ReadArray(&header, 1) != 1 || header.data_size != file.GetSize() - file.Tell()) {
+        LOG_INFO(Render_Vulkan, "Failed to load pipeline cache for game with title id={}, removing",
+                 GetTitleID());
+        file.Close();
+        InvalidatePipelineCache();
+        return {};
+    }
+    if (header != MakePipelineCacheHeader(device, header.data_size)) {
+        LOG_INFO(Render_Vulkan, "Pipeline cache was built by a different driver, removing");
+        file.Close();
+        InvalidatePipelineCache();
+        return {};
+    }
+
+    std::vector<u8> data(header.data_size);
+    if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+        LOG_ERROR(Render_Vulkan, "Failed to read pipeline cache data, removing");
+        file.Close();
+        InvalidatePipelineCache();
+        return {};
+    }
+    return data;
+}
+
+void VKShaderDiskCache::InvalidateTransferable() {
+    if (!FileUtil::Delete(GetTransferablePath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate transferable file={}",
+                  GetTransferablePath());
+    }
+    stored_shaders.clear();
+    stored_graphics_pipelines.clear();
+    stored_compute_pipelines.clear();
+    saved_texture_handler_size = false;
+    num_saved_bindless_samplers = 0;
+    InvalidatePipelineCache();
+}
+
+void VKShaderDiskCache::InvalidatePipelineCache() {
+    if (!FileUtil::Delete(GetPipelineCachePath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate pipeline cache file={}",
+                  GetPipelineCachePath());
+    }
+}
+
+void VKShaderDiskCache::SaveShader(const ShaderDiskCacheEntry& entry) {
+    if (!is_usable || stored_shaders.count(entry.unique_identifier) != 0) {
+        return;
+    }
+
+    FileUtil::IOFile file = AppendTransferableFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (file.WriteObject(TransferableEntryKind::Shader) != 1 || !entry.Save(file)) {
+        LOG_ERROR(Render_Vulkan, "Failed to save shader transferable cache entry, removing");
+        file.Close();
+        InvalidateTransferable();
+        return;
+    }
+    stored_shaders.insert(entry.unique_identifier);
+}
+
+void VKShaderDiskCache::SaveGraphicsPipeline(const GraphicsPipelineCacheKey& key) {
+    if (!is_usable || !stored_graphics_pipelines.insert(key).second) {
+        return;
+    }
+
+    FileUtil::IOFile file = AppendTransferableFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (file.WriteObject(TransferableEntryKind::GraphicsPipeline) != 1 ||
+        file.WriteObject(key.fixed_state) != 1 ||
+        file.WriteArray(key.shaders.data(), key.shaders.size()) != key.shaders.size() ||
+        !SaveRenderPassParams(file, key.renderpass_params) || !SaveDriverProfile(file)) {
+        LOG_ERROR(Render_Vulkan, "Failed to save graphics pipeline transferable entry, removing");
+        file.Close();
+        InvalidateTransferable();
+    }
+}
+
+void VKShaderDiskCache::SaveComputePipeline(const ComputePipelineCacheKey& key) {
+    if (!is_usable || !stored_compute_pipelines.insert(key).second) {
+        return;
+    }
+
+    FileUtil::IOFile file = AppendTransferableFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (file.WriteObject(TransferableEntryKind::ComputePipeline) != 1 ||
+        file.WriteObject(key) != 1 || !SaveDriverProfile(file)) {
+        LOG_ERROR(Render_Vulkan, "Failed to save compute pipeline transferable entry, removing");
+        file.Close();
+        InvalidateTransferable();
+    }
+}
+
+void VKShaderDiskCache::SavePipelineCache(const std::vector<u8>& data) {
+    if (!is_usable || !EnsureDirectories()) {
+        return;
+    }
+
+    const auto path{GetPipelineCachePath()};
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open pipeline cache in path={}", path);
+        return;
+    }
+    const PipelineCacheHeader header = MakePipelineCacheHeader(device, data.size());
+    if (file.WriteObject(header) != 1 ||
+        file.WriteBytes(data.data(), data.size()) != data.size()) {
+        LOG_ERROR(Render_Vulkan, "Failed to write pipeline cache in path={}", path);
+        file.Close();
+        InvalidatePipelineCache();
+    }
+}
+
+bool VKShaderDiskCache::LoadDriverProfile(FileUtil::IOFile& file) {
+    u32 texture_handler_size{};
+    u32 num_bindless_samplers{};
+    if (file.ReadArray(&texture_handler_size, 1) != 1 ||
+        file.ReadArray(&num_bindless_samplers, 1) != 1) {
+        return false;
+    }
+    std::vector<VideoCore::BindlessSamplerKey> bindless_samplers(num_bindless_samplers);
+    if (file.ReadArray(bindless_samplers.data(), bindless_samplers.size()) !=
+        bindless_samplers.size()) {
+        return false;
+    }
+
+    auto& profile = system.GPU().Maxwell3D().AccessGuestDriverProfile();
+    if (texture_handler_size != 0 && !profile.TextureHandlerSizeKnown()) {
+        profile.SetTextureHandlerSize(texture_handler_size);
+    }
+    for (const auto& key : bindless_samplers) {
+        profile.RegisterBindlessSampler(key);
+    }
+    saved_texture_handler_size = profile.TextureHandlerSizeKnown();
+    num_saved_bindless_samplers = profile.GetBindlessSamplers().size();
+    return true;
+}
+
+bool VKShaderDiskCache::SaveDriverProfile(FileUtil::IOFile& file) {
+    const auto& profile = system.GPU().Maxwell3D().AccessGuestDriverProfile();
+    const auto& bindless_samplers = profile.GetBindlessSamplers();
+    const bool save_handler_size = profile.TextureHandlerSizeKnown() && !saved_texture_handler_size;
+    if (!save_handler_size && bindless_samplers.size() == num_saved_bindless_samplers) {
+        return true;
+    }
+
+    // Only the locations learned since the last save are stored, loading appends them in order
+    const u32 texture_handler_size = save_handler_size ? profile.GetTextureHandlerSize() : 0;
+    const std::size_t num_new = bindless_samplers.size() - num_saved_bindless_samplers;
+    if (file.WriteObject(TransferableEntryKind::DriverProfile) != 1 ||
+        file.WriteObject(texture_handler_size) != 1 ||
+        file.WriteObject(static_cast<u32>(num_new)) != 1 ||
+        file.WriteArray(bindless_samplers.data() + num_saved_bindless_samplers, num_new) !=
+            num_new) {
+        return false;
+    }
+    saved_texture_handler_size = profile.TextureHandlerSizeKnown();
+    num_saved_bindless_samplers = bindless_samplers.size();
+    return true;
+}
+
+FileUtil::IOFile VKShaderDiskCache::AppendTransferableFile() const {
+    if (!EnsureDirectories()) {
+        return {};
+    }
+
+    const auto transferable_path{GetTransferablePath()};
+    const bool existed = FileUtil::Exists(transferable_path);
+
+    FileUtil::IOFile file(transferable_path, "ab");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open transferable cache in path={}", transferable_path);
+        return {};
+    }
+    if (!existed || file.GetSize() == 0) {
+        // If the file didn't exist, write its version
+        if (file.WriteObject(NativeVersion) != 1) {
+            LOG_ERROR(Render_Vulkan, "Failed to write transferable cache version in path={}",
+                      transferable_path);
+            return {};
+        }
+    }
+    return file;
+}
+
+bool VKShaderDiskCache::EnsureDirectories() const {
+    const auto CreateDir = [](const std::string& dir) {
+        if (!FileUtil::CreateDir(dir)) {
+            LOG_ERROR(Render_Vulkan, "Failed to create directory={}", dir);
+            return false;
+        }
+        return true;
+    };
+
+    return CreateDir(FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir)) &&
+           CreateDir(GetBaseDir()) && CreateDir(GetTransferableDir()) &&
+           CreateDir(GetPipelineCacheDir());
+}
+
+std::string VKShaderDiskCache::GetTransferablePath() const {
+    return FileUtil::SanitizePath(GetTransferableDir() + DIR_SEP_CHR + GetTitleID() + ".bin");
+}
+
+std::string VKShaderDiskCache::GetPipelineCachePath() const {
+    return FileUtil::SanitizePath(GetPipelineCacheDir() + DIR_SEP_CHR + GetTitleID() + ".bin");
+}
+
+std::string VKShaderDiskCache::GetTransferableDir() const {
+    return GetBaseDir() + DIR_SEP "transferable";
+}
+
+std::string VKShaderDiskCache::GetPipelineCacheDir() const {
+    return GetBaseDir() + DIR_SEP "pipeline";
+}
+
+std::string VKShaderDiskCache::GetBaseDir() const {
+    return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + DIR_SEP "vulkan";
+}
+
+std::string VKShaderDiskCache::GetTitleID() const {
+    return fmt::format("{:016X}", system.CurrentProcess()->GetTitleID());
+}
+
+} // namespace Vulkan
@@ -0,0 +1,141 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/shader/const_buffer_locker.h"
+
+namespace Core {
+class System;
+}
+
+namespace FileUtil {
+class IOFile;
+}
+
+namespace Vulkan {
+
+class VKDevice;
+
+/// Guest shader stored in the transferable cache, along with the keys its IR was decoded with.
+struct ShaderDiskCacheEntry {
+    ShaderDiskCacheEntry();
+    ~ShaderDiskCacheEntry();
+
+    bool Load(FileUtil::IOFile& file);
+
+    bool Save(FileUtil::IOFile& file) const;
+
+    /// Registers the stored keys in the given locker.
+    void FillLocker(VideoCommon::Shader::ConstBufferLocker& locker) const;
+
+    u64 unique_identifier{};
+    Tegra::Engines::ShaderType type{};
+    u32 main_offset{};
+    ProgramCode code;
+    u32 bound_buffer{};
+    VideoCommon::Shader::KeyMap keys;
+    VideoCommon::Shader::BoundSamplerMap bound_samplers;
+    VideoCommon::Shader::BindlessSamplerMap bindless_samplers;
+};
+
+/// Contents of the transferable cache. Pipeline keys reference their shaders by unique identifier
+/// instead of by GPU address, since addresses are not stable across boots.
+struct ShaderDiskCacheTransferable {
+    std::vector<ShaderDiskCacheEntry> shaders;
+    std::vector<GraphicsPipelineCacheKey> graphics_pipelines;
+    std::vector<ComputePipelineCacheKey> compute_pipelines;
+};
+
+class VKShaderDiskCache {
+public:
+    explicit VKShaderDiskCache(Core::System& system, const VKDevice& device);
+    ~VKShaderDiskCache();
+
+    /// Loads the transferable cache. If the file has an old version or on failure, it's deleted.
+    std::optional<ShaderDiskCacheTransferable> LoadTransferable();
+
+    /// Loads the Vulkan pipeline cache blob. Returns empty when it was made by a different driver.
+    std::vector<u8> LoadPipelineCache();
+
+    /// Removes the transferable cache and the pipeline cache blob.
+    void InvalidateTransferable();
+
+    /// Removes the pipeline cache blob.
+    void InvalidatePipelineCache();
+
+    /// Saves a shader to the transferable file. Skips shaders that are already stored.
+    void SaveShader(const ShaderDiskCacheEntry& entry);
+
+    /// Saves a graphics pipeline usage to the transferable file. Skips known usages.
+    void SaveGraphicsPipeline(const GraphicsPipelineCacheKey& key);
+
+    /// Saves a compute pipeline usage to the transferable file. Skips known usages.
+    void SaveComputePipeline(const ComputePipelineCacheKey& key);
+
+    /// Writes the Vulkan pipeline cache blob, tagged with the current driver.
+    void SavePipelineCache(const std::vector<u8>& data);
+
+    /// Returns true when the cache has been loaded and can be written to.
+    bool IsUsable() const {
+        return is_usable;
+    }
+
+private:
+    /// Applies a driver profile entry to the guest driver profile. Returns true on success.
+    bool LoadDriverProfile(FileUtil::IOFile& file);
+
+    /// Writes the guest driver profile learned since the last save, if any. Returns true on
+    /// success.
+    bool SaveDriverProfile(FileUtil::IOFile& file);
+
+    /// Opens current game's transferable file and write it's header if it doesn't exist
+    FileUtil::IOFile AppendTransferableFile() const;
+
+    /// Create shader disk cache directories. Returns true on success.
+    bool EnsureDirectories() const;
+
+    /// Gets current game's transferable file path
+    std::string GetTransferablePath() const;
+
+    /// Gets current game's pipeline cache file path
+    std::string GetPipelineCachePath() const;
+
+    /// Get user's transferable directory path
+    std::string GetTransferableDir() const;
+
+    /// Get user's pipeline cache directory path
+    std::string GetPipelineCacheDir() const;
+
+    /// Get user's shader directory path
+    std::string GetBaseDir() const;
+
+    /// Get current game's title id
+    std::string GetTitleID() const;
+
+    Core::System& system;
+    const VKDevice& device;
+
+    // Stored transferable entries
+    std::unordered_set<u64> stored_shaders;
+    std::unordered_set<GraphicsPipelineCacheKey> stored_graphics_pipelines;
+    std::unordered_set<ComputePipelineCacheKey> stored_compute_pipelines;
+
+    // Guest driver profile state already stored in the transferable file
+    bool saved_texture_handler_size{};
+    std::size_t num_saved_bindless_samplers{};
+
+    // The cache has been loaded at boot
+    bool is_usable{};
+};
+
+} // namespace Vulkan
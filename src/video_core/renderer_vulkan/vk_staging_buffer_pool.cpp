@@ -18,11 +18,16 @@ namespace Vulkan {
 
 VKStagingBufferPool::StagingBuffer::StagingBuffer(std::unique_ptr<VKBuffer> buffer, VKFence& fence,
                                                   u64 last_epoch)
-    : buffer{std::move(buffer)}, watch{fence}, last_epoch{last_epoch} {}
+    : buffer{std::move(buffer)}, tick{fence.GetTick()}, last_epoch{last_epoch} {
+    if (tick == 0) {
+        watch.Watch(fence);
+    }
+}
 
 VKStagingBufferPool::StagingBuffer::StagingBuffer(StagingBuffer&& rhs) noexcept {
     buffer = std::move(rhs.buffer);
     watch = std::move(rhs.watch);
+    tick = rhs.tick;
     last_epoch = rhs.last_epoch;
 }
 
@@ -32,6 +37,7 @@ VKStagingBufferPool::StagingBuffer& VKStagingBufferPool::StagingBuffer::operator
     StagingBuffer&& rhs) noexcept {
     buffer = std::move(rhs.buffer);
     watch = std::move(rhs.watch);
+    tick = rhs.tick;
     last_epoch = rhs.last_epoch;
     return *this;
 }
@@ -61,11 +67,19 @@ void VKStagingBufferPool::TickFrame() {
 }
 
 VKBuffer* VKStagingBufferPool::TryGetReservedBuffer(std::size_t size, bool host_visible) {
+    VKFence& fence = scheduler.GetFence();
+    const u64 tick = fence.GetTick();
     for (auto& entry : GetCache(host_visible)[Common::Log2Ceil64(size)].entries) {
-        if (entry.watch.TryWatch(scheduler.GetFence())) {
-            entry.last_epoch = epoch;
-            return &*entry.buffer;
+        if (tick != 0) {
+            if (!fence.IsTickFree(entry.tick)) {
+                continue;
+            }
+            entry.tick = tick;
+        } else if (!entry.watch.TryWatch(fence)) {
+            continue;
         }
+        entry.last_epoch = epoch;
+        return &*entry.buffer;
     }
     return nullptr;
 }
@@ -106,8 +120,10 @@ u64 VKStagingBufferPool::ReleaseLevel(StagingBuffersCache& cache, std::size_t lo
     auto& entries = staging.entries;
     const std::size_t old_size = entries.size();
 
-    const auto is_deleteable = [this](const auto& entry) {
-        return entry.last_epoch + epochs_to_destroy < epoch && !entry.watch.IsUsed();
+    VKFence& fence = scheduler.GetFence();
+    const auto is_deleteable = [this, &fence](const auto& entry) {
+        return entry.last_epoch + epochs_to_destroy < epoch && !entry.watch.IsUsed() &&
+               fence.IsTickFree(entry.tick);
     };
     const std::size_t begin_offset = staging.delete_index;
     const std::size_t end_offset = std::min(begin_offset + deletions_per_tick, old_size);
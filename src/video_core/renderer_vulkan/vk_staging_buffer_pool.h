@@ -47,6 +47,7 @@ private:
 
         std::unique_ptr<VKBuffer> buffer;
         VKFenceWatch watch;
+        u64 tick = 0; ///< Tick of the last usage, only used with timeline semaphores.
         u64 last_epoch = 0;
     };
 
@@ -9,6 +9,7 @@
 
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/vk_device.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
@@ -22,16 +23,22 @@ namespace {
 constexpr u64 WATCHES_INITIAL_RESERVE = 0x4000;
 constexpr u64 WATCHES_RESERVE_CHUNK = 0x1000;
 
-constexpr u64 STREAM_BUFFER_SIZE = 256 * 1024 * 1024;
+constexpr u64 INITIAL_STREAM_BUFFER_SIZE = 256 * 1024 * 1024;
+constexpr u64 MAX_STREAM_BUFFER_SIZE = 1024 * 1024 * 1024;
 
-std::optional<u32> FindMemoryType(const VKDevice& device, u32 filter,
+std::optional<u32> FindMemoryType(const VKDevice& device, u32 filter, u64 size,
                                   vk::MemoryPropertyFlags wanted) {
     const auto properties = device.GetPhysical().getMemoryProperties(device.GetDispatchLoader());
     for (u32 i = 0; i < properties.memoryTypeCount; i++) {
         if (!(filter & (1 << i))) {
             continue;
         }
-        if ((properties.memoryTypes[i].propertyFlags & wanted) == wanted) {
+        const auto& type = properties.memoryTypes[i];
+        if (properties.memoryHeaps[type.heapIndex].size < size) {
+            // Grown buffers might not fit in small heaps (e.g. AMD's pinned memory)
+            continue;
+        }
+        if ((type.propertyFlags & wanted) == wanted) {
             return i;
         }
     }
@@ -42,8 +49,8 @@ std::optional<u32> FindMemoryType(const VKDevice& device, u32 filter,
 
 VKStreamBuffer::VKStreamBuffer(const VKDevice& device, VKScheduler& scheduler,
                                vk::BufferUsageFlags usage)
-    : device{device}, scheduler{scheduler} {
-    CreateBuffers(usage);
+    : device{device}, scheduler{scheduler}, usage{usage}, buffer_size{INITIAL_STREAM_BUFFER_SIZE} {
+    CreateBuffers();
     ReserveWatches(current_watches, WATCHES_INITIAL_RESERVE);
     ReserveWatches(previous_watches, WATCHES_INITIAL_RESERVE);
 }
@@ -51,17 +58,25 @@ VKStreamBuffer::VKStreamBuffer(const VKDevice& device, VKScheduler& scheduler,
 VKStreamBuffer::~VKStreamBuffer() = default;
 
 std::tuple<u8*, u64, bool> VKStreamBuffer::Map(u64 size, u64 alignment) {
-    ASSERT(size <= STREAM_BUFFER_SIZE);
+    ASSERT(size <= MAX_STREAM_BUFFER_SIZE);
     mapped_size = size;
 
     if (alignment > 0) {
         offset = Common::AlignUp(offset, alignment);
     }
 
+    if (offset + size > buffer_size && ShouldGrow(size)) {
+        Grow(size);
+        const auto dev = device.GetLogical();
+        const auto& dld = device.GetDispatchLoader();
+        const auto pointer = reinterpret_cast<u8*>(dev.mapMemory(*memory, offset, size, {}, dld));
+        return {pointer, offset, true};
+    }
+
     WaitPendingOperations(offset);
 
     bool invalidated = false;
-    if (offset + size > STREAM_BUFFER_SIZE) {
+    if (offset + size > buffer_size) {
         // The buffer would overflow, save the amount of used watches and reset the state.
         invalidation_mark = current_watch_cursor;
         current_watch_cursor = 0;
@@ -91,6 +106,7 @@ void VKStreamBuffer::Unmap(u64 size) {
     dev.unmapMemory(*memory, device.GetDispatchLoader());
 
     offset += size;
+    frame_usage += size;
 
     if (current_watch_cursor + 1 >= current_watches.size()) {
         // Ensure that there are enough watches.
@@ -101,22 +117,27 @@ void VKStreamBuffer::Unmap(u64 size) {
     watch.fence.Watch(scheduler.GetFence());
 }
 
-void VKStreamBuffer::CreateBuffers(vk::BufferUsageFlags usage) {
-    const vk::BufferCreateInfo buffer_ci({}, STREAM_BUFFER_SIZE, usage, vk::SharingMode::eExclusive,
-                                         0, nullptr);
+void VKStreamBuffer::TickFrame() {
+    high_water_mark = std::max(high_water_mark, frame_usage);
+    frame_usage = 0;
+}
+
+void VKStreamBuffer::CreateBuffers() {
+    const vk::BufferCreateInfo buffer_ci({}, buffer_size, usage, vk::SharingMode::eExclusive, 0,
+                                         nullptr);
     const auto dev = device.GetLogical();
     const auto& dld = device.GetDispatchLoader();
     buffer = dev.createBufferUnique(buffer_ci, nullptr, dld);
 
     const auto requirements = dev.getBufferMemoryRequirements(*buffer, dld);
     // Prefer device local host visible allocations (this should hit AMD's pinned memory).
-    auto type = FindMemoryType(device, requirements.memoryTypeBits,
+    auto type = FindMemoryType(device, requirements.memoryTypeBits, requirements.size,
                                vk::MemoryPropertyFlagBits::eHostVisible |
                                    vk::MemoryPropertyFlagBits::eHostCoherent |
                                    vk::MemoryPropertyFlagBits::eDeviceLocal);
     if (!type) {
         // Otherwise search for a host visible allocation.
-        type = FindMemoryType(device, requirements.memoryTypeBits,
+        type = FindMemoryType(device, requirements.memoryTypeBits, requirements.size,
                               vk::MemoryPropertyFlagBits::eHostVisible |
                                   vk::MemoryPropertyFlagBits::eHostCoherent);
         ASSERT_MSG(type, "No host visible and coherent memory type found");
@@ -127,6 +148,40 @@ void VKStreamBuffer::CreateBuffers(vk::BufferUsageFlags usage) {
     dev.bindBufferMemory(*buffer, *memory, 0, dld);
 }
 
+bool VKStreamBuffer::ShouldGrow(u64 size) const {
+    if (buffer_size >= MAX_STREAM_BUFFER_SIZE) {
+        return false;
+    }
+    // When a single frame fills more than half of the buffer, the memory reused after wrapping
+    // around is likely still being read by frames in flight and waiting for it stalls mid-frame.
+    return frame_usage + size > buffer_size / 2;
+}
+
+void VKStreamBuffer::Grow(u64 size) {
+    const u64 wanted_size = std::max(high_water_mark, frame_usage + size) * 2;
+    u64 new_size = buffer_size;
+    while (new_size < wanted_size && new_size < MAX_STREAM_BUFFER_SIZE) {
+        new_size *= 2;
+    }
+    new_size = std::min(new_size, MAX_STREAM_BUFFER_SIZE);
+    LOG_INFO(Render_Vulkan, "Growing stream buffer from {} MiB to {} MiB, {} MiB used this frame",
+             buffer_size >> 20, new_size >> 20, (frame_usage + size) >> 20);
+
+    // The old buffer can't be destroyed while the GPU is using it, growing is rare enough to wait
+    scheduler.Finish();
+    buffer.reset();
+    memory.reset();
+    buffer_size = new_size;
+    CreateBuffers();
+
+    // All the pending operations have finished, start a clean cycle
+    offset = 0;
+    current_watch_cursor = 0;
+    invalidation_mark = std::nullopt;
+    wait_cursor = 0;
+    wait_bound = 0;
+}
+
 void VKStreamBuffer::ReserveWatches(std::vector<Watch>& watches, std::size_t grow_size) {
     watches.resize(watches.size() + grow_size);
 }
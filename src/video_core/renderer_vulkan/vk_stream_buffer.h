@@ -35,6 +35,9 @@ public:
     /// Ensures that "size" bytes of memory are available to the GPU, potentially recording a copy.
     void Unmap(u64 size);
 
+    /// Marks the end of a frame, updating usage statistics.
+    void TickFrame();
+
     vk::Buffer GetHandle() const {
         return *buffer;
     }
@@ -46,7 +49,13 @@ private:
     };
 
     /// Creates Vulkan buffer handles committing the required the required memory.
-    void CreateBuffers(vk::BufferUsageFlags usage);
+    void CreateBuffers();
+
+    /// Returns true when the buffer should grow instead of wrapping around.
+    bool ShouldGrow(u64 size) const;
+
+    /// Waits for the GPU to be idle and replaces the buffer with a larger one.
+    void Grow(u64 size);
 
     /// Increases the amount of watches available.
     void ReserveWatches(std::vector<Watch>& watches, std::size_t grow_size);
@@ -57,9 +66,11 @@ private:
     VKScheduler& scheduler;                      ///< Command scheduler.
     const vk::AccessFlags access;                ///< Access usage of this stream buffer.
     const vk::PipelineStageFlags pipeline_stage; ///< Pipeline usage of this stream buffer.
+    const vk::BufferUsageFlags usage;            ///< Usage of the Vulkan buffer.
 
     UniqueBuffer buffer;       ///< Mapped buffer.
     UniqueDeviceMemory memory; ///< Memory allocation.
+    u64 buffer_size{};         ///< Size of the buffer, it grows when a frame doesn't fit.
 
     u64 offset{};      ///< Buffer iterator.
     u64 mapped_size{}; ///< Size reserved for the current copy.
@@ -71,6 +82,9 @@ private:
     std::vector<Watch> previous_watches; ///< Watches used in the previous iteration.
     std::size_t wait_cursor{};           ///< Last watch being waited for completion.
     u64 wait_bound{};                    ///< Highest offset being watched for completion.
+
+    u64 frame_usage{};     ///< Bytes used in the current frame.
+    u64 high_water_mark{}; ///< Highest number of bytes used in a single frame.
 };
 
 } // namespace Vulkan
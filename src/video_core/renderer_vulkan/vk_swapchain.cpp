@@ -11,6 +11,7 @@
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/frontend/framebuffer_layout.h"
+#include "core/settings.h"
 #include "video_core/renderer_vulkan/declarations.h"
 #include "video_core/renderer_vulkan/vk_device.h"
 #include "video_core/renderer_vulkan/vk_resource_manager.h"
@@ -36,12 +37,34 @@ vk::SurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormat
     return found != formats.end() ? *found : formats[0];
 }
 
+/// Upper bound of the configurable frames in flight
+constexpr u32 MAX_FRAMES_IN_FLIGHT = 4;
+
 vk::PresentModeKHR ChooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& modes) {
-    // Mailbox doesn't lock the application like fifo (vsync), prefer it
-    const auto& found = std::find_if(modes.begin(), modes.end(), [](const auto& mode) {
-        return mode == vk::PresentModeKHR::eMailbox;
-    });
-    return found != modes.end() ? *found : vk::PresentModeKHR::eFifo;
+    vk::PresentModeKHR requested_mode;
+    switch (Settings::values.vulkan_present_mode) {
+    case Settings::VulkanPresentMode::Automatic:
+    default:
+        // When the frame limit follows vsync, fifo gives the most stable pacing. Otherwise mailbox
+        // doesn't lock the application like fifo does, while it still doesn't tear
+        requested_mode = Settings::values.use_frame_limit &&
+                                 Settings::values.align_frame_limit_to_vsync
+                             ? vk::PresentModeKHR::eFifo
+                             : vk::PresentModeKHR::eMailbox;
+        break;
+    case Settings::VulkanPresentMode::Fifo:
+        requested_mode = vk::PresentModeKHR::eFifo;
+        break;
+    case Settings::VulkanPresentMode::Mailbox:
+        requested_mode = vk::PresentModeKHR::eMailbox;
+        break;
+    case Settings::VulkanPresentMode::Immediate:
+        requested_mode = vk::PresentModeKHR::eImmediate;
+        break;
+    }
+    // Fifo is the only mode every implementation is required to support
+    const bool is_supported = std::find(modes.begin(), modes.end(), requested_mode) != modes.end();
+    return is_supported ? requested_mode : vk::PresentModeKHR::eFifo;
 }
 
 vk::Extent2D ChooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, u32 width,
@@ -77,6 +100,10 @@ void VKSwapchain::Create(u32 width, u32 height, bool srgb) {
     Destroy();
 
     CreateSwapchain(capabilities, width, height, srgb);
+
+    frames_in_flight = std::clamp(Settings::values.vulkan_frames_in_flight, 1U,
+                                  std::min(MAX_FRAMES_IN_FLIGHT, static_cast<u32>(image_count)));
+    frame_images.assign(frames_in_flight, std::nullopt);
     CreateSemaphores();
     CreateImageViews();
 
@@ -84,12 +111,23 @@ void VKSwapchain::Create(u32 width, u32 height, bool srgb) {
 }
 
 void VKSwapchain::AcquireNextImage() {
+    // Wait for the frame that used this slot to finish rendering before queueing another one, so
+    // no more than frames_in_flight frames are ever queued ahead of the display
+    if (const auto& previous_image = frame_images[frame_index]) {
+        WaitImage(*previous_image);
+    }
+
     const auto dev{device.GetLogical()};
     const auto& dld{device.GetDispatchLoader()};
     dev.acquireNextImageKHR(*swapchain, std::numeric_limits<u64>::max(),
                             *present_semaphores[frame_index], {}, &image_index, dld);
 
-    if (auto& fence = fences[image_index]; fence) {
+    // The image may still be rendered to by a frame of another slot
+    WaitImage(image_index);
+}
+
+void VKSwapchain::WaitImage(u32 index) {
+    if (auto& fence = fences[index]; fence) {
         fence->Wait();
         fence->Release();
         fence = nullptr;
@@ -121,10 +159,18 @@ bool VKSwapchain::Present(vk::Semaphore render_semaphore, VKFence& fence) {
         UNREACHABLE();
     }
 
+    if (recreated) {
+        // The new swapchain starts with no frames in flight, only this frame's fence is pending
+        fence.Wait();
+        fence.Release();
+        return true;
+    }
+
     ASSERT(fences[image_index] == nullptr);
     fences[image_index] = &fence;
-    frame_index = (frame_index + 1) % static_cast<u32>(image_count);
-    return recreated;
+    frame_images[frame_index] = image_index;
+    frame_index = (frame_index + 1) % frames_in_flight;
+    return false;
 }
 
 bool VKSwapchain::HasFramebufferChanged(const Layout::FramebufferLayout& framebuffer) const {
@@ -181,8 +227,9 @@ void VKSwapchain::CreateSemaphores() {
     const auto dev{device.GetLogical()};
     const auto& dld{device.GetDispatchLoader()};
 
-    present_semaphores.resize(image_count);
-    for (std::size_t i = 0; i < image_count; i++) {
+    // Acquire semaphores are per frame in flight, a slot is only reused once its frame is done
+    present_semaphores.resize(frames_in_flight);
+    for (std::size_t i = 0; i < frames_in_flight; i++) {
         present_semaphores[i] = dev.createSemaphoreUnique({}, nullptr, dld);
     }
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include "common/common_types.h"
@@ -26,7 +27,8 @@ public:
     /// Creates (or recreates) the swapchain with a given size.
     void Create(u32 width, u32 height, bool srgb);
 
-    /// Acquires the next image in the swapchain, waits as needed.
+    /// Acquires the next image in the swapchain. Waits as needed to keep no more frames in flight
+    /// than configured.
     void AcquireNextImage();
 
     /// Presents the rendered image to the swapchain. Returns true when the swapchains had to be
@@ -70,6 +72,9 @@ private:
     void CreateSemaphores();
     void CreateImageViews();
 
+    /// Waits for the rendering to the given swapchain image to finish
+    void WaitImage(u32 index);
+
     void Destroy();
 
     const vk::SurfaceKHR surface;
@@ -84,8 +89,12 @@ private:
     std::vector<VKFence*> fences;
     std::vector<UniqueSemaphore> present_semaphores;
 
+    /// Image presented by the last frame of each frame in flight slot
+    std::vector<std::optional<u32>> frame_images;
+
     u32 image_index{};
     u32 frame_index{};
+    u32 frames_in_flight{1};
 
     vk::Format image_format{};
     vk::Extent2D extent{};
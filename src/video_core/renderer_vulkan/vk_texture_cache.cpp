@@ -36,6 +36,7 @@ using Tegra::Texture::SwizzleSource;
 using VideoCore::Surface::PixelFormat;
 using VideoCore::Surface::SurfaceCompression;
 using VideoCore::Surface::SurfaceTarget;
+using VideoCore::Surface::SurfaceType;
 
 namespace {
 
@@ -294,6 +295,26 @@ void CachedSurface::UploadImage(const std::vector<u8>& staging_buffer) {
     }
 }
 
+void CachedSurface::UploadBand(const std::vector<u8>& staging_buffer,
+                               const VideoCommon::SurfaceBand& band) {
+    scheduler.RequestOutsideRenderPassOperationContext();
+
+    const auto& src_buffer = staging_pool.GetUnusedBuffer(band.host_size, true);
+    std::memcpy(src_buffer.commit->Map(band.host_size), staging_buffer.data(), band.host_size);
+
+    Transition(band.layer, 1, band.level, 1, vk::PipelineStageFlagBits::eTransfer,
+               vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eTransferDstOptimal);
+
+    const vk::BufferImageCopy copy(0, 0, 0, {image->GetAspectMask(), band.level, band.layer, 1},
+                                   {0, static_cast<s32>(band.y), 0},
+                                   {params.GetMipWidth(band.level), band.height, 1});
+    scheduler.Record(
+        [buffer = *src_buffer.handle, image = image->GetHandle(), copy](auto cmdbuf, auto& dld) {
+            cmdbuf.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, {copy},
+                                     dld);
+        });
+}
+
 vk::BufferImageCopy CachedSurface::GetBufferImageCopy(u32 level) const {
     const u32 vk_depth = params.target == SurfaceTarget::Texture3D ? params.GetMipDepth(level) : 1;
     const auto compression_type = params.GetCompressionType();
@@ -455,7 +476,9 @@ void VKTextureCache::ImageBlit(View& src_view, View& dst_view,
     const auto dst_bot_right = vk::Offset3D(cfg.dst_rect.right, cfg.dst_rect.bottom, 1);
     const vk::ImageBlit blit(src_view->GetImageSubresourceLayers(), {src_top_left, src_bot_right},
                              dst_view->GetImageSubresourceLayers(), {dst_top_left, dst_bot_right});
-    const bool is_linear = copy_config.filter == Tegra::Engines::Fermi2D::Filter::Linear;
+    // Depth and stencil aspects can only be blitted with nearest filtering
+    const bool is_linear = copy_config.filter == Tegra::Engines::Fermi2D::Filter::Linear &&
+                           blit.srcSubresource.aspectMask == vk::ImageAspectFlagBits::eColor;
 
     const auto& dld{device.GetDispatchLoader()};
     scheduler.Record([src_image = src_view->GetImage(), dst_image = dst_view->GetImage(), blit,
@@ -467,9 +490,64 @@ void VKTextureCache::ImageBlit(View& src_view, View& dst_view,
 }
 
 void VKTextureCache::BufferCopy(Surface& src_surface, Surface& dst_surface) {
-    // Currently unimplemented. PBO copies should be dropped and we should use a render pass to
-    // convert from color to depth and viceversa.
-    LOG_WARNING(Render_Vulkan, "Unimplemented");
+    const auto& src_params = src_surface->GetSurfaceParams();
+    const auto& dst_params = dst_surface->GetSurfaceParams();
+    const std::size_t size = src_surface->GetHostSizeInBytes();
+
+    if (!CanBufferCopy(src_params, dst_params) || src_params.num_levels > 1 ||
+        dst_params.num_levels > 1 || size != dst_surface->GetHostSizeInBytes()) {
+        LOG_WARNING(Render_Vulkan, "Unimplemented buffer copy from format {} to format {}",
+                    static_cast<u32>(src_params.pixel_format),
+                    static_cast<u32>(dst_params.pixel_format));
+        return;
+    }
+
+    // We can't copy inside a renderpass
+    scheduler.RequestOutsideRenderPassOperationContext();
+
+    src_surface->FullTransition(vk::PipelineStageFlagBits::eTransfer,
+                                vk::AccessFlagBits::eTransferRead,
+                                vk::ImageLayout::eTransferSrcOptimal);
+    dst_surface->FullTransition(vk::PipelineStageFlagBits::eTransfer,
+                                vk::AccessFlagBits::eTransferWrite,
+                                vk::ImageLayout::eTransferDstOptimal);
+
+    const auto& buffer = staging_pool.GetUnusedBuffer(size, false);
+    scheduler.Record([src_image = src_surface->GetImageHandle(),
+                      dst_image = dst_surface->GetImageHandle(), buffer = *buffer.handle,
+                      src_copy = src_surface->GetBufferImageCopy(0),
+                      dst_copy = dst_surface->GetBufferImageCopy(0), size](auto cmdbuf, auto& dld) {
+        cmdbuf.copyImageToBuffer(src_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                 {src_copy}, dld);
+        const vk::BufferMemoryBarrier barrier(
+            vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead,
+            VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, buffer, 0, size);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eTransfer, {}, {}, {barrier}, {}, dld);
+        cmdbuf.copyBufferToImage(buffer, dst_image, vk::ImageLayout::eTransferDstOptimal,
+                                 {dst_copy}, dld);
+    });
+}
+
+bool VKTextureCache::CanBufferCopy(const SurfaceParams& src_params,
+                                   const SurfaceParams& dst_params) const {
+    // Reinterpreting through a buffer works when both images have a single aspect, this covers
+    // color and depth aliases like R32F and Z32F. Packed depth stencil formats store their
+    // aspects separately in buffers and would need a render pass to convert them.
+    const auto is_supported = [](const SurfaceParams& params) {
+        return !params.IsBuffer() && params.type != SurfaceType::DepthStencil &&
+               params.GetCompressionType() != SurfaceCompression::Converted;
+    };
+    return is_supported(src_params) && is_supported(dst_params);
+}
+
+bool VKTextureCache::CanUploadSwizzled(const SurfaceParams& params) const {
+    // There is no deswizzling compute pass yet, textures are always deswizzled on the CPU.
+    return false;
+}
+
+void VKTextureCache::UploadSwizzled(const Surface& surface, const u8* guest_data) {
+    UNREACHABLE();
 }
 
 } // namespace Vulkan
@@ -59,6 +59,8 @@ public:
 
     void UploadTexture(const std::vector<u8>& staging_buffer) override;
     void DownloadTexture(std::vector<u8>& staging_buffer) override;
+    void UploadBand(const std::vector<u8>& staging_buffer,
+                    const VideoCommon::SurfaceBand& band) override;
 
     void FullTransition(vk::PipelineStageFlags new_stage_mask, vk::AccessFlags new_access,
                         vk::ImageLayout new_layout) {
@@ -93,6 +95,8 @@ public:
         return *buffer_view;
     }
 
+    vk::BufferImageCopy GetBufferImageCopy(u32 level) const;
+
 protected:
     void DecorateSurfaceName();
 
@@ -104,8 +108,6 @@ private:
 
     void UploadImage(const std::vector<u8>& staging_buffer);
 
-    vk::BufferImageCopy GetBufferImageCopy(u32 level) const;
-
     vk::ImageSubresourceRange GetImageSubresourceRange() const;
 
     Core::System& system;
@@ -229,6 +231,13 @@ private:
 
     void BufferCopy(Surface& src_surface, Surface& dst_surface) override;
 
+    bool CanBufferCopy(const SurfaceParams& src_params,
+                       const SurfaceParams& dst_params) const override;
+
+    bool CanUploadSwizzled(const SurfaceParams& params) const override;
+
+    void UploadSwizzled(const Surface& surface, const u8* guest_data) override;
+
     const VKDevice& device;
     VKResourceManager& resource_manager;
     VKMemoryManager& memory_manager;
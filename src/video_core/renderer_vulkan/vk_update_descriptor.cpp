@@ -2,12 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <variant>
 #include <boost/container/static_vector.hpp>
 
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "video_core/renderer_vulkan/declarations.h"
+#include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_device.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_update_descriptor.h"
@@ -21,18 +24,25 @@ VKUpdateDescriptorQueue::~VKUpdateDescriptorQueue() = default;
 
 void VKUpdateDescriptorQueue::TickFrame() {
     payload.clear();
+    cached_sets.clear();
 }
 
 void VKUpdateDescriptorQueue::Acquire() {
     entries.clear();
 }
 
-void VKUpdateDescriptorQueue::Send(vk::DescriptorUpdateTemplate update_template,
-                                   vk::DescriptorSet set) {
+vk::DescriptorSet VKUpdateDescriptorQueue::Send(vk::DescriptorUpdateTemplate update_template,
+                                                DescriptorAllocator& allocator, VKFence& fence) {
     if (payload.size() + entries.size() >= payload.max_size()) {
         LOG_WARNING(Render_Vulkan, "Payload overflow, waiting for worker thread");
         scheduler.WaitWorker();
         payload.clear();
+        cached_sets.clear();
+    }
+    if (const u64 tick = scheduler.GetTicks(); tick != cache_tick) {
+        // Sets from previous command buffers are no longer protected by the current fence
+        cached_sets.clear();
+        cache_tick = tick;
     }
 
     const auto payload_start = payload.data() + payload.size();
@@ -48,10 +58,26 @@ void VKUpdateDescriptorQueue::Send(vk::DescriptorUpdateTemplate update_template,
         }
     }
 
+    const std::size_t num_entries = entries.size();
+    const std::size_t size_bytes = num_entries * sizeof(DescriptorUpdateEntry);
+    const u64 hash = Common::HashValue(payload_start, size_bytes);
+    if (const auto it = cached_sets.find(hash); it != cached_sets.end()) {
+        const CachedSet& cached = it->second;
+        if (cached.update_template == update_template && cached.num_entries == num_entries &&
+            std::memcmp(cached.entries, payload_start, size_bytes) == 0) {
+            payload.resize(payload.size() - num_entries);
+            return cached.set;
+        }
+    }
+
+    const vk::DescriptorSet set = allocator.Commit(fence);
+    cached_sets.insert_or_assign(hash, CachedSet{update_template, set, payload_start, num_entries});
+
     scheduler.Record([dev = device.GetLogical(), payload_start, set,
                       update_template]([[maybe_unused]] auto cmdbuf, auto& dld) {
         dev.updateDescriptorSetWithTemplate(set, update_template, payload_start, dld);
     });
+    return set;
 }
 
 } // namespace Vulkan
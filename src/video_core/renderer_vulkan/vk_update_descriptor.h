@@ -5,6 +5,7 @@
 #pragma once
 
 #include <type_traits>
+#include <unordered_map>
 #include <variant>
 #include <boost/container/static_vector.hpp>
 
@@ -13,19 +14,26 @@
 
 namespace Vulkan {
 
+class DescriptorAllocator;
 class VKDevice;
+class VKFence;
 class VKScheduler;
 
 class DescriptorUpdateEntry {
 public:
-    explicit DescriptorUpdateEntry() : image{} {}
+    explicit DescriptorUpdateEntry() : buffer{} {}
 
-    DescriptorUpdateEntry(vk::DescriptorImageInfo image) : image{image} {}
+    // Unused bytes are zeroed so payloads with the same descriptors compare equal bitwise
+    DescriptorUpdateEntry(vk::DescriptorImageInfo image_) : buffer{} {
+        image = image_;
+    }
 
     DescriptorUpdateEntry(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size)
         : buffer{buffer, offset, size} {}
 
-    DescriptorUpdateEntry(vk::BufferView texel_buffer) : texel_buffer{texel_buffer} {}
+    DescriptorUpdateEntry(vk::BufferView texel_buffer_) : buffer{} {
+        texel_buffer = texel_buffer_;
+    }
 
 private:
     union {
@@ -44,7 +52,10 @@ public:
 
     void Acquire();
 
-    void Send(vk::DescriptorUpdateTemplate update_template, vk::DescriptorSet set);
+    /// Returns a descriptor set holding the acquired entries. Sets with identical contents updated
+    /// in the current command buffer are reused instead of committing and updating a new one.
+    vk::DescriptorSet Send(vk::DescriptorUpdateTemplate update_template,
+                           DescriptorAllocator& allocator, VKFence& fence);
 
     void AddSampledImage(vk::Sampler sampler, vk::ImageView image_view) {
         entries.emplace_back(vk::DescriptorImageInfo{sampler, image_view, {}});
@@ -72,6 +83,13 @@ private:
         u64 offset{};
         std::size_t size{};
     };
+    struct CachedSet {
+        vk::DescriptorUpdateTemplate update_template;
+        vk::DescriptorSet set;
+        const DescriptorUpdateEntry* entries{};
+        std::size_t num_entries{};
+    };
+
     using Variant = std::variant<vk::DescriptorImageInfo, Buffer, vk::BufferView>;
     // Old gcc versions don't consider this trivially copyable.
     // static_assert(std::is_trivially_copyable_v<Variant>);
@@ -81,6 +99,10 @@ private:
 
     boost::container::static_vector<Variant, 0x400> entries;
     boost::container::static_vector<DescriptorUpdateEntry, 0x10000> payload;
+
+    /// Sets updated in the command buffer of cache_tick, keyed by the hash of their payload
+    std::unordered_map<u64, CachedSet> cached_sets;
+    u64 cache_tick = 0;
 };
 
 } // namespace Vulkan
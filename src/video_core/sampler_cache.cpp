@@ -2,16 +2,26 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/cityhash.h"
+#include <cstring>
+
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "video_core/sampler_cache.h"
 
 namespace VideoCommon {
 
 std::size_t SamplerCacheKey::Hash() const {
-    static_assert(sizeof(raw) % sizeof(u64) == 0);
-    return static_cast<std::size_t>(
-        Common::CityHash64(reinterpret_cast<const char*>(raw.data()), sizeof(raw) / sizeof(u64)));
+    return static_cast<std::size_t>(Common::HashValue(raw.data(), sizeof(raw)));
+}
+
+std::size_t SamplerCacheKey::FastHash(const Tegra::Texture::TSCEntry& tsc) {
+    std::array<u64, sizeof(tsc.raw) / sizeof(u64)> words;
+    std::memcpy(words.data(), tsc.raw.data(), sizeof(words));
+    u64 hash = 0;
+    for (const u64 word : words) {
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    }
+    return static_cast<std::size_t>(hash >> 32);
 }
 
 bool SamplerCacheKey::operator==(const SamplerCacheKey& rhs) const {
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <unordered_map>
+#include <utility>
 
+#include "common/common_types.h"
 #include "video_core/textures/texture.h"
 
 namespace VideoCommon {
@@ -14,6 +17,9 @@ namespace VideoCommon {
 struct SamplerCacheKey final : public Tegra::Texture::TSCEntry {
     std::size_t Hash() const;
 
+    /// Cheap hash used to index the direct mapped front cache, it doesn't have to be good.
+    static std::size_t FastHash(const Tegra::Texture::TSCEntry& tsc);
+
     bool operator==(const SamplerCacheKey& rhs) const;
 
     bool operator!=(const SamplerCacheKey& rhs) const {
@@ -40,12 +46,41 @@ template <typename SamplerType, typename SamplerStorageType>
 class SamplerCache {
 public:
     SamplerType GetSampler(const Tegra::Texture::TSCEntry& tsc) {
-        const auto [entry, is_cache_miss] = cache.try_emplace(SamplerCacheKey{tsc});
-        auto& sampler = entry->second;
+        // Draws usually look up the same few samplers, avoid hashing the whole entry for them
+        auto& front_entry = front_cache[SamplerCacheKey::FastHash(tsc) % FRONT_CACHE_SIZE];
+        if (front_entry && front_entry->first.raw == tsc.raw) {
+            front_entry->second.last_use_frame = frame;
+            return ToSamplerType(front_entry->second.sampler);
+        }
+
+        const auto [it, is_cache_miss] = cache.try_emplace(SamplerCacheKey{tsc});
+        auto& entry = it->second;
         if (is_cache_miss) {
-            sampler = CreateSampler(tsc);
+            entry.sampler = CreateSampler(tsc);
+        }
+        entry.last_use_frame = frame;
+        front_entry = &*it;
+        return ToSamplerType(entry.sampler);
+    }
+
+    /// Destroys the samplers that haven't been used in a while. Returns true when any of them has
+    /// been destroyed.
+    bool TickFrame() {
+        ++frame;
+        if (frame % COLLECTION_INTERVAL != 0) {
+            return false;
         }
-        return ToSamplerType(sampler);
+        front_cache.fill(nullptr);
+
+        const std::size_t old_size = cache.size();
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (it->second.last_use_frame + MAX_UNUSED_FRAMES < frame) {
+                it = cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return cache.size() != old_size;
     }
 
 protected:
@@ -54,7 +89,24 @@ protected:
     virtual SamplerType ToSamplerType(const SamplerStorageType& sampler) const = 0;
 
 private:
-    std::unordered_map<SamplerCacheKey, SamplerStorageType> cache;
+    /// Frames between garbage collections.
+    static constexpr u64 COLLECTION_INTERVAL = 256;
+
+    /// Frames a sampler can stay unused before it's destroyed, long enough to not be in flight.
+    static constexpr u64 MAX_UNUSED_FRAMES = 1024;
+
+    static constexpr std::size_t FRONT_CACHE_SIZE = 64;
+
+    struct Entry {
+        SamplerStorageType sampler;
+        u64 last_use_frame = 0;
+    };
+
+    using CacheType = std::unordered_map<SamplerCacheKey, Entry>;
+
+    CacheType cache;
+    std::array<typename CacheType::value_type*, FRONT_CACHE_SIZE> front_cache{};
+    u64 frame = 0;
 };
 
 } // namespace VideoCommon
\ No newline at end of file
@@ -426,12 +426,46 @@ void ASTManager::InsertReturn(Expr condition, bool kills) {
 // through outward/inward movements and lifting. Once they are at the same
 // level, you can enclose them in an "if" structure or a "do-while" structure.
 void ASTManager::Decompile() {
+    // Enclosing a goto can move pending ones into the scope of their labels, so retry them until a
+    // pass makes no progress instead of giving up after the first one.
+    std::size_t num_pending;
+    do {
+        num_pending = gotos.size();
+        if (!DecompilePass()) {
+            return;
+        }
+    } while (!gotos.empty() && gotos.size() < num_pending);
+
+    if (full_decompile) {
+        for (const ASTNode& label : labels) {
+            auto& manager = label->GetManager();
+            manager.Remove(label);
+        }
+        labels.clear();
+    } else {
+        std::vector<bool> is_label_used(labels.size());
+        for (const ASTNode& goto_node : gotos) {
+            const auto label_index = goto_node->GetGotoLabel();
+            if (!label_index) {
+                return;
+            }
+            is_label_used[*label_index] = true;
+        }
+        for (std::size_t index = 0; index < labels.size(); ++index) {
+            if (!is_label_used[index]) {
+                labels[index]->MarkLabelUnused();
+            }
+        }
+    }
+}
+
+bool ASTManager::DecompilePass() {
     auto it = gotos.begin();
     while (it != gotos.end()) {
         const ASTNode goto_node = *it;
         const auto label_index = goto_node->GetGotoLabel();
         if (!label_index) {
-            return;
+            return false;
         }
         const ASTNode label = labels[*label_index];
         if (!full_decompile) {
@@ -476,33 +510,7 @@ void ASTManager::Decompile() {
         }
         it++;
     }
-    if (full_decompile) {
-        for (const ASTNode& label : labels) {
-            auto& manager = label->GetManager();
-            manager.Remove(label);
-        }
-        labels.clear();
-    } else {
-        auto label_it = labels.begin();
-        while (label_it != labels.end()) {
-            bool can_remove = true;
-            ASTNode label = *label_it;
-            for (const ASTNode& goto_node : gotos) {
-                const auto label_index = goto_node->GetGotoLabel();
-                if (!label_index) {
-                    return;
-                }
-                ASTNode& glabel = labels[*label_index];
-                if (glabel == label) {
-                    can_remove = false;
-                    break;
-                }
-            }
-            if (can_remove) {
-                label->MarkLabelUnused();
-            }
-        }
-    }
+    return true;
 }
 
 bool ASTManager::IsBackwardsJump(ASTNode goto_node, ASTNode label_node) const {
@@ -369,6 +369,9 @@ public:
     }
 
 private:
+    /// Tries to structure each pending goto once. Returns false when a goto has no label.
+    bool DecompilePass();
+
     bool IsBackwardsJump(ASTNode goto_node, ASTNode label_node) const;
 
     bool IndirectlyRelated(const ASTNode& first, const ASTNode& second) const;
@@ -21,6 +21,9 @@ std::string CompileDepthAsString(CompileDepth cd);
 struct CompilerSettings {
     CompileDepth depth{CompileDepth::NoFlowStack};
     bool disable_else_derivation{true};
+    bool fold_constants{true};      ///< Evaluate integer operations on immediates
+    bool simplify_predicates{true}; ///< Resolve logical operations on constant predicates
+    bool eliminate_dead_code{true}; ///< Remove register writes overwritten within a block
 };
 
 } // namespace VideoCommon::Shader
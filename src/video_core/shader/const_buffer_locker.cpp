@@ -8,6 +8,7 @@
 #include "common/common_types.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
+#include "video_core/guest_driver.h"
 #include "video_core/shader/const_buffer_locker.h"
 
 namespace VideoCommon::Shader {
@@ -61,6 +62,8 @@ std::optional<Tegra::Engines::SamplerDescriptor> ConstBufferLocker::ObtainBindle
     if (!engine) {
         return std::nullopt;
     }
+    engine->AccessGuestDriverProfile().RegisterBindlessSampler(
+        {static_cast<u32>(stage), buffer, offset});
     const SamplerDescriptor value = engine->AccessBindlessSampler(stage, buffer, offset);
     bindless_samplers.emplace(key, value);
     return value;
@@ -166,6 +166,7 @@ void ShaderIR::Decode() {
             if (label == static_cast<u32>(exit_branch)) {
                 return;
             }
+            OptimizeBlock(nodes);
             basic_blocks.insert({label, nodes});
         };
         const auto& blocks = shader_info.blocks;
@@ -220,6 +221,7 @@ void ShaderIR::Decode() {
 NodeBlock ShaderIR::DecodeRange(u32 begin, u32 end) {
     NodeBlock basic_block;
     DecodeRangeInner(basic_block, begin, end);
+    OptimizeBlock(basic_block);
     return basic_block;
 }
 
@@ -252,19 +254,19 @@ void ShaderIR::InsertControlFlow(NodeBlock& bb, const ShaderBlock& block) {
                 Node n = Operation(OperationCode::Discard);
                 n = apply_conditions(branch->condition, n);
                 bb.push_back(n);
-                global_code.push_back(n);
+                PushGlobalCode(n);
                 return;
             }
             Node n = Operation(OperationCode::Exit);
             n = apply_conditions(branch->condition, n);
             bb.push_back(n);
-            global_code.push_back(n);
+            PushGlobalCode(n);
             return;
         }
         Node n = Operation(OperationCode::Branch, Immediate(branch->address));
         n = apply_conditions(branch->condition, n);
         bb.push_back(n);
-        global_code.push_back(n);
+        PushGlobalCode(n);
         return;
     }
     auto multi_branch = std::get_if<MultiBranch>(block.branch.get());
@@ -276,7 +278,7 @@ void ShaderIR::InsertControlFlow(NodeBlock& bb, const ShaderBlock& block) {
             GetPredicateComparisonInteger(Tegra::Shader::PredCondition::Equal, false, op_a, op_b);
         auto result = Conditional(condition, {n});
         bb.push_back(result);
-        global_code.push_back(result);
+        PushGlobalCode(result);
     }
 }
 
@@ -350,11 +352,11 @@ u32 ShaderIR::DecodeInstr(NodeBlock& bb, u32 pc) {
     if (can_be_predicated && pred_index != static_cast<u32>(Pred::UnusedIndex)) {
         const Node conditional =
             Conditional(GetPredicate(pred_index, instr.negate_pred != 0), std::move(tmp_block));
-        global_code.push_back(conditional);
+        PushGlobalCode(conditional);
         bb.push_back(conditional);
     } else {
         for (auto& node : tmp_block) {
-            global_code.push_back(node);
+            PushGlobalCode(node);
             bb.push_back(node);
         }
     }
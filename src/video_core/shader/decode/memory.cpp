@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 #include <fmt/format.h>
 
@@ -220,11 +221,11 @@ u32 ShaderIR::DecodeMemory(NodeBlock& bb, u32 pc) {
             }
         }();
 
-        const auto [real_address_base, base_address, descriptor] =
-            TrackGlobalMemory(bb, instr, true, false);
-
         const u32 size = GetMemorySize(type);
         const u32 count = Common::AlignUp(size, 32) / 32;
+        const auto [real_address_base, base_address, descriptor] =
+            TrackGlobalMemory(bb, instr, true, false, size / 8);
+
         if (!real_address_base || !base_address) {
             // Tracking failed, load zeroes.
             for (u32 i = 0; i < count; ++i) {
@@ -338,15 +339,15 @@ u32 ShaderIR::DecodeMemory(NodeBlock& bb, u32 pc) {
 
         // For unaligned reads we have to read memory too.
         const bool is_read = IsUnaligned(type);
+        const u32 size = GetMemorySize(type);
+        const u32 count = Common::AlignUp(size, 32) / 32;
         const auto [real_address_base, base_address, descriptor] =
-            TrackGlobalMemory(bb, instr, is_read, true);
+            TrackGlobalMemory(bb, instr, is_read, true, size / 8);
         if (!real_address_base || !base_address) {
             // Tracking failed, skip the store.
             break;
         }
 
-        const u32 size = GetMemorySize(type);
-        const u32 count = Common::AlignUp(size, 32) / 32;
         for (u32 i = 0; i < count; ++i) {
             const Node it_offset = Immediate(i * 4);
             const Node real_address = Operation(OperationCode::UAdd, real_address_base, it_offset);
@@ -369,7 +370,7 @@ u32 ShaderIR::DecodeMemory(NodeBlock& bb, u32 pc) {
                              static_cast<int>(instr.atom.type.Value()));
 
         const auto [real_address, base_address, descriptor] =
-            TrackGlobalMemory(bb, instr, true, true);
+            TrackGlobalMemory(bb, instr, true, true, sizeof(u32));
         if (!real_address || !base_address) {
             // Tracking failed, skip atomic.
             break;
@@ -421,7 +422,8 @@ u32 ShaderIR::DecodeMemory(NodeBlock& bb, u32 pc) {
 
 std::tuple<Node, Node, GlobalMemoryBase> ShaderIR::TrackGlobalMemory(NodeBlock& bb,
                                                                      Instruction instr,
-                                                                     bool is_read, bool is_write) {
+                                                                     bool is_read, bool is_write,
+                                                                     u32 access_size) {
     const auto addr_register{GetRegister(instr.gmem.gpr)};
     const auto immediate_offset{static_cast<u32>(instr.gmem.offset)};
 
@@ -439,6 +441,17 @@ std::tuple<Node, Node, GlobalMemoryBase> ShaderIR::TrackGlobalMemory(NodeBlock&
     usage.is_written |= is_write;
     usage.is_read |= is_read;
 
+    // Accesses at constant offsets let the rasterizer bind only the start of the region
+    const auto displacement = TrackCbufDisplacement(addr_register, global_code,
+                                                    static_cast<s64>(global_code.size()));
+    const s64 access_offset = displacement ? *displacement + instr.gmem.offset : -1;
+    if (access_offset < 0 || access_offset > std::numeric_limits<s32>::max()) {
+        usage.is_bounded = false;
+    } else {
+        const auto access_end = Common::AlignUp(static_cast<u32>(access_offset) + access_size, 4);
+        usage.bound_size = std::max(usage.bound_size, access_end);
+    }
+
     const auto real_address =
         Operation(OperationCode::UAdd, NO_PRECISE, Immediate(immediate_offset), addr_register);
 
@@ -0,0 +1,94 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <optional>
+
+#include "common/assert.h"
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "video_core/memory_manager.h"
+#include "video_core/shader/memory_util.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+/// Number of instructions read from guest memory at once while looking for the end of a program
+constexpr std::size_t READ_CHUNK_LENGTH = 0x100;
+
+/// Returns true when the instruction ends the program
+constexpr bool IsProgramEnd(u64 instruction) {
+    // This is the encoded version of BRA that jumps to itself. All Nvidia
+    // shaders end with one.
+    constexpr u64 self_jumping_branch = 0xE2400FFFFF07000FULL;
+    constexpr u64 mask = 0xFFFFFFFFFF7FFFFFULL;
+    return (instruction & mask) == self_jumping_branch || instruction == 0;
+}
+
+/// Looks for the instruction ending the program in [offset, end), advancing offset while scanning.
+/// Returns the offset of that instruction when it's found.
+std::optional<std::size_t> FindProgramEnd(const ProgramCode& program, std::size_t main_offset,
+                                          std::size_t& offset, std::size_t end) {
+    constexpr std::size_t SchedPeriod = 4;
+    for (; offset < end; ++offset) {
+        if (IsSchedInstruction(offset, main_offset)) {
+            // Test the three instructions of the bundle at once and skip it when none of them
+            // ends the program. Otherwise fall back to testing them one by one.
+            if (offset + SchedPeriod <= end) {
+                const u64* const bundle = program.data() + offset;
+                if (!(IsProgramEnd(bundle[1]) | IsProgramEnd(bundle[2]) |
+                      IsProgramEnd(bundle[3]))) {
+                    offset += SchedPeriod - 1;
+                }
+            }
+            continue;
+        }
+        if (IsProgramEnd(program[offset])) {
+            return offset;
+        }
+    }
+    return std::nullopt;
+}
+
+} // Anonymous namespace
+
+ProgramCode GetShaderCode(Tegra::MemoryManager& memory_manager, GPUVAddr gpu_addr,
+                          const u8* host_ptr, bool is_compute) {
+    ProgramCode code;
+    ASSERT_OR_EXECUTE(host_ptr != nullptr, {
+        code.resize(MAX_PROGRAM_LENGTH);
+        return code;
+    });
+    const std::size_t main_offset = is_compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+    std::size_t offset = main_offset;
+    while (code.size() < MAX_PROGRAM_LENGTH) {
+        const std::size_t read = code.size();
+        const std::size_t length = std::min(READ_CHUNK_LENGTH, MAX_PROGRAM_LENGTH - read);
+        code.resize(read + length);
+        memory_manager.ReadBlockUnsafe(gpu_addr + read * sizeof(u64), code.data() + read,
+                                       length * sizeof(u64));
+        if (const auto last = FindProgramEnd(code, main_offset, offset, code.size())) {
+            // The last instruction is included in the program size
+            code.resize(*last + 1);
+            break;
+        }
+    }
+    return code;
+}
+
+u64 GetUniqueIdentifier(const ProgramCode& code, const ProgramCode& code_b) {
+    u64 unique_identifier = Common::CityHash64(reinterpret_cast<const char*>(code.data()),
+                                               code.size() * sizeof(u64));
+    if (!code_b.empty()) {
+        // VertexA programs include two programs
+        unique_identifier = Common::CityHash64WithSeed(
+            reinterpret_cast<const char*>(code_b.data()), code_b.size() * sizeof(u64),
+            unique_identifier);
+    }
+    return unique_identifier;
+}
+
+} // namespace VideoCommon::Shader
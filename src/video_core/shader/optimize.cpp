@@ -0,0 +1,325 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <bitset>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/shader/node.h"
+#include "video_core/shader/node_helper.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace VideoCommon::Shader {
+
+using Tegra::Shader::Pred;
+
+namespace {
+
+constexpr std::size_t NumRegisters = 256;
+
+using RegisterSet = std::bitset<NumRegisters>;
+
+std::optional<u32> GetImmediate(const Node& node) {
+    if (const auto immediate = std::get_if<ImmediateNode>(&*node)) {
+        return immediate->GetValue();
+    }
+    return std::nullopt;
+}
+
+/// Returns the value of a predicate node when it is known at compile time
+std::optional<bool> GetConstantPredicate(const Node& node) {
+    const auto predicate = std::get_if<PredicateNode>(&*node);
+    if (!predicate) {
+        return std::nullopt;
+    }
+    switch (predicate->GetIndex()) {
+    case Pred::UnusedIndex:
+        return !predicate->IsNegated();
+    case Pred::NeverExecute:
+        return predicate->IsNegated();
+    default:
+        return std::nullopt;
+    }
+}
+
+Node MakeConstantPredicate(bool value) {
+    return MakeNode<PredicateNode>(Pred::UnusedIndex, !value);
+}
+
+std::optional<u32> FoldIntegerOperation(OperationCode code, const std::vector<u32>& values) {
+    if (values.size() == 1) {
+        switch (code) {
+        case OperationCode::INegate:
+            return 0U - values[0];
+        case OperationCode::IBitwiseNot:
+        case OperationCode::UBitwiseNot:
+            return ~values[0];
+        case OperationCode::ICastUnsigned:
+        case OperationCode::UCastSigned:
+            return values[0];
+        default:
+            return std::nullopt;
+        }
+    }
+    if (values.size() != 2) {
+        return std::nullopt;
+    }
+    const u32 a = values[0];
+    const u32 b = values[1];
+    switch (code) {
+    case OperationCode::IAdd:
+    case OperationCode::UAdd:
+        return a + b;
+    case OperationCode::IMul:
+    case OperationCode::UMul:
+        return a * b;
+    case OperationCode::IBitwiseAnd:
+    case OperationCode::UBitwiseAnd:
+        return a & b;
+    case OperationCode::IBitwiseOr:
+    case OperationCode::UBitwiseOr:
+        return a | b;
+    case OperationCode::IBitwiseXor:
+    case OperationCode::UBitwiseXor:
+        return a ^ b;
+    case OperationCode::ILogicalShiftLeft:
+    case OperationCode::ULogicalShiftLeft:
+        // Shifts past the register width are left to the host to keep their behavior
+        return b < 32 ? std::optional<u32>{a << b} : std::nullopt;
+    case OperationCode::ILogicalShiftRight:
+    case OperationCode::ULogicalShiftRight:
+        return b < 32 ? std::optional<u32>{a >> b} : std::nullopt;
+    default:
+        return std::nullopt;
+    }
+}
+
+Node SimplifyPredicateOperation(OperationCode code, const std::vector<Node>& operands) {
+    switch (code) {
+    case OperationCode::LogicalNegate:
+        if (operands.size() != 1) {
+            return {};
+        }
+        if (const auto predicate = std::get_if<PredicateNode>(&*operands[0])) {
+            return MakeNode<PredicateNode>(predicate->GetIndex(), !predicate->IsNegated());
+        }
+        return {};
+    case OperationCode::LogicalAnd:
+    case OperationCode::LogicalOr: {
+        if (operands.size() != 2) {
+            return {};
+        }
+        const bool is_and = code == OperationCode::LogicalAnd;
+        for (std::size_t i = 0; i < 2; ++i) {
+            const auto value = GetConstantPredicate(operands[i]);
+            if (!value) {
+                continue;
+            }
+            // true && x == x, false && x == false, true || x == true, false || x == x
+            return *value == is_and ? operands[1 - i] : MakeConstantPredicate(*value);
+        }
+        return {};
+    }
+    default:
+        return {};
+    }
+}
+
+/// Returns true when an operation changes state visible outside of registers or transfers control
+bool HasSideEffects(OperationCode code) {
+    return (code >= OperationCode::ImageLoad && code <= OperationCode::EndPrimitive) ||
+           code == OperationCode::MemoryBarrierGL;
+}
+
+/// Marks the registers read by a node as live. Returns false when the node has to be considered
+/// opaque, either because it leaves the block or because it executes amended code.
+bool MarkReads(const Node& node, RegisterSet& overwritten) {
+    if (!node) {
+        return true;
+    }
+    const auto mark = [&overwritten](const Node& child) { return MarkReads(child, overwritten); };
+    return std::visit(
+        [&](const auto& data) -> bool {
+            using T = std::decay_t<decltype(data)>;
+            if constexpr (std::is_same_v<T, GprNode>) {
+                // Temporaries live past the end of the register file and are never tracked
+                if (data.GetIndex() < NumRegisters) {
+                    overwritten[data.GetIndex()] = false;
+                }
+                return true;
+            } else if constexpr (std::is_same_v<T, OperationNode>) {
+                if (data.GetAmendIndex() || HasSideEffects(data.GetCode())) {
+                    return false;
+                }
+                for (std::size_t i = 0; i < data.GetOperandsCount(); ++i) {
+                    if (!mark(data[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            } else if constexpr (std::is_same_v<T, ConditionalNode>) {
+                if (data.GetAmendIndex() || !mark(data.GetCondition())) {
+                    return false;
+                }
+                for (const Node& child : data.GetCode()) {
+                    if (!mark(child)) {
+                        return false;
+                    }
+                }
+                return true;
+            } else if constexpr (std::is_same_v<T, AbufNode>) {
+                return mark(data.GetBuffer()) && mark(data.GetPhysicalAddress());
+            } else if constexpr (std::is_same_v<T, CbufNode>) {
+                return mark(data.GetOffset());
+            } else if constexpr (std::is_same_v<T, LmemNode> || std::is_same_v<T, SmemNode>) {
+                return mark(data.GetAddress());
+            } else if constexpr (std::is_same_v<T, GmemNode>) {
+                return mark(data.GetRealAddress()) && mark(data.GetBaseAddress());
+            } else {
+                return true;
+            }
+        },
+        *node);
+}
+
+bool IsOpaque(const Node& node) {
+    RegisterSet unused;
+    return !MarkReads(node, unused);
+}
+
+class Optimizer final {
+public:
+    explicit Optimizer(const CompilerSettings& settings) : settings{settings} {}
+
+    void Run(NodeBlock& block) const {
+        NodeBlock result;
+        result.reserve(block.size());
+        for (const Node& node : block) {
+            const auto conditional = std::get_if<ConditionalNode>(&*node);
+            if (!conditional || conditional->GetAmendIndex()) {
+                result.push_back(Fold(node));
+                continue;
+            }
+            Node condition = Fold(conditional->GetCondition());
+            const auto value = GetConstantPredicate(condition);
+            if (value && !*value) {
+                continue;
+            }
+            NodeBlock code = conditional->GetCode();
+            Run(code);
+            if (value) {
+                result.insert(result.end(), code.begin(), code.end());
+            } else {
+                result.push_back(MakeNode<ConditionalNode>(std::move(condition), std::move(code)));
+            }
+        }
+        if (settings.eliminate_dead_code) {
+            EliminateDeadWrites(result);
+        }
+        block = std::move(result);
+    }
+
+private:
+    /// Returns a simplified copy of a node, or the node itself when it can't be simplified
+    Node Fold(const Node& node) const {
+        const auto operation = std::get_if<OperationNode>(&*node);
+        if (!operation || operation->GetAmendIndex()) {
+            return node;
+        }
+        const OperationCode code = operation->GetCode();
+        const std::size_t num_operands = operation->GetOperandsCount();
+
+        bool changed = false;
+        std::vector<Node> operands;
+        operands.reserve(num_operands);
+        for (std::size_t i = 0; i < num_operands; ++i) {
+            const Node& operand = (*operation)[i];
+            Node folded = operand ? Fold(operand) : operand;
+            changed |= folded != operand;
+            operands.push_back(std::move(folded));
+        }
+
+        if (settings.fold_constants && num_operands > 0) {
+            std::vector<u32> values;
+            values.reserve(num_operands);
+            for (const Node& operand : operands) {
+                const auto value = operand ? GetImmediate(operand) : std::nullopt;
+                if (!value) {
+                    break;
+                }
+                values.push_back(*value);
+            }
+            if (values.size() == num_operands) {
+                if (const auto result = FoldIntegerOperation(code, values)) {
+                    return Immediate(*result);
+                }
+            }
+        }
+        if (settings.simplify_predicates && num_operands > 0) {
+            if (Node simplified = SimplifyPredicateOperation(code, operands)) {
+                return simplified;
+            }
+        }
+        if (!changed) {
+            return node;
+        }
+        return MakeNode<OperationNode>(code, operation->GetMeta(), std::move(operands));
+    }
+
+    /// Removes unconditional register writes that are overwritten later in the same block without
+    /// being read in between
+    static void EliminateDeadWrites(NodeBlock& block) {
+        RegisterSet overwritten;
+        std::vector<bool> is_dead(block.size());
+        for (std::size_t i = block.size(); i-- > 0;) {
+            const Node& node = block[i];
+            const auto operation = std::get_if<OperationNode>(&*node);
+            if (operation && operation->GetCode() == OperationCode::Assign &&
+                !operation->GetAmendIndex()) {
+                const auto gpr = std::get_if<GprNode>(&*(*operation)[0]);
+                if (gpr && gpr->GetIndex() < NumRegisters) {
+                    const u32 index = gpr->GetIndex();
+                    if (overwritten[index] && !IsOpaque((*operation)[1])) {
+                        is_dead[i] = true;
+                        continue;
+                    }
+                    overwritten[index] = true;
+                    if (!MarkReads((*operation)[1], overwritten)) {
+                        overwritten.reset();
+                    }
+                    continue;
+                }
+            }
+            if (!MarkReads(node, overwritten)) {
+                overwritten.reset();
+            }
+        }
+
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < block.size(); ++i) {
+            if (!is_dead[i]) {
+                block[next++] = std::move(block[i]);
+            }
+        }
+        block.resize(next);
+    }
+
+    const CompilerSettings& settings;
+};
+
+} // Anonymous namespace
+
+void ShaderIR::OptimizeBlock(NodeBlock& block) const {
+    if (!settings.fold_constants && !settings.simplify_predicates &&
+        !settings.eliminate_dead_code) {
+        return;
+    }
+    Optimizer{settings}.Run(block);
+}
+
+} // namespace VideoCommon::Shader
@@ -8,9 +8,10 @@
 #include <list>
 #include <map>
 #include <optional>
-#include <set>
 #include <tuple>
 #include <vector>
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
 
 #include "common/common_types.h"
 #include "video_core/engines/maxwell_3d.h"
@@ -64,6 +65,8 @@ private:
 struct GlobalMemoryUsage {
     bool is_read{};
     bool is_written{};
+    bool is_bounded{true}; ///< Every access is at a constant offset from the base address
+    u32 bound_size{};      ///< Bytes from the base address that bounded accesses touch
 };
 
 class ShaderIR final {
@@ -76,23 +79,24 @@ public:
         return basic_blocks;
     }
 
-    const std::set<u32>& GetRegisters() const {
+    const boost::container::flat_set<u32>& GetRegisters() const {
         return used_registers;
     }
 
-    const std::set<Tegra::Shader::Pred>& GetPredicates() const {
+    const boost::container::flat_set<Tegra::Shader::Pred>& GetPredicates() const {
         return used_predicates;
     }
 
-    const std::set<Tegra::Shader::Attribute::Index>& GetInputAttributes() const {
+    const boost::container::flat_set<Tegra::Shader::Attribute::Index>& GetInputAttributes() const {
         return used_input_attributes;
     }
 
-    const std::set<Tegra::Shader::Attribute::Index>& GetOutputAttributes() const {
+    const boost::container::flat_set<Tegra::Shader::Attribute::Index>& GetOutputAttributes()
+        const {
         return used_output_attributes;
     }
 
-    const std::map<u32, ConstBuffer>& GetConstantBuffers() const {
+    const boost::container::flat_map<u32, ConstBuffer>& GetConstantBuffers() const {
         return used_cbufs;
     }
 
@@ -201,6 +205,12 @@ private:
     void DecodeRangeInner(NodeBlock& bb, u32 begin, u32 end);
     void InsertControlFlow(NodeBlock& bb, const ShaderBlock& block);
 
+    /// Appends a node to the global code, indexing the register it assigns for tracking
+    void PushGlobalCode(Node node);
+
+    /// Runs the optimization passes enabled in the compiler settings over a decoded block
+    void OptimizeBlock(NodeBlock& block) const;
+
     /**
      * Decodes a single instruction from Tegra to IR.
      * @param bb Basic block where the nodes will be written to.
@@ -399,12 +409,18 @@ private:
 
     std::optional<u32> TrackImmediate(Node tracked, const NodeBlock& code, s64 cursor) const;
 
+    /// Tracks a value built by adding immediates to a const buffer read, returning the sum of the
+    /// immediates.
+    std::optional<s64> TrackCbufDisplacement(Node tracked, const NodeBlock& code,
+                                             s64 cursor) const;
+
     std::pair<Node, s64> TrackRegister(const GprNode* tracked, const NodeBlock& code,
                                        s64 cursor) const;
 
     std::tuple<Node, Node, GlobalMemoryBase> TrackGlobalMemory(NodeBlock& bb,
                                                                Tegra::Shader::Instruction instr,
-                                                               bool is_read, bool is_write);
+                                                               bool is_read, bool is_write,
+                                                               u32 access_size);
 
     /// Register new amending code and obtain the reference id.
     std::size_t DeclareAmend(Node new_amend);
@@ -424,15 +440,19 @@ private:
 
     std::map<u32, NodeBlock> basic_blocks;
     NodeBlock global_code;
+    /// Register assignments found in global code, in decode order and indexed by register
+    /// (temporaries included), so tracking a register is a lookup instead of a backward scan
+    std::vector<std::vector<std::pair<s64, Node>>> global_code_assigns;
     ASTManager program_manager{true, true};
     std::vector<Node> amend_code;
     u32 num_custom_variables{};
 
-    std::set<u32> used_registers;
-    std::set<Tegra::Shader::Pred> used_predicates;
-    std::set<Tegra::Shader::Attribute::Index> used_input_attributes;
-    std::set<Tegra::Shader::Attribute::Index> used_output_attributes;
-    std::map<u32, ConstBuffer> used_cbufs;
+    // Registries are queried on every operand decode, keep them in sorted contiguous storage
+    boost::container::flat_set<u32> used_registers;
+    boost::container::flat_set<Tegra::Shader::Pred> used_predicates;
+    boost::container::flat_set<Tegra::Shader::Attribute::Index> used_input_attributes;
+    boost::container::flat_set<Tegra::Shader::Attribute::Index> used_output_attributes;
+    boost::container::flat_map<u32, ConstBuffer> used_cbufs;
     std::list<Sampler> used_samplers;
     std::list<Image> used_images;
     std::array<bool, Tegra::Engines::Maxwell3D::Regs::NumClipDistances> used_clip_distances{};
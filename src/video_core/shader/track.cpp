@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
 #include <variant>
 
@@ -37,6 +38,22 @@ std::pair<Node, s64> FindOperation(const NodeBlock& code, s64 cursor,
     return {};
 }
 
+/// Returns the last assignment executed by a node, looking into conditionals like FindOperation
+Node FindLastAssign(const Node& node) {
+    if (const auto operation = std::get_if<OperationNode>(&*node)) {
+        return operation->GetCode() == OperationCode::Assign ? node : nullptr;
+    }
+    if (const auto conditional = std::get_if<ConditionalNode>(&*node)) {
+        const auto& conditional_code = conditional->GetCode();
+        for (auto it = conditional_code.rbegin(); it != conditional_code.rend(); ++it) {
+            if (Node found = FindLastAssign(*it)) {
+                return found;
+            }
+        }
+    }
+    return nullptr;
+}
+
 std::optional<std::pair<Node, Node>> DecoupleIndirectRead(const OperationNode& operation) {
     if (operation.GetCode() != OperationCode::UAdd) {
         return std::nullopt;
@@ -181,6 +198,46 @@ std::tuple<Node, u32, u32> ShaderIR::TrackCbuf(Node tracked, const NodeBlock& co
     return {};
 }
 
+std::optional<s64> ShaderIR::TrackCbufDisplacement(Node tracked, const NodeBlock& code,
+                                                   s64 cursor) const {
+    if (std::holds_alternative<CbufNode>(*tracked)) {
+        return 0;
+    }
+    if (const auto gpr = std::get_if<GprNode>(&*tracked)) {
+        if (gpr->GetIndex() == Tegra::Shader::Register::ZeroIndex) {
+            return {};
+        }
+        const auto [source, new_cursor] = TrackRegister(gpr, code, cursor - 1);
+        if (!source) {
+            return {};
+        }
+        return TrackCbufDisplacement(source, code, new_cursor);
+    }
+    if (const auto operation = std::get_if<OperationNode>(&*tracked)) {
+        const OperationCode operation_code = operation->GetCode();
+        if ((operation_code != OperationCode::IAdd && operation_code != OperationCode::UAdd) ||
+            operation->GetOperandsCount() != 2) {
+            return {};
+        }
+        for (std::size_t i = 0; i < 2; ++i) {
+            const auto immediate = std::get_if<ImmediateNode>(&*(*operation)[i]);
+            if (!immediate) {
+                continue;
+            }
+            const auto displacement = TrackCbufDisplacement((*operation)[1 - i], code, cursor);
+            if (!displacement) {
+                return {};
+            }
+            const u32 value = immediate->GetValue();
+            return *displacement + (operation_code == OperationCode::IAdd
+                                        ? static_cast<s64>(static_cast<s32>(value))
+                                        : static_cast<s64>(value));
+        }
+        return {};
+    }
+    return {};
+}
+
 std::optional<u32> ShaderIR::TrackImmediate(Node tracked, const NodeBlock& code, s64 cursor) const {
     // Reduce the cursor in one to avoid infinite loops when the instruction sets the same register
     // that it uses as operand
@@ -195,8 +252,39 @@ std::optional<u32> ShaderIR::TrackImmediate(Node tracked, const NodeBlock& code,
     return {};
 }
 
+void ShaderIR::PushGlobalCode(Node node) {
+    const auto cursor = static_cast<s64>(global_code.size());
+    if (const Node assign = FindLastAssign(node)) {
+        const auto& operation = std::get<OperationNode>(*assign);
+        if (const auto gpr = std::get_if<GprNode>(&*operation[0])) {
+            const std::size_t index = gpr->GetIndex();
+            if (index >= global_code_assigns.size()) {
+                global_code_assigns.resize(index + 1);
+            }
+            global_code_assigns[index].emplace_back(cursor, operation[1]);
+        }
+    }
+    global_code.push_back(std::move(node));
+}
+
 std::pair<Node, s64> ShaderIR::TrackRegister(const GprNode* tracked, const NodeBlock& code,
                                              s64 cursor) const {
+    if (&code == &global_code) {
+        // Global code is indexed while it's decoded, find the last assignment up to the cursor
+        const std::size_t index = tracked->GetIndex();
+        if (index >= global_code_assigns.size()) {
+            return {};
+        }
+        const auto& assigns = global_code_assigns[index];
+        const auto it =
+            std::upper_bound(assigns.begin(), assigns.end(), cursor,
+                             [](s64 value, const auto& assign) { return value < assign.first; });
+        if (it == assigns.begin()) {
+            return {};
+        }
+        const auto& [found_cursor, value] = *std::prev(it);
+        return {value, found_cursor};
+    }
     for (; cursor >= 0; --cursor) {
         const auto [found_node, new_cursor] = FindOperation(code, cursor, OperationCode::Assign);
         if (!found_node) {
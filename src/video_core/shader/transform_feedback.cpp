@@ -0,0 +1,100 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/assert.h"
+#include "common/cityhash.h"
+#include "video_core/engines/shader_bytecode.h"
+#include "video_core/shader/transform_feedback.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+using Tegra::Shader::Attribute;
+
+/// Returns true when the attribute offset in words belongs to an attribute captured as a vector
+bool IsVectorAttribute(u8 location) {
+    const auto index = static_cast<Attribute::Index>(location / 4);
+    return index == Attribute::Index::Position ||
+           (index >= Attribute::Index::Attribute_0 && index <= Attribute::Index::Attribute_31);
+}
+
+} // Anonymous namespace
+
+TransformFeedbackState TransformFeedbackState::FromRegs(const Maxwell& regs) {
+    TransformFeedbackState state;
+    if (regs.tfb_enabled == 0) {
+        return state;
+    }
+    for (std::size_t buffer = 0; buffer < Maxwell::NumTransformFeedbackBuffers; ++buffer) {
+        const auto& layout = regs.tfb_layouts[buffer];
+        const u32 varying_count =
+            std::min<u32>(layout.varying_count, static_cast<u32>(MaxTransformFeedbackVaryings));
+        state.layouts[buffer] = {layout.stream, varying_count, layout.stride};
+
+        const auto& locations = regs.tfb_varying_locs[buffer];
+        std::copy_n(locations.begin(), varying_count, state.varyings[buffer].begin());
+    }
+    return state;
+}
+
+bool TransformFeedbackState::IsEnabled() const noexcept {
+    return std::any_of(layouts.begin(), layouts.end(),
+                       [](const Layout& layout) { return layout.varying_count != 0; });
+}
+
+std::size_t TransformFeedbackState::Hash() const noexcept {
+    if (!IsEnabled()) {
+        return 0;
+    }
+    return static_cast<std::size_t>(
+        Common::CityHash64(reinterpret_cast<const char*>(this), sizeof(*this)));
+}
+
+bool TransformFeedbackState::operator==(const TransformFeedbackState& rhs) const noexcept {
+    return std::memcmp(this, &rhs, sizeof(*this)) == 0;
+}
+
+std::unordered_map<u8, VaryingTFB> BuildTransformFeedback(const TransformFeedbackState& state) {
+    std::unordered_map<u8, VaryingTFB> tfb;
+    for (std::size_t buffer = 0; buffer < state.layouts.size(); ++buffer) {
+        const auto& layout = state.layouts[buffer];
+        const auto& locations = state.varyings[buffer];
+        if (layout.varying_count == 0) {
+            continue;
+        }
+        UNIMPLEMENTED_IF_MSG(layout.stream != 0, "Unimplemented stream={} on buffer {}",
+                             layout.stream, buffer);
+
+        std::size_t highest = 0;
+        for (std::size_t offset = 0; offset < layout.varying_count; ++offset) {
+            const std::size_t base_offset = offset;
+            const u8 location = locations[offset];
+
+            VaryingTFB varying{buffer, layout.stride, offset * sizeof(u32), 1};
+            if (IsVectorAttribute(location)) {
+                // Join the following components of the same attribute
+                while (offset + 1 < layout.varying_count &&
+                       locations[offset + 1] / 4 == location / 4 &&
+                       locations[offset + 1] == location + varying.components) {
+                    ++offset;
+                    ++varying.components;
+                }
+            }
+
+            [[maybe_unused]] const bool inserted = tfb.emplace(location, varying).second;
+            UNIMPLEMENTED_IF_MSG(!inserted, "Location {} is captured more than once", location);
+
+            highest = std::max(highest, (base_offset + varying.components) * sizeof(u32));
+        }
+        UNIMPLEMENTED_IF_MSG(highest > layout.stride, "Varyings of buffer {} overflow its stride",
+                             buffer);
+    }
+    return tfb;
+}
+
+} // namespace VideoCommon::Shader
@@ -0,0 +1,69 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <unordered_map>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+
+namespace VideoCommon::Shader {
+
+/// Number of varyings each transform feedback buffer can capture
+constexpr std::size_t MaxTransformFeedbackVaryings = 128;
+
+/**
+ * Varyings the last vertex processing stage has to capture, as the guest describes them. Programs
+ * are specialized on it, so the varyings past the count of each layout are kept zeroed to make
+ * equal states compare and hash the same.
+ */
+struct TransformFeedbackState {
+    using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+    struct Layout {
+        u32 stream;
+        u32 varying_count;
+        u32 stride;
+    };
+
+    std::array<Layout, Maxwell::NumTransformFeedbackBuffers> layouts{};
+    std::array<std::array<u8, MaxTransformFeedbackVaryings>, Maxwell::NumTransformFeedbackBuffers>
+        varyings{};
+
+    /// Reads the state from registers, an empty state is returned when transform feedback is off
+    static TransformFeedbackState FromRegs(const Maxwell& regs);
+
+    /// Returns true when any varying is captured
+    bool IsEnabled() const noexcept;
+
+    std::size_t Hash() const noexcept;
+
+    bool operator==(const TransformFeedbackState& rhs) const noexcept;
+
+    bool operator!=(const TransformFeedbackState& rhs) const noexcept {
+        return !operator==(rhs);
+    }
+};
+static_assert(std::is_trivially_copyable_v<TransformFeedbackState>);
+
+/// Describes where a captured varying is written
+struct VaryingTFB {
+    std::size_t buffer;     ///< Transform feedback buffer index
+    std::size_t stride;     ///< Bytes between the vertices of the buffer
+    std::size_t offset;     ///< Offset in bytes of the varying inside a vertex
+    std::size_t components; ///< Number of consecutive components captured
+};
+
+/**
+ * Returns the captured varyings, keyed by the attribute offset in words of their first component
+ * (the attribute index times four plus the component). The components of position and generic
+ * attributes captured next to each other are joined in a single varying.
+ */
+std::unordered_map<u8, VaryingTFB> BuildTransformFeedback(const TransformFeedbackState& state);
+
+} // namespace VideoCommon::Shader
@@ -259,6 +259,24 @@ bool IsPixelFormatSRGB(PixelFormat format) {
     }
 }
 
+bool IsPixelFormatInteger(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::ABGR8UI:
+    case PixelFormat::R8UI:
+    case PixelFormat::RGBA16UI:
+    case PixelFormat::RGBA32UI:
+    case PixelFormat::R16UI:
+    case PixelFormat::R16I:
+    case PixelFormat::RG16UI:
+    case PixelFormat::RG16I:
+    case PixelFormat::RG32UI:
+    case PixelFormat::R32UI:
+        return true;
+    default:
+        return false;
+    }
+}
+
 std::pair<u32, u32> GetASTCBlockSize(PixelFormat format) {
     return {GetDefaultBlockWidth(format), GetDefaultBlockHeight(format)};
 }
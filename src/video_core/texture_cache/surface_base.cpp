@@ -2,9 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+
 #include "common/algorithm.h"
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/microprofile.h"
 #include "video_core/memory_manager.h"
 #include "video_core/texture_cache/surface_base.h"
@@ -24,6 +29,35 @@ StagingCache::StagingCache() = default;
 
 StagingCache::~StagingCache() = default;
 
+bool StagingCache::LoadConverted(u64 key, std::vector<u8>& buffer) {
+    const auto it = converted_lookup.find(key);
+    if (it == converted_lookup.end()) {
+        return false;
+    }
+    const std::vector<u8>& data = it->second->second;
+    if (data.size() != buffer.size()) {
+        return false;
+    }
+    std::memcpy(buffer.data(), data.data(), data.size());
+    converted.splice(converted.begin(), converted, it->second);
+    return true;
+}
+
+void StagingCache::StoreConverted(u64 key, const std::vector<u8>& buffer) {
+    if (buffer.size() > ConvertedBudget || converted_lookup.count(key) != 0) {
+        return;
+    }
+    while (converted_size + buffer.size() > ConvertedBudget) {
+        const auto& [oldest_key, oldest_data] = converted.back();
+        converted_size -= oldest_data.size();
+        converted_lookup.erase(oldest_key);
+        converted.pop_back();
+    }
+    converted.emplace_front(key, buffer);
+    converted_lookup.emplace(key, converted.begin());
+    converted_size += buffer.size();
+}
+
 SurfaceBaseImpl::SurfaceBaseImpl(GPUVAddr gpu_addr, const SurfaceParams& params)
     : params{params}, host_memory_size{params.GetHostSizeInBytes()}, gpu_addr{gpu_addr},
       mipmap_sizes(params.num_levels), mipmap_offsets(params.num_levels) {
@@ -44,6 +78,119 @@ SurfaceBaseImpl::SurfaceBaseImpl(GPUVAddr gpu_addr, const SurfaceParams& params)
     } else {
         guest_memory_size = layer_size;
     }
+    BuildBands();
+}
+
+void SurfaceBaseImpl::BuildBands() {
+    // Only large surfaces whose guest texels are uploaded as they are can be reloaded in parts
+    constexpr std::size_t min_size = 1ULL << 20;
+    constexpr std::size_t linear_band_size = 64 * 1024;
+    const auto compression_type = params.GetCompressionType();
+    if (guest_memory_size < min_size || params.IsBuffer() ||
+        params.type == VideoCore::Surface::SurfaceType::DepthStencil ||
+        (params.target != SurfaceTarget::Texture2D &&
+         params.target != SurfaceTarget::Texture2DArray) ||
+        (compression_type != SurfaceCompression::None &&
+         compression_type != SurfaceCompression::Compressed)) {
+        return;
+    }
+    const u32 bpp = params.GetBytesPerPixel();
+    const u32 tile_width = params.GetDefaultBlockWidth();
+    const u32 tile_height = params.GetDefaultBlockHeight();
+
+    if (!params.is_tiled) {
+        const u32 width = (params.width + tile_width - 1) / tile_width;
+        const u32 rows = (params.height + tile_height - 1) / tile_height;
+        const std::size_t row_size = static_cast<std::size_t>(width) * bpp;
+        if (params.num_levels != 1 || params.is_layered || params.pitch < row_size) {
+            return;
+        }
+        const u32 band_rows = std::max<u32>(1, linear_band_size / params.pitch);
+        for (u32 row = 0; row < rows; row += band_rows) {
+            const u32 num_rows = std::min(band_rows, rows - row);
+            const u32 y = row * tile_height;
+            bands.push_back({0, 0, y, std::min(num_rows * tile_height, params.height - y),
+                             row * params.pitch, num_rows * params.pitch, row * row_size,
+                             num_rows * row_size});
+        }
+        return;
+    }
+
+    if (params.block_width != 0 || params.block_depth != 0 || params.tile_width_spacing != 0) {
+        return;
+    }
+    // Each band is a row of blocks, the guest stores them one after the other
+    constexpr u32 gob_width = 64;
+    constexpr u32 gob_height = 8;
+    const u32 num_layers = params.is_layered ? params.depth : 1;
+    for (u32 level = 0; level < params.num_levels; ++level) {
+        const u32 mip_height = params.GetMipHeight(level);
+        const u32 width = (params.GetMipWidth(level) + tile_width - 1) / tile_width;
+        const u32 rows = (mip_height + tile_height - 1) / tile_height;
+        const u32 band_rows = gob_height << params.GetMipBlockHeight(level);
+        const u32 num_bands = (rows + band_rows - 1) / band_rows;
+        const std::size_t host_row_size = static_cast<std::size_t>(width) * bpp;
+        const std::size_t band_size = Common::AlignUp(host_row_size, gob_width) * band_rows;
+        if (band_size * num_bands != mipmap_sizes[level] ||
+            host_row_size * rows != params.GetHostLayerSize(level)) {
+            // Layouts this doesn't understand are always reloaded as a whole
+            bands.clear();
+            return;
+        }
+        const std::size_t host_level_offset = params.GetHostMipmapLevelOffset(level);
+        for (u32 layer = 0; layer < num_layers; ++layer) {
+            for (u32 band = 0; band < num_bands; ++band) {
+                const u32 row = band * band_rows;
+                const u32 num_rows = std::min(band_rows, rows - row);
+                const u32 y = row * tile_height;
+                bands.push_back({level, layer, y, std::min(num_rows * tile_height, mip_height - y),
+                                 layer * layer_size + mipmap_offsets[level] + band * band_size,
+                                 band_size,
+                                 host_level_offset + layer * params.GetHostLayerSize(level) +
+                                     row * host_row_size,
+                                 num_rows * host_row_size});
+            }
+        }
+    }
+}
+
+void SurfaceBaseImpl::HashBands(const u8* guest_data) {
+    band_hashes.resize(bands.size());
+    for (std::size_t i = 0; i < bands.size(); ++i) {
+        const SurfaceBand& band = bands[i];
+        band_hashes[i] = Common::HashValue(guest_data + band.guest_offset, band.guest_size);
+    }
+}
+
+std::vector<std::size_t> SurfaceBaseImpl::FindChangedBands(const u8* guest_data) {
+    std::vector<std::size_t> changed;
+    for (std::size_t i = 0; i < bands.size(); ++i) {
+        const SurfaceBand& band = bands[i];
+        const u64 hash = Common::HashValue(guest_data + band.guest_offset, band.guest_size);
+        if (hash != band_hashes[i]) {
+            band_hashes[i] = hash;
+            changed.push_back(i);
+        }
+    }
+    return changed;
+}
+
+void SurfaceBaseImpl::LoadBand(const u8* guest_data, std::vector<u8>& staging_buffer,
+                               const SurfaceBand& band) const {
+    staging_buffer.resize(band.host_size);
+    u8* const guest_ptr = const_cast<u8*>(guest_data) + band.guest_offset;
+    if (params.is_tiled) {
+        MortonSwizzle(MortonSwizzleMode::MortonToLinear, params.pixel_format,
+                      params.GetMipWidth(band.level), params.GetMipBlockHeight(band.level),
+                      band.height, 0, 1, 0, staging_buffer.data(), guest_ptr);
+        return;
+    }
+    const std::size_t num_rows = band.guest_size / params.pitch;
+    const std::size_t row_size = band.host_size / num_rows;
+    for (std::size_t row = 0; row < num_rows; ++row) {
+        std::memcpy(staging_buffer.data() + row * row_size, guest_ptr + row * params.pitch,
+                    row_size);
+    }
 }
 
 MatchTopologyResult SurfaceBaseImpl::MatchesTopology(const SurfaceParams& rhs) const {
@@ -180,26 +327,49 @@ void SurfaceBaseImpl::SwizzleFunc(MortonSwizzleMode mode, u8* memory, const Surf
     }
 }
 
-void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
-                                 StagingCache& staging_cache) {
-    MICROPROFILE_SCOPE(GPU_Load_Texture);
-    auto& staging_buffer = staging_cache.GetBuffer(0);
-    u8* host_ptr;
+u8* SurfaceBaseImpl::GetGuestData(Tegra::MemoryManager& memory_manager,
+                                  StagingCache& staging_cache) {
     is_continuous = memory_manager.IsBlockContinuous(gpu_addr, guest_memory_size);
 
     // Handle continuouty
     if (is_continuous) {
         // Use physical memory directly
-        host_ptr = memory_manager.GetPointer(gpu_addr);
-        if (!host_ptr) {
+        return memory_manager.GetPointer(gpu_addr);
+    }
+
+    // Use an extra temporal buffer
+    auto& tmp_buffer = staging_cache.GetBuffer(1);
+    tmp_buffer.resize(guest_memory_size);
+    memory_manager.ReadBlockUnsafe(gpu_addr, tmp_buffer.data(), guest_memory_size);
+    return tmp_buffer.data();
+}
+
+void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
+                                 StagingCache& staging_cache) {
+    MICROPROFILE_SCOPE(GPU_Load_Texture);
+    auto& staging_buffer = staging_cache.GetBuffer(0);
+    u8* const host_ptr = GetGuestData(memory_manager, staging_cache);
+    if (!host_ptr) {
+        return;
+    }
+
+    // Decoding converted formats (ASTC) is expensive, reuse the result of previous loads of the
+    // same guest data
+    const auto compression_type = params.GetCompressionType();
+    u64 converted_key = 0;
+    if (compression_type == SurfaceCompression::Converted) {
+        converted_key = Common::HashValue(host_ptr, guest_memory_size, params.Hash());
+        if (staging_cache.LoadConverted(converted_key, staging_buffer)) {
             return;
         }
-    } else {
-        // Use an extra temporal buffer
-        auto& tmp_buffer = staging_cache.GetBuffer(1);
-        tmp_buffer.resize(guest_memory_size);
-        host_ptr = tmp_buffer.data();
-        memory_manager.ReadBlockUnsafe(gpu_addr, host_ptr, guest_memory_size);
+    }
+
+    // Converted formats are decoded straight into the staging buffer, so their guest texels are
+    // laid out in a separate buffer first
+    const bool is_converted = compression_type == SurfaceCompression::Converted;
+    auto& unswizzled_buffer = is_converted ? staging_cache.GetBuffer(2) : staging_buffer;
+    if (is_converted) {
+        unswizzled_buffer.resize(params.GetUnconvertedSizeInBytes());
     }
 
     if (params.is_tiled) {
@@ -208,7 +378,7 @@ void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
         for (u32 level = 0; level < params.num_levels; ++level) {
             const std::size_t host_offset{params.GetHostMipmapLevelOffset(level)};
             SwizzleFunc(MortonSwizzleMode::MortonToLinear, host_ptr, params,
-                        staging_buffer.data() + host_offset, level);
+                        unswizzled_buffer.data() + host_offset, level);
         }
     } else {
         ASSERT_MSG(params.num_levels == 1, "Linear mipmap loading is not implemented");
@@ -218,11 +388,16 @@ void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
         const u32 width{(params.width + block_width - 1) / block_width};
         const u32 height{(params.height + block_height - 1) / block_height};
         const u32 copy_size{width * bpp};
-        if (params.pitch == copy_size) {
-            std::memcpy(staging_buffer.data(), host_ptr, params.GetHostSizeInBytes());
+        if (params.pitch == copy_size && compression_type == SurfaceCompression::Rearranged) {
+            // Rearrange the texels while copying them instead of in another pass
+            ConvertFromGuestToHost(host_ptr, staging_buffer.data(), params.pixel_format,
+                                   params.width, params.height, 1, true, true);
+            return;
+        } else if (params.pitch == copy_size) {
+            std::memcpy(unswizzled_buffer.data(), host_ptr, params.GetUnconvertedSizeInBytes());
         } else {
             const u8* start{host_ptr};
-            u8* write_to{staging_buffer.data()};
+            u8* write_to{unswizzled_buffer.data()};
             for (u32 h = height; h > 0; --h) {
                 std::memcpy(write_to, start, copy_size);
                 start += params.pitch;
@@ -231,7 +406,6 @@ void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
         }
     }
 
-    auto compression_type = params.GetCompressionType();
     if (compression_type == SurfaceCompression::None ||
         compression_type == SurfaceCompression::Compressed)
         return;
@@ -242,12 +416,15 @@ void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
         const std::size_t out_host_offset = compression_type == SurfaceCompression::Rearranged
                                                 ? in_host_offset
                                                 : params.GetConvertedMipmapOffset(level);
-        u8* in_buffer = staging_buffer.data() + in_host_offset;
+        u8* in_buffer = unswizzled_buffer.data() + in_host_offset;
         u8* out_buffer = staging_buffer.data() + out_host_offset;
         ConvertFromGuestToHost(in_buffer, out_buffer, params.pixel_format,
                                params.GetMipWidth(level), params.GetMipHeight(level),
                                params.GetMipDepth(level), true, true);
     }
+    if (is_converted) {
+        staging_cache.StoreConverted(converted_key, staging_buffer);
+    }
 }
 
 void SurfaceBaseImpl::FlushBuffer(Tegra::MemoryManager& memory_manager,
@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <list>
 #include <optional>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/common_types.h"
@@ -54,12 +56,46 @@ public:
         staging_buffer.resize(size);
     }
 
+    /// Copies the host data of a previous conversion with the same key into the buffer. Returns
+    /// false when there is no such conversion.
+    bool LoadConverted(u64 key, std::vector<u8>& buffer);
+
+    /// Remembers the host data of a conversion, evicting the least recently used ones when the
+    /// cache grows over budget.
+    void StoreConverted(u64 key, const std::vector<u8>& buffer);
+
 private:
+    using ConvertedList = std::list<std::pair<u64, std::vector<u8>>>;
+
+    /// Largest amount of converted host data kept around, in bytes.
+    static constexpr std::size_t ConvertedBudget = 256 * 1024 * 1024;
+
     std::vector<std::vector<u8>> staging_buffer;
+
+    ConvertedList converted; ///< Most recently used first
+    std::unordered_map<u64, ConvertedList::iterator> converted_lookup;
+    std::size_t converted_size = 0;
+};
+
+/// Horizontal slice of a mipmap level and layer that can be reloaded on its own. For tiled
+/// surfaces it's a row of blocks, for linear ones a group of rows.
+struct SurfaceBand {
+    u32 level;
+    u32 layer;
+    u32 y;      ///< First texel row, in pixels
+    u32 height; ///< Number of texel rows, in pixels
+    std::size_t guest_offset;
+    std::size_t guest_size;
+    std::size_t host_offset;
+    std::size_t host_size;
 };
 
 class SurfaceBaseImpl {
 public:
+    /// Returns the guest memory backing the surface, gathered into a staging buffer when it is not
+    /// contiguous. Returns nullptr when the surface is not mapped.
+    u8* GetGuestData(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
+
     void LoadBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
 
     void FlushBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
@@ -155,10 +191,34 @@ public:
 
     std::optional<std::pair<u32, u32>> GetLayerMipmap(const GPUVAddr candidate_gpu_addr) const;
 
+    GPUVAddr GetLayerMipmapAddress(u32 layer, u32 level) const {
+        return gpu_addr + layer * layer_size + mipmap_offsets[level];
+    }
+
     std::vector<CopyParams> BreakDown(const SurfaceParams& in_params) const {
         return params.is_layered ? BreakDownLayered(in_params) : BreakDownNonLayered(in_params);
     }
 
+    const std::vector<SurfaceBand>& GetBands() const {
+        return bands;
+    }
+
+    /// Returns true when the guest contents of each band have been hashed since the last load.
+    bool HasBandHashes() const {
+        return !bands.empty() && band_hashes.size() == bands.size();
+    }
+
+    /// Remembers the hash of each band of the given guest data.
+    void HashBands(const u8* guest_data);
+
+    /// Returns the indices of the bands whose guest data hashes differently than when they were
+    /// last hashed, updating their hashes.
+    std::vector<std::size_t> FindChangedBands(const u8* guest_data);
+
+    /// Writes the host texels of a band into the staging buffer.
+    void LoadBand(const u8* guest_data, std::vector<u8>& staging_buffer,
+                  const SurfaceBand& band) const;
+
 protected:
     explicit SurfaceBaseImpl(GPUVAddr gpu_addr, const SurfaceParams& params);
     ~SurfaceBaseImpl() = default;
@@ -178,7 +238,12 @@ protected:
     std::vector<std::size_t> mipmap_sizes;
     std::vector<std::size_t> mipmap_offsets;
 
+    std::vector<SurfaceBand> bands;
+    std::vector<u64> band_hashes;
+
 private:
+    void BuildBands();
+
     void SwizzleFunc(MortonSwizzleMode mode, u8* memory, const SurfaceParams& params, u8* buffer,
                      u32 level);
 
@@ -194,9 +259,42 @@ public:
 
     virtual void DownloadTexture(std::vector<u8>& staging_buffer) = 0;
 
+    /// Uploads the host texels of a single band, laid out from the start of the staging buffer.
+    virtual void UploadBand(const std::vector<u8>& staging_buffer, const SurfaceBand& band) = 0;
+
+    /// Marks a change in the host contents of the surface, it forgets the hashed guest contents.
     void MarkAsModified(bool is_modified_, u64 tick) {
         is_modified = is_modified_ || is_target;
         modification_tick = tick;
+        has_content_hash = false;
+        band_hashes.clear();
+    }
+
+    /// Marks the guest memory of the surface as written since its bands were hashed. Dirty
+    /// surfaces stay registered until their changed bands are reloaded.
+    void MarkAsDirty(bool is_dirty_) {
+        is_dirty = is_dirty_;
+    }
+
+    bool IsDirty() const {
+        return is_dirty;
+    }
+
+    /// Remembers the hash of the guest memory the host contents were just loaded from.
+    void SetContentHash(u64 hash) {
+        content_hash = hash;
+        content_hash_addr = gpu_addr;
+        has_content_hash = true;
+    }
+
+    void ClearContentHash() {
+        has_content_hash = false;
+    }
+
+    /// Returns true when the host contents were loaded from guest memory with the given hash at
+    /// the current address and haven't changed since.
+    bool MatchesContentHash(u64 hash) const {
+        return has_content_hash && content_hash_addr == gpu_addr && content_hash == hash;
     }
 
     void MarkAsRenderTarget(bool is_target_, u32 index_) {
@@ -204,10 +302,6 @@ public:
         index = index_;
     }
 
-    void MarkAsPicked(bool is_picked_) {
-        is_picked = is_picked_;
-    }
-
     bool IsModified() const {
         return is_modified;
     }
@@ -229,10 +323,6 @@ public:
         return is_registered;
     }
 
-    bool IsPicked() const {
-        return is_picked;
-    }
-
     void MarkAsRegistered(bool is_reg) {
         is_registered = is_reg;
     }
@@ -241,6 +331,14 @@ public:
         return modification_tick;
     }
 
+    void MarkAsUsed(u64 tick) {
+        last_use_tick = tick;
+    }
+
+    u64 GetLastUseTick() const {
+        return last_use_tick;
+    }
+
     TView EmplaceOverview(const SurfaceParams& overview_params) {
         const u32 num_layers{(params.is_layered && !overview_params.is_layered) ? 1 : params.depth};
         return GetView(ViewParams(overview_params.target, 0, num_layers, 0, params.num_levels));
@@ -313,9 +411,13 @@ private:
     bool is_modified{};
     bool is_target{};
     bool is_registered{};
-    bool is_picked{};
+    bool is_dirty{};
     u32 index{NO_RT};
     u64 modification_tick{};
+    u64 last_use_tick{};
+    bool has_content_hash{};
+    u64 content_hash{};
+    GPUVAddr content_hash_addr{};
 };
 
 } // namespace VideoCommon
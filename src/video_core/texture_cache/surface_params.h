@@ -8,8 +8,8 @@
 
 #include "common/alignment.h"
 #include "common/bit_util.h"
-#include "common/cityhash.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/shader/shader_ir.h"
@@ -56,8 +56,7 @@ public:
         const VideoCommon::Shader::Image& entry);
 
     std::size_t Hash() const {
-        return static_cast<std::size_t>(
-            Common::CityHash64(reinterpret_cast<const char*>(this), sizeof(*this)));
+        return static_cast<std::size_t>(Common::HashValue(this, sizeof(*this)));
     }
 
     bool operator==(const SurfaceParams& rhs) const;
@@ -84,6 +83,11 @@ public:
         return host_size_in_bytes;
     }
 
+    /// Returns the size of the surface in host memory before it's converted to its host format.
+    std::size_t GetUnconvertedSizeInBytes() const {
+        return GetInnerMemorySize(true, false, false);
+    }
+
     u32 GetBlockAlignedWidth() const {
         return Common::AlignUp(width, 64 / GetBytesPerPixel());
     }
@@ -6,26 +6,32 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
-#include <boost/icl/interval_map.hpp>
-#include <boost/range/iterator_range.hpp>
-
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/math_util.h"
 #include "core/core.h"
+#include "core/frame_timeline.h"
 #include "core/memory.h"
 #include "core/settings.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/engines/maxwell_3d.h"
+#include "video_core/fence_manager.h"
 #include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
+#include "video_core/page_registry.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/surface.h"
 #include "video_core/texture_cache/copy_params.h"
@@ -47,18 +53,30 @@ namespace VideoCommon {
 using VideoCore::Surface::PixelFormat;
 
 using VideoCore::Surface::SurfaceTarget;
+using VideoCore::Surface::SurfaceType;
 using RenderTargetConfig = Tegra::Engines::Maxwell3D::Regs::RenderTargetConfig;
 
 template <typename TSurface, typename TView>
 class TextureCache {
-    using IntervalMap = boost::icl::interval_map<CacheAddr, std::set<TSurface>>;
-    using IntervalType = typename IntervalMap::interval_type;
 
 public:
     void InvalidateRegion(CacheAddr addr, std::size_t size) {
         std::lock_guard lock{mutex};
 
         for (const auto& surface : GetSurfacesInRegion(addr, size)) {
+            if (surface->IsDirty()) {
+                continue;
+            }
+            if (surface->HasBandHashes() && !surface->IsModified() &&
+                !surface->IsRenderTarget()) {
+                // Keep the surface around, only the bands that changed are reloaded on its next
+                // use. Its pages stop being tracked so further writes don't land here again.
+                surface->MarkAsDirty(true);
+                rasterizer.UpdatePagesCachedCount(surface->GetCpuAddr(), surface->GetSizeInBytes(),
+                                                  -1);
+                dirty_surfaces.push_back(surface);
+                continue;
+            }
             Unregister(surface);
         }
     }
@@ -75,6 +93,20 @@ public:
         guard_samplers = new_guard;
     }
 
+    /// Returns the number of surface overlaps resolved with host GPU copies since the last call,
+    /// and the number of overlaps that had to round trip through guest memory.
+    std::pair<u32, u32> GetAndResetOverlapStats() {
+        return {gpu_resolved_overlaps.exchange(0), flushed_overlaps.exchange(0)};
+    }
+
+    /// Returns the mean number of guest bytes per frame whose upload was skipped since the last
+    /// call, because their contents hashed the same as what the host surface already holds.
+    u64 GetAndResetSkippedUploadStats() {
+        const u64 bytes = skipped_upload_bytes.exchange(0);
+        const u32 frames = stats_frames.exchange(0);
+        return frames == 0 ? 0 : bytes / frames;
+    }
+
     void FlushRegion(CacheAddr addr, std::size_t size) {
         std::lock_guard lock{mutex};
 
@@ -90,13 +122,51 @@ public:
         }
     }
 
+    /// Returns true when surfaces have been modified since the last committed batch.
+    bool HasUncommittedFlushes() const {
+        return !uncommitted_flushes.empty();
+    }
+
+    /// Returns true when the oldest committed batch has surfaces to download.
+    bool ShouldWaitAsyncFlushes() const {
+        return !committed_flushes.empty() && !committed_flushes.front().empty();
+    }
+
+    /// Commits the surfaces modified so far as a batch, flushed once its fence is released.
+    void CommitAsyncFlushes() {
+        std::lock_guard lock{mutex};
+        committed_flushes.push_back(std::exchange(uncommitted_flushes, {}));
+    }
+
+    /// Flushes the oldest committed batch.
+    void PopAsyncFlushes() {
+        std::lock_guard lock{mutex};
+        if (committed_flushes.empty()) {
+            return;
+        }
+        for (const TSurface& surface : committed_flushes.front()) {
+            if (surface->IsRegistered()) {
+                FlushSurface(surface);
+            }
+        }
+        committed_flushes.pop_front();
+    }
+
     TView GetTextureSurface(const Tegra::Texture::TICEntry& tic,
                             const VideoCommon::Shader::Sampler& entry) {
         std::lock_guard lock{mutex};
+        RefreshDirtySurfaces();
+        Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::TextureCache};
         const auto gpu_addr{tic.Address()};
         if (!gpu_addr) {
             return GetNullSurface(SurfaceParams::ExpectedTarget(entry));
         }
+        const u32 shape = static_cast<u32>(entry.GetType()) | (entry.IsArray() ? 1U << 8 : 0) |
+                          (entry.IsShadow() ? 1U << 9 : 0);
+        TextureLookup& lookup = GetTextureLookup(tic, shape);
+        if (IsLookupValid(lookup, tic, shape)) {
+            return UseLookup(lookup);
+        }
 
         const auto host_ptr{system.GPU().MemoryManager().GetPointer(gpu_addr)};
         const auto cache_addr{ToCacheAddr(host_ptr)};
@@ -105,19 +175,26 @@ public:
         }
         const auto params{SurfaceParams::CreateForTexture(format_lookup_table, tic, entry)};
         const auto [surface, view] = GetSurface(gpu_addr, cache_addr, params, true, false);
-        if (guard_samplers) {
-            sampled_textures.push_back(surface);
-        }
-        return view;
+        StoreLookup(lookup, tic, shape, surface, view);
+        return UseLookup(lookup);
     }
 
     TView GetImageSurface(const Tegra::Texture::TICEntry& tic,
                           const VideoCommon::Shader::Image& entry) {
         std::lock_guard lock{mutex};
+        RefreshDirtySurfaces();
+        Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::TextureCache};
         const auto gpu_addr{tic.Address()};
         if (!gpu_addr) {
             return GetNullSurface(SurfaceParams::ExpectedTarget(entry));
         }
+        // Images get their own shapes, they can't share lookups with samplers
+        const u32 shape = static_cast<u32>(entry.GetType()) | (1U << 16);
+        TextureLookup& lookup = GetTextureLookup(tic, shape);
+        if (IsLookupValid(lookup, tic, shape)) {
+            return UseLookup(lookup);
+        }
+
         const auto host_ptr{system.GPU().MemoryManager().GetPointer(gpu_addr)};
         const auto cache_addr{ToCacheAddr(host_ptr)};
         if (!cache_addr) {
@@ -125,10 +202,8 @@ public:
         }
         const auto params{SurfaceParams::CreateForImage(format_lookup_table, tic, entry)};
         const auto [surface, view] = GetSurface(gpu_addr, cache_addr, params, true, false);
-        if (guard_samplers) {
-            sampled_textures.push_back(surface);
-        }
-        return view;
+        StoreLookup(lookup, tic, shape, surface, view);
+        return UseLookup(lookup);
     }
 
     bool TextureBarrier() {
@@ -141,6 +216,8 @@ public:
 
     TView GetDepthBufferSurface(bool preserve_contents) {
         std::lock_guard lock{mutex};
+        RefreshDirtySurfaces();
+        Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::TextureCache};
         auto& maxwell3d = system.GPU().Maxwell3D();
 
         if (!maxwell3d.dirty.depth_buffer) {
@@ -169,13 +246,17 @@ public:
             depth_buffer.target->MarkAsRenderTarget(false, NO_RT);
         depth_buffer.target = surface_view.first;
         depth_buffer.view = surface_view.second;
-        if (depth_buffer.target)
+        if (depth_buffer.target) {
             depth_buffer.target->MarkAsRenderTarget(true, DEPTH_RT);
+            depth_buffer.target->MarkAsUsed(Tick());
+        }
         return surface_view.second;
     }
 
     TView GetColorBufferSurface(std::size_t index, bool preserve_contents) {
         std::lock_guard lock{mutex};
+        RefreshDirtySurfaces();
+        Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::TextureCache};
         ASSERT(index < Tegra::Engines::Maxwell3D::Regs::NumRenderTargets);
         auto& maxwell3d = system.GPU().Maxwell3D();
         if (!maxwell3d.dirty.render_target[index]) {
@@ -211,20 +292,24 @@ public:
             render_targets[index].target->MarkAsRenderTarget(false, NO_RT);
         render_targets[index].target = surface_view.first;
         render_targets[index].view = surface_view.second;
-        if (render_targets[index].target)
+        if (render_targets[index].target) {
             render_targets[index].target->MarkAsRenderTarget(true, static_cast<u32>(index));
+            render_targets[index].target->MarkAsUsed(Tick());
+        }
         return surface_view.second;
     }
 
     void MarkColorBufferInUse(std::size_t index) {
         if (auto& render_target = render_targets[index].target) {
-            render_target->MarkAsModified(true, Tick());
+            MarkSurfaceWritten(render_target);
+            render_target->MarkAsUsed(Tick());
         }
     }
 
     void MarkDepthBufferInUse() {
         if (depth_buffer.target) {
-            depth_buffer.target->MarkAsModified(true, Tick());
+            MarkSurfaceWritten(depth_buffer.target);
+            depth_buffer.target->MarkAsUsed(Tick());
         }
     }
 
@@ -246,15 +331,29 @@ public:
         render_targets[index].view = nullptr;
     }
 
-    void DoFermiCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src_config,
+    /**
+     * Performs a Fermi2D surface copy on the host GPU. Scaled, filtered and format converting
+     * blits go through ImageBlit, unscaled copies between formats that can't be blitted into each
+     * other are copied raw when their texel sizes match.
+     * Returns false when the host can't perform the copy.
+     */
+    bool DoFermiCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src_config,
                      const Tegra::Engines::Fermi2D::Regs::Surface& dst_config,
                      const Tegra::Engines::Fermi2D::Config& copy_config) {
         std::lock_guard lock{mutex};
+        RefreshDirtySurfaces();
+        Core::FrameTimeline::ScopedTimer timer{Core::FrameTimeline::Stage::TextureCache};
         SurfaceParams src_params = SurfaceParams::CreateForFermiCopySurface(src_config);
         SurfaceParams dst_params = SurfaceParams::CreateForFermiCopySurface(dst_config);
         const GPUVAddr src_gpu_addr = src_config.Address();
         const GPUVAddr dst_gpu_addr = dst_config.Address();
         DeduceBestBlit(src_params, dst_params, src_gpu_addr, dst_gpu_addr);
+
+        const FermiCopyMethod method = GetFermiCopyMethod(src_params, dst_params, copy_config);
+        if (method == FermiCopyMethod::Unsupported) {
+            return false;
+        }
+
         const auto dst_host_ptr{system.GPU().MemoryManager().GetPointer(dst_gpu_addr)};
         const auto dst_cache_addr{ToCacheAddr(dst_host_ptr)};
         const auto src_host_ptr{system.GPU().MemoryManager().GetPointer(src_gpu_addr)};
@@ -263,8 +362,20 @@ public:
             GetSurface(dst_gpu_addr, dst_cache_addr, dst_params, true, false);
         std::pair<TSurface, TView> src_surface =
             GetSurface(src_gpu_addr, src_cache_addr, src_params, true, false);
-        ImageBlit(src_surface.second, dst_surface.second, copy_config);
-        dst_surface.first->MarkAsModified(true, Tick());
+        if (method == FermiCopyMethod::Blit) {
+            ImageBlit(src_surface.second, dst_surface.second, copy_config);
+        } else {
+            const auto& src_rect = copy_config.src_rect;
+            const auto& dst_rect = copy_config.dst_rect;
+            const CopyParams copy_params(src_rect.left, src_rect.top, 0, dst_rect.left,
+                                         dst_rect.top, 0, 0, 0, src_rect.GetWidth(),
+                                         src_rect.GetHeight(), 1);
+            ImageCopy(src_surface.first, dst_surface.first, copy_params);
+        }
+        src_surface.first->MarkAsUsed(Tick());
+        dst_surface.first->MarkAsUsed(Tick());
+        MarkSurfaceWritten(dst_surface.first);
+        return true;
     }
 
     TSurface TryFindFramebufferSurface(const u8* host_ptr) {
@@ -272,20 +383,71 @@ public:
         if (!cache_addr) {
             return nullptr;
         }
-        const CacheAddr page = cache_addr >> registry_page_bits;
-        std::vector<TSurface>& list = registry[page];
-        for (auto& surface : list) {
+        std::lock_guard lock{mutex};
+        RefreshDirtySurfaces();
+        TSurface found;
+        registry.ForEachOverlap(cache_addr, cache_addr + 1, [&](const TSurface& surface) {
             if (surface->GetCacheAddr() == cache_addr) {
-                return surface;
+                found = surface;
             }
-        }
-        return nullptr;
+        });
+        return found;
     }
 
     u64 Tick() {
         return ++ticks;
     }
 
+    /// Evicts the least recently used surfaces while the cache is over the configured budget.
+    /// Modified surfaces are flushed to guest memory before they are released.
+    void TickFrame() {
+        std::lock_guard lock{mutex};
+        ++stats_frames;
+        frame_ticks.push_back(ticks);
+        if (frame_ticks.size() <= frames_to_keep) {
+            return;
+        }
+        // Surfaces used in the last frames may still be in flight, only older ones are evicted
+        const u64 tick_limit = frame_ticks.front();
+        frame_ticks.pop_front();
+
+        const u64 budget = static_cast<u64>(Settings::values.vram_budget) << 20;
+        if (budget == 0 || memory_usage <= budget) {
+            return;
+        }
+        // Every surface created by the cache lives in the reserve, registered or not
+        std::vector<TSurface> candidates;
+        for (const auto& [params, surfaces] : surface_reserve) {
+            for (const TSurface& surface : surfaces) {
+                if (surface->GetLastUseTick() < tick_limit && !surface->IsRenderTarget()) {
+                    candidates.push_back(surface);
+                }
+            }
+        }
+        // Unregistered surfaces go first, they are released without having to flush anything
+        std::sort(candidates.begin(), candidates.end(), [](const TSurface& a, const TSurface& b) {
+            if (a->IsRegistered() != b->IsRegistered()) {
+                return b->IsRegistered();
+            }
+            return a->GetLastUseTick() < b->GetLastUseTick();
+        });
+        // Lookups hold references to the surfaces, drop them so released surfaces are destroyed
+        texture_lookups.fill({});
+        for (TSurface& surface : candidates) {
+            if (memory_usage <= budget) {
+                break;
+            }
+            if (surface->IsRegistered()) {
+                FlushSurface(surface);
+                Unregister(surface);
+                if (surface->IsRegistered()) {
+                    continue;
+                }
+            }
+            ReleaseReservedSurface(surface);
+        }
+    }
+
 protected:
     TextureCache(Core::System& system, VideoCore::RasterizerInterface& rasterizer)
         : system{system}, rasterizer{rasterizer} {
@@ -294,7 +456,7 @@ protected:
         }
 
         SetEmptyDepthBuffer();
-        staging_cache.SetSize(2);
+        staging_cache.SetSize(3);
 
         const auto make_siblings = [this](PixelFormat a, PixelFormat b) {
             siblings_table[static_cast<std::size_t>(a)] = b;
@@ -322,6 +484,18 @@ protected:
     // and reading it from a separate buffer.
     virtual void BufferCopy(TSurface& src_surface, TSurface& dst_surface) = 0;
 
+    /// Returns true when the backend can reinterpret a surface into another through BufferCopy.
+    virtual bool CanBufferCopy(const SurfaceParams& src_params,
+                               const SurfaceParams& dst_params) const {
+        return true;
+    }
+
+    /// Returns true when surfaces with these parameters can be deswizzled by the host GPU.
+    virtual bool CanUploadSwizzled(const SurfaceParams& params) const = 0;
+
+    /// Uploads the raw guest memory of a surface and deswizzles it on the host GPU.
+    virtual void UploadSwizzled(const TSurface& surface, const u8* guest_data) = 0;
+
     void ManageRenderTargetUnregister(TSurface& surface) {
         auto& maxwell3d = system.GPU().Maxwell3D();
         const u32 index = surface->GetRenderTarget();
@@ -350,6 +524,7 @@ protected:
         surface->SetCpuAddr(*cpu_addr);
         RegisterInnerCache(surface);
         surface->MarkAsRegistered(true);
+        ++lookup_generation;
         rasterizer.UpdatePagesCachedCount(*cpu_addr, size, 1);
     }
 
@@ -362,19 +537,33 @@ protected:
         }
         const std::size_t size = surface->GetSizeInBytes();
         const VAddr cpu_addr = surface->GetCpuAddr();
-        rasterizer.UpdatePagesCachedCount(cpu_addr, size, -1);
+        if (surface->IsDirty()) {
+            // Dirty surfaces already stopped tracking their pages
+            surface->MarkAsDirty(false);
+        } else {
+            rasterizer.UpdatePagesCachedCount(cpu_addr, size, -1);
+        }
         UnregisterInnerCache(surface);
         surface->MarkAsRegistered(false);
-        ReserveSurface(surface->GetSurfaceParams(), surface);
+        ++lookup_generation;
     }
 
-    TSurface GetUncachedSurface(const GPUVAddr gpu_addr, const SurfaceParams& params) {
-        if (const auto surface = TryGetReservedSurface(params); surface) {
+    /// Returns an unregistered surface, reusing a reserved one when possible. Unless the caller
+    /// is going to load it from guest memory, its hashed contents are forgotten, the caller is
+    /// about to write them.
+    TSurface GetUncachedSurface(const GPUVAddr gpu_addr, const SurfaceParams& params,
+                                bool is_load = false) {
+        if (const auto surface = TryGetReservedSurface(params, gpu_addr); surface) {
             surface->SetGpuAddr(gpu_addr);
+            if (!is_load) {
+                surface->ClearContentHash();
+            }
             return surface;
         }
         // No reserved surface available, create a new one and reserve it
         auto new_surface{CreateSurface(gpu_addr, params)};
+        memory_usage += new_surface->GetHostSizeInBytes();
+        ReserveSurface(params, new_surface);
         return new_surface;
     }
 
@@ -434,6 +623,11 @@ private:
                 return RecycleStrategy::Flush;
             }
         }
+        // Same memory layout with a different format, reinterpret it on the GPU
+        if (untopological != MatchTopologyResult::CompressUnmatch && overlaps.size() == 1 &&
+            overlaps[0]->GetGpuAddr() == gpu_addr && IsReinterpretable(*overlaps[0], params)) {
+            return RecycleStrategy::BufferCopy;
+        }
         // Untopological decision
         if (untopological == MatchTopologyResult::CompressUnmatch) {
             return RecycleStrategy::Flush;
@@ -445,11 +639,45 @@ private:
     }
 
     /**
-     * Used to decide what to do with textures we can't resolve in the cache It has 2 implemented
-     * strategies: Ignore and Flush.
+     * Returns true when a registered surface and the new parameters describe the same bytes in
+     * guest memory, so the surface can be reinterpreted with a BufferCopy instead of flushing it.
+     * Texel rows have to match in bytes, tiling only depends on byte coordinates.
+     **/
+    bool IsReinterpretable(const SurfaceBaseImpl& surface, const SurfaceParams& params) const {
+        const SurfaceParams& src_params = surface.GetSurfaceParams();
+        if (src_params.IsBuffer() || params.IsBuffer() || src_params.IsCompressed() ||
+            params.IsCompressed()) {
+            return false;
+        }
+        if (src_params.num_levels != 1 || params.num_levels != 1 ||
+            src_params.target != params.target || src_params.depth != params.depth ||
+            src_params.height != params.height || src_params.is_tiled != params.is_tiled) {
+            return false;
+        }
+        if (src_params.width * src_params.GetBytesPerPixel() !=
+            params.width * params.GetBytesPerPixel()) {
+            return false;
+        }
+        if (params.is_tiled) {
+            if (std::tie(src_params.block_height, src_params.block_depth,
+                         src_params.tile_width_spacing) !=
+                std::tie(params.block_height, params.block_depth, params.tile_width_spacing)) {
+                return false;
+            }
+        } else if (src_params.pitch != params.pitch) {
+            return false;
+        }
+        return surface.GetSizeInBytes() == params.GetGuestSizeInBytes() &&
+               CanBufferCopy(src_params, params);
+    }
+
+    /**
+     * Used to decide what to do with textures we can't resolve in the cache It has 3 implemented
+     * strategies: Ignore, Flush and BufferCopy.
      *
      * - Ignore: Just unregisters all the overlaps and loads the new texture.
      * - Flush: Flushes all the overlaps into memory and loads the new surface from that data.
+     * - BufferCopy: Reinterprets a single overlap with the same layout into the new surface.
      *
      * @param overlaps          The overlapping surfaces registered in the cache.
      * @param params            The parameters for the new surface.
@@ -479,11 +707,15 @@ private:
             for (auto& surface : overlaps) {
                 FlushSurface(surface);
             }
+            ++flushed_overlaps;
             return InitializeSurface(gpu_addr, params, preserve_contents);
         }
         case RecycleStrategy::BufferCopy: {
             auto new_surface = GetUncachedSurface(gpu_addr, params);
             BufferCopy(overlaps[0], new_surface);
+            Register(new_surface);
+            new_surface->MarkAsModified(overlaps[0]->IsModified(), Tick());
+            ++gpu_resolved_overlaps;
             return {new_surface, new_surface->GetMainView()};
         }
         default: {
@@ -527,6 +759,7 @@ private:
         Unregister(current_surface);
         Register(new_surface);
         new_surface->MarkAsModified(current_surface->IsModified(), Tick());
+        ++gpu_resolved_overlaps;
         return {new_surface, new_surface->GetMainView()};
     }
 
@@ -563,7 +796,8 @@ private:
      * Unlike RebuildSurface where we know whether or not registered surfaces match the candidate
      * in some way, we have no guarantees here. We try to see if the overlaps are sublayers/mipmaps
      * of the new surface, if they all match we end up recreating a surface for them,
-     * else we return nothing.
+     * else we return nothing. Layered and mipmapped overlaps are copied one subresource at a time
+     * when each of them lands on a subresource of the same size in the new surface.
      *
      * @param overlaps The overlapping surfaces registered in the cache.
      * @param params   The parameters on the new surface.
@@ -578,28 +812,45 @@ private:
         bool modified = false;
         TSurface new_surface = GetUncachedSurface(gpu_addr, params);
         u32 passed_tests = 0;
+        const u32 num_layers = static_cast<u32>(params.GetNumLayers());
+        std::vector<CopyParams> copies;
         for (auto& surface : overlaps) {
             const SurfaceParams& src_params = surface->GetSurfaceParams();
-            if (src_params.is_layered || src_params.num_levels > 1) {
-                // We send this cases to recycle as they are more complex to handle
-                return {};
-            }
-            const std::size_t candidate_size = surface->GetSizeInBytes();
-            auto mipmap_layer{new_surface->GetLayerMipmap(surface->GetGpuAddr())};
-            if (!mipmap_layer) {
-                continue;
+            const bool is_complex = src_params.is_layered || src_params.num_levels > 1;
+            const u32 src_layers = static_cast<u32>(src_params.GetNumLayers());
+            copies.clear();
+            for (u32 src_layer = 0; src_layer < src_layers; ++src_layer) {
+                for (u32 src_level = 0; src_level < src_params.num_levels; ++src_level) {
+                    const GPUVAddr src_addr = surface->GetLayerMipmapAddress(src_layer, src_level);
+                    const auto mipmap_layer{new_surface->GetLayerMipmap(src_addr)};
+                    if (!mipmap_layer) {
+                        break;
+                    }
+                    const auto [layer, mipmap] = *mipmap_layer;
+                    if (layer >= num_layers ||
+                        new_surface->GetMipmapSize(mipmap) != surface->GetMipmapSize(src_level)) {
+                        break;
+                    }
+                    const u32 width =
+                        SurfaceParams::IntersectWidth(src_params, params, src_level, mipmap);
+                    const u32 height =
+                        SurfaceParams::IntersectHeight(src_params, params, src_level, mipmap);
+                    copies.emplace_back(0, 0, src_layer, 0, 0, layer, src_level, mipmap, width,
+                                        height, 1);
+                }
             }
-            const auto [layer, mipmap] = *mipmap_layer;
-            if (new_surface->GetMipmapSize(mipmap) != candidate_size) {
+            if (copies.size() != static_cast<std::size_t>(src_layers) * src_params.num_levels) {
+                if (is_complex) {
+                    // Partially matching layered or mipmapped overlaps are sent to recycle
+                    return {};
+                }
                 continue;
             }
             modified |= surface->IsModified();
-            // Now we got all the data set up
-            const u32 width = SurfaceParams::IntersectWidth(src_params, params, 0, mipmap);
-            const u32 height = SurfaceParams::IntersectHeight(src_params, params, 0, mipmap);
-            const CopyParams copy_params(0, 0, 0, 0, 0, layer, 0, mipmap, width, height, 1);
             passed_tests++;
-            ImageCopy(surface, new_surface, copy_params);
+            for (const auto& copy_params : copies) {
+                ImageCopy(surface, new_surface, copy_params);
+            }
         }
         if (passed_tests == 0) {
             return {};
@@ -612,6 +863,7 @@ private:
         }
         new_surface->MarkAsModified(modified, Tick());
         Register(new_surface);
+        ++gpu_resolved_overlaps;
         return {{new_surface, new_surface->GetMainView()}};
     }
 
@@ -941,7 +1193,7 @@ private:
     void DeduceBestBlit(SurfaceParams& src_params, SurfaceParams& dst_params,
                         const GPUVAddr src_gpu_addr, const GPUVAddr dst_gpu_addr) {
         auto deduced_src = DeduceSurface(src_gpu_addr, src_params);
-        auto deduced_dst = DeduceSurface(src_gpu_addr, src_params);
+        auto deduced_dst = DeduceSurface(dst_gpu_addr, dst_params);
         if (deduced_src.Failed() || deduced_dst.Failed()) {
             return;
         }
@@ -987,9 +1239,47 @@ private:
         }
     }
 
+    enum class FermiCopyMethod {
+        Blit,        ///< Scaled and format converting copy
+        Raw,         ///< Unscaled copy of the texel bits
+        Unsupported, ///< The host can't perform the copy
+    };
+
+    static FermiCopyMethod GetFermiCopyMethod(const SurfaceParams& src_params,
+                                              const SurfaceParams& dst_params,
+                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
+        if (copy_config.operation != Tegra::Engines::Fermi2D::Operation::SrcCopy) {
+            return FermiCopyMethod::Unsupported;
+        }
+        const auto src_format = src_params.pixel_format;
+        const auto dst_format = dst_params.pixel_format;
+        if (src_params.type == dst_params.type &&
+            (src_params.type == SurfaceType::ColorTexture
+                 ? VideoCore::Surface::IsPixelFormatInteger(src_format) ==
+                       VideoCore::Surface::IsPixelFormatInteger(dst_format)
+                 : src_format == dst_format)) {
+            return FermiCopyMethod::Blit;
+        }
+        // Integer and normalized colors can't be blitted into each other and depth formats have to
+        // match, reinterpret the texels instead when nothing has to be scaled.
+        const auto& src_rect = copy_config.src_rect;
+        const auto& dst_rect = copy_config.dst_rect;
+        const bool needs_blit = src_rect.GetWidth() != dst_rect.GetWidth() ||
+                               src_rect.GetHeight() != dst_rect.GetHeight() ||
+                               src_rect.left > src_rect.right || src_rect.top > src_rect.bottom ||
+                               dst_rect.left > dst_rect.right || dst_rect.top > dst_rect.bottom;
+        if (!needs_blit && src_params.type == SurfaceType::ColorTexture &&
+            dst_params.type == SurfaceType::ColorTexture &&
+            VideoCore::Surface::GetBytesPerPixel(src_format) ==
+                VideoCore::Surface::GetBytesPerPixel(dst_format)) {
+            return FermiCopyMethod::Raw;
+        }
+        return FermiCopyMethod::Unsupported;
+    }
+
     std::pair<TSurface, TView> InitializeSurface(GPUVAddr gpu_addr, const SurfaceParams& params,
                                                  bool preserve_contents) {
-        auto new_surface{GetUncachedSurface(gpu_addr, params)};
+        auto new_surface{GetUncachedSurface(gpu_addr, params, preserve_contents)};
         Register(new_surface);
         if (preserve_contents) {
             LoadSurface(new_surface);
@@ -998,10 +1288,116 @@ private:
     }
 
     void LoadSurface(const TSurface& surface) {
+        auto& memory_manager = system.GPU().MemoryManager();
+        const u8* guest_data = nullptr;
+        std::optional<u64> content_hash;
+        const auto finish_load = [&] {
+            surface->MarkAsModified(false, Tick());
+            if (content_hash) {
+                surface->SetContentHash(*content_hash);
+            }
+            if (Settings::values.use_texture_hashing && !surface->GetBands().empty()) {
+                // Gathering the guest data again is cheap when it's continuous, and it's already
+                // staged when it isn't
+                guest_data = surface->GetGuestData(memory_manager, staging_cache);
+                if (guest_data) {
+                    surface->HashBands(guest_data);
+                }
+            }
+        };
+        if (Settings::values.use_texture_hashing) {
+            guest_data = surface->GetGuestData(memory_manager, staging_cache);
+            if (guest_data) {
+                // Guests often rewrite the same bytes, the host contents are still valid then
+                const std::size_t size = surface->GetSizeInBytes();
+                content_hash = Common::HashValue(guest_data, size);
+                if (surface->MatchesContentHash(*content_hash)) {
+                    skipped_upload_bytes += size;
+                    finish_load();
+                    return;
+                }
+            }
+        }
+        if (CanUploadSwizzled(surface->GetSurfaceParams())) {
+            if (!guest_data) {
+                guest_data = surface->GetGuestData(memory_manager, staging_cache);
+            }
+            if (guest_data) {
+                UploadSwizzled(surface, guest_data);
+                finish_load();
+                return;
+            }
+        }
         staging_cache.GetBuffer(0).resize(surface->GetHostSizeInBytes());
-        surface->LoadBuffer(system.GPU().MemoryManager(), staging_cache);
+        surface->LoadBuffer(memory_manager, staging_cache);
         surface->UploadTexture(staging_cache.GetBuffer(0));
-        surface->MarkAsModified(false, Tick());
+        finish_load();
+    }
+
+    /// Reloads the bands of dirty surfaces whose guest data changed. Surfaces that changed for the
+    /// most part are unregistered instead, they are reloaded as a whole when they are used again.
+    void RefreshDirtySurfaces() {
+        if (dirty_surfaces.empty()) {
+            return;
+        }
+        auto& memory_manager = system.GPU().MemoryManager();
+        for (const TSurface& surface : std::exchange(dirty_surfaces, {})) {
+            if (!surface->IsDirty()) {
+                // Unregistered while it was dirty
+                continue;
+            }
+            surface->MarkAsDirty(false);
+            const std::size_t size = surface->GetSizeInBytes();
+            rasterizer.UpdatePagesCachedCount(surface->GetCpuAddr(), size, 1);
+
+            const GPUVAddr gpu_addr = surface->GetGpuAddr();
+            const CacheAddr cache_addr = ToCacheAddr(memory_manager.GetPointer(gpu_addr));
+            const u8* guest_data = nullptr;
+            if (cache_addr == surface->GetCacheAddr()) {
+                guest_data = surface->GetGuestData(memory_manager, staging_cache);
+            }
+            if (!guest_data) {
+                Unregister(surface);
+                continue;
+            }
+            const std::vector<std::size_t> changed = surface->FindChangedBands(guest_data);
+            const auto& bands = surface->GetBands();
+            if (changed.size() * 2 > bands.size()) {
+                Unregister(surface);
+                continue;
+            }
+            std::size_t reloaded_size = 0;
+            auto& staging_buffer = staging_cache.GetBuffer(0);
+            for (const std::size_t index : changed) {
+                const SurfaceBand& band = bands[index];
+                surface->LoadBand(guest_data, staging_buffer, band);
+                surface->UploadBand(staging_buffer, band);
+                reloaded_size += band.guest_size;
+            }
+            skipped_upload_bytes += size - reloaded_size;
+            surface->ClearContentHash();
+        }
+    }
+
+    /// Marks a surface as modified by the GPU, the CPU has to flush it before reading its memory.
+    void MarkSurfaceWritten(const TSurface& surface) {
+        if (!surface->IsModified()) {
+            const CacheAddr cache_addr = surface->GetCacheAddr();
+            system.GPU().MarkRegionWritten(cache_addr, surface->GetCacheAddrEnd() - cache_addr);
+        }
+        surface->MarkAsModified(true, Tick());
+        AsyncFlushSurface(surface);
+    }
+
+    /// Queues a modified surface to be flushed with the next committed batch.
+    void AsyncFlushSurface(const TSurface& surface) {
+        if (!IsAsyncFlushEnabled()) {
+            return;
+        }
+        if (std::find(uncommitted_flushes.begin(), uncommitted_flushes.end(), surface) ==
+            uncommitted_flushes.end()) {
+            uncommitted_flushes.push_back(surface);
+        }
     }
 
     void FlushSurface(const TSurface& surface) {
@@ -1016,66 +1412,108 @@ private:
 
     void RegisterInnerCache(TSurface& surface) {
         const CacheAddr cache_addr = surface->GetCacheAddr();
-        CacheAddr start = cache_addr >> registry_page_bits;
-        const CacheAddr end = (surface->GetCacheAddrEnd() - 1) >> registry_page_bits;
         l1_cache[cache_addr] = surface;
-        while (start <= end) {
-            registry[start].push_back(surface);
-            start++;
-        }
+        registry.Insert(surface, cache_addr, surface->GetCacheAddrEnd());
     }
 
     void UnregisterInnerCache(TSurface& surface) {
         const CacheAddr cache_addr = surface->GetCacheAddr();
-        CacheAddr start = cache_addr >> registry_page_bits;
-        const CacheAddr end = (surface->GetCacheAddrEnd() - 1) >> registry_page_bits;
         l1_cache.erase(cache_addr);
-        while (start <= end) {
-            auto& reg{registry[start]};
-            reg.erase(std::find(reg.begin(), reg.end(), surface));
-            start++;
-        }
+        registry.Erase(surface, cache_addr, surface->GetCacheAddrEnd());
     }
 
     std::vector<TSurface> GetSurfacesInRegion(const CacheAddr cache_addr, const std::size_t size) {
         if (size == 0) {
             return {};
         }
-        const CacheAddr cache_addr_end = cache_addr + size;
-        CacheAddr start = cache_addr >> registry_page_bits;
-        const CacheAddr end = (cache_addr_end - 1) >> registry_page_bits;
         std::vector<TSurface> surfaces;
-        while (start <= end) {
-            std::vector<TSurface>& list = registry[start];
-            for (auto& surface : list) {
-                if (!surface->IsPicked() && surface->Overlaps(cache_addr, cache_addr_end)) {
-                    surface->MarkAsPicked(true);
-                    surfaces.push_back(surface);
-                }
-            }
-            start++;
-        }
-        for (auto& surface : surfaces) {
-            surface->MarkAsPicked(false);
-        }
+        registry.ForEachOverlap(cache_addr, cache_addr + size,
+                                [&](const TSurface& surface) { surfaces.push_back(surface); });
         return surfaces;
     }
 
+    /// View resolved from a TIC entry, valid while no surface has been registered or unregistered
+    /// since it was stored.
+    struct TextureLookup {
+        Tegra::Texture::TICEntry tic{};
+        u32 shape{};
+        u64 generation{};
+        TSurface surface;
+        TView view;
+    };
+
+    TextureLookup& GetTextureLookup(const Tegra::Texture::TICEntry& tic, u32 shape) {
+        const GPUVAddr gpu_addr = tic.Address();
+        const u64 hash = (gpu_addr >> 8) ^ (gpu_addr >> 20) ^ shape;
+        return texture_lookups[hash % texture_lookups.size()];
+    }
+
+    bool IsLookupValid(const TextureLookup& lookup, const Tegra::Texture::TICEntry& tic,
+                       u32 shape) const {
+        return lookup.generation == lookup_generation && lookup.shape == shape &&
+               std::memcmp(&lookup.tic, &tic, sizeof(tic)) == 0;
+    }
+
+    void StoreLookup(TextureLookup& lookup, const Tegra::Texture::TICEntry& tic, u32 shape,
+                     TSurface surface, TView view) {
+        lookup.tic = tic;
+        lookup.shape = shape;
+        lookup.generation = lookup_generation;
+        lookup.surface = std::move(surface);
+        lookup.view = std::move(view);
+    }
+
+    TView UseLookup(const TextureLookup& lookup) {
+        lookup.surface->MarkAsUsed(Tick());
+        if (guard_samplers) {
+            sampled_textures.push_back(lookup.surface);
+        }
+        return lookup.view;
+    }
+
     void ReserveSurface(const SurfaceParams& params, TSurface surface) {
         surface_reserve[params].push_back(std::move(surface));
     }
 
-    TSurface TryGetReservedSurface(const SurfaceParams& params) {
+    /// Returns an unregistered surface with the given parameters, preferring one that was last
+    /// used at the same address so its contents can be kept when they didn't change.
+    TSurface TryGetReservedSurface(const SurfaceParams& params, GPUVAddr gpu_addr) {
         auto search{surface_reserve.find(params)};
         if (search == surface_reserve.end()) {
             return {};
         }
+        TSurface candidate;
         for (auto& surface : search->second) {
-            if (!surface->IsRegistered()) {
+            if (surface->IsRegistered()) {
+                continue;
+            }
+            if (surface->GetGpuAddr() == gpu_addr) {
                 return surface;
             }
+            if (!candidate) {
+                candidate = surface;
+            }
+        }
+        return candidate;
+    }
+
+    /// Drops an unregistered surface from the reserve, its host memory is released once it's no
+    /// longer bound.
+    void ReleaseReservedSurface(const TSurface& surface) {
+        const auto search{surface_reserve.find(surface->GetSurfaceParams())};
+        if (search == surface_reserve.end()) {
+            return;
         }
-        return {};
+        auto& surfaces = search->second;
+        const auto it = std::find(surfaces.begin(), surfaces.end(), surface);
+        if (it == surfaces.end()) {
+            return;
+        }
+        surfaces.erase(it);
+        if (surfaces.empty()) {
+            surface_reserve.erase(search);
+        }
+        memory_usage -= surface->GetHostSizeInBytes();
     }
 
     constexpr PixelFormat GetSiblingFormat(PixelFormat format) const {
@@ -1093,6 +1531,18 @@ private:
 
     u64 ticks{};
 
+    // Tick counter at the start of each of the last frames, used to find unused surfaces
+    static constexpr std::size_t frames_to_keep = 4;
+    std::deque<u64> frame_ticks;
+
+    // Host memory held by the surfaces created by the cache, including reserved ones
+    u64 memory_usage{};
+
+    // Direct mapped memoization of texture lookups, it lets static scenes skip the surface
+    // search. The generation starts at one so empty lookups are never valid.
+    std::array<TextureLookup, 256> texture_lookups;
+    u64 lookup_generation{1};
+
     // Guards the cache for protection conflicts.
     bool guard_render_targets{};
     bool guard_samplers{};
@@ -1106,8 +1556,7 @@ private:
     // of 1MB. This fits better for the purpose of this cache as textures are normaly
     // large in size.
     static constexpr u64 registry_page_bits{20};
-    static constexpr u64 registry_page_size{1 << registry_page_bits};
-    std::unordered_map<CacheAddr, std::vector<TSurface>> registry;
+    PageRegistry<TSurface, registry_page_bits> registry;
 
     static constexpr u32 DEPTH_RT = 8;
     static constexpr u32 NO_RT = 0xFFFFFFFF;
@@ -1116,9 +1565,16 @@ private:
     // This avoids calculating size and other stuffs.
     std::unordered_map<CacheAddr, TSurface> l1_cache;
 
-    /// The surface reserve is a "backup" cache, this is where we put unique surfaces that have
-    /// previously been used. This is to prevent surfaces from being constantly created and
-    /// destroyed when used with different surface parameters.
+    // Modified surfaces waiting for a syncpoint, and batches waiting for their fence
+    std::vector<TSurface> uncommitted_flushes;
+    std::list<std::vector<TSurface>> committed_flushes;
+
+    // Surfaces whose guest memory was written since their bands were hashed
+    std::vector<TSurface> dirty_surfaces;
+
+    /// The surface reserve is a "backup" cache, this is where we keep every surface created by
+    /// the cache. Unregistered surfaces are reused to prevent surfaces from being constantly
+    /// created and destroyed when used with different surface parameters.
     std::unordered_map<SurfaceParams, std::vector<TSurface>> surface_reserve;
     std::array<FramebufferTargetInfo, Tegra::Engines::Maxwell3D::Regs::NumRenderTargets>
         render_targets;
@@ -1133,6 +1589,11 @@ private:
 
     StagingCache staging_cache;
     std::recursive_mutex mutex;
+
+    std::atomic<u32> gpu_resolved_overlaps{};
+    std::atomic<u32> flushed_overlaps{};
+    std::atomic<u64> skipped_upload_bytes{};
+    std::atomic<u32> stats_frames{};
 };
 
 } // namespace VideoCommon
@@ -21,6 +21,7 @@
 #include <cstring>
 #include <vector>
 
+#include "common/thread_worker.h"
 #include "video_core/textures/astc.h"
 
 class InputBitStream {
@@ -1612,37 +1613,67 @@ static void DecompressBlock(const uint8_t inBuf[16], const uint32_t blockWidth,
 } // namespace ASTCC
 
 namespace Tegra::Texture::ASTC {
-
-std::vector<uint8_t> Decompress(const uint8_t* data, uint32_t width, uint32_t height,
-                                uint32_t depth, uint32_t block_width, uint32_t block_height) {
-    uint32_t blockIdx = 0;
-    std::size_t depth_offset = 0;
-    std::vector<uint8_t> outData(height * width * depth * 4);
-    for (uint32_t k = 0; k < depth; k++) {
-        for (uint32_t j = 0; j < height; j += block_height) {
-            for (uint32_t i = 0; i < width; i += block_width) {
-
-                const uint8_t* blockPtr = data + blockIdx * 16;
-
-                // Blocks can be at most 12x12
-                uint32_t uncompData[144];
-                ASTCC::DecompressBlock(blockPtr, block_width, block_height, uncompData);
-
-                uint32_t decompWidth = std::min(block_width, width - i);
-                uint32_t decompHeight = std::min(block_height, height - j);
-
-                uint8_t* outRow = depth_offset + outData.data() + (j * width + i) * 4;
-                for (uint32_t jj = 0; jj < decompHeight; jj++) {
-                    memcpy(outRow + jj * width * 4, uncompData + jj * block_width, decompWidth * 4);
-                }
-
-                blockIdx++;
+namespace {
+/// Smallest number of blocks worth handing over to another thread.
+constexpr std::size_t MinBlocksPerJob = 256;
+
+void DecompressRows(const uint8_t* data, uint32_t width, uint32_t height, uint32_t block_width,
+                    uint32_t block_height, uint32_t first_row, uint32_t last_row,
+                    uint8_t* output) {
+    const uint32_t blocks_per_row = (width + block_width - 1) / block_width;
+    const uint32_t rows_per_layer = (height + block_height - 1) / block_height;
+    for (uint32_t row = first_row; row < last_row; ++row) {
+        const uint32_t j = (row % rows_per_layer) * block_height;
+        const std::size_t depth_offset =
+            static_cast<std::size_t>(row / rows_per_layer) * height * width * 4;
+        const uint8_t* blockPtr = data + static_cast<std::size_t>(row) * blocks_per_row * 16;
+        for (uint32_t i = 0; i < width; i += block_width, blockPtr += 16) {
+            // Blocks can be at most 12x12
+            uint32_t uncompData[144];
+            ASTCC::DecompressBlock(blockPtr, block_width, block_height, uncompData);
+
+            uint32_t decompWidth = std::min(block_width, width - i);
+            uint32_t decompHeight = std::min(block_height, height - j);
+
+            uint8_t* outRow = depth_offset + output + (j * width + i) * 4;
+            for (uint32_t jj = 0; jj < decompHeight; jj++) {
+                memcpy(outRow + jj * width * 4, uncompData + jj * block_width, decompWidth * 4);
             }
         }
-        depth_offset += height * width * 4;
     }
+}
+} // Anonymous namespace
+
+void Decompress(const uint8_t* data, uint32_t width, uint32_t height, uint32_t depth,
+                uint32_t block_width, uint32_t block_height, uint8_t* output) {
+    const uint32_t blocks_per_row = (width + block_width - 1) / block_width;
+    const uint32_t num_rows = (height + block_height - 1) / block_height * depth;
+    const auto decompress = [=](uint32_t first_row, uint32_t last_row) {
+        DecompressRows(data, width, height, block_width, block_height, first_row, last_row,
+                       output);
+    };
+
+    // Every block is independent, split the image in runs of block rows
+    // The calling thread decodes a share of the image too
+    Common::ThreadWorker& worker = Common::GetSharedWorker();
+    const std::size_t num_blocks = static_cast<std::size_t>(num_rows) * blocks_per_row;
+    const std::size_t max_jobs = std::min(num_blocks / MinBlocksPerJob, worker.NumWorkers() + 1);
+    if (max_jobs <= 1) {
+        decompress(0, num_rows);
+        return;
+    }
+    const uint32_t rows_per_job = static_cast<uint32_t>((num_rows + max_jobs - 1) / max_jobs);
 
-    return outData;
+    // Something is blocked on the texture, get ahead of background jobs
+    Common::TaskGroup group;
+    for (uint32_t first_row = rows_per_job; first_row < num_rows; first_row += rows_per_job) {
+        const uint32_t last_row = std::min(first_row + rows_per_job, num_rows);
+        worker.QueueWork(
+            group, [&decompress, first_row, last_row] { decompress(first_row, last_row); },
+            Common::WorkPriority::High);
+    }
+    decompress(0, std::min(rows_per_job, num_rows));
+    group.Wait();
 }
 
 } // namespace Tegra::Texture::ASTC
@@ -5,11 +5,12 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
 
 namespace Tegra::Texture::ASTC {
 
-std::vector<uint8_t> Decompress(const uint8_t* data, uint32_t width, uint32_t height,
-                                uint32_t depth, uint32_t block_width, uint32_t block_height);
+/// Decodes an ASTC image into RGBA8 texels written to output, which must have room for
+/// width * height * depth texels.
+void Decompress(const uint8_t* data, uint32_t width, uint32_t height, uint32_t depth,
+                uint32_t block_width, uint32_t block_height, uint8_t* output);
 
 } // namespace Tegra::Texture::ASTC
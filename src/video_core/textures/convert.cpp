@@ -14,54 +14,55 @@
 #include "video_core/textures/astc.h"
 #include "video_core/textures/convert.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/textures/convert_avx2.h"
+#endif
+
 namespace Tegra::Texture {
 
 using VideoCore::Surface::PixelFormat;
 
-template <bool reverse>
-void SwapS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
-    union S8Z24 {
-        BitField<0, 24, u32> z24;
-        BitField<24, 8, u32> s8;
-    };
-    static_assert(sizeof(S8Z24) == 4, "S8Z24 is incorrect size");
-
-    union Z24S8 {
-        BitField<0, 8, u32> s8;
-        BitField<8, 24, u32> z24;
-    };
-    static_assert(sizeof(Z24S8) == 4, "Z24S8 is incorrect size");
+namespace {
 
-    S8Z24 s8z24_pixel{};
-    Z24S8 z24s8_pixel{};
-    constexpr auto bpp{
-        VideoCore::Surface::GetBytesPerPixel(VideoCore::Surface::PixelFormat::S8Z24)};
-    for (std::size_t y = 0; y < height; ++y) {
-        for (std::size_t x = 0; x < width; ++x) {
-            const std::size_t offset{bpp * (y * width + x)};
-            if constexpr (reverse) {
-                std::memcpy(&z24s8_pixel, &data[offset], sizeof(Z24S8));
-                s8z24_pixel.s8.Assign(z24s8_pixel.s8);
-                s8z24_pixel.z24.Assign(z24s8_pixel.z24);
-                std::memcpy(&data[offset], &s8z24_pixel, sizeof(S8Z24));
-            } else {
-                std::memcpy(&s8z24_pixel, &data[offset], sizeof(S8Z24));
-                z24s8_pixel.s8.Assign(s8z24_pixel.s8);
-                z24s8_pixel.z24.Assign(s8z24_pixel.z24);
-                std::memcpy(&data[offset], &z24s8_pixel, sizeof(Z24S8));
-            }
-        }
+/// Rotates the bits of every 32-bit texel left, the loop is simple enough to be vectorized
+template <u32 rotation>
+void RotateTexels(const u8* in_data, u8* out_data, std::size_t num_texels) {
+    for (std::size_t i = 0; i < num_texels; ++i) {
+        u32 texel;
+        std::memcpy(&texel, in_data + i * sizeof(u32), sizeof(u32));
+        texel = (texel << rotation) | (texel >> (32 - rotation));
+        std::memcpy(out_data + i * sizeof(u32), &texel, sizeof(u32));
     }
 }
 
-static void ConvertS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
-    SwapS8Z24ToZ24S8<false>(data, width, height);
+/// Moves the stencil from the high to the low byte of each texel. Input and output may alias.
+void ConvertS8Z24ToZ24S8(const u8* in_data, u8* out_data, std::size_t num_texels) {
+    std::size_t converted = 0;
+#ifdef ARCHITECTURE_x86_64
+    static const bool has_avx2 = AVX2::IsSupported();
+    if (has_avx2) {
+        converted = AVX2::ConvertS8Z24ToZ24S8(in_data, out_data, num_texels);
+    }
+#endif
+    const std::size_t offset = converted * sizeof(u32);
+    RotateTexels<8>(in_data + offset, out_data + offset, num_texels - converted);
 }
 
-static void ConvertZ24S8ToS8Z24(u8* data, u32 width, u32 height) {
-    SwapS8Z24ToZ24S8<true>(data, width, height);
+/// Moves the stencil from the low to the high byte of each texel. Input and output may alias.
+void ConvertZ24S8ToS8Z24(const u8* in_data, u8* out_data, std::size_t num_texels) {
+    std::size_t converted = 0;
+#ifdef ARCHITECTURE_x86_64
+    static const bool has_avx2 = AVX2::IsSupported();
+    if (has_avx2) {
+        converted = AVX2::ConvertZ24S8ToS8Z24(in_data, out_data, num_texels);
+    }
+#endif
+    const std::size_t offset = converted * sizeof(u32);
+    RotateTexels<24>(in_data + offset, out_data + offset, num_texels - converted);
 }
 
+} // Anonymous namespace
+
 void ConvertFromGuestToHost(u8* in_data, u8* out_data, PixelFormat pixel_format, u32 width,
                             u32 height, u32 depth, bool convert_astc, bool convert_s8z24) {
     if (convert_astc && IsPixelFormatASTC(pixel_format)) {
@@ -69,12 +70,11 @@ void ConvertFromGuestToHost(u8* in_data, u8* out_data, PixelFormat pixel_format,
         u32 block_width{};
         u32 block_height{};
         std::tie(block_width, block_height) = GetASTCBlockSize(pixel_format);
-        const std::vector<u8> rgba8_data = Tegra::Texture::ASTC::Decompress(
-            in_data, width, height, depth, block_width, block_height);
-        std::copy(rgba8_data.begin(), rgba8_data.end(), out_data);
+        Tegra::Texture::ASTC::Decompress(in_data, width, height, depth, block_width, block_height,
+                                         out_data);
 
     } else if (convert_s8z24 && pixel_format == PixelFormat::S8Z24) {
-        Tegra::Texture::ConvertS8Z24ToZ24S8(in_data, width, height);
+        ConvertS8Z24ToZ24S8(in_data, out_data, static_cast<std::size_t>(width) * height);
     }
 }
 
@@ -86,7 +86,7 @@ void ConvertFromHostToGuest(u8* data, PixelFormat pixel_format, u32 width, u32 h
         UNREACHABLE();
 
     } else if (convert_s8z24 && pixel_format == PixelFormat::S8Z24) {
-        Tegra::Texture::ConvertZ24S8ToS8Z24(data, width, height);
+        ConvertZ24S8ToS8Z24(data, data, static_cast<std::size_t>(width) * height);
     }
 }
 
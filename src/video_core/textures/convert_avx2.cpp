@@ -0,0 +1,44 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#include "video_core/textures/convert_avx2.h"
+
+namespace Tegra::Texture::AVX2 {
+namespace {
+
+constexpr std::size_t TEXELS_PER_VECTOR = sizeof(__m256i) / sizeof(u32);
+
+/// Shuffles the bytes of every texel, byte i of a texel is taken from its byte b<i>.
+template <int b0, int b1, int b2, int b3>
+std::size_t ShuffleTexels(const u8* in_data, u8* out_data, std::size_t num_texels) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        b0, b1, b2, b3, b0 + 4, b1 + 4, b2 + 4, b3 + 4, b0 + 8, b1 + 8, b2 + 8, b3 + 8, b0 + 12,
+        b1 + 12, b2 + 12, b3 + 12, b0, b1, b2, b3, b0 + 4, b1 + 4, b2 + 4, b3 + 4, b0 + 8, b1 + 8,
+        b2 + 8, b3 + 8, b0 + 12, b1 + 12, b2 + 12, b3 + 12);
+    const std::size_t num_vectors = num_texels / TEXELS_PER_VECTOR;
+    for (std::size_t i = 0; i < num_vectors; ++i) {
+        const auto in = reinterpret_cast<const __m256i*>(in_data) + i;
+        const auto out = reinterpret_cast<__m256i*>(out_data) + i;
+        _mm256_storeu_si256(out, _mm256_shuffle_epi8(_mm256_loadu_si256(in), shuffle));
+    }
+    return num_vectors * TEXELS_PER_VECTOR;
+}
+
+} // Anonymous namespace
+
+bool IsSupported() {
+    return Common::GetCPUCaps().avx2;
+}
+
+std::size_t ConvertS8Z24ToZ24S8(const u8* in_data, u8* out_data, std::size_t num_texels) {
+    return ShuffleTexels<3, 0, 1, 2>(in_data, out_data, num_texels);
+}
+
+std::size_t ConvertZ24S8ToS8Z24(const u8* in_data, u8* out_data, std::size_t num_texels) {
+    return ShuffleTexels<1, 2, 3, 0>(in_data, out_data, num_texels);
+}
+
+} // namespace Tegra::Texture::AVX2
@@ -0,0 +1,28 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+
+/// Texel conversion loops of convert.cpp implemented with AVX2. Only available on x86-64 hosts.
+namespace Tegra::Texture::AVX2 {
+
+/// Returns true when the host CPU supports the instructions used by this module.
+bool IsSupported();
+
+/**
+ * Moves the stencil of S8Z24 texels from the high to the low byte. Input and output may alias.
+ * @returns Number of texels converted, the remaining ones don't fill a whole vector.
+ */
+std::size_t ConvertS8Z24ToZ24S8(const u8* in_data, u8* out_data, std::size_t num_texels);
+
+/**
+ * Moves the stencil of Z24S8 texels from the low to the high byte. Input and output may alias.
+ * @returns Number of texels converted, the remaining ones don't fill a whole vector.
+ */
+std::size_t ConvertZ24S8ToS8Z24(const u8* in_data, u8* out_data, std::size_t num_texels);
+
+} // namespace Tegra::Texture::AVX2
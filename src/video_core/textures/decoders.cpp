@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <type_traits>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "video_core/gpu.h"
@@ -55,12 +56,17 @@ constexpr auto fast_swizzle_table = SwizzleTable<gob_size_y, 4, fast_swizzle_ali
  * This function manages ALL the GOBs(Group of Bytes) Inside a single block.
  * Instead of going gob by gob, we map the coordinates inside a block and manage from
  * those. Block_Width is assumed to be 1.
+ * When static_bpp is not zero, it's the size of both the input and output pixels, known at
+ * compile time so the per pixel copy turns into a single move.
  */
+template <u32 static_bpp>
 void PreciseProcessBlock(u8* const swizzled_data, u8* const unswizzled_data, const bool unswizzle,
                          const u32 x_start, const u32 y_start, const u32 z_start, const u32 x_end,
                          const u32 y_end, const u32 z_end, const u32 tile_offset,
                          const u32 xy_block_size, const u32 layer_z, const u32 stride_x,
-                         const u32 bytes_per_pixel, const u32 out_bytes_per_pixel) {
+                         const u32 runtime_bpp, const u32 runtime_out_bpp) {
+    const u32 bytes_per_pixel = static_bpp != 0 ? static_bpp : runtime_bpp;
+    const u32 out_bytes_per_pixel = static_bpp != 0 ? static_bpp : runtime_out_bpp;
     std::array<u8*, 2> data_ptrs;
     u32 z_address = tile_offset;
 
@@ -84,6 +90,27 @@ void PreciseProcessBlock(u8* const swizzled_data, u8* const unswizzled_data, con
     }
 }
 
+/**
+ * Copies a whole GOB between its swizzled layout and linear lines of the given stride. The
+ * offsets come from a constant table, so this unrolls into plain 16 byte vector moves.
+ */
+template <bool unswizzle>
+void CopyGob(u8* const swizzled_gob, u8* const linear, const u32 stride) {
+    for (u32 y = 0; y < gob_size_y; ++y) {
+        const auto& table = fast_swizzle_table[y];
+        u8* const line = linear + y * stride;
+        for (u32 x = 0; x < gob_size_x / fast_swizzle_align; ++x) {
+            u8* const swizzled = swizzled_gob + table[x];
+            u8* const unswizzled = line + x * fast_swizzle_align;
+            if constexpr (unswizzle) {
+                std::memcpy(unswizzled, swizzled, fast_swizzle_align);
+            } else {
+                std::memcpy(swizzled, unswizzled, fast_swizzle_align);
+            }
+        }
+    }
+}
+
 /**
  * This function manages ALL the GOBs(Group of Bytes) Inside a single block.
  * Instead of going gob by gob, we map the coordinates inside a block and manage from
@@ -98,11 +125,28 @@ void FastProcessBlock(u8* const swizzled_data, u8* const unswizzled_data, const
     u32 z_address = tile_offset;
     const u32 x_startb = x_start * bytes_per_pixel;
     const u32 x_endb = x_end * bytes_per_pixel;
+    // Blocks spanning a whole GOB row with no pixel size conversion are copied a GOB at a time.
+    const bool whole_gobs =
+        x_endb - x_startb == gob_size_x && bytes_per_pixel == out_bytes_per_pixel;
 
     for (u32 z = z_start; z < z_end; z++) {
         u32 y_address = z_address;
         u32 pixel_base = layer_z * z + y_start * stride_x;
-        for (u32 y = y_start; y < y_end; y++) {
+        u32 y = y_start;
+        if (whole_gobs) {
+            for (; y + gob_size_y <= y_end; y += gob_size_y) {
+                u8* const swizzled_gob = swizzled_data + y_address;
+                u8* const linear = unswizzled_data + pixel_base + x_startb;
+                if (unswizzle) {
+                    CopyGob<true>(swizzled_gob, linear, stride_x);
+                } else {
+                    CopyGob<false>(swizzled_gob, linear, stride_x);
+                }
+                pixel_base += gob_size_y * stride_x;
+                y_address += gob_size;
+            }
+        }
+        for (; y < y_end; y++) {
             const auto& table = fast_swizzle_table[y % gob_size_y];
             for (u32 xb = x_startb; xb < x_endb; xb += fast_swizzle_align) {
                 const u32 swizzle_offset{y_address + table[(xb / fast_swizzle_align) % 4]};
@@ -129,11 +173,13 @@ void FastProcessBlock(u8* const swizzled_data, u8* const unswizzled_data, const
  * Documentation for the memory layout and decoding can be found at:
  *  https://envytools.readthedocs.io/en/latest/hw/memory/g80-surface.html#blocklinear-surfaces
  */
-template <bool fast>
+template <bool fast, u32 static_bpp>
 void SwizzledData(u8* const swizzled_data, u8* const unswizzled_data, const bool unswizzle,
-                  const u32 width, const u32 height, const u32 depth, const u32 bytes_per_pixel,
-                  const u32 out_bytes_per_pixel, const u32 block_height, const u32 block_depth,
+                  const u32 width, const u32 height, const u32 depth, const u32 runtime_bpp,
+                  const u32 runtime_out_bpp, const u32 block_height, const u32 block_depth,
                   const u32 width_spacing) {
+    const u32 bytes_per_pixel = static_bpp != 0 ? static_bpp : runtime_bpp;
+    const u32 out_bytes_per_pixel = static_bpp != 0 ? static_bpp : runtime_out_bpp;
     auto div_ceil = [](const u32 x, const u32 y) { return ((x + y - 1) / y); };
     const u32 stride_x = width * out_bytes_per_pixel;
     const u32 layer_z = height * stride_x;
@@ -164,9 +210,10 @@ void SwizzledData(u8* const swizzled_data, u8* const unswizzled_data, const bool
                                      z_start, x_end, y_end, z_end, tile_offset, xy_block_size,
                                      layer_z, stride_x, bytes_per_pixel, out_bytes_per_pixel);
                 } else {
-                    PreciseProcessBlock(swizzled_data, unswizzled_data, unswizzle, x_start, y_start,
-                                        z_start, x_end, y_end, z_end, tile_offset, xy_block_size,
-                                        layer_z, stride_x, bytes_per_pixel, out_bytes_per_pixel);
+                    PreciseProcessBlock<static_bpp>(swizzled_data, unswizzled_data, unswizzle,
+                                                    x_start, y_start, z_start, x_end, y_end, z_end,
+                                                    tile_offset, xy_block_size, layer_z, stride_x,
+                                                    bytes_per_pixel, out_bytes_per_pixel);
                 }
                 tile_offset += block_size;
             }
@@ -174,17 +221,47 @@ void SwizzledData(u8* const swizzled_data, u8* const unswizzled_data, const bool
     }
 }
 
+/// Calls the precise SwizzledData instantiation for the pixel size, when it's a common one
+void PreciseSwizzledData(u8* const swizzled_data, u8* const unswizzled_data, const bool unswizzle,
+                         const u32 width, const u32 height, const u32 depth,
+                         const u32 bytes_per_pixel, const u32 out_bytes_per_pixel,
+                         const u32 block_height, const u32 block_depth, const u32 width_spacing) {
+    const auto call = [&](auto static_bpp) {
+        SwizzledData<false, decltype(static_bpp)::value>(
+            swizzled_data, unswizzled_data, unswizzle, width, height, depth, bytes_per_pixel,
+            out_bytes_per_pixel, block_height, block_depth, width_spacing);
+    };
+    if (bytes_per_pixel == out_bytes_per_pixel) {
+        switch (bytes_per_pixel) {
+        case 1:
+            return call(std::integral_constant<u32, 1>{});
+        case 2:
+            return call(std::integral_constant<u32, 2>{});
+        case 4:
+            return call(std::integral_constant<u32, 4>{});
+        case 8:
+            return call(std::integral_constant<u32, 8>{});
+        case 12:
+            return call(std::integral_constant<u32, 12>{});
+        case 16:
+            return call(std::integral_constant<u32, 16>{});
+        }
+    }
+    call(std::integral_constant<u32, 0>{});
+}
+
 void CopySwizzledData(u32 width, u32 height, u32 depth, u32 bytes_per_pixel,
                       u32 out_bytes_per_pixel, u8* const swizzled_data, u8* const unswizzled_data,
                       bool unswizzle, u32 block_height, u32 block_depth, u32 width_spacing) {
     const u32 block_height_size{1U << block_height};
     const u32 block_depth_size{1U << block_depth};
     if (bytes_per_pixel % 3 != 0 && (width * bytes_per_pixel) % fast_swizzle_align == 0) {
-        SwizzledData<true>(swizzled_data, unswizzled_data, unswizzle, width, height, depth,
-                           bytes_per_pixel, out_bytes_per_pixel, block_height_size,
-                           block_depth_size, width_spacing);
+        // The fast path copies 16 bytes at a time regardless of the pixel size
+        SwizzledData<true, 0>(swizzled_data, unswizzled_data, unswizzle, width, height, depth,
+                              bytes_per_pixel, out_bytes_per_pixel, block_height_size,
+                              block_depth_size, width_spacing);
     } else {
-        SwizzledData<false>(swizzled_data, unswizzled_data, unswizzle, width, height, depth,
+        PreciseSwizzledData(swizzled_data, unswizzled_data, unswizzle, width, height, depth,
                             bytes_per_pixel, out_bytes_per_pixel, block_height_size,
                             block_depth_size, width_spacing);
     }
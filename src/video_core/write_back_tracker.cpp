@@ -0,0 +1,51 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/write_back_tracker.h"
+
+namespace VideoCommon {
+
+void WriteBackTracker::MarkWritten(CacheAddr addr, u64 size) {
+    if (size == 0) {
+        return;
+    }
+    const u64 page_end = ((addr + size - 1) >> PageBits) + 1;
+    std::lock_guard lock{mutex};
+    u64 num_marked = 0;
+    for (u64 page = addr >> PageBits; page < page_end; ++page) {
+        bool& is_written = pages[page];
+        num_marked += is_written ? 0 : 1;
+        is_written = true;
+    }
+    num_written_pages.fetch_add(num_marked, std::memory_order_relaxed);
+}
+
+bool WriteBackTracker::IsWritten(CacheAddr addr, u64 size) const {
+    if (size == 0 || num_written_pages.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    const u64 page_end = ((addr + size - 1) >> PageBits) + 1;
+    std::lock_guard lock{mutex};
+    return pages.ForEachInRange(addr >> PageBits, page_end,
+                                [](u64, bool is_written) { return is_written; });
+}
+
+void WriteBackTracker::Clear(CacheAddr addr, u64 size) {
+    if (size == 0) {
+        return;
+    }
+    const u64 page_end = ((addr + size - 1) >> PageBits) + 1;
+    std::lock_guard lock{mutex};
+    u64 num_cleared = 0;
+    for (u64 page = addr >> PageBits; page < page_end; ++page) {
+        bool* const is_written = pages.Find(page);
+        if (is_written && *is_written) {
+            *is_written = false;
+            ++num_cleared;
+        }
+    }
+    num_written_pages.fetch_sub(num_cleared, std::memory_order_relaxed);
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,45 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+#include "common/common_types.h"
+#include "video_core/gpu.h"
+#include "video_core/radix_table.h"
+
+namespace VideoCommon {
+
+/**
+ * Tracks the pages of host cached memory the GPU has written and the CPU hasn't seen yet.
+ *
+ * The caches mark the ranges they modify (render targets, storage buffers, copy destinations and
+ * query reports) from the GPU thread, and the CPU only has to flush ranges touching a marked page.
+ * Tracking is conservative: a page stays marked until a flush covering it has finished.
+ */
+class WriteBackTracker {
+public:
+    static constexpr std::size_t PageBits = 12;
+    static constexpr u64 PageSize = 1ULL << PageBits;
+
+    /// Records that the GPU wrote [addr, addr + size).
+    void MarkWritten(CacheAddr addr, u64 size);
+
+    /// Returns true when the GPU wrote a page of [addr, addr + size) that hasn't been flushed.
+    bool IsWritten(CacheAddr addr, u64 size) const;
+
+    /// Forgets the writes to the pages touching [addr, addr + size), once they have been flushed.
+    void Clear(CacheAddr addr, u64 size);
+
+private:
+    mutable std::mutex mutex;
+    RadixTable<bool, 6> pages;
+    /// Number of marked pages, lets the CPU skip the lock while the GPU hasn't written anything.
+    std::atomic<u64> num_written_pages{0};
+};
+
+} // namespace VideoCommon
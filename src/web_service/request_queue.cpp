@@ -0,0 +1,122 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "web_service/request_queue.h"
+#include "web_service/web_backend.h"
+
+namespace WebService {
+
+namespace {
+
+constexpr std::size_t MAX_PENDING_REQUESTS = 16;
+
+constexpr auto SHUTDOWN_TIMEOUT = std::chrono::seconds{2};
+
+} // Anonymous namespace
+
+struct RequestQueue::State {
+    struct PendingRequest {
+        std::string host;
+        std::string username;
+        std::string token;
+        Request request;
+    };
+
+    /// Runs the requests until the queue is stopped, shared with the queue so it outlives it
+    static void WorkerLoop(std::shared_ptr<State> state) {
+        Common::SetCurrentThreadName("yuzu:WebService");
+
+        std::map<std::tuple<std::string, std::string, std::string>, std::unique_ptr<Client>>
+            clients;
+        std::unique_lock lock{state->mutex};
+        while (true) {
+            state->cv.wait(lock, [&] { return state->stop_requested || !state->pending.empty(); });
+            if (state->pending.empty()) {
+                break;
+            }
+
+            PendingRequest pending = std::move(state->pending.front());
+            state->pending.pop_front();
+            state->busy = true;
+            lock.unlock();
+
+            auto& client = clients[{pending.host, pending.username, pending.token}];
+            if (client == nullptr) {
+                client = std::make_unique<Client>(pending.host, pending.username, pending.token);
+            }
+            pending.request(*client);
+
+            lock.lock();
+            state->busy = false;
+            state->idle_cv.notify_all();
+        }
+        state->idle_cv.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable idle_cv;
+    std::deque<PendingRequest> pending;
+    bool busy = false;
+    bool stop_requested = false;
+    std::thread worker;
+};
+
+RequestQueue& RequestQueue::GetInstance() {
+    static RequestQueue instance;
+    return instance;
+}
+
+RequestQueue::RequestQueue() : state{std::make_shared<State>()} {
+    state->worker = std::thread(&State::WorkerLoop, state);
+}
+
+RequestQueue::~RequestQueue() {
+    std::unique_lock lock{state->mutex};
+    state->stop_requested = true;
+    state->cv.notify_one();
+
+    const bool finished = state->idle_cv.wait_for(lock, SHUTDOWN_TIMEOUT, [this] {
+        return state->pending.empty() && !state->busy;
+    });
+    if (!finished) {
+        LOG_WARNING(WebService, "Abandoning {} requests to the web service",
+                    state->pending.size() + (state->busy ? 1 : 0));
+        state->pending.clear();
+    }
+    lock.unlock();
+
+    // A request stuck on the network must not hold up the exit, the worker keeps the state alive
+    if (finished) {
+        state->worker.join();
+    } else {
+        state->worker.detach();
+    }
+}
+
+bool RequestQueue::Push(std::string host, std::string username, std::string token,
+                        Request request) {
+    {
+        std::lock_guard lock{state->mutex};
+        if (state->stop_requested || state->pending.size() >= MAX_PENDING_REQUESTS) {
+            LOG_WARNING(WebService, "Too many pending requests to the web service, dropping one");
+            return false;
+        }
+        state->pending.push_back(
+            {std::move(host), std::move(username), std::move(token), std::move(request)});
+    }
+    state->cv.notify_one();
+    return true;
+}
+
+} // namespace WebService
@@ -0,0 +1,48 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace WebService {
+
+class Client;
+
+/**
+ * Runs the requests to the web service on a thread of its own, so neither booting nor shutting
+ * down the emulator ever waits on the network.
+ *
+ * Requests run one after the other on a Client kept per host and credentials, so later requests
+ * reuse its connection setup and JWT. At most MAX_PENDING_REQUESTS wait to run, newer ones are
+ * dropped. On exit, pending requests get SHUTDOWN_TIMEOUT to finish before they are abandoned.
+ */
+class RequestQueue {
+public:
+    using Request = std::function<void(Client&)>;
+
+    static RequestQueue& GetInstance();
+
+    ~RequestQueue();
+
+    RequestQueue(const RequestQueue&) = delete;
+    RequestQueue& operator=(const RequestQueue&) = delete;
+
+    /**
+     * Queues a request to run on the client of the given host and credentials.
+     * @returns false when too many requests are pending and the request was dropped
+     */
+    bool Push(std::string host, std::string username, std::string token, Request request);
+
+private:
+    struct State;
+
+    RequestQueue();
+
+    std::shared_ptr<State> state;
+};
+
+} // namespace WebService
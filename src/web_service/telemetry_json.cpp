@@ -2,9 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <future>
 #include <json.hpp>
-#include "common/detached_tasks.h"
 #include "common/web_result.h"
+#include "web_service/request_queue.h"
 #include "web_service/telemetry_json.h"
 #include "web_service/web_backend.h"
 
@@ -99,16 +100,16 @@ void TelemetryJson::Visit(const Telemetry::Field<std::chrono::microseconds>& fie
 }
 
 void TelemetryJson::Complete() {
-    impl->SerializeSection(Telemetry::FieldType::App, "App");
-    impl->SerializeSection(Telemetry::FieldType::Session, "Session");
-    impl->SerializeSection(Telemetry::FieldType::Performance, "Performance");
-    impl->SerializeSection(Telemetry::FieldType::UserConfig, "UserConfig");
-    impl->SerializeSection(Telemetry::FieldType::UserSystem, "UserSystem");
-
-    auto content = impl->TopSection().dump();
-    // Send the telemetry async but don't handle the errors since they were written to the log
-    Common::DetachedTasks::AddTask([host{impl->host}, content]() {
-        Client{host, "", ""}.PostJson("/telemetry", content, true);
+    // Both the serialization and the submission happen on the web service thread, the errors
+    // aren't handled since they were written to the log
+    std::shared_ptr<Impl> session = std::move(impl);
+    RequestQueue::GetInstance().Push(session->host, "", "", [session](Client& client) {
+        session->SerializeSection(Telemetry::FieldType::App, "App");
+        session->SerializeSection(Telemetry::FieldType::Session, "Session");
+        session->SerializeSection(Telemetry::FieldType::Performance, "Performance");
+        session->SerializeSection(Telemetry::FieldType::UserConfig, "UserConfig");
+        session->SerializeSection(Telemetry::FieldType::UserSystem, "UserSystem");
+        client.PostJson("/telemetry", session->TopSection().dump(), true);
     });
 }
 
@@ -119,11 +120,16 @@ bool TelemetryJson::SubmitTestcase() {
     impl->SerializeSection(Telemetry::FieldType::UserSystem, "UserSystem");
     impl->SerializeSection(Telemetry::FieldType::UserConfig, "UserConfig");
 
-    auto content = impl->TopSection().dump();
-    Client client(impl->host, impl->username, impl->token);
-    auto value = client.PostJson("/gamedb/testcase", content, false);
-
-    return value.result_code == Common::WebResult::Code::Success;
+    // The caller waits for the result, but the request still shares the web service thread
+    auto result = std::make_shared<std::promise<bool>>();
+    std::future<bool> submitted = result->get_future();
+    const bool queued = RequestQueue::GetInstance().Push(
+        impl->host, impl->username, impl->token,
+        [result, content = impl->TopSection().dump()](Client& client) {
+            const auto value = client.PostJson("/gamedb/testcase", content, false);
+            result->set_value(value.result_code == Common::WebResult::Code::Success);
+        });
+    return queued && submitted.get();
 }
 
 } // namespace WebService
@@ -56,6 +56,6 @@ void QtErrorDisplay::ShowCustomErrorText(ResultCode error, std::string dialog_te
 
 void QtErrorDisplay::MainWindowFinishedError() {
     // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{HLE::GetLock()};
     callback();
 }
@@ -146,6 +146,6 @@ void QtProfileSelector::SelectProfile(
 
 void QtProfileSelector::MainWindowFinishedSelection(std::optional<Common::UUID> uuid) {
     // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{HLE::GetLock()};
     callback(uuid);
 }
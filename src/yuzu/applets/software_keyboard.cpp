@@ -142,12 +142,12 @@ void QtSoftwareKeyboard::SendTextCheckDialog(std::u16string error_message,
 
 void QtSoftwareKeyboard::MainWindowFinishedText(std::optional<std::u16string> text) {
     // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{HLE::GetLock()};
     text_output(std::move(text));
 }
 
 void QtSoftwareKeyboard::MainWindowFinishedCheckDialog() {
     // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{HLE::GetLock()};
     finished_check();
 }
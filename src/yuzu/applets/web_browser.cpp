@@ -104,12 +104,12 @@ void QtWebBrowser::OpenPageLocal(std::string_view url, std::function<void()> unp
 
 void QtWebBrowser::MainWindowUnpackRomFS() {
     // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{HLE::GetLock()};
     unpack_romfs_callback();
 }
 
 void QtWebBrowser::MainWindowFinishedBrowsing() {
     // Acquire the HLE mutex
-    std::lock_guard lock{HLE::g_hle_lock};
+    std::lock_guard lock{HLE::GetLock()};
     finished_callback();
 }
@@ -5,12 +5,12 @@
 #include <glad/glad.h>
 
 #include <QApplication>
+#include <QFontDatabase>
 #include <QHBoxLayout>
 #include <QKeyEvent>
+#include <QLabel>
 #include <QMessageBox>
 #include <QOffscreenSurface>
-#include <QOpenGLWindow>
-#include <QPainter>
 #include <QScreen>
 #include <QStringList>
 #include <QWindow>
@@ -21,11 +21,14 @@
 #include <fmt/format.h>
 
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
 #include "core/core.h"
 #include "core/frontend/framebuffer_layout.h"
 #include "core/frontend/scope_acquire_window_context.h"
+#include "core/perf_stats.h"
+#include "core/save_state.h"
 #include "core/settings.h"
 #include "input_common/keyboard.h"
 #include "input_common/main.h"
@@ -63,6 +66,7 @@ void EmuThread::run() {
     // next execution step
     bool was_active = false;
     while (!stop_run) {
+        ProcessStateRequests();
         if (running) {
             if (!was_active)
                 emit DebugModeLeft();
@@ -88,7 +92,10 @@ void EmuThread::run() {
             was_active = false;
         } else {
             std::unique_lock lock{running_mutex};
-            running_cv.wait(lock, [this] { return IsRunning() || exec_step || stop_run; });
+            running_cv.wait(lock, [this] {
+                return IsRunning() || exec_step || stop_run || save_state_requested ||
+                       load_state_requested;
+            });
         }
     }
 
@@ -102,6 +109,21 @@ void EmuThread::run() {
     render_window->moveContext();
 }
 
+void EmuThread::ProcessStateRequests() {
+    Core::System& system = Core::System::GetInstance();
+    if (save_state_requested.exchange(false)) {
+        save_state = system.CreateSaveState();
+    }
+    if (load_state_requested.exchange(false)) {
+        if (save_state == nullptr) {
+            LOG_WARNING(Frontend, "No state has been saved yet");
+        } else if (!system.LoadSaveState(*save_state)) {
+            // The state belongs to an application that is no longer running
+            save_state.reset();
+        }
+    }
+}
+
 class GGLContext : public Core::Frontend::GraphicsContext {
 public:
     explicit GGLContext(QOpenGLContext* shared_context) : shared_context{shared_context} {
@@ -125,6 +147,40 @@ private:
     QOpenGLContext context;
 };
 
+/// Context presenting to the render window from the thread that first makes it current. Qt only
+/// lets contexts be made current from the thread they live in, so it is created there.
+class GGLPresentationContext : public Core::Frontend::GraphicsContext {
+public:
+    explicit GGLPresentationContext(GRenderWindow* render_window, QOpenGLContext* shared_context,
+                                    QWindow* surface)
+        : render_window{render_window}, shared_context{shared_context}, surface{surface} {}
+
+    void MakeCurrent() override {
+        if (!context) {
+            context = std::make_unique<QOpenGLContext>();
+            context->setFormat(shared_context->format());
+            context->setShareContext(shared_context);
+            context->create();
+        }
+        context->makeCurrent(surface);
+    }
+
+    void DoneCurrent() override {
+        context->doneCurrent();
+    }
+
+    void SwapBuffers() override {
+        context->swapBuffers(surface);
+        render_window->OnFrameDisplayed();
+    }
+
+private:
+    GRenderWindow* render_window;
+    QOpenGLContext* shared_context;
+    QWindow* surface;
+    std::unique_ptr<QOpenGLContext> context;
+};
+
 class GWidgetInternal : public QWindow {
 public:
     GWidgetInternal(GRenderWindow* parent) : parent(parent) {}
@@ -176,42 +232,25 @@ public:
             InputCommon::GetMotionEmu()->EndTilt();
     }
 
-    void DisablePainting() {
-        do_painting = false;
-    }
-
-    void EnablePainting() {
-        do_painting = true;
-    }
-
     std::pair<unsigned, unsigned> GetSize() const {
         return std::make_pair(width(), height());
     }
 
-protected:
-    bool IsPaintingEnabled() const {
-        return do_painting;
-    }
-
 private:
     GRenderWindow* parent;
-    bool do_painting = false;
 };
 
-// This class overrides paintEvent and resizeEvent to prevent the GUI thread from stealing GL
-// context.
-// The corresponding functionality is handled in EmuThread instead
-class GGLWidgetInternal final : public GWidgetInternal, public QOpenGLWindow {
+// Native window the renderer presents to from its own thread. Unlike a QOpenGLWindow, Qt never
+// paints into it nor makes a context current on it from the GUI thread, so busy menus, dialogs or
+// window drags never wait on the renderer and the renderer never waits on them.
+class GGLWidgetInternal final : public GWidgetInternal {
 public:
-    GGLWidgetInternal(GRenderWindow* parent, QOpenGLContext* shared_context)
-        : GWidgetInternal(parent), QOpenGLWindow(shared_context) {}
-    ~GGLWidgetInternal() override = default;
-
-    void paintEvent(QPaintEvent* ev) override {
-        if (IsPaintingEnabled()) {
-            QPainter painter(this);
-        }
+    GGLWidgetInternal(GRenderWindow* parent, const QSurfaceFormat& format)
+        : GWidgetInternal(parent) {
+        setSurfaceType(QSurface::OpenGLSurface);
+        setFormat(format);
     }
+    ~GGLWidgetInternal() override = default;
 };
 
 #ifdef HAS_VULKAN
@@ -233,6 +272,13 @@ GRenderWindow::GRenderWindow(GMainWindow* parent, EmuThread* emu_thread)
                             QString::fromUtf8(Common::g_scm_desc)));
     setAttribute(Qt::WA_AcceptTouchEvents);
 
+    frame_timeline_label = new QLabel(this, Qt::ToolTip | Qt::FramelessWindowHint);
+    frame_timeline_label->setAttribute(Qt::WA_ShowWithoutActivating);
+    frame_timeline_label->setAttribute(Qt::WA_TransparentForMouseEvents);
+    frame_timeline_label->setStyleSheet(QStringLiteral(
+        "QLabel { background-color: rgba(0, 0, 0, 160); color: white; padding: 4px; }"));
+    frame_timeline_label->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
     InputCommon::Init();
     connect(this, &GRenderWindow::FirstFrameDisplayed, parent, &GMainWindow::OnLoadComplete);
 }
@@ -262,6 +308,10 @@ void GRenderWindow::SwapBuffers() {
     if (context) {
         context->swapBuffers(child);
     }
+    OnFrameDisplayed();
+}
+
+void GRenderWindow::OnFrameDisplayed() {
     if (!first_frame) {
         first_frame = true;
         emit FirstFrameDisplayed();
@@ -280,10 +330,16 @@ void GRenderWindow::DoneCurrent() {
     }
 }
 
-void GRenderWindow::PollEvents() {}
+void GRenderWindow::PollEvents() {
+    // Resizes are only applied between frames, from the thread that presents them
+    if (surface_resized.exchange(false, std::memory_order_acquire)) {
+        const u64 size = surface_size.load(std::memory_order_relaxed);
+        UpdateCurrentFramebufferLayout(static_cast<u32>(size >> 32), static_cast<u32>(size));
+    }
+}
 
 bool GRenderWindow::IsShown() const {
-    return !isMinimized();
+    return is_shown.load(std::memory_order_relaxed);
 }
 
 void GRenderWindow::RetrieveVulkanHandlers(void* get_instance_proc_addr, void* instance,
@@ -311,7 +367,17 @@ void GRenderWindow::OnFramebufferSizeChanged() {
     // framebuffer size
     const qreal pixelRatio{GetWindowPixelRatio()};
     const auto size{child->GetSize()};
-    UpdateCurrentFramebufferLayout(size.first * pixelRatio, size.second * pixelRatio);
+    const auto width = static_cast<u32>(size.first * pixelRatio);
+    const auto height = static_cast<u32>(size.second * pixelRatio);
+    if (emu_thread == nullptr) {
+        UpdateCurrentFramebufferLayout(width, height);
+        return;
+    }
+
+    // The renderer picks the new size up on its next frame, instead of the GUI thread changing
+    // the layout under it
+    surface_size.store(static_cast<u64>(width) << 32 | height, std::memory_order_relaxed);
+    surface_resized.store(true, std::memory_order_release);
 }
 
 void GRenderWindow::ForwardKeyPressEvent(QKeyEvent* event) {
@@ -410,6 +476,13 @@ bool GRenderWindow::event(QEvent* event) {
     return QWidget::event(event);
 }
 
+void GRenderWindow::changeEvent(QEvent* event) {
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        is_shown.store(!isMinimized(), std::memory_order_relaxed);
+    }
+}
+
 void GRenderWindow::focusOutEvent(QFocusEvent* event) {
     QWidget::focusOutEvent(event);
     InputCommon::GetKeyboard()->ReleaseAllKeys();
@@ -423,6 +496,14 @@ std::unique_ptr<Core::Frontend::GraphicsContext> GRenderWindow::CreateSharedCont
     return std::make_unique<GGLContext>(context.get());
 }
 
+std::unique_ptr<Core::Frontend::GraphicsContext> GRenderWindow::CreatePresentationContext() const {
+    if (!context) {
+        return nullptr;
+    }
+    return std::make_unique<GGLPresentationContext>(const_cast<GRenderWindow*>(this),
+                                                    shared_context.get(), child);
+}
+
 bool GRenderWindow::InitRenderTarget() {
     shared_context.reset();
     context.reset();
@@ -530,7 +611,7 @@ bool GRenderWindow::InitializeOpenGL() {
     context->create();
     fmt.setSwapInterval(false);
 
-    child = new GGLWidgetInternal(this, shared_context.get());
+    child = new GGLWidgetInternal(this, fmt);
     return true;
 }
 
@@ -621,12 +702,45 @@ QStringList GRenderWindow::GetUnsupportedGLExtensions() const {
 
 void GRenderWindow::OnEmulationStarting(EmuThread* emu_thread) {
     this->emu_thread = emu_thread;
-    child->DisablePainting();
+    // Drop resizes left over from the previous emulation, the layout was set when booting
+    surface_resized = false;
 }
 
 void GRenderWindow::OnEmulationStopping() {
     emu_thread = nullptr;
-    child->EnablePainting();
+    frame_timeline_label->hide();
+}
+
+void GRenderWindow::SetFrameTimelineVisible(bool visible) {
+    frame_timeline_visible = visible;
+    if (!visible) {
+        frame_timeline_label->hide();
+    }
+}
+
+void GRenderWindow::UpdateFrameTimeline(const Core::PerfStatsResults& results) {
+    if (!frame_timeline_visible || !isVisible()) {
+        frame_timeline_label->hide();
+        return;
+    }
+    const auto ms = [](double seconds) { return QString::number(seconds * 1000.0, 'f', 2); };
+    frame_timeline_label->setText(
+        tr("Milliseconds per frame
+"
+           "CPU  JIT %1  SVC %2  HLE %3  Idle %4
+"
+           "GPU  DMA %5  Macro %6  Draw %7  Shader %8  Texture %9
+"
+           "Host GPU %10")
+            .arg(ms(results.cpu_jit_time), ms(results.cpu_svc_time), ms(results.cpu_hle_time),
+                 ms(results.cpu_idle_time), ms(results.gpu_dma_time), ms(results.gpu_macro_time),
+                 ms(results.gpu_draw_time), ms(results.gpu_shader_time),
+                 ms(results.gpu_texture_time))
+            .arg(ms(results.host_gpu_time)));
+    frame_timeline_label->adjustSize();
+    // The render window may have moved along with the main window since the last update
+    frame_timeline_label->move(mapToGlobal(QPoint(8, 8)));
+    frame_timeline_label->show();
 }
 
 void GRenderWindow::showEvent(QShowEvent* event) {
@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 #include <QImage>
@@ -17,6 +18,7 @@
 #include "core/frontend/emu_window.h"
 
 class QKeyEvent;
+class QLabel;
 class QScreen;
 class QTouchEvent;
 class QStringList;
@@ -89,10 +91,39 @@ public:
         SetRunning(false);
     }
 
+    /**
+     * Requests for the emulation thread to save the state of the application in memory, replacing
+     * any previously saved one
+     * @note This function is thread-safe
+     */
+    void RequestSaveState() {
+        std::unique_lock lock{running_mutex};
+        save_state_requested = true;
+        lock.unlock();
+        running_cv.notify_all();
+    }
+
+    /**
+     * Requests for the emulation thread to go back to the last saved state
+     * @note This function is thread-safe
+     */
+    void RequestLoadState() {
+        std::unique_lock lock{running_mutex};
+        load_state_requested = true;
+        lock.unlock();
+        running_cv.notify_all();
+    }
+
 private:
+    /// Handles the save state requests, between two runs of the emulated cores
+    void ProcessStateRequests();
+
     bool exec_step = false;
     bool running = false;
     std::atomic_bool stop_run{false};
+    std::atomic_bool save_state_requested{false};
+    std::atomic_bool load_state_requested{false};
+    std::shared_ptr<const Core::SaveState> save_state;
     std::mutex running_mutex;
     std::condition_variable running_cv;
 
@@ -138,6 +169,10 @@ public:
     void RetrieveVulkanHandlers(void* get_instance_proc_addr, void* instance,
                                 void* surface) const override;
     std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreatePresentationContext() const override;
+
+    /// Called after every presented frame, from the thread that presents it
+    void OnFrameDisplayed();
 
     void ForwardKeyPressEvent(QKeyEvent* event);
     void ForwardKeyReleaseEvent(QKeyEvent* event);
@@ -151,6 +186,7 @@ public:
     std::pair<u32, u32> ScaleTouch(QPointF pos) const;
 
     void closeEvent(QCloseEvent* event) override;
+    void changeEvent(QEvent* event) override;
     bool event(QEvent* event) override;
     void focusOutEvent(QFocusEvent* event) override;
 
@@ -160,12 +196,16 @@ public:
 
     void CaptureScreenshot(u32 res_scale, const QString& screenshot_path);
 
+    /// Shows the frame time breakdown of the given stats over the rendered frames.
+    void UpdateFrameTimeline(const Core::PerfStatsResults& results);
+
 public slots:
     void moveContext(); // overridden
 
     void OnEmulationStarting(EmuThread* emu_thread);
     void OnEmulationStopping();
     void OnFramebufferSizeChanged();
+    void SetFrameTimelineVisible(bool visible);
 
 signals:
     /// Emitted when the window is closed
@@ -204,6 +244,16 @@ private:
     QByteArray geometry;
     bool first_frame = false;
 
+    /// Pixel size of the render surface, width in the upper half, waiting for the renderer to
+    /// apply it when surface_resized is set. Written by the GUI thread only.
+    std::atomic<u64> surface_size{0};
+    std::atomic_bool surface_resized{false};
+    std::atomic_bool is_shown{true};
+
+    /// Separate window floating over the render target, which native windows would hide
+    QLabel* frame_timeline_label = nullptr;
+    bool frame_timeline_visible = false;
+
 protected:
     void showEvent(QShowEvent* event) override;
 };
@@ -212,7 +212,7 @@ const std::array<int, Settings::NativeKeyboard::NumKeyboardMods> Config::default
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 15> default_hotkeys{{
+const std::array<UISettings::Shortcut, 17> default_hotkeys{{
     {QStringLiteral("Capture Screenshot"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+P"), Qt::ApplicationShortcut}},
     {QStringLiteral("Continue/Pause Emulation"), QStringLiteral("Main Window"), {QStringLiteral("F4"), Qt::WindowShortcut}},
     {QStringLiteral("Decrease Speed Limit"),     QStringLiteral("Main Window"), {QStringLiteral("-"), Qt::ApplicationShortcut}},
@@ -222,7 +222,9 @@ const std::array<UISettings::Shortcut, 15> default_hotkeys{{
     {QStringLiteral("Increase Speed Limit"),     QStringLiteral("Main Window"), {QStringLiteral("+"), Qt::ApplicationShortcut}},
     {QStringLiteral("Load Amiibo"),              QStringLiteral("Main Window"), {QStringLiteral("F2"), Qt::ApplicationShortcut}},
     {QStringLiteral("Load File"),                QStringLiteral("Main Window"), {QStringLiteral("Ctrl+O"), Qt::WindowShortcut}},
+    {QStringLiteral("Load State"),               QStringLiteral("Main Window"), {QStringLiteral("F8"), Qt::WindowShortcut}},
     {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"), Qt::WindowShortcut}},
+    {QStringLiteral("Save State"),               QStringLiteral("Main Window"), {QStringLiteral("F7"), Qt::WindowShortcut}},
     {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"), Qt::WindowShortcut}},
     {QStringLiteral("Toggle Filter Bar"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+F"), Qt::WindowShortcut}},
     {QStringLiteral("Toggle Speed Limit"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+Z"), Qt::ApplicationShortcut}},
@@ -407,6 +409,8 @@ void Config::ReadAudioValues() {
                                    .toStdString();
     Settings::values.enable_audio_stretching =
         ReadSetting(QStringLiteral("enable_audio_stretching"), true).toBool();
+    Settings::values.use_asynchronous_audio_decoding =
+        ReadSetting(QStringLiteral("use_asynchronous_audio_decoding"), false).toBool();
     Settings::values.audio_device_id =
         ReadSetting(QStringLiteral("output_device"), QStringLiteral("auto"))
             .toString()
@@ -430,6 +434,8 @@ void Config::ReadControlValues() {
                     QStringLiteral("engine:motion_emu,update_period:100,sensitivity:0.01"))
             .toString()
             .toStdString();
+    Settings::values.hid_sampling_rate =
+        static_cast<u16>(ReadSetting(QStringLiteral("hid_sampling_rate"), 66).toUInt());
     Settings::values.udp_input_address =
         ReadSetting(QStringLiteral("udp_input_address"),
                     QString::fromUtf8(InputCommon::CemuhookUDP::DEFAULT_ADDR))
@@ -448,6 +454,12 @@ void Config::ReadCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     Settings::values.use_multi_core = ReadSetting(QStringLiteral("use_multi_core"), false).toBool();
+    Settings::values.use_host_timing =
+        ReadSetting(QStringLiteral("use_host_timing"), false).toBool();
+    Settings::values.use_idle_skip = ReadSetting(QStringLiteral("use_idle_skip"), false).toBool();
+    Settings::values.preemption_quantum =
+        static_cast<u16>(ReadSetting(QStringLiteral("preemption_quantum"), 10).toUInt());
+    Settings::values.migration_cost = ReadSetting(QStringLiteral("migration_cost"), 0).toUInt();
 
     qt_config->endGroup();
 }
@@ -497,6 +509,9 @@ void Config::ReadDataStorageValues() {
         ReadSetting(QStringLiteral("gamecard_current_game"), false).toBool();
     Settings::values.gamecard_path =
         ReadSetting(QStringLiteral("gamecard_path"), QStringLiteral("")).toString().toStdString();
+    Settings::values.nca_cache_size = ReadSetting(QStringLiteral("nca_cache_size"), 64).toUInt();
+    Settings::values.use_shared_content_cache =
+        ReadSetting(QStringLiteral("use_shared_content_cache"), false).toBool();
     Settings::values.nand_total_size = static_cast<Settings::NANDTotalSize>(
         ReadSetting(QStringLiteral("nand_total_size"),
                     QVariant::fromValue<u64>(static_cast<u64>(Settings::NANDTotalSize::S29_1GB)))
@@ -523,12 +538,22 @@ void Config::ReadDebuggingValues() {
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     Settings::values.record_frame_times =
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
+    Settings::values.gpu_capture_start_frame =
+        qt_config->value(QStringLiteral("gpu_capture_start_frame"), 0).toUInt();
+    Settings::values.gpu_capture_frames =
+        qt_config->value(QStringLiteral("gpu_capture_frames"), 0).toUInt();
+    Settings::values.frame_capture_command =
+        qt_config->value(QStringLiteral("frame_capture_command"), QString{})
+            .toString()
+            .toStdString();
     Settings::values.use_gdbstub = ReadSetting(QStringLiteral("use_gdbstub"), false).toBool();
     Settings::values.gdbstub_port = ReadSetting(QStringLiteral("gdbstub_port"), 24689).toInt();
     Settings::values.program_args =
         ReadSetting(QStringLiteral("program_args"), QStringLiteral("")).toString().toStdString();
     Settings::values.dump_exefs = ReadSetting(QStringLiteral("dump_exefs"), false).toBool();
     Settings::values.dump_nso = ReadSetting(QStringLiteral("dump_nso"), false).toBool();
+    Settings::values.verify_nso_hashes =
+        ReadSetting(QStringLiteral("verify_nso_hashes"), false).toBool();
     Settings::values.reporting_services =
         ReadSetting(QStringLiteral("reporting_services"), false).toBool();
     Settings::values.quest_flag = ReadSetting(QStringLiteral("quest_flag"), false).toBool();
@@ -544,6 +569,12 @@ void Config::ReadServiceValues() {
             .toStdString();
     Settings::values.bcat_boxcat_local =
         ReadSetting(QStringLiteral("bcat_boxcat_local"), false).toBool();
+    Settings::values.ldn_relay_address =
+        ReadSetting(QStringLiteral("ldn_relay_address"), QStringLiteral("127.0.0.1"))
+            .toString()
+            .toStdString();
+    Settings::values.ldn_relay_port =
+        static_cast<u16>(ReadSetting(QStringLiteral("ldn_relay_port"), 30200).toInt());
     qt_config->endGroup();
 }
 
@@ -628,19 +659,42 @@ void Config::ReadRendererValues() {
         static_cast<Settings::RendererBackend>(ReadSetting(QStringLiteral("backend"), 0).toInt());
     Settings::values.renderer_debug = ReadSetting(QStringLiteral("debug"), false).toBool();
     Settings::values.vulkan_device = ReadSetting(QStringLiteral("vulkan_device"), 0).toInt();
+    Settings::values.vulkan_present_mode = static_cast<Settings::VulkanPresentMode>(
+        ReadSetting(QStringLiteral("vulkan_present_mode"), 0).toInt());
+    Settings::values.vulkan_frames_in_flight =
+        ReadSetting(QStringLiteral("vulkan_frames_in_flight"), 2).toUInt();
     Settings::values.resolution_factor =
         ReadSetting(QStringLiteral("resolution_factor"), 1.0).toFloat();
     Settings::values.use_frame_limit =
         ReadSetting(QStringLiteral("use_frame_limit"), true).toBool();
     Settings::values.frame_limit = ReadSetting(QStringLiteral("frame_limit"), 100).toInt();
+    Settings::values.align_frame_limit_to_vsync =
+        ReadSetting(QStringLiteral("align_frame_limit_to_vsync"), false).toBool();
+    Settings::values.vram_budget = ReadSetting(QStringLiteral("vram_budget"), 0).toUInt();
     Settings::values.use_disk_shader_cache =
         ReadSetting(QStringLiteral("use_disk_shader_cache"), true).toBool();
+    Settings::values.use_asynchronous_shaders =
+        ReadSetting(QStringLiteral("use_asynchronous_shaders"), false).toBool();
+    Settings::values.use_assembly_shaders =
+        ReadSetting(QStringLiteral("use_assembly_shaders"), true).toBool();
     Settings::values.use_accurate_gpu_emulation =
         ReadSetting(QStringLiteral("use_accurate_gpu_emulation"), false).toBool();
     Settings::values.use_asynchronous_gpu_emulation =
         ReadSetting(QStringLiteral("use_asynchronous_gpu_emulation"), false).toBool();
+    Settings::values.use_threaded_presentation =
+        ReadSetting(QStringLiteral("use_threaded_presentation"), false).toBool();
+    Settings::values.disable_macro_compiler =
+        ReadSetting(QStringLiteral("disable_macro_compiler"), false).toBool();
+    Settings::values.validate_macro_compiler =
+        ReadSetting(QStringLiteral("validate_macro_compiler"), false).toBool();
     Settings::values.force_30fps_mode =
         ReadSetting(QStringLiteral("force_30fps_mode"), false).toBool();
+    Settings::values.use_adaptive_composition =
+        ReadSetting(QStringLiteral("use_adaptive_composition"), false).toBool();
+    Settings::values.use_extra_host_buffer =
+        ReadSetting(QStringLiteral("use_extra_host_buffer"), false).toBool();
+    Settings::values.use_texture_hashing =
+        ReadSetting(QStringLiteral("use_texture_hashing"), false).toBool();
 
     Settings::values.bg_red = ReadSetting(QStringLiteral("bg_red"), 0.0).toFloat();
     Settings::values.bg_green = ReadSetting(QStringLiteral("bg_green"), 0.0).toFloat();
@@ -725,6 +779,8 @@ void Config::ReadUIValues() {
         ReadSetting(QStringLiteral("showFilterBar"), true).toBool();
     UISettings::values.show_status_bar =
         ReadSetting(QStringLiteral("showStatusBar"), true).toBool();
+    UISettings::values.show_frame_timeline =
+        ReadSetting(QStringLiteral("showFrameTimeline"), false).toBool();
     UISettings::values.confirm_before_closing =
         ReadSetting(QStringLiteral("confirmClose"), true).toBool();
     UISettings::values.first_start = ReadSetting(QStringLiteral("firstStart"), true).toBool();
@@ -907,6 +963,8 @@ void Config::SaveAudioValues() {
                  QStringLiteral("auto"));
     WriteSetting(QStringLiteral("enable_audio_stretching"),
                  Settings::values.enable_audio_stretching, true);
+    WriteSetting(QStringLiteral("use_asynchronous_audio_decoding"),
+                 Settings::values.use_asynchronous_audio_decoding, false);
     WriteSetting(QStringLiteral("output_device"),
                  QString::fromStdString(Settings::values.audio_device_id), QStringLiteral("auto"));
     WriteSetting(QStringLiteral("volume"), Settings::values.volume, 1.0f);
@@ -925,6 +983,7 @@ void Config::SaveControlValues() {
     WriteSetting(QStringLiteral("motion_device"),
                  QString::fromStdString(Settings::values.motion_device),
                  QStringLiteral("engine:motion_emu,update_period:100,sensitivity:0.01"));
+    WriteSetting(QStringLiteral("hid_sampling_rate"), Settings::values.hid_sampling_rate, 66);
     WriteSetting(QStringLiteral("keyboard_enabled"), Settings::values.keyboard_enabled, false);
     WriteSetting(QStringLiteral("udp_input_address"),
                  QString::fromStdString(Settings::values.udp_input_address),
@@ -940,6 +999,10 @@ void Config::SaveCoreValues() {
     qt_config->beginGroup(QStringLiteral("Core"));
 
     WriteSetting(QStringLiteral("use_multi_core"), Settings::values.use_multi_core, false);
+    WriteSetting(QStringLiteral("use_host_timing"), Settings::values.use_host_timing, false);
+    WriteSetting(QStringLiteral("use_idle_skip"), Settings::values.use_idle_skip, false);
+    WriteSetting(QStringLiteral("preemption_quantum"), Settings::values.preemption_quantum, 10);
+    WriteSetting(QStringLiteral("migration_cost"), Settings::values.migration_cost, 0);
 
     qt_config->endGroup();
 }
@@ -968,6 +1031,9 @@ void Config::SaveDataStorageValues() {
                  false);
     WriteSetting(QStringLiteral("gamecard_path"),
                  QString::fromStdString(Settings::values.gamecard_path), QStringLiteral(""));
+    WriteSetting(QStringLiteral("nca_cache_size"), Settings::values.nca_cache_size, 64);
+    WriteSetting(QStringLiteral("use_shared_content_cache"),
+                 Settings::values.use_shared_content_cache, false);
     WriteSetting(QStringLiteral("nand_total_size"),
                  QVariant::fromValue<u64>(static_cast<u64>(Settings::values.nand_total_size)),
                  QVariant::fromValue<u64>(static_cast<u64>(Settings::NANDTotalSize::S29_1GB)));
@@ -988,12 +1054,18 @@ void Config::SaveDebuggingValues() {
 
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
+    qt_config->setValue(QStringLiteral("gpu_capture_start_frame"),
+                        Settings::values.gpu_capture_start_frame);
+    qt_config->setValue(QStringLiteral("gpu_capture_frames"), Settings::values.gpu_capture_frames);
+    qt_config->setValue(QStringLiteral("frame_capture_command"),
+                        QString::fromStdString(Settings::values.frame_capture_command));
     WriteSetting(QStringLiteral("use_gdbstub"), Settings::values.use_gdbstub, false);
     WriteSetting(QStringLiteral("gdbstub_port"), Settings::values.gdbstub_port, 24689);
     WriteSetting(QStringLiteral("program_args"),
                  QString::fromStdString(Settings::values.program_args), QStringLiteral(""));
     WriteSetting(QStringLiteral("dump_exefs"), Settings::values.dump_exefs, false);
     WriteSetting(QStringLiteral("dump_nso"), Settings::values.dump_nso, false);
+    WriteSetting(QStringLiteral("verify_nso_hashes"), Settings::values.verify_nso_hashes, false);
     WriteSetting(QStringLiteral("quest_flag"), Settings::values.quest_flag, false);
 
     qt_config->endGroup();
@@ -1004,6 +1076,10 @@ void Config::SaveServiceValues() {
     WriteSetting(QStringLiteral("bcat_backend"),
                  QString::fromStdString(Settings::values.bcat_backend), QStringLiteral("null"));
     WriteSetting(QStringLiteral("bcat_boxcat_local"), Settings::values.bcat_boxcat_local, false);
+    WriteSetting(QStringLiteral("ldn_relay_address"),
+                 QString::fromStdString(Settings::values.ldn_relay_address),
+                 QStringLiteral("127.0.0.1"));
+    WriteSetting(QStringLiteral("ldn_relay_port"), Settings::values.ldn_relay_port, 30200);
     qt_config->endGroup();
 }
 
@@ -1063,17 +1139,40 @@ void Config::SaveRendererValues() {
     WriteSetting(QStringLiteral("backend"), static_cast<int>(Settings::values.renderer_backend), 0);
     WriteSetting(QStringLiteral("debug"), Settings::values.renderer_debug, false);
     WriteSetting(QStringLiteral("vulkan_device"), Settings::values.vulkan_device, 0);
+    WriteSetting(QStringLiteral("vulkan_present_mode"),
+                 static_cast<int>(Settings::values.vulkan_present_mode), 0);
+    WriteSetting(QStringLiteral("vulkan_frames_in_flight"),
+                 Settings::values.vulkan_frames_in_flight, 2);
     WriteSetting(QStringLiteral("resolution_factor"),
                  static_cast<double>(Settings::values.resolution_factor), 1.0);
     WriteSetting(QStringLiteral("use_frame_limit"), Settings::values.use_frame_limit, true);
     WriteSetting(QStringLiteral("frame_limit"), Settings::values.frame_limit, 100);
+    WriteSetting(QStringLiteral("align_frame_limit_to_vsync"),
+                 Settings::values.align_frame_limit_to_vsync, false);
+    WriteSetting(QStringLiteral("vram_budget"), Settings::values.vram_budget, 0);
     WriteSetting(QStringLiteral("use_disk_shader_cache"), Settings::values.use_disk_shader_cache,
                  true);
+    WriteSetting(QStringLiteral("use_asynchronous_shaders"),
+                 Settings::values.use_asynchronous_shaders, false);
+    WriteSetting(QStringLiteral("use_assembly_shaders"), Settings::values.use_assembly_shaders,
+                 true);
     WriteSetting(QStringLiteral("use_accurate_gpu_emulation"),
                  Settings::values.use_accurate_gpu_emulation, false);
     WriteSetting(QStringLiteral("use_asynchronous_gpu_emulation"),
                  Settings::values.use_asynchronous_gpu_emulation, false);
+    WriteSetting(QStringLiteral("use_threaded_presentation"),
+                 Settings::values.use_threaded_presentation, false);
+    WriteSetting(QStringLiteral("disable_macro_compiler"),
+                 Settings::values.disable_macro_compiler, false);
+    WriteSetting(QStringLiteral("validate_macro_compiler"),
+                 Settings::values.validate_macro_compiler, false);
     WriteSetting(QStringLiteral("force_30fps_mode"), Settings::values.force_30fps_mode, false);
+    WriteSetting(QStringLiteral("use_adaptive_composition"),
+                 Settings::values.use_adaptive_composition, false);
+    WriteSetting(QStringLiteral("use_extra_host_buffer"), Settings::values.use_extra_host_buffer,
+                 false);
+    WriteSetting(QStringLiteral("use_texture_hashing"), Settings::values.use_texture_hashing,
+                 false);
 
     // Cast to double because Qt's written float values are not human-readable
     WriteSetting(QStringLiteral("bg_red"), static_cast<double>(Settings::values.bg_red), 0.0);
@@ -1145,6 +1244,8 @@ void Config::SaveUIValues() {
     WriteSetting(QStringLiteral("displayTitleBars"), UISettings::values.display_titlebar, true);
     WriteSetting(QStringLiteral("showFilterBar"), UISettings::values.show_filter_bar, true);
     WriteSetting(QStringLiteral("showStatusBar"), UISettings::values.show_status_bar, true);
+    WriteSetting(QStringLiteral("showFrameTimeline"), UISettings::values.show_frame_timeline,
+                 false);
     WriteSetting(QStringLiteral("confirmClose"), UISettings::values.confirm_before_closing, true);
     WriteSetting(QStringLiteral("firstStart"), UISettings::values.first_start, true);
     WriteSetting(QStringLiteral("calloutFlags"), UISettings::values.callout_flags, 0);
@@ -54,8 +54,8 @@ std::size_t WaitTreeItem::Row() const {
     return row;
 }
 
-std::vector<std::unique_ptr<WaitTreeThread>> WaitTreeItem::MakeThreadItemList() {
-    std::vector<std::unique_ptr<WaitTreeThread>> item_list;
+std::vector<std::unique_ptr<WaitTreeItem>> WaitTreeItem::MakeTopLevelItemList() {
+    std::vector<std::unique_ptr<WaitTreeItem>> item_list;
     std::size_t row = 0;
     auto add_threads = [&](const std::vector<std::shared_ptr<Kernel::Thread>>& threads) {
         for (std::size_t i = 0; i < threads.size(); ++i) {
@@ -68,6 +68,9 @@ std::vector<std::unique_ptr<WaitTreeThread>> WaitTreeItem::MakeThreadItemList()
     const auto& system = Core::System::GetInstance();
     add_threads(system.GlobalScheduler().GetThreadList());
 
+    item_list.push_back(std::make_unique<WaitTreeSchedulerStatistics>());
+    item_list.back()->row = row;
+
     return item_list;
 }
 
@@ -341,6 +344,30 @@ std::vector<std::unique_ptr<WaitTreeItem>> WaitTreeThreadList::GetChildren() con
     return list;
 }
 
+WaitTreeSchedulerStatistics::WaitTreeSchedulerStatistics() = default;
+WaitTreeSchedulerStatistics::~WaitTreeSchedulerStatistics() = default;
+
+QString WaitTreeSchedulerStatistics::GetText() const {
+    return tr("scheduler statistics");
+}
+
+std::vector<std::unique_ptr<WaitTreeItem>> WaitTreeSchedulerStatistics::GetChildren() const {
+    std::vector<std::unique_ptr<WaitTreeItem>> list;
+
+    const auto& scheduler = Core::System::GetInstance().GlobalScheduler();
+    for (std::size_t core = 0; core < scheduler.CpuCoresCount(); ++core) {
+        const Kernel::SchedulerStatistics statistics = scheduler.GetStatistics(core);
+        list.push_back(std::make_unique<WaitTreeText>(
+            tr("core %1: %2 context switches, %3 migrations, %4 preemptions, %5 idle selections")
+                .arg(core)
+                .arg(statistics.context_switches)
+                .arg(statistics.migrations)
+                .arg(statistics.preemptions)
+                .arg(statistics.idle_selections)));
+    }
+    return list;
+}
+
 WaitTreeModel::WaitTreeModel(QObject* parent) : QAbstractItemModel(parent) {}
 WaitTreeModel::~WaitTreeModel() = default;
 
@@ -354,7 +381,7 @@ QModelIndex WaitTreeModel::index(int row, int column, const QModelIndex& parent)
         return createIndex(row, column, parent_item->Children()[row].get());
     }
 
-    return createIndex(row, column, thread_items[row].get());
+    return createIndex(row, column, items[row].get());
 }
 
 QModelIndex WaitTreeModel::parent(const QModelIndex& index) const {
@@ -370,7 +397,7 @@ QModelIndex WaitTreeModel::parent(const QModelIndex& index) const {
 
 int WaitTreeModel::rowCount(const QModelIndex& parent) const {
     if (!parent.isValid())
-        return static_cast<int>(thread_items.size());
+        return static_cast<int>(items.size());
 
     WaitTreeItem* parent_item = static_cast<WaitTreeItem*>(parent.internalPointer());
     parent_item->Expand();
@@ -396,11 +423,11 @@ QVariant WaitTreeModel::data(const QModelIndex& index, int role) const {
 }
 
 void WaitTreeModel::ClearItems() {
-    thread_items.clear();
+    items.clear();
 }
 
 void WaitTreeModel::InitItems() {
-    thread_items = WaitTreeItem::MakeThreadItemList();
+    items = WaitTreeItem::MakeTopLevelItemList();
 }
 
 WaitTreeWidget::WaitTreeWidget(QWidget* parent) : QDockWidget(tr("Wait Tree"), parent) {
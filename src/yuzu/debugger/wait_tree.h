@@ -40,7 +40,7 @@ public:
     WaitTreeItem* Parent() const;
     const std::vector<std::unique_ptr<WaitTreeItem>>& Children() const;
     std::size_t Row() const;
-    static std::vector<std::unique_ptr<WaitTreeThread>> MakeThreadItemList();
+    static std::vector<std::unique_ptr<WaitTreeItem>> MakeTopLevelItemList();
 
 private:
     std::size_t row;
@@ -158,6 +158,17 @@ private:
     const std::vector<std::shared_ptr<Kernel::Thread>>& thread_list;
 };
 
+/// Scheduling counters of every cpu core, to see how much a title makes the scheduler work
+class WaitTreeSchedulerStatistics : public WaitTreeExpandableItem {
+    Q_OBJECT
+public:
+    WaitTreeSchedulerStatistics();
+    ~WaitTreeSchedulerStatistics() override;
+
+    QString GetText() const override;
+    std::vector<std::unique_ptr<WaitTreeItem>> GetChildren() const override;
+};
+
 class WaitTreeModel : public QAbstractItemModel {
     Q_OBJECT
 
@@ -175,7 +186,7 @@ public:
     void InitItems();
 
 private:
-    std::vector<std::unique_ptr<WaitTreeThread>> thread_items;
+    std::vector<std::unique_ptr<WaitTreeItem>> items;
 };
 
 class WaitTreeWidget : public QDockWidget {
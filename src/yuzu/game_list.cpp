@@ -326,6 +326,7 @@ GameList::GameList(FileSys::VirtualFilesystem vfs, FileSys::ManualContentProvide
     // We must register all custom types with the Qt Automoc system so that we are able to use
     // it with signals/slots. In this case, QList falls under the umbrells of custom types.
     qRegisterMetaType<QList<QStandardItem*>>("QList<QStandardItem*>");
+    qRegisterMetaType<QVector<QList<QStandardItem*>>>("QVector<QList<QStandardItem*>>");
 
     layout->setContentsMargins(0, 0, 0, 0);
     layout->setSpacing(0);
@@ -359,8 +360,13 @@ void GameList::AddDirEntry(GameListDir* entry_items) {
         entry_items->data(GameListDir::GameDirRole).value<UISettings::GameDir*>()->expanded);
 }
 
-void GameList::AddEntry(const QList<QStandardItem*>& entry_items, GameListDir* parent) {
-    parent->appendRow(entry_items);
+void GameList::AddEntries(const QVector<QList<QStandardItem*>>& entries, GameListDir* parent) {
+    // The view is only repainted once for the whole batch
+    tree_view->setUpdatesEnabled(false);
+    for (const auto& entry_items : entries) {
+        parent->appendRow(entry_items);
+    }
+    tree_view->setUpdatesEnabled(true);
 }
 
 void GameList::ValidateEntry(const QModelIndex& item) {
@@ -414,6 +420,13 @@ bool GameList::isEmpty() const {
 void GameList::DonePopulating(QStringList watch_list) {
     emit ShowList(!isEmpty());
 
+    // Games are added in the order they finished parsing, sort them like the view was before
+    const auto* const header = tree_view->header();
+    for (int i = 0; i < item_model->rowCount(); ++i) {
+        item_model->item(i, 0)->sortChildren(header->sortIndicatorSection(),
+                                             header->sortIndicatorOrder());
+    }
+
     item_model->invisibleRootItem()->appendRow(new GameListAddDir());
 
     // Clear out the old directories to watch for changes and add the new ones
@@ -641,7 +654,8 @@ void GameList::PopulateAsync(QVector<UISettings::GameDir>& game_dirs) {
 
     GameListWorker* worker = new GameListWorker(vfs, provider, game_dirs, compatibility_list);
 
-    connect(worker, &GameListWorker::EntryReady, this, &GameList::AddEntry, Qt::QueuedConnection);
+    connect(worker, &GameListWorker::EntriesReady, this, &GameList::AddEntries,
+            Qt::QueuedConnection);
     connect(worker, &GameListWorker::DirEntryReady, this, &GameList::AddDirEntry,
             Qt::QueuedConnection);
     connect(worker, &GameListWorker::Finished, this, &GameList::DonePopulating,
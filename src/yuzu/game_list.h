@@ -92,7 +92,7 @@ private slots:
 
 private:
     void AddDirEntry(GameListDir* entry_items);
-    void AddEntry(const QList<QStandardItem*>& entry_items, GameListDir* parent);
+    void AddEntries(const QVector<QList<QStandardItem*>>& entries, GameListDir* parent);
     void ValidateEntry(const QModelIndex& item);
     void DonePopulating(QStringList watch_list);
 
@@ -0,0 +1,197 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QString>
+
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "yuzu/game_list_cache.h"
+#include "yuzu/uisettings.h"
+
+namespace {
+
+constexpr quint32 CACHE_MAGIC = 0x59474C43; // "YGLC"
+
+/// Bump whenever the layout of the entries changes, older caches are discarded
+constexpr quint32 CACHE_VERSION = 1;
+
+QString GetCachePath() {
+    return QString::fromStdString(FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + DIR_SEP +
+                                  "game_list" + DIR_SEP + "entries.bin");
+}
+
+QString ToQString(const std::string& str) {
+    return QString::fromStdString(str);
+}
+
+QByteArray ToByteArray(const std::vector<u8>& data) {
+    return QByteArray(reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()));
+}
+
+void Serialize(QDataStream& stream, const GameListCacheEntry& entry) {
+    stream << quint64{entry.size} << qint64{entry.modified} << entry.has_contents
+           << static_cast<quint32>(entry.contents.size());
+    for (const auto& content : entry.contents) {
+        stream << quint8{content.title_type} << quint8{content.record_type}
+               << quint64{content.title_id} << quint64{content.offset} << quint64{content.size}
+               << ToQString(content.name);
+    }
+    stream << entry.has_metadata << entry.is_loadable << static_cast<quint32>(entry.file_type)
+           << quint64{entry.program_id} << ToQString(entry.name) << ToByteArray(entry.icon);
+}
+
+GameListCacheEntry Deserialize(QDataStream& stream) {
+    GameListCacheEntry entry;
+    quint64 size;
+    qint64 modified;
+    quint32 num_contents;
+    stream >> size >> modified >> entry.has_contents >> num_contents;
+    entry.size = size;
+    entry.modified = modified;
+    for (quint32 i = 0; i < num_contents && stream.status() == QDataStream::Ok; ++i) {
+        quint8 title_type;
+        quint8 record_type;
+        quint64 title_id;
+        quint64 offset;
+        quint64 content_size;
+        QString name;
+        stream >> title_type >> record_type >> title_id >> offset >> content_size >> name;
+        entry.contents.push_back(
+            {title_type, record_type, title_id, offset, content_size, name.toStdString()});
+    }
+
+    quint32 file_type;
+    quint64 program_id;
+    QString name;
+    QByteArray icon;
+    stream >> entry.has_metadata >> entry.is_loadable >> file_type >> program_id >> name >> icon;
+    entry.file_type = static_cast<Loader::FileType>(file_type);
+    entry.program_id = program_id;
+    entry.name = name.toStdString();
+    entry.icon.assign(icon.begin(), icon.end());
+    return entry;
+}
+
+void Stamp(const std::string& path, GameListCacheEntry& entry) {
+    const QFileInfo info{ToQString(path)};
+    entry.size = static_cast<u64>(info.size());
+    entry.modified = info.lastModified().toMSecsSinceEpoch();
+}
+
+} // Anonymous namespace
+
+GameListCache::GameListCache() : is_enabled{UISettings::values.cache_game_list} {
+    if (is_enabled) {
+        Load();
+    }
+}
+
+GameListCache::~GameListCache() = default;
+
+GameListCacheEntry GameListCache::Get(const std::string& path) {
+    GameListCacheEntry current;
+    Stamp(path, current);
+    if (!is_enabled) {
+        return current;
+    }
+
+    std::lock_guard lock{mutex};
+    const auto it = entries.find(path);
+    if (it == entries.end()) {
+        return current;
+    }
+    it->second.is_used = true;
+    const GameListCacheEntry& entry = it->second.entry;
+    if (entry.size != current.size || entry.modified != current.modified) {
+        return current;
+    }
+    return entry;
+}
+
+void GameListCache::Store(const std::string& path, GameListCacheEntry entry) {
+    if (!is_enabled) {
+        return;
+    }
+    std::lock_guard lock{mutex};
+    entries[path] = {std::move(entry), true};
+    is_dirty = true;
+}
+
+void GameListCache::Save(bool prune) {
+    if (!is_enabled) {
+        return;
+    }
+    std::lock_guard lock{mutex};
+    if (prune) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.is_used) {
+                ++it;
+                continue;
+            }
+            it = entries.erase(it);
+            is_dirty = true;
+        }
+    }
+    if (!is_dirty) {
+        return;
+    }
+
+    const QString path = GetCachePath();
+    FileUtil::CreateFullPath(path.toStdString());
+
+    // Written through a temporary file, a scan can be cancelled while another one saves
+    QSaveFile file{path};
+    if (!file.open(QFile::WriteOnly)) {
+        LOG_ERROR(Frontend, "Failed to open the game list cache for writing.");
+        return;
+    }
+    QDataStream stream{&file};
+    stream << CACHE_MAGIC << CACHE_VERSION << static_cast<quint32>(entries.size());
+    for (const auto& [entry_path, cached] : entries) {
+        stream << ToQString(entry_path);
+        Serialize(stream, cached.entry);
+    }
+    if (!file.commit()) {
+        LOG_ERROR(Frontend, "Failed to write the game list cache.");
+        return;
+    }
+    is_dirty = false;
+}
+
+void GameListCache::Load() {
+    QFile file{GetCachePath()};
+    if (!file.open(QFile::ReadOnly)) {
+        return;
+    }
+    QDataStream stream{&file};
+    quint32 magic;
+    quint32 version;
+    quint32 num_entries;
+    stream >> magic >> version >> num_entries;
+    if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        LOG_INFO(Frontend, "Discarding an incompatible game list cache.");
+        return;
+    }
+
+    for (quint32 i = 0; i < num_entries; ++i) {
+        QString path;
+        stream >> path;
+        auto entry = Deserialize(stream);
+        if (stream.status() != QDataStream::Ok) {
+            LOG_ERROR(Frontend, "The game list cache is corrupted, discarding it.");
+            entries.clear();
+            return;
+        }
+        entries.emplace(path.toStdString(), CachedEntry{std::move(entry)});
+    }
+}
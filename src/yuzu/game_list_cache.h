@@ -0,0 +1,81 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/loader/loader.h"
+
+/// What the game list learned from a file the last time it was parsed.
+struct GameListCacheEntry {
+    /// An NCA of the file registered into the manual content provider
+    struct Content {
+        u8 title_type;
+        u8 record_type;
+        u64 title_id;
+        u64 offset; ///< Offset of the NCA in the file
+        u64 size;
+        std::string name;
+    };
+
+    // Size and modification time of the file when it was cached
+    u64 size = 0;
+    s64 modified = 0;
+
+    /// True when the contents of the file have been cached
+    bool has_contents = false;
+    std::vector<Content> contents;
+
+    /// True when the metadata shown by the game list has been cached
+    bool has_metadata = false;
+    bool is_loadable = false;
+    Loader::FileType file_type = Loader::FileType::Unknown;
+    u64 program_id = 0;
+    std::string name;
+    std::vector<u8> icon;
+};
+
+/**
+ * On-disk cache of what the game list parsed from every file of the game directories, so a scan
+ * only has to parse the files that were added or modified since the last one. Files are matched
+ * by path, size and modification time. Does nothing when the game list cache is disabled.
+ */
+class GameListCache {
+public:
+    GameListCache();
+    ~GameListCache();
+
+    /**
+     * Returns the cached entry of a file. When the file was never cached or has changed since,
+     * returns an empty entry holding the current size and modification time of the file.
+     */
+    GameListCacheEntry Get(const std::string& path);
+
+    /// Replaces the cached entry of a file.
+    void Store(const std::string& path, GameListCacheEntry entry);
+
+    /**
+     * Writes the cache to disk.
+     * @param prune Drops the entries of files that were not looked up since the cache was loaded
+     */
+    void Save(bool prune);
+
+private:
+    struct CachedEntry {
+        GameListCacheEntry entry;
+        bool is_used = false;
+    };
+
+    void Load();
+
+    bool is_enabled;
+    bool is_dirty = false;
+    std::mutex mutex;
+    std::unordered_map<std::string, CachedEntry> entries;
+};
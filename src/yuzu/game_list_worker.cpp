@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,10 +25,12 @@
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
+#include "core/file_sys/vfs_offset.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
 #include "yuzu/compatibility_list.h"
 #include "yuzu/game_list.h"
+#include "yuzu/game_list_cache.h"
 #include "yuzu/game_list_p.h"
 #include "yuzu/game_list_worker.h"
 #include "yuzu/uisettings.h"
@@ -188,9 +192,10 @@ QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
 }
 
 QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::string& name,
-                                        const std::vector<u8>& icon, Loader::AppLoader& loader,
+                                        const std::vector<u8>& icon, Loader::FileType file_type,
                                         u64 program_id, const CompatibilityList& compatibility_list,
-                                        const FileSys::PatchManager& patch) {
+                                        const FileSys::PatchManager& patch,
+                                        const std::function<QString()>& patch_versions_generator) {
     const auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
 
     // The game list uses this as compatibility number for untested games
@@ -199,7 +204,6 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         compatibility = it->second.first;
     }
 
-    const auto file_type = loader.GetFileType();
     const auto file_type_string = QString::fromStdString(Loader::GetFileTypeString(file_type));
 
     QList<QStandardItem*> list{
@@ -212,14 +216,30 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
 
     if (UISettings::values.show_add_ons) {
         const auto patch_versions = GetGameListCachedObject(
-            fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", [&patch, &loader] {
-                return FormatPatchNameVersions(patch, loader, loader.IsRomFSUpdatable());
-            });
+            fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", patch_versions_generator);
         list.insert(2, new GameListItem(patch_versions));
     }
 
     return list;
 }
+
+/// Returns the offset of a file inside the file it was sliced from, if it only went through offsets
+std::optional<u64> GetOffsetInFile(FileSys::VirtualFile file, const FileSys::VirtualFile& outer) {
+    u64 offset = 0;
+    while (file != outer) {
+        const auto slice = std::dynamic_pointer_cast<FileSys::OffsetVfsFile>(file);
+        if (slice == nullptr) {
+            return std::nullopt;
+        }
+        offset += slice->GetOffset();
+        file = slice->GetBaseFile();
+    }
+    return offset;
+}
+
+// Entries are emitted in batches, waiting for either of these to be reached
+constexpr int MAX_BATCH_SIZE = 64;
+constexpr std::chrono::milliseconds MAX_BATCH_AGE{100};
 } // Anonymous namespace
 
 GameListWorker::GameListWorker(FileSys::VirtualFilesystem vfs,
@@ -256,25 +276,35 @@ void GameListWorker::AddTitlesToGameList(GameListDir* parent_dir) {
         if (slot == ContentProviderUnionSlot::FrontendManual)
             continue;
 
-        const auto file = cache.GetEntryUnparsed(game.title_id, game.type);
-        std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(file);
-        if (!loader)
-            continue;
-
-        std::vector<u8> icon;
-        std::string name;
-        u64 program_id = 0;
-        loader->ReadProgramId(program_id);
-
-        const PatchManager patch{program_id};
-        const auto control = cache.GetEntry(game.title_id, ContentRecordType::Control);
-        if (control != nullptr)
-            GetMetadataFromControlNCA(patch, *control, icon, name);
+        Common::GetSharedWorker().QueueWork(parse_tasks, [this, &cache, game = game, parent_dir] {
+            if (stop_processing) {
+                return;
+            }
+            const auto file = cache.GetEntryUnparsed(game.title_id, game.type);
+            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(file);
+            if (!loader)
+                return;
 
-        emit EntryReady(MakeGameListEntry(file->GetFullPath(), name, icon, *loader, program_id,
-                                          compatibility_list, patch),
-                        parent_dir);
+            std::vector<u8> icon;
+            std::string name;
+            u64 program_id = 0;
+            loader->ReadProgramId(program_id);
+
+            const PatchManager patch{program_id};
+            const auto control = cache.GetEntry(game.title_id, ContentRecordType::Control);
+            if (control != nullptr)
+                GetMetadataFromControlNCA(patch, *control, icon, name);
+
+            QueueEntry(MakeGameListEntry(file->GetFullPath(), name, icon, loader->GetFileType(),
+                                         program_id, compatibility_list, patch,
+                                         [&patch, &loader] {
+                                             return FormatPatchNameVersions(
+                                                 patch, *loader, loader->IsRomFSUpdatable());
+                                         }),
+                       parent_dir);
+        });
     }
+    parse_tasks.Wait();
 }
 
 void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_path,
@@ -292,50 +322,10 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
         if (!is_dir &&
             (HasSupportedFileExtension(physical_name) || IsExtractedNCAMain(physical_name))) {
             const auto file = vfs->OpenFile(physical_name, FileSys::Mode::Read);
-            auto loader = Loader::GetLoader(file);
-            if (!loader) {
-                return true;
-            }
-
-            const auto file_type = loader->GetFileType();
-            if ((file_type == Loader::FileType::Unknown || file_type == Loader::FileType::Error) &&
-                !UISettings::values.show_unknown) {
-                return true;
-            }
-
-            u64 program_id = 0;
-            const auto res2 = loader->ReadProgramId(program_id);
-
             if (target == ScanTarget::FillManualContentProvider) {
-                if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
-                    provider->AddEntry(FileSys::TitleType::Application,
-                                       FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()),
-                                       program_id, file);
-                } else if (res2 == Loader::ResultStatus::Success &&
-                           (file_type == Loader::FileType::XCI ||
-                            file_type == Loader::FileType::NSP)) {
-                    const auto nsp = file_type == Loader::FileType::NSP
-                                         ? std::make_shared<FileSys::NSP>(file)
-                                         : FileSys::XCI{file}.GetSecurePartitionNSP();
-                    for (const auto& title : nsp->GetNCAs()) {
-                        for (const auto& entry : title.second) {
-                            provider->AddEntry(entry.first.first, entry.first.second, title.first,
-                                               entry.second->GetBaseFile());
-                        }
-                    }
-                }
+                FillManualContentProvider(physical_name, file);
             } else {
-                std::vector<u8> icon;
-                [[maybe_unused]] const auto res1 = loader->ReadIcon(icon);
-
-                std::string name = " ";
-                [[maybe_unused]] const auto res3 = loader->ReadTitle(name);
-
-                const FileSys::PatchManager patch{program_id};
-
-                emit EntryReady(MakeGameListEntry(physical_name, name, icon, *loader, program_id,
-                                                  compatibility_list, patch),
-                                parent_dir);
+                PopulateGameList(physical_name, file, parent_dir);
             }
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
@@ -348,8 +338,162 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
     FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
 }
 
+void GameListWorker::FillManualContentProvider(const std::string& path,
+                                               const FileSys::VirtualFile& file) {
+    // Parsing NSPs and XCIs is what takes time, the provider itself is filled in scan order
+    auto entries = std::make_shared<std::vector<ProviderEntry>>();
+    provider_entries.push_back(entries);
+    Common::GetSharedWorker().QueueWork(parse_tasks, [this, path, file, entries] {
+        if (!stop_processing) {
+            *entries = ParseProviderEntries(path, file);
+        }
+    });
+}
+
+std::vector<GameListWorker::ProviderEntry> GameListWorker::ParseProviderEntries(
+    const std::string& path, const FileSys::VirtualFile& file) {
+    std::vector<ProviderEntry> entries;
+    auto entry = cache->Get(path);
+    if (entry.has_contents) {
+        for (const auto& content : entry.contents) {
+            auto content_file =
+                content.offset == 0 && content.size == file->GetSize()
+                    ? file
+                    : std::make_shared<FileSys::OffsetVfsFile>(file, content.size, content.offset,
+                                                               content.name);
+            entries.push_back({static_cast<FileSys::TitleType>(content.title_type),
+                               static_cast<FileSys::ContentRecordType>(content.record_type),
+                               content.title_id, std::move(content_file)});
+        }
+        return entries;
+    }
+
+    const auto add_entry = [&file, &entry, &entries](FileSys::TitleType title_type,
+                                                     FileSys::ContentRecordType record_type,
+                                                     u64 title_id, FileSys::VirtualFile nca_file) {
+        // Contents that can't be found back from the file's data keep it from being cached
+        const auto offset = GetOffsetInFile(nca_file, file);
+        if (offset) {
+            entry.contents.push_back({static_cast<u8>(title_type), static_cast<u8>(record_type),
+                                      title_id, *offset, nca_file->GetSize(),
+                                      nca_file->GetName()});
+        } else {
+            entry.has_contents = false;
+        }
+        entries.push_back({title_type, record_type, title_id, std::move(nca_file)});
+    };
+
+    entry.has_contents = true;
+    const auto loader = Loader::GetLoader(file);
+    if (loader) {
+        const auto file_type = loader->GetFileType();
+        u64 program_id = 0;
+        const auto res2 = loader->ReadProgramId(program_id);
+        if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
+            add_entry(FileSys::TitleType::Application,
+                      FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()), program_id,
+                      file);
+        } else if (res2 == Loader::ResultStatus::Success &&
+                   (file_type == Loader::FileType::XCI || file_type == Loader::FileType::NSP)) {
+            const auto nsp = file_type == Loader::FileType::NSP
+                                 ? std::make_shared<FileSys::NSP>(file)
+                                 : FileSys::XCI{file}.GetSecurePartitionNSP();
+            for (const auto& title : nsp->GetNCAs()) {
+                for (const auto& nca : title.second) {
+                    add_entry(nca.first.first, nca.first.second, title.first,
+                              nca.second->GetBaseFile());
+                }
+            }
+        }
+    }
+    cache->Store(path, std::move(entry));
+    return entries;
+}
+
+void GameListWorker::PopulateGameList(const std::string& path, const FileSys::VirtualFile& file,
+                                      GameListDir* parent_dir) {
+    auto entry = cache->Get(path);
+    if (entry.has_metadata) {
+        EmitGameListEntry(path, file, entry, parent_dir);
+        return;
+    }
+
+    // The content provider is complete by now, so the files can be parsed in any order
+    Common::GetSharedWorker().QueueWork(
+        parse_tasks, [this, path, file, parent_dir, entry = std::move(entry)]() mutable {
+            if (stop_processing) {
+                return;
+            }
+            entry.has_metadata = true;
+            const auto loader = Loader::GetLoader(file);
+            entry.is_loadable = loader != nullptr;
+            if (loader) {
+                entry.file_type = loader->GetFileType();
+                loader->ReadProgramId(entry.program_id);
+                loader->ReadIcon(entry.icon);
+                entry.name = " ";
+                loader->ReadTitle(entry.name);
+            }
+            cache->Store(path, entry);
+            EmitGameListEntry(path, file, entry, parent_dir);
+        });
+}
+
+void GameListWorker::EmitGameListEntry(const std::string& path, const FileSys::VirtualFile& file,
+                                       const GameListCacheEntry& entry, GameListDir* parent_dir) {
+    if (!entry.is_loadable) {
+        return;
+    }
+    if ((entry.file_type == Loader::FileType::Unknown ||
+         entry.file_type == Loader::FileType::Error) &&
+        !UISettings::values.show_unknown) {
+        return;
+    }
+
+    const FileSys::PatchManager patch{entry.program_id};
+    QueueEntry(MakeGameListEntry(path, entry.name, entry.icon, entry.file_type, entry.program_id,
+                                 compatibility_list, patch,
+                                 [&patch, &file] {
+                                     const auto loader = Loader::GetLoader(file);
+                                     if (!loader) {
+                                         return QString{};
+                                     }
+                                     return FormatPatchNameVersions(patch, *loader,
+                                                                    loader->IsRomFSUpdatable());
+                                 }),
+               parent_dir);
+}
+
+void GameListWorker::QueueEntry(QList<QStandardItem*> entry_items, GameListDir* parent_dir) {
+    std::lock_guard lock{batch_mutex};
+    if (parent_dir != batch_parent_dir) {
+        EmitBatch();
+        batch_parent_dir = parent_dir;
+    }
+    batch.push_back(std::move(entry_items));
+    if (batch.size() >= MAX_BATCH_SIZE ||
+        std::chrono::steady_clock::now() - last_flush >= MAX_BATCH_AGE) {
+        EmitBatch();
+    }
+}
+
+void GameListWorker::FlushEntries() {
+    std::lock_guard lock{batch_mutex};
+    EmitBatch();
+}
+
+void GameListWorker::EmitBatch() {
+    last_flush = std::chrono::steady_clock::now();
+    if (batch.isEmpty()) {
+        return;
+    }
+    emit EntriesReady(std::move(batch), batch_parent_dir);
+    batch.clear();
+}
+
 void GameListWorker::run() {
     stop_processing = false;
+    cache = std::make_unique<GameListCache>();
 
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("SDMC")) {
@@ -371,11 +515,24 @@ void GameListWorker::run() {
             provider->ClearAllEntries();
             ScanFileSystem(ScanTarget::FillManualContentProvider, game_dir.path.toStdString(), 2,
                            game_list_dir);
+            parse_tasks.Wait();
+            for (const auto& entries : provider_entries) {
+                for (auto& entry : *entries) {
+                    provider->AddEntry(entry.title_type, entry.record_type, entry.title_id,
+                                       std::move(entry.file));
+                }
+            }
+            provider_entries.clear();
+
             ScanFileSystem(ScanTarget::PopulateGameList, game_dir.path.toStdString(),
                            game_dir.deep_scan ? 256 : 0, game_list_dir);
+            // The next directory refills the content provider the parses are reading from
+            parse_tasks.Wait();
         }
+        FlushEntries();
     };
 
+    cache->Save(!stop_processing);
     emit Finished(watch_list);
 }
 
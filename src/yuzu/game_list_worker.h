@@ -5,10 +5,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <QList>
 #include <QObject>
@@ -17,13 +20,19 @@
 #include <QVector>
 
 #include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/vfs_types.h"
 #include "yuzu/compatibility_list.h"
 
+class GameListCache;
 class QStandardItem;
+struct GameListCacheEntry;
 
 namespace FileSys {
 class NCA;
 class VfsFilesystem;
+enum class ContentRecordType : u8;
+enum class TitleType : u8;
 } // namespace FileSys
 
 /**
@@ -54,7 +63,14 @@ signals:
      * entry.
      */
     void DirEntryReady(GameListDir* entry_items);
-    void EntryReady(QList<QStandardItem*> entry_items, GameListDir* parent_dir);
+
+    /**
+     * Emitted with the entries prepared since the last emission, so the view is updated once
+     * per batch instead of once per entry.
+     * @param entries a list of entries, each a list with the `QStandardItem`s that make up its
+     * columns.
+     */
+    void EntriesReady(QVector<QList<QStandardItem*>> entries, GameListDir* parent_dir);
 
     /**
      * After the worker has traversed the game directory looking for entries, this signal is
@@ -73,6 +89,37 @@ private:
     void ScanFileSystem(ScanTarget target, const std::string& dir_path, unsigned int recursion,
                         GameListDir* parent_dir);
 
+    /// Content of a scanned file that goes into the manual content provider
+    struct ProviderEntry {
+        FileSys::TitleType title_type;
+        FileSys::ContentRecordType record_type;
+        u64 title_id;
+        FileSys::VirtualFile file;
+    };
+
+    /// Finds the NCAs of a file on the worker pool, to be registered once the scan is done.
+    void FillManualContentProvider(const std::string& path, const FileSys::VirtualFile& file);
+
+    /// Finds the NCAs of a file, from the cache when it knows them.
+    std::vector<ProviderEntry> ParseProviderEntries(const std::string& path,
+                                                    const FileSys::VirtualFile& file);
+
+    /// Adds a file to the game list, parsing it on the worker pool when it isn't cached.
+    void PopulateGameList(const std::string& path, const FileSys::VirtualFile& file,
+                          GameListDir* parent_dir);
+
+    void EmitGameListEntry(const std::string& path, const FileSys::VirtualFile& file,
+                           const GameListCacheEntry& entry, GameListDir* parent_dir);
+
+    /// Queues an entry for the next batch, emitting it when it is large or old enough. Thread-safe.
+    void QueueEntry(QList<QStandardItem*> entry_items, GameListDir* parent_dir);
+
+    /// Emits the entries queued so far. Thread-safe.
+    void FlushEntries();
+
+    /// Emits the entries queued so far, with batch_mutex held by the caller.
+    void EmitBatch();
+
     std::shared_ptr<FileSys::VfsFilesystem> vfs;
     FileSys::ManualContentProvider* provider;
     QVector<UISettings::GameDir>& game_dirs;
@@ -80,4 +127,15 @@ private:
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
+
+    std::unique_ptr<GameListCache> cache;
+    Common::TaskGroup parse_tasks;
+
+    /// Results of FillManualContentProvider in scan order, so duplicates resolve the same way
+    std::vector<std::shared_ptr<std::vector<ProviderEntry>>> provider_entries;
+
+    std::mutex batch_mutex;
+    QVector<QList<QStandardItem*>> batch;
+    GameListDir* batch_parent_dir = nullptr;
+    std::chrono::steady_clock::time_point last_flush;
 };
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <atomic>
 #include <cinttypes>
 #include <clocale>
 #include <memory>
@@ -48,8 +49,11 @@ static FileSys::VirtualFile VfsDirectoryCreateFileWrapper(const FileSys::Virtual
 #include <QDesktopServices>
 #include <QDesktopWidget>
 #include <QDialogButtonBox>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QProgressBar>
@@ -88,6 +92,7 @@ static FileSys::VirtualFile VfsDirectoryCreateFileWrapper(const FileSys::Virtual
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/hle/service/nfp/nfp.h"
+#include "core/hle/service/service_stats.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/loader/loader.h"
 #include "core/perf_stats.h"
@@ -470,8 +475,9 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a Switch frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
+    audio_dsp_label = new QLabel();
 
-    for (auto& label : {emu_speed_label, game_fps_label, emu_frametime_label}) {
+    for (auto& label : {emu_speed_label, game_fps_label, emu_frametime_label, audio_dsp_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -594,6 +600,8 @@ void GMainWindow::InitializeHotkeys() {
     const QString exit_yuzu = QStringLiteral("Exit yuzu");
     const QString restart_emulation = QStringLiteral("Restart Emulation");
     const QString stop_emulation = QStringLiteral("Stop Emulation");
+    const QString save_state = QStringLiteral("Save State");
+    const QString load_state = QStringLiteral("Load State");
     const QString toggle_filter_bar = QStringLiteral("Toggle Filter Bar");
     const QString toggle_status_bar = QStringLiteral("Toggle Status Bar");
     const QString fullscreen = QStringLiteral("Fullscreen");
@@ -618,6 +626,14 @@ void GMainWindow::InitializeHotkeys() {
     ui.action_Stop->setShortcutContext(
         hotkey_registry.GetShortcutContext(main_window, stop_emulation));
 
+    ui.action_Save_State->setShortcut(hotkey_registry.GetKeySequence(main_window, save_state));
+    ui.action_Save_State->setShortcutContext(
+        hotkey_registry.GetShortcutContext(main_window, save_state));
+
+    ui.action_Load_State->setShortcut(hotkey_registry.GetKeySequence(main_window, load_state));
+    ui.action_Load_State->setShortcutContext(
+        hotkey_registry.GetShortcutContext(main_window, load_state));
+
     ui.action_Show_Filter_Bar->setShortcut(
         hotkey_registry.GetKeySequence(main_window, toggle_filter_bar));
     ui.action_Show_Filter_Bar->setShortcutContext(
@@ -744,6 +760,9 @@ void GMainWindow::RestoreUIState() {
 
     ui.action_Show_Status_Bar->setChecked(UISettings::values.show_status_bar);
     statusBar()->setVisible(ui.action_Show_Status_Bar->isChecked());
+
+    ui.action_Show_Frame_Timeline->setChecked(UISettings::values.show_frame_timeline);
+    render_window->SetFrameTimelineVisible(ui.action_Show_Frame_Timeline->isChecked());
     Debugger::ToggleConsole();
 }
 
@@ -811,6 +830,10 @@ void GMainWindow::ConnectMenuEvents() {
     connect(ui.action_Report_Compatibility, &QAction::triggered, this,
             &GMainWindow::OnMenuReportCompatibility);
     connect(ui.action_Restart, &QAction::triggered, this, [this] { BootGame(QString(game_path)); });
+    connect(ui.action_Save_State, &QAction::triggered, this,
+            [this] { emu_thread->RequestSaveState(); });
+    connect(ui.action_Load_State, &QAction::triggered, this,
+            [this] { emu_thread->RequestLoadState(); });
     connect(ui.action_Configure, &QAction::triggered, this, &GMainWindow::OnConfigure);
 
     // View
@@ -820,6 +843,8 @@ void GMainWindow::ConnectMenuEvents() {
             &GMainWindow::OnDisplayTitleBars);
     connect(ui.action_Show_Filter_Bar, &QAction::triggered, this, &GMainWindow::OnToggleFilterBar);
     connect(ui.action_Show_Status_Bar, &QAction::triggered, statusBar(), &QStatusBar::setVisible);
+    connect(ui.action_Show_Frame_Timeline, &QAction::triggered, render_window,
+            &GRenderWindow::SetFrameTimelineVisible);
 
     // Fullscreen
     ui.action_Fullscreen->setShortcut(
@@ -831,6 +856,8 @@ void GMainWindow::ConnectMenuEvents() {
     // Movie
     connect(ui.action_Capture_Screenshot, &QAction::triggered, this,
             &GMainWindow::OnCaptureScreenshot);
+    connect(ui.action_Dump_Service_Stats, &QAction::triggered, this,
+            &GMainWindow::OnDumpServiceStats);
 
     // Help
     connect(ui.action_Open_yuzu_Folder, &QAction::triggered, this, &GMainWindow::OnOpenYuzuFolder);
@@ -1060,6 +1087,8 @@ void GMainWindow::ShutdownGame() {
     ui.action_Pause->setEnabled(false);
     ui.action_Stop->setEnabled(false);
     ui.action_Restart->setEnabled(false);
+    ui.action_Save_State->setEnabled(false);
+    ui.action_Load_State->setEnabled(false);
     ui.action_Report_Compatibility->setEnabled(false);
     ui.action_Load_Amiibo->setEnabled(false);
     ui.action_Capture_Screenshot->setEnabled(false);
@@ -1079,6 +1108,7 @@ void GMainWindow::ShutdownGame() {
     emu_speed_label->setVisible(false);
     game_fps_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    audio_dsp_label->setVisible(false);
     async_status_button->setEnabled(true);
 #ifdef HAS_VULKAN
     renderer_status_button->setEnabled(true);
@@ -1478,35 +1508,53 @@ void GMainWindow::OnMenuInstallToNAND() {
         return;
     }
 
-    const auto qt_raw_copy = [this](const FileSys::VirtualFile& src,
-                                    const FileSys::VirtualFile& dest, std::size_t block_size) {
-        if (src == nullptr || dest == nullptr)
-            return false;
-        if (!dest->Resize(src->GetSize()))
-            return false;
-
-        std::array<u8, 0x1000> buffer{};
-        const int progress_maximum = static_cast<int>(src->GetSize() / buffer.size());
+    // Installs run on another thread so the window stays responsive while the NCAs are copied,
+    // with a single progress dialog covering every NCA of the file
+    const auto install = [this, &filename](u64 total_size, const auto& install_entry) {
+        constexpr int progress_maximum = 1000;
+        std::atomic<u64> copied_size{0};
+        std::atomic_bool canceled{false};
+
+        const FileSys::VfsCopyFunction copy = [&copied_size, &canceled](
+                                                  const FileSys::VirtualFile& src,
+                                                  const FileSys::VirtualFile& dest,
+                                                  std::size_t block_size) {
+            const u64 previous_size = copied_size;
+            return FileSys::VfsRawCopyWithProgress(
+                src, dest, block_size, [&copied_size, &canceled, previous_size](std::size_t size) {
+                    copied_size = previous_size + size;
+                    return !canceled;
+                });
+        };
 
         QProgressDialog progress(
-            tr("Installing file \"%1\"...").arg(QString::fromStdString(src->GetName())),
-            tr("Cancel"), 0, progress_maximum, this);
+            tr("Installing file \"%1\"...").arg(QFileInfo(filename).fileName()), tr("Cancel"),
+            0, progress_maximum, this);
         progress.setWindowModality(Qt::WindowModal);
+        progress.setMinimumDuration(0);
+        progress.setValue(0);
+        connect(&progress, &QProgressDialog::canceled, [&canceled] { canceled = true; });
 
-        for (std::size_t i = 0; i < src->GetSize(); i += buffer.size()) {
+        QTimer progress_timer;
+        connect(&progress_timer, &QTimer::timeout, [&] {
             if (progress.wasCanceled()) {
-                dest->Resize(0);
-                return false;
+                return;
             }
+            const u64 size = std::min<u64>(copied_size, total_size);
+            progress.setValue(
+                static_cast<int>(size * progress_maximum / std::max<u64>(total_size, 1)));
+        });
 
-            const int progress_value = static_cast<int>(i / buffer.size());
-            progress.setValue(progress_value);
+        QEventLoop loop;
+        QFutureWatcher<FileSys::InstallResult> watcher;
+        connect(&watcher, &QFutureWatcher<FileSys::InstallResult>::finished, &loop,
+                &QEventLoop::quit);
+        watcher.setFuture(
+            QtConcurrent::run([&install_entry, &copy] { return install_entry(copy); }));
+        progress_timer.start(100);
+        loop.exec();
 
-            const auto read = src->Read(buffer.data(), buffer.size(), i);
-            dest->Write(buffer.data(), read, i);
-        }
-
-        return true;
+        return watcher.result();
     };
 
     const auto success = [this]() {
@@ -1550,19 +1598,26 @@ void GMainWindow::OnMenuInstallToNAND() {
             failed();
             return;
         }
-        const auto res = Core::System::GetInstance()
-                             .GetFileSystemController()
-                             .GetUserNANDContents()
-                             ->InstallEntry(*nsp, false, qt_raw_copy);
+        u64 total_size = 0;
+        for (const auto& nca : nsp->GetNCAsCollapsed()) {
+            total_size += nca->GetBaseFile()->GetSize();
+        }
+        const auto install_nsp = [&nsp](bool overwrite_if_exists) {
+            return [&nsp, overwrite_if_exists](const FileSys::VfsCopyFunction& copy) {
+                return Core::System::GetInstance()
+                    .GetFileSystemController()
+                    .GetUserNANDContents()
+                    ->InstallEntry(*nsp, overwrite_if_exists, copy);
+            };
+        };
+
+        const auto res = install(total_size, install_nsp(false));
         if (res == FileSys::InstallResult::Success) {
             success();
         } else {
             if (res == FileSys::InstallResult::ErrorAlreadyExists) {
                 if (overwrite()) {
-                    const auto res2 = Core::System::GetInstance()
-                                          .GetFileSystemController()
-                                          .GetUserNANDContents()
-                                          ->InstallEntry(*nsp, true, qt_raw_copy);
+                    const auto res2 = install(total_size, install_nsp(true));
                     if (res2 == FileSys::InstallResult::Success) {
                         success();
                     } else {
@@ -1614,30 +1669,37 @@ void GMainWindow::OnMenuInstallToNAND() {
                      static_cast<size_t>(FileSys::TitleType::FirmwarePackageB);
         }
 
+        const u64 total_size = nca->GetBaseFile()->GetSize();
+        const auto type = static_cast<FileSys::TitleType>(index);
+
         FileSys::InstallResult res;
         if (index >= static_cast<size_t>(FileSys::TitleType::Application)) {
-            res = Core::System::GetInstance()
-                      .GetFileSystemController()
-                      .GetUserNANDContents()
-                      ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index), false,
-                                     qt_raw_copy);
+            res = install(total_size, [&nca, type](const FileSys::VfsCopyFunction& copy) {
+                return Core::System::GetInstance()
+                    .GetFileSystemController()
+                    .GetUserNANDContents()
+                    ->InstallEntry(*nca, type, false, copy);
+            });
         } else {
-            res = Core::System::GetInstance()
-                      .GetFileSystemController()
-                      .GetSystemNANDContents()
-                      ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index), false,
-                                     qt_raw_copy);
+            res = install(total_size, [&nca, type](const FileSys::VfsCopyFunction& copy) {
+                return Core::System::GetInstance()
+                    .GetFileSystemController()
+                    .GetSystemNANDContents()
+                    ->InstallEntry(*nca, type, false, copy);
+            });
         }
 
         if (res == FileSys::InstallResult::Success) {
             success();
         } else if (res == FileSys::InstallResult::ErrorAlreadyExists) {
             if (overwrite()) {
-                const auto res2 = Core::System::GetInstance()
-                                      .GetFileSystemController()
-                                      .GetUserNANDContents()
-                                      ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index),
-                                                     true, qt_raw_copy);
+                const auto res2 =
+                    install(total_size, [&nca, type](const FileSys::VfsCopyFunction& copy) {
+                        return Core::System::GetInstance()
+                            .GetFileSystemController()
+                            .GetUserNANDContents()
+                            ->InstallEntry(*nca, type, true, copy);
+                    });
                 if (res2 == FileSys::InstallResult::Success) {
                     success();
                 } else {
@@ -1709,6 +1771,8 @@ void GMainWindow::OnStartGame() {
     ui.action_Pause->setEnabled(true);
     ui.action_Stop->setEnabled(true);
     ui.action_Restart->setEnabled(true);
+    ui.action_Save_State->setEnabled(true);
+    ui.action_Load_State->setEnabled(true);
     ui.action_Report_Compatibility->setEnabled(true);
 
     discord_rpc->Update();
@@ -1939,6 +2003,25 @@ void GMainWindow::OnCaptureScreenshot() {
     OnStartGame();
 }
 
+void GMainWindow::OnDumpServiceStats() {
+    const QString default_path =
+        QString::fromStdString(FileUtil::GetUserPath(FileUtil::UserPath::LogDir)) +
+        QStringLiteral("service_stats.txt");
+    const QString path = QFileDialog::getSaveFileName(this, tr("Dump HLE Service Stats"),
+                                                      default_path, tr("Text File (*.txt)"));
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Error Dumping HLE Service Stats"),
+                             tr("Could not open %1 for writing.").arg(path));
+        return;
+    }
+    file.write(QByteArray::fromStdString(Service::Stats::GetReport()));
+}
+
 void GMainWindow::UpdateWindowTitle(const QString& title_name) {
     const auto full_name = std::string(Common::g_build_fullname);
     const auto branch_name = std::string(Common::g_scm_branch);
@@ -1978,10 +2061,48 @@ void GMainWindow::UpdateStatusBar() {
     }
     game_fps_label->setText(tr("Game: %1 FPS").arg(results.game_fps, 0, 'f', 0));
     emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
+    emu_frametime_label->setToolTip(
+        tr("Time taken to emulate a Switch frame, not counting framelimiting or v-sync. For "
+           "full-speed emulation this should be at most 16.67 ms.\n"
+           "GPU syncpoint waits: %1, %2 ms on average\n"
+           "Input latency: %3 ms on average, %4 ms at most\n"
+           "2D blits: %5 on the GPU, %6 unhandled\n"
+           "Texture overlaps: %7 resolved on the GPU, %8 reloaded from memory\n"
+           "Texture uploads skipped: %9 KiB per frame\n"
+           "Buffer uploads: %10 KiB per frame, %11 KiB of const buffers reused")
+            .arg(results.syncpt_waits)
+            .arg(results.syncpt_wait_time * 1000.0, 0, 'f', 3)
+            .arg(results.input_latency * 1000.0, 0, 'f', 2)
+            .arg(results.input_latency_max * 1000.0, 0, 'f', 2)
+            .arg(results.gpu_accelerated_blits)
+            .arg(results.gpu_unhandled_blits)
+            .arg(results.gpu_resolved_overlaps)
+            .arg(results.gpu_flushed_overlaps)
+            .arg(results.gpu_skipped_upload_bytes / 1024)
+            .arg(results.gpu_uploaded_buffer_bytes / 1024)
+            .arg(results.gpu_reused_const_buffer_bytes / 1024));
+
+    const double audio_time = results.audio_decode_time + results.audio_resample_time +
+                              results.audio_mix_time + results.audio_effects_time;
+    audio_dsp_label->setText(tr("Audio: %1 ms").arg(audio_time * 1000.0, 0, 'f', 2));
+    audio_dsp_label->setToolTip(
+        tr("Time the audio renderer spends per update, and what it spends it on.\n"
+           "Decode: %1 ms\nResample: %2 ms\nMix: %3 ms\nEffects: %4 ms\n"
+           "Voices: %5\nSamples mixed: %6 per second\nUnderruns: %7")
+            .arg(results.audio_decode_time * 1000.0, 0, 'f', 3)
+            .arg(results.audio_resample_time * 1000.0, 0, 'f', 3)
+            .arg(results.audio_mix_time * 1000.0, 0, 'f', 3)
+            .arg(results.audio_effects_time * 1000.0, 0, 'f', 3)
+            .arg(results.audio_voices)
+            .arg(results.audio_samples_per_second, 0, 'f', 0)
+            .arg(results.audio_underruns));
+
+    render_window->UpdateFrameTimeline(results);
 
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+    audio_dsp_label->setVisible(true);
 }
 
 void GMainWindow::OnCoreError(Core::System::ResultStatus result, std::string details) {
@@ -2201,6 +2322,7 @@ void GMainWindow::closeEvent(QCloseEvent* event) {
     UISettings::values.display_titlebar = ui.action_Display_Dock_Widget_Headers->isChecked();
     UISettings::values.show_filter_bar = ui.action_Show_Filter_Bar->isChecked();
     UISettings::values.show_status_bar = ui.action_Show_Status_Bar->isChecked();
+    UISettings::values.show_frame_timeline = ui.action_Show_Frame_Timeline->isChecked();
     UISettings::values.first_start = false;
 
     game_list->SaveInterfaceLayout();
@@ -208,6 +208,7 @@ private slots:
     void HideFullscreen();
     void ToggleWindowMode();
     void OnCaptureScreenshot();
+    void OnDumpServiceStats();
     void OnCoreError(Core::System::ResultStatus, std::string);
     void OnReinitializeKeys(ReinitializeKeyBehavior behavior);
 
@@ -229,6 +230,7 @@ private:
     QLabel* emu_speed_label = nullptr;
     QLabel* game_fps_label = nullptr;
     QLabel* emu_frametime_label = nullptr;
+    QLabel* audio_dsp_label = nullptr;
     QPushButton* async_status_button = nullptr;
     QPushButton* renderer_status_button = nullptr;
     QPushButton* dock_status_button = nullptr;
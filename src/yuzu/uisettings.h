@@ -55,6 +55,7 @@ struct Values {
     bool display_titlebar;
     bool show_filter_bar;
     bool show_status_bar;
+    bool show_frame_timeline;
 
     bool confirm_before_closing;
     bool first_start;
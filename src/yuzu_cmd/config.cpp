@@ -260,6 +260,8 @@ void Config::ReadValues() {
 
     Settings::values.motion_device = sdl2_config->Get(
         "ControlsGeneral", "motion_device", "engine:motion_emu,update_period:100,sensitivity:0.01");
+    Settings::values.hid_sampling_rate =
+        static_cast<u16>(sdl2_config->GetInteger("ControlsGeneral", "hid_sampling_rate", 66));
 
     Settings::values.keyboard_enabled =
         sdl2_config->GetBoolean("ControlsGeneral", "keyboard_enabled", false);
@@ -335,6 +337,10 @@ void Config::ReadValues() {
     Settings::values.gamecard_current_game =
         sdl2_config->GetBoolean("Data Storage", "gamecard_current_game", false);
     Settings::values.gamecard_path = sdl2_config->Get("Data Storage", "gamecard_path", "");
+    Settings::values.nca_cache_size =
+        static_cast<u32>(sdl2_config->GetInteger("Data Storage", "nca_cache_size", 64));
+    Settings::values.use_shared_content_cache =
+        sdl2_config->GetBoolean("Data Storage", "use_shared_content_cache", false);
     Settings::values.nand_total_size = static_cast<Settings::NANDTotalSize>(sdl2_config->GetInteger(
         "Data Storage", "nand_total_size", static_cast<long>(Settings::NANDTotalSize::S29_1GB)));
     Settings::values.nand_user_size = static_cast<Settings::NANDUserSize>(sdl2_config->GetInteger(
@@ -369,6 +375,12 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.use_multi_core = sdl2_config->GetBoolean("Core", "use_multi_core", false);
+    Settings::values.use_host_timing = sdl2_config->GetBoolean("Core", "use_host_timing", false);
+    Settings::values.use_idle_skip = sdl2_config->GetBoolean("Core", "use_idle_skip", false);
+    Settings::values.preemption_quantum =
+        static_cast<u16>(sdl2_config->GetInteger("Core", "preemption_quantum", 10));
+    Settings::values.migration_cost =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "migration_cost", 0));
 
     // Renderer
     const int renderer_backend = sdl2_config->GetInteger(
@@ -376,18 +388,42 @@ void Config::ReadValues() {
     Settings::values.renderer_backend = static_cast<Settings::RendererBackend>(renderer_backend);
     Settings::values.renderer_debug = sdl2_config->GetBoolean("Renderer", "debug", false);
     Settings::values.vulkan_device = sdl2_config->GetInteger("Renderer", "vulkan_device", 0);
+    Settings::values.vulkan_present_mode = static_cast<Settings::VulkanPresentMode>(
+        sdl2_config->GetInteger("Renderer", "vulkan_present_mode", 0));
+    Settings::values.vulkan_frames_in_flight =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "vulkan_frames_in_flight", 2));
 
     Settings::values.resolution_factor =
         static_cast<float>(sdl2_config->GetReal("Renderer", "resolution_factor", 1.0));
     Settings::values.use_frame_limit = sdl2_config->GetBoolean("Renderer", "use_frame_limit", true);
     Settings::values.frame_limit =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100));
+    Settings::values.align_frame_limit_to_vsync =
+        sdl2_config->GetBoolean("Renderer", "align_frame_limit_to_vsync", false);
+    Settings::values.vram_budget =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "vram_budget", 0));
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", false);
+    Settings::values.use_asynchronous_shaders =
+        sdl2_config->GetBoolean("Renderer", "use_asynchronous_shaders", false);
+    Settings::values.use_assembly_shaders =
+        sdl2_config->GetBoolean("Renderer", "use_assembly_shaders", true);
     Settings::values.use_accurate_gpu_emulation =
         sdl2_config->GetBoolean("Renderer", "use_accurate_gpu_emulation", false);
     Settings::values.use_asynchronous_gpu_emulation =
         sdl2_config->GetBoolean("Renderer", "use_asynchronous_gpu_emulation", false);
+    Settings::values.use_threaded_presentation =
+        sdl2_config->GetBoolean("Renderer", "use_threaded_presentation", false);
+    Settings::values.disable_macro_compiler =
+        sdl2_config->GetBoolean("Renderer", "disable_macro_compiler", false);
+    Settings::values.validate_macro_compiler =
+        sdl2_config->GetBoolean("Renderer", "validate_macro_compiler", false);
+    Settings::values.use_adaptive_composition =
+        sdl2_config->GetBoolean("Renderer", "use_adaptive_composition", false);
+    Settings::values.use_extra_host_buffer =
+        sdl2_config->GetBoolean("Renderer", "use_extra_host_buffer", false);
+    Settings::values.use_texture_hashing =
+        sdl2_config->GetBoolean("Renderer", "use_texture_hashing", false);
 
     Settings::values.bg_red = static_cast<float>(sdl2_config->GetReal("Renderer", "bg_red", 0.0));
     Settings::values.bg_green =
@@ -398,6 +434,8 @@ void Config::ReadValues() {
     Settings::values.sink_id = sdl2_config->Get("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
+    Settings::values.use_asynchronous_audio_decoding =
+        sdl2_config->GetBoolean("Audio", "use_asynchronous_audio_decoding", false);
     Settings::values.audio_device_id = sdl2_config->Get("Audio", "output_device", "auto");
     Settings::values.volume = static_cast<float>(sdl2_config->GetReal("Audio", "volume", 1));
 
@@ -410,12 +448,20 @@ void Config::ReadValues() {
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    Settings::values.gpu_capture_start_frame =
+        static_cast<u32>(sdl2_config->GetInteger("Debugging", "gpu_capture_start_frame", 0));
+    Settings::values.gpu_capture_frames =
+        static_cast<u32>(sdl2_config->GetInteger("Debugging", "gpu_capture_frames", 0));
+    Settings::values.frame_capture_command =
+        sdl2_config->Get("Debugging", "frame_capture_command", "");
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
     Settings::values.program_args = sdl2_config->Get("Debugging", "program_args", "");
     Settings::values.dump_exefs = sdl2_config->GetBoolean("Debugging", "dump_exefs", false);
     Settings::values.dump_nso = sdl2_config->GetBoolean("Debugging", "dump_nso", false);
+    Settings::values.verify_nso_hashes =
+        sdl2_config->GetBoolean("Debugging", "verify_nso_hashes", false);
     Settings::values.reporting_services =
         sdl2_config->GetBoolean("Debugging", "reporting_services", false);
     Settings::values.quest_flag = sdl2_config->GetBoolean("Debugging", "quest_flag", false);
@@ -449,6 +495,10 @@ void Config::ReadValues() {
     Settings::values.bcat_backend = sdl2_config->Get("Services", "bcat_backend", "boxcat");
     Settings::values.bcat_boxcat_local =
         sdl2_config->GetBoolean("Services", "bcat_boxcat_local", false);
+    Settings::values.ldn_relay_address =
+        sdl2_config->Get("Services", "ldn_relay_address", "127.0.0.1");
+    Settings::values.ldn_relay_port =
+        static_cast<u16>(sdl2_config->GetInteger("Services", "ldn_relay_port", 30200));
 }
 
 void Config::Reload() {
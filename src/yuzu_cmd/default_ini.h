@@ -72,6 +72,10 @@ rstick=
 #  - "cemuhookudp" reads motion input from a udp server that uses cemuhook's udp protocol
 motion_device=
 
+# Rate at which the emulated HID samples the input devices, higher rates lower the input latency
+# 15 - 1000: Samples per second. 66 (default)
+hid_sampling_rate=
+
 # for touch input, the following devices are available:
 #  - "emu_window" (default) for emulating touch input from mouse input to the emulation window. No parameters required
 #  - "cemuhookudp" reads touch input from a udp server that uses cemuhook's udp protocol
@@ -97,6 +101,22 @@ udp_pad_index=
 # 0 (default): Disabled, 1: Enabled
 use_multi_core=
 
+# Whether the guest time follows the host clock instead of the amount of emulated instructions
+# 0 (default): Disabled, 1: Enabled
+use_host_timing=
+
+# Whether guest loops that only poll the system tick are skipped ahead to the next timed event
+# 0 (default): Disabled, 1: Enabled
+use_idle_skip=
+
+# Time between two preemptions of the threads at the preemption priorities, in milliseconds
+# Must be at least 1, 10 (default): The preemption interval of the hardware kernel
+preemption_quantum=
+
+# For how long after running a thread is left on its core by load balancing, in microseconds
+# 0 (default): Threads always migrate like on the hardware kernel
+migration_cost=
+
 [Renderer]
 # Which backend API to use.
 # 0 (default): OpenGL, 1: Vulkan
@@ -109,6 +129,17 @@ debug =
 # Which Vulkan physical device to use (defaults to 0)
 vulkan_device =
 
+# How Vulkan presents frames. Mailbox keeps latency low when the frame rate is uncapped, FIFO
+# paces frames to the display's refresh rate. Unsupported modes fall back to FIFO.
+# 0 (default): Automatic, FIFO when the frame limit is aligned to vsync and mailbox otherwise,
+# 1: FIFO, 2: Mailbox, 3: Immediate
+vulkan_present_mode =
+
+# How many frames Vulkan can queue ahead of the one being displayed. Fewer frames lower the
+# latency, more frames smooth uneven frame times. Limited by the swapchain's image count.
+# 1 - 4, 2 (default)
+vulkan_frames_in_flight =
+
 # Whether to use software or hardware rendering.
 # 0: Software, 1 (default): Hardware
 use_hw_renderer =
@@ -130,6 +161,16 @@ use_vsync =
 # 0: Off, 1: On (default)
 use_frame_limit =
 
+# Ends the frame limiter waits on the host vsyncs reported by the presenter, which evens out the
+# frame pacing when the target game speed matches the refresh rate of the display
+# 0 (default): Off, 1: On
+align_frame_limit_to_vsync =
+
+# Host memory each of the texture and buffer caches try to stay under, least recently used objects
+# are evicted once it's exceeded
+# 0 (default): Unlimited, otherwise the budget in MiB
+vram_budget =
+
 # Limits the speed of the game to run no faster than this value as a percentage of target speed
 # 1 - 9999: Speed limit as a percentage of target game speed. 100 (default)
 frame_limit =
@@ -138,6 +179,15 @@ frame_limit =
 # 0 (default): Off, 1 : On
 use_disk_shader_cache =
 
+# Whether to compile shaders on background threads, skipping draws until they are ready
+# 0 (default): Off, 1 : On
+use_asynchronous_shaders =
+
+# Whether to build shaders as NVIDIA assembly programs when the driver supports them, which is
+# much faster than building GLSL. OpenGL only.
+# 0 : Off, 1 (default): On
+use_assembly_shaders =
+
 # Whether to use accurate GPU emulation
 # 0 (default): Off (fast), 1 : On (slow)
 use_accurate_gpu_emulation =
@@ -146,6 +196,34 @@ use_accurate_gpu_emulation =
 # 0 : Off (slow), 1 (default): On (fast)
 use_asynchronous_gpu_emulation =
 
+# Whether OpenGL presents frames from a thread of its own, so waiting for vsync doesn't slow down
+# the GPU thread. Frames the display can't keep up with are skipped. Needs asynchronous GPU
+# emulation. 0 (default): Off, 1 : On
+use_threaded_presentation =
+
+# Whether to run GPU macros through the interpreter instead of compiling them
+# 0 (default): Off, 1 : On
+disable_macro_compiler =
+
+# Whether to check compiled GPU macros against the macro memory on every instruction (slow)
+# 0 (default): Off, 1 : On
+validate_macro_compiler =
+
+# Whether to compose frames as soon as the game queues them and the previous one was presented,
+# instead of at a fixed refresh rate. Unlocks the frame rate of games that allow it
+# 0 (default): Off, 1 : On
+use_adaptive_composition =
+
+# Whether the host may hold one more frame while the previous one is being presented, so the game
+# can start on the next frame sooner. Only used with adaptive composition
+# 0 (default): Off, 1 : On
+use_extra_host_buffer =
+
+# Whether to hash texture contents when the game rewrites them, skipping the upload when the bytes
+# didn't change. Helps games that stream the same data repeatedly
+# 0 (default): Off, 1 : On
+use_texture_hashing =
+
 # The clear color for the renderer. What shows up on the sides of the bottom screen.
 # Must be in range of 0.0-1.0. Defaults to 1.0 for all.
 bg_red =
@@ -188,6 +266,11 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not to decode audio codecs (hwopus) on worker threads. The guest waits for the result
+# while emulation keeps running.
+# 0 (default): No, 1: Yes
+use_asynchronous_audio_decoding =
+
 # Which audio device to use.
 # auto (default): Auto-select
 output_device =
@@ -215,6 +298,15 @@ gamecard_current_game =
 # If 'gamecard_current_game' is 1 this setting is irrelevant
 gamecard_path =
 
+# Memory budget in MiB for keeping decrypted game data that is read often, 0 disables it
+# 64 (default)
+nca_cache_size =
+
+# Whether to share decrypted game data and system archives with the other running instances of
+# yuzu through files in the cache directory, which also keeps them for later runs. These files
+# take as much disk space as the data read so far. 0 (default): Off, 1: On
+use_shared_content_cache =
+
 [System]
 # Whether the system is docked
 # 1: Yes, 0 (default): No
@@ -257,6 +349,16 @@ log_filter = *:Trace
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
+# Records what the game submits to the GPU into a capture that can be replayed with yuzu-replay.
+# Captures can be found in the dump directory. Number of frames to skip before recording starts
+gpu_capture_start_frame =
+# Number of frames to record, 0 (default) disables GPU captures
+gpu_capture_frames =
+# Command of an encoder that records the presented frames (OpenGL only), empty (default) disables
+# it. The encoder reads raw BGRA video from its standard input, {width}, {height} and {fps} are
+# replaced with its format. For example:
+# ffmpeg -f rawvideo -pix_fmt bgra -s {width}x{height} -r {fps} -i - -c:v h264_vaapi out.mkv
+frame_capture_command =
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
@@ -264,6 +366,9 @@ gdbstub_port=24689
 dump_exefs=false
 # Determines whether or not yuzu will dump all NSOs it attempts to load while loading them
 dump_nso=false
+# Determines whether or not yuzu will check the segment hashes of the NSOs it loads
+# false (default): Doesn't check, true: Refuses to load NSOs with a mismatching segment
+verify_nso_hashes=false
 # Determines whether or not yuzu will report to the game that the emulated console is in Kiosk Mode
 # false: Retail/Normal Mode (default), true: Kiosk Mode
 quest_flag =
@@ -284,6 +389,11 @@ yuzu_token =
 # If this is set to 'boxcat' boxcat will be used, otherwise a null implementation will be used
 bcat_backend =
 
+# Address and port of the relay server that connects the local wireless networks of several
+# instances. Defaults to 127.0.0.1 and 30200
+ldn_relay_address =
+ldn_relay_port =
+
 [AddOns]
 # Used to disable add-ons
 # List of title IDs of games that will have add-ons disabled (separated by '|'):
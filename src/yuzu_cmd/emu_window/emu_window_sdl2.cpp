@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <SDL.h>
+#include <fmt/format.h>
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "core/core.h"
@@ -13,9 +14,13 @@
 #include "input_common/sdl/sdl.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2.h"
 
-EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
+EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool offscreen) : is_offscreen{offscreen} {
+    if (offscreen) {
+        // The offscreen driver renders OpenGL to EGL pbuffers
+        SDL_setenv("SDL_VIDEODRIVER", "offscreen", 1);
+    }
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK) < 0) {
-        LOG_CRITICAL(Frontend, "Failed to initialize SDL2! Exiting...");
+        LOG_CRITICAL(Frontend, "Failed to initialize SDL2! {} Exiting...", SDL_GetError());
         exit(1);
     }
     InputCommon::Init();
@@ -90,7 +95,16 @@ bool EmuWindow_SDL2::IsOpen() const {
 }
 
 bool EmuWindow_SDL2::IsShown() const {
-    return is_shown;
+    return is_shown && !is_offscreen;
+}
+
+bool EmuWindow_SDL2::OpenPerfStatsFile(const std::string& path) {
+    if (!perf_stats_file.Open(path, "w")) {
+        return false;
+    }
+    perf_stats_file.WriteString("time_ms,game_fps,system_fps,frametime_ms,emulation_speed,"
+                                "cpu_jit_ms,cpu_idle_ms,gpu_dma_ms,gpu_draw_ms,gpu_shader_ms\n");
+    return true;
 }
 
 void EmuWindow_SDL2::OnResize() {
@@ -181,6 +195,15 @@ void EmuWindow_SDL2::PollEvents() {
     const u32 current_time = SDL_GetTicks();
     if (current_time > last_time + 2000) {
         const auto results = Core::System::GetInstance().GetAndResetPerfStats();
+        if (perf_stats_file.IsOpen()) {
+            perf_stats_file.WriteString(fmt::format(
+                "{},{:.2f},{:.2f},{:.3f},{:.4f},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}\n", current_time,
+                results.game_fps, results.system_fps, results.frametime * 1000.0,
+                results.emulation_speed, results.cpu_jit_time * 1000.0,
+                results.cpu_idle_time * 1000.0, results.gpu_dma_time * 1000.0,
+                results.gpu_draw_time * 1000.0, results.gpu_shader_time * 1000.0));
+            perf_stats_file.Flush();
+        }
         const auto title = fmt::format(
             "yuzu {} | {}-{} | FPS: {:.0f} ({:.0%})", Common::g_build_fullname,
             Common::g_scm_branch, Common::g_scm_desc, results.game_fps, results.emulation_speed);
@@ -5,14 +5,20 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <utility>
+#include "common/file_util.h"
 #include "core/frontend/emu_window.h"
 
 struct SDL_Window;
 
 class EmuWindow_SDL2 : public Core::Frontend::EmuWindow {
 public:
-    explicit EmuWindow_SDL2(bool fullscreen);
+    /**
+     * @param offscreen Renders through SDL's offscreen video driver, which needs no display
+     *                  server and never presents anything
+     */
+    explicit EmuWindow_SDL2(bool fullscreen, bool offscreen = false);
     ~EmuWindow_SDL2();
 
     /// Polls window events
@@ -24,6 +30,9 @@ public:
     /// Returns if window is shown (not minimized)
     bool IsShown() const override;
 
+    /// Appends the perf stats to a CSV file at path each time they are updated
+    bool OpenPerfStatsFile(const std::string& path);
+
 protected:
     /// Called by PollEvents when a key is pressed or released.
     void OnKeyEvent(int key, u8 state);
@@ -61,6 +70,12 @@ protected:
     /// Is the window being shown?
     bool is_shown = true;
 
+    /// Is the window rendered offscreen, without a display server?
+    bool is_offscreen = false;
+
+    /// CSV file the perf stats are written to, if any
+    FileUtil::IOFile perf_stats_file;
+
     /// Internal SDL2 render window
     SDL_Window* render_window;
 
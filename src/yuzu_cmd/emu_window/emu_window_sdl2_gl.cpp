@@ -10,13 +10,17 @@
 #include <fmt/format.h>
 #include <glad/glad.h>
 #include "common/assert.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/string_util.h"
+#include "core/core.h"
 #include "core/settings.h"
 #include "input_common/keyboard.h"
 #include "input_common/main.h"
 #include "input_common/motion_emu.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
 
 class SDLGLContext : public Core::Frontend::GraphicsContext {
@@ -50,6 +54,35 @@ private:
     SDL_GLContext context;
 };
 
+/// Context drawing to the window itself, to present its frames from another thread
+class SDLGLPresentationContext : public Core::Frontend::GraphicsContext {
+public:
+    explicit SDLGLPresentationContext(EmuWindow_SDL2_GL& emu_window, SDL_Window* window,
+                                      SDL_GLContext context)
+        : emu_window{emu_window}, window{window}, context{context} {}
+
+    ~SDLGLPresentationContext() {
+        SDL_GL_DeleteContext(context);
+    }
+
+    void MakeCurrent() override {
+        SDL_GL_MakeCurrent(window, context);
+    }
+
+    void DoneCurrent() override {
+        SDL_GL_MakeCurrent(window, nullptr);
+    }
+
+    void SwapBuffers() override {
+        emu_window.SwapBuffers();
+    }
+
+private:
+    EmuWindow_SDL2_GL& emu_window;
+    SDL_Window* window;
+    SDL_GLContext context;
+};
+
 bool EmuWindow_SDL2_GL::SupportsRequiredGLExtensions() {
     std::vector<std::string_view> unsupported_ext;
 
@@ -80,7 +113,8 @@ bool EmuWindow_SDL2_GL::SupportsRequiredGLExtensions() {
     return unsupported_ext.empty();
 }
 
-EmuWindow_SDL2_GL::EmuWindow_SDL2_GL(bool fullscreen) : EmuWindow_SDL2(fullscreen) {
+EmuWindow_SDL2_GL::EmuWindow_SDL2_GL(bool fullscreen, bool offscreen)
+    : EmuWindow_SDL2(fullscreen, offscreen) {
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
@@ -93,19 +127,21 @@ EmuWindow_SDL2_GL::EmuWindow_SDL2_GL(bool fullscreen) : EmuWindow_SDL2(fullscree
 
     std::string window_title = fmt::format("yuzu {} | {}-{}", Common::g_build_fullname,
                                            Common::g_scm_branch, Common::g_scm_desc);
-    render_window =
-        SDL_CreateWindow(window_title.c_str(),
-                         SDL_WINDOWPOS_UNDEFINED, // x position
-                         SDL_WINDOWPOS_UNDEFINED, // y position
-                         Layout::ScreenUndocked::Width, Layout::ScreenUndocked::Height,
-                         SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+    const u32 window_flags = offscreen ? SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN
+                                       : SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE |
+                                             SDL_WINDOW_ALLOW_HIGHDPI;
+    render_window = SDL_CreateWindow(window_title.c_str(),
+                                     SDL_WINDOWPOS_UNDEFINED, // x position
+                                     SDL_WINDOWPOS_UNDEFINED, // y position
+                                     Layout::ScreenUndocked::Width, Layout::ScreenUndocked::Height,
+                                     window_flags);
 
     if (render_window == nullptr) {
         LOG_CRITICAL(Frontend, "Failed to create SDL2 window! {}", SDL_GetError());
         exit(1);
     }
 
-    if (fullscreen) {
+    if (fullscreen && !offscreen) {
         Fullscreen();
     }
     gl_context = SDL_GL_CreateContext(render_window);
@@ -141,7 +177,63 @@ EmuWindow_SDL2_GL::~EmuWindow_SDL2_GL() {
 }
 
 void EmuWindow_SDL2_GL::SwapBuffers() {
-    SDL_GL_SwapWindow(render_window);
+    ++frame_count;
+    if (frame_dump_interval != 0) {
+        RequestFrameDump();
+    }
+    if (!is_offscreen) {
+        SDL_GL_SwapWindow(render_window);
+    }
+}
+
+void EmuWindow_SDL2_GL::SetFrameDumpInterval(u32 interval, std::string directory) {
+    frame_dump_interval = interval;
+    frame_dump_directory = std::move(directory);
+    if (interval != 0) {
+        FileUtil::CreateFullPath(frame_dump_directory);
+    }
+}
+
+void EmuWindow_SDL2_GL::RequestFrameDump() {
+    // The renderer captures the frame after the one being swapped
+    const u64 next_frame = frame_count + 1;
+    if (next_frame % frame_dump_interval != 0) {
+        return;
+    }
+
+    auto& renderer = Core::System::GetInstance().Renderer();
+    const Layout::FramebufferLayout layout{
+        Layout::FrameLayoutFromResolutionScale(VideoCore::GetResolutionScaleFactor(renderer))};
+    frame_dump_width = layout.width;
+    frame_dump_height = layout.height;
+    frame_dump_pixels.resize(static_cast<std::size_t>(layout.width) * layout.height * 4);
+    renderer.RequestScreenshot(
+        frame_dump_pixels.data(), [this, next_frame] { WriteFrameDump(next_frame); }, layout);
+}
+
+void EmuWindow_SDL2_GL::WriteFrameDump(u64 frame) const {
+    const std::string path = fmt::format("{}frame_{:08}.ppm", frame_dump_directory, frame);
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Frontend, "Failed to create frame dump \"{}\"", path);
+        return;
+    }
+
+    // Screenshots are BGRA with the bottom row first, PPM wants RGB with the top row first
+    const std::size_t pitch = static_cast<std::size_t>(frame_dump_width) * 4;
+    std::vector<u8> rgb(static_cast<std::size_t>(frame_dump_width) * frame_dump_height * 3);
+    u8* dest = rgb.data();
+    for (u32 y = frame_dump_height; y-- > 0;) {
+        const u8* src = frame_dump_pixels.data() + y * pitch;
+        for (u32 x = 0; x < frame_dump_width; ++x, src += 4) {
+            *dest++ = src[2];
+            *dest++ = src[1];
+            *dest++ = src[0];
+        }
+    }
+
+    file.WriteString(fmt::format("P6\n{} {}\n255\n", frame_dump_width, frame_dump_height));
+    file.WriteBytes(rgb.data(), rgb.size());
 }
 
 void EmuWindow_SDL2_GL::MakeCurrent() {
@@ -161,3 +253,16 @@ void EmuWindow_SDL2_GL::RetrieveVulkanHandlers(void* get_instance_proc_addr, voi
 std::unique_ptr<Core::Frontend::GraphicsContext> EmuWindow_SDL2_GL::CreateSharedContext() const {
     return std::make_unique<SDLGLContext>();
 }
+
+std::unique_ptr<Core::Frontend::GraphicsContext> EmuWindow_SDL2_GL::CreatePresentationContext()
+    const {
+    // Shares with the window's context, which the caller has current, and takes its place
+    SDL_GLContext context = SDL_GL_CreateContext(render_window);
+    SDL_GL_MakeCurrent(render_window, gl_context);
+    if (context == nullptr) {
+        LOG_ERROR(Frontend, "Failed to create the presentation context! {}", SDL_GetError());
+        return nullptr;
+    }
+    return std::make_unique<SDLGLPresentationContext>(const_cast<EmuWindow_SDL2_GL&>(*this),
+                                                      render_window, context);
+}
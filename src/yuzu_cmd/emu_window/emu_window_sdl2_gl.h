@@ -5,17 +5,23 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
 #include "core/frontend/emu_window.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2.h"
 
 class EmuWindow_SDL2_GL final : public EmuWindow_SDL2 {
 public:
-    explicit EmuWindow_SDL2_GL(bool fullscreen);
+    explicit EmuWindow_SDL2_GL(bool fullscreen, bool offscreen);
     ~EmuWindow_SDL2_GL();
 
-    /// Swap buffers to display the next frame
+    /// Swap buffers to display the next frame, doing nothing but frame dumps when offscreen
     void SwapBuffers() override;
 
+    /// Dumps every interval-th frame as a PPM image to directory, or stops dumping when zero
+    void SetFrameDumpInterval(u32 interval, std::string directory);
+
     /// Makes the graphics context current for the caller thread
     void MakeCurrent() override;
 
@@ -27,11 +33,25 @@ public:
                                 void* surface) const override;
 
     std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreatePresentationContext() const override;
 
 private:
     /// Whether the GPU and driver supports the OpenGL extension required
     bool SupportsRequiredGLExtensions();
 
+    /// Requests the screenshot of the next frame when it is due to be dumped
+    void RequestFrameDump();
+
+    /// Writes the screenshot in frame_dump_pixels to an image file
+    void WriteFrameDump(u64 frame) const;
+
+    u32 frame_dump_interval = 0;
+    std::string frame_dump_directory;
+    u64 frame_count = 0;
+    u32 frame_dump_width = 0;
+    u32 frame_dump_height = 0;
+    std::vector<u8> frame_dump_pixels;
+
     using SDL_GLContext = void*;
     /// The OpenGL context associated with the window
     SDL_GLContext gl_context;
@@ -20,6 +20,7 @@
 #include "common/scope_exit.h"
 #include "common/string_util.h"
 #include "common/telemetry.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/crypto/key_manager.h"
 #include "core/file_sys/vfs_real.h"
@@ -67,7 +68,11 @@ static void PrintHelp(const char* argv0) {
                  "-f, --fullscreen      Start in fullscreen mode\n"
                  "-h, --help            Display this help and exit\n"
                  "-v, --version         Output version information and exit\n"
-                 "-p, --program         Pass following string as arguments to executable\n";
+                 "-p, --program         Pass following string as arguments to executable\n"
+                 "-t, --trace=FILE      Record the profiler scopes into a Chrome trace JSON FILE\n"
+                 "-o, --offscreen       Render offscreen without a display server (OpenGL only)\n"
+                 "-d, --dump-frames=N   Dump every Nth frame to the frames dump directory\n"
+                 "-s, --perf-stats=FILE Write the performance statistics to a CSV FILE\n";
 }
 
 static void PrintVersion() {
@@ -111,17 +116,23 @@ int main(int argc, char** argv) {
     }
 #endif
     std::string filepath;
+    std::string trace_path;
+    std::string perf_stats_path;
+    u32 frame_dump_interval = 0;
 
     bool fullscreen = false;
+    bool offscreen = false;
 
     static struct option long_options[] = {
         {"gdbport", required_argument, 0, 'g'}, {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},          {"version", no_argument, 0, 'v'},
-        {"program", optional_argument, 0, 'p'}, {0, 0, 0, 0},
+        {"program", optional_argument, 0, 'p'}, {"trace", required_argument, 0, 't'},
+        {"offscreen", no_argument, 0, 'o'},     {"dump-frames", required_argument, 0, 'd'},
+        {"perf-stats", required_argument, 0, 's'}, {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:fhvp::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:fhvp::t:od:s:", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -149,6 +160,26 @@ int main(int argc, char** argv) {
                 Settings::values.program_args = argv[optind];
                 ++optind;
                 break;
+            case 't':
+                trace_path = optarg;
+                break;
+            case 'o':
+                offscreen = true;
+                LOG_INFO(Frontend, "Rendering offscreen...");
+                break;
+            case 'd':
+                errno = 0;
+                frame_dump_interval = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--dump-frames");
+                    exit(1);
+                }
+                break;
+            case 's':
+                perf_stats_path = optarg;
+                break;
             }
         } else {
 #ifdef _WIN32
@@ -165,6 +196,7 @@ int main(int argc, char** argv) {
 #endif
 
     MicroProfileOnThreadCreate("EmuThread");
+    Common::Trace::SetCurrentThreadName("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
 
     if (filepath.empty()) {
@@ -179,11 +211,23 @@ int main(int argc, char** argv) {
 
     std::unique_ptr<EmuWindow_SDL2> emu_window;
     switch (Settings::values.renderer_backend) {
-    case Settings::RendererBackend::OpenGL:
-        emu_window = std::make_unique<EmuWindow_SDL2_GL>(fullscreen);
+    case Settings::RendererBackend::OpenGL: {
+        auto gl_window = std::make_unique<EmuWindow_SDL2_GL>(fullscreen, offscreen);
+        if (frame_dump_interval != 0) {
+            gl_window->SetFrameDumpInterval(frame_dump_interval,
+                                            FileUtil::GetUserPath(FileUtil::UserPath::DumpDir) +
+                                                "frames" DIR_SEP);
+        }
+        emu_window = std::move(gl_window);
         break;
+    }
     case Settings::RendererBackend::Vulkan:
 #ifdef HAS_VULKAN
+        // The Vulkan renderer can't run without a surface to present to
+        if (offscreen || frame_dump_interval != 0) {
+            LOG_CRITICAL(Frontend, "Offscreen rendering and frame dumps need the OpenGL backend!");
+            return 1;
+        }
         emu_window = std::make_unique<EmuWindow_SDL2_VK>(fullscreen);
         break;
 #else
@@ -192,6 +236,10 @@ int main(int argc, char** argv) {
 #endif
     }
 
+    if (!perf_stats_path.empty() && !emu_window->OpenPerfStatsFile(perf_stats_path)) {
+        LOG_ERROR(Frontend, "Failed to create the perf stats file {}", perf_stats_path);
+    }
+
     if (!Settings::values.use_multi_core) {
         // Single core mode must acquire OpenGL context for entire emulation session
         emu_window->MakeCurrent();
@@ -234,6 +282,10 @@ int main(int argc, char** argv) {
 
     system.TelemetrySession().AddField(Telemetry::FieldType::App, "Frontend", "SDL");
 
+    if (!trace_path.empty() && !Common::Trace::StartRecording(trace_path)) {
+        LOG_ERROR(Frontend, "Failed to create the trace file {}", trace_path);
+    }
+
     emu_window->MakeCurrent();
     system.Renderer().Rasterizer().LoadDiskResources();
 
@@ -242,6 +294,7 @@ int main(int argc, char** argv) {
     }
 
     system.Shutdown();
+    Common::Trace::StopRecording();
 
     detached_tasks.WaitForAllTasks();
     return 0;
@@ -0,0 +1,266 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "common/common_paths.h"
+#include "common/detached_tasks.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/scm_rev.h"
+#include "common/scope_exit.h"
+#include "common/string_util.h"
+#include "core/core.h"
+#include "core/file_sys/registered_cache.h"
+#include "core/file_sys/vfs_real.h"
+#include "core/hle/service/filesystem/filesystem.h"
+#include "core/loader/loader.h"
+#include "core/settings.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_capture.h"
+#include "yuzu_cmd/config.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_vk.h"
+
+#ifdef _WIN32
+// windows.h needs to be included before shellapi.h
+#include <windows.h>
+
+#include <shellapi.h>
+#endif
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+extern "C" {
+// tells Nvidia and AMD drivers to use the dedicated GPU by default on laptops with switchable
+// graphics
+__declspec(dllexport) unsigned long NvOptimusEnablement = 0x00000001;
+__declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
+}
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <capture>\n"
+                 "-b, --backend=NAME    Replay with the opengl or the vulkan renderer\n"
+                 "-n, --loops=NUMBER    Replay the capture NUMBER times, 2 by default\n"
+                 "-h, --help            Display this help and exit\n"
+                 "-v, --version         Output version information and exit\n";
+}
+
+void PrintVersion() {
+    std::cout << "yuzu [GPU Capture Replay] " << Common::g_scm_branch << " "
+              << Common::g_scm_desc << std::endl;
+}
+
+void InitializeLogging() {
+    Log::Filter log_filter(Log::Level::Debug);
+    log_filter.ParseFilterString(Settings::values.log_filter);
+    Log::SetGlobalFilter(log_filter);
+
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    FileUtil::CreateFullPath(log_dir);
+    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+#ifdef _WIN32
+    Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
+#endif
+}
+
+/// Prints the frame time statistics of one replay of the capture
+void PrintStatistics(u32 loop, std::vector<double> frame_times) {
+    if (frame_times.empty()) {
+        std::cout << fmt::format("Loop {}: no frames", loop) << std::endl;
+        return;
+    }
+    std::sort(frame_times.begin(), frame_times.end());
+    const double total = std::accumulate(frame_times.begin(), frame_times.end(), 0.0);
+    const auto percentile = [&frame_times](double fraction) {
+        const auto index = static_cast<std::size_t>(fraction * (frame_times.size() - 1));
+        return frame_times[index];
+    };
+    std::cout << fmt::format("Loop {}: {} frames in {:.3f} s, {:.2f} FPS | frame time (ms) "
+                             "avg {:.3f} min {:.3f} p50 {:.3f} p99 {:.3f} max {:.3f}",
+                             loop, frame_times.size(), total / 1000.0,
+                             frame_times.size() * 1000.0 / total, total / frame_times.size(),
+                             frame_times.front(), percentile(0.5), percentile(0.99),
+                             frame_times.back())
+              << std::endl;
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    Common::DetachedTasks detached_tasks;
+    Config config;
+
+    int option_index = 0;
+
+    InitializeLogging();
+
+    char* endarg;
+#ifdef _WIN32
+    int argc_w;
+    auto argv_w = CommandLineToArgvW(GetCommandLineW(), &argc_w);
+
+    if (argv_w == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to get command line arguments");
+        return -1;
+    }
+#endif
+    std::string filepath;
+    u32 num_loops = 2;
+
+    static struct option long_options[] = {
+        {"backend", required_argument, 0, 'b'},
+        {"loops", required_argument, 0, 'n'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "b:n:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'b': {
+                const std::string backend = Common::ToLower(optarg);
+                if (backend == "opengl") {
+                    Settings::values.renderer_backend = Settings::RendererBackend::OpenGL;
+                } else if (backend == "vulkan") {
+                    Settings::values.renderer_backend = Settings::RendererBackend::Vulkan;
+                } else {
+                    std::cerr << "Unknown renderer backend " << backend << std::endl;
+                    return 1;
+                }
+                break;
+            }
+            case 'n':
+                errno = 0;
+                num_loops = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || num_loops == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--loops");
+                    exit(1);
+                }
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+#ifdef _WIN32
+            filepath = Common::UTF16ToUTF8(argv_w[optind]);
+#else
+            filepath = argv[optind];
+#endif
+            optind++;
+        }
+    }
+
+#ifdef _WIN32
+    LocalFree(argv_w);
+#endif
+
+    MicroProfileOnThreadCreate("EmuThread");
+    SCOPE_EXIT({ MicroProfileShutdown(); });
+
+    if (filepath.empty()) {
+        LOG_CRITICAL(Frontend, "Failed to replay: No GPU capture specified");
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    // Replay as fast as possible, and don't record the replay into another capture
+    Settings::values.use_frame_limit = false;
+    Settings::values.use_gdbstub = false;
+    Settings::values.gpu_capture_frames = 0;
+    Settings::Apply();
+
+    std::unique_ptr<EmuWindow_SDL2> emu_window;
+    switch (Settings::values.renderer_backend) {
+    case Settings::RendererBackend::OpenGL:
+        emu_window = std::make_unique<EmuWindow_SDL2_GL>(false);
+        break;
+    case Settings::RendererBackend::Vulkan:
+#ifdef HAS_VULKAN
+        emu_window = std::make_unique<EmuWindow_SDL2_VK>(false);
+        break;
+#else
+        LOG_CRITICAL(Frontend, "Vulkan backend has not been compiled!");
+        return 1;
+#endif
+    }
+
+    Core::System& system{Core::System::GetInstance()};
+    system.SetContentProvider(std::make_unique<FileSys::ContentProviderUnion>());
+    system.SetFilesystem(std::make_shared<FileSys::RealVfsFilesystem>());
+    system.GetFileSystemController().CreateFactories(*system.GetFilesystem());
+
+    const Core::System::ResultStatus load_result{system.Load(*emu_window, filepath)};
+    if (load_result != Core::System::ResultStatus::Success) {
+        LOG_CRITICAL(Frontend, "Failed to load GPU capture {} (Error {})", filepath,
+                     static_cast<u32>(load_result));
+        return -1;
+    }
+    SCOPE_EXIT({ system.Shutdown(); });
+
+    if (!Settings::values.use_asynchronous_gpu_emulation) {
+        // The renderer runs on this thread when the GPU is emulated synchronously
+        emu_window->MakeCurrent();
+    }
+
+    Tegra::Capture::Player player{
+        system, system.GetFilesystem()->OpenFile(filepath, FileSys::Mode::Read)};
+    Tegra::GPU& gpu = system.GPU();
+
+    for (u32 loop = 0; loop < num_loops && emu_window->IsOpen(); ++loop) {
+        std::vector<double> frame_times;
+        auto frame_start = Clock::now();
+        const auto num_frames = player.Play([&] {
+            // Time what the GPU took to get through the frame, not how long it took to queue it
+            gpu.WaitIdle();
+            const auto frame_end = Clock::now();
+            frame_times.push_back(
+                std::chrono::duration<double, std::milli>(frame_end - frame_start).count());
+            frame_start = frame_end;
+        });
+        if (!num_frames) {
+            LOG_CRITICAL(Frontend, "Failed to replay GPU capture {}", filepath);
+            return -1;
+        }
+        PrintStatistics(loop, std::move(frame_times));
+    }
+
+    detached_tasks.WaitForAllTasks();
+    return 0;
+}
@@ -114,18 +114,34 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.use_multi_core = sdl2_config->GetBoolean("Core", "use_multi_core", false);
+    Settings::values.use_host_timing = sdl2_config->GetBoolean("Core", "use_host_timing", false);
+    Settings::values.use_idle_skip = sdl2_config->GetBoolean("Core", "use_idle_skip", false);
+    Settings::values.preemption_quantum =
+        static_cast<u16>(sdl2_config->GetInteger("Core", "preemption_quantum", 10));
+    Settings::values.migration_cost =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "migration_cost", 0));
 
     // Renderer
     Settings::values.resolution_factor =
         static_cast<float>(sdl2_config->GetReal("Renderer", "resolution_factor", 1.0));
     Settings::values.use_frame_limit = false;
     Settings::values.frame_limit = 100;
+    Settings::values.align_frame_limit_to_vsync = false;
+    Settings::values.vram_budget = 0;
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", false);
+    Settings::values.use_asynchronous_shaders =
+        sdl2_config->GetBoolean("Renderer", "use_asynchronous_shaders", false);
+    Settings::values.use_assembly_shaders =
+        sdl2_config->GetBoolean("Renderer", "use_assembly_shaders", true);
     Settings::values.use_accurate_gpu_emulation =
         sdl2_config->GetBoolean("Renderer", "use_accurate_gpu_emulation", false);
     Settings::values.use_asynchronous_gpu_emulation =
         sdl2_config->GetBoolean("Renderer", "use_asynchronous_gpu_emulation", false);
+    Settings::values.disable_macro_compiler =
+        sdl2_config->GetBoolean("Renderer", "disable_macro_compiler", false);
+    Settings::values.validate_macro_compiler =
+        sdl2_config->GetBoolean("Renderer", "validate_macro_compiler", false);
 
     Settings::values.bg_red = static_cast<float>(sdl2_config->GetReal("Renderer", "bg_red", 0.0));
     Settings::values.bg_green =
@@ -135,6 +151,7 @@ void Config::ReadValues() {
     // Audio
     Settings::values.sink_id = "null";
     Settings::values.enable_audio_stretching = false;
+    Settings::values.use_asynchronous_audio_decoding = false;
     Settings::values.audio_device_id = "auto";
     Settings::values.volume = 0;
 
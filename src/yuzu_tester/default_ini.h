@@ -12,6 +12,22 @@ const char* sdl2_config_file = R"(
 # 0 (default): Disabled, 1: Enabled
 use_multi_core=
 
+# Whether the guest time follows the host clock instead of the amount of emulated instructions
+# 0 (default): Disabled, 1: Enabled
+use_host_timing=
+
+# Whether guest loops that only poll the system tick are skipped ahead to the next timed event
+# 0 (default): Disabled, 1: Enabled
+use_idle_skip=
+
+# Time between two preemptions of the threads at the preemption priorities, in milliseconds
+# Must be at least 1, 10 (default): The preemption interval of the hardware kernel
+preemption_quantum=
+
+# For how long after running a thread is left on its core by load balancing, in microseconds
+# 0 (default): Threads always migrate like on the hardware kernel
+migration_cost=
+
 [Renderer]
 # Whether to use software or hardware rendering.
 # 0: Software, 1 (default): Hardware
@@ -34,6 +50,15 @@ use_vsync =
 # 0 (default): Off, 1 : On
 use_disk_shader_cache =
 
+# Whether to compile shaders on background threads, skipping draws until they are ready
+# 0 (default): Off, 1 : On
+use_asynchronous_shaders =
+
+# Whether to build shaders as NVIDIA assembly programs when the driver supports them, which is
+# much faster than building GLSL. OpenGL only.
+# 0 : Off, 1 (default): On
+use_assembly_shaders =
+
 # Whether to use accurate GPU emulation
 # 0 (default): Off (fast), 1 : On (slow)
 use_accurate_gpu_emulation =
@@ -42,6 +67,14 @@ use_accurate_gpu_emulation =
 # 0 : Off (slow), 1 (default): On (fast)
 use_asynchronous_gpu_emulation =
 
+# Whether to run GPU macros through the interpreter instead of compiling them
+# 0 (default): Off, 1 : On
+disable_macro_compiler =
+
+# Whether to check compiled GPU macros against the macro memory on every instruction (slow)
+# 0 (default): Off, 1 : On
+validate_macro_compiler =
+
 # The clear color for the renderer. What shows up on the sides of the bottom screen.
 # Must be in range of 0.0-1.0. Defaults to 1.0 for all.
 bg_red =
@@ -0,0 +1,38 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "core/settings.h"
+#include "input_common/main.h"
+#include "yuzu_tester/emu_window/emu_window_headless.h"
+
+EmuWindow_Headless::EmuWindow_Headless() {
+    InputCommon::Init();
+
+    LOG_INFO(Frontend, "yuzu-tester Version: {} | {}-{} (headless)", Common::g_build_fullname,
+             Common::g_scm_branch, Common::g_scm_desc);
+    Settings::LogSettings();
+}
+
+EmuWindow_Headless::~EmuWindow_Headless() {
+    InputCommon::Shutdown();
+}
+
+void EmuWindow_Headless::SwapBuffers() {}
+
+void EmuWindow_Headless::PollEvents() {}
+
+void EmuWindow_Headless::MakeCurrent() {}
+
+void EmuWindow_Headless::DoneCurrent() {}
+
+bool EmuWindow_Headless::IsShown() const {
+    return false;
+}
+
+void EmuWindow_Headless::RetrieveVulkanHandlers(void*, void*, void*) const {
+    UNREACHABLE();
+}
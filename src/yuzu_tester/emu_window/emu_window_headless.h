@@ -0,0 +1,22 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "core/frontend/emu_window.h"
+
+/// Window without any graphics context, for use with the null renderer
+class EmuWindow_Headless : public Core::Frontend::EmuWindow {
+public:
+    explicit EmuWindow_Headless();
+    ~EmuWindow_Headless();
+
+    void SwapBuffers() override;
+    void PollEvents() override;
+    void MakeCurrent() override;
+    void DoneCurrent() override;
+    bool IsShown() const override;
+    void RetrieveVulkanHandlers(void* get_instance_proc_addr, void* instance,
+                                void* surface) const override;
+};
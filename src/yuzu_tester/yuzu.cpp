@@ -2,10 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <fmt/ostream.h>
 
@@ -26,10 +32,12 @@
 #include "core/file_sys/vfs_real.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
+#include "core/perf_stats.h"
 #include "core/settings.h"
 #include "core/telemetry_session.h"
 #include "video_core/renderer_base.h"
 #include "yuzu_tester/config.h"
+#include "yuzu_tester/emu_window/emu_window_headless.h"
 #include "yuzu_tester/emu_window/emu_window_sdl2_hide.h"
 #include "yuzu_tester/service/yuzutest.h"
 
@@ -57,12 +65,18 @@ __declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
 
 static void PrintHelp(const char* argv0) {
     std::cout << "Usage: " << argv0
-              << " [options] <filename>\n"
+              << " [options] <filename> [<filename>...]\n"
                  "-h, --help            Display this help and exit\n"
                  "-v, --version         Output version information and exit\n"
                  "-d, --datastring      Pass following string as data to test service command #2\n"
                  "-l, --log             Log to console in addition to file (will log to file only "
-                 "by default)\n";
+                 "by default)\n"
+                 "-n, --null-renderer   Run without a host GPU, nothing is rendered and the "
+                 "emulation speed is reported\n"
+                 "-r, --repeat          Run the tests the given number of times, soft resetting "
+                 "the emulation in between\n"
+                 "-j, --jobs            Run the given number of tests in parallel, each one on "
+                 "its own system. Implies --null-renderer\n";
 }
 
 static void PrintVersion() {
@@ -86,6 +100,136 @@ static void InitializeLogging(bool console) {
 #endif
 }
 
+/// Loads and runs a test application on the given system until it reports its results
+static int RunTest(Core::System& system, Core::Frontend::EmuWindow& emu_window,
+                   const std::string& filepath, const std::string& datastring, int repeat_count,
+                   bool null_renderer) {
+    bool finished = false;
+    int return_value = 0;
+    const auto callback = [&system, &finished, &return_value, &filepath,
+                           null_renderer](std::vector<Service::Yuzu::TestResult> results) {
+        finished = true;
+
+        // Parallel runs report at the same time, keep each report in one piece
+        std::ostringstream report;
+        report << filepath << std::endl;
+        if (null_renderer) {
+            // Without rendering, the speed only depends on the CPU and HLE emulation
+            const auto stats = system.GetAndResetPerfStats();
+            report << fmt::format("Emulation speed {:.1f}% | Frametime {:.2f} ms | "
+                                  "Game FPS {:.1f}",
+                                  stats.emulation_speed * 100.0, stats.frametime * 1000.0,
+                                  stats.game_fps)
+                   << std::endl
+                   << std::endl;
+        }
+
+        // Find the minimum length needed to fully enclose all test names (and the header field) in
+        // the fmt::format column by first finding the maximum size of any test name and comparing
+        // that to 9, the string length of 'Test Name'
+        const auto needed_length_name =
+            std::max<u64>(std::max_element(results.begin(), results.end(),
+                                           [](const auto& lhs, const auto& rhs) {
+                                               return lhs.name.size() < rhs.name.size();
+                                           })
+                              ->name.size(),
+                          9ull);
+
+        std::size_t passed = 0;
+        std::size_t failed = 0;
+
+        report << fmt::format("Result [Res Code] | {:<{}} | Extra Data", "Test Name",
+                              needed_length_name)
+               << std::endl;
+
+        for (const auto& res : results) {
+            const auto main_res = res.code == 0 ? "PASSED" : "FAILED";
+            if (res.code == 0)
+                ++passed;
+            else
+                ++failed;
+            report << fmt::format("{} [{:08X}] | {:<{}} | {}", main_res, res.code, res.name,
+                                  needed_length_name, res.data)
+                   << std::endl;
+        }
+
+        report << std::endl
+               << fmt::format("{:4d} Passed | {:4d} Failed | {:4d} Total | {:2.2f} Passed Ratio",
+                              passed, failed, passed + failed,
+                              static_cast<float>(passed) / (passed + failed))
+               << std::endl
+               << (failed == 0 ? "PASSED" : "FAILED") << std::endl;
+        {
+            static std::mutex output_mutex;
+            std::lock_guard lock{output_mutex};
+            std::cout << report.str() << std::endl;
+        }
+
+        if (failed > 0)
+            return_value = -1;
+    };
+
+    system.SetContentProvider(std::make_unique<FileSys::ContentProviderUnion>());
+    system.SetFilesystem(std::make_shared<FileSys::RealVfsFilesystem>());
+    system.GetFileSystemController().CreateFactories(*system.GetFilesystem());
+
+    SCOPE_EXIT({ system.Shutdown(); });
+
+    const Core::System::ResultStatus load_result{system.Load(emu_window, filepath)};
+
+    switch (load_result) {
+    case Core::System::ResultStatus::ErrorGetLoader:
+        LOG_CRITICAL(Frontend, "Failed to obtain loader for {}!", filepath);
+        return -1;
+    case Core::System::ResultStatus::ErrorLoader:
+        LOG_CRITICAL(Frontend, "Failed to load ROM!");
+        return -1;
+    case Core::System::ResultStatus::ErrorNotInitialized:
+        LOG_CRITICAL(Frontend, "CPUCore not initialized");
+        return -1;
+    case Core::System::ResultStatus::ErrorVideoCore:
+        LOG_CRITICAL(Frontend, "Failed to initialize VideoCore!");
+        return -1;
+    case Core::System::ResultStatus::Success:
+        break; // Expected case
+    default:
+        if (static_cast<u32>(load_result) >
+            static_cast<u32>(Core::System::ResultStatus::ErrorLoader)) {
+            const u16 loader_id = static_cast<u16>(Core::System::ResultStatus::ErrorLoader);
+            const u16 error_id = static_cast<u16>(load_result) - loader_id;
+            LOG_CRITICAL(Frontend,
+                         "While attempting to load the ROM requested, an error occured. Please "
+                         "refer to the yuzu wiki for more information or the yuzu discord for "
+                         "additional help.\n\nError Code: {:04X}-{:04X}\nError Description: {}",
+                         loader_id, error_id, static_cast<Loader::ResultStatus>(error_id));
+        }
+    }
+
+    for (int run = 0; run < repeat_count; ++run) {
+        if (run > 0) {
+            // Boots the application again on the renderer and shader caches of the previous run
+            if (system.SoftReset() != Core::System::ResultStatus::Success) {
+                LOG_CRITICAL(Frontend, "Failed to soft reset the emulation!");
+                return -1;
+            }
+            finished = false;
+        }
+
+        Service::Yuzu::InstallInterfaces(system.ServiceManager(), datastring, callback);
+
+        system.TelemetrySession().AddField(Telemetry::FieldType::App, "Frontend",
+                                           "SDLHideTester");
+
+        system.Renderer().Rasterizer().LoadDiskResources();
+
+        while (!finished) {
+            system.RunLoop();
+        }
+    }
+
+    return return_value;
+}
+
 /// Application entry point
 int main(int argc, char** argv) {
     Common::DetachedTasks detached_tasks;
@@ -102,21 +246,27 @@ int main(int argc, char** argv) {
         return -1;
     }
 #endif
-    std::string filepath;
+    std::vector<std::string> filepaths;
 
     static struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {"datastring", optional_argument, 0, 'd'},
         {"log", no_argument, 0, 'l'},
+        {"null-renderer", no_argument, 0, 'n'},
+        {"repeat", required_argument, 0, 'r'},
+        {"jobs", required_argument, 0, 'j'},
         {0, 0, 0, 0},
     };
 
     bool console_log = false;
+    bool null_renderer = false;
+    int repeat_count = 1;
+    std::size_t num_jobs = 1;
     std::string datastring;
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "hvdl::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "hvdnr:j:l::", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'h':
@@ -132,12 +282,21 @@ int main(int argc, char** argv) {
             case 'l':
                 console_log = true;
                 break;
+            case 'n':
+                null_renderer = true;
+                break;
+            case 'r':
+                repeat_count = std::max(std::atoi(optarg), 1);
+                break;
+            case 'j':
+                num_jobs = static_cast<std::size_t>(std::max(std::atoi(optarg), 1));
+                break;
             }
         } else {
 #ifdef _WIN32
-            filepath = Common::UTF16ToUTF8(argv_w[optind]);
+            filepaths.push_back(Common::UTF16ToUTF8(argv_w[optind]));
 #else
-            filepath = argv[optind];
+            filepaths.push_back(argv[optind]);
 #endif
             optind++;
         }
@@ -152,115 +311,77 @@ int main(int argc, char** argv) {
     MicroProfileOnThreadCreate("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
 
-    if (filepath.empty()) {
+    if (filepaths.empty()) {
         LOG_CRITICAL(Frontend, "Failed to load application: No application specified");
         std::cout << "Failed to load application: No application specified" << std::endl;
         PrintHelp(argv[0]);
         return -1;
     }
 
-    Settings::values.use_gdbstub = false;
-    Settings::Apply();
-
-    std::unique_ptr<EmuWindow_SDL2_Hide> emu_window{std::make_unique<EmuWindow_SDL2_Hide>()};
+    if (num_jobs > 1 && !null_renderer) {
+        LOG_WARNING(Frontend, "Parallel tests can't share a host GPU, using the null renderer");
+        null_renderer = true;
+    }
 
-    if (!Settings::values.use_multi_core) {
-        // Single core mode must acquire OpenGL context for entire emulation session
-        emu_window->MakeCurrent();
+    Settings::values.use_gdbstub = false;
+    if (null_renderer) {
+        // Nothing is left for a GPU thread to do, the syncpoints are signaled right away
+        Settings::values.renderer_backend = Settings::RendererBackend::Null;
+        Settings::values.use_asynchronous_gpu_emulation = false;
     }
+    Settings::Apply();
 
-    bool finished = false;
     int return_value = 0;
-    const auto callback = [&finished,
-                           &return_value](std::vector<Service::Yuzu::TestResult> results) {
-        finished = true;
-        return_value = 0;
-
-        // Find the minimum length needed to fully enclose all test names (and the header field) in
-        // the fmt::format column by first finding the maximum size of any test name and comparing
-        // that to 9, the string length of 'Test Name'
-        const auto needed_length_name =
-            std::max<u64>(std::max_element(results.begin(), results.end(),
-                                           [](const auto& lhs, const auto& rhs) {
-                                               return lhs.name.size() < rhs.name.size();
-                                           })
-                              ->name.size(),
-                          9ull);
-
-        std::size_t passed = 0;
-        std::size_t failed = 0;
-
-        std::cout << fmt::format("Result [Res Code] | {:<{}} | Extra Data", "Test Name",
-                                 needed_length_name)
-                  << std::endl;
-
-        for (const auto& res : results) {
-            const auto main_res = res.code == 0 ? "PASSED" : "FAILED";
-            if (res.code == 0)
-                ++passed;
-            else
-                ++failed;
-            std::cout << fmt::format("{} [{:08X}] | {:<{}} | {}", main_res, res.code, res.name,
-                                     needed_length_name, res.data)
-                      << std::endl;
+    if (num_jobs > 1) {
+        // Every test runs on its own system, bound to the worker thread driving it. Only the
+        // settings and the logging backends are shared between them.
+        std::atomic<std::size_t> next_test{0};
+        std::atomic<bool> any_failed{false};
+        std::vector<std::thread> workers(std::min(num_jobs, filepaths.size()));
+        for (auto& worker : workers) {
+            worker = std::thread([&] {
+                MicroProfileOnThreadCreate("EmuThread");
+                EmuWindow_Headless emu_window;
+                for (std::size_t index = next_test++; index < filepaths.size();
+                     index = next_test++) {
+                    Core::System system;
+                    Core::System::SetCurrentInstance(system);
+                    if (RunTest(system, emu_window, filepaths[index], datastring, repeat_count,
+                                null_renderer) != 0) {
+                        any_failed = true;
+                    }
+                }
+            });
         }
-
-        std::cout << std::endl
-                  << fmt::format("{:4d} Passed | {:4d} Failed | {:4d} Total | {:2.2f} Passed Ratio",
-                                 passed, failed, passed + failed,
-                                 static_cast<float>(passed) / (passed + failed))
-                  << std::endl
-                  << (failed == 0 ? "PASSED" : "FAILED") << std::endl;
-
-        if (failed > 0)
-            return_value = -1;
-    };
-
-    Core::System& system{Core::System::GetInstance()};
-    system.SetContentProvider(std::make_unique<FileSys::ContentProviderUnion>());
-    system.SetFilesystem(std::make_shared<FileSys::RealVfsFilesystem>());
-    system.GetFileSystemController().CreateFactories(*system.GetFilesystem());
-
-    SCOPE_EXIT({ system.Shutdown(); });
-
-    const Core::System::ResultStatus load_result{system.Load(*emu_window, filepath)};
-
-    switch (load_result) {
-    case Core::System::ResultStatus::ErrorGetLoader:
-        LOG_CRITICAL(Frontend, "Failed to obtain loader for {}!", filepath);
-        return -1;
-    case Core::System::ResultStatus::ErrorLoader:
-        LOG_CRITICAL(Frontend, "Failed to load ROM!");
-        return -1;
-    case Core::System::ResultStatus::ErrorNotInitialized:
-        LOG_CRITICAL(Frontend, "CPUCore not initialized");
-        return -1;
-    case Core::System::ResultStatus::ErrorVideoCore:
-        LOG_CRITICAL(Frontend, "Failed to initialize VideoCore!");
-        return -1;
-    case Core::System::ResultStatus::Success:
-        break; // Expected case
-    default:
-        if (static_cast<u32>(load_result) >
-            static_cast<u32>(Core::System::ResultStatus::ErrorLoader)) {
-            const u16 loader_id = static_cast<u16>(Core::System::ResultStatus::ErrorLoader);
-            const u16 error_id = static_cast<u16>(load_result) - loader_id;
-            LOG_CRITICAL(Frontend,
-                         "While attempting to load the ROM requested, an error occured. Please "
-                         "refer to the yuzu wiki for more information or the yuzu discord for "
-                         "additional help.\n\nError Code: {:04X}-{:04X}\nError Description: {}",
-                         loader_id, error_id, static_cast<Loader::ResultStatus>(error_id));
+        for (auto& worker : workers) {
+            worker.join();
         }
+        detached_tasks.WaitForAllTasks();
+        return any_failed ? -1 : 0;
     }
 
-    Service::Yuzu::InstallInterfaces(system.ServiceManager(), datastring, callback);
-
-    system.TelemetrySession().AddField(Telemetry::FieldType::App, "Frontend", "SDLHideTester");
+    std::unique_ptr<EmuWindow_Headless> headless_window;
+    std::unique_ptr<EmuWindow_SDL2_Hide> sdl_window;
+    if (null_renderer) {
+        headless_window = std::make_unique<EmuWindow_Headless>();
+    } else {
+        sdl_window = std::make_unique<EmuWindow_SDL2_Hide>();
+    }
+    Core::Frontend::EmuWindow& emu_window = null_renderer
+                                                ? static_cast<Core::Frontend::EmuWindow&>(
+                                                      *headless_window)
+                                                : *sdl_window;
 
-    system.Renderer().Rasterizer().LoadDiskResources();
+    if (!Settings::values.use_multi_core) {
+        // Single core mode must acquire OpenGL context for entire emulation session
+        emu_window.MakeCurrent();
+    }
 
-    while (!finished) {
-        system.RunLoop();
+    for (const auto& filepath : filepaths) {
+        if (RunTest(Core::System::GetInstance(), emu_window, filepath, datastring, repeat_count,
+                    null_renderer) != 0) {
+            return_value = -1;
+        }
     }
 
     detached_tasks.WaitForAllTasks();